@@ -90,6 +90,12 @@ Use "HEADLESS=True pip install ." to build in headless mode with pip""",
     parser.add_argument(
         "--build-tests", dest="build_tests", action="store_true", help="Build tests"
     )
+    parser.add_argument(
+        "--build-benchmarks",
+        dest="build_benchmarks",
+        action="store_true",
+        help="Build benchmarks",
+    )
     parser.add_argument(
         "--build-datatool",
         dest="build_datatool",
@@ -317,6 +323,9 @@ class CMakeBuild(build_ext):
         ]
 
         cmake_args += ["-DBUILD_TEST={}".format("ON" if args.build_tests else "OFF")]
+        cmake_args += [
+            "-DBUILD_BENCHMARKS={}".format("ON" if args.build_benchmarks else "OFF")
+        ]
         cmake_args += [
             "-DBUILD_WITH_BULLET={}".format("ON" if args.with_bullet else "OFF")
         ]
@@ -0,0 +1,137 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Path.h>
+
+#include "esp/assets/RenderAssetInstanceCreationInfo.h"
+#include "esp/assets/ResourceManager.h"
+#include "esp/gfx/RenderCamera.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/Recorder.h"
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/scene/SceneManager.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::assets::ResourceManager;
+using esp::metadata::MetadataMediator;
+using esp::scene::SceneManager;
+using Magnum::Math::Literals::operator""_degf;
+
+namespace {
+
+//! Instances are laid out on a NumInstancesPerSide^2 grid in the XZ plane
+constexpr int NumInstancesPerSide = 64;
+
+struct GfxBenchmark : Cr::TestSuite::Tester {
+  explicit GfxBenchmark();
+
+  void cull();
+  void saveKeyframe();
+  void saveKeyframeAllMoving();
+
+  esp::logging::LoggingContext loggingContext;
+  // must declare these in this order due to avoid deallocation errors
+  esp::gfx::WindowlessContext::uptr context;
+  std::unique_ptr<ResourceManager> resourceManager;
+  SceneManager::uptr sceneManager;
+  esp::gfx::replay::Recorder recorder;
+  int sceneID = esp::ID_UNDEFINED;
+  std::vector<esp::scene::SceneNode*> instanceNodes;
+  esp::gfx::RenderCamera* renderCamera = nullptr;
+};
+
+GfxBenchmark::GfxBenchmark() {
+  context = esp::gfx::WindowlessContext::create_unique(0);
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  auto MM = MetadataMediator::create(cfg);
+  resourceManager = std::make_unique<ResourceManager>(MM);
+  sceneManager = SceneManager::create_unique();
+  sceneID = sceneManager->initSceneGraph();
+  auto& sceneGraph = sceneManager->getSceneGraph(sceneID);
+
+  const std::string boxFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/transform_box.glb");
+  const esp::assets::AssetInfo info =
+      esp::assets::AssetInfo::fromPath(boxFile);
+  esp::assets::RenderAssetInstanceCreationInfo::Flags flags;
+  flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      boxFile, Cr::Containers::NullOpt, flags, esp::NO_LIGHT_KEY);
+
+  recorder.onLoadRenderAsset(info);
+  instanceNodes.reserve(NumInstancesPerSide * NumInstancesPerSide);
+  for (int x = 0; x < NumInstancesPerSide; ++x) {
+    for (int z = 0; z < NumInstancesPerSide; ++z) {
+      esp::scene::SceneNode* node =
+          resourceManager->loadAndCreateRenderAssetInstance(
+              info, creation, &sceneGraph.getRootNode(),
+              &sceneGraph.getDrawables());
+      CORRADE_INTERNAL_ASSERT(node);
+      node->setTranslation(Mn::Vector3(x * 3.0f, 0.0f, z * 3.0f));
+      recorder.onCreateRenderAssetInstance(node, creation);
+      instanceNodes.push_back(node);
+    }
+  }
+
+  // looking diagonally across the grid, so roughly half the instances are
+  // culled
+  esp::scene::SceneNode& cameraNode = sceneGraph.getRootNode().createChild();
+  renderCamera = new esp::gfx::RenderCamera(
+      cameraNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID);
+  renderCamera->setProjectionMatrix(800, 600, 0.01f, 100.0f, 90.0_degf);
+  cameraNode.translate({-1.0f, 2.0f, -1.0f});
+  cameraNode.rotateY(-135.0_degf);
+
+  addBenchmarks({&GfxBenchmark::cull}, 20);
+  addBenchmarks(
+      {&GfxBenchmark::saveKeyframe, &GfxBenchmark::saveKeyframeAllMoving},
+      20);
+}
+
+void GfxBenchmark::cull() {
+  auto& drawables = sceneManager->getSceneGraph(sceneID).getDrawables();
+  CORRADE_COMPARE(drawables.size(), instanceNodes.size());
+
+  std::size_t numVisible = 0;
+  CORRADE_BENCHMARK(1) {
+    esp::gfx::RenderCamera::DrawableTransforms drawableTransforms =
+        renderCamera->drawableTransformations(drawables);
+    numVisible = renderCamera->cull(drawableTransforms);
+  };
+  CORRADE_VERIFY(numVisible > 0);
+  CORRADE_VERIFY(numVisible < instanceNodes.size());
+}
+
+void GfxBenchmark::saveKeyframe() {
+  // only a handful of instances change between keyframes
+  std::size_t frame = 0;
+  CORRADE_BENCHMARK(1) {
+    for (std::size_t i = frame % 16; i < instanceNodes.size(); i += 256) {
+      instanceNodes[i]->translate({0.0f, 0.01f, 0.0f});
+    }
+    ++frame;
+    recorder.saveKeyframe();
+  };
+  CORRADE_VERIFY(!recorder.writeSavedKeyframesToString().empty());
+}
+
+void GfxBenchmark::saveKeyframeAllMoving() {
+  CORRADE_BENCHMARK(1) {
+    for (esp::scene::SceneNode* node : instanceNodes) {
+      node->translate({0.0f, 0.01f, 0.0f});
+    }
+    recorder.saveKeyframe();
+  };
+  CORRADE_VERIFY(!recorder.writeSavedKeyframesToString().empty());
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(GfxBenchmark)
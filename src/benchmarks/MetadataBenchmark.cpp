@@ -0,0 +1,126 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Path.h>
+#include <random>
+
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/scene/SemanticScene.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::metadata::MetadataMediator;
+
+namespace {
+
+const std::string physicsConfigFile =
+    Cr::Utility::Path::join(TEST_ASSETS, "testing.physics_config.json");
+
+const std::string semanticConfigFile = Cr::Utility::Path::join(
+    TEST_ASSETS, "semantic/test_regions.semantic_config.json");
+
+constexpr struct {
+  const char* name;
+  const char* configFile;
+} DatasetData[]{
+    {"dataset_0", "dataset_0/test_dataset_0.scene_dataset_config.json"},
+    {"dataset_1", "dataset_1/test_dataset_1.scene_dataset_config.json"}};
+
+constexpr struct {
+  const char* name;
+  int numPoints;
+} RegionQueryData[]{{"1k points", 1000}, {"100k points", 100000}};
+
+struct MetadataBenchmark : Cr::TestSuite::Tester {
+  explicit MetadataBenchmark();
+
+  void loadSceneDataset();
+  void loadObjectConfigs();
+  void getRegionsForPoints();
+
+  esp::logging::LoggingContext loggingContext;
+};
+
+MetadataBenchmark::MetadataBenchmark() {
+  addInstancedBenchmarks({&MetadataBenchmark::loadSceneDataset}, 10,
+                         Cr::Containers::arraySize(DatasetData));
+  addBenchmarks({&MetadataBenchmark::loadObjectConfigs}, 10);
+  addInstancedBenchmarks({&MetadataBenchmark::getRegionsForPoints}, 10,
+                         Cr::Containers::arraySize(RegionQueryData));
+}
+
+void MetadataBenchmark::loadSceneDataset() {
+  auto&& data = DatasetData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  cfg.sceneDatasetConfigFile = Cr::Utility::Path::join(
+      TEST_ASSETS, Cr::Utility::Path::join("dataset_tests", data.configFile));
+  cfg.physicsConfigFile = physicsConfigFile;
+
+  // parses every stage, object, light and scene instance config the dataset
+  // references
+  bool status = false;
+  CORRADE_BENCHMARK(1) {
+    auto MM = MetadataMediator::create();
+    status = MM->setSimulatorConfiguration(cfg);
+  };
+  CORRADE_VERIFY(status);
+}
+
+void MetadataBenchmark::loadObjectConfigs() {
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  auto MM = MetadataMediator::create(cfg);
+  auto objAttrMgr = MM->getObjectAttributesManager();
+
+  std::size_t numLoaded = 0;
+  CORRADE_BENCHMARK(1) {
+    numLoaded = objAttrMgr
+                    ->loadAllJSONConfigsFromPath(
+                        Cr::Utility::Path::join(TEST_ASSETS, "objects"), true)
+                    .size();
+  };
+  CORRADE_VERIFY(numLoaded > 0);
+}
+
+void MetadataBenchmark::getRegionsForPoints() {
+  auto&& data = RegionQueryData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  auto MM = MetadataMediator::create(cfg);
+  auto semanticAttr = MM->getSemanticAttributesManager()->createObject(
+      semanticConfigFile, true);
+  CORRADE_VERIFY(semanticAttr);
+  auto semanticScene = esp::scene::SemanticScene::create();
+  esp::scene::SemanticScene::loadSemanticSceneDescriptor(semanticAttr,
+                                                         *semanticScene);
+  CORRADE_VERIFY(!semanticScene->regions().empty());
+
+  // uniformly spread over and around both test regions, so the query sees a
+  // mix of hits and misses
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> xDist(-30.0f, 30.0f);
+  std::uniform_real_distribution<float> yDist(-3.0f, 3.0f);
+  std::uniform_real_distribution<float> zDist(-12.0f, 12.0f);
+  std::vector<Mn::Vector3> points(data.numPoints);
+  for (Mn::Vector3& point : points) {
+    point = {xDist(generator), yDist(generator), zDist(generator)};
+  }
+
+  std::size_t numRegions = 0;
+  CORRADE_BENCHMARK(1) {
+    numRegions = semanticScene->getRegionsForPoints(points).size();
+  };
+  CORRADE_VERIFY(numRegions > 0);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(MetadataBenchmark)
@@ -0,0 +1,122 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Path.h>
+
+#include "esp/nav/PathFinder.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+
+namespace {
+
+const std::string skokloster =
+    Cr::Utility::Path::join(SCENE_DATASETS,
+                            "habitat-test-scenes/skokloster-castle.navmesh");
+
+constexpr struct {
+  const char* name;
+  int numEnds;
+} MultiGoalData[]{{"10 goals", 10}, {"100 goals", 100}, {"1000 goals", 1000}};
+
+constexpr struct {
+  const char* name;
+  float metersPerPixel;
+  bool rasterize;
+} TopDownViewData[]{{"0.1 m/px", 0.1f, false},
+                    {"0.05 m/px", 0.05f, false},
+                    {"0.1 m/px, rasterized", 0.1f, true},
+                    {"0.01 m/px, rasterized", 0.01f, true}};
+
+struct NavBenchmark : Cr::TestSuite::Tester {
+  explicit NavBenchmark();
+
+  void findPathSingleGoal();
+  void findPathMultiGoal();
+  void getTopDownView();
+
+  esp::logging::LoggingContext loggingContext;
+  esp::nav::PathFinder pathFinder;
+};
+
+NavBenchmark::NavBenchmark() {
+  pathFinder.loadNavMesh(skokloster);
+  pathFinder.seed(0);
+
+  addBenchmarks({&NavBenchmark::findPathSingleGoal}, 100);
+  addInstancedBenchmarks({&NavBenchmark::findPathMultiGoal}, 10,
+                         Cr::Containers::arraySize(MultiGoalData));
+  addInstancedBenchmarks({&NavBenchmark::getTopDownView}, 10,
+                         Cr::Containers::arraySize(TopDownViewData));
+}
+
+void NavBenchmark::findPathSingleGoal() {
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  // a fresh random query per batch, so the numbers don't depend on one
+  // particularly short or long path
+  std::vector<esp::nav::ShortestPath> paths(100);
+  for (esp::nav::ShortestPath& path : paths) {
+    do {
+      path.requestedStart = pathFinder.getRandomNavigablePoint();
+    } while (pathFinder.islandRadius(path.requestedStart) < 10.0);
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+  }
+
+  std::size_t numFound = 0;
+  CORRADE_BENCHMARK(1) {
+    for (esp::nav::ShortestPath& path : paths) {
+      numFound += pathFinder.findPath(path);
+    }
+  };
+  CORRADE_VERIFY(numFound > 0);
+}
+
+void NavBenchmark::findPathMultiGoal() {
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  auto&& data = MultiGoalData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  esp::nav::MultiGoalShortestPath path;
+  do {
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+  } while (pathFinder.islandRadius(path.requestedStart) < 10.0);
+
+  std::vector<esp::vec3f> requestedEnds;
+  requestedEnds.reserve(data.numEnds);
+  for (int i = 0; i < data.numEnds; ++i) {
+    requestedEnds.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+  path.setRequestedEnds(requestedEnds);
+
+  bool status = false;
+  CORRADE_BENCHMARK(1) { status = pathFinder.findPath(path); };
+  CORRADE_VERIFY(status);
+}
+
+void NavBenchmark::getTopDownView() {
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  auto&& data = TopDownViewData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // views are cached per argument set, so nudge the height every run to
+  // measure the actual generation
+  float height = pathFinder.bounds().first[1];
+  Eigen::Index numCells = 0;
+  CORRADE_BENCHMARK(1) {
+    height += 1e-4f;
+    numCells = pathFinder
+                   .getTopDownView(data.metersPerPixel, height, 0.5f,
+                                   data.rasterize)
+                   .size();
+  };
+  CORRADE_VERIFY(numCells > 0);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(NavBenchmark)
@@ -0,0 +1,89 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Path.h>
+#include <cmath>
+
+#include "esp/physics/objectManagers/RigidObjectManager.h"
+#include "esp/sim/Simulator.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::sim::Simulator;
+using esp::sim::SimulatorConfiguration;
+
+namespace {
+
+const std::string planeStage =
+    Cr::Utility::Path::join(TEST_ASSETS, "scenes/plane.glb");
+const std::string physicsConfigFile =
+    Cr::Utility::Path::join(TEST_ASSETS, "testing.physics_config.json");
+
+constexpr struct {
+  const char* name;
+  int numObjects;
+} StepPhysicsData[]{
+    {"100 objects", 100}, {"1000 objects", 1000}, {"4000 objects", 4000}};
+
+struct PhysicsBenchmark : Cr::TestSuite::Tester {
+  explicit PhysicsBenchmark();
+
+  void stepPhysics();
+
+  esp::logging::LoggingContext loggingContext;
+};
+
+PhysicsBenchmark::PhysicsBenchmark() {
+  addInstancedBenchmarks({&PhysicsBenchmark::stepPhysics}, 10,
+                         Cr::Containers::arraySize(StepPhysicsData));
+}
+
+void PhysicsBenchmark::stepPhysics() {
+  auto&& data = StepPhysicsData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  SimulatorConfiguration simConfig{};
+  simConfig.activeSceneName = planeStage;
+  simConfig.enablePhysics = true;
+  simConfig.physicsConfigFile = physicsConfigFile;
+  simConfig.createRenderer = false;
+  auto sim = Simulator::create_unique(simConfig);
+  if (sim->getPhysicsSimulationLibrary() !=
+      esp::physics::PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    CORRADE_SKIP("Bullet physics is not available.");
+  }
+
+  auto objAttrMgr = sim->getObjectAttributesManager();
+  objAttrMgr->loadAllJSONConfigsFromPath(
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/nested_box"), true);
+  const std::string objHandle =
+      objAttrMgr->getObjectHandlesBySubstring("nested_box")[0];
+
+  // stack the objects in a loose grid of columns so they keep colliding with
+  // their neighbours and the ground while the world is stepped
+  auto rigidObjMgr = sim->getRigidObjectManager();
+  const int numPerSide = std::ceil(std::cbrt(data.numObjects));
+  for (int i = 0; i < data.numObjects; ++i) {
+    auto obj = rigidObjMgr->addObjectByHandle(objHandle);
+    CORRADE_VERIFY(obj);
+    obj->setTranslation(Mn::Vector3(
+        (i % numPerSide) * 0.6f, 0.5f + (i / (numPerSide * numPerSide)) * 0.6f,
+        ((i / numPerSide) % numPerSide) * 0.6f));
+  }
+  // let the pile settle a little so the measurement isn't just free fall
+  sim->stepWorld(0.5);
+
+  double worldTime = 0.0;
+  CORRADE_BENCHMARK(1) { worldTime = sim->stepWorld(1.0 / 60.0); };
+  CORRADE_VERIFY(worldTime > 0.5);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(PhysicsBenchmark)
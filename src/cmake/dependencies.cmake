@@ -187,6 +187,13 @@ if(BUILD_WITH_BULLET AND NOT USE_SYSTEM_BULLET)
   # that causes rigid objects to never come to rest.
   # This needs to be further examined on bullet side
   add_definitions(-DBT_DISABLE_CONVEX_CONCAVE_EARLY_OUT=1)
+  # Lets PhysicsManagerAttributes::setNumThreads() spread collision detection
+  # over several threads. Bullet defines BT_THREADSAFE only for itself, but
+  # its headers depend on it, so define it for everything.
+  if(NOT CORRADE_TARGET_EMSCRIPTEN)
+    set(BULLET2_MULTITHREADING ON CACHE BOOL "" FORCE)
+    add_definitions(-DBT_THREADSAFE=1)
+  endif()
   add_subdirectory(${DEPS_DIR}/bullet3 EXCLUDE_FROM_ALL)
   set(CMAKE_CXX_FLAGS ${_PREV_CMAKE_CXX_FLAGS})
 endif()
@@ -233,10 +240,13 @@ if(NOT USE_SYSTEM_MAGNUM)
   set(MAGNUM_WITH_EMSCRIPTENAPPLICATION OFF CACHE BOOL "" FORCE)
   set(MAGNUM_WITH_GLFWAPPLICATION OFF CACHE BOOL "" FORCE)
   set(MAGNUM_WITH_EIGEN ON CACHE BOOL "" FORCE) # Eigen integration
-  # GltfSceneConverter and KtxImageConverter are needed only by
-  # BatchRendererTest and are optional
+  # KtxImageConverter writes the on-disk cache of precomputed IBL maps, and is
+  # used by BatchRendererTest. GltfSceneConverter is needed only by the latter
+  # and is optional
   #set(MAGNUM_WITH_GLTFSCENECONVERTER ON CACHE BOOL "" FORCE)
-  #set(MAGNUM_WITH_KTXIMAGECONVERTER ON CACHE BOOL "" FORCE)
+  set(MAGNUM_WITH_KTXIMAGECONVERTER ON CACHE BOOL "" FORCE)
+  # Compresses textures to BC1/BC3 with SimulatorConfiguration::compressTextures
+  set(MAGNUM_WITH_STBDXTIMAGECONVERTER ON CACHE BOOL "" FORCE)
   if(BUILD_PYTHON_BINDINGS)
     set(MAGNUM_WITH_PYTHON ON CACHE BOOL "" FORCE) # Python bindings
   endif()
@@ -7,6 +7,8 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include "esp/core/Check.h"
+#include "esp/core/LatencyTracker.h"
 #include "esp/scene/ObjectControls.h"
 #include "esp/sensor/Sensor.h"
 
@@ -31,28 +33,76 @@ Agent::~Agent() {
 }
 
 bool Agent::act(const std::string& actionName) {
-  if (hasAction(actionName)) {
-    const ActionSpec& actionSpec = *configuration_.actionSpace.at(actionName);
-    if (BodyActions.find(actionSpec.name) != BodyActions.end()) {
-      controls_->action(object(), actionSpec.name,
-                        actionSpec.actuation.at("amount"),
-                        /*applyFilter=*/true);
-    } else {
-      for (const auto& p : node().getNodeSensors()) {
-        controls_->action(p.second.get().object(), actionSpec.name,
-                          actionSpec.actuation.at("amount"),
-                          /*applyFilter=*/false);
-      }
-    }
-    return true;
-  } else {
+  return act(getActionId(actionName));
+}
+
+bool Agent::act(int actionId) {
+  ESP_TRACK_LATENCY("Agent::act");
+  if (actionsDirty_) {
+    compileActions();
+  }
+  if (actionId < 0 || std::size_t(actionId) >= compiledActions_.size()) {
     return false;
   }
+  const CompiledAction& action = compiledActions_[actionId];
+  const float amount = action.spec->actuation.at("amount");
+  if (!action.moveFunc) {
+    ESP_ERROR() << "Tried to perform unknown action with name"
+                << action.spec->name;
+  } else if (action.bodyAction) {
+    controls_->action(object(), *action.moveFunc, amount,
+                      /*applyFilter=*/true);
+  } else {
+    for (const auto& p : node().getNodeSensors()) {
+      controls_->action(p.second.get().object(), *action.moveFunc, amount,
+                        /*applyFilter=*/false);
+    }
+  }
+  return true;
+}
+
+int Agent::getActionId(const std::string& actionName) {
+  if (actionsDirty_) {
+    compileActions();
+  }
+  auto actionIter = configuration_.actionSpace.find(actionName);
+  if (actionIter == configuration_.actionSpace.end()) {
+    return ID_UNDEFINED;
+  }
+  return int(std::distance(configuration_.actionSpace.begin(), actionIter));
+}
+
+const scene::ObjectControls::MoveFunc* Agent::getBodyMoveFunc(int actionId,
+                                                              float& amount) {
+  if (actionsDirty_) {
+    compileActions();
+  }
+  if (actionId < 0 || std::size_t(actionId) >= compiledActions_.size()) {
+    return nullptr;
+  }
+  const CompiledAction& action = compiledActions_[actionId];
+  if (!action.bodyAction || !action.moveFunc) {
+    return nullptr;
+  }
+  amount = action.spec->actuation.at("amount");
+  return action.moveFunc;
+}
+
+void Agent::compileActions() {
+  compiledActions_.clear();
+  compiledActions_.reserve(configuration_.actionSpace.size());
+  for (const auto& entry : configuration_.actionSpace) {
+    const ActionSpec::ptr& spec = entry.second;
+    compiledActions_.push_back(
+        {spec, controls_->getMoveFunc(spec->name),
+         BodyActions.find(spec->name) != BodyActions.end()});
+  }
+  actionsDirty_ = false;
 }
 
 bool Agent::hasAction(const std::string& actionName) const {
-  auto actionSpace = configuration_.actionSpace;
-  return !(actionSpace.find(actionName) == actionSpace.end());
+  return configuration_.actionSpace.find(actionName) !=
+         configuration_.actionSpace.end();
 }
 
 void Agent::reset() {
@@ -84,6 +134,65 @@ void Agent::setState(const AgentState& state,
   // TODO other state members when implemented
 }
 
+std::size_t act(const std::vector<Agent::ptr>& agents,
+                const std::vector<int>& actionIds) {
+  ESP_CHECK(agents.size() == actionIds.size(),
+            "act(): expected one action per agent but got"
+                << actionIds.size() << "for" << agents.size() << "agents");
+  std::size_t count = 0;
+  for (std::size_t i = 0; i != agents.size(); ++i) {
+    if (actionIds[i] >= 0 && agents[i]->act(actionIds[i])) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+std::vector<bool> act(const std::vector<Agent::ptr>& agents,
+                      const std::vector<int>& actionIds,
+                      const AgentsMoveFilterFunc& filterFunc) {
+  ESP_CHECK(agents.size() == actionIds.size(),
+            "act(): expected one action per agent but got"
+                << actionIds.size() << "for" << agents.size() << "agents");
+  // body moves are gathered for a single filter call, the rest is done
+  // right away as it isn't filtered anyway
+  std::vector<std::size_t> movedAgents;
+  std::vector<scene::SceneNode*> objects;
+  std::vector<const scene::ObjectControls::MoveFunc*> moveFuncs;
+  std::vector<float> amounts;
+  for (std::size_t i = 0; i != agents.size(); ++i) {
+    if (actionIds[i] < 0) {
+      continue;
+    }
+    float amount = 0.0f;
+    const scene::ObjectControls::MoveFunc* moveFunc =
+        agents[i]->getBodyMoveFunc(actionIds[i], amount);
+    if (moveFunc) {
+      movedAgents.push_back(i);
+      objects.push_back(&agents[i]->node());
+      moveFuncs.push_back(moveFunc);
+      amounts.push_back(amount);
+    } else {
+      agents[i]->act(actionIds[i]);
+    }
+  }
+
+  scene::ObjectControls::MoveBatchFilterFunc movedFilterFunc;
+  if (filterFunc) {
+    movedFilterFunc = [&](const std::vector<Magnum::Vector3>& starts,
+                          const std::vector<Magnum::Vector3>& ends) {
+      return filterFunc(movedAgents, starts, ends);
+    };
+  }
+  const std::vector<bool> movedCollided = scene::ObjectControls::batchAction(
+      objects, moveFuncs, amounts, movedFilterFunc);
+  std::vector<bool> collided(agents.size(), false);
+  for (std::size_t i = 0; i != movedAgents.size(); ++i) {
+    collided[movedAgents[i]] = movedCollided[i];
+  }
+  return collided;
+}
+
 bool operator==(const ActionSpec& a, const ActionSpec& b) {
   return a.name == b.name && a.actuation == b.actuation;
 }
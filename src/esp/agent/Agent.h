@@ -5,18 +5,18 @@
 #define ESP_AGENT_AGENT_H_
 
 #include <Magnum/SceneGraph/Object.h>
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
+#include "esp/scene/ObjectControls.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
-namespace scene {
-class ObjectControls;
-}
 namespace sensor {
 class Sensor;
 struct SensorSpec;
@@ -178,6 +178,35 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
    */
   bool act(const std::string& actionName);
 
+  /**
+   * @brief Perform an action by the ID returned by @ref getActionId(), without
+   * looking it up by name
+   * @return Whether the action is available to the agent
+   */
+  bool act(int actionId);
+
+  /**
+   * @brief Resolve the name of an action in the action space to an ID for
+   * @ref act(int)
+   *
+   * IDs are the indices of the actions in the action space sorted by name, so
+   * agents with the same action space share them. They are valid until the
+   * action space is modified. Returns @ref ID_UNDEFINED if the agent has no
+   * such action.
+   */
+  int getActionId(const std::string& actionName);
+
+  /**
+   * @brief The move function of action @p actionId if it's a body action,
+   * for moving many agents with @ref scene::ObjectControls::batchAction()
+   * @param actionId  Action ID, see @ref getActionId()
+   * @param[out] amount The amount of the action
+   * @return @cpp nullptr @ce if @p actionId isn't a body action the controls
+   *    know
+   */
+  const scene::ObjectControls::MoveFunc* getBodyMoveFunc(int actionId,
+                                                         float& amount);
+
   /**
    * @brief Verify whether the named action is available to the agent.
    * @param actionName the name of the action to perform
@@ -247,8 +276,14 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
 
   /**
    * @brief Retrieve a reference to this agent's configuration.
+   *
+   * Action IDs are recomputed on the next action, in case the action space is
+   * modified through it.
    */
-  AgentConfiguration& getConfig() { return configuration_; }
+  AgentConfiguration& getConfig() {
+    actionsDirty_ = true;
+    return configuration_;
+  }
 
   /**
    * @brief Set of actions that are applied to the body of the agent.  These
@@ -268,9 +303,60 @@ class Agent : public Magnum::SceneGraph::AbstractFeature3D {
   std::shared_ptr<scene::ObjectControls> controls_;
   AgentState initialState_;
 
+  //! An action of the action space, resolved once for @ref act(int)
+  struct CompiledAction {
+    ActionSpec::ptr spec;
+    //! @cpp nullptr @ce if the controls don't know the action
+    const std::function<scene::SceneNode&(scene::SceneNode&, float)>* moveFunc;
+    bool bodyAction;
+  };
+
+  void compileActions();
+
+  //! Indexed by action ID
+  std::vector<CompiledAction> compiledActions_;
+  bool actionsDirty_ = true;
+
   ESP_SMART_POINTERS(Agent)
 };
 
+/**
+ * @brief Perform one action per agent
+ * @param agents      Agents
+ * @param actionIds   Action of each agent, see @ref Agent::getActionId().
+ *    Agents with a negative ID don't act.
+ * @return Number of agents that performed their action
+ */
+std::size_t act(const std::vector<Agent::ptr>& agents,
+                const std::vector<int>& actionIds);
+
+/**
+ * @brief Filter for the body moves of many agents, taking the indices of the
+ * moving agents along with their start and desired end positions and
+ * returning the filtered end positions
+ */
+typedef std::function<std::vector<Magnum::Vector3>(
+    const std::vector<std::size_t>&,
+    const std::vector<Magnum::Vector3>&,
+    const std::vector<Magnum::Vector3>&)>
+    AgentsMoveFilterFunc;
+
+/**
+ * @brief Perform one action per agent, filtering all body moves at once
+ * @param agents      Agents
+ * @param actionIds   Action of each agent, see @ref Agent::getActionId().
+ *    Agents with a negative ID don't act.
+ * @param filterFunc  Filter for all body moves, such as one calling
+ *    @ref nav::PathFinder::trySteps(). If empty, moves aren't filtered.
+ * @return Whether the body move of each agent was cut short by the filter
+ *
+ * Unlike acting agent by agent, the per-agent move filters set with
+ * @ref scene::ObjectControls::setMoveFilterFunction() aren't used.
+ */
+std::vector<bool> act(const std::vector<Agent::ptr>& agents,
+                      const std::vector<int>& actionIds,
+                      const AgentsMoveFilterFunc& filterFunc);
+
 }  // namespace agent
 }  // namespace esp
 
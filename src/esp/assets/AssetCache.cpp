@@ -0,0 +1,92 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AssetCache.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Algorithms.h>
+
+#include "BaseMesh.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+AssetCache& AssetCache::instance() {
+  static AssetCache cache;
+  return cache;
+}
+
+SharedRenderAsset::cptr AssetCache::find(const AssetInfo& info,
+                                         bool requiresTextures,
+                                         const Mn::GL::Context* glContext) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    return nullptr;
+  }
+  auto range = assets_.equal_range(info.filepath);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    SharedRenderAsset::cptr asset = iter->second.lock();
+    if (!asset || asset->assetInfo != info ||
+        asset->glContext != glContext ||
+        (requiresTextures && !asset->hasTextures)) {
+      continue;
+    }
+    return asset;
+  }
+  return nullptr;
+}
+
+SharedRenderAsset::cptr AssetCache::publish(SharedRenderAsset::uptr asset) {
+  SharedRenderAsset::cptr shared{std::move(asset)};
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (enabled_) {
+    pruneExpired();
+    assets_.emplace(shared->assetInfo.filepath, shared);
+  }
+  return shared;
+}
+
+int AssetCache::getNumLiveAssets() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pruneExpired();
+  return static_cast<int>(assets_.size());
+}
+
+void AssetCache::setEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = enabled;
+}
+
+bool AssetCache::isEnabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return enabled_;
+}
+
+void AssetCache::pruneExpired() {
+  for (auto iter = assets_.begin(); iter != assets_.end();) {
+    if (iter->second.expired()) {
+      iter = assets_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+Mn::Trade::MaterialData copyMaterialData(
+    const Mn::Trade::MaterialData& material) {
+  Cr::Containers::Array<Mn::Trade::MaterialAttributeData> attributes{
+      Cr::NoInit, material.attributeData().size()};
+  Cr::Utility::copy(material.attributeData(), attributes);
+  Cr::Containers::Array<Mn::UnsignedInt> layers{
+      Cr::NoInit, material.layerData().size()};
+  Cr::Utility::copy(material.layerData(), layers);
+  return Mn::Trade::MaterialData{material.types(), std::move(attributes),
+                                 std::move(layers)};
+}
+
+}  // namespace assets
+}  // namespace esp
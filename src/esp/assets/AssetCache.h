@@ -0,0 +1,171 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_ASSETCACHE_H_
+#define ESP_ASSETS_ASSETCACHE_H_
+
+/** @file
+ * @brief Class @ref esp::assets::AssetCache, Struct @ref
+ * esp::assets::SharedRenderAsset
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/Trade/MaterialData.h>
+
+#include "Asset.h"
+#include "MeshMetaData.h"
+#include "esp/core/Esp.h"
+#include "esp/gfx/SkinData.h"
+
+namespace esp {
+namespace assets {
+
+class BaseMesh;
+
+/**
+ * @brief Everything a @ref ResourceManager built while importing a general
+ * render asset, in a form another @ref ResourceManager can adopt without
+ * touching the file again.
+ *
+ * Index ranges in @ref meshMetaData and numeric material keys in its
+ * hierarchy are the ones of the @ref ResourceManager that published the asset;
+ * adopters remap them into their own ID spaces. All data is treated as
+ * immutable once published.
+ */
+struct SharedRenderAsset {
+  /** @brief The @ref AssetInfo the asset was imported with. */
+  AssetInfo assetInfo;
+
+  /** @brief Metadata of the asset, in the publisher's ID space. */
+  MeshMetaData meshMetaData;
+
+  /**
+   * @brief Inclusive range of the numeric material keys the publisher
+   * registered for this asset, or @ref ID_UNDEFINED if it has none.
+   */
+  std::pair<int, int> materialIndex{ID_UNDEFINED, ID_UNDEFINED};
+
+  /** @brief Meshes, in @ref MeshMetaData::meshIndex order. */
+  std::vector<std::shared_ptr<BaseMesh>> meshes;
+
+  /** @brief Textures, in @ref MeshMetaData::textureIndex order. */
+  std::vector<std::shared_ptr<Magnum::GL::Texture2D>> textures;
+
+  /** @brief Skins, in @ref MeshMetaData::skinIndex order. */
+  std::vector<std::shared_ptr<gfx::SkinData>> skins;
+
+  /**
+   * @brief Materials keyed by their offset into @ref materialIndex; materials
+   * that failed to import are absent. Texture pointers inside reference
+   * @ref textures, which this struct keeps alive.
+   */
+  std::map<int, Magnum::Trade::MaterialData> materials;
+
+  /**
+   * @brief Whether textures and materials were imported. Assets loaded
+   * without textures are never handed to a consumer that requires them.
+   */
+  bool hasTextures = false;
+
+  /**
+   * @brief GL context the meshes and textures were uploaded to, or nullptr
+   * if the publisher did not render. GPU resources are only valid in this
+   * context.
+   */
+  const Magnum::GL::Context* glContext = nullptr;
+
+  ESP_SMART_POINTERS(SharedRenderAsset)
+};
+
+/**
+ * @brief Process-wide, reference-counted registry of imported render assets.
+ *
+ * When several @ref esp::sim::Simulator instances live in one process, the
+ * first @ref ResourceManager to import an asset publishes the result here and
+ * the others adopt the same meshes, textures and collision data instead of
+ * re-importing and re-uploading them. The cache only holds weak references, so
+ * an asset is released as soon as the last @ref ResourceManager using it is
+ * destroyed.
+ *
+ * GPU resources are only shared between consumers rendering through the same
+ * GL context. All methods are thread-safe.
+ */
+class AssetCache {
+ public:
+  /**
+   * @brief Get the process-wide cache instance.
+   */
+  static AssetCache& instance();
+
+  /**
+   * @brief Find a previously published asset compatible with the given
+   * request.
+   *
+   * @param info The @ref AssetInfo of the asset to load; must match the
+   * published one exactly.
+   * @param requiresTextures Whether the consumer needs textures and materials.
+   * @param glContext The consumer's current GL context, or nullptr if it
+   * does not render.
+   * @return The shared asset, or nullptr if none is available.
+   */
+  SharedRenderAsset::cptr find(const AssetInfo& info,
+                               bool requiresTextures,
+                               const Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Publish an imported asset so other consumers can adopt it. The
+   * caller must keep the returned pointer for as long as it uses the asset.
+   */
+  SharedRenderAsset::cptr publish(SharedRenderAsset::uptr asset);
+
+  /**
+   * @brief Number of published assets still referenced by some consumer.
+   */
+  int getNumLiveAssets();
+
+  /**
+   * @brief Disable or re-enable sharing. While disabled, @ref find always
+   * misses and @ref publish does not register. Enabled by default.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Whether sharing is currently enabled.
+   */
+  bool isEnabled();
+
+ private:
+  AssetCache() = default;
+
+  /**
+   * @brief Remove entries whose asset has been released. Must be called with
+   * @ref mutex_ held.
+   */
+  void pruneExpired();
+
+  std::mutex mutex_;
+
+  //! Published assets, keyed by filepath.
+  std::multimap<std::string, std::weak_ptr<const SharedRenderAsset>> assets_;
+
+  bool enabled_ = true;
+};
+
+/**
+ * @brief Make a standalone copy of a material, since @ref
+ * Magnum::Trade::MaterialData is move-only.
+ */
+Magnum::Trade::MaterialData copyMaterialData(
+    const Magnum::Trade::MaterialData& material);
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_ASSETCACHE_H_
@@ -9,9 +9,11 @@
 #include <Magnum/DebugTools/ColorMap.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/PackingBatch.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/RemoveDuplicates.h>
+#include <Magnum/VertexFormat.h>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -32,9 +34,28 @@ bool BaseMesh::setMeshType(SupportedMeshType type) {
 void BaseMesh::convertMeshColors(
     const Mn::Trade::MeshData& srcMeshData,
     bool convertToSRGB,
-    Cr::Containers::Array<Mn::Color3ub>& meshColors) const {
-  /* Assuming colors are 8-bit RGB to avoid expanding them to float and then
-     packing back */
+    Cr::Containers::ArrayView<Mn::Color3ub> meshColors) const {
+  /* 8-bit colors, which is what PLY files have, are read in place instead of
+     expanding the whole attribute to a float copy first */
+  const Mn::VertexFormat format =
+      srcMeshData.attributeFormat(Mn::Trade::MeshAttribute::Color);
+  if (format == Mn::VertexFormat::Vector3ubNormalized ||
+      format == Mn::VertexFormat::Vector4ubNormalized) {
+    const auto srcColors = Cr::Containers::arrayCast<2, const Mn::UnsignedByte>(
+        srcMeshData.attribute(Mn::Trade::MeshAttribute::Color));
+    for (std::size_t i = 0; i != meshColors.size(); ++i) {
+      const Mn::Color3ub color{srcColors[i][0], srcColors[i][1],
+                               srcColors[i][2]};
+      meshColors[i] =
+          convertToSRGB
+              ? Mn::Math::unpack<Mn::Color3>(color).toSrgb<Mn::UnsignedByte>()
+              : color;
+    }
+    return;
+  }
+
+  /* Otherwise assume colors are 8-bit RGB to avoid expanding them to float and
+     then packing back */
   auto colors = srcMeshData.colorsAsArray();
   if (convertToSRGB) {
     for (std::size_t i = 0; i != colors.size(); ++i) {
@@ -51,7 +72,7 @@ void BaseMesh::convertMeshColors(
 
 void BaseMesh::buildColorMapToUse(
     Cr::Containers::Array<Magnum::UnsignedInt>& vertIDs,
-    const Cr::Containers::Array<Mn::Color3ub>& vertColors,
+    Cr::Containers::ArrayView<const Mn::Color3ub> vertColors,
     bool useVertexColors,
     std::vector<Mn::Vector3ub>& colorMapToUse) const {
   colorMapToUse.clear();
@@ -155,7 +155,7 @@ class BaseMesh {
    */
   void buildColorMapToUse(
       Corrade::Containers::Array<Magnum::UnsignedInt>& vertIDs,
-      const Cr::Containers::Array<Mn::Color3ub>& vertColors,
+      Cr::Containers::ArrayView<const Mn::Color3ub> vertColors,
       bool useVertexColors,
       std::vector<Mn::Vector3ub>& colorMapToUse) const;
 
@@ -166,11 +166,13 @@ class BaseMesh {
    * @param srcMeshData The meshdata containing the colors we wish to query
    * @param convertToSRGB Whether the source vertex colors from the @p
    * srcMeshData should be converted to SRGB
-   * @param [out] destColors The per-element array of colors to be built.
+   * @param [out] destColors The per-element array of colors to be built, sized
+   * to the vertex count of @p srcMeshData.
    */
-  void convertMeshColors(const Mn::Trade::MeshData& srcMeshData,
-                         bool convertToSRGB,
-                         Cr::Containers::Array<Mn::Color3ub>& destColors) const;
+  void convertMeshColors(
+      const Mn::Trade::MeshData& srcMeshData,
+      bool convertToSRGB,
+      Cr::Containers::ArrayView<Mn::Color3ub> destColors) const;
 
   /**
    * @brief Identifies the derived type of this object and the format of the
@@ -7,14 +7,215 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/MeshTools/Copy.h>
+#include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
+#include <Magnum/MeshTools/Tipsify.h>
+
+#include <cstring>
+#include <unordered_map>
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
 namespace esp {
 namespace assets {
 
+namespace {
+
+/* Cells along the largest side of the bounding box for the first level of
+   detail, halved for every following level */
+constexpr int lodBaseGridSize = 128;
+
+/* Collapses all vertices falling into the same grid cell onto the first one
+   of them and returns the triangles that didn't degenerate in the process */
+Cr::Containers::Array<Mn::UnsignedInt> clusterTriangles(
+    Cr::Containers::ArrayView<const Mn::Vector3> positions,
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> indices,
+    const Mn::Vector3& origin,
+    float cellSize) {
+  std::unordered_map<std::uint64_t, Mn::UnsignedInt> representatives;
+  Cr::Containers::Array<Mn::UnsignedInt> remap{Cr::NoInit, positions.size()};
+  for (std::size_t i = 0; i != positions.size(); ++i) {
+    const Mn::Vector3i cell =
+        Mn::Math::max(Mn::Vector3i{(positions[i] - origin) / cellSize}, 0);
+    const std::uint64_t key = std::uint64_t(cell.x()) |
+                              std::uint64_t(cell.y()) << 21 |
+                              std::uint64_t(cell.z()) << 42;
+    remap[i] = representatives.emplace(key, Mn::UnsignedInt(i)).first->second;
+  }
+
+  Cr::Containers::Array<Mn::UnsignedInt> out;
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const Mn::UnsignedInt a = remap[indices[i]];
+    const Mn::UnsignedInt b = remap[indices[i + 1]];
+    const Mn::UnsignedInt c = remap[indices[i + 2]];
+    if (a != b && b != c && a != c) {
+      arrayAppend(out, {a, b, c});
+    }
+  }
+  return out;
+}
+
+/* Post-transform vertex cache size assumed when reordering indices */
+constexpr std::size_t vertexCacheSize = 24;
+
+/* Bump whenever the cache file layout or the optimizations change, so stale
+   cache entries aren't used */
+constexpr Mn::UnsignedInt meshCacheVersion = 1;
+constexpr char meshCacheMagic[4]{'H', 'S', 'M', 'C'};
+
+struct MeshCacheHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedInt primitive;
+  Mn::UnsignedInt indexType;
+  Mn::UnsignedInt indexCount;
+  Mn::UnsignedInt vertexCount;
+  Mn::UnsignedInt vertexDataSize;
+  Mn::UnsignedInt attributeCount;
+};
+
+struct MeshCacheAttribute {
+  Mn::UnsignedInt name;
+  Mn::UnsignedInt format;
+  Mn::UnsignedInt offset;
+  Mn::UnsignedInt stride;
+  Mn::UnsignedInt arraySize;
+};
+
+/* Smaller vertex format for an attribute, or the original one if it can't be
+   packed without visible loss. Positions stay floats, the shaders have no
+   way to dequantize them and the collision data is derived from them. */
+Mn::VertexFormat packedVertexFormat(Mn::Trade::MeshAttribute name,
+                                    Mn::VertexFormat format,
+                                    Mn::UnsignedShort arraySize) {
+  if (arraySize != 0) {
+    return format;
+  }
+  if ((name == Mn::Trade::MeshAttribute::Normal ||
+       name == Mn::Trade::MeshAttribute::Tangent ||
+       name == Mn::Trade::MeshAttribute::Bitangent) &&
+      format == Mn::VertexFormat::Vector3) {
+    return Mn::VertexFormat::Vector3sNormalized;
+  }
+  if (name == Mn::Trade::MeshAttribute::Tangent &&
+      format == Mn::VertexFormat::Vector4) {
+    return Mn::VertexFormat::Vector4sNormalized;
+  }
+  // texture coordinates may be outside of [0, 1] for repeated textures, so
+  // half-floats instead of normalized integers
+  if (name == Mn::Trade::MeshAttribute::TextureCoordinates &&
+      format == Mn::VertexFormat::Vector2) {
+    return Mn::VertexFormat::Vector2h;
+  }
+  return format;
+}
+
+/* Copy of an interleaved @p mesh with attributes in packedVertexFormat(), or
+   NullOpt if there's nothing to pack */
+Cr::Containers::Optional<Mn::Trade::MeshData> packAttributes(
+    const Mn::Trade::MeshData& mesh) {
+  if (mesh.isIndexed() &&
+      Mn::isMeshIndexTypeImplementationSpecific(mesh.indexType())) {
+    return Cr::Containers::NullOpt;
+  }
+  const Mn::UnsignedInt vertexCount = mesh.vertexCount();
+  Cr::Containers::Array<Mn::VertexFormat> formats{Cr::NoInit,
+                                                  mesh.attributeCount()};
+  Cr::Containers::Array<std::size_t> offsets{Cr::NoInit,
+                                             mesh.attributeCount()};
+  std::size_t stride = 0;
+  bool packed = false;
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    const Mn::VertexFormat format = mesh.attributeFormat(i);
+    if (Mn::isVertexFormatImplementationSpecific(format)) {
+      return Cr::Containers::NullOpt;
+    }
+    formats[i] = packedVertexFormat(mesh.attributeName(i), format,
+                                    mesh.attributeArraySize(i));
+    packed = packed || formats[i] != format;
+    offsets[i] = stride;
+    // keep every attribute four-byte aligned
+    const std::size_t size =
+        Mn::vertexFormatSize(formats[i]) *
+        Mn::Math::max<std::size_t>(mesh.attributeArraySize(i), 1);
+    stride += (size + 3) & ~std::size_t{3};
+  }
+  if (!packed) {
+    return Cr::Containers::NullOpt;
+  }
+
+  Cr::Containers::Array<char> vertexData{Cr::ValueInit, stride * vertexCount};
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributes{
+      Cr::ValueInit, mesh.attributeCount()};
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    const Mn::VertexFormat format = mesh.attributeFormat(i);
+    const Cr::Containers::StridedArrayView1D<char> dst{
+        vertexData, vertexData.data() + offsets[i], vertexCount,
+        std::ptrdiff_t(stride)};
+    if (formats[i] == format) {
+      const Cr::Containers::StridedArrayView2D<const char> src =
+          mesh.attribute(i);
+      Cr::Utility::copy(src, Cr::Containers::StridedArrayView2D<char>{
+                                 vertexData,
+                                 vertexData.data() + offsets[i],
+                                 {vertexCount, src.size()[1]},
+                                 {std::ptrdiff_t(stride), 1}});
+    } else if (format == Mn::VertexFormat::Vector3) {
+      Mn::Math::packInto(
+          Cr::Containers::arrayCast<2, const Mn::Float>(
+              mesh.attribute<Mn::Vector3>(i)),
+          Cr::Containers::arrayCast<2, Mn::Short>(
+              Cr::Containers::arrayCast<Mn::Vector3s>(dst)));
+    } else if (format == Mn::VertexFormat::Vector4) {
+      Mn::Math::packInto(
+          Cr::Containers::arrayCast<2, const Mn::Float>(
+              mesh.attribute<Mn::Vector4>(i)),
+          Cr::Containers::arrayCast<2, Mn::Short>(
+              Cr::Containers::arrayCast<Mn::Vector4s>(dst)));
+    } else {
+      CORRADE_INTERNAL_ASSERT(format == Mn::VertexFormat::Vector2);
+      Mn::Math::packHalfInto(
+          Cr::Containers::arrayCast<2, const Mn::Float>(
+              mesh.attribute<Mn::Vector2>(i)),
+          Cr::Containers::arrayCast<2, Mn::UnsignedShort>(
+              Cr::Containers::arrayCast<Mn::Vector2us>(dst)));
+    }
+    attributes[i] = Mn::Trade::MeshAttributeData{
+        mesh.attributeName(i), formats[i], dst, mesh.attributeArraySize(i)};
+  }
+
+  if (!mesh.isIndexed()) {
+    return Mn::Trade::MeshData{mesh.primitive(), std::move(vertexData),
+                               std::move(attributes), vertexCount};
+  }
+  const Cr::Containers::StridedArrayView2D<const char> srcIndices =
+      mesh.indices();
+  Cr::Containers::Array<char> indexData{
+      Cr::NoInit, srcIndices.size()[0] * srcIndices.size()[1]};
+  Cr::Utility::copy(srcIndices, Cr::Containers::StridedArrayView2D<char>{
+                                    indexData, srcIndices.size()});
+  const Mn::Trade::MeshIndexData indices{mesh.indexType(), indexData};
+  return Mn::Trade::MeshData{mesh.primitive(),       std::move(indexData),
+                             indices,                std::move(vertexData),
+                             std::move(attributes), vertexCount};
+}
+
+}  // namespace
+
 void GenericMeshData::uploadBuffersToGPU(bool forceReload) {
   if (forceReload) {
     buffersOnGPU_ = false;
@@ -32,6 +233,10 @@ void GenericMeshData::uploadBuffersToGPU(bool forceReload) {
   }
   // position, normals, uv, colors are bound to corresponding attributes
   renderingBuffer_->mesh = Magnum::MeshTools::compile(*meshData_, compileFlags);
+  for (const LodLevel& level : lodLevels_) {
+    renderingBuffer_->lodMeshes.emplace_back(
+        Magnum::MeshTools::compile(level.meshData, compileFlags));
+  }
 
   buffersOnGPU_ = true;
 }
@@ -44,6 +249,247 @@ Magnum::GL::Mesh* GenericMeshData::getMagnumGLMesh() {
   return &(renderingBuffer_->mesh);
 }
 
+Magnum::GL::Mesh* GenericMeshData::getLodMagnumGLMesh(std::size_t level) {
+  if (renderingBuffer_ == nullptr ||
+      level >= renderingBuffer_->lodMeshes.size()) {
+    return nullptr;
+  }
+
+  return &(renderingBuffer_->lodMeshes[level]);
+}
+
+void GenericMeshData::optimizeForRendering() {
+  if (!meshData_) {
+    return;
+  }
+  Cr::Containers::Optional<Mn::Trade::MeshData> mesh =
+      packAttributes(*meshData_);
+  if (!mesh) {
+    // a no-op if the data are owned already, which imported data are
+    mesh = Mn::MeshTools::copy(*std::move(meshData_));
+  }
+
+  if (mesh->isIndexed() &&
+      mesh->primitive() == Mn::MeshPrimitive::Triangles) {
+    switch (mesh->indexType()) {
+      case Mn::MeshIndexType::UnsignedByte:
+        Mn::MeshTools::tipsifyInPlace(
+            mesh->mutableIndices<Mn::UnsignedByte>(), mesh->vertexCount(),
+            vertexCacheSize);
+        break;
+      case Mn::MeshIndexType::UnsignedShort:
+        Mn::MeshTools::tipsifyInPlace(
+            mesh->mutableIndices<Mn::UnsignedShort>(), mesh->vertexCount(),
+            vertexCacheSize);
+        break;
+      case Mn::MeshIndexType::UnsignedInt:
+        Mn::MeshTools::tipsifyInPlace(mesh->mutableIndices<Mn::UnsignedInt>(),
+                                      mesh->vertexCount(), vertexCacheSize);
+        break;
+      default:
+        break;
+    }
+  }
+
+  setMeshData(*std::move(mesh));
+}  // optimizeForRendering
+
+std::string GenericMeshData::getCacheFilename(const std::string& cacheDir,
+                                              const std::string& assetKey,
+                                              int meshID) {
+  const std::string key = Cr::Utility::formatString(
+      "{}-mesh={}-version={}", assetKey, meshID, meshCacheVersion);
+  return Cr::Utility::Path::join(
+      cacheDir,
+      "mesh_" + Cr::Utility::MurmurHash2{}(key).hexString() + ".bin");
+}
+
+bool GenericMeshData::loadMeshDataFromCache(const std::string& filename) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  return data && deserializeMeshData(*data);
+}  // loadMeshDataFromCache
+
+bool GenericMeshData::deserializeMeshData(
+    Cr::Containers::ArrayView<const char> data) {
+  if (data.size() < sizeof(MeshCacheHeader)) {
+    return false;
+  }
+  MeshCacheHeader header;
+  std::memcpy(&header, data.data(), sizeof(MeshCacheHeader));
+  const auto indexType = Mn::MeshIndexType(header.indexType);
+  if (std::memcmp(header.magic, meshCacheMagic, sizeof(meshCacheMagic)) ||
+      header.version != meshCacheVersion ||
+      (indexType != Mn::MeshIndexType::UnsignedByte &&
+       indexType != Mn::MeshIndexType::UnsignedShort &&
+       indexType != Mn::MeshIndexType::UnsignedInt)) {
+    return false;
+  }
+  const std::size_t indexOffset =
+      sizeof(MeshCacheHeader) +
+      std::size_t(header.attributeCount) * sizeof(MeshCacheAttribute);
+  const std::size_t vertexOffset =
+      indexOffset +
+      std::size_t(header.indexCount) * Mn::meshIndexTypeSize(indexType);
+  if (data.size() != vertexOffset + header.vertexDataSize) {
+    return false;
+  }
+
+  Cr::Containers::Array<char> vertexData{Cr::NoInit, header.vertexDataSize};
+  Cr::Utility::copy(data.exceptPrefix(vertexOffset), vertexData);
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributes{
+      Cr::ValueInit, header.attributeCount};
+  for (Mn::UnsignedInt i = 0; i != header.attributeCount; ++i) {
+    MeshCacheAttribute attribute;
+    std::memcpy(&attribute,
+                data.data() + sizeof(MeshCacheHeader) +
+                    i * sizeof(MeshCacheAttribute),
+                sizeof(MeshCacheAttribute));
+    const auto format = Mn::VertexFormat(attribute.format);
+    if (header.vertexCount == 0 ||
+        attribute.offset + std::size_t(header.vertexCount - 1) *
+                                   attribute.stride +
+                Mn::vertexFormatSize(format) *
+                    Mn::Math::max<std::size_t>(attribute.arraySize, 1) >
+            header.vertexDataSize) {
+      return false;
+    }
+    attributes[i] = Mn::Trade::MeshAttributeData{
+        Mn::Trade::MeshAttribute(attribute.name), format,
+        Cr::Containers::StridedArrayView1D<const void>{
+            vertexData, vertexData.data() + attribute.offset,
+            header.vertexCount, std::ptrdiff_t(attribute.stride)},
+        Mn::UnsignedShort(attribute.arraySize)};
+  }
+  Cr::Containers::Array<char> indexData{
+      Cr::NoInit, vertexOffset - indexOffset};
+  Cr::Utility::copy(data.slice(indexOffset, vertexOffset), indexData);
+  const Mn::Trade::MeshIndexData indices{indexType, indexData};
+
+  setMeshData(Mn::Trade::MeshData{
+      Mn::MeshPrimitive(header.primitive), std::move(indexData), indices,
+      std::move(vertexData), std::move(attributes), header.vertexCount});
+  return true;
+}  // deserializeMeshData
+
+bool GenericMeshData::saveMeshDataToCache(const std::string& filename) const {
+  Cr::Containers::Array<char> data = serializeMeshData();
+  if (data.isEmpty() ||
+      !Cr::Utility::Path::make(Cr::Utility::Path::split(filename).first())) {
+    return false;
+  }
+  // other processes may be reading or writing the same cache entry, so only
+  // move the file in place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&data));
+  return Cr::Utility::Path::write(tmpFilename, data) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveMeshDataToCache
+
+Cr::Containers::Array<char> GenericMeshData::serializeMeshData() const {
+  if (!meshData_ || !meshData_->isIndexed() ||
+      Mn::isMeshIndexTypeImplementationSpecific(meshData_->indexType())) {
+    return {};
+  }
+  const Mn::Trade::MeshData& mesh = *meshData_;
+  const Cr::Containers::StridedArrayView2D<const char> indices =
+      mesh.indices();
+  const std::size_t indexOffset =
+      sizeof(MeshCacheHeader) +
+      mesh.attributeCount() * sizeof(MeshCacheAttribute);
+  const std::size_t vertexOffset =
+      indexOffset + indices.size()[0] * indices.size()[1];
+  Cr::Containers::Array<char> data{Cr::ValueInit,
+                                   vertexOffset + mesh.vertexData().size()};
+
+  MeshCacheHeader header{};
+  std::memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+  header.version = meshCacheVersion;
+  header.primitive = Mn::UnsignedInt(mesh.primitive());
+  header.indexType = Mn::UnsignedInt(mesh.indexType());
+  header.indexCount = mesh.indexCount();
+  header.vertexCount = mesh.vertexCount();
+  header.vertexDataSize = mesh.vertexData().size();
+  header.attributeCount = mesh.attributeCount();
+  std::memcpy(data.data(), &header, sizeof(MeshCacheHeader));
+  for (Mn::UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+    // setMeshData() interleaves, so strides are never negative
+    if (Mn::isVertexFormatImplementationSpecific(mesh.attributeFormat(i)) ||
+        mesh.attributeStride(i) < 0) {
+      return {};
+    }
+    const MeshCacheAttribute attribute{
+        Mn::UnsignedInt(mesh.attributeName(i)),
+        Mn::UnsignedInt(mesh.attributeFormat(i)),
+        Mn::UnsignedInt(mesh.attributeOffset(i)),
+        Mn::UnsignedInt(mesh.attributeStride(i)),
+        mesh.attributeArraySize(i)};
+    std::memcpy(data.data() + sizeof(MeshCacheHeader) +
+                    i * sizeof(MeshCacheAttribute),
+                &attribute, sizeof(MeshCacheAttribute));
+  }
+  Cr::Utility::copy(indices, Cr::Containers::StridedArrayView2D<char>{
+                                 data.slice(indexOffset, vertexOffset),
+                                 indices.size()});
+  Cr::Utility::copy(mesh.vertexData(), data.exceptPrefix(vertexOffset));
+  return data;
+}  // serializeMeshData
+
+void GenericMeshData::generateLodLevels(int levelCount) {
+  lodLevels_.clear();
+  if (!meshData_ || !meshData_->isIndexed() ||
+      meshData_->primitive() != Mn::MeshPrimitive::Triangles ||
+      collisionMeshData_.positions.isEmpty()) {
+    return;
+  }
+
+  const Mn::Range3D bounds{Mn::Math::minmax(collisionMeshData_.positions)};
+  const float extent = bounds.size().max();
+  if (extent <= 0.0f) {
+    return;
+  }
+
+  std::size_t previousIndexCount = collisionMeshData_.indices.size();
+  for (int level = 0; level != levelCount; ++level) {
+    const int gridSize = lodBaseGridSize >> level;
+    if (gridSize < 1) {
+      break;
+    }
+    Cr::Containers::Array<Mn::UnsignedInt> indices =
+        clusterTriangles(collisionMeshData_.positions,
+                         collisionMeshData_.indices, bounds.min(),
+                         extent / float(gridSize));
+    // nothing left to draw, the coarser levels won't have anything either
+    if (indices.isEmpty()) {
+      break;
+    }
+    // not worth an extra mesh, try a coarser grid instead
+    if (indices.size() * 10 > previousIndexCount * 9) {
+      continue;
+    }
+    previousIndexCount = indices.size();
+
+    /* Reference the original vertices with the reduced index buffer, then
+       throw away the vertices no longer referenced */
+    const Mn::Trade::MeshIndexData indexData{indices};
+    const Mn::Trade::MeshData clustered{
+        Mn::MeshPrimitive::Triangles,
+        {},
+        indices,
+        indexData,
+        {},
+        meshData_->vertexData(),
+        Mn::Trade::meshAttributeDataNonOwningArray(meshData_->attributeData()),
+        meshData_->vertexCount()};
+    lodLevels_.push_back(
+        {Mn::MeshTools::removeDuplicates(Mn::MeshTools::duplicate(clustered)),
+         float(gridSize)});
+  }
+}  // generateLodLevels
+
 void GenericMeshData::setMeshData(Magnum::Trade::MeshData&& meshData) {
   /* Interleave the mesh, if not already. This makes the GPU happier (better
      cache locality for vertex fetching) and is a no-op if the source data is
@@ -10,9 +10,11 @@
  * esp::assets::GenericMeshData::RenderingBuffer
  */
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <vector>
 
 #include "BaseMesh.h"
 #include "esp/core/Esp.h"
@@ -34,6 +36,12 @@ class GenericMeshData : public BaseMesh {
      * @brief Compiled openGL render data for the mesh.
      */
     Magnum::GL::Mesh mesh;
+
+    /**
+     * @brief Compiled openGL render data for each level of detail, see @ref
+     * generateLodLevels().
+     */
+    std::vector<Magnum::GL::Mesh> lodMeshes;
   };
 
   /**
@@ -83,6 +91,84 @@ class GenericMeshData : public BaseMesh {
   void importAndSetMeshData(Magnum::Trade::AbstractImporter& importer,
                             const std::string& meshName);
 
+  /**
+   * @brief Optimize the mesh for rendering. Reorders the indices of indexed
+   * triangle meshes for post-transform vertex cache locality and packs
+   * normals, tangents and texture coordinates into smaller vertex formats.
+   * Has to be called before @ref generateLodLevels() and
+   * @ref uploadBuffersToGPU().
+   */
+  void optimizeForRendering();
+
+  /**
+   * @brief Path of the file to cache the optimized mesh @p meshID of the
+   * asset identified by @p assetKey in, see @ref saveMeshDataToCache()
+   */
+  static std::string getCacheFilename(const std::string& cacheDir,
+                                      const std::string& assetKey,
+                                      int meshID);
+
+  /**
+   * @brief Set the mesh data from a file written by @ref
+   * saveMeshDataToCache(). Sets the @ref collisionMeshData_ references.
+   * @return Whether the file exists and could be loaded.
+   */
+  bool loadMeshDataFromCache(const std::string& filename);
+
+  /**
+   * @brief Save the mesh data to @p filename, so a later run can load them
+   * with @ref loadMeshDataFromCache() instead of importing and optimizing
+   * them again. Only indexed meshes can be saved.
+   * @return Whether the file could be written.
+   */
+  bool saveMeshDataToCache(const std::string& filename) const;
+
+  /**
+   * @brief Set the mesh data from @p data laid out by @ref
+   * serializeMeshData(). The data are copied, so @p data can be a view on a
+   * mapped file. Sets the @ref collisionMeshData_ references.
+   * @return Whether @p data is valid.
+   */
+  bool deserializeMeshData(Corrade::Containers::ArrayView<const char> data);
+
+  /**
+   * @brief Lay out the mesh data as a single block that @ref
+   * deserializeMeshData() can set them from without any processing, in the
+   * format written by @ref saveMeshDataToCache(). Only indexed meshes can be
+   * serialized.
+   * @return The serialized data, empty on failure.
+   */
+  Corrade::Containers::Array<char> serializeMeshData() const;
+
+  /**
+   * @brief Generate up to @p levelCount simplified versions of the mesh by
+   * clustering its vertices on successively coarser grids. Has to be called
+   * before @ref uploadBuffersToGPU(). Levels that wouldn't remove at least a
+   * tenth of the triangles of the previous one are skipped, only indexed
+   * triangle meshes get any.
+   */
+  void generateLodLevels(int levelCount);
+
+  /**
+   * @brief Number of simplified levels generated by @ref generateLodLevels()
+   */
+  std::size_t getLodLevelCount() const { return lodLevels_.size(); }
+
+  /**
+   * @brief Projected size of the mesh in pixels below which level @p level
+   * can be drawn instead of the full mesh without visible difference.
+   * Levels are ordered from the most to the least detailed.
+   */
+  float getLodMaxPixelSize(std::size_t level) const {
+    return lodLevels_[level].maxPixelSize;
+  }
+
+  /**
+   * @brief Returns a pointer to the compiled render mesh data of level @p
+   * level, or nullptr if the buffers weren't uploaded yet.
+   */
+  Magnum::GL::Mesh* getLodMagnumGLMesh(std::size_t level);
+
   /**
    * @brief Returns a pointer to the compiled render data storage structure.
    * @return Pointer to the @ref renderingBuffer_.
@@ -116,6 +202,12 @@ class GenericMeshData : public BaseMesh {
      MeshData doesn't have them in desired type */
   Corrade::Containers::Array<Magnum::Vector3> positionData_;
   Corrade::Containers::Array<Magnum::UnsignedInt> indexData_;
+
+  struct LodLevel {
+    Magnum::Trade::MeshData meshData;
+    float maxPixelSize;
+  };
+  std::vector<LodLevel> lodLevels_;
 };
 }  // namespace assets
 }  // namespace esp
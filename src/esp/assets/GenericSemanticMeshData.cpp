@@ -74,13 +74,13 @@ GenericSemanticMeshData::buildSemanticMeshData(
 
   srcMeshData.indicesInto(semanticMeshData->cpu_ibo_);
 
-  // initialize per-vertex color array
-  Cr::Containers::Array<Mn::Color3ub> meshColors{Mn::NoInit, numVerts};
-  // build color array from colors present in mesh
-  semanticMeshData->convertMeshColors(srcMeshData, convertToSRGB, meshColors);
-
-  Cr::Utility::copy(meshColors,
-                    Cr::Containers::arrayView(semanticMeshData->cpu_cbo_));
+  // build color array from colors present in mesh, straight into the
+  // per-vertex color buffer
+  semanticMeshData->convertMeshColors(
+      srcMeshData, convertToSRGB,
+      Cr::Containers::arrayView(semanticMeshData->cpu_cbo_));
+  const Cr::Containers::ArrayView<const Mn::Color3ub> meshColors =
+      Cr::Containers::arrayView(semanticMeshData->cpu_cbo_);
 
   // Check we actually have object IDs before copying them, and that those are
   // in a range we expect them to be
@@ -280,7 +280,7 @@ GenericSemanticMeshData::buildSemanticMeshData(
       // build adj list to use to derive CCs
       // Assumes that index buffer defines triangle polys in sequential groups
       // of 3 vert idxs
-      const std::vector<std::set<uint32_t>> adjList = geo::buildAdjList(
+      const geo::AdjacencyList adjList = geo::buildAdjList(
           semanticMeshData->cpu_vbo_.size(), semanticMeshData->cpu_ibo_);
 
       // find all connected components based on adj list and vertex color.
@@ -296,12 +296,14 @@ GenericSemanticMeshData::buildSemanticMeshData(
               semanticMeshData->cpu_vbo_, clrsToComponents, semanticScene,
               fractionOfMaxBBoxSize, dbgMsgPrefix);
     } else {
-      // FOR VERT-BASED OBB CALC build semantic (actually AABBs currently)
-      // uses all vertex annotations, including disconnected components.
+      // FOR VERT-BASED OBB CALC build semantic AABBs, or minimum volume OBBs
+      // if requested, using all vertex annotations, including disconnected
+      // components.
       semanticMeshData->unMappedObjectIDXs =
           scene::SemanticScene::buildSemanticOBBs(
               semanticMeshData->cpu_vbo_, semanticMeshData->objectIds_,
-              semanticScene->objects(), dbgMsgPrefix);
+              semanticScene->objects(), dbgMsgPrefix,
+              semanticScene->useMinVolumeOBBs());
     }
   }
   // display or save report denoting presence of semantic object-defined colors
@@ -392,7 +394,7 @@ std::unordered_map<uint32_t, std::vector<scene::CCSemanticObject::ptr>>
 GenericSemanticMeshData::buildCCBasedSemanticObjs(
     const std::shared_ptr<scene::SemanticScene>& semanticScene) {
   // build adj list
-  std::vector<std::set<uint32_t>> adjList =
+  const geo::AdjacencyList adjList =
       geo::buildAdjList(cpu_vbo_.size(), cpu_ibo_);
   // find all connected components based on vertex color.
   std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
@@ -22,6 +22,7 @@
 #include <Corrade/Utility/String.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/TextureFormat.h>
@@ -50,14 +51,24 @@
 #include <Magnum/Trade/TextureData.h>
 #include <Magnum/VertexFormat.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 
+#include "esp/assets/AssetCache.h"
 #include "esp/assets/BaseMesh.h"
 #include "esp/assets/CollisionMeshData.h"
 #include "esp/assets/GenericSemanticMeshData.h"
 #include "esp/assets/MeshMetaData.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
+#include "esp/assets/StageBundle.h"
+#include "esp/assets/TextureCompression.h"
 #include "esp/geo/Geo.h"
 #include "esp/gfx/DrawableConfiguration.h"
 #include "esp/gfx/GenericDrawable.h"
@@ -130,10 +141,28 @@ ResourceManager::ResourceManager(
 
 ResourceManager::~ResourceManager() = default;
 
+namespace {
+
+/**
+ * @brief Pick the same plugins in @p manager as in
+ * @ref ResourceManager::importerManager_, which plugin configuration alone
+ * doesn't cover
+ */
+void setPreferredImporterPlugins(
+    Cr::PluginManager::Manager<ResourceManager::Importer>& manager) {
+#ifdef ESP_BUILD_ASSIMP_SUPPORT
+  manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
+#else
+  static_cast<void>(manager);
+#endif
+}
+
+}  // namespace
+
 void ResourceManager::buildImporters() {
   // Preferred plugins, Basis target GPU format
+  setPreferredImporterPlugins(importerManager_);
 #ifdef ESP_BUILD_ASSIMP_SUPPORT
-  importerManager_.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
   Cr::PluginManager::PluginMetadata* const assimpmetadata =
       importerManager_.metadata("AssimpImporter");
   assimpmetadata->configuration().setValue("ImportColladaIgnoreUpDirection",
@@ -171,6 +200,61 @@ void ResourceManager::buildImporters() {
   primitiveImporter_->openData("");
 }  // buildImporters
 
+namespace {
+
+Cr::Containers::Optional<Cr::Containers::ArrayView<const char>>
+prefetchedFileCallback(
+    const std::string& filename,
+    const Mn::InputFileCallbackPolicy policy,
+    std::unordered_map<std::string, Cr::Containers::Array<char>>& files) {
+  /* Everything is released at once in clearPrefetchedFiles() */
+  if (policy == Mn::InputFileCallbackPolicy::Close)
+    return {};
+
+  auto found = files.find(filename);
+  if (found == files.end()) {
+    Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(filename);
+    if (!data)
+      return {};
+    found = files.emplace(filename, *std::move(data)).first;
+  }
+  return Cr::Containers::ArrayView<const char>{found->second};
+}
+
+}  // namespace
+
+void ResourceManager::setPrefetchedFiles(
+    std::unordered_map<std::string, Cr::Containers::Array<char>>&& files) {
+  // the callback can't be changed while a file is opened
+  fileImporter_->close();
+  prefetchedFiles_ = std::move(files);
+  fileImporter_->setFileCallback(prefetchedFileCallback, prefetchedFiles_);
+}  // ResourceManager::setPrefetchedFiles
+
+void ResourceManager::addPrefetchedFiles(
+    std::unordered_map<std::string, Cr::Containers::Array<char>>&& files) {
+  if (!hasPrefetchedFiles()) {
+    setPrefetchedFiles(std::move(files));
+    return;
+  }
+  // files already handed out to the importer stay where they are
+  for (auto& file : files) {
+    prefetchedFiles_.emplace(file.first, std::move(file.second));
+  }
+}  // ResourceManager::addPrefetchedFiles
+
+bool ResourceManager::hasPrefetchedFiles() const {
+  return fileImporter_->fileCallback() != nullptr;
+}
+
+void ResourceManager::clearPrefetchedFiles() {
+  // the importer may still reference the data
+  fileImporter_->close();
+  fileImporter_->setFileCallback(nullptr);
+  prefetchedFiles_.clear();
+}  // ResourceManager::clearPrefetchedFiles
+
 bool ResourceManager::getCreateRenderer() const {
   return metadataMediator_->getCreateRenderer();
 }
@@ -322,6 +406,9 @@ bool ResourceManager::loadSemanticScene(
 
     success = scene::SemanticScene::loadSemanticSceneDescriptor(
         semanticAttr, *semanticScene_);
+    semanticScene_->setUseMinVolumeOBBs(
+        metadataMediator_->getSimulatorConfiguration()
+            .useMinVolumeSemanticOBBs);
 
     ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
         << "Attempt to create SemanticScene for Current Scene :`"
@@ -340,6 +427,7 @@ void ResourceManager::buildSemanticColorMap() {
 
   semanticColorMapBeingUsed_.clear();
   semanticColorAsInt_.clear();
+  semanticColorLookup_ = SemanticColorLookup{};
   const auto& ssdClrMap = semanticScene_->getSemanticColorMap();
   if (ssdClrMap.empty()) {
     return;
@@ -356,6 +444,7 @@ void ResourceManager::buildSemanticColorMap() {
 
 void ResourceManager::buildSemanticColorAsIntMap() {
   semanticColorAsInt_.clear();
+  semanticColorLookup_ = SemanticColorLookup{};
   if (semanticColorMapBeingUsed_.empty()) {
     return;
   }
@@ -368,6 +457,7 @@ void ResourceManager::buildSemanticColorAsIntMap() {
                  [](const Mn::Color3ub& color) -> uint32_t {
                    return geo::getValueAsUInt(color);
                  });
+  semanticColorLookup_ = SemanticColorLookup{semanticColorAsInt_};
 }
 
 bool ResourceManager::loadStage(
@@ -498,8 +588,6 @@ bool ResourceManager::loadStage(
         << "Stage render mesh load failed, Aborting stage initialization.";
     return false;
   }
-  // declare mesh group variable
-  std::vector<CollisionMeshData> meshGroup;
   AssetInfo& infoToUse = renderInfo;
   auto colInfoIter = assetInfoMap.find("collision");
   if (colInfoIter != assetInfoMap.end()) {
@@ -525,18 +613,10 @@ bool ResourceManager::loadStage(
       infoToUse = colInfo;
     }  // if not colInfo.filepath.compare(EMPTY_SCENE)
   }    // if collision mesh desired
-  // build the appropriate mesh groups, either for the collision mesh, or, if
-  // the collision mesh is empty scene
-
+  // the collision mesh group is only built once the physics manager actually
+  // needs it, see getCollisionMesh()
   if ((_physicsManager != nullptr) && (infoToUse.filepath != EMPTY_SCENE)) {
-    bool success = buildMeshGroups(infoToUse, meshGroup);
-    if (!success) {
-      return false;
-    }
     //! Add to physics manager - will only be null for certain tests
-    // Either add with pre-built meshGroup if collision assets are loaded
-    // or empty vector for mesh group - this should only be the case if
-    // we are using None-type physicsManager.
     bool sceneSuccess = _physicsManager->addStageInstance(
         stageAttributes, stageInstanceAttributes);
     if (!sceneSuccess) {
@@ -551,37 +631,27 @@ bool ResourceManager::loadStage(
 
 bool ResourceManager::buildMeshGroups(
     const AssetInfo& info,
-    std::vector<CollisionMeshData>& meshGroup) {
-  auto colMeshGroupIter = collisionMeshGroups_.find(info.filepath);
-  if (colMeshGroupIter == collisionMeshGroups_.end()) {
-    //! Collect collision mesh group
-    bool colMeshGroupSuccess = false;
-    if ((info.type == AssetType::INSTANCE_MESH) && !info.hasSemanticTextures) {
-      // PLY Semantic mesh
-      colMeshGroupSuccess =
-          buildStageCollisionMeshGroup<GenericSemanticMeshData>(info.filepath,
-                                                                meshGroup);
-    } else if ((info.type == AssetType::MP3D_MESH ||
-                info.type == AssetType::UNKNOWN) ||
-               ((info.type == AssetType::INSTANCE_MESH) &&
-                info.hasSemanticTextures)) {
-      // GLB Mesh
-      colMeshGroupSuccess = buildStageCollisionMeshGroup<GenericMeshData>(
-          info.filepath, meshGroup);
-    }
-
-    // failure during build of collision mesh group
-    if (!colMeshGroupSuccess) {
-      ESP_ERROR() << "Stage" << info.filepath
-                  << "Collision mesh load failed. Aborting scene "
-                     "initialization.";
-      return false;
-    }
-    //! Add scene meshgroup to collision mesh groups
-    collisionMeshGroups_.emplace(info.filepath, meshGroup);
-  } else {
-    // collision meshGroup already exists from prior load
-    meshGroup = colMeshGroupIter->second;
+    std::vector<CollisionMeshData>& meshGroup) const {
+  //! Collect collision mesh group
+  bool colMeshGroupSuccess = false;
+  if ((info.type == AssetType::INSTANCE_MESH) && !info.hasSemanticTextures) {
+    // PLY Semantic mesh
+    colMeshGroupSuccess =
+        buildStageCollisionMeshGroup<GenericSemanticMeshData>(info.filepath,
+                                                              meshGroup);
+  } else if ((info.type == AssetType::MP3D_MESH ||
+              info.type == AssetType::UNKNOWN) ||
+             ((info.type == AssetType::INSTANCE_MESH) &&
+              info.hasSemanticTextures)) {
+    // GLB Mesh
+    colMeshGroupSuccess = buildStageCollisionMeshGroup<GenericMeshData>(
+        info.filepath, meshGroup);
+  }
+
+  // failure during build of collision mesh group
+  if (!colMeshGroupSuccess) {
+    ESP_ERROR() << "Asset" << info.filepath << "Collision mesh load failed.";
+    return false;
   }
   return true;
 }  // ResourceManager::buildMeshGroups
@@ -804,6 +874,10 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
   bool meshSuccess = fileAssetIsLoaded;
   // first load the file asset as-is if necessary
   if (!fileAssetIsLoaded) {
+    // whether this load imported a general asset other ResourceManagers can
+    // share
+    bool publishToAssetCache = false;
+    int materialStart = nextMaterialID_;
     // clone the AssetInfo and remove the custom material to load a default
     // AssetInfo first
     AssetInfo defaultInfo(info);
@@ -819,22 +893,35 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
           << "Loading Semantic Mesh asset named `" << info.filepath << "`.";
       meshSuccess = loadSemanticRenderAsset(defaultInfo);
     } else if (isRenderAssetGeneral(info.type)) {
-      ESP_DEBUG(Mn::Debug::Flag::NoSpace)
-          << "Loading general asset named `" << info.filepath << "`.";
-      meshSuccess = loadRenderAssetGeneral(defaultInfo);
+      if (adoptSharedRenderAsset(defaultInfo)) {
+        ESP_DEBUG(Mn::Debug::Flag::NoSpace)
+            << "Sharing already loaded general asset named `" << info.filepath
+            << "`.";
+        meshSuccess = true;
+      } else if (loadRenderAssetFromStageBundle(defaultInfo)) {
+        ESP_DEBUG(Mn::Debug::Flag::NoSpace)
+            << "Loaded general asset named `" << info.filepath
+            << "` from its stage bundle.";
+        meshSuccess = true;
+        publishToAssetCache = true;
+      } else {
+        ESP_DEBUG(Mn::Debug::Flag::NoSpace)
+            << "Loading general asset named `" << info.filepath << "`.";
+        meshSuccess = loadRenderAssetGeneral(defaultInfo);
+        publishToAssetCache = meshSuccess;
+      }
     } else {
       // loadRenderAsset doesn't yet support the requested asset type
       CORRADE_INTERNAL_ASSERT_UNREACHABLE();
     }
 
     if (meshSuccess) {
-      // create and register the collisionMeshGroups
+      if (publishToAssetCache) {
+        publishSharedRenderAsset(defaultInfo, materialStart);
+      }
+
       if (info.type != AssetType::PRIMITIVE) {
-        std::vector<CollisionMeshData> meshGroup;
-        CORRADE_ASSERT(buildMeshGroups(defaultInfo, meshGroup),
-                       "Failed to construct collisionMeshGroups for asset"
-                           << info.filepath,
-                       false);
+        registerCachedAsset(info.filepath);
       }
 
       if (gfxReplayRecorder_) {
@@ -871,12 +958,6 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
           node->materialID = materialId;
         }
       }
-      if (info.type != AssetType::PRIMITIVE) {
-        // clone the collision data
-        collisionMeshGroups_.emplace(modifiedAssetName,
-                                     collisionMeshGroups_.at(info.filepath));
-      }
-
       if (gfxReplayRecorder_) {
         gfxReplayRecorder_->onLoadRenderAsset(info);
       }
@@ -885,6 +966,91 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
   return meshSuccess;
 }  // ResourceManager::loadRenderAsset
 
+bool ResourceManager::replaceRenderAsset(
+    const std::string& filepath,
+    const std::string& replacementFilepath) {
+  const auto found = resourceDict_.find(filepath);
+  if (found == resourceDict_.end() ||
+      !isRenderAssetGeneral(found->second.assetInfo.type)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "No general render asset `" << filepath << "` loaded to replace.";
+    return false;
+  }
+  if (resourceDict_.count(replacementFilepath) ||
+      !Cr::Utility::Path::exists(replacementFilepath)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Replacement `" << replacementFilepath
+        << "` is already loaded or doesn't exist.";
+    return false;
+  }
+
+  // loaded directly rather than through loadRenderAsset(), as its meshes and
+  // textures end up moved out and shouldn't be shared with anyone
+  AssetInfo replacementInfo = found->second.assetInfo;
+  replacementInfo.filepath = replacementFilepath;
+  replacementInfo.overridePhongMaterial = Cr::Containers::NullOpt;
+  const int meshEnd = nextMeshID_;
+  const int textureEnd = nextTextureID_;
+  const bool loaded = loadRenderAssetGeneral(replacementInfo);
+  const auto replacement = resourceDict_.find(replacementFilepath);
+
+  const auto count = [](const std::pair<int, int>& range) {
+    return range.first == ID_UNDEFINED ? 0 : range.second - range.first + 1;
+  };
+  const MeshMetaData& metaData = found->second.meshMetaData;
+  const bool compatible =
+      loaded && replacement != resourceDict_.end() &&
+      count(replacement->second.meshMetaData.meshIndex) ==
+          count(metaData.meshIndex) &&
+      count(replacement->second.meshMetaData.textureIndex) ==
+          count(metaData.textureIndex);
+  if (compatible) {
+    const MeshMetaData& replacementMetaData =
+        replacement->second.meshMetaData;
+    // drawables point to the GL objects, which are thus moved into the
+    // existing ones instead of replacing them
+    for (int i = 0; i != count(metaData.meshIndex); ++i) {
+      BaseMesh& target = *meshes_.at(metaData.meshIndex.first + i);
+      BaseMesh& source = *meshes_.at(replacementMetaData.meshIndex.first + i);
+      if (target.getMagnumGLMesh() && source.getMagnumGLMesh()) {
+        *target.getMagnumGLMesh() = std::move(*source.getMagnumGLMesh());
+      }
+      for (int level = 0;
+           target.getMagnumGLMesh(level) && source.getMagnumGLMesh(level);
+           ++level) {
+        *target.getMagnumGLMesh(level) =
+            std::move(*source.getMagnumGLMesh(level));
+      }
+    }
+    for (int i = 0; i != count(metaData.textureIndex); ++i) {
+      const int targetID = metaData.textureIndex.first + i;
+      const int sourceID = replacementMetaData.textureIndex.first + i;
+      if (textures_.at(targetID) && textures_.at(sourceID)) {
+        *textures_.at(targetID) = std::move(*textures_.at(sourceID));
+        textureMemory_[targetID] = textureMemory_[sourceID];
+      }
+    }
+  } else if (loaded) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Replacement `" << replacementFilepath
+        << "` doesn't have the same meshes and textures as `" << filepath
+        << "`, keeping the original.";
+  }
+
+  // drop whatever the replacement load added, except for the few materials
+  for (int id = meshEnd; id != nextMeshID_; ++id) {
+    meshes_.erase(id);
+  }
+  for (int id = textureEnd; id != nextTextureID_; ++id) {
+    textures_.erase(id);
+    textureMemory_.erase(id);
+  }
+  if (replacement != resourceDict_.end()) {
+    resourceDict_.erase(replacement);
+  }
+  return compatible;
+}  // ResourceManager::replaceRenderAsset
+
 scene::SceneNode* ResourceManager::createRenderAssetInstance(
     const RenderAssetInstanceCreationInfo& creation,
     scene::SceneNode* parent,
@@ -904,6 +1070,8 @@ scene::SceneNode* ResourceManager::createRenderAssetInstance(
   }
 
   const auto& info = loadedAssetData.assetInfo;
+  touchCachedAsset(info.filepath);
+
   scene::SceneNode* newNode = nullptr;
   if (info.type == AssetType::INSTANCE_MESH) {
     CORRADE_ASSERT(!visNodeCache,
@@ -926,6 +1094,165 @@ scene::SceneNode* ResourceManager::createRenderAssetInstance(
   return newNode;
 }  // ResourceManager::createRenderAssetInstance
 
+void ResourceManager::registerCachedAsset(const std::string& filepath) {
+  auto resourceDictIter = resourceDict_.find(filepath);
+  if (resourceDictIter == resourceDict_.end() ||
+      cachedAssets_.count(filepath) > 0) {
+    return;
+  }
+  const MeshMetaData& meshMetaData = resourceDictIter->second.meshMetaData;
+
+  CachedAssetEntry entry;
+  if (meshMetaData.meshIndex.first != ID_UNDEFINED) {
+    for (int meshID = meshMetaData.meshIndex.first;
+         meshID <= meshMetaData.meshIndex.second; ++meshID) {
+      auto meshIter = meshes_.find(meshID);
+      if (meshIter == meshes_.end() || !meshIter->second ||
+          !meshIter->second->getMeshData()) {
+        continue;
+      }
+      const Mn::Trade::MeshData& meshData = *meshIter->second->getMeshData();
+      entry.cpuBytes +=
+          meshData.vertexData().size() + meshData.indexData().size();
+    }
+  }
+  // the meshes are uploaded as-is, so they take the same memory on the GPU
+  if (getCreateRenderer()) {
+    entry.gpuBytes = entry.cpuBytes;
+  }
+  if (meshMetaData.textureIndex.first != ID_UNDEFINED) {
+    for (int textureID = meshMetaData.textureIndex.first;
+         textureID <= meshMetaData.textureIndex.second; ++textureID) {
+      auto textureMemoryIter = textureMemory_.find(textureID);
+      if (textureMemoryIter != textureMemory_.end()) {
+        entry.gpuBytes += textureMemoryIter->second;
+      }
+    }
+  }
+  entry.sceneEpoch = sceneAssetEpoch_;
+  cachedAssetLru_.push_front(filepath);
+  entry.lruPosition = cachedAssetLru_.begin();
+
+  ++assetCacheStats_.misses;
+  assetCacheStats_.cpuBytes += entry.cpuBytes;
+  assetCacheStats_.gpuBytes += entry.gpuBytes;
+  cachedAssets_.emplace(filepath, entry);
+}  // ResourceManager::registerCachedAsset
+
+void ResourceManager::touchCachedAsset(const std::string& filepath) {
+  auto cachedAssetIter = cachedAssets_.find(filepath);
+  if (cachedAssetIter == cachedAssets_.end()) {
+    return;
+  }
+  CachedAssetEntry& entry = cachedAssetIter->second;
+  // only the first use in a scene of an asset loaded for an earlier one is a
+  // hit, further instances are plain reuse
+  if (entry.sceneEpoch != sceneAssetEpoch_) {
+    ++assetCacheStats_.hits;
+    entry.sceneEpoch = sceneAssetEpoch_;
+  }
+  cachedAssetLru_.splice(cachedAssetLru_.begin(), cachedAssetLru_,
+                         entry.lruPosition);
+}  // ResourceManager::touchCachedAsset
+
+void ResourceManager::releaseCachedAsset(const std::string& filepath) {
+  auto cachedAssetIter = cachedAssets_.find(filepath);
+  CORRADE_INTERNAL_ASSERT(cachedAssetIter != cachedAssets_.end());
+  const CachedAssetEntry& entry = cachedAssetIter->second;
+
+  auto resourceDictIter = resourceDict_.find(filepath);
+  if (resourceDictIter != resourceDict_.end()) {
+    const MeshMetaData& meshMetaData = resourceDictIter->second.meshMetaData;
+    const auto eraseRange = [](auto& resources,
+                               const std::pair<int, int>& range) {
+      if (range.first != ID_UNDEFINED) {
+        resources.erase(resources.lower_bound(range.first),
+                        resources.upper_bound(range.second));
+      }
+    };
+    eraseRange(meshes_, meshMetaData.meshIndex);
+    eraseRange(textures_, meshMetaData.textureIndex);
+    eraseRange(textureMemory_, meshMetaData.textureIndex);
+    eraseRange(skins_, meshMetaData.skinIndex);
+  }
+
+  // material-modified variants share the meshes and go with them
+  for (auto iter = resourceDict_.begin(); iter != resourceDict_.end();) {
+    if (iter->second.assetInfo.filepath == filepath) {
+      collisionMeshGroups_.erase(iter->first);
+      joinedCollisionMeshes_.erase(iter->first);
+      joinedSemanticMeshes_.erase(iter->first);
+      iter = resourceDict_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  collisionMeshGroups_.erase(filepath);
+  joinedCollisionMeshes_.erase(filepath);
+  joinedSemanticMeshes_.erase(filepath);
+  sharedRenderAssets_.erase(
+      std::remove_if(sharedRenderAssets_.begin(), sharedRenderAssets_.end(),
+                     [&filepath](const SharedRenderAsset::cptr& shared) {
+                       return shared->assetInfo.filepath == filepath;
+                     }),
+      sharedRenderAssets_.end());
+
+  ++assetCacheStats_.evictions;
+  assetCacheStats_.cpuBytes -= entry.cpuBytes;
+  assetCacheStats_.gpuBytes -= entry.gpuBytes;
+  cachedAssetLru_.erase(entry.lruPosition);
+  cachedAssets_.erase(cachedAssetIter);
+}  // ResourceManager::releaseCachedAsset
+
+void ResourceManager::evictCachedAssetsOverBudget() {
+  const auto& simConfig = metadataMediator_->getSimulatorConfiguration();
+  const std::size_t cpuBudget = simConfig.assetCacheCpuBudget;
+  const std::size_t gpuBudget = simConfig.assetCacheGpuBudget;
+  const auto overBudget = [&]() {
+    return (cpuBudget != 0 && assetCacheStats_.cpuBytes > cpuBudget) ||
+           (gpuBudget != 0 && assetCacheStats_.gpuBytes > gpuBudget);
+  };
+
+  // walk from the least recently used end, skipping what the current scene
+  // uses
+  auto lruIter = cachedAssetLru_.end();
+  while (overBudget() && lruIter != cachedAssetLru_.begin()) {
+    --lruIter;
+    const CachedAssetEntry& entry = cachedAssets_.at(*lruIter);
+    if (entry.sceneEpoch == sceneAssetEpoch_) {
+      continue;
+    }
+    const std::string filepath = *lruIter;
+    ++lruIter;
+    ESP_DEBUG(Mn::Debug::Flag::NoSpace)
+        << "Evicting render asset `" << filepath << "` from the asset cache.";
+    releaseCachedAsset(filepath);
+  }
+}  // ResourceManager::evictCachedAssetsOverBudget
+
+core::MemoryUsage ResourceManager::getMemoryUsage() const {
+  core::MemoryUsage usage;
+  for (const auto& mesh : meshes_) {
+    if (!mesh.second) {
+      continue;
+    }
+    const Cr::Containers::Optional<Mn::Trade::MeshData>& meshData =
+        mesh.second->getMeshData();
+    if (meshData) {
+      usage.cpuBytes +=
+          meshData->vertexData().size() + meshData->indexData().size();
+    }
+  }
+  // the meshes are uploaded as-is, same as in registerCachedAsset()
+  if (getCreateRenderer()) {
+    usage.gpuBytes = usage.cpuBytes;
+  }
+  for (const auto& texture : textureMemory_) {
+    usage.gpuBytes += texture.second;
+  }
+  return usage;
+}  // ResourceManager::getMemoryUsage
+
 bool ResourceManager::loadStageInternal(
     const AssetInfo& info,
     const RenderAssetInstanceCreationInfo* creation,
@@ -982,7 +1309,7 @@ bool ResourceManager::loadStageInternal(
 template <class T>
 bool ResourceManager::buildStageCollisionMeshGroup(
     const std::string& filename,
-    std::vector<CollisionMeshData>& meshGroup) {
+    std::vector<CollisionMeshData>& meshGroup) const {
   // TODO : refactor to manage any mesh groups, not just scene
 
   //! Collect collision mesh group
@@ -1033,7 +1360,7 @@ bool ResourceManager::loadObjectMeshDataFromFile(
 
 Mn::Range3D ResourceManager::computeMeshBB(BaseMesh* meshDataGL) {
   CollisionMeshData& meshData = meshDataGL->getCollisionMeshData();
-  return Mn::Math::minmax(meshData.positions);
+  return geo::computeAABB(meshData.positions);
 }
 
 void ResourceManager::computeGeneralMeshAbsoluteAABBs(
@@ -1058,18 +1385,16 @@ void ResourceManager::computeGeneralMeshAbsoluteAABBs(
     // a vector to store the min, max pos for the aabb of every position array
     std::vector<Mn::Vector3> bbPos;
 
-    // transform the vertex positions to the world space, compute the aabb for
-    // each position array
+    // compute the aabb of the vertex positions in world space for each
+    // position array
     for (uint32_t jArray = 0;
          jArray < meshData->attributeCount(Mn::Trade::MeshAttribute::Position);
          ++jArray) {
-      Cr::Containers::Array<Mn::Vector3> pos =
-          meshData->positions3DAsArray(jArray);
-      Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry], pos);
-
-      std::pair<Mn::Vector3, Mn::Vector3> bb = Mn::Math::minmax(pos);
-      bbPos.push_back(bb.first);
-      bbPos.push_back(bb.second);
+      const Mn::Range3D bb = geo::computeTransformedAABB(
+          absTransforms[iEntry],
+          Cr::Containers::arrayView(meshData->positions3DAsArray(jArray)));
+      bbPos.push_back(bb.min());
+      bbPos.push_back(bb.max());
     }
 
     // locate the scene node which contains the current drawable
@@ -1093,15 +1418,14 @@ void ResourceManager::computeInstanceMeshAbsoluteAABBs(
   for (size_t iEntry = 0; iEntry < absTransforms.size(); ++iEntry) {
     const int meshID = staticDrawableInfo[iEntry].meshID;
 
-    std::vector<Mn::Vector3> transformedPositions =
+    // transformed on the fly instead of in a copy of the whole vertex buffer
+    const std::vector<Mn::Vector3>& positions =
         dynamic_cast<GenericSemanticMeshData&>(*meshes_.at(meshID))
             .getVertexBufferObjectCPU();
 
-    Mn::MeshTools::transformPointsInPlace(absTransforms[iEntry],
-                                          transformedPositions);
-
     scene::SceneNode& node = staticDrawableInfo[iEntry].node;
-    node.setAbsoluteAABB(Mn::Math::minmax(transformedPositions));
+    node.setAbsoluteAABB(geo::computeTransformedAABB(
+        absTransforms[iEntry], Cr::Containers::arrayView(positions)));
   }  // iEntry
 }
 
@@ -1475,27 +1799,29 @@ void ResourceManager::configureImporterManagerGLExtensions() {
     return;
   }
 
-  Cr::PluginManager::PluginMetadata* const metadata =
-      importerManager_.metadata("BasisImporter");
-  if (!metadata)
-    return;
-
   Mn::GL::Context& context = Mn::GL::Context::current();
   /* This is reduced to formats that Magnum currently can Y-flip. More formats
      will get added back with new additions to Magnum/Math/ColorBatch.h. */
 #ifdef MAGNUM_TARGET_WEBGL
-  if (context.isExtensionSupported<
-          Mn::GL::Extensions::WEBGL::compressed_texture_s3tc>())
+  bcTextureCompressionSupported_ = context.isExtensionSupported<
+      Mn::GL::Extensions::WEBGL::compressed_texture_s3tc>();
 #elif defined(MAGNUM_TARGET_GLES)
-  if (context.isExtensionSupported<
+  bcTextureCompressionSupported_ =
+      context.isExtensionSupported<
           Mn::GL::Extensions::EXT::texture_compression_s3tc>() ||
       context.isExtensionSupported<
-          Mn::GL::Extensions::ANGLE::texture_compression_dxt5>())
+          Mn::GL::Extensions::ANGLE::texture_compression_dxt5>();
 #else
-  if (context.isExtensionSupported<
-          Mn::GL::Extensions::EXT::texture_compression_s3tc>())
+  bcTextureCompressionSupported_ = context.isExtensionSupported<
+      Mn::GL::Extensions::EXT::texture_compression_s3tc>();
 #endif
-  {
+
+  Cr::PluginManager::PluginMetadata* const metadata =
+      importerManager_.metadata("BasisImporter");
+  if (!metadata)
+    return;
+
+  if (bcTextureCompressionSupported_) {
     ESP_DEBUG() << "Importing Basis files as BC3.";
     metadata->configuration().setValue("format", "Bc3RGBA");
   } else {
@@ -1642,6 +1968,347 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
   return true;
 }  // ResourceManager::loadRenderAssetGeneral
 
+namespace {
+
+/**
+ * @brief Collect the absolute transformations of all nodes with a mesh in the
+ * depth-first order addComponent() creates their drawables in.
+ */
+void collectMeshNodeTransformations(
+    const MeshTransformNode& node,
+    const Mn::Matrix4& parentTransformation,
+    std::vector<std::pair<int, Mn::Matrix4>>& meshNodes) {
+  const Mn::Matrix4 transformation =
+      parentTransformation * node.transformFromLocalToParent;
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    meshNodes.emplace_back(node.meshIDLocal, transformation);
+  }
+  for (const auto& child : node.children) {
+    collectMeshNodeTransformations(child, transformation, meshNodes);
+  }
+}
+
+}  // namespace
+
+bool ResourceManager::bakeStageBundle(const std::string& assetFilename,
+                                      const std::string& bundleFilename) {
+  AssetInfo info = AssetInfo::fromPath(assetFilename);
+  if (!isRenderAssetGeneral(info.type) || resourceDict_.count(assetFilename)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Can only bake general render assets that aren't loaded yet, `"
+        << assetFilename << "` isn't one.";
+    return false;
+  }
+  if (!loadRenderAssetGeneral(info)) {
+    return false;
+  }
+  // the importer is still open from the load above
+  const int materialCount = fileImporter_->materialCount();
+  if (fileImporter_->skin3DCount() != 0) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Can't bake `" << assetFilename << "`, skins aren't supported.";
+    return false;
+  }
+  const MeshMetaData& meshMetaData = getMeshMetaData(assetFilename);
+
+  StageBundle bundle;
+  bundle.materialCount = materialCount;
+  bundle.hasNormals = !info.forceFlatShading;
+
+  // meshes go in the exact layout they get uploaded in
+  std::vector<Cr::Containers::Array<char>> serializedMeshes;
+  for (int meshID = meshMetaData.meshIndex.first;
+       meshID <= meshMetaData.meshIndex.second; ++meshID) {
+    auto* meshData = dynamic_cast<GenericMeshData*>(meshes_.at(meshID).get());
+    serializedMeshes.push_back(meshData ? meshData->serializeMeshData()
+                                        : Cr::Containers::Array<char>{});
+    if (serializedMeshes.back().isEmpty()) {
+      ESP_ERROR(Mn::Debug::Flag::NoSpace)
+          << "Can't bake `" << assetFilename << "`, mesh "
+          << meshID - meshMetaData.meshIndex.first << " isn't indexed.";
+      return false;
+    }
+    bundle.meshes.emplace_back(serializedMeshes.back());
+    bundle.meshBBs.push_back(meshData->BB);
+  }
+
+  // the hierarchy is saved without the frame orientation of the load above,
+  // with materials relative to the asset, see loadRenderAssetGeneral()
+  bundle.root = meshMetaData.root;
+  const Mn::Matrix4 frameRotation = Mn::Matrix4::from(
+      Mn::Quaternion(info.frame.rotationFrameToWorld()).toMatrix(), {});
+  bundle.root.transformFromLocalToParent =
+      frameRotation.invertedRigid() * bundle.root.transformFromLocalToParent;
+  const int materialStart = nextMaterialID_ - materialCount;
+  std::vector<MeshTransformNode*> nodeQueue{&bundle.root};
+  while (!nodeQueue.empty()) {
+    MeshTransformNode* node = nodeQueue.back();
+    nodeQueue.pop_back();
+    for (auto& child : node->children) {
+      nodeQueue.push_back(&child);
+    }
+    if (!node->materialID.empty() &&
+        node->materialID.find_first_not_of("0123456789") ==
+            std::string::npos) {
+      node->materialID =
+          std::to_string(std::stoi(node->materialID) - materialStart);
+    }
+  }
+
+  // same as computeGeneralMeshAbsoluteAABBs() for an instance at the origin
+  std::vector<std::pair<int, Mn::Matrix4>> meshNodes;
+  collectMeshNodeTransformations(bundle.root, Mn::Matrix4{}, meshNodes);
+  for (const auto& meshNode : meshNodes) {
+    const Cr::Containers::Optional<Mn::Trade::MeshData>& meshData =
+        meshes_.at(meshMetaData.meshIndex.first + meshNode.first)
+            ->getMeshData();
+    std::vector<Mn::Vector3> bbPos;
+    for (Mn::UnsignedInt jArray = 0;
+         jArray < meshData->attributeCount(Mn::Trade::MeshAttribute::Position);
+         ++jArray) {
+      const Mn::Range3D bb = geo::computeTransformedAABB(
+          meshNode.second,
+          Cr::Containers::arrayView(meshData->positions3DAsArray(jArray)));
+      bbPos.push_back(bb.min());
+      bbPos.push_back(bb.max());
+    }
+    bundle.absoluteAABBs.emplace_back(Mn::Math::minmax(bbPos));
+  }
+
+  const std::string filename = bundleFilename.empty()
+                                   ? getStageBundleFilename(assetFilename)
+                                   : bundleFilename;
+  if (!saveStageBundle(bundle, filename, assetFilename)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Unable to save the stage bundle of `" << assetFilename << "` to `"
+        << filename << "`.";
+    return false;
+  }
+  return true;
+}  // ResourceManager::bakeStageBundle
+
+bool ResourceManager::loadRenderAssetFromStageBundle(const AssetInfo& info) {
+  const std::string& filename = info.filepath;
+  const std::string bundleFilename = getStageBundleFilename(filename);
+  if (!Cr::Utility::Path::exists(bundleFilename)) {
+    return false;
+  }
+  Cr::Containers::Optional<StageBundle> bundle =
+      loadStageBundle(bundleFilename, filename);
+  if (!bundle || (!bundle->hasNormals && !info.forceFlatShading)) {
+    ESP_WARNING(Mn::Debug::Flag::NoSpace)
+        << "Ignoring the stage bundle `" << bundleFilename
+        << "`, it's outdated or was baked for flat shading only.";
+    return false;
+  }
+
+  // everything that can fail is done before anything gets registered
+  std::vector<std::unique_ptr<GenericMeshData>> meshes;
+  meshes.reserve(bundle->meshes.size());
+  for (std::size_t iMesh = 0; iMesh != bundle->meshes.size(); ++iMesh) {
+    auto meshData =
+        std::make_unique<GenericMeshData>(!info.forceFlatShading);
+    if (!meshData->deserializeMeshData(bundle->meshes[iMesh])) {
+      ESP_WARNING(Mn::Debug::Flag::NoSpace)
+          << "Ignoring the stage bundle `" << bundleFilename
+          << "`, its mesh " << iMesh << " is corrupted.";
+      return false;
+    }
+    meshData->BB = bundle->meshBBs[iMesh];
+    meshes.push_back(std::move(meshData));
+  }
+  configureImporterManagerGLExtensions();
+
+  LoadedAssetData loadedAssetData{info};
+  if (requiresTextures_) {
+    // materials and textures aren't in the bundle
+    ESP_CHECK(fileImporter_->openFile(filename),
+              Cr::Utility::formatString(
+                  "Error loading materials and textures from file '{}'",
+                  filename));
+    loadTextures(*fileImporter_, loadedAssetData);
+    loadMaterials(*fileImporter_, loadedAssetData);
+  }
+
+  const int meshStart = nextMeshID_;
+  nextMeshID_ += meshes.size();
+  loadedAssetData.meshMetaData.setMeshIndices(meshStart, nextMeshID_ - 1);
+  const int meshLodLevels =
+      metadataMediator_->getSimulatorConfiguration().meshLodLevels;
+  for (int iMesh = 0; iMesh != int(meshes.size()); ++iMesh) {
+    if (meshLodLevels > 0) {
+      meshes[iMesh]->generateLodLevels(meshLodLevels);
+    }
+    if (getCreateRenderer()) {
+      meshes[iMesh]->uploadBuffersToGPU(false);
+    }
+    meshes_.emplace(meshStart + iMesh, std::move(meshes[iMesh]));
+  }
+
+  // same material keys as loadRenderAssetGeneral() assigns
+  MeshMetaData& meshMetaData = loadedAssetData.meshMetaData;
+  meshMetaData.root = std::move(bundle->root);
+  const int materialStart = nextMaterialID_ - bundle->materialCount;
+  std::vector<MeshTransformNode*> nodeQueue{&meshMetaData.root};
+  while (!nodeQueue.empty()) {
+    MeshTransformNode* node = nodeQueue.back();
+    nodeQueue.pop_back();
+    for (auto& child : node->children) {
+      nodeQueue.push_back(&child);
+    }
+    if (!node->materialID.empty()) {
+      node->materialID =
+          std::to_string(std::stoi(node->materialID) + materialStart);
+    }
+  }
+  meshMetaData.setRootFrameOrientation(info.frame);
+
+  // the baked boxes assume no frame orientation
+  const Mn::Matrix4 frameRotation = Mn::Matrix4::from(
+      Mn::Quaternion(info.frame.rotationFrameToWorld()).toMatrix(), {});
+  if (frameRotation == Mn::Matrix4{}) {
+    loadedAssetData.absoluteAABBs = std::move(bundle->absoluteAABBs);
+  }
+
+  resourceDict_.emplace(filename, std::move(loadedAssetData));
+  return true;
+}  // ResourceManager::loadRenderAssetFromStageBundle
+
+namespace {
+
+/**
+ * @brief Register shared resources under fresh IDs of a ResourceManager's
+ * resource map, returning the new inclusive index range.
+ */
+template <typename T>
+std::pair<int, int> adoptSharedResources(
+    const std::vector<std::shared_ptr<T>>& sharedResources,
+    const std::pair<int, int>& sharedRange,
+    std::map<int, std::shared_ptr<T>>& resources,
+    int& nextID) {
+  if (sharedRange.first == ID_UNDEFINED) {
+    return sharedRange;
+  }
+  const int start = nextID;
+  for (const auto& resource : sharedResources) {
+    resources.emplace(nextID++, resource);
+  }
+  return std::make_pair(start, nextID - 1);
+}
+
+/**
+ * @brief Collect the resources of an inclusive index range, in order.
+ */
+template <typename T>
+std::vector<std::shared_ptr<T>> collectSharedResources(
+    const std::map<int, std::shared_ptr<T>>& resources,
+    const std::pair<int, int>& range) {
+  std::vector<std::shared_ptr<T>> shared;
+  if (range.first == ID_UNDEFINED) {
+    return shared;
+  }
+  for (int id = range.first; id <= range.second; ++id) {
+    auto resourceIter = resources.find(id);
+    shared.emplace_back(resourceIter != resources.end() ? resourceIter->second
+                                                        : nullptr);
+  }
+  return shared;
+}
+
+}  // namespace
+
+const Mn::GL::Context* ResourceManager::getSharedAssetGLContext() const {
+  if (!getCreateRenderer() || !Mn::GL::Context::hasCurrent()) {
+    return nullptr;
+  }
+  return &Mn::GL::Context::current();
+}
+
+bool ResourceManager::adoptSharedRenderAsset(const AssetInfo& info) {
+  SharedRenderAsset::cptr shared = AssetCache::instance().find(
+      info, requiresTextures_, getSharedAssetGLContext());
+  if (!shared) {
+    return false;
+  }
+
+  LoadedAssetData loadedAssetData{info, shared->meshMetaData};
+  MeshMetaData& meshMetaData = loadedAssetData.meshMetaData;
+  meshMetaData.meshIndex = adoptSharedResources(
+      shared->meshes, shared->meshMetaData.meshIndex, meshes_, nextMeshID_);
+  meshMetaData.textureIndex =
+      adoptSharedResources(shared->textures, shared->meshMetaData.textureIndex,
+                           textures_, nextTextureID_);
+  meshMetaData.skinIndex = adoptSharedResources(
+      shared->skins, shared->meshMetaData.skinIndex, skins_, nextSkinID_);
+
+  // materials are cheap, so each ResourceManager registers its own copies
+  // under fresh keys and the hierarchy is remapped to them.
+  if (shared->materialIndex.first != ID_UNDEFINED) {
+    const int materialStart = nextMaterialID_;
+    for (const auto& material : shared->materials) {
+      shaderManager_.set<Mn::Trade::MaterialData>(
+          std::to_string(materialStart + material.first),
+          copyMaterialData(material.second));
+    }
+    nextMaterialID_ += shared->materialIndex.second -
+                       shared->materialIndex.first + 1;
+
+    std::vector<MeshTransformNode*> nodeQueue;
+    nodeQueue.push_back(&meshMetaData.root);
+    while (!nodeQueue.empty()) {
+      MeshTransformNode* node = nodeQueue.back();
+      nodeQueue.pop_back();
+      for (auto& child : node->children) {
+        nodeQueue.push_back(&child);
+      }
+      if (node->materialID.empty() ||
+          node->materialID.find_first_not_of("0123456789") !=
+              std::string::npos) {
+        continue;
+      }
+      const int sharedMaterialID = std::stoi(node->materialID);
+      if (sharedMaterialID >= shared->materialIndex.first &&
+          sharedMaterialID <= shared->materialIndex.second) {
+        node->materialID = std::to_string(
+            materialStart + sharedMaterialID - shared->materialIndex.first);
+      }
+    }
+  }
+
+  resourceDict_.emplace(info.filepath, std::move(loadedAssetData));
+  sharedRenderAssets_.emplace_back(std::move(shared));
+  return true;
+}  // ResourceManager::adoptSharedRenderAsset
+
+void ResourceManager::publishSharedRenderAsset(const AssetInfo& info,
+                                               int materialStart) {
+  const MeshMetaData& meshMetaData = getMeshMetaData(info.filepath);
+  auto shared = SharedRenderAsset::create_unique();
+  shared->assetInfo = info;
+  shared->meshMetaData = meshMetaData;
+  shared->meshes = collectSharedResources(meshes_, meshMetaData.meshIndex);
+  shared->textures =
+      collectSharedResources(textures_, meshMetaData.textureIndex);
+  shared->skins = collectSharedResources(skins_, meshMetaData.skinIndex);
+  if (nextMaterialID_ > materialStart) {
+    shared->materialIndex = std::make_pair(materialStart, nextMaterialID_ - 1);
+    for (int materialID = materialStart; materialID < nextMaterialID_;
+         ++materialID) {
+      auto materialResource = shaderManager_.get<Mn::Trade::MaterialData>(
+          std::to_string(materialID));
+      if (materialResource.state() == Mn::ResourceState::Final ||
+          materialResource.state() == Mn::ResourceState::Mutable) {
+        shared->materials.emplace(materialID - materialStart,
+                                  copyMaterialData(*materialResource));
+      }
+    }
+  }
+  shared->hasTextures = requiresTextures_;
+  shared->glContext = getSharedAssetGLContext();
+  sharedRenderAssets_.emplace_back(
+      AssetCache::instance().publish(std::move(shared)));
+}  // ResourceManager::publishSharedRenderAsset
+
 scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
     const RenderAssetInstanceCreationInfo& creation,
     scene::SceneNode* parent,
@@ -1690,7 +2357,8 @@ scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
               "registered to the RigManager.");
     const auto& skinData = skins_[meshMetaData.skinIndex.first];
     const auto& rig = rigManager_.getRigInstance(creation.rigId);
-    instanceSkinData = std::make_shared<gfx::InstanceSkinData>(skinData);
+    instanceSkinData = std::make_shared<gfx::InstanceSkinData>(
+        skinData, rigManager_.getBonePalette());
     mapSkinnedModelToRig(meshMetaData.root, rig, instanceSkinData);
     ESP_CHECK(instanceSkinData->rootArticulatedObjectNode &&
                   !instanceSkinData->jointIdToTransformNode.empty(),
@@ -1711,8 +2379,19 @@ scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
                instanceSkinData);     // instance skinning data
 
   if (computeAbsoluteAABBs) {
-    // now compute aabbs by constructed staticDrawableInfo
-    computeGeneralMeshAbsoluteAABBs(staticDrawableInfo);
+    // stage bundles come with the boxes of an instance at the origin, which
+    // is where stages are
+    if (!creation.scale &&
+        loadedAssetData.absoluteAABBs.size() == staticDrawableInfo.size() &&
+        newNode.absoluteTransformationMatrix() == Mn::Matrix4{}) {
+      for (std::size_t i = 0; i != staticDrawableInfo.size(); ++i) {
+        staticDrawableInfo[i].node.setAbsoluteAABB(
+            loadedAssetData.absoluteAABBs[i]);
+      }
+    } else {
+      // now compute aabbs by constructed staticDrawableInfo
+      computeGeneralMeshAbsoluteAABBs(staticDrawableInfo);
+    }
   }
 
   // set the node type for all cached visual nodes
@@ -1828,69 +2507,111 @@ bool ResourceManager::buildTrajectoryVisualization(
   return true;
 }  // ResourceManager::loadTrajectoryVisualization
 
-int ResourceManager::loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
-                                              scene::SceneNode* parent,
-                                              DrawableGroup* drawables) {
-  int navMeshPrimitiveID = ID_UNDEFINED;
-
+bool ResourceManager::updateNavMeshVisualization(
+    esp::nav::PathFinder& pathFinder,
+    NavMeshVisualizationTiles& tiles,
+    scene::SceneNode* parent,
+    DrawableGroup* drawables) {
   if (!pathFinder.isLoaded()) {
-    return navMeshPrimitiveID;
+    return false;
   }
 
   if (!getCreateRenderer()) {
-    return navMeshPrimitiveID;
+    return false;
+  }
+
+  const std::map<std::pair<int, int>, uint64_t> revisions =
+      pathFinder.getNavMeshTileRevisions();
+
+  // drop the meshes of tiles that are gone
+  for (auto tile = tiles.begin(); tile != tiles.end();) {
+    if (revisions.count(tile->first)) {
+      ++tile;
+      continue;
+    }
+    if (tile->second.primitiveID != ID_UNDEFINED) {
+      removePrimitiveMesh(tile->second.primitiveID);
+    }
+    tile = tiles.erase(tile);
   }
 
-  // create the mesh
   std::vector<Mn::UnsignedInt> indices;
   std::vector<Mn::Vector3> positions;
+  for (const auto& revision : revisions) {
+    NavMeshVisualizationTile& tile = tiles[revision.first];
+    if (tile.primitiveID != ID_UNDEFINED &&
+        tile.revision == revision.second) {
+      continue;
+    }
+    tile.revision = revision.second;
+
+    const MeshData::ptr navMeshData = pathFinder.getNavMeshTileData(
+        revision.first.first, revision.first.second);
+    if (navMeshData->ibo.empty()) {
+      if (tile.primitiveID != ID_UNDEFINED) {
+        removePrimitiveMesh(tile.primitiveID);
+        tile.primitiveID = ID_UNDEFINED;
+      }
+      continue;
+    }
 
-  const MeshData::ptr navMeshData = pathFinder.getNavMeshData();
-
-  // add the vertices
-  positions.resize(navMeshData->vbo.size());
-  for (size_t vix = 0; vix < navMeshData->vbo.size(); ++vix) {
-    positions[vix] = Mn::Vector3{navMeshData->vbo[vix]};
-  }
-
-  indices.resize(navMeshData->ibo.size() * 2);
-  for (size_t ix = 0; ix < navMeshData->ibo.size();
-       ix += 3) {  // for each triangle, create lines
-    size_t nix = ix * 2;
-    indices[nix] = navMeshData->ibo[ix];
-    indices[nix + 1] = navMeshData->ibo[ix + 1];
-    indices[nix + 2] = navMeshData->ibo[ix + 1];
-    indices[nix + 3] = navMeshData->ibo[ix + 2];
-    indices[nix + 4] = navMeshData->ibo[ix + 2];
-    indices[nix + 5] = navMeshData->ibo[ix];
-  }
-
-  // create a temporary mesh object referencing the above data
-  Mn::Trade::MeshData visualNavMesh{
-      Mn::MeshPrimitive::Lines,
-      {},
-      indices,
-      Mn::Trade::MeshIndexData{indices},
-      {},
-      positions,
-      {Mn::Trade::MeshAttributeData{Mn::Trade::MeshAttribute::Position,
-                                    Cr::Containers::arrayView(positions)}}};
-
-  // compile and add the new mesh to the structure
-  navMeshPrimitiveID = nextPrimitiveMeshId;
-  primitive_meshes_[nextPrimitiveMeshId++] =
-      std::make_unique<Mn::GL::Mesh>(Mn::MeshTools::compile(visualNavMesh));
+    // add the vertices
+    positions.resize(navMeshData->vbo.size());
+    for (size_t vix = 0; vix < navMeshData->vbo.size(); ++vix) {
+      positions[vix] = Mn::Vector3{navMeshData->vbo[vix]};
+    }
+
+    indices.resize(navMeshData->ibo.size() * 2);
+    for (size_t ix = 0; ix < navMeshData->ibo.size();
+         ix += 3) {  // for each triangle, create lines
+      size_t nix = ix * 2;
+      indices[nix] = navMeshData->ibo[ix];
+      indices[nix + 1] = navMeshData->ibo[ix + 1];
+      indices[nix + 2] = navMeshData->ibo[ix + 1];
+      indices[nix + 3] = navMeshData->ibo[ix + 2];
+      indices[nix + 4] = navMeshData->ibo[ix + 2];
+      indices[nix + 5] = navMeshData->ibo[ix];
+    }
 
-  if (parent != nullptr && drawables != nullptr &&
-      navMeshPrimitiveID != ID_UNDEFINED) {
-    // create the drawable
-    addPrimitiveToDrawables(navMeshPrimitiveID, *parent, drawables);
-    parent->setMeshBB(Mn::Math::minmax(positions));
+    // create a temporary mesh object referencing the above data
+    Mn::Trade::MeshData visualNavMesh{
+        Mn::MeshPrimitive::Lines,
+        {},
+        indices,
+        Mn::Trade::MeshIndexData{indices},
+        {},
+        positions,
+        {Mn::Trade::MeshAttributeData{Mn::Trade::MeshAttribute::Position,
+                                      Cr::Containers::arrayView(positions)}}};
+
+    tile.bounds = Mn::Math::minmax(positions);
+    // compile into the existing mesh, if any, so Drawables rendering it pick
+    // up the new buffers
+    if (tile.primitiveID != ID_UNDEFINED) {
+      *primitive_meshes_.at(tile.primitiveID) =
+          Mn::MeshTools::compile(visualNavMesh);
+    } else {
+      tile.primitiveID = nextPrimitiveMeshId;
+      primitive_meshes_[nextPrimitiveMeshId++] =
+          std::make_unique<Mn::GL::Mesh>(Mn::MeshTools::compile(visualNavMesh));
+    }
+  }
+
+  if (parent != nullptr && drawables != nullptr) {
+    // create the drawables
+    for (const auto& tile : tiles) {
+      if (tile.second.primitiveID == ID_UNDEFINED) {
+        continue;
+      }
+      scene::SceneNode& tileNode = parent->createChild();
+      addPrimitiveToDrawables(tile.second.primitiveID, tileNode, drawables);
+      tileNode.setMeshBB(tile.second.bounds);
+    }
     parent->computeCumulativeBB();
   }
 
-  return navMeshPrimitiveID;
-}  // ResourceManager::loadNavMeshVisualization
+  return true;
+}  // ResourceManager::updateNavMeshVisualization
 
 namespace {
 /**
@@ -2630,11 +3351,45 @@ void ResourceManager::loadMeshes(Importer& importer,
   nextMeshID_ = meshEnd + 1;
   loadedAssetData.meshMetaData.setMeshIndices(meshStart, meshEnd);
 
+  const sim::SimulatorConfiguration& simConfig =
+      metadataMediator_->getSimulatorConfiguration();
+  // Key the cached meshes on the asset contents as well as its name, so an
+  // edited asset isn't matched with meshes optimized from the old one
+  std::string cacheAssetKey;
+  if (simConfig.optimizeMeshes && !simConfig.meshCacheDir.empty()) {
+    const std::string& filepath = loadedAssetData.assetInfo.filepath;
+    if (Cr::Containers::Optional<std::size_t> assetSize =
+            Cr::Utility::Path::size(filepath)) {
+      cacheAssetKey = Cr::Utility::formatString("{}-size={}", filepath,
+                                                *assetSize);
+    }
+  }
+
   for (int iMesh = 0; iMesh < importer.meshCount(); ++iMesh) {
     // don't need normals if we aren't using lighting
     auto gltfMeshData = std::make_unique<GenericMeshData>(
         !loadedAssetData.assetInfo.forceFlatShading);
-    gltfMeshData->importAndSetMeshData(importer, iMesh);
+    const std::string cacheFilename =
+        cacheAssetKey.empty()
+            ? std::string{}
+            : GenericMeshData::getCacheFilename(simConfig.meshCacheDir,
+                                                cacheAssetKey, iMesh);
+    if (cacheFilename.empty() ||
+        !gltfMeshData->loadMeshDataFromCache(cacheFilename)) {
+      gltfMeshData->importAndSetMeshData(importer, iMesh);
+      if (simConfig.optimizeMeshes) {
+        gltfMeshData->optimizeForRendering();
+        if (!cacheFilename.empty() &&
+            !gltfMeshData->saveMeshDataToCache(cacheFilename)) {
+          ESP_WARNING() << "Unable to save optimized mesh" << iMesh << "of"
+                        << loadedAssetData.assetInfo.filepath << "to"
+                        << cacheFilename << ", it'll be optimized again";
+        }
+      }
+    }
+    if (simConfig.meshLodLevels > 0) {
+      gltfMeshData->generateLodLevels(simConfig.meshLodLevels);
+    }
 
     // compute the mesh bounding box
     gltfMeshData->BB = computeMeshBB(gltfMeshData.get());
@@ -2675,146 +3430,405 @@ void ResourceManager::loadSkins(Importer& importer,
 
 Mn::Image2D ResourceManager::convertRGBToSemanticId(
     const Mn::ImageView2D& srcImage,
-    Cr::Containers::Array<Mn::UnsignedShort>& clrToSemanticId) {
-  // convert image to semantic image here
-
-  const Mn::Vector2i size = srcImage.size();
-  // construct empty integer image
-  Mn::Image2D resImage{
-      Mn::PixelFormat::R16UI, size,
-      Cr::Containers::Array<char>{
-          Mn::NoInit, std::size_t(size.product() *
-                                  pixelFormatSize(Mn::PixelFormat::R16UI))}};
-
-  Cr::Containers::StridedArrayView2D<const Mn::Color3ub> input =
-      srcImage.pixels<Mn::Color3ub>();
-  Cr::Containers::StridedArrayView2D<Mn::UnsignedShort> output =
-      resImage.pixels<Mn::UnsignedShort>();
-  for (std::size_t y = 0; y != size.y(); ++y) {
-    Cr::Containers::StridedArrayView1D<const Mn::Color3ub> inputRow = input[y];
-    Cr::Containers::StridedArrayView1D<Mn::UnsignedShort> outputRow = output[y];
-    for (std::size_t x = 0; x != size.x(); ++x) {
-      const Mn::Color3ub color = inputRow[x];
-      /* Fugly. Sorry. Needs better API on Magnum side. */
-      const Mn::UnsignedInt colorInt = geo::getValueAsUInt(color);
-      outputRow[x] = clrToSemanticId[colorInt];
-    }
-  }
-  return resImage;
+    const SemanticColorLookup& colorLookup,
+    std::size_t threadCount) {
+  return colorLookup.convert(srcImage, threadCount);
 }  // ResourceManager::convertRGBToSemanticId
+
+namespace {
+
+/**
+ * @brief Mip levels of an image referenced by a texture, decoded ahead of the
+ * GL upload. Empty if the image could not be decoded.
+ */
+using DecodedImageLevels = std::vector<Mn::Trade::ImageData2D>;
+
+using ImporterManager = Cr::PluginManager::Manager<ResourceManager::Importer>;
+
+/**
+ * @brief Decodes the images referenced by the textures of an asset on worker
+ * threads, while the GL thread uploads already decoded images in order.
+ *
+ * Neither plugin managers nor importers are thread-safe, so every worker gets
+ * its own manager and importer, with the preferred plugins and plugin
+ * configuration of the source manager, opened on the same file as the
+ * importer the asset is being loaded with. Files are read only once for all
+ * workers, prefetched files are served from memory. Images of a worker whose
+ * importer failed to open the file, or sees a different image count than the
+ * source importer, are reported as not decoded, for the caller to decode with
+ * its own importer instead.
+ */
+class ParallelImageDecoder {
+ public:
+  using DecodeFunction = std::function<
+      DecodedImageLevels(ResourceManager::Importer&, Mn::UnsignedInt)>;
+
+  /**
+   * @param sourceManager   Manager the source importer was created with
+   * @param filename        Asset file the source importer opened
+   * @param flags           Flags of the source importer
+   * @param imageCount      Image count of the source importer
+   * @param imageIds        Images to decode
+   * @param prefetchedFiles Files to serve from memory instead of reading
+   *    them. Has to outlive the decoder and may get new entries meanwhile,
+   *    but existing ones can't be changed or removed.
+   * @param numThreads      Worker count
+   * @param decode          Decodes an image with a worker's importer
+   */
+  ParallelImageDecoder(
+      ImporterManager& sourceManager,
+      const std::string& filename,
+      Mn::Trade::ImporterFlags flags,
+      Mn::UnsignedInt imageCount,
+      std::vector<Mn::UnsignedInt> imageIds,
+      const std::unordered_map<std::string, Cr::Containers::Array<char>>&
+          prefetchedFiles,
+      int numThreads,
+      DecodeFunction decode)
+      : filename_(filename),
+        imageCount_(imageCount),
+        imageIds_(std::move(imageIds)),
+        decode_(std::move(decode)),
+        results_(imageIds_.size()),
+        ready_(imageIds_.size(), false) {
+    // only views, the source importer may add files to the map meanwhile
+    for (const auto& file : prefetchedFiles) {
+      files_.emplace(file.first, Cr::Containers::arrayView(file.second));
+    }
+
+    // managers and importers are set up on this thread, only opening the file
+    // and decoding happens on the workers
+    for (int i = 0; i != numThreads; ++i) {
+#ifdef MAGNUM_BUILD_STATIC
+      // same as ResourceManager::importerManager_
+      managers_.emplace_back(std::make_unique<ImporterManager>("nonexistent"));
+#else
+      managers_.emplace_back(std::make_unique<ImporterManager>());
+#endif
+      ImporterManager& manager = *managers_.back();
+      setPreferredImporterPlugins(manager);
+      // e.g. the Basis transcoding target, which depends on the GL context
+      for (const std::string& plugin : manager.pluginList()) {
+        Cr::PluginManager::PluginMetadata* const sourceMetadata =
+            sourceManager.metadata(plugin);
+        Cr::PluginManager::PluginMetadata* const metadata =
+            manager.metadata(plugin);
+        if (sourceMetadata && metadata) {
+          metadata->configuration() = sourceMetadata->configuration();
+        }
+      }
+      importers_.emplace_back(manager.loadAndInstantiate("AnySceneImporter"));
+      if (importers_.back()) {
+        importers_.back()->setFlags(flags);
+        importers_.back()->setFileCallback(fileCallback, *this);
+      }
+    }
+    workers_.reserve(numThreads);
+    for (int i = 0; i != numThreads; ++i) {
+      workers_.emplace_back(&ParallelImageDecoder::run, this, i);
+    }
+  }
+
+  ~ParallelImageDecoder() {
+    // stop claiming new images if the caller bailed out early
+    next_ = imageIds_.size();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief Wait for the image at @p index in the list passed to the
+   * constructor and take its decoded levels. Returns
+   * @ref Corrade::Containers::NullOpt if no worker could decode it. Each index
+   * can only be taken once.
+   */
+  Cr::Containers::Optional<DecodedImageLevels> take(std::size_t index) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    ready_cv_.wait(lock, [&]() { return bool(ready_[index]); });
+    return std::move(results_[index]);
+  }
+
+ private:
+  /**
+   * @brief Serve @ref files_ to the workers, reading files that aren't there
+   * yet once for all of them. Everything stays in memory until the decoder
+   * is destroyed.
+   */
+  static Cr::Containers::Optional<Cr::Containers::ArrayView<const char>>
+  fileCallback(const std::string& filename,
+               const Mn::InputFileCallbackPolicy policy,
+               ParallelImageDecoder& self) {
+    if (policy == Mn::InputFileCallbackPolicy::Close) {
+      return {};
+    }
+
+    std::lock_guard<std::mutex> lock{self.filesMutex_};
+    auto found = self.files_.find(filename);
+    if (found == self.files_.end()) {
+      Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+          Cr::Utility::Path::read(filename);
+      if (!data) {
+        return {};
+      }
+      // moving the array around doesn't move its contents
+      found = self.files_.emplace(filename, Cr::Containers::arrayView(*data))
+                  .first;
+      self.readFiles_.push_back(*std::move(data));
+    }
+    return Cr::Containers::ArrayView<const char>{found->second};
+  }
+
+  void run(int worker) {
+    ResourceManager::Importer* importer = importers_[worker].get();
+    // a different plugin may see different images, e.g. none at all
+    if (importer && (!importer->openFile(filename_) ||
+                     importer->image2DCount() != imageCount_)) {
+      importer = nullptr;
+    }
+    for (std::size_t i = next_++; i < imageIds_.size(); i = next_++) {
+      Cr::Containers::Optional<DecodedImageLevels> levels;
+      if (importer) {
+        levels = decode_(*importer, imageIds_[i]);
+      }
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        results_[i] = std::move(levels);
+        ready_[i] = true;
+      }
+      ready_cv_.notify_all();
+    }
+  }
+
+  const std::string filename_;
+  const Mn::UnsignedInt imageCount_;
+  const std::vector<Mn::UnsignedInt> imageIds_;
+  const DecodeFunction decode_;
+
+  std::mutex filesMutex_;
+  std::unordered_map<std::string, Cr::Containers::ArrayView<const char>>
+      files_;
+  //! Files read by fileCallback(), referenced by files_
+  std::vector<Cr::Containers::Array<char>> readFiles_;
+
+  std::vector<std::unique_ptr<ImporterManager>> managers_;
+  std::vector<Cr::Containers::Pointer<ResourceManager::Importer>> importers_;
+  std::vector<std::thread> workers_;
+
+  std::atomic<std::size_t> next_{0};
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  std::vector<Cr::Containers::Optional<DecodedImageLevels>> results_;
+  std::vector<char> ready_;
+};
+
+}  // namespace
+
 void ResourceManager::loadTextures(Importer& importer,
                                    LoadedAssetData& loadedAssetData) {
   int textureStart = nextTextureID_;
   int textureEnd = textureStart + importer.textureCount() - 1;
   nextTextureID_ = textureEnd + 1;
   loadedAssetData.meshMetaData.setTextureIndices(textureStart, textureEnd);
-  if (loadedAssetData.assetInfo.hasSemanticTextures) {
+
+  const bool hasSemanticTextures =
+      loadedAssetData.assetInfo.hasSemanticTextures;
+  if (hasSemanticTextures) {
     // build semantic BBoxes and semanticColorMapBeingUsed_ if semanticScene_
     // and save results to informational SemanticMeshData, to facilitate future
     // reporting
     infoSemanticMeshData_ = flattenImportedMeshAndBuildSemantic(
         importer, loadedAssetData.assetInfo);
-
     // We are assuming that the only textures that exist are the semantic
-    // textures. We build table of all possible colors holding ushorts
-    // representing semantic IDs for those colors. We then assign known semantic
-    // IDs to table entries corresponding the ID's specified color. Unknown
-    // entries have semantic id 0x0 (corresponding to Unknown object in semantic
+    // textures, converted through semanticColorLookup_, which maps unknown
+    // colors to semantic id 0x0 (corresponding to Unknown object in semantic
     // scene).
-    //
-    Cr::Containers::Array<Mn::UnsignedShort> clrToSemanticId{
-        Mn::DirectInit, 256 * 256 * 256, Mn::UnsignedShort(0x0)};
+  }
 
-    for (std::size_t i = 0; i < semanticColorAsInt_.size(); ++i) {
-      // skip '0x0' (black) color - already mapped 0
-      if (semanticColorAsInt_[i] == 0) {
-        continue;
-      }
-      // assign semantic ID to list at colorAsInt idx
-      clrToSemanticId[semanticColorAsInt_[i]] =
-          static_cast<Mn::UnsignedShort>(i);
+  // Uncompressed textures are compressed only if the GPU can sample the result
+  const bool compressTextures =
+      !hasSemanticTextures &&
+      metadataMediator_->getSimulatorConfiguration().compressTextures &&
+      bcTextureCompressionSupported_;
+  if (!hasSemanticTextures && importer.textureCount() > 0 &&
+      metadataMediator_->getSimulatorConfiguration().compressTextures &&
+      !bcTextureCompressionSupported_) {
+    ESP_WARNING() << "The GPU doesn't support BC1/BC3 compressed textures, "
+                     "textures of"
+                  << loadedAssetData.assetInfo.filepath
+                  << "will be loaded uncompressed.";
+  }
+
+  // Gather the textures first, so the images they reference can be decoded
+  // before they're needed for upload. Several textures may share an image.
+  std::vector<Cr::Containers::Optional<Mn::Trade::TextureData>> textureData;
+  textureData.reserve(importer.textureCount());
+  std::vector<Mn::UnsignedInt> imageIds;
+  std::unordered_map<Mn::UnsignedInt, std::size_t> imageSlots;
+  std::vector<std::size_t> imageUseCounts;
+  for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
+    textureData.emplace_back(importer.texture(iTexture));
+    if (!textureData.back() ||
+        textureData.back()->type() != Mn::Trade::TextureType::Texture2D) {
+      continue;
+    }
+    auto slot =
+        imageSlots.emplace(textureData.back()->image(), imageIds.size());
+    if (slot.second) {
+      imageIds.push_back(textureData.back()->image());
+      imageUseCounts.push_back(0);
     }
+    ++imageUseCounts[slot.first->second];
+  }
 
-    for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
-      auto currentTextureID = textureStart + iTexture;
-      auto txtrIter = textures_.emplace(currentTextureID,
-                                        std::make_shared<Mn::GL::Texture2D>());
-      auto& currentTexture = txtrIter.first->second;
+  // Decode on worker threads while the textures are uploaded below, unless
+  // there's nothing to run in parallel. Semantic textures are split across
+  // the cores the decoding leaves idle, as there's usually just a few huge
+  // ones.
+  const std::size_t hardwareThreads =
+      std::max(1u, std::thread::hardware_concurrency());
+  const int numThreads = std::min<std::size_t>(
+      {hardwareThreads, std::size_t(maxImageDecodeThreads_), imageIds.size()});
+  const std::size_t semanticConversionThreads =
+      hardwareThreads / std::max(numThreads, 1);
+
+  // Decodes all mip levels of an image, or for semantic textures only the
+  // first level, converted to semantic IDs. Touches nothing but its arguments,
+  // read-only state and the image's own cache file, so it's safe to call from
+  // the workers.
+  auto decodeImage = [&](Importer& imageImporter, Mn::UnsignedInt imageId) {
+    DecodedImageLevels levels;
+    if (hasSemanticTextures) {
+      // load only first level of textures for semantic annotations
+      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+          imageImporter.image2D(imageId, 0);
+      if (!image) {
+        return levels;
+      }
+      // Convert color-based image to semantic image here
+      Mn::Image2D semanticImage = convertRGBToSemanticId(
+          *image, semanticColorLookup_, semanticConversionThreads);
+      const Mn::PixelStorage storage = semanticImage.storage();
+      const Mn::PixelFormat format = semanticImage.format();
+      const Mn::Vector2i size = semanticImage.size();
+      levels.emplace_back(storage, format, size, semanticImage.release());
+      return levels;
+    }
 
-      auto textureData = importer.texture(iTexture);
-      if (!textureData ||
-          textureData->type() != Mn::Trade::TextureType::Texture2D) {
-        ESP_ERROR() << "Cannot load texture" << iTexture << "so skipping";
-        currentTexture = nullptr;
-        continue;
+    // An image compressed on an earlier load doesn't need decoding at all
+    const std::string cacheFilename =
+        compressTextures ? getCompressedTextureCacheFilename(
+                               loadedAssetData.assetInfo.filepath, imageId)
+                         : std::string{};
+    if (!cacheFilename.empty()) {
+      levels = loadCompressedTextureFromCache(cacheFilename);
+      if (!levels.empty()) {
+        return levels;
       }
-      // texture will end up being semantic IDs
-      currentTexture->setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
-          .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
-          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge);
+    }
 
-      // load only first level of textures for semantic annotations
+    const Mn::UnsignedInt levelCount =
+        imageImporter.image2DLevelCount(imageId);
+    levels.reserve(levelCount);
+    for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
       Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-          importer.image2D(textureData->image(), 0);
+          imageImporter.image2D(imageId, level);
+      // Mip level loading failed, fail the whole image
       if (!image) {
-        ESP_ERROR() << "Cannot load semantic texture image, skipping";
-        currentTexture = nullptr;
-        continue;
+        levels.clear();
+        return levels;
       }
-      // Convert color-based image to semantic image here
-      auto newImage = convertRGBToSemanticId(*image, clrToSemanticId);
+      levels.push_back(std::move(*image));
+    }
 
-      currentTexture
-          ->setStorage(1, Mn::GL::TextureFormat::R16UI, newImage.size())
-          .setSubImage(0, {}, newImage);
+    // Replace a single uncompressed level with a compressed mip chain, as
+    // the mips of compressed textures can't be generated on the GPU
+    if (compressTextures && levels.size() == 1 &&
+        isCompressibleTextureImage(levels[0])) {
+      DecodedImageLevels compressed = compressTextureImage(levels[0]);
+      if (!compressed.empty()) {
+        if (!cacheFilename.empty()) {
+          saveCompressedTextureToCache(compressed, cacheFilename);
+        }
+        return compressed;
+      }
+    }
+    return levels;
+  };
 
-      // Whether semantic RGB or not
+  Cr::Containers::Pointer<ParallelImageDecoder> decoder;
+  if (numThreads > 1) {
+    decoder.emplace(importerManager_, loadedAssetData.assetInfo.filepath,
+                    importer.flags(), importer.image2DCount(), imageIds,
+                    prefetchedFiles_, numThreads, decodeImage);
+  }
+  std::vector<Cr::Containers::Optional<DecodedImageLevels>> decodedImages(
+      imageIds.size());
+
+  for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
+    auto currentTextureID = textureStart + iTexture;
+    auto txtrIter = textures_.emplace(currentTextureID,
+                                      std::make_shared<Mn::GL::Texture2D>());
+    auto& currentTexture = txtrIter.first->second;
+
+    const auto& currentTextureData = textureData[iTexture];
+    if (!currentTextureData ||
+        currentTextureData->type() != Mn::Trade::TextureType::Texture2D) {
+      ESP_ERROR() << "Cannot load texture" << iTexture << "so skipping";
+      currentTexture = nullptr;
+      continue;
     }
-  } else {
-    for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
-      auto currentTextureID = textureStart + iTexture;
-      auto txtrIter = textures_.emplace(currentTextureID,
-                                        std::make_shared<Mn::GL::Texture2D>());
-      auto& currentTexture = txtrIter.first->second;
-
-      auto textureData = importer.texture(iTexture);
-      if (!textureData ||
-          textureData->type() != Mn::Trade::TextureType::Texture2D) {
-        ESP_ERROR() << "Cannot load texture" << iTexture << "so skipping";
-        currentTexture = nullptr;
-        continue;
+
+    // Take the decoded image from the workers on first use, falling back to
+    // decoding it here if they couldn't
+    const std::size_t slot = imageSlots.at(currentTextureData->image());
+    if (!decodedImages[slot]) {
+      if (decoder) {
+        decodedImages[slot] = decoder->take(slot);
+      }
+      if (!decodedImages[slot]) {
+        decodedImages[slot] = decodeImage(importer, imageIds[slot]);
       }
+    }
+    const DecodedImageLevels& levels = *decodedImages[slot];
 
-      // Configure the texture
-      // Mn::GL::Texture2D& texture = *(textures_.at(textureStart +
-      // iTexture).get());
-      currentTexture->setMagnificationFilter(textureData->magnificationFilter())
-          .setMinificationFilter(textureData->minificationFilter(),
-                                 textureData->mipmapFilter())
-          .setWrapping(textureData->wrapping().xy());
+    if (hasSemanticTextures) {
+      // texture will end up being semantic IDs
+      currentTexture->setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge);
 
-      // Load all mip levels
-      const std::uint32_t levelCount =
-          importer.image2DLevelCount(textureData->image());
+      if (levels.empty()) {
+        ESP_ERROR() << "Cannot load semantic texture image, skipping";
+        currentTexture = nullptr;
+      } else {
+        currentTexture
+            ->setStorage(1, Mn::GL::TextureFormat::R16UI, levels[0].size())
+            .setSubImage(0, {}, levels[0]);
+        textureMemory_[currentTextureID] = levels[0].data().size();
+      }
+    } else if (levels.empty()) {
+      ESP_ERROR() << "Cannot load texture image, skipping";
+      currentTexture = nullptr;
+    } else {
+      // Configure the texture
+      currentTexture
+          ->setMagnificationFilter(currentTextureData->magnificationFilter())
+          .setMinificationFilter(currentTextureData->minificationFilter(),
+                                 currentTextureData->mipmapFilter())
+          .setWrapping(currentTextureData->wrapping().xy());
 
+      // Upload all mip levels
+      const std::uint32_t levelCount = levels.size();
       bool generateMipmap = false;
       for (std::uint32_t level = 0; level != levelCount; ++level) {
-        // TODO:
-        // it seems we have a way to just load the image once in this case,
-        // as long as the image2DName include the full path to the image
-        Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-            importer.image2D(textureData->image(), level);
-        if (!image) {
-          ESP_ERROR() << "Cannot load texture image, skipping";
-          currentTexture = nullptr;
-          break;
-        }
+        const Mn::Trade::ImageData2D& image = levels[level];
 
         Mn::GL::TextureFormat format;
-        if (image->isCompressed()) {
-          format = Mn::GL::textureFormat(image->compressedFormat());
+        if (image.isCompressed()) {
+          format = Mn::GL::textureFormat(image.compressedFormat());
         } else {
-          const auto pixelFormat = image->format();
+          const auto pixelFormat = image.format();
           format = Mn::GL::textureFormat(pixelFormat);
           // Modify swizzle for single channel textures so that they are
           // greyscale
@@ -2844,33 +3858,44 @@ void ResourceManager::loadTextures(Importer& importer,
         if (level == 0) {
           // If there is just one level and the image is not compressed, we'll
           // generate mips ourselves
-          if (levelCount == 1 && !image->isCompressed()) {
-            currentTexture->setStorage(Mn::Math::log2(image->size().max()) + 1,
-                                       format, image->size());
+          if (levelCount == 1 && !image.isCompressed()) {
+            currentTexture->setStorage(Mn::Math::log2(image.size().max()) + 1,
+                                       format, image.size());
             generateMipmap = true;
           } else {
-            currentTexture->setStorage(levelCount, format, image->size());
+            currentTexture->setStorage(levelCount, format, image.size());
           }
         }
 
-        if (image->isCompressed()) {
-          currentTexture->setCompressedSubImage(level, {}, *image);
+        if (image.isCompressed()) {
+          currentTexture->setCompressedSubImage(level, {}, image);
         } else {
-          currentTexture->setSubImage(level, {}, *image);
+          currentTexture->setSubImage(level, {}, image);
         }
       }
 
-      // Mip level loading failed, fail the whole texture
-      if (currentTexture == nullptr) {
-        continue;
-      }
-
       // Generate a mipmap if requested
       if (generateMipmap) {
         currentTexture->generateMipmap();
       }
+
+      // Estimate the GPU memory for the asset cache budget, a generated mip
+      // chain adds about a third of the base level
+      std::size_t textureBytes = 0;
+      for (const Mn::Trade::ImageData2D& image : levels) {
+        textureBytes += image.data().size();
+      }
+      if (generateMipmap) {
+        textureBytes += textureBytes / 3;
+      }
+      textureMemory_[currentTextureID] = textureBytes;
+    }
+
+    // Free the decoded image once the last texture using it is uploaded
+    if (--imageUseCounts[slot] == 0) {
+      decodedImages[slot] = Cr::Containers::NullOpt;
     }
-  }  // Whether semantic RGB or not
+  }
 }  // ResourceManager::loadTextures
 
 bool ResourceManager::instantiateAssetsOnDemand(
@@ -2942,24 +3967,8 @@ bool ResourceManager::instantiateAssetsOnDemand(
         return false;
       }
     }
-    // check if collision handle exists in collision mesh groups yet.  if not
-    // then instance
-    if (collisionMeshGroups_.count(collisionAssetHandle) == 0) {
-      // set collision mesh data
-      const MeshMetaData& meshMetaData = getMeshMetaData(collisionAssetHandle);
-
-      int start = meshMetaData.meshIndex.first;
-      int end = meshMetaData.meshIndex.second;
-      //! Gather mesh components for meshGroup data
-      std::vector<CollisionMeshData> meshGroup;
-      for (int mesh_i = start; mesh_i <= end; ++mesh_i) {
-        GenericMeshData& gltfMeshData =
-            dynamic_cast<GenericMeshData&>(*meshes_.at(mesh_i).get());
-        CollisionMeshData& meshData = gltfMeshData.getCollisionMeshData();
-        meshGroup.push_back(meshData);
-      }
-      collisionMeshGroups_.emplace(collisionAssetHandle, meshGroup);
-    }
+    // the collision mesh group itself is built by getCollisionMesh() once
+    // the object is added to physics as collidable
   }
 
   return true;
@@ -2968,7 +3977,20 @@ bool ResourceManager::instantiateAssetsOnDemand(
 const std::vector<assets::CollisionMeshData>& ResourceManager::getCollisionMesh(
     const std::string& collisionAssetHandle) const {
   auto colMeshGroupIter = collisionMeshGroups_.find(collisionAssetHandle);
-  CORRADE_INTERNAL_ASSERT(colMeshGroupIter != collisionMeshGroups_.end());
+  if (colMeshGroupIter == collisionMeshGroups_.end()) {
+    // built on first use, render-only assets never need one
+    auto resDictIter = resourceDict_.find(collisionAssetHandle);
+    CORRADE_INTERNAL_ASSERT(resDictIter != resourceDict_.end());
+    // material-modified variants carry the source asset's AssetInfo and
+    // share its meshes
+    std::vector<CollisionMeshData> meshGroup;
+    ESP_CHECK(buildMeshGroups(resDictIter->second.assetInfo, meshGroup),
+              "Failed to construct the collision mesh group for asset"
+                  << collisionAssetHandle);
+    colMeshGroupIter =
+        collisionMeshGroups_.emplace(collisionAssetHandle, std::move(meshGroup))
+            .first;
+  }
   return colMeshGroupIter->second;
 }
 
@@ -3132,10 +4154,26 @@ void ResourceManager::addComponent(
       drawableConfig.setPbrShaderConfig(pbrAttributesPtr);
     }  // if pbr, add appropriate config information
 
-    createDrawable(mesh,                // render mesh
-                   meshAttributeFlags,  // mesh attribute flags
-                   node,                // scene node
-                   drawableConfig);     // instance skinning data
+    gfx::Drawable& drawable =
+        createDrawable(mesh,                // render mesh
+                       meshAttributeFlags,  // mesh attribute flags
+                       node,                // scene node
+                       drawableConfig);     // instance skinning data
+
+    // simplified levels generated in loadMeshes(), if any
+    if (auto* genericMeshData =
+            dynamic_cast<GenericMeshData*>(meshes_.at(meshID).get())) {
+      std::vector<gfx::Drawable::LodLevel> lodLevels;
+      for (std::size_t i = 0; i != genericMeshData->getLodLevelCount(); ++i) {
+        if (Mn::GL::Mesh* lodMesh = genericMeshData->getLodMagnumGLMesh(i)) {
+          lodLevels.push_back(
+              {lodMesh, genericMeshData->getLodMaxPixelSize(i)});
+        }
+      }
+      if (!lodLevels.empty()) {
+        drawable.setLodLevels(std::move(lodLevels));
+      }
+    }
 
     // compute the bounding box for the mesh we are adding
     if (computeAbsoluteAABBs) {
@@ -3224,21 +4262,23 @@ void ResourceManager::removePrimitiveMesh(int primitiveID) {
   primitive_meshes_.erase(primMeshIter);
 }
 
-void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
-                                     gfx::Drawable::Flags& meshAttributeFlags,
-                                     scene::SceneNode& node,
-                                     gfx::DrawableConfiguration& drawableCfg) {
+gfx::Drawable& ResourceManager::createDrawable(
+    Mn::GL::Mesh* mesh,
+    gfx::Drawable::Flags& meshAttributeFlags,
+    scene::SceneNode& node,
+    gfx::DrawableConfiguration& drawableCfg) {
+  gfx::Drawable* drawable = nullptr;
   switch (drawableCfg.materialDataType_) {
     case ObjectInstanceShaderType::Flat:
     case ObjectInstanceShaderType::Phong:
-      node.addFeature<gfx::GenericDrawable>(
+      drawable = &node.addFeature<gfx::GenericDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
           drawableCfg);
       break;
     case ObjectInstanceShaderType::PBR:
-      node.addFeature<gfx::PbrDrawable>(
+      drawable = &node.addFeature<gfx::PbrDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
@@ -3252,6 +4292,7 @@ void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
   if (mesh) {
     drawableCountAndNumFaces_.second += mesh->count() / 3;
   }
+  return *drawable;
 
 }  // ResourceManager::createDrawable
 
@@ -3317,8 +4358,30 @@ std::shared_ptr<gfx::PbrIBLHelper> ResourceManager::getOrBuildPBRIBLHelper(
     // images were found and successfully converted into textures.
 
     if (blutTexture && envMapTexture) {
+      // Key the cached maps on the env map contents, so an edited image
+      // isn't matched with maps computed from the old one. The image is
+      // looked up the same way as in loadIBLImageIntoTexture().
+      std::string cacheFilePrefix;
+      const std::string& iblCacheDir =
+          metadataMediator_->getSimulatorConfiguration().iblCacheDir;
+      if (!iblCacheDir.empty()) {
+        const std::string prefixedEnvMapFilename = "env_maps/" + envMapFilename;
+        Cr::Containers::Optional<Cr::Containers::Array<char>> envMapFileData;
+        Cr::Containers::ArrayView<const char> envMapData;
+        if (rs.hasFile(envMapFilename)) {
+          envMapData = rs.getRaw(envMapFilename);
+        } else if (rs.hasFile(prefixedEnvMapFilename)) {
+          envMapData = rs.getRaw(prefixedEnvMapFilename);
+        } else if ((envMapFileData = Cr::Utility::Path::read(envMapFilename))) {
+          envMapData = *envMapFileData;
+        }
+        if (!envMapData.isEmpty()) {
+          cacheFilePrefix =
+              gfx::PbrIBLHelper::getCacheFilePrefix(iblCacheDir, envMapData);
+        }
+      }
       pbrIBLHelper = std::make_shared<gfx::PbrIBLHelper>(
-          shaderManager_, blutTexture, envMapTexture);
+          shaderManager_, blutTexture, envMapTexture, cacheFilePrefix);
       pbrIBLHelpers_.emplace(helperKey, pbrIBLHelper);
     }
   }  // if found else create
@@ -3570,33 +4633,49 @@ void ResourceManager::setLightSetup(gfx::LightSetup setup,
 
   shaderManager_.set(key, std::move(setup), Mn::ResourceDataState::Mutable,
                      Mn::ResourcePolicy::Manual);
+  scene::SceneNode::markAppearanceChanged();
 }
 
-std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
+const MeshData& ResourceManager::getJoinedCollisionMesh(
     const std::string& filename) const {
-  std::unique_ptr<MeshData> mesh = std::make_unique<MeshData>();
-
-  const MeshMetaData& metaData = getMeshMetaData(filename);
-
-  Mn::Matrix4 identity;
-  joinHierarchy(*mesh, metaData, metaData.root, identity);
+  auto joinedMeshIter = joinedCollisionMeshes_.find(filename);
+  if (joinedMeshIter == joinedCollisionMeshes_.end()) {
+    const MeshMetaData& metaData = getMeshMetaData(filename);
+
+    MeshData mesh;
+    Mn::Matrix4 identity;
+    joinHierarchy(mesh, metaData, metaData.root, identity);
+    joinedMeshIter =
+        joinedCollisionMeshes_.emplace(filename, std::move(mesh)).first;
+  }
+  return joinedMeshIter->second;
+}
 
-  return mesh;
+std::unique_ptr<MeshData> ResourceManager::createJoinedCollisionMesh(
+    const std::string& filename) const {
+  return std::make_unique<MeshData>(getJoinedCollisionMesh(filename));
 }
 
 std::unique_ptr<MeshData> ResourceManager::createJoinedSemanticCollisionMesh(
     std::vector<std::uint16_t>& objectIds,
     const std::string& filename) const {
-  std::unique_ptr<MeshData> mesh = std::make_unique<MeshData>();
-
-  CORRADE_INTERNAL_ASSERT(resourceDict_.count(filename) > 0);
-
-  const MeshMetaData& metaData = getMeshMetaData(filename);
-
-  Mn::Matrix4 identity;
-  joinSemanticHierarchy(*mesh, objectIds, metaData, metaData.root, identity);
+  auto joinedMeshIter = joinedSemanticMeshes_.find(filename);
+  if (joinedMeshIter == joinedSemanticMeshes_.end()) {
+    CORRADE_INTERNAL_ASSERT(resourceDict_.count(filename) > 0);
+
+    const MeshMetaData& metaData = getMeshMetaData(filename);
+
+    std::pair<MeshData, std::vector<std::uint16_t>> joined;
+    Mn::Matrix4 identity;
+    joinSemanticHierarchy(joined.first, joined.second, metaData, metaData.root,
+                          identity);
+    joinedMeshIter =
+        joinedSemanticMeshes_.emplace(filename, std::move(joined)).first;
+  }
 
-  return mesh;
+  objectIds.insert(objectIds.end(), joinedMeshIter->second.second.begin(),
+                   joinedMeshIter->second.second.end());
+  return std::make_unique<MeshData>(joinedMeshIter->second.first);
 }
 
 }  // namespace assets
@@ -9,18 +9,26 @@
  * @brief Class @ref esp::assets::ResourceManager
  */
 
+#include <algorithm>
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/EnumSet.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "Asset.h"
+#include "AssetCache.h"
+#include "MeshData.h"
 #include "MeshMetaData.h"
 #include "RigManager.h"
+#include "SemanticColorLookup.h"
+#include "esp/core/MemoryUsage.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/ShaderManager.h"
 #include "esp/gfx/SkinData.h"
@@ -84,7 +92,6 @@ namespace assets {
 class BaseMesh;
 struct CollisionMeshData;
 class GenericSemanticMeshData;
-struct MeshData;
 struct RenderAssetInstanceCreationInfo;
 // used for shadertype specification
 using metadata::attributes::ObjectInstanceShaderType;
@@ -172,10 +179,10 @@ class ResourceManager {
 
   /**
    * @brief Build @p semanticColorAsInt_ (array of colors as integers) from
-   * the current @p semanticColorMapBeingUsed_ map. The @p
-   * semanticColorAsInt_ is used when building the color matrix for conversion
-   * of colors found in semantic textures to their semantic IDs. When semantic
-   * textures are preprocessed, this will not need to be performed.
+   * the current @p semanticColorMapBeingUsed_ map, and the
+   * @ref SemanticColorLookup built from it, which converts colors found in
+   * semantic textures to their semantic IDs. When semantic textures are
+   * preprocessed, this will not need to be performed.
    */
   void buildSemanticColorAsIntMap();
 
@@ -183,13 +190,14 @@ class ResourceManager {
    * @brief Remap a semantic annotation texture to have the semantic IDs per
    * pxl.
    * @param srcImage The source texture with the semantic colors.
-   * @param clrToSemanticId Large table of all possible colors to their semantic
-   * IDs. initialized to 0xffff
+   * @param colorLookup Semantic ID of each color, colors not in it are mapped
+   * to 0.
+   * @param threadCount Number of threads the rows are split across.
    * @return An image of the semantic IDs, with the ID mapped
    */
-  Mn::Image2D convertRGBToSemanticId(
-      const Mn::ImageView2D& srcImage,
-      Cr::Containers::Array<Mn::UnsignedShort>& clrToSemanticId);
+  Mn::Image2D convertRGBToSemanticId(const Mn::ImageView2D& srcImage,
+                                     const SemanticColorLookup& colorLookup,
+                                     std::size_t threadCount = 1);
 
   /** @brief check if the @ref esp::scene::SemanticScene exists.*/
   bool semanticSceneExists() const { return (semanticScene_ != nullptr); }
@@ -238,6 +246,24 @@ class ResourceManager {
       esp::scene::SceneManager* sceneManagerPtr,
       std::vector<int>& activeSceneIDs);
 
+  /**
+   * @brief Import the general render asset @p assetFilename and save its
+   * processed geometry to a @ref StageBundle that later loads of the asset
+   * use instead of importing and processing its meshes.
+   *
+   * The meshes are saved as they'd be rendered with the current
+   * @ref sim::SimulatorConfiguration, so set
+   * @ref sim::SimulatorConfiguration::optimizeMeshes to bake optimized ones.
+   * The asset must not have been loaded by this ResourceManager yet and must
+   * not have skins.
+   * @param assetFilename The asset to bake.
+   * @param bundleFilename The file to save the bundle to. If empty, it's saved
+   * alongside the asset, where it's picked up by @ref loadStage.
+   * @return Whether the bundle was saved.
+   */
+  bool bakeStageBundle(const std::string& assetFilename,
+                       const std::string& bundleFilename = "");
+
   /**
    * @brief Construct scene collision mesh group based on name and type of
    * scene.
@@ -247,13 +273,15 @@ class ResourceManager {
    * @return whether built successfully or not
    */
   template <class T>
-  bool buildStageCollisionMeshGroup(const std::string& filename,
-                                    std::vector<CollisionMeshData>& meshGroup);
+  bool buildStageCollisionMeshGroup(
+      const std::string& filename,
+      std::vector<CollisionMeshData>& meshGroup) const;
 
   /**
    * @brief Load/instantiate any required render and collision assets for an
-   * object, if they do not already exist in @ref resourceDict_ or @ref
-   * collisionMeshGroups_, respectively. Assumes valid render and collisions
+   * object, if they do not already exist in @ref resourceDict_. The collision
+   * mesh group is only built once requested through @ref getCollisionMesh.
+   * Assumes valid render and collisions
    * asset handles have been specified (This is checked/verified during
    * registration.)
    * @param ObjectAttributes The object template describing the object we wish
@@ -271,6 +299,9 @@ class ResourceManager {
    * @brief Getter for all @ref assets::CollisionMeshData associated with the
    * particular asset.
    *
+   * The group is built and cached in @ref collisionMeshGroups_ on first
+   * request, so assets that are only rendered, or never added to physics as
+   * collidable, don't pay for it. The asset has to be loaded already.
    * @param collisionAssetHandle The key by which the asset is referenced in
    * @ref collisionMeshGroups_, from the @ref
    * esp::metadata::managers::ObjectAttributesManager::objectLibrary_.
@@ -370,11 +401,22 @@ class ResourceManager {
                      const Mn::ResourceKey& key = Mn::ResourceKey{
                          DEFAULT_LIGHTING_KEY});
 
+  /**
+   * @brief Get the unified @ref MeshData of a loaded asset's collision meshes.
+   *
+   * The meshes are joined by @ref joinHierarchy on first request and cached
+   * in @ref joinedCollisionMeshes_ until the asset is released.
+   * @param filename The identifying string key for the asset. See @ref
+   * resourceDict_ and @ref meshes_.
+   * @return The unified @ref MeshData object for the asset.
+   */
+  const MeshData& getJoinedCollisionMesh(const std::string& filename) const;
+
   /**
    * @brief Construct a unified @ref MeshData from a loaded asset's collision
    * meshes.
    *
-   * See @ref joinHierarchy.
+   * Returns a copy of @ref getJoinedCollisionMesh.
    * @param filename The identifying string key for the asset. See @ref
    * resourceDict_ and @ref meshes_.
    * @return The unified @ref MeshData object for the asset.
@@ -386,7 +428,9 @@ class ResourceManager {
    * @brief Construct a unified @ref MeshData from a loaded asset's semantic
    * meshes.
    *
-   * See @ref joinHierarchy.
+   * The meshes are joined by @ref joinSemanticHierarchy on first request and
+   * cached in @ref joinedSemanticMeshes_ until the asset is released, later
+   * calls only copy the result.
    * @param[out] objectIds vector of uint16_t, will be populated with the object
    * ids of the semantic mesh
    * @param filename The identifying string key for the asset. See @ref
@@ -450,12 +494,13 @@ class ResourceManager {
    * attached.
    * @param drawableCfg The @ref esp::gfx::DrawableConfiguration that describes
    * the drawable being created.
+   * @return The created drawable.
    */
 
-  void createDrawable(Mn::GL::Mesh* mesh,
-                      gfx::Drawable::Flags& meshAttributeFlags,
-                      scene::SceneNode& node,
-                      gfx::DrawableConfiguration& drawableCfg);
+  gfx::Drawable& createDrawable(Mn::GL::Mesh* mesh,
+                                gfx::Drawable::Flags& meshAttributeFlags,
+                                scene::SceneNode& node,
+                                gfx::DrawableConfiguration& drawableCfg);
 
   /**
    * @brief Remove the specified primitive mesh.
@@ -465,20 +510,46 @@ class ResourceManager {
   void removePrimitiveMesh(int primitiveID);
 
   /**
-   * @brief Generate a new primitive mesh asset for the NavMesh loaded in the
-   * provided PathFinder object.
+   * @brief Primitive mesh visualizing a single NavMesh tile, see
+   * @ref updateNavMeshVisualization().
+   */
+  struct NavMeshVisualizationTile {
+    /** @brief Key of the mesh in @ref primitive_meshes_. */
+    int primitiveID = ID_UNDEFINED;
+    /** @brief NavMesh tile revision the mesh was generated from. */
+    uint64_t revision = 0;
+    /** @brief Bounding box of the mesh. */
+    Mn::Range3D bounds;
+  };
+
+  /**
+   * @brief Visualization meshes of the tiles of a NavMesh, keyed by their
+   * (x, z) location on the tile grid.
+   */
+  typedef std::map<std::pair<int, int>, NavMeshVisualizationTile>
+      NavMeshVisualizationTiles;
+
+  /**
+   * @brief Bring the primitive meshes in @p tiles up to date with the NavMesh
+   * loaded in the provided PathFinder object, one per NavMesh tile.
+   *
+   * Only the meshes of tiles whose revision changed are regenerated and
+   * uploaded again, in place, so existing Drawables keep rendering them.
+   * Meshes of tiles that are gone are removed. After an incremental tiled
+   * NavMesh rebuild this touches only the rebuilt tiles.
    *
-   * If parent and drawables are provided, create the Drawable and render the
-   * NavMesh.
+   * If parent and drawables are provided, create a child node of parent with
+   * a Drawable for every tile and render the NavMesh.
    * @param pathFinder Holds the NavMesh information.
-   * @param parent The new Drawable is attached to this node.
-   * @param drawables The group with which the new Drawable will be rendered.
-   * @return The primitive ID of the new object or @ref ID_UNDEFINED if
-   * construction failed.
+   * @param[in,out] tiles The tile meshes from the previous update, if any.
+   * @param parent The new Drawables are attached to children of this node.
+   * @param drawables The group with which the new Drawables will be rendered.
+   * @return Whether the visualization could be generated.
    */
-  int loadNavMeshVisualization(esp::nav::PathFinder& pathFinder,
-                               scene::SceneNode* parent,
-                               DrawableGroup* drawables);
+  bool updateNavMeshVisualization(esp::nav::PathFinder& pathFinder,
+                                  NavMeshVisualizationTiles& tiles,
+                                  scene::SceneNode* parent,
+                                  DrawableGroup* drawables);
 
   /**
    * @brief Generate a tube following the passed trajectory of points.
@@ -526,6 +597,71 @@ class ResourceManager {
    */
   inline void setRequiresTextures(bool newVal) { requiresTextures_ = newVal; }
 
+  /**
+   * @brief Set the maximum number of threads decoding the texture images of
+   * an asset while its textures are uploaded
+   *
+   * No more threads than images and hardware threads are used either way.
+   * @cpp 1 @ce decodes all images on the loading thread. Default is
+   * @cpp 8 @ce, as every thread keeps its own importer open on the asset.
+   */
+  void setMaxImageDecodeThreads(int count) {
+    maxImageDecodeThreads_ = std::max(count, 1);
+  }
+
+  /** @brief Maximum number of threads decoding texture images */
+  int getMaxImageDecodeThreads() const { return maxImageDecodeThreads_; }
+
+  /**
+   * @brief Texture @p textureId, or nullptr if it doesn't exist or failed to
+   * load. Texture IDs of an asset are in @ref MeshMetaData::textureIndex.
+   */
+  std::shared_ptr<Mn::GL::Texture2D> getTexture(int textureId) const {
+    auto found = textures_.find(textureId);
+    return found != textures_.end() ? found->second : nullptr;
+  }
+
+  /**
+   * @brief Serve the contents of @p files, keyed by filename, to the asset
+   * importer instead of reading them from disk, until
+   * @ref clearPrefetchedFiles is called. Files that aren't in @p files are
+   * still read from disk. Used to load a scene whose files were read ahead of
+   * time by @ref sim::Simulator::prefetchScene.
+   */
+  void setPrefetchedFiles(
+      std::unordered_map<std::string, Corrade::Containers::Array<char>>&&
+          files);
+
+  /**
+   * @brief Serve the contents of @p files in addition to the files already
+   * passed to @ref setPrefetchedFiles, or start serving them if there are
+   * none. Used by @ref physics::URDFImporter to read the meshes of a
+   * freshly parsed URDF in parallel.
+   */
+  void addPrefetchedFiles(
+      std::unordered_map<std::string, Corrade::Containers::Array<char>>&&
+          files);
+
+  /**
+   * @brief Whether files passed to @ref setPrefetchedFiles or
+   * @ref addPrefetchedFiles are currently being served.
+   */
+  bool hasPrefetchedFiles() const;
+
+  /**
+   * @brief Release the files passed to @ref setPrefetchedFiles and go back to
+   * reading all files from disk.
+   */
+  void clearPrefetchedFiles();
+
+  /**
+   * @brief Whether the asset @p filename is loaded already, so its file won't
+   * be read again.
+   */
+  bool isAssetLoaded(const std::string& filename) const {
+    return resourceDict_.count(filename) > 0;
+  }
+
   /**
    * @brief Set a replay recorder so that ResourceManager can notify it about
    * render assets.
@@ -600,6 +736,25 @@ class ResourceManager {
    */
   bool loadRenderAsset(const AssetInfo& info);
 
+  /**
+   * @brief Replace the GPU meshes and textures of the loaded render asset
+   * @p filepath with those of @p replacementFilepath, in place.
+   *
+   * Meant for progressive loading, where a scene is first loaded from a
+   * low-detail variant with simplified meshes and downscaled textures, and
+   * the full-detail file is swapped in once it's available. Existing
+   * instances, drawables and the asset name are kept, so they render the
+   * replacement right away. Both files have to have the same meshes and
+   * textures in the same order, which is the case for variants produced by
+   * simplifying each mesh and resizing each texture. CPU-side mesh data,
+   * materials and thus also collision shapes stay those of the original.
+   *
+   * @return Whether the replacement was loaded and swapped in. On failure,
+   * the original is kept.
+   */
+  bool replaceRenderAsset(const std::string& filepath,
+                          const std::string& replacementFilepath);
+
   /**
    * @brief Get the shader manager.
    */
@@ -644,6 +799,61 @@ class ResourceManager {
    */
   void resetDrawableCountAndNumFaces() { drawableCountAndNumFaces_ = {0, 0}; }
 
+  /**
+   * @brief Counters and memory use of the cache of loaded render assets, see
+   * @ref evictCachedAssetsOverBudget.
+   */
+  struct AssetCacheStats {
+    /** @brief Assets needed by a scene that were still loaded from an earlier
+     * one */
+    std::size_t hits = 0;
+    /** @brief Assets that had to be imported */
+    std::size_t misses = 0;
+    /** @brief Assets released to stay within the budget */
+    std::size_t evictions = 0;
+    /** @brief Estimated CPU memory of the loaded assets, in bytes */
+    std::size_t cpuBytes = 0;
+    /** @brief Estimated GPU memory of the loaded assets, in bytes */
+    std::size_t gpuBytes = 0;
+  };
+
+  /**
+   * @brief Get the counters and memory use of the loaded asset cache.
+   */
+  const AssetCacheStats& getAssetCacheStats() const { return assetCacheStats_; }
+
+  /**
+   * @brief Estimated memory of all loaded meshes and textures.
+   *
+   * Unlike @ref getAssetCacheStats, which only covers the cached render
+   * assets, this includes primitives, semantic meshes and textures, and
+   * assets shared with other ResourceManagers through the @ref AssetCache.
+   * GPU memory of meshes is estimated as the size of their vertex and index
+   * data.
+   */
+  core::MemoryUsage getMemoryUsage() const;
+
+  /**
+   * @brief Start a new scene: assets loaded or instanced from now on are
+   * marked as used by it and won't be evicted by
+   * @ref evictCachedAssetsOverBudget until the next call.
+   */
+  void beginSceneAssetUse() { ++sceneAssetEpoch_; }
+
+  /**
+   * @brief Release the least recently used render assets not used by the
+   * current scene until the estimated memory of all loaded assets fits
+   * @ref sim::SimulatorConfiguration::assetCacheCpuBudget and
+   * @ref sim::SimulatorConfiguration::assetCacheGpuBudget, if set.
+   *
+   * Only assets that aren't instanced in the current scene are released, so
+   * the budget can be exceeded if the current scene alone doesn't fit. A
+   * released asset is imported again the next time it's needed. Scene graphs
+   * of earlier scenes may still reference the released meshes and textures
+   * and must not be drawn afterwards.
+   */
+  void evictCachedAssetsOverBudget();
+
  private:
   /**
    * @brief Retrieve the appropriate @ref eps::gfx::PbrIBLHelper for the passed
@@ -773,6 +983,12 @@ class ResourceManager {
   struct LoadedAssetData {
     AssetInfo assetInfo;
     MeshMetaData meshMetaData;
+    /**
+     * @brief Absolute AABBs of the drawables of a static instance at the
+     * origin, in the order @ref addComponent creates them. Only set for assets
+     * loaded from a @ref StageBundle.
+     */
+    std::vector<Mn::Range3D> absoluteAABBs{};
   };
 
   /**
@@ -1021,13 +1237,13 @@ class ResourceManager {
 
   /**
    * @brief Builds the appropriate collision mesh groups for the passed
-   * assetInfo, and adds it to the @ref collisionMeshGroup map.
+   * assetInfo. Cached by @ref getCollisionMesh.
    * @param info The @ref AssetInfo for the mesh, already parsed from a file.
    * @param meshGroup The constructed @ref meshGroup
    * @return Whether the meshgroup was successfully built or not
    */
   bool buildMeshGroups(const AssetInfo& info,
-                       std::vector<CollisionMeshData>& meshGroup);
+                       std::vector<CollisionMeshData>& meshGroup) const;
 
   /**
    * @brief Creates a map of appropriate asset infos for sceneries.  Will always
@@ -1078,6 +1294,56 @@ class ResourceManager {
    */
   bool loadRenderAssetGeneral(const AssetInfo& info);
 
+  /**
+   * @brief Load a general render asset from the @ref StageBundle baked for it
+   * by @ref bakeStageBundle, if there's a valid one. Only materials and
+   * textures are imported from the asset itself.
+   * @return Whether the asset was loaded, otherwise nothing was changed.
+   */
+  bool loadRenderAssetFromStageBundle(const AssetInfo& info);
+
+  /**
+   * @brief Try to satisfy a general render asset load from the process-wide
+   * @ref AssetCache instead of importing the file. On success the shared
+   * meshes, textures, skins, materials and collision meshes are registered
+   * under this ResourceManager's own IDs.
+   * @return Whether a compatible shared asset was adopted.
+   */
+  bool adoptSharedRenderAsset(const AssetInfo& info);
+
+  /**
+   * @brief Publish a freshly imported general render asset to the
+   * process-wide @ref AssetCache so other ResourceManagers can adopt it.
+   * @param info The @ref AssetInfo the asset was loaded with.
+   * @param materialStart Value of @ref nextMaterialID_ before the asset's
+   * materials were loaded.
+   */
+  void publishSharedRenderAsset(const AssetInfo& info, int materialStart);
+
+  /**
+   * @brief Add a freshly loaded render asset to the cache bookkeeping of
+   * @ref evictCachedAssetsOverBudget, estimating its memory use.
+   */
+  void registerCachedAsset(const std::string& filepath);
+
+  /**
+   * @brief Mark a cached render asset as used by the current scene and move
+   * it to the front of the LRU order.
+   */
+  void touchCachedAsset(const std::string& filepath);
+
+  /**
+   * @brief Release the meshes, textures, skins and collision data of a cached
+   * render asset along with all its material-modified variants.
+   */
+  void releaseCachedAsset(const std::string& filepath);
+
+  /**
+   * @brief The GL context GPU resources of this ResourceManager live in, or
+   * nullptr if it is not rendering.
+   */
+  const Mn::GL::Context* getSharedAssetGLContext() const;
+
   /**
    * @brief Create a render asset instance.
    *
@@ -1294,6 +1560,12 @@ class ResourceManager {
    */
   std::vector<uint32_t> semanticColorAsInt_{};
 
+  /**
+   * @brief Semantic ID of each color in @ref semanticColorAsInt_, for
+   * converting semantic textures.
+   */
+  SemanticColorLookup semanticColorLookup_{};
+
   // ======== Physical parameter data ========
 
   /**
@@ -1308,15 +1580,95 @@ class ResourceManager {
 
   /**
    * @brief Maps string keys (typically property filenames) to @ref
-   * CollisionMeshData for all components of a loaded asset.
+   * CollisionMeshData for all components of a loaded asset. Filled lazily by
+   * @ref getCollisionMesh.
    */
-  std::map<std::string, std::vector<CollisionMeshData>> collisionMeshGroups_;
+  mutable std::map<std::string, std::vector<CollisionMeshData>>
+      collisionMeshGroups_;
+
+  /**
+   * @brief Maps string keys (typically property filenames) to the @ref
+   * MeshData joined from all collision meshes of a loaded asset. Filled lazily
+   * by @ref getJoinedCollisionMesh.
+   */
+  mutable std::map<std::string, MeshData> joinedCollisionMeshes_;
+
+  /**
+   * @brief Maps string keys (typically property filenames) to the @ref
+   * MeshData joined from all semantic meshes of a loaded asset and its
+   * per-vertex object ids. Filled lazily by @ref
+   * createJoinedSemanticCollisionMesh.
+   */
+  mutable std::map<std::string,
+                   std::pair<MeshData, std::vector<std::uint16_t>>>
+      joinedSemanticMeshes_;
+
+  /**
+   * @brief References to the @ref SharedRenderAsset entries this
+   * ResourceManager published or adopted, keeping them alive in the
+   * process-wide @ref AssetCache while in use.
+   */
+  std::vector<SharedRenderAsset::cptr> sharedRenderAssets_;
 
   /**
    * @brief Flag to load textures of meshes
    */
   bool requiresTextures_ = true;
 
+  //! see @ref setMaxImageDecodeThreads()
+  int maxImageDecodeThreads_ = 8;
+
+  /**
+   * @brief Files served to @ref fileImporter_ from memory, see
+   * @ref setPrefetchedFiles. Also holds the files read through the callback
+   * while it's set, as the importer doesn't own the data it gets from it.
+   */
+  std::unordered_map<std::string, Corrade::Containers::Array<char>>
+      prefetchedFiles_;
+
+  /**
+   * @brief Bookkeeping of a loaded render asset for
+   * @ref evictCachedAssetsOverBudget
+   */
+  struct CachedAssetEntry {
+    std::list<std::string>::iterator lruPosition;
+    std::size_t cpuBytes = 0;
+    std::size_t gpuBytes = 0;
+    //! @ref sceneAssetEpoch_ the asset was last used in
+    std::size_t sceneEpoch = 0;
+  };
+
+  /**
+   * @brief Loaded render assets keyed by filepath, material-modified variants
+   * included under the filepath of the asset they were made from
+   */
+  std::unordered_map<std::string, CachedAssetEntry> cachedAssets_;
+
+  /**
+   * @brief Filepaths of @ref cachedAssets_, most recently used first
+   */
+  std::list<std::string> cachedAssetLru_;
+
+  /**
+   * @brief Incremented by @ref beginSceneAssetUse
+   */
+  std::size_t sceneAssetEpoch_ = 0;
+
+  AssetCacheStats assetCacheStats_;
+
+  /**
+   * @brief GPU memory of the textures in @ref textures_ uploaded by this
+   * ResourceManager, in bytes
+   */
+  std::unordered_map<int, std::size_t> textureMemory_;
+
+  /**
+   * @brief Whether the GPU supports the BC1 and BC3 formats textures are
+   * compressed to with @ref sim::SimulatorConfiguration::compressTextures. Set
+   * by @ref configureImporterManagerGLExtensions.
+   */
+  bool bcTextureCompressionSupported_ = false;
+
   /**
    * @brief See @ref setRecorder.
    */
@@ -5,6 +5,7 @@
 #ifndef ESP_ASSETS_RIGMANAGER_H_
 #define ESP_ASSETS_RIGMANAGER_H_
 
+#include "esp/gfx/BonePalette.h"
 #include "esp/gfx/SkinData.h"
 
 namespace esp {
@@ -58,6 +59,14 @@ class RigManager {
    */
   gfx::Rig& getRigInstance(int rigId);
 
+  /**
+   * @brief Get the palette the joint matrices of all skinned instances are
+   * packed into.
+   */
+  const std::shared_ptr<gfx::BonePalette>& getBonePalette() const {
+    return _bonePalette;
+  }
+
  private:
   /**
    * @brief The rigs for instantiated skinned assets.
@@ -68,6 +77,12 @@ class RigManager {
    * @brief The next available unique ID for instantiated rigs.
    */
   int _nextRigInstanceID = 0;
+
+  /**
+   * @brief Joint matrices of all skinned instances. Shared with their skin
+   * data, which releases its range when the instance is deleted.
+   */
+  std::shared_ptr<gfx::BonePalette> _bonePalette = gfx::BonePalette::create();
 };
 
 }  // namespace assets
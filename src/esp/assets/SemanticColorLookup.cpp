@@ -0,0 +1,113 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "SemanticColorLookup.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/PixelFormat.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+SemanticColorLookup::SemanticColorLookup(const std::vector<uint32_t>& colors) {
+  // smallest power of two at least twice the color count, keeping probe
+  // sequences short
+  uint32_t bits = 1;
+  while ((std::size_t(1) << bits) < colors.size() * 2) {
+    ++bits;
+  }
+  shift_ = 32 - bits;
+  keys_.assign(std::size_t(1) << bits, EmptyKey);
+  ids_.assign(keys_.size(), 0);
+
+  const uint32_t mask = uint32_t(keys_.size() - 1);
+  for (std::size_t id = 0; id != colors.size(); ++id) {
+    // black is already mapped to 0
+    if (colors[id] == 0) {
+      continue;
+    }
+    uint32_t i = hash(colors[id]);
+    while (keys_[i] != EmptyKey && keys_[i] != colors[id]) {
+      i = (i + 1) & mask;
+    }
+    if (keys_[i] == EmptyKey) {
+      keys_[i] = colors[id];
+      ++size_;
+    }
+    ids_[i] = static_cast<Mn::UnsignedShort>(id);
+  }
+}
+
+Mn::Image2D SemanticColorLookup::convert(const Mn::ImageView2D& image,
+                                         std::size_t threadCount) const {
+  CORRADE_ASSERT(image.pixelSize() == 3,
+                 "SemanticColorLookup::convert(): expected an RGB8 image, got"
+                     << image.format(),
+                 (Mn::Image2D{Mn::PixelFormat::R16UI}));
+
+  const Mn::Vector2i size = image.size();
+  Mn::Image2D result{
+      Mn::PixelFormat::R16UI, size,
+      Cr::Containers::Array<char>{
+          Mn::NoInit, std::size_t(size.product()) *
+                          pixelFormatSize(Mn::PixelFormat::R16UI)}};
+
+  const Cr::Containers::StridedArrayView2D<const char> input = image.pixels();
+  const Cr::Containers::StridedArrayView2D<Mn::UnsignedShort> output =
+      result.pixels<Mn::UnsignedShort>();
+  const auto convertRows = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t y = begin; y != end; ++y) {
+      // pixels within a row are always tightly packed
+      const auto* bytes =
+          static_cast<const Mn::UnsignedByte*>(input[y].data());
+      Cr::Containers::StridedArrayView1D<Mn::UnsignedShort> outputRow =
+          output[y];
+      // neighboring texels mostly belong to the same object, so repeated
+      // colors skip the table
+      uint32_t lastColor = EmptyKey;
+      Mn::UnsignedShort lastId = 0;
+      for (std::size_t x = 0; x != std::size_t(size.x()); ++x) {
+        const uint32_t color = (uint32_t(bytes[3 * x]) << 16) |
+                               (uint32_t(bytes[3 * x + 1]) << 8) |
+                               uint32_t(bytes[3 * x + 2]);
+        if (color != lastColor) {
+          lastColor = color;
+          lastId = (*this)(color);
+        }
+        outputRow[x] = lastId;
+      }
+    }
+  };
+
+  const std::size_t rowCount = std::size_t(size.y());
+  // not worth a thread for less than a few rows each
+  threadCount = std::max<std::size_t>(
+      1, std::min(threadCount, rowCount / 16));
+  if (threadCount == 1) {
+    convertRows(0, rowCount);
+    return result;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(threadCount - 1);
+  for (std::size_t i = 1; i != threadCount; ++i) {
+    workers.emplace_back(convertRows, rowCount * i / threadCount,
+                         rowCount * (i + 1) / threadCount);
+  }
+  convertRows(0, rowCount / threadCount);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return result;
+}  // SemanticColorLookup::convert
+
+}  // namespace assets
+}  // namespace esp
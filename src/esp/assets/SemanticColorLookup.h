@@ -0,0 +1,89 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_SEMANTICCOLORLOOKUP_H_
+#define ESP_ASSETS_SEMANTICCOLORLOOKUP_H_
+
+/** @file
+ * @brief Class @ref esp::assets::SemanticColorLookup
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Magnum.h>
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Maps the colors of semantic annotation textures to semantic IDs
+ *
+ * Colors are kept in a flat open-addressing hash table that's at most half
+ * full, so a lookup touches one or two cache lines of a table sized by the
+ * number of semantic colors, instead of a random spot in a 32 MB table of all
+ * 24-bit colors. Black and colors not in the map are mapped to ID 0, the
+ * unknown object.
+ */
+class SemanticColorLookup {
+ public:
+  /** @brief Constructor, mapping every color to ID 0 */
+  SemanticColorLookup() = default;
+
+  /**
+   * @brief Constructor
+   * @param colors  Color of each semantic ID, as given by
+   *    @ref geo::getValueAsUInt(const Magnum::Color3ub&). If a color appears
+   *    more than once, the last ID wins.
+   */
+  explicit SemanticColorLookup(const std::vector<uint32_t>& colors);
+
+  /** @brief Number of colors mapped to a non-zero ID */
+  std::size_t size() const { return size_; }
+
+  /** @brief Semantic ID of a color */
+  Magnum::UnsignedShort operator()(uint32_t color) const {
+    if (keys_.empty()) {
+      return 0;
+    }
+    const uint32_t mask = uint32_t(keys_.size() - 1);
+    for (uint32_t i = hash(color);; i = (i + 1) & mask) {
+      if (keys_[i] == color) {
+        return ids_[i];
+      }
+      if (keys_[i] == EmptyKey) {
+        return 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Convert an RGB8 semantic texture to an R16UI image of IDs
+   * @param image        Semantic texture
+   * @param threadCount  Number of threads the rows are split across
+   */
+  Magnum::Image2D convert(const Magnum::ImageView2D& image,
+                          std::size_t threadCount = 1) const;
+
+ private:
+  // colors are 24-bit, so this never collides with one
+  static constexpr uint32_t EmptyKey = ~uint32_t(0);
+
+  uint32_t hash(uint32_t color) const {
+    // Fibonacci hashing, the high bits are the best mixed
+    return (color * 2654435769u) >> shift_;
+  }
+
+  std::vector<uint32_t> keys_;
+  std::vector<Magnum::UnsignedShort> ids_;
+  uint32_t shift_ = 32;
+  std::size_t size_ = 0;
+};
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_SEMANTICCOLORLOOKUP_H_
@@ -0,0 +1,283 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "StageBundle.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+/* Bump whenever the bundle layout or the mesh layout of
+   GenericMeshData::serializeMeshData() changes, so stale bundles aren't
+   used */
+constexpr Mn::UnsignedInt stageBundleVersion = 1;
+constexpr char stageBundleMagic[4]{'H', 'S', 'S', 'B'};
+
+enum StageBundleFlag : Mn::UnsignedInt { HasNormals = 1 << 0 };
+
+struct StageBundleHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedLong assetSize;
+  Mn::UnsignedInt meshCount;
+  Mn::UnsignedInt nodeCount;
+  Mn::UnsignedInt aabbCount;
+  Mn::Int materialCount;
+  Mn::UnsignedInt flags;
+  Mn::UnsignedInt namesSize;
+};
+
+struct StageBundleMesh {
+  Mn::UnsignedLong offset;
+  Mn::UnsignedLong size;
+  Mn::Range3D bb;
+};
+
+struct StageBundleNode {
+  // index of the parent node, -1 for the root. Nodes are stored depth-first,
+  // so parents always come before their children
+  Mn::Int parent;
+  Mn::Int meshIDLocal;
+  Mn::Int componentID;
+  // asset-local material index, -1 for the default material
+  Mn::Int material;
+  Mn::Matrix4 transformFromLocalToParent;
+  Mn::UnsignedInt nameOffset;
+  Mn::UnsignedInt nameSize;
+};
+
+void flattenNodes(const MeshTransformNode& node,
+                  int parent,
+                  std::vector<StageBundleNode>& nodes,
+                  std::string& names) {
+  StageBundleNode flat{};
+  flat.parent = parent;
+  flat.meshIDLocal = node.meshIDLocal;
+  flat.componentID = node.componentID;
+  flat.material = node.materialID.empty() ||
+                          node.materialID.find_first_not_of("0123456789") !=
+                              std::string::npos
+                      ? -1
+                      : std::stoi(node.materialID);
+  flat.transformFromLocalToParent = node.transformFromLocalToParent;
+  flat.nameOffset = names.size();
+  flat.nameSize = node.name.size();
+  names += node.name;
+  const int index = nodes.size();
+  nodes.push_back(flat);
+  for (const MeshTransformNode& child : node.children) {
+    flattenNodes(child, index, nodes, names);
+  }
+}
+
+MeshTransformNode buildNode(const std::vector<StageBundleNode>& nodes,
+                            const std::vector<std::vector<int>>& children,
+                            Cr::Containers::ArrayView<const char> names,
+                            int index) {
+  const StageBundleNode& flat = nodes[index];
+  MeshTransformNode node;
+  node.meshIDLocal = flat.meshIDLocal;
+  node.componentID = flat.componentID;
+  if (flat.material != -1) {
+    node.materialID = std::to_string(flat.material);
+  }
+  node.transformFromLocalToParent = flat.transformFromLocalToParent;
+  node.name = std::string{names.data() + flat.nameOffset, flat.nameSize};
+  node.children.reserve(children[index].size());
+  for (int child : children[index]) {
+    node.children.push_back(buildNode(nodes, children, names, child));
+  }
+  return node;
+}
+
+}  // namespace
+
+std::string getStageBundleFilename(const std::string& assetFilename) {
+  return Cr::Utility::formatString("{}.bundle", assetFilename);
+}
+
+Cr::Containers::Optional<StageBundle> loadStageBundle(
+    const std::string& filename,
+    const std::string& assetFilename) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return Cr::Containers::NullOpt;
+  }
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  if (!assetSize) {
+    return Cr::Containers::NullOpt;
+  }
+
+  // the meshes get copied out of the file only once, straight into their
+  // final storage
+  StageBundle bundle;
+  Cr::Containers::ArrayView<const char> data;
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+  {
+    Cr::Containers::Optional<
+        Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+        mapped = Cr::Utility::Path::mapRead(filename);
+    if (!mapped) {
+      return Cr::Containers::NullOpt;
+    }
+    auto storage = std::make_shared<
+        Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>(
+        *std::move(mapped));
+    data = *storage;
+    bundle.storage = std::move(storage);
+  }
+#else
+  {
+    Cr::Containers::Optional<Cr::Containers::Array<char>> read =
+        Cr::Utility::Path::read(filename);
+    if (!read) {
+      return Cr::Containers::NullOpt;
+    }
+    auto storage =
+        std::make_shared<Cr::Containers::Array<char>>(*std::move(read));
+    data = *storage;
+    bundle.storage = std::move(storage);
+  }
+#endif
+
+  if (data.size() < sizeof(StageBundleHeader)) {
+    return Cr::Containers::NullOpt;
+  }
+  StageBundleHeader header;
+  std::memcpy(&header, data.data(), sizeof(StageBundleHeader));
+  const std::size_t nodesOffset =
+      sizeof(StageBundleHeader) +
+      std::size_t(header.meshCount) * sizeof(StageBundleMesh);
+  const std::size_t aabbsOffset =
+      nodesOffset + std::size_t(header.nodeCount) * sizeof(StageBundleNode);
+  const std::size_t namesOffset =
+      aabbsOffset + std::size_t(header.aabbCount) * sizeof(Mn::Range3D);
+  const std::size_t meshesOffset = namesOffset + header.namesSize;
+  if (std::memcmp(header.magic, stageBundleMagic, sizeof(stageBundleMagic)) ||
+      header.version != stageBundleVersion ||
+      header.assetSize != *assetSize || header.nodeCount == 0 ||
+      data.size() < meshesOffset) {
+    return Cr::Containers::NullOpt;
+  }
+
+  bundle.meshes.reserve(header.meshCount);
+  bundle.meshBBs.reserve(header.meshCount);
+  for (Mn::UnsignedInt i = 0; i != header.meshCount; ++i) {
+    StageBundleMesh mesh;
+    std::memcpy(&mesh,
+                data.data() + sizeof(StageBundleHeader) +
+                    i * sizeof(StageBundleMesh),
+                sizeof(StageBundleMesh));
+    if (mesh.offset < meshesOffset || mesh.offset + mesh.size > data.size()) {
+      return Cr::Containers::NullOpt;
+    }
+    bundle.meshes.push_back(data.slice(mesh.offset, mesh.offset + mesh.size));
+    bundle.meshBBs.push_back(mesh.bb);
+  }
+
+  std::vector<StageBundleNode> nodes(header.nodeCount);
+  std::memcpy(nodes.data(), data.data() + nodesOffset,
+              nodes.size() * sizeof(StageBundleNode));
+  std::vector<std::vector<int>> children(nodes.size());
+  for (std::size_t i = 0; i != nodes.size(); ++i) {
+    const StageBundleNode& node = nodes[i];
+    if ((i == 0) != (node.parent == -1) || node.parent >= int(i) ||
+        node.meshIDLocal >= int(header.meshCount) ||
+        std::size_t(node.nameOffset) + node.nameSize > header.namesSize) {
+      return Cr::Containers::NullOpt;
+    }
+    if (i != 0) {
+      children[node.parent].push_back(i);
+    }
+  }
+  bundle.root = buildNode(
+      nodes, children, data.slice(namesOffset, meshesOffset), 0);
+
+  bundle.absoluteAABBs.resize(header.aabbCount);
+  std::memcpy(bundle.absoluteAABBs.data(), data.data() + aabbsOffset,
+              bundle.absoluteAABBs.size() * sizeof(Mn::Range3D));
+  bundle.materialCount = header.materialCount;
+  bundle.hasNormals = header.flags & StageBundleFlag::HasNormals;
+  return bundle;
+}  // loadStageBundle
+
+bool saveStageBundle(const StageBundle& bundle,
+                     const std::string& filename,
+                     const std::string& assetFilename) {
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  if (!assetSize || bundle.meshes.size() != bundle.meshBBs.size()) {
+    return false;
+  }
+
+  std::vector<StageBundleNode> nodes;
+  std::string names;
+  flattenNodes(bundle.root, -1, nodes, names);
+
+  StageBundleHeader header{};
+  std::memcpy(header.magic, stageBundleMagic, sizeof(stageBundleMagic));
+  header.version = stageBundleVersion;
+  header.assetSize = *assetSize;
+  header.meshCount = bundle.meshes.size();
+  header.nodeCount = nodes.size();
+  header.aabbCount = bundle.absoluteAABBs.size();
+  header.materialCount = bundle.materialCount;
+  header.flags = bundle.hasNormals ? StageBundleFlag::HasNormals : 0;
+  header.namesSize = names.size();
+
+  const std::size_t nodesOffset =
+      sizeof(StageBundleHeader) +
+      std::size_t(header.meshCount) * sizeof(StageBundleMesh);
+  const std::size_t aabbsOffset =
+      nodesOffset + nodes.size() * sizeof(StageBundleNode);
+  const std::size_t namesOffset =
+      aabbsOffset + bundle.absoluteAABBs.size() * sizeof(Mn::Range3D);
+  // keep the mesh data 8-byte aligned in the file, and thus in the mapping
+  const std::size_t meshesOffset =
+      (namesOffset + names.size() + 7) & ~std::size_t{7};
+  std::size_t dataSize = meshesOffset;
+  for (const auto& mesh : bundle.meshes) {
+    dataSize += (mesh.size() + 7) & ~std::size_t{7};
+  }
+
+  Cr::Containers::Array<char> data{Cr::ValueInit, dataSize};
+  std::memcpy(data.data(), &header, sizeof(StageBundleHeader));
+  std::size_t offset = meshesOffset;
+  for (std::size_t i = 0; i != bundle.meshes.size(); ++i) {
+    const StageBundleMesh mesh{offset, bundle.meshes[i].size(),
+                               bundle.meshBBs[i]};
+    std::memcpy(data.data() + sizeof(StageBundleHeader) +
+                    i * sizeof(StageBundleMesh),
+                &mesh, sizeof(StageBundleMesh));
+    std::memcpy(data.data() + offset, bundle.meshes[i].data(),
+                bundle.meshes[i].size());
+    offset += (bundle.meshes[i].size() + 7) & ~std::size_t{7};
+  }
+  std::memcpy(data.data() + nodesOffset, nodes.data(),
+              nodes.size() * sizeof(StageBundleNode));
+  std::memcpy(data.data() + aabbsOffset, bundle.absoluteAABBs.data(),
+              bundle.absoluteAABBs.size() * sizeof(Mn::Range3D));
+  std::memcpy(data.data() + namesOffset, names.data(), names.size());
+
+  // stages may be loaded by other processes while baking, so only move the
+  // file in place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&data));
+  return Cr::Utility::Path::write(tmpFilename, data) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveStageBundle
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_STAGEBUNDLE_H_
+#define ESP_ASSETS_STAGEBUNDLE_H_
+
+/** @file
+ * @brief Struct @ref esp::assets::StageBundle and functions reading and
+ * writing it, see @ref esp::assets::ResourceManager::bakeStageBundle
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+
+#include "MeshMetaData.h"
+
+namespace esp {
+namespace assets {
+
+/**
+@brief Preprocessed geometry of a general render asset
+
+Holds everything importing a stage computes that doesn't depend on the GPU:
+the meshes in their final, GPU-ready vertex and index layout, their bounding
+boxes, the component hierarchy and the absolute bounding boxes of its mesh
+nodes. Loading it replaces mesh import, processing and bounding box
+computation with a copy per mesh. Materials and textures aren't included and
+still come from the asset itself.
+*/
+struct StageBundle {
+  /**
+   * @brief Meshes, each laid out by @ref GenericMeshData::serializeMeshData()
+   *
+   * Views into @ref storage when loaded with @ref loadStageBundle().
+   */
+  std::vector<Corrade::Containers::ArrayView<const char>> meshes;
+
+  /** @brief Bounding box of each of @ref meshes */
+  std::vector<Magnum::Range3D> meshBBs;
+
+  /**
+   * @brief Component hierarchy without the asset frame orientation
+   *
+   * Material IDs are indices local to the asset, or empty if a node uses the
+   * default material.
+   */
+  MeshTransformNode root;
+
+  /** @brief Number of materials in the source asset */
+  int materialCount = 0;
+
+  /**
+   * @brief Absolute bounding box of each node of @ref root that has a mesh,
+   * in depth-first order, for an instance at the origin without any frame
+   * orientation
+   */
+  std::vector<Magnum::Range3D> absoluteAABBs;
+
+  /**
+   * @brief Whether the meshes have normals, i.e. can be drawn with lighting
+   */
+  bool hasNormals = true;
+
+  /** @brief The file @ref meshes point into, if loaded */
+  std::shared_ptr<const void> storage;
+};
+
+/**
+ * @brief Name of the bundle baked for @p assetFilename, stored alongside it
+ */
+std::string getStageBundleFilename(const std::string& assetFilename);
+
+/**
+ * @brief Load a bundle saved by @ref saveStageBundle()
+ *
+ * The file is memory-mapped where possible. Returns
+ * @ref Corrade::Containers::NullOpt if it doesn't exist, is corrupted, or was
+ * baked from a different version of @p assetFilename.
+ */
+Corrade::Containers::Optional<StageBundle> loadStageBundle(
+    const std::string& filename,
+    const std::string& assetFilename);
+
+/**
+ * @brief Save @p bundle baked from @p assetFilename
+ *
+ * Returns @cpp false @ce if the file can't be written.
+ */
+bool saveStageBundle(const StageBundle& bundle,
+                     const std::string& filename,
+                     const std::string& assetFilename);
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_STAGEBUNDLE_H_
@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TextureCompression.h"
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include <cstdint>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+// bump when the way textures are compressed changes, so stale caches are
+// ignored
+constexpr unsigned int textureCacheVersion = 1;
+
+bool isBlockAligned(const Mn::Vector2i& size) {
+  return size.min() >= 4 && (size % 4).isZero();
+}
+
+/**
+ * @brief Half the size of an 8-bit-per-channel image with a 2x2 box filter.
+ * The size of @p image has to be even.
+ */
+Mn::Image2D downsampleImage(const Mn::ImageView2D& image) {
+  const Mn::Vector2i size = image.size() / 2;
+  const std::size_t pixelSize = image.pixelSize();
+  // tightly packed, RGB rows don't have to be a multiple of four bytes
+  Mn::Image2D result{
+      Mn::PixelStorage{}.setAlignment(1), image.format(), size,
+      Cr::Containers::Array<char>{Cr::NoInit,
+                                  std::size_t(size.product()) * pixelSize}};
+
+  const Cr::Containers::StridedArrayView3D<const char> src = image.pixels();
+  const Cr::Containers::StridedArrayView3D<char> dst = result.pixels();
+  for (std::size_t y = 0; y != std::size_t(size.y()); ++y) {
+    for (std::size_t x = 0; x != std::size_t(size.x()); ++x) {
+      for (std::size_t c = 0; c != pixelSize; ++c) {
+        const unsigned int sum =
+            Mn::UnsignedByte(src[2 * y][2 * x][c]) +
+            Mn::UnsignedByte(src[2 * y][2 * x + 1][c]) +
+            Mn::UnsignedByte(src[2 * y + 1][2 * x][c]) +
+            Mn::UnsignedByte(src[2 * y + 1][2 * x + 1][c]);
+        dst[y][x][c] = char((sum + 2) / 4);
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+bool isCompressibleTextureImage(const Mn::ImageView2D& image) {
+  if (image.isCompressed()) {
+    return false;
+  }
+  const Mn::PixelFormat format = image.format();
+  return (format == Mn::PixelFormat::RGB8Unorm ||
+          format == Mn::PixelFormat::RGB8Srgb ||
+          format == Mn::PixelFormat::RGBA8Unorm ||
+          format == Mn::PixelFormat::RGBA8Srgb) &&
+         isBlockAligned(image.size());
+}
+
+std::vector<Mn::Trade::ImageData2D> compressTextureImage(
+    const Mn::ImageView2D& image) {
+  std::vector<Mn::Trade::ImageData2D> levels;
+  if (!isCompressibleTextureImage(image)) {
+    return levels;
+  }
+  // a manager per call, as neither managers nor converters are thread-safe
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter =
+      manager.loadAndInstantiate("StbDxtImageConverter");
+  if (!converter) {
+    return levels;
+  }
+
+  Cr::Containers::Optional<Mn::Image2D> mip;
+  Mn::ImageView2D level = image;
+  for (;;) {
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> compressed =
+        converter->convert(level);
+    if (!compressed || !compressed->isCompressed()) {
+      levels.clear();
+      return levels;
+    }
+    levels.push_back(std::move(*compressed));
+    if (!isBlockAligned(level.size() / 2)) {
+      break;
+    }
+    mip = downsampleImage(level);
+    level = *mip;
+  }
+  return levels;
+}  // compressTextureImage
+
+std::string getCompressedTextureCacheFilename(const std::string& assetFilename,
+                                              Mn::UnsignedInt imageId) {
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  if (!assetSize) {
+    return {};
+  }
+  const std::string key = Cr::Utility::formatString(
+      "size={}-version={}", *assetSize, textureCacheVersion);
+  return Cr::Utility::formatString(
+      "{}.image{}-{}.ktx2", assetFilename, imageId,
+      Cr::Utility::MurmurHash2{}(key).hexString());
+}
+
+std::vector<Mn::Trade::ImageData2D> loadCompressedTextureFromCache(
+    const std::string& filename) {
+  std::vector<Mn::Trade::ImageData2D> levels;
+  if (!Cr::Utility::Path::exists(filename)) {
+    return levels;
+  }
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("KtxImporter");
+  if (!importer || !importer->openFile(filename) ||
+      importer->image2DCount() != 1) {
+    return levels;
+  }
+  const Mn::UnsignedInt levelCount = importer->image2DLevelCount(0);
+  levels.reserve(levelCount);
+  for (Mn::UnsignedInt i = 0; i != levelCount; ++i) {
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> level =
+        importer->image2D(0, i);
+    if (!level || !level->isCompressed()) {
+      levels.clear();
+      return levels;
+    }
+    levels.push_back(std::move(*level));
+  }
+  return levels;
+}  // loadCompressedTextureFromCache
+
+bool saveCompressedTextureToCache(
+    const std::vector<Mn::Trade::ImageData2D>& levels,
+    const std::string& filename) {
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter =
+      manager.loadAndInstantiate("KtxImageConverter");
+  if (!converter) {
+    return false;
+  }
+  std::vector<Mn::CompressedImageView2D> views;
+  views.reserve(levels.size());
+  for (const Mn::Trade::ImageData2D& level : levels) {
+    views.emplace_back(level);
+  }
+
+  // other processes may be loading the same asset, so only move the file in
+  // place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&views));
+  return converter->convertToFile(views, tmpFilename) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveCompressedTextureToCache
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,78 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_TEXTURECOMPRESSION_H_
+#define ESP_ASSETS_TEXTURECOMPRESSION_H_
+
+/** @file
+ * @brief Block compression of uncompressed texture images and its on-disk
+ * cache, see @ref esp::assets::compressTextureImage
+ */
+
+#include <string>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Trade/ImageData.h>
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Whether @p image can be compressed with @ref compressTextureImage()
+ *
+ * That's the case for 8-bit RGB and RGBA images, linear or sRGB, whose size
+ * is a multiple of the 4x4 block size.
+ */
+bool isCompressibleTextureImage(const Magnum::ImageView2D& image);
+
+/**
+ * @brief Compress an uncompressed texture image to BC1 (RGB) or BC3 (RGBA)
+ *
+ * Returns the full chain of compressed mip levels, down to the last level
+ * that's still a multiple of the block size, as compressed textures can't
+ * have their mips generated on the GPU. The mips are box-filtered on the CPU.
+ * Returns an empty vector if @p image isn't compressible, see
+ * @ref isCompressibleTextureImage(), or if the compressor plugin isn't
+ * available.
+ *
+ * Safe to call from multiple threads at once.
+ */
+std::vector<Magnum::Trade::ImageData2D> compressTextureImage(
+    const Magnum::ImageView2D& image);
+
+/**
+ * @brief Name of the file caching the compressed image @p imageId of
+ * @p assetFilename
+ *
+ * The cache is stored alongside the asset. The name depends on the size of
+ * the asset, so an edited asset isn't matched with textures compressed from
+ * the old one. Returns an empty string if the asset doesn't exist.
+ */
+std::string getCompressedTextureCacheFilename(const std::string& assetFilename,
+                                              Magnum::UnsignedInt imageId);
+
+/**
+ * @brief Load the mip levels saved by @ref saveCompressedTextureToCache()
+ *
+ * Returns an empty vector if the file doesn't exist or doesn't contain a
+ * compressed image.
+ */
+std::vector<Magnum::Trade::ImageData2D> loadCompressedTextureFromCache(
+    const std::string& filename);
+
+/**
+ * @brief Save compressed mip levels to a KTX2 cache file
+ *
+ * Returns @cpp false @ce if the file can't be written, e.g. because the asset
+ * directory is read-only.
+ */
+bool saveCompressedTextureToCache(
+    const std::vector<Magnum::Trade::ImageData2D>& levels,
+    const std::string& filename);
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_TEXTURECOMPRESSION_H_
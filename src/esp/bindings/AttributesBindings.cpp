@@ -446,6 +446,14 @@ void initAttributesBindings(py::module& m) {
           &ObjectAttributes::setJoinCollisionMeshes,
           R"(Whether collision meshes for objects constructed from this
           template should be joined into a convex hull or kept separate.)")
+      .def_property(
+          "convex_decomposition_max_hulls",
+          &ObjectAttributes::getConvexDecompositionMaxHulls,
+          &ObjectAttributes::setConvexDecompositionMaxHulls,
+          R"(If positive, the collision mesh of objects constructed from this
+          template is approximated by at most this many convex hulls, which
+          are cached alongside the collision asset. Takes precedence over
+          join_collision_meshes.)")
       .def_property(
           "is_visibile", &ObjectAttributes::getIsVisible,
           &ObjectAttributes::setIsVisible,
@@ -563,6 +571,14 @@ void initAttributesBindings(py::module& m) {
           R"(Sets the global direct lighting multiplier to control overall direct light
                 brightness. This is used to balance PBR and Phong lighting of the same scene.
                 Default value is 3.14)")
+      .def_property(
+          "clustered_lighting_min_lights",
+          &PbrShaderAttributes::getClusteredLightingMinLightCount,
+          &PbrShaderAttributes::setClusteredLightingMinLightCount,
+          R"(Number of direct lights from which on each fragment is only shaded with the
+                lights reaching its cluster of the view instead of with all lights. Point
+                lights then get a finite range derived from their intensity. Default value
+                is 0, which disables clustered lighting.)")
       .def_property(
           "skip_calc_missing_tbn", &PbrShaderAttributes::getSkipCalcMissingTBN,
           &PbrShaderAttributes::setSkipCalcMissingTBN,
@@ -711,10 +727,74 @@ void initAttributesBindings(py::module& m) {
       .def_property("timestep", &PhysicsManagerAttributes::getTimestep,
                     &PhysicsManagerAttributes::setTimestep,
                     R"(The timestep to use for forward simulation.)")
-      .def_property("max_substeps", &PhysicsManagerAttributes::getMaxSubsteps,
-                    &PhysicsManagerAttributes::setMaxSubsteps,
-                    R"(Maximum simulation steps between each rendering step.
-                    (Not currently implemented).)")
+      .def_property(
+          "max_substeps", &PhysicsManagerAttributes::getMaxSubsteps,
+          &PhysicsManagerAttributes::setMaxSubsteps,
+          R"(Maximum number of fixed substeps a single simulation step may take,
+          bounding its worst case duration. Time beyond the budget is dropped.
+          0 means unlimited.)")
+      .def_property(
+          "adaptive_timestep", &PhysicsManagerAttributes::getAdaptiveTimestep,
+          &PhysicsManagerAttributes::setAdaptiveTimestep,
+          R"(Whether calm scenes are simulated with substeps longer than the timestep,
+          up to adaptive_max_timestep. Falls back to the timestep with more than
+          adaptive_max_contacts active contact points or any awake articulated
+          object.)")
+      .def_property(
+          "adaptive_max_timestep",
+          &PhysicsManagerAttributes::getAdaptiveMaxTimestep,
+          &PhysicsManagerAttributes::setAdaptiveMaxTimestep,
+          R"(The longest substep the adaptive timestep may take.)")
+      .def_property(
+          "adaptive_max_contacts",
+          &PhysicsManagerAttributes::getAdaptiveMaxContacts,
+          &PhysicsManagerAttributes::setAdaptiveMaxContacts,
+          R"(Number of active contact points above which the adaptive timestep falls
+          back to the timestep.)")
+      .def_property(
+          "adaptive_max_travel",
+          &PhysicsManagerAttributes::getAdaptiveMaxTravel,
+          &PhysicsManagerAttributes::setAdaptiveMaxTravel,
+          R"(Distance any point of an active object may travel in one adaptive
+          substep.)")
+      .def_property(
+          "num_threads", &PhysicsManagerAttributes::getNumThreads,
+          &PhysicsManagerAttributes::setNumThreads,
+          R"(Number of threads used for collision detection during dynamic simulation.
+          1 steps the simulation on the calling thread only. Only supported by
+          Bullet built with multithreading, otherwise the simulation stays
+          single-threaded.)")
+      .def_property(
+          "deterministic", &PhysicsManagerAttributes::getDeterministic,
+          &PhysicsManagerAttributes::setDeterministic,
+          R"(Whether simulation results must not depend on the number of threads or
+          on thread scheduling. Contact constraints are then solved in a fixed
+          order, at the cost of sorting them every simulation step.)")
+      .def_property(
+          "broadphase", &PhysicsManagerAttributes::getBroadphase,
+          &PhysicsManagerAttributes::setBroadphase,
+          R"(The broadphase used to find potentially colliding pairs. Either "dbvt"
+          (dynamic AABB trees, default) or "sap" (sweep and prune over the
+          broadphase world bounds).)")
+      .def_property(
+          "broadphase_world_min",
+          &PhysicsManagerAttributes::getBroadphaseWorldMin,
+          &PhysicsManagerAttributes::setBroadphaseWorldMin,
+          R"(Minimum corner of the world bounds used by the "sap" broadphase.)")
+      .def_property(
+          "broadphase_world_max",
+          &PhysicsManagerAttributes::getBroadphaseWorldMax,
+          &PhysicsManagerAttributes::setBroadphaseWorldMax,
+          R"(Maximum corner of the world bounds used by the "sap" broadphase.)")
+      .def_property(
+          "collision_margin", &PhysicsManagerAttributes::getCollisionMargin,
+          &PhysicsManagerAttributes::setCollisionMargin,
+          R"(Collision margin of articulated object link shapes. Rigid objects and
+          stages use the margin of their own attributes.)")
+      .def_property(
+          "solver_iterations", &PhysicsManagerAttributes::getSolverIterations,
+          &PhysicsManagerAttributes::setSolverIterations,
+          R"(Number of constraint solver iterations per simulation step.)")
       .def_property(
           "gravity", &PhysicsManagerAttributes::getGravity,
           &PhysicsManagerAttributes::setGravity,
@@ -3,9 +3,17 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "esp/bindings/Bindings.h"
+
+#include <Corrade/Utility/FormatStl.h>
+
+#include "esp/core/Buffer.h"
+#include "esp/core/LatencyTracker.h"
+#include "esp/core/MemoryUsage.h"
+#include "esp/core/Profiler.h"
 #include "esp/core/Random.h"
 #include "esp/core/Utility.h"
 
+namespace Cr = Corrade;
 namespace py = pybind11;
 using py::literals::operator""_a;
 using esp::logging::LoggingContext;
@@ -13,6 +21,28 @@ using esp::logging::LoggingContext;
 namespace esp {
 namespace core {
 
+namespace {
+
+template <class T>
+py::buffer_info bufferInfo(Buffer& buffer) {
+  std::vector<py::ssize_t> shape(buffer.shape.begin(), buffer.shape.end());
+  std::vector<py::ssize_t> strides(shape.size());
+  py::ssize_t stride = sizeof(T);
+  for (std::size_t i = shape.size(); i != 0; --i) {
+    strides[i - 1] = stride;
+    stride *= shape[i - 1];
+  }
+  const auto ndim = py::ssize_t(shape.size());
+  return py::buffer_info{buffer.data.data(),
+                         sizeof(T),
+                         py::format_descriptor<T>::format(),
+                         ndim,
+                         std::move(shape),
+                         std::move(strides)};
+}
+
+}  // namespace
+
 void initCoreBindings(py::module& m) {
   // ==== struct RigidState ===
   py::class_<RigidState, RigidState::ptr>(m, "RigidState")
@@ -22,6 +52,39 @@ void initCoreBindings(py::module& m) {
       .def_readwrite("rotation", &RigidState::rotation)
       .def_readwrite("translation", &RigidState::translation);
 
+  // ==== Buffer ====
+  py::class_<Buffer, Buffer::ptr>(
+      m, "Buffer", py::buffer_protocol(),
+      R"(Native observation memory. numpy.asarray() views it without copying and keeps it alive.)")
+      .def_buffer([](Buffer& self) -> py::buffer_info {
+        switch (self.dataType) {
+          case DataType::DT_INT8:
+            return bufferInfo<std::int8_t>(self);
+          case DataType::DT_UINT8:
+            return bufferInfo<std::uint8_t>(self);
+          case DataType::DT_INT16:
+            return bufferInfo<std::int16_t>(self);
+          case DataType::DT_UINT16:
+            return bufferInfo<std::uint16_t>(self);
+          case DataType::DT_INT32:
+            return bufferInfo<std::int32_t>(self);
+          case DataType::DT_UINT32:
+            return bufferInfo<std::uint32_t>(self);
+          case DataType::DT_INT64:
+            return bufferInfo<std::int64_t>(self);
+          case DataType::DT_UINT64:
+            return bufferInfo<std::uint64_t>(self);
+          case DataType::DT_FLOAT:
+            return bufferInfo<float>(self);
+          case DataType::DT_DOUBLE:
+            return bufferInfo<double>(self);
+          default:
+            throw std::runtime_error("Buffer has no valid data type.");
+        }
+      })
+      .def_readonly("shape", &Buffer::shape)
+      .def_readonly("pinned", &Buffer::pinned);
+
   py::class_<Random, Random::ptr>(m, "Random")
       .def(py::init(&Random::create<>))
       .def("seed", &Random::seed)
@@ -49,6 +112,128 @@ void initCoreBindings(py::module& m) {
                logging::LoggingLevel::Debug;
       });
   core.attr("_logging_context") = new LoggingContext{};
+  core.def(
+      "set_async_logging", &logging::setAsyncLogging, "enabled"_a,
+      R"(Hand log messages below the error level to a background writer thread instead of writing them on the calling thread. Errors are always written right away, after everything queued before them.)");
+  core.def("is_async_logging", &logging::isAsyncLogging);
+  core.def("flush_async_logging", &logging::flushAsyncLogging,
+           R"(Wait until all log messages queued so far are written.)");
+
+  py::class_<MemoryUsage>(
+      core, "MemoryUsage",
+      R"(Estimated memory held by a subsystem, computed from the sizes of the data it keeps. Memory shared between subsystems is counted only by its owner.)")
+      .def_readonly("cpu_bytes", &MemoryUsage::cpuBytes)
+      .def_readonly("gpu_bytes", &MemoryUsage::gpuBytes)
+      .def("__repr__", [](const MemoryUsage& self) {
+        return Cr::Utility::formatString(
+            "MemoryUsage(cpu_bytes={}, gpu_bytes={})", self.cpuBytes,
+            self.gpuBytes);
+      });
+
+  // ==== Profiler ====
+  py::class_<ProfileStat>(core, "ProfileStat")
+      .def_readonly("name", &ProfileStat::name)
+      .def_readonly("call_count", &ProfileStat::callCount)
+      .def_readonly("total_ms", &ProfileStat::totalMs)
+      .def_readonly("max_ms", &ProfileStat::maxMs)
+      .def_readonly("depth", &ProfileStat::depth)
+      .def("__repr__", [](const ProfileStat& self) {
+        return Cr::Utility::formatString(
+            "ProfileStat(name={}, call_count={}, total_ms={:.3f}, "
+            "max_ms={:.3f})",
+            self.name, self.callCount, self.totalMs, self.maxMs);
+      });
+
+  py::class_<ProfileCounter>(core, "ProfileCounter")
+      .def_readonly("name", &ProfileCounter::name)
+      .def_readonly("value", &ProfileCounter::value)
+      .def("__repr__", [](const ProfileCounter& self) {
+        return Cr::Utility::formatString("ProfileCounter(name={}, value={})",
+                                         self.name, self.value);
+      });
+
+  py::class_<Profiler>(
+      core, "Profiler",
+      R"(Process-wide scoped-timer profiler instrumenting physics stepping, rendering, culling, replay recording, pathfinding and sensor readback. GPU passes are timed with non-blocking timer queries and reported under names prefixed with "GPU ", typically a frame or two late. Disabled by default.)")
+      .def_static(
+          "set_enabled",
+          [](bool enabled) { Profiler::instance().setEnabled(enabled); },
+          "enabled"_a, R"(Start or stop recording profiled scopes.)")
+      .def_static("is_enabled", &Profiler::isEnabled)
+      .def_static(
+          "clear", []() { Profiler::instance().clear(); },
+          R"(Drop all recorded events.)")
+      .def_static(
+          "mark_frame", []() { Profiler::instance().markFrame(); },
+          R"(Mark the end of a frame; get_frame_stats aggregates the events between the two most recent marks.)")
+      .def_static(
+          "get_frame_stats",
+          []() { return Profiler::instance().getFrameStats(); },
+          R"(Per-scope timings of the last complete frame, sorted by descending total time.)")
+      .def_static(
+          "get_stats", []() { return Profiler::instance().getStats(); },
+          R"(Per-scope timings of all recorded events, sorted by descending total time.)")
+      .def_static(
+          "get_frame_counters",
+          []() { return Profiler::instance().getFrameCounters(); },
+          R"(Counters of the last complete frame, such as GL state changes while drawing, sorted by name.)")
+      .def_static(
+          "get_chrome_trace",
+          []() { return Profiler::instance().getChromeTrace(); },
+          R"(Recorded events in the Chrome trace event JSON format.)")
+      .def_static(
+          "export_chrome_trace",
+          [](const std::string& filepath) {
+            return Profiler::instance().exportChromeTrace(filepath);
+          },
+          "filepath"_a,
+          R"(Write the recorded events as a Chrome trace JSON file, viewable in chrome://tracing or Perfetto.)");
+
+  // ==== LatencyTracker ====
+  py::class_<LatencyStats>(core, "LatencyStats")
+      .def_readonly("name", &LatencyStats::name)
+      .def_readonly("count", &LatencyStats::count)
+      .def_readonly("mean_ms", &LatencyStats::meanMs)
+      .def_readonly("p50_ms", &LatencyStats::p50Ms)
+      .def_readonly("p90_ms", &LatencyStats::p90Ms)
+      .def_readonly("p99_ms", &LatencyStats::p99Ms)
+      .def_readonly("p999_ms", &LatencyStats::p999Ms)
+      .def_readonly("max_ms", &LatencyStats::maxMs)
+      .def("__repr__", [](const LatencyStats& self) {
+        return Cr::Utility::formatString(
+            "LatencyStats(name={}, count={}, p50_ms={:.3f}, p99_ms={:.3f}, "
+            "max_ms={:.3f})",
+            self.name, self.count, self.p50Ms, self.p99Ms, self.maxMs);
+      });
+
+  py::class_<LatencyTracker>(
+      core, "LatencyTracker",
+      R"(Process-wide collector of per-call latency histograms of Simulator.step_world, Agent.act, Simulator.get_sensor_observations and Simulator.reconfigure, for watching tail latency. Disabled by default.)")
+      .def_static(
+          "set_enabled",
+          [](bool enabled) { LatencyTracker::instance().setEnabled(enabled); },
+          "enabled"_a)
+      .def_static("is_enabled", &LatencyTracker::isEnabled)
+      .def_static(
+          "clear", []() { LatencyTracker::instance().clear(); },
+          R"(Drop all recorded calls.)")
+      .def_static(
+          "set_dump_interval",
+          [](double seconds, const std::string& filepath) {
+            LatencyTracker::instance().setDumpInterval(seconds, filepath);
+          },
+          "seconds"_a, "filepath"_a = "",
+          R"(Periodically report the latency percentiles of each interval, appended to filepath as lines of JSON, or printed to the log if filepath is empty. An interval of 0 disables the reports.)")
+      .def_static(
+          "get_stats", []() { return LatencyTracker::instance().getStats(); },
+          R"(Latency percentiles of all calls recorded so far, sorted by name.)")
+      .def_static(
+          "get_percentile_ms",
+          [](const std::string& name, double percentile) {
+            return LatencyTracker::instance().getPercentileMs(name, percentile);
+          },
+          "name"_a, "percentile"_a,
+          R"(Latency of the call name below or at which percentile percent of the calls were, in milliseconds.)");
 
   core.def("orthonormalize_rotation_shear",
            &orthonormalizeRotationShear<float>);
@@ -6,8 +6,13 @@
 
 #include "esp/geo/Geo.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OccupancyGrid.h"
 
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
+#include <pybind11/numpy.h>
+
+#include <cstring>
+#include <stdexcept>
 
 namespace Mn = Magnum;
 namespace py = pybind11;
@@ -16,6 +21,27 @@ using py::literals::operator""_a;
 namespace esp {
 namespace geo {
 
+namespace {
+
+using FloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief View a contiguous [N, 3] float array as N vectors
+ */
+Corrade::Containers::ArrayView<const Mn::Vector3> vector3View(
+    const FloatArray& array,
+    const char* name) {
+  if (array.ndim() != 2 || array.shape(1) != 3) {
+    throw std::runtime_error(std::string{"Expected "} + name +
+                             " to be an array of shape [N, 3]");
+  }
+  return {reinterpret_cast<const Mn::Vector3*>(array.data()),
+          std::size_t(array.shape(0))};
+}
+
+}  // namespace
+
 void initGeoBindings(py::module& m) {
   auto geo = m.def_submodule("geo");
 
@@ -73,10 +99,111 @@ void initGeoBindings(py::module& m) {
   geo.def(
       "compute_gravity_aligned_MOBB", &geo::computeGravityAlignedMOBB,
       R"(Compute a minimum area OBB containing given points, and constrained to have -Z axis along given gravity orientation.)");
+  geo.def(
+      "compute_min_volume_OBB", &geo::computeMinVolumeOBB,
+      R"(Compute a tight, approximately minimum volume OBB containing given points in any orientation, starting from their principal axes.)");
   geo.def(
       "get_transformed_bb", &geo::getTransformedBB, "range"_a, "xform"_a,
       R"(Compute the axis-aligned bounding box which results from applying a transform to an existing bounding box.)");
 
+  // ==== OccupancyGrid ====
+  py::class_<OccupancyGrid, OccupancyGrid::ptr>(
+      m, "OccupancyGrid",
+      R"(Sparse voxel occupancy grid of triangle geometry. Geometry is added in sources identified by an integer id, which can be replaced or removed one by one, e.g. as objects move.)")
+      .def(py::init<float>(), "voxel_size"_a)
+      .def_property_readonly("voxel_size", &OccupancyGrid::voxelSize,
+                             R"(Edge length of a voxel.)")
+      .def_property_readonly("source_count", &OccupancyGrid::sourceCount,
+                             R"(Count of sources.)")
+      .def_property_readonly("occupied_voxel_count",
+                             &OccupancyGrid::occupiedVoxelCount,
+                             R"(Count of voxels occupied by any source.)")
+      .def_property_readonly("block_count", &OccupancyGrid::blockCount,
+                             R"(Count of allocated 8x8x8 voxel blocks.)")
+      .def(
+          "set_source",
+          [](OccupancyGrid& self, int sourceId, const FloatArray& positions,
+             const py::array_t<std::uint32_t, py::array::c_style |
+                                                  py::array::forcecast>&
+                 indices,
+             const Mn::Matrix4& transformation, int numThreads) {
+            const auto positionView = vector3View(positions, "positions");
+            py::gil_scoped_release release;
+            self.setSource(sourceId, positionView,
+                           {indices.data(), std::size_t(indices.size())},
+                           transformation, numThreads);
+          },
+          "source_id"_a, "positions"_a, "indices"_a,
+          "transformation"_a = Mn::Matrix4{}, "num_threads"_a = 0,
+          R"(Voxelize a triangle mesh, given as [N, 3] vertex positions and a flat array of triangle indices, as source source_id, replacing a previous source of the same id.)")
+      .def("remove_source", &OccupancyGrid::removeSource, "source_id"_a,
+           R"(Remove a source. Returns whether there was such source.)")
+      .def("has_source", &OccupancyGrid::hasSource, "source_id"_a,
+           R"(Whether there is a source of given id.)")
+      .def("source_ids", &OccupancyGrid::sourceIds,
+           R"(Ids of all sources, in no particular order.)")
+      .def(
+          "source_voxels",
+          [](const OccupancyGrid& self, int sourceId) {
+            const std::vector<Mn::Vector3i>& voxels =
+                self.sourceVoxels(sourceId);
+            py::array_t<int> out(
+                {py::ssize_t(voxels.size()), py::ssize_t(3)});
+            if (!voxels.empty()) {
+              std::memcpy(out.mutable_data(), voxels.data(),
+                          voxels.size() * sizeof(Mn::Vector3i));
+            }
+            return out;
+          },
+          "source_id"_a,
+          R"(Voxels occupied by a source as a sorted [N, 3] array of integer voxel coordinates.)")
+      .def("clear", &OccupancyGrid::clear, R"(Remove all sources.)")
+      .def("voxel_at", &OccupancyGrid::voxelAt, "point"_a,
+           R"(Integer coordinates of the voxel containing a point.)")
+      .def(
+          "is_occupied",
+          [](const OccupancyGrid& self, const FloatArray& points) {
+            const auto pointView = vector3View(points, "points");
+            py::array_t<bool> occupied(py::ssize_t(pointView.size()));
+            {
+              py::gil_scoped_release release;
+              self.isOccupied(pointView,
+                              {occupied.mutable_data(), pointView.size()});
+            }
+            return occupied;
+          },
+          "points"_a,
+          R"(Whether the voxels containing a batch of [N, 3] points are occupied.)")
+      .def(
+          "is_box_occupied",
+          [](const OccupancyGrid& self, const FloatArray& boxMins,
+             const FloatArray& boxMaxs) {
+            const auto minView = vector3View(boxMins, "box_mins");
+            const auto maxView = vector3View(boxMaxs, "box_maxs");
+            if (maxView.size() != minView.size()) {
+              throw std::runtime_error(
+                  "Expected box_mins and box_maxs to have the same shape");
+            }
+            py::array_t<bool> occupied(py::ssize_t(minView.size()));
+            {
+              py::gil_scoped_release release;
+              bool* out = occupied.mutable_data();
+              for (std::size_t i = 0; i != minView.size(); ++i) {
+                out[i] = self.isBoxOccupied({minView[i], maxView[i]});
+              }
+            }
+            return occupied;
+          },
+          "box_mins"_a, "box_maxs"_a,
+          R"(Whether any voxel overlapping each of a batch of axis-aligned boxes, given as [N, 3] min and max corners, is occupied.)")
+      .def("save_source", &OccupancyGrid::saveSource, "source_id"_a,
+           "filename"_a,
+           R"(Save the voxels of a source to a file. Returns whether the file was written.)")
+      .def(
+          "load_source", &OccupancyGrid::loadSource, "source_id"_a,
+          "filename"_a,
+          R"(Load the voxels of a source from a file written by save_source() with the same voxel size. Returns whether the file was read.)");
+
   // ==== Ray ====
   py::class_<Ray>(m, "Ray")
       .def(py::init<Magnum::Vector3, Magnum::Vector3>(), "origin"_a,
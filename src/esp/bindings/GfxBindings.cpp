@@ -14,6 +14,7 @@
 #include "esp/assets/ResourceManager.h"
 #include "esp/bindings/EnumOperators.h"
 #include "esp/gfx/DebugLineRender.h"
+#include "esp/gfx/TrajectoryRender.h"
 #include "esp/gfx/LightSetup.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
@@ -53,6 +54,10 @@ void initGfxBindings(py::module& m) {
 
   flags.value("FRUSTUM_CULLING", RenderCamera::Flag::FrustumCulling)
       .value("OBJECTS_ONLY", RenderCamera::Flag::ObjectsOnly)
+      .value("INSTANCING", RenderCamera::Flag::Instancing)
+      .value("LEVEL_OF_DETAIL", RenderCamera::Flag::LevelOfDetail)
+      .value("DEPTH_ONLY", RenderCamera::Flag::DepthOnly)
+      .value("OBJECT_ID_ONLY", RenderCamera::Flag::ObjectIdOnly)
       .value("NONE", RenderCamera::Flag{});
   pybindEnumOperators(flags);
 
@@ -94,13 +99,14 @@ void initGfxBindings(py::module& m) {
             self.draw(camera, sceneGraph, RenderCamera::Flags{flags});
           },
           R"(Draw given scene using the camera)", "camera"_a, "scene"_a,
-          "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
+          "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling},
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "draw",
           [](Renderer& self, sensor::VisualSensor& visualSensor,
              sim::Simulator& sim) { self.draw(visualSensor, sim); },
           R"(Draw the active scene in current simulator using the visual sensor)",
-          "visualSensor"_a, "sim"_a)
+          "visualSensor"_a, "sim"_a, py::call_guard<py::gil_scoped_release>())
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
       .def(
           "enqueue_async_draw_job",
@@ -114,10 +120,15 @@ void initGfxBindings(py::module& m) {
           "visualSensor"_a, "scene"_a, "view"_a,
           "flags"_a = RenderCamera::Flag{RenderCamera::Flag::FrustumCulling})
       .def("wait_draw_jobs", &Renderer::waitDrawJobs,
+           py::call_guard<py::gil_scoped_release>(),
            R"(See tutorials/async_rendering.py)")
       .def("start_draw_jobs", &Renderer::startDrawJobs,
            R"(See tutorials/async_rendering.py)")
 #endif
+      .def(
+          "wait_scene_graph", &Renderer::waitSceneGraph,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Wait until async draw jobs no longer read the scene graph, which is only while skinned drawables are drawn. This is a noop if the main-thread already owns the scene graph.)")
       .def(
           "acquire_gl_context", &Renderer::acquireGlContext,
           R"(See tutorials/async_rendering.py. This is a noop if the main-thread already has the context.)")
@@ -128,7 +139,36 @@ void initGfxBindings(py::module& m) {
             self.bindRenderTarget(visualSensor, Renderer::Flags{flags});
           },
           R"(Binds a RenderTarget to the sensor)", "visualSensor"_a,
-          "flags"_a = Renderer::Flag{});
+          "flags"_a = Renderer::Flag{})
+      .def(
+          "bind_fused_render_target", &Renderer::bindFusedRenderTarget,
+          R"(Binds one RenderTarget with color, depth and object id attachments to a group of sensors sharing resolution, projection and pose, so draw_fused() can render all their observations in one pass. A group of fisheye and equirectangular sensors sharing pose and near and far planes shares one cubemap instead, each sensor keeping its own RenderTarget.)",
+          "visual_sensors"_a)
+      .def(
+          "bind_tiled_render_target",
+          [](Renderer& self,
+             const std::vector<sensor::VisualSensor*>& visualSensors) {
+            return self.bindTiledRenderTarget(visualSensors).get();
+          },
+          R"(Binds tiles of one large RenderTarget to a group of camera sensors of the same type and resolution, possibly of different simulators sharing the GL context. Each sensor draws and reads its observation as usual, and the returned RenderTarget reads all of them back with a single transfer. It's kept alive by the sensors.)",
+          "visual_sensors"_a, py::return_value_policy::reference)
+      .def(
+          "set_redwood_depth_noise",
+          [](Renderer& self, sensor::VisualSensor& visualSensor,
+             const Eigen::Ref<const Eigen::RowMatrixXf>& model,
+             float noiseMultiplier, unsigned int seed) {
+            self.setRedwoodDepthNoise(
+                visualSensor, {model.data(), std::size_t(model.size())},
+                noiseMultiplier, seed);
+          },
+          R"(Apply the Redwood depth noise model to a depth sensor directly in its render target, on the GPU while the depth is unprojected. The model is the 80 x 400 distortion model of the RedwoodDepthNoiseModel.)",
+          "visual_sensor"_a, "model"_a, "noise_multiplier"_a = 1.0f,
+          "seed"_a = 0)
+      .def(
+          "draw_fused", &Renderer::drawFused,
+          R"(Draw the active scene in current simulator once for a group of sensors bound with bind_fused_render_target(). A group of cubemap sensors renders the shared cubemap once and draws the observation of each sensor from it.)",
+          "visual_sensors"_a, "sim"_a,
+          py::call_guard<py::gil_scoped_release>());
 
   py::class_<RenderTarget>(m, "RenderTarget")
       .def("__enter__",
@@ -139,11 +179,23 @@ void initGfxBindings(py::module& m) {
       .def("__exit__",
            [](RenderTarget& self, const py::object&, const py::object&,
               const py::object&) { self.renderExit(); })
-      .def("read_frame_rgba", &RenderTarget::readFrameRgba,
-           "Reads RGBA frame into passed img in uint8 byte format.")
-      .def("read_frame_depth", &RenderTarget::readFrameDepth)
-      .def("read_frame_object_id", &RenderTarget::readFrameObjectId)
+      .def("read_frame_rgba",
+           py::overload_cast<const Mn::MutableImageView2D&>(
+               &RenderTarget::readFrameRgba),
+           "Reads RGBA frame into passed img in uint8 byte format.",
+           py::call_guard<py::gil_scoped_release>())
+      .def("read_frame_depth",
+           py::overload_cast<const Mn::MutableImageView2D&>(
+               &RenderTarget::readFrameDepth),
+           py::call_guard<py::gil_scoped_release>())
+      .def("read_frame_object_id",
+           py::overload_cast<const Mn::MutableImageView2D&>(
+               &RenderTarget::readFrameObjectId),
+           py::call_guard<py::gil_scoped_release>())
       .def("blit_rgba_to_default", &RenderTarget::blitRgbaToDefault)
+      .def_property_readonly(
+          "viewport", &RenderTarget::viewport,
+          R"(The area of the framebuffer rendered into, its whole size unless this is a tile of another render target)")
 #ifdef ESP_BUILD_WITH_CUDA
       .def("read_frame_rgba_gpu",
            [](RenderTarget& self, size_t devPtr) {
@@ -243,6 +295,28 @@ void initGfxBindings(py::module& m) {
           "normal"_a = Magnum::Vector3{0.0, 1.0, 0.0},
           R"(Draw a sequence of line segments with circles at the two endpoints. In world-space or local-space (see pushTransform).)");
 
+  py::class_<TrajectoryRender, std::shared_ptr<TrajectoryRender>>(
+      m, "TrajectoryRender",
+      R"(Draws trajectories as tubes into color sensors, without creating an object and render asset for each.)")
+      .def("add_trajectory", &TrajectoryRender::addTrajectory, "points"_a,
+           "color"_a = Mn::Color4{0.9f, 0.1f, 0.1f, 1.0f}, "radius"_a = 0.01f,
+           R"(Add a trajectory through the given points and return its ID.)")
+      .def("append_points",
+           py::overload_cast<int, const std::vector<Mn::Vector3>&>(
+               &TrajectoryRender::appendPoints),
+           "trajectory_id"_a, "points"_a,
+           R"(Append points to the end of a trajectory. Only the new segments are uploaded to the GPU.)")
+      .def("remove_trajectory", &TrajectoryRender::removeTrajectory,
+           "trajectory_id"_a, R"(Remove a trajectory.)")
+      .def("has_trajectory", &TrajectoryRender::hasTrajectory,
+           "trajectory_id"_a, R"(Whether a trajectory with the ID exists.)")
+      .def("clear", &TrajectoryRender::clear, R"(Remove all trajectories.)")
+      .def_property_readonly("num_trajectories",
+                             &TrajectoryRender::trajectoryCount,
+                             R"(Number of trajectories.)")
+      .def_property_readonly("num_segments", &TrajectoryRender::segmentCount,
+                             R"(Number of segments of all trajectories.)");
+
   m.attr("DEFAULT_LIGHTING_KEY") = DEFAULT_LIGHTING_KEY;
   m.attr("NO_LIGHT_KEY") = NO_LIGHT_KEY;
 }
@@ -7,8 +7,10 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/ReplayManager.h"
+#include "esp/scene/SceneNode.h"
 
 namespace py = pybind11;
 using py::literals::operator""_a;
@@ -45,6 +47,35 @@ void initGfxReplayBindings(py::module& m) {
           "close", &Player::close,
           R"(Unload all keyframes. The Player is unusable after it is closed.)");
 
+  py::class_<KeyframeRingBuffer>(m, "KeyframeRingBuffer")
+      .def_static(
+          "create", &KeyframeRingBuffer::create, "name"_a, "capacity"_a,
+          R"(Create a named shared-memory ring buffer for passing keyframes between processes, with capacity in bytes. The memory is released when this object is destroyed. Returns None on failure.)")
+      .def_static(
+          "open", &KeyframeRingBuffer::open, "name"_a,
+          R"(Attach to a ring buffer created by KeyframeRingBuffer.create in another process. Returns None on failure.)")
+      .def_property_readonly("capacity", &KeyframeRingBuffer::capacity,
+                             R"(Size of the message area in bytes.)")
+      .def_property_readonly(
+          "max_message_size", &KeyframeRingBuffer::maxMessageSize,
+          R"(Size of the largest keyframe the buffer accepts, in bytes.)")
+      .def("is_empty", &KeyframeRingBuffer::isEmpty,
+           R"(Whether there are no unconsumed keyframes.)");
+
+  py::class_<StateUpdateFilter>(
+      m, "StateUpdateFilter",
+      R"(Filtering of recorded instance state updates, see ReplayManager.set_state_update_filter.)")
+      .def(py::init<>())
+      .def_readwrite(
+          "min_translation", &StateUpdateFilter::minTranslation,
+          R"(Translation change in meters below which an update is dropped, if the rotation change is below min_rotation as well.)")
+      .def_readwrite(
+          "min_rotation", &StateUpdateFilter::minRotation,
+          R"(Rotation change in radians below which an update is dropped.)")
+      .def_readwrite(
+          "min_keyframe_interval", &StateUpdateFilter::minKeyframeInterval,
+          R"(Minimum number of saved keyframes between two updates of an instance. The latest state is recorded once the interval passed.)");
+
   py::class_<ReplayManager, ReplayManager::ptr>(m, "ReplayManager")
       .def(
           "save_keyframe",
@@ -98,6 +129,45 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to a file, then discard the keyframes.)")
 
+      .def(
+          "write_saved_keyframes_to_binary_file",
+          [](ReplayManager& self, const std::string& filepath) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->writeSavedKeyframesToBinaryFile(filepath);
+          },
+          R"(Write all saved keyframes to a file in the compact binary format, then discard the keyframes. The file can be read with read_keyframes_from_file.)")
+
+      .def(
+          "start_streaming_keyframes_to_file",
+          [](ReplayManager& self, const std::string& filepath,
+             int checkpointInterval) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->startStreamingKeyframesToFile(
+                filepath, checkpointInterval);
+          },
+          "filepath"_a, "checkpoint_interval"_a = 0,
+          R"(Write each keyframe to a file as soon as it's saved instead of keeping it in memory. With a positive checkpoint_interval, a new standalone file is started after that many keyframes. See Recorder.h for details.)")
+
+      .def(
+          "stop_streaming_keyframes",
+          [](ReplayManager& self) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->stopStreamingKeyframes();
+          },
+          R"(Finish the file started with start_streaming_keyframes_to_file.)")
+
       .def(
           "write_saved_keyframes_to_string",
           [](ReplayManager& self) {
@@ -123,6 +193,19 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to individual strings. See Recorder.h for details.)")
 
+      .def(
+          "write_incremental_saved_keyframes_to_ring_buffer",
+          [](ReplayManager& self, KeyframeRingBuffer& buffer) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            return self.getRecorder()
+                ->writeIncrementalSavedKeyframesToRingBuffer(buffer);
+          },
+          R"(Publish saved keyframes to a KeyframeRingBuffer in the binary format. Keyframes that don't fit are kept for the next call. Returns the number of keyframes published. See Recorder.h for details.)")
+
       .def("read_keyframes_from_file", &ReplayManager::readKeyframesFromFile,
            R"(Create a Player object from a replay file.)")
 
@@ -148,7 +231,59 @@ void initGfxReplayBindings(py::module& m) {
             }
             return self.getRecorder()->getMaxDecimalPlaces();
           },
-          R"(Get the precision of the floating points serialized by this recorder.)");
+          R"(Get the precision of the floating points serialized by this recorder.)")
+
+      .def(
+          "set_state_update_filter",
+          [](ReplayManager& self, const StateUpdateFilter& filter) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "Replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->setStateUpdateFilter(filter);
+          },
+          R"(Set the filter for state updates of all instances that don't have their own filter set with set_instance_state_update_filter.)")
+
+      .def(
+          "set_instance_state_update_filter",
+          [](ReplayManager& self, const scene::SceneNode& node,
+             const StateUpdateFilter& filter) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "Replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->setInstanceStateUpdateFilter(&node, filter);
+          },
+          "node"_a, "filter"_a,
+          R"(Set the filter for state updates of the render asset instance with the given root node.)")
+
+      .def(
+          "set_region_of_interest",
+          [](ReplayManager& self, const Magnum::Vector3& center,
+             float radius) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "Replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->setRegionOfInterest(center, radius);
+          },
+          "center"_a, "radius"_a,
+          R"(Postpone state updates of instances farther than radius from center, usually the camera of a remote viewer. Call before each save_keyframe to follow the camera.)")
+
+      .def(
+          "clear_region_of_interest",
+          [](ReplayManager& self) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "Replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->clearRegionOfInterest();
+          },
+          R"(Record state updates of all instances regardless of where they are.)");
 }
 
 }  // namespace replay
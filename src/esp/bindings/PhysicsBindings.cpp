@@ -190,6 +190,45 @@ void initPhysicsBindings(py::module& m) {
           "is_active", &ContactPointData::isActive,
           R"(Whether or not the contact is between active objects. Deactivated objects may produce contact points but no reaction.)");
 
+  // ==== enum object ContactEventType ====
+  py::enum_<ContactEventType>(m, "ContactEventType")
+      .value("BEGIN", ContactEventType::Begin)
+      .value("PERSIST", ContactEventType::Persist)
+      .value("END", ContactEventType::End);
+
+  // ==== struct object ContactEvent ====
+  py::class_<ContactEvent, ContactEvent::ptr>(m, "ContactEvent")
+      .def(py::init(&ContactEvent::create<>))
+      .def_readonly("type", &ContactEvent::type,
+                    R"(Whether the contact began, persisted or ended.)")
+      .def_readonly(
+          "object_id_a", &ContactEvent::objectIdA,
+          R"(The Habitat object id of the side with the lower id.)")
+      .def_readonly(
+          "link_id_a", &ContactEvent::linkIndexA,
+          R"(The Habitat link id of the first side if an articulated link. -1 can indicate base link.)")
+      .def_readonly("object_id_b", &ContactEvent::objectIdB,
+                    R"(The Habitat object id of the other side.)")
+      .def_readonly(
+          "link_id_b", &ContactEvent::linkIndexB,
+          R"(The Habitat link id of the second side if an articulated link. -1 can indicate base link.)")
+      .def_readonly(
+          "num_contact_points", &ContactEvent::numContactPoints,
+          R"(Number of contact points between the two sides, 0 for ended contacts.)");
+
+  // ==== struct object ContactPointFilter ====
+  py::class_<ContactPointFilter, ContactPointFilter::ptr>(m,
+                                                          "ContactPointFilter")
+      .def(py::init(&ContactPointFilter::create<>))
+      .def_readwrite(
+          "object_pairs", &ContactPointFilter::objectPairs,
+          R"(Pairs of object ids to report contacts between, in either order. An id of -1 matches any object. Empty to not filter by object pairs.)")
+      .def_readwrite(
+          "links", &ContactPointFilter::links,
+          R"(Pairs of object id and link id to report contacts of. Rigid objects, the stage and articulated object bases have a link id of -1. Empty to not filter by links.)")
+      .def_readwrite("active_only", &ContactPointFilter::activeOnly,
+                     R"(Whether to skip contacts between sleeping objects.)");
+
   // ==== enum object CollisionGroup ====
   py::enum_<CollisionGroup> collisionGroups{m, "CollisionGroups",
                                             "CollisionGroups"};
@@ -249,6 +288,18 @@ void initPhysicsBindings(py::module& m) {
           &CollisionGroupHelper::setGroupInteractsWith, "group_a"_a,
           "group_b"_a, "interact"_a,
           R"(Set groupA's collision mask to a specific interaction state with respect to groupB.)")
+      .def_static(
+          "groups_interact", &CollisionGroupHelper::groupsInteract,
+          "group_a"_a, "group_b"_a,
+          R"(Check whether objects of groupA and groupB collide with each other under both groups' masks.)")
+      .def_static(
+          "get_interacting_groups",
+          [](CollisionGroup group) {
+            return CollisionGroup(
+                uint32_t(CollisionGroupHelper::getInteractingGroups(group)));
+          },
+          "group"_a,
+          R"(Get all groups which collide with a collision group under both groups' masks. Objects of a group for which this is empty never generate collision pairs.)")
       .def_static("get_all_group_names",
                   &CollisionGroupHelper::getAllGroupNames,
                   R"(Get a list of all configured collision group names.)");
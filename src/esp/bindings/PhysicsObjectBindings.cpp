@@ -3,6 +3,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "esp/bindings/Bindings.h"
+
+#include <pybind11/numpy.h>
+
 #include "esp/physics/PhysicsObjectBase.h"
 #include "esp/physics/RigidBase.h"
 #include "esp/physics/RigidObject.h"
@@ -601,7 +604,11 @@ void initPhysicsObjectBindings(py::module& m) {
       .def_property_readonly(
           "collision_shape_aabb",
           &ManagedBulletRigidObject::getCollisionShapeAabb,
-          R"(REQUIRES BULLET TO BE INSTALLED. The bounds of the axis-aligned bounding box from Bullet Physics, in its local coordinate frame.)");
+          R"(REQUIRES BULLET TO BE INSTALLED. The bounds of the axis-aligned bounding box from Bullet Physics, in its local coordinate frame.)")
+      .def(
+          "contact_test_transforms",
+          &ManagedBulletRigidObject::contactTestTransforms, "transforms"_a,
+          R"(REQUIRES BULLET TO BE INSTALLED. Returns the result of a discrete collision test between this object and the world for each of the given object transformations, without moving the object or changing the simulation state.)");
 
   // create bindings for ArticulatedObjects
   // physics object base instance for articulated object
@@ -618,7 +625,67 @@ void initPhysicsObjectBindings(py::module& m) {
       m, "ManagedBulletArticulatedObject")
       .def(
           "contact_test", &ManagedBulletArticulatedObject::contactTest,
-          R"(REQUIRES BULLET TO BE INSTALLED. Returns the result of a discrete collision test between this object and the world.)");
+          R"(REQUIRES BULLET TO BE INSTALLED. Returns the result of a discrete collision test between this object and the world.)")
+      .def(
+          "contact_test_joint_positions",
+          &ManagedBulletArticulatedObject::contactTestJointPositions,
+          "positions"_a,
+          R"(REQUIRES BULLET TO BE INSTALLED. Returns the result of a discrete collision test between this object and the world for each joint configuration in a flat list of blocks the size of joint_positions, without changing the object or the simulation state. Self-collisions are not reported.)")
+      .def(
+          "compute_link_transformations",
+          [](ManagedBulletArticulatedObject& self,
+             const py::array_t<float, py::array::c_style |
+                                          py::array::forcecast>& positions,
+             int numThreads) {
+            const int numPositions = self.getNumJointPositions();
+            const py::ssize_t numConfigurations =
+                numPositions ? positions.size() / numPositions : 0;
+            const py::ssize_t numTransformations = self.getNumLinks() + 1;
+            // column-major strides like Magnum::Matrix4, so the matrices are
+            // written into the array directly
+            py::array_t<float> transformations(
+                {numConfigurations, numTransformations, py::ssize_t(4),
+                 py::ssize_t(4)},
+                {py::ssize_t(numTransformations * sizeof(Mn::Matrix4)),
+                 py::ssize_t(sizeof(Mn::Matrix4)), py::ssize_t(sizeof(float)),
+                 py::ssize_t(4 * sizeof(float))});
+            Mn::Matrix4* out =
+                reinterpret_cast<Mn::Matrix4*>(transformations.mutable_data());
+            {
+              py::gil_scoped_release release;
+              self.computeLinkTransformations(
+                  {positions.data(), std::size_t(positions.size())},
+                  {out, std::size_t(numConfigurations * numTransformations)},
+                  numThreads);
+            }
+            return transformations;
+          },
+          "positions"_a, "num_threads"_a = 0,
+          R"(REQUIRES BULLET TO BE INSTALLED. Compute the world transformations of the base and all links for a batch of joint configurations, given as an array of blocks the size of joint_positions, without changing the object or the simulation state. Returns a float32 array of shape (N, num_links + 1, 4, 4) with the base first and the links ordered by link id. Configurations are split across num_threads threads, one per core if 0.)")
+      .def(
+          "compute_link_jacobians",
+          [](ManagedBulletArticulatedObject& self, int linkId,
+             const py::array_t<float, py::array::c_style |
+                                          py::array::forcecast>& positions,
+             int numThreads) {
+            const int numPositions = self.getNumJointPositions();
+            const py::ssize_t numConfigurations =
+                numPositions ? positions.size() / numPositions : 0;
+            const py::ssize_t numDofs = self.getNumDofs();
+            py::array_t<float> jacobians(
+                {numConfigurations, py::ssize_t(6), numDofs});
+            float* out = jacobians.mutable_data();
+            {
+              py::gil_scoped_release release;
+              self.computeLinkJacobians(
+                  linkId, {positions.data(), std::size_t(positions.size())},
+                  {out, std::size_t(numConfigurations * 6 * numDofs)},
+                  numThreads);
+            }
+            return jacobians;
+          },
+          "link_id"_a, "positions"_a, "num_threads"_a = 0,
+          R"(REQUIRES BULLET TO BE INSTALLED. Compute the Jacobian of a link for a batch of joint configurations, given as for compute_link_transformations, without changing the object or the simulation state. Returns a float32 array of shape (N, 6, num_dofs) mapping joint velocities to the world space linear velocity of the link origin in the first three rows and the angular velocity of the link in the last three, with the base held fixed.)");
 
 }  // initPhysicsObjectBindings
 
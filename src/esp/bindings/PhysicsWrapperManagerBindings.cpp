@@ -4,6 +4,8 @@
 
 #include "esp/bindings/Bindings.h"
 
+#include <pybind11/numpy.h>
+
 #include "esp/physics/bullet/objectWrappers/ManagedBulletArticulatedObject.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
@@ -13,6 +15,7 @@
 #include "esp/physics/objectWrappers/ManagedRigidObject.h"
 
 namespace py = pybind11;
+namespace Mn = Magnum;
 using py::literals::operator""_a;
 
 namespace PhysWraps = esp::physics;
@@ -26,6 +29,95 @@ using PhysWraps::RigidObjectManager;
 
 namespace esp {
 namespace physics {
+
+namespace {
+
+using IntArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+using FloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+Corrade::Containers::ArrayView<const int> intView(const IntArray& array) {
+  return {array.data(), std::size_t(array.size())};
+}
+
+Corrade::Containers::ArrayView<const float> floatView(
+    const FloatArray& array) {
+  return {array.data(), std::size_t(array.size())};
+}
+
+/**
+ * @brief Return @p out as the array joint state is gathered into, or a new
+ * array of @p size values if @p out is None. @p out is written to in place,
+ * so it has to be a contiguous float32 array of exactly @p size values.
+ */
+py::array_t<float> jointStateOutput(const py::object& out, int size) {
+  if (out.is_none()) {
+    return py::array_t<float>(py::ssize_t(size));
+  }
+  if (!py::isinstance<py::array>(out)) {
+    throw std::runtime_error("Expected out to be a numpy array");
+  }
+  auto array = py::reinterpret_borrow<py::array>(out);
+  if (!array.dtype().is(py::dtype::of<float>()) ||
+      !(array.flags() & py::array::c_style) || !array.writeable() ||
+      array.size() != size) {
+    throw std::runtime_error(
+        "Expected out to be a writeable contiguous float32 array of " +
+        std::to_string(size) + " values");
+  }
+  return py::reinterpret_borrow<py::array_t<float>>(out);
+}
+
+/**
+ * @brief Gather the transformations of the objects with the given
+ * @p objectIds into a new float32 array of shape (N, 4, 4) indexed by row and
+ * column. Its strides are column-major like @ref Magnum::Matrix4, so the
+ * matrices are written into it directly.
+ */
+template <class MgrClass>
+py::array_t<float> gatherTransformations(const MgrClass& self,
+                                         const IntArray& objectIds) {
+  const auto ids = intView(objectIds);
+  py::array_t<float> transformations(
+      {py::ssize_t(ids.size()), py::ssize_t(4), py::ssize_t(4)},
+      {py::ssize_t(sizeof(Mn::Matrix4)), py::ssize_t(sizeof(float)),
+       py::ssize_t(4 * sizeof(float))});
+  self.getTransformations(
+      ids, {reinterpret_cast<Mn::Matrix4*>(transformations.mutable_data()),
+            ids.size()});
+  return transformations;
+}
+
+/**
+ * @brief Gather one vector per object with @p getter into a new float32
+ * array of shape (N, 3)
+ */
+template <class MgrClass>
+py::array_t<float> gatherVectors(
+    const MgrClass& self,
+    const IntArray& objectIds,
+    void (MgrClass::*getter)(Corrade::Containers::ArrayView<const int>,
+                             Corrade::Containers::ArrayView<Mn::Vector3>)
+        const) {
+  const auto ids = intView(objectIds);
+  py::array_t<float> vectors({py::ssize_t(ids.size()), py::ssize_t(3)});
+  (self.*getter)(ids,
+                 {reinterpret_cast<Mn::Vector3*>(vectors.mutable_data()),
+                  ids.size()});
+  return vectors;
+}
+
+template <class MgrClass>
+std::vector<MotionType> gatherMotionTypes(const MgrClass& self,
+                                          const IntArray& objectIds) {
+  const auto ids = intView(objectIds);
+  std::vector<MotionType> motionTypes(ids.size());
+  self.getMotionTypes(ids, {motionTypes.data(), motionTypes.size()});
+  return motionTypes;
+}
+
+}  // namespace
+
 /**
  * @brief instance class template base classes for object wrapper managers.
  * @tparam The type used to specialize class template for each object wrapper
@@ -230,6 +322,7 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
 #endif
           "object_lib_id"_a, "attachment_node"_a = nullptr,
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Instance an object into the scene via a template referenced by library id.
           Optionally attach the object to an existing SceneNode and assign its initial
           LightSetup key. Returns a reference to the created object.)")
@@ -242,6 +335,7 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
 #endif
           "object_lib_handle"_a, "attachment_node"_a = nullptr,
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Instance an object into the scene via a template referenced by its handle.
           Optionally attach the object to an existing SceneNode and assign its initial
           LightSetup key. Returns a reference to the created object.)")
@@ -256,7 +350,29 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
           &RigidObjectManager::removePhysObjectByHandle, "handle"_a,
           "delete_object_node"_a = true, "delete_visual_node"_a = true,
           R"(This removes the RigidObject referenced by the passed handle from the library, while allowing "
-          "for the optional retention of the object's scene node and/or the visual node)");
+          "for the optional retention of the object's scene node and/or the visual node)")
+      .def("get_transformations",
+           &gatherTransformations<RigidObjectManager>, "object_ids"_a,
+           R"(Get the transformations of the rigid objects with the given ids as one float32 array of shape (N, 4, 4), without going through a wrapper per object.)")
+      .def(
+          "get_linear_velocities",
+          [](const RigidObjectManager& self, const IntArray& objectIds) {
+            return gatherVectors(self, objectIds,
+                                 &RigidObjectManager::getLinearVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the linear velocities of the rigid objects with the given ids as one float32 array of shape (N, 3).)")
+      .def(
+          "get_angular_velocities",
+          [](const RigidObjectManager& self, const IntArray& objectIds) {
+            return gatherVectors(self, objectIds,
+                                 &RigidObjectManager::getAngularVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the angular velocities of the rigid objects with the given ids as one float32 array of shape (N, 3).)")
+      .def("get_motion_types", &gatherMotionTypes<RigidObjectManager>,
+           "object_ids"_a,
+           R"(Get the motion types of the rigid objects with the given ids as a list.)");
 
   // initialize bindings for articulated objects
 
@@ -276,6 +392,115 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
              std::shared_ptr<ArticulatedObjectManager>>(
       m, "ArticulatedObjectManager")
 
+      .def(
+          "get_num_dofs",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds) {
+            return self.getNumDofs(intView(objectIds));
+          },
+          "object_ids"_a,
+          R"(Get the total number of joint degrees of freedom of the articulated objects with the given ids, the size of their batched joint velocities and forces.)")
+      .def(
+          "get_num_joint_positions",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds) {
+            return self.getNumJointPositions(intView(objectIds));
+          },
+          "object_ids"_a,
+          R"(Get the total number of joint position variables of the articulated objects with the given ids, the size of their batched joint positions.)")
+      .def(
+          "get_joint_positions",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const py::object& out) {
+            const auto ids = intView(objectIds);
+            py::array_t<float> positions =
+                jointStateOutput(out, self.getNumJointPositions(ids));
+            self.getJointPositions(
+                ids, {positions.mutable_data(), std::size_t(positions.size())});
+            return positions;
+          },
+          "object_ids"_a, "out"_a = py::none(),
+          R"(Gather the joint positions of the articulated objects with the given ids into one float32 array, each object's positions following the previous object's. If out is given, the positions are written into it in place and it is returned, otherwise a new array is returned.)")
+      .def(
+          "set_joint_positions",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const FloatArray& positions) {
+            self.setJointPositions(intView(objectIds), floatView(positions));
+          },
+          "object_ids"_a, "positions"_a,
+          R"(Set the joint positions of the articulated objects with the given ids from one array laid out as returned by get_joint_positions. A contiguous float32 array is read without copying.)")
+      .def(
+          "get_joint_velocities",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const py::object& out) {
+            const auto ids = intView(objectIds);
+            py::array_t<float> vels =
+                jointStateOutput(out, self.getNumDofs(ids));
+            self.getJointVelocities(
+                ids, {vels.mutable_data(), std::size_t(vels.size())});
+            return vels;
+          },
+          "object_ids"_a, "out"_a = py::none(),
+          R"(Gather the joint velocities of the articulated objects with the given ids into one float32 array, written into out in place if given.)")
+      .def(
+          "set_joint_velocities",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const FloatArray& vels) {
+            self.setJointVelocities(intView(objectIds), floatView(vels));
+          },
+          "object_ids"_a, "velocities"_a,
+          R"(Set the joint velocities of the articulated objects with the given ids from one array laid out as returned by get_joint_velocities.)")
+      .def(
+          "get_joint_forces",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const py::object& out) {
+            const auto ids = intView(objectIds);
+            py::array_t<float> forces =
+                jointStateOutput(out, self.getNumDofs(ids));
+            self.getJointForces(
+                ids, {forces.mutable_data(), std::size_t(forces.size())});
+            return forces;
+          },
+          "object_ids"_a, "out"_a = py::none(),
+          R"(Gather the joint forces/torques of the articulated objects with the given ids into one float32 array, written into out in place if given.)")
+      .def(
+          "set_joint_forces",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const FloatArray& forces) {
+            self.setJointForces(intView(objectIds), floatView(forces));
+          },
+          "object_ids"_a, "forces"_a,
+          R"(Set the joint forces/torques of the articulated objects with the given ids from one array laid out as returned by get_joint_forces.)")
+      .def(
+          "add_joint_forces",
+          [](ArticulatedObjectManager& self, const IntArray& objectIds,
+             const FloatArray& forces) {
+            self.addJointForces(intView(objectIds), floatView(forces));
+          },
+          "object_ids"_a, "forces"_a,
+          R"(Add one array of joint forces/torques, laid out as returned by get_joint_forces, to the articulated objects with the given ids.)")
+      .def("get_transformations",
+           &gatherTransformations<ArticulatedObjectManager>, "object_ids"_a,
+           R"(Get the root transformations of the articulated objects with the given ids as one float32 array of shape (N, 4, 4), without going through a wrapper per object.)")
+      .def(
+          "get_root_linear_velocities",
+          [](const ArticulatedObjectManager& self, const IntArray& objectIds) {
+            return gatherVectors(
+                self, objectIds,
+                &ArticulatedObjectManager::getRootLinearVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the root linear velocities of the articulated objects with the given ids as one float32 array of shape (N, 3).)")
+      .def(
+          "get_root_angular_velocities",
+          [](const ArticulatedObjectManager& self, const IntArray& objectIds) {
+            return gatherVectors(
+                self, objectIds,
+                &ArticulatedObjectManager::getRootAngularVelocities);
+          },
+          "object_ids"_a,
+          R"(Get the root angular velocities of the articulated objects with the given ids as one float32 array of shape (N, 3).)")
+      .def("get_motion_types", &gatherMotionTypes<ArticulatedObjectManager>,
+           "object_ids"_a,
+           R"(Get the motion types of the articulated objects with the given ids as a list.)")
       .def(
           "add_articulated_object_by_template_handle",
 #ifdef ESP_BUILD_WITH_BULLET
@@ -285,6 +510,7 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
 #endif
           "ao_lib_handle"_a, "force_reload"_a = false,
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Instance an articulated object into the scene via a template referenced by its handle.
           Optionally force the articulated object's model to be reloaded from disk and assign its initial
           LightSetup key. Returns a reference to the created object.)")
@@ -297,6 +523,7 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
 #endif
           "ao_lib_id"_a, "force_reload"_a = false,
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Instance an articulated object into the scene via a template referenced by its ID.
           Optionally force the articulated object's model to be reloaded from disk and assign its initial
           LightSetup key. Returns a reference to the created object.)")
@@ -312,6 +539,7 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
           "mass_scale"_a = 1.0, "force_reload"_a = false,
           "maintain_link_order"_a = false, "intertia_from_urdf"_a = false,
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Load and parse a URDF file using the given 'filepath' into a model,
           then use this model to instantiate an Articulated Object in the world.
           Returns a reference to the created object.)");
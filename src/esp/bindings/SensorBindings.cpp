@@ -5,6 +5,7 @@
 #include "esp/bindings/Bindings.h"
 
 #include <Corrade/Containers/OptionalPythonBindings.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
@@ -27,6 +28,7 @@
 #include "esp/sim/Simulator.h"
 
 #include "esp/sensor/AudioSensor.h"
+#include "esp/sensor/LidarSensor.h"
 
 namespace py = pybind11;
 using py::literals::operator""_a;
@@ -40,6 +42,84 @@ esp::scene::SceneNode* nodeGetter(T& self) {
     throw py::value_error{"feature not valid"};
   return &self.node();
 };
+
+#ifdef ESP_BUILD_WITH_CUDA
+// The subset of the DLPack ABI needed to hand out device buffers, see
+// https://github.com/dmlc/dlpack/blob/main/include/dlpack/dlpack.h
+struct DLDevice {
+  int32_t deviceType;  // kDLCUDA is 2
+  int32_t deviceId;
+};
+
+struct DLDataType {
+  uint8_t code;  // 0 for signed, 1 for unsigned integers, 2 for floats
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byteOffset;
+};
+
+struct DLManagedTensor {
+  DLTensor tensor;
+  void* managerContext;
+  void (*deleter)(DLManagedTensor*);
+};
+
+struct ObservationDLPackContext {
+  DLManagedTensor managed;
+  std::shared_ptr<void> memory;
+  std::vector<int64_t> shape;
+};
+
+/**
+ * @brief Wrap the CUDA observation buffer of @p sensor in a DLPack capsule,
+ * which shares ownership of the device memory with the sensor.
+ */
+py::capsule observationDLPack(const esp::sensor::VisualSensor& sensor) {
+  using esp::sensor::SensorType;
+  const SensorType type = sensor.specification()->sensorType;
+  const Magnum::Vector2i size = sensor.framebufferSize();
+
+  // same shapes and types as the gpu2gpu_transfer buffers in Python
+  auto* context = new ObservationDLPackContext{};
+  context->memory = sensor.observationGPUBuffer();
+  context->shape = {size.y(), size.x()};
+  if (type != SensorType::Depth && type != SensorType::Semantic) {
+    context->shape.push_back(4);
+  }
+  DLTensor& tensor = context->managed.tensor;
+  tensor.data = context->memory.get();
+  tensor.device = {2, sensor.observationGPUDevice()};
+  tensor.ndim = context->shape.size();
+  tensor.dtype = type == SensorType::Depth      ? DLDataType{2, 32, 1}
+                 : type == SensorType::Semantic ? DLDataType{0, 32, 1}
+                                                : DLDataType{1, 8, 1};
+  tensor.shape = context->shape.data();
+  tensor.strides = nullptr;
+  tensor.byteOffset = 0;
+  context->managed.managerContext = context;
+  context->managed.deleter = [](DLManagedTensor* managed) {
+    delete static_cast<ObservationDLPackContext*>(managed->managerContext);
+  };
+
+  // consumers rename the capsule once they take ownership
+  return py::capsule{&context->managed, "dltensor", [](PyObject* capsule) {
+                       if (PyCapsule_IsValid(capsule, "dltensor")) {
+                         auto* managed = static_cast<DLManagedTensor*>(
+                             PyCapsule_GetPointer(capsule, "dltensor"));
+                         managed->deleter(managed);
+                       }
+                     }};
+}
+#endif
 }  // namespace
 
 namespace esp {
@@ -47,8 +127,11 @@ namespace sensor {
 
 void initSensorBindings(py::module& m) {
   // ==== Observation ====
-  // NOLINTNEXTLINE(bugprone-unused-raii)
-  py::class_<Observation, Observation::ptr>(m, "Observation");
+  py::class_<Observation, Observation::ptr>(m, "Observation")
+      .def(py::init(&Observation::create<>))
+      .def_readonly(
+          "buffer", &Observation::buffer,
+          R"(Memory filled by Sensor.get_observation(), usable with numpy.asarray() without copying. Sensors reuse it for their next observation.)");
 
   // TODO fill out other SensorTypes
   // ==== enum SensorType ====
@@ -57,7 +140,8 @@ void initSensorBindings(py::module& m) {
       .value("COLOR", SensorType::Color)
       .value("DEPTH", SensorType::Depth)
       .value("SEMANTIC", SensorType::Semantic)
-      .value("AUDIO", SensorType::Audio);
+      .value("AUDIO", SensorType::Audio)
+      .value("LIDAR", SensorType::Lidar);
 
   py::enum_<SensorSubType>(m, "SensorSubType")
       .value("NONE", SensorSubType::None)
@@ -65,7 +149,8 @@ void initSensorBindings(py::module& m) {
       .value("ORTHOGRAPHIC", SensorSubType::Orthographic)
       .value("FISHEYE", SensorSubType::Fisheye)
       .value("EQUIRECTANGULAR", SensorSubType::Equirectangular)
-      .value("IMPULSERESPONSE", SensorSubType::ImpulseResponse);
+      .value("IMPULSERESPONSE", SensorSubType::ImpulseResponse)
+      .value("SPINNING", SensorSubType::Spinning);
 
   // NOTE : esp::sensor::SemanticSensorTarget is an alias for
   // esp::scene::SceneNodeSemanticDataIDX.
@@ -73,6 +158,49 @@ void initSensorBindings(py::module& m) {
       .value("SEMANTIC_ID", SemanticSensorTarget::SEMANTIC_ID)
       .value("OBJECT_ID", SemanticSensorTarget::OBJECT_ID);
 
+  py::enum_<ObservationEncoding>(m, "ObservationEncoding")
+      .value("NONE", ObservationEncoding::None)
+      .value("JPEG", ObservationEncoding::Jpeg)
+      .value("LOSSLESS", ObservationEncoding::Lossless);
+
+  // ==== EncodedObservation ====
+  py::class_<EncodedObservation>(m, "EncodedObservation")
+      .def_property_readonly(
+          "ready", &EncodedObservation::ready,
+          R"(Whether the compression finished)")
+      .def("wait", &EncodedObservation::wait,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Wait for the compression to finish)")
+      .def_property_readonly(
+          "data",
+          [](const EncodedObservation& self) {
+            {
+              py::gil_scoped_release release;
+              self.wait();
+            }
+            return py::bytes(self.data());
+          },
+          R"(The compressed observation, waiting for it if it isn't ready yet)");
+
+  // ==== ObservationEncoder ====
+  py::class_<ObservationEncoder, ObservationEncoder::ptr>(
+      m, "ObservationEncoder",
+      R"(Compresses observations on background threads, so they can be compressed while the next ones are rendered)")
+      .def(py::init(&ObservationEncoder::create<std::size_t>),
+           "thread_count"_a = 1)
+      .def_property_readonly("thread_count", &ObservationEncoder::threadCount);
+
+  m.def(
+      "decode_observation",
+      [](const py::bytes& data, ObservationEncoding encoding,
+         const Mn::MutableImageView2D& image) {
+        const std::string bytes = data;
+        return decodeObservation({bytes.data(), bytes.size()}, encoding,
+                                 image);
+      },
+      R"(Decompress an observation compressed with the given encoding into image, which has the size and format of the original observation. Returns False if it can't be decoded.)",
+      "data"_a, "encoding"_a, "image"_a);
+
   py::enum_<FisheyeSensorModelType>(m, "FisheyeSensorModelType")
       .value("DOUBLE_SPHERE", FisheyeSensorModelType::DoubleSphere);
 
@@ -109,7 +237,21 @@ void initSensorBindings(py::module& m) {
       .def_readwrite("far", &VisualSensorSpec::far)
       .def_readwrite("resolution", &VisualSensorSpec::resolution)
       .def_readwrite("gpu2gpu_transfer", &VisualSensorSpec::gpu2gpuTransfer)
+      .def_readwrite(
+          "pinned_host_memory", &VisualSensorSpec::pinnedHostMemory,
+          R"(Keep observations in page-locked host memory, so they can be copied to a GPU asynchronously. Only has an effect in CUDA builds.)")
+      .def_readwrite(
+          "render_scale", &VisualSensorSpec::renderScale,
+          R"(Fraction of the resolution to render at, the result is upsampled to the full resolution when read. Only used by pinhole and orthographic camera sensors.)")
       .def_readwrite("channels", &VisualSensorSpec::channels)
+      .def_readwrite(
+          "encoding", &VisualSensorSpec::encoding,
+          R"(How Simulator.get_encoded_sensor_observations() compresses observations of this sensor. JPEG is only supported by color sensors.)")
+      .def_readwrite("jpeg_quality", &VisualSensorSpec::jpegQuality,
+                     R"(Quality of JPEG encoding, in [1, 100])")
+      .def_readwrite(
+          "compact_semantic_ids", &VisualSensorSpec::compactSemanticIds,
+          R"(Read semantic observations as 16-bit instead of 32-bit IDs, halving the readback. Drawing fails if the semantic scene has more than 65535 objects. Not supported with gpu2gpu_transfer.)")
       .def_readwrite(
           "semantic_target", &VisualSensorSpec::semanticTarget,
           R"(The type of information rendered by the semantic sensor. If this sensor is not semantic,
@@ -148,6 +290,10 @@ void initSensorBindings(py::module& m) {
       .def_readwrite(
           "cubemap_size", &FisheyeSensorSpec::cubemapSize,
           R"(If not set, will be the min(height, width) of resolution)")
+      .def_readwrite(
+          "fit_cubemap_size_to_projection",
+          &FisheyeSensorSpec::fitCubemapSizeToProjection,
+          R"(If cubemap_size is not set, derive it from the resolution and distortion so a cubemap texel is no larger than the smallest image pixel, instead of using min(height, width) of resolution)")
       .def_readwrite("sensor_model_type", &FisheyeSensorSpec::fisheyeModelType);
 
   // ====FisheyeSensorDoubleSphereSpec ====
@@ -192,7 +338,13 @@ void initSensorBindings(py::module& m) {
       .def("specification", &Sensor::specification)
       .def("set_transformation_from_spec", &Sensor::setTransformationFromSpec)
       .def("is_visual_sensor", &Sensor::isVisualSensor)
-      .def("get_observation", &Sensor::getObservation)
+      .def_property(
+          "enabled", &Sensor::isEnabled, &Sensor::setEnabled,
+          R"(Whether the sensor is drawn and read by Simulator.get_sensor_observations() when no sensor subset is requested. Disabled sensors aren't rendered unless requested by uuid.)")
+      .def(
+          "get_observation", &Sensor::getObservation, "sim"_a, "obs"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Draw and read the observation into obs, see Observation.buffer. Returns False if there's nothing to observe.)")
       .def_property_readonly("node", nodeGetter<Sensor>,
                              "Node this object is attached to")
       .def_property_readonly("object", nodeGetter<Sensor>, "Alias to node");
@@ -215,7 +367,48 @@ void initSensorBindings(py::module& m) {
           "hfov", [](VisualSensor& self) { return Mn::Degd(self.getFOV()); },
           R"(The Field of View this VisualSensor uses.)")
       .def_property_readonly("framebuffer_size", &VisualSensor::framebufferSize)
-      .def_property_readonly("render_target", &VisualSensor::renderTarget);
+      .def_property_readonly("render_target", &VisualSensor::renderTarget)
+      .def(
+          "start_read_observation", &VisualSensor::startReadObservation,
+          R"(Start reading back the observation that was last drawn without waiting for the GPU. Finish it with finish_read_observation(), possibly after the next frame was drawn.)")
+      .def(
+          "finish_read_observation",
+          [](VisualSensor& self, const Mn::MutableImageView2D& view) {
+            return self.finishReadObservation(view);
+          },
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Wait for the oldest readback started by start_read_observation() and copy it to view. Returns False if no readback is pending.)",
+          "view"_a)
+      .def_property_readonly(
+          "pending_read_observation_count",
+          &VisualSensor::pendingReadObservationCount,
+          R"(Number of readbacks started and not finished yet)")
+      .def_property_readonly(
+          "is_read_observation_ready", &VisualSensor::isReadObservationReady,
+          R"(Whether the oldest pending readback completed, so finish_read_observation() won't wait)")
+      .def_property(
+          "readback_slot_count", &VisualSensor::readbackSlotCount,
+          &VisualSensor::setReadbackSlotCount,
+          R"(How many readbacks can be pending at once, 2 by default)")
+      .def(
+          "encode_observation",
+          [](VisualSensor& self, ObservationEncoder& encoder) {
+            Observation obs;
+            self.readObservation(obs);
+            return self.encodeObservation(obs, encoder);
+          },
+          R"(Read the observation that was last drawn and compress it on the encoder's threads, according to the encoding of the sensor specification.)",
+          "encoder"_a)
+#ifdef ESP_BUILD_WITH_CUDA
+      .def(
+          "read_observation_gpu",
+          [](VisualSensor& self) {
+            self.readObservationGPU();
+            return observationDLPack(self);
+          },
+          R"(Copy the observation that was last drawn to a CUDA buffer of this sensor, without going through host memory, and return it as a DLPack capsule, e.g. for torch.utils.dlpack.from_dlpack(). The buffer is reused by subsequent reads, rows are stored bottom to top.)")
+#endif
+      ;
 
   // === CameraSensor ====
   py::class_<CameraSensor, Magnum::SceneGraph::PyFeature<CameraSensor>,
@@ -257,7 +450,19 @@ void initSensorBindings(py::module& m) {
           R"(The distance to the near clipping plane for this CameraSensor uses.)")
       .def_property(
           "far_plane_dist", &CameraSensor::getFar, &CameraSensor::setFar,
-          R"(The distance to the far clipping plane for this CameraSensor uses.)");
+          R"(The distance to the far clipping plane for this CameraSensor uses.)")
+      .def_property(
+          "skip_unchanged_draws", &CameraSensor::getSkipUnchangedDraws,
+          &CameraSensor::setSkipUnchangedDraws,
+          R"(Whether to reuse the previous observation when neither the camera nor
+          any visible drawable moved or changed its appearance since. Off by
+          default, texture, lighting, background, clear color and HBAO changes
+          aren't detected.)")
+      .def_property_readonly("draw_count", &CameraSensor::drawCount,
+                             R"(Number of observations drawn.)")
+      .def_property_readonly(
+          "skipped_draw_count", &CameraSensor::skippedDrawCount,
+          R"(Number of observations that reused the previous one.)");
 
   // === CubeMapSensorBase ===
   // NOLINTNEXTLINE (bugprone-unused-raii)
@@ -294,7 +499,15 @@ void initSensorBindings(py::module& m) {
                                    const int cols, std::size_t devNoisyDepth) {
         self.simulateFromGPU(reinterpret_cast<const float*>(devDepth), rows,
                              cols, reinterpret_cast<float*>(devNoisyDepth));
-      });
+      })
+      .def("simulate_batch_from_gpu",
+           [](RedwoodNoiseModelGPUImpl& self, std::size_t devDepth,
+              const int batchSize, const int rows, const int cols,
+              std::size_t devNoisyDepth) {
+             self.simulateBatchFromGPU(
+                 reinterpret_cast<const float*>(devDepth), batchSize, rows,
+                 cols, reinterpret_cast<float*>(devNoisyDepth));
+           });
 #endif
 
 #ifdef ESP_BUILD_WITH_AUDIO
@@ -437,7 +650,19 @@ void initSensorBindings(py::module& m) {
           R"(RLRAudioPropagationConfiguration | Defined in the relevant section | Acoustic configuration struct that defines simulation parameters)")
       .def_readwrite(
           "channelLayout", &AudioSensorSpec::channelLayout_,
-          R"(RLRAudioPropagationChannelLayout | Defined in the relevant section | Channel layout for simulated output audio)");
+          R"(RLRAudioPropagationChannelLayout | Defined in the relevant section | Channel layout for simulated output audio)")
+      .def_readwrite(
+          "cacheSceneGeometry", &AudioSensorSpec::cacheSceneGeometry_,
+          R"(bool | true | Keep the acoustic simulator and its uploaded scene geometry across AudioSensor.reset() calls as long as the stage doesn't change. Static objects are assumed to not change between such resets.)")
+      .def_readwrite(
+          "irCacheGridSize", &AudioSensorSpec::irCacheGridSize_,
+          R"(float | 0 | Size of the grid cells source and listener positions are quantized to for caching impulse responses. 0 disables the cache.)")
+      .def_readwrite(
+          "irCacheRotationStep", &AudioSensorSpec::irCacheRotationStep_,
+          R"(float | 0.05 | Quantization step of the listener rotation quaternion components for caching impulse responses)")
+      .def_readwrite(
+          "irCacheMemoryBudget", &AudioSensorSpec::irCacheMemoryBudget_,
+          R"(int | 512 MB | Bytes of cached impulse response samples to keep at most, the least recently used ones are evicted first)");
 #else
   py::class_<AudioSensorSpec, AudioSensorSpec::ptr, SensorSpec>(
       m, "AudioSensorSpec", py::dynamic_attr())
@@ -453,6 +678,20 @@ void initSensorBindings(py::module& m) {
       .def("setAudioSourceTransform", &AudioSensor::setAudioSourceTransform)
       .def("setAudioListenerTransform", &AudioSensor::setAudioListenerTransform)
       .def("runSimulation", &AudioSensor::runSimulation)
+      .def(
+          "runSimulations", &AudioSensor::runSimulations,
+          R"(Run the audio simulation for a list of listener positions and rotation quaternions, returning the impulse response of each. The scene geometry and source are uploaded only once.)",
+          "sim"_a, "listenerPositions"_a, "listenerRotQuats"_a)
+      .def(
+          "precomputeIRCache", &AudioSensor::precomputeIRCache,
+          R"(Simulate and cache the impulse responses of all navigable grid points of the pathfinder for the given listener rotation quaternions, with the listener at listenerHeight above the navmesh. Returns the number of simulated responses.)",
+          "sim"_a, "pathfinder"_a, "listenerRotQuats"_a, "listenerHeight"_a)
+      .def_property_readonly(
+          "irCacheSize",
+          [](const AudioSensor& self) -> std::size_t {
+            return self.irCache() ? self.irCache()->size() : 0;
+          },
+          R"(Number of cached impulse responses)")
       .def("setAudioMaterialsJSON", &AudioSensor::setAudioMaterialsJSON)
       .def("getIR", &AudioSensor::getIR)
       .def("reset", &AudioSensor::reset);
@@ -462,6 +701,49 @@ void initSensorBindings(py::module& m) {
       .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
                           const AudioSensorSpec::ptr&>());
 #endif  // ESP_BUILD_WITH_AUDIO
+
+  // ==== LidarSensorSpec ====
+  py::class_<LidarSensorSpec, LidarSensorSpec::ptr, SensorSpec>(
+      m, "LidarSensorSpec", py::dynamic_attr())
+      .def(py::init(&LidarSensorSpec::create<>))
+      .def_readwrite("horizontal_resolution",
+                     &LidarSensorSpec::horizontalResolution,
+                     R"(Number of rays per scan line)")
+      .def_readwrite("vertical_resolution",
+                     &LidarSensorSpec::verticalResolution,
+                     R"(Number of scan lines, 1 for a planar lidar)")
+      .def_property(
+          "horizontal_fov",
+          [](LidarSensorSpec& self) { return Mn::Degd(self.horizontalFov); },
+          [](LidarSensorSpec& self, const py::object& angle) {
+            auto PyDeg = py::module_::import("magnum").attr("Deg");
+            self.horizontalFov = Mn::Deg(PyDeg(angle).cast<Mn::Degd>());
+          },
+          R"(Horizontal field of view, centered on the forward axis. 360 degrees for a full revolution.)")
+      .def_property(
+          "vertical_fov",
+          [](LidarSensorSpec& self) { return Mn::Degd(self.verticalFov); },
+          [](LidarSensorSpec& self, const py::object& angle) {
+            auto PyDeg = py::module_::import("magnum").attr("Deg");
+            self.verticalFov = Mn::Deg(PyDeg(angle).cast<Mn::Degd>());
+          },
+          R"(Vertical field of view spanned by the scan lines, centered on the horizontal plane.)")
+      .def_readwrite("min_range", &LidarSensorSpec::minRange,
+                     R"(Hits closer than this are reported as 0)")
+      .def_readwrite("max_range", &LidarSensorSpec::maxRange,
+                     R"(Farthest distance a ray is cast to)");
+
+  // ==== LidarSensor ====
+  py::class_<LidarSensor, Magnum::SceneGraph::PyFeature<LidarSensor>, Sensor,
+             Magnum::SceneGraph::PyFeatureHolder<LidarSensor>>(m, "LidarSensor")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const LidarSensorSpec::ptr&>())
+      .def_property_readonly(
+          "ray_directions", &LidarSensor::rayDirections,
+          R"(Ray directions in the sensor's local frame, in observation order)")
+      .def_property_readonly(
+          "hit_object_ids", &LidarSensor::hitObjectIds,
+          R"(Ids of the objects hit by the last observation, in observation order, -1 for rays that hit nothing within range)");
 }
 
 }  // namespace sensor
@@ -70,7 +70,10 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite(
           "closest_end_point_index",
           &MultiGoalShortestPath::closestEndPointIndex,
-          R"(The index of the closest end point corresponding to end of the shortest path. Will be -1 if no path exists.)");
+          R"(The index of the closest end point corresponding to end of the shortest path. Will be -1 if no path exists.)")
+      .def_readwrite(
+          "use_distance_field", &MultiGoalShortestPath::useDistanceField,
+          R"(Answer queries from a geodesic distance field over the navmesh polygons, built on first use and reused until the requested ends or the navmesh change. Distances are approximate and points is left empty.)");
 
   py::class_<NavMeshSettings, NavMeshSettings::ptr>(
       m, "NavMeshSettings",
@@ -128,6 +131,9 @@ void initShortestPathBindings(py::module& m) {
       .def_readwrite(
           "include_static_objects", &NavMeshSettings::includeStaticObjects,
           R"(Whether or not to include STATIC RigidObjects as NavMesh constraints. Note: Used in Simulator recomputeNavMesh pre-process. Default False.)")
+      .def_readwrite(
+          "tile_size", &NavMeshSettings::tileSize,
+          R"(XZ-plane edge length of navmesh tiles in world units, or 0 to build a single tile. Tiles are built in parallel, and rebuilding with the same settings and bounds only rebuilds tiles whose input triangles changed, e.g. around STATIC objects added or moved between recompute_navmesh calls. Default 0.)")
       .def("set_defaults", &NavMeshSettings::setDefaults)
       .def("read_from_json", &NavMeshSettings::readFromJSON,
            R"(Overwrite these settings with values from a JSON file.)")
@@ -138,6 +144,46 @@ void initShortestPathBindings(py::module& m) {
           R"(Checks for equivalency of (or < eps 1e-5 distance between) each parameter.)")
       .def(py::self != py::self);
 
+  // queries release the GIL so Python worker threads can run them in parallel
+  py::class_<PathFinderQueryContext, PathFinderQueryContext::ptr>(
+      m, "PathFinderQueryContext",
+      R"(Handle for read-only navigation queries on the navmesh of a PathFinder from one thread. Create one per worker thread with PathFinder.create_query_context(); contexts share the navmesh instead of copying it, so many threads can query it concurrently. A single context must not be used by several threads at once.)")
+      .def("find_path", &PathFinderQueryContext::findPath, "path"_a,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(See PathFinder.find_path().)")
+      .def("try_step", &PathFinderQueryContext::tryStep<Magnum::Vector3>,
+           "start"_a, "end"_a, py::call_guard<py::gil_scoped_release>())
+      .def("try_step", &PathFinderQueryContext::tryStep<vec3f>, "start"_a,
+           "end"_a, py::call_guard<py::gil_scoped_release>())
+      .def("try_step_no_sliding",
+           &PathFinderQueryContext::tryStepNoSliding<Magnum::Vector3>,
+           "start"_a, "end"_a, py::call_guard<py::gil_scoped_release>())
+      .def("try_step_no_sliding",
+           &PathFinderQueryContext::tryStepNoSliding<vec3f>, "start"_a,
+           "end"_a, py::call_guard<py::gil_scoped_release>())
+      .def("snap_point", &PathFinderQueryContext::snapPoint<Magnum::Vector3>,
+           "point"_a, "island_index"_a = ID_UNDEFINED,
+           py::call_guard<py::gil_scoped_release>())
+      .def("snap_point", &PathFinderQueryContext::snapPoint<vec3f>, "point"_a,
+           "island_index"_a = ID_UNDEFINED,
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_island", &PathFinderQueryContext::getIsland<Magnum::Vector3>,
+           "point"_a, py::call_guard<py::gil_scoped_release>())
+      .def("get_island", &PathFinderQueryContext::getIsland<vec3f>, "point"_a,
+           py::call_guard<py::gil_scoped_release>())
+      .def("island_radius", &PathFinderQueryContext::islandRadius, "pt"_a,
+           py::call_guard<py::gil_scoped_release>())
+      .def("distance_to_closest_obstacle",
+           &PathFinderQueryContext::distanceToClosestObstacle, "pt"_a,
+           "max_search_radius"_a = 2.0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("closest_obstacle_surface_point",
+           &PathFinderQueryContext::closestObstacleSurfacePoint, "pt"_a,
+           "max_search_radius"_a = 2.0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("is_navigable", &PathFinderQueryContext::isNavigable, "pt"_a,
+           "max_y_delta"_a = 0.5, py::call_guard<py::gil_scoped_release>());
+
   py::class_<PathFinder, PathFinder::ptr>(
       m, "PathFinder",
       R"(Loads and/or builds a navigation mesh and then allows point sampling, path finding, collision, and island queries on that navmesh. See PathFinder C++ API docs for more details.)")
@@ -150,12 +196,14 @@ void initShortestPathBindings(py::module& m) {
           R"(Seed the pathfinder.  Useful for get_random_navigable_point(). Seeds the global c rand function.)")
       .def(
           "get_topdown_view", &PathFinder::getTopDownView,
-          R"(Returns the topdown view of the PathFinder's navmesh at a given vertical slice with eps slack.)",
-          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5)
+          R"(Returns the topdown view of the PathFinder's navmesh at a given vertical slice with eps slack. With rasterize, navmesh polygons are rasterized into the grid directly instead of testing navigability per cell, which is much faster but may differ at polygon borders. Results are cached until the navmesh changes.)",
+          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5,
+          "rasterize"_a = false)
       .def(
           "get_topdown_island_view", &PathFinder::getTopDownIslandView,
-          R"(Returns the topdown view of the PathFinder's navmesh with island indices at each point or -1 for non-navigable cells for a given vertical slice with eps slack.)",
-          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5)
+          R"(Returns the topdown view of the PathFinder's navmesh with island indices at each point or -1 for non-navigable cells for a given vertical slice with eps slack. See get_topdown_view for rasterize.)",
+          "meters_per_pixel"_a, "height"_a, "eps"_a = 0.5,
+          "rasterize"_a = false)
       // detailed docs in docs/docs.rst
       .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint,
            "max_tries"_a = 10, "island_index"_a = ID_UNDEFINED)
@@ -164,18 +212,69 @@ void initShortestPathBindings(py::module& m) {
           &PathFinder::getRandomNavigablePointAroundSphere, "circle_center"_a,
           "radius"_a, "max_tries"_a = 100, "island_index"_a = ID_UNDEFINED,
           R"(Returns a random navigable point within a specified radius about a given point. Optionally specify the island from which to sample the point. Default -1 queries the full navmesh.)")
+      .def(
+          "get_random_navigable_points",
+          &PathFinder::getRandomNavigablePoints, "count"_a, "seed"_a,
+          "island_index"_a = ID_UNDEFINED, "num_threads"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Returns count random navigable points, uniformly distributed by area over the navmesh or the island island_index, drawn across num_threads worker threads (all hardware threads if 0). The points only depend on seed, not on the thread count or the global seed. The GIL is released while sampling.)")
       .def(
           "find_path", py::overload_cast<ShortestPath&>(&PathFinder::findPath),
-          "path"_a,
+          "path"_a, py::call_guard<py::gil_scoped_release>(),
           R"(Finds the shortest path between two points on the navigation mesh using ShortestPath module. Path variable is filled if successful. Returns boolean success.)")
       .def(
           "find_path",
           py::overload_cast<MultiGoalShortestPath&>(&PathFinder::findPath),
-          "path"_a,
+          "path"_a, py::call_guard<py::gil_scoped_release>(),
           R"(Finds the shortest path between a start point and the closest of a set of end points (in geodesic distance) on the navigation mesh using MultiGoalShortestPath module. Path variable is filled if successful. Returns boolean success.)")
+      .def(
+          "geodesic_distance_matrix", &PathFinder::geodesicDistanceMatrix,
+          "points"_a, "num_threads"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Returns the (N, N) float matrix of geodesic distances between all pairs of points, computed with one Dijkstra search per point over the polygon edge midpoints spread across num_threads worker threads (all hardware threads if 0). Points on different islands or off the navmesh are infinitely far apart. Distances can be slightly longer than those of find_path.)")
+      .def(
+          "find_paths",
+          [](PathFinder& self, const std::vector<vec3f>& starts,
+             const std::vector<vec3f>& ends, bool returnPoints,
+             int numThreads) -> py::object {
+            if (starts.size() != ends.size()) {
+              throw py::value_error{
+                  "starts and ends must have the same length"};
+            }
+            std::vector<ShortestPath> paths(starts.size());
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+              paths[i].requestedStart = starts[i];
+              paths[i].requestedEnd = ends[i];
+            }
+            {
+              py::gil_scoped_release release;
+              self.findPaths(paths, numThreads);
+            }
+            std::vector<float> distances(paths.size());
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+              distances[i] = paths[i].geodesicDistance;
+            }
+            if (!returnPoints) {
+              return py::cast(distances);
+            }
+            std::vector<std::vector<vec3f>> points(paths.size());
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+              points[i] = std::move(paths[i].points);
+            }
+            return py::make_tuple(distances, points);
+          },
+          "starts"_a, "ends"_a, "return_points"_a = false, "num_threads"_a = 0,
+          R"(Finds the shortest paths between each pair of starts[i] and ends[i], spread across num_threads worker threads (all hardware threads if 0). Returns the list of geodesic distances, inf where no path exists, or a tuple of distances and path point lists if return_points is set. The GIL is released while the paths are computed.)")
+      .def(
+          "create_query_context", &PathFinder::createQueryContext,
+          R"(Create a PathFinderQueryContext for read-only queries on the current navmesh from another thread.)")
       .def("try_step", &PathFinder::tryStep<Magnum::Vector3>, "start"_a,
            "end"_a)
       .def("try_step", &PathFinder::tryStep<vec3f>, "start"_a, "end"_a)
+      .def("try_steps", &PathFinder::trySteps, "starts"_a, "ends"_a,
+           "allow_sliding"_a = true, "num_threads"_a = 0,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Batched try_step (or try_step_no_sliding if allow_sliding is false) for each pair of starts[i] and ends[i], spread across num_threads worker threads (all hardware threads if 0). The GIL is released while stepping.)")
       .def("try_step_no_sliding",
            &PathFinder::tryStepNoSliding<Magnum::Vector3>, "start"_a, "end"_a)
       .def("try_step_no_sliding", &PathFinder::tryStepNoSliding<vec3f>,
@@ -233,6 +332,7 @@ void initShortestPathBindings(py::module& m) {
           "island_index"_a = ID_UNDEFINED,
           R"(Returns an array of triangle index data for the triangulated NavMesh poly vertices returned by build_navmesh_vertices(). Optionally limit results to a specific island. Default (island_index==-1) queries all islands.)")
       .def("load_nav_mesh", &PathFinder::loadNavMesh, "path"_a,
+           py::call_guard<py::gil_scoped_release>(),
            R"(Load a .navmesh file overriding this PathFinder instance.)")
       .def(
           "save_nav_mesh", &PathFinder::saveNavMesh, "path"_a,
@@ -247,6 +347,34 @@ void initShortestPathBindings(py::module& m) {
            R"(Returns the hit_pos, hit_normal and hit_dist of the surface point
           on the closest obstacle.)",
            "pt"_a, "max_search_radius"_a = 2.0)
+      .def(
+          "distances_to_closest_obstacle",
+          &PathFinder::distancesToClosestObstacle, "pts"_a,
+          "max_search_radius"_a = 2.0, "num_threads"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Batched distance_to_closest_obstacle for each of pts, spread across num_threads worker threads (all hardware threads if 0). The GIL is released while querying.)")
+      .def(
+          "build_obstacle_distance_field",
+          &PathFinder::buildObstacleDistanceField, "meters_per_pixel"_a = 0.05,
+          "max_search_radius"_a = 2.0, "num_threads"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Precomputes the distance to the closest obstacle on a top-down grid with meters_per_pixel spacing over every floor of the navmesh, using num_threads worker threads (all hardware threads if 0). distance_to_closest_obstacle then interpolates bilinearly from it where possible. Saved and loaded with the navmesh, discarded when it changes.)")
+      .def_property_readonly(
+          "has_obstacle_distance_field", &PathFinder::hasObstacleDistanceField,
+          R"(Whether an obstacle distance field was built or loaded.)")
+      .def("clear_obstacle_distance_field",
+           &PathFinder::clearObstacleDistanceField,
+           R"(Drops the obstacle distance field.)")
+      .def(
+          "build_path_hierarchy", &PathFinder::buildPathHierarchy,
+          "region_size"_a = 64, "num_threads"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Clusters the navmesh polygons into regions of up to region_size polygons connected by portals and precomputes the portal-to-portal distances inside each region, using num_threads worker threads (all hardware threads if 0). find_path then searches paths between regions that aren't neighbours over the portals first, which may be slightly longer than the exact shortest path. Saved and loaded with the navmesh, discarded when it changes.)")
+      .def_property_readonly(
+          "has_path_hierarchy", &PathFinder::hasPathHierarchy,
+          R"(Whether a path hierarchy was built or loaded.)")
+      .def("clear_path_hierarchy", &PathFinder::clearPathHierarchy,
+           R"(Drops the path hierarchy.)")
       .def("is_navigable", &PathFinder::isNavigable,
            R"(Checks to see if the agent can stand at the specified point.)",
            "pt"_a, "max_y_delta"_a = 0.5)
@@ -292,6 +420,40 @@ void initShortestPathBindings(py::module& m) {
                &GreedyGeodesicFollowerImpl::findPath),
            py::return_value_policy::move)
       .def("reset", &GreedyGeodesicFollowerImpl::reset);
+
+  py::class_<GreedyGeodesicFollowerBatch, GreedyGeodesicFollowerBatch::ptr>(
+      m, "GreedyGeodesicFollowerBatch",
+      R"(Runs the greedy geodesic follower for many agents in one call, spread across worker threads. Actions are applied natively: move_forward is filtered with try_step (or try_step_no_sliding) and turn_left/turn_right rotate about the up axis, matching the default agent actions without actuation noise.)")
+      .def(py::init(&GreedyGeodesicFollowerBatch::create<
+                    const PathFinder::ptr&, int, double, double, double, bool,
+                    bool, int, int>),
+           "pathfinder"_a, "num_agents"_a, "goal_radius"_a,
+           "forward_amount"_a, "turn_amount"_a, "allow_sliding"_a = true,
+           "fix_thrashing"_a = true, "thrashing_threshold"_a = 16,
+           "num_threads"_a = 0)
+      .def_property_readonly("num_agents",
+                             &GreedyGeodesicFollowerBatch::numAgents)
+      .def("next_actions_along", &GreedyGeodesicFollowerBatch::nextActionsAlong,
+           "states"_a, "goals"_a, py::call_guard<py::gil_scoped_release>(),
+           R"(Computes the next action of every agent. An agent's follower is reset whenever its goal changes.)")
+      .def(
+          "step",
+          [](GreedyGeodesicFollowerBatch& self,
+             std::vector<core::RigidState> states,
+             const std::vector<Mn::Vector3>& goals) {
+            std::vector<GreedyGeodesicFollowerImpl::CODES> actions;
+            {
+              py::gil_scoped_release release;
+              actions = self.step(states, goals);
+            }
+            return py::make_tuple(actions, states);
+          },
+          "states"_a, "goals"_a,
+          R"(Computes the next action of every agent and applies it. Returns a tuple of the actions and the new agent states.)")
+      .def("find_paths", &GreedyGeodesicFollowerBatch::findPaths, "states"_a,
+           "goals"_a, py::call_guard<py::gil_scoped_release>(),
+           R"(Finds the full action sequence of every agent, empty where no path was found.)")
+      .def("reset", &GreedyGeodesicFollowerBatch::reset);
 }
 
 }  // namespace nav
@@ -4,21 +4,30 @@
 
 #include "esp/bindings/Bindings.h"
 
+#include <pybind11/numpy.h>
+
+#include <cstdint>
+#include <cstring>
+
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
 #include "esp/gfx/Renderer.h"
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/ReplayManager.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/scene/SemanticScene.h"
+#include "esp/sensor/CameraSensor.h"
 #include "esp/sim/AbstractReplayRenderer.h"
 #include "esp/sim/BatchReplayRenderer.h"
+#include "esp/sim/BatchedSimulator.h"
 #include "esp/sim/ClassicReplayRenderer.h"
 #include "esp/sim/Simulator.h"
 #include "esp/sim/SimulatorConfiguration.h"
@@ -29,6 +38,127 @@ using py::literals::operator""_a;
 namespace esp {
 namespace sim {
 
+namespace {
+
+py::dtype dtypeForDataType(core::DataType dataType) {
+  switch (dataType) {
+    case core::DataType::DT_INT8:
+      return py::dtype::of<int8_t>();
+    case core::DataType::DT_UINT8:
+      return py::dtype::of<uint8_t>();
+    case core::DataType::DT_INT16:
+      return py::dtype::of<int16_t>();
+    case core::DataType::DT_UINT16:
+      return py::dtype::of<uint16_t>();
+    case core::DataType::DT_INT32:
+      return py::dtype::of<int32_t>();
+    case core::DataType::DT_UINT32:
+      return py::dtype::of<uint32_t>();
+    case core::DataType::DT_INT64:
+      return py::dtype::of<int64_t>();
+    case core::DataType::DT_UINT64:
+      return py::dtype::of<uint64_t>();
+    case core::DataType::DT_FLOAT:
+      return py::dtype::of<float>();
+    case core::DataType::DT_DOUBLE:
+      return py::dtype::of<double>();
+    default:
+      throw std::runtime_error("Observation buffer has no valid data type.");
+  }
+}
+
+/**
+ * @brief Stack the per-environment observations of a @ref BatchedSimulator
+ * into one numpy array of shape [numEnvironments, *sensorShape] per sensor
+ * uuid.
+ */
+py::dict stackBatchedObservations(
+    const std::vector<BatchedSimulator::EnvironmentObservations>&
+        observations) {
+  py::dict result;
+  if (observations.empty()) {
+    return result;
+  }
+  for (const auto& entry : observations[0]) {
+    const core::Buffer& first = *entry.second.buffer;
+    std::vector<py::ssize_t> shape{py::ssize_t(observations.size())};
+    for (size_t dim : first.shape) {
+      shape.push_back(py::ssize_t(dim));
+    }
+    py::array stacked{dtypeForDataType(first.dataType), shape};
+    const size_t envBytes = first.data.size();
+    auto* dst = static_cast<char*>(stacked.mutable_data());
+    for (size_t envIndex = 0; envIndex < observations.size(); ++envIndex) {
+      auto found = observations[envIndex].find(entry.first);
+      if (found == observations[envIndex].end() ||
+          found->second.buffer->data.size() != envBytes) {
+        throw std::runtime_error(
+            "Batched environments have mismatched observations for sensor " +
+            entry.first);
+      }
+      std::memcpy(dst + envIndex * envBytes, found->second.buffer->data.data(),
+                  envBytes);
+    }
+    result[py::str(entry.first)] = std::move(stacked);
+  }
+  return result;
+}
+
+/**
+ * @brief View the memory of an observation as a numpy array, without copying.
+ * The array keeps @p buffer alive.
+ */
+py::array observationView(const core::Buffer::ptr& buffer) {
+  std::vector<py::ssize_t> shape(buffer->shape.begin(), buffer->shape.end());
+  return py::array{dtypeForDataType(buffer->dataType), std::move(shape),
+                   buffer->data.data(), py::cast(buffer)};
+}
+
+using FloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+using IntArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief View a contiguous [N, 3] float array as N vectors, for passing ray
+ * batches to @ref Simulator::castRays.
+ */
+Corrade::Containers::ArrayView<const Mn::Vector3> vector3View(
+    const FloatArray& array,
+    const char* name) {
+  if (array.ndim() != 2 || array.shape(1) != 3) {
+    throw std::runtime_error(std::string{"Expected "} + name +
+                             " to be an array of shape [N, 3]");
+  }
+  return {reinterpret_cast<const Mn::Vector3*>(array.data()),
+          std::size_t(array.shape(0))};
+}
+
+/**
+ * @brief Convert an optional [N, 3, 3] float array of row-major matrices to
+ * Magnum's column-major ones. None gives no matrices.
+ */
+std::vector<Mn::Matrix3x3> matrix3x3Array(const py::object& object,
+                                          const char* name) {
+  std::vector<Mn::Matrix3x3> matrices;
+  if (object.is_none()) {
+    return matrices;
+  }
+  const auto array = py::cast<FloatArray>(object);
+  if (array.ndim() != 3 || array.shape(1) != 3 || array.shape(2) != 3) {
+    throw std::runtime_error(std::string{"Expected "} + name +
+                             " to be an array of shape [N, 3, 3]");
+  }
+  const float* data = array.data();
+  matrices.resize(array.shape(0));
+  for (Mn::Matrix3x3& matrix : matrices) {
+    matrix = Mn::Matrix3x3::from(data).transposed();
+    data += 9;
+  }
+  return matrices;
+}
+
+}  // namespace
+
 void initSimBindings(py::module& m) {
   // ==== SimulatorConfiguration ====
   py::class_<SimulatorConfiguration, SimulatorConfiguration::ptr>(
@@ -63,6 +193,12 @@ void initSimBindings(py::module& m) {
           R"(See tutorials/async_rendering.py)")
       .def_readwrite("frustum_culling", &SimulatorConfiguration::frustumCulling,
                      R"(Enable or disable the frustum culling optimisation.)")
+      .def_readwrite(
+          "instanced_rendering", &SimulatorConfiguration::instancedRendering,
+          R"(Draw copies of the same asset sharing a material in single instanced draw calls. Changes the draw order.)")
+      .def_readwrite(
+          "mesh_lod_levels", &SimulatorConfiguration::meshLodLevels,
+          R"(Number of simplified levels of detail to generate for each loaded mesh. Distant objects are drawn with a level matching their size on screen. 0 disables level of detail.)")
       .def_readwrite(
           "enable_physics", &SimulatorConfiguration::enablePhysics,
           R"(Specifies whether or not dynamics is supported by the simulation if a suitable library (i.e. Bullet) has been installed. Install with --bullet to enable.)")
@@ -102,6 +238,65 @@ void initSimBindings(py::module& m) {
       .def_readwrite(
           "enable_hbao", &SimulatorConfiguration::enableHBAO,
           R"(Whether or not to enable horizon-based ambient occlusion, which provides soft shadows in corners and crevices.)")
+      .def_readwrite(
+          "hbao_resolution_divisor",
+          &SimulatorConfiguration::hbaoResolutionDivisor,
+          R"(Resolution divisor horizon-based ambient occlusion is calculated at, either 1, 2 or 4. Reduced resolutions are bilaterally upsampled and are significantly cheaper.)")
+      .def_readwrite(
+          "ibl_cache_dir", &SimulatorConfiguration::iblCacheDir,
+          R"(Directory to cache the IBL maps precomputed from PBR environment maps in, so later runs load them instead of recomputing. Empty disables the cache.)")
+      .def_readwrite(
+          "optimize_meshes", &SimulatorConfiguration::optimizeMeshes,
+          R"(Optimize loaded meshes for rendering, reordering their indices for vertex cache locality and packing their normals, tangents and texture coordinates into smaller vertex formats.)")
+      .def_readwrite(
+          "mesh_cache_dir", &SimulatorConfiguration::meshCacheDir,
+          R"(Directory to cache the meshes optimized with `optimize_meshes` in, so later runs load them instead of importing and optimizing again. Empty disables the cache.)")
+      .def_readwrite(
+          "shader_cache_dir", &SimulatorConfiguration::shaderCacheDir,
+          R"(Directory to cache the binaries of linked shader programs in, so later runs, and other processes on the same driver, load them instead of compiling GLSL again. Empty disables the cache.)")
+      .def_readwrite(
+          "precompile_shaders", &SimulatorConfiguration::precompileShaders,
+          R"(Create the shaders of all drawables of a scene right after it's loaded instead of on first draw, moving the compilation latency out of the first frame. See Simulator.precompile_shaders().)")
+      .def_readwrite(
+          "compress_textures", &SimulatorConfiguration::compressTextures,
+          R"(Compress uncompressed 8-bit RGB and RGBA textures to BC1 and BC3 on load, if the GPU supports them, cutting their memory use four to six times. The compressed textures are cached next to the asset, so later runs load them instead of compressing again.)")
+      .def_readwrite(
+          "asset_cache_cpu_budget",
+          &SimulatorConfiguration::assetCacheCpuBudget,
+          R"(Estimated CPU memory, in bytes, that render assets loaded for earlier scenes may keep taking when the scene is changed. Least recently used assets the new scene doesn't need are released until the total fits. Zero keeps everything loaded.)")
+      .def_readwrite(
+          "asset_cache_gpu_budget",
+          &SimulatorConfiguration::assetCacheGpuBudget,
+          R"(Estimated GPU memory, in bytes, that render assets loaded for earlier scenes may keep taking when the scene is changed, see `asset_cache_cpu_budget`. Zero keeps everything loaded.)")
+      .def_readwrite(
+          "use_min_volume_semantic_obbs",
+          &SimulatorConfiguration::useMinVolumeSemanticOBBs,
+          R"(Build tight, approximately minimum volume OBBs instead of AABBs for semantic objects whose bounding boxes are derived from vertex annotations on load, e.g. for HM3D. Noticeably slower to load.)")
+      .def_readwrite(
+          "use_dataset_config_snapshot",
+          &SimulatorConfiguration::useDatasetConfigSnapshot,
+          R"(Keep a snapshot of all config files of the scene dataset next to its .scene_dataset_config.json, so later runs read them with a single read instead of opening each. Files changed since are read from disk again and the snapshot is updated.)")
+      .def_readwrite(
+          "cache_directory_listings",
+          &SimulatorConfiguration::cacheDirectoryListings,
+          R"(Check the existence of dataset config and asset files against directory listings read once per directory instead of querying the filesystem for each file. Speeds up loading datasets on network filesystems. Listings are read again when a scene dataset is loaded, files added to a dataset in between aren't found. The setting is process-wide.)")
+      .def_readwrite(
+          "lazy_scene_instance_loading",
+          &SimulatorConfiguration::lazySceneInstanceLoading,
+          R"(Only index the scene instance configs of the scene dataset when loading it, and parse each one the first time it's requested. Speeds up loading datasets with many scene instances of which only a few are used.)")
+      .def_readwrite(
+          "save_scene_instances_in_background",
+          &SimulatorConfiguration::saveSceneInstancesInBackground,
+          R"(Write the files of save_current_scene_config from a background thread, so checkpointing a scene only stalls the simulation for building its description. Use wait_for_scene_config_saves to find out whether the writes succeeded.)")
+      .def_readwrite(
+          "main_thread_cpus", &SimulatorConfiguration::mainThreadCpus,
+          R"(CPUs to pin the thread creating the simulator to, on Linux. Threads it starts for a single call inherit them, and buffers it allocates and fills, such as loaded assets and observation buffers, end up on their NUMA node. Empty leaves the thread where it is.)")
+      .def_readwrite(
+          "render_thread_cpus", &SimulatorConfiguration::renderThreadCpus,
+          R"(CPUs to pin the background render thread to, on Linux. Empty leaves it on the CPUs it inherited.)")
+      .def_readwrite(
+          "worker_thread_cpus", &SimulatorConfiguration::workerThreadCpus,
+          R"(CPUs to pin long-lived worker threads to, on Linux, such as the observation encoder threads, the scene prefetch thread and the threads stepping batched physics worlds. Empty leaves them on the CPUs they inherited.)")
       .def(py::self == py::self)
       .def(py::self != py::self);
 
@@ -125,14 +320,35 @@ void initSimBindings(py::module& m) {
             Not available for all datasets
             )")
       .def_property_readonly("renderer", &Simulator::getRenderer)
+      .def_property_readonly(
+          "observation_encoder", &Simulator::getObservationEncoder,
+          py::return_value_policy::reference_internal,
+          R"(Encoder compressing observations of sensors with an encoding, created on first use with up to four threads)")
       .def_property_readonly(
           "gfx_replay_manager", &Simulator::getGfxReplayManager,
           R"(Use gfx_replay_manager for replay recording and playback.)")
       .def("seed", &Simulator::seed, "new_seed"_a)
-      .def("reconfigure", &Simulator::reconfigure, "configuration"_a)
-      .def("reset", &Simulator::reset)
+      .def("reconfigure", &Simulator::reconfigure, "configuration"_a,
+           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "prefetch_scene",
+          [](Simulator& self, const std::string& activeSceneName) {
+            self.prefetchScene(activeSceneName);
+          },
+          "active_scene_name"_a,
+          R"(Start reading the navmesh and asset files of the given scene instance on a background thread, so a later reconfigure() to that scene doesn't wait on the disk. Poll is_scene_prefetched() to know when it's done.)")
+      .def(
+          "is_scene_prefetched", &Simulator::isScenePrefetched,
+          "active_scene_name"_a,
+          R"(Whether the files of the given scene instance were prefetched with prefetch_scene() and reading them has finished.)")
+      .def(
+          "precompile_shaders", &Simulator::precompileShaders,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Create the shaders of all drawables of the active scene and its semantic scene now instead of on first draw. Done after loading a scene if SimulatorConfiguration.precompile_shaders is set.)")
+      .def("reset", &Simulator::reset, py::call_guard<py::gil_scoped_release>())
       .def(
           "close", &Simulator::close, "destroy"_a = true,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Free all loaded assets and GPU contexts. Use destroy=true except where noted in tutorials/async_rendering.py.)")
       .def(
           "physics_debug_draw", &Simulator::physicsDebugDraw, "projMat"_a,
@@ -155,6 +371,14 @@ void initSimBindings(py::module& m) {
       .def_property("frustum_culling", &Simulator::isFrustumCullingEnabled,
                     &Simulator::setFrustumCullingEnabled,
                     R"(Enable or disable the frustum culling)")
+      .def_property("instanced_rendering",
+                    &Simulator::isInstancedRenderingEnabled,
+                    &Simulator::setInstancedRenderingEnabled,
+                    R"(Enable or disable instanced rendering of repeated assets)")
+      .def_property(
+          "mesh_lod", &Simulator::isMeshLodEnabled,
+          &Simulator::setMeshLodEnabled,
+          R"(Enable or disable drawing simplified levels of detail of distant meshes, if the meshes were loaded with any)")
       .def_property(
           "active_dataset", &Simulator::getActiveSceneDatasetName,
           &Simulator::setActiveSceneDatasetName,
@@ -219,15 +443,37 @@ void initSimBindings(py::module& m) {
           R"(Get a list of strings describing first each color found on vertices in the semantic mesh that is
           not present in the loaded semantic scene descriptor file, and then a list of each semantic object
           whose specified color is not found on any vertex in the mesh.)")
+      .def(
+          "replace_render_asset", &Simulator::replaceRenderAsset, "filepath"_a,
+          "replacement_filepath"_a,
+          R"(Swap the meshes and textures of the loaded render asset filepath for those of replacement_filepath in place, such as a full-detail stage for the low-detail variant it was first loaded from. Both have to have the same meshes and textures in the same order. Returns whether the replacement was swapped in.)")
 
       /* --- Kinematics and dynamics --- */
       .def(
           "step_world", &Simulator::stepWorld, "dt"_a = 1.0 / 60.0,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Step the physics simulation by a desired timestep (dt). Note that resulting world time after step may not be exactly t+dt. Use get_world_time to query current simulation time.)")
       .def("get_world_time", &Simulator::getWorldTime,
            R"(Query the current simulation world time.)")
       .def("get_physics_time_step", &Simulator::getPhysicsTimeStep,
            R"(Get the last used physics timestep)")
+      .def(
+          "capture_state",
+          [](Simulator& self) {
+            const std::vector<char> state = self.captureState();
+            return py::bytes(state.data(), state.size());
+          },
+          R"(Capture rigid and articulated object states, joint positions and velocities, rigid constraints, agent states and world time into a compact binary blob. Restore it with restore_state to reset an episode without rebuilding the scene.)")
+      .def(
+          "restore_state",
+          [](Simulator& self, const py::bytes& state) {
+            const std::string stateStr = state;
+            py::gil_scoped_release release;
+            self.restoreState(
+                std::vector<char>(stateStr.begin(), stateStr.end()));
+          },
+          "state"_a,
+          R"(Restore a blob captured with capture_state, reusing existing objects. Objects and constraints added since the capture are removed.)")
       .def("get_gravity", &Simulator::getGravity,
            R"(Query the gravity vector for the scene.)")
       .def("set_gravity", &Simulator::setGravity, "gravity"_a,
@@ -253,23 +499,216 @@ void initSimBindings(py::module& m) {
           "get_physics_step_collision_summary",
           &Simulator::getPhysicsStepCollisionSummary,
           R"(Get a summary of collision-processing from the last physics step.)")
-      .def("get_physics_contact_points", &Simulator::getPhysicsContactPoints,
-           R"(Return a list of ContactPointData "
+      .def(
+          "get_physics_contact_points",
+          [](Simulator& self) { return self.getPhysicsContactPoints(); },
+          R"(Return a list of ContactPointData "
           "objects describing the contacts from the most recent physics substep.)")
+      .def(
+          "get_physics_contact_points",
+          [](Simulator& self, const esp::physics::ContactPointFilter& filter) {
+            std::vector<esp::physics::ContactPointData> contactPoints;
+            self.getPhysicsContactPoints(filter, contactPoints);
+            return contactPoints;
+          },
+          "filter"_a,
+          R"(Return a list of ContactPointData objects describing the contacts from the most recent physics substep that pass the ContactPointFilter. Manifolds rejected by the filter are skipped without converting their contact points.)")
+      .def(
+          "subscribe_physics_contact_events",
+          &Simulator::subscribePhysicsContactEvents, "object_id"_a,
+          R"(Report contact begin, persist and end events of an object during physics steps. The stage has an id of 0.)")
+      .def("unsubscribe_physics_contact_events",
+           &Simulator::unsubscribePhysicsContactEvents, "object_id"_a,
+           R"(Stop reporting contact events of an object.)")
+      .def(
+          "get_physics_contact_events", &Simulator::getPhysicsContactEvents,
+          R"(Return a list of ContactEvent objects recorded for subscribed objects during the most recent physics step, in the order they happened.)")
+      .def(
+          "set_object_pooling_enabled", &Simulator::setObjectPoolingEnabled,
+          "enabled"_a,
+          R"(Keep removed rigid objects hidden and out of the simulation for reuse by objects later added from the same template, instead of destroying them. Disabling pooling destroys the pooled objects.)")
+      .def("get_num_pooled_objects", &Simulator::getNumPooledObjects,
+           R"(Get the number of removed rigid objects kept for reuse.)")
       .def(
           "perform_discrete_collision_detection",
           &Simulator::performDiscreteCollisionDetection,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Perform discrete collision detection for the scene. Physics must be enabled. Warning: may break simulation determinism.)")
       .def(
           "cast_ray", &Simulator::castRay, "ray"_a, "max_distance"_a = 100.0,
+          py::call_guard<py::gil_scoped_release>(),
           R"(Cast a ray into the collidable scene and return hit results. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays",
+          [](Simulator& self, const FloatArray& origins,
+             const FloatArray& directions, double maxDistance) {
+            const auto originView = vector3View(origins, "origins");
+            const auto directionView = vector3View(directions, "directions");
+            const std::size_t count = originView.size();
+            py::array_t<float> distances(py::ssize_t(count));
+            py::array_t<int> objectIds(py::ssize_t(count));
+            py::array_t<float> normals({py::ssize_t(count), py::ssize_t(3)});
+            {
+              py::gil_scoped_release release;
+              self.castRays(
+                  originView, directionView, maxDistance,
+                  {distances.mutable_data(), count},
+                  {objectIds.mutable_data(), count},
+                  {reinterpret_cast<Mn::Vector3*>(normals.mutable_data()),
+                   count});
+            }
+            return py::make_tuple(distances, objectIds, normals);
+          },
+          "origins"_a, "directions"_a, "max_distance"_a = 100.0,
+          R"(Cast a batch of rays, given as [N, 3] origin and direction arrays, in parallel and return a tuple of the closest hit distances, object ids and normals. Rays that hit nothing have a distance of max_distance and an object id of -1. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays_all_hits",
+          [](Simulator& self, const FloatArray& origins,
+             const FloatArray& directions, double maxDistance,
+             std::size_t maxHitsPerRay) {
+            const auto originView = vector3View(origins, "origins");
+            const auto directionView = vector3View(directions, "directions");
+            const std::size_t count = originView.size();
+            const std::size_t slots = count * maxHitsPerRay;
+            py::array_t<float> distances(
+                {py::ssize_t(count), py::ssize_t(maxHitsPerRay)});
+            py::array_t<int> objectIds(
+                {py::ssize_t(count), py::ssize_t(maxHitsPerRay)});
+            py::array_t<float> normals({py::ssize_t(count),
+                                        py::ssize_t(maxHitsPerRay),
+                                        py::ssize_t(3)});
+            py::array_t<int> hitCounts(py::ssize_t(count));
+            {
+              py::gil_scoped_release release;
+              self.castRaysAllHits(
+                  originView, directionView, maxDistance, maxHitsPerRay,
+                  {distances.mutable_data(), slots},
+                  {objectIds.mutable_data(), slots},
+                  {reinterpret_cast<Mn::Vector3*>(normals.mutable_data()),
+                   slots},
+                  {hitCounts.mutable_data(), count});
+            }
+            return py::make_tuple(distances, objectIds, normals, hitCounts);
+          },
+          "origins"_a, "directions"_a, "max_distance"_a = 100.0,
+          "max_hits_per_ray"_a = 8,
+          R"(Cast a batch of rays like cast_rays() but return up to max_hits_per_ray hits per ray sorted by distance, as a tuple of [N, max_hits_per_ray] distances and object ids, [N, max_hits_per_ray, 3] normals and the number of hits of each ray.)")
+      .def(
+          "cast_capsule", &Simulator::castCapsule, "ray"_a, "radius"_a,
+          "height"_a, "max_distance"_a = 100.0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Sweep an upright (Y-aligned) capsule centered at the ray origin along the ray and return the first hit, if any. height is the distance between the centers of the capsule's caps. Physics must be enabled. max_distance and hit distances in units of ray length, i.e. the time of impact for a velocity.)")
+      .def(
+          "cast_capsules",
+          [](Simulator& self, const FloatArray& origins,
+             const FloatArray& directions, float radius, float height,
+             double maxDistance) {
+            const auto originView = vector3View(origins, "origins");
+            const auto directionView = vector3View(directions, "directions");
+            const std::size_t count = originView.size();
+            py::array_t<float> distances(py::ssize_t(count));
+            py::array_t<int> objectIds(py::ssize_t(count));
+            py::array_t<float> normals({py::ssize_t(count), py::ssize_t(3)});
+            {
+              py::gil_scoped_release release;
+              self.castCapsules(
+                  originView, directionView, radius, height, maxDistance,
+                  {distances.mutable_data(), count},
+                  {objectIds.mutable_data(), count},
+                  {reinterpret_cast<Mn::Vector3*>(normals.mutable_data()),
+                   count});
+            }
+            return py::make_tuple(distances, objectIds, normals);
+          },
+          "origins"_a, "directions"_a, "radius"_a, "height"_a,
+          "max_distance"_a = 100.0,
+          R"(Sweep an upright capsule along a batch of rays, given as [N, 3] origin and direction arrays, in parallel and return a tuple of the first hit distances, object ids and normals like cast_rays(). Sweeps that hit nothing have a distance of max_distance and an object id of -1. Physics must be enabled.)")
+      .def(
+          "query_box_overlaps",
+          [](Simulator& self, const FloatArray& boxMins,
+             const FloatArray& boxMaxs, std::size_t maxOverlapsPerQuery) {
+            const auto minView = vector3View(boxMins, "box_mins");
+            const auto maxView = vector3View(boxMaxs, "box_maxs");
+            if (maxView.size() != minView.size()) {
+              throw std::runtime_error(
+                  "Expected box_mins and box_maxs to have the same shape");
+            }
+            const std::size_t count = minView.size();
+            const std::size_t slots = count * maxOverlapsPerQuery;
+            std::vector<Mn::Range3D> boxes;
+            boxes.reserve(count);
+            for (std::size_t i = 0; i != count; ++i) {
+              boxes.emplace_back(minView[i], maxView[i]);
+            }
+            py::array_t<int> objectIds(
+                {py::ssize_t(count), py::ssize_t(maxOverlapsPerQuery)});
+            py::array_t<int> linkIds(
+                {py::ssize_t(count), py::ssize_t(maxOverlapsPerQuery)});
+            py::array_t<int> overlapCounts(py::ssize_t(count));
+            {
+              py::gil_scoped_release release;
+              self.queryBoxOverlaps(boxes, maxOverlapsPerQuery,
+                                    {objectIds.mutable_data(), slots},
+                                    {linkIds.mutable_data(), slots},
+                                    {overlapCounts.mutable_data(), count});
+            }
+            return py::make_tuple(objectIds, linkIds, overlapCounts);
+          },
+          "box_mins"_a, "box_maxs"_a, "max_overlaps_per_query"_a = 32,
+          R"(Find the objects overlapping a batch of axis-aligned boxes, given as [N, 3] min and max corner arrays, using the broadphase of the collision world. Returns a tuple of [N, max_overlaps_per_query] object ids and link ids, sorted and padded with -1, and the number of overlaps of each box. Link ids are -1 for rigid objects and articulated object bases. Objects are tested with their broadphase bounding boxes rather than exact shapes and the stage is never reported. Physics must be enabled.)")
+      .def(
+          "query_sphere_overlaps",
+          [](Simulator& self, const FloatArray& centers,
+             const FloatArray& radii, std::size_t maxOverlapsPerQuery) {
+            const auto centerView = vector3View(centers, "centers");
+            const std::size_t count = centerView.size();
+            if (radii.ndim() != 1 || std::size_t(radii.shape(0)) != count) {
+              throw std::runtime_error(
+                  "Expected radii to be an array of shape [N]");
+            }
+            const std::size_t slots = count * maxOverlapsPerQuery;
+            py::array_t<int> objectIds(
+                {py::ssize_t(count), py::ssize_t(maxOverlapsPerQuery)});
+            py::array_t<int> linkIds(
+                {py::ssize_t(count), py::ssize_t(maxOverlapsPerQuery)});
+            py::array_t<int> overlapCounts(py::ssize_t(count));
+            {
+              py::gil_scoped_release release;
+              self.querySphereOverlaps(
+                  centerView, {radii.data(), count}, maxOverlapsPerQuery,
+                  {objectIds.mutable_data(), slots},
+                  {linkIds.mutable_data(), slots},
+                  {overlapCounts.mutable_data(), count});
+            }
+            return py::make_tuple(objectIds, linkIds, overlapCounts);
+          },
+          "centers"_a, "radii"_a, "max_overlaps_per_query"_a = 32,
+          R"(Find the objects within radii of a batch of [N, 3] centers, like query_box_overlaps(). An object is reported if its broadphase bounding box comes within the radius of the center. Physics must be enabled.)")
+      .def(
+          "build_occupancy_grid", &Simulator::buildOccupancyGrid,
+          "voxel_size"_a, "stage_cache_filename"_a = "",
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Voxelize the collision geometry of the stage, rigid objects and articulated object links into an OccupancyGrid with one source per object or link id, the stage being source 0. If stage_cache_filename is given, the stage voxels are loaded from it when it was written with the same voxel size and saved to it otherwise.)")
+      .def(
+          "update_occupancy_grid", &Simulator::updateOccupancyGrid,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Voxelize objects and links that moved or were added since the last update again and remove removed ones from the occupancy grid.)")
+      .def_property_readonly(
+          "occupancy_grid", &Simulator::getOccupancyGrid,
+          R"(The occupancy grid built by build_occupancy_grid(), or None.)")
       .def("set_object_bb_draw", &Simulator::setObjectBBDraw, "draw_bb"_a,
            "object_id"_a,
            R"(Enable or disable bounding box visualization for an object.)")
       .def(
           "recompute_navmesh", &Simulator::recomputeNavMesh, "pathfinder"_a,
-          "navmesh_settings"_a,
+          "navmesh_settings"_a, py::call_guard<py::gil_scoped_release>(),
           R"(Recompute the NavMesh for a given PathFinder instance using configured NavMeshSettings.)")
+      .def(
+          "export_batch_renderer_composite",
+          &Simulator::exportBatchRendererComposite, "filename"_a,
+          "quantize_vertex_attributes"_a = false,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Write render assets of the stage, rigid objects and articulated objects into a single batch renderer composite file (.gltf or .glb) with deduplicated meshes and textures packed into texture arrays. Each asset is a node hierarchy named after its handle. Load it with preload_file() of a batch replay renderer. With quantize_vertex_attributes, normals, texture coordinates and vertex colors are stored in 16- and 8-bit formats using KHR_mesh_quantization, and stay that way on the GPU. Returns whether the file was written.)")
 
       .def(
           "add_trajectory_object",
@@ -327,6 +766,11 @@ void initSimBindings(py::module& m) {
           This can be used to reload the stage, objects, articulated
           objects and other values as they currently are.)",
           "overwrite"_a = false)
+      .def("wait_for_scene_config_saves",
+           &Simulator::waitForSceneInstanceSaves,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Wait until scene instance configs saved in the background are written.
+          Returns whether all of them were written successfully.)")
       .def("get_light_setup", &Simulator::getLightSetup,
            "key"_a = DEFAULT_LIGHTING_KEY,
            R"(Get a copy of the LightSetup registered with a specific key.)")
@@ -351,15 +795,221 @@ void initSimBindings(py::module& m) {
            R"(Get a copy of the settings for an existing rigid constraint.)")
       .def("remove_rigid_constraint", &Simulator::removeRigidConstraint,
            "constraint_id"_a, R"(Remove a rigid constraint by id.)")
+      .def(
+          "update_rigid_constraints",
+          [](Simulator& self, const IntArray& constraintIds,
+             const py::object& pivotsA, const py::object& pivotsB,
+             const py::object& framesA, const py::object& framesB,
+             const py::object& maxImpulses) {
+            // keep the converted arrays alive until the update is done
+            FloatArray pivotsAArray, pivotsBArray, maxImpulsesArray;
+            Corrade::Containers::ArrayView<const Mn::Vector3> pivotsAView,
+                pivotsBView;
+            Corrade::Containers::ArrayView<const float> maxImpulsesView;
+            if (!pivotsA.is_none()) {
+              pivotsAArray = py::cast<FloatArray>(pivotsA);
+              pivotsAView = vector3View(pivotsAArray, "pivots_a");
+            }
+            if (!pivotsB.is_none()) {
+              pivotsBArray = py::cast<FloatArray>(pivotsB);
+              pivotsBView = vector3View(pivotsBArray, "pivots_b");
+            }
+            if (!maxImpulses.is_none()) {
+              maxImpulsesArray = py::cast<FloatArray>(maxImpulses);
+              maxImpulsesView = {maxImpulsesArray.data(),
+                                 std::size_t(maxImpulsesArray.size())};
+            }
+            const std::vector<Mn::Matrix3x3> framesAArray =
+                matrix3x3Array(framesA, "frames_a");
+            const std::vector<Mn::Matrix3x3> framesBArray =
+                matrix3x3Array(framesB, "frames_b");
+            py::gil_scoped_release release;
+            self.updateRigidConstraints(
+                {constraintIds.data(), std::size_t(constraintIds.size())},
+                pivotsAView, pivotsBView,
+                {framesAArray.data(), framesAArray.size()},
+                {framesBArray.data(), framesBArray.size()}, maxImpulsesView);
+          },
+          "constraint_ids"_a, "pivots_a"_a = py::none(),
+          "pivots_b"_a = py::none(), "frames_a"_a = py::none(),
+          "frames_b"_a = py::none(), "max_impulses"_a = py::none(),
+          R"(Update the pivots ([N, 3] arrays), frames ([N, 3, 3] arrays of rotation matrices) and max impulses ([N] array) of N rigid constraints at once. Parameters left as None are kept unchanged. Object, link and type of the constraints can't be changed this way.)")
+      .def(
+          "get_rigid_constraint_forces",
+          [](Simulator& self, const IntArray& constraintIds) {
+            const std::size_t count = constraintIds.size();
+            py::array_t<float> forces(py::ssize_t(count));
+            {
+              py::gil_scoped_release release;
+              self.getRigidConstraintForces({constraintIds.data(), count},
+                                            {forces.mutable_data(), count});
+            }
+            return forces;
+          },
+          "constraint_ids"_a,
+          R"(Get the magnitude of the linear force each of the given rigid constraints applied during the last simulation substep, as an [N] array.)")
       .def(
           "get_runtime_perf_stat_names", &Simulator::getRuntimePerfStatNames,
           R"(Runtime perf stats are various scalars helpful for troubleshooting runtime perf. This can be called once at startup. See also get_runtime_perf_stat_values.)")
       .def(
           "get_runtime_perf_stat_values", &Simulator::getRuntimePerfStatValues,
           R"(Runtime perf stats are various scalars helpful for troubleshooting runtime perf. These values generally change after every sim step. See also get_runtime_perf_stat_names.)")
+      .def(
+          "get_memory_usage", &Simulator::getMemoryUsage,
+          R"(Estimated CPU and GPU memory held by each subsystem, as a dict of MemoryUsage keyed by "resources", "physics", "navmesh", "replay" and "observations".)")
       .def("get_debug_line_render", &Simulator::getDebugLineRender,
            pybind11::return_value_policy::reference,
-           R"(Get visualization helper for rendering lines.)");
+           R"(Get visualization helper for rendering lines.)")
+      .def(
+          "get_trajectory_render", &Simulator::getTrajectoryRender,
+          R"(Get the renderer drawing trajectories as tubes into color sensors. Unlike add_trajectory_object(), adding or extending a trajectory creates no objects, render assets or attributes.)")
+      .def(
+          "render_viewpoints",
+          [](Simulator& self, const FloatArray& cameraTransformations,
+             const sensor::CameraSensorSpec& spec) {
+            if (cameraTransformations.ndim() != 3 ||
+                cameraTransformations.shape(1) != 4 ||
+                cameraTransformations.shape(2) != 4) {
+              throw std::runtime_error(
+                  "Expected camera_transformations to be an array of shape "
+                  "[N, 4, 4]");
+            }
+            const std::size_t count = cameraTransformations.shape(0);
+            std::vector<Mn::Matrix4> transformations(count);
+            for (std::size_t i = 0; i != count; ++i) {
+              transformations[i] =
+                  Mn::Matrix4::from(cameraTransformations.data() + 16 * i)
+                      .transposed();
+            }
+
+            std::vector<py::ssize_t> shape{py::ssize_t(count),
+                                           spec.resolution[0],
+                                           spec.resolution[1]};
+            py::dtype dtype = py::dtype::of<uint8_t>();
+            if (spec.sensorType == sensor::SensorType::Semantic) {
+              dtype = spec.compactSemanticIds ? py::dtype::of<uint16_t>()
+                                              : py::dtype::of<uint32_t>();
+            } else if (spec.sensorType == sensor::SensorType::Depth) {
+              dtype = py::dtype::of<float>();
+            } else {
+              shape.push_back(4);
+            }
+            py::array images{dtype, std::move(shape)};
+            {
+              py::gil_scoped_release release;
+              self.renderViewpoints(
+                  transformations, spec,
+                  {static_cast<char*>(images.mutable_data()),
+                   std::size_t(images.nbytes())});
+            }
+            return images;
+          },
+          "camera_transformations"_a, "spec"_a,
+          R"(Render the active scene from a batch of [N, 4, 4] row-major world transformations of a camera described by spec, a color, depth or semantic CameraSensorSpec whose position and orientation are ignored. All views are drawn into tiles of one framebuffer and read back together, instead of setting an agent state and getting observations for each. Returns the images stacked along the first dimension, with rows top to bottom like get_observation().)");
+
+  // ==== BatchedSimulatorConfiguration ====
+  py::class_<BatchedSimulatorConfiguration,
+             BatchedSimulatorConfiguration::ptr>(
+      m, "BatchedSimulatorConfiguration")
+      .def(py::init(&BatchedSimulatorConfiguration::create<>))
+      .def_readwrite(
+          "sim_config", &BatchedSimulatorConfiguration::simConfig,
+          R"(The SimulatorConfiguration used to build every environment. Each environment's random seed is offset by its index.)")
+      .def_readwrite("num_environments",
+                     &BatchedSimulatorConfiguration::numEnvironments,
+                     R"(Number of concurrent environments to simulate.)")
+      .def_property(
+          "sensor_specifications",
+          [](const BatchedSimulatorConfiguration& self) {
+            return self.agentConfig.sensorSpecifications;
+          },
+          [](BatchedSimulatorConfiguration& self,
+             const std::vector<sensor::SensorSpec::ptr>& specs) {
+            self.agentConfig.sensorSpecifications = specs;
+          },
+          R"(List of sensor specifications of the agent created in each environment. All environments share the same specifications so observations can be stacked.)")
+      .def_readwrite(
+          "step_dt", &BatchedSimulatorConfiguration::stepDt,
+          R"(The timestep each environment's world is advanced by in step_all.)")
+      .def_readwrite(
+          "num_physics_threads",
+          &BatchedSimulatorConfiguration::numPhysicsThreads,
+          R"(Number of threads stepping the environments' worlds in parallel, 0 for one per hardware thread.)");
+
+  // ==== BatchedSimulator ====
+  py::class_<BatchedSimulator, BatchedSimulator::ptr>(m, "BatchedSimulator")
+      .def(py::init<const BatchedSimulatorConfiguration&,
+                    esp::metadata::MetadataMediator::ptr>(),
+           "configuration"_a, "metadata_mediator"_a = nullptr)
+      .def_property_readonly("num_environments",
+                             &BatchedSimulator::getNumEnvironments,
+                             R"(The number of environments in the batch.)")
+      .def_property_readonly(
+          "metadata_mediator", &BatchedSimulator::getMetadataMediator,
+          R"(The MetadataMediator shared by all environments.)")
+      .def("get_environment", &BatchedSimulator::getEnvironment,
+           "env_index"_a, py::return_value_policy::reference_internal,
+           R"(Get the Simulator of a single environment. PYTHON DOES NOT GET OWNERSHIP)")
+      .def("get_agent", &BatchedSimulator::getAgent, "env_index"_a,
+           R"(Get the agent of a single environment.)")
+      .def("reset", &BatchedSimulator::reset, R"(Reset all environments.)")
+      .def("reset_environment", &BatchedSimulator::resetEnvironment,
+           "env_index"_a, R"(Reset a single environment.)")
+      .def("seed", &BatchedSimulator::seed, "new_seed"_a,
+           R"(Seed all environments, offsetting the seed by environment index.)")
+      .def(
+          "step_all",
+          [](BatchedSimulator& self, const std::vector<std::string>& actions) {
+            const std::vector<BatchedSimulator::EnvironmentObservations>*
+                observations;
+            {
+              py::gil_scoped_release release;
+              observations = &self.stepAll(actions);
+            }
+            return stackBatchedObservations(*observations);
+          },
+          "actions"_a,
+          R"(Apply one action per environment (an empty string skips acting), step every world
+          by step_dt and return a dict mapping sensor uuid to a numpy array of the stacked
+          observations with shape [num_environments, *sensor_shape].)")
+      .def(
+          "step_all",
+          [](BatchedSimulator& self, const std::vector<int>& actionIds) {
+            const std::vector<BatchedSimulator::EnvironmentObservations>*
+                observations;
+            {
+              py::gil_scoped_release release;
+              observations = &self.stepAll(actionIds);
+            }
+            return stackBatchedObservations(*observations);
+          },
+          "action_ids"_a,
+          R"(Like step_all() with action names, but with the IDs returned by get_action_id(), which skip looking the actions up by name. A negative ID skips the action.)")
+      .def(
+          "get_action_id", &BatchedSimulator::getActionId, "action_name"_a,
+          R"(ID of an action for step_all(), shared by all environments, or -1 if there's no such action.)")
+      .def("step_worlds", &BatchedSimulator::stepWorlds, "dt"_a,
+           py::call_guard<py::gil_scoped_release>(),
+           R"(Step the physics of all environments by dt in parallel without acting or collecting observations. Releases the GIL for the whole batch.)")
+      .def(
+          "get_all_observations",
+          [](BatchedSimulator& self) {
+            return stackBatchedObservations(self.getAllObservations());
+          },
+          R"(Return the current stacked observations of all environments without acting or stepping.)")
+      .def(
+          "get_environment_observations",
+          [](BatchedSimulator& self, int envIndex) {
+            py::dict result;
+            for (const auto& entry :
+                 self.getEnvironmentObservations(envIndex)) {
+              result[py::str(entry.first)] =
+                  observationView(entry.second.buffer);
+            }
+            return result;
+          },
+          "env_index"_a,
+          R"(Return a dict mapping sensor uuid to the observations of one environment last collected by step_all() or get_all_observations(). The numpy arrays view the sensors' memory without copying, so they get overwritten by the next step; copy them to keep them.)");
 
   // ==== ReplayRendererConfiguration ====
   py::class_<ReplayRendererConfiguration, ReplayRendererConfiguration::ptr>(
@@ -377,12 +1027,28 @@ void initSimBindings(py::module& m) {
           R"(List of sensor specifications for one simulator. For batch rendering, all simulators must have the same specification.)")
       .def_readwrite("gpu_device_id", &ReplayRendererConfiguration::gpuDeviceId,
                      R"(The system GPU device to use for rendering)")
+      .def_readwrite(
+          "gpu_device_ids", &ReplayRendererConfiguration::gpuDeviceIds,
+          R"(CUDA devices to spread the environments across, batch renderer only. If not empty, gpu_device_id is ignored and each device renders an even share of the environments in its own GL context.)")
       .def_readwrite("enable_frustum_culling",
                      &ReplayRendererConfiguration::enableFrustumCulling,
                      R"(Controls whether frustum culling is enabled.)")
       .def_readwrite(
           "enable_hbao", &ReplayRendererConfiguration::enableHBAO,
           R"(Controls whether horizon-based ambient occlusion is enabled.)")
+      .def_readwrite(
+          "texture_memory_budget",
+          &ReplayRendererConfiguration::textureMemoryBudget,
+          R"(GPU texture memory budget in bytes, batch renderer only. If non-zero, textures with pre-made mip levels are streamed in for the environments that reference them and evicted when over the budget. 0 means unlimited.)")
+      .def_readwrite(
+          "draw_thread_count", &ReplayRendererConfiguration::drawThreadCount,
+          R"(Count of threads calculating transformations, culling and assigning lights per environment before drawing, batch renderer only. Uploads and draw submission stay on the rendering thread. 0 means one per hardware core.)")
+      .def_readwrite(
+          "depth_only", &ReplayRendererConfiguration::depthOnly,
+          R"(Render just depth, batch renderer only. Only vertex positions are fetched and there's no color output.)")
+      .def_readwrite(
+          "object_ids", &ReplayRendererConfiguration::objectIds,
+          R"(Output semantic IDs of all instances, batch renderer only. Retrieve them with cuda_object_id_image_view().)")
       .def_readwrite(
           "force_separate_semantic_scene_graph",
           &ReplayRendererConfiguration::forceSeparateSemanticSceneGraph,
@@ -393,6 +1059,57 @@ void initSimBindings(py::module& m) {
           &ReplayRendererConfiguration::leaveContextWithBackgroundRenderer,
           R"(See See tutorials/async_rendering.py.)");
 
+  // ==== CudaImageView ====
+  py::class_<CudaImageView>(
+      m, "CudaImageView",
+      R"(Image of a single environment in a CUDA buffer. Consumable without a
+      copy by any library supporting __cuda_array_interface__, such as
+      torch.as_tensor() or cupy.asarray(). Rows are ordered bottom-up, as
+      rendered. Valid until the next render.)")
+      .def_property_readonly(
+          "size",
+          [](const CudaImageView& self) {
+            return py::make_tuple(self.size.y(), self.size.x());
+          },
+          R"(Image height and width)")
+      .def_property_readonly(
+          "__cuda_array_interface__", [](const CudaImageView& self) {
+            if (!self.data)
+              throw py::value_error("the CUDA image view is empty");
+            py::dict out;
+            if (Mn::isPixelFormatDepthOrStencil(self.format)) {
+              /* The only depth format the batch renderer outputs */
+              CORRADE_INTERNAL_ASSERT(self.format ==
+                                      Mn::PixelFormat::Depth32F);
+              out["shape"] = py::make_tuple(self.size.y(), self.size.x());
+              out["strides"] = py::make_tuple(self.rowStride, 4);
+              out["typestr"] = "<f4";
+            } else if (self.format == Mn::PixelFormat::R32UI) {
+              /* Object IDs */
+              out["shape"] = py::make_tuple(self.size.y(), self.size.x());
+              out["strides"] = py::make_tuple(self.rowStride, 4);
+              out["typestr"] = "<u4";
+            } else {
+              /* Color is 8-bit normalized, one byte per channel */
+              const Mn::UnsignedInt channelCount =
+                  Mn::pixelFormatChannelCount(self.format);
+              CORRADE_INTERNAL_ASSERT(Mn::pixelFormatSize(self.format) ==
+                                      channelCount);
+              out["shape"] =
+                  py::make_tuple(self.size.y(), self.size.x(), channelCount);
+              out["strides"] = py::make_tuple(self.rowStride, channelCount, 1);
+              out["typestr"] = "|u1";
+            }
+            out["data"] =
+                py::make_tuple(reinterpret_cast<std::uintptr_t>(self.data),
+                               true);
+            /* The buffers are ready on the legacy default stream, consumers
+               synchronize their own stream with it */
+            out["stream"] = 1;
+            out["version"] = 3;
+            return out;
+          });
+
   // ==== ReplayRenderer ====
   py::class_<AbstractReplayRenderer, AbstractReplayRenderer::ptr>(
       m, "ReplayRenderer")
@@ -444,6 +1161,26 @@ void initSimBindings(py::module& m) {
           The images are required to be pre-allocated.)",
           py::arg("color_images") = std::vector<Mn::MutableImageView2D>{},
           py::arg("depth_images") = std::vector<Mn::MutableImageView2D>{})
+      .def("render_async", &AbstractReplayRenderer::renderAsync,
+           R"(Submit rendering of all environments without waiting for the GPU.
+          Keyframes and sensor transforms set afterwards only affect the next
+          frame. Up to two frames can be in flight, retrieve them in order
+          with wait_frame(). Only supported by the batch renderer.)")
+      .def(
+          "wait_frame",
+          [](AbstractReplayRenderer& self,
+             std::vector<Mn::MutableImageView2D> colorImageViews,
+             std::vector<Mn::MutableImageView2D> depthImageViews) {
+            self.waitFrame(colorImageViews, depthImageViews);
+          },
+          R"(Wait for the oldest frame submitted with render_async() and copy
+          it into the specified image vectors, same as render().)",
+          py::arg("color_images") = std::vector<Mn::MutableImageView2D>{},
+          py::arg("depth_images") = std::vector<Mn::MutableImageView2D>{})
+      .def_property_readonly(
+          "frames_in_flight", &AbstractReplayRenderer::framesInFlight,
+          R"(Count of frames submitted with render_async() and not yet
+          retrieved with wait_frame().)")
       .def(
           "set_sensor_transforms_from_keyframe",
           &AbstractReplayRenderer::setSensorTransformsFromKeyframe,
@@ -453,6 +1190,18 @@ void initSimBindings(py::module& m) {
       .def("set_environment_keyframe",
            &AbstractReplayRenderer::setEnvironmentKeyframe,
            R"(Set the keyframe for a specific environment.)")
+      .def(
+          "set_environment_keyframes",
+          [](AbstractReplayRenderer& self,
+             const std::vector<std::string>& keyframes) {
+            self.setEnvironmentKeyframes({keyframes.data(), keyframes.size()});
+          },
+          R"(Set the keyframes of all environments at once, one per environment. The keyframes are decoded and applied in parallel where possible.)")
+      .def(
+          "consume_environment_keyframes",
+          &AbstractReplayRenderer::consumeEnvironmentKeyframes, "env_index"_a,
+          "buffer"_a,
+          R"(Apply all keyframes pending in a gfx.replay.KeyframeRingBuffer to an environment, in order. Returns the number of keyframes applied.)")
       .def_static(
           "environment_grid_size", &AbstractReplayRenderer::environmentGridSize,
           R"(Get the dimensions (tile counts) of the environment grid.)")
@@ -465,9 +1214,43 @@ void initSimBindings(py::module& m) {
       .def(
           "cuda_depth_buffer_device_pointer",
           [](AbstractReplayRenderer& self) {
-            return py::capsule(self.getCudaColorBufferDevicePointer());
+            return py::capsule(self.getCudaDepthBufferDevicePointer());
           },
           R"(Retrieve the depth buffer as a CUDA device pointer.)")
+      .def(
+          "cuda_object_id_buffer_device_pointer",
+          [](AbstractReplayRenderer& self) {
+            return py::capsule(self.getCudaObjectIdBufferDevicePointer());
+          },
+          R"(Retrieve the object ID buffer as a CUDA device pointer.)")
+      .def("cuda_color_image_view",
+           &AbstractReplayRenderer::getCudaColorImageView,
+           R"(Retrieve the color image of an environment as a CUDA image
+           view, see CudaImageView.)",
+           py::arg("env_index"), py::keep_alive<0, 1>())
+      .def("cuda_depth_image_view",
+           &AbstractReplayRenderer::getCudaDepthImageView,
+           R"(Retrieve the raw depth image of an environment as a CUDA image
+           view, see CudaImageView.)",
+           py::arg("env_index"), py::keep_alive<0, 1>())
+      .def("cuda_object_id_image_view",
+           &AbstractReplayRenderer::getCudaObjectIdImageView,
+           R"(Retrieve the object ID image of an environment as a CUDA image
+           view, see CudaImageView. Requires object_ids to be enabled in the
+           configuration.)",
+           py::arg("env_index"), py::keep_alive<0, 1>())
+      .def(
+          "wait_for_cuda_images",
+          [](AbstractReplayRenderer& self, unsigned envIndex,
+             std::uintptr_t stream) {
+            self.waitForCudaImages(envIndex, reinterpret_cast<void*>(stream));
+          },
+          R"(Make a CUDA stream, given as a raw cudaStream_t handle such as
+          torch.cuda.current_stream().cuda_stream, wait until the CUDA
+          images of an environment are ready. Doesn't block the CPU or other
+          streams. Not needed when consuming through
+          __cuda_array_interface__, which synchronizes on its own.)",
+          py::arg("env_index"), py::arg("stream"))
       .def("debug_line_render", &AbstractReplayRenderer::getDebugLineRender,
            R"(Get visualization helper for rendering lines.)")
       .def("unproject", &AbstractReplayRenderer::unproject,
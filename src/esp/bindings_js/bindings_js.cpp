@@ -47,6 +47,48 @@ em::val Observation_getData(Observation& obs) {
   }
 }
 
+/**
+ * @brief RGBA image of the navigable area, with navigable pixels white and
+ * the rest transparent.
+ *
+ * Owns its pixels in the Emscripten heap, so @ref getData() returns a view
+ * instead of a copy. Reusing an instance across calls to
+ * @ref PathFinder_getTopDownMap() reuses the allocation.
+ */
+struct TopDownMapImage {
+  std::vector<uint8_t> data;
+  int width = 0;
+  int height = 0;
+};
+
+em::val TopDownMapImage_getData(TopDownMapImage& image) {
+  return em::val(em::typed_memory_view(image.data.size(), image.data.data()));
+}
+
+/**
+ * @brief Rasterize the navmesh slice at @p height into @p image, with X
+ * along image rows, or Z if @p transpose is set.
+ */
+void PathFinder_getTopDownMap(PathFinder& pathFinder,
+                              TopDownMapImage& image,
+                              float metersPerPixel,
+                              float height,
+                              bool transpose) {
+  const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> view =
+      pathFinder.getTopDownView(metersPerPixel, height, 0.5f, true);
+  image.width = int(transpose ? view.rows() : view.cols());
+  image.height = int(transpose ? view.cols() : view.rows());
+  image.data.assign(std::size_t(image.width) * image.height * 4, 0);
+  uint8_t* pixel = image.data.data();
+  for (int y = 0; y != image.height; ++y) {
+    for (int x = 0; x != image.width; ++x, pixel += 4) {
+      if (transpose ? view(x, y) : view(y, x)) {
+        pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0xff;
+      }
+    }
+  }
+}
+
 ObservationSpace Simulator_getAgentObservationSpace(Simulator& sim,
                                                     int agentId,
                                                     std::string sensorId) {
@@ -139,6 +181,22 @@ bool isBuildWithBulletPhysics() {
 #endif
 }
 
+bool isBuildWithThreads() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool isBuildWithSimd() {
+#ifdef __wasm_simd128__
+  return true;
+#else
+  return false;
+#endif
+}
+
 EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
   em::class_<LoggingContext>("LoggingContext");
   em::constant("_loggingContext", std::make_shared<LoggingContext>());
@@ -148,6 +206,8 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
   em::function("toVec4f", &toVec4f);
   em::function("loadAllObjectConfigsFromPath", &loadAllObjectConfigsFromPath);
   em::function("isBuildWithBulletPhysics", &isBuildWithBulletPhysics);
+  em::function("isBuildWithThreads", &isBuildWithThreads);
+  em::function("isBuildWithSimd", &isBuildWithSimd);
 
   em::register_vector<SensorSpec::ptr>("VectorSensorSpec");
   em::register_vector<size_t>("VectorSizeT");
@@ -277,14 +337,29 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .smart_ptr<Recorder::ptr>("Recorder::ptr")
       .function("saveKeyframe", &Recorder::saveKeyframe)
       .function("getLatestKeyframe", &Recorder::getLatestKeyframe)
-      .function("keyframeToString", &Recorder::keyframeToString);
+      .function("keyframeToString", &Recorder::keyframeToString)
+      .function("setStateUpdateFilter", &Recorder::setStateUpdateFilter)
+      .function("setRegionOfInterest", &Recorder::setRegionOfInterest)
+      .function("clearRegionOfInterest", &Recorder::clearRegionOfInterest);
+
+  em::value_object<StateUpdateFilter>("StateUpdateFilter")
+      .field("minTranslation", &StateUpdateFilter::minTranslation)
+      .field("minRotation", &StateUpdateFilter::minRotation)
+      .field("minKeyframeInterval", &StateUpdateFilter::minKeyframeInterval);
 
   em::class_<Keyframe>("Keyframe").smart_ptr<Keyframe::ptr>("Keyframe::ptr");
 
   em::class_<PathFinder>("PathFinder")
       .smart_ptr<PathFinder::ptr>("PathFinder::ptr")
       .property("bounds", &PathFinder::bounds)
-      .function("isNavigable", &PathFinder::isNavigable);
+      .function("isNavigable", &PathFinder::isNavigable)
+      .function("getTopDownMap", &PathFinder_getTopDownMap);
+
+  em::class_<TopDownMapImage>("TopDownMapImage")
+      .constructor<>()
+      .property("width", &TopDownMapImage::width)
+      .property("height", &TopDownMapImage::height)
+      .function("getData", &TopDownMapImage_getData);
 
   em::enum_<SensorType>("SensorType")
       .value("NONE", SensorType::None)
@@ -453,6 +528,7 @@ EMSCRIPTEN_BINDINGS(habitat_sim_bindings_js) {
       .function("getAgentObservationSpace", &Simulator_getAgentObservationSpace)
       .function("getAgent", &Simulator::getAgent)
       .function("getPathFinder", &Simulator::getPathFinder)
+      .function("replaceRenderAsset", &Simulator::replaceRenderAsset)
       .function("addAgent",
                 em::select_overload<Agent::ptr(const AgentConfiguration&)>(
                     &Simulator::addAgent))
@@ -33,7 +33,14 @@ Module.preRun.push(() => {
   buildConfigFromURLParameters(config);
   window.config = config;
   const scene = config.scene;
-  Module.scene = preload(scene);
+  if (config.preview) {
+    // start with the low-detail variant, the full scene is streamed in once
+    // the demo runs
+    Module.scene = preload(config.preview);
+    Module.fullScene = scene;
+  } else {
+    Module.scene = preload(scene);
+  }
 
   Module.physicsConfigFile = preload(defaultPhysicsConfigFilepath);
 
@@ -89,6 +89,18 @@ class SimEnv {
     return this.sim.getPathFinder();
   }
 
+  /**
+   * Swap the meshes and textures of a loaded asset, such as the stage, for
+   * those of a more detailed variant.
+   * @param {string} filepath - loaded asset
+   * @param {string} replacementFilepath - variant with the same meshes and
+   * textures in the same order
+   * @returns {boolean} whether the variant got swapped in
+   */
+  replaceRenderAsset(filepath, replacementFilepath) {
+    return this.sim.replaceRenderAsset(filepath, replacementFilepath);
+  }
+
   /**
    * Display an observation from the given sensorId
    * to canvas selected as default frame buffer.
@@ -2,6 +2,8 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+/*global Module */
+
 import { throttle } from "./utils";
 
 /**
@@ -26,6 +28,7 @@ class TopDownMap {
     this.ctx.strokeStyle = "blue";
     this.ctx.lineWidth = 3;
     this.currentY = -Infinity;
+    this.mapImage = new Module.TopDownMapImage();
   }
 
   /**
@@ -102,14 +105,12 @@ class TopDownMap {
   }
 
   /*
-   * Produces map using a regular grid sampling of navigability.
+   * Produces map by rasterizing the navmesh in C++.
    */
   createMap() {
     const canvas = this.canvas;
     let width = this.bounds.max[0] - this.bounds.min[0];
     let height = this.bounds.max[2] - this.bounds.min[2];
-    let heightInPixels = 0;
-    let widthInPixels = 0;
 
     // Best-Fit: orient and scale for tightest fit
     if (
@@ -125,40 +126,22 @@ class TopDownMap {
     if (height / width > canvas.height / canvas.width) {
       // Fit height
       this.scale = canvas.height / height;
-      heightInPixels = canvas.height;
-      widthInPixels = Math.round(width * this.scale - 0.5);
     } else {
       // Fit width
       this.scale = canvas.width / width;
-      widthInPixels = canvas.width;
-      heightInPixels = Math.round(height * this.scale - 0.5);
     }
 
-    let imageData = new ImageData(widthInPixels, heightInPixels);
-
-    // Create map by painting navigable locations white
-    const stride = 4 * canvas.width;
-    const increment = 1 / this.scale;
-    const color = 0xffffffff;
-    let y = this.bounds.min[this.heightComponent] + increment / 2;
-    let i, j;
-    for (i = 0; i < heightInPixels; i++) {
-      let x = this.bounds.min[this.widthComponent] + increment / 2;
-      for (j = 0; j < widthInPixels; j++) {
-        let point = [0, this.currentY, 0];
-        point[this.widthComponent] = x;
-        point[this.heightComponent] = y;
-        let isNavigable = this.pathFinder.isNavigable(point, 0.5);
-        if (isNavigable) {
-          imageData.data[i * stride + j * 4] = (color >> 24) & 0xff;
-          imageData.data[i * stride + j * 4 + 1] = (color >> 16) & 0xff;
-          imageData.data[i * stride + j * 4 + 2] = (color >> 8) & 0xff;
-          imageData.data[i * stride + j * 4 + 3] = color & 0xff;
-        }
-        x += increment;
-      }
-      y += increment;
-    }
+    // X goes along image rows unless the components were swapped above
+    this.pathFinder.getTopDownMap(
+      this.mapImage,
+      1 / this.scale,
+      this.currentY,
+      this.widthComponent === 2
+    );
+    let imageData = new ImageData(this.mapImage.width, this.mapImage.height);
+    // the view points into the Emscripten heap, which may be shared with
+    // worker threads, so it's copied into the canvas-owned buffer right away
+    imageData.data.set(this.mapImage.getData());
     return imageData;
   }
 }
@@ -8,6 +8,56 @@
  * Given a path to a file, load it into the file system for the page.
  */
 export function preload(url) {
+  const [parent, file] = createFileParents(url);
+  FS.createPreloadedFile(parent, file, url, true, false);
+  return parent + file;
+}
+
+/**
+ * Download a file into the file system for the page while the simulator
+ * already runs, unlike preload() which blocks startup until it's done.
+ * @param {string} url - file to download
+ * @param {function} onProgress - called with the fraction downloaded so far,
+ * if the server reports the file size
+ * @returns {Promise<string>} path of the file in the file system
+ */
+export async function stream(url, onProgress = () => {}) {
+  const response = await fetch(url);
+  if (!response.ok) {
+    throw new Error(`Can't download ${url}: ${response.status}`);
+  }
+  const total = Number(response.headers.get("Content-Length")) || 0;
+  const reader = response.body.getReader();
+  const chunks = [];
+  let size = 0;
+  for (;;) {
+    const { done, value } = await reader.read();
+    if (done) {
+      break;
+    }
+    chunks.push(value);
+    size += value.length;
+    if (total) {
+      onProgress(size / total);
+    }
+  }
+
+  const data = new Uint8Array(size);
+  let offset = 0;
+  for (const chunk of chunks) {
+    data.set(chunk, offset);
+    offset += chunk.length;
+  }
+  const [parent, file] = createFileParents(url);
+  FS.writeFile(parent + file, data);
+  return parent + file;
+}
+
+/**
+ * Create the directories a file downloaded from url is put in, returns the
+ * parent directory and the file name.
+ */
+function createFileParents(url) {
   let file_parents_str = "/";
   const splits = url.split("/");
   let file = splits[splits.length - 1];
@@ -21,8 +71,7 @@ export function preload(url) {
       file_parents_str += "/";
     }
   }
-  FS.createPreloadedFile(file_parents_str, file, url, true, false);
-  return file_parents_str + file;
+  return [file_parents_str, file];
 }
 
 /**
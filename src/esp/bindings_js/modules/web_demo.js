@@ -11,7 +11,7 @@ import {
 import SimEnv from "./simenv_embind";
 import TopDownMap from "./topdown";
 import NavigateTask from "./navigate";
-import { buildConfigFromURLParameters } from "./utils";
+import { buildConfigFromURLParameters, stream } from "./utils";
 
 class WebDemo {
   currentResolution = defaultResolution;
@@ -57,6 +57,34 @@ class WebDemo {
 
     this.task.init();
     this.task.reset();
+
+    if (Module.fullScene) {
+      this.streamFullScene(Module.scene, Module.fullScene);
+    }
+  }
+
+  /**
+   * Download the full-detail scene in the background and swap it in place of
+   * the low-detail variant the demo started with.
+   * @param {string} previewPath - path of the loaded low-detail variant
+   * @param {string} url - full-detail scene
+   */
+  async streamFullScene(previewPath, url) {
+    try {
+      const path = await stream(url, fraction => {
+        this.task.setStatus(
+          `Loading full detail ${Math.round(fraction * 100)}%`
+        );
+      });
+      if (this.simenv.replaceRenderAsset(previewPath, path)) {
+        this.task.setStatus("Ready");
+      } else {
+        this.task.setWarningStatus("Full detail doesn't match the preview");
+      }
+    } catch (e) {
+      this.task.setWarningStatus(`Full detail not loaded: ${e.message}`);
+    }
+    this.task.render();
   }
 
   updateAgentConfigWithSensors(agentConfig = defaultAgentConfig) {
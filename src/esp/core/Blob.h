@@ -0,0 +1,152 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_BLOB_H_
+#define ESP_CORE_BLOB_H_
+
+/** @file
+ * @brief Class @ref esp::core::BlobWriter, Class @ref esp::core::BlobReader
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Check.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Appends trivially copyable values to an in-memory binary blob.
+ *
+ * Values are stored with their native size and byte order, so blobs are only
+ * meant to be read back by the same build on the same machine, e.g. to
+ * snapshot and restore state within a process.
+ */
+class BlobWriter {
+ public:
+  /**
+   * @brief Constructor.
+   * @param data The blob to append to. Must outlive the writer.
+   */
+  explicit BlobWriter(std::vector<char>& data) : data_(data) {}
+
+  /**
+   * @brief Append a single value.
+   */
+  template <typename T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BlobWriter::write() requires a trivially copyable type");
+    append(&value, sizeof(T));
+  }
+
+  /**
+   * @brief Append a size-prefixed array of values.
+   */
+  template <typename T>
+  void writeArray(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BlobWriter::writeArray() requires a trivially copyable type");
+    write<uint32_t>(values.size());
+    append(values.data(), values.size() * sizeof(T));
+  }
+
+  /**
+   * @brief Append a size-prefixed string.
+   */
+  void writeString(const std::string& value) {
+    write<uint32_t>(value.size());
+    append(value.data(), value.size());
+  }
+
+ private:
+  void append(const void* src, std::size_t size) {
+    if (size == 0) {
+      return;
+    }
+    const std::size_t offset = data_.size();
+    data_.resize(offset + size);
+    std::memcpy(data_.data() + offset, src, size);
+  }
+
+  std::vector<char>& data_;
+};
+
+/**
+ * @brief Reads back values written by a @ref BlobWriter, in the same order.
+ *
+ * Reading past the end of the blob is a fatal runtime error.
+ */
+class BlobReader {
+ public:
+  /**
+   * @brief Constructor.
+   * @param data The blob to read from. Must outlive the reader.
+   */
+  explicit BlobReader(const std::vector<char>& data) : data_(data) {}
+
+  /**
+   * @brief Read a single value.
+   */
+  template <typename T>
+  T read() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BlobReader::read() requires a trivially copyable type");
+    T value;
+    extract(&value, sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Read a size-prefixed array of values.
+   */
+  template <typename T>
+  std::vector<T> readArray() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BlobReader::readArray() requires a trivially copyable type");
+    std::vector<T> values(read<uint32_t>());
+    extract(values.data(), values.size() * sizeof(T));
+    return values;
+  }
+
+  /**
+   * @brief Read a size-prefixed string.
+   */
+  std::string readString() {
+    std::string value(read<uint32_t>(), '\0');
+    extract(&value[0], value.size());
+    return value;
+  }
+
+  /**
+   * @brief Whether every byte of the blob has been read.
+   */
+  bool atEnd() const { return offset_ == data_.size(); }
+
+ private:
+  void extract(void* dst, std::size_t size) {
+    ESP_CHECK(size <= data_.size() - offset_,
+              "BlobReader : attempted to read" << size << "bytes at offset"
+                                                << offset_
+                                                << "past the end of a blob of"
+                                                << data_.size() << "bytes.");
+    if (size == 0) {
+      return;
+    }
+    std::memcpy(dst, data_.data() + offset_, size);
+    offset_ += size;
+  }
+
+  const std::vector<char>& data_;
+  std::size_t offset_ = 0;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_BLOB_H_
@@ -6,6 +6,10 @@
 
 #include <cstring>
 
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
 namespace esp {
 namespace core {
 
@@ -45,8 +49,21 @@ void Buffer::alloc() {
   }
   if (size != this->totalSize) {
     this->totalSize = size;
-    this->data = Corrade::Containers::Array<uint8_t>{
-        size * getDataTypeByteSize(dataType)};
+    const size_t byteSize = size * getDataTypeByteSize(dataType);
+#ifdef ESP_BUILD_WITH_CUDA
+    void* pinnedData = nullptr;
+    if (this->pinned && byteSize &&
+        cudaMallocHost(&pinnedData, byteSize) == cudaSuccess) {
+      // zero-initialized like the pageable allocation below
+      std::memset(pinnedData, 0, byteSize);
+      this->data = Corrade::Containers::Array<uint8_t>{
+          static_cast<uint8_t*>(pinnedData), byteSize,
+          [](uint8_t* ptr, size_t) { cudaFreeHost(ptr); }};
+      return;
+    }
+#endif
+    this->pinned = false;
+    this->data = Corrade::Containers::Array<uint8_t>{byteSize};
   }
 }
 
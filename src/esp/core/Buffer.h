@@ -35,8 +35,18 @@ enum class DataType {
 class Buffer {
  public:
   explicit Buffer() = default;
-  explicit Buffer(const std::vector<size_t>& shape, const DataType dataType)
-      : dataType(dataType), shape(shape) {
+  /**
+   * @brief Allocate a buffer of @p shape
+   * @param shape       Number of elements along each dimension
+   * @param dataType    Type of the elements
+   * @param pinned      Allocate @ref data in page-locked host memory, so it
+   *    can be copied to a GPU asynchronously. Falls back to pageable memory
+   *    in builds without CUDA or if the allocation fails, see @ref pinned.
+   */
+  explicit Buffer(const std::vector<size_t>& shape,
+                  const DataType dataType,
+                  bool pinned = false)
+      : dataType(dataType), shape(shape), pinned(pinned) {
     alloc();
   }
   void clear();
@@ -51,6 +61,11 @@ class Buffer {
   size_t totalSize = 0;
   DataType dataType = DataType::DT_UINT8;
   std::vector<size_t> shape;
+  /**
+   * @brief Whether @ref data is in page-locked host memory. Set to request
+   * it before allocating, reset if the memory couldn't be pinned.
+   */
+  bool pinned = false;
 
   ESP_SMART_POINTERS(Buffer)
 };
@@ -6,6 +6,7 @@
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <algorithm>
 #include "esp/core/Check.h"
 #include "esp/io/Json.h"
 
@@ -648,13 +649,21 @@ template <>
 std::shared_ptr<Configuration> Configuration::editSubconfig<Configuration>(
     const std::string& name) {
   // retrieve existing (or create new) subgroup, with passed name
-  return addSubgroup(name);
+  std::shared_ptr<Configuration> subgroup = addSubgroup(name);
+  editedSubconfigs_.insert(name);
+  return subgroup;
 }
 
 template <>
 void Configuration::setSubconfigPtr<Configuration>(
     const std::string& name,
     std::shared_ptr<Configuration>& configPtr) {
+  // only safe to share with copies if nobody else holds the pointer
+  if (configPtr.use_count() > 1) {
+    editedSubconfigs_.insert(name);
+  } else {
+    editedSubconfigs_.erase(name);
+  }
   configMap_[name] = std::move(configPtr);
 }  // setSubconfigPtr
 
@@ -701,13 +710,51 @@ std::vector<std::string> Configuration::findValue(
   return breadcrumbs;
 }
 
+void Configuration::copySubconfigsFrom(const Configuration& otr) {
+  for (const auto& entry : otr.configMap_) {
+    // shared until either configuration edits it, see addSubgroup()
+    if (isShareable(entry.second) &&
+        otr.editedSubconfigs_.count(entry.first) == 0) {
+      configMap_.emplace_hint(configMap_.end(), entry.first, entry.second);
+    } else {
+      configMap_.emplace_hint(configMap_.end(), entry.first,
+                              std::make_shared<Configuration>(*entry.second));
+    }
+  }
+}  // Configuration::copySubconfigsFrom
+
+std::size_t ConfigValueMap::findIndex(const ConfigKey& key) const {
+  auto hashIter = std::lower_bound(hashes_.begin(), hashes_.end(), key.hash());
+  // keys with the same hash are adjacent, compare each of them
+  for (; hashIter != hashes_.end() && *hashIter == key.hash(); ++hashIter) {
+    const std::size_t index = hashIter - hashes_.begin();
+    if (key.matches(entries_[index].first)) {
+      return index;
+    }
+  }
+  return entries_.size();
+}  // ConfigValueMap::findIndex
+
+ConfigValue& ConfigValueMap::operator[](const ConfigKey& key) {
+  const std::size_t index = findIndex(key);
+  if (index != entries_.size()) {
+    return entries_[index].second;
+  }
+  const std::size_t insertIndex =
+      std::upper_bound(hashes_.begin(), hashes_.end(), key.hash()) -
+      hashes_.begin();
+  hashes_.insert(hashes_.begin() + insertIndex, key.hash());
+  return entries_
+      .emplace(entries_.begin() + insertIndex, key.str(), ConfigValue{})
+      ->second;
+}  // ConfigValueMap::operator[]
+
 Configuration& Configuration::operator=(const Configuration& otr) {
   if (this != &otr) {
     configMap_.clear();
+    editedSubconfigs_.clear();
     valueMap_ = otr.valueMap_;
-    for (const auto& entry : otr.configMap_) {
-      configMap_[entry.first] = std::make_shared<Configuration>(*entry.second);
-    }
+    copySubconfigsFrom(otr);
   }
   return *this;
 }
@@ -9,8 +9,13 @@
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Magnum.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
+#include <vector>
 
 #include "esp/core/Check.h"
 #include "esp/core/Esp.h"
@@ -429,17 +434,161 @@ class ConfigValue {
  */
 MAGNUM_EXPORT Mn::Debug& operator<<(Mn::Debug& debug, const ConfigValue& value);
 
+/**
+ * @brief Key of a value in a @ref Configuration, along with its hash.
+ *
+ * Only references the string it's made from. The constructors are
+ * @cpp constexpr @ce, so keys made from string literals, as used by all the
+ * attributes getters, are hashed at compile time, and looking them up needs
+ * neither a @ref std::string nor hashing at runtime.
+ */
+class ConfigKey {
+ public:
+  /** @brief Construct from a null-terminated string */
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr ConfigKey(const char* key)
+      : data_{key}, size_{length(key)}, hash_{hashOf(key, size_)} {}
+
+  /** @brief Construct from a @ref std::string, which has to outlive it */
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  ConfigKey(const std::string& key)
+      : data_{key.data()},
+        size_{key.size()},
+        hash_{hashOf(key.data(), key.size())} {}
+
+  /** @brief The key's characters, not necessarily null-terminated */
+  constexpr const char* data() const { return data_; }
+
+  /** @brief Number of characters in the key */
+  constexpr std::size_t size() const { return size_; }
+
+  /** @brief FNV-1a hash of the key */
+  constexpr std::uint64_t hash() const { return hash_; }
+
+  /** @brief Copy of the key, e.g. for storing or printing it */
+  std::string str() const { return {data_, size_}; }
+
+  /** @brief Whether this key is the same as @p key */
+  bool matches(const std::string& key) const {
+    return key.size() == size_ && std::memcmp(key.data(), data_, size_) == 0;
+  }
+
+ private:
+  static constexpr std::size_t length(const char* key) {
+    std::size_t size = 0;
+    while (key[size] != '\0') {
+      ++size;
+    }
+    return size;
+  }
+
+  static constexpr std::uint64_t hashOf(const char* key, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i != size; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(key[i])) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  const char* data_;
+  std::size_t size_;
+  std::uint64_t hash_;
+};
+
+/**
+ * @brief Storage of the values of a @ref Configuration.
+ *
+ * Keeps the values in a single array, ordered by the hash of their keys, with
+ * the hashes in a separate array so lookups binary-search a contiguous range
+ * of integers and only compare the key string of the entry found. Values are
+ * few per configuration, so inserting into the middle is cheap, while
+ * lookups are by far the most common operation. Provides the subset of the
+ * @ref std::unordered_map interface @ref Configuration uses.
+ */
+class ConfigValueMap {
+ public:
+  /** @brief Stored key and value */
+  typedef std::pair<std::string, ConfigValue> value_type;
+  /** @brief Iterator */
+  typedef std::vector<value_type>::iterator iterator;
+  /** @brief Const iterator */
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  /** @brief Iterator to the first entry */
+  iterator begin() { return entries_.begin(); }
+  /** @brief Iterator past the last entry */
+  iterator end() { return entries_.end(); }
+  /** @brief Iterator to the first entry */
+  const_iterator begin() const { return entries_.begin(); }
+  /** @brief Iterator past the last entry */
+  const_iterator end() const { return entries_.end(); }
+  /** @brief Const iterator to the first entry */
+  const_iterator cbegin() const { return entries_.cbegin(); }
+  /** @brief Const iterator past the last entry */
+  const_iterator cend() const { return entries_.cend(); }
+
+  /** @brief Number of entries */
+  std::size_t size() const { return entries_.size(); }
+
+  /** @brief Whether there are no entries */
+  bool empty() const { return entries_.empty(); }
+
+  /** @brief Entry with @p key, or @ref end() */
+  iterator find(const ConfigKey& key) {
+    return entries_.begin() + findIndex(key);
+  }
+
+  /** @brief Entry with @p key, or @ref end() */
+  const_iterator find(const ConfigKey& key) const {
+    return entries_.begin() + findIndex(key);
+  }
+
+  /** @brief 1 if there is an entry with @p key, 0 otherwise */
+  std::size_t count(const ConfigKey& key) const {
+    return findIndex(key) != entries_.size() ? 1 : 0;
+  }
+
+  /** @brief Value with @p key, default-constructed first if not present */
+  ConfigValue& operator[](const ConfigKey& key);
+
+  /** @brief Remove the entry at @p pos */
+  iterator erase(const_iterator pos) {
+    hashes_.erase(hashes_.begin() + (pos - entries_.cbegin()));
+    return entries_.erase(pos);
+  }
+
+  /** @brief Remove all entries */
+  void clear() {
+    entries_.clear();
+    hashes_.clear();
+  }
+
+ private:
+  /** @brief Index of the entry with @p key, or @ref size() if not found */
+  std::size_t findIndex(const ConfigKey& key) const;
+
+  std::vector<value_type> entries_;
+  // hash of the key of each entry, sorted
+  std::vector<std::uint64_t> hashes_;
+};
+
 /**
  * @brief This class holds configuration data in a map of ConfigValues, and
  * also supports nested configurations via a map of smart pointers to this
  * type.
+ *
+ * Copies share the subconfigurations of the original until either of them
+ * edits one, at which point it gets its own copy of it. Subconfigurations
+ * whose pointer was handed out for editing, through @ref editSubconfig or
+ * @ref setSubconfigPtr, are always copied, as they may be changed through
+ * that pointer at any time.
  */
 class Configuration {
  public:
   /**
    * @brief Convenience typedef for the value map
    */
-  typedef std::unordered_map<std::string, ConfigValue> ValueMapType;
+  typedef ConfigValueMap ValueMapType;
   /**
    * @brief Convenience typedef for the subconfiguration map
    */
@@ -455,9 +604,7 @@ class Configuration {
    */
   Configuration(const Configuration& otr)
       : configMap_(), valueMap_(otr.valueMap_) {
-    for (const auto& entry : otr.configMap_) {
-      configMap_[entry.first] = std::make_shared<Configuration>(*entry.second);
-    }
+    copySubconfigsFrom(otr);
   }  // copy ctor
 
   /**
@@ -465,7 +612,8 @@ class Configuration {
    */
   Configuration(Configuration&& otr) noexcept
       : configMap_(std::move(otr.configMap_)),
-        valueMap_(std::move(otr.valueMap_)) {}  // move ctor
+        valueMap_(std::move(otr.valueMap_)),
+        editedSubconfigs_(std::move(otr.editedSubconfigs_)) {}  // move ctor
 
   // virtual destructor set to that pybind11 recognizes attributes inheritance
   // from configuration to be polymorphic
@@ -489,12 +637,12 @@ class Configuration {
    * @return ConfigValue specified by key. If none exists, will be empty
    * ConfigValue, with type @ref ConfigValType::Unknown
    */
-  ConfigValue get(const std::string& key) const {
+  ConfigValue get(const ConfigKey& key) const {
     ValueMapType::const_iterator mapIter = valueMap_.find(key);
     if (mapIter != valueMap_.end()) {
       return mapIter->second;
     }
-    ESP_WARNING() << "Key :" << key << "not present in configuration";
+    ESP_WARNING() << "Key :" << key.str() << "not present in configuration";
     return {};
   }
 
@@ -509,14 +657,14 @@ class Configuration {
    * default value.
    */
   template <typename T>
-  T get(const std::string& key) const {
+  T get(const ConfigKey& key) const {
     ValueMapType::const_iterator mapIter = valueMap_.find(key);
     const ConfigValType desiredType = configValTypeFor<T>();
     if (mapIter != valueMap_.end() &&
         (mapIter->second.getType() == desiredType)) {
       return mapIter->second.get<T>();
     }
-    ESP_ERROR() << "Key :" << key << "not present in configuration as"
+    ESP_ERROR() << "Key :" << key.str() << "not present in configuration as"
                 << getNameForStoredType(desiredType);
     return {};
   }
@@ -644,8 +792,9 @@ class Configuration {
   ConfigValue remove(const std::string& key) {
     ValueMapType::const_iterator mapIter = valueMap_.find(key);
     if (mapIter != valueMap_.end()) {
+      ConfigValue value = mapIter->second;
       valueMap_.erase(mapIter);
-      return mapIter->second;
+      return value;
     }
     ESP_WARNING() << "Key :" << key << "not present in configuration";
     return {};
@@ -667,8 +816,9 @@ class Configuration {
     const ConfigValType desiredType = configValTypeFor<T>();
     if (mapIter != valueMap_.end() &&
         (mapIter->second.getType() == desiredType)) {
+      T value = mapIter->second.get<T>();
       valueMap_.erase(mapIter);
-      return mapIter->second.get<T>();
+      return value;
     }
     ESP_WARNING() << "Key :" << key << "not present in configuration as"
                   << getNameForStoredType(desiredType);
@@ -858,7 +1008,9 @@ class Configuration {
                   "Configuration : Desired subconfig must be derived from "
                   "core::config::Configuration");
     // retrieve existing (or create new) subgroup, with passed name
-    return std::static_pointer_cast<T>(addSubgroup(name));
+    std::shared_ptr<Configuration> subgroup = addSubgroup(name);
+    editedSubconfigs_.insert(name);
+    return std::static_pointer_cast<T>(std::move(subgroup));
   }
 
   /**
@@ -873,7 +1025,12 @@ class Configuration {
     static_assert(std::is_base_of<Configuration, T>::value,
                   "Configuration : Desired subconfig must be derived from "
                   "core::config::Configuration");
-
+    // only safe to share with copies if nobody else holds the pointer
+    if (configPtr.use_count() > 1) {
+      editedSubconfigs_.insert(name);
+    } else {
+      editedSubconfigs_.erase(name);
+    }
     configMap_[name] = std::move(configPtr);
   }  // setSubconfigPtr
 
@@ -884,10 +1041,17 @@ class Configuration {
    * @return a shared pointer to the removed subconfiguration.
    */
   std::shared_ptr<Configuration> removeSubconfig(const std::string& name) {
-    ConfigMapType::const_iterator mapIter = configMap_.find(name);
+    ConfigMapType::iterator mapIter = configMap_.find(name);
     if (mapIter != configMap_.end()) {
+      std::shared_ptr<Configuration> subconfig = std::move(mapIter->second);
       configMap_.erase(mapIter);
-      return mapIter->second;
+      // the caller may edit what it gets, so don't hand out a subconfig still
+      // shared with copies of this configuration
+      if (editedSubconfigs_.erase(name) == 0 && isShareable(subconfig) &&
+          subconfig.use_count() > 1) {
+        return std::make_shared<Configuration>(*subconfig);
+      }
+      return subconfig;
     }
     ESP_WARNING() << "Name :" << name
                   << "not present in map of subconfigurations.";
@@ -1095,10 +1259,31 @@ class Configuration {
     // configuration
     if (result.second) {
       result.first->second = std::make_shared<Configuration>();
+    } else if (result.first->second.use_count() > 1 &&
+               isShareable(result.first->second) &&
+               editedSubconfigs_.count(name) == 0) {
+      // still shared with copies of this configuration, so get an own copy
+      // before it's changed
+      result.first->second =
+          std::make_shared<Configuration>(*result.first->second);
     }
     return result.first->second;
   }
 
+  /**
+   * @brief Whether @p subconfig may be shared between copies, i.e. isn't of a
+   * derived type that a plain copy would slice.
+   */
+  static bool isShareable(const std::shared_ptr<Configuration>& subconfig) {
+    return subconfig && typeid(*subconfig) == typeid(Configuration);
+  }
+
+  /**
+   * @brief Fill @ref configMap_ with the subconfigs of @p otr, sharing the
+   * ones that are never edited in place.
+   */
+  void copySubconfigsFrom(const Configuration& otr);
+
   /**
    * @brief Map to hold configurations as subgroups
    */
@@ -1109,6 +1294,12 @@ class Configuration {
    */
   ValueMapType valueMap_{};
 
+  /**
+   * @brief Names of subconfigs whose pointer was handed out for editing, so
+   * they're never shared with copies of this configuration.
+   */
+  std::set<std::string> editedSubconfigs_{};
+
   ESP_SMART_POINTERS(Configuration)
 };  // class Configuration
 
@@ -0,0 +1,213 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include "Logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+namespace {
+constexpr std::size_t HalfSubBucketCount =
+    LatencyHistogram::SubBucketCount / 2;
+
+double nsToMs(uint64_t ns) {
+  return double(ns) * 1.0e-6;
+}
+}  // namespace
+
+std::size_t LatencyHistogram::bucketIndex(uint64_t ns) {
+  if (ns < SubBucketCount) {
+    return std::size_t(ns);
+  }
+  // shift so the value lands in [SubBucketCount/2, SubBucketCount)
+  int shift = 0;
+  while ((ns >> shift) >= SubBucketCount) {
+    ++shift;
+  }
+  return SubBucketCount + (shift - 1) * HalfSubBucketCount +
+         std::size_t(ns >> shift) - HalfSubBucketCount;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+  if (index < SubBucketCount) {
+    return index;
+  }
+  const std::size_t shift = (index - SubBucketCount) / HalfSubBucketCount + 1;
+  const uint64_t subBucket =
+      (index - SubBucketCount) % HalfSubBucketCount + HalfSubBucketCount;
+  return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+  ++counts_[bucketIndex(ns)];
+  ++count_;
+  sum_ += ns;
+  min_ = std::min(min_, ns);
+  max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (std::size_t i = 0; i != BucketCount; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::clear() {
+  *this = LatencyHistogram{};
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+  if (!count_) {
+    return 0;
+  }
+  // rank of the value, 1-based, at least the first one
+  const uint64_t rank = std::max<uint64_t>(
+      1, uint64_t(std::ceil(std::min(percentile, 100.0) / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i != BucketCount; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::min(bucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+std::atomic<bool> LatencyTracker::enabled_{false};
+
+LatencyTracker& LatencyTracker::instance() {
+  static LatencyTracker tracker;
+  return tracker;
+}
+
+void LatencyTracker::setEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  lastDump_ = Clock::now();
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyTracker::clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  histograms_.clear();
+  intervalHistograms_.clear();
+  lastDump_ = Clock::now();
+}
+
+void LatencyTracker::setDumpInterval(double seconds,
+                                     const std::string& filepath) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  dumpInterval_ = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(std::max(seconds, 0.0)));
+  dumpFilepath_ = filepath;
+  intervalHistograms_.clear();
+  lastDump_ = Clock::now();
+}
+
+std::vector<LatencyStats> LatencyTracker::toStats(
+    const std::map<std::string, LatencyHistogram>& histograms) {
+  std::vector<LatencyStats> stats;
+  stats.reserve(histograms.size());
+  for (const auto& item : histograms) {
+    const LatencyHistogram& histogram = item.second;
+    LatencyStats stat;
+    stat.name = item.first;
+    stat.count = histogram.count();
+    stat.meanMs = histogram.mean() * 1.0e-6;
+    stat.p50Ms = nsToMs(histogram.valueAtPercentile(50.0));
+    stat.p90Ms = nsToMs(histogram.valueAtPercentile(90.0));
+    stat.p99Ms = nsToMs(histogram.valueAtPercentile(99.0));
+    stat.p999Ms = nsToMs(histogram.valueAtPercentile(99.9));
+    stat.maxMs = nsToMs(histogram.max());
+    stats.push_back(std::move(stat));
+  }
+  return stats;
+}
+
+std::vector<LatencyStats> LatencyTracker::getStats() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return toStats(histograms_);
+}
+
+double LatencyTracker::getPercentileMs(const std::string& name,
+                                       double percentile) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  const auto found = histograms_.find(name);
+  if (found == histograms_.end()) {
+    return 0.0;
+  }
+  return nsToMs(found->second.valueAtPercentile(percentile));
+}
+
+void LatencyTracker::record(const char* name, uint64_t ns) {
+  std::vector<LatencyStats> dump;
+  std::string dumpFilepath;
+  double intervalSeconds = 0.0;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    histograms_[name].record(ns);
+    if (dumpInterval_ == Clock::duration{}) {
+      return;
+    }
+    intervalHistograms_[name].record(ns);
+    const Clock::time_point now = Clock::now();
+    if (now - lastDump_ < dumpInterval_) {
+      return;
+    }
+    dump = toStats(intervalHistograms_);
+    dumpFilepath = dumpFilepath_;
+    intervalSeconds = std::chrono::duration<double>(now - lastDump_).count();
+    intervalHistograms_.clear();
+    lastDump_ = now;
+  }
+
+  // formatted and written outside of the lock to not stall other threads
+  if (dumpFilepath.empty()) {
+    for (const LatencyStats& stat : dump) {
+      ESP_DEBUG() << Cr::Utility::formatString(
+          "{} in the last {:.1f} s: {} calls, mean {:.3f} ms, p50 {:.3f} ms, "
+          "p90 {:.3f} ms, p99 {:.3f} ms, p99.9 {:.3f} ms, max {:.3f} ms",
+          stat.name, intervalSeconds, stat.count, stat.meanMs, stat.p50Ms,
+          stat.p90Ms, stat.p99Ms, stat.p999Ms, stat.maxMs);
+    }
+    return;
+  }
+  std::string line = Cr::Utility::formatString(
+      "{{\"time\":{:.3f},\"interval\":{:.3f},\"calls\":{{",
+      std::chrono::duration<double>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count(),
+      intervalSeconds);
+  for (std::size_t i = 0; i != dump.size(); ++i) {
+    const LatencyStats& stat = dump[i];
+    line += Cr::Utility::formatString(
+        "{}\"{}\":{{\"count\":{},\"mean_ms\":{:.4f},\"p50_ms\":{:.4f},"
+        "\"p90_ms\":{:.4f},\"p99_ms\":{:.4f},\"p999_ms\":{:.4f},"
+        "\"max_ms\":{:.4f}}}",
+        i ? "," : "", stat.name, stat.count, stat.meanMs, stat.p50Ms,
+        stat.p90Ms, stat.p99Ms, stat.p999Ms, stat.maxMs);
+  }
+  line += "}}\n";
+  if (!Cr::Utility::Path::append(
+          dumpFilepath, Cr::Containers::arrayView(line.data(), line.size()))) {
+    ESP_ERROR() << "Unable to append latency report to" << dumpFilepath;
+  }
+}  // LatencyTracker::record
+
+}  // namespace core
+}  // namespace esp
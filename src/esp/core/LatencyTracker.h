@@ -0,0 +1,221 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_LATENCYTRACKER_H_
+#define ESP_CORE_LATENCYTRACKER_H_
+
+/** @file
+ * @brief Class @ref esp::core::LatencyHistogram,
+ * @ref esp::core::LatencyTracker, @ref esp::core::LatencyScope, macro
+ * @ref ESP_TRACK_LATENCY
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Histogram of latencies with a bounded relative error, in the style
+ * of HdrHistogram.
+ *
+ * Values below @ref SubBucketCount nanoseconds are counted exactly. Larger
+ * ones fall into power-of-two ranges that are each split into
+ * @cpp SubBucketCount/2 @ce linear buckets, so every bucket is narrower than
+ * 1/64 of the values in it, and recording is a single array increment.
+ */
+class LatencyHistogram {
+ public:
+  /** @brief Number of exact buckets at the start of the value range */
+  static constexpr std::size_t SubBucketCount = 128;
+
+  /** @brief Record a latency, in nanoseconds */
+  void record(uint64_t ns);
+
+  /** @brief Add all values recorded into @p other */
+  void merge(const LatencyHistogram& other);
+
+  /** @brief Drop all recorded values */
+  void clear();
+
+  /** @brief Number of recorded values */
+  uint64_t count() const { return count_; }
+
+  /** @brief Smallest recorded value, @cpp 0 @ce if there's none */
+  uint64_t min() const { return count_ ? min_ : 0; }
+
+  /** @brief Largest recorded value */
+  uint64_t max() const { return max_; }
+
+  /** @brief Mean of the recorded values */
+  double mean() const { return count_ ? double(sum_) / count_ : 0.0; }
+
+  /**
+   * @brief Value below or at which @p percentile percent of the recorded
+   * values are
+   *
+   * Returns the upper bound of the bucket the value fell into, clamped to
+   * @ref max(), so it's never below the exact value. @cpp 0 @ce if nothing
+   * was recorded.
+   */
+  uint64_t valueAtPercentile(double percentile) const;
+
+ private:
+  // 57 power-of-two ranges above the exact buckets cover all of uint64_t
+  static constexpr std::size_t BucketCount =
+      SubBucketCount + 57 * SubBucketCount / 2;
+
+  static std::size_t bucketIndex(uint64_t ns);
+  static uint64_t bucketUpperBound(std::size_t index);
+
+  std::array<uint64_t, BucketCount> counts_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = ~uint64_t(0);
+  uint64_t max_ = 0;
+};
+
+/**
+ * @brief Latency percentiles of a tracked call, see @ref LatencyTracker.
+ */
+struct LatencyStats {
+  /** @brief Call name. */
+  std::string name;
+  /** @brief Number of calls. */
+  uint64_t count = 0;
+  /** @brief Mean latency, in milliseconds. */
+  double meanMs = 0.0;
+  /** @brief Median latency, in milliseconds. */
+  double p50Ms = 0.0;
+  /** @brief 90th percentile latency, in milliseconds. */
+  double p90Ms = 0.0;
+  /** @brief 99th percentile latency, in milliseconds. */
+  double p99Ms = 0.0;
+  /** @brief 99.9th percentile latency, in milliseconds. */
+  double p999Ms = 0.0;
+  /** @brief Longest call, in milliseconds. */
+  double maxMs = 0.0;
+};
+
+/**
+ * @brief Process-wide collector of per-call latency histograms.
+ *
+ * Calls timed with @ref ESP_TRACK_LATENCY, such as
+ * @cpp "Simulator::stepWorld" @ce, are recorded into a
+ * @ref LatencyHistogram per name. Unlike the @ref Profiler, which keeps only
+ * the most recent events, histograms have a fixed size and cover the whole
+ * run, which makes them suitable for watching tail latency of long-running
+ * deployments. While disabled, which is the default, a timed call costs a
+ * single relaxed atomic load.
+ *
+ * With @ref setDumpInterval, the percentiles of each interval are
+ * periodically written to the log or appended to a file, so latency spikes
+ * can be located in time. Dumps happen on the thread recording the first
+ * call after the interval elapsed.
+ */
+class LatencyTracker {
+ public:
+  /** @brief Get the process-wide tracker. */
+  static LatencyTracker& instance();
+
+  /** @brief Whether calls are currently being recorded. */
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /** @brief Start or stop recording calls. */
+  void setEnabled(bool enabled);
+
+  /** @brief Drop all recorded calls. */
+  void clear();
+
+  /**
+   * @brief Periodically report the latencies recorded in each interval
+   * @param seconds   Interval length, @cpp 0 @ce disables the dumps
+   * @param filepath  File each report is appended to as a line of JSON. If
+   *    empty, reports are printed to the log instead.
+   */
+  void setDumpInterval(double seconds, const std::string& filepath = "");
+
+  /** @brief Latencies of all calls recorded so far, sorted by name. */
+  std::vector<LatencyStats> getStats();
+
+  /**
+   * @brief Latency of call @p name below or at which @p percentile percent
+   * of the calls were, in milliseconds. @cpp 0 @ce if no such call was
+   * recorded.
+   */
+  double getPercentileMs(const std::string& name, double percentile);
+
+  /**
+   * @brief Record a finished call. Use @ref ESP_TRACK_LATENCY instead of
+   * calling this directly.
+   */
+  void record(const char* name, uint64_t ns);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  LatencyTracker() = default;
+
+  static std::vector<LatencyStats> toStats(
+      const std::map<std::string, LatencyHistogram>& histograms);
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex mutex_;
+  std::map<std::string, LatencyHistogram> histograms_;
+  //! Calls since the last dump
+  std::map<std::string, LatencyHistogram> intervalHistograms_;
+  Clock::duration dumpInterval_{};
+  Clock::time_point lastDump_;
+  std::string dumpFilepath_;
+};
+
+/**
+ * @brief RAII helper timing the enclosing scope. See @ref ESP_TRACK_LATENCY.
+ */
+class LatencyScope {
+ public:
+  explicit LatencyScope(const char* name)
+      : name_(LatencyTracker::isEnabled() ? name : nullptr) {
+    if (name_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~LatencyScope() {
+    if (name_) {
+      LatencyTracker::instance().record(
+          name_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start_)
+                     .count());
+    }
+  }
+
+  LatencyScope(const LatencyScope&) = delete;
+  LatencyScope& operator=(const LatencyScope&) = delete;
+
+ private:
+  const char* name_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+/**
+ * @brief Record the latency of the enclosing scope under @p name, which must
+ * be a string literal, whenever the @ref esp::core::LatencyTracker is
+ * enabled. At most one per scope.
+ */
+#define ESP_TRACK_LATENCY(name) \
+  esp::core::LatencyScope espLatencyScope_ { name }
+
+#endif  // ESP_CORE_LATENCYTRACKER_H_
@@ -7,7 +7,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <utility>
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Pair.h>
@@ -91,6 +98,27 @@ const LoggingContext* currentLoggingContext = nullptr;
 }  // namespace
 #endif
 
+/* Same as currentLoggingContext, but it's referenced from the header so it
+   can't be in an unnamed namespace in any case */
+#if defined(MAGNUM_BUILD_STATIC_UNIQUE_GLOBALS) && \
+    !defined(CORRADE_TARGET_WINDOWS)
+CORRADE_VISIBILITY_EXPORT
+#ifdef __GNUC__
+__attribute__((weak))
+#endif
+#endif
+std::atomic<uint8_t> impl::currentLevels[uint8_t(Subsystem::NumSubsystems)]{};
+
+namespace {
+void cacheLevels(const LoggingContext* context) {
+  for (uint8_t i = 0; i != uint8_t(Subsystem::NumSubsystems); ++i) {
+    impl::currentLevels[i].store(
+        context ? uint8_t(context->levelFor(Subsystem(i))) + 1 : 0,
+        std::memory_order_relaxed);
+  }
+}
+}  // namespace
+
 bool LoggingContext::hasCurrent() {
   return currentLoggingContext != nullptr;
 }
@@ -120,6 +148,7 @@ LoggingContext::LoggingContext(Corrade::Containers::StringView envString)
                 levelFromName(setLevelCommand));
     }
   }
+  cacheLevels(this);
 }
 
 LoggingContext::LoggingContext()
@@ -127,14 +156,201 @@ LoggingContext::LoggingContext()
 
 LoggingContext::~LoggingContext() {
   currentLoggingContext = prevContext_;
+  cacheLevels(prevContext_);
 }
 
 LoggingLevel LoggingContext::levelFor(Subsystem subsystem) const {
   return loggingLevels_[uint8_t(subsystem)];
 }
 
-bool isLevelEnabled(Subsystem subsystem, LoggingLevel level) {
-  return level >= LoggingContext::current().levelFor(subsystem);
+namespace {
+
+/**
+ * @brief Messages waiting to be written by the background thread of
+ * @ref setAsyncLogging()
+ */
+struct AsyncLogQueue {
+  // logging threads wait for the writer beyond this many messages
+  static constexpr std::size_t Capacity = 4096;
+
+  ~AsyncLogQueue() { stop(); }
+
+  void start() {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!writer.joinable()) {
+      stopping = false;
+      writer = std::thread{&AsyncLogQueue::write, this};
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stopping = true;
+    }
+    queued.notify_one();
+    if (writer.joinable()) {
+      writer.join();
+    }
+    // messages of threads that were still logging while the writer stopped
+    std::lock_guard<std::mutex> lock{mutex};
+    for (const auto& message : messages) {
+      *message.first << message.second << std::flush;
+    }
+    messages.clear();
+    written.notify_all();
+  }
+
+  void push(std::ostream* output, std::string message) {
+    std::unique_lock<std::mutex> lock{mutex};
+    // lines finished by other threads after async logging got disabled
+    if (stopping) {
+      *output << message << std::flush;
+      return;
+    }
+    written.wait(lock, [&] { return messages.size() < Capacity; });
+    messages.emplace_back(output, std::move(message));
+    lock.unlock();
+    queued.notify_one();
+  }
+
+  void flush() {
+    std::unique_lock<std::mutex> lock{mutex};
+    written.wait(lock, [&] { return messages.empty() && !writing; });
+  }
+
+  void write() {
+    std::deque<std::pair<std::ostream*, std::string>> batch;
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;) {
+      queued.wait(lock, [&] { return stopping || !messages.empty(); });
+      if (messages.empty()) {
+        return;
+      }
+      batch.swap(messages);
+      writing = true;
+      lock.unlock();
+      written.notify_all();
+
+      std::ostream* lastOutput = nullptr;
+      for (const auto& message : batch) {
+        if (lastOutput && lastOutput != message.first) {
+          lastOutput->flush();
+        }
+        lastOutput = message.first;
+        *lastOutput << message.second;
+      }
+      if (lastOutput) {
+        lastOutput->flush();
+      }
+      batch.clear();
+
+      lock.lock();
+      writing = false;
+      written.notify_all();
+    }
+  }
+
+  std::mutex mutex;
+  //! Signaled when messages are queued or the writer should stop
+  std::condition_variable queued;
+  //! Signaled when messages were taken from the queue or written
+  std::condition_variable written;
+  std::deque<std::pair<std::ostream*, std::string>> messages;
+  bool writing = false;
+  bool stopping = true;
+  std::thread writer;
+};
+
+AsyncLogQueue& asyncLogQueue() {
+  static AsyncLogQueue queue;
+  return queue;
+}
+
+std::atomic<bool> asyncLogging{false};
+
+/**
+ * @brief Collects what a thread logs and queues it line by line
+ */
+class AsyncLogBuffer : public std::streambuf {
+ public:
+  ~AsyncLogBuffer() override { queueLine(); }
+
+  void setOutput(std::ostream* output) {
+    // a message logged while formatting another one to a different output
+    if (output != output_ && !line_.empty()) {
+      queueLine();
+    }
+    output_ = output;
+  }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (c != traits_type::eof()) {
+      line_ += traits_type::to_char_type(c);
+      if (c == '\n') {
+        queueLine();
+      }
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* data, std::streamsize size) override {
+    line_.append(data, std::size_t(size));
+    if (size && line_.back() == '\n') {
+      queueLine();
+    }
+    return size;
+  }
+
+ private:
+  void queueLine() {
+    if (!line_.empty() && output_) {
+      asyncLogQueue().push(output_, std::move(line_));
+    }
+    line_.clear();
+  }
+
+  std::ostream* output_ = nullptr;
+  std::string line_;
+};
+
+}  // namespace
+
+void setAsyncLogging(bool enabled) {
+  AsyncLogQueue& queue = asyncLogQueue();
+  if (enabled) {
+    queue.start();
+    asyncLogging.store(true, std::memory_order_relaxed);
+  } else {
+    asyncLogging.store(false, std::memory_order_relaxed);
+    queue.stop();
+  }
+}
+
+bool isAsyncLogging() {
+  return asyncLogging.load(std::memory_order_relaxed);
+}
+
+void flushAsyncLogging() {
+  if (isAsyncLogging()) {
+    asyncLogQueue().flush();
+  }
+}
+
+std::ostream* impl::asyncOutput(std::ostream* output) {
+  if (!output || !isAsyncLogging()) {
+    return output;
+  }
+  thread_local AsyncLogBuffer buffer;
+  thread_local std::ostream stream{&buffer};
+  buffer.setOutput(output);
+  return &stream;
+}
+
+std::ostream* impl::syncOutput(std::ostream* output) {
+  flushAsyncLogging();
+  return output;
 }
 
 Cr::Containers::String buildMessagePrefix(Subsystem subsystem,
@@ -142,6 +358,9 @@ Cr::Containers::String buildMessagePrefix(Subsystem subsystem,
                                           const std::string& filename,
                                           const std::string& function,
                                           int line) {
+  // the cached levels enable everything if there's no context, fail here
+  // instead
+  LoggingContext::current();
   auto baseFileName = Cr::Utility::Path::split(filename).second();
 
   const auto timePassed =
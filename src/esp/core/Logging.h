@@ -7,6 +7,9 @@
 
 #include "esp/core/configure.h"
 
+#include <atomic>
+#include <cstdint>
+
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringView.h>
@@ -245,6 +248,18 @@ class LoggingContext {
   const LoggingContext* prevContext_;
 };
 
+namespace impl {
+/**
+ * @brief Levels of the current @ref LoggingContext, cached so that checking
+ * them is a single load and compare
+ *
+ * Each entry is the minimum enabled level of a subsystem plus one, or zero if
+ * there's no current context, in which case everything compares as enabled
+ * and building the message prefix reports the missing context.
+ */
+extern std::atomic<uint8_t> currentLevels[uint8_t(Subsystem::NumSubsystems)];
+}  // namespace impl
+
 /**
  * @brief Determine if the specified logging level is enabled within a given
  * subsystem
@@ -255,7 +270,36 @@ class LoggingContext {
  * @ref espLoggingSubsystem
  * @param[in] level The logging level
  */
-bool isLevelEnabled(Subsystem subsystem, LoggingLevel level);
+inline bool isLevelEnabled(Subsystem subsystem, LoggingLevel level) {
+  return uint8_t(level) + 1 > impl::currentLevels[uint8_t(subsystem)].load(
+                                  std::memory_order_relaxed);
+}
+
+/**
+ * @brief Write log messages from a background thread
+ *
+ * While enabled, logging statements only format their message and queue it,
+ * so simulation threads don't block on the terminal or file they log to.
+ * Messages keep going to the output they'd be written to otherwise, which
+ * has to stay alive until they're flushed. Errors are still written
+ * immediately, after everything queued before them. Logging blocks only if
+ * thousands of messages are waiting to be written.
+ *
+ * Disabling flushes all queued messages and stops the background thread.
+ */
+void setAsyncLogging(bool enabled);
+
+/**
+ * @brief Whether log messages are written from a background thread
+ */
+bool isAsyncLogging();
+
+/**
+ * @brief Wait until all queued log messages are written
+ *
+ * Does nothing if @ref setAsyncLogging() isn't enabled.
+ */
+void flushAsyncLogging();
 
 /**
  * @brief Build appropriate prefix for logging messages, including
@@ -268,6 +312,18 @@ Corrade::Containers::String buildMessagePrefix(Subsystem subsystem,
                                                int line);
 
 namespace impl {
+/**
+ * @brief Stream a logging statement writes to instead of @p output, which is
+ * the calling thread's queue if @ref setAsyncLogging() is enabled
+ */
+std::ostream* asyncOutput(std::ostream* output);
+
+/**
+ * @brief Flush the queued messages, if any, before writing to @p output
+ * directly
+ */
+std::ostream* syncOutput(std::ostream* output);
+
 class LogMessageVoidify {
  public:
   // This has to be an operator with a precedence lower than << but
@@ -319,44 +375,75 @@ class LogMessageVoidify {
       ? static_cast<void>(0) /* NOLINTNEXTLINE(bugprone-macro-parentheses) */ \
       : esp::logging::impl::LogMessageVoidify{} & (output)
 
+/**
+ * @brief Least severe @ref esp::logging::LoggingLevel compiled in
+ *
+ * Logging statements of lower levels are removed at compile time regardless
+ * of the @ref esp::logging::LoggingContext. Set with the @cmake
+ * BUILD_MIN_LOG_LEVEL @ce CMake option, everything is compiled in by default.
+ */
+#ifndef ESP_MIN_LOG_LEVEL
+#define ESP_MIN_LOG_LEVEL 0
+#endif
+
+#define ESP_LOG_LEVEL_COMPILED_IN(level) \
+  (uint8_t(level) >= ESP_MIN_LOG_LEVEL)
+
 // This ends with a nospace since the space is baked in to subsystemPrefix for
 // the case that the logger was created with a nospace flag.
 #define ESP_SUBSYS_LOG_IF(subsystem, level, output, levelMsg)                  \
-  ESP_LOG_IF(esp::logging::isLevelEnabled((subsystem), (level)), (output))     \
+  ESP_LOG_IF(ESP_LOG_LEVEL_COMPILED_IN(level) &&                               \
+                 esp::logging::isLevelEnabled((subsystem), (level)),           \
+             (output))                                                         \
       << esp::logging::buildMessagePrefix((subsystem), (levelMsg), (__FILE__), \
                                           (__FUNCTION__), (__LINE__))          \
       << Corrade::Utility::Debug::nospace
 
-#define ESP_LOG_LEVEL_ENABLED(level) \
-  esp::logging::isLevelEnabled(espLoggingSubsystem(), (level))
+#define ESP_LOG_LEVEL_ENABLED(level)   \
+  (ESP_LOG_LEVEL_COMPILED_IN(level) && \
+   esp::logging::isLevelEnabled(espLoggingSubsystem(), (level)))
 
 /**
  * @brief Very verbose level logging macro.
  */
-#define ESP_VERY_VERBOSE(...)                                            \
-  ESP_SUBSYS_LOG_IF(                                                     \
-      espLoggingSubsystem(), esp::logging::LoggingLevel::VeryVerbose,    \
-      (Corrade::Utility::Debug{Corrade::Utility::Debug::defaultOutput(), \
-                               __VA_ARGS__}),                            \
+#define ESP_VERY_VERBOSE(...)                                         \
+  ESP_SUBSYS_LOG_IF(                                                  \
+      espLoggingSubsystem(), esp::logging::LoggingLevel::VeryVerbose, \
+      (Corrade::Utility::Debug{                                       \
+          esp::logging::impl::asyncOutput(                            \
+              Corrade::Utility::Debug::defaultOutput()),              \
+          __VA_ARGS__}),                                              \
       "Verbose")
 /**
  * @brief Debug level logging macro.
  */
 #define ESP_DEBUG(...)                                                        \
   ESP_SUBSYS_LOG_IF(espLoggingSubsystem(), esp::logging::LoggingLevel::Debug, \
-                    Corrade::Utility::Debug{__VA_ARGS__}, "Debug")
+                    (Corrade::Utility::Debug{                                 \
+                        esp::logging::impl::asyncOutput(                      \
+                            Corrade::Utility::Debug::output()),               \
+                        __VA_ARGS__}),                                        \
+                    "Debug")
 /**
  * @brief Warning level logging macro.
  */
-#define ESP_WARNING(...)                                 \
-  ESP_SUBSYS_LOG_IF(espLoggingSubsystem(),               \
-                    esp::logging::LoggingLevel::Warning, \
-                    Corrade::Utility::Warning{__VA_ARGS__}, "Warning")
+#define ESP_WARNING(...)                                          \
+  ESP_SUBSYS_LOG_IF(espLoggingSubsystem(),                        \
+                    esp::logging::LoggingLevel::Warning,          \
+                    (Corrade::Utility::Warning{                   \
+                        esp::logging::impl::asyncOutput(          \
+                            Corrade::Utility::Warning::output()), \
+                        __VA_ARGS__}),                            \
+                    "Warning")
 /**
  * @brief Error level logging macro.
  */
 #define ESP_ERROR(...)                                                        \
   ESP_SUBSYS_LOG_IF(espLoggingSubsystem(), esp::logging::LoggingLevel::Error, \
-                    Corrade::Utility::Error{__VA_ARGS__}, "Error")
+                    (Corrade::Utility::Error{                                 \
+                        esp::logging::impl::syncOutput(                       \
+                            Corrade::Utility::Error::output()),               \
+                        __VA_ARGS__}),                                        \
+                    "Error")
 
 #endif  // ESP_CORE_LOGGING_H_
@@ -0,0 +1,41 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_MEMORYUSAGE_H_
+#define ESP_CORE_MEMORYUSAGE_H_
+
+/** @file
+ * @brief Struct @ref esp::core::MemoryUsage
+ */
+
+#include <cstddef>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Estimated memory held by a subsystem.
+ *
+ * Estimates are computed from the sizes of the data a subsystem keeps, not
+ * from allocator statistics, so they don't include allocator or driver
+ * overhead. Memory shared between subsystems, such as mesh data referenced by
+ * physics shapes, is counted only by the subsystem owning it.
+ */
+struct MemoryUsage {
+  /** @brief Host memory, in bytes */
+  std::size_t cpuBytes = 0;
+  /** @brief GPU memory, in bytes */
+  std::size_t gpuBytes = 0;
+
+  MemoryUsage& operator+=(const MemoryUsage& other) {
+    cpuBytes += other.cpuBytes;
+    gpuBytes += other.gpuBytes;
+    return *this;
+  }
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_MEMORYUSAGE_H_
@@ -0,0 +1,263 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+#include "Logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Fixed-size ring buffer of the events recorded by one thread.
+ */
+struct Profiler::ThreadBuffer {
+  explicit ThreadBuffer(uint32_t _threadIndex, bool _gpu = false)
+      : events(EventsPerThread), threadIndex(_threadIndex), gpu(_gpu) {}
+
+  //! Only contended while events are being read back.
+  std::mutex mutex;
+  std::vector<ProfileEvent> events;
+  //! Total number of events ever recorded; the ring position is modulo size.
+  std::size_t numRecorded = 0;
+  uint32_t threadIndex;
+  bool gpu;
+};
+
+std::atomic<bool> Profiler::enabled_{false};
+
+Profiler& Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+uint64_t Profiler::now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+uint32_t& ProfileScope::depth() {
+  thread_local uint32_t depth = 0;
+  return depth;
+}
+
+void Profiler::setEnabled(bool enabled) {
+  if (enabled) {
+    // make sure the epoch is initialized before the first scope
+    now();
+  }
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& buffer : threadBuffers_) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->numRecorded = 0;
+  }
+  counters_.clear();
+  frameCounters_.clear();
+  previousFrameNs_ = lastFrameNs_ = now();
+}
+
+void Profiler::markFrame() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  previousFrameNs_ = lastFrameNs_;
+  lastFrameNs_ = now();
+  frameCounters_ = std::move(counters_);
+  counters_.clear();
+}
+
+void Profiler::count(const char* name, int64_t value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_[name] += value;
+}
+
+std::vector<ProfileCounter> Profiler::getFrameCounters() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ProfileCounter> counters;
+  counters.reserve(frameCounters_.size());
+  for (const auto& entry : frameCounters_) {
+    counters.push_back({entry.first, entry.second});
+  }
+  return counters;
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer = std::make_shared<ThreadBuffer>(threadBuffers_.size());
+    // the profiler keeps the buffer alive so events outlive their thread
+    threadBuffers_.push_back(buffer);
+  }
+  return *buffer;
+}
+
+void Profiler::record(const char* name,
+                      uint64_t startNs,
+                      uint64_t endNs,
+                      uint32_t depth) {
+  recordInto(threadBuffer(), name, startNs, endNs, depth);
+}
+
+void Profiler::recordGpu(const char* name,
+                         uint64_t startNs,
+                         uint64_t endNs,
+                         uint32_t depth) {
+  ThreadBuffer* buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!gpuBuffer_) {
+      gpuBuffer_ = std::make_shared<ThreadBuffer>(threadBuffers_.size(), true);
+      threadBuffers_.push_back(gpuBuffer_);
+    }
+    buffer = gpuBuffer_.get();
+  }
+  recordInto(*buffer, name, startNs, endNs, depth);
+}
+
+void Profiler::recordInto(ThreadBuffer& buffer,
+                          const char* name,
+                          uint64_t startNs,
+                          uint64_t endNs,
+                          uint32_t depth) {
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  ProfileEvent& event =
+      buffer.events[buffer.numRecorded % buffer.events.size()];
+  event.name = name;
+  event.startNs = startNs;
+  event.endNs = endNs;
+  event.depth = depth;
+  event.threadIndex = buffer.threadIndex;
+  event.gpu = buffer.gpu;
+  ++buffer.numRecorded;
+}
+
+std::vector<ProfileEvent> Profiler::getEvents() {
+  std::vector<ProfileEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : threadBuffers_) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      const std::size_t capacity = buffer->events.size();
+      const std::size_t numHeld = std::min(buffer->numRecorded, capacity);
+      for (std::size_t i = buffer->numRecorded - numHeld;
+           i < buffer->numRecorded; ++i) {
+        events.push_back(buffer->events[i % capacity]);
+      }
+    }
+  }
+  std::sort(events.begin(), events.end(),
+            [](const ProfileEvent& a, const ProfileEvent& b) {
+              return a.startNs < b.startNs;
+            });
+  return events;
+}
+
+std::vector<ProfileStat> Profiler::aggregate(uint64_t fromNs, uint64_t toNs) {
+  std::unordered_map<std::string, ProfileStat> statsByName;
+  for (const ProfileEvent& event : getEvents()) {
+    if (event.endNs <= fromNs || event.endNs > toNs) {
+      continue;
+    }
+    auto inserted = statsByName.emplace(event.name, ProfileStat{});
+    ProfileStat& stat = inserted.first->second;
+    const double durationMs = (event.endNs - event.startNs) * 1e-6;
+    if (inserted.second) {
+      stat.name = event.name;
+      stat.depth = event.depth;
+    }
+    ++stat.callCount;
+    stat.totalMs += durationMs;
+    stat.maxMs = std::max(stat.maxMs, durationMs);
+    stat.depth = std::min<int>(stat.depth, event.depth);
+  }
+
+  std::vector<ProfileStat> stats;
+  stats.reserve(statsByName.size());
+  for (auto& entry : statsByName) {
+    stats.push_back(std::move(entry.second));
+  }
+  std::sort(stats.begin(), stats.end(),
+            [](const ProfileStat& a, const ProfileStat& b) {
+              return a.totalMs > b.totalMs;
+            });
+  return stats;
+}
+
+std::vector<ProfileStat> Profiler::getFrameStats() {
+  uint64_t fromNs = 0;
+  uint64_t toNs = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fromNs = previousFrameNs_;
+    toNs = lastFrameNs_;
+  }
+  return aggregate(fromNs, toNs);
+}
+
+std::vector<ProfileStat> Profiler::getStats() {
+  return aggregate(0, UINT64_MAX);
+}
+
+std::string Profiler::getChromeTrace() {
+  std::string trace = "{\"traceEvents\":[";
+  bool first = true;
+  bool gpuTrackNamed = false;
+  for (const ProfileEvent& event : getEvents()) {
+    // GPU events get a track of their own, labeled as such
+    if (event.gpu && !gpuTrackNamed) {
+      Cr::Utility::formatInto(
+          trace, trace.size(),
+          "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+          "\"tid\":{},\"args\":{{\"name\":\"GPU\"}}}}",
+          first ? "" : ",", event.threadIndex);
+      first = false;
+      gpuTrackNamed = true;
+    }
+    std::string name;
+    for (const char* c = event.name; *c; ++c) {
+      if (*c == '"' || *c == '\\') {
+        name += '\\';
+      }
+      name += *c;
+    }
+    Cr::Utility::formatInto(
+        trace, trace.size(),
+        "{}{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+        "\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}",
+        first ? "" : ",", name, event.gpu ? "gpu" : "habitat",
+        event.startNs * 1e-3,
+        (event.endNs - event.startNs) * 1e-3, event.threadIndex);
+    first = false;
+  }
+  trace += "],\"displayTimeUnit\":\"ms\"}";
+  return trace;
+}
+
+bool Profiler::exportChromeTrace(const std::string& filepath) {
+  const std::string trace = getChromeTrace();
+  if (!Cr::Utility::Path::write(
+          filepath, Cr::Containers::arrayView(trace.data(), trace.size()))) {
+    ESP_ERROR() << "Unable to write profiler trace to" << filepath;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace esp
@@ -0,0 +1,276 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_PROFILER_H_
+#define ESP_CORE_PROFILER_H_
+
+/** @file
+ * @brief Class @ref esp::core::Profiler, Class @ref esp::core::ProfileScope,
+ * macro @ref ESP_PROFILE_SCOPE, @ref ESP_PROFILE_COUNT
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Esp.h"
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief A single timed scope recorded by the @ref Profiler.
+ */
+struct ProfileEvent {
+  /** @brief Scope name. Must be a string literal, it is stored as-is. */
+  const char* name = nullptr;
+  /** @brief Start time in nanoseconds since the profiler epoch. */
+  uint64_t startNs = 0;
+  /** @brief End time in nanoseconds since the profiler epoch. */
+  uint64_t endNs = 0;
+  /** @brief Nesting depth of the scope on its thread, 0 for outermost. */
+  uint32_t depth = 0;
+  /** @brief Index of the recording thread, in order of first use. */
+  uint32_t threadIndex = 0;
+  /**
+   * @brief Whether the event was timed on the GPU, see @ref
+   * Profiler::recordGpu. GPU events have a thread index of their own.
+   */
+  bool gpu = false;
+};
+
+/**
+ * @brief Aggregated timings of all events sharing a scope name.
+ */
+struct ProfileStat {
+  /** @brief Scope name. */
+  std::string name;
+  /** @brief Number of times the scope was entered. */
+  int callCount = 0;
+  /** @brief Total time spent in the scope, in milliseconds. */
+  double totalMs = 0.0;
+  /** @brief Longest single call, in milliseconds. */
+  double maxMs = 0.0;
+  /** @brief Smallest nesting depth the scope was recorded at. */
+  int depth = 0;
+};
+
+/**
+ * @brief Total of a counter over a frame, see @ref ESP_PROFILE_COUNT.
+ */
+struct ProfileCounter {
+  /** @brief Counter name. */
+  std::string name;
+  /** @brief Sum of all values added to the counter. */
+  int64_t value = 0;
+};
+
+/**
+ * @brief Lightweight process-wide scoped-timer profiler.
+ *
+ * Scopes are recorded with @ref ESP_PROFILE_SCOPE into fixed-size per-thread
+ * ring buffers, so long runs keep only the most recent events. While disabled,
+ * which is the default, a scope costs a single relaxed atomic load.
+ *
+ * Recorded events can be aggregated per frame with @ref markFrame and
+ * @ref getFrameStats, or exported for chrome://tracing and Perfetto with
+ * @ref getChromeTrace. Counts added with @ref ESP_PROFILE_COUNT are summed
+ * per frame and queried with @ref getFrameCounters.
+ *
+ * GPU passes timed with @ref esp::gfx::GpuTimer are recorded alongside, with
+ * names prefixed with @cpp "GPU " @ce. Their results are read back without
+ * stalling, typically a frame or two after the pass was submitted, so the
+ * stats of the last frame may not have them yet.
+ */
+class Profiler {
+ public:
+  /**
+   * @brief Number of events each thread's ring buffer holds before the oldest
+   * get overwritten.
+   */
+  static constexpr std::size_t EventsPerThread = 1 << 16;
+
+  /**
+   * @brief Get the process-wide profiler.
+   */
+  static Profiler& instance();
+
+  /**
+   * @brief Whether scopes are currently being recorded. Cheap enough to call
+   * from any hot path.
+   */
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Start or stop recording scopes.
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Drop all recorded events.
+   */
+  void clear();
+
+  /**
+   * @brief Mark the end of a frame. @ref getFrameStats aggregates the events
+   * that ended between the two most recent marks.
+   */
+  void markFrame();
+
+  /**
+   * @brief Timings of the last complete frame, aggregated per scope name and
+   * sorted by descending total time.
+   */
+  std::vector<ProfileStat> getFrameStats();
+
+  /**
+   * @brief Timings of all recorded events, aggregated per scope name and
+   * sorted by descending total time.
+   */
+  std::vector<ProfileStat> getStats();
+
+  /**
+   * @brief Counters of the last complete frame, sorted by name.
+   */
+  std::vector<ProfileCounter> getFrameCounters();
+
+  /**
+   * @brief All recorded events still held in the ring buffers, sorted by
+   * start time.
+   */
+  std::vector<ProfileEvent> getEvents();
+
+  /**
+   * @brief Recorded events in the Chrome trace event JSON format.
+   */
+  std::string getChromeTrace();
+
+  /**
+   * @brief Write @ref getChromeTrace to @p filepath.
+   * @return Whether the file was written successfully.
+   */
+  bool exportChromeTrace(const std::string& filepath);
+
+  /**
+   * @brief Nanoseconds elapsed since the profiler epoch.
+   */
+  static uint64_t now();
+
+  /**
+   * @brief Record a finished scope on the calling thread. Use @ref
+   * ESP_PROFILE_SCOPE instead of calling this directly.
+   */
+  void record(const char* name,
+              uint64_t startNs,
+              uint64_t endNs,
+              uint32_t depth);
+
+  /**
+   * @brief Record a pass timed on the GPU, with times already converted to
+   * the profiler epoch. Events of all GPUs and threads share a single ring
+   * buffer. Use @ref esp::gfx::GpuTimer instead of calling this directly.
+   */
+  void recordGpu(const char* name,
+                 uint64_t startNs,
+                 uint64_t endNs,
+                 uint32_t depth);
+
+  /**
+   * @brief Add @p value to the counter @p name of the current frame. Use
+   * @ref ESP_PROFILE_COUNT instead of calling this directly.
+   */
+  void count(const char* name, int64_t value);
+
+ private:
+  struct ThreadBuffer;
+
+  Profiler() = default;
+
+  ThreadBuffer& threadBuffer();
+
+  void recordInto(ThreadBuffer& buffer,
+                  const char* name,
+                  uint64_t startNs,
+                  uint64_t endNs,
+                  uint32_t depth);
+
+  std::vector<ProfileStat> aggregate(uint64_t fromNs, uint64_t toNs);
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers_;
+  //! Also in threadBuffers_, created on the first GPU event
+  std::shared_ptr<ThreadBuffer> gpuBuffer_;
+  uint64_t previousFrameNs_ = 0;
+  uint64_t lastFrameNs_ = 0;
+  //! Counters since the last frame mark, and of the last complete frame
+  std::map<std::string, int64_t> counters_;
+  std::map<std::string, int64_t> frameCounters_;
+};
+
+/**
+ * @brief RAII helper timing the enclosing scope. See @ref ESP_PROFILE_SCOPE.
+ */
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char* name) {
+    if (Profiler::isEnabled()) {
+      name_ = name;
+      depth_ = depth()++;
+      startNs_ = Profiler::now();
+    }
+  }
+
+  ~ProfileScope() {
+    if (name_) {
+      --depth();
+      Profiler::instance().record(name_, startNs_, Profiler::now(), depth_);
+    }
+  }
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  //! Current scope nesting depth of the calling thread.
+  static uint32_t& depth();
+
+  const char* name_ = nullptr;
+  uint64_t startNs_ = 0;
+  uint32_t depth_ = 0;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#define ESP_PROFILE_SCOPE_CONCAT_IMPL(a, b) a##b
+#define ESP_PROFILE_SCOPE_CONCAT(a, b) ESP_PROFILE_SCOPE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Time the enclosing scope under @p name, which must be a string
+ * literal, whenever the @ref esp::core::Profiler is enabled.
+ */
+#define ESP_PROFILE_SCOPE(name)                                        \
+  esp::core::ProfileScope ESP_PROFILE_SCOPE_CONCAT(espProfileScope_, \
+                                                   __LINE__) {       \
+    name                                                             \
+  }
+
+/**
+ * @brief Add @p value to the per-frame counter @p name, e.g. a number of
+ * state changes, whenever the @ref esp::core::Profiler is enabled.
+ */
+#define ESP_PROFILE_COUNT(name, value)                    \
+  do {                                                    \
+    if (esp::core::Profiler::isEnabled()) {               \
+      esp::core::Profiler::instance().count(name, value); \
+    }                                                     \
+  } while (false)
+
+#endif  // ESP_CORE_PROFILER_H_
@@ -0,0 +1,89 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ScratchArena.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace esp {
+namespace core {
+
+namespace {
+// Size of the first chunk of a thread, enough for the temporaries of a
+// typical frame
+constexpr std::size_t MinChunkSize = 64 * 1024;
+
+// Offset from @p data at or after @p offset that's aligned to @p alignment
+std::size_t alignedOffset(const char* data,
+                          std::size_t offset,
+                          std::size_t alignment) {
+  const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+  return ((address + offset + alignment - 1) & ~(alignment - 1)) - address;
+}
+}  // namespace
+
+ScratchArena& ScratchArena::current() {
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+ScratchArena::~ScratchArena() {
+  CORRADE_ASSERT(!liveAllocations_,
+                 "ScratchArena: destroyed with" << liveAllocations_
+                                                << "live allocations", );
+}
+
+void* ScratchArena::allocate(std::size_t size, std::size_t alignment) {
+  CORRADE_ASSERT(alignment && !(alignment & (alignment - 1)),
+                 "ScratchArena::allocate(): expected a power-of-two "
+                 "alignment, got"
+                     << alignment,
+                 nullptr);
+  std::size_t begin =
+      chunks_.empty()
+          ? 0
+          : alignedOffset(chunks_.back().data.get(), offset_, alignment);
+  if (chunks_.empty() || begin + size > chunks_.back().size) {
+    // the chunks grow geometrically, so a frame needs only a few of them
+    const std::size_t chunkSize =
+        std::max({MinChunkSize, size + alignment, 2 * capacity()});
+    chunks_.push_back(
+        {std::unique_ptr<char[]>{new char[chunkSize]}, chunkSize});
+    offset_ = 0;
+    begin = alignedOffset(chunks_.back().data.get(), 0, alignment);
+  }
+  usedSize_ += begin + size - offset_;
+  offset_ = begin + size;
+  ++liveAllocations_;
+  return chunks_.back().data.get() + begin;
+}
+
+bool ScratchArena::reset() {
+  if (liveAllocations_) {
+    return false;
+  }
+  // a frame that needed several chunks gets a single one fitting all of it
+  // next time
+  if (chunks_.size() > 1) {
+    const std::size_t size = capacity();
+    chunks_.clear();
+    chunks_.push_back({std::unique_ptr<char[]>{new char[size]}, size});
+  }
+  offset_ = 0;
+  usedSize_ = 0;
+  return true;
+}
+
+std::size_t ScratchArena::capacity() const {
+  std::size_t size = 0;
+  for (const Chunk& chunk : chunks_) {
+    size += chunk.size;
+  }
+  return size;
+}
+
+}  // namespace core
+}  // namespace esp
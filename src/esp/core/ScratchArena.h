@@ -0,0 +1,147 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_SCRATCHARENA_H_
+#define ESP_CORE_SCRATCHARENA_H_
+
+/** @file
+ * @brief Class @ref esp::core::ScratchArena, @ref esp::core::ScratchAllocator,
+ * typedef @ref esp::core::ScratchVector
+ */
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Per-thread bump allocator for transient storage of a frame
+ *
+ * Allocations are carved out of a chunk in order and are never freed on
+ * their own, all of them are released together by @ref reset(). Once a frame
+ * needed more than one chunk, the next reset replaces them with a single
+ * chunk that fits the whole frame, so in steady state a frame doesn't touch
+ * the heap at all. Every thread has its own arena, see @ref current(), so
+ * many simulators stepping in the same process don't contend on the global
+ * allocator for their temporaries.
+ *
+ * Memory of the arena is only valid until the next @ref reset(), so it's
+ * meant for containers that don't leave the function creating them, through
+ * @ref ScratchVector. A reset while any allocation is still alive does
+ * nothing.
+ */
+class ScratchArena {
+ public:
+  /** @brief Arena of the calling thread */
+  static ScratchArena& current();
+
+  explicit ScratchArena() = default;
+
+  ~ScratchArena();
+
+  /** @brief Copying is not allowed */
+  ScratchArena(const ScratchArena&) = delete;
+
+  /** @brief Copying is not allowed */
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /**
+   * @brief Allocate @p size bytes aligned to @p alignment, which is expected
+   * to be a power of two
+   */
+  void* allocate(std::size_t size, std::size_t alignment);
+
+  /**
+   * @brief Mark an allocation as no longer used
+   *
+   * The memory is reclaimed only by @ref reset().
+   */
+  void deallocate() { --liveAllocations_; }
+
+  /**
+   * @brief Release all allocations, if none is alive anymore
+   * @return Whether the arena was reset
+   *
+   * Called once per @ref sim::Simulator::stepWorld() for the stepping
+   * thread. Can be called any time a thread knows it holds no scratch
+   * memory.
+   */
+  bool reset();
+
+  /** @brief Number of allocations not deallocated yet */
+  std::size_t liveAllocationCount() const { return liveAllocations_; }
+
+  /** @brief Bytes allocated since the last reset, including padding */
+  std::size_t usedSize() const { return usedSize_; }
+
+  /** @brief Bytes of all chunks of the arena */
+  std::size_t capacity() const;
+
+ private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  std::vector<Chunk> chunks_;
+  //! Offset of the next allocation in the last chunk
+  std::size_t offset_ = 0;
+  std::size_t usedSize_ = 0;
+  std::size_t liveAllocations_ = 0;
+};
+
+/**
+ * @brief STL allocator taking memory from the @ref ScratchArena of the thread
+ * it was created on
+ */
+template <class T>
+class ScratchAllocator {
+ public:
+  typedef T value_type;
+
+  /** @brief Allocator on the arena of the calling thread */
+  ScratchAllocator() noexcept : arena_{&ScratchArena::current()} {}
+
+  /** @brief Allocator on the same arena as @p other */
+  template <class U>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  ScratchAllocator(const ScratchAllocator<U>& other) noexcept
+      : arena_{other.arena()} {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, std::size_t) noexcept { arena_->deallocate(); }
+
+  /** @brief Arena the memory comes from */
+  ScratchArena* arena() const noexcept { return arena_; }
+
+ private:
+  ScratchArena* arena_;
+};
+
+template <class T, class U>
+bool operator==(const ScratchAllocator<T>& a, const ScratchAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ScratchAllocator<T>& a, const ScratchAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+/**
+ * @brief Vector on the @ref ScratchArena of the calling thread, for temporary
+ * data of a single function call
+ */
+template <class T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_SCRATCHARENA_H_
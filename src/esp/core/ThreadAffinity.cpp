@@ -0,0 +1,85 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ThreadAffinity.h"
+
+#include <Corrade/configure.h>
+#include <Corrade/Utility/DebugStl.h>
+
+#include <atomic>
+#include <mutex>
+
+#if defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_APPLE)
+#include <pthread.h>
+#include <sched.h>
+#define ESP_THREAD_AFFINITY_SUPPORTED
+#endif
+
+#include "Logging.h"
+
+namespace esp {
+namespace core {
+
+namespace {
+constexpr std::size_t RoleCount = 3;
+
+std::mutex& roleCpusMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<int>& roleCpus(ThreadRole role) {
+  static std::vector<int> cpus[RoleCount];
+  return cpus[std::size_t(role)];
+}
+
+// whether a failure to pin a thread of the role was logged already
+std::atomic<bool>& roleFailureLogged(ThreadRole role) {
+  static std::atomic<bool> logged[RoleCount]{};
+  return logged[std::size_t(role)];
+}
+}  // namespace
+
+void setThreadRoleCpus(ThreadRole role, std::vector<int> cpus) {
+  std::lock_guard<std::mutex> lock{roleCpusMutex()};
+  roleCpus(role) = std::move(cpus);
+  roleFailureLogged(role) = false;
+}
+
+std::vector<int> threadRoleCpus(ThreadRole role) {
+  std::lock_guard<std::mutex> lock{roleCpusMutex()};
+  return roleCpus(role);
+}
+
+bool setCurrentThreadCpus(const std::vector<int>& cpus) {
+#ifdef ESP_THREAD_AFFINITY_SUPPORTED
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  bool any = false;
+  for (const int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+      any = true;
+    }
+  }
+  return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpus);
+  return false;
+#endif
+}
+
+void pinCurrentThread(ThreadRole role) {
+  const std::vector<int> cpus = threadRoleCpus(role);
+  if (cpus.empty() || setCurrentThreadCpus(cpus)) {
+    return;
+  }
+  if (!roleFailureLogged(role).exchange(true)) {
+    ESP_WARNING() << "Couldn't pin a thread to CPUs" << cpus
+                  << ", leaving it unpinned.";
+  }
+}
+
+}  // namespace core
+}  // namespace esp
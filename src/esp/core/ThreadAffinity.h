@@ -0,0 +1,71 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_THREADAFFINITY_H_
+#define ESP_CORE_THREADAFFINITY_H_
+
+/** @file
+ * @brief Enum @ref esp::core::ThreadRole, functions
+ * @ref esp::core::setThreadRoleCpus(), @ref esp::core::pinCurrentThread()
+ */
+
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Role of a thread, selecting the CPUs it's pinned to
+ *
+ * Threads inherit the CPUs of the thread creating them, so short-lived
+ * threads splitting a single call, e.g. when voxelizing a mesh or decoding
+ * images, run on the CPUs of the @ref ThreadRole::Main thread. Long-lived
+ * threads pin themselves to the CPUs of their role once started.
+ */
+enum class ThreadRole {
+  /** Thread running the simulation, usually the Python thread */
+  Main,
+  /** Background render thread */
+  Render,
+  /**
+   * Long-lived worker threads, such as the observation encoder threads, the
+   * scene prefetch thread and the threads stepping batched physics worlds
+   */
+  Worker
+};
+
+/**
+ * @brief Set the CPUs threads of @p role are pinned to
+ *
+ * Applies to threads pinned with @ref pinCurrentThread() afterwards. Empty
+ * @p cpus leaves those threads on the CPUs they inherited. The setting is
+ * process-wide.
+ */
+void setThreadRoleCpus(ThreadRole role, std::vector<int> cpus);
+
+/** @brief CPUs threads of @p role are pinned to */
+std::vector<int> threadRoleCpus(ThreadRole role);
+
+/**
+ * @brief Pin the calling thread to @p cpus
+ * @return Whether the thread was pinned. Always @cpp false @ce on platforms
+ *    other than Linux, or if @p cpus is empty or has no CPU available to the
+ *    process.
+ *
+ * Memory is placed on the NUMA node of the thread first writing to it, so
+ * buffers allocated and filled by a pinned thread end up local to its CPUs.
+ */
+bool setCurrentThreadCpus(const std::vector<int>& cpus);
+
+/**
+ * @brief Pin the calling thread to the CPUs of @p role
+ *
+ * Does nothing if no CPUs are set for @p role. A failure is logged once.
+ */
+void pinCurrentThread(ThreadRole role);
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_THREADAFFINITY_H_
@@ -648,6 +648,15 @@ class ManagedContainer : public ManagedContainerBase {
     return U::create(*(static_cast<U*>(orig.get())));
   }  // ManagedContainer::
 
+  /**
+   * @brief Return the passed managed object itself instead of a copy. Used in
+   * the copy constructor map in place of @ref createObjectCopy for managed
+   * object types holding no state of their own, such as physics object
+   * wrappers, so that looking them up doesn't allocate.
+   * @param orig original object of type ManagedPtr being shared
+   */
+  ManagedPtr shareObject(ManagedPtr& orig) { return orig; }
+
   /**
    * @brief Build an @ref esp::core::managedContainers::AbstractManagedObject
    * object of type associated with passed object.
@@ -656,7 +665,8 @@ class ManagedContainer : public ManagedContainerBase {
    */
   ManagedPtr copyObject(ManagedPtr& origAttr) {
     const std::string ctorKey = origAttr->getClassKey();
-    return (*this.*(this->copyConstructorMap_[ctorKey]))(origAttr);
+    // not operator[], so that copies can be made from several threads
+    return (*this.*(this->copyConstructorMap_.at(ctorKey)))(origAttr);
   }  // ManagedContainer::copyObject
 
   /**
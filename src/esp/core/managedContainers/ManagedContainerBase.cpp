@@ -115,12 +115,79 @@ std::vector<std::string> getHandlesBySubStringPerTypeInternal(
 }
 }  // namespace
 
+void ManagedContainerBase::addHandleToIndex(const std::string& handle) {
+  auto result = handleIndex_.emplace(handle, std::string{});
+  if (!result.second) {
+    return;
+  }
+  std::string lowercase = Cr::Utility::String::lowercase(handle);
+  result.first->second = lowercase;
+  std::reverse(lowercase.begin(), lowercase.end());
+  reversedHandleIndex_.emplace(std::move(lowercase), handle);
+  lowercaseHandleIndex_.emplace(result.first->second, handle);
+}  // ManagedContainerBase::addHandleToIndex
+
+void ManagedContainerBase::removeHandleFromIndex(const std::string& handle) {
+  auto indexIter = handleIndex_.find(handle);
+  if (indexIter == handleIndex_.end()) {
+    return;
+  }
+  std::string lowercase = indexIter->second;
+  lowercaseHandleIndex_.erase({lowercase, handle});
+  std::reverse(lowercase.begin(), lowercase.end());
+  reversedHandleIndex_.erase({lowercase, handle});
+  handleIndex_.erase(indexIter);
+}  // ManagedContainerBase::removeHandleFromIndex
+
+std::vector<std::string> ManagedContainerBase::getHandlesBySubstringIndexed(
+    const std::string& lowercaseSubStr,
+    bool contains) const {
+  std::vector<std::string> res;
+  res.reserve(contains && !lowercaseSubStr.empty() ? 0 : handleIndex_.size());
+  for (const auto& entry : handleIndex_) {
+    // handles shorter than the search string are skipped either way, same as
+    // for the unindexed maps
+    if (entry.second.length() < lowercaseSubStr.length()) {
+      continue;
+    }
+    const bool found = entry.second.find(lowercaseSubStr) != std::string::npos;
+    if (found == contains) {
+      res.push_back(entry.first);
+    }
+  }
+  return res;
+}  // ManagedContainerBase::getHandlesBySubstringIndexed
+
+std::vector<std::string> ManagedContainerBase::getHandlesByPrefixInternal(
+    const std::set<std::pair<std::string, std::string>>& index,
+    const std::string& keyPrefix) {
+  std::vector<std::string> res;
+  for (auto iter = index.lower_bound({keyPrefix, std::string{}});
+       iter != index.end() &&
+       iter->first.compare(0, keyPrefix.size(), keyPrefix) == 0;
+       ++iter) {
+    res.push_back(iter->second);
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}  // ManagedContainerBase::getHandlesByPrefixInternal
+
 std::vector<std::string>
 ManagedContainerBase::getObjectHandlesBySubStringPerType(
     const std::unordered_map<int, std::string>& mapOfHandles,
     const std::string& subStr,
     bool contains,
     bool sorted) const {
+  // the handles of the library itself are indexed, so neither need to be
+  // lowercased nor sorted here
+  if (&mapOfHandles == &objectLibKeyByID_) {
+    if (subStr.empty()) {
+      // empty search string returns all values, regardless of contains
+      return getHandlesBySubstringIndexed(subStr, true);
+    }
+    return getHandlesBySubstringIndexed(Cr::Utility::String::lowercase(subStr),
+                                        contains);
+  }
   // get second element of pair in map entries (string)
   return getHandlesBySubStringPerTypeInternal<1>(mapOfHandles, subStr, contains,
                                                  sorted);
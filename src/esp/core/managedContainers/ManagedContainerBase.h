@@ -11,10 +11,13 @@
  * esp::core::managedContainers::ManagedContainer to cut down on code bload.
  */
 
+#include <algorithm>
 #include <deque>
 #include <functional>
+#include <map>
 #include <set>
 #include <unordered_map>
+#include <utility>
 
 #include <Corrade/Utility/String.h>
 
@@ -137,6 +140,36 @@ class ManagedContainerBase {
                                               contains, sorted);
   }  // ManagedContainerBase::getObjectHandlesBySubstring
 
+  /**
+   * @brief Get a sorted list of all managed objects handles that start with
+   * @p prefix, ignoring case. Unlike @ref getObjectHandlesBySubstring, this
+   * doesn't need to look at every handle.
+   * @param prefix prefix to search for.
+   * @return vector of 0 or more managed object handles starting with the
+   * passed prefix
+   */
+  std::vector<std::string> getObjectHandlesByPrefix(
+      const std::string& prefix) const {
+    return getHandlesByPrefixInternal(lowercaseHandleIndex_,
+                                      Cr::Utility::String::lowercase(prefix));
+  }  // ManagedContainerBase::getObjectHandlesByPrefix
+
+  /**
+   * @brief Get a sorted list of all managed objects handles that end with
+   * @p suffix, ignoring case, e.g. all handles of a file name regardless of
+   * the directory it was loaded from. Unlike @ref getObjectHandlesBySubstring,
+   * this doesn't need to look at every handle.
+   * @param suffix suffix to search for.
+   * @return vector of 0 or more managed object handles ending with the passed
+   * suffix
+   */
+  std::vector<std::string> getObjectHandlesBySuffix(
+      const std::string& suffix) const {
+    std::string reversed = Cr::Utility::String::lowercase(suffix);
+    std::reverse(reversed.begin(), reversed.end());
+    return getHandlesByPrefixInternal(reversedHandleIndex_, reversed);
+  }  // ManagedContainerBase::getObjectHandlesBySuffix
+
   /**
    * @brief returns a vector of managed object handles representing the
    * system-specified undeletable managed objects this manager manages. These
@@ -184,6 +217,9 @@ class ManagedContainerBase {
   void reset() {
     objectLibKeyByID_.clear();
     objectLibrary_.clear();
+    handleIndex_.clear();
+    lowercaseHandleIndex_.clear();
+    reversedHandleIndex_.clear();
     availableObjectIDs_.clear();
     undeletableObjectNames_.clear();
     userLockedObjectNames_.clear();
@@ -304,6 +340,7 @@ class ManagedContainerBase {
   void setObjectInternal(const std::shared_ptr<void>& ptr,
                          const std::string& handle) {
     objectLibrary_[handle] = ptr;
+    addHandleToIndex(handle);
   }
 
   /**
@@ -429,6 +466,7 @@ class ManagedContainerBase {
   void deleteObjectInternal(int objectID, const std::string& objectHandle) {
     objectLibKeyByID_.erase(objectID);
     objectLibrary_.erase(objectHandle);
+    removeHandleFromIndex(objectHandle);
     availableObjectIDs_.emplace_front(objectID);
     // call instance-specific delete code to remove managed object handle from
     // any local lists and perform any other manager-specific delete functions.
@@ -440,6 +478,37 @@ class ManagedContainerBase {
    */
   virtual void resetFinalize() = 0;
 
+ private:
+  /**
+   * @brief Add @p handle to @ref handleIndex_, @ref lowercaseHandleIndex_
+   * and @ref reversedHandleIndex_, if not there already.
+   */
+  void addHandleToIndex(const std::string& handle);
+
+  /**
+   * @brief Remove @p handle from @ref handleIndex_, @ref
+   * lowercaseHandleIndex_ and @ref reversedHandleIndex_.
+   */
+  void removeHandleFromIndex(const std::string& handle);
+
+  /**
+   * @brief Search @ref handleIndex_ for handles whose lowercase version
+   * contains, or does not contain, @p lowercaseSubStr. Results are sorted.
+   */
+  std::vector<std::string> getHandlesBySubstringIndexed(
+      const std::string& lowercaseSubStr,
+      bool contains) const;
+
+  /**
+   * @brief Get the sorted handles of all entries in @p index whose key starts
+   * with @p keyPrefix.
+   */
+  static std::vector<std::string> getHandlesByPrefixInternal(
+      const std::set<std::pair<std::string, std::string>>& index,
+      const std::string& keyPrefix);
+
+ protected:
+
   // ========  Instance Variables ========
   /**
    * @brief Maps string keys to managed object managed objects
@@ -457,6 +526,25 @@ class ManagedContainerBase {
    */
   std::unordered_map<int, std::string> objectLibKeyByID_;
 
+  /**
+   * @brief All handles in @ref objectLibKeyByID_ in sorted order, each mapped
+   * to its lowercase version, so substring searches neither need to lowercase
+   * nor sort the handles on each query.
+   */
+  std::map<std::string, std::string> handleIndex_;
+
+  /**
+   * @brief Lowercase version of each handle in @ref handleIndex_ paired with
+   * the handle, for prefix searches.
+   */
+  std::set<std::pair<std::string, std::string>> lowercaseHandleIndex_;
+
+  /**
+   * @brief Reversed lowercase version of each handle in @ref handleIndex_
+   * paired with the handle, for suffix searches.
+   */
+  std::set<std::pair<std::string, std::string>> reversedHandleIndex_;
+
   /**
    * @brief Deque holding all IDs of deleted objects. These ID's should be
    * recycled before using map-size-based IDs
@@ -15,12 +15,16 @@
 #include "AbstractFileBasedManagedObject.h"
 #include "ManagedContainer.h"
 #include "esp/io/Json.h"
+#include "esp/io/JsonFileSnapshot.h"
 
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
+#include <atomic>
+#include <thread>
 #include <typeinfo>
+#include <unordered_map>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -53,6 +57,48 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
                                      const std::string& JSONTypeExt)
       : ManagedContainer<T, Access>(metadataType), JSONTypeExt_(JSONTypeExt) {}
 
+  ~ManagedFileBasedContainer() override { joinBackgroundSave(); }
+
+  /**
+   * @brief Set whether @ref saveManagedObjectToFile writes files from a
+   * background thread.
+   *
+   * If enabled, the JSON document describing an object is still built on the
+   * calling thread, but writing it to the file happens in the background, and
+   * the save functions only report whether the file was set up to be written.
+   * At most one file is written at a time, so saving again waits for the
+   * previous write to finish. Use @ref waitForBackgroundSaves to find out
+   * whether the writes succeeded.
+   */
+  void setSaveFilesInBackground(bool saveFilesInBackground) {
+    saveFilesInBackground_ = saveFilesInBackground;
+  }
+
+  /**
+   * @brief Whether @ref saveManagedObjectToFile writes files from a background
+   * thread. See @ref setSaveFilesInBackground.
+   */
+  bool getSaveFilesInBackground() const { return saveFilesInBackground_; }
+
+  /**
+   * @brief Wait until the file being written in the background, if any, is
+   * complete.
+   * @return Whether all files written in the background since the last call
+   * were written successfully.
+   */
+  bool waitForBackgroundSaves() const {
+    joinBackgroundSave();
+    return backgroundSavesSucceeded_.exchange(true);
+  }
+
+  /**
+   * @brief Set a snapshot to read JSON files from while unchanged, and store
+   * files read from disk in. Pass @cpp nullptr @ce to read from disk again.
+   */
+  void setJSONFileSnapshot(io::JsonFileSnapshot::ptr snapshot) {
+    jsonFileSnapshot_ = std::move(snapshot);
+  }
+
   /**
    * @brief Creates an instance of a managed object from a JSON file, by first
    * loading the file into a @ref JsonDocument and then parsing that document
@@ -367,6 +413,23 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
     // move constructed config into doc
     doc.Swap(configJson);
     if (!doc.ObjectEmpty()) {
+      if (saveFilesInBackground_) {
+        // the document owns its allocator, so it can be written on its own
+        // while the object keeps being used
+        joinBackgroundSave();
+        backgroundSave_ = std::thread{[this, doc = std::move(doc),
+                                       objectType = this->objectType_,
+                                       fullFilename]() {
+          if (!io::writeJsonToFile(doc, fullFilename, true, 7)) {
+            ESP_ERROR(Mn::Debug::Flag::NoSpace)
+                << "<" << objectType << "> : Attempt to save to Filename `"
+                << fullFilename << "` in the background Failed!";
+            backgroundSavesSucceeded_ = false;
+          }
+        }};
+        managedObject->setActualFilename(fullFilename);
+        return true;
+      }
       // save to file if doc exists
       bool success = io::writeJsonToFile(doc, fullFilename, true, 7);
       if (success) {
@@ -397,6 +460,16 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
     }
   }
 
+  /**
+   * @brief Wait for the file being written in the background, if any. See
+   * @ref setSaveFilesInBackground.
+   */
+  void joinBackgroundSave() const {
+    if (backgroundSave_.joinable()) {
+      backgroundSave_.join();
+    }
+  }
+
   /**
    * @brief Verify passd @p filename is legal document of type U. Returns
    * loaded document in passed argument if successful. This requires
@@ -430,6 +503,31 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
   bool verifyLoadDocument(const std::string& filename,
                           std::unique_ptr<io::JsonDocument>& jsonDoc);
 
+  /**
+   * @brief Read and parse the JSON files among @p filenames ahead of time on
+   * all hardware threads, so a following @ref verifyLoadDocument for each of
+   * them only has to hand out the parsed document. Files with other
+   * extensions are skipped, as are files that fail to parse, which are then
+   * parsed and reported by @ref verifyLoadDocument as usual.
+   *
+   * @param filenames The names of the files about to be loaded
+   */
+  void preparseJSONFiles(const std::vector<std::string>& filenames) {
+    std::vector<std::string> jsonFilenames;
+    for (const std::string& filename : filenames) {
+      if (Cr::Utility::String::endsWith(filename, this->JSONTypeExt_)) {
+        jsonFilenames.push_back(filename);
+      }
+    }
+    std::vector<std::unique_ptr<io::JsonDocument>> docs =
+        io::parseJsonFiles(jsonFilenames, jsonFileSnapshot_.get());
+    for (std::size_t i = 0; i < docs.size(); ++i) {
+      if (docs[i]) {
+        preparsedDocs_[jsonFilenames[i]] = std::move(docs[i]);
+      }
+    }
+  }  // preparseJSONFiles
+
   /**
    * @brief Verify passd @p docString represents a legal document of type U.
    * Returns parsed document in passed argument @p resDoc if successful. This
@@ -508,6 +606,37 @@ class ManagedFileBasedContainer : public ManagedContainer<T, Access> {
    */
   const std::string JSONTypeExt_;
 
+  /**
+   * @brief Documents parsed by @ref preparseJSONFiles and not yet consumed by
+   * @ref verifyLoadDocument, keyed by file name.
+   */
+  std::unordered_map<std::string, std::unique_ptr<io::JsonDocument>>
+      preparsedDocs_;
+
+  /**
+   * @brief Snapshot JSON files are read from, if set. See @ref
+   * setJSONFileSnapshot.
+   */
+  io::JsonFileSnapshot::ptr jsonFileSnapshot_;
+
+  /**
+   * @brief Whether files are written from a background thread. See @ref
+   * setSaveFilesInBackground.
+   */
+  bool saveFilesInBackground_ = false;
+
+  /**
+   * @brief Thread writing the most recently saved file in the background, if
+   * any.
+   */
+  mutable std::thread backgroundSave_;
+
+  /**
+   * @brief Whether all files written in the background since the last call to
+   * @ref waitForBackgroundSaves succeeded.
+   */
+  mutable std::atomic<bool> backgroundSavesSucceeded_{true};
+
  public:
   ESP_SMART_POINTERS(ManagedFileBasedContainer<T, Access>)
 
@@ -586,6 +715,21 @@ template <class T, ManagedObjectAccess Access>
 bool ManagedFileBasedContainer<T, Access>::verifyLoadDocument(
     const std::string& filename,
     std::unique_ptr<io::JsonDocument>& jsonDoc) {
+  auto preparsedIter = preparsedDocs_.find(filename);
+  if (preparsedIter != preparsedDocs_.end()) {
+    jsonDoc = std::move(preparsedIter->second);
+    preparsedDocs_.erase(preparsedIter);
+    return true;
+  }
+  if (jsonFileSnapshot_) {
+    std::vector<std::unique_ptr<io::JsonDocument>> docs =
+        io::parseJsonFiles({filename}, jsonFileSnapshot_.get());
+    // failures are reported by the regular path below
+    if (docs[0]) {
+      jsonDoc = std::move(docs[0]);
+      return true;
+    }
+  }
   if (Cr::Utility::Path::exists(filename)) {
     try {
       jsonDoc = std::make_unique<io::JsonDocument>(io::parseJsonFile(filename));
@@ -653,7 +797,8 @@ bool ManagedFileBasedContainer<T, Access>::saveManagedObjectToFile(
   std::string fileName = fileNameBase + "." + this->JSONTypeExt_;
   if (!overwrite) {
     // if not overwrite, then attempt to find a non-conflicting name before
-    // attempting to save
+    // attempting to save, once a file still being written exists
+    joinBackgroundSave();
     bool nameExists = true;
     int count = 0;
 
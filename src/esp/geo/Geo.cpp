@@ -9,8 +9,16 @@
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Primitives/Circle.h>
 #include <Magnum/Trade/MeshData.h>
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <thread>
+
+#if defined(CORRADE_TARGET_SSE2)
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace Mn = Magnum;
 namespace Cr = Corrade;
@@ -18,6 +26,108 @@ using Magnum::Math::Literals::operator""_rgb;
 namespace esp {
 namespace geo {
 
+namespace {
+
+// Four float lanes used by the batch functions below. A point occupies the
+// first three, the last one is unspecified. Points are loaded without reading
+// past their third component so the last point of an array is safe to load.
+#if defined(CORRADE_TARGET_SSE2)
+#define ESP_GEO_LANES
+typedef __m128 Lanes;
+inline Lanes loadLanes(const float* p) {
+  return _mm_loadu_ps(p);
+}
+inline Lanes loadPoint(const float* p) {
+  return _mm_movelh_ps(
+      _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))),
+      _mm_load_ss(p + 2));
+}
+inline void storePoint(float* p, Lanes v) {
+  _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+  _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+inline void storeLanes(float* p, Lanes v) {
+  _mm_storeu_ps(p, v);
+}
+inline Lanes splat(float value) {
+  return _mm_set1_ps(value);
+}
+inline Lanes minLanes(Lanes a, Lanes b) {
+  return _mm_min_ps(a, b);
+}
+inline Lanes maxLanes(Lanes a, Lanes b) {
+  return _mm_max_ps(a, b);
+}
+inline Lanes addLanes(Lanes a, Lanes b) {
+  return _mm_add_ps(a, b);
+}
+inline Lanes mulLanes(Lanes a, Lanes b) {
+  return _mm_mul_ps(a, b);
+}
+inline bool pointInside(Lanes v, Lanes min, Lanes max) {
+  return (_mm_movemask_ps(
+              _mm_and_ps(_mm_cmpge_ps(v, min), _mm_cmple_ps(v, max))) &
+          7) == 7;
+}
+#elif defined(CORRADE_TARGET_NEON)
+#define ESP_GEO_LANES
+typedef float32x4_t Lanes;
+inline Lanes loadLanes(const float* p) {
+  return vld1q_f32(p);
+}
+inline Lanes loadPoint(const float* p) {
+  return vcombine_f32(vld1_f32(p), vset_lane_f32(p[2], vdup_n_f32(0.0f), 0));
+}
+inline void storePoint(float* p, Lanes v) {
+  vst1_f32(p, vget_low_f32(v));
+  vst1q_lane_f32(p + 2, v, 2);
+}
+inline void storeLanes(float* p, Lanes v) {
+  vst1q_f32(p, v);
+}
+inline Lanes splat(float value) {
+  return vdupq_n_f32(value);
+}
+inline Lanes minLanes(Lanes a, Lanes b) {
+  return vminq_f32(a, b);
+}
+inline Lanes maxLanes(Lanes a, Lanes b) {
+  return vmaxq_f32(a, b);
+}
+inline Lanes addLanes(Lanes a, Lanes b) {
+  return vaddq_f32(a, b);
+}
+inline Lanes mulLanes(Lanes a, Lanes b) {
+  return vmulq_f32(a, b);
+}
+inline bool pointInside(Lanes v, Lanes min, Lanes max) {
+  const uint32x4_t inside = vandq_u32(vcgeq_f32(v, min), vcleq_f32(v, max));
+  return vgetq_lane_u32(inside, 0) && vgetq_lane_u32(inside, 1) &&
+         vgetq_lane_u32(inside, 2);
+}
+#endif
+
+#ifdef ESP_GEO_LANES
+// rotation, scaling and translation columns of an affine transformation
+struct AffineLanes {
+  explicit AffineLanes(const Mn::Matrix4& transformation)
+      : c0{loadLanes(transformation[0].data())},
+        c1{loadLanes(transformation[1].data())},
+        c2{loadLanes(transformation[2].data())},
+        c3{loadLanes(transformation[3].data())} {}
+
+  Lanes transformPoint(const Mn::Vector3& p) const {
+    return addLanes(addLanes(mulLanes(c0, splat(p.x())),
+                             mulLanes(c1, splat(p.y()))),
+                    addLanes(mulLanes(c2, splat(p.z())), c3));
+  }
+
+  Lanes c0, c1, c2, c3;
+};
+#endif
+
+}  // namespace
+
 std::vector<vec2f> convexHull2D(const std::vector<vec2f>& points) {
   CORRADE_INTERNAL_ASSERT(points.size() > 2);
 
@@ -125,6 +235,174 @@ Mn::Range3D getTransformedBB(const Mn::Range3D& range,
   return Mn::Range3D::fromCenter(newCenter, newExtent);
 }
 
+Mn::Range3D computeAABB(
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& points) {
+  if (points.isEmpty()) {
+    return {};
+  }
+#ifdef ESP_GEO_LANES
+  const std::size_t count = points.size();
+  std::size_t i = 1;
+  Lanes min = loadPoint(points[0].data());
+  Lanes max = min;
+  if (points.stride() == sizeof(Mn::Vector3) && count >= 4) {
+    // four consecutive points are three full registers, lane k of register r
+    // holding component (4*r + k) % 3
+    const float* data = points[0].data();
+    Lanes min0 = loadLanes(data), max0 = min0;
+    Lanes min1 = loadLanes(data + 4), max1 = min1;
+    Lanes min2 = loadLanes(data + 8), max2 = min2;
+    for (i = 4; i + 4 <= count; i += 4) {
+      const float* p = data + 3 * i;
+      const Lanes v0 = loadLanes(p);
+      const Lanes v1 = loadLanes(p + 4);
+      const Lanes v2 = loadLanes(p + 8);
+      min0 = minLanes(min0, v0);
+      max0 = maxLanes(max0, v0);
+      min1 = minLanes(min1, v1);
+      max1 = maxLanes(max1, v1);
+      min2 = minLanes(min2, v2);
+      max2 = maxLanes(max2, v2);
+    }
+    float mins[12], maxs[12];
+    storeLanes(mins, min0);
+    storeLanes(mins + 4, min1);
+    storeLanes(mins + 8, min2);
+    storeLanes(maxs, max0);
+    storeLanes(maxs + 4, max1);
+    storeLanes(maxs + 8, max2);
+    Mn::Vector3 minPoint{mins[0], mins[1], mins[2]};
+    Mn::Vector3 maxPoint{maxs[0], maxs[1], maxs[2]};
+    for (std::size_t j = 3; j != 12; ++j) {
+      minPoint[j % 3] = Mn::Math::min(minPoint[j % 3], mins[j]);
+      maxPoint[j % 3] = Mn::Math::max(maxPoint[j % 3], maxs[j]);
+    }
+    min = loadPoint(minPoint.data());
+    max = loadPoint(maxPoint.data());
+  }
+  for (; i != count; ++i) {
+    const Lanes v = loadPoint(points[i].data());
+    min = minLanes(min, v);
+    max = maxLanes(max, v);
+  }
+  Mn::Range3D result;
+  storePoint(result.min().data(), min);
+  storePoint(result.max().data(), max);
+  return result;
+#else
+  return Mn::Range3D{Mn::Math::minmax(points)};
+#endif
+}  // computeAABB
+
+Mn::Range3D computeAABB(
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& points,
+    Cr::Containers::ArrayView<const uint32_t> indices) {
+  if (indices.isEmpty()) {
+    return {};
+  }
+#ifdef ESP_GEO_LANES
+  Lanes min = loadPoint(points[indices[0]].data());
+  Lanes max = min;
+  for (std::size_t i = 1; i != indices.size(); ++i) {
+    const Lanes v = loadPoint(points[indices[i]].data());
+    min = minLanes(min, v);
+    max = maxLanes(max, v);
+  }
+  Mn::Range3D result;
+  storePoint(result.min().data(), min);
+  storePoint(result.max().data(), max);
+  return result;
+#else
+  Mn::Vector3 min = points[indices[0]];
+  Mn::Vector3 max = min;
+  for (std::size_t i = 1; i != indices.size(); ++i) {
+    min = Mn::Math::min(min, points[indices[i]]);
+    max = Mn::Math::max(max, points[indices[i]]);
+  }
+  return {min, max};
+#endif
+}  // computeAABB
+
+Mn::Range3D computeTransformedAABB(
+    const Mn::Matrix4& transformation,
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& points) {
+  if (points.isEmpty()) {
+    return {};
+  }
+#ifdef ESP_GEO_LANES
+  const AffineLanes affine{transformation};
+  Lanes min = affine.transformPoint(points[0]);
+  Lanes max = min;
+  for (std::size_t i = 1; i != points.size(); ++i) {
+    const Lanes v = affine.transformPoint(points[i]);
+    min = minLanes(min, v);
+    max = maxLanes(max, v);
+  }
+  Mn::Range3D result;
+  storePoint(result.min().data(), min);
+  storePoint(result.max().data(), max);
+  return result;
+#else
+  Mn::Vector3 min = transformation.transformPoint(points[0]);
+  Mn::Vector3 max = min;
+  for (std::size_t i = 1; i != points.size(); ++i) {
+    const Mn::Vector3 p = transformation.transformPoint(points[i]);
+    min = Mn::Math::min(min, p);
+    max = Mn::Math::max(max, p);
+  }
+  return {min, max};
+#endif
+}  // computeTransformedAABB
+
+void transformPoints(
+    const Mn::Matrix4& transformation,
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& points,
+    const Cr::Containers::StridedArrayView1D<Mn::Vector3>& output) {
+  CORRADE_ASSERT(points.size() == output.size(),
+                 "geo::transformPoints(): expected" << points.size()
+                                                    << "output points, got"
+                                                    << output.size(), );
+#ifdef ESP_GEO_LANES
+  const AffineLanes affine{transformation};
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    // read before written, so in-place transformation is fine
+    storePoint(output[i].data(), affine.transformPoint(points[i]));
+  }
+#else
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    output[i] = transformation.transformPoint(points[i]);
+  }
+#endif
+}  // transformPoints
+
+std::size_t pointsInAABB(
+    const Mn::Range3D& box,
+    const Cr::Containers::StridedArrayView1D<const Mn::Vector3>& points,
+    Cr::Containers::ArrayView<bool> inside) {
+  CORRADE_ASSERT(points.size() == inside.size(),
+                 "geo::pointsInAABB(): expected" << points.size()
+                                                 << "output flags, got"
+                                                 << inside.size(),
+                 {});
+  std::size_t count = 0;
+#ifdef ESP_GEO_LANES
+  const Lanes min = loadPoint(box.min().data());
+  const Lanes max = loadPoint(box.max().data());
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    inside[i] = pointInside(loadPoint(points[i].data()), min, max);
+    count += inside[i];
+  }
+#else
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    // Range3D::contains() excludes the max boundary
+    inside[i] =
+        (points[i] >= box.min()).all() && (points[i] <= box.max()).all();
+    count += inside[i];
+  }
+#endif
+  return count;
+}  // pointsInAABB
+
 float calcWeightedDistance(const Mn::Vector3& a,
                            const Mn::Vector3& b,
                            float alpha) {
@@ -522,30 +800,156 @@ std::string getColorAsString(const Magnum::Color3ub& color) {
   return std::string(out);
 }
 
-std::vector<std::set<uint32_t>> buildAdjList(
-    int numVerts,
-    const std::vector<uint32_t>& indexBuffer) {
+AdjacencyList buildAdjList(int numVerts,
+                           const std::vector<uint32_t>& indexBuffer) {
   // build adj list by assuming that each sequence of 3 indices in index list
-  // denote a triangle.  Idx matches vertex index in vert list, value is set of
-  // verts that are adjacent
-  std::vector<std::set<uint32_t>> adjList(numVerts, std::set<uint32_t>{});
-  for (size_t i = 0; i < indexBuffer.size(); i += 3) {
+  // denote a triangle. Every triangle adds its two other verts to each of its
+  // verts, so count those first to size the rows
+  const std::size_t numIndices = indexBuffer.size() / 3 * 3;
+  AdjacencyList adjList;
+  adjList.offsets.assign(numVerts + 1, 0);
+  for (std::size_t i = 0; i < numIndices; ++i) {
+    adjList.offsets[indexBuffer[i] + 1] += 2;
+  }
+  for (int v = 0; v < numVerts; ++v) {
+    adjList.offsets[v + 1] += adjList.offsets[v];
+  }
+
+  // fill the rows, using a running fill position per vert
+  adjList.neighbors.resize(adjList.offsets[numVerts]);
+  std::vector<uint32_t> fill(adjList.offsets.begin(),
+                             adjList.offsets.end() - 1);
+  for (std::size_t i = 0; i < numIndices; i += 3) {
     // find idxs of triangle
     const uint32_t idx0 = indexBuffer[i];
     const uint32_t idx1 = indexBuffer[i + 1];
     const uint32_t idx2 = indexBuffer[i + 2];
     // save adjacency info for triangle
-    adjList[idx0].insert(idx1);
-    adjList[idx1].insert(idx0);
-    adjList[idx0].insert(idx2);
-    adjList[idx2].insert(idx0);
-    adjList[idx1].insert(idx2);
-    adjList[idx2].insert(idx1);
+    adjList.neighbors[fill[idx0]++] = idx1;
+    adjList.neighbors[fill[idx0]++] = idx2;
+    adjList.neighbors[fill[idx1]++] = idx0;
+    adjList.neighbors[fill[idx1]++] = idx2;
+    adjList.neighbors[fill[idx2]++] = idx0;
+    adjList.neighbors[fill[idx2]++] = idx1;
+  }
+  std::vector<uint32_t>().swap(fill);
+
+  // sort each row and drop the duplicates from shared edges, compacting the
+  // rows towards the front in place
+  uint32_t outIdx = 0;
+  for (int v = 0; v < numVerts; ++v) {
+    const auto rowBegin = adjList.neighbors.begin() + adjList.offsets[v];
+    const auto rowEnd = adjList.neighbors.begin() + adjList.offsets[v + 1];
+    std::sort(rowBegin, rowEnd);
+    const auto uniqueEnd = std::unique(rowBegin, rowEnd);
+    adjList.offsets[v] = outIdx;
+    outIdx = std::copy(rowBegin, uniqueEnd,
+                       adjList.neighbors.begin() + outIdx) -
+             adjList.neighbors.begin();
   }
+  adjList.offsets[numVerts] = outIdx;
+  adjList.neighbors.resize(outIdx);
+  adjList.neighbors.shrink_to_fit();
   return adjList;
 
 }  // buildAdjList
 
+namespace {
+// union-find root lookup with path halving
+uint32_t findRoot(std::vector<uint32_t>& parents, uint32_t vIDX) {
+  while (parents[vIDX] != vIDX) {
+    parents[vIDX] = parents[parents[vIDX]];
+    vIDX = parents[vIDX];
+  }
+  return vIDX;
+}
+
+// the smaller index always becomes the root, so each CC's root is its lowest
+// vert
+void joinRoots(std::vector<uint32_t>& parents, uint32_t a, uint32_t b) {
+  a = findRoot(parents, a);
+  b = findRoot(parents, b);
+  if (a < b) {
+    parents[b] = a;
+  } else if (b < a) {
+    parents[a] = b;
+  }
+}
+
+uint32_t getKeyPartition(uint32_t key, uint32_t numPartitions) {
+  // keys are often colors that differ in only a few bits, so scramble them
+  // before splitting
+  return (key * 0x9e3779b1u >> 16) % numPartitions;
+}
+}  // namespace
+
+std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>> findCCsByKey(
+    const AdjacencyList& adjList,
+    const std::vector<uint32_t>& vertKeys) {
+  const uint32_t numVerts = adjList.size();
+  std::vector<uint32_t> parents(numVerts);
+  std::iota(parents.begin(), parents.end(), 0);
+
+  // joins only ever touch verts of a single key, and thus of a single
+  // partition, so the partitions can be processed in parallel without locking
+  const auto joinPartition = [&](uint32_t partition, uint32_t numPartitions) {
+    for (uint32_t vIDX = 0; vIDX < numVerts; ++vIDX) {
+      const uint32_t key = vertKeys[vIDX];
+      if (numPartitions > 1 &&
+          getKeyPartition(key, numPartitions) != partition) {
+        continue;
+      }
+      for (uint32_t i = adjList.offsets[vIDX]; i != adjList.offsets[vIDX + 1];
+           ++i) {
+        const uint32_t adjIDX = adjList.neighbors[i];
+        if (adjIDX > vIDX && vertKeys[adjIDX] == key) {
+          joinRoots(parents, vIDX, adjIDX);
+        }
+      }
+    }
+  };
+
+  // not worth a thread for small meshes
+  const uint32_t numPartitions = std::max(
+      1u, std::min(std::thread::hardware_concurrency(), numVerts / 65536));
+  if (numPartitions == 1) {
+    joinPartition(0, 1);
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(numPartitions - 1);
+    for (uint32_t i = 1; i < numPartitions; ++i) {
+      workers.emplace_back(joinPartition, i, numPartitions);
+    }
+    joinPartition(0, numPartitions);
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // gather the members of each CC. Roots are the lowest vert of their CC, so
+  // they're always seen before the rest of it and CCs end up ordered by their
+  // lowest vert
+  std::vector<uint32_t> ccIDXs(numVerts);
+  std::vector<std::vector<uint32_t>> ccs;
+  for (uint32_t vIDX = 0; vIDX < numVerts; ++vIDX) {
+    const uint32_t root = findRoot(parents, vIDX);
+    if (root == vIDX) {
+      ccIDXs[vIDX] = ccs.size();
+      ccs.emplace_back();
+    }
+    ccs[ccIDXs[root]].push_back(vIDX);
+  }
+
+  std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
+      clrsToComponents;
+  for (std::vector<uint32_t>& cc : ccs) {
+    // members are sorted, which makes building the set linear
+    clrsToComponents[vertKeys[cc.front()]].emplace_back(cc.begin(), cc.end());
+    std::vector<uint32_t>().swap(cc);
+  }
+  return clrsToComponents;
+}  // findCCsByKey
+
 uint32_t getValueAsUInt(const Mn::Color3ub& color) {
   return (unsigned(color[0]) << 16) | (unsigned(color[1]) << 8) |
          unsigned(color[2]);
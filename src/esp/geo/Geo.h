@@ -13,6 +13,9 @@
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/Trade.h>
 
@@ -68,6 +71,64 @@ std::vector<vec2f> convexHull2D(const std::vector<vec2f>& points);
 Magnum::Range3D getTransformedBB(const Magnum::Range3D& range,
                                  const Magnum::Matrix4& xform);
 
+/**
+ * @brief Axis-aligned bounding box of @p points
+ *
+ * Same as @cpp Magnum::Math::minmax() @ce, including a default-constructed
+ * range for no points, but vectorized with SSE2 or NEON where available.
+ * Contiguous arrays are processed four points at a time.
+ */
+Magnum::Range3D computeAABB(
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        points);
+
+/**
+ * @brief Axis-aligned bounding box of the @p points at @p indices
+ */
+Magnum::Range3D computeAABB(
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        points,
+    Corrade::Containers::ArrayView<const uint32_t> indices);
+
+/**
+ * @brief Axis-aligned bounding box of @p points transformed by
+ * @p transformation
+ *
+ * Same as transforming a copy of the points and calling @ref computeAABB() on
+ * it, without the copy. Expects an affine transformation, the projective row
+ * is ignored.
+ */
+Magnum::Range3D computeTransformedAABB(
+    const Magnum::Matrix4& transformation,
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        points);
+
+/**
+ * @brief Transform @p points by @p transformation into @p output
+ *
+ * @p output has to have the same size as @p points and may be the same
+ * memory. Expects an affine transformation, the projective row is ignored.
+ */
+void transformPoints(
+    const Magnum::Matrix4& transformation,
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        points,
+    const Corrade::Containers::StridedArrayView1D<Magnum::Vector3>& output);
+
+/**
+ * @brief Test which of @p points are inside @p box
+ * @param box     Box, including its boundary
+ * @param points  Points to test
+ * @param inside  Set to whether each point is inside, has to have the same
+ *    size as @p points
+ * @return Number of points inside
+ */
+std::size_t pointsInAABB(
+    const Magnum::Range3D& box,
+    const Corrade::Containers::StridedArrayView1D<const Magnum::Vector3>&
+        points,
+    Corrade::Containers::ArrayView<bool> inside);
+
 /**
  * @brief Return a vector of L2/Euclidean distances of points along a
  * trajectory. First point will always be 0, and last point will give length of
@@ -192,103 +253,81 @@ uint32_t getValueAsUInt(const Mn::Color4ub& color);
  */
 uint32_t getValueAsUInt(int color);
 
+/**
+ * @brief Per-vertex adjacency of a mesh in compressed sparse row layout. The
+ * verts adjacent to vert @cpp i @ce are @cpp neighbors[offsets[i]] @ce up to
+ * (excluding) @cpp neighbors[offsets[i + 1]] @ce, sorted and without
+ * duplicates. Takes two flat arrays instead of a node-based container per
+ * vertex, which matters for large semantic meshes.
+ */
+struct AdjacencyList {
+  /**
+   * @brief Offset of each vert's neighbors in @ref neighbors, with one extra
+   * trailing entry holding the total count.
+   */
+  std::vector<uint32_t> offsets;
+  /** @brief Adjacent vert indices of all verts, concatenated. */
+  std::vector<uint32_t> neighbors;
+
+  /** @brief Number of verts in the mesh. */
+  std::size_t size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+};
+
 /**
  * @brief Build an adjacency list using the passed index buffer.  Assumes each
  * sequence of 3 indices describesd a poly.
  * @param numVerts Number of verts found in mesh.
  * @param indices Index buffer.
- * @return vector of sets, where each set's index corresponds to the src vert in
- * the vertex buffer, and each element is a set containing the indices of the
- * adjacent verts.
+ * @return The adjacency of each vert in the vertex buffer, see
+ * @ref AdjacencyList.
  */
 
-std::vector<std::set<uint32_t>> buildAdjList(
-    int numVerts,
-    const std::vector<uint32_t>& indexBuffer);
+AdjacencyList buildAdjList(int numVerts,
+                           const std::vector<uint32_t>& indexBuffer);
 
 /**
- * @brief Build a connected component recursively on an unconnected graph
- * (i.e. mesh vertices), building from passed @p vIDX from adjecent verts
- * that match the passed @p clr value, which can be any per-vertex identifier
- * or tag.
+ * @brief Find and return all connected components in a graph (represented by
+ * the @p adjList ), where adjacent verts only connect if they have the same
+ * key in @p vertKeys.
  *
- * @tparam The type of the conditioning variable.
- * @param adjList A reference to the mesh's adjacency list.  IDX of list is
- * src vert index in owning vert list, value is dest vert index in vert
- * list.
- * @param clrVec A reference to the per-vertex identifiers used to condition
- * the CC (not necessarily a color).
- * @param vIDX The index of the src vertex of this part of the CC.
- * @param visited Per-vertex visitation record.
- * @param clr The CC's identifying "color"/tag, to be matched by adjacent
- * verts for membership in CC.
- * @param setOfVerts Aggregation of verts in the CC.
+ * Uses union-find. Keys are split into partitions processed in parallel,
+ * which is safe as verts can only ever be joined with verts of the same key.
+ * @param adjList A reference to the mesh's per-vertex adjacency list.
+ * @param vertKeys The per-vertex keys used to condition the CC.
+ * @return an unordered map, keyed by vertex key, where the value is a vector
+ * of all sets of CCs consisting of verts with that key, in order of each
+ * CC's lowest vertex index.
  */
-template <class T>
-void conditionalDFS(const std::vector<std::set<uint32_t>>& adjList,
-                    const std::vector<T>& clrVec,
-                    uint32_t vIDX,
-                    std::vector<bool>& visited,
-                    const T& clr,
-                    std::set<uint32_t>& setOfVerts) {
-  setOfVerts.insert(vIDX);
-  visited[vIDX] = true;
-  // for every adjacent vertex
-  for (auto it = adjList[vIDX].begin(); it != adjList[vIDX].end(); ++it) {
-    // make sure not visited and color matches
-    if ((!visited[*it]) && (clrVec[*it] == clr)) {
-      conditionalDFS(adjList, clrVec, *it, visited, clr, setOfVerts);
-    }
-  }
-}  // conditionalDFS
+std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>> findCCsByKey(
+    const AdjacencyList& adjList,
+    const std::vector<uint32_t>& vertKeys);
 
 /**
  * @brief Find and return all connected components in a graph (represented by
  * the @p adjList ), that match some specified per-vertex tag/"color".
  * @tparam The type of the CC conditioning variable.
- * @param adjList A reference to the mesh's per-vertex adjacency list.  IDX of
- * list is src vert index in owning vert list, value is dest vert index in
- * vert list.
+ * @param adjList A reference to the mesh's per-vertex adjacency list.
  * @param clrVec A reference to the per-vertex identifiers used to condition
  * the CC (not necessarily a color).
  * @return an unordered map, keyed by tag/color value encoded as int, where
  * the value is a vector of all sets of CCs consisting of verts with specified
- * tag/"color".
+ * tag/"color". See @ref findCCsByKey.
  */
 template <class T>
 std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
-findCCsByGivenColor(const std::vector<std::set<uint32_t>>& adjList,
+findCCsByGivenColor(const AdjacencyList& adjList,
                     const std::vector<T>& clrVec) {
-  // standard dfs implementation of CC builder, with added conditioning on
-  // some per-vert characteristic (in this case, vertex color)
-  auto numVerts = adjList.size();
-  std::vector<bool> visited(numVerts, false);
-  std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>
-      clrsToComponents(numVerts);
-  for (uint32_t vIDX = 0; vIDX < numVerts; ++vIDX) {
-    if (!visited[vIDX]) {
-      // initialize CC's set of member verts
-      std::set<uint32_t> setOfVerts{};
-      // vert's color for membership in CC
-      const auto vertColor = clrVec[vIDX];
-      // build CC of connected verts that share vertColor
-      conditionalDFS(adjList, clrVec, vIDX, visited, vertColor, setOfVerts);
-      // convert color/tag to key for map
-      const uint32_t colorKey = getValueAsUInt(vertColor);
-      if (colorKey == ~uint32_t(0)) {
-        return {};
-      }
-      // find or build map entry keyed by color of vert set for CC
-      auto findIter = clrsToComponents.find(colorKey);
-      if (findIter == clrsToComponents.end()) {
-        // not found already, so add new entry
-        findIter = clrsToComponents.insert({colorKey, {}}).first;
-      }
-      // move set to map entry of CC sets with specified color
-      findIter->second.push_back(std::move(setOfVerts));
+  // convert color/tag to key for map
+  std::vector<uint32_t> vertKeys(adjList.size());
+  for (std::size_t vIDX = 0; vIDX < vertKeys.size(); ++vIDX) {
+    vertKeys[vIDX] = getValueAsUInt(clrVec[vIDX]);
+    if (vertKeys[vIDX] == ~uint32_t(0)) {
+      return {};
     }
   }
-  return clrsToComponents;
+  return findCCsByKey(adjList, vertKeys);
 }  // findCCsByGivenColor
 
 template <typename T>
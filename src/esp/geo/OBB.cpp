@@ -7,6 +7,8 @@
 #include <array>
 #include <vector>
 
+#include <Eigen/Eigenvalues>
+
 #include "esp/core/Check.h"
 #include "esp/geo/Geo.h"
 
@@ -236,6 +238,11 @@ OBB computeGravityAlignedMOBB(const vec3f& gravity,
       best_area = area;
     }
   }
+  if (!best_bottom_dir.allFinite()) {
+    // degenerate hull, e.g. all points on a line, so any orientation is as
+    // good as another
+    best_bottom_dir = vec2f::UnitX();
+  }
   const auto T_w2b =
       quatf::FromTwoVectors(vec3f(best_bottom_dir[0], best_bottom_dir[1], 0),
                             vec3f::UnitX()) *
@@ -250,5 +257,73 @@ OBB computeGravityAlignedMOBB(const vec3f& gravity,
   return OBB{T_w2b.inverse() * aabb.center(), aabb.sizes(), T_w2b.inverse()};
 }
 
+namespace {
+// box bounding points in the frame rotated from world by T_w2b
+OBB computeOBBInFrame(const quatf& T_w2b, const std::vector<vec3f>& points) {
+  box3f aabb;
+  aabb.setEmpty();
+  for (const auto& pt : points) {
+    aabb.extend(T_w2b * pt);
+  }
+  return OBB{T_w2b.inverse() * aabb.center(), aabb.sizes(), T_w2b.inverse()};
+}
+}  // namespace
+
+OBB computeMinVolumeOBB(const std::vector<vec3f>& points) {
+  if (points.empty()) {
+    return OBB{};
+  }
+  OBB best = computeOBBInFrame(quatf::Identity(), points);
+  if (points.size() < 4) {
+    return best;
+  }
+
+  // principal axes of the points
+  vec3f mean = vec3f::Zero();
+  for (const auto& pt : points) {
+    mean += pt;
+  }
+  mean /= static_cast<float>(points.size());
+  mat3f covariance = mat3f::Zero();
+  for (const auto& pt : points) {
+    const vec3f d = pt - mean;
+    covariance += d * d.transpose();
+  }
+  const Eigen::SelfAdjointEigenSolver<mat3f> solver(covariance);
+  mat3f axes = solver.eigenvectors();
+  if (axes.determinant() < 0.0f) {
+    axes.col(0) = -axes.col(0);
+  }
+  const OBB pcaOBB = computeOBBInFrame(quatf(axes).inverse(), points);
+  if (pcaOBB.volume() < best.volume()) {
+    best = pcaOBB;
+  }
+
+  // principal axes are only a guess, especially for symmetric or very uneven
+  // point distributions, so keep one box axis fixed at a time and rotate the
+  // other two to the minimum area rectangle, as long as that helps
+  constexpr int maxRefinements = 3;
+  for (int refinement = 0; refinement < maxRefinements; ++refinement) {
+    bool improved = false;
+    for (int axis = 0; axis < 3; ++axis) {
+      const vec3f sizes = best.sizes();
+      // flat boxes project to a degenerate hull and can't improve anyway
+      if (sizes[(axis + 1) % 3] <= 1e-6f || sizes[(axis + 2) % 3] <= 1e-6f) {
+        continue;
+      }
+      const OBB candidate = computeGravityAlignedMOBB(
+          -(best.rotation() * vec3f::Unit(axis)), points);
+      if (candidate.volume() < best.volume() * (1.0f - 1e-4f)) {
+        best = candidate;
+        improved = true;
+      }
+    }
+    if (!improved) {
+      break;
+    }
+  }
+  return best;
+}
+
 }  // namespace geo
 }  // namespace esp
@@ -82,6 +82,12 @@ inline std::ostream& operator<<(std::ostream& os, const OBB& obb) {
 OBB computeGravityAlignedMOBB(const vec3f& gravity,
                               const std::vector<vec3f>& points);
 
+// compute a tight, approximately minimum volume OBB containing given points in
+// any orientation. Starts from the principal axes of the points and refines
+// the box by fitting a minimum area rectangle around each of its axes in turn
+// while that keeps shrinking it. Considerably slower than an AABB.
+OBB computeMinVolumeOBB(const std::vector<vec3f>& points);
+
 }  // namespace geo
 }  // namespace esp
 
@@ -0,0 +1,437 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "OccupancyGrid.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/Functions.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <tuple>
+
+#include "esp/core/Check.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+constexpr Mn::UnsignedInt occupancyCacheVersion = 1;
+constexpr char occupancyCacheMagic[4]{'H', 'S', 'O', 'G'};
+
+struct OccupancyCacheHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  float voxelSize;
+  Mn::UnsignedInt voxelCount;
+};
+
+//! Triangles voxelized by a thread at a time
+constexpr std::size_t TrianglesPerTask = 4096;
+
+bool voxelLess(const Mn::Vector3i& a, const Mn::Vector3i& b) {
+  return std::make_tuple(a.x(), a.y(), a.z()) <
+         std::make_tuple(b.x(), b.y(), b.z());
+}
+
+/**
+ * @brief Floor division, rounding towards negative infinity also for
+ * negative @p value
+ */
+int floorDivide(int value, int divisor) {
+  return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+/**
+ * @brief Separating axis test of a triangle against a box, after
+ * Akenine-Möller, "Fast 3D Triangle-Box Overlap Testing"
+ */
+bool triangleOverlapsBox(const Mn::Vector3& center,
+                         const Mn::Vector3& halfSize,
+                         const Mn::Vector3& a,
+                         const Mn::Vector3& b,
+                         const Mn::Vector3& c) {
+  const Mn::Vector3 v[]{a - center, b - center, c - center};
+
+  // the box face normals, i.e. the bounding box of the triangle
+  for (std::size_t axis = 0; axis != 3; ++axis) {
+    if (std::min({v[0][axis], v[1][axis], v[2][axis]}) > halfSize[axis] ||
+        std::max({v[0][axis], v[1][axis], v[2][axis]}) < -halfSize[axis]) {
+      return false;
+    }
+  }
+
+  // the triangle plane
+  const Mn::Vector3 edges[]{v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+  const Mn::Vector3 normal = Mn::Math::cross(edges[0], edges[1]);
+  if (Mn::Math::abs(Mn::Math::dot(normal, v[0])) >
+      Mn::Math::dot(halfSize, Mn::Math::abs(normal))) {
+    return false;
+  }
+
+  // cross products of the triangle edges with the box axes
+  for (const Mn::Vector3& edge : edges) {
+    for (std::size_t axis = 0; axis != 3; ++axis) {
+      Mn::Vector3 boxAxis;
+      boxAxis[axis] = 1.0f;
+      const Mn::Vector3 separatingAxis = Mn::Math::cross(boxAxis, edge);
+      const float p0 = Mn::Math::dot(separatingAxis, v[0]);
+      const float p1 = Mn::Math::dot(separatingAxis, v[1]);
+      const float p2 = Mn::Math::dot(separatingAxis, v[2]);
+      const float radius =
+          Mn::Math::dot(halfSize, Mn::Math::abs(separatingAxis));
+      if (std::min({p0, p1, p2}) > radius ||
+          std::max({p0, p1, p2}) < -radius) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::size_t OccupancyGrid::VoxelHash::operator()(
+    const Mn::Vector3i& voxel) const {
+  return std::size_t(voxel.x()) * 73856093u ^
+         std::size_t(voxel.y()) * 19349663u ^
+         std::size_t(voxel.z()) * 83492791u;
+}
+
+OccupancyGrid::OccupancyGrid(float voxelSize) : voxelSize_{voxelSize} {
+  ESP_CHECK(voxelSize > 0.0f,
+            "OccupancyGrid: expected a positive voxel size but got"
+                << voxelSize);
+}
+
+Mn::Vector3i OccupancyGrid::voxelAt(const Mn::Vector3& point) const {
+  return Mn::Vector3i{Mn::Math::floor(point / voxelSize_)};
+}
+
+Mn::Range3D OccupancyGrid::voxelBounds(const Mn::Vector3i& voxel) const {
+  const Mn::Vector3 min = Mn::Vector3{voxel} * voxelSize_;
+  return {min, min + Mn::Vector3{voxelSize_}};
+}
+
+void OccupancyGrid::setSource(
+    int sourceId,
+    Cr::Containers::ArrayView<const Mn::Vector3> positions,
+    Cr::Containers::ArrayView<const std::uint32_t> indices,
+    const Mn::Matrix4& transformation,
+    int numThreads) {
+  ESP_CHECK(indices.size() % 3 == 0,
+            "OccupancyGrid::setSource(): expected a multiple of three indices "
+            "but got"
+                << indices.size());
+  for (const std::uint32_t index : indices) {
+    ESP_CHECK(index < positions.size(),
+              "OccupancyGrid::setSource(): index" << index << "out of range for"
+                                                  << positions.size()
+                                                  << "vertices");
+  }
+
+  const std::size_t triangleCount = indices.size() / 3;
+  const std::size_t taskCount =
+      (triangleCount + TrianglesPerTask - 1) / TrianglesPerTask;
+  std::size_t threadCount =
+      numThreads > 0 ? std::size_t(numThreads)
+                     : std::max(1u, std::thread::hardware_concurrency());
+  // not worth a thread for less than a task worth of triangles
+  threadCount = std::max<std::size_t>(1, std::min(threadCount, taskCount));
+
+  const Mn::Vector3 halfSize{voxelSize_ * 0.5f};
+  std::atomic<std::size_t> nextTask{0};
+  std::vector<std::vector<Mn::Vector3i>> threadVoxels(threadCount);
+  const auto voxelizeTasks = [&](std::size_t thread) {
+    std::vector<Mn::Vector3i>& voxels = threadVoxels[thread];
+    for (std::size_t task; (task = nextTask++) < taskCount;) {
+      const std::size_t end =
+          std::min(triangleCount, (task + 1) * TrianglesPerTask);
+      for (std::size_t i = task * TrianglesPerTask; i != end; ++i) {
+        const Mn::Vector3 a =
+            transformation.transformPoint(positions[indices[3 * i]]);
+        const Mn::Vector3 b =
+            transformation.transformPoint(positions[indices[3 * i + 1]]);
+        const Mn::Vector3 c =
+            transformation.transformPoint(positions[indices[3 * i + 2]]);
+        const Mn::Vector3i min = voxelAt(Mn::Math::min(a, Mn::Math::min(b, c)));
+        const Mn::Vector3i max = voxelAt(Mn::Math::max(a, Mn::Math::max(b, c)));
+        for (int z = min.z(); z <= max.z(); ++z) {
+          for (int y = min.y(); y <= max.y(); ++y) {
+            for (int x = min.x(); x <= max.x(); ++x) {
+              const Mn::Vector3i voxel{x, y, z};
+              if (triangleOverlapsBox(voxelBounds(voxel).center(), halfSize, a,
+                                      b, c)) {
+                voxels.push_back(voxel);
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < threadCount; ++i) {
+    workers.emplace_back(voxelizeTasks, i);
+  }
+  voxelizeTasks(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  std::vector<Mn::Vector3i> voxels = std::move(threadVoxels[0]);
+  for (std::size_t i = 1; i < threadCount; ++i) {
+    voxels.insert(voxels.end(), threadVoxels[i].begin(),
+                  threadVoxels[i].end());
+  }
+  std::sort(voxels.begin(), voxels.end(), voxelLess);
+  voxels.erase(std::unique(voxels.begin(), voxels.end()), voxels.end());
+  replaceSource(sourceId, std::move(voxels));
+}
+
+bool OccupancyGrid::removeSource(int sourceId) {
+  auto found = sources_.find(sourceId);
+  if (found == sources_.end()) {
+    return false;
+  }
+  removeVoxels(found->second);
+  sources_.erase(found);
+  return true;
+}
+
+std::vector<int> OccupancyGrid::sourceIds() const {
+  std::vector<int> ids;
+  ids.reserve(sources_.size());
+  for (const auto& source : sources_) {
+    ids.push_back(source.first);
+  }
+  return ids;
+}
+
+const std::vector<Mn::Vector3i>& OccupancyGrid::sourceVoxels(
+    int sourceId) const {
+  auto found = sources_.find(sourceId);
+  ESP_CHECK(found != sources_.end(),
+            "OccupancyGrid::sourceVoxels(): no source with ID" << sourceId);
+  return found->second;
+}
+
+void OccupancyGrid::clear() {
+  blocks_.clear();
+  sources_.clear();
+  occupiedVoxelCount_ = 0;
+}
+
+bool OccupancyGrid::isVoxelOccupied(const Mn::Vector3i& voxel) const {
+  const Mn::Vector3i block{floorDivide(voxel.x(), BlockSize),
+                           floorDivide(voxel.y(), BlockSize),
+                           floorDivide(voxel.z(), BlockSize)};
+  auto found = blocks_.find(block);
+  if (found == blocks_.end()) {
+    return false;
+  }
+  const Mn::Vector3i local = voxel - block * BlockSize;
+  return found->second
+             .counts[(local.z() * BlockSize + local.y()) * BlockSize +
+                     local.x()] != 0;
+}
+
+void OccupancyGrid::isOccupied(
+    Cr::Containers::ArrayView<const Mn::Vector3> points,
+    Cr::Containers::ArrayView<bool> occupied) const {
+  ESP_CHECK(occupied.size() == points.size(),
+            "OccupancyGrid::isOccupied(): expected" << points.size()
+                                                    << "outputs but got"
+                                                    << occupied.size());
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    occupied[i] = isOccupied(points[i]);
+  }
+}
+
+bool OccupancyGrid::isBoxOccupied(const Mn::Range3D& box) const {
+  const Mn::Vector3i min = voxelAt(box.min());
+  const Mn::Vector3i max = voxelAt(box.max());
+  const Mn::Vector3i blockMin{floorDivide(min.x(), BlockSize),
+                              floorDivide(min.y(), BlockSize),
+                              floorDivide(min.z(), BlockSize)};
+  const Mn::Vector3i blockMax{floorDivide(max.x(), BlockSize),
+                              floorDivide(max.y(), BlockSize),
+                              floorDivide(max.z(), BlockSize)};
+  for (int bz = blockMin.z(); bz <= blockMax.z(); ++bz) {
+    for (int by = blockMin.y(); by <= blockMax.y(); ++by) {
+      for (int bx = blockMin.x(); bx <= blockMax.x(); ++bx) {
+        const Mn::Vector3i block{bx, by, bz};
+        auto found = blocks_.find(block);
+        if (found == blocks_.end()) {
+          continue;
+        }
+        // voxels of the box inside this block, in block-local coordinates
+        const Mn::Vector3i localMin =
+            Mn::Math::max(min - block * BlockSize, Mn::Vector3i{0});
+        const Mn::Vector3i localMax =
+            Mn::Math::min(max - block * BlockSize, Mn::Vector3i{BlockSize - 1});
+        for (int z = localMin.z(); z <= localMax.z(); ++z) {
+          for (int y = localMin.y(); y <= localMax.y(); ++y) {
+            for (int x = localMin.x(); x <= localMax.x(); ++x) {
+              if (found->second
+                      .counts[(z * BlockSize + y) * BlockSize + x] != 0) {
+                return true;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+void OccupancyGrid::isBoxOccupied(
+    Cr::Containers::ArrayView<const Mn::Range3D> boxes,
+    Cr::Containers::ArrayView<bool> occupied) const {
+  ESP_CHECK(occupied.size() == boxes.size(),
+            "OccupancyGrid::isBoxOccupied(): expected" << boxes.size()
+                                                       << "outputs but got"
+                                                       << occupied.size());
+  for (std::size_t i = 0; i != boxes.size(); ++i) {
+    occupied[i] = isBoxOccupied(boxes[i]);
+  }
+}
+
+bool OccupancyGrid::saveSource(int sourceId,
+                               const std::string& filename) const {
+  const std::vector<Mn::Vector3i>& voxels = sourceVoxels(sourceId);
+  OccupancyCacheHeader header;
+  std::memcpy(header.magic, occupancyCacheMagic, sizeof(occupancyCacheMagic));
+  header.version = occupancyCacheVersion;
+  header.voxelSize = voxelSize_;
+  header.voxelCount = Mn::UnsignedInt(voxels.size());
+  Cr::Containers::Array<char> data{
+      Cr::NoInit,
+      sizeof(OccupancyCacheHeader) + voxels.size() * sizeof(Mn::Vector3i)};
+  std::memcpy(data.data(), &header, sizeof(OccupancyCacheHeader));
+  if (!voxels.empty()) {
+    std::memcpy(data.data() + sizeof(OccupancyCacheHeader), voxels.data(),
+                voxels.size() * sizeof(Mn::Vector3i));
+  }
+  if (!Cr::Utility::Path::make(Cr::Utility::Path::split(filename).first())) {
+    return false;
+  }
+  // other processes may be reading the same cache file, so only move the
+  // file in place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&data));
+  return Cr::Utility::Path::write(tmpFilename, data) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}
+
+bool OccupancyGrid::loadSource(int sourceId, const std::string& filename) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  if (!data || data->size() < sizeof(OccupancyCacheHeader)) {
+    return false;
+  }
+  OccupancyCacheHeader header;
+  std::memcpy(&header, data->data(), sizeof(OccupancyCacheHeader));
+  if (std::memcmp(header.magic, occupancyCacheMagic,
+                  sizeof(occupancyCacheMagic)) ||
+      header.version != occupancyCacheVersion ||
+      header.voxelSize != voxelSize_ ||
+      data->size() != sizeof(OccupancyCacheHeader) +
+                          std::size_t(header.voxelCount) *
+                              sizeof(Mn::Vector3i)) {
+    return false;
+  }
+  std::vector<Mn::Vector3i> voxels(header.voxelCount);
+  if (!voxels.empty()) {
+    std::memcpy(voxels.data(), data->data() + sizeof(OccupancyCacheHeader),
+                voxels.size() * sizeof(Mn::Vector3i));
+  }
+  // removing voxels relies on them being unique
+  if (!std::is_sorted(voxels.begin(), voxels.end(), voxelLess) ||
+      std::adjacent_find(voxels.begin(), voxels.end()) != voxels.end()) {
+    return false;
+  }
+  replaceSource(sourceId, std::move(voxels));
+  return true;
+}
+
+void OccupancyGrid::addVoxels(const std::vector<Mn::Vector3i>& voxels) {
+  Block* block = nullptr;
+  Mn::Vector3i blockCoords;
+  for (const Mn::Vector3i& voxel : voxels) {
+    const Mn::Vector3i coords{floorDivide(voxel.x(), BlockSize),
+                              floorDivide(voxel.y(), BlockSize),
+                              floorDivide(voxel.z(), BlockSize)};
+    // sorted voxels of neighboring x mostly share a block, skip the lookup
+    if (!block || coords != blockCoords) {
+      block = &blocks_[coords];
+      blockCoords = coords;
+    }
+    const Mn::Vector3i local = voxel - coords * BlockSize;
+    std::uint16_t& count =
+        block->counts[(local.z() * BlockSize + local.y()) * BlockSize +
+                      local.x()];
+    CORRADE_INTERNAL_ASSERT(count != 0xffff);
+    if (!count++) {
+      ++block->occupiedCount;
+      ++occupiedVoxelCount_;
+    }
+  }
+}
+
+void OccupancyGrid::removeVoxels(const std::vector<Mn::Vector3i>& voxels) {
+  for (const Mn::Vector3i& voxel : voxels) {
+    const Mn::Vector3i coords{floorDivide(voxel.x(), BlockSize),
+                              floorDivide(voxel.y(), BlockSize),
+                              floorDivide(voxel.z(), BlockSize)};
+    auto found = blocks_.find(coords);
+    CORRADE_INTERNAL_ASSERT(found != blocks_.end());
+    const Mn::Vector3i local = voxel - coords * BlockSize;
+    std::uint16_t& count =
+        found->second
+            .counts[(local.z() * BlockSize + local.y()) * BlockSize +
+                    local.x()];
+    CORRADE_INTERNAL_ASSERT(count != 0);
+    if (!--count) {
+      --occupiedVoxelCount_;
+      if (!--found->second.occupiedCount) {
+        blocks_.erase(found);
+      }
+    }
+  }
+}
+
+void OccupancyGrid::replaceSource(int sourceId,
+                                  std::vector<Mn::Vector3i>&& voxels) {
+  // add first, so voxels shared by the old and new state of a source don't
+  // free and reallocate their block
+  addVoxels(voxels);
+  auto found = sources_.find(sourceId);
+  if (found != sources_.end()) {
+    removeVoxels(found->second);
+    found->second = std::move(voxels);
+  } else {
+    sources_.emplace(sourceId, std::move(voxels));
+  }
+}
+
+}  // namespace geo
+}  // namespace esp
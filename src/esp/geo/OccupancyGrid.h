@@ -0,0 +1,194 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GEO_OCCUPANCYGRID_H_
+#define ESP_GEO_OCCUPANCYGRID_H_
+
+/** @file
+ * @brief Class @ref esp::geo::OccupancyGrid
+ */
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Sparse voxel occupancy grid of triangle geometry
+ *
+ * Space is divided into cubic voxels of @ref voxelSize() with voxel
+ * @f$ (x, y, z) @f$ spanning @f$ [x, x + 1) \cdot s @f$ along X and so on. A
+ * voxel is occupied if a triangle of any source touches it. Occupied voxels
+ * are stored in blocks of 8×8×8 voxels, allocated only where there is
+ * geometry, so large mostly empty scenes stay small.
+ *
+ * Geometry is added in *sources*, identified by an integer ID, for example
+ * the stage and each object of a scene. Voxels keep a count of the sources
+ * occupying them, so a single source can be replaced with
+ * @ref setSource(), e.g. after the object moved, or removed with
+ * @ref removeSource() without voxelizing the rest again.
+ *
+ * Voxelization tests every voxel touched by a triangle's bounding box
+ * against the triangle with the separating axis test, spreading the
+ * triangles of a source over threads. Voxels of a source can be saved to and
+ * loaded from a file with @ref saveSource() and @ref loadSource(), e.g. to
+ * voxelize a stage only once.
+ */
+class OccupancyGrid {
+ public:
+  /**
+   * @brief Constructor
+   * @param voxelSize   Edge length of a voxel, expected to be positive
+   */
+  explicit OccupancyGrid(float voxelSize);
+
+  /** @brief Edge length of a voxel */
+  float voxelSize() const { return voxelSize_; }
+
+  /** @brief Voxel containing @p point */
+  Magnum::Vector3i voxelAt(const Magnum::Vector3& point) const;
+
+  /** @brief Bounds of @p voxel */
+  Magnum::Range3D voxelBounds(const Magnum::Vector3i& voxel) const;
+
+  /**
+   * @brief Voxelize a triangle mesh as source @p sourceId
+   * @param sourceId        Source ID. Voxels of a previous source of the
+   *    same ID are replaced.
+   * @param positions       Vertex positions
+   * @param indices         Triangle indices, three per triangle
+   * @param transformation  Transformation of @p positions to the grid
+   * @param numThreads      Number of threads to voxelize with. If zero or
+   *    negative, one per hardware core is used for large meshes.
+   */
+  void setSource(
+      int sourceId,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+      Corrade::Containers::ArrayView<const std::uint32_t> indices,
+      const Magnum::Matrix4& transformation = {},
+      int numThreads = 0);
+
+  /**
+   * @brief Remove source @p sourceId
+   * @return Whether there was such source
+   */
+  bool removeSource(int sourceId);
+
+  /** @brief Whether there is a source @p sourceId */
+  bool hasSource(int sourceId) const { return sources_.count(sourceId) != 0; }
+
+  /** @brief Count of sources */
+  std::size_t sourceCount() const { return sources_.size(); }
+
+  /** @brief IDs of all sources, in no particular order */
+  std::vector<int> sourceIds() const;
+
+  /** @brief Voxels occupied by source @p sourceId, sorted */
+  const std::vector<Magnum::Vector3i>& sourceVoxels(int sourceId) const;
+
+  /** @brief Count of voxels occupied by any source */
+  std::size_t occupiedVoxelCount() const { return occupiedVoxelCount_; }
+
+  /** @brief Count of allocated blocks */
+  std::size_t blockCount() const { return blocks_.size(); }
+
+  /** @brief Remove all sources */
+  void clear();
+
+  /** @brief Whether @p voxel is occupied */
+  bool isVoxelOccupied(const Magnum::Vector3i& voxel) const;
+
+  /** @brief Whether the voxel containing @p point is occupied */
+  bool isOccupied(const Magnum::Vector3& point) const {
+    return isVoxelOccupied(voxelAt(point));
+  }
+
+  /**
+   * @brief Whether the voxels containing a batch of points are occupied
+   * @param points        Query points
+   * @param[out] occupied Results, expected to have the same size as
+   *    @p points
+   */
+  void isOccupied(Corrade::Containers::ArrayView<const Magnum::Vector3> points,
+                  Corrade::Containers::ArrayView<bool> occupied) const;
+
+  /**
+   * @brief Whether any voxel overlapping @p box is occupied
+   *
+   * Empty blocks are skipped whole, so large boxes in free space are cheap.
+   */
+  bool isBoxOccupied(const Magnum::Range3D& box) const;
+
+  /**
+   * @brief Whether any voxel overlapping each of a batch of boxes is
+   * occupied
+   * @param boxes         Query boxes
+   * @param[out] occupied Results, expected to have the same size as
+   *    @p boxes
+   */
+  void isBoxOccupied(
+      Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+      Corrade::Containers::ArrayView<bool> occupied) const;
+
+  /**
+   * @brief Save the voxels of source @p sourceId to @p filename
+   * @return Whether the file was written
+   */
+  bool saveSource(int sourceId, const std::string& filename) const;
+
+  /**
+   * @brief Load the voxels of source @p sourceId from @p filename
+   * @return Whether the file was read. Fails if it doesn't exist, isn't a
+   *    file written by @ref saveSource() or was written with a different
+   *    @ref voxelSize().
+   *
+   * Voxels of a previous source of the same ID are replaced.
+   */
+  bool loadSource(int sourceId, const std::string& filename);
+
+ private:
+  //! Voxels along each side of a block
+  static constexpr int BlockSize = 8;
+
+  //! Count of sources occupying each voxel of a block, x fastest
+  struct Block {
+    std::array<std::uint16_t, BlockSize * BlockSize * BlockSize> counts{};
+    //! count of voxels with a non-zero count
+    int occupiedCount = 0;
+  };
+
+  struct VoxelHash {
+    std::size_t operator()(const Magnum::Vector3i& voxel) const;
+  };
+
+  void addVoxels(const std::vector<Magnum::Vector3i>& voxels);
+  void removeVoxels(const std::vector<Magnum::Vector3i>& voxels);
+  void replaceSource(int sourceId, std::vector<Magnum::Vector3i>&& voxels);
+
+  float voxelSize_;
+  std::unordered_map<Magnum::Vector3i, Block, VoxelHash> blocks_;
+  //! sorted voxels of each source
+  std::unordered_map<int, std::vector<Magnum::Vector3i>> sources_;
+  std::size_t occupiedVoxelCount_ = 0;
+
+ public:
+  ESP_SMART_POINTERS(OccupancyGrid)
+};
+
+}  // namespace geo
+}  // namespace esp
+
+#endif  // ESP_GEO_OCCUPANCYGRID_H_
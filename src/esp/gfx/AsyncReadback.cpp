@@ -0,0 +1,155 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AsyncReadback.h"
+
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/BufferImage.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <vector>
+
+#include "esp/core/Check.h"
+
+#ifndef MAGNUM_TARGET_WEBGL
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+struct AsyncReadback::Impl {
+  struct Slot {
+    Mn::GL::BufferImage2D image;
+    GLsync fence;
+  };
+
+  Impl(Mn::PixelFormat format, std::size_t slotCount) {
+    ESP_CHECK(slotCount > 0,
+              "AsyncReadback: the ring needs at least one pixel buffer");
+    slots_.reserve(slotCount);
+    for (std::size_t i = 0; i != slotCount; ++i) {
+      slots_.push_back(Slot{Mn::GL::BufferImage2D{format}, nullptr});
+    }
+  }
+
+  ~Impl() {
+    for (Slot& slot : slots_) {
+      if (slot.fence) {
+        glDeleteSync(slot.fence);
+      }
+    }
+  }
+
+  std::size_t slotCount() const { return slots_.size(); }
+
+  std::size_t pendingCount() const { return pending_; }
+
+  std::size_t gpuMemoryUsage() const {
+    std::size_t usage = 0;
+    for (const Slot& slot : slots_) {
+      usage += slot.image.dataSize();
+    }
+    return usage;
+  }
+
+  bool isReady() const {
+    if (!pending_) {
+      return false;
+    }
+    const GLenum status = glClientWaitSync(slots_[first_].fence, 0, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+  }
+
+  void start(const std::function<void(Mn::GL::BufferImage2D&)>& read) {
+    ESP_CHECK(pending_ < slots_.size(),
+              "AsyncReadback::start(): all"
+                  << slots_.size()
+                  << "pixel buffers are pending, finish() the oldest first");
+    Slot& slot = slots_[(first_ + pending_) % slots_.size()];
+    read(slot.image);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++pending_;
+  }
+
+  bool finish(const Mn::MutableImageView2D& view) {
+    if (!pending_) {
+      return false;
+    }
+    Slot& slot = slots_[first_];
+
+    // flushing on the first wait makes sure the fence eventually signals
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (status == GL_TIMEOUT_EXPIRED) {
+      status = glClientWaitSync(slot.fence, waitFlags, 1000000);
+      waitFlags = 0;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    first_ = (first_ + 1) % slots_.size();
+    --pending_;
+    ESP_CHECK(status != GL_WAIT_FAILED,
+              "AsyncReadback::finish(): waiting for the read failed");
+
+    Mn::GL::BufferImage2D& image = slot.image;
+    ESP_CHECK(view.size() == image.size() &&
+                  view.pixelSize() == image.pixelSize(),
+              "AsyncReadback::finish(): expected a view of"
+                  << image.size() << "pixels with" << image.pixelSize()
+                  << "bytes each but got" << view.size() << "pixels with"
+                  << view.pixelSize());
+
+    const Cr::Containers::ArrayView<const char> data = image.buffer().map(
+        0, image.dataSize(), Mn::GL::Buffer::MapFlag::Read);
+    Cr::Utility::copy(Mn::ImageView2D{image.storage(), image.format(),
+                                      image.type(), image.size(), data}
+                          .pixels(),
+                      view.pixels());
+    image.buffer().unmap();
+    return true;
+  }
+
+ private:
+  std::vector<Slot> slots_;
+  //! Oldest pending slot
+  std::size_t first_ = 0;
+  std::size_t pending_ = 0;
+};
+
+AsyncReadback::AsyncReadback(Mn::PixelFormat format, std::size_t slotCount)
+    : pimpl_(spimpl::make_unique_impl<Impl>(format, slotCount)) {}
+
+std::size_t AsyncReadback::slotCount() const {
+  return pimpl_->slotCount();
+}
+
+std::size_t AsyncReadback::pendingCount() const {
+  return pimpl_->pendingCount();
+}
+
+std::size_t AsyncReadback::gpuMemoryUsage() const {
+  return pimpl_->gpuMemoryUsage();
+}
+
+bool AsyncReadback::isReady() const {
+  return pimpl_->isReady();
+}
+
+void AsyncReadback::start(
+    const std::function<void(Mn::GL::BufferImage2D&)>& read) {
+  pimpl_->start(read);
+}
+
+bool AsyncReadback::finish(const Mn::MutableImageView2D& view) {
+  return pimpl_->finish(view);
+}
+
+}  // namespace gfx
+}  // namespace esp
+#endif
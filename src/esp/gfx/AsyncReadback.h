@@ -0,0 +1,79 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_ASYNCREADBACK_H_
+#define ESP_GFX_ASYNCREADBACK_H_
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/Magnum.h>
+#include <functional>
+
+#include "esp/core/Esp.h"
+
+#ifndef MAGNUM_TARGET_WEBGL
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Ring of pixel buffers for reading rendering results back without
+ * stalling on the GPU
+ *
+ * @ref start() lets the caller queue a framebuffer read into the next pixel
+ * buffer of the ring and fences it, returning as soon as the read is issued.
+ * @ref finish() waits for the oldest read and copies it to CPU memory, so the
+ * results of frame N can be retrieved while frame N + 1 renders.
+ */
+class AsyncReadback {
+ public:
+  /**
+   * @brief Constructor
+   * @param format     Pixel format the results are read in
+   * @param slotCount  How many reads can be pending at once
+   */
+  explicit AsyncReadback(Magnum::PixelFormat format,
+                         std::size_t slotCount = 2);
+
+  /** @brief How many reads can be pending at once */
+  std::size_t slotCount() const;
+
+  /** @brief Number of reads started and not finished yet */
+  std::size_t pendingCount() const;
+
+  /**
+   * @brief Whether the oldest pending read completed, so @ref finish() won't
+   * wait. False if no read is pending.
+   */
+  bool isReady() const;
+
+  /**
+   * @brief GPU memory of the pixel buffers, in bytes. Each grows to the size
+   * of the largest read issued into it.
+   */
+  std::size_t gpuMemoryUsage() const;
+
+  /**
+   * @brief Queue a read into the next pixel buffer of the ring
+   * @param read Issues the read into the given image, e.g. through
+   * @ref RenderTarget::readFrameRgba(Magnum::GL::BufferImage2D&)
+   *
+   * Expects that fewer than @ref slotCount() reads are pending.
+   */
+  void start(const std::function<void(Magnum::GL::BufferImage2D&)>& read);
+
+  /**
+   * @brief Wait for the oldest pending read and copy its result
+   * @param[in, out] view Preallocated memory of the size and pixel size that
+   * was read
+   * @return false if no read is pending
+   */
+  bool finish(const Magnum::MutableImageView2D& view);
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(AsyncReadback)
+};
+
+}  // namespace gfx
+}  // namespace esp
+#endif
+
+#endif  // ESP_GFX_ASYNCREADBACK_H_
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "BackgroundRenderer.h"
+#include "Drawable.h"
 #include "RenderTarget.h"
 #include "Renderer.h"
 
@@ -11,6 +12,7 @@
 #include <thread>
 
 #include "esp/core/Check.h"
+#include "esp/core/ThreadAffinity.h"
 #include "esp/sensor/VisualSensor.h"
 
 namespace Mn = Magnum;
@@ -82,19 +84,77 @@ void BackgroundRenderer::submitRenderJob(sensor::VisualSensor& sensor,
               sensor::SensorSubType::Orthographic,
       "BackgroundRenderer:: Only Pinhole and Orthographic sensors are "
       "supported");
-  jobs_.emplace_back(std::ref(sensor), std::ref(sceneGraph), std::cref(view),
-                     flags);
+
+  auto* camera = sensor.getRenderCamera();
+  Job job{std::ref(sensor),
+          std::cref(view),
+          flags,
+          camera->node().absoluteTransformationMatrix(),
+          camera->projectionMatrix(),
+          camera->viewport(),
+          camera->getSemanticDataIDX(),
+          {}};
+  job.drawableTransforms.reserve(sceneGraph.getDrawableGroups().size());
+  for (auto& it : sceneGraph.getDrawableGroups()) {
+    it.second.prepareForDraw(*camera);
+    job.drawableTransforms.emplace_back(
+        camera->filteredDrawableTransformations(it.second, flags));
+    for (const auto& transform : job.drawableTransforms.back()) {
+      auto* drawable = dynamic_cast<Drawable*>(&transform.first.get());
+      job.readsSceneGraph |= drawable && drawable->isSkinned();
+    }
+  }
+  pendingJobs_.emplace_back(std::move(job));
 }
 
 void BackgroundRenderer::startRenderJobs() {
   waitThreadJobs();
   ensureThreadInit();
+
+  // the thread is idle, so hand it everything submitted since the last frame
+  std::swap(jobs_, pendingJobs_);
+  pendingJobs_.clear();
+  prepareProxyCameras();
+
+  bool readsSceneGraph = false;
+  for (const Job& job : jobs_) {
+    readsSceneGraph |= job.readsSceneGraph;
+  }
+
   task_ = Task::Render;
-  sgLock_.store(1, std::memory_order_relaxed);
+  sgLock_.store(readsSceneGraph ? 1 : 0, std::memory_order_relaxed);
   jobsWaiting_ = jobs_.size();
   startThreadJobs();
 }
 
+void BackgroundRenderer::prepareProxyCameras() {
+  for (std::size_t i = 0; i < jobs_.size(); ++i) {
+    const Job& job = jobs_[i];
+    if (i == proxyCameras_.size()) {
+      proxyCameras_.push_back(nullptr);
+    }
+
+    // the semantic data index is fixed at construction
+    RenderCamera*& proxy = proxyCameras_[i];
+    if (proxy && proxy->getSemanticDataIDX() != job.semanticDataIDX) {
+      delete &proxy->node();
+      proxy = nullptr;
+    }
+    if (!proxy) {
+      proxy = new RenderCamera{
+          proxyScene_.getRootNode().createChild(),
+          static_cast<scene::SceneNodeSemanticDataIDX>(job.semanticDataIDX)};
+    }
+
+    Mn::Matrix4 projectionMatrix = job.projectionMatrix;
+    proxy->node().setTransformation(job.cameraTransformation);
+    proxy->setProjectionMatrix(job.viewport.x(), job.viewport.y(),
+                               projectionMatrix);
+    // cleans the camera matrix here rather than on the thread
+    proxy->cameraMatrix();
+  }
+}
+
 void BackgroundRenderer::releaseContext() {
   if (!wasInitialized())
     return;
@@ -115,56 +175,35 @@ int BackgroundRenderer::threadRender() {
     threadOwnsContext_ = true;
   }
 
-  std::vector<std::vector<RenderCamera::DrawableTransforms>> jobTransforms(
-      jobs_.size());
-
   for (size_t i = 0; i < jobs_.size(); ++i) {
     auto& job = jobs_[i];
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    scene::SceneGraph& sg = std::get<1>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
-
-    auto* camera = sensor.getRenderCamera();
-    jobTransforms[i].reserve(sg.getDrawableGroups().size());
-    for (auto& it : sg.getDrawableGroups()) {
-      it.second.prepareForDraw(*camera);
-      auto transforms = camera->drawableTransformations(it.second);
-      camera->filterTransforms(transforms, flags);
-
-      jobTransforms[i].emplace_back(std::move(transforms));
-    }
-  }
-
-  sgLock_.store(0, std::memory_order_release);
-  cpp20::atomic_notify_all(&sgLock_);
+    sensor::VisualSensor& sensor = job.sensor;
 
-  for (size_t i = 0; i < jobs_.size(); ++i) {
-    auto& job = jobs_[i];
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
-
-    if (!(flags & RenderCamera::Flag::ObjectsOnly))
+    if (!(job.flags & RenderCamera::Flag::ObjectsOnly))
       sensor.renderTarget().renderEnter();
 
-    auto* camera = sensor.getRenderCamera();
+    auto* camera = proxyCameras_[i];
 
-    for (auto& transforms : jobTransforms[i]) {
-      camera->draw(transforms, flags);
+    for (auto& transforms : job.drawableTransforms) {
+      camera->draw(transforms, job.flags);
     }
     auto sensorType = sensor.specification()->sensorType;
     if (sensorType == sensor::SensorType::Color) {
       sensor.renderTarget().tryDrawHbao();
     }
 
-    if (!(flags & RenderCamera::Flag::ObjectsOnly))
+    if (!(job.flags & RenderCamera::Flag::ObjectsOnly))
       sensor.renderTarget().renderExit();
   }
 
+  // only set when some job draws skinned drawables
+  sgLock_.store(0, std::memory_order_release);
+  cpp20::atomic_notify_all(&sgLock_);
+
   for (auto& job : jobs_) {
-    sensor::VisualSensor& sensor = std::get<0>(job);
-    const Mn::MutableImageView2D& view = std::get<2>(job);
-    RenderCamera::Flags flags = std::get<3>(job);
-    if (flags & RenderCamera::Flag::ObjectsOnly)
+    sensor::VisualSensor& sensor = job.sensor;
+    const Mn::MutableImageView2D& view = job.view;
+    if (job.flags & RenderCamera::Flag::ObjectsOnly)
       continue;
 
     auto sensorType = sensor.specification()->sensorType;
@@ -191,6 +230,7 @@ void BackgroundRenderer::threadReleaseContext() {
 }
 
 void BackgroundRenderer::runLoopThread() {
+  core::pinCurrentThread(core::ThreadRole::Render);
   context_->makeCurrent();
 
   threadOwnsContext_ = true;
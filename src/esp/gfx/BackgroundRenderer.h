@@ -37,6 +37,15 @@ class BackgroundRenderer {
   void startThreadJobs();
   void waitThreadJobs();
 
+  /**
+   * @brief Queue a render job for the next @ref startRenderJobs()
+   *
+   * The camera pose and the transformations of the visible drawables are
+   * captured right away, so the scene graph can change while the job renders.
+   * Skinned drawables read their joint nodes while drawing, so jobs with
+   * those keep the scene graph locked until drawing is done. The drawables
+   * themselves must stay alive until the job is done.
+   */
   void submitRenderJob(sensor::VisualSensor& sensor,
                        scene::SceneGraph& sceneGraph,
                        const Mn::MutableImageView2D& view,
@@ -50,6 +59,30 @@ class BackgroundRenderer {
   void threadReleaseContext();
 
  private:
+  /**
+   * @brief A render job along with everything the thread needs to draw it,
+   * captured from the scene graph at submit time
+   */
+  struct Job {
+    std::reference_wrapper<sensor::VisualSensor> sensor;
+    std::reference_wrapper<const Mn::MutableImageView2D> view;
+    RenderCamera::Flags flags;
+
+    Mn::Matrix4 cameraTransformation;
+    Mn::Matrix4 projectionMatrix;
+    Mn::Vector2i viewport;
+    int semanticDataIDX;
+
+    //! Visible drawables and their camera-relative transformations, one entry
+    //! per drawable group
+    std::vector<RenderCamera::DrawableTransforms> drawableTransforms;
+    //! Whether drawing still reads the scene graph, see @ref submitRenderJob
+    bool readsSceneGraph = false;
+  };
+
+  // poses the proxy cameras for jobs_, called while the thread is idle
+  void prepareProxyCameras();
+
   WindowlessContext* context_;
 
   std::atomic<int> done_, sgLock_, start_;
@@ -58,12 +91,15 @@ class BackgroundRenderer {
 
   bool threadOwnsContext_;
   Task task_;
-  std::vector<std::tuple<std::reference_wrapper<sensor::VisualSensor>,
-                         std::reference_wrapper<scene::SceneGraph>,
-                         std::reference_wrapper<const Mn::MutableImageView2D>,
-                         RenderCamera::Flags>>
-      jobs_;
+  // jobs submitted since the last startRenderJobs(), only touched by the
+  // main thread, and the ones the thread is rendering
+  std::vector<Job> pendingJobs_, jobs_;
   int jobsWaiting_ = 0;
+
+  // stand-ins for the sensor cameras, one per job, so the thread never reads
+  // the live scene graph
+  scene::SceneGraph proxyScene_;
+  std::vector<RenderCamera*> proxyCameras_;
 };
 }  // namespace gfx
 }  // namespace esp
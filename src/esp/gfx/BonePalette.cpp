@@ -0,0 +1,66 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BonePalette.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Assert.h>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+int BonePalette::addRange(std::size_t count) {
+  // reuse the smallest free range the new one fits into, so rigs of the same
+  // kind keep recycling each other's slots
+  int found = ID_UNDEFINED;
+  for (std::size_t i = 0; freeRanges_ && i != ranges_.size(); ++i) {
+    const Range& range = ranges_[i];
+    if (!range.used && range.capacity >= count &&
+        (found == ID_UNDEFINED || range.capacity < ranges_[found].capacity)) {
+      found = int(i);
+    }
+  }
+
+  if (found == ID_UNDEFINED) {
+    found = int(ranges_.size());
+    ranges_.push_back({matrices_.size(), count, count, true});
+    Cr::Containers::arrayResize(matrices_, matrices_.size() + count);
+  } else {
+    Range& range = ranges_[found];
+    range.count = count;
+    range.used = true;
+    --freeRanges_;
+  }
+
+  for (Mn::Matrix4& matrix : this->range(found)) {
+    matrix = Mn::Matrix4{Mn::Math::IdentityInit};
+  }
+  return found;
+}
+
+void BonePalette::removeRange(int id) {
+  CORRADE_ASSERT(std::size_t(id) < ranges_.size() && ranges_[id].used,
+                 "BonePalette::removeRange(): invalid range" << id, );
+  ranges_[id].used = false;
+  ++freeRanges_;
+}
+
+Cr::Containers::ArrayView<Mn::Matrix4> BonePalette::range(int id) {
+  CORRADE_ASSERT(std::size_t(id) < ranges_.size() && ranges_[id].used,
+                 "BonePalette::range(): invalid range" << id, {});
+  const Range& range = ranges_[id];
+  return matrices_.sliceSize(range.offset, range.count);
+}
+
+std::size_t BonePalette::rangeOffset(int id) const {
+  CORRADE_ASSERT(std::size_t(id) < ranges_.size() && ranges_[id].used,
+                 "BonePalette::rangeOffset(): invalid range" << id, {});
+  return ranges_[id].offset;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,79 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_BONEPALETTE_H_
+#define ESP_GFX_BONEPALETTE_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::BonePalette
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Matrix4.h>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Joint matrices of all rig instances, packed into a single array.
+ *
+ * Each skinned instance or replayed rig allocates a contiguous range of the
+ * palette, so the poses of all humanoids in a scene can be updated and
+ * uploaded as one buffer and skinned meshes only need to know the offset of
+ * their range. Ranges of removed instances are reused by later ones that
+ * fit, which keeps the palette compact when humanoids are spawned and
+ * removed repeatedly.
+ *
+ * Growing the palette reallocates it, views returned by @ref range() and
+ * @ref matrices() are only valid until the next @ref addRange().
+ */
+class BonePalette {
+ public:
+  /**
+   * @brief Allocate a range of @p count matrices, all set to identity
+   * @return ID of the range, stays valid until @ref removeRange()
+   */
+  int addRange(std::size_t count);
+
+  /** @brief Free a range allocated by @ref addRange() */
+  void removeRange(int id);
+
+  /** @brief Matrices of range @p id */
+  Corrade::Containers::ArrayView<Magnum::Matrix4> range(int id);
+
+  /** @brief Offset of range @p id in @ref matrices() */
+  std::size_t rangeOffset(int id) const;
+
+  /** @brief Number of ranges currently allocated */
+  std::size_t rangeCount() const { return ranges_.size() - freeRanges_; }
+
+  /** @brief The whole packed palette, including unused ranges */
+  Corrade::Containers::ArrayView<const Magnum::Matrix4> matrices() const {
+    return matrices_;
+  }
+
+ private:
+  struct Range {
+    std::size_t offset;
+    //! Size the range was allocated with, a reused range may use less
+    std::size_t capacity;
+    std::size_t count;
+    bool used;
+  };
+
+  Corrade::Containers::Array<Magnum::Matrix4> matrices_;
+  std::vector<Range> ranges_;
+  std::size_t freeRanges_ = 0;
+
+  ESP_SMART_POINTERS(BonePalette)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_BONEPALETTE_H_
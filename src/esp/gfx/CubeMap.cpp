@@ -551,7 +551,8 @@ void CubeMap::copySubImage(unsigned int cubeSideIndex,
 void CubeMap::renderToTexture(CubeMapCamera& camera,
                               scene::SceneGraph& sceneGraph,
                               const char* drawableGroupName,
-                              RenderCamera::Flags renderCameraFlags) {
+                              RenderCamera::Flags renderCameraFlags,
+                              const Faces& faces) {
   CORRADE_ASSERT(camera.isInSceneGraph(sceneGraph),
                  "CubeMap::renderToTexture(): camera is NOT attached to the "
                  "current scene graph.", );
@@ -574,16 +575,21 @@ void CubeMap::renderToTexture(CubeMapCamera& camera,
   // the camera MUST be updated as well.
   camera.updateOriginalViewingMatrix();
 
+  // TODO:
+  // should have different drawable groups that can do "low quality"
+  // rendering, e.g., no normal maps, no specular lighting, low-poly meshes,
+  // low-quality textures.
+  DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
+  // the draw order doesn't depend on the face, so build it once for all six
+  group.prepareForDraw(camera);
+
+  ESP_PROFILE_GPU_SCOPE(gpuTimer_, "CubeMap::renderToTexture");
   for (int iFace = 0; iFace < 6; ++iFace) {
+    if (!faces[iFace]) {
+      continue;
+    }
     camera.switchToFace(iFace);
     prepareToDraw(iFace, renderCameraFlags);
-
-    // TODO:
-    // should have different drawable groups that can do "low quality"
-    // rendering, e.g., no normal maps, no specular lighting, low-poly meshes,
-    // low-quality textures.
-    DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
-    group.prepareForDraw(camera);
     camera.draw(group, renderCameraFlags);
   }  // iFace
 
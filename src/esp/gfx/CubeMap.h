@@ -13,11 +13,13 @@
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/BitVector.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/ResourceManager.h>
 #include <Magnum/Shaders/GenericGL.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include "esp/gfx/CubeMapCamera.h"
+#include "esp/gfx/GpuTimer.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/scene/SceneGraph.h"
 #include "esp/scene/SceneNode.h"
@@ -102,6 +104,17 @@ class CubeMap {
    */
   typedef Corrade::Containers::EnumSet<Flag> Flags;
 
+  /**
+   * @brief Set of cube faces, bit i is the face i as in
+   * @ref CubeMapCamera::switchToFace(unsigned int)
+   */
+  typedef Magnum::Math::BitVector<6> Faces;
+
+  /**
+   * @brief All six cube faces
+   */
+  static constexpr Faces allFaces() { return Faces{0x3f}; }
+
   /**
    * @brief, Constructor
    * @param imageSize the size of the cubemap texture (each face is size x size)
@@ -194,6 +207,8 @@ class CubeMap {
   /**
    * @brief Render to cubemap texture using the camera
    * @param camera a cubemap camera
+   * @param faces the faces to render. The others are left untouched, so only
+   * leave out faces the cubemap is never sampled from.
    * NOTE: It will NOT automatically generate the mipmap for the user
    */
   void renderToTexture(CubeMapCamera& camera,
@@ -202,7 +217,8 @@ class CubeMap {
                        RenderCamera::Flags flags = {
                            RenderCamera::Flag::FrustumCulling |
                            RenderCamera::Flag::ClearColor |
-                           RenderCamera::Flag::ClearDepth});
+                           RenderCamera::Flag::ClearDepth},
+                       const Faces& faces = allFaces());
 
   /**
    * @brief copy the texture from a specified cube face to a given texture
@@ -263,6 +279,9 @@ class CubeMap {
 
   Magnum::GL::CubeMapTexture textures_[uint8_t(TextureType::Count)];
 
+  //! Times the face rendering in @ref renderToTexture()
+  GpuTimer gpuTimer_;
+
   Magnum::GL::CubeMapTexture& texture(TextureType type);
 
   /**
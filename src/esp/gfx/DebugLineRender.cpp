@@ -5,9 +5,17 @@
 #include "DebugLineRender.h"
 
 #include <Corrade/Containers/GrowableArray.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/Math/Color.h>
+#include <algorithm>
+#include <cstring>
 
+#include "DebugLineShader.h"
 #include "esp/core/Check.h"
 #include "esp/core/Logging.h"
 
@@ -19,11 +27,22 @@ namespace gfx {
 
 namespace {
 
-Mn::Color4 remapAlpha(const Mn::Color4& src) {
-  // Because we render lines multiple times additively in flushLines, we need to
-  // remap alpha (opacity). This is an approximation.
-  constexpr float exponent = 2.f;
-  return {src.rgb(), std::pow(src.a(), exponent)};
+// Regions of the persistently mapped line buffer consecutive flushes cycle
+// through, so lines are never written to a region the GPU may still read
+constexpr std::size_t StreamRegionCount = 3;
+// Lines a region holds at least, it grows to fit the largest flush
+constexpr std::size_t MinStreamRegionCapacity = 4096;
+
+bool supportsPersistentMapping() {
+#ifdef MAGNUM_TARGET_GLES
+  return false;
+#else
+  const Mn::GL::Context& context = Mn::GL::Context::current();
+  return context
+             .isExtensionSupported<Mn::GL::Extensions::ARB::buffer_storage>() &&
+         context
+             .isExtensionSupported<Mn::GL::Extensions::ARB::base_instance>();
+#endif
 }
 
 // return false if segment is entirely clipped
@@ -57,12 +76,57 @@ bool scissorSegmentToOutsideCircle(Mn::Vector3* pt0,
 
 }  // namespace
 
+struct DebugLineRender::GLResourceSet {
+  //! The six corners of the two triangles every line is expanded to
+  Mn::GL::Buffer cornerBuffer;
+  Mn::GL::Buffer lineBuffer;
+  Mn::GL::Mesh mesh{Mn::NoCreate};
+  DebugLineShader shader;
+  const bool persistent = supportsPersistentMapping();
+  //! Lines a region of the persistently mapped buffer holds
+  std::size_t regionCapacity = 0;
+  std::size_t region = 0;
+  //! The whole persistently mapped buffer
+  Cr::Containers::ArrayView<char> mapped;
+#ifndef MAGNUM_TARGET_GLES
+  //! Signalled once the GPU is done with the lines in each region
+  GLsync fences[StreamRegionCount]{};
+#endif
+
+  GLResourceSet() {
+    const Mn::Vector2 corners[]{{0.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f},
+                                {0.0f, -1.0f}, {1.0f, 1.0f},  {0.0f, 1.0f}};
+    cornerBuffer.setData(corners, Mn::GL::BufferUsage::StaticDraw);
+    setupMesh();
+  }
+
+  ~GLResourceSet() { deleteFences(); }
+
+  void setupMesh() {
+    mesh = Mn::GL::Mesh{};
+    mesh.setCount(6)
+        .addVertexBuffer(cornerBuffer, 0, DebugLineShader::Corner{})
+        .addVertexBufferInstanced(
+            lineBuffer, 1, 0, DebugLineShader::From{}, DebugLineShader::To{},
+            DebugLineShader::FromColor{}, DebugLineShader::ToColor{});
+  }
+
+  void deleteFences() {
+#ifndef MAGNUM_TARGET_GLES
+    for (GLsync& fence : fences) {
+      if (fence) {
+        glDeleteSync(fence);
+        fence = nullptr;
+      }
+    }
+#endif
+  }
+};
+
 DebugLineRender::DebugLineRender()
-    : _glResources{std::make_unique<GLResourceSet>()} {
-  _glResources->mesh.addVertexBuffer(_glResources->buffer, 0,
-                                     Mn::Shaders::FlatGL3D::Position{},
-                                     Mn::Shaders::FlatGL3D::Color4{});
-}
+    : _glResources{std::make_unique<GLResourceSet>()} {}
+
+DebugLineRender::~DebugLineRender() = default;
 
 void DebugLineRender::releaseGLResources() {
   _glResources = nullptr;
@@ -72,20 +136,59 @@ void DebugLineRender::drawLine(const Mn::Vector3& from,
                                const Mn::Vector3& to,
                                const Mn::Color4& fromColor,
                                const Mn::Color4& toColor) {
-  VertexRecord v1{from, remapAlpha(fromColor)};
-  VertexRecord v2{to, remapAlpha(toColor)};
-  arrayAppend(_verts, {v1, v2});
+  arrayAppend(_lines, LineRecord{from, to, fromColor, toColor});
 }
 
 void DebugLineRender::setLineWidth(float lineWidth) {
-  // This is derived from experiments with glLineWidth on Nvidia hardware.
-  const float maxLineWidth = 20.f;
-  if (lineWidth > maxLineWidth) {
-    ESP_WARNING() << "Requested lineWidth of" << lineWidth
-                  << "is greater than max supported width of" << maxLineWidth;
-    lineWidth = maxLineWidth;
+  _lineWidth = lineWidth;
+}
+
+void DebugLineRender::uploadLines() {
+  GLResourceSet& gl = *_glResources;
+  if (!gl.persistent) {
+    // respecifying the whole store lets the driver orphan the previous one
+    // instead of waiting for draws still reading it
+    gl.lineBuffer.setData(_lines, Mn::GL::BufferUsage::StreamDraw);
+    return;
   }
-  _internalLineWidth = lineWidth / 2;  // see also DebugLineRender::flushLines
+
+#ifndef MAGNUM_TARGET_GLES
+  constexpr Mn::GL::Buffer::StorageFlags storageFlags =
+      Mn::GL::Buffer::StorageFlag::MapWrite |
+      Mn::GL::Buffer::StorageFlag::MapPersistent |
+      Mn::GL::Buffer::StorageFlag::MapCoherent;
+  constexpr Mn::GL::Buffer::MapFlags mapFlags =
+      Mn::GL::Buffer::MapFlag::Write | Mn::GL::Buffer::MapFlag::Persistent |
+      Mn::GL::Buffer::MapFlag::Coherent;
+  if (_lines.size() > gl.regionCapacity) {
+    // storage is immutable, so growing needs a new buffer; the driver keeps
+    // the old one alive until the draws reading it are done
+    gl.regionCapacity = std::max(
+        {MinStreamRegionCapacity, _lines.size(), 2 * gl.regionCapacity});
+    const std::size_t size =
+        StreamRegionCount * gl.regionCapacity * sizeof(LineRecord);
+    gl.deleteFences();
+    gl.lineBuffer = Mn::GL::Buffer{};
+    gl.lineBuffer.setStorage(size, storageFlags);
+    gl.mapped = gl.lineBuffer.map(0, size, mapFlags);
+    gl.region = 0;
+    gl.setupMesh();
+  }
+
+  GLsync& fence = gl.fences[gl.region];
+  if (fence) {
+    // only blocks if the GPU is more than two flushes behind
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) ==
+           GL_TIMEOUT_EXPIRED) {
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+  std::memcpy(gl.mapped.data() +
+                  gl.region * gl.regionCapacity * sizeof(LineRecord),
+              _lines.data(), _lines.size() * sizeof(LineRecord));
+  gl.mesh.setBaseInstance(Mn::UnsignedInt(gl.region * gl.regionCapacity));
+#endif
 }
 
 void DebugLineRender::flushLines(const Magnum::Matrix4& camMatrix,
@@ -100,7 +203,7 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
                  "DebugLineRender::flushLines: no GL resources; see "
                  "also releaseGLResources", );
 
-  if (_verts.isEmpty()) {
+  if (_lines.isEmpty()) {
     return;
   }
 
@@ -113,65 +216,40 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
         Mn::GL::Renderer::BlendFunction::OneMinusSourceAlpha);
     Mn::GL::Renderer::setBlendEquation(Mn::GL::Renderer::BlendEquation::Add);
   }
+  // the quads face either way depending on the line direction
+  bool doToggleFaceCulling = glIsEnabled(GL_CULL_FACE);
+  if (doToggleFaceCulling) {
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
 
-  // Update buffer with new data
-  _glResources->buffer.setData(_verts, Mn::GL::BufferUsage::DynamicDraw);
-
-  // Update shader
-  _glResources->mesh.setCount(_verts.size());
-
-  Mn::GL::Renderer::setLineWidth(_internalLineWidth);
-
-  // We draw lines multiple times, with pixel offsets, to produce a single
-  // thick, visually-appealing line. Todo: implement thick lines using
-  // triangles, for example https://mattdesl.svbtle.com/drawing-lines-is-hard.
-  // 1.2 is hand-tuned for Nvidia hardware to be just small enough so we don't
-  // see gaps between the individual offset lines.
-  const float x = _internalLineWidth * 1.2f;
-  constexpr float sqrtOfTwo = Mn::Constants::sqrt2();
-  // hard-coding 8 points around a circle
-  const Mn::Vector3 offsets[] = {Mn::Vector3(x, x, 0),
-                                 Mn::Vector3(-x, x, 0),
-                                 Mn::Vector3(x, -x, 0),
-                                 Mn::Vector3(-x, -x, 0),
-                                 Mn::Vector3(x * sqrtOfTwo, 0, 0),
-                                 Mn::Vector3(-x * sqrtOfTwo, 0, 0),
-                                 Mn::Vector3(0, x * sqrtOfTwo, 0),
-                                 Mn::Vector3(0, -x * sqrtOfTwo, 0)};
-
-  const auto& projCam = projCamMatrix;
-
-  auto submitLinesWithOffsets = [&]() {
-    for (const auto& offset : offsets) {
-      // We want to offset in viewport (pixel) space, but we need to specify our
-      // offset transform in projection space. So divide by viewport dim.
-      Magnum::Matrix4 offset0Matrix = Mn::Matrix4::translation(
-          offset * Mn::Vector3(1.f / viewport.x(), 1.f / viewport.y(), 0.f));
-      Magnum::Matrix4 transProj = offset0Matrix * projCam;
-      _glResources->shader.setTransformationProjectionMatrix(transProj);
-      _glResources->shader.draw(_glResources->mesh);
-    }
-  };
-
-  _glResources->shader.setColor({1.0f, 1.0f, 1.0f, 1.0});
-
-  submitLinesWithOffsets();
+  uploadLines();
+  GLResourceSet& gl = *_glResources;
+  gl.mesh.setInstanceCount(Mn::Int(_lines.size()));
 
-  // modify all colors to be semi-transparent
-  static float opacity = 0.1;
-  _glResources->shader.setColor({1.0f, 1.0f, 1.0f, opacity});
+  gl.shader.setTransformationProjectionMatrix(projCamMatrix)
+      .setViewportSize(Mn::Vector2{viewport})
+      .setLineWidth(_lineWidth)
+      .setOpacity(1.0f)
+      .draw(gl.mesh);
 
   // Here, we re-draw lines with a reversed depth function. This causes
   // occluded lines to be visualized as semi-transparent, which is useful for
   // UX and visually-appealing.
   Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Greater);
-  submitLinesWithOffsets();
+  gl.shader.setOpacity(0.1f).draw(gl.mesh);
 
   // restore to a reasonable default
   Mn::GL::Renderer::setDepthFunction(Mn::GL::Renderer::DepthFunction::Less);
 
-  // Clear _verts to receive new data
-  arrayResize(_verts, 0);
+#ifndef MAGNUM_TARGET_GLES
+  if (gl.persistent) {
+    gl.fences[gl.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl.region = (gl.region + 1) % StreamRegionCount;
+  }
+#endif
+
+  // Clear _lines to receive new data
+  arrayResize(_lines, 0);
 
   // restore blending state if necessary
   if (doToggleBlend) {
@@ -179,9 +257,9 @@ void DebugLineRender::flushLines(const Magnum::Matrix4& projCamMatrix,
     // Note: because we are disabling blending, we don't need to restore
     // BlendFunction or BlendEquation
   }
-
-  // restore to a reasonable default
-  Mn::GL::Renderer::setLineWidth(1.0);
+  if (doToggleFaceCulling) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
 }
 
 void DebugLineRender::pushTransform(const Magnum::Matrix4& transform) {
@@ -8,11 +8,8 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/Macros.h>
-#include <Magnum/GL/Buffer.h>
-#include <Magnum/GL/Mesh.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix4.h>
-#include <Magnum/Shaders/FlatGL.h>
 
 #include <memory>
 #include <vector>
@@ -25,6 +22,10 @@ namespace gfx {
  * frame). This is intended for debugging or simple UX for prototype apps. The
  * API prioritizes ease-of-use over maximum runtime performance.
  *
+ * Lines are streamed to the GPU once per @ref flushLines(), through a
+ * persistently mapped buffer where the driver supports it, and drawn as
+ * screen-space quads of the requested width in a single draw per depth test.
+ *
  * It's easy to add new primitives here; see drawCircle as a reference. In
  * addition, if you're interested to integrate Magnum's line-based primitives,
  * see src/deps/magnum/doc/generated/primitives.cpp and also this discussion:
@@ -38,9 +39,16 @@ class DebugLineRender {
    */
   DebugLineRender();
 
+  ~DebugLineRender();
+
   /** @brief Release GPU resources */
   void releaseGLResources();
 
+  /**
+   * @brief Whether any lines were drawn since the last @ref flushLines()
+   */
+  bool hasLines() const { return !_lines.isEmpty(); }
+
   /** @brief Copying is not allowed */
   DebugLineRender(const DebugLineRender&) = delete;
 
@@ -48,7 +56,7 @@ class DebugLineRender {
   DebugLineRender& operator=(const DebugLineRender&) = delete;
 
   /**
-   * @brief Set line width in pixels (approximate).
+   * @brief Set line width in pixels.
    */
   void setLineWidth(float lineWidth);
 
@@ -165,24 +173,23 @@ class DebugLineRender {
  private:
   void updateCachedInputTransform();
 
-  struct VertexRecord {
-    Magnum::Vector3 pos;
-    Magnum::Color4 color;
-  };
+  void uploadLines();
 
-  struct GLResourceSet {
-    Magnum::GL::Buffer buffer;
-    Magnum::GL::Mesh mesh{Magnum::GL::MeshPrimitive::Lines};
-    Magnum::Shaders::FlatGL3D shader{
-        Magnum::Shaders::FlatGL3D::Configuration{}.setFlags(
-            Magnum::Shaders::FlatGL3D::Flag::VertexColor)};
+  //! One instance of the line shader, laid out as its per-instance attributes
+  struct LineRecord {
+    Magnum::Vector3 from;
+    Magnum::Vector3 to;
+    Magnum::Color4 fromColor;
+    Magnum::Color4 toColor;
   };
 
+  struct GLResourceSet;
+
   std::vector<Magnum::Matrix4> _inputTransformStack;
   Magnum::Matrix4 _cachedInputTransform{Magnum::Math::IdentityInit};
-  float _internalLineWidth = 1.0f;
+  float _lineWidth = 1.0f;
   std::unique_ptr<GLResourceSet> _glResources;
-  Magnum::Containers::Array<VertexRecord> _verts;
+  Magnum::Containers::Array<LineRecord> _lines;
 };
 
 }  // namespace gfx
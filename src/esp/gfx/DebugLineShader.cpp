@@ -0,0 +1,97 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DebugLineShader.h"
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/gfx_batch/ShaderCache.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+DebugLineShader::DebugLineShader() {
+  if (!Corrade::Utility::Resource::hasGroup("gfx-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  vert.addSource(Cr::Utility::formatString(
+                     "#define ATTRIBUTE_LOCATION_CORNER {}\n"
+                     "#define ATTRIBUTE_LOCATION_FROM {}\n"
+                     "#define ATTRIBUTE_LOCATION_TO {}\n"
+                     "#define ATTRIBUTE_LOCATION_FROM_COLOR {}\n"
+                     "#define ATTRIBUTE_LOCATION_TO_COLOR {}\n",
+                     Corner::Location, From::Location, To::Location,
+                     FromColor::Location, ToColor::Location))
+      .addSource(rs.getString("debugLine.vert"));
+
+  frag.addSource(Cr::Utility::formatString(
+                     "#define OUTPUT_ATTRIBUTE_LOCATION_COLOR {}\n",
+                     ColorOutput))
+      .addSource(rs.getString("debugLine.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
+
+  transformationProjectionMatrixUniform_ =
+      uniformLocation("TransformationProjectionMatrix");
+  viewportSizeUniform_ = uniformLocation("ViewportSize");
+  lineWidthUniform_ = uniformLocation("LineWidth");
+  opacityUniform_ = uniformLocation("Opacity");
+  CORRADE_INTERNAL_ASSERT(transformationProjectionMatrixUniform_ >= 0 &&
+                          viewportSizeUniform_ >= 0 &&
+                          lineWidthUniform_ >= 0 && opacityUniform_ >= 0);
+}
+
+DebugLineShader& DebugLineShader::setTransformationProjectionMatrix(
+    const Mn::Matrix4& matrix) {
+  setUniform(transformationProjectionMatrixUniform_, matrix);
+  return *this;
+}
+
+DebugLineShader& DebugLineShader::setViewportSize(const Mn::Vector2& size) {
+  setUniform(viewportSizeUniform_, size);
+  return *this;
+}
+
+DebugLineShader& DebugLineShader::setLineWidth(float width) {
+  setUniform(lineWidthUniform_, width);
+  return *this;
+}
+
+DebugLineShader& DebugLineShader::setOpacity(float opacity) {
+  setUniform(opacityUniform_, opacity);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,94 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_DEBUGLINESHADER_H_
+#define ESP_GFX_DEBUGLINESHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Shaders/GenericGL.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Shader drawing thick lines in a single pass, used by
+@ref DebugLineRender
+
+Each line segment is one instance, expanded by the vertex shader to a quad of
+constant width in pixels from six @ref Corner vertices shared by all
+segments. Unlike @ref Magnum::GL::Renderer::setLineWidth(), the width isn't
+limited by the driver.
+*/
+class DebugLineShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  /**
+   * @brief Corner of the quad a segment is expanded to, shared by all
+   * instances. X is @cpp 0.0f @ce at the segment start and @cpp 1.0f @ce at
+   * its end, Y is @cpp -1.0f @ce or @cpp 1.0f @ce for the two sides.
+   */
+  typedef Magnum::GL::Attribute<0, Magnum::Vector2> Corner;
+
+  /** @brief Segment start, per instance */
+  typedef Magnum::GL::Attribute<1, Magnum::Vector3> From;
+
+  /** @brief Segment end, per instance */
+  typedef Magnum::GL::Attribute<2, Magnum::Vector3> To;
+
+  /** @brief Color at the segment start, per instance */
+  typedef Magnum::GL::Attribute<3, Magnum::Vector4> FromColor;
+
+  /** @brief Color at the segment end, per instance */
+  typedef Magnum::GL::Attribute<4, Magnum::Vector4> ToColor;
+
+  enum : Magnum::UnsignedInt {
+    /**
+     * Color shader output. @ref shaders-generic "Generic output",
+     * present always. Expects three- or four-component floating-point
+     * or normalized buffer attachment.
+     */
+    ColorOutput = Magnum::Shaders::GenericGL3D::ColorOutput,
+  };
+
+  /** @brief Constructor */
+  explicit DebugLineShader();
+
+  /**
+   * @brief Set transformation and projection matrix
+   * @return Reference to self (for method chaining)
+   */
+  DebugLineShader& setTransformationProjectionMatrix(
+      const Magnum::Matrix4& matrix);
+
+  /**
+   * @brief Set viewport size in pixels, needed to keep the line width
+   * constant in screen space
+   * @return Reference to self (for method chaining)
+   */
+  DebugLineShader& setViewportSize(const Magnum::Vector2& size);
+
+  /**
+   * @brief Set line width in pixels
+   * @return Reference to self (for method chaining)
+   */
+  DebugLineShader& setLineWidth(float width);
+
+  /**
+   * @brief Set opacity the alpha of the vertex colors is multiplied with
+   * @return Reference to self (for method chaining)
+   */
+  DebugLineShader& setOpacity(float opacity);
+
+ private:
+  GLint transformationProjectionMatrixUniform_ = -1;
+  GLint viewportSizeUniform_ = -1;
+  GLint lineWidthUniform_ = -1;
+  GLint opacityUniform_ = -1;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif
@@ -13,6 +13,8 @@
 
 #include <sstream>
 
+#include "esp/gfx_batch/ShaderCache.h"
+
 // This is to import the "resources" at runtime. When the resource is
 // compiled into static library, it must be explicitly initialized via this
 // macro, and should be called *outside* of any namespace.
@@ -71,11 +73,14 @@ DoubleSphereCameraShader::DoubleSphereCameraShader(
                      : "")
       .addSource(rs.getString("doubleSphereCamera.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // set texture binding points in the shader
   if (flags_ & CubeMapShaderBase::Flag::ColorTexture) {
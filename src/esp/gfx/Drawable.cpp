@@ -8,9 +8,21 @@
 #include "DrawableGroup.h"
 #include "esp/scene/SceneNode.h"
 
+#include <unordered_map>
+
 namespace esp {
 namespace gfx {
+
+namespace {
+struct ResourceKeyHash {
+  std::size_t operator()(const Mn::ResourceKey& key) const {
+    return *reinterpret_cast<const std::size_t*>(key.byteArray());
+  }
+};
+}  // namespace
+
 uint64_t Drawable::drawableIdCounter = 0;
+uint64_t Drawable::materialIdCounter = 0;
 Drawable::Drawable(scene::SceneNode& node,
                    Magnum::GL::Mesh* mesh,
                    DrawableType type,
@@ -26,18 +38,37 @@ Drawable::Drawable(scene::SceneNode& node,
       mesh_(mesh) {
   // Every drawable scene node holds a reference to its drawable ID
   node_.setDrawableId(drawableId_);
+  // the node's box now counts towards the subtree boxes of its ancestors
+  node_.invalidateSubtreeAABB();
   if (cfg.group_) {
     cfg.group_->registerDrawable(*this);
   }
 }
 
 Drawable::~Drawable() {
+  scene::SceneNode::markAppearanceChanged();
   DrawableGroup* group = drawables();
   if (group) {
     group->unregisterDrawable(*this);
   }
 }
 
+void Drawable::shareMaterialId(const Mn::ResourceKey& key,
+                               const Mn::Trade::MaterialData* material) {
+  static std::unordered_map<
+      Mn::ResourceKey, std::pair<const Mn::Trade::MaterialData*, uint64_t>,
+      ResourceKeyHash>
+      materialIds;
+  auto& sharedId = materialIds[key];
+  // the material under the key was replaced since, don't share with drawables
+  // built from the old one
+  if (sharedId.first != material) {
+    assignUniqueMaterialId();
+    sharedId = {material, materialId_};
+  }
+  materialId_ = sharedId.second;
+}
+
 DrawableGroup* Drawable::drawables() {
   auto* group = Magnum::SceneGraph::Drawable3D::drawables();
   if (!group) {
@@ -49,43 +80,72 @@ DrawableGroup* Drawable::drawables() {
   return static_cast<DrawableGroup*>(group);
 }
 
-void Drawable::buildSkinJointTransforms() {
-  if (!skinData_) {
+void Drawable::setMaterialValues(
+    const Mn::Resource<Mn::Trade::MaterialData, Mn::Trade::MaterialData>&
+        material) {
+  setMaterialValuesInternal(material, false);
+  scene::SceneNode::markAppearanceChanged();
+}
+
+void Drawable::resetMaterialValues(
+    const Mn::Resource<Mn::Trade::MaterialData, Mn::Trade::MaterialData>&
+        material) {
+  setMaterialValuesInternal(material, true);
+  scene::SceneNode::markAppearanceChanged();
+}
+
+void Drawable::setLodLevels(std::vector<LodLevel> levels) {
+  // a simplified mesh from the bind pose would tear apart when skinned
+  if (isSkinned()) {
     return;
   }
+  lodLevels_ = std::move(levels);
+  lodMesh_ = nullptr;
+}
+
+void Drawable::selectLodLevel(float pixelSize) {
+  lodMesh_ = nullptr;
+  for (const LodLevel& level : lodLevels_) {
+    if (pixelSize > level.maxPixelSize) {
+      break;
+    }
+    lodMesh_ = level.mesh;
+  }
+}
+
+Corrade::Containers::ArrayView<const Mn::Matrix4>
+Drawable::buildSkinJointTransforms(uint64_t drawPass) {
+  const Corrade::Containers::ArrayView<Mn::Matrix4> jointTransformations =
+      skinData_->bonePalette->range(skinData_->bonePaletteRange);
+  if (skinData_->bonePaletteDrawPass == drawPass) {
+    return jointTransformations;
+  }
+  skinData_->bonePaletteDrawPass = drawPass;
+
   // Gather joint transformations
   const auto& skin = skinData_->skinData->skin;
   const auto& transformNodes = skinData_->jointIdToTransformNode;
 
-  ESP_CHECK(jointTransformations_.size() == skin->joints().size(),
-            "Joint transformation count doesn't match bone count.");
-
   // Undo root node transform so that the model origin matches the root
   // articulated object link.
   const auto invRootTransform =
       skinData_->rootArticulatedObjectNode->absoluteTransformationMatrix()
           .inverted();
 
-  for (std::size_t i = 0; i != jointTransformations_.size(); ++i) {
+  for (std::size_t i = 0; i != jointTransformations.size(); ++i) {
     const auto jointNodeIt = transformNodes.find(skin->joints()[i]);
     if (jointNodeIt != transformNodes.end()) {
-      jointTransformations_[i] =
+      jointTransformations[i] =
           invRootTransform *
           jointNodeIt->second->absoluteTransformationMatrix() *
           skin->inverseBindMatrices()[i];
     } else {
       // Joint not found, use placeholder matrix.
-      jointTransformations_[i] = Mn::Matrix4{Mn::Math::IdentityInit};
+      jointTransformations[i] = Mn::Matrix4{Mn::Math::IdentityInit};
     }
   }
-
+  return jointTransformations;
 }  // Drawable::buildSkinJointTransforms
 
-void Drawable::resizeJointTransformArray(Mn::UnsignedInt jointCount) {
-  if (jointTransformations_.size() != jointCount) {
-    Corrade::Containers::arrayResize(jointTransformations_, jointCount);
-  }
-}
-
 }  // namespace gfx
 }  // namespace esp
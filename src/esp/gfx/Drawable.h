@@ -11,6 +11,7 @@
 #include <Magnum/GL/GL.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/Trade/MaterialData.h>
+#include <vector>
 #include "esp/core/Esp.h"
 #include "esp/gfx/DrawableConfiguration.h"
 
@@ -107,18 +108,82 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    */
   virtual scene::SceneNode& getSceneNode() const { return node_; }
 
-  /** @brief get the GL mesh */
+  /**
+   * @brief get the GL mesh, or the mesh of the level of detail selected with
+   * @ref selectLodLevel()
+   */
   Magnum::GL::Mesh& getMesh() const {
     CORRADE_ASSERT(
         mesh_ != nullptr,
         "Drawable::getMesh() : Attempting to get the GL mesh when none exists",
         *mesh_);
-    return *mesh_;
+    return lodMesh_ ? *lodMesh_ : *mesh_;
   }
 
+  /**
+   * @brief A simplified version of the mesh, see @ref setLodLevels()
+   */
+  struct LodLevel {
+    Magnum::GL::Mesh* mesh;
+    /**
+     * projected size of the node's bounding box in pixels below which the
+     * level gets drawn
+     */
+    float maxPixelSize;
+  };
+
+  /**
+   * @brief Set simplified versions of the mesh to draw when the node is
+   * small on screen, ordered from the most to the least detailed. Ignored
+   * for skinned drawables.
+   */
+  void setLodLevels(std::vector<LodLevel> levels);
+
+  /** @brief Whether this drawable has any levels of detail to select from */
+  bool hasLodLevels() const { return !lodLevels_.empty(); }
+
+  /**
+   * @brief Draw the least detailed level whose @ref LodLevel::maxPixelSize
+   * is not smaller than @p pixelSize, or the full mesh if there's none
+   */
+  void selectLodLevel(float pixelSize);
+
   /** @brief get the drawable type */
   DrawableType getDrawableType() const { return type_; }
 
+  /**
+   * @brief GL state a drawable draws with, see @ref getDrawState()
+   */
+  struct DrawState {
+    const Magnum::GL::AbstractShaderProgram* shader = nullptr;
+    uint64_t materialId = 0;
+    const Magnum::GL::Mesh* mesh = nullptr;
+  };
+
+  /**
+   * @brief Shader, material and mesh this drawable draws with
+   *
+   * Used by @ref DrawableGroup::prepareForDraw() to order drawables so that
+   * ones sharing state are drawn back to back.
+   * NOTE: sub-class should override this function to report its shader
+   */
+  virtual DrawState getDrawState() {
+    return {nullptr, materialId_, lodMesh_ ? lodMesh_ : mesh_};
+  }
+
+  /**
+   * @brief Id of the material values this drawable draws with. Drawables
+   * built from the same material share the id until their values are
+   * changed.
+   */
+  uint64_t getMaterialId() const { return materialId_; }
+
+  /**
+   * @brief Whether this drawable is skinned. Skinned drawables read the
+   * absolute transformations of their joint nodes while drawing.
+   */
+  bool isSkinned() const { return skinData_ != nullptr; }
+
   /**
    * @brief Get the Magnum GL mesh for visualization, highlighting (e.g., used
    * in object picking)
@@ -141,9 +206,7 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
 
   void setMaterialValues(
       const Magnum::Resource<Magnum::Trade::MaterialData,
-                             Magnum::Trade::MaterialData>& material) {
-    setMaterialValuesInternal(material, false);
-  }
+                             Magnum::Trade::MaterialData>& material);
 
   /**
    * Reset this drawable's @ref Magnum::Trade::MaterialData values from passed material, completely replacing the existing values
@@ -153,9 +216,7 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    */
   void resetMaterialValues(
       const Magnum::Resource<Magnum::Trade::MaterialData,
-                             Magnum::Trade::MaterialData>& material) {
-    setMaterialValuesInternal(material, true);
-  }
+                             Magnum::Trade::MaterialData>& material);
 
  private:
   /**
@@ -172,9 +233,18 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
 
  protected:
   /**
-   * @brief resize the jointTransformArray_
+   * @brief Share the material id with all other drawables built from
+   * @p material, stored under @p key in the shader manager
+   */
+  void shareMaterialId(const Magnum::ResourceKey& key,
+                       const Magnum::Trade::MaterialData* material);
+
+  /**
+   * @brief Give this drawable a material id of its own, e.g. after its
+   * material values were changed
    */
-  void resizeJointTransformArray(Mn::UnsignedInt jointCount);
+  void assignUniqueMaterialId() { materialId_ = ++materialIdCounter; }
+
   /**
    * @brief Draw the object using given camera
    *
@@ -207,9 +277,15 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   }
 
   /**
-   * @brief Build the joint transformations on every draw if skinData exists
+   * @brief Joint transformations of the skinned instance in draw pass
+   * @p drawPass, see @ref RenderCamera::drawPass()
+   *
+   * They're packed into the instance's range of the shared
+   * @ref BonePalette and computed only by the first drawable of the instance
+   * drawn in the pass, the others reuse them.
    */
-  void buildSkinJointTransforms();
+  Corrade::Containers::ArrayView<const Magnum::Matrix4>
+  buildSkinJointTransforms(uint64_t drawPass);
 
   /**
    * @brief Update lighting-related parameters on every draw call
@@ -247,16 +323,21 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   static uint64_t drawableIdCounter;
   uint64_t drawableId_;
 
+  static uint64_t materialIdCounter;
+  uint64_t materialId_ = 0;
+
   Mn::Resource<LightSetup> lightSetup_;
 
   std::shared_ptr<InstanceSkinData> skinData_{nullptr};
 
-  Corrade::Containers::Array<Magnum::Matrix4> jointTransformations_;
-
   bool glMeshExists() const { return mesh_ != nullptr; }
 
  private:
   Magnum::GL::Mesh* mesh_ = nullptr;
+
+  std::vector<LodLevel> lodLevels_;
+  // level selected by selectLodLevel(), nullptr for the full mesh
+  Magnum::GL::Mesh* lodMesh_ = nullptr;
 };
 
 CORRADE_ENUMSET_OPERATORS(Drawable::Flags)
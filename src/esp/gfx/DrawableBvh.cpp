@@ -0,0 +1,188 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DrawableBvh.h"
+
+#include <Magnum/Math/Functions.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <algorithm>
+
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+//! Leaves hold at most this many drawables
+constexpr int MaxLeafSize = 4;
+
+enum class FrustumTest { Outside, Intersects, Inside };
+
+FrustumTest testRange(const Mn::Range3D& range, const Mn::Frustum& frustum) {
+  // same formulation as the per-drawable test in RenderCamera, with both
+  // vectors scaled by two
+  const Mn::Vector3 center = range.min() + range.max();
+  const Mn::Vector3 extent = range.max() - range.min();
+
+  FrustumTest result = FrustumTest::Inside;
+  for (int iPlane = 0; iPlane < 6; ++iPlane) {
+    const Mn::Vector4& plane = frustum[iPlane];
+    const float d = Mn::Math::dot(center, plane.xyz());
+    const float r = Mn::Math::dot(extent, Mn::Math::abs(plane.xyz()));
+    if (d + r < -2.0f * plane.w()) {
+      return FrustumTest::Outside;
+    }
+    if (d - r < -2.0f * plane.w()) {
+      result = FrustumTest::Intersects;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+DrawableBvh::DrawableBvh(Mn::SceneGraph::DrawableGroup3D& group) {
+  entries_.reserve(group.size());
+  order_.reserve(group.size());
+  for (std::size_t i = 0; i != group.size(); ++i) {
+    auto& node = static_cast<scene::SceneNode&>(group[i].object());
+    node.setClean();
+    entries_.push_back({&group[i], &node, node.getAbsoluteAABB(),
+                        node.transformGeneration(), -1});
+    order_.push_back(i);
+    if (!node.hasStaticAbsoluteAABB()) {
+      dynamicEntries_.push_back(i);
+    }
+  }
+  if (!entries_.empty()) {
+    nodes_.reserve(2 * (entries_.size() / MaxLeafSize + 1));
+    build(0, entries_.size(), -1);
+  }
+}
+
+Mn::Range3D DrawableBvh::leafBounds(const Node& node) const {
+  Mn::Range3D bounds = entries_[order_[node.first]].aabb;
+  for (int i = node.first + 1; i < node.first + node.count; ++i) {
+    bounds = Mn::Math::join(bounds, entries_[order_[i]].aabb);
+  }
+  return bounds;
+}
+
+int DrawableBvh::build(int first, int count, int parent) {
+  const int index = nodes_.size();
+  nodes_.push_back({{}, parent, -1, first, count});
+
+  if (count <= MaxLeafSize) {
+    for (int i = first; i < first + count; ++i) {
+      entries_[order_[i]].leaf = index;
+    }
+    nodes_[index].aabb = leafBounds(nodes_[index]);
+    return index;
+  }
+
+  // split at the median centroid along the longest axis of the centroids
+  Mn::Range3D centroidBounds{entries_[order_[first]].aabb.center(),
+                             entries_[order_[first]].aabb.center()};
+  for (int i = first + 1; i < first + count; ++i) {
+    const Mn::Vector3 c = entries_[order_[i]].aabb.center();
+    centroidBounds = {Mn::Math::min(centroidBounds.min(), c),
+                      Mn::Math::max(centroidBounds.max(), c)};
+  }
+  const Mn::Vector3 size = centroidBounds.size();
+  const int axis = size.x() >= size.y() ? (size.x() >= size.z() ? 0 : 2)
+                                        : (size.y() >= size.z() ? 1 : 2);
+  const int half = count / 2;
+  std::nth_element(order_.begin() + first, order_.begin() + first + half,
+                   order_.begin() + first + count, [&](int a, int b) {
+                     return entries_[a].aabb.center()[axis] <
+                            entries_[b].aabb.center()[axis];
+                   });
+
+  build(first, half, index);
+  const int right = build(first + half, count - half, index);
+  nodes_[index].right = right;
+  nodes_[index].aabb =
+      Mn::Math::join(nodes_[index + 1].aabb, nodes_[right].aabb);
+  return index;
+}
+
+bool DrawableBvh::refit() {
+  bool moved = false;
+  for (int e : dynamicEntries_) {
+    Entry& entry = entries_[e];
+    // a node can move without its box changing, e.g. when spinning in place.
+    // Not checking isDirty(), the node may have been cleaned already, e.g.
+    // by SceneGraph::updateTransformations().
+    const std::uint64_t generation = entry.node->transformGeneration();
+    if (generation != entry.generation) {
+      entry.generation = generation;
+      moved = true;
+    }
+    // This updates the AABB for dynamic objects if needed
+    entry.node->setClean();
+    const Mn::Range3D& aabb = entry.node->getAbsoluteAABB();
+    if (aabb == entry.aabb) {
+      continue;
+    }
+    entry.aabb = aabb;
+    moved = true;
+
+    // walk up until a node's bounds don't change anymore
+    int index = entry.leaf;
+    Mn::Range3D bounds = leafBounds(nodes_[index]);
+    while (index != -1 && bounds != nodes_[index].aabb) {
+      nodes_[index].aabb = bounds;
+      index = nodes_[index].parent;
+      if (index != -1) {
+        bounds = Mn::Math::join(nodes_[index + 1].aabb,
+                                nodes_[nodes_[index].right].aabb);
+      }
+    }
+  }
+  return moved;
+}
+
+std::vector<std::size_t> DrawableBvh::cull(
+    const Mn::Frustum& frustum,
+    const std::function<bool(Mn::SceneGraph::Drawable3D&)>& intersects) const {
+  std::vector<std::size_t> visible;
+  if (nodes_.empty()) {
+    return visible;
+  }
+
+  std::vector<int> stack{0};
+  while (!stack.empty()) {
+    const Node& node = nodes_[stack.back()];
+    const int index = stack.back();
+    stack.pop_back();
+
+    const FrustumTest test = testRange(node.aabb, frustum);
+    if (test == FrustumTest::Outside) {
+      continue;
+    }
+    if (test == FrustumTest::Inside) {
+      visible.insert(visible.end(), order_.begin() + node.first,
+                     order_.begin() + node.first + node.count);
+    } else if (node.right == -1) {
+      for (int i = node.first; i < node.first + node.count; ++i) {
+        if (intersects(*entries_[order_[i]].drawable)) {
+          visible.push_back(order_[i]);
+        }
+      }
+    } else {
+      stack.push_back(node.right);
+      stack.push_back(index + 1);
+    }
+  }
+
+  // keep the draw order of the group
+  std::sort(visible.begin(), visible.end());
+  return visible;
+}
+
+}  // namespace gfx
+}  // namespace esp
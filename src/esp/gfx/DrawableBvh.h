@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_DRAWABLEBVH_H_
+#define ESP_GFX_DRAWABLEBVH_H_
+
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/SceneGraph/SceneGraph.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace scene {
+class SceneNode;
+}
+namespace gfx {
+
+/**
+ * @brief Bounding volume hierarchy over the absolute AABBs of a group of
+ * drawables, used to frustum cull large groups without testing every drawable.
+ *
+ * Drawables attached to a @ref scene::SceneNode with a static absolute AABB
+ * (see @ref scene::SceneNode::hasStaticAbsoluteAABB) are assumed to never
+ * move. Boxes of all other drawables are updated and their ancestors refit by
+ * @ref refit, so its cost only depends on the number of dynamic drawables.
+ */
+class DrawableBvh {
+ public:
+  /**
+   * @brief Build the hierarchy over the current drawables of @p group
+   */
+  explicit DrawableBvh(Magnum::SceneGraph::DrawableGroup3D& group);
+
+  /** @brief Number of drawables in the hierarchy */
+  std::size_t size() const { return entries_.size(); }
+
+  /**
+   * @brief Update the boxes of drawables not attached to static nodes
+   *
+   * Cleans their nodes so their absolute AABBs are up to date.
+   * @return Whether any of those nodes moved or changed their box since the
+   *    last call. Movement is detected with
+   *    @ref scene::SceneNode::transformGeneration(), so it's reported even if
+   *    the nodes were cleaned by someone else in between.
+   */
+  bool refit();
+
+  /**
+   * @brief Collect the drawables that may intersect @p frustum
+   *
+   * Subtrees completely outside of @p frustum are skipped and subtrees
+   * completely inside are accepted without further tests. Remaining leaf
+   * drawables are accepted if @p intersects returns true for them, which lets
+   * the caller keep its own per-drawable test.
+   *
+   * @return Indices of the visible drawables in the group they were built
+   * from, in increasing order
+   */
+  std::vector<std::size_t> cull(
+      const Magnum::Frustum& frustum,
+      const std::function<bool(Magnum::SceneGraph::Drawable3D&)>& intersects)
+      const;
+
+ private:
+  struct Entry {
+    Magnum::SceneGraph::Drawable3D* drawable;
+    scene::SceneNode* node;
+    Magnum::Range3D aabb;
+    //! transformGeneration() of the node when aabb was last updated
+    std::uint64_t generation;
+    //! Leaf containing this entry
+    int leaf;
+  };
+
+  struct Node {
+    Magnum::Range3D aabb;
+    int parent;
+    //! Second child, the first one directly follows this node. -1 for leaves.
+    int right;
+    //! Entries of the whole subtree are order_[first, first + count)
+    int first, count;
+  };
+
+  int build(int first, int count, int parent);
+  Magnum::Range3D leafBounds(const Node& node) const;
+
+  std::vector<Entry> entries_;
+  //! Entry indices, grouped by leaf
+  std::vector<int> order_;
+  //! Depth-first, root at index 0
+  std::vector<Node> nodes_;
+  //! Entries not attached to static nodes
+  std::vector<int> dynamicEntries_;
+
+  ESP_SMART_POINTERS(DrawableBvh)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_DRAWABLEBVH_H_
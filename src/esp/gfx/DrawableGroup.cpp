@@ -3,6 +3,11 @@
 // LICENSE file in the root directory of this source tree.
 #include "DrawableGroup.h"
 #include "Drawable.h"
+#include "DrawableBvh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
 
 namespace esp {
 namespace gfx {
@@ -37,11 +42,92 @@ Drawable* DrawableGroup::getDrawable(uint64_t id) const {
   return nullptr;
 }
 
+bool DrawableGroup::prepareForDraw(const RenderCamera&) {
+  if (hasDrawOrder()) {
+    return true;
+  }
+
+  std::vector<std::pair<Drawable::DrawState, std::size_t>> states;
+  states.reserve(size());
+  for (std::size_t i = 0; i != size(); ++i) {
+    // also catch drawables that were added through the Magnum API directly
+    auto* drawable = dynamic_cast<Drawable*>(&(*this)[i]);
+    states.emplace_back(drawable ? drawable->getDrawState()
+                                 : Drawable::DrawState{},
+                        i);
+  }
+  std::sort(states.begin(), states.end(),
+            [](const std::pair<Drawable::DrawState, std::size_t>& a,
+               const std::pair<Drawable::DrawState, std::size_t>& b) {
+              return std::tie(a.first.shader, a.first.materialId,
+                              a.first.mesh, a.second) <
+                     std::tie(b.first.shader, b.first.materialId,
+                              b.first.mesh, b.second);
+            });
+
+  drawOrder_.clear();
+  drawOrder_.reserve(states.size());
+  for (std::size_t i = 0; i != states.size(); ++i) {
+    drawOrder_.emplace(&(*this)[states[i].second], i);
+  }
+  return true;
+}
+
+bool DrawableGroup::hasDrawOrder() const {
+  return !drawOrder_.empty() && drawOrder_.size() == size();
+}
+
+std::size_t DrawableGroup::drawOrderIndex(
+    const Magnum::SceneGraph::Drawable3D& drawable) const {
+  auto it = drawOrder_.find(&drawable);
+  // drawables swapped in through the Magnum API directly go last
+  return it != drawOrder_.end() ? it->second : drawOrder_.size();
+}
+
+DrawableBvh& DrawableGroup::bvh() {
+  // also catch drawables that were added through the Magnum API directly
+  if (!bvh_ || bvh_->size() != size()) {
+    bvh_ = std::make_unique<DrawableBvh>(*this);
+    cullResults_.clear();
+  } else if (bvh_->refit()) {
+    cullResults_.clear();
+  }
+  return *bvh_;
+}
+
+const DrawableGroup::CullResult* DrawableGroup::cachedCullResult(
+    const Magnum::Matrix4& projection,
+    const Magnum::Matrix4& camera) const {
+  // exact comparison, the cached transformations are only valid for
+  // bit-identical matrices
+  for (const CullResult& result : cullResults_) {
+    if (std::memcmp(&result.projection, &projection, sizeof(projection)) ==
+            0 &&
+        std::memcmp(&result.camera, &camera, sizeof(camera)) == 0) {
+      return &result;
+    }
+  }
+  return nullptr;
+}
+
+void DrawableGroup::cacheCullResult(CullResult result) {
+  if (cullResults_.size() == MaxCachedCullResults) {
+    cullResults_.erase(cullResults_.begin());
+  }
+  cullResults_.emplace_back(std::move(result));
+}
+
 bool DrawableGroup::registerDrawable(Drawable& drawable) {
+  bvh_ = nullptr;
+  cullResults_.clear();
+  drawOrder_.clear();
   // if it is already registered, emplace will do nothing
   return idToDrawable_.emplace(drawable.getDrawableId(), &drawable).second;
 }
 bool DrawableGroup::unregisterDrawable(Drawable& drawable) {
+  bvh_ = nullptr;
+  cullResults_.clear();
+  drawOrder_.clear();
   // if it is not registered, erase will do nothing
   return idToDrawable_.erase(drawable.getDrawableId()) != 0;
 }
@@ -5,12 +5,15 @@
 #ifndef ESP_GFX_DRAWABLEGROUP_H_
 #define ESP_GFX_DRAWABLEGROUP_H_
 
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/FeatureGroup.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 #include <unordered_map>
 
 #include <functional>
+#include <memory>
+#include <vector>
 #include "esp/core/Esp.h"
 
 namespace esp {
@@ -18,6 +21,7 @@ namespace gfx {
 
 class RenderCamera;
 class Drawable;
+class DrawableBvh;
 
 /**
  * @brief Group of drawables, and shared group parameters.
@@ -60,9 +64,71 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
   /**
    * @brief Prepare to draw group with given @ref RenderCamera
    *
+   * Builds the draw order of @ref drawOrderIndex() if drawables were added or
+   * removed since it was last built.
    * @return Whether the @ref DrawableGroup is in a valid state to be drawn
    */
-  virtual bool prepareForDraw(const RenderCamera&) { return true; }
+  virtual bool prepareForDraw(const RenderCamera& camera);
+
+  /**
+   * @brief Whether the draw order built by @ref prepareForDraw() covers all
+   * drawables of the group
+   */
+  bool hasDrawOrder() const;
+
+  /**
+   * @brief Position of @p drawable in the draw order built by
+   * @ref prepareForDraw()
+   *
+   * Drawables are ordered by shader, then material, then mesh, see
+   * @ref Drawable::getDrawState(), so that consecutive draws change as little
+   * GL state as possible. Ties keep the order of the group. Only meaningful
+   * if @ref hasDrawOrder() is true.
+   */
+  std::size_t drawOrderIndex(
+      const Magnum::SceneGraph::Drawable3D& drawable) const;
+
+  /**
+   * @brief Bounding volume hierarchy over the drawables of this group, used
+   * by @ref RenderCamera for frustum culling
+   *
+   * Built on first use and rebuilt after drawables were added or removed.
+   * Boxes of drawables on dynamic nodes are refit on every call, so the
+   * hierarchy can be shared by all cameras rendering the group.
+   */
+  DrawableBvh& bvh();
+
+  /**
+   * @brief Visible drawables of a frustum cull, see
+   * @ref RenderCamera::visibleDrawableTransformations
+   */
+  struct CullResult {
+    Magnum::Matrix4 projection;
+    Magnum::Matrix4 camera;
+    //! Indices of the visible drawables in this group
+    std::vector<std::size_t> visible;
+    //! Transformations of the visible drawables relative to the camera
+    std::vector<Magnum::Matrix4> transformations;
+  };
+
+  /**
+   * @brief Result cached by @ref cacheCullResult for exactly this projection
+   * and camera matrix, or nullptr
+   *
+   * Cached results are dropped whenever @ref bvh() is rebuilt or finds moved
+   * drawables, so co-located cameras rendering the same frame share one cull.
+   */
+  const CullResult* cachedCullResult(const Magnum::Matrix4& projection,
+                                     const Magnum::Matrix4& camera) const;
+
+  /**
+   * @brief Cache a cull result, replacing the oldest one if there are
+   * already @ref MaxCachedCullResults
+   */
+  void cacheCullResult(CullResult result);
+
+  //! Enough for a few co-located sensors with different projections
+  static constexpr std::size_t MaxCachedCullResults = 4;
 
  protected:
   /**
@@ -87,6 +153,23 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
    * a lookup table, that maps a drawable id to the drawable object
    */
   std::unordered_map<uint64_t, Drawable*> idToDrawable_;
+  /**
+   * lazily built by @ref bvh(), reset whenever a drawable is registered or
+   * unregistered
+   */
+  std::unique_ptr<DrawableBvh> bvh_;
+  /**
+   * results of recent culls, oldest first. Cleared whenever bvh_ is rebuilt
+   * or refit with moved drawables
+   */
+  std::vector<CullResult> cullResults_;
+  /**
+   * position of each drawable in the draw order, built by
+   * @ref prepareForDraw() and cleared whenever a drawable is registered or
+   * unregistered
+   */
+  std::unordered_map<const Magnum::SceneGraph::Drawable3D*, std::size_t>
+      drawOrder_;
   ESP_SMART_POINTERS(DrawableGroup)
 };
 
@@ -11,6 +11,7 @@
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/Version.h>
 #include "esp/gfx/CubeMap.h"
+#include "esp/gfx_batch/ShaderCache.h"
 
 #include <sstream>
 
@@ -76,11 +77,14 @@ EquirectangularShader::EquirectangularShader(Flags flags)
                      : "")
       .addSource(rs.getString("equirectangular.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // set texture binding points in the shader
   if (flags_ & CubeMapShaderBase::Flag::ColorTexture) {
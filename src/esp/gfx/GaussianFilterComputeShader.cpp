@@ -0,0 +1,135 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GaussianFilterComputeShader.h"
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/ImageFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/gfx_batch/ShaderCache.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+enum {
+  SourceImageUnit = 0,
+  DestinationImageUnit = 1,
+};
+
+// texels of a row or column filtered by one work group
+constexpr Mn::UnsignedInt TileSize = 128;
+
+}  // namespace
+
+bool GaussianFilterComputeShader::isSupported() {
+#ifndef MAGNUM_TARGET_GLES
+  return Mn::GL::Context::current().isVersionSupported(Mn::GL::Version::GL430);
+#else
+  return false;
+#endif
+}
+
+GaussianFilterComputeShader::GaussianFilterComputeShader() {
+#ifndef MAGNUM_TARGET_GLES
+  CORRADE_ASSERT(isSupported(),
+                 "GaussianFilterComputeShader: OpenGL 4.3 is not supported", );
+
+  if (!Corrade::Utility::Resource::hasGroup("gfx-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"gfx-shaders"};
+
+  Mn::GL::Shader comp{Mn::GL::Version::GL430, Mn::GL::Shader::Type::Compute};
+  comp.addSource(Cr::Utility::formatString(
+                     "#define TILE_SIZE {}\n"
+                     "#define SOURCE_IMAGE_UNIT {}\n"
+                     "#define DESTINATION_IMAGE_UNIT {}\n",
+                     TileSize, SourceImageUnit, DestinationImageUnit))
+      .addSource(rs.getString("gaussianFilter.comp"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(
+      gfx_batch::linkCachedShaderProgram(*this, {comp}, [&]() {
+        if (!comp.compile()) {
+          return false;
+        }
+        attachShader(comp);
+        return link();
+      }));
+
+  filterDirectionUniform_ = uniformLocation("FilterDirection");
+  CORRADE_INTERNAL_ASSERT(filterDirectionUniform_ >= 0);
+#else
+  CORRADE_ASSERT_UNREACHABLE(
+      "GaussianFilterComputeShader: not available on OpenGL ES", );
+#endif
+}
+
+GaussianFilterComputeShader& GaussianFilterComputeShader::setFilteringDirection(
+    GaussianFilterShader::FilteringDirection dir) {
+  if (dir == GaussianFilterShader::FilteringDirection::Horizontal) {
+    setUniform(filterDirectionUniform_, Mn::Vector2i(1, 0));
+  } else {
+    setUniform(filterDirectionUniform_, Mn::Vector2i(0, 1));
+  }
+  return *this;
+}
+
+GaussianFilterComputeShader& GaussianFilterComputeShader::bindSource(
+    Mn::GL::CubeMapTexture& texture) {
+#ifndef MAGNUM_TARGET_GLES
+  texture.bindImageLayered(SourceImageUnit, 0, Mn::GL::ImageAccess::ReadOnly,
+                           Mn::GL::ImageFormat::RGBA8);
+#else
+  static_cast<void>(texture);
+#endif
+  return *this;
+}
+
+GaussianFilterComputeShader& GaussianFilterComputeShader::bindDestination(
+    Mn::GL::CubeMapTexture& texture) {
+#ifndef MAGNUM_TARGET_GLES
+  texture.bindImageLayered(DestinationImageUnit, 0,
+                           Mn::GL::ImageAccess::WriteOnly,
+                           Mn::GL::ImageFormat::RGBA8);
+#else
+  static_cast<void>(texture);
+#endif
+  return *this;
+}
+
+void GaussianFilterComputeShader::filter(int cubeMapSize) {
+#ifndef MAGNUM_TARGET_GLES
+  // one work group per tile of every row (or column) of every face
+  dispatchCompute({(Mn::UnsignedInt(cubeMapSize) + TileSize - 1) / TileSize,
+                   Mn::UnsignedInt(cubeMapSize), 6});
+  // the result is read by the next pass or sampled afterwards
+  Mn::GL::Renderer::setMemoryBarrier(
+      Mn::GL::Renderer::MemoryBarrier::ShaderImageAccess |
+      Mn::GL::Renderer::MemoryBarrier::TextureFetch |
+      Mn::GL::Renderer::MemoryBarrier::TextureUpdate |
+      Mn::GL::Renderer::MemoryBarrier::Framebuffer);
+#else
+  static_cast<void>(cubeMapSize);
+#endif
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,66 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_GAUSSIANFILTERCOMPUTESHADER_H_
+#define ESP_GFX_GAUSSIANFILTERCOMPUTESHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/GL.h>
+
+#include "GaussianFilterShader.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Compute shader variant of @ref GaussianFilterShader
+
+Filters all six faces of an RGBA8 cube map in one dispatch per direction,
+reading from and writing to the cube maps directly instead of copying each
+face to a texture and drawing it. Needs OpenGL 4.3, see @ref isSupported().
+*/
+class GaussianFilterComputeShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  /** @brief Whether the current context can run the shader */
+  static bool isSupported();
+
+  /** @brief Constructor */
+  explicit GaussianFilterComputeShader();
+
+  /**
+   * @brief Set the filtering direction
+   * @return Reference to self (for method chaining)
+   */
+  GaussianFilterComputeShader& setFilteringDirection(
+      GaussianFilterShader::FilteringDirection dir);
+
+  /**
+   * @brief Bind the cube map to filter
+   * @return Reference to self (for method chaining)
+   */
+  GaussianFilterComputeShader& bindSource(
+      Magnum::GL::CubeMapTexture& texture);
+
+  /**
+   * @brief Bind the cube map the result is written to, with the same size
+   * as the source
+   * @return Reference to self (for method chaining)
+   */
+  GaussianFilterComputeShader& bindDestination(
+      Magnum::GL::CubeMapTexture& texture);
+
+  /**
+   * @brief Filter all faces of the bound source into the destination
+   * @param cubeMapSize size of a face of both cube maps
+   */
+  void filter(int cubeMapSize);
+
+ private:
+  GLint filterDirectionUniform_ = -1;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif
@@ -4,7 +4,10 @@
 
 #include "GenericDrawable.h"
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix3.h>
@@ -13,14 +16,41 @@
 
 #include "Magnum/Types.h"
 #include "esp/core/Check.h"
+#include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/SkinData.h"
 #include "esp/scene/SceneNode.h"
 
+namespace Cr = Corrade;
 namespace Mn = Magnum;
 
 namespace esp {
 namespace gfx {
 
+namespace {
+
+// per-instance vertex data of drawInstanced(), matching the attributes it
+// adds to the mesh
+struct InstanceData {
+  Mn::Matrix4 transformationMatrix;
+  Mn::Matrix3x3 normalMatrix;
+  Mn::UnsignedInt objectId;
+};
+
+bool operator==(const GenericDrawable::GenericMaterialCache& a,
+                const GenericDrawable::GenericMaterialCache& b) {
+  return a.ambientColor == b.ambientColor &&
+         a.diffuseColor == b.diffuseColor &&
+         a.specularColor == b.specularColor && a.shininess == b.shininess &&
+         a.textureMatrix == b.textureMatrix &&
+         a.ambientTexture == b.ambientTexture &&
+         a.diffuseTexture == b.diffuseTexture &&
+         a.specularTexture == b.specularTexture &&
+         a.normalTexture == b.normalTexture &&
+         a.objectIdTexture == b.objectIdTexture;
+}
+
+}  // namespace
+
 GenericDrawable::GenericDrawable(scene::SceneNode& node,
                                  Mn::GL::Mesh* mesh,
                                  Drawable::Flags& meshAttributeFlags,
@@ -30,9 +60,11 @@ GenericDrawable::GenericDrawable(scene::SceneNode& node,
                shaderManager.get<LightSetup>(cfg.lightSetupKey_)},
       shaderManager_{shaderManager},
       meshAttributeFlags_{meshAttributeFlags} {
-  resetMaterialValues(
+  auto material =
       shaderManager.get<Mn::Trade::MaterialData, Mn::Trade::MaterialData>(
-          cfg.materialDataKey_));
+          cfg.materialDataKey_);
+  resetMaterialValues(material);
+  shareMaterialId(cfg.materialDataKey_, &*material);
 
   // update the shader early here to to avoid doing it during the render loop
   if (glMeshExists()) {
@@ -125,8 +157,18 @@ void GenericDrawable::setMaterialValuesInternal(
     flags_ = oldFlags;
   }
 
+  // the values may now differ from any other drawable's
+  assignUniqueMaterialId();
 }  // GenericDrawable::setMaterialValuesInternal
 
+Drawable::DrawState GenericDrawable::getDrawState() {
+  if (!glMeshExists()) {
+    return Drawable::getDrawState();
+  }
+  updateShader();
+  return {&*shader_, materialId_, &getMesh()};
+}
+
 void GenericDrawable::setLightSetup(const Mn::ResourceKey& resourceKey) {
   lightSetup_ = shaderManager_.get<LightSetup>(resourceKey);
 
@@ -193,6 +235,23 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
       .setProjectionMatrix(camera.projectionMatrix())
       .setNormalMatrix(normalMatrix);
 
+  bindMaterialTextures();
+
+  if (skinData_) {
+    shader_->setJointMatrices(buildSkinJointTransforms(
+        static_cast<RenderCamera&>(camera).drawPass()));
+  }
+
+  shader_->draw(getMesh());
+
+  // Reset winding direction
+  if (normalDet < 0) {
+    Mn::GL::Renderer::setFrontFace(
+        Mn::GL::Renderer::FrontFace::CounterClockWise);
+  }
+}
+
+void GenericDrawable::bindMaterialTextures() {
   if (flags_ & Mn::Shaders::PhongGL::Flag::TextureTransformation) {
     shader_->setTextureMatrix(matCache.textureMatrix);
   }
@@ -212,58 +271,204 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
   if (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture) {
     shader_->bindObjectIdTexture(*(matCache.objectIdTexture));
   }
+}
 
-  if (skinData_) {
-    buildSkinJointTransforms();
-    shader_->setJointMatrices(jointTransformations_);
+bool GenericDrawable::canDrawInstanced() {
+#ifndef MAGNUM_TARGET_WEBGL
+  // the instanced object ID shares the attribute location with per-vertex
+  // object IDs and bitangents
+  if (!glMeshExists() || skinData_ ||
+      (flags_ & (Mn::Shaders::PhongGL::Flag::InstancedObjectId |
+                 Mn::Shaders::PhongGL::Flag::ObjectIdTexture |
+                 Mn::Shaders::PhongGL::Flag::Bitangent))) {
+    return false;
   }
+  // all instances share the light positions
+  for (Mn::UnsignedInt i = 0; i < lightSetup_->size(); ++i) {
+    if ((*lightSetup_)[i].model == LightPositionModel::Object) {
+      return false;
+    }
+  }
+  return true;
+#else
+  // without vertex array objects, every attribute added to the mesh would be
+  // kept around
+  return false;
+#endif
+}
 
-  shader_->draw(getMesh());
+bool GenericDrawable::isInstanceCompatible(
+    const GenericDrawable& other) const {
+  return &getMesh() == &other.getMesh() && flags_ == other.flags_ &&
+         lightSetup_.key() == other.lightSetup_.key() &&
+         matCache == other.matCache;
+}
 
-  // Reset winding direction
-  if (normalDet < 0) {
+void GenericDrawable::drawInstanced(
+    Cr::Containers::ArrayView<const std::pair<GenericDrawable*, Mn::Matrix4>>
+        instances,
+    Mn::SceneGraph::Camera3D& camera,
+    Mn::GL::Buffer& instanceBuffer) {
+#ifndef MAGNUM_TARGET_WEBGL
+  CORRADE_ASSERT(!instances.isEmpty(),
+                 "GenericDrawable::drawInstanced() : no instances", );
+  GenericDrawable& first = *instances.front().first;
+  const int semanticDataIDX =
+      static_cast<RenderCamera&>(camera).getSemanticDataIDX();
+
+  Cr::Containers::Array<InstanceData> instanceData{Cr::NoInit,
+                                                   instances.size()};
+  for (std::size_t i = 0; i != instances.size(); ++i) {
+    const Mn::Matrix4& transformationMatrix = instances[i].second;
+    const Mn::Matrix3x3 rotScale = transformationMatrix.rotationScaling();
+    CORRADE_INTERNAL_ASSERT(rotScale.determinant() > 0.0f);
+    // see draw() for the normal matrix derivation
+    instanceData[i].transformationMatrix = transformationMatrix;
+    instanceData[i].normalMatrix = rotScale.comatrix() / rotScale.determinant();
+    instanceData[i].objectId =
+        instances[i].first->node_.getShaderObjectID(semanticDataIDX);
+  }
+  instanceBuffer.setData(instanceData, Mn::GL::BufferUsage::StreamDraw);
+
+  // everything but the transformation and object ID is shared, so set it up
+  // through the first drawable with the instanced shader swapped in
+  first.updateShader(first.instancedShader_,
+                     first.flags_ |
+                         Mn::Shaders::PhongGL::Flag::InstancedTransformation |
+                         Mn::Shaders::PhongGL::Flag::InstancedObjectId);
+  std::swap(first.shader_, first.instancedShader_);
+  // lights aren't relative to the object, so there's no transformation
+  first.updateShaderLightingParameters(
+      Mn::Matrix4{}, camera, first.shader_,
+      [](const LightInfo& lightInfo,
+         const Magnum::Matrix4& transformationMatrix,
+         const Magnum::Matrix4& cameraMatrix) {
+        return getLightPositionRelativeToCamera(lightInfo, transformationMatrix,
+                                                cameraMatrix);
+      });
+  // the uniforms are multiplied with / added to the per-instance values
+  (*first.shader_)
+      .setObjectId(0)
+      .setTransformationMatrix(Mn::Matrix4{})
+      .setProjectionMatrix(camera.projectionMatrix())
+      .setNormalMatrix(Mn::Matrix3x3{});
+  first.bindMaterialTextures();
+
+  Mn::GL::Mesh& mesh = first.getMesh();
+  mesh.addVertexBufferInstanced(instanceBuffer, 1, 0,
+                                Mn::Shaders::PhongGL::TransformationMatrix{},
+                                Mn::Shaders::PhongGL::NormalMatrix{},
+                                Mn::Shaders::PhongGL::ObjectId{})
+      .setInstanceCount(instances.size());
+  first.shader_->draw(mesh);
+  mesh.setInstanceCount(1);
+
+  std::swap(first.shader_, first.instancedShader_);
+#else
+  CORRADE_ASSERT_UNREACHABLE(
+      "GenericDrawable::drawInstanced() : not available on WebGL", );
+#endif
+}
+
+void GenericDrawable::drawObjectId(const Mn::Matrix4& transformationMatrix,
+                                   Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(!skinData_,
+                 "GenericDrawable::drawObjectId(): skinned drawables can't be "
+                 "drawn with a flat shader", );
+  Mn::Shaders::FlatGL3D::Flags flags = Mn::Shaders::FlatGL3D::Flag::ObjectId;
+  if (flags_ >= Mn::Shaders::PhongGL::Flag::InstancedObjectId) {
+    flags |= Mn::Shaders::FlatGL3D::Flag::InstancedObjectId;
+  }
+  if (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture) {
+    flags |= Mn::Shaders::FlatGL3D::Flag::ObjectIdTexture;
+    if (flags_ & Mn::Shaders::PhongGL::Flag::TextureTransformation) {
+      flags |= Mn::Shaders::FlatGL3D::Flag::TextureTransformation;
+    }
+  }
+  if (!objectIdShader_ || objectIdShader_->flags() != flags) {
+    using FlagsType = Mn::Shaders::FlatGL3D::Flags::UnderlyingType;
+    objectIdShader_ = shaderManager_.get<Mn::GL::AbstractShaderProgram,
+                                         Mn::Shaders::FlatGL3D>(
+        getShaderKey("FlatObjectId", 0, static_cast<FlagsType>(flags), 0));
+    if (!objectIdShader_) {
+      shaderManager_.set<Mn::GL::AbstractShaderProgram>(
+          objectIdShader_.key(),
+          new Mn::Shaders::FlatGL3D{
+              Mn::Shaders::FlatGL3D::Configuration{}.setFlags(flags)},
+          Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
+    }
+    CORRADE_INTERNAL_ASSERT(objectIdShader_ &&
+                            objectIdShader_->flags() == flags);
+  }
+
+  // Flip winding direction to correct handle backface culling
+  const bool mirrored =
+      transformationMatrix.rotationScaling().determinant() < 0.0f;
+  if (mirrored) {
+    Mn::GL::Renderer::setFrontFace(Mn::GL::Renderer::FrontFace::ClockWise);
+  }
+
+  (*objectIdShader_)
+      .setObjectId(
+          ((flags_ >= Mn::Shaders::PhongGL::Flag::InstancedObjectId) ||
+           (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture))
+              ? 0
+              : node_.getShaderObjectID(
+                    static_cast<RenderCamera&>(camera).getSemanticDataIDX()))
+      .setTransformationProjectionMatrix(camera.projectionMatrix() *
+                                         transformationMatrix);
+  if (flags & Mn::Shaders::FlatGL3D::Flag::TextureTransformation) {
+    objectIdShader_->setTextureMatrix(matCache.textureMatrix);
+  }
+  if (flags >= Mn::Shaders::FlatGL3D::Flag::ObjectIdTexture) {
+    objectIdShader_->bindObjectIdTexture(*(matCache.objectIdTexture));
+  }
+  objectIdShader_->draw(getMesh());
+
+  if (mirrored) {
     Mn::GL::Renderer::setFrontFace(
         Mn::GL::Renderer::FrontFace::CounterClockWise);
   }
 }
 
 void GenericDrawable::updateShader() {
+  updateShader(shader_, flags_);
+}
+
+void GenericDrawable::updateShader(
+    Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL>& shader,
+    Mn::Shaders::PhongGL::Flags flags) {
   const Mn::UnsignedInt lightCount = lightSetup_->size();
   const Mn::UnsignedInt jointCount =
       skinData_ ? skinData_->skinData->skin->joints().size() : 0;
   const Mn::UnsignedInt perVertexJointCount =
       skinData_ ? skinData_->skinData->perVertexJointCount : 0;
 
-  if (skinData_) {
-    resizeJointTransformArray(jointCount);
-  }
-
-  if (!shader_ || shader_->lightCount() != lightCount ||
-      shader_->flags() != flags_) {
+  if (!shader || shader->lightCount() != lightCount ||
+      shader->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ =
+    shader =
         shaderManager_.get<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL>(
             getShaderKey(
                 "Phong", lightCount,
-                static_cast<Mn::Shaders::PhongGL::Flags::UnderlyingType>(
-                    flags_),
+                static_cast<Mn::Shaders::PhongGL::Flags::UnderlyingType>(flags),
                 jointCount));
 
     // if no shader with desired number of lights and flags exists, create one
-    if (!shader_) {
+    if (!shader) {
       shaderManager_.set<Mn::GL::AbstractShaderProgram>(
-          shader_.key(),
+          shader.key(),
           new Mn::Shaders::PhongGL{
               Mn::Shaders::PhongGL::Configuration{}
-                  .setFlags(flags_)
+                  .setFlags(flags)
                   .setLightCount(lightCount)
                   .setJointCount(jointCount, perVertexJointCount)},
           Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
     }
 
-    CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
-                            shader_->flags() == flags_);
+    CORRADE_INTERNAL_ASSERT(shader && shader->lightCount() == lightCount &&
+                            shader->flags() == flags);
   }
 }
 
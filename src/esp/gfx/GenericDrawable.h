@@ -5,8 +5,11 @@
 #ifndef ESP_GFX_GENERICDRAWABLE_H_
 #define ESP_GFX_GENERICDRAWABLE_H_
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Shaders/FlatGL.h>
 #include <Magnum/Shaders/PhongGL.h>
 #include <memory>
+#include <utility>
 
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/DrawableConfiguration.h"
@@ -47,6 +50,58 @@ class GenericDrawable : public Drawable {
 
   void setLightSetup(const Mn::ResourceKey& lightSetupKey) override;
 
+  /**
+   * @brief Whether this drawable can be drawn through @ref drawInstanced()
+   *
+   * Skinned drawables, drawables with per-vertex or textured object IDs,
+   * separate bitangents or lights relative to the object can't.
+   */
+  bool canDrawInstanced();
+
+  /**
+   * @brief Shader, material and mesh this drawable draws with
+   */
+  DrawState getDrawState() override;
+
+  /**
+   * @brief Whether this drawable is drawn exactly like @p other, apart from
+   * the transformation and object ID
+   *
+   * True if both share the mesh, material values, lights and shader flags.
+   */
+  bool isInstanceCompatible(const GenericDrawable& other) const;
+
+  /**
+   * @brief Draw several drawables in a single instanced draw call
+   * @param instances       Drawables along with their transformations
+   *    relative to @p camera. All have to @ref canDrawInstanced(), be
+   *    @ref isInstanceCompatible() with the first one and have a transformation
+   *    with a positive determinant.
+   * @param camera          Camera to draw from, has to be a @ref RenderCamera
+   * @param instanceBuffer  Buffer the per-instance transformations and object
+   *    IDs get uploaded to
+   *
+   * Temporarily attaches @p instanceBuffer to the shared mesh.
+   */
+  static void drawInstanced(
+      Corrade::Containers::ArrayView<
+          const std::pair<GenericDrawable*, Mn::Matrix4>> instances,
+      Mn::SceneGraph::Camera3D& camera,
+      Mn::GL::Buffer& instanceBuffer);
+
+  /**
+   * @brief Draw only the object IDs, with a flat shader
+   * @param transformationMatrix  Transformation relative to @p camera
+   * @param camera                Camera to draw from, has to be a
+   *    @ref RenderCamera
+   *
+   * Writes the same object IDs as a regular draw, including per-vertex and
+   * textured ones, without any lighting or other textures. Can't be used for
+   * skinned drawables.
+   */
+  void drawObjectId(const Mn::Matrix4& transformationMatrix,
+                    Mn::SceneGraph::Camera3D& camera);
+
  private:
   /**
    * @brief Internal implementation of material setting, so that it can be
@@ -63,6 +118,19 @@ class GenericDrawable : public Drawable {
 
   void updateShader();
 
+  /**
+   * @brief Fetch or create a shader with given flags
+   */
+  void updateShader(
+      Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL>&
+          shader,
+      Mn::Shaders::PhongGL::Flags flags);
+
+  /**
+   * @brief Set the texture matrix and bind the textures of the material
+   */
+  void bindMaterialTextures();
+
   void updateShaderLightingParametersInternal() override;
 
   // shader parameters
@@ -70,6 +138,13 @@ class GenericDrawable : public Drawable {
   Mn::Shaders::PhongGL::Flags flags_;
   ShaderManager& shaderManager_;
   Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL> shader_;
+  //! Variant of @ref shader_ with instanced transformations and object IDs,
+  //! fetched on first @ref drawInstanced()
+  Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL>
+      instancedShader_;
+  //! Flat shader of @ref drawObjectId(), fetched on first use
+  Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::FlatGL3D>
+      objectIdShader_;
 
   /**
    * Local cache of material quantities to speed up access in draw
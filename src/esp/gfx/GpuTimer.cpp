@@ -0,0 +1,154 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GpuTimer.h"
+
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
+#ifndef MAGNUM_TARGET_WEBGL
+#include <Magnum/GL/TimeQuery.h>
+#endif
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+//! Current GPU scope nesting depth of the calling thread
+uint32_t& gpuDepth() {
+  thread_local uint32_t depth = 0;
+  return depth;
+}
+}  // namespace
+
+struct GpuTimer::Slot {
+  const char* name = nullptr;
+  uint32_t depth = 0;
+  bool ended = false;
+#ifndef MAGNUM_TARGET_WEBGL
+  Mn::GL::TimeQuery start{Mn::NoCreate};
+  Mn::GL::TimeQuery finish{Mn::NoCreate};
+#endif
+};
+
+bool GpuTimer::isSupported() {
+#ifdef MAGNUM_TARGET_WEBGL
+  return false;
+#else
+  if (!Mn::GL::Context::hasCurrent()) {
+    return false;
+  }
+#ifndef MAGNUM_TARGET_GLES
+  return Mn::GL::Context::current()
+      .isExtensionSupported<Mn::GL::Extensions::ARB::timer_query>();
+#else
+  return Mn::GL::Context::current()
+      .isExtensionSupported<Mn::GL::Extensions::EXT::disjoint_timer_query>();
+#endif
+#endif
+}
+
+GpuTimer::GpuTimer() = default;
+
+GpuTimer::~GpuTimer() = default;
+
+GpuTimer::GpuTimer(GpuTimer&&) noexcept = default;
+
+GpuTimer& GpuTimer::operator=(GpuTimer&&) noexcept = default;
+
+int GpuTimer::begin(const char* name) {
+#ifdef MAGNUM_TARGET_WEBGL
+  static_cast<void>(name);
+  return -1;
+#else
+  if (!isSupported()) {
+    return -1;
+  }
+  collect();
+  if (numStarted_ - numCollected_ == Capacity) {
+    ESP_PROFILE_COUNT("GpuTimer::dropped", 1);
+    return -1;
+  }
+  if (!slots_) {
+    slots_.reset(new Slot[Capacity]);
+  }
+
+  const std::size_t index = numStarted_++ % Capacity;
+  Slot& slot = slots_[index];
+  if (!slot.start.id()) {
+    slot.start = Mn::GL::TimeQuery{Mn::GL::TimeQuery::Target::Timestamp};
+    slot.finish = Mn::GL::TimeQuery{Mn::GL::TimeQuery::Target::Timestamp};
+  }
+  slot.name = name;
+  slot.depth = gpuDepth()++;
+  slot.ended = false;
+  slot.start.timestamp();
+  return int(index);
+#endif
+}
+
+void GpuTimer::end(int index) {
+#ifndef MAGNUM_TARGET_WEBGL
+  Slot& slot = slots_[index];
+  slot.finish.timestamp();
+  slot.ended = true;
+  --gpuDepth();
+#else
+  static_cast<void>(index);
+#endif
+}
+
+void GpuTimer::collect() {
+#ifndef MAGNUM_TARGET_WEBGL
+  if (numCollected_ == numStarted_) {
+    return;
+  }
+#ifdef MAGNUM_TARGET_GLES
+  // a GPU clock change, e.g. due to throttling, makes the timestamps of all
+  // passes in flight meaningless
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+#else
+  const GLint disjoint = 0;
+#endif
+
+  bool calibrated = false;
+  for (; numCollected_ != numStarted_; ++numCollected_) {
+    Slot& slot = slots_[numCollected_ % Capacity];
+    // passes end in reverse order of nesting, and the end timestamp is
+    // submitted after the start, so both are ready once it is
+    if (!slot.ended || !slot.finish.resultAvailable()) {
+      break;
+    }
+    const auto startNs = slot.start.result<Mn::UnsignedLong>();
+    const auto endNs = slot.finish.result<Mn::UnsignedLong>();
+    if (disjoint) {
+      continue;
+    }
+    // the GPU clock has an arbitrary origin and may drift from the CPU one,
+    // so the offset is measured again on every collection that has results
+    if (!calibrated) {
+      GLint64 gpuNowNs = 0;
+#ifndef MAGNUM_TARGET_GLES
+      glGetInteger64v(GL_TIMESTAMP, &gpuNowNs);
+#else
+      glGetInteger64v(GL_TIMESTAMP_EXT, &gpuNowNs);
+#endif
+      clockOffsetNs_ = int64_t(core::Profiler::now()) - gpuNowNs;
+      calibrated = true;
+    }
+    const auto toProfilerNs = [&](Mn::UnsignedLong gpuNs) {
+      const int64_t ns = int64_t(gpuNs) + clockOffsetNs_;
+      return uint64_t(ns > 0 ? ns : 0);
+    };
+    core::Profiler::instance().recordGpu(slot.name, toProfilerNs(startNs),
+                                         toProfilerNs(endNs), slot.depth);
+  }
+#endif
+}  // GpuTimer::collect
+
+}  // namespace gfx
+}  // namespace esp
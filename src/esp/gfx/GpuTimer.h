@@ -0,0 +1,125 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_GPUTIMER_H_
+#define ESP_GFX_GPUTIMER_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::GpuTimer, @ref esp::gfx::GpuProfileScope, macro
+ * @ref ESP_PROFILE_GPU_SCOPE
+ */
+
+#include <Magnum/GL/GL.h>
+#include <cstdint>
+#include <memory>
+
+#include "esp/core/Profiler.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Times GPU passes with timestamp queries and records them in the
+ * @ref core::Profiler.
+ *
+ * Each timed pass takes a pair of queries from a fixed-size ring. Results
+ * are only read once the driver reports them available, which is checked
+ * whenever a new pass starts, so timing never stalls the pipeline. If all
+ * queries are still in flight, the pass is not timed and counted under
+ * @cpp "GpuTimer::dropped" @ce instead. Timestamps rather than elapsed time
+ * queries are used so passes can nest.
+ *
+ * Queries belong to the GL context current when the pass started, so an
+ * instance has to be used with a single context only. While the profiler is
+ * disabled or on drivers without timer queries, passes cost a single check.
+ */
+class GpuTimer {
+ public:
+  /** @brief Number of passes that can be in flight at once */
+  static constexpr std::size_t Capacity = 64;
+
+  /** @brief Whether the current GL context supports timestamp queries */
+  static bool isSupported();
+
+  /** @brief Constructor. Doesn't create any GL objects. */
+  GpuTimer();
+
+  ~GpuTimer();
+
+  GpuTimer(GpuTimer&&) noexcept;
+  GpuTimer& operator=(GpuTimer&&) noexcept;
+
+  /**
+   * @brief Start timing a pass
+   * @param name  Pass name, must be a string literal
+   * @return Index to pass to @ref end(), or @cpp -1 @ce if the pass isn't
+   *    timed
+   *
+   * Use @ref ESP_PROFILE_GPU_SCOPE instead of calling this directly.
+   */
+  int begin(const char* name);
+
+  /** @brief Finish timing the pass started by @ref begin() */
+  void end(int index);
+
+  /**
+   * @brief Record the results of all passes that finished on the GPU
+   *
+   * Called by @ref begin() already, useful to flush the results after the
+   * last pass of a frame.
+   */
+  void collect();
+
+ private:
+  struct Slot;
+
+  //! Capacity slots, allocated on first use
+  std::unique_ptr<Slot[]> slots_;
+  //! Total number of passes started and collected, the ring position is
+  //! modulo the slot count
+  std::size_t numStarted_ = 0;
+  std::size_t numCollected_ = 0;
+  //! Profiler time minus GPU time
+  int64_t clockOffsetNs_ = 0;
+};
+
+/**
+ * @brief RAII helper timing the enclosing scope on the GPU. See
+ * @ref ESP_PROFILE_GPU_SCOPE.
+ */
+class GpuProfileScope {
+ public:
+  explicit GpuProfileScope(GpuTimer& timer, const char* name)
+      : timer_(core::Profiler::isEnabled() ? &timer : nullptr),
+        index_(timer_ ? timer_->begin(name) : -1) {}
+
+  ~GpuProfileScope() {
+    if (index_ != -1) {
+      timer_->end(index_);
+    }
+  }
+
+  GpuProfileScope(const GpuProfileScope&) = delete;
+  GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+ private:
+  GpuTimer* timer_;
+  int index_;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+/**
+ * @brief Time the GPU commands submitted in the enclosing scope with
+ * @p timer under @cpp "GPU " @ce followed by @p name, which must be a string
+ * literal, whenever the @ref esp::core::Profiler is enabled.
+ */
+#define ESP_PROFILE_GPU_SCOPE(timer, name)                         \
+  esp::gfx::GpuProfileScope ESP_PROFILE_SCOPE_CONCAT(              \
+      espGpuProfileScope_, __LINE__) {                             \
+    timer, "GPU " name                                             \
+  }
+
+#endif  // ESP_GFX_GPUTIMER_H_
@@ -0,0 +1,228 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LightClusters.h"
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/Sampler.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+float LightClusters::influenceRange(const Mn::Color3& color,
+                                    float threshold) {
+  // negative lights darken just as far as positive ones lighten
+  const float intensity = Mn::Math::abs(color).max();
+  return Mn::Math::sqrt(intensity / threshold);
+}
+
+LightClusters::LightClusters(const Mn::Vector3i& clusterCount)
+    : clusterCount_{clusterCount} {
+  CORRADE_ASSERT(clusterCount.min() > 0,
+                 "LightClusters::LightClusters(): expected a non-zero "
+                 "cluster count, got"
+                     << clusterCount, );
+}
+
+bool LightClusters::update(const LightSetup& lightSetup,
+                           const Mn::Matrix4& cameraMatrix,
+                           const Mn::Matrix4& projectionMatrix,
+                           const Mn::Vector2i& viewportSize) {
+  if (updated_ && lightSetup == lightSetup_ && cameraMatrix == cameraMatrix_ &&
+      projectionMatrix == projectionMatrix_ && viewportSize == viewportSize_) {
+    return false;
+  }
+  updated_ = true;
+  uploaded_ = false;
+  lightSetup_ = lightSetup;
+  cameraMatrix_ = cameraMatrix;
+  projectionMatrix_ = projectionMatrix;
+  viewportSize_ = viewportSize;
+
+  // depth range of the view, unprojected so any projection works. Slices are
+  // exponential in depth, which needs the near depth to be positive.
+  const Mn::Matrix4 inverseProjection = projectionMatrix.inverted();
+  const float far = -inverseProjection.transformPoint({0.0f, 0.0f, 1.0f}).z();
+  const float near = Mn::Math::max(
+      -inverseProjection.transformPoint({0.0f, 0.0f, -1.0f}).z(), far * 1e-4f);
+  const float sliceScale = clusterCount_.z() / Mn::Math::log(far / near);
+  tileSize_ = Mn::Vector2{viewportSize} / Mn::Vector2{clusterCount_.xy()};
+  depthRow_ = -cameraMatrix.row(2);
+  sliceScaleBias_ = {sliceScale, -Mn::Math::log(near) * sliceScale};
+  const auto sliceDepth = [&](int slice) {
+    return near * Mn::Math::pow(far / near, float(slice) / clusterCount_.z());
+  };
+  const auto sliceAt = [&](float depth) {
+    return Mn::Math::clamp(
+        int(Mn::Math::floor(Mn::Math::log(Mn::Math::max(depth, near)) *
+                                sliceScaleBias_.x() +
+                            sliceScaleBias_.y())),
+        0, clusterCount_.z() - 1);
+  };
+
+  // view space lines through the tile corners, from the near to the far plane
+  const Mn::Vector2i cornerCount = clusterCount_.xy() + Mn::Vector2i{1};
+  std::vector<std::pair<Mn::Vector3, Mn::Vector3>> cornerLines;
+  cornerLines.reserve(cornerCount.product());
+  for (int y = 0; y != cornerCount.y(); ++y) {
+    for (int x = 0; x != cornerCount.x(); ++x) {
+      const Mn::Vector2 ndc = Mn::Vector2{Mn::Vector2i{x, y}} * 2.0f /
+                                  Mn::Vector2{clusterCount_.xy()} -
+                              Mn::Vector2{1.0f};
+      cornerLines.emplace_back(inverseProjection.transformPoint({ndc, -1.0f}),
+                               inverseProjection.transformPoint({ndc, 1.0f}));
+    }
+  }
+
+  // view space spheres of the point lights in front of the far plane, all
+  // other lights affect every cluster
+  struct Light {
+    Mn::UnsignedInt index;
+    Mn::Vector3 center;
+    float radius;
+    int firstSlice, lastSlice;
+  };
+  std::vector<Light> lights;
+  std::vector<Mn::UnsignedInt> unboundedLights;
+  ranges_.assign(lightSetup.size(), Mn::Constants::inf());
+  for (Mn::UnsignedInt i = 0; i != lightSetup.size(); ++i) {
+    const LightInfo& light = lightSetup[i];
+    if (light.vector.w() == 0.0f || light.model == LightPositionModel::Object) {
+      unboundedLights.push_back(i);
+      continue;
+    }
+    ranges_[i] = influenceRange(light.color);
+    const Mn::Vector3 center =
+        light.model == LightPositionModel::Camera
+            ? light.vector.xyz()
+            : cameraMatrix.transformPoint(light.vector.xyz());
+    if (-center.z() - ranges_[i] > far || -center.z() + ranges_[i] < near) {
+      continue;
+    }
+    lights.push_back({i, center, ranges_[i], sliceAt(-center.z() - ranges_[i]),
+                      sliceAt(-center.z() + ranges_[i])});
+  }
+
+  clusters_.resize(std::size_t(clusterCount_.product()));
+  lightIndices_.clear();
+  for (int z = 0; z != clusterCount_.z(); ++z) {
+    const float nearDepth = sliceDepth(z);
+    const float farDepth = sliceDepth(z + 1);
+    for (int y = 0; y != clusterCount_.y(); ++y) {
+      for (int x = 0; x != clusterCount_.x(); ++x) {
+        // view space bounds of the cluster, spanned by its four corner lines
+        // at the slice depths
+        Mn::Vector3 min{Mn::Constants::inf()};
+        Mn::Vector3 max{-Mn::Constants::inf()};
+        for (const Mn::Vector2i corner :
+             {Mn::Vector2i{x, y}, Mn::Vector2i{x + 1, y},
+              Mn::Vector2i{x, y + 1}, Mn::Vector2i{x + 1, y + 1}}) {
+          const std::pair<Mn::Vector3, Mn::Vector3>& line =
+              cornerLines[corner.y() * cornerCount.x() + corner.x()];
+          for (const float depth : {nearDepth, farDepth}) {
+            const float t = (depth + line.first.z()) /
+                            (line.first.z() - line.second.z());
+            const Mn::Vector3 point =
+                Mn::Math::lerp(line.first, line.second, t);
+            min = Mn::Math::min(min, point);
+            max = Mn::Math::max(max, point);
+          }
+        }
+
+        Mn::Vector2ui& cluster = clusters_[clusterIndex({x, y, z})];
+        cluster = {Mn::UnsignedInt(lightIndices_.size()), 0};
+        lightIndices_.insert(lightIndices_.end(), unboundedLights.begin(),
+                             unboundedLights.end());
+        for (const Light& light : lights) {
+          if (z < light.firstSlice || z > light.lastSlice) {
+            continue;
+          }
+          const Mn::Vector3 closest = Mn::Math::clamp(light.center, min, max);
+          if ((closest - light.center).dot() <= light.radius * light.radius) {
+            lightIndices_.push_back(light.index);
+          }
+        }
+        cluster.y() = Mn::UnsignedInt(lightIndices_.size()) - cluster.x();
+      }
+    }
+  }
+  return true;
+}  // LightClusters::update
+
+Mn::Vector3i LightClusters::clusterAt(const Mn::Vector2& fragmentCoordinates,
+                                      const Mn::Vector3& position) const {
+  const Mn::Vector2i tile = Mn::Math::clamp(
+      Mn::Vector2i{Mn::Math::floor(fragmentCoordinates / tileSize_)},
+      Mn::Vector2i{0}, clusterCount_.xy() - Mn::Vector2i{1});
+  const float depth =
+      Mn::Math::max(Mn::Math::dot(depthRow_, Mn::Vector4{position, 1.0f}),
+                    1.0e-6f);
+  const int slice = Mn::Math::clamp(
+      int(Mn::Math::floor(Mn::Math::log(depth) * sliceScaleBias_.x() +
+                          sliceScaleBias_.y())),
+      0, clusterCount_.z() - 1);
+  return Mn::Vector3i{tile, slice};
+}
+
+void LightClusters::upload() {
+  CORRADE_ASSERT(updated_, "LightClusters::upload(): not updated yet", );
+  if (uploaded_) {
+    return;
+  }
+  uploaded_ = true;
+
+  const Mn::Vector2i clusterTextureSize{
+      clusterCount_.x() * clusterCount_.y(), clusterCount_.z()};
+  if (!clusterTexture_) {
+    clusterTexture_.emplace();
+    (*clusterTexture_)
+        .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RG32UI, clusterTextureSize);
+  }
+  clusterTexture_->setSubImage(
+      0, {},
+      Mn::ImageView2D{Mn::PixelFormat::RG32UI, clusterTextureSize,
+                      Corrade::Containers::arrayView(clusters_)});
+
+  // padded to whole rows, textures with immutable storage are recreated once
+  // the indices outgrow them
+  const Mn::Int height = Mn::Math::max(
+      Mn::Int((lightIndices_.size() + LightIndexTextureWidth - 1) /
+              LightIndexTextureWidth),
+      1);
+  if (!lightIndexTexture_ || height > lightIndexTextureHeight_) {
+    lightIndexTextureHeight_ = height;
+    lightIndexTexture_.emplace();
+    (*lightIndexTexture_)
+        .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32UI,
+                    {Mn::Int(LightIndexTextureWidth), height});
+  }
+  std::vector<Mn::UnsignedInt> padded(
+      std::size_t(LightIndexTextureWidth) * height);
+  std::copy(lightIndices_.begin(), lightIndices_.end(), padded.begin());
+  lightIndexTexture_->setSubImage(
+      0, {},
+      Mn::ImageView2D{Mn::PixelFormat::R32UI,
+                      {Mn::Int(LightIndexTextureWidth), height},
+                      Corrade::Containers::arrayView(padded)});
+}  // LightClusters::upload
+
+}  // namespace gfx
+}  // namespace esp
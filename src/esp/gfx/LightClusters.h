@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_LIGHTCLUSTERS_H_
+#define ESP_GFX_LIGHTCLUSTERS_H_
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector3.h>
+#include <vector>
+
+#include "esp/core/Esp.h"
+#include "esp/gfx/LightSetup.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Assignment of the lights of a @ref LightSetup to the clusters of a
+ * camera view, for shading with only the lights that reach each fragment.
+ *
+ * The view is split into screen tiles and exponentially distributed depth
+ * slices between the near and far plane. Point lights affect a sphere whose
+ * radius is given by @ref influenceRange(), directional lights and lights
+ * positioned relative to the drawn object affect every cluster. For each
+ * cluster the indices of the lights affecting it are stored contiguously,
+ * with @ref clusters() holding the offset and count of each cluster's range
+ * in @ref lightIndices().
+ *
+ * The CPU side is updated by @ref update(), @ref upload() then mirrors the
+ * result into the textures @ref PbrShader::setLightClusters() binds.
+ */
+class LightClusters {
+ public:
+  /** @brief Width of @ref lightIndexTexture() */
+  static constexpr Magnum::UnsignedInt LightIndexTextureWidth = 1024;
+
+  /**
+   * @brief Light intensity under which a point light is considered to have
+   * no effect, about the smallest difference an 8-bit channel can show
+   */
+  static constexpr float DefaultInfluenceThreshold = 1.0f / 256.0f;
+
+  /**
+   * @brief Distance at which a point light of @p color falls under
+   * @p threshold with inverse square attenuation
+   */
+  static float influenceRange(const Magnum::Color3& color,
+                              float threshold = DefaultInfluenceThreshold);
+
+  /**
+   * @brief Constructor
+   * @param clusterCount  Number of tiles along the viewport width and height
+   *    and number of depth slices
+   */
+  explicit LightClusters(
+      const Magnum::Vector3i& clusterCount = {16, 9, 24});
+
+  /** @brief Number of tiles along the viewport and of depth slices */
+  const Magnum::Vector3i& clusterCount() const { return clusterCount_; }
+
+  /**
+   * @brief Assign the lights of @p lightSetup to the clusters of a view
+   * @param lightSetup        Lights
+   * @param cameraMatrix      World to camera transformation
+   * @param projectionMatrix  Camera projection
+   * @param viewportSize      Viewport size in pixels
+   * @return Whether anything changed since the last call
+   */
+  bool update(const LightSetup& lightSetup,
+              const Magnum::Matrix4& cameraMatrix,
+              const Magnum::Matrix4& projectionMatrix,
+              const Magnum::Vector2i& viewportSize);
+
+  /**
+   * @brief Offset into @ref lightIndices() and light count of each cluster
+   *
+   * Indexed by @ref clusterIndex().
+   */
+  const std::vector<Magnum::Vector2ui>& clusters() const { return clusters_; }
+
+  /** @brief Light indices of all clusters */
+  const std::vector<Magnum::UnsignedInt>& lightIndices() const {
+    return lightIndices_;
+  }
+
+  /**
+   * @brief Range of each light, infinite for lights affecting every cluster
+   *
+   * Lights have no effect past their range, which the shader has to be told
+   * for the clusters to be correct.
+   */
+  const std::vector<float>& ranges() const { return ranges_; }
+
+  /** @brief Index of a tile and depth slice in @ref clusters() */
+  std::size_t clusterIndex(const Magnum::Vector3i& cluster) const {
+    return (std::size_t(cluster.z()) * clusterCount_.y() + cluster.y()) *
+               clusterCount_.x() +
+           cluster.x();
+  }
+
+  /**
+   * @brief Cluster a point is in
+   * @param fragmentCoordinates  Window coordinates of the point, in pixels
+   * @param position             World position of the point
+   *
+   * Same as the lookup done by the shader.
+   */
+  Magnum::Vector3i clusterAt(const Magnum::Vector2& fragmentCoordinates,
+                             const Magnum::Vector3& position) const;
+
+  /** @brief Size of a tile in pixels */
+  const Magnum::Vector2& tileSize() const { return tileSize_; }
+
+  /**
+   * @brief Row giving the depth of a world position along the view
+   * direction when multiplied with the position
+   */
+  const Magnum::Vector4& depthRow() const { return depthRow_; }
+
+  /**
+   * @brief Scale and bias to get the depth slice from the logarithm of the
+   * depth
+   */
+  const Magnum::Vector2& sliceScaleBias() const { return sliceScaleBias_; }
+
+  /**
+   * @brief Upload @ref clusters() and @ref lightIndices() to their textures
+   *
+   * Requires a GL context.
+   */
+  void upload();
+
+  /**
+   * @brief RG32UI texture with a row of @ref clusters() per depth slice
+   *
+   * Available after @ref upload().
+   */
+  Magnum::GL::Texture2D& clusterTexture() { return *clusterTexture_; }
+
+  /**
+   * @brief R32UI texture with @ref lightIndices(), in rows of
+   * @ref LightIndexTextureWidth
+   *
+   * Available after @ref upload().
+   */
+  Magnum::GL::Texture2D& lightIndexTexture() { return *lightIndexTexture_; }
+
+ private:
+  Magnum::Vector3i clusterCount_;
+
+  // inputs of the last update, to skip updates that wouldn't change anything
+  LightSetup lightSetup_;
+  Magnum::Matrix4 cameraMatrix_;
+  Magnum::Matrix4 projectionMatrix_;
+  Magnum::Vector2i viewportSize_;
+  bool updated_ = false;
+
+  Magnum::Vector2 tileSize_;
+  Magnum::Vector4 depthRow_;
+  Magnum::Vector2 sliceScaleBias_;
+
+  std::vector<Magnum::Vector2ui> clusters_;
+  std::vector<Magnum::UnsignedInt> lightIndices_;
+  std::vector<float> ranges_;
+
+  bool uploaded_ = false;
+  Corrade::Containers::Optional<Magnum::GL::Texture2D> clusterTexture_;
+  Corrade::Containers::Optional<Magnum::GL::Texture2D> lightIndexTexture_;
+  Magnum::Int lightIndexTextureHeight_ = 0;
+
+  ESP_SMART_POINTERS(LightClusters)
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_LIGHTCLUSTERS_H_
@@ -28,6 +28,13 @@ class MeshVisualizerDrawable : public Drawable {
                                   Magnum::GL::Mesh& mesh,
                                   DrawableConfiguration& cfg);
 
+  /**
+   * @brief Shader and mesh this drawable draws with
+   */
+  DrawState getDrawState() override {
+    return {&shader_, materialId_, &getMesh()};
+  }
+
  protected:
   /**
    * @brief Draw the object using given camera
@@ -28,8 +28,12 @@ PbrDrawable::PbrDrawable(scene::SceneNode& node,
       pbrIbl_(std::move(cfg.getPbrIblData())),
       meshAttributeFlags_{meshAttributeFlags} {
   // Build material cache
-  resetMaterialValues(
-      shaderManager.get<Mn::Trade::MaterialData>(cfg.materialDataKey_));
+  auto material =
+      shaderManager.get<Mn::Trade::MaterialData>(cfg.materialDataKey_);
+  resetMaterialValues(material);
+  // Drawables built from the same material share its id until their values
+  // are changed, so they can be drawn without re-uploading material uniforms
+  shareMaterialId(cfg.materialDataKey_, &*material);
   // Set shader config flags
   setShaderAttributesValues(cfg.getPbrShaderConfig());
   // update the shader early here to to avoid doing it during the render loop
@@ -342,6 +346,8 @@ void PbrDrawable::setMaterialValuesInternal(
     flags_ = oldFlags;
   }
 
+  // the values may now differ from any other drawable's
+  assignUniqueMaterialId();
 }  // PbrDrawable::setMaterialValuesInternal
 
 void PbrDrawable::setShaderAttributesValues(
@@ -415,6 +421,8 @@ void PbrDrawable::setShaderAttributesValues(
     // Intensity of direct lighting
     shaderConfig_.directLightingIntensity =
         pbrShaderConfig->getDirectLightIntensity();
+    shaderConfig_.clusteredLightingMinLightCount =
+        pbrShaderConfig->getClusteredLightingMinLightCount();
     if (flags_ >= PbrShader::Flag::ImageBasedLighting) {
       // Scales contributions but only if both direct and IBL are being
       // processed.
@@ -439,6 +447,13 @@ void PbrDrawable::setShaderAttributesValues(
   }
 }  // PbrDrawable::setShaderAttributesValues
 
+Drawable::DrawState PbrDrawable::getDrawState() {
+  if (!glMeshExists()) {
+    return Drawable::getDrawState();
+  }
+  return {&getShader(), materialId_, &getMesh()};
+}
+
 void PbrDrawable::setLightSetup(const Mn::ResourceKey& lightSetupKey) {
   lightSetup_ = shaderManager_.get<LightSetup>(lightSetupKey);
   // update the shader early here to to avoid doing it during the render loop
@@ -461,6 +476,11 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
                                        lightInfo, transformationMatrix,
                                        cameraMatrix);
                                  });
+  if (flags_ >= PbrShader::Flag::ClusteredLighting) {
+    LightClusters& clusters =
+        static_cast<RenderCamera&>(camera).getLightClusters(*lightSetup_);
+    shader_->setLightRanges(clusters.ranges()).setLightClusters(clusters);
+  }
 
   // ABOUT PbrShader::Flag::DoubleSided:
   //
@@ -509,79 +529,16 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
       .setModelMatrix(modelMatrix)  // NOT modelview matrix!
       .setNormalMatrix(normalMatrix)
       .setCameraWorldPosition(
-          camera.object().absoluteTransformationMatrix().translation())
-      .setBaseColor(matCache.baseColor)
-      .setRoughness(matCache.roughness)
-      .setMetallic(matCache.metalness)
-      .setIndexOfRefraction(matCache.ior_Index)
-      .setEmissiveColor(matCache.emissiveColor);
-
-  if (flags_ >= PbrShader::Flag::BaseColorTexture) {
-    shader_->bindBaseColorTexture(*matCache.baseColorTexture);
-  }
-
-  if (flags_ >= PbrShader::Flag::NoneRoughnessMetallicTexture) {
-    shader_->bindMetallicRoughnessTexture(
-        *matCache.noneRoughnessMetallicTexture);
-  }
-
-  if (flags_ >= PbrShader::Flag::NormalTexture) {
-    shader_->bindNormalTexture(*matCache.normalTexture);
-    shader_->setNormalTextureScale(matCache.normalTextureScale);
-  }
-
-  if (flags_ >= PbrShader::Flag::EmissiveTexture) {
-    shader_->bindEmissiveTexture(*matCache.emissiveTexture);
-  }
-
-  if (flags_ >= PbrShader::Flag::TextureTransformation) {
-    shader_->setTextureMatrix(matCache.textureMatrix);
-  }
+          camera.object().absoluteTransformationMatrix().translation());
 
-  // clearcoat data
-  if (flags_ >= PbrShader::Flag::ClearCoatLayer) {
-    (*shader_)
-        .setClearCoatFactor(matCache.clearCoat.factor)
-        .setClearCoatRoughness(matCache.clearCoat.roughnessFactor);
-    if (flags_ >= PbrShader::Flag::ClearCoatTexture) {
-      shader_->bindClearCoatFactorTexture(*matCache.clearCoat.texture);
-    }
-    if (flags_ >= PbrShader::Flag::ClearCoatRoughnessTexture) {
-      shader_->bindClearCoatRoughnessTexture(
-          *matCache.clearCoat.roughnessTexture);
-    }
-    if (flags_ >= PbrShader::Flag::ClearCoatNormalTexture) {
-      (*shader_)
-          .setClearCoatNormalTextureScale(matCache.clearCoat.normalTextureScale)
-          .bindClearCoatNormalTexture(*matCache.clearCoat.normalTexture);
-    }
-  }
-
-  // specular layer data
-  if (flags_ >= PbrShader::Flag::SpecularLayer) {
-    (*shader_)
-        .setSpecularLayerFactor(matCache.specularLayer.factor)
-        .setSpecularLayerColorFactor(matCache.specularLayer.colorFactor);
-
-    if (flags_ >= PbrShader::Flag::SpecularLayerTexture) {
-      shader_->bindSpecularLayerTexture(*matCache.specularLayer.texture);
-    }
-    if (flags_ >= PbrShader::Flag::SpecularLayerColorTexture) {
-      shader_->bindSpecularLayerColorTexture(
-          *matCache.specularLayer.colorTexture);
-    }
-  }
-
-  // anisotropy layer data
-  if (flags_ >= PbrShader::Flag::AnisotropyLayer) {
-    (*shader_)
-        .setAnisotropyLayerFactor(matCache.anisotropyLayer.factor)
-        .setAnisotropyLayerDirection(matCache.anisotropyLayer.direction);
-
-    if (flags_ >= PbrShader::Flag::AnisotropyLayerTexture) {
-      shader_->bindAnisotropyLayerTexture(*matCache.anisotropyLayer.texture);
-    }
+  // uniforms are per-program state, so they only need uploading if another
+  // material was drawn with this shader since. Texture bindings are shared by
+  // all programs and are always made.
+  if (shader_->materialId() != materialId_) {
+    setMaterialUniforms();
+    shader_->setMaterialId(materialId_);
   }
+  bindMaterialTextures();
 
   // Set gamma value to use for srgb remapping if being used
   // Setter does appropriate checking
@@ -613,8 +570,8 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
   }
 
   if (skinData_) {
-    buildSkinJointTransforms();
-    shader_->setJointMatrices(jointTransformations_);
+    shader_->setJointMatrices(buildSkinJointTransforms(
+        static_cast<RenderCamera&>(camera).drawPass()));
   }
 
   shader_->draw(getMesh());
@@ -631,6 +588,90 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
 
 }  // PbrDrawable::draw
 
+void PbrDrawable::setMaterialUniforms() {
+  (*shader_)
+      .setBaseColor(matCache.baseColor)
+      .setRoughness(matCache.roughness)
+      .setMetallic(matCache.metalness)
+      .setIndexOfRefraction(matCache.ior_Index)
+      .setEmissiveColor(matCache.emissiveColor);
+
+  if (flags_ >= PbrShader::Flag::NormalTexture) {
+    shader_->setNormalTextureScale(matCache.normalTextureScale);
+  }
+
+  if (flags_ >= PbrShader::Flag::TextureTransformation) {
+    shader_->setTextureMatrix(matCache.textureMatrix);
+  }
+
+  // clearcoat data
+  if (flags_ >= PbrShader::Flag::ClearCoatLayer) {
+    (*shader_)
+        .setClearCoatFactor(matCache.clearCoat.factor)
+        .setClearCoatRoughness(matCache.clearCoat.roughnessFactor);
+    if (flags_ >= PbrShader::Flag::ClearCoatNormalTexture) {
+      shader_->setClearCoatNormalTextureScale(
+          matCache.clearCoat.normalTextureScale);
+    }
+  }
+
+  // specular layer data
+  if (flags_ >= PbrShader::Flag::SpecularLayer) {
+    (*shader_)
+        .setSpecularLayerFactor(matCache.specularLayer.factor)
+        .setSpecularLayerColorFactor(matCache.specularLayer.colorFactor);
+  }
+
+  // anisotropy layer data
+  if (flags_ >= PbrShader::Flag::AnisotropyLayer) {
+    (*shader_)
+        .setAnisotropyLayerFactor(matCache.anisotropyLayer.factor)
+        .setAnisotropyLayerDirection(matCache.anisotropyLayer.direction);
+  }
+}  // PbrDrawable::setMaterialUniforms
+
+void PbrDrawable::bindMaterialTextures() {
+  if (flags_ >= PbrShader::Flag::BaseColorTexture) {
+    shader_->bindBaseColorTexture(*matCache.baseColorTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::NoneRoughnessMetallicTexture) {
+    shader_->bindMetallicRoughnessTexture(
+        *matCache.noneRoughnessMetallicTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::NormalTexture) {
+    shader_->bindNormalTexture(*matCache.normalTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::EmissiveTexture) {
+    shader_->bindEmissiveTexture(*matCache.emissiveTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::ClearCoatTexture) {
+    shader_->bindClearCoatFactorTexture(*matCache.clearCoat.texture);
+  }
+  if (flags_ >= PbrShader::Flag::ClearCoatRoughnessTexture) {
+    shader_->bindClearCoatRoughnessTexture(
+        *matCache.clearCoat.roughnessTexture);
+  }
+  if (flags_ >= PbrShader::Flag::ClearCoatNormalTexture) {
+    shader_->bindClearCoatNormalTexture(*matCache.clearCoat.normalTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::SpecularLayerTexture) {
+    shader_->bindSpecularLayerTexture(*matCache.specularLayer.texture);
+  }
+  if (flags_ >= PbrShader::Flag::SpecularLayerColorTexture) {
+    shader_->bindSpecularLayerColorTexture(
+        *matCache.specularLayer.colorTexture);
+  }
+
+  if (flags_ >= PbrShader::Flag::AnisotropyLayerTexture) {
+    shader_->bindAnisotropyLayerTexture(*matCache.anisotropyLayer.texture);
+  }
+}  // PbrDrawable::bindMaterialTextures
+
 void PbrDrawable::updateShader() {
   const Mn::UnsignedInt lightCount = lightSetup_->size();
   Mn::UnsignedInt jointCount = 0;
@@ -639,9 +680,16 @@ void PbrDrawable::updateShader() {
   if (flags_ >= PbrShader::Flag::SkinnedMesh) {
     jointCount = skinData_->skinData->skin->joints().size();
     perVertexJointCount = skinData_->skinData->perVertexJointCount;
-    resizeJointTransformArray(jointCount);
   }
 
+  // with many lights, fragments are only shaded with the lights reaching
+  // their cluster of the view
+  (flags_ >= PbrShader::Flag::DirectLighting &&
+   shaderConfig_.clusteredLightingMinLightCount > 0 &&
+   lightCount >= Mn::UnsignedInt(shaderConfig_.clusteredLightingMinLightCount))
+      ? flags_ |= PbrShader::Flag::ClusteredLighting
+      : flags_ &= ~PbrShader::Flag::ClusteredLighting;
+
   if (!shader_ || shader_->lightCount() != lightCount ||
       shader_->flags() != flags_) {
     // if the number of lights or flags have changed, we need to fetch a
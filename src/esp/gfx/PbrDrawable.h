@@ -228,6 +228,11 @@ class PbrDrawable : public Drawable {
      * Control the direct lighting intensity.
      */
     float directLightingIntensity = 1.0f;
+    /**
+     * Number of direct lights from which on clustered lighting is used, 0 to
+     * never use it.
+     */
+    int clusteredLightingMinLightCount = 0;
     /**
      * Controls the exposure level for the tonemapping function. Only used if
      * tonemapping is enabled.
@@ -277,6 +282,28 @@ class PbrDrawable : public Drawable {
       const std::shared_ptr<metadata::attributes::PbrShaderAttributes>&
           _pbrShaderConfig);
 
+  /**
+   * @brief The shader this drawable draws with, updated for the current
+   * material and light setup
+   */
+  const PbrShader& getShader() {
+    updateShader();
+    return *shader_;
+  }
+
+  /**
+   * @brief Shader, material and mesh this drawable draws with
+   */
+  DrawState getDrawState() override;
+
+  /**
+   * @brief Whether the material is double-sided, drawn with face culling
+   * disabled
+   */
+  bool isDoubleSided() const {
+    return flags_ >= PbrShader::Flag::DoubleSided;
+  }
+
  private:
   /**
    * @brief Internal implementation of material setting, so that it can be
@@ -304,6 +331,16 @@ class PbrDrawable : public Drawable {
    */
   void updateShader();
 
+  /**
+   * @brief Upload the material uniforms of @ref matCache to the shader
+   */
+  void setMaterialUniforms();
+
+  /**
+   * @brief Bind the material textures of @ref matCache
+   */
+  void bindMaterialTextures();
+
   // shader parameters
   PbrShader::Flags flags_;
   ShaderManager& shaderManager_;
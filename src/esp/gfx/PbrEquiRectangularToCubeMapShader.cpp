@@ -15,6 +15,8 @@
 #include <Magnum/GL/Version.h>
 #include <sstream>
 
+#include "esp/gfx_batch/ShaderCache.h"
+
 // This is to import the "resources" at runtime. When the resource is
 // compiled into static library, it must be explicitly initialized via this
 // macro, and should be called *outside* of any namespace.
@@ -59,11 +61,14 @@ PbrEquiRectangularToCubeMapShader::PbrEquiRectangularToCubeMapShader() {
           "#define OUTPUT_ATTRIBUTE_LOCATION_COLOR {}\n", ColorOutput))
       .addSource(rs.getString("equirectangularToCubeMap.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // setup texture binding point
   setUniform(uniformLocation("uEquirectangularTexture"),
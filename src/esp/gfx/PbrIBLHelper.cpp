@@ -3,6 +3,14 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PbrIBLHelper.h"
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/GL/CubeMapTexture.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
@@ -14,11 +22,15 @@
 #include <Magnum/MeshTools/Copy.h>
 #include <Magnum/MeshTools/FlipNormals.h>
 #include <Magnum/Primitives/Cube.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData.h>
+#include <unistd.h>
+#include <atomic>
 
 #include "CubeMapCamera.h"
+#include "esp/core/Logging.h"
 
 namespace Mn = Magnum;
 namespace Cr = Corrade;
@@ -41,17 +53,177 @@ Mn::Matrix4 buildDfltPerspectiveMatrix() {
       1000.0f);   // z-far plane
 }  // buildDfltPerspectiveMatrix()
 
+// bump when the way the maps are computed changes, so stale caches are ignored
+constexpr unsigned int cacheVersion = 1;
+
+Mn::GL::CubeMapCoordinate cubeMapFace(unsigned int iSide) {
+  return Mn::GL::CubeMapCoordinate(
+      Mn::UnsignedInt(Mn::GL::CubeMapCoordinate::PositiveX) + iSide);
+}
+
+/**
+ * @brief load a cube map saved by @ref saveCubeMap(), if it has the size and
+ * mip levels of a cube map created with @p size and @p flags
+ */
+Cr::Containers::Optional<CubeMap> loadCubeMap(const std::string& filename,
+                                              int size,
+                                              CubeMap::Flags flags) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return Cr::Containers::NullOpt;
+  }
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      manager.loadAndInstantiate("KtxImporter");
+  if (!importer || !importer->openFile(filename)) {
+    return Cr::Containers::NullOpt;
+  }
+
+  CubeMap cubeMap{size, flags};
+  const unsigned int mipLevels = cubeMap.getMipmapLevels();
+  if (importer->image3DCount() != 1 ||
+      importer->image3DLevelCount(0) != mipLevels) {
+    return Cr::Containers::NullOpt;
+  }
+  auto& texture = cubeMap.getTexture(CubeMap::TextureType::Color);
+  for (unsigned int iMip = 0; iMip < mipLevels; ++iMip) {
+    Cr::Containers::Optional<Mn::Trade::ImageData3D> image =
+        importer->image3D(0, iMip);
+    const Mn::Vector3i levelSize{Mn::Vector2i{Mn::Math::max(size >> iMip, 1)},
+                                 6};
+    if (!image || image->isCompressed() ||
+        image->format() != Mn::PixelFormat::RGBA8Unorm ||
+        !(image->flags() & Mn::ImageFlag3D::CubeMap) ||
+        image->size() != levelSize) {
+      return Cr::Containers::NullOpt;
+    }
+    // the faces are consecutive slices of the image, in the order of
+    // CubeMapCoordinate
+    const std::size_t faceSize = image->data().size() / 6;
+    for (unsigned int iSide = 0; iSide < 6; ++iSide) {
+      texture.setSubImage(
+          cubeMapFace(iSide), iMip, {},
+          Mn::ImageView2D{image->storage(), image->format(),
+                          image->size().xy(),
+                          image->data().slice(iSide * faceSize,
+                                              (iSide + 1) * faceSize)});
+    }
+  }
+  return cubeMap;
+}  // loadCubeMap
+
+#ifndef MAGNUM_TARGET_WEBGL
+/**
+ * @brief save all mip levels of the color texture of @p cubeMap into a single
+ * KTX2 file
+ */
+bool saveCubeMap(CubeMap& cubeMap, const std::string& filename) {
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter =
+      manager.loadAndInstantiate("KtxImageConverter");
+  if (!converter) {
+    return false;
+  }
+
+  auto& texture = cubeMap.getTexture(CubeMap::TextureType::Color);
+  const unsigned int mipLevels = cubeMap.getMipmapLevels();
+  std::vector<Cr::Containers::Array<char>> levelData;
+  std::vector<Mn::ImageView3D> levels;
+  levelData.reserve(mipLevels);
+  levels.reserve(mipLevels);
+  for (unsigned int iMip = 0; iMip < mipLevels; ++iMip) {
+    const Mn::Vector2i faceSize{
+        Mn::Math::max(cubeMap.getCubeMapSize() >> iMip, 1)};
+    const std::size_t faceDataSize = faceSize.product() * 4;
+    Cr::Containers::Array<char> data{Cr::NoInit, faceDataSize * 6};
+    for (unsigned int iSide = 0; iSide < 6; ++iSide) {
+      Mn::Image2D image = texture.image(cubeMapFace(iSide), iMip,
+                                        {Mn::PixelFormat::RGBA8Unorm});
+      Cr::Utility::copy(image.data(),
+                        data.slice(iSide * faceDataSize,
+                                   (iSide + 1) * faceDataSize));
+    }
+    levels.emplace_back(Mn::PixelFormat::RGBA8Unorm,
+                        Mn::Vector3i{faceSize, 6}, data,
+                        Mn::ImageFlag3D::CubeMap);
+    levelData.push_back(std::move(data));
+  }
+
+  // other processes may be reading or writing the same cache entry, so only
+  // move the file in place once it's complete. Named after the process and a
+  // per-process counter, as addresses repeat across processes.
+  static std::atomic<std::size_t> tmpFileCounter{0};
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.{}.tmp", filename, ::getpid(), tmpFileCounter++);
+  if (!converter->convertToFile(levels, tmpFilename)) {
+    return false;
+  }
+  return Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveCubeMap
+#endif
+
 }  // namespace
 
 PbrIBLHelper::PbrIBLHelper(
     ShaderManager& shaderManager,
     const std::shared_ptr<Mn::GL::Texture2D>& brdfLUT,
-    const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture)
+    const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture,
+    const std::string& cacheFilePrefix)
     : shaderManager_(shaderManager), brdfLUT_(brdfLUT) {
+  if (!cacheFilePrefix.empty() && loadCachedMaps(cacheFilePrefix)) {
+    return;
+  }
   // convert the loaded texture into a cubemap
   convertEquirectangularToCubeMap(envMapTexture);
+  if (!cacheFilePrefix.empty()) {
+    saveCachedMaps(cacheFilePrefix);
+  }
 }
 
+std::string PbrIBLHelper::getCacheFilePrefix(
+    const std::string& cacheDir,
+    Cr::Containers::ArrayView<const char> envMapData) {
+  const std::string key = Cr::Utility::formatString(
+      "{}-env={}-prefiltered={}-irradiance={}-version={}",
+      Cr::Utility::MurmurHash2{}(envMapData.data(), envMapData.size())
+          .hexString(),
+      environmentMapSize, prefilteredMapSize, irradianceMapSize, cacheVersion);
+  return Cr::Utility::Path::join(
+      cacheDir, "ibl_" + Cr::Utility::MurmurHash2{}(key).hexString());
+}
+
+bool PbrIBLHelper::loadCachedMaps(const std::string& cacheFilePrefix) {
+  Cr::Containers::Optional<CubeMap> irradianceMap =
+      loadCubeMap(cacheFilePrefix + ".irradiance.ktx2", irradianceMapSize,
+                  CubeMap::Flag::ColorTexture);
+  if (!irradianceMap) {
+    return false;
+  }
+  Cr::Containers::Optional<CubeMap> prefilteredMap = loadCubeMap(
+      cacheFilePrefix + ".prefiltered.ktx2", prefilteredMapSize,
+      CubeMap::Flag::ColorTexture | CubeMap::Flag::ManuallyBuildMipmap);
+  if (!prefilteredMap) {
+    return false;
+  }
+  ESP_DEBUG() << "Loaded precomputed IBL maps from" << cacheFilePrefix;
+  irradianceMap_ = std::move(irradianceMap);
+  prefilteredMap_ = std::move(prefilteredMap);
+  return true;
+}  // loadCachedMaps
+
+void PbrIBLHelper::saveCachedMaps(const std::string& cacheFilePrefix) {
+#ifndef MAGNUM_TARGET_WEBGL
+  if (!Cr::Utility::Path::make(
+          Cr::Utility::Path::split(cacheFilePrefix).first()) ||
+      !saveCubeMap(*irradianceMap_, cacheFilePrefix + ".irradiance.ktx2") ||
+      !saveCubeMap(*prefilteredMap_, cacheFilePrefix + ".prefiltered.ktx2")) {
+    ESP_WARNING() << "Unable to save precomputed IBL maps to"
+                  << cacheFilePrefix << ", they'll be computed again";
+  }
+#else
+  static_cast<void>(cacheFilePrefix);
+#endif
+}  // saveCachedMaps
+
 void PbrIBLHelper::convertEquirectangularToCubeMap(
     const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture) {
   // prepare a mesh to be displayed
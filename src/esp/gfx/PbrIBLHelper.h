@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_PBR_IBL_H_
 #define ESP_GFX_PBR_IBL_H_
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Texture.h>
 
@@ -31,11 +32,29 @@ class PbrIBLHelper {
    * @param[in] brdfLUT the brdf lookup table texture being used.
    * @param[in] envMapTexture the texture to use to build the environment cube
    * maps.
+   * @param[in] cacheFilePrefix if not empty, the irradiance and pre-filtered
+   * maps are loaded from `{cacheFilePrefix}.irradiance.ktx2` and
+   * `{cacheFilePrefix}.prefiltered.ktx2` instead of being computed. If they
+   * can't be loaded, they're computed and saved there. See
+   * @ref getCacheFilePrefix().
    */
   explicit PbrIBLHelper(
       ShaderManager& shaderManager,
       const std::shared_ptr<Mn::GL::Texture2D>& brdfLUT,
-      const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture);
+      const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture,
+      const std::string& cacheFilePrefix = "");
+
+  /**
+   * @brief Cache file prefix for the maps computed from an environment map
+   * @param[in] cacheDir directory holding the cache
+   * @param[in] envMapData contents of the environment map image file
+   *
+   * The prefix is a hash of @p envMapData and the map sizes, so an edited
+   * image or other settings don't pick up stale maps.
+   */
+  static std::string getCacheFilePrefix(
+      const std::string& cacheDir,
+      Corrade::Containers::ArrayView<const char> envMapData);
 
   /**
    * @brief get the irradiance cube map
@@ -62,6 +81,18 @@ class PbrIBLHelper {
   void convertEquirectangularToCubeMap(
       const std::shared_ptr<Mn::GL::Texture2D>& envMapTexture);
 
+  /**
+   * @brief load the irradiance and pre-filtered maps saved by
+   * @ref saveCachedMaps()
+   * @return true if both were loaded and match the expected sizes
+   */
+  bool loadCachedMaps(const std::string& cacheFilePrefix);
+
+  /**
+   * @brief save the irradiance and pre-filtered maps to the cache
+   */
+  void saveCachedMaps(const std::string& cacheFilePrefix);
+
   /**
    * @brief 2D BRDF lookup table, an HDR image (16-bits per channel) that
    * contains BRDF values for roughness and view angle. This is for the indirect
@@ -21,6 +21,8 @@
 #include <initializer_list>
 #include <sstream>
 
+#include "esp/gfx_batch/ShaderCache.h"
+
 // This is to import the "resources" at runtime. When the resource is
 // compiled into static library, it must be explicitly initialized via this
 // macro, and should be called *outside* of any namespace.
@@ -75,11 +77,14 @@ PbrPrecomputedMapShader::PbrPrecomputedMapShader(Flags flags) : flags_(flags) {
     frag.addSource(rs.getString("pbrPrefilteredMap.frag"));
   }
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // set texture unit
   setUniform(uniformLocation("EnvironmentMap"),
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PbrShader.h"
+#include "LightClusters.h"
 #include "PbrTextureUnit.h"
 
 #include <Corrade/Containers/Array.h>
@@ -27,6 +28,8 @@
 
 #include <sstream>
 
+#include "esp/gfx_batch/ShaderCache.h"
+
 // This is to import the "resources" at runtime. When the resource is
 // compiled into static library, it must be explicitly initialized via this
 // macro, and should be called *outside* of any namespace.
@@ -227,6 +230,12 @@ PbrShader::PbrShader(const Configuration& config)
                      : "")
       // Lights exist and direct lighting is enabled
       .addSource(directLightingIsEnabled_ ? "#define DIRECT_LIGHTING\n" : "")
+      .addSource(directLightingIsEnabled_ && flags_ >= Flag::ClusteredLighting
+                     ? Cr::Utility::formatString(
+                           "#define CLUSTERED_LIGHTING\n"
+                           "#define LIGHT_INDEX_TEXTURE_WIDTH {}u\n",
+                           LightClusters::LightIndexTextureWidth)
+                     : "")
       // Whether to skip the TBN calc if no precomputed tangents are provided.
       // NOTE : This will disable normal textures if no precomp tangents,
       // which will result in a severe degredation in quality.
@@ -277,11 +286,14 @@ PbrShader::PbrShader(const Configuration& config)
       .addSource(rs.getString("pbrMaterials.glsl"))
       .addSource(rs.getString("pbr.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // set texture binding points in the shader;
   // see PBR vertex, fragment shader code for details
@@ -398,6 +410,17 @@ PbrShader::PbrShader(const Configuration& config)
     lightDirectionsUniform_ = uniformLocation("uLightDirections");
     // global light intensity across all direct lights
     directLightingIntensityUniform_ = uniformLocation("uDirectLightIntensity");
+    if (flags_ >= Flag::ClusteredLighting) {
+      setUniform(uniformLocation("uLightClusters"),
+                 pbrTextureUnitSpace::TextureUnit::LightClusters);
+      setUniform(uniformLocation("uLightIndices"),
+                 pbrTextureUnitSpace::TextureUnit::LightIndices);
+      lightClusterTileSizeUniform_ = uniformLocation("uLightClusterTileSize");
+      lightClusterCountUniform_ = uniformLocation("uLightClusterCount");
+      lightClusterDepthRowUniform_ = uniformLocation("uLightClusterDepthRow");
+      lightClusterSliceScaleBiasUniform_ =
+          uniformLocation("uLightClusterSliceScaleBias");
+    }
   }
 
   cameraWorldPosUniform_ = uniformLocation("uCameraWorldPos");
@@ -967,6 +990,22 @@ PbrShader& PbrShader::setDirectLightIntensity(float lightIntensity) {
   return *this;
 }
 
+PbrShader& PbrShader::setLightClusters(LightClusters& clusters) {
+  CORRADE_ASSERT(directLightingIsEnabled_ && flags_ >= Flag::ClusteredLighting,
+                 "PbrShader::setLightClusters(): the shader was not created "
+                 "with clustered direct lighting enabled",
+                 *this);
+  clusters.clusterTexture().bind(
+      pbrTextureUnitSpace::TextureUnit::LightClusters);
+  clusters.lightIndexTexture().bind(
+      pbrTextureUnitSpace::TextureUnit::LightIndices);
+  setUniform(lightClusterTileSizeUniform_, clusters.tileSize());
+  setUniform(lightClusterCountUniform_, clusters.clusterCount());
+  setUniform(lightClusterDepthRowUniform_, clusters.depthRow());
+  setUniform(lightClusterSliceScaleBiasUniform_, clusters.sliceScaleBias());
+  return *this;
+}
+
 PbrShader& PbrShader::setGamma(const Mn::Vector3& gamma) {
   // if any input values are mapped to linear, should set gamma uniform value
   if (mapInputToLinear_) {
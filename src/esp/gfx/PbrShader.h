@@ -18,6 +18,8 @@
 namespace esp {
 namespace gfx {
 
+class LightClusters;
+
 class PbrShader : public Magnum::GL::AbstractShaderProgram {
  public:
   // Configuration (See Magnum::Shaders::PhongGL::Configuration )
@@ -357,6 +359,13 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
      * PbrDebugDisplay in the fragment shader for debugging
      */
     DebugDisplay = 1ULL << 37,
+
+    /**
+     * Shade each fragment only with the lights reaching its cluster of the
+     * view instead of with all lights, see @ref LightClusters and
+     * @ref setLightClusters(). Requires @ref Flag::DirectLighting.
+     */
+    ClusteredLighting = 1ULL << 38,
     /*
      * TODO: alphaMask
      */
@@ -409,6 +418,23 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
   /** @brief Flags */
   Flags flags() const { return flags_; }
 
+  /**
+   * @brief Id of the material whose values were last uploaded to this shader,
+   * 0 if none
+   */
+  uint64_t materialId() const { return materialId_; }
+
+  /**
+   * @brief Record the id of the material whose values were just uploaded
+   * @return Reference to self (for method chaining)
+   *
+   * Only tracked for the caller, see @ref Drawable::getMaterialId().
+   */
+  PbrShader& setMaterialId(uint64_t id) {
+    materialId_ = id;
+    return *this;
+  }
+
   // ======== texture binding ========
   /**
    * @brief Bind the BaseColor texture
@@ -728,6 +754,16 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   PbrShader& setDirectLightIntensity(float lightIntensity);
 
+  /**
+   * @brief Bind the light clusters of the current view and set their
+   * parameters
+   * NOTE: requires Flag::ClusteredLighting is set. The light ranges have to
+   * be set to @ref LightClusters::ranges() and the clusters already
+   * uploaded.
+   * @return Reference to self (for method chaining)
+   */
+  PbrShader& setLightClusters(LightClusters& clusters);
+
   /**
    * @brief Set the gamma value used for remapping sRGB to linear approximations
    *  @return Reference to self (for method chaining)
@@ -883,6 +919,12 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
   // Global, config-driven knob to control direct lighting intensity
   int directLightingIntensityUniform_ = ID_UNDEFINED;
 
+  // Clustered lighting, see LightClusters
+  int lightClusterTileSizeUniform_ = ID_UNDEFINED;
+  int lightClusterCountUniform_ = ID_UNDEFINED;
+  int lightClusterDepthRowUniform_ = ID_UNDEFINED;
+  int lightClusterSliceScaleBiasUniform_ = ID_UNDEFINED;
+
   // Global, config-driven knob to control IBL exposure
   int tonemapExposureUniform_ = ID_UNDEFINED;
 
@@ -915,6 +957,9 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
 
   // pbr debug info
   int pbrDebugDisplayUniform_ = ID_UNDEFINED;
+
+  // id of the material whose uniforms were last set, see materialId()
+  uint64_t materialId_ = 0;
 };
 
 /**
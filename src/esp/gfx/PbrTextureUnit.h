@@ -30,6 +30,8 @@ enum TextureUnit : uint8_t {
   IrradianceMap = 11,
   BrdfLUT = 12,
   PrefilteredMap = 13,
+  LightClusters = 14,
+  LightIndices = 15,
 
 };
 }  // namespace pbrTextureUnitSpace
@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "RedwoodNoiseShader.h"
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "esp/gfx_batch/ShaderCache.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+enum {
+  DepthTextureUnit = 1,
+  DistortionModelTextureUnit = 2,
+};
+
+RedwoodNoiseShader::RedwoodNoiseShader() {
+  if (!Corrade::Utility::Resource::hasGroup("gfx-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  vert.addSource(rs.getString("bigTriangle.vert"));
+
+  frag.addSource(Cr::Utility::formatString(
+                     "#define OUTPUT_ATTRIBUTE_LOCATION_DEPTH {}\n",
+                     DepthOutput))
+      .addSource(rs.getString("redwoodNoise.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
+
+  // setup texture binding points
+  setUniform(uniformLocation("DepthTexture"), DepthTextureUnit);
+  setUniform(uniformLocation("DistortionModel"), DistortionModelTextureUnit);
+
+  // setup uniforms
+  depthUnprojectionUniform_ = uniformLocation("DepthUnprojection");
+  noiseMultiplierUniform_ = uniformLocation("NoiseMultiplier");
+  seedUniform_ = uniformLocation("Seed");
+  CORRADE_INTERNAL_ASSERT(depthUnprojectionUniform_ >= 0 &&
+                          noiseMultiplierUniform_ >= 0 && seedUniform_ >= 0);
+}
+
+RedwoodNoiseShader& RedwoodNoiseShader::bindDepthTexture(
+    Mn::GL::Texture2D& texture) {
+  texture.bind(DepthTextureUnit);
+  return *this;
+}
+
+RedwoodNoiseShader& RedwoodNoiseShader::bindDistortionModel(
+    Mn::GL::Texture2D& texture) {
+  texture.bind(DistortionModelTextureUnit);
+  return *this;
+}
+
+RedwoodNoiseShader& RedwoodNoiseShader::setDepthUnprojection(
+    const Mn::Vector2& depthUnprojection) {
+  setUniform(depthUnprojectionUniform_, depthUnprojection);
+  return *this;
+}
+
+RedwoodNoiseShader& RedwoodNoiseShader::setNoiseMultiplier(
+    float noiseMultiplier) {
+  setUniform(noiseMultiplierUniform_, noiseMultiplier);
+  return *this;
+}
+
+RedwoodNoiseShader& RedwoodNoiseShader::setSeed(Mn::UnsignedInt seed) {
+  setUniform(seedUniform_, seed);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,86 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REDWOODNOISESHADER_H_
+#define ESP_GFX_REDWOODNOISESHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/GL.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief A shader unprojecting a depth texture and applying the Redwood noise
+model for PrimeSense depth sensors to it
+
+GLSL implementation of @ref sensor::RedwoodNoiseModelGPUImpl, drawn with a
+fullscreen triangle into an R32F attachment in place of
+@ref gfx_batch::DepthShader, so the noise costs neither an extra pass over
+the observation nor CUDA. Uses its own random number generator, the noise
+has the same distribution but isn't bit-exact with the CUDA one.
+*/
+class RedwoodNoiseShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  enum : Magnum::UnsignedInt {
+    /** Noisy unprojected depth output */
+    DepthOutput = 0,
+  };
+
+  /** @brief Rows of the distortion model, see @ref bindDistortionModel() */
+  static constexpr int DistortionModelRows = 80;
+
+  /** @brief Columns of the distortion model */
+  static constexpr int DistortionModelColumns = 80 * 5;
+
+  /** @brief Constructor */
+  explicit RedwoodNoiseShader();
+
+  /**
+   * @brief Bind the depth texture to unproject
+   * @return Reference to self (for method chaining)
+   */
+  RedwoodNoiseShader& bindDepthTexture(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Bind the distortion model, a @ref DistortionModelColumns x
+   * @ref DistortionModelRows R32F texture built from
+   * http://redwood-data.org/indoor/data/dist-model.txt with the third
+   * dimension flattened into the second
+   * @return Reference to self (for method chaining)
+   */
+  RedwoodNoiseShader& bindDistortionModel(Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Set depth unprojection parameters, see
+   * @ref gfx_batch::calculateDepthUnprojection()
+   * @return Reference to self (for method chaining)
+   */
+  RedwoodNoiseShader& setDepthUnprojection(
+      const Magnum::Vector2& depthUnprojection);
+
+  /**
+   * @brief Set the multiplier of the Gaussian random variables, to increase
+   * or decrease the noise level
+   * @return Reference to self (for method chaining)
+   */
+  RedwoodNoiseShader& setNoiseMultiplier(float noiseMultiplier);
+
+  /**
+   * @brief Set the random seed, should differ for every draw so that the
+   * noise does too
+   * @return Reference to self (for method chaining)
+   */
+  RedwoodNoiseShader& setSeed(Magnum::UnsignedInt seed);
+
+ private:
+  GLint depthUnprojectionUniform_ = -1;
+  GLint noiseMultiplierUniform_ = -1;
+  GLint seedUniform_ = -1;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_REDWOODNOISESHADER_H_
@@ -4,11 +4,22 @@
 
 #include "RenderCamera.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/GL/Renderer.h>
 #include <Magnum/SceneGraph/Drawable.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include "esp/core/Profiler.h"
+#include "esp/core/ScratchArena.h"
+#include "esp/gfx/DrawableBvh.h"
+#include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/PbrDrawable.h"
 #include "esp/scene/SceneGraph.h"
 
 namespace Mn = Magnum;
@@ -17,6 +28,11 @@ namespace Cr = Corrade;
 namespace esp {
 namespace gfx {
 
+namespace {
+//! Source of @ref RenderCamera::drawPass(), 0 is never a valid pass
+std::atomic<uint64_t> drawPassCounter{0};
+}  // namespace
+
 /**
  * @brief do frustum culling with temporal coherence
  * @param range the axis-aligned bounding box
@@ -47,6 +63,39 @@ Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
   return Cr::Containers::NullOpt;
 }
 
+/**
+ * @brief camera relative transformations of the objects of @p drawables
+ *
+ * Dirty objects are cleaned together first. After
+ * @ref scene::SceneGraph::updateTransformations() there are none, and each
+ * transformation is a single multiplication with the cached absolute one
+ * instead of a walk up the hierarchy. @p transformations is a
+ * @ref core::ScratchVector if it doesn't outlive the frame.
+ */
+template <class Transformations>
+void cameraRelativeTransformations(
+    Cr::Containers::ArrayView<
+        const std::reference_wrapper<Mn::SceneGraph::Drawable3D>> drawables,
+    const Mn::Matrix4& camera,
+    Transformations& transformations) {
+  std::vector<std::reference_wrapper<MagnumObject>> dirtyNodes;
+  for (Mn::SceneGraph::Drawable3D& drawable : drawables) {
+    auto& node = static_cast<scene::SceneNode&>(drawable.object());
+    if (node.isDirty()) {
+      dirtyNodes.emplace_back(node);
+    }
+  }
+  MagnumObject::setClean(std::move(dirtyNodes));
+
+  transformations.clear();
+  transformations.reserve(drawables.size());
+  for (Mn::SceneGraph::Drawable3D& drawable : drawables) {
+    transformations.push_back(
+        camera * static_cast<scene::SceneNode&>(drawable.object())
+                     .cleanAbsoluteTransformation());
+  }
+}
+
 RenderCamera::RenderCamera(scene::SceneNode& node,
                            esp::scene::SceneNodeSemanticDataIDX semanticDataIDX)
     : MagnumCamera{node}, semanticInfoIDX_(semanticDataIDX) {
@@ -113,16 +162,52 @@ RenderCamera& RenderCamera::setOrthoProjectionMatrix(int width,
 }
 
 size_t RenderCamera::cull(DrawableTransforms& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::cull");
   // camera frustum relative to world origin
   const Mn::Frustum frustum =
       Mn::Frustum::fromMatrix(projectionMatrix() * cameraMatrix());
 
+  // objects are tested as a whole first, so the drawables of ones outside the
+  // frustum are rejected with a single test. Results are per object.
+  std::unordered_map<
+      scene::SceneNode*, bool, std::hash<scene::SceneNode*>,
+      std::equal_to<scene::SceneNode*>,
+      core::ScratchAllocator<std::pair<scene::SceneNode* const, bool>>>
+      objectCulled;
+  const auto isObjectCulled = [&](scene::SceneNode& node) {
+    scene::SceneNode* object = nullptr;
+    for (scene::SceneNode* ancestor = &node;;) {
+      if (ancestor->getType() == scene::SceneNodeType::OBJECT) {
+        object = ancestor;
+      }
+      auto* parent = ancestor->parent();
+      if (!parent || parent->isScene()) {
+        break;
+      }
+      ancestor = static_cast<scene::SceneNode*>(parent);
+    }
+    if (!object) {
+      return false;
+    }
+    auto found = objectCulled.emplace(object, false);
+    if (found.second) {
+      const Cr::Containers::Optional<Mn::Range3D>& aabb =
+          object->getSubtreeAABB();
+      found.first->second =
+          aabb && rangeFrustum(*aabb, frustum) != Cr::Containers::NullOpt;
+    }
+    return found.first->second;
+  };
+
   auto newEndIter = std::remove_if(
       drawableTransforms.begin(), drawableTransforms.end(),
       [&](const std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
                           Mn::Matrix4>& a) {
         // obtain the absolute aabb
         auto& node = static_cast<scene::SceneNode&>(a.first.get().object());
+        if (isObjectCulled(node)) {
+          return true;
+        }
         // This updates the AABB for dynamic objects if needed
         node.setClean();
         const Mn::Range3D& aabb = node.getAbsoluteAABB();
@@ -139,6 +224,61 @@ size_t RenderCamera::cull(DrawableTransforms& drawableTransforms) {
   return (newEndIter - drawableTransforms.begin());
 }
 
+RenderCamera::DrawableTransforms RenderCamera::visibleDrawableTransformations(
+    DrawableGroup& drawables) {
+  ESP_PROFILE_SCOPE("RenderCamera::visibleDrawableTransformations");
+  const Mn::Matrix4 camera = cameraMatrix();
+  // refits the hierarchy, which drops cached results if anything moved
+  DrawableBvh& bvh = drawables.bvh();
+
+  // sensors sharing a pose and projection, e.g. color and depth, reuse the
+  // first one's cull
+  const DrawableGroup::CullResult* result =
+      drawables.cachedCullResult(projectionMatrix(), camera);
+  if (!result) {
+    // camera frustum relative to world origin
+    const Mn::Frustum frustum =
+        Mn::Frustum::fromMatrix(projectionMatrix() * camera);
+
+    DrawableGroup::CullResult newResult;
+    newResult.projection = projectionMatrix();
+    newResult.camera = camera;
+    newResult.visible =
+        bvh.cull(frustum, [&](Mn::SceneGraph::Drawable3D& drawable) {
+          auto& node = static_cast<scene::SceneNode&>(drawable.object());
+          Cr::Containers::Optional<int> culledPlane = rangeFrustum(
+              node.getAbsoluteAABB(), frustum, node.getFrustumPlaneIndex());
+          if (culledPlane) {
+            node.setFrustumPlaneIndex(*culledPlane);
+          }
+          return culledPlane == Cr::Containers::NullOpt;
+        });
+
+    // same as MagnumCamera::drawableTransformations(), but only for the
+    // drawables that passed
+    core::ScratchVector<std::reference_wrapper<Mn::SceneGraph::Drawable3D>>
+        visible;
+    visible.reserve(newResult.visible.size());
+    for (std::size_t i : newResult.visible) {
+      visible.emplace_back(drawables[i]);
+    }
+    // cached in the group, so not on the scratch arena
+    cameraRelativeTransformations(visible, camera, newResult.transformations);
+
+    drawables.cacheCullResult(std::move(newResult));
+    result = drawables.cachedCullResult(projectionMatrix(), camera);
+    CORRADE_INTERNAL_ASSERT(result);
+  }
+
+  DrawableTransforms drawableTransforms;
+  drawableTransforms.reserve(result->visible.size());
+  for (std::size_t i = 0; i < result->visible.size(); ++i) {
+    drawableTransforms.emplace_back(drawables[result->visible[i]],
+                                    result->transformations[i]);
+  }
+  return drawableTransforms;
+}
+
 size_t RenderCamera::removeNonObjects(DrawableTransforms& drawableTransforms) {
   auto newEndIter = std::remove_if(
       drawableTransforms.begin(), drawableTransforms.end(),
@@ -154,12 +294,33 @@ size_t RenderCamera::removeNonObjects(DrawableTransforms& drawableTransforms) {
 uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
                             Flags flags) {
   previousNumVisibleDrawables_ = drawableTransforms.size();
+  drawPass_ = ++drawPassCounter;
 
   if (flags & Flag::UseDrawableIdAsObjectId) {
     semanticIDXToUse_ = esp::scene::SceneNodeSemanticDataIDX::DRAWABLE_ID;
   }
 
-  MagnumCamera::draw(drawableTransforms);
+  if (flags & Flag::LevelOfDetail) {
+    selectLodLevels(drawableTransforms);
+  }
+
+  if (core::Profiler::isEnabled()) {
+    countStateChanges(drawableTransforms);
+  }
+
+  if (flags & Flag::DepthOnly) {
+    drawDepthOnly(drawableTransforms);
+  } else if (flags & Flag::ObjectIdOnly) {
+    drawObjectIdOnly(drawableTransforms);
+  } else if (flags & Flag::Instancing) {
+    drawInstanced(drawableTransforms);
+  } else {
+    MagnumCamera::draw(drawableTransforms);
+  }
+
+  if (flags & Flag::LevelOfDetail) {
+    resetLodLevels(drawableTransforms);
+  }
 
   // Reset to using the base semantic idx assigned to this camera
   semanticIDXToUse_ = semanticInfoIDX_;
@@ -167,9 +328,249 @@ uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
   return drawableTransforms.size();
 }
 
+void RenderCamera::selectLodLevels(DrawableTransforms& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::selectLodLevels");
+  const Mn::Matrix4& projection = projectionMatrix();
+  const bool orthographic = projection[3][3] != 0.0f;
+  // pixels covered by a unit length at unit distance (or at any distance for
+  // an orthographic projection) along the vertical axis
+  const float pixelsPerUnit =
+      0.5f * projection[1][1] * Mn::Float(viewport().y());
+  const Mn::Matrix4 camera = cameraMatrix();
+
+  for (auto& drawableTransform : drawableTransforms) {
+    auto* drawable = dynamic_cast<Drawable*>(&drawableTransform.first.get());
+    if (!drawable || !drawable->hasLodLevels()) {
+      continue;
+    }
+    auto& node = static_cast<scene::SceneNode&>(drawable->object());
+    // This updates the AABB for dynamic objects if needed
+    node.setClean();
+    const Mn::Range3D& aabb = node.getAbsoluteAABB();
+    // bounding sphere of the box, the full mesh is drawn when the camera is
+    // inside of it
+    const float radius = 0.5f * aabb.size().length();
+    const float distance = -camera.transformPoint(aabb.center()).z();
+    float pixelSize = Mn::Constants::inf();
+    if (orthographic) {
+      pixelSize = 2.0f * radius * pixelsPerUnit;
+    } else if (distance > radius) {
+      pixelSize = 2.0f * radius / distance * pixelsPerUnit;
+    }
+    drawable->selectLodLevel(pixelSize);
+  }
+}
+
+void RenderCamera::resetLodLevels(DrawableTransforms& drawableTransforms) {
+  for (auto& drawableTransform : drawableTransforms) {
+    if (auto* drawable =
+            dynamic_cast<Drawable*>(&drawableTransform.first.get())) {
+      drawable->selectLodLevel(Mn::Constants::inf());
+    }
+  }
+}
+
+void RenderCamera::drawInstanced(DrawableTransforms& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::drawInstanced");
+  // compatible drawables are collected into batches, PBR drawables are sorted
+  // by shader and material, everything else is drawn right away in the
+  // original order
+  // all of it is scratch memory, the draw doesn't keep any of it
+  core::ScratchVector<
+      core::ScratchVector<std::pair<GenericDrawable*, Mn::Matrix4>>>
+      batches;
+  std::unordered_map<
+      const Mn::GL::Mesh*, core::ScratchVector<std::size_t>,
+      std::hash<const Mn::GL::Mesh*>, std::equal_to<const Mn::GL::Mesh*>,
+      core::ScratchAllocator<std::pair<const Mn::GL::Mesh* const,
+                                       core::ScratchVector<std::size_t>>>>
+      batchesForMesh;
+  core::ScratchVector<std::pair<PbrDrawable*, Mn::Matrix4>> pbrDrawables;
+  for (auto& drawableTransform : drawableTransforms) {
+    Mn::SceneGraph::Drawable3D& drawable = drawableTransform.first;
+    if (auto* pbr = dynamic_cast<PbrDrawable*>(&drawable)) {
+      pbrDrawables.emplace_back(pbr, drawableTransform.second);
+      continue;
+    }
+    auto* generic = dynamic_cast<GenericDrawable*>(&drawable);
+    // mirrored instances would need the opposite winding
+    if (!generic || !generic->canDrawInstanced() ||
+        drawableTransform.second.rotationScaling().determinant() <= 0.0f) {
+      drawable.draw(drawableTransform.second, *this);
+      continue;
+    }
+
+    core::ScratchVector<std::size_t>& candidates =
+        batchesForMesh[&generic->getMesh()];
+    auto found = std::find_if(
+        candidates.begin(), candidates.end(), [&](std::size_t batch) {
+          return batches[batch].front().first->isInstanceCompatible(*generic);
+        });
+    if (found == candidates.end()) {
+      candidates.push_back(batches.size());
+      batches.emplace_back();
+      found = candidates.end() - 1;
+    }
+    batches[*found].emplace_back(generic, drawableTransform.second);
+  }
+
+  for (const auto& batch : batches) {
+    if (batch.size() == 1) {
+      static_cast<Mn::SceneGraph::Drawable3D&>(*batch.front().first)
+          .draw(batch.front().second, *this);
+      continue;
+    }
+    if (!instanceBuffer_) {
+      instanceBuffer_.emplace();
+    }
+    GenericDrawable::drawInstanced(batch, *this, *instanceBuffer_);
+  }
+
+  // consecutive draws with the same shader and material skip the program
+  // switch and material uniform uploads
+  core::ScratchVector<
+      std::pair<std::pair<const PbrShader*, uint64_t>, std::size_t>>
+      pbrOrder;
+  pbrOrder.reserve(pbrDrawables.size());
+  for (std::size_t i = 0; i != pbrDrawables.size(); ++i) {
+    PbrDrawable& pbr = *pbrDrawables[i].first;
+    pbrOrder.push_back({{&pbr.getShader(), pbr.getMaterialId()}, i});
+  }
+  std::sort(pbrOrder.begin(), pbrOrder.end());
+  for (const auto& entry : pbrOrder) {
+    auto& pbrDrawable = pbrDrawables[entry.second];
+    static_cast<Mn::SceneGraph::Drawable3D&>(*pbrDrawable.first)
+        .draw(pbrDrawable.second, *this);
+  }
+}
+
+void RenderCamera::drawDepthOnly(DrawableTransforms& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::drawDepthOnly");
+  if (!depthOnlyShader_) {
+    depthOnlyShader_.emplace();
+  }
+  Mn::GL::Renderer::setColorMask(false, false, false, false);
+  const Mn::Matrix4& projection = projectionMatrix();
+  for (auto& drawableTransform : drawableTransforms) {
+    Mn::SceneGraph::Drawable3D& drawable = drawableTransform.first;
+    auto* ours = dynamic_cast<Drawable*>(&drawable);
+    auto* pbr = dynamic_cast<PbrDrawable*>(ours);
+    // skinned meshes are deformed by their own shaders and double-sided
+    // materials change face culling in their own draws
+    if (!ours || !ours->getDrawState().mesh || ours->isSkinned() ||
+        (pbr && pbr->isDoubleSided()) ||
+        (!pbr && !dynamic_cast<GenericDrawable*>(ours))) {
+      Mn::GL::Renderer::setColorMask(true, true, true, true);
+      drawable.draw(drawableTransform.second, *this);
+      Mn::GL::Renderer::setColorMask(false, false, false, false);
+      continue;
+    }
+
+    // mirrored drawables need the opposite winding, as in their own draws
+    const bool mirrored =
+        drawableTransform.second.rotationScaling().determinant() < 0.0f;
+    if (mirrored) {
+      Mn::GL::Renderer::setFrontFace(Mn::GL::Renderer::FrontFace::ClockWise);
+    }
+    depthOnlyShader_
+        ->setTransformationProjectionMatrix(projection *
+                                            drawableTransform.second)
+        .draw(ours->getMesh());
+    if (mirrored) {
+      Mn::GL::Renderer::setFrontFace(
+          Mn::GL::Renderer::FrontFace::CounterClockWise);
+    }
+  }
+  Mn::GL::Renderer::setColorMask(true, true, true, true);
+}
+
+void RenderCamera::drawObjectIdOnly(DrawableTransforms& drawableTransforms) {
+  ESP_PROFILE_SCOPE("RenderCamera::drawObjectIdOnly");
+  for (auto& drawableTransform : drawableTransforms) {
+    Mn::SceneGraph::Drawable3D& drawable = drawableTransform.first;
+    auto* generic = dynamic_cast<GenericDrawable*>(&drawable);
+    if (generic && generic->getDrawState().mesh && !generic->isSkinned()) {
+      generic->drawObjectId(drawableTransform.second, *this);
+    } else {
+      drawable.draw(drawableTransform.second, *this);
+    }
+  }
+}
+
+RenderCamera::DrawableTransforms RenderCamera::filteredDrawableTransformations(
+    MagnumDrawableGroup& drawables,
+    Flags flags) {
+  // cull through the group's hierarchy when there is one, which also skips
+  // computing transformations of culled drawables
+  auto* group = dynamic_cast<DrawableGroup*>(&drawables);
+  DrawableTransforms drawableTransforms;
+  if ((flags & Flag::FrustumCulling) && group) {
+    drawableTransforms = visibleDrawableTransformations(*group);
+    filterTransforms(drawableTransforms, flags & ~Flag::FrustumCulling);
+  } else {
+    core::ScratchVector<std::reference_wrapper<Mn::SceneGraph::Drawable3D>>
+        all;
+    all.reserve(drawables.size());
+    for (std::size_t i = 0; i != drawables.size(); ++i) {
+      all.emplace_back(drawables[i]);
+    }
+    core::ScratchVector<Mn::Matrix4> transformations;
+    cameraRelativeTransformations(all, cameraMatrix(), transformations);
+    drawableTransforms.reserve(all.size());
+    for (std::size_t i = 0; i != all.size(); ++i) {
+      drawableTransforms.emplace_back(all[i], transformations[i]);
+    }
+    filterTransforms(drawableTransforms, flags);
+  }
+
+  if (group && group->hasDrawOrder()) {
+    sortByDrawOrder(drawableTransforms, *group);
+  }
+  return drawableTransforms;
+}
+
+void RenderCamera::sortByDrawOrder(DrawableTransforms& drawableTransforms,
+                                   const DrawableGroup& group) {
+  ESP_PROFILE_SCOPE("RenderCamera::sortByDrawOrder");
+  std::vector<std::pair<std::size_t, std::size_t>> order;
+  order.reserve(drawableTransforms.size());
+  for (std::size_t i = 0; i != drawableTransforms.size(); ++i) {
+    order.emplace_back(group.drawOrderIndex(drawableTransforms[i].first), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  DrawableTransforms sorted;
+  sorted.reserve(drawableTransforms.size());
+  for (const auto& entry : order) {
+    sorted.push_back(drawableTransforms[entry.second]);
+  }
+  drawableTransforms = std::move(sorted);
+}
+
+void RenderCamera::countStateChanges(
+    const DrawableTransforms& drawableTransforms) {
+  Drawable::DrawState previous;
+  int64_t shaderChanges = 0;
+  int64_t materialChanges = 0;
+  int64_t meshChanges = 0;
+  for (const auto& drawableTransform : drawableTransforms) {
+    auto* drawable = dynamic_cast<Drawable*>(&drawableTransform.first.get());
+    const Drawable::DrawState state =
+        drawable ? drawable->getDrawState() : Drawable::DrawState{};
+    shaderChanges += state.shader != previous.shader;
+    materialChanges += state.materialId != previous.materialId;
+    meshChanges += state.mesh != previous.mesh;
+    previous = state;
+  }
+  ESP_PROFILE_COUNT("RenderCamera::draws",
+                    static_cast<int64_t>(drawableTransforms.size()));
+  ESP_PROFILE_COUNT("RenderCamera::shaderChanges", shaderChanges);
+  ESP_PROFILE_COUNT("RenderCamera::materialChanges", materialChanges);
+  ESP_PROFILE_COUNT("RenderCamera::meshChanges", meshChanges);
+}
+
 uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
-  auto drawableTransforms = drawableTransformations(drawables);
-  filterTransforms(drawableTransforms, flags);
+  auto drawableTransforms = filteredDrawableTransformations(drawables, flags);
   return draw(drawableTransforms, flags);
 }
 
@@ -194,6 +595,15 @@ size_t RenderCamera::filterTransforms(DrawableTransforms& drawableTransforms,
   return drawableTransforms.size();
 }
 
+LightClusters& RenderCamera::getLightClusters(const LightSetup& lightSetup) {
+  LightClusters& clusters = lightClusters_[&lightSetup];
+  if (clusters.update(lightSetup, cameraMatrix(), projectionMatrix(),
+                      viewport())) {
+    clusters.upload();
+  }
+  return clusters;
+}
+
 esp::geo::Ray RenderCamera::unproject(const Mn::Vector2i& viewportPosition,
                                       bool normalized) {
   esp::geo::Ray ray;
@@ -5,12 +5,19 @@
 #ifndef ESP_GFX_RENDERCAMERA_H_
 #define ESP_GFX_RENDERCAMERA_H_
 
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/SceneGraph/Camera.h>
+#include <Magnum/Shaders/FlatGL.h>
 #include "esp/core/Esp.h"
 #include "esp/geo/Geo.h"
+#include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/LightClusters.h"
 #include "esp/gfx/magnum.h"
 #include "esp/scene/SceneNode.h"
 
+#include <unordered_map>
+
 namespace esp {
 namespace gfx {
 
@@ -53,6 +60,39 @@ class RenderCamera : public MagnumCamera {
      * Clear object id, used in the sub-class CubeMapCamera
      */
     ClearObjectId = 1 << 5,
+
+    /**
+     * Draw @ref GenericDrawable instances that share mesh, material and
+     * lights in a single instanced draw call, and @ref PbrDrawable instances
+     * sorted by shader and material. Changes the draw order.
+     */
+    Instancing = 1 << 6,
+
+    /**
+     * Draw Drawables with simplified levels of detail set, see @ref
+     * Drawable::setLodLevels(), with the level matching the projected size
+     * of their node's bounding box on screen.
+     */
+    LevelOfDetail = 1 << 7,
+
+    /**
+     * Draw only depth, with a position-only shader instead of the drawables'
+     * own shaders, skipping their material, texture and light setup.
+     * Skinned drawables, double-sided PBR materials and drawables other
+     * than @ref GenericDrawable and @ref PbrDrawable are still drawn as
+     * usual. Color writes are disabled, so the color and object id
+     * attachments aren't written to.
+     */
+    DepthOnly = 1 << 8,
+
+    /**
+     * Draw only object IDs, drawing @ref GenericDrawable instances with a
+     * flat shader instead of their own, without lighting or any textures
+     * except object ID textures. Skinned drawables and all other drawables
+     * are still drawn as usual. Used for semantic sensors, which only read
+     * the object ID attachment.
+     */
+    ObjectIdOnly = 1 << 9,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -219,6 +259,40 @@ class RenderCamera : public MagnumCamera {
    */
   size_t cull(DrawableTransforms& drawableTransforms);
 
+  /**
+   * @brief Frustum culls @p drawables through their bounding volume hierarchy
+   * and returns the visible drawables along with their transformations
+   * relative to the camera
+   * @param drawables the drawable group to cull
+   * @return the same drawables and transformations as @ref cull on all of
+   * @p drawables, in the order of the group
+   *
+   * Only the transformations of visible drawables are computed, and the
+   * result is cached in @p drawables so other cameras with the same camera
+   * and projection matrix reuse it until something in the group moves. Used
+   * by @ref draw(MagnumDrawableGroup&, Flags) when frustum culling is
+   * enabled.
+   */
+  DrawableTransforms visibleDrawableTransformations(DrawableGroup& drawables);
+
+  /**
+   * @brief The drawables @ref draw(MagnumDrawableGroup&, Flags) would draw,
+   * along with their transformations relative to the camera
+   * @param drawables a drawable group containing all the drawables
+   * @param flags state flags to direct drawing
+   *
+   * If @p drawables is a @ref DrawableGroup that was prepared with
+   * @ref DrawableGroup::prepareForDraw(), the drawables are sorted by its
+   * draw order.
+   *
+   * Lets the transformations be computed separately from drawing them, e.g.
+   * to snapshot them for drawing on another thread with
+   * @ref draw(DrawableTransforms&, Flags).
+   */
+  DrawableTransforms filteredDrawableTransformations(
+      MagnumDrawableGroup& drawables,
+      Flags flags = {});
+
   /**
    * @brief Cull Drawables for SceneNodes which are not OBJECT type.
    *
@@ -237,6 +311,15 @@ class RenderCamera : public MagnumCamera {
    */
   int getSemanticDataIDX() const { return static_cast<int>(semanticIDXToUse_); }
 
+  /**
+   * @brief ID of the draw currently in progress, unique across all cameras.
+   *
+   * Scene nodes don't move while a camera draws, so state derived from them,
+   * such as the joint matrices of a skinned instance, only has to be
+   * computed by the first drawable that needs it in a draw pass.
+   */
+  uint64_t drawPass() const { return drawPass_; }
+
   /**
    * @brief Unproject a 2D viewport point to a 3D ray with origin at camera
    * position. Ray direction is optionally normalized. Non-normalized rays
@@ -260,12 +343,75 @@ class RenderCamera : public MagnumCamera {
     return previousNumVisibleDrawables_;
   }
 
+  /**
+   * @brief Clusters of @p lightSetup for the current view, updated and
+   * uploaded if the lights or the view changed since the last call
+   *
+   * Kept per light setup, so drawables sharing one share the clusters too.
+   */
+  LightClusters& getLightClusters(const LightSetup& lightSetup);
+
  protected:
   //! cached inverted projection matrix to save compute on repeated calls (e.g.
   //! to unproject) without moving the camera
   Mn::Matrix4 invertedProjectionMatrix;
   size_t previousNumVisibleDrawables_ = 0;
   bool useDrawableIds_ = false;
+  uint64_t drawPass_ = 0;
+
+  /**
+   * @brief Draw with compatible drawables batched into instanced draws, see
+   * @ref Flag::Instancing
+   */
+  void drawInstanced(DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Draw only the depth of @p drawableTransforms, see
+   * @ref Flag::DepthOnly
+   */
+  void drawDepthOnly(DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Draw only the object IDs of @p drawableTransforms, see
+   * @ref Flag::ObjectIdOnly
+   */
+  void drawObjectIdOnly(DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Select the level of detail of each drawable in @p
+   * drawableTransforms from its projected size, see @ref
+   * Flag::LevelOfDetail
+   */
+  void selectLodLevels(DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Switch all drawables in @p drawableTransforms back to their full
+   * mesh, so their level doesn't leak into draws without @ref
+   * Flag::LevelOfDetail
+   */
+  static void resetLodLevels(DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Reorder @p drawableTransforms by the draw order of @p group, see
+   * @ref DrawableGroup::drawOrderIndex()
+   */
+  static void sortByDrawOrder(DrawableTransforms& drawableTransforms,
+                              const DrawableGroup& group);
+
+  /**
+   * @brief Add the shader, material and mesh changes between consecutive
+   * drawables to the per-frame counters of the @ref core::Profiler
+   */
+  static void countStateChanges(const DrawableTransforms& drawableTransforms);
+
+  //! per-instance data of instanced draws, created on first use
+  Corrade::Containers::Optional<Magnum::GL::Buffer> instanceBuffer_;
+
+  //! position-only shader of depth-only draws, created on first use
+  Corrade::Containers::Optional<Magnum::Shaders::FlatGL3D> depthOnlyShader_;
+
+  //! light clusters of each light setup drawn from this camera
+  std::unordered_map<const LightSetup*, LightClusters> lightClusters_;
 
   //! index of semantic id type held in scene nodes that this camera is made to
   //! render for semantic sensors. This may be overridden by object picking
@@ -19,6 +19,8 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Shaders/GenericGL.h>
 
+#include "GpuTimer.h"
+#include "RedwoodNoiseShader.h"
 #include "RenderTarget.h"
 #include "esp/sensor/VisualSensor.h"
 
@@ -43,6 +45,8 @@ const Mn::GL::Framebuffer::ColorAttachment ObjectIdTextureColorAttachment =
     Mn::GL::Framebuffer::ColorAttachment{1};
 const Mn::GL::Framebuffer::ColorAttachment UnprojectedDepthBufferAttachment =
     Mn::GL::Framebuffer::ColorAttachment{0};
+const Mn::GL::Framebuffer::ColorAttachment UpsampledDepthBufferAttachment =
+    Mn::GL::Framebuffer::ColorAttachment{2};
 
 struct RenderTarget::Impl {
   Impl(const Mn::Vector2i& size,
@@ -50,9 +54,9 @@ struct RenderTarget::Impl {
        gfx_batch::DepthShader* depthShader,
        Flags flags,
        const sensor::VisualSensor* visualSensor)
-      : colorBuffer_{},
-        objectIdTexture_{},
-        depthRenderTexture_{},
+      : colorBuffer_{Mn::NoCreate},
+        objectIdTexture_{Mn::NoCreate},
+        depthRenderTexture_{Mn::NoCreate},
         framebuffer_{Mn::NoCreate},
         depthUnprojection_{depthUnprojection},
         depthShader_{depthShader},
@@ -60,13 +64,26 @@ struct RenderTarget::Impl {
         depthUnprojectionMesh_{Mn::NoCreate},
         depthUnprojectionFrameBuffer_{Mn::NoCreate},
         flags_{flags},
+        viewport_{{}, size},
+        outputSize_{size},
         visualSensor_{visualSensor} {
     if (depthShader_) {
       CORRADE_INTERNAL_ASSERT(
           depthShader_->flags() &
           gfx_batch::DepthShader::Flag::UnprojectExistingDepth);
     }
+    createAttachments(size);
+  }
 
+  /**
+   * @brief (Re)create the framebuffer and all its attachments for rendering
+   * at @p size
+   */
+  void createAttachments(const Mn::Vector2i& size) {
+    // texture storage is immutable, so everything is created anew
+    colorBuffer_ = Mn::GL::Renderbuffer{};
+    objectIdTexture_ = Mn::GL::Texture2D{};
+    depthRenderTexture_ = Mn::GL::Texture2D{};
     if (flags_ & Flag::RgbaAttachment) {
       colorBuffer_.setStorage(Mn::GL::RenderbufferFormat::RGBA8, size);
     }
@@ -123,10 +140,17 @@ struct RenderTarget::Impl {
 #ifndef MAGNUM_TARGET_WEBGL
       // depth texture is required for HBAO
       CORRADE_INTERNAL_ASSERT(flags_ & Flag::DepthTextureAttachment);
+      gfx_batch::HbaoResolution resolution = gfx_batch::HbaoResolution::Full;
+      if (flags_ & Flag::HbaoQuarterResolution) {
+        resolution = gfx_batch::HbaoResolution::Quarter;
+      } else if (flags_ & Flag::HbaoHalfResolution) {
+        resolution = gfx_batch::HbaoResolution::Half;
+      }
       // TODO Drive construction based on premade configurations
       hbao_ = gfx_batch::Hbao{
           gfx_batch::HbaoConfiguration{}
               .setSize(size)
+              .setResolution(resolution)
               .setUseSpecialBlur(true)
               .setUseLayeredGeometryShader(true)
           // TODO other options here?
@@ -138,6 +162,132 @@ struct RenderTarget::Impl {
     }
   }
 
+  Impl(const std::shared_ptr<RenderTarget>& atlas,
+       const Mn::Range2Di& tile,
+       const Mn::Vector2& depthUnprojection,
+       const sensor::VisualSensor* visualSensor)
+      : colorBuffer_{Mn::NoCreate},
+        objectIdTexture_{Mn::NoCreate},
+        depthRenderTexture_{Mn::NoCreate},
+        framebuffer_{Mn::NoCreate},
+        depthUnprojection_{depthUnprojection},
+        depthShader_{nullptr},
+        unprojectedDepth_{Mn::NoCreate},
+        depthUnprojectionMesh_{Mn::NoCreate},
+        depthUnprojectionFrameBuffer_{Mn::NoCreate},
+        flags_{atlas->pimpl_->flags_ & ~Flag::HorizonBasedAmbientOcclusion},
+        viewport_{tile},
+        outputSize_{tile.size()},
+        visualSensor_{visualSensor},
+        atlasTarget_{atlas},
+        atlas_{atlas->pimpl_.get()} {
+    CORRADE_ASSERT(!atlas_->atlas_,
+                   "RenderTarget::Impl: a tile can't be made of another "
+                   "tile", );
+    CORRADE_ASSERT(
+        atlas_->viewport_.contains(tile),
+        "RenderTarget::Impl: tile" << tile << "is outside of the atlas"
+                                   << atlas_->viewport_, );
+  }
+
+  void resize(const Mn::Vector2i& size, const Mn::Vector2i& outputSize) {
+    ESP_CHECK(!atlas_,
+              "RenderTarget::resize(): a tile can't be resized, bind its "
+              "sensors to a new atlas instead");
+    const bool resized = size != viewport_.size();
+    if (resized) {
+#ifdef ESP_BUILD_WITH_CUDA
+      // the interop registrations refer to the old attachments
+      for (cudaGraphicsResource_t* resource :
+           {&colorBufferCugl_, &depthBufferCugl_, &objecIdBufferCugl_}) {
+        if (*resource != nullptr) {
+          checkCudaErrors(cudaGraphicsUnregisterResource(*resource));
+          *resource = nullptr;
+        }
+      }
+#endif
+      viewport_ = {{}, size};
+      createAttachments(size);
+      // the unprojection target gets recreated on the next depth read
+      depthUnprojectionMesh_ = Mn::GL::Mesh{Mn::NoCreate};
+      depthUnprojectionFrameBuffer_ = Mn::GL::Framebuffer{Mn::NoCreate};
+    }
+    if (resized || outputSize != outputSize_) {
+      upsampleFramebuffer_ = Mn::GL::Framebuffer{Mn::NoCreate};
+    }
+    outputSize_ = outputSize;
+  }
+
+  //! Whether reads upsample the rendered image to @ref outputSize_
+  bool upsampling() const { return outputSize_ != viewport_.size(); }
+
+  //! Rectangle reads copy from the framebuffer returned by @ref readSource()
+  Mn::Range2Di readRectangle() const {
+    return upsampling() ? Mn::Range2Di{{}, outputSize_} : viewport_;
+  }
+
+  /**
+   * @brief Framebuffer to read @p attachment of @p source from, mapped for
+   * reading. When upsampling, the attachment is first blitted to a
+   * framebuffer of the output size with @p upsampledAttachment and
+   * @p upsampledFormat, using @p filter.
+   */
+  Mn::GL::Framebuffer& readSource(
+      Mn::GL::Framebuffer& source,
+      Mn::GL::Framebuffer::ColorAttachment attachment,
+      Mn::GL::Framebuffer::ColorAttachment upsampledAttachment,
+      Mn::GL::FramebufferBlitFilter filter) {
+    if (!upsampling()) {
+      source.mapForRead(attachment);
+      return source;
+    }
+
+    if (upsampleFramebuffer_.id() == 0) {
+      upsampleFramebuffer_ = Mn::GL::Framebuffer{{{}, outputSize_}};
+      upsampleColor_ = Mn::GL::Renderbuffer{Mn::NoCreate};
+      upsampleObjectId_ = Mn::GL::Renderbuffer{Mn::NoCreate};
+      upsampleDepth_ = Mn::GL::Renderbuffer{Mn::NoCreate};
+      if (flags_ & Flag::RgbaAttachment) {
+        upsampleColor_ = Mn::GL::Renderbuffer{};
+        upsampleColor_.setStorage(Mn::GL::RenderbufferFormat::RGBA8,
+                                  outputSize_);
+        upsampleFramebuffer_.attachRenderbuffer(RgbaBufferAttachment,
+                                                upsampleColor_);
+      }
+      if (flags_ & Flag::ObjectIdAttachment) {
+        upsampleObjectId_ = Mn::GL::Renderbuffer{};
+        upsampleObjectId_.setStorage(Mn::GL::RenderbufferFormat::R32UI,
+                                     outputSize_);
+        upsampleFramebuffer_.attachRenderbuffer(ObjectIdTextureColorAttachment,
+                                                upsampleObjectId_);
+      }
+      if (flags_ & Flag::DepthTextureAttachment) {
+        upsampleDepth_ = Mn::GL::Renderbuffer{};
+        upsampleDepth_.setStorage(Mn::GL::RenderbufferFormat::R32F,
+                                  outputSize_);
+        upsampleFramebuffer_.attachRenderbuffer(UpsampledDepthBufferAttachment,
+                                                upsampleDepth_);
+      }
+    }
+
+    source.mapForRead(attachment);
+    upsampleFramebuffer_.mapForDraw(upsampledAttachment);
+    Mn::GL::AbstractFramebuffer::blit(source, upsampleFramebuffer_, viewport_,
+                                      {{}, outputSize_},
+                                      Mn::GL::FramebufferBlit::Color, filter);
+    upsampleFramebuffer_.mapForRead(upsampledAttachment);
+    return upsampleFramebuffer_;
+  }
+
+  /**
+   * @brief The framebuffer rendered to, shared with the atlas for a tile. Its
+   * viewport is the one of the last tile that entered rendering, use
+   * @ref viewport_ instead.
+   */
+  Mn::GL::Framebuffer& framebuffer() {
+    return atlas_ ? atlas_->framebuffer_ : framebuffer_;
+  }
+
   void initDepthUnprojector() {
     CORRADE_ASSERT(
         flags_ & Flag::DepthTextureAttachment,
@@ -164,8 +314,44 @@ struct RenderTarget::Impl {
     }
   }
 
+  void setRedwoodDepthNoise(RedwoodNoiseShader* shader,
+                            Cr::Containers::ArrayView<const Mn::Float> model,
+                            Mn::Float noiseMultiplier,
+                            Mn::UnsignedInt seed) {
+    noiseShader_ = shader;
+    if (!noiseShader_) {
+      noiseModelTexture_ = Mn::GL::Texture2D{Mn::NoCreate};
+      return;
+    }
+
+    CORRADE_ASSERT(!atlas_,
+                   "RenderTarget::Impl::setRedwoodDepthNoise(): not supported "
+                   "for a tile", );
+    CORRADE_ASSERT(
+        flags_ & Flag::DepthTextureAttachment,
+        "RenderTarget::Impl::setRedwoodDepthNoise(): this render target "
+        "was not created with depth texture enabled.", );
+    const Mn::Vector2i modelSize{RedwoodNoiseShader::DistortionModelColumns,
+                                 RedwoodNoiseShader::DistortionModelRows};
+    CORRADE_ASSERT(model.size() == std::size_t(modelSize.product()),
+                   "RenderTarget::Impl::setRedwoodDepthNoise(): expected"
+                       << modelSize.product() << "model coefficients but got"
+                       << model.size(), );
+
+    noiseModelTexture_ = Mn::GL::Texture2D{};
+    noiseModelTexture_.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::R32F, modelSize)
+        .setSubImage(0, {},
+                     Mn::ImageView2D{Mn::PixelFormat::R32F, modelSize, model});
+    noiseMultiplier_ = noiseMultiplier;
+    noiseSeed_ = seed;
+    noiseFrame_ = 0;
+  }
+
   void unprojectDepthGPU() {
-    CORRADE_INTERNAL_ASSERT(depthShader_ != nullptr);
+    CORRADE_INTERNAL_ASSERT(depthShader_ != nullptr || noiseShader_ != nullptr);
     CORRADE_ASSERT(
         flags_ & Flag::DepthTextureAttachment,
         "RenderTarget::Impl::unprojectDepthGPU(): this render target "
@@ -173,6 +359,18 @@ struct RenderTarget::Impl {
     initDepthUnprojector();
 
     depthUnprojectionFrameBuffer_.bind();
+    if (noiseShader_) {
+      // unprojection is fused into the noise pass, a different seed every
+      // frame so the noise isn't frozen in place
+      (*noiseShader_)
+          .bindDepthTexture(depthRenderTexture_)
+          .bindDistortionModel(noiseModelTexture_)
+          .setDepthUnprojection(depthUnprojection_)
+          .setNoiseMultiplier(noiseMultiplier_)
+          .setSeed(noiseSeed_ + 0x9e3779b9u * ++noiseFrame_)
+          .draw(depthUnprojectionMesh_);
+      return;
+    }
     (*depthShader_)
         .bindDepthTexture(depthRenderTexture_)
         .setDepthUnprojection(depthUnprojection_)
@@ -180,23 +378,38 @@ struct RenderTarget::Impl {
   }
 
   void renderEnter() {
-    framebuffer_.clearDepth(1.0);
+    ++renderCount_;
+    Mn::GL::Framebuffer& framebuffer = this->framebuffer();
+    framebuffer.setViewport(viewport_);
+    // clears ignore the viewport, so only the scissor keeps a tile from
+    // clearing its neighbors
+    if (atlas_) {
+      Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::ScissorTest);
+      Mn::GL::Renderer::setScissor(viewport_);
+    }
+    framebuffer.clearDepth(1.0);
     if (flags_ & Flag::RgbaAttachment) {
       if (visualSensor_) {
-        framebuffer_.clearColor(0, static_cast<esp::sensor::VisualSensorSpec*>(
-                                       visualSensor_->specification().get())
-                                       ->clearColor);
+        framebuffer.clearColor(0, static_cast<esp::sensor::VisualSensorSpec*>(
+                                      visualSensor_->specification().get())
+                                      ->clearColor);
       } else {
-        framebuffer_.clearColor(0, Mn::Color4{0, 0, 0, 1});
+        framebuffer.clearColor(0, Mn::Color4{0, 0, 0, 1});
       }
     }
     if (flags_ & Flag::ObjectIdAttachment) {
-      framebuffer_.clearColor(1, Mn::Vector4ui{});
+      framebuffer.clearColor(1, Mn::Vector4ui{});
     }
-    framebuffer_.bind();
+    if (atlas_) {
+      Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::ScissorTest);
+    }
+    framebuffer.bind();
   }
 
-  void renderReEnter() { framebuffer_.bind(); }
+  void renderReEnter() {
+    ++renderCount_;
+    framebuffer().setViewport(viewport_).bind();
+  }
 
   void renderExit() {}
 
@@ -205,6 +418,7 @@ struct RenderTarget::Impl {
       return;
     }
 
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "Hbao::drawEffect");
     hbao_->drawEffect(visualSensor_->getProjectionMatrix(),
                       gfx_batch::HbaoType::CacheAware, depthRenderTexture_,
                       framebuffer_);
@@ -217,9 +431,9 @@ struct RenderTarget::Impl {
         "RenderTarget::Impl::blitRgbaToDefault(): this render target "
         "was not created with rgba render buffer enabled.", );
 
-    framebuffer_.mapForRead(RgbaBufferAttachment);
+    framebuffer().mapForRead(RgbaBufferAttachment);
     Mn::GL::AbstractFramebuffer::blit(
-        framebuffer_, target, framebuffer_.viewport(), targetRectangle,
+        framebuffer(), target, viewport_, targetRectangle,
         Mn::GL::FramebufferBlit::Color, Mn::GL::FramebufferBlitFilter::Linear);
   }
 
@@ -227,24 +441,33 @@ struct RenderTarget::Impl {
     CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
                    "RenderTarget::Impl::readFrameRgba(): this render target "
                    "was not created with rgba render buffer enabled.", );
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameRgba");
 
-    framebuffer_.mapForRead(RgbaBufferAttachment)
-        .read(framebuffer_.viewport(), view);
+    readSource(framebuffer(), RgbaBufferAttachment, RgbaBufferAttachment,
+               Mn::GL::FramebufferBlitFilter::Linear)
+        .read(readRectangle(), view);
   }
 
   void readFrameDepth(const Mn::MutableImageView2D& view) {
     CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
                    "RenderTarget::Impl::readFrameDepth(): this render target "
                    "was not created with depth texture enabled.", );
-    if (depthShader_) {
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameDepth");
+    if (depthShader_ || noiseShader_) {
       unprojectDepthGPU();
-      depthUnprojectionFrameBuffer_.mapForRead(UnprojectedDepthBufferAttachment)
-          .read(framebuffer_.viewport(), view);
+      readSource(depthUnprojectionFrameBuffer_,
+                 UnprojectedDepthBufferAttachment,
+                 UpsampledDepthBufferAttachment,
+                 Mn::GL::FramebufferBlitFilter::Nearest)
+          .read(readRectangle(), view);
     } else {
+      ESP_CHECK(!upsampling(),
+                "RenderTarget::readFrameDepth(): upsampling depth requires "
+                "a depth shader");
       Mn::MutableImageView2D depthBufferView{
           Mn::GL::PixelFormat::DepthComponent, Mn::GL::PixelType::Float,
           view.size(), view.data()};
-      framebuffer_.read(framebuffer_.viewport(), depthBufferView);
+      framebuffer().read(viewport_, depthBufferView);
       gfx_batch::unprojectDepth(depthUnprojection_, view.pixels<Mn::Float>());
     }
   }
@@ -254,20 +477,95 @@ struct RenderTarget::Impl {
         flags_ & Flag::ObjectIdAttachment,
         "RenderTarget::Impl::readFrameObjectId(): this render target "
         "was not created with objectId render texture enabled.", );
-    framebuffer_.mapForRead(ObjectIdTextureColorAttachment)
-        .read(framebuffer_.viewport(), view);
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameObjectId");
+    readSource(framebuffer(), ObjectIdTextureColorAttachment,
+               ObjectIdTextureColorAttachment,
+               Mn::GL::FramebufferBlitFilter::Nearest)
+        .read(readRectangle(), view);
+  }
+
+#ifndef MAGNUM_TARGET_WEBGL
+  void readFrameRgba(Mn::GL::BufferImage2D& image) {
+    CORRADE_ASSERT(flags_ & Flag::RgbaAttachment,
+                   "RenderTarget::Impl::readFrameRgba(): this render target "
+                   "was not created with rgba render buffer enabled.", );
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameRgba");
+
+    readSource(framebuffer(), RgbaBufferAttachment, RgbaBufferAttachment,
+               Mn::GL::FramebufferBlitFilter::Linear)
+        .read(readRectangle(), image, Mn::GL::BufferUsage::StreamRead);
+  }
+
+  void readFrameDepth(Mn::GL::BufferImage2D& image) {
+    CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
+                   "RenderTarget::Impl::readFrameDepth(): this render target "
+                   "was not created with depth texture enabled.", );
+    CORRADE_ASSERT(depthShader_ || noiseShader_,
+                   "RenderTarget::Impl::readFrameDepth(): reading depth into a "
+                   "pixel buffer requires a depth shader.", );
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameDepth");
+    unprojectDepthGPU();
+    readSource(depthUnprojectionFrameBuffer_, UnprojectedDepthBufferAttachment,
+               UpsampledDepthBufferAttachment,
+               Mn::GL::FramebufferBlitFilter::Nearest)
+        .read(readRectangle(), image, Mn::GL::BufferUsage::StreamRead);
+  }
+
+  void readFrameObjectId(Mn::GL::BufferImage2D& image) {
+    CORRADE_ASSERT(
+        flags_ & Flag::ObjectIdAttachment,
+        "RenderTarget::Impl::readFrameObjectId(): this render target "
+        "was not created with objectId render texture enabled.", );
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "RenderTarget::readFrameObjectId");
+    readSource(framebuffer(), ObjectIdTextureColorAttachment,
+               ObjectIdTextureColorAttachment,
+               Mn::GL::FramebufferBlitFilter::Nearest)
+        .read(readRectangle(), image, Mn::GL::BufferUsage::StreamRead);
   }
+#endif
+
+  Mn::Vector2i framebufferSize() const { return viewport_.size(); }
+
+  Mn::Vector2i outputSize() const { return outputSize_; }
 
-  Mn::Vector2i framebufferSize() const {
-    return framebuffer_.viewport().size();
+  std::size_t gpuMemoryUsage() const {
+    if (atlas_) {
+      return 0;
+    }
+    // every attachment format used has four bytes per pixel, except for
+    // the 24-bit depth renderbuffer which drivers pad to four as well
+    const std::size_t pixelCount = viewport_.size().product();
+    std::size_t attachmentCount = 0;
+    if (flags_ & Flag::RgbaAttachment) {
+      ++attachmentCount;
+    }
+    if (flags_ & Flag::ObjectIdAttachment) {
+      ++attachmentCount;
+    }
+    if (flags_ & Flag::DepthTextureAttachment) {
+      ++attachmentCount;
+    }
+    if (unprojectedDepth_.id()) {
+      ++attachmentCount;
+    }
+    std::size_t usage = 4 * pixelCount * attachmentCount;
+    for (const Mn::GL::Renderbuffer* buffer :
+         {&upsampleColor_, &upsampleObjectId_, &upsampleDepth_}) {
+      if (buffer->id()) {
+        usage += 4 * std::size_t(outputSize_.product());
+      }
+    }
+    return usage;
   }
 
+  Mn::Range2Di viewport() const { return viewport_; }
+
   Magnum::GL::Texture2D& getDepthTexture() {
     CORRADE_ASSERT(flags_ & Flag::DepthTextureAttachment,
                    "RenderTarget::Impl::getDepthTexture(): this render target "
                    "was not created with depth texture enabled.",
                    depthRenderTexture_);
-    return depthRenderTexture_;
+    return atlas_ ? atlas_->depthRenderTexture_ : depthRenderTexture_;
   }
   Magnum::GL::Texture2D& getObjectIdTexture() {
     CORRADE_ASSERT(
@@ -275,11 +573,17 @@ struct RenderTarget::Impl {
         "RenderTarget::Impl::getObjectIdTexture(): this render target "
         "was not created with object id texture enabled.",
         objectIdTexture_);
-    return objectIdTexture_;
+    return atlas_ ? atlas_->objectIdTexture_ : objectIdTexture_;
   }
 
 #ifdef ESP_BUILD_WITH_CUDA
   void readFrameRgbaGPU(uint8_t* devPtr) {
+    CORRADE_ASSERT(!atlas_,
+                   "RenderTarget::Impl::readFrameRgbaGPU(): not supported for "
+                   "a tile, read the atlas instead", );
+    CORRADE_ASSERT(!upsampling(),
+                   "RenderTarget::Impl::readFrameRgbaGPU(): not supported when "
+                   "upsampling", );
     // TODO: Consider implementing the GPU read functions with EGLImage
     // See discussion here:
     // https://github.com/facebookresearch/habitat-sim/pull/114#discussion_r312718502
@@ -306,6 +610,12 @@ struct RenderTarget::Impl {
   }
 
   void readFrameDepthGPU(float* devPtr) {
+    CORRADE_ASSERT(!atlas_,
+                   "RenderTarget::Impl::readFrameDepthGPU(): not supported for "
+                   "a tile, read the atlas instead", );
+    CORRADE_ASSERT(!upsampling(),
+                   "RenderTarget::Impl::readFrameDepthGPU(): not supported "
+                   "when upsampling", );
     CORRADE_ASSERT(
         flags_ & Flag::DepthTextureAttachment,
         "RenderTarget::Impl::readFrameDepthGPU(): this render target "
@@ -331,6 +641,12 @@ struct RenderTarget::Impl {
   }
 
   void readFrameObjectIdGPU(int32_t* devPtr) {
+    CORRADE_ASSERT(!atlas_,
+                   "RenderTarget::Impl::readFrameObjectIdGPU(): not supported "
+                   "for a tile, read the atlas instead", );
+    CORRADE_ASSERT(!upsampling(),
+                   "RenderTarget::Impl::readFrameObjectIdGPU(): not supported "
+                   "when upsampling", );
     CORRADE_ASSERT(
         flags_ & Flag::ObjectIdAttachment,
         "RenderTarget::Impl::readFrameObjectIdGPU(): this render target "
@@ -382,10 +698,35 @@ struct RenderTarget::Impl {
   Mn::GL::Mesh depthUnprojectionMesh_;
   Mn::GL::Framebuffer depthUnprojectionFrameBuffer_;
 
+  // Redwood depth noise applied while unprojecting, if set
+  RedwoodNoiseShader* noiseShader_ = nullptr;
+  Mn::GL::Texture2D noiseModelTexture_{Mn::NoCreate};
+  Mn::Float noiseMultiplier_ = 1.0f;
+  Mn::UnsignedInt noiseSeed_ = 0;
+  Mn::UnsignedInt noiseFrame_ = 0;
+
   Flags flags_;
 
+  std::size_t renderCount_ = 0;
+
+  // the area of the framebuffer rendered to and read from
+  Mn::Range2Di viewport_;
+
+  // size reads are upsampled to, same as the viewport size if not
+  // upsampling. The framebuffer holding the upsampled attachments is created
+  // on first read.
+  Mn::Vector2i outputSize_;
+  Mn::GL::Framebuffer upsampleFramebuffer_{Mn::NoCreate};
+  Mn::GL::Renderbuffer upsampleColor_{Mn::NoCreate};
+  Mn::GL::Renderbuffer upsampleObjectId_{Mn::NoCreate};
+  Mn::GL::Renderbuffer upsampleDepth_{Mn::NoCreate};
+
   const sensor::VisualSensor* visualSensor_ = nullptr;
 
+  // for a tile, the render target that owns the framebuffer, null otherwise
+  std::shared_ptr<RenderTarget> atlasTarget_;
+  Impl* atlas_ = nullptr;
+
 #ifdef ESP_BUILD_WITH_CUDA
   cudaGraphicsResource_t colorBufferCugl_ = nullptr;
   cudaGraphicsResource_t objecIdBufferCugl_ = nullptr;
@@ -393,6 +734,8 @@ struct RenderTarget::Impl {
 #endif
 
   Cr::Containers::Optional<gfx_batch::Hbao> hbao_{};
+  //! Times the HBAO pass and readbacks
+  GpuTimer gpuTimer_;
 };  // namespace gfx
 
 RenderTarget::RenderTarget(const Mn::Vector2i& size,
@@ -406,6 +749,15 @@ RenderTarget::RenderTarget(const Mn::Vector2i& size,
                                             flags,
                                             visualSensor)) {}
 
+RenderTarget::RenderTarget(const std::shared_ptr<RenderTarget>& atlas,
+                           const Mn::Range2Di& tile,
+                           const Mn::Vector2& depthUnprojection,
+                           const sensor::VisualSensor* visualSensor)
+    : pimpl_(spimpl::make_unique_impl<Impl>(atlas,
+                                            tile,
+                                            depthUnprojection,
+                                            visualSensor)) {}
+
 void RenderTarget::renderEnter() {
   pimpl_->renderEnter();
 }
@@ -418,6 +770,14 @@ void RenderTarget::renderExit() {
   pimpl_->renderExit();
 }
 
+std::size_t RenderTarget::renderCount() const {
+  return pimpl_->renderCount_;
+}
+
+std::size_t RenderTarget::gpuMemoryUsage() const {
+  return pimpl_->gpuMemoryUsage();
+}
+
 void RenderTarget::readFrameRgba(const Mn::MutableImageView2D& view) {
   pimpl_->readFrameRgba(view);
 }
@@ -430,6 +790,20 @@ void RenderTarget::readFrameObjectId(const Mn::MutableImageView2D& view) {
   pimpl_->readFrameObjectId(view);
 }
 
+#ifndef MAGNUM_TARGET_WEBGL
+void RenderTarget::readFrameRgba(Mn::GL::BufferImage2D& image) {
+  pimpl_->readFrameRgba(image);
+}
+
+void RenderTarget::readFrameDepth(Mn::GL::BufferImage2D& image) {
+  pimpl_->readFrameDepth(image);
+}
+
+void RenderTarget::readFrameObjectId(Mn::GL::BufferImage2D& image) {
+  pimpl_->readFrameObjectId(image);
+}
+#endif
+
 void RenderTarget::blitRgbaTo(Mn::GL::AbstractFramebuffer& target,
                               const Mn::Range2Di& targetRectangle) {
   pimpl_->blitRgbaTo(target, targetRectangle);
@@ -444,6 +818,19 @@ Mn::Vector2i RenderTarget::framebufferSize() const {
   return pimpl_->framebufferSize();
 }
 
+Mn::Vector2i RenderTarget::outputSize() const {
+  return pimpl_->outputSize();
+}
+
+void RenderTarget::resize(const Mn::Vector2i& size,
+                          const Mn::Vector2i& outputSize) {
+  pimpl_->resize(size, outputSize);
+}
+
+Mn::Range2Di RenderTarget::viewport() const {
+  return pimpl_->viewport();
+}
+
 Mn::GL::Texture2D& RenderTarget::getDepthTexture() {
   return pimpl_->getDepthTexture();
 }
@@ -452,6 +839,14 @@ Mn::GL::Texture2D& RenderTarget::getObjectIdTexture() {
   return pimpl_->getObjectIdTexture();
 }
 
+void RenderTarget::setRedwoodDepthNoise(
+    RedwoodNoiseShader* shader,
+    Cr::Containers::ArrayView<const Mn::Float> model,
+    Mn::Float noiseMultiplier,
+    Mn::UnsignedInt seed) {
+  pimpl_->setRedwoodDepthNoise(shader, model, noiseMultiplier, seed);
+}
+
 void RenderTarget::tryDrawHbao() {
   return pimpl_->tryDrawHbao();
 }
@@ -5,8 +5,12 @@
 #ifndef ESP_GFX_RENDERTARGET_H_
 #define ESP_GFX_RENDERTARGET_H_
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/EnumSet.h>
+#include <Magnum/GL/GL.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+#include <memory>
 
 #include "esp/core/Esp.h"
 
@@ -23,6 +27,8 @@ class DepthShader;
 
 namespace gfx {
 
+class RedwoodNoiseShader;
+
 /**
  * Holds a framebuffer and encapsulates the logic of retrieving rendering
  * results of various types (RGB, Depth, ObjectID) from the framebuffer.
@@ -57,6 +63,19 @@ class RenderTarget {
      * Enable HBAO visual effect that adds soft shadows to corners and crevices.
      */
     HorizonBasedAmbientOcclusion = 1 << 3,
+
+    /**
+     * Calculate HBAO at half resolution and bilaterally upsample it. Has an
+     * effect only together with @ref Flag::HorizonBasedAmbientOcclusion.
+     */
+    HbaoHalfResolution = 1 << 4,
+
+    /**
+     * Calculate HBAO at quarter resolution and bilaterally upsample it. Has
+     * an effect only together with @ref Flag::HorizonBasedAmbientOcclusion,
+     * takes precedence over @ref Flag::HbaoHalfResolution.
+     */
+    HbaoQuarterResolution = 1 << 5,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -98,6 +117,27 @@ class RenderTarget {
                const sensor::VisualSensor* visualSensor = nullptr)
       : RenderTarget{size, depthUnprojection, nullptr, {}, visualSensor} {}
 
+  /**
+   * @brief Constructor for a tile of another render target
+   * @param atlas              The render target owning the framebuffer the
+   *                           tile is part of. It is kept alive by the tile.
+   * @param tile               The area of the @p atlas framebuffer to render
+   *                           into and read from
+   * @param depthUnprojection  Depth unprojection parameters.  See @ref
+   *                           calculateDepthUnprojection()
+   * @param visualSensor       (optional) The visual sensor for this render
+   * target
+   *
+   * Lets several sensors render into one framebuffer, to read all their
+   * results back from @p atlas with a single transfer. A tile has the
+   * attachments of @p atlas but no HBAO, unprojects depth on the CPU and
+   * can't be read into pixel buffers or CUDA memory.
+   */
+  RenderTarget(const std::shared_ptr<RenderTarget>& atlas,
+               const Magnum::Range2Di& tile,
+               const Magnum::Vector2& depthUnprojection,
+               const sensor::VisualSensor* visualSensor = nullptr);
+
   ~RenderTarget() = default;
 
   /**
@@ -118,11 +158,55 @@ class RenderTarget {
    */
   void renderExit();
 
+  /**
+   * @brief Number of times @ref renderEnter() or @ref renderReEnter() was
+   * called
+   *
+   * Lets a sensor tell whether the framebuffer still holds the image it drew
+   * last, as targets can be shared.
+   */
+  std::size_t renderCount() const;
+
+  /**
+   * @brief Estimated GPU memory of the attachments, in bytes
+   *
+   * Counts the framebuffer, depth unprojection and upsampling attachments
+   * created so far, but not the HBAO buffers. A tile shares the attachments
+   * of its atlas and reports @cpp 0 @ce.
+   */
+  std::size_t gpuMemoryUsage() const;
+
   /**
    * @brief The size of the framebuffer in WxH
    */
   Magnum::Vector2i framebufferSize() const;
 
+  /**
+   * @brief The area of the framebuffer rendered into, its whole size unless
+   * this is a tile of another render target
+   */
+  Magnum::Range2Di viewport() const;
+
+  /**
+   * @brief The size frames are read back at in WxH
+   *
+   * Same as @ref framebufferSize() unless set otherwise with @ref resize(), in
+   * which case reads upsample the rendered frame to it.
+   */
+  Magnum::Vector2i outputSize() const;
+
+  /**
+   * @brief Render at @p size and read frames back at @p outputSize
+   *
+   * The attachments are reallocated only if @p size changed. If
+   * @p outputSize differs from @p size, reads blit the rendered frame to
+   * @p outputSize first, with linear filtering for RGBA and nearest for depth
+   * and object IDs, trading quality for rendering throughput. Reading depth
+   * that way requires a depth shader, and the GPU reads don't support it.
+   * Expects that this is neither a tile nor an atlas with tiles.
+   */
+  void resize(const Magnum::Vector2i& size, const Magnum::Vector2i& outputSize);
+
   /**
    * @brief Retrieve the RGBA rendering results.
    *
@@ -152,6 +236,33 @@ class RenderTarget {
    */
   void readFrameObjectId(const Magnum::MutableImageView2D& view);
 
+#ifndef MAGNUM_TARGET_WEBGL
+  /**
+   * @brief Queue a read of the RGBA rendering results into a pixel buffer
+   *
+   * Returns without waiting for the GPU. The buffer of @p image is
+   * (re)allocated to the framebuffer size and the result is read as the pixel
+   * format of @p image. See @ref AsyncReadback for fencing and retrieving it.
+   */
+  void readFrameRgba(Magnum::GL::BufferImage2D& image);
+
+  /**
+   * @brief Queue a read of the depth rendering results into a pixel buffer
+   *
+   * Like @ref readFrameRgba(Magnum::GL::BufferImage2D&). Requires the
+   * rendering target to have a valid DepthShader, as the depth is unprojected
+   * on the GPU before it's read.
+   */
+  void readFrameDepth(Magnum::GL::BufferImage2D& image);
+
+  /**
+   * @brief Queue a read of the ObjectID rendering results into a pixel buffer
+   *
+   * Like @ref readFrameRgba(Magnum::GL::BufferImage2D&)
+   */
+  void readFrameObjectId(Magnum::GL::BufferImage2D& image);
+#endif
+
   /**
    * @brief Blits the rgba buffer from internal FBO to given framebuffer
    * rectangle
@@ -166,12 +277,12 @@ class RenderTarget {
   void blitRgbaToDefault();
 
   /**
-   * @brief get the depth texture
+   * @brief get the depth texture, of the whole atlas for a tile
    */
   Magnum::GL::Texture2D& getDepthTexture();
 
   /**
-   * @brief get the object id texture
+   * @brief get the object id texture, of the whole atlas for a tile
    */
   Magnum::GL::Texture2D& getObjectIdTexture();
 
@@ -180,6 +291,22 @@ class RenderTarget {
    */
   void tryDrawHbao();
 
+  /**
+   * @brief Apply the Redwood depth noise model while unprojecting depth on
+   * the GPU, so depth reads return noisy depth without an extra pass or
+   * transfer. Not supported for tiles of an atlas.
+   *
+   * @param shader          Shader applying the noise, nullptr disables it.
+   *                        Has to outlive the render target or the next call.
+   * @param model           The distortion model, 80 rows of 80 x 5 floats
+   * @param noiseMultiplier Multiplier of the Gaussian noise
+   * @param seed            Random seed, advanced on every depth read
+   */
+  void setRedwoodDepthNoise(RedwoodNoiseShader* shader,
+                            Corrade::Containers::ArrayView<const float> model,
+                            float noiseMultiplier,
+                            unsigned int seed);
+
   // @brief Delete copy Constructor
   RenderTarget(const RenderTarget&) = delete;
   // @brief Delete copy operator
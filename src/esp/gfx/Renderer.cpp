@@ -22,13 +22,20 @@
 #include <Magnum/ResourceManager.h>
 
 #include "esp/core/Check.h"
+#include "esp/core/Profiler.h"
+#include "esp/gfx/GaussianFilterComputeShader.h"
 #include "esp/gfx/GaussianFilterShader.h"
+#include "esp/gfx/GpuTimer.h"
+#include "esp/gfx/RedwoodNoiseShader.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/TextureVisualizerShader.h"
 #include "esp/gfx_batch/DepthUnprojection.h"
+#include "esp/sensor/CubeMapSensorBase.h"
 #include "esp/sensor/VisualSensor.h"
 #include "esp/sim/Simulator.h"
 
+#include <cmath>
+
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
 #include "BackgroundRenderer.h"
 #endif
@@ -75,6 +82,7 @@ struct Renderer::Impl {
             scene::SceneGraph& sceneGraph,
             RenderCamera::Flags flags) {
     acquireGlContext();
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "Renderer::draw");
     for (auto& it : sceneGraph.getDrawableGroups()) {
       // TODO: remove || true and NOLINT below
       // NOLINTNEXTLINE (readability-simplify-boolean-expr)
@@ -204,12 +212,39 @@ struct Renderer::Impl {
                        (helper.getFlags() & CubeMap::Flag::ColorTexture),
                    "Renderer::Impl::applyGaussianFiltering(): cubemap is not "
                    "created with specified flag (ColorTexture) enabled.", );
+    ESP_PROFILE_GPU_SCOPE(gpuTimer_, "Renderer::applyGaussianFiltering");
 
     int imageSize = target.getCubeMapSize();
     if (helper.getCubeMapSize() != imageSize) {
       helper.reset(imageSize);
     }
 
+    if (gaussianFilterImplementation_ ==
+        GaussianFilterImplementation::Compute) {
+      Mn::Resource<Mn::GL::AbstractShaderProgram, GaussianFilterComputeShader>
+          shader = getShader<GaussianFilterComputeShader>(
+              RendererShaderType::GaussianFilterCompute);
+      // Round 1 horizontally into the helper, round 2 vertically back into
+      // the target, all faces at once
+      shader
+          ->setFilteringDirection(
+              GaussianFilterShader::FilteringDirection::Horizontal)
+          .bindSource(target.getTexture(type))
+          .bindDestination(helper.getTexture(type))
+          .filter(imageSize);
+      shader
+          ->setFilteringDirection(
+              GaussianFilterShader::FilteringDirection::Vertical)
+          .bindSource(helper.getTexture(type))
+          .bindDestination(target.getTexture(type))
+          .filter(imageSize);
+
+      if (target.getFlags() & CubeMap::Flag::AutoBuildMipmap) {
+        target.generateMipmap(type);
+      }
+      return;
+    }
+
     // get mesh
     if (!mesh_) {
       // prepare a big triangle mesh to cover the screen
@@ -262,6 +297,19 @@ struct Renderer::Impl {
     }
   }
 
+  void setGaussianFilterImplementation(
+      GaussianFilterImplementation implementation) {
+    ESP_CHECK(implementation != GaussianFilterImplementation::Compute ||
+                  GaussianFilterComputeShader::isSupported(),
+              "Renderer::setGaussianFilterImplementation(): compute shaders "
+              "need OpenGL 4.3, which the context doesn't support");
+    gaussianFilterImplementation_ = implementation;
+  }
+
+  GaussianFilterImplementation gaussianFilterImplementation() const {
+    return gaussianFilterImplementation_;
+  }
+
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
   void checkHasBackgroundRenderer() {
     ESP_CHECK(backgroundRenderer_,
@@ -347,6 +395,12 @@ struct Renderer::Impl {
           // force depth texture for Color sensor, needed for HBAO
           renderTargetFlags |= RenderTarget::Flag::DepthTextureAttachment;
           renderTargetFlags |= RenderTarget::Flag::HorizonBasedAmbientOcclusion;
+          if (flags_ & Renderer::Flag::HbaoHalfResolution) {
+            renderTargetFlags |= RenderTarget::Flag::HbaoHalfResolution;
+          }
+          if (flags_ & Renderer::Flag::HbaoQuarterResolution) {
+            renderTargetFlags |= RenderTarget::Flag::HbaoQuarterResolution;
+          }
         }
         break;
 
@@ -371,16 +425,305 @@ struct Renderer::Impl {
         break;
     }
 
-    sensor.bindRenderTarget(RenderTarget::create_unique(
-        sensor.framebufferSize(), *depthUnprojection, depthShader_.get(),
-        renderTargetFlags, &sensor));
+    RenderTarget::uptr tgt = RenderTarget::create_unique(
+        sensor.renderTargetSize(), *depthUnprojection, depthShader_.get(),
+        renderTargetFlags, &sensor);
+    tgt->resize(sensor.renderTargetSize(), sensor.framebufferSize());
+    sensor.bindRenderTarget(std::move(tgt));
+  }
+
+  void bindFusedRenderTarget(
+      const std::vector<sensor::VisualSensor*>& sensors) {
+    acquireGlContext();
+    // cubemap sensors keep their own targets and share just the cubemap
+    // they resample
+    const std::vector<sensor::CubeMapSensorBase*> cubeMapGroup =
+        cubeMapSensors(sensors);
+    if (!cubeMapGroup.empty()) {
+      sensor::CubeMapSensorBase::bindSharedCubeMap(cubeMapGroup);
+      return;
+    }
+
+    sensor::VisualSensor& primary = fusedPrimarySensor(sensors);
+    const Mn::Matrix4 projection = primary.getProjectionMatrix();
+
+    RenderTarget::Flags renderTargetFlags = {};
+    for (sensor::VisualSensor* sensor : sensors) {
+      ESP_CHECK(sensor->getRenderCamera(),
+                "Renderer::bindFusedRenderTarget(): sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't render through a camera and can't be fused");
+      ESP_CHECK(sensor->framebufferSize() == primary.framebufferSize() &&
+                    sensor->renderTargetSize() == primary.renderTargetSize() &&
+                    sensor->getProjectionMatrix() == projection,
+                "Renderer::bindFusedRenderTarget(): sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't share resolution and projection with sensor"
+                    << primary.specification()->uuid);
+
+      switch (sensor->specification()->sensorType) {
+        case sensor::SensorType::Color:
+          ESP_CHECK(!(flags_ & Flag::NoTextures),
+                    "Renderer::bindFusedRenderTarget(): Tried to setup a "
+                    "color render buffer while the simulator was initialized "
+                    "with requiresTextures = false");
+          renderTargetFlags |= RenderTarget::Flag::RgbaAttachment;
+          break;
+        case sensor::SensorType::Depth:
+          renderTargetFlags |= RenderTarget::Flag::DepthTextureAttachment;
+          break;
+        case sensor::SensorType::Semantic:
+          renderTargetFlags |= RenderTarget::Flag::ObjectIdAttachment;
+          break;
+        default:
+          ESP_CHECK(false, "Renderer::bindFusedRenderTarget(): sensor"
+                               << sensor->specification()->uuid
+                               << "is not a color, depth or semantic sensor");
+          break;
+      }
+    }
+
+    if (!depthShader_) {
+      depthShader_ = std::make_unique<gfx_batch::DepthShader>(
+          gfx_batch::DepthShader::Flag::UnprojectExistingDepth);
+    }
+
+    // the primary sensor provides the clear color
+    std::shared_ptr<RenderTarget> tgt = RenderTarget::create_unique(
+        primary.renderTargetSize(), *primary.depthUnprojection(),
+        depthShader_.get(), renderTargetFlags, &primary);
+    tgt->resize(primary.renderTargetSize(), primary.framebufferSize());
+    for (sensor::VisualSensor* sensor : sensors) {
+      sensor->bindRenderTarget(tgt);
+    }
+  }
+
+  std::shared_ptr<RenderTarget> bindTiledRenderTarget(
+      const std::vector<sensor::VisualSensor*>& sensors) {
+    std::vector<std::shared_ptr<RenderTarget>> tiles;
+    std::shared_ptr<RenderTarget> atlas = createTiles(sensors, tiles);
+    for (std::size_t i = 0; i != sensors.size(); ++i) {
+      sensors[i]->bindRenderTarget(std::move(tiles[i]));
+    }
+    return atlas;
+  }
+
+  std::shared_ptr<RenderTarget> createTiledRenderTarget(
+      sensor::VisualSensor& sensor,
+      int tileCount,
+      std::vector<std::shared_ptr<RenderTarget>>& tiles) {
+    ESP_CHECK(tileCount > 0,
+              "Renderer::createTiledRenderTarget(): expected a positive tile "
+              "count, got"
+                  << tileCount);
+    return createTiles(std::vector<sensor::VisualSensor*>(tileCount, &sensor),
+                       tiles);
+  }
+
+  // Atlas of one tile per sensor in a grid as square as possible, tiles[i]
+  // made for sensors[i]
+  std::shared_ptr<RenderTarget> createTiles(
+      const std::vector<sensor::VisualSensor*>& sensors,
+      std::vector<std::shared_ptr<RenderTarget>>& tiles) {
+    acquireGlContext();
+    ESP_CHECK(!sensors.empty(),
+              "Renderer::bindTiledRenderTarget(): the sensor group is empty");
+    sensor::VisualSensor& first = *sensors.front();
+    const sensor::SensorType type = first.specification()->sensorType;
+    const Mn::Vector2i tileSize = first.framebufferSize();
+    for (sensor::VisualSensor* sensor : sensors) {
+      // cubemap sensors resample with gl_FragCoord, which a tile offsets
+      ESP_CHECK(sensor->getRenderCamera(),
+                "Renderer::bindTiledRenderTarget(): sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't render through a camera and can't be tiled");
+      ESP_CHECK(sensor->specification()->sensorType == type &&
+                    sensor->framebufferSize() == tileSize,
+                "Renderer::bindTiledRenderTarget(): sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't share type and resolution with sensor"
+                    << first.specification()->uuid);
+      ESP_CHECK(sensor->renderTargetSize() == tileSize,
+                "Renderer::bindTiledRenderTarget(): sensor"
+                    << sensor->specification()->uuid
+                    << "renders at a reduced scale and can't be tiled");
+      ESP_CHECK(type != sensor::SensorType::Depth ||
+                    *sensor->depthUnprojection() == *first.depthUnprojection(),
+                "Renderer::bindTiledRenderTarget(): depth sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't share the depth unprojection of sensor"
+                    << first.specification()->uuid);
+    }
+
+    RenderTarget::Flags renderTargetFlags = {};
+    switch (type) {
+      case sensor::SensorType::Color:
+        ESP_CHECK(!(flags_ & Flag::NoTextures),
+                  "Renderer::bindTiledRenderTarget(): Tried to setup a "
+                  "color render buffer while the simulator was initialized "
+                  "with requiresTextures = false");
+        renderTargetFlags |= RenderTarget::Flag::RgbaAttachment;
+        break;
+      case sensor::SensorType::Depth:
+        renderTargetFlags |= RenderTarget::Flag::DepthTextureAttachment;
+        break;
+      case sensor::SensorType::Semantic:
+        renderTargetFlags |= RenderTarget::Flag::ObjectIdAttachment;
+        break;
+      default:
+        ESP_CHECK(false, "Renderer::bindTiledRenderTarget(): sensor"
+                             << first.specification()->uuid
+                             << "is not a color, depth or semantic sensor");
+        break;
+    }
+
+    if (!depthShader_) {
+      depthShader_ = std::make_unique<gfx_batch::DepthShader>(
+          gfx_batch::DepthShader::Flag::UnprojectExistingDepth);
+    }
+
+    // as square a grid as possible
+    const int tileCount = int(sensors.size());
+    const int columns = int(std::ceil(std::sqrt(float(tileCount))));
+    const Mn::Vector2i gridSize{columns, (tileCount + columns - 1) / columns};
+    std::shared_ptr<RenderTarget> atlas = RenderTarget::create_unique(
+        tileSize * gridSize, *first.depthUnprojection(), depthShader_.get(),
+        renderTargetFlags, &first);
+    tiles.clear();
+    tiles.reserve(tileCount);
+    for (int i = 0; i != tileCount; ++i) {
+      const Mn::Vector2i offset =
+          tileSize * Mn::Vector2i{i % columns, i / columns};
+      sensor::VisualSensor& sensor = *sensors[i];
+      tiles.push_back(std::make_shared<RenderTarget>(
+          atlas, Mn::Range2Di::fromSize(offset, tileSize),
+          *sensor.depthUnprojection(), &sensor));
+    }
+    return atlas;
+  }
+
+  void setRedwoodDepthNoise(sensor::VisualSensor& sensor,
+                            Cr::Containers::ArrayView<const float> model,
+                            float noiseMultiplier,
+                            unsigned int seed) {
+    acquireGlContext();
+    ESP_CHECK(sensor.specification()->sensorType == sensor::SensorType::Depth,
+              "Renderer::setRedwoodDepthNoise(): sensor"
+                  << sensor.specification()->uuid << "is not a depth sensor");
+    ESP_CHECK(sensor.hasRenderTarget(),
+              "Renderer::setRedwoodDepthNoise(): sensor"
+                  << sensor.specification()->uuid
+                  << "has no rendering target");
+    ESP_CHECK(model.size() ==
+                  std::size_t(RedwoodNoiseShader::DistortionModelRows *
+                              RedwoodNoiseShader::DistortionModelColumns),
+              "Renderer::setRedwoodDepthNoise(): expected a distortion model "
+              "of"
+                  << RedwoodNoiseShader::DistortionModelRows << "x"
+                  << RedwoodNoiseShader::DistortionModelColumns
+                  << "coefficients but got" << model.size());
+
+    if (!redwoodNoiseShader_) {
+      redwoodNoiseShader_ = std::make_unique<RedwoodNoiseShader>();
+    }
+    sensor.renderTarget().setRedwoodDepthNoise(redwoodNoiseShader_.get(),
+                                               model, noiseMultiplier, seed);
+  }
+
+  void drawFused(const std::vector<sensor::VisualSensor*>& sensors,
+                 sim::Simulator& sim) {
+    acquireGlContext();
+    const std::vector<sensor::CubeMapSensorBase*> cubeMapGroup =
+        cubeMapSensors(sensors);
+    if (!cubeMapGroup.empty()) {
+      sensor::CubeMapSensorBase::drawSharedObservations(cubeMapGroup, sim);
+      return;
+    }
+
+    sensor::VisualSensor& primary = fusedPrimarySensor(sensors);
+    ESP_CHECK(primary.hasRenderTarget(),
+              "Renderer::drawFused(): sensor" << primary.specification()->uuid
+                                              << "has no rendering target");
+    RenderTarget& tgt = primary.renderTarget();
+    const Mn::Matrix4 pose = primary.node().absoluteTransformationMatrix();
+
+    bool hasSemantic = false;
+    for (sensor::VisualSensor* sensor : sensors) {
+      ESP_CHECK(sensor->hasRenderTarget() && &sensor->renderTarget() == &tgt,
+                "Renderer::drawFused(): sensor"
+                    << sensor->specification()->uuid
+                    << "is not bound to the fused render target of the group");
+      ESP_CHECK(sensor->node().absoluteTransformationMatrix() == pose,
+                "Renderer::drawFused(): sensor"
+                    << sensor->specification()->uuid
+                    << "doesn't share the pose of sensor"
+                    << primary.specification()->uuid);
+      hasSemantic |=
+          sensor->specification()->sensorType == sensor::SensorType::Semantic;
+    }
+    if (hasSemantic) {
+      ESP_CHECK(sim.semanticSceneGraphExists(),
+                "Renderer::drawFused(): SemanticSensor observation requested "
+                "but no SemanticSceneGraph is loaded");
+      // object ids are only written by the drawables of the main scene graph
+      ESP_CHECK(
+          &sim.getActiveSemanticSceneGraph() == &sim.getActiveSceneGraph(),
+          "Renderer::drawFused(): a SemanticSensor can only be fused when "
+          "the semantic scene is part of the main scene graph");
+    }
+
+    RenderCamera::Flags flags;
+    if (sim.isFrustumCullingEnabled()) {
+      flags |= RenderCamera::Flag::FrustumCulling;
+    }
+
+    RenderCamera& camera = *primary.getRenderCamera();
+    DrawableGroup& drawables = sim.getActiveSceneGraph().getDrawables();
+    tgt.renderEnter();
+    drawables.prepareForDraw(camera);
+    camera.draw(drawables, flags);
+    tgt.renderExit();
   }
 
  private:
+  /**
+   * @brief The sensor a fused group is drawn with: its color sensor if it
+   * has one, so the clear color matches the unfused rendering, otherwise the
+   * first one.
+   */
+  static sensor::VisualSensor& fusedPrimarySensor(
+      const std::vector<sensor::VisualSensor*>& sensors) {
+    ESP_CHECK(!sensors.empty(), "Renderer: a fused sensor group is empty");
+    for (sensor::VisualSensor* sensor : sensors) {
+      if (sensor->specification()->sensorType == sensor::SensorType::Color) {
+        return *sensor;
+      }
+    }
+    return *sensors.front();
+  }
+
+  /**
+   * @brief The sensors of a fused group as cubemap sensors if all of them
+   * are, otherwise an empty list
+   */
+  static std::vector<sensor::CubeMapSensorBase*> cubeMapSensors(
+      const std::vector<sensor::VisualSensor*>& sensors) {
+    std::vector<sensor::CubeMapSensorBase*> cubeMapGroup;
+    for (sensor::VisualSensor* sensor : sensors) {
+      auto* cubeMapSensor = dynamic_cast<sensor::CubeMapSensorBase*>(sensor);
+      if (!cubeMapSensor) {
+        return {};
+      }
+      cubeMapGroup.push_back(cubeMapSensor);
+    }
+    return cubeMapGroup;
+  }
+
   WindowlessContext* context_;
   bool contextIsOwned_ = true;
   // TODO: shall we use shader resource manager from now?
   std::unique_ptr<gfx_batch::DepthShader> depthShader_;
+  std::unique_ptr<RedwoodNoiseShader> redwoodNoiseShader_;
   const Flags flags_;
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
   std::unique_ptr<BackgroundRenderer> backgroundRenderer_ = nullptr;
@@ -388,6 +731,9 @@ struct Renderer::Impl {
   Cr::Containers::Optional<Mn::GL::Mesh> mesh_;
   Mn::ResourceManager<Mn::GL::AbstractShaderProgram> shaderManager_;
   Cr::Containers::Optional<Mn::GL::Texture2D> visualizedTex_;
+  GaussianFilterImplementation gaussianFilterImplementation_ =
+      GaussianFilterImplementation::Fragment;
+  GpuTimer gpuTimer_;
 #ifdef ENABLE_VISUALIZATION_WORKAROUND_ON_MAC
   Cr::Containers::Optional<Mn::GL::BufferImage2D> depthBufferImage_;
 #endif
@@ -397,6 +743,7 @@ struct Renderer::Impl {
     DepthTextureVisualizer = 1,
     ObjectIdTextureVisualizer = 2,
     GaussianFilter = 3,
+    GaussianFilterCompute = 4,
   };
   template <typename T>
   Mn::Resource<Mn::GL::AbstractShaderProgram, T> getShader(
@@ -419,6 +766,10 @@ struct Renderer::Impl {
         key = Mn::ResourceKey{"gaussianFilter"};
         break;
 
+      case RendererShaderType::GaussianFilterCompute:
+        key = Mn::ResourceKey{"gaussianFilterCompute"};
+        break;
+
       default:
         CORRADE_INTERNAL_ASSERT_UNREACHABLE();
         break;
@@ -449,6 +800,10 @@ struct Renderer::Impl {
         shaderManager_.set<Mn::GL::AbstractShaderProgram>(
             shader.key(), new GaussianFilterShader{},
             Mn::ResourceDataState::Final, Mn::ResourcePolicy::Resident);
+      } else if (type == RendererShaderType::GaussianFilterCompute) {
+        shaderManager_.set<Mn::GL::AbstractShaderProgram>(
+            shader.key(), new GaussianFilterComputeShader{},
+            Mn::ResourceDataState::Final, Mn::ResourcePolicy::Resident);
       }
     }
     CORRADE_INTERNAL_ASSERT(shader);
@@ -465,10 +820,12 @@ Renderer::Renderer(WindowlessContext* context, Flags flags)
 void Renderer::draw(RenderCamera& camera,
                     scene::SceneGraph& sceneGraph,
                     RenderCamera::Flags flags) {
+  ESP_PROFILE_SCOPE("Renderer::draw");
   pimpl_->draw(camera, sceneGraph, flags);
 }
 
 void Renderer::draw(sensor::VisualSensor& visualSensor, sim::Simulator& sim) {
+  ESP_PROFILE_SCOPE("Renderer::draw(VisualSensor)");
   pimpl_->draw(visualSensor, sim);
 }
 
@@ -477,6 +834,37 @@ void Renderer::bindRenderTarget(sensor::VisualSensor& sensor,
   pimpl_->bindRenderTarget(sensor, bindingFlags);
 }
 
+std::shared_ptr<RenderTarget> Renderer::bindTiledRenderTarget(
+    const std::vector<sensor::VisualSensor*>& sensors) {
+  return pimpl_->bindTiledRenderTarget(sensors);
+}
+
+std::shared_ptr<RenderTarget> Renderer::createTiledRenderTarget(
+    sensor::VisualSensor& sensor,
+    int tileCount,
+    std::vector<std::shared_ptr<RenderTarget>>& tiles) {
+  return pimpl_->createTiledRenderTarget(sensor, tileCount, tiles);
+}
+
+void Renderer::setRedwoodDepthNoise(
+    sensor::VisualSensor& sensor,
+    Cr::Containers::ArrayView<const float> model,
+    float noiseMultiplier,
+    unsigned int seed) {
+  pimpl_->setRedwoodDepthNoise(sensor, model, noiseMultiplier, seed);
+}
+
+void Renderer::bindFusedRenderTarget(
+    const std::vector<sensor::VisualSensor*>& sensors) {
+  pimpl_->bindFusedRenderTarget(sensors);
+}
+
+void Renderer::drawFused(const std::vector<sensor::VisualSensor*>& sensors,
+                         sim::Simulator& sim) {
+  ESP_PROFILE_SCOPE("Renderer::drawFused");
+  pimpl_->drawFused(sensors, sim);
+}
+
 #ifdef ESP_BUILD_WITH_BACKGROUND_RENDERER
 void Renderer::enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
                                    scene::SceneGraph& sceneGraph,
@@ -519,6 +907,20 @@ void Renderer::visualize(sensor::VisualSensor& sensor,
 void Renderer::visualize(sensor::VisualSensor& sensor) {
   pimpl_->visualize(sensor);
 }
+bool Renderer::isGaussianFilterComputeSupported() {
+  return GaussianFilterComputeShader::isSupported();
+}
+
+void Renderer::setGaussianFilterImplementation(
+    GaussianFilterImplementation implementation) {
+  pimpl_->setGaussianFilterImplementation(implementation);
+}
+
+Renderer::GaussianFilterImplementation Renderer::gaussianFilterImplementation()
+    const {
+  return pimpl_->gaussianFilterImplementation();
+}
+
 void Renderer::applyGaussianFiltering(CubeMap& target,
                                       CubeMap& helper,
                                       CubeMap::TextureType type) {
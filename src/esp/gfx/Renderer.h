@@ -5,6 +5,9 @@
 #ifndef ESP_GFX_RENDERER_H_
 #define ESP_GFX_RENDERER_H_
 
+#include <Corrade/Containers/ArrayView.h>
+#include <vector>
+
 #include "esp/core/Esp.h"
 #include "esp/gfx/CubeMap.h"
 #include "esp/gfx/RenderCamera.h"
@@ -57,6 +60,17 @@ class Renderer {
      */
     HorizonBasedAmbientOcclusion = 1 << 4,
 
+    /**
+     * Calculate HBAO at half resolution, see
+     * @ref RenderTarget::Flag::HbaoHalfResolution.
+     */
+    HbaoHalfResolution = 1 << 5,
+
+    /**
+     * Calculate HBAO at quarter resolution, see
+     * @ref RenderTarget::Flag::HbaoQuarterResolution.
+     */
+    HbaoQuarterResolution = 1 << 6,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -109,9 +123,12 @@ class Renderer {
   /**
    * @brief Enqueue a async draw job.
    *
-   * Jobs are started by a call to @ref startDrawJobs.  Note that after calling
-   * @ref startDrawJobs, you must call @ref waitSceneGraph before doing anything
-   * that changes the scene graph.
+   * Jobs are started by a call to @ref startDrawJobs. The camera pose and
+   * drawable transformations are captured here, so the scene graph can be
+   * moved, e.g. by stepping physics, while the jobs render. Skinned drawables
+   * still read the scene graph while drawing, call @ref waitSceneGraph before
+   * changing it when there are any. Drawables must not be added or removed
+   * until @ref waitDrawJobs.
    */
   void enqueueAsyncDrawJob(sensor::VisualSensor& visualSensor,
                            scene::SceneGraph& sceneGraph,
@@ -122,9 +139,10 @@ class Renderer {
   /**
    * @brief Begins all the draw jobs enqueued by @ref enqueueAsyncDrawJob.
    *
-   * This method implicitly transfers ownership of the OpenGL context and scene
-   * graphs to the thread, use @ref waitSceneGraph and @ref acquireGlContext to
-   * transfer ownership back
+   * This method implicitly transfers ownership of the OpenGL context to the
+   * thread, use @ref acquireGlContext to transfer ownership back. The scene
+   * graphs are only handed over when a job draws skinned drawables, see
+   * @ref enqueueAsyncDrawJob.
    */
   void startDrawJobs();
   /**
@@ -144,7 +162,8 @@ class Renderer {
 
   /**
    * @brief Acquires ownership of the scene graph from the background render
-   * thread. Will block if needed.
+   * thread. Will block if needed, which is only while skinned drawables are
+   * being drawn.
    *
    * The blocking waiting is guarded by an atomic, so if the main thread already
    * has ownership of the scene graph, this method is lock-free and very cheap.
@@ -172,6 +191,124 @@ class Renderer {
    */
   void bindRenderTarget(sensor::VisualSensor& sensor, Flags bindingFlags = {});
 
+  /**
+   * @brief Binds a single @ref RenderTarget to a group of sensors, with the
+   * color, depth and object id attachments their types need, so that
+   * @ref drawFused() renders the observations of all of them in one pass
+   * @param[in] sensors camera sensors sharing resolution and projection
+   *
+   * The sensors are expected to share a pose as well, e.g. by being mounted
+   * at the same spot of an agent. HBAO and debug lines are not drawn into a
+   * fused target, as they would leak into the depth and object id
+   * attachments, and @ref visualize() shouldn't be used on its sensors.
+   *
+   * If all @p sensors are cubemap sensors, such as fisheye and
+   * equirectangular ones, they keep their own targets and share a cubemap
+   * instead, see @ref sensor::CubeMapSensorBase::bindSharedCubeMap(). They
+   * need to share near and far planes, but not resolution or projection.
+   */
+  void bindFusedRenderTarget(
+      const std::vector<sensor::VisualSensor*>& sensors);
+
+  /**
+   * @brief Draw the active scene in current sim once for a group of sensors
+   * bound with @ref bindFusedRenderTarget(). Each sensor then reads its
+   * observation from the shared target as usual. A group of cubemap sensors
+   * renders the shared cubemap once and each sensor draws its observation
+   * from it into its own target.
+   * @param[in] sensors the fused sensor group
+   * @param[in] sim the simulator instance
+   */
+  void drawFused(const std::vector<sensor::VisualSensor*>& sensors,
+                 sim::Simulator& sim);
+
+  /**
+   * @brief Binds tiles of one large @ref RenderTarget to a group of sensors
+   * @param[in] sensors camera sensors of the same type and resolution. They
+   * may belong to different simulators, as long as those share the GL
+   * context.
+   * @return the render target holding all tiles, laid out in a grid in the
+   * order of @p sensors
+   *
+   * Every sensor still draws and reads its observation as usual, but into
+   * its own tile of a shared framebuffer. Once all of them are drawn, the
+   * returned target reads the observations of the whole group back with a
+   * single transfer, see @ref RenderTarget::viewport() for where each one
+   * is. Depth sensors also need to share the depth unprojection, so the
+   * whole depth can be unprojected at once. HBAO is not drawn into tiles.
+   */
+  std::shared_ptr<RenderTarget> bindTiledRenderTarget(
+      const std::vector<sensor::VisualSensor*>& sensors);
+
+  /**
+   * @brief Creates @p tileCount tiles of one large @ref RenderTarget for
+   * observations of a single sensor
+   * @param[in] sensor camera sensor the tiles are made for
+   * @param[in] tileCount number of tiles
+   * @param[out] tiles the tiles, laid out like with
+   * @ref bindTiledRenderTarget()
+   *
+   * Unlike @ref bindTiledRenderTarget(), nothing is bound to @p sensor. It's
+   * meant to be bound to each tile in turn to draw many views of it, which
+   * are then read back from the returned target with a single transfer.
+   */
+  std::shared_ptr<RenderTarget> createTiledRenderTarget(
+      sensor::VisualSensor& sensor,
+      int tileCount,
+      std::vector<std::shared_ptr<RenderTarget>>& tiles);
+
+  /**
+   * @brief Apply the Redwood depth noise model to the depth sensor
+   * observations directly in its render target, see
+   * @ref RenderTarget::setRedwoodDepthNoise()
+   * @param[in] sensor a depth sensor with a render target bound to it, not
+   * a tile of an atlas
+   * @param[in] model the distortion model, 80 rows of 80 x 5 floats
+   * @param[in] noiseMultiplier multiplier of the Gaussian noise
+   * @param[in] seed random seed
+   *
+   * The noise is applied on the GPU while the depth is unprojected, so it
+   * needs neither CUDA nor a pass over the observation on the CPU.
+   */
+  void setRedwoodDepthNoise(sensor::VisualSensor& sensor,
+                            Corrade::Containers::ArrayView<const float> model,
+                            float noiseMultiplier,
+                            unsigned int seed);
+
+  /**
+   * @brief How @ref applyGaussianFiltering() filters the cubemap
+   */
+  enum class GaussianFilterImplementation {
+    /**
+     * Fragment shader passes, two for every face. The default.
+     */
+    Fragment,
+    /**
+     * One compute shader dispatch for all faces in each direction, see
+     * @ref isGaussianFilterComputeSupported()
+     */
+    Compute,
+  };
+
+  /**
+   * @brief Whether the current context supports
+   * @ref GaussianFilterImplementation::Compute, which needs OpenGL 4.3
+   */
+  static bool isGaussianFilterComputeSupported();
+
+  /**
+   * @brief Set the implementation used by @ref applyGaussianFiltering()
+   *
+   * Both use the same kernel. The compute implementation reads and writes
+   * the cubemaps directly instead of copying every face out and drawing it
+   * back.
+   */
+  void setGaussianFilterImplementation(
+      GaussianFilterImplementation implementation);
+
+  /** @brief Implementation used by @ref applyGaussianFiltering() */
+  GaussianFilterImplementation gaussianFilterImplementation() const;
+
   /**
    * @brief apply gaussian filtering to source cubemap and store the result in
    * target cubemap
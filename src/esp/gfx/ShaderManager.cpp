@@ -17,6 +17,7 @@ void setLightSetupForSubTree(scene::SceneNode& root,
       root, [&lightSetup](Drawable& drawable) {
         drawable.setLightSetup(lightSetup);
       });
+  scene::SceneNode::markAppearanceChanged();
 }
 
 }  // namespace gfx
@@ -6,6 +6,7 @@
 #define ESP_GFX_SKINDATA_H_
 
 #include <Magnum/Trade/SkinData.h>
+#include <esp/gfx/BonePalette.h>
 #include <esp/scene/SceneNode.h>
 #include <unordered_map>
 
@@ -37,9 +38,27 @@ struct InstanceSkinData {
   /** @brief Map between skin joint IDs and articulated object transform nodes.
    */
   std::unordered_map<int, const scene::SceneNode*> jointIdToTransformNode{};
+  /** @brief Palette the joint matrices of the instance are packed into. */
+  std::shared_ptr<BonePalette> bonePalette;
+  /** @brief Range of @ref bonePalette holding one matrix per skin joint. */
+  int bonePaletteRange = ID_UNDEFINED;
+  /**
+   * @brief Draw pass the joint matrices were last computed in, shared by all
+   * drawables of the instance. See @ref RenderCamera::drawPass().
+   */
+  uint64_t bonePaletteDrawPass = 0;
+
+  InstanceSkinData(const std::shared_ptr<SkinData>& skinData,
+                   std::shared_ptr<BonePalette> bonePalette)
+      : skinData(skinData),
+        bonePalette(std::move(bonePalette)),
+        bonePaletteRange(
+            this->bonePalette->addRange(skinData->skin->joints().size())) {}
+
+  ~InstanceSkinData() { bonePalette->removeRange(bonePaletteRange); }
 
-  explicit InstanceSkinData(const std::shared_ptr<SkinData>& skinData)
-      : skinData(skinData){};
+  InstanceSkinData(const InstanceSkinData&) = delete;
+  InstanceSkinData& operator=(const InstanceSkinData&) = delete;
 };
 
 /**
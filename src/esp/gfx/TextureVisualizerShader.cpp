@@ -14,6 +14,8 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 
+#include "esp/gfx_batch/ShaderCache.h"
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -68,11 +70,14 @@ TextureVisualizerShader::TextureVisualizerShader(Flags flags) : flags_(flags) {
                                                 : "")
       .addSource(rs.getString("textureVisualizer.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   // setup texture binding point
   setUniform(uniformLocation("sourceTexture"), SourceTextureUnit);
@@ -0,0 +1,267 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TrajectoryRender.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Functions.h>
+#include <algorithm>
+
+#include "TrajectoryShader.h"
+#include "esp/core/Check.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+
+// Resolution of the capsule every segment is drawn with
+constexpr Mn::UnsignedInt CapsuleSegments = 8;
+constexpr Mn::UnsignedInt CapsuleCapRings = 3;
+// Segments reserved for a new trajectory, doubled whenever it fills up
+constexpr std::size_t MinTrajectoryCapacity = 16;
+// Unused segment slots tolerated before trajectories get moved together
+constexpr std::size_t MinCompactedSegments = 4096;
+
+// Rings from the pole of the start cap over the two equators, which form the
+// tube, to the pole of the end cap
+void buildCapsule(Cr::Containers::Array<Mn::Vector4>& vertices,
+                  Cr::Containers::Array<Mn::UnsignedShort>& indices) {
+  Mn::UnsignedInt ringCount = 0;
+  for (Mn::UnsignedInt end = 0; end != 2; ++end) {
+    for (Mn::UnsignedInt i = 0; i <= CapsuleCapRings; ++i) {
+      // -90° to 0° for the start cap, 0° to 90° for the end cap
+      const Mn::Rad latitude{Mn::Deg{
+          90.0f * (float(i) / CapsuleCapRings + float(end) - 1.0f)}};
+      const float z = Mn::Math::sin(latitude);
+      const float ringRadius = Mn::Math::cos(latitude);
+      for (Mn::UnsignedInt j = 0; j != CapsuleSegments; ++j) {
+        const Mn::Rad longitude{Mn::Deg{360.0f * j / CapsuleSegments}};
+        arrayAppend(vertices, Mn::Vector4{ringRadius * Mn::Math::cos(longitude),
+                                          ringRadius * Mn::Math::sin(longitude),
+                                          z, float(end)});
+      }
+      ++ringCount;
+    }
+  }
+
+  for (Mn::UnsignedInt ring = 0; ring + 1 != ringCount; ++ring) {
+    for (Mn::UnsignedInt j = 0; j != CapsuleSegments; ++j) {
+      const Mn::UnsignedShort a = ring * CapsuleSegments + j;
+      const Mn::UnsignedShort b =
+          ring * CapsuleSegments + (j + 1) % CapsuleSegments;
+      const Mn::UnsignedShort c = a + CapsuleSegments;
+      const Mn::UnsignedShort d = b + CapsuleSegments;
+      arrayAppend(indices, {a, b, d, a, d, c});
+    }
+  }
+}
+
+}  // namespace
+
+struct TrajectoryRender::GLResourceSet {
+  Mn::GL::Buffer capsuleVertexBuffer;
+  Mn::GL::Buffer capsuleIndexBuffer;
+  Mn::GL::Buffer segmentBuffer;
+  Mn::GL::Mesh mesh;
+  TrajectoryShader shader;
+  //! Segments the segment buffer has space for
+  std::size_t segmentCapacity = 0;
+
+  GLResourceSet() {
+    Cr::Containers::Array<Mn::Vector4> vertices;
+    Cr::Containers::Array<Mn::UnsignedShort> indices;
+    buildCapsule(vertices, indices);
+    capsuleVertexBuffer.setData(vertices, Mn::GL::BufferUsage::StaticDraw);
+    capsuleIndexBuffer.setData(indices, Mn::GL::BufferUsage::StaticDraw);
+    mesh.setCount(indices.size())
+        .addVertexBuffer(capsuleVertexBuffer, 0, TrajectoryShader::Corner{})
+        .setIndexBuffer(capsuleIndexBuffer, 0,
+                        Mn::GL::MeshIndexType::UnsignedShort)
+        .addVertexBufferInstanced(segmentBuffer, 1, 0, TrajectoryShader::From{},
+                                  TrajectoryShader::To{},
+                                  TrajectoryShader::Color{},
+                                  TrajectoryShader::Radius{});
+  }
+};
+
+TrajectoryRender::TrajectoryRender()
+    : glResources_{std::make_unique<GLResourceSet>()} {}
+
+TrajectoryRender::~TrajectoryRender() = default;
+
+void TrajectoryRender::releaseGLResources() {
+  glResources_ = nullptr;
+}
+
+int TrajectoryRender::addTrajectory(const std::vector<Mn::Vector3>& points,
+                                    const Mn::Color4& color,
+                                    float radius) {
+  ESP_CHECK(radius > 0.0f,
+            "TrajectoryRender::addTrajectory(): expected a positive radius, got"
+                << radius);
+  const int trajectoryId = nextTrajectoryId_++;
+  Trajectory& trajectory = trajectories_[trajectoryId];
+  trajectory = Trajectory{segments_.size(), 0, 0, {}, false, color, radius};
+  relocate(trajectory, std::max(MinTrajectoryCapacity, points.size()));
+  appendPoints(trajectoryId, points);
+  return trajectoryId;
+}
+
+void TrajectoryRender::appendPoints(
+    int trajectoryId,
+    Cr::Containers::ArrayView<const Mn::Vector3> points) {
+  const auto found = trajectories_.find(trajectoryId);
+  ESP_CHECK(found != trajectories_.end(),
+            "TrajectoryRender::appendPoints(): no trajectory with ID"
+                << trajectoryId);
+  Trajectory& trajectory = found->second;
+  for (const Mn::Vector3& point : points) {
+    if (!trajectory.hasPoints) {
+      trajectory.lastPoint = point;
+      trajectory.hasPoints = true;
+      continue;
+    }
+    if (trajectory.segmentCount == trajectory.capacity) {
+      relocate(trajectory, 2 * trajectory.capacity);
+    }
+    const std::size_t index = trajectory.offset + trajectory.segmentCount++;
+    segments_[index] = SegmentRecord{trajectory.lastPoint, point,
+                                     trajectory.color, trajectory.radius};
+    markDirty(index, index + 1);
+    trajectory.lastPoint = point;
+  }
+  compactIfFragmented();
+}
+
+void TrajectoryRender::removeTrajectory(int trajectoryId) {
+  const auto found = trajectories_.find(trajectoryId);
+  ESP_CHECK(found != trajectories_.end(),
+            "TrajectoryRender::removeTrajectory(): no trajectory with ID"
+                << trajectoryId);
+  releaseRange(found->second.offset, found->second.capacity);
+  trajectories_.erase(found);
+  compactIfFragmented();
+}
+
+void TrajectoryRender::clear() {
+  trajectories_.clear();
+  arrayResize(segments_, 0);
+  unusedSegments_ = 0;
+  dirtyBegin_ = dirtyEnd_ = 0;
+  ++revision_;
+}
+
+std::size_t TrajectoryRender::segmentCount() const {
+  std::size_t count = 0;
+  for (const auto& trajectory : trajectories_) {
+    count += trajectory.second.segmentCount;
+  }
+  return count;
+}
+
+void TrajectoryRender::relocate(Trajectory& trajectory,
+                                std::size_t capacity) {
+  const std::size_t offset = segments_.size();
+  arrayResize(segments_, offset + capacity);
+  for (std::size_t i = 0; i != trajectory.segmentCount; ++i) {
+    segments_[offset + i] = segments_[trajectory.offset + i];
+  }
+  releaseRange(trajectory.offset, trajectory.capacity);
+  trajectory.offset = offset;
+  trajectory.capacity = capacity;
+  // the whole range, as the buffer may hold stale segments past the end
+  markDirty(offset, offset + capacity);
+}
+
+void TrajectoryRender::releaseRange(std::size_t offset, std::size_t capacity) {
+  for (std::size_t i = offset; i != offset + capacity; ++i) {
+    segments_[i] = SegmentRecord{};
+  }
+  unusedSegments_ += capacity;
+  markDirty(offset, offset + capacity);
+}
+
+void TrajectoryRender::compactIfFragmented() {
+  if (unusedSegments_ < MinCompactedSegments ||
+      2 * unusedSegments_ < segments_.size()) {
+    return;
+  }
+  Cr::Containers::Array<SegmentRecord> compacted;
+  arrayReserve(compacted, segments_.size() - unusedSegments_);
+  for (auto& item : trajectories_) {
+    Trajectory& trajectory = item.second;
+    const std::size_t offset = compacted.size();
+    arrayAppend(compacted,
+                segments_.sliceSize(trajectory.offset, trajectory.capacity));
+    trajectory.offset = offset;
+  }
+  segments_ = std::move(compacted);
+  unusedSegments_ = 0;
+  dirtyBegin_ = dirtyEnd_ = 0;
+  markDirty(0, segments_.size());
+}
+
+void TrajectoryRender::markDirty(std::size_t begin, std::size_t end) {
+  if (dirtyBegin_ == dirtyEnd_) {
+    dirtyBegin_ = begin;
+    dirtyEnd_ = end;
+  } else {
+    dirtyBegin_ = std::min(dirtyBegin_, begin);
+    dirtyEnd_ = std::max(dirtyEnd_, end);
+  }
+  ++revision_;
+}
+
+void TrajectoryRender::draw(const Mn::Matrix4& viewMatrix,
+                            const Mn::Matrix4& projectionMatrix) {
+  CORRADE_ASSERT(glResources_,
+                 "TrajectoryRender::draw: no GL resources; see "
+                 "also releaseGLResources", );
+  if (segments_.isEmpty()) {
+    return;
+  }
+
+  GLResourceSet& gl = *glResources_;
+  if (segments_.size() > gl.segmentCapacity) {
+    // grow along with the segment array, so appending points reallocates
+    // the buffer only rarely
+    gl.segmentCapacity = arrayCapacity(segments_);
+    gl.segmentBuffer.setData(
+        {nullptr, gl.segmentCapacity * sizeof(SegmentRecord)},
+        Mn::GL::BufferUsage::DynamicDraw);
+    dirtyBegin_ = 0;
+    dirtyEnd_ = segments_.size();
+  }
+  if (dirtyBegin_ != dirtyEnd_) {
+    gl.segmentBuffer.setSubData(dirtyBegin_ * sizeof(SegmentRecord),
+                                segments_.slice(dirtyBegin_, dirtyEnd_));
+    dirtyBegin_ = dirtyEnd_ = 0;
+  }
+
+  // the capsule triangles aren't consistently wound
+  const bool doToggleFaceCulling = glIsEnabled(GL_CULL_FACE);
+  if (doToggleFaceCulling) {
+    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+
+  gl.mesh.setInstanceCount(Mn::Int(segments_.size()));
+  gl.shader.setViewMatrix(viewMatrix)
+      .setProjectionMatrix(projectionMatrix)
+      .draw(gl.mesh);
+
+  if (doToggleFaceCulling) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+}
+
+}  // namespace gfx
+}  // namespace esp
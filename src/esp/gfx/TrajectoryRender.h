@@ -0,0 +1,156 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_TRAJECTORYRENDER_H_
+#define ESP_GFX_TRAJECTORYRENDER_H_
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Draws trajectories as tubes without creating render assets for them.
+ *
+ * Unlike trajectory objects made by @ref sim::Simulator::addTrajectoryObject(),
+ * which build a new tube mesh, material and render asset each, trajectories
+ * here are just polylines. All their segments are kept in a single buffer and
+ * drawn as instances of one shared capsule mesh, so adding hundreds of
+ * trajectories or appending points to them every step only uploads the
+ * segments that changed. Trajectories are drawn into color sensors only, they
+ * aren't part of the scene graph.
+ */
+class TrajectoryRender {
+ public:
+  /**
+   * @brief Constructor. This allocates GPU resources so it should persist
+   * frame-to-frame.
+   */
+  TrajectoryRender();
+
+  ~TrajectoryRender();
+
+  /** @brief Copying is not allowed */
+  TrajectoryRender(const TrajectoryRender&) = delete;
+
+  /** @brief Copying is not allowed */
+  TrajectoryRender& operator=(const TrajectoryRender&) = delete;
+
+  /** @brief Release GPU resources */
+  void releaseGLResources();
+
+  /**
+   * @brief Add a trajectory
+   * @param points  Points of the trajectory so far, more can be added with
+   *    @ref appendPoints()
+   * @param color   Tube color
+   * @param radius  Tube radius
+   * @return ID of the trajectory, never reused
+   */
+  int addTrajectory(const std::vector<Magnum::Vector3>& points,
+                    const Magnum::Color4& color,
+                    float radius);
+
+  /**
+   * @brief Append points to the end of trajectory @p trajectoryId
+   *
+   * Only the new segments are uploaded on the next @ref draw().
+   */
+  void appendPoints(
+      int trajectoryId,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> points);
+
+  /** @overload */
+  void appendPoints(int trajectoryId,
+                    const std::vector<Magnum::Vector3>& points) {
+    appendPoints(trajectoryId,
+                 Corrade::Containers::arrayView(points.data(), points.size()));
+  }
+
+  /** @brief Remove trajectory @p trajectoryId */
+  void removeTrajectory(int trajectoryId);
+
+  /** @brief Remove all trajectories */
+  void clear();
+
+  /** @brief Whether trajectory @p trajectoryId exists */
+  bool hasTrajectory(int trajectoryId) const {
+    return trajectories_.count(trajectoryId) != 0;
+  }
+
+  /** @brief Number of trajectories */
+  std::size_t trajectoryCount() const { return trajectories_.size(); }
+
+  /** @brief Number of segments of all trajectories */
+  std::size_t segmentCount() const;
+
+  /**
+   * @brief Counter incremented on every change of the trajectories, for
+   * telling whether a previously drawn image is still up to date
+   */
+  std::uint64_t revision() const { return revision_; }
+
+  /**
+   * @brief Upload the segments changed since the last call and draw all
+   * trajectories into the current framebuffer
+   */
+  void draw(const Magnum::Matrix4& viewMatrix,
+            const Magnum::Matrix4& projectionMatrix);
+
+ private:
+  //! One instance of the trajectory shader, laid out as its per-instance
+  //! attributes
+  struct SegmentRecord {
+    Magnum::Vector3 from;
+    Magnum::Vector3 to;
+    Magnum::Color4 color;
+    //! Zero for slots not holding a segment, which makes them invisible
+    float radius;
+  };
+
+  struct Trajectory {
+    //! Range of segments_ reserved for the trajectory
+    std::size_t offset;
+    std::size_t capacity;
+    std::size_t segmentCount;
+    Magnum::Vector3 lastPoint;
+    bool hasPoints;
+    Magnum::Color4 color;
+    float radius;
+  };
+
+  struct GLResourceSet;
+
+  //! Move a trajectory to a new range at the end of segments_
+  void relocate(Trajectory& trajectory, std::size_t capacity);
+  //! Clear the segments of a range no trajectory uses anymore
+  void releaseRange(std::size_t offset, std::size_t capacity);
+  //! Move all trajectories next to each other once too much space is unused
+  void compactIfFragmented();
+  void markDirty(std::size_t begin, std::size_t end);
+
+  std::unique_ptr<GLResourceSet> glResources_;
+  std::unordered_map<int, Trajectory> trajectories_;
+  int nextTrajectoryId_ = 0;
+  Corrade::Containers::Array<SegmentRecord> segments_;
+  //! Slots of segments_ not reserved by any trajectory
+  std::size_t unusedSegments_ = 0;
+  //! Range of segments_ changed since the last upload
+  std::size_t dirtyBegin_ = 0;
+  std::size_t dirtyEnd_ = 0;
+  std::uint64_t revision_ = 0;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_TRAJECTORYRENDER_H_
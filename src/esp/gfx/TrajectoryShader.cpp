@@ -0,0 +1,83 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TrajectoryShader.h"
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/gfx_batch/ShaderCache.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+static void importShaderResources() {
+  CORRADE_RESOURCE_INITIALIZE(GfxShaderResources)
+}
+
+namespace esp {
+namespace gfx {
+
+TrajectoryShader::TrajectoryShader() {
+  if (!Corrade::Utility::Resource::hasGroup("gfx-shaders")) {
+    importShaderResources();
+  }
+
+  const Corrade::Utility::Resource rs{"gfx-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  vert.addSource(Cr::Utility::formatString(
+                     "#define ATTRIBUTE_LOCATION_CORNER {}\n"
+                     "#define ATTRIBUTE_LOCATION_FROM {}\n"
+                     "#define ATTRIBUTE_LOCATION_TO {}\n"
+                     "#define ATTRIBUTE_LOCATION_COLOR {}\n"
+                     "#define ATTRIBUTE_LOCATION_RADIUS {}\n",
+                     Corner::Location, From::Location, To::Location,
+                     Color::Location, Radius::Location))
+      .addSource(rs.getString("trajectory.vert"));
+
+  frag.addSource(Cr::Utility::formatString(
+                     "#define OUTPUT_ATTRIBUTE_LOCATION_COLOR {}\n",
+                     ColorOutput))
+      .addSource(rs.getString("trajectory.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(gfx_batch::linkCachedShaderProgram(
+      *this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
+
+  viewMatrixUniform_ = uniformLocation("ViewMatrix");
+  projectionMatrixUniform_ = uniformLocation("ProjectionMatrix");
+  CORRADE_INTERNAL_ASSERT(viewMatrixUniform_ >= 0 &&
+                          projectionMatrixUniform_ >= 0);
+}
+
+TrajectoryShader& TrajectoryShader::setViewMatrix(const Mn::Matrix4& matrix) {
+  setUniform(viewMatrixUniform_, matrix);
+  return *this;
+}
+
+TrajectoryShader& TrajectoryShader::setProjectionMatrix(
+    const Mn::Matrix4& matrix) {
+  setUniform(projectionMatrixUniform_, matrix);
+  return *this;
+}
+
+}  // namespace gfx
+}  // namespace esp
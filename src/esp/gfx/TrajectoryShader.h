@@ -0,0 +1,77 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_TRAJECTORYSHADER_H_
+#define ESP_GFX_TRAJECTORYSHADER_H_
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Shaders/GenericGL.h>
+
+namespace esp {
+namespace gfx {
+
+/**
+@brief Shader drawing trajectories as tubes, used by @ref TrajectoryRender
+
+Each trajectory segment is one instance of a unit capsule mesh made of
+@ref Corner vertices, placed around the segment by the vertex shader. Tubes
+are lit by a headlight and not by the scene lights.
+*/
+class TrajectoryShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  /**
+   * @brief Vertex of the unit capsule shared by all instances. XYZ is the
+   * offset from the segment axis in units of the radius, with Z along the
+   * segment, W is @cpp 0.0f @ce at the segment start and @cpp 1.0f @ce at its
+   * end.
+   */
+  typedef Magnum::GL::Attribute<0, Magnum::Vector4> Corner;
+
+  /** @brief Segment start, per instance */
+  typedef Magnum::GL::Attribute<1, Magnum::Vector3> From;
+
+  /** @brief Segment end, per instance */
+  typedef Magnum::GL::Attribute<2, Magnum::Vector3> To;
+
+  /** @brief Segment color, per instance */
+  typedef Magnum::GL::Attribute<3, Magnum::Vector4> Color;
+
+  /** @brief Tube radius, per instance */
+  typedef Magnum::GL::Attribute<4, Magnum::Float> Radius;
+
+  enum : Magnum::UnsignedInt {
+    /**
+     * Color shader output. @ref shaders-generic "Generic output",
+     * present always. Expects three- or four-component floating-point
+     * or normalized buffer attachment.
+     */
+    ColorOutput = Magnum::Shaders::GenericGL3D::ColorOutput,
+  };
+
+  /** @brief Constructor */
+  explicit TrajectoryShader();
+
+  /**
+   * @brief Set view matrix
+   * @return Reference to self (for method chaining)
+   */
+  TrajectoryShader& setViewMatrix(const Magnum::Matrix4& matrix);
+
+  /**
+   * @brief Set projection matrix
+   * @return Reference to self (for method chaining)
+   */
+  TrajectoryShader& setProjectionMatrix(const Magnum::Matrix4& matrix);
+
+ private:
+  GLint viewMatrixUniform_ = -1;
+  GLint projectionMatrixUniform_ = -1;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif
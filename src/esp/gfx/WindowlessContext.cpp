@@ -87,6 +87,11 @@ struct WindowlessContext::Impl {
 
   int gpuDevice() const { return device_; }
 
+  bool isCurrent() const {
+    return Mn::GL::Context::hasCurrent() &&
+           &Mn::GL::Context::current() == &magnumGLContext_;
+  }
+
  private:
   int device_;
   Mn::Platform::GLContext magnumGLContext_;
@@ -116,5 +121,67 @@ int WindowlessContext::gpuDevice() const {
   return pimpl_->gpuDevice();
 }
 
+bool WindowlessContext::isCurrent() const {
+  return pimpl_->isCurrent();
+}
+
+void WindowlessContextPool::Returner::operator()(
+    WindowlessContext* context) const {
+  WindowlessContextPool::instance().giveBack(context);
+}
+
+WindowlessContextPool& WindowlessContextPool::instance() {
+  static WindowlessContextPool* pool = new WindowlessContextPool;
+  return *pool;
+}
+
+WindowlessContextPool::Borrowed WindowlessContextPool::acquire(
+    int gpuDevice) {
+  WindowlessContext::uptr context;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto found = idle_.find(gpuDevice);
+    if (found != idle_.end() && !found->second.empty()) {
+      context = std::move(found->second.back());
+      found->second.pop_back();
+    }
+  }
+
+  if (context) {
+    context->makeCurrent();
+  } else {
+    // made current by the constructor
+    context = WindowlessContext::create_unique(gpuDevice);
+  }
+  return Borrowed{context.release()};
+}
+
+void WindowlessContextPool::giveBack(WindowlessContext* context) {
+  if (!context) {
+    return;
+  }
+  // if another context is current, leave it be
+  if (context->isCurrent()) {
+    context->release();
+  }
+  std::lock_guard<std::mutex> lock{mutex_};
+  idle_[context->gpuDevice()].emplace_back(context);
+}
+
+std::size_t WindowlessContextPool::idleContextCount(int gpuDevice) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto found = idle_.find(gpuDevice);
+  return found == idle_.end() ? 0 : found->second.size();
+}
+
+void WindowlessContextPool::clear() {
+  std::unordered_map<int, std::vector<WindowlessContext::uptr>> idle;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    idle.swap(idle_);
+  }
+  // destroyed outside of the lock, context teardown can take a while
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -5,6 +5,11 @@
 #ifndef ESP_GFX_WINDOWLESSCONTEXT_H_
 #define ESP_GFX_WINDOWLESSCONTEXT_H_
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "esp/core/Esp.h"
 
 namespace esp {
@@ -24,9 +29,65 @@ class WindowlessContext {
 
   int gpuDevice() const;
 
+  /** @brief Whether this context is current in the calling thread */
+  bool isCurrent() const;
+
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(WindowlessContext)
 };
 
+/**
+ * @brief Process-wide pool of windowless contexts, kept per GPU device
+ *
+ * Creating a GL context and destroying it again is slow, and some drivers
+ * don't free everything on destruction. Simulators and replay renderers,
+ * which long-lived processes may create and close many times over, borrow
+ * their context from here and give it back once they're done, so each
+ * device only ever gets as many contexts as are in use at the same time.
+ *
+ * A borrowed context is current in the calling thread. Everything created
+ * with it has to be destroyed before it's given back, as the next borrower
+ * gets the context as-is.
+ */
+class WindowlessContextPool {
+ public:
+  /** @brief Deleter giving a borrowed context back to the pool */
+  struct Returner {
+    void operator()(WindowlessContext* context) const;
+  };
+
+  /** @brief Borrowed context, given back to the pool on destruction */
+  typedef std::unique_ptr<WindowlessContext, Returner> Borrowed;
+
+  /**
+   * @brief The global pool
+   *
+   * Never destroyed, so contexts still borrowed at exit can be given back
+   * without depending on the order of static destruction.
+   */
+  static WindowlessContextPool& instance();
+
+  /**
+   * @brief Borrow a context for @p gpuDevice, creating one if none is idle
+   *
+   * The context is made current in the calling thread.
+   */
+  Borrowed acquire(int gpuDevice);
+
+  /** @brief Number of idle contexts for @p gpuDevice */
+  std::size_t idleContextCount(int gpuDevice) const;
+
+  /** @brief Destroy all idle contexts, borrowed ones aren't affected */
+  void clear();
+
+ private:
+  WindowlessContextPool() = default;
+
+  void giveBack(WindowlessContext* context);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<int, std::vector<WindowlessContext::uptr>> idle_;
+};
+
 }  // namespace gfx
 }  // namespace esp
 
@@ -0,0 +1,593 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BinaryKeyframes.h"
+
+#include <Magnum/Math/Functions.h>
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+/*
+  Layout, all multi-byte scalars little-endian:
+
+    header      magic, version byte, flags varint, translation precision f32
+    keyframes   varint count, then for each keyframe varint-counted lists of
+                loads, rig creations, creations, deletions, state updates,
+                rig updates, user transforms, then a lightsChanged byte with
+                an optional varint-counted list of lights
+
+  After the rig ID, rig updates have the varint-counted words of
+  RigUpdate::changedBones (since version 2) and a varint bone count. State
+  updates and every bone of a rig update start with a change mask byte,
+  followed by a zigzag varint delta for every quantized translation, rotation
+  (and semantic ID) component whose mask bit is set. The delta reference is
+  the previous update of the same instance key or rig bone within the blob,
+  or zero.
+
+  No flags are defined yet; they're reserved for payload compression.
+*/
+constexpr char Magic[]{'H', 'S', 'R', 'K'};
+constexpr std::uint8_t Version = 2;
+
+// 16-bit signed quaternion components
+constexpr float RotationScale = 32767.0f;
+constexpr std::uint8_t SemanticIdBit = 1 << 7;
+
+enum : std::uint8_t {
+  AssetForceFlatShading = 1 << 0,
+  AssetSplitInstanceMesh = 1 << 1,
+  AssetOverridePhongMaterial = 1 << 2,
+  AssetHasSemanticTextures = 1 << 3
+};
+
+struct QuantizedTransform {
+  std::int64_t translation[3]{};
+  std::int32_t rotation[4]{};
+};
+
+struct QuantizedState {
+  QuantizedTransform transform;
+  int semanticId = ID_UNDEFINED;
+};
+
+QuantizedTransform quantize(const Transform& transform, float precision) {
+  QuantizedTransform q;
+  for (std::size_t i = 0; i != 3; ++i) {
+    q.translation[i] = std::llround(transform.translation[i] / precision);
+  }
+  const Mn::Vector4 rotation{transform.rotation.vector(),
+                             transform.rotation.scalar()};
+  for (std::size_t i = 0; i != 4; ++i) {
+    q.rotation[i] = std::int32_t(
+        std::lround(Mn::Math::clamp(rotation[i], -1.0f, 1.0f) * RotationScale));
+  }
+  return q;
+}
+
+Transform dequantize(const QuantizedTransform& q, float precision) {
+  Transform transform;
+  for (std::size_t i = 0; i != 3; ++i) {
+    transform.translation[i] = float(double(q.translation[i]) * precision);
+  }
+  const Mn::Quaternion rotation{
+      {float(q.rotation[0]), float(q.rotation[1]), float(q.rotation[2])},
+      float(q.rotation[3])};
+  const float length = rotation.length();
+  transform.rotation = length > 0.0f ? rotation / length : Mn::Quaternion{};
+  return transform;
+}
+
+std::uint8_t changeMask(const QuantizedTransform& q,
+                        const QuantizedTransform& prev) {
+  std::uint8_t mask = 0;
+  for (std::size_t i = 0; i != 3; ++i) {
+    if (q.translation[i] != prev.translation[i]) {
+      mask |= 1 << i;
+    }
+  }
+  for (std::size_t i = 0; i != 4; ++i) {
+    if (q.rotation[i] != prev.rotation[i]) {
+      mask |= 1 << (3 + i);
+    }
+  }
+  return mask;
+}
+
+class Writer {
+ public:
+  void u8(std::uint8_t value) { out_.push_back(char(value)); }
+
+  void varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      u8(std::uint8_t(value | 0x80));
+      value >>= 7;
+    }
+    u8(std::uint8_t(value));
+  }
+
+  void svarint(std::int64_t value) {
+    varint((std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+  }
+
+  void f32(float value) {
+    char bytes[sizeof(float)];
+    std::memcpy(bytes, &value, sizeof(float));
+    out_.append(bytes, sizeof(float));
+  }
+
+  template <std::size_t size, class T>
+  void floats(const Mn::Math::Vector<size, T>& value) {
+    for (std::size_t i = 0; i != size; ++i) {
+      f32(value[i]);
+    }
+  }
+
+  void floats(const vec3f& value) {
+    for (Eigen::Index i = 0; i != 3; ++i) {
+      f32(value[i]);
+    }
+  }
+
+  void string(const std::string& value) {
+    varint(value.size());
+    out_.append(value);
+  }
+
+  void transformDelta(std::uint8_t mask,
+                      const QuantizedTransform& q,
+                      QuantizedTransform& prev) {
+    for (std::size_t i = 0; i != 3; ++i) {
+      if (mask & (1 << i)) {
+        svarint(q.translation[i] - prev.translation[i]);
+      }
+    }
+    for (std::size_t i = 0; i != 4; ++i) {
+      if (mask & (1 << (3 + i))) {
+        svarint(std::int64_t(q.rotation[i]) - prev.rotation[i]);
+      }
+    }
+    prev = q;
+  }
+
+  std::string& out() { return out_; }
+
+ private:
+  std::string out_;
+};
+
+/* Reads past the end or malformed varints set the failure flag and return
+   zeros, so decoding can run to the end of a section and get checked once */
+class Reader {
+ public:
+  explicit Reader(Cr::Containers::StringView data) : data_{data} {}
+
+  bool failed() const { return failed_; }
+
+  std::uint8_t u8() {
+    if (data_.isEmpty()) {
+      failed_ = true;
+      return 0;
+    }
+    const auto value = std::uint8_t(data_[0]);
+    data_ = data_.exceptPrefix(1);
+    return value;
+  }
+
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      const std::uint8_t byte = u8();
+      value |= std::uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    failed_ = true;
+    return 0;
+  }
+
+  std::int64_t svarint() {
+    const std::uint64_t value = varint();
+    return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+  }
+
+  // Upper bound on an element count, so corrupted data can't trigger a huge
+  // allocation. Every element takes at least one byte.
+  std::size_t count() {
+    const std::uint64_t value = varint();
+    if (value > data_.size()) {
+      failed_ = true;
+      return 0;
+    }
+    return std::size_t(value);
+  }
+
+  float f32() {
+    if (data_.size() < sizeof(float)) {
+      failed_ = true;
+      data_ = {};
+      return 0.0f;
+    }
+    float value;
+    std::memcpy(&value, data_.data(), sizeof(float));
+    data_ = data_.exceptPrefix(sizeof(float));
+    return value;
+  }
+
+  template <class T>
+  T floats() {
+    T value;
+    for (std::size_t i = 0; i != T::Size; ++i) {
+      value[i] = f32();
+    }
+    return value;
+  }
+
+  vec3f vec3() {
+    vec3f value;
+    for (Eigen::Index i = 0; i != 3; ++i) {
+      value[i] = f32();
+    }
+    return value;
+  }
+
+  std::string string() {
+    const std::size_t size = count();
+    std::string value{data_.data(), size};
+    data_ = data_.exceptPrefix(size);
+    return value;
+  }
+
+  void transformDelta(std::uint8_t mask, QuantizedTransform& prev) {
+    for (std::size_t i = 0; i != 3; ++i) {
+      if (mask & (1 << i)) {
+        prev.translation[i] += svarint();
+      }
+    }
+    for (std::size_t i = 0; i != 4; ++i) {
+      if (mask & (1 << (3 + i))) {
+        prev.rotation[i] += std::int32_t(svarint());
+      }
+    }
+  }
+
+ private:
+  Cr::Containers::StringView data_;
+  bool failed_ = false;
+};
+
+void writeAssetInfo(Writer& w, const assets::AssetInfo& info) {
+  w.varint(std::uint32_t(info.type));
+  w.string(info.filepath);
+  w.floats(info.frame.up());
+  w.floats(info.frame.front());
+  w.floats(info.frame.origin());
+  w.f32(info.virtualUnitToMeters);
+  w.u8((info.forceFlatShading ? AssetForceFlatShading : 0) |
+       (info.splitInstanceMesh ? AssetSplitInstanceMesh : 0) |
+       (info.overridePhongMaterial ? AssetOverridePhongMaterial : 0) |
+       (info.hasSemanticTextures ? AssetHasSemanticTextures : 0));
+  if (info.overridePhongMaterial) {
+    w.floats(info.overridePhongMaterial->ambientColor);
+    w.floats(info.overridePhongMaterial->diffuseColor);
+    w.floats(info.overridePhongMaterial->specularColor);
+  }
+  w.svarint(int(info.shaderTypeToUse));
+}
+
+assets::AssetInfo readAssetInfo(Reader& r) {
+  assets::AssetInfo info;
+  info.type = assets::AssetType(r.varint());
+  info.filepath = r.string();
+  const vec3f up = r.vec3();
+  const vec3f front = r.vec3();
+  const vec3f origin = r.vec3();
+  info.frame = geo::CoordinateFrame{up, front, origin};
+  info.virtualUnitToMeters = r.f32();
+  const std::uint8_t bits = r.u8();
+  info.forceFlatShading = bits & AssetForceFlatShading;
+  info.splitInstanceMesh = bits & AssetSplitInstanceMesh;
+  info.hasSemanticTextures = bits & AssetHasSemanticTextures;
+  if (bits & AssetOverridePhongMaterial) {
+    info.overridePhongMaterial = assets::PhongMaterialColor{};
+    info.overridePhongMaterial->ambientColor = r.floats<Mn::Color4>();
+    info.overridePhongMaterial->diffuseColor = r.floats<Mn::Color4>();
+    info.overridePhongMaterial->specularColor = r.floats<Mn::Color4>();
+  }
+  info.shaderTypeToUse =
+      metadata::attributes::ObjectInstanceShaderType(r.svarint());
+  return info;
+}
+
+void writeCreation(Writer& w,
+                   const assets::RenderAssetInstanceCreationInfo& creation) {
+  w.string(creation.filepath);
+  w.u8(bool(creation.scale));
+  if (creation.scale) {
+    w.floats(*creation.scale);
+  }
+  w.varint(static_cast<unsigned int>(creation.flags));
+  w.string(creation.lightSetupKey);
+  w.svarint(creation.rigId);
+}
+
+assets::RenderAssetInstanceCreationInfo readCreation(Reader& r) {
+  using Creation = assets::RenderAssetInstanceCreationInfo;
+  Creation creation;
+  creation.filepath = r.string();
+  if (r.u8()) {
+    creation.scale = r.floats<Mn::Vector3>();
+  }
+  creation.flags = Creation::Flags{Creation::Flag(r.varint())};
+  creation.lightSetupKey = r.string();
+  creation.rigId = int(r.svarint());
+  return creation;
+}
+
+}  // namespace
+
+bool isBinaryKeyframeData(const Cr::Containers::StringView data) {
+  return data.hasPrefix({Magic, sizeof(Magic)});
+}
+
+std::string keyframesToBinary(const std::vector<Keyframe>& keyframes,
+                              const float translationPrecision) {
+  Writer w;
+  w.out().append(Magic, sizeof(Magic));
+  w.u8(Version);
+  w.varint(0);
+  w.f32(translationPrecision);
+
+  std::unordered_map<RenderAssetInstanceKey, QuantizedState> instanceStates;
+  std::unordered_map<int, std::vector<QuantizedTransform>> rigPoses;
+
+  w.varint(keyframes.size());
+  for (const Keyframe& keyframe : keyframes) {
+    w.varint(keyframe.loads.size());
+    for (const assets::AssetInfo& load : keyframe.loads) {
+      writeAssetInfo(w, load);
+    }
+
+    w.varint(keyframe.rigCreations.size());
+    for (const RigCreation& rig : keyframe.rigCreations) {
+      w.svarint(rig.id);
+      w.varint(rig.boneNames.size());
+      for (const std::string& name : rig.boneNames) {
+        w.string(name);
+      }
+    }
+
+    RenderAssetInstanceKey prevKey = 0;
+    w.varint(keyframe.creations.size());
+    for (const auto& pair : keyframe.creations) {
+      w.svarint(std::int64_t(pair.first) - prevKey);
+      prevKey = pair.first;
+      writeCreation(w, pair.second);
+    }
+
+    prevKey = 0;
+    w.varint(keyframe.deletions.size());
+    for (const RenderAssetInstanceKey key : keyframe.deletions) {
+      w.svarint(std::int64_t(key) - prevKey);
+      prevKey = key;
+      instanceStates.erase(key);
+    }
+
+    prevKey = 0;
+    w.varint(keyframe.stateUpdates.size());
+    for (const auto& pair : keyframe.stateUpdates) {
+      w.svarint(std::int64_t(pair.first) - prevKey);
+      prevKey = pair.first;
+
+      QuantizedState& prev = instanceStates[pair.first];
+      const QuantizedTransform q =
+          quantize(pair.second.absTransform, translationPrecision);
+      const std::uint8_t mask =
+          changeMask(q, prev.transform) |
+          (pair.second.semanticId != prev.semanticId ? SemanticIdBit : 0);
+      w.u8(mask);
+      w.transformDelta(mask, q, prev.transform);
+      if (mask & SemanticIdBit) {
+        w.svarint(std::int64_t(pair.second.semanticId) - prev.semanticId);
+        prev.semanticId = pair.second.semanticId;
+      }
+    }
+
+    w.varint(keyframe.rigUpdates.size());
+    for (const RigUpdate& rig : keyframe.rigUpdates) {
+      w.svarint(rig.id);
+      w.varint(rig.changedBones.size());
+      for (const std::uint32_t word : rig.changedBones) {
+        w.varint(word);
+      }
+      w.varint(rig.pose.boneCount());
+      std::vector<QuantizedTransform>& prevPose = rigPoses[rig.id];
+      const std::size_t maskedBoneCount = rig.changedBones.size() * 32;
+      std::size_t bone = 0;
+      for (std::size_t i = 0; i != rig.pose.boneCount(); ++i, ++bone) {
+        while (bone < maskedBoneCount && !rig.isBoneChanged(bone)) {
+          ++bone;
+        }
+        if (prevPose.size() <= bone) {
+          prevPose.resize(bone + 1);
+        }
+        const QuantizedTransform q = quantize(
+            {rig.pose.translations[i], rig.pose.rotations[i]},
+            translationPrecision);
+        const std::uint8_t mask = changeMask(q, prevPose[bone]);
+        w.u8(mask);
+        w.transformDelta(mask, q, prevPose[bone]);
+      }
+    }
+
+    w.varint(keyframe.userTransforms.size());
+    for (const auto& pair : keyframe.userTransforms) {
+      w.string(pair.first);
+      w.floats(pair.second.translation);
+      w.floats(pair.second.rotation.vector());
+      w.f32(pair.second.rotation.scalar());
+    }
+
+    w.u8(keyframe.lightsChanged);
+    if (keyframe.lightsChanged) {
+      w.varint(keyframe.lights.size());
+      for (const LightInfo& light : keyframe.lights) {
+        w.floats(light.vector);
+        w.floats(light.color);
+        w.varint(std::uint32_t(light.model));
+      }
+    }
+  }
+
+  return std::move(w.out());
+}
+
+bool keyframesFromBinary(const Cr::Containers::StringView data,
+                         std::vector<Keyframe>& keyframes) {
+  if (!isBinaryKeyframeData(data)) {
+    return false;
+  }
+  Reader r{data.exceptPrefix(sizeof(Magic))};
+  const std::uint8_t version = r.u8();
+  if (version < 1 || version > Version || r.varint() != 0) {
+    return false;
+  }
+  const float translationPrecision = r.f32();
+  if (r.failed() || !(translationPrecision > 0.0f)) {
+    return false;
+  }
+
+  std::unordered_map<RenderAssetInstanceKey, QuantizedState> instanceStates;
+  std::unordered_map<int, std::vector<QuantizedTransform>> rigPoses;
+
+  std::vector<Keyframe> decoded(r.count());
+  for (Keyframe& keyframe : decoded) {
+    keyframe.loads.resize(r.count());
+    for (assets::AssetInfo& load : keyframe.loads) {
+      load = readAssetInfo(r);
+    }
+
+    keyframe.rigCreations.resize(r.count());
+    for (RigCreation& rig : keyframe.rigCreations) {
+      rig.id = int(r.svarint());
+      rig.boneNames.resize(r.count());
+      for (std::string& name : rig.boneNames) {
+        name = r.string();
+      }
+    }
+
+    std::int64_t prevKey = 0;
+    keyframe.creations.resize(r.count());
+    for (auto& pair : keyframe.creations) {
+      prevKey += r.svarint();
+      pair.first = RenderAssetInstanceKey(prevKey);
+      pair.second = readCreation(r);
+    }
+
+    prevKey = 0;
+    keyframe.deletions.resize(r.count());
+    for (RenderAssetInstanceKey& key : keyframe.deletions) {
+      prevKey += r.svarint();
+      key = RenderAssetInstanceKey(prevKey);
+      instanceStates.erase(key);
+    }
+
+    prevKey = 0;
+    keyframe.stateUpdates.resize(r.count());
+    for (auto& pair : keyframe.stateUpdates) {
+      prevKey += r.svarint();
+      pair.first = RenderAssetInstanceKey(prevKey);
+
+      QuantizedState& prev = instanceStates[pair.first];
+      const std::uint8_t mask = r.u8();
+      r.transformDelta(mask, prev.transform);
+      if (mask & SemanticIdBit) {
+        prev.semanticId += int(r.svarint());
+      }
+      pair.second.absTransform =
+          dequantize(prev.transform, translationPrecision);
+      pair.second.semanticId = prev.semanticId;
+    }
+
+    keyframe.rigUpdates.resize(r.count());
+    for (RigUpdate& rig : keyframe.rigUpdates) {
+      rig.id = int(r.svarint());
+      // version 1 had no partial rig updates
+      if (version >= 2) {
+        rig.changedBones.resize(r.count());
+        for (std::uint32_t& word : rig.changedBones) {
+          word = std::uint32_t(r.varint());
+        }
+      }
+      const std::size_t boneCount = r.count();
+      rig.pose.translations.resize(boneCount);
+      rig.pose.rotations.resize(boneCount);
+      std::vector<QuantizedTransform>& prevPose = rigPoses[rig.id];
+      const std::size_t maskedBoneCount = rig.changedBones.size() * 32;
+      std::size_t bone = 0;
+      for (std::size_t i = 0; i != boneCount && !r.failed(); ++i, ++bone) {
+        while (bone < maskedBoneCount && !rig.isBoneChanged(bone)) {
+          ++bone;
+        }
+        if (rig.isPartial() && bone == maskedBoneCount) {
+          return false;
+        }
+        if (prevPose.size() <= bone) {
+          prevPose.resize(bone + 1);
+        }
+        r.transformDelta(r.u8(), prevPose[bone]);
+        const Transform transform =
+            dequantize(prevPose[bone], translationPrecision);
+        rig.pose.translations[i] = transform.translation;
+        rig.pose.rotations[i] = transform.rotation;
+      }
+    }
+
+    for (std::size_t i = 0, count = r.count(); i != count; ++i) {
+      std::string name = r.string();
+      Transform transform;
+      transform.translation = r.floats<Mn::Vector3>();
+      transform.rotation.vector() = r.floats<Mn::Vector3>();
+      transform.rotation.scalar() = r.f32();
+      keyframe.userTransforms[std::move(name)] = transform;
+    }
+
+    keyframe.lightsChanged = r.u8();
+    if (keyframe.lightsChanged) {
+      keyframe.lights.resize(r.count());
+      for (LightInfo& light : keyframe.lights) {
+        light.vector = r.floats<Mn::Vector4>();
+        light.color = r.floats<Mn::Color3>();
+        light.model = LightPositionModel(r.varint());
+      }
+    }
+
+    if (r.failed()) {
+      return false;
+    }
+  }
+
+  if (r.failed()) {
+    return false;
+  }
+  keyframes.insert(keyframes.end(), std::make_move_iterator(decoded.begin()),
+                   std::make_move_iterator(decoded.end()));
+  return true;
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,65 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_BINARYKEYFRAMES_H_
+#define ESP_GFX_REPLAY_BINARYKEYFRAMES_H_
+
+#include "Keyframe.h"
+
+#include <Corrade/Containers/StringView.h>
+
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief Default translation quantization step for binary keyframes, in
+ * meters.
+ */
+constexpr float DEFAULT_BINARY_TRANSLATION_PRECISION = 1.0e-4f;
+
+/**
+ * @brief Whether @p data starts with the binary keyframe header.
+ *
+ * Used by @ref Player to tell binary keyframe files and blobs apart from
+ * JSON ones.
+ */
+bool isBinaryKeyframeData(Corrade::Containers::StringView data);
+
+/**
+ * @brief Serialize keyframes to the compact binary format.
+ * @param keyframes            Keyframes to serialize
+ * @param translationPrecision Quantization step for instance and bone
+ *    translations, in meters
+ *
+ * A more compact alternative to the JSON produced by
+ * @ref Recorder::writeSavedKeyframesToFile. Instance and rig translations are
+ * quantized to @p translationPrecision and rotations to 16-bit components,
+ * and both are delta-coded against the previous update of the same instance
+ * or rig bone, so static instances cost a single byte per update. Instance
+ * keys are delta-coded varints. Loads, creations, user transforms and lights
+ * are stored at full precision. Each serialized blob is self-contained.
+ */
+std::string keyframesToBinary(
+    const std::vector<Keyframe>& keyframes,
+    float translationPrecision = DEFAULT_BINARY_TRANSLATION_PRECISION);
+
+/**
+ * @brief Deserialize keyframes produced by @ref keyframesToBinary().
+ *
+ * Appends the decoded keyframes to @p keyframes. Returns @cpp false @ce if
+ * the data is truncated, has an unknown version or is otherwise malformed,
+ * in which case @p keyframes is left unchanged.
+ */
+bool keyframesFromBinary(Corrade::Containers::StringView data,
+                         std::vector<Keyframe>& keyframes);
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
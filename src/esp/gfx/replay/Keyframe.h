@@ -47,13 +47,38 @@ struct RigCreation {
   std::vector<std::string> boneNames;
 };
 
+/**
+ * @brief Bone transforms of a rig, packed as one translation and one rotation
+ * array so they can be consumed as contiguous buffers.
+ */
+struct RigPose {
+  std::vector<Magnum::Vector3> translations;  // localToWorld
+  std::vector<Magnum::Quaternion> rotations;  // localToWorld
+
+  std::size_t boneCount() const { return translations.size(); }
+};
+
 /**
  * @brief The dynamic state of a rigged articulated object that is tracked by
  * the replay system every frame.
+ *
+ * If @ref changedBones is empty, @ref pose contains all bones of the rig.
+ * Otherwise it's a mask with one bit per bone, set for bones that changed
+ * since the previous update of the same rig, and @ref pose contains only
+ * those bones in increasing bone order.
  */
 struct RigUpdate {
   int id = ID_UNDEFINED;
-  std::vector<Transform> pose;  // localToWorld
+  RigPose pose;
+  std::vector<std::uint32_t> changedBones;
+
+  bool isPartial() const { return !changedBones.empty(); }
+
+  bool isBoneChanged(std::size_t bone) const {
+    return !isPartial() ||
+           (bone / 32 < changedBones.size() &&
+            (changedBones[bone / 32] & (1u << (bone % 32))));
+  }
 };
 
 /**
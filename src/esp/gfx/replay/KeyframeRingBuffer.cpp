@@ -0,0 +1,262 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KeyframeRingBuffer.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#ifdef CORRADE_TARGET_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "esp/core/Check.h"
+#include "esp/core/Logging.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+/*
+  The shared memory is a Header followed by the message area. Both offsets
+  grow monotonically, their value modulo the capacity is the position in the
+  message area. Each message is an 8-byte size followed by the payload padded
+  to a multiple of 8. If a message doesn't fit before the end of the area,
+  the producer writes WrapMarker instead of the size and continues at the
+  start.
+
+  The producer owns writeOffset and the consumer readOffset. Each side
+  publishes its offset with a release store once it's done with the bytes
+  before it, and acquires the other side's offset before touching them.
+*/
+constexpr std::uint32_t Magic = 0x4b525348;  // "HSRK" little-endian
+constexpr std::uint32_t Version = 1;
+constexpr std::uint64_t WrapMarker = ~std::uint64_t{};
+constexpr std::size_t SizeFieldSize = sizeof(std::uint64_t);
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared-memory offsets need lock-free 64-bit atomics");
+
+std::size_t paddedSize(std::size_t size) {
+  return (size + 7) & ~std::size_t{7};
+}
+
+std::string sharedMemoryName(const std::string& name) {
+  return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+}  // namespace
+
+struct KeyframeRingBuffer::Header {
+  std::atomic<std::uint32_t> magic;
+  std::uint32_t version;
+  std::uint64_t capacity;
+  // on separate cache lines so the two sides don't false-share
+  alignas(64) std::atomic<std::uint64_t> writeOffset;
+  alignas(64) std::atomic<std::uint64_t> readOffset;
+};
+
+std::unique_ptr<KeyframeRingBuffer> KeyframeRingBuffer::create(
+    const std::string& name,
+    std::size_t capacity) {
+  ESP_CHECK(capacity >= 4 * SizeFieldSize,
+            "KeyframeRingBuffer::create(): capacity of" << capacity
+                                                        << "bytes too small");
+  capacity = paddedSize(capacity);
+#ifdef CORRADE_TARGET_UNIX
+  const std::string shmName = sharedMemoryName(name);
+  const int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    ESP_ERROR() << "Unable to create shared memory" << shmName
+                << Cr::Utility::Debug::nospace << ":" << std::strerror(errno);
+    return nullptr;
+  }
+  const std::size_t mappedSize = sizeof(Header) + capacity;
+  void* mapped = MAP_FAILED;
+  if (ftruncate(fd, mappedSize) == 0) {
+    mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+  }
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    ESP_ERROR() << "Unable to map shared memory" << shmName
+                << Cr::Utility::Debug::nospace << ":" << std::strerror(errno);
+    shm_unlink(shmName.c_str());
+    return nullptr;
+  }
+
+  std::unique_ptr<KeyframeRingBuffer> buffer{new KeyframeRingBuffer{}};
+  buffer->header_ = new (mapped) Header;
+  buffer->data_ = static_cast<char*>(mapped) + sizeof(Header);
+  buffer->mappedSize_ = mappedSize;
+  buffer->name_ = shmName;
+  buffer->owner_ = true;
+  buffer->header_->version = Version;
+  buffer->header_->capacity = capacity;
+  buffer->header_->writeOffset.store(0, std::memory_order_relaxed);
+  buffer->header_->readOffset.store(0, std::memory_order_relaxed);
+  // the magic goes last so open() doesn't see a half-initialized header
+  buffer->header_->magic.store(Magic, std::memory_order_release);
+  return buffer;
+#else
+  ESP_ERROR() << "Shared-memory keyframe ring buffers are not supported on "
+                 "this platform, can't create"
+              << name;
+  return nullptr;
+#endif
+}
+
+std::unique_ptr<KeyframeRingBuffer> KeyframeRingBuffer::open(
+    const std::string& name) {
+#ifdef CORRADE_TARGET_UNIX
+  const std::string shmName = sharedMemoryName(name);
+  const int fd = shm_open(shmName.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    ESP_ERROR() << "Unable to open shared memory" << shmName
+                << Cr::Utility::Debug::nospace << ":" << std::strerror(errno);
+    return nullptr;
+  }
+  struct stat st {};
+  void* mapped = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && std::size_t(st.st_size) > sizeof(Header)) {
+    mapped = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+  }
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    ESP_ERROR() << "Unable to map shared memory" << shmName;
+    return nullptr;
+  }
+
+  Header* header = static_cast<Header*>(mapped);
+  if (header->magic.load(std::memory_order_acquire) != Magic ||
+      header->version != Version ||
+      sizeof(Header) + header->capacity > std::size_t(st.st_size)) {
+    ESP_ERROR() << "Shared memory" << shmName
+                << "is not a keyframe ring buffer, or not initialized yet";
+    munmap(mapped, st.st_size);
+    return nullptr;
+  }
+
+  std::unique_ptr<KeyframeRingBuffer> buffer{new KeyframeRingBuffer{}};
+  buffer->header_ = header;
+  buffer->data_ = static_cast<char*>(mapped) + sizeof(Header);
+  buffer->mappedSize_ = st.st_size;
+  buffer->name_ = shmName;
+  return buffer;
+#else
+  ESP_ERROR() << "Shared-memory keyframe ring buffers are not supported on "
+                 "this platform, can't open"
+              << name;
+  return nullptr;
+#endif
+}
+
+KeyframeRingBuffer::~KeyframeRingBuffer() {
+#ifdef CORRADE_TARGET_UNIX
+  if (header_) {
+    munmap(header_, mappedSize_);
+  }
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+#endif
+}
+
+std::size_t KeyframeRingBuffer::capacity() const {
+  return header_->capacity;
+}
+
+std::size_t KeyframeRingBuffer::maxMessageSize() const {
+  // a message of at most half the capacity fits either before the end of
+  // the area or at its start once the buffer is drained, wherever the
+  // offsets currently are
+  return (header_->capacity / 2 & ~std::size_t{7}) - SizeFieldSize;
+}
+
+bool KeyframeRingBuffer::tryPush(const Cr::Containers::StringView message) {
+  ESP_CHECK(message.size() <= maxMessageSize(),
+            "KeyframeRingBuffer::tryPush(): message of"
+                << message.size() << "bytes doesn't fit into a buffer of"
+                << capacity() << "bytes");
+  const std::uint64_t capacity = header_->capacity;
+  const std::uint64_t write =
+      header_->writeOffset.load(std::memory_order_relaxed);
+  const std::uint64_t read =
+      header_->readOffset.load(std::memory_order_acquire);
+  const std::uint64_t position = write % capacity;
+  const std::uint64_t messageSize = SizeFieldSize + paddedSize(message.size());
+
+  // skip the tail of the area if the message doesn't fit there
+  const std::uint64_t skip =
+      capacity - position < messageSize ? capacity - position : 0;
+  if (capacity - (write - read) < skip + messageSize) {
+    return false;
+  }
+
+  std::uint64_t start = position;
+  if (skip) {
+    std::memcpy(data_ + position, &WrapMarker, SizeFieldSize);
+    start = 0;
+  }
+  const std::uint64_t size = message.size();
+  std::memcpy(data_ + start, &size, SizeFieldSize);
+  std::memcpy(data_ + start + SizeFieldSize, message.data(), message.size());
+  header_->writeOffset.store(write + skip + messageSize,
+                             std::memory_order_release);
+  return true;
+}
+
+Cr::Containers::Optional<Cr::Containers::StringView>
+KeyframeRingBuffer::peek() {
+  const std::uint64_t capacity = header_->capacity;
+  std::uint64_t read = header_->readOffset.load(std::memory_order_relaxed);
+  const std::uint64_t write =
+      header_->writeOffset.load(std::memory_order_acquire);
+  if (read == write) {
+    return Cr::Containers::NullOpt;
+  }
+
+  std::uint64_t position = read % capacity;
+  std::uint64_t size;
+  std::memcpy(&size, data_ + position, SizeFieldSize);
+  if (size == WrapMarker) {
+    // the producer always writes a message right after the marker
+    read += capacity - position;
+    header_->readOffset.store(read, std::memory_order_release);
+    position = 0;
+    std::memcpy(&size, data_, SizeFieldSize);
+  }
+  return Cr::Containers::StringView{data_ + position + SizeFieldSize,
+                                    std::size_t(size)};
+}
+
+void KeyframeRingBuffer::pop() {
+  const Cr::Containers::Optional<Cr::Containers::StringView> message = peek();
+  ESP_CHECK(message, "KeyframeRingBuffer::pop(): the buffer is empty");
+  const std::uint64_t read =
+      header_->readOffset.load(std::memory_order_relaxed);
+  header_->readOffset.store(
+      read + SizeFieldSize + paddedSize(message->size()),
+      std::memory_order_release);
+}
+
+bool KeyframeRingBuffer::isEmpty() const {
+  return header_->readOffset.load(std::memory_order_relaxed) ==
+         header_->writeOffset.load(std::memory_order_acquire);
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,123 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_KEYFRAMERINGBUFFER_H_
+#define ESP_GFX_REPLAY_KEYFRAMERINGBUFFER_H_
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief Single-producer single-consumer ring buffer of serialized keyframes
+ * in shared memory.
+ *
+ * Lets a physics process publish keyframes to a separate render process
+ * without going through a socket or pipe. The producer writes with
+ * @ref Recorder::writeIncrementalSavedKeyframesToRingBuffer, which uses the
+ * binary format of @ref keyframesToBinary. The consumer gets views pointing
+ * directly into the shared memory with @ref peek, which can be passed to
+ * @ref Player::keyframeFromStringUnwrapped or
+ * @ref sim::AbstractReplayRenderer::setEnvironmentKeyframeUnwrapped without
+ * an intermediate copy, and releases them with @ref pop.
+ *
+ * One side creates the buffer with @ref create and the other attaches to it
+ * by name with @ref open. Use one buffer per producer; the buffer is
+ * lock-free and doesn't support several concurrent producers or consumers.
+ * Only available on Unix platforms.
+ */
+class KeyframeRingBuffer {
+ public:
+  /**
+   * @brief Create a named shared-memory buffer
+   * @param name      Name under which @ref open finds the buffer
+   * @param capacity  Size of the message area in bytes, rounded up to a
+   *    multiple of 8
+   *
+   * Fails if a buffer of the same name already exists. The shared memory is
+   * unlinked when the returned instance is destroyed, processes that opened
+   * it keep their mapping until they destroy theirs. Returns
+   * @cpp nullptr @ce and prints a message on failure.
+   */
+  static std::unique_ptr<KeyframeRingBuffer> create(const std::string& name,
+                                                    std::size_t capacity);
+
+  /**
+   * @brief Attach to a buffer created by @ref create in another process
+   *
+   * Returns @cpp nullptr @ce and prints a message if no buffer of that name
+   * exists or it isn't a keyframe ring buffer.
+   */
+  static std::unique_ptr<KeyframeRingBuffer> open(const std::string& name);
+
+  ~KeyframeRingBuffer();
+
+  KeyframeRingBuffer(const KeyframeRingBuffer&) = delete;
+  KeyframeRingBuffer& operator=(const KeyframeRingBuffer&) = delete;
+
+  /** @brief Size of the message area in bytes */
+  std::size_t capacity() const;
+
+  /**
+   * @brief Size of the largest message the buffer accepts
+   *
+   * Half of @ref capacity minus per-message overhead, which guarantees that
+   * a message of this size can be pushed once the consumer drained the
+   * buffer.
+   */
+  std::size_t maxMessageSize() const;
+
+  /**
+   * @brief Publish a message
+   *
+   * Copies @p message into the buffer and makes it visible to the consumer.
+   * Returns @cpp false @ce without writing anything if there isn't enough
+   * free space until the consumer pops older messages. The message has to
+   * be at most @ref maxMessageSize bytes.
+   */
+  bool tryPush(Corrade::Containers::StringView message);
+
+  /**
+   * @brief Oldest unconsumed message
+   *
+   * The view points into the shared memory and stays valid until the next
+   * @ref pop. Returns @ref Corrade::Containers::NullOpt if the buffer is
+   * empty.
+   */
+  Corrade::Containers::Optional<Corrade::Containers::StringView> peek();
+
+  /**
+   * @brief Release the message returned by @ref peek
+   *
+   * Expects that the buffer isn't empty.
+   */
+  void pop();
+
+  /** @brief Whether there are no unconsumed messages */
+  bool isEmpty() const;
+
+ private:
+  struct Header;
+
+  KeyframeRingBuffer() = default;
+
+  Header* header_ = nullptr;
+  char* data_ = nullptr;
+  std::size_t mappedSize_ = 0;
+  std::string name_;
+  bool owner_ = false;
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
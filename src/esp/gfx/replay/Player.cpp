@@ -3,16 +3,22 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Player.h"
+#include "BinaryKeyframes.h"
 
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Path.h>
 
+#include "esp/core/Check.h"
 #include "esp/io/Json.h"
 
 namespace esp {
 namespace gfx {
 namespace replay {
 
+constexpr int Player::KeyframeSnapshotInterval;
+
 namespace {
 
 // At recording time, material overrides gets stringified and appended to the
@@ -32,6 +38,38 @@ std::string removeMaterialOverrideFromFilepathAndWarn(const std::string& src) {
   }
 }
 
+RigPose createRigPose(const std::size_t boneCount) {
+  RigPose pose;
+  pose.translations.resize(boneCount);
+  pose.rotations.resize(boneCount);
+  return pose;
+}
+
+// Merges a full or partial update into a pose. Returns false if the update is
+// partial and the pose has no bones to merge it into.
+bool applyRigUpdate(const RigUpdate& update, RigPose& pose) {
+  if (!update.isPartial()) {
+    pose.translations.assign(update.pose.translations.begin(),
+                             update.pose.translations.end());
+    pose.rotations.assign(update.pose.rotations.begin(),
+                          update.pose.rotations.end());
+    return true;
+  }
+  if (!pose.boneCount()) {
+    return false;
+  }
+  std::size_t src = 0;
+  for (std::size_t bone = 0;
+       bone != pose.boneCount() && src != update.pose.boneCount(); ++bone) {
+    if (update.isBoneChanged(bone)) {
+      pose.translations[bone] = update.pose.translations[src];
+      pose.rotations[bone] = update.pose.rotations[src];
+      ++src;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 static_assert(std::is_nothrow_move_constructible<Player>::value, "");
@@ -87,9 +125,7 @@ void AbstractPlayerImplementation::createRigInstance(
 
 void AbstractPlayerImplementation::deleteRigInstance(int) {}
 
-void AbstractPlayerImplementation::setRigPose(
-    int,
-    const std::vector<gfx::replay::Transform>&) {}
+void AbstractPlayerImplementation::setRigPose(int, const RigPose&) {}
 
 void Player::readKeyframesFromJsonDocument(const rapidjson::Document& d) {
   CORRADE_INTERNAL_ASSERT(keyframes_.empty());
@@ -106,6 +142,14 @@ Keyframe Player::keyframeFromString(const std::string& keyframe) {
 
 Keyframe Player::keyframeFromStringUnwrapped(
     const Cr::Containers::StringView keyframe) {
+  if (isBinaryKeyframeData(keyframe)) {
+    std::vector<Keyframe> keyframes;
+    ESP_CHECK(
+        keyframesFromBinary(keyframe, keyframes) && keyframes.size() == 1,
+        "keyframeFromStringUnwrapped: malformed binary keyframe");
+    return std::move(keyframes.front());
+  }
+
   Keyframe res;
   rapidjson::Document d;
   d.Parse<0>(keyframe.data(), keyframe.size());
@@ -124,7 +168,20 @@ void Player::readKeyframesFromFile(const std::string& filepath) {
     return;
   }
   try {
-    auto newDoc = esp::io::parseJsonFile(filepath);
+    Cr::Containers::Optional<Cr::Containers::String> data =
+        Corrade::Utility::Path::readString(filepath);
+    if (!data) {
+      throw std::runtime_error{"unreadable file"};
+    }
+    if (isBinaryKeyframeData(*data)) {
+      if (!keyframesFromBinary(*data, keyframes_)) {
+        ESP_ERROR() << "Failed to parse keyframes from" << filepath << ".";
+      }
+      return;
+    }
+    // the document is only read once, straight into keyframes_, so parse it
+    // in place instead of copying every string out of the file contents
+    auto newDoc = esp::io::parseJsonInsitu(data->data());
     readKeyframesFromJsonDocument(newDoc);
   } catch (...) {
     ESP_ERROR() << "Failed to parse keyframes from" << filepath << ".";
@@ -151,11 +208,98 @@ void Player::setKeyframeIndex(int frameIndex) {
     clearFrame();
   }
 
+  // Start from the closest snapshot if it saves applying more than a snapshot
+  // interval worth of keyframes
+  const int snapshotIndex = (frameIndex + 1) / KeyframeSnapshotInterval - 1;
+  const int snapshotFrameIndex =
+      (snapshotIndex + 1) * KeyframeSnapshotInterval - 1;
+  if (snapshotIndex >= 0 &&
+      snapshotFrameIndex - frameIndex_ > KeyframeSnapshotInterval) {
+    const Keyframe& keyframe = snapshot(snapshotIndex);
+    clearFrame();
+    applyKeyframe(keyframe);
+    frameIndex_ = snapshotFrameIndex;
+  }
+
   while (frameIndex_ < frameIndex) {
     applyKeyframe(keyframes_[++frameIndex_]);
   }
 }
 
+const Keyframe& Player::snapshot(const int snapshotIndex) {
+  SnapshotState& state = snapshotState_;
+  while (int(snapshots_.size()) <= snapshotIndex) {
+    // Accumulate in the same order applyKeyframe() applies things
+    const int end = (snapshots_.size() + 1) * KeyframeSnapshotInterval;
+    CORRADE_INTERNAL_ASSERT(end <= getNumKeyframes());
+    for (; state.keyframeCount < end; ++state.keyframeCount) {
+      const Keyframe& keyframe = keyframes_[state.keyframeCount];
+      for (const auto& assetInfo : keyframe.loads) {
+        state.loads[assetInfo.filepath] = assetInfo;
+      }
+      for (const auto& rigCreation : keyframe.rigCreations) {
+        state.rigCreations[rigCreation.id] = rigCreation;
+        state.rigPoses[rigCreation.id] =
+            createRigPose(rigCreation.boneNames.size());
+      }
+      for (const auto& pair : keyframe.creations) {
+        state.creations[pair.first] = pair.second;
+      }
+      for (const auto& deletion : keyframe.deletions) {
+        const auto it = state.creations.find(deletion);
+        if (it == state.creations.end()) {
+          continue;
+        }
+        if (it->second.rigId != ID_UNDEFINED) {
+          state.rigCreations.erase(it->second.rigId);
+          state.rigPoses.erase(it->second.rigId);
+        }
+        state.creations.erase(it);
+        state.states.erase(deletion);
+      }
+      for (const auto& pair : keyframe.stateUpdates) {
+        if (state.creations.count(pair.first)) {
+          state.states[pair.first] = pair.second;
+        }
+      }
+      for (const auto& rigUpdate : keyframe.rigUpdates) {
+        applyRigUpdate(rigUpdate, state.rigPoses[rigUpdate.id]);
+      }
+      if (keyframe.lightsChanged) {
+        state.lightsChanged = true;
+        state.lights = keyframe.lights;
+      }
+    }
+
+    Keyframe snapshot;
+    snapshot.loads.reserve(state.loads.size());
+    for (const auto& pair : state.loads) {
+      snapshot.loads.push_back(pair.second);
+    }
+    snapshot.rigCreations.reserve(state.rigCreations.size());
+    for (const auto& pair : state.rigCreations) {
+      snapshot.rigCreations.push_back(pair.second);
+    }
+    snapshot.creations.assign(state.creations.begin(), state.creations.end());
+    snapshot.stateUpdates.assign(state.states.begin(), state.states.end());
+    snapshot.rigUpdates.reserve(state.rigPoses.size());
+    for (const auto& pair : state.rigPoses) {
+      if (pair.second.boneCount()) {
+        snapshot.rigUpdates.push_back({pair.first, pair.second, {}});
+      }
+    }
+    snapshot.lightsChanged = state.lightsChanged;
+    snapshot.lights = state.lights;
+    snapshots_.emplace_back(std::move(snapshot));
+  }
+  return snapshots_[snapshotIndex];
+}
+
+void Player::clearSnapshots() {
+  snapshots_.clear();
+  snapshotState_ = SnapshotState{};
+}
+
 bool Player::getUserTransform(const std::string& name,
                               Magnum::Vector3* translation,
                               Magnum::Quaternion* rotation) const {
@@ -176,6 +320,7 @@ bool Player::getUserTransform(const std::string& name,
 void Player::close() {
   clearFrame();
   keyframes_.clear();
+  clearSnapshots();
 }
 
 void Player::clearFrame() {
@@ -187,6 +332,7 @@ void Player::clearFrame() {
   createdInstances_.clear();
   assetInfos_.clear();
   creationInfos_.clear();
+  rigPoses_.clear();
   frameIndex_ = -1;
 }
 
@@ -202,6 +348,7 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
 
   for (const auto& rigCreation : keyframe.rigCreations) {
     implementation_->createRigInstance(rigCreation.id, rigCreation.boneNames);
+    rigPoses_[rigCreation.id] = createRigPose(rigCreation.boneNames.size());
   }
 
   for (const auto& pair : keyframe.creations) {
@@ -253,8 +400,12 @@ void Player::applyKeyframe(const Keyframe& keyframe) {
     implementation_->setNodeSemanticId(node, state.semanticId);
   }
 
+  // partial updates are merged so the implementation always gets full poses
   for (const auto& rigUpdate : keyframe.rigUpdates) {
-    implementation_->setRigPose(rigUpdate.id, rigUpdate.pose);
+    RigPose& pose = rigPoses_[rigUpdate.id];
+    if (applyRigUpdate(rigUpdate, pose)) {
+      implementation_->setRigPose(rigUpdate.id, pose);
+    }
   }
 
   if (keyframe.lightsChanged) {
@@ -285,6 +436,7 @@ void Player::hackProcessDeletions(const Keyframe& keyframe) {
       int rigId = creationInfos_[deletionInstanceKey].rigId;
       if (rigId != ID_UNDEFINED) {
         implementation_->deleteRigInstance(rigId);
+        rigPoses_.erase(rigId);
       }
       creationInfos_.erase(deletionInstanceKey);
     }
@@ -338,6 +490,7 @@ void Player::appendJSONKeyframe(const std::string& keyframe) {
 
 void Player::setSingleKeyframe(Keyframe&& keyframe) {
   keyframes_.clear();
+  clearSnapshots();
   frameIndex_ = -1;
   keyframes_.emplace_back(std::move(keyframe));
   setKeyframeIndex(0);
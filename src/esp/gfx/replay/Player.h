@@ -12,6 +12,8 @@
 
 #include <rapidjson/document.h>
 
+#include <map>
+
 namespace esp {
 namespace gfx {
 namespace replay {
@@ -145,11 +147,13 @@ class AbstractPlayerImplementation {
 
   /**
    * @brief Set all bone transforms for a specific rig.
-
-   * Default implementation does nothing.
+   *
+   * The @p pose always contains all bones of the rig, partial updates
+   * recorded in the keyframe are merged into the previous pose by
+   * @ref Player. The translations and rotations are contiguous so they can
+   * be uploaded directly. Default implementation does nothing.
    */
-  virtual void setRigPose(int rigId,
-                          const std::vector<gfx::replay::Transform>& pose);
+  virtual void setRigPose(int rigId, const RigPose& pose);
 };
 
 /**
@@ -212,7 +216,9 @@ class Player {
   ~Player();
 
   /**
-   * @brief Read keyframes. See also @ref Recorder::writeSavedKeyframesToFile.
+   * @brief Read keyframes. See also @ref Recorder::writeSavedKeyframesToFile
+   * and @ref Recorder::writeSavedKeyframesToBinaryFile; the format is
+   * detected from the file contents.
    * After calling this, use @ref setKeyframeIndex to set a keyframe.
    * @param filepath
    */
@@ -234,7 +240,9 @@ class Player {
    *
    * The JSON string is expected to directly contain the keyframe object,
    * (with `loads`, `creations`, etc.). Use @ref keyframeFromString() to
-   * consume a keyframe wrapped in an additional object.
+   * consume a keyframe wrapped in an additional object. A single keyframe in
+   * the binary format produced by @ref Recorder::keyframeToBinary is accepted
+   * as well.
    */
   static Keyframe keyframeFromStringUnwrapped(
       Corrade::Containers::StringView keyframe);
@@ -252,6 +260,14 @@ class Player {
   /**
    * @brief Set a keyframe by index, or pass -1 to clear the currently-set
    * keyframe.
+   *
+   * Keyframes only contain changes relative to the previous one, so reaching
+   * a keyframe means applying all keyframes before it. To keep seeking
+   * bounded for long recordings, the player consolidates the keyframes into
+   * a full-state snapshot every @ref KeyframeSnapshotInterval keyframes, and
+   * a seek backwards or far ahead starts from the closest snapshot instead.
+   * Snapshots are built on demand, the first seek to the end of a recording
+   * thus still goes through all keyframes once.
    */
   void setKeyframeIndex(int frameIndex);
 
@@ -273,8 +289,15 @@ class Player {
    */
   void debugSetKeyframes(std::vector<Keyframe>&& keyframes) {
     keyframes_ = std::move(keyframes);
+    clearSnapshots();
   }
 
+  /**
+   * @brief Number of keyframes between full-state snapshots used for seeking.
+   * See @ref setKeyframeIndex.
+   */
+  static constexpr int KeyframeSnapshotInterval = 64;
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -297,6 +320,23 @@ class Player {
   void readKeyframesFromJsonDocument(const rapidjson::Document& d);
   void clearFrame();
   void hackProcessDeletions(const Keyframe& keyframe);
+  const Keyframe& snapshot(int snapshotIndex);
+  void clearSnapshots();
+
+  /* Everything the keyframes up to snapshotState_.keyframeCount add up to,
+     used for building snapshots_. Ordered maps so the snapshots create
+     instances in the order they were originally created. */
+  struct SnapshotState {
+    int keyframeCount = 0;
+    std::map<std::string, esp::assets::AssetInfo> loads;
+    std::map<int, RigCreation> rigCreations;
+    std::map<RenderAssetInstanceKey, assets::RenderAssetInstanceCreationInfo>
+        creations;
+    std::map<RenderAssetInstanceKey, RenderAssetInstanceState> states;
+    std::map<int, RigPose> rigPoses;
+    bool lightsChanged = false;
+    LightSetup lights;
+  };
 
   std::shared_ptr<AbstractPlayerImplementation> implementation_;
 
@@ -308,7 +348,12 @@ class Player {
                      assets::RenderAssetInstanceCreationInfo>
       creationInfos_;
   std::unordered_map<RenderAssetInstanceKey, Mn::Matrix4> latestTransformCache_;
+  // full pose of each rig, partial rig updates get merged into these
+  std::unordered_map<int, RigPose> rigPoses_;
   std::set<std::string> failedFilepaths_;
+  // snapshots_[i] is the state at keyframe (i + 1)*KeyframeSnapshotInterval - 1
+  std::vector<Keyframe> snapshots_;
+  SnapshotState snapshotState_;
 
   ESP_SMART_POINTERS(Player)
 };
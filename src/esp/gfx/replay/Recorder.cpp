@@ -3,15 +3,34 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Recorder.h"
+#include "BinaryKeyframes.h"
+#include "KeyframeRingBuffer.h"
 
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/core/Check.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/ScratchArena.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/SkinData.h"
 #include "esp/io/Json.h"
 #include "esp/io/JsonAllTypes.h"
 #include "esp/scene/SceneNode.h"
 
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
 namespace {
 esp::gfx::replay::Transform createReplayTransform(
     const Magnum::Matrix4& absTransformMat) {
@@ -28,6 +47,59 @@ esp::gfx::replay::Transform createReplayTransform(
       absTransformMat.translation(),
       Magnum::Quaternion::fromMatrix(rotationShear)};
 };
+
+// Unlike Recorder::keyframeToString, without the wrapping "keyframe" object
+std::string keyframeToJsonValueString(
+    const esp::gfx::replay::Keyframe& keyframe,
+    int maxDecimalPlaces) {
+  rapidjson::Document d;
+  const esp::io::JsonGenericValue value =
+      esp::io::toJsonValue(keyframe, d.GetAllocator());
+  rapidjson::StringBuffer buffer{};
+  rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+  if (maxDecimalPlaces != -1) {
+    writer.SetMaxDecimalPlaces(maxDecimalPlaces);
+  }
+  value.Accept(writer);
+  return buffer.GetString();
+}
+
+template <class T>
+std::size_t vectorMemoryUsage(const std::vector<T>& vector) {
+  return vector.capacity() * sizeof(T);
+}
+
+std::size_t keyframeMemoryUsage(const esp::gfx::replay::Keyframe& keyframe) {
+  std::size_t usage = vectorMemoryUsage(keyframe.loads) +
+                      vectorMemoryUsage(keyframe.rigCreations) +
+                      vectorMemoryUsage(keyframe.creations) +
+                      vectorMemoryUsage(keyframe.deletions) +
+                      vectorMemoryUsage(keyframe.stateUpdates) +
+                      vectorMemoryUsage(keyframe.rigUpdates) +
+                      vectorMemoryUsage(keyframe.lights);
+  for (const auto& load : keyframe.loads) {
+    usage += load.filepath.capacity();
+  }
+  for (const auto& rigCreation : keyframe.rigCreations) {
+    usage += vectorMemoryUsage(rigCreation.boneNames);
+    for (const std::string& boneName : rigCreation.boneNames) {
+      usage += boneName.capacity();
+    }
+  }
+  for (const auto& creation : keyframe.creations) {
+    usage += creation.second.filepath.capacity() +
+             creation.second.lightSetupKey.capacity();
+  }
+  for (const auto& rigUpdate : keyframe.rigUpdates) {
+    usage += vectorMemoryUsage(rigUpdate.pose.translations) +
+             vectorMemoryUsage(rigUpdate.pose.rotations) +
+             vectorMemoryUsage(rigUpdate.changedBones);
+  }
+  for (const auto& userTransform : keyframe.userTransforms) {
+    usage += sizeof(userTransform) + userTransform.first.capacity();
+  }
+  return usage;
+}
 }  // namespace
 
 namespace esp {
@@ -49,17 +121,72 @@ class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
     recorder_->onDeleteRenderAssetInstance(node);
   }
 
+  // Set whenever the node or any of its parents gets transformed. The
+  // Recorder cleans the node when it reads the flag, so the next
+  // transformation marks it dirty (and calls markDirty()) again, even if
+  // nothing else cleans the scene graph in between.
+  bool transformChanged = true;
+
  private:
+  void markDirty() override { transformChanged = true; }
+
   Recorder* recorder_ = nullptr;
   const scene::SceneNode* node = nullptr;
 };
 
+/**
+ * @brief A file written by @ref Recorder::startStreamingKeyframesToFile.
+ *
+ * The file is a regular `{"keyframes": [...]}` document, the closing brackets
+ * get written when the stream is finished or destroyed.
+ */
+struct Recorder::KeyframeStream {
+  explicit KeyframeStream(const std::string& filepath, int checkpointInterval)
+      : checkpointInterval{checkpointInterval}, consolidated(1) {
+    basePath = filepath;
+    if (Corrade::Utility::String::endsWith(basePath, ".json")) {
+      basePath.resize(basePath.size() - 5);
+    }
+  }
+
+  ~KeyframeStream() { finish(); }
+
+  bool open() {
+    const std::string filepath =
+        fileIndex == 0
+            ? basePath + ".json"
+            : Corrade::Utility::format("{}_{}.json", basePath, fileIndex);
+    file.open(filepath, std::ios::out | std::ios::trunc);
+    file << "{\"keyframes\":[";
+    keyframeCount = 0;
+    return bool(file);
+  }
+
+  void finish() {
+    if (file.is_open()) {
+      file << "]}";
+      file.close();
+    }
+  }
+
+  std::string basePath;
+  int checkpointInterval;
+  int fileIndex = 0;
+  int keyframeCount = 0;
+  std::ofstream file;
+  // loads, creations and deletions of all streamed keyframes, consolidated
+  // the same way as in consolidateSavedKeyframes(). A one-item vector to be
+  // usable with addLoadsCreationsDeletions().
+  std::vector<Keyframe> consolidated;
+};
+
 Recorder::~Recorder() {
   // Delete NodeDeletionHelpers. This is important because they hold raw
   // pointers to this Recorder and these pointers would become dangling
   // (invalid) after this Recorder is destroyed.
-  for (auto& instanceRecord : instanceRecords_) {
-    delete instanceRecord.deletionHelper;
+  // Each deletion removes its record via onDeleteRenderAssetInstance.
+  while (!instanceRecords_.empty()) {
+    delete instanceRecords_.back().deletionHelper;
   }
 }
 
@@ -81,6 +208,7 @@ void Recorder::onCreateRenderAssetInstance(
   // manually later if necessary.
   NodeDeletionHelper* deletionHelper = new NodeDeletionHelper{*node, this};
 
+  instanceRecordIndices_[node] = instanceRecords_.size();
   instanceRecords_.emplace_back(InstanceRecord{node, instanceKey,
                                                Corrade::Containers::NullOpt,
                                                deletionHelper, creation.rigId});
@@ -110,8 +238,12 @@ void Recorder::onHideSceneGraph(const esp::scene::SceneGraph& sceneGraph) {
 }
 
 void Recorder::saveKeyframe() {
+  ESP_PROFILE_SCOPE("Recorder::saveKeyframe");
   updateStates();
   advanceKeyframe();
+  if (keyframeStream_) {
+    streamLatestKeyframe();
+  }
 }
 
 Keyframe Recorder::extractKeyframe() {
@@ -186,7 +318,13 @@ void Recorder::onDeleteRenderAssetInstance(const scene::SceneNode* node) {
 
   checkAndAddDeletion(&getKeyframe(), instanceKey);
 
-  instanceRecords_.erase(instanceRecords_.begin() + index);
+  // swap-and-pop, records aren't ordered
+  instanceRecordIndices_.erase(node);
+  if (std::size_t(index) != instanceRecords_.size() - 1) {
+    instanceRecords_[index] = std::move(instanceRecords_.back());
+    instanceRecordIndices_[instanceRecords_[index].node] = index;
+  }
+  instanceRecords_.pop_back();
   rigNodes_.erase(rigId);
   rigNodeTransformCache_.erase(rigId);
 }
@@ -200,20 +338,16 @@ RenderAssetInstanceKey Recorder::getNewInstanceKey() {
 }
 
 int Recorder::findInstance(const scene::SceneNode* queryNode) {
-  auto it = std::find_if(instanceRecords_.begin(), instanceRecords_.end(),
-                         [&queryNode](const InstanceRecord& record) {
-                           return record.node == queryNode;
-                         });
-
-  return it == instanceRecords_.end()
-             ? ID_UNDEFINED
-             : static_cast<int>(it - instanceRecords_.begin());
+  const auto it = instanceRecordIndices_.find(queryNode);
+  return it == instanceRecordIndices_.end() ? ID_UNDEFINED
+                                            : static_cast<int>(it->second);
 }
 
 RenderAssetInstanceState Recorder::getInstanceState(
     const scene::SceneNode* node) {
-  const auto absTransformMat = node->absoluteTransformation();
-  const auto transform = ::createReplayTransform(absTransformMat);
+  // the caller cleaned the node, so this doesn't walk the hierarchy again
+  const auto transform =
+      ::createReplayTransform(node->cleanAbsoluteTransformation());
   return RenderAssetInstanceState{transform, node->getSemanticId()};
 }
 
@@ -223,51 +357,142 @@ void Recorder::updateStates() {
 }
 
 void Recorder::updateInstanceStates() {
-  for (auto& instanceRecord : instanceRecords_) {
+  // Decomposing the absolute transformation is the expensive part, skip it
+  // for nodes that didn't move. Semantic ID changes don't mark the node
+  // dirty, so those are checked separately.
+  core::ScratchVector<std::size_t> changedRecords;
+  // passed by value to setClean(), so it can't live on the scratch arena
+  std::vector<std::reference_wrapper<MagnumObject>> dirtyNodes;
+  for (std::size_t i = 0; i < instanceRecords_.size(); ++i) {
+    InstanceRecord& instanceRecord = instanceRecords_[i];
+    NodeDeletionHelper& helper = *instanceRecord.deletionHelper;
+    if (instanceRecord.recentState && !helper.transformChanged &&
+        instanceRecord.recentState->semanticId ==
+            instanceRecord.node->getSemanticId()) {
+      continue;
+    }
+    helper.transformChanged = false;
+    changedRecords.push_back(i);
+    // nodes already cleaned by the renderer or by physics don't need another
+    // hierarchy walk
+    if (instanceRecord.node->isDirty()) {
+      dirtyNodes.emplace_back(*instanceRecord.node);
+    }
+  }
+  // cleaning all nodes at once computes shared parent transformations only
+  // once and re-arms NodeDeletionHelper::markDirty()
+  MagnumObject::setClean(std::move(dirtyNodes));
+
+  for (const std::size_t i : changedRecords) {
+    InstanceRecord& instanceRecord = instanceRecords_[i];
     auto state = getInstanceState(instanceRecord.node);
-    if (!instanceRecord.recentState || state != instanceRecord.recentState) {
-      getKeyframe().stateUpdates.emplace_back(instanceRecord.instanceKey,
-                                              state);
-      instanceRecord.recentState = state;
+    if (instanceRecord.recentState) {
+      if (state == *instanceRecord.recentState) {
+        continue;
+      }
+      if (isStateUpdatePostponed(instanceRecord, state)) {
+        // look at the node again next time even if it doesn't move anymore
+        instanceRecord.deletionHelper->transformChanged = true;
+        continue;
+      }
+      if (isStateUpdateNegligible(instanceRecord, state)) {
+        continue;
+      }
     }
+    getKeyframe().stateUpdates.emplace_back(instanceRecord.instanceKey, state);
+    instanceRecord.recentState = state;
+    instanceRecord.recentStateKeyframe = stateUpdateIndex_;
   }
+  ++stateUpdateIndex_;
+}
+
+bool Recorder::isStateUpdatePostponed(
+    const InstanceRecord& instanceRecord,
+    const RenderAssetInstanceState& state) const {
+  const StateUpdateFilter& filter =
+      instanceRecord.filter ? *instanceRecord.filter : stateUpdateFilter_;
+  if (stateUpdateIndex_ - instanceRecord.recentStateKeyframe <
+      std::size_t(filter.minKeyframeInterval)) {
+    return true;
+  }
+  return regionOfInterest_ &&
+         (state.absTransform.translation - regionOfInterest_->center).dot() >
+             Mn::Math::pow<2>(regionOfInterest_->radius);
+}
+
+bool Recorder::isStateUpdateNegligible(
+    const InstanceRecord& instanceRecord,
+    const RenderAssetInstanceState& state) const {
+  const StateUpdateFilter& filter =
+      instanceRecord.filter ? *instanceRecord.filter : stateUpdateFilter_;
+  const RenderAssetInstanceState& recentState = *instanceRecord.recentState;
+  if (state.semanticId != recentState.semanticId) {
+    return false;
+  }
+  const float translationChange = (state.absTransform.translation -
+                                   recentState.absTransform.translation)
+                                      .length();
+  // q and -q are the same rotation, hence the absolute value
+  const float cosHalfAngle = std::abs(Mn::Math::dot(
+      state.absTransform.rotation, recentState.absTransform.rotation));
+  const float rotationChange = 2.0f * std::acos(std::min(cosHalfAngle, 1.0f));
+  return translationChange < filter.minTranslation &&
+         rotationChange < filter.minRotation;
 }
 
 void Recorder::updateRigInstanceStates() {
+  // bones of a rig share most of their parent chain, clean them together
+  std::vector<std::reference_wrapper<MagnumObject>> dirtyBones;
+  for (const auto& rigItr : rigNodes_) {
+    for (scene::SceneNode* bone : rigItr.second) {
+      if (bone->isDirty()) {
+        dirtyBones.emplace_back(*bone);
+      }
+    }
+  }
+  MagnumObject::setClean(std::move(dirtyBones));
+
   for (const auto& rigItr : rigNodes_) {
     const int rigId = rigItr.first;
     const int boneCount = rigItr.second.size();
 
-    RigUpdate rigUpdate;
-    rigUpdate.id = rigId;
-
-    const auto cacheIt = rigNodeTransformCache_.find(rigId);
-    if (cacheIt == rigNodeTransformCache_.end()) {
-      rigNodeTransformCache_[rigId] = std::vector<Mn::Matrix4>(boneCount);
+    // A rig seen for the first time gets a full pose, otherwise only the
+    // bones that moved since the previous update are recorded
+    auto cacheIt = rigNodeTransformCache_.find(rigId);
+    const bool full = cacheIt == rigNodeTransformCache_.end();
+    if (full) {
+      cacheIt = rigNodeTransformCache_
+                    .emplace(rigId, std::vector<Mn::Matrix4>(boneCount))
+                    .first;
     }
+    std::vector<Mn::Matrix4>& cache = cacheIt->second;
 
-    // If a single bone pose was updated, update the entire pose
-    bool updated = false;
+    RigUpdate rigUpdate;
+    rigUpdate.id = rigId;
+    std::vector<std::uint32_t> changedBones((boneCount + 31) / 32);
+    int changedCount = 0;
     for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
-      const auto* bone = rigItr.second[boneIdx];
-      const auto absTransformMat = bone->absoluteTransformation();
-      if (rigNodeTransformCache_[rigId][boneIdx] != absTransformMat) {
-        updated = true;
-        break;
+      const Mn::Matrix4& absTransformMat =
+          rigItr.second[boneIdx]->cleanAbsoluteTransformation();
+      if (!full && cache[boneIdx] == absTransformMat) {
+        continue;
       }
+      cache[boneIdx] = absTransformMat;
+      changedBones[boneIdx / 32] |= 1u << (boneIdx % 32);
+      ++changedCount;
+      const Transform transform = createReplayTransform(absTransformMat);
+      rigUpdate.pose.translations.push_back(transform.translation);
+      rigUpdate.pose.rotations.push_back(transform.rotation);
     }
 
-    // Update the pose
-    if (updated) {
-      rigUpdate.pose.reserve(boneCount);
-      for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
-        const auto* bone = rigItr.second[boneIdx];
-        const auto absTransformMat = bone->absoluteTransformation();
-        rigNodeTransformCache_[rigId][boneIdx] = absTransformMat;
-        rigUpdate.pose.emplace_back(createReplayTransform(absTransformMat));
-      }
-      currKeyframe_.rigUpdates.emplace_back(std::move(rigUpdate));
+    if (changedCount == 0) {
+      continue;
     }
+    // no mask needed if all bones are there anyway
+    if (changedCount != boneCount) {
+      rigUpdate.changedBones = std::move(changedBones);
+    }
+    currKeyframe_.rigUpdates.emplace_back(std::move(rigUpdate));
   }
 }
 
@@ -276,8 +501,43 @@ void Recorder::advanceKeyframe() {
   currKeyframe_ = Keyframe{};
 }
 
+void Recorder::setStateUpdateFilter(const StateUpdateFilter& filter) {
+  ESP_CHECK(filter.minKeyframeInterval >= 1,
+            "Recorder::setStateUpdateFilter(): expected a positive keyframe "
+            "interval but got"
+                << filter.minKeyframeInterval);
+  stateUpdateFilter_ = filter;
+}
+
+void Recorder::setInstanceStateUpdateFilter(const scene::SceneNode* node,
+                                            const StateUpdateFilter& filter) {
+  ESP_CHECK(filter.minKeyframeInterval >= 1,
+            "Recorder::setInstanceStateUpdateFilter(): expected a positive "
+            "keyframe interval but got"
+                << filter.minKeyframeInterval);
+  const int index = findInstance(node);
+  ESP_CHECK(index != ID_UNDEFINED,
+            "Recorder::setInstanceStateUpdateFilter(): the node isn't the "
+            "root of a recorded render asset instance");
+  instanceRecords_[index].filter = filter;
+}
+
+void Recorder::setRegionOfInterest(const Magnum::Vector3& center,
+                                   float radius) {
+  ESP_CHECK(radius >= 0.0f,
+            "Recorder::setRegionOfInterest(): expected a non-negative radius "
+            "but got"
+                << radius);
+  regionOfInterest_ = RegionOfInterest{center, radius};
+}
+
+void Recorder::clearRegionOfInterest() {
+  regionOfInterest_ = Cr::Containers::NullOpt;
+}
+
 void Recorder::writeSavedKeyframesToFile(const std::string& filepath,
                                          bool usePrettyWriter) {
+  checkNotStreaming("writeSavedKeyframesToFile");
   auto document = writeKeyframesToJsonDocument();
   auto ok = esp::io::writeJsonToFile(document, filepath, usePrettyWriter,
                                      maxDecimalPlaces_);
@@ -286,7 +546,24 @@ void Recorder::writeSavedKeyframesToFile(const std::string& filepath,
   consolidateSavedKeyframes();
 }
 
+void Recorder::writeSavedKeyframesToBinaryFile(const std::string& filepath) {
+  checkNotStreaming("writeSavedKeyframesToBinaryFile");
+  if (savedKeyframes_.empty()) {
+    ESP_WARNING() << "No saved keyframes to write";
+  }
+  const std::string data =
+      keyframesToBinary(savedKeyframes_, binaryTranslationPrecision());
+  auto ok = Corrade::Utility::Path::write(
+      filepath, Corrade::Containers::ArrayView<const char>{data.data(),
+                                                           data.size()});
+  ESP_CHECK(ok,
+            "writeSavedKeyframesToBinaryFile: unable to write to " << filepath);
+
+  consolidateSavedKeyframes();
+}
+
 std::string Recorder::writeSavedKeyframesToString() {
+  checkNotStreaming("writeSavedKeyframesToString");
   auto document = writeKeyframesToJsonDocument();
 
   consolidateSavedKeyframes();
@@ -296,6 +573,7 @@ std::string Recorder::writeSavedKeyframesToString() {
 
 std::vector<std::string>
 Recorder::writeIncrementalSavedKeyframesToStringArray() {
+  checkNotStreaming("writeIncrementalSavedKeyframesToStringArray");
   std::vector<std::string> results;
   results.reserve(savedKeyframes_.size());
 
@@ -313,6 +591,27 @@ Recorder::writeIncrementalSavedKeyframesToStringArray() {
   return results;
 }
 
+std::size_t Recorder::writeIncrementalSavedKeyframesToRingBuffer(
+    KeyframeRingBuffer& buffer) {
+  checkNotStreaming("writeIncrementalSavedKeyframesToRingBuffer");
+  std::size_t published = 0;
+  for (; published != savedKeyframes_.size(); ++published) {
+    const std::string data = keyframeToBinary(savedKeyframes_[published]);
+    ESP_CHECK(data.size() <= buffer.maxMessageSize(),
+              "writeIncrementalSavedKeyframesToRingBuffer: keyframe of"
+                  << data.size() << "bytes doesn't fit into a ring buffer of"
+                  << buffer.capacity() << "bytes");
+    if (!buffer.tryPush(data)) {
+      break;
+    }
+  }
+
+  // as in writeIncrementalSavedKeyframesToStringArray, no consolidation
+  savedKeyframes_.erase(savedKeyframes_.begin(),
+                        savedKeyframes_.begin() + published);
+  return published;
+}
+
 void Recorder::setMaxDecimalPlaces(int maxDecimalPlaces) {
   maxDecimalPlaces_ = maxDecimalPlaces;
 }
@@ -328,6 +627,98 @@ std::string Recorder::keyframeToString(const Keyframe& keyframe) const {
   return esp::io::jsonToString(d, maxDecimalPlaces_);
 }
 
+std::string Recorder::keyframeToBinary(const Keyframe& keyframe) const {
+  return keyframesToBinary({keyframe}, binaryTranslationPrecision());
+}
+
+std::size_t Recorder::getMemoryUsage() const {
+  std::size_t usage = vectorMemoryUsage(savedKeyframes_) +
+                      keyframeMemoryUsage(currKeyframe_) +
+                      vectorMemoryUsage(instanceRecords_);
+  for (const Keyframe& keyframe : savedKeyframes_) {
+    usage += keyframeMemoryUsage(keyframe);
+  }
+  return usage;
+}
+
+float Recorder::binaryTranslationPrecision() const {
+  // match the rounding of the JSON output
+  return maxDecimalPlaces_ >= 0 ? std::pow(10.0f, -float(maxDecimalPlaces_))
+                                : DEFAULT_BINARY_TRANSLATION_PRECISION;
+}
+
+void Recorder::startStreamingKeyframesToFile(const std::string& filepath,
+                                             int checkpointInterval) {
+  ESP_CHECK(!keyframeStream_,
+            "startStreamingKeyframesToFile: already streaming keyframes");
+  keyframeStream_ =
+      std::make_unique<KeyframeStream>(filepath, checkpointInterval);
+  ESP_CHECK(keyframeStream_->open(),
+            "startStreamingKeyframesToFile: unable to write to " << filepath);
+
+  // keyframes saved before streaming started go to the file first
+  std::vector<Keyframe> pending = std::move(savedKeyframes_);
+  savedKeyframes_.clear();
+  for (Keyframe& keyframe : pending) {
+    savedKeyframes_.emplace_back(std::move(keyframe));
+    streamLatestKeyframe();
+  }
+}
+
+void Recorder::stopStreamingKeyframes() {
+  if (!keyframeStream_) {
+    return;
+  }
+  keyframeStream_->finish();
+  // savedKeyframes_ holds just the latest keyframe, which was already
+  // streamed. Restore the consolidated state from the stream instead.
+  savedKeyframes_ = std::move(keyframeStream_->consolidated);
+  keyframeStream_ = nullptr;
+  consolidateSavedKeyframes();
+}
+
+void Recorder::streamLatestKeyframe() {
+  CORRADE_INTERNAL_ASSERT(keyframeStream_ && !savedKeyframes_.empty());
+  KeyframeStream& stream = *keyframeStream_;
+
+  if (stream.keyframeCount) {
+    stream.file << ',';
+  }
+  stream.file << keyframeToJsonValueString(savedKeyframes_.back(),
+                                           maxDecimalPlaces_);
+  ++stream.keyframeCount;
+
+  addLoadsCreationsDeletions(savedKeyframes_.end() - 1, savedKeyframes_.end(),
+                             &stream.consolidated.front());
+  // keep only the latest keyframe, for getLatestKeyframe()
+  savedKeyframes_.erase(savedKeyframes_.begin(), savedKeyframes_.end() - 1);
+
+  if (stream.checkpointInterval > 0 &&
+      stream.keyframeCount >= stream.checkpointInterval) {
+    stream.finish();
+    // the next saved keyframe becomes the checkpoint: it gets all loads and
+    // creations so far and, with recentState and the rig cache cleared, all
+    // instance states and full rig poses
+    addLoadsCreationsDeletions(stream.consolidated.begin(),
+                               stream.consolidated.end(), &getKeyframe());
+    stream.consolidated.front() = Keyframe{};
+    for (auto& instanceRecord : instanceRecords_) {
+      instanceRecord.recentState = Corrade::Containers::NullOpt;
+    }
+    rigNodeTransformCache_.clear();
+    ++stream.fileIndex;
+    ESP_CHECK(stream.open(), "saveKeyframe: unable to write to "
+                                 << stream.basePath << "_" << stream.fileIndex
+                                 << ".json");
+  }
+}
+
+void Recorder::checkNotStreaming(const char* function) const {
+  ESP_CHECK(!keyframeStream_,
+            function << ": not available while streaming keyframes, call "
+                        "stopStreamingKeyframes() first");
+}
+
 void Recorder::consolidateSavedKeyframes() {
   // consolidate saved keyframes into current keyframe
   addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
@@ -337,6 +728,8 @@ void Recorder::consolidateSavedKeyframes() {
   for (auto& instanceRecord : instanceRecords_) {
     instanceRecord.recentState = Corrade::Containers::NullOpt;
   }
+  // and full rig poses, as the partial ones refer to discarded keyframes
+  rigNodeTransformCache_.clear();
   savedKeyframes_.clear();
 }
 
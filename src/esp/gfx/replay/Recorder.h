@@ -9,7 +9,9 @@
 
 #include <rapidjson/document.h>
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace esp {
 namespace assets {
@@ -26,8 +28,39 @@ namespace replay {
 
 const int DEFAULT_MAX_DECIMAL_PLACES = 7;
 
+class KeyframeRingBuffer;
 class NodeDeletionHelper;
 
+/**
+ * @brief Filtering of recorded instance state updates.
+ *
+ * Reduces keyframe size, e.g. when streaming keyframes to a remote viewer,
+ * at the cost of replay fidelity. A default-constructed filter records every
+ * change. See @ref Recorder::setStateUpdateFilter.
+ */
+struct StateUpdateFilter {
+  /**
+   * @brief Translation change in meters below which an update is dropped
+   *
+   * Measured against the last recorded state of the instance, so small
+   * movements accumulate until they're recorded. Updates are only dropped if
+   * the rotation change is below @ref minRotation as well.
+   */
+  float minTranslation = 0.0f;
+
+  /** @brief Rotation change in radians below which an update is dropped */
+  float minRotation = 0.0f;
+
+  /**
+   * @brief Minimum number of saved keyframes between two updates of an
+   * instance
+   *
+   * Changes in between aren't lost, the latest state is recorded once the
+   * interval passed.
+   */
+  int minKeyframeInterval = 1;
+};
+
 /**
  * @brief Recording for "render replay".
  *
@@ -126,6 +159,44 @@ class Recorder {
    */
   void clearLightsFromKeyframe();
 
+  /**
+   * @brief Set the filter for state updates of all instances.
+   *
+   * Instances with a filter set through @ref setInstanceStateUpdateFilter
+   * aren't affected. The first state of an instance is always recorded and
+   * semantic ID changes are never dropped as negligible.
+   */
+  void setStateUpdateFilter(const StateUpdateFilter& filter);
+
+  /**
+   * @brief Set the filter for state updates of a single instance.
+   * @param node    The root node of an instance passed to
+   *    @ref onCreateRenderAssetInstance
+   * @param filter  Filter used instead of the one set with
+   *    @ref setStateUpdateFilter
+   */
+  void setInstanceStateUpdateFilter(const scene::SceneNode* node,
+                                    const StateUpdateFilter& filter);
+
+  /**
+   * @brief Only record state updates of instances near a point of interest.
+   * @param center  Usually the position of the camera of a remote viewer,
+   *    expected to be updated before each @ref saveKeyframe
+   * @param radius  Distance from @p center beyond which instance updates are
+   *    postponed
+   *
+   * Updates of instances outside of the region are postponed until they or
+   * the region move so that they're inside. The first state of an instance is
+   * always recorded.
+   */
+  void setRegionOfInterest(const Magnum::Vector3& center, float radius);
+
+  /**
+   * @brief Record state updates of all instances regardless of where they
+   * are. See @ref setRegionOfInterest.
+   */
+  void clearRegionOfInterest();
+
   /**
    * @brief write saved keyframes to file.
    * @param filepath
@@ -136,6 +207,50 @@ class Recorder {
   void writeSavedKeyframesToFile(const std::string& filepath,
                                  bool usePrettyWriter = false);
 
+  /**
+   * @brief write saved keyframes to file in the compact binary format. See
+   * @ref keyframesToBinary() for details.
+   * @param filepath
+   *
+   * Translations are quantized to @ref getMaxDecimalPlaces() decimal places.
+   * Like @ref writeSavedKeyframesToFile, the file can be read back with
+   * @ref Player::readKeyframesFromFile.
+   */
+  void writeSavedKeyframesToBinaryFile(const std::string& filepath);
+
+  /**
+   * @brief Stream keyframes to file as they're saved instead of accumulating
+   * them in memory.
+   * @param filepath            File to write. A `.json` extension is added if
+   *    not present.
+   * @param checkpointInterval  If positive, the file is finished after this
+   *    many keyframes and streaming continues in `<filepath>_1.json`,
+   *    `<filepath>_2.json` etc.
+   *
+   * Each keyframe is appended to the file as soon as @ref saveKeyframe
+   * completes, and only the latest keyframe is kept in memory. Every
+   * continuation file starts with a checkpoint keyframe holding all loads and
+   * creations so far and the full state of every instance, the same as what
+   * consecutive @ref writeSavedKeyframesToFile calls produce, so each file
+   * can be played on its own with @ref Player::readKeyframesFromFile. While
+   * streaming, the other write functions aren't available. Call
+   * @ref stopStreamingKeyframes to finish the file.
+   */
+  void startStreamingKeyframesToFile(const std::string& filepath,
+                                     int checkpointInterval = 0);
+
+  /**
+   * @brief Finish the file started with @ref startStreamingKeyframesToFile and
+   * return to accumulating saved keyframes in memory.
+   */
+  void stopStreamingKeyframes();
+
+  /**
+   * @brief Whether keyframes are being streamed to file. See
+   * @ref startStreamingKeyframesToFile.
+   */
+  bool isStreamingKeyframes() const { return bool(keyframeStream_); }
+
   /**
    * @brief write saved keyframes to string. '{"keyframes": [{...},{...},...]}'
    */
@@ -152,6 +267,20 @@ class Recorder {
    */
   std::vector<std::string> writeIncrementalSavedKeyframesToStringArray();
 
+  /**
+   * @brief Publish saved keyframes to a shared-memory ring buffer, in the
+   * binary format of @ref keyframeToBinary.
+   *
+   * Incremental like @ref writeIncrementalSavedKeyframesToStringArray, but
+   * without the JSON serialization and with the consumer reading the
+   * keyframes in place. Keyframes are published in order and discarded once
+   * published. If the buffer fills up, the remaining keyframes are kept and
+   * published on the next call, so no state is lost when the consumer falls
+   * behind. Returns the number of keyframes published.
+   */
+  std::size_t writeIncrementalSavedKeyframesToRingBuffer(
+      KeyframeRingBuffer& buffer);
+
   /**
    * @brief Set the precision of the floating points serialized by this
    * recorder.
@@ -169,6 +298,18 @@ class Recorder {
    */
   std::string keyframeToString(const Keyframe& keyframe) const;
 
+  /**
+   * @brief returns the given keyframe in the compact binary format. The
+   * result can be passed to @ref Player::keyframeFromStringUnwrapped.
+   */
+  std::string keyframeToBinary(const Keyframe& keyframe) const;
+
+  /**
+   * @brief Estimated host memory of the saved keyframes, the keyframe being
+   * recorded and the tracked instances, in bytes.
+   */
+  std::size_t getMemoryUsage() const;
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -187,9 +328,18 @@ class Recorder {
     Corrade::Containers::Optional<RenderAssetInstanceState> recentState;
     NodeDeletionHelper* deletionHelper = nullptr;
     int rigId = ID_UNDEFINED;
+    Corrade::Containers::Optional<StateUpdateFilter> filter;
+    // index of the keyframe in which recentState was recorded
+    std::size_t recentStateKeyframe = 0;
+  };
+
+  struct RegionOfInterest {
+    Magnum::Vector3 center;
+    float radius;
   };
 
   using KeyframeIterator = std::vector<Keyframe>::const_iterator;
+  struct KeyframeStream;
 
   rapidjson::Document writeKeyframesToJsonDocument();
   void onDeleteRenderAssetInstance(const scene::SceneNode* node);
@@ -201,20 +351,35 @@ class Recorder {
   void updateStates();
   void updateInstanceStates();
   void updateRigInstanceStates();
+  bool isStateUpdatePostponed(const InstanceRecord& instanceRecord,
+                              const RenderAssetInstanceState& state) const;
+  bool isStateUpdateNegligible(const InstanceRecord& instanceRecord,
+                               const RenderAssetInstanceState& state) const;
   void checkAndAddDeletion(Keyframe* keyframe,
                            RenderAssetInstanceKey instanceKey);
   void addLoadsCreationsDeletions(KeyframeIterator begin,
                                   KeyframeIterator end,
                                   Keyframe* dest);
   void consolidateSavedKeyframes();
+  void streamLatestKeyframe();
+  void checkNotStreaming(const char* function) const;
+  float binaryTranslationPrecision() const;
 
+  // unordered, see onDeleteRenderAssetInstance
   std::vector<InstanceRecord> instanceRecords_;
+  std::unordered_map<const scene::SceneNode*, std::size_t>
+      instanceRecordIndices_;
   Keyframe currKeyframe_;
   std::vector<Keyframe> savedKeyframes_;
   RenderAssetInstanceKey nextInstanceKey_ = 0;
   std::unordered_map<int, std::vector<scene::SceneNode*>> rigNodes_;
   std::unordered_map<int, std::vector<Magnum::Matrix4>> rigNodeTransformCache_;
   int maxDecimalPlaces_ = DEFAULT_MAX_DECIMAL_PLACES;
+  std::unique_ptr<KeyframeStream> keyframeStream_;
+  StateUpdateFilter stateUpdateFilter_;
+  Corrade::Containers::Optional<RegionOfInterest> regionOfInterest_;
+  // incremented on every state update, used for minKeyframeInterval
+  std::size_t stateUpdateIndex_ = 0;
 
   ESP_SMART_POINTERS(Recorder)
 };
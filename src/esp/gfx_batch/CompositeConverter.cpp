@@ -0,0 +1,958 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "CompositeConverter.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/PluginManager/PluginMetadata.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/MeshTools/Concatenate.h>
+#include <Magnum/MeshTools/Filter.h>
+#include <Magnum/MeshTools/GenerateIndices.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/SceneTools/Hierarchy.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/FlatMaterialData.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MaterialData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/PbrMetallicRoughnessMaterialData.h>
+#include <Magnum/Trade/PhongMaterialData.h>
+#include <Magnum/Trade/SceneData.h>
+#include <Magnum/Trade/TextureData.h>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx_batch {
+
+namespace {
+
+/* Same IDs as the renderer test uses, the names are what matters */
+constexpr Mn::Trade::SceneField SceneFieldMeshViewIndexOffset =
+    Mn::Trade::sceneFieldCustom(0);
+constexpr Mn::Trade::SceneField SceneFieldMeshViewIndexCount =
+    Mn::Trade::sceneFieldCustom(1);
+constexpr Mn::Trade::SceneField SceneFieldMeshViewMaterial =
+    Mn::Trade::sceneFieldCustom(2);
+
+/* The minimum of GL_MAX_ARRAY_TEXTURE_LAYERS guaranteed by GL 3.3 / ES 3.0,
+   more images of the same size and format go to another texture */
+constexpr Mn::UnsignedInt MaxTextureLayers = 256;
+
+std::size_t hashBytes(const Cr::Containers::ArrayView<const char> data) {
+  const Cr::Utility::HashDigest<sizeof(std::size_t)> digest =
+      Cr::Utility::MurmurHash2{}(data.data(), data.size());
+  std::size_t hash;
+  std::memcpy(&hash, digest.byteArray(), sizeof(std::size_t));
+  return hash;
+}
+
+bool equalBytes(const Cr::Containers::ArrayView<const char> a,
+                const Cr::Containers::ArrayView<const char> b) {
+  return a.size() == b.size() &&
+         (a.isEmpty() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+/* Vertex layout of all meshes in the composite, the color is dropped from
+   meshes that don't have it */
+struct Vertex {
+  Mn::Vector3 position;
+  Mn::Vector3 normal;
+  Mn::Vector2 textureCoordinates;
+  Mn::Color4 color;
+};
+
+/* Indexed triangles with the above layout, or NullOpt if the mesh can't be
+   drawn by the renderer */
+Cr::Containers::Optional<Mn::Trade::MeshData> normalizeMesh(
+    Mn::Trade::MeshData mesh,
+    Mn::Trade::AbstractSceneConverter* const optimizer) {
+  if (mesh.primitive() == Mn::MeshPrimitive::TriangleStrip ||
+      mesh.primitive() == Mn::MeshPrimitive::TriangleFan)
+    mesh = Mn::MeshTools::generateIndices(mesh);
+  else if (mesh.primitive() != Mn::MeshPrimitive::Triangles)
+    return {};
+  if (!mesh.hasAttribute(Mn::Trade::MeshAttribute::Position))
+    return {};
+
+  const Cr::Containers::Array<Mn::UnsignedInt> indices =
+      mesh.isIndexed() ? mesh.indicesAsArray()
+                       : Mn::MeshTools::generateTrivialIndices(
+                             mesh.vertexCount());
+  const Cr::Containers::Array<Mn::Vector3> positions =
+      mesh.positions3DAsArray();
+  const bool colored = mesh.hasAttribute(Mn::Trade::MeshAttribute::Color);
+
+  Cr::Containers::Array<char> indexData{
+      Cr::NoInit, indices.size() * sizeof(Mn::UnsignedInt)};
+  const Cr::Containers::ArrayView<Mn::UnsignedInt> outputIndices =
+      Cr::Containers::arrayCast<Mn::UnsignedInt>(indexData);
+  Cr::Utility::copy(indices, outputIndices);
+
+  Cr::Containers::Array<char> vertexData{Cr::ValueInit,
+                                         positions.size() * sizeof(Vertex)};
+  const Cr::Containers::StridedArrayView1D<Vertex> vertices =
+      Cr::Containers::arrayCast<Vertex>(vertexData);
+  Cr::Utility::copy(Cr::Containers::stridedArrayView(positions),
+                    vertices.slice(&Vertex::position));
+  if (mesh.hasAttribute(Mn::Trade::MeshAttribute::Normal))
+    mesh.normalsInto(vertices.slice(&Vertex::normal));
+  else
+    Mn::MeshTools::generateSmoothNormalsInto(
+        Cr::Containers::stridedArrayView(indices),
+        Cr::Containers::stridedArrayView(positions),
+        vertices.slice(&Vertex::normal));
+  /* Texture coordinates stay zero if there are none */
+  if (mesh.hasAttribute(Mn::Trade::MeshAttribute::TextureCoordinates))
+    mesh.textureCoordinates2DInto(vertices.slice(&Vertex::textureCoordinates));
+  if (colored)
+    mesh.colorsInto(vertices.slice(&Vertex::color));
+
+  const Mn::Trade::MeshIndexData indexView{outputIndices};
+  const Mn::Trade::MeshAttributeData positionView{
+      Mn::Trade::MeshAttribute::Position, vertices.slice(&Vertex::position)};
+  const Mn::Trade::MeshAttributeData normalView{
+      Mn::Trade::MeshAttribute::Normal, vertices.slice(&Vertex::normal)};
+  const Mn::Trade::MeshAttributeData textureCoordinateView{
+      Mn::Trade::MeshAttribute::TextureCoordinates,
+      vertices.slice(&Vertex::textureCoordinates)};
+  const Mn::Trade::MeshAttributeData colorView{
+      Mn::Trade::MeshAttribute::Color, vertices.slice(&Vertex::color)};
+  Mn::Trade::MeshData out{Mn::MeshPrimitive::Triangles,
+                          std::move(indexData),
+                          indexView,
+                          std::move(vertexData),
+                          {positionView, normalView, textureCoordinateView,
+                           colorView}};
+
+  /* Drop the color if the original didn't have it */
+  out = colored ? Mn::MeshTools::removeDuplicates(out)
+                : Mn::MeshTools::removeDuplicates(
+                      Mn::MeshTools::filterExceptAttributes(
+                          out, {Mn::Trade::MeshAttribute::Color}));
+
+  if (optimizer) {
+    if (Cr::Containers::Optional<Mn::Trade::MeshData> optimized =
+            optimizer->convert(out))
+      out = *std::move(optimized);
+  }
+
+  return out;
+}
+
+/* Copy of a concatenated mesh with normals packed to normalized shorts,
+   texture coordinates to normalized unsigned shorts if they're all in
+   [0, 1] and colors to normalized unsigned bytes, which glTF allows with
+   KHR_mesh_quantization. Positions stay floats, as the renderer calculates
+   draw bounds from them and has no way to dequantize them. */
+Mn::Trade::MeshData quantizeMesh(const Mn::Trade::MeshData& mesh) {
+  const Mn::UnsignedInt vertexCount = mesh.vertexCount();
+  const Cr::Containers::Array<Mn::Vector2> textureCoordinates =
+      mesh.textureCoordinates2DAsArray();
+  bool textureCoordinatesNormalized = true;
+  for (const Mn::Vector2& i : textureCoordinates) {
+    if (i.min() < 0.0f || i.max() > 1.0f) {
+      textureCoordinatesNormalized = false;
+      break;
+    }
+  }
+  const bool colored = mesh.hasAttribute(Mn::Trade::MeshAttribute::Color);
+
+  /* glTF wants all offsets and the stride to be multiples of four, thus the
+     normal is padded */
+  const std::size_t normalOffset = sizeof(Mn::Vector3);
+  const std::size_t textureCoordinateOffset = normalOffset + 8;
+  const std::size_t colorOffset =
+      textureCoordinateOffset + (textureCoordinatesNormalized
+                                     ? sizeof(Mn::Vector2us)
+                                     : sizeof(Mn::Vector2));
+  const std::size_t stride =
+      colorOffset + (colored ? sizeof(Mn::Vector4ub) : 0);
+
+  const auto attributeStride = std::ptrdiff_t(stride);
+  Cr::Containers::Array<Mn::Trade::MeshAttributeData> attributes;
+  arrayAppend(attributes, Cr::InPlaceInit, Mn::Trade::MeshAttribute::Position,
+              Mn::VertexFormat::Vector3, 0, vertexCount, attributeStride);
+  arrayAppend(attributes, Cr::InPlaceInit, Mn::Trade::MeshAttribute::Normal,
+              Mn::VertexFormat::Vector3sNormalized, normalOffset, vertexCount,
+              attributeStride);
+  arrayAppend(attributes, Cr::InPlaceInit,
+              Mn::Trade::MeshAttribute::TextureCoordinates,
+              textureCoordinatesNormalized
+                  ? Mn::VertexFormat::Vector2usNormalized
+                  : Mn::VertexFormat::Vector2,
+              textureCoordinateOffset, vertexCount, attributeStride);
+  if (colored)
+    arrayAppend(attributes, Cr::InPlaceInit, Mn::Trade::MeshAttribute::Color,
+                Mn::VertexFormat::Vector4ubNormalized, colorOffset,
+                vertexCount, attributeStride);
+
+  Cr::Containers::Array<char> indexData{Cr::NoInit, mesh.indexData().size()};
+  Cr::Utility::copy(mesh.indexData(), indexData);
+  const Mn::Trade::MeshIndexData indices{mesh.indexType(), indexData};
+  Mn::Trade::MeshData out{Mn::MeshPrimitive::Triangles,
+                          std::move(indexData),
+                          indices,
+                          Cr::Containers::Array<char>{Cr::ValueInit,
+                                                      stride * vertexCount},
+                          std::move(attributes)};
+
+  Cr::Utility::copy(
+      mesh.positions3DAsArray(),
+      out.mutableAttribute<Mn::Vector3>(Mn::Trade::MeshAttribute::Position));
+  const Cr::Containers::Array<Mn::Vector3> normals = mesh.normalsAsArray();
+  const Cr::Containers::StridedArrayView1D<Mn::Vector3s> outNormals =
+      out.mutableAttribute<Mn::Vector3s>(Mn::Trade::MeshAttribute::Normal);
+  for (std::size_t i = 0; i != vertexCount; ++i)
+    outNormals[i] = Mn::Math::pack<Mn::Vector3s>(normals[i]);
+  if (textureCoordinatesNormalized) {
+    const Cr::Containers::StridedArrayView1D<Mn::Vector2us>
+        outTextureCoordinates = out.mutableAttribute<Mn::Vector2us>(
+            Mn::Trade::MeshAttribute::TextureCoordinates);
+    for (std::size_t i = 0; i != vertexCount; ++i)
+      outTextureCoordinates[i] =
+          Mn::Math::pack<Mn::Vector2us>(textureCoordinates[i]);
+  } else {
+    Cr::Utility::copy(textureCoordinates,
+                      out.mutableAttribute<Mn::Vector2>(
+                          Mn::Trade::MeshAttribute::TextureCoordinates));
+  }
+  if (colored) {
+    const Cr::Containers::Array<Mn::Color4> colors = mesh.colorsAsArray();
+    const Cr::Containers::StridedArrayView1D<Mn::Vector4ub> outColors =
+        out.mutableAttribute<Mn::Vector4ub>(Mn::Trade::MeshAttribute::Color);
+    for (std::size_t i = 0; i != vertexCount; ++i)
+      outColors[i] = Mn::Math::pack<Mn::Vector4ub>(Mn::Vector4{colors[i]});
+  }
+
+  return out;
+}
+
+/* Color, base color texture and its transformation of a material, which is
+   all the renderer uses */
+struct FileMaterial {
+  bool flat;
+  Mn::Color4 color;
+  /* -1 if untextured */
+  Mn::Int texture;
+  /* Used only if the texture is a 2D array */
+  Mn::UnsignedInt textureLayer;
+  Mn::Matrix3 textureMatrix;
+};
+
+FileMaterial extractMaterial(const Mn::Trade::MaterialData& material) {
+  FileMaterial out{false, Mn::Color4{1.0f}, -1, 0, {}};
+  if (material.types() & Mn::Trade::MaterialType::Flat) {
+    const auto& flat = material.as<Mn::Trade::FlatMaterialData>();
+    out.flat = true;
+    out.color = flat.color();
+    if (flat.hasTexture()) {
+      out.texture = flat.texture();
+      out.textureLayer = flat.textureLayer();
+      out.textureMatrix = flat.textureMatrix();
+    }
+  } else if (material.hasAttribute(
+                 Mn::Trade::MaterialAttribute::BaseColor) ||
+             material.hasAttribute(
+                 Mn::Trade::MaterialAttribute::BaseColorTexture)) {
+    const auto& pbr =
+        material.as<Mn::Trade::PbrMetallicRoughnessMaterialData>();
+    out.color = pbr.baseColor();
+    if (pbr.hasAttribute(Mn::Trade::MaterialAttribute::BaseColorTexture)) {
+      out.texture = pbr.baseColorTexture();
+      out.textureLayer = pbr.baseColorTextureLayer();
+      out.textureMatrix = pbr.baseColorTextureMatrix();
+    }
+  } else {
+    const auto& phong = material.as<Mn::Trade::PhongMaterialData>();
+    out.color = phong.diffuseColor();
+    if (phong.hasAttribute(Mn::Trade::MaterialAttribute::DiffuseTexture)) {
+      out.texture = phong.diffuseTexture();
+      out.textureLayer = phong.diffuseTextureLayer();
+      out.textureMatrix = phong.diffuseTextureMatrix();
+    }
+  }
+  return out;
+}
+
+/* Mesh of a file, in the file mesh ID, material ID and transformation */
+struct FileChild {
+  Mn::UnsignedInt mesh;
+  Mn::Int material;
+  Mn::Matrix4 transformation;
+};
+
+/* Level 0 of a 2D image or of a layer of a 2D array image. Uncompressed
+   data are repacked to the default four-byte row alignment so all layers of
+   a texture array have the same layout, the padding zeroed so it doesn't
+   make equal images differ. */
+struct FileImage {
+  bool compressed;
+  Mn::PixelFormat format;
+  Mn::CompressedPixelFormat compressedFormat;
+  Mn::Vector2i size;
+  Cr::Containers::Array<char> data;
+};
+
+FileImage extractImage(const Mn::PixelFormat format,
+                       const Mn::Vector2i& size,
+                       const Cr::Containers::StridedArrayView3D<const char>&
+                           pixels) {
+  FileImage out{false, format, {}, size, {}};
+  const std::size_t rowSize =
+      (std::size_t(size.x()) * pixels.size()[2] + 3) / 4 * 4;
+  out.data = Cr::Containers::Array<char>{Cr::ValueInit, rowSize * size.y()};
+  Cr::Utility::copy(pixels,
+                    Mn::MutableImageView2D{format, size, out.data}.pixels());
+  return out;
+}
+
+FileImage extractImage(const Mn::CompressedPixelFormat format,
+                       const Mn::Vector2i& size,
+                       const Cr::Containers::ArrayView<const char> data) {
+  FileImage out{true, {}, format, size, {}};
+  out.data = Cr::Containers::Array<char>{Cr::NoInit, data.size()};
+  Cr::Utility::copy(data, out.data);
+  return out;
+}
+
+FileImage extractImage(const Mn::Trade::ImageData2D& image) {
+  return image.isCompressed()
+             ? extractImage(image.compressedFormat(), image.size(),
+                            image.data())
+             : extractImage(image.format(), image.size(), image.pixels());
+}
+
+FileImage extractImage(const Mn::Trade::ImageData3D& image,
+                       const Mn::UnsignedInt layer) {
+  if (!image.isCompressed())
+    return extractImage(image.format(), image.size().xy(),
+                        image.pixels()[layer]);
+
+  /* Layers of a compressed image are consecutive whole blocks */
+  const Mn::Vector3i blockSize =
+      Mn::compressedPixelFormatBlockSize(image.compressedFormat());
+  const std::size_t layerSize =
+      std::size_t(((image.size().xy() + blockSize.xy() - Mn::Vector2i{1}) /
+                   blockSize.xy())
+                      .product()) *
+      Mn::compressedPixelFormatBlockDataSize(image.compressedFormat());
+  return extractImage(image.compressedFormat(), image.size().xy(),
+                      image.data().sliceSize(layer * layerSize, layerSize));
+}
+
+struct FileTexture {
+  /* Only for the sampler */
+  Mn::Trade::TextureData texture;
+  FileImage image;
+};
+
+/* Texture ID and layer of a textured material */
+Mn::UnsignedLong textureKey(const FileMaterial& material) {
+  return Mn::UnsignedLong(material.texture) << 32 | material.textureLayer;
+}
+
+}  // namespace
+
+struct CompositeConverter::State {
+  struct Mesh {
+    Mn::Trade::MeshData data;
+    bool colored;
+    std::size_t hash;
+  };
+
+  struct Image {
+    FileImage image;
+    Mn::UnsignedInt textureArray;
+    Mn::UnsignedInt layer;
+  };
+
+  struct TextureArray {
+    bool compressed;
+    Mn::PixelFormat format;
+    Mn::CompressedPixelFormat compressedFormat;
+    Mn::Vector2i size;
+    /* Sampler of the first texture that got a layer here */
+    Mn::SamplerFilter minificationFilter;
+    Mn::SamplerFilter magnificationFilter;
+    Mn::SamplerMipmap mipmapFilter;
+    Mn::Math::Vector3<Mn::SamplerWrapping> wrapping;
+    Mn::UnsignedInt layerCount;
+  };
+
+  struct Material {
+    bool flat;
+    Mn::Color4 color;
+    /* -1 if untextured */
+    Mn::Int textureArray;
+    Mn::UnsignedInt layer;
+    Mn::Matrix3 textureMatrix;
+  };
+
+  struct Child {
+    Mn::UnsignedInt mesh;
+    Mn::Int material;
+    Mn::Matrix4 transformation;
+  };
+
+  struct Hierarchy {
+    std::string name;
+    std::vector<Child> children;
+  };
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager;
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter>
+      imageConverterManager;
+  Cr::PluginManager::Manager<Mn::Trade::AbstractSceneConverter>
+      converterManager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractSceneConverter> meshOptimizer;
+
+  std::vector<Mesh> meshes;
+  std::unordered_multimap<std::size_t, Mn::UnsignedInt> meshesByHash;
+  std::vector<Image> images;
+  std::unordered_multimap<std::size_t, Mn::UnsignedInt> imagesByHash;
+  std::vector<TextureArray> textureArrays;
+  std::vector<Material> materials;
+  std::vector<Hierarchy> hierarchies;
+  std::unordered_set<std::string> hierarchyNames;
+  bool quantizeVertexAttributes = false;
+
+  Mn::UnsignedInt addMesh(Mn::Trade::MeshData&& mesh);
+  Mn::Int addMaterial(const FileMaterial& material, const FileTexture* texture);
+  Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt> addImage(
+      const FileTexture& texture);
+};
+
+Mn::UnsignedInt CompositeConverter::State::addMesh(Mn::Trade::MeshData&& mesh) {
+  const bool colored = mesh.hasAttribute(Mn::Trade::MeshAttribute::Color);
+  const std::size_t hash =
+      hashBytes(mesh.indexData()) ^ (hashBytes(mesh.vertexData()) << 1);
+  const auto found = meshesByHash.equal_range(hash);
+  for (auto it = found.first; it != found.second; ++it) {
+    const Mn::Trade::MeshData& other = meshes[it->second].data;
+    if (meshes[it->second].colored == colored &&
+        other.indexType() == mesh.indexType() &&
+        equalBytes(other.indexData(), mesh.indexData()) &&
+        equalBytes(other.vertexData(), mesh.vertexData()))
+      return it->second;
+  }
+
+  const Mn::UnsignedInt id = meshes.size();
+  meshes.push_back(Mesh{std::move(mesh), colored, hash});
+  meshesByHash.emplace(hash, id);
+  return id;
+}
+
+Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt>
+CompositeConverter::State::addImage(const FileTexture& texture) {
+  const FileImage& image = texture.image;
+  const std::size_t hash = hashBytes(image.data);
+  const auto found = imagesByHash.equal_range(hash);
+  for (auto it = found.first; it != found.second; ++it) {
+    const FileImage& other = images[it->second].image;
+    if (other.compressed == image.compressed &&
+        other.format == image.format &&
+        other.compressedFormat == image.compressedFormat &&
+        other.size == image.size && equalBytes(other.data, image.data))
+      return {images[it->second].textureArray, images[it->second].layer};
+  }
+
+  /* Find a texture array of the same size and format that has space left,
+     or make a new one */
+  std::size_t textureArray = 0;
+  for (; textureArray != textureArrays.size(); ++textureArray) {
+    const TextureArray& candidate = textureArrays[textureArray];
+    if (candidate.compressed == image.compressed &&
+        candidate.format == image.format &&
+        candidate.compressedFormat == image.compressedFormat &&
+        candidate.size == image.size &&
+        candidate.layerCount < MaxTextureLayers)
+      break;
+  }
+  if (textureArray == textureArrays.size())
+    textureArrays.push_back(TextureArray{
+        image.compressed, image.format, image.compressedFormat, image.size,
+        texture.texture.minificationFilter(),
+        texture.texture.magnificationFilter(), texture.texture.mipmapFilter(),
+        texture.texture.wrapping(), 0});
+
+  const Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt> location{
+      Mn::UnsignedInt(textureArray),
+      textureArrays[textureArray].layerCount++};
+  /* The same texture may be used by more than one material, copy */
+  Cr::Containers::Array<char> data{Cr::NoInit, image.data.size()};
+  Cr::Utility::copy(image.data, data);
+  imagesByHash.emplace(hash, images.size());
+  images.push_back(Image{FileImage{image.compressed, image.format,
+                                   image.compressedFormat, image.size,
+                                   std::move(data)},
+                         location.first(), location.second()});
+  return location;
+}
+
+Mn::Int CompositeConverter::State::addMaterial(const FileMaterial& material,
+                                               const FileTexture* texture) {
+  Material out{material.flat, material.color, -1, 0, {}};
+  if (texture) {
+    const Cr::Containers::Pair<Mn::UnsignedInt, Mn::UnsignedInt> location =
+        addImage(*texture);
+    out.textureArray = location.first();
+    out.layer = location.second();
+    out.textureMatrix = material.textureMatrix;
+  }
+
+  /* There's usually just a few hundred materials, a linear search is fine */
+  for (std::size_t i = 0; i != materials.size(); ++i) {
+    const Material& other = materials[i];
+    if (other.flat == out.flat && other.color == out.color &&
+        other.textureArray == out.textureArray && other.layer == out.layer &&
+        other.textureMatrix == out.textureMatrix)
+      return i;
+  }
+
+  materials.push_back(out);
+  return materials.size() - 1;
+}
+
+CompositeConverter::CompositeConverter() : state_{Cr::InPlaceInit} {
+  state_->converterManager.registerExternalManager(
+      state_->imageConverterManager);
+
+  /* Basis files get decoded to plain RGBA, which is what every GPU can use
+     and what KtxImageConverter can write */
+  if (Cr::PluginManager::PluginMetadata* const metadata =
+          state_->importerManager.metadata("BasisImporter"))
+    metadata->configuration().setValue("format", "RGBA8");
+
+  if (state_->converterManager.loadState("MeshOptimizerSceneConverter") !=
+      Cr::PluginManager::LoadState::NotFound)
+    state_->meshOptimizer = state_->converterManager.loadAndInstantiate(
+        "MeshOptimizerSceneConverter");
+}
+
+CompositeConverter::~CompositeConverter() = default;
+
+bool CompositeConverter::addFile(const Cr::Containers::StringView filename,
+                                 const Cr::Containers::StringView name) {
+  State& state = *state_;
+  const Cr::Containers::StringView hierarchyName =
+      name.isEmpty() ? filename : name;
+  if (state.hierarchyNames.count(hierarchyName)) {
+    Mn::Error{} << "CompositeConverter::addFile(): node hierarchy"
+                << hierarchyName << "already added";
+    return false;
+  }
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      state.importerManager.loadAndInstantiate("AnySceneImporter");
+  if (!importer)
+    return false;
+  /* Same as Renderer::addFile(), so composites can be combined as well */
+  if (filename.hasSuffix(".gltf") || filename.hasSuffix(".glb")) {
+    importer->configuration().setValue("ignoreRequiredExtensions", true);
+    importer->configuration().setValue("experimentalKhrTextureKtx", true);
+  }
+  if (!importer->openFile(filename)) {
+    Mn::Error{} << "CompositeConverter::addFile(): can't open" << filename;
+    return false;
+  }
+
+  /* Import everything first so a failure leaves the converter untouched */
+  std::vector<Cr::Containers::Optional<Mn::Trade::MeshData>> meshes;
+  for (Mn::UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+    Cr::Containers::Optional<Mn::Trade::MeshData> mesh = importer->mesh(i);
+    if (!mesh) {
+      Mn::Error{} << "CompositeConverter::addFile(): can't import mesh" << i
+                  << "of" << filename;
+      return false;
+    }
+    meshes.push_back(
+        normalizeMesh(*std::move(mesh), state.meshOptimizer.get()));
+    if (!meshes.back())
+      Mn::Warning{} << "CompositeConverter::addFile(): skipping mesh" << i
+                    << "of" << filename << "that isn't a triangle mesh";
+  }
+
+  std::vector<FileMaterial> materials;
+  std::unordered_map<Mn::UnsignedLong, FileTexture> textures;
+  /* Images of 2D array textures, of which more than one layer can be used */
+  std::unordered_map<Mn::UnsignedInt, Mn::Trade::ImageData3D> arrayImages;
+  for (Mn::UnsignedInt i = 0; i != importer->materialCount(); ++i) {
+    Cr::Containers::Optional<Mn::Trade::MaterialData> material =
+        importer->material(i);
+    if (!material) {
+      Mn::Error{} << "CompositeConverter::addFile(): can't import material"
+                  << i << "of" << filename;
+      return false;
+    }
+    materials.push_back(extractMaterial(*material));
+
+    FileMaterial& extracted = materials.back();
+    if (extracted.texture == -1)
+      continue;
+    Cr::Containers::Optional<Mn::Trade::TextureData> texture =
+        importer->texture(extracted.texture);
+    if (!texture) {
+      Mn::Error{} << "CompositeConverter::addFile(): can't import texture"
+                  << extracted.texture << "of" << filename;
+      return false;
+    }
+    if (texture->type() == Mn::Trade::TextureType::Texture2D) {
+      extracted.textureLayer = 0;
+    } else if (texture->type() != Mn::Trade::TextureType::Texture2DArray) {
+      Mn::Warning{} << "CompositeConverter::addFile(): ignoring"
+                    << texture->type() << "of material" << i << "of"
+                    << filename;
+      extracted.texture = -1;
+      continue;
+    }
+    if (textures.count(textureKey(extracted)))
+      continue;
+
+    const Mn::UnsignedInt imageId = texture->image();
+    if (texture->type() == Mn::Trade::TextureType::Texture2D) {
+      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+          importer->image2D(imageId);
+      if (!image) {
+        Mn::Error{} << "CompositeConverter::addFile(): can't import image"
+                    << imageId << "of" << filename;
+        return false;
+      }
+      textures.emplace(textureKey(extracted),
+                       FileTexture{*std::move(texture), extractImage(*image)});
+      continue;
+    }
+
+    auto image = arrayImages.find(imageId);
+    if (image == arrayImages.end()) {
+      Cr::Containers::Optional<Mn::Trade::ImageData3D> imported =
+          importer->image3D(imageId);
+      if (!imported) {
+        Mn::Error{} << "CompositeConverter::addFile(): can't import image"
+                    << imageId << "of" << filename;
+        return false;
+      }
+      image = arrayImages.emplace(imageId, *std::move(imported)).first;
+    }
+    if (extracted.textureLayer >= Mn::UnsignedInt(image->second.size().z())) {
+      Mn::Error{} << "CompositeConverter::addFile(): material" << i << "of"
+                  << filename << "references layer" << extracted.textureLayer
+                  << "of a" << image->second.size().z() << Mn::Debug::nospace
+                  << "-layer image";
+      return false;
+    }
+    textures.emplace(
+        textureKey(extracted),
+        FileTexture{*std::move(texture),
+                    extractImage(image->second, extracted.textureLayer)});
+  }
+
+  std::vector<FileChild> children;
+  if (!importer->sceneCount()) {
+    for (Mn::UnsignedInt i = 0; i != meshes.size(); ++i)
+      children.push_back({i, -1, {}});
+  } else {
+    const Mn::Int sceneId =
+        importer->defaultScene() == -1 ? 0 : importer->defaultScene();
+    Cr::Containers::Optional<Mn::Trade::SceneData> scene =
+        importer->scene(sceneId);
+    if (!scene || !scene->is3D()) {
+      Mn::Error{} << "CompositeConverter::addFile(): can't import a 3D scene"
+                  << sceneId << "of" << filename;
+      return false;
+    }
+    const Cr::Containers::Array<Cr::Containers::Pair<
+        Mn::UnsignedInt, Cr::Containers::Pair<Mn::UnsignedInt, Mn::Int>>>
+        meshesMaterials = scene->meshesMaterialsAsArray();
+    const Cr::Containers::Array<Mn::Matrix4> transformations =
+        scene->hasField(Mn::Trade::SceneField::Parent)
+            ? Mn::SceneTools::absoluteFieldTransformations3D(
+                  *scene, Mn::Trade::SceneField::Mesh)
+            : Cr::Containers::Array<Mn::Matrix4>{Cr::ValueInit,
+                                                 meshesMaterials.size()};
+    for (std::size_t i = 0; i != meshesMaterials.size(); ++i)
+      children.push_back({meshesMaterials[i].second().first(),
+                          meshesMaterials[i].second().second(),
+                          transformations[i]});
+  }
+
+  /* Everything imported, add just what the scene references */
+  std::vector<Mn::Int> meshIds(meshes.size(), -1);
+  std::vector<Mn::Int> materialIds(materials.size(), -2);
+  State::Hierarchy hierarchy{hierarchyName, {}};
+  for (const FileChild& child : children) {
+    if (!meshes[child.mesh])
+      continue;
+    if (meshIds[child.mesh] == -1)
+      meshIds[child.mesh] = state.addMesh(*std::move(meshes[child.mesh]));
+
+    Mn::Int material = -1;
+    if (child.material != -1) {
+      if (materialIds[child.material] == -2) {
+        const FileMaterial& fileMaterial = materials[child.material];
+        materialIds[child.material] = state.addMaterial(
+            fileMaterial, fileMaterial.texture == -1
+                              ? nullptr
+                              : &textures.at(textureKey(fileMaterial)));
+      }
+      material = materialIds[child.material];
+    }
+
+    hierarchy.children.push_back(
+        {Mn::UnsignedInt(meshIds[child.mesh]), material, child.transformation});
+  }
+
+  state.hierarchyNames.insert(hierarchy.name);
+  state.hierarchies.push_back(std::move(hierarchy));
+  return true;
+}
+
+bool CompositeConverter::hasNodeHierarchy(
+    const Cr::Containers::StringView name) const {
+  return state_->hierarchyNames.count(name);
+}
+
+bool CompositeConverter::quantizeVertexAttributes() const {
+  return state_->quantizeVertexAttributes;
+}
+
+CompositeConverter& CompositeConverter::setQuantizeVertexAttributes(
+    const bool quantize) {
+  state_->quantizeVertexAttributes = quantize;
+  return *this;
+}
+
+std::size_t CompositeConverter::nodeHierarchyCount() const {
+  return state_->hierarchies.size();
+}
+
+std::size_t CompositeConverter::meshCount() const {
+  return state_->meshes.size();
+}
+
+std::size_t CompositeConverter::imageCount() const {
+  return state_->images.size();
+}
+
+std::size_t CompositeConverter::materialCount() const {
+  return state_->materials.size();
+}
+
+bool CompositeConverter::convertToFile(
+    const Cr::Containers::StringView filename) {
+  State& state = *state_;
+  if (state.imageConverterManager.loadState("KtxImageConverter") ==
+      Cr::PluginManager::LoadState::NotFound) {
+    Mn::Error{} << "CompositeConverter::convertToFile(): KtxImageConverter "
+                   "plugin not found";
+    return false;
+  }
+  Cr::Containers::Pointer<Mn::Trade::AbstractSceneConverter> converter =
+      state.converterManager.loadAndInstantiate("GltfSceneConverter");
+  if (!converter)
+    return false;
+
+  converter->configuration().setValue("experimentalKhrTextureKtx", true);
+  converter->configuration().setValue("imageConverter", "KtxImageConverter");
+  converter->configuration().setValue("bundleImages", true);
+  /* To prevent the file from being opened by unsuspecting libraries */
+  converter->configuration().addValue("extensionUsed", "MAGNUMX_mesh_views");
+  converter->configuration().addValue("extensionRequired",
+                                      "MAGNUMX_mesh_views");
+
+  if (!converter->beginFile(filename))
+    return false;
+  converter->setSceneFieldName(SceneFieldMeshViewIndexOffset,
+                               "meshViewIndexOffset");
+  converter->setSceneFieldName(SceneFieldMeshViewIndexCount,
+                               "meshViewIndexCount");
+  converter->setSceneFieldName(SceneFieldMeshViewMaterial, "meshViewMaterial");
+
+  /* One concatenated mesh for each vertex layout. The concatenated index
+     type is always 32-bit, offsets are in bytes. */
+  std::vector<Mn::UnsignedInt> meshGlobalIds(state.meshes.size());
+  std::vector<Mn::UnsignedInt> meshIndexOffsets(state.meshes.size());
+  for (const bool colored : {false, true}) {
+    Cr::Containers::Array<Cr::Containers::Reference<const Mn::Trade::MeshData>>
+        group;
+    Mn::UnsignedInt indexCount = 0;
+    for (std::size_t i = 0; i != state.meshes.size(); ++i) {
+      if (state.meshes[i].colored != colored)
+        continue;
+      arrayAppend(group, state.meshes[i].data);
+      meshIndexOffsets[i] = indexCount * sizeof(Mn::UnsignedInt);
+      indexCount += state.meshes[i].data.indexCount();
+    }
+    if (group.isEmpty())
+      continue;
+
+    /* The converter marks the file as requiring KHR_mesh_quantization if
+       there are quantized attributes */
+    Mn::Trade::MeshData concatenated = Mn::MeshTools::concatenate(group);
+    if (state.quantizeVertexAttributes)
+      concatenated = quantizeMesh(concatenated);
+    const Cr::Containers::Optional<Mn::UnsignedInt> id =
+        converter->add(concatenated);
+    if (!id) {
+      converter->abort();
+      return false;
+    }
+    for (std::size_t i = 0; i != state.meshes.size(); ++i)
+      if (state.meshes[i].colored == colored)
+        meshGlobalIds[i] = *id;
+  }
+
+  /* One image and texture for each texture array, in the same order */
+  for (std::size_t i = 0; i != state.textureArrays.size(); ++i) {
+    const State::TextureArray& textureArray = state.textureArrays[i];
+    Cr::Containers::Array<char> data;
+    for (const State::Image& image : state.images)
+      if (image.textureArray == i)
+        arrayAppend(data, image.image.data);
+
+    const Mn::Vector3i size{textureArray.size,
+                            Mn::Int(textureArray.layerCount)};
+    const Cr::Containers::Optional<Mn::UnsignedInt> image =
+        textureArray.compressed
+            ? converter->add(Mn::CompressedImageView3D{
+                  textureArray.compressedFormat, size, data,
+                  Mn::ImageFlag3D::Array})
+            : converter->add(Mn::ImageView3D{textureArray.format, size, data,
+                                             Mn::ImageFlag3D::Array});
+    if (!image || !converter->add(Mn::Trade::TextureData{
+                      Mn::Trade::TextureType::Texture2DArray,
+                      textureArray.minificationFilter,
+                      textureArray.magnificationFilter,
+                      textureArray.mipmapFilter, textureArray.wrapping,
+                      *image})) {
+      converter->abort();
+      return false;
+    }
+  }
+
+  /* Base color attributes for both, the importer provides the Phong diffuse
+     color the renderer uses for shaded materials */
+  for (const State::Material& material : state.materials) {
+    const Mn::Trade::MaterialAttributeData color{
+        Mn::Trade::MaterialAttribute::BaseColor, material.color};
+    using Attributes = Cr::Containers::Array<Mn::Trade::MaterialAttributeData>;
+    Attributes attributes =
+        material.textureArray == -1
+            ? Attributes{Cr::InPlaceInit, {color}}
+            : Attributes{
+                  Cr::InPlaceInit,
+                  {color,
+                   {Mn::Trade::MaterialAttribute::BaseColorTexture,
+                    Mn::UnsignedInt(material.textureArray)},
+                   {Mn::Trade::MaterialAttribute::BaseColorTextureLayer,
+                    material.layer},
+                   {Mn::Trade::MaterialAttribute::BaseColorTextureMatrix,
+                    material.textureMatrix}}};
+    if (!converter->add(Mn::Trade::MaterialData{
+            material.flat
+                ? Mn::Trade::MaterialTypes{Mn::Trade::MaterialType::Flat}
+                : Mn::Trade::MaterialTypes{},
+            std::move(attributes)})) {
+      converter->abort();
+      return false;
+    }
+  }
+
+  /* A root for each hierarchy followed by its children */
+  std::size_t objectCount = 0;
+  std::size_t childCount = 0;
+  for (const State::Hierarchy& hierarchy : state.hierarchies) {
+    objectCount += 1 + hierarchy.children.size();
+    childCount += hierarchy.children.size();
+  }
+  Cr::Containers::ArrayView<Mn::UnsignedInt> parentMapping;
+  Cr::Containers::ArrayView<Mn::Int> parents;
+  Cr::Containers::ArrayView<Mn::UnsignedInt> meshMapping;
+  Cr::Containers::ArrayView<Mn::UnsignedInt> meshes;
+  Cr::Containers::ArrayView<Mn::UnsignedInt> meshViewIndexOffsets;
+  Cr::Containers::ArrayView<Mn::UnsignedInt> meshViewIndexCounts;
+  Cr::Containers::ArrayView<Mn::Int> meshViewMaterials;
+  Cr::Containers::ArrayView<Mn::Matrix4> transformations;
+  Cr::Containers::ArrayTuple data{
+      {Cr::NoInit, objectCount, parentMapping},
+      {Cr::NoInit, objectCount, parents},
+      {Cr::NoInit, childCount, meshMapping},
+      {Cr::NoInit, childCount, meshes},
+      {Cr::NoInit, childCount, meshViewIndexOffsets},
+      {Cr::NoInit, childCount, meshViewIndexCounts},
+      {Cr::NoInit, childCount, meshViewMaterials},
+      {Cr::NoInit, childCount, transformations}};
+  Mn::UnsignedInt object = 0;
+  std::size_t child = 0;
+  for (const State::Hierarchy& hierarchy : state.hierarchies) {
+    const Mn::UnsignedInt root = object++;
+    converter->setObjectName(root, hierarchy.name);
+    parentMapping[root] = root;
+    parents[root] = -1;
+    for (const State::Child& c : hierarchy.children) {
+      parentMapping[object] = object;
+      parents[object] = root;
+      meshMapping[child] = object;
+      meshes[child] = meshGlobalIds[c.mesh];
+      meshViewIndexOffsets[child] = meshIndexOffsets[c.mesh];
+      meshViewIndexCounts[child] = state.meshes[c.mesh].data.indexCount();
+      meshViewMaterials[child] = c.material;
+      transformations[child] = c.transformation;
+      ++object;
+      ++child;
+    }
+  }
+
+  if (!converter->add(Mn::Trade::SceneData{
+          Mn::Trade::SceneMappingType::UnsignedInt,
+          objectCount,
+          {},
+          Cr::Containers::ArrayView<const void>{data.data(), data.size()},
+          {Mn::Trade::SceneFieldData{Mn::Trade::SceneField::Parent,
+                                     parentMapping, parents},
+           Mn::Trade::SceneFieldData{Mn::Trade::SceneField::Mesh, meshMapping,
+                                     meshes},
+           Mn::Trade::SceneFieldData{SceneFieldMeshViewIndexOffset,
+                                     meshMapping, meshViewIndexOffsets},
+           Mn::Trade::SceneFieldData{SceneFieldMeshViewIndexCount,
+                                     meshMapping, meshViewIndexCounts},
+           Mn::Trade::SceneFieldData{SceneFieldMeshViewMaterial, meshMapping,
+                                     meshViewMaterials},
+           Mn::Trade::SceneFieldData{Mn::Trade::SceneField::Transformation,
+                                     meshMapping, transformations}}})) {
+    converter->abort();
+    return false;
+  }
+
+  return converter->endFile();
+}
+
+}  // namespace gfx_batch
+}  // namespace esp
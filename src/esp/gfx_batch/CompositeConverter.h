@@ -0,0 +1,130 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_BATCH_COMPOSITECONVERTER_H_
+#define ESP_GFX_BATCH_COMPOSITECONVERTER_H_
+
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <cstddef>
+
+namespace esp {
+namespace gfx_batch {
+
+/**
+@brief Composite file converter
+
+Combines regular scene files into a single *composite* file, which can then
+be loaded with @ref Renderer::addFile() and its contents added with
+@ref Renderer::addNodeHierarchy() under the names given in @ref addFile()
+here. Compared to adding the files to the renderer one by one, all meshes,
+textures and materials of a composite are drawn with a handful of GPU
+resources:
+
+-   Meshes are converted to indexed triangles with positions, normals and
+    texture coordinates, plus vertex colors if the original had them,
+    deduplicated vertex-wise and, if the
+    @relativeref{Magnum::Trade,MeshOptimizerSceneConverter} plugin is
+    available, optimized for vertex cache and fetch. They're then
+    concatenated into a single mesh for each of the two layouts and
+    referenced through mesh views. Meshes with the same data are stored just
+    once, even if they come from different files.
+-   Base color or diffuse textures are packed into 2D array textures, one for
+    each distinct image size and format, with identical images stored just
+    once. Only the first mip level is kept, the renderer generates the rest.
+-   Materials are converted to the flat or shaded materials the renderer
+    draws, again with identical materials stored just once.
+
+With @ref setQuantizeVertexAttributes() enabled, normals, texture
+coordinates and vertex colors are written in 16- and 8-bit normalized
+formats using the `KHR_mesh_quantization` glTF extension. The renderer
+uploads them to the GPU as-is, so a vertex takes 24 instead of 32 bytes on
+disk and on the GPU, or 28 instead of 48 bytes with vertex colors.
+
+The hierarchy of every file is flattened, with each mesh of the scene being
+an immediate child of the named root node with its absolute transformation,
+which is what the renderer expects. Files without a scene contribute all
+their meshes with an identity transformation and a default material.
+Primitives other than triangles, and everything except meshes, materials and
+textures (such as lights, cameras or skins) are ignored.
+
+Writing the file needs the @relativeref{Magnum::Trade,GltfSceneConverter} and
+@relativeref{Magnum::Trade,KtxImageConverter} plugins.
+*/
+class CompositeConverter {
+ public:
+  explicit CompositeConverter();
+
+  ~CompositeConverter();
+
+  /** @brief Copying is not allowed */
+  CompositeConverter(const CompositeConverter&) = delete;
+
+  /** @brief Copying is not allowed */
+  CompositeConverter& operator=(const CompositeConverter&) = delete;
+
+  /**
+   * @brief Add a file as a node hierarchy
+   * @param filename  File to import with
+   *    @relativeref{Magnum::Trade,AnySceneImporter}
+   * @param name      Name of the node hierarchy. If empty, @p filename is
+   *    used.
+   * @return Whether the file was added
+   *
+   * Fails and adds nothing if a node hierarchy of the same name was added
+   * already, if the file can't be opened or if any of its meshes, materials
+   * or textures can't be imported.
+   */
+  bool addFile(Corrade::Containers::StringView filename,
+               Corrade::Containers::StringView name = {});
+
+  /** @brief Whether vertex attributes are quantized */
+  bool quantizeVertexAttributes() const;
+
+  /**
+   * @brief Set whether to quantize vertex attributes
+   * @return Reference to self (for method chaining)
+   *
+   * If enabled, @ref convertToFile() packs normals to normalized 16-bit
+   * integers, texture coordinates to normalized unsigned 16-bit integers if
+   * all of them are in the @f$ [0, 1] @f$ range and vertex colors to
+   * normalized unsigned 8-bit integers. Positions stay floating-point. Files
+   * written this way need an importer supporting `KHR_mesh_quantization`.
+   * Disabled by default.
+   */
+  CompositeConverter& setQuantizeVertexAttributes(bool quantize);
+
+  /** @brief Whether a node hierarchy of given name was added */
+  bool hasNodeHierarchy(Corrade::Containers::StringView name) const;
+
+  /** @brief Count of added node hierarchies */
+  std::size_t nodeHierarchyCount() const;
+
+  /** @brief Count of meshes after deduplication */
+  std::size_t meshCount() const;
+
+  /** @brief Count of images, i.e. texture layers, after deduplication */
+  std::size_t imageCount() const;
+
+  /** @brief Count of materials after deduplication */
+  std::size_t materialCount() const;
+
+  /**
+   * @brief Write the composite file
+   * @return Whether the file was written
+   *
+   * The file should have a `*.gltf` or `*.glb` extension. Can be called
+   * repeatedly, with more files added in between.
+   */
+  bool convertToFile(Corrade::Containers::StringView filename);
+
+ private:
+  struct State;
+  Corrade::Containers::Pointer<State> state_;
+};
+
+}  // namespace gfx_batch
+}  // namespace esp
+
+#endif  // ESP_GFX_BATCH_COMPOSITECONVERTER_H_
@@ -3,11 +3,15 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "DepthUnprojection.h"
+#include "ShaderCache.h"
 
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/Version.h>
@@ -25,7 +29,10 @@ namespace esp {
 namespace gfx_batch {
 
 namespace {
-enum { DepthTextureUnit = 1 };
+enum { DepthTextureUnit = 1, TileBufferBinding = 0 };
+
+static_assert(sizeof(DepthUnprojectionTileUniform) == 96,
+              "Not a nice uniform struct");
 }
 
 DepthShader::DepthShader(Flags flags) : flags_{flags} {
@@ -54,11 +61,14 @@ DepthShader::DepthShader(Flags flags) : flags_{flags} {
   vert.addSource(rs.getString("depth.vert"));
   frag.addSource(rs.getString("depth.frag"));
 
-  CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
-
-  attachShaders({vert, frag});
-
-  CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+  CORRADE_INTERNAL_ASSERT_OUTPUT(
+      linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
 
   if (flags & Flag::UnprojectExistingDepth) {
     projectionMatrixOrDepthUnprojectionUniform_ =
@@ -99,6 +109,64 @@ DepthShader& DepthShader::bindDepthTexture(Mn::GL::Texture2D& texture) {
   return *this;
 }
 
+TiledDepthUnprojectionShader::TiledDepthUnprojectionShader(Flags flags)
+    : flags_{flags} {
+  if (!Corrade::Utility::Resource::hasGroup("gfx-batch-shaders")) {
+    importShaderResources();
+  }
+  const Corrade::Utility::Resource rs{"gfx-batch-shaders"};
+
+#ifdef MAGNUM_TARGET_WEBGL
+  Mn::GL::Version glVersion = Mn::GL::Version::GLES300;
+#else
+  Mn::GL::Version glVersion = Mn::GL::Version::GL330;
+#endif
+
+  Mn::GL::Shader vert{glVersion, Mn::GL::Shader::Type::Vertex};
+  Mn::GL::Shader frag{glVersion, Mn::GL::Shader::Type::Fragment};
+
+  const Cr::Containers::String tileCount =
+      Cr::Utility::format("#define TILE_COUNT {}\n",
+                          Mn::UnsignedInt(MaxTileCount));
+  vert.addSource(tileCount);
+  frag.addSource(tileCount);
+
+  if (flags & Flag::PointCloud)
+    frag.addSource("#define POINT_CLOUD\n");
+
+  vert.addSource(rs.getString("depth_unprojection.vert"));
+  frag.addSource(rs.getString("depth_unprojection.frag"));
+
+  CORRADE_INTERNAL_ASSERT_OUTPUT(
+      linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+        if (!vert.compile() || !frag.compile()) {
+          return false;
+        }
+        attachShaders({vert, frag});
+        return link();
+      }));
+
+  setUniform(uniformLocation("depthTexture"), DepthTextureUnit);
+  setUniformBlockBinding(uniformBlockIndex("Tiles"), TileBufferBinding);
+}
+
+TiledDepthUnprojectionShader& TiledDepthUnprojectionShader::bindDepthTexture(
+    Mn::GL::Texture2D& texture) {
+  texture.bind(DepthTextureUnit);
+  return *this;
+}
+
+TiledDepthUnprojectionShader& TiledDepthUnprojectionShader::bindTileBuffer(
+    Mn::GL::Buffer& buffer,
+    const Mn::UnsignedInt offset) {
+  /* Always binding the whole block size, as binding a smaller range than
+     what the shader declares is an error on some drivers */
+  buffer.bind(Mn::GL::Buffer::Target::Uniform, TileBufferBinding,
+              offset * sizeof(DepthUnprojectionTileUniform),
+              MaxTileCount * sizeof(DepthUnprojectionTileUniform));
+  return *this;
+}
+
 Mn::Vector2 calculateDepthUnprojection(const Mn::Matrix4& projectionMatrix) {
   return Mn::Vector2{(projectionMatrix[2][2] - 1.0f), projectionMatrix[3][2]} *
          0.5f;
@@ -111,23 +179,23 @@ __attribute__((target_clones("default", "sse4.2", "avx2")))
 void unprojectDepth(
     const Mn::Vector2& unprojection,
     const Cr::Containers::StridedArrayView2D<Mn::Float>& depth) {
+  const Mn::Float a = unprojection[0];
+  const Mn::Float b = unprojection[1];
   for (Cr::Containers::StridedArrayView1D<Mn::Float> row : depth) {
-    for (Mn::Float& d : row) {
-      d = unprojection[1] / (d + unprojection[0]);
-    }
-  }
-
-  /* Change pixels on the far plane to be 0. Done in a separate loop to allow
-     the optimizer to vectorize the above better.  */
-  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
-  for (Cr::Containers::StridedArrayView1D<Mn::Float> row : depth) {
-    for (Mn::Float& d : row) {
-      /* We can afford using == for comparison as 1.0f has an exact
-         representation, the depth was cleared to exactly this value and the
-         calculation is done exactly the same way in both cases -- thus the
-         result should be bit-exact. */
-      if (d == farDepth)
-        d = 0.0f;
+    /* Pixels on the far plane are changed to be 0. We can afford using == for
+       comparison as 1.0f has an exact representation and the depth was
+       cleared to exactly this value. Written as a select instead of a branch
+       so it compiles to a blend and doesn't need a separate pass. */
+    if (row.isContiguous()) {
+      /* Iterating a plain pointer, which is the common case of a whole tile
+         or framebuffer row, lets the optimizer vectorize the loop */
+      for (Mn::Float& d : row.asContiguous()) {
+        d = d == 1.0f ? 0.0f : b / (d + a);
+      }
+    } else {
+      for (Mn::Float& d : row) {
+        d = d == 1.0f ? 0.0f : b / (d + a);
+      }
     }
   }
 }
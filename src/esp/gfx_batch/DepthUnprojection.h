@@ -7,6 +7,7 @@
 
 #include <Corrade/Containers/EnumSet.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Matrix4.h>
 
 namespace esp {
 namespace gfx_batch {
@@ -86,6 +87,113 @@ class DepthShader : public Magnum::GL::AbstractShaderProgram {
 
 CORRADE_ENUMSET_OPERATORS(DepthShader::Flags)
 
+/**
+@brief Per-tile data for @ref TiledDepthUnprojectionShader
+
+Laid out to be directly uploadable to a uniform buffer.
+*/
+struct DepthUnprojectionTileUniform {
+  /**
+   * @brief Tile rectangle in normalized device coordinates
+   *
+   * Minimum in the first two components, maximum in the other two.
+   */
+  Magnum::Vector4 rectangle;
+
+  /**
+   * @brief Depth unprojection
+   *
+   * Coefficients from @ref calculateDepthUnprojection() in the first two
+   * components, the other two are unused.
+   */
+  Magnum::Vector4 depthUnprojection;
+
+  /**
+   * @brief Point unprojection
+   *
+   * Inverse of the projection matrix for points in camera space, or of the
+   * combined projection and view matrix for points in world space. Used only
+   * if @ref TiledDepthUnprojectionShader::Flag::PointCloud is enabled.
+   */
+  Magnum::Matrix4 pointUnprojection;
+};
+
+/**
+@brief Batched depth unprojection shader
+
+Unprojects an existing depth buffer of many tiles, each with its own
+projection, in a single instanced draw. Bind a depth texture with
+@ref bindDepthTexture() and per-tile data with @ref bindTileBuffer(), then
+draw a mesh with @ref Magnum::MeshPrimitive::TriangleStrip, four vertices and
+an instance for each tile, at most @ref MaxTileCount in a single draw. Writes
+metric depth to the first color output, with values on the far plane patched
+to @cpp 0.0f @ce, same as @ref unprojectDepth() does.
+@see @ref DepthShader
+*/
+class TiledDepthUnprojectionShader : public Magnum::GL::AbstractShaderProgram {
+ public:
+  /** @brief Flag */
+  enum class Flag {
+    /**
+     * Additionally write a point for each pixel into the second color output,
+     * in a four-component float format. The point is calculated using
+     * @ref DepthUnprojectionTileUniform::pointUnprojection and has the last
+     * component set to @cpp 1.0f @ce, points on the far plane are all zeros.
+     */
+    PointCloud = 1 << 0
+  };
+
+  /** @brief Flags */
+  typedef Corrade::Containers::EnumSet<Flag> Flags;
+
+  enum : Magnum::UnsignedInt {
+    /**
+     * Max count of tiles drawn at once. A multiple of 8, so consecutive
+     * ranges of the tile buffer stay aligned for @ref bindTileBuffer().
+     */
+    MaxTileCount = 128
+  };
+
+  /** @brief Constructor */
+  explicit TiledDepthUnprojectionShader(Flags flags = {});
+
+  /**
+   * @brief Construct without creating the underlying OpenGL object
+   *
+   * Meant to be move-assigned from a created instance later.
+   */
+  explicit TiledDepthUnprojectionShader(Magnum::NoCreateT) noexcept
+      : Magnum::GL::AbstractShaderProgram{Magnum::NoCreate} {}
+
+  /**
+   * @brief Bind depth texture
+   * @return Reference to self (for method chaining)
+   */
+  TiledDepthUnprojectionShader& bindDepthTexture(
+      Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Bind a range of a buffer with @ref DepthUnprojectionTileUniform
+   *    data
+   * @return Reference to self (for method chaining)
+   *
+   * Binds @ref MaxTileCount items starting at item @p offset, the buffer is
+   * expected to be large enough even if fewer tiles get drawn.
+   */
+  TiledDepthUnprojectionShader& bindTileBuffer(Magnum::GL::Buffer& buffer,
+                                               Magnum::UnsignedInt offset);
+
+  /**
+   * @brief The flags passed to the Constructor
+   */
+  Flags flags() const { return flags_; }
+
+ private:
+  Flags flags_;
+};
+
+CORRADE_ENUMSET_OPERATORS(TiledDepthUnprojectionShader::Flags)
+
 /**
 @brief Calculate depth unprojection coefficients for @ref unprojectDepth()
 
@@ -147,6 +255,10 @@ See @ref calculateDepthUnprojection() for the full algorithm explanation.
 Additionally to applying that calculation, if the input depth is at the far
 plane (of value @cpp 1.0f @ce), it's set to @cpp 0.0f @ce on output as
 consumers expect zeros for things that are too far.
+
+Rows that are contiguous in memory are processed in a single branchless pass
+that the compiler can vectorize. For unprojecting many tiles of a framebuffer
+on the GPU see @ref TiledDepthUnprojectionShader.
 */
 void unprojectDepth(
     const Magnum::Vector2& unprojection,
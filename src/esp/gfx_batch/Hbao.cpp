@@ -3,9 +3,12 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Hbao.h"
+#include "ShaderCache.h"
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
@@ -48,7 +51,9 @@ enum {
   MaxSamples = 8,
   HbaoRandomSize = AoRandomTextureSize,
   FragmentOutputCount = 8,
-  HbaoRandomNumElements = HbaoRandomSize * HbaoRandomSize
+  HbaoRandomNumElements = HbaoRandomSize * HbaoRandomSize,
+  // 48 bytes each, fits into the 16 kB guaranteed uniform block size
+  MaxTileCount = 256
 };
 
 #ifndef MAGNUM_TARGET_WEBGL
@@ -57,12 +62,46 @@ constexpr Mn::GL::Version GlslVersion = Mn::GL::Version::GL330;
 constexpr Mn::GL::Version GlslVersion = Mn::GL::Version::GLES300;
 #endif
 
+namespace {
+
+/**
+ * Add tile defines and helpers (and optionally the per-tile uniform block)
+ * to a fragment shader if there's more than one tile
+ */
+void addTileSources(Mn::GL::Shader& frag,
+                    const Mn::Vector2i& tileCount,
+                    const Mn::Vector2i& tileSize,
+                    bool tileData) {
+  if (tileCount.product() == 1) {
+    return;
+  }
+
+  Cr::Utility::Resource rs{"gfx-batch-shaders"};
+  frag.addSource(Cr::Utility::format(
+                     "#define AO_TILED\n"
+                     "#define AO_TILE_COUNT {}\n"
+                     "#define AO_TILE_COUNT_X {}\n"
+                     "#define AO_TILE_SIZE vec2({}, {})\n"
+                     "{}",
+                     tileCount.product(), tileCount.x(), tileSize.x(),
+                     tileSize.y(), tileData ? "#define AO_TILE_DATA\n"_s : ""))
+      .addSource(rs.getString("hbao/tiles.glsl"));
+}
+
+}  // namespace
+
 class HbaoBlurShader : public Mn::GL::AbstractShaderProgram {
  private:
   enum : Mn::Int { SourceTextureBinding = 0, LinearDepthTextureBinding = 1 };
 
  public:
-  explicit HbaoBlurShader(bool bilateral, Mn::Int aoBlurPass)
+  explicit HbaoBlurShader(Mn::NoCreateT)
+      : Mn::GL::AbstractShaderProgram{Mn::NoCreate} {}
+
+  explicit HbaoBlurShader(bool bilateral,
+                          Mn::Int aoBlurPass,
+                          const Mn::Vector2i& tileCount = Mn::Vector2i{1},
+                          const Mn::Vector2i& tileSize = {})
       : bilateral_{bilateral} {
     CORRADE_INTERNAL_ASSERT(!bilateral || !aoBlurPass);
 
@@ -73,6 +112,7 @@ class HbaoBlurShader : public Mn::GL::AbstractShaderProgram {
     vert.addSource(rs.getString("hbao/fullscreenquad.vert"));
 
     Mn::GL::Shader frag{GlslVersion, Mn::GL::Shader::Type::Fragment};
+    addTileSources(frag, tileCount, tileSize, /*tileData*/ false);
     if (bilateral) {
       frag.addSource(rs.getString("hbao/bilateralblur.frag"));
     } else {
@@ -83,11 +123,14 @@ class HbaoBlurShader : public Mn::GL::AbstractShaderProgram {
       frag.addSource(rs.getString("hbao/hbao_blur.frag"));
     }
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
 
     sharpnessUniform_ = uniformLocation("uGaussSharpness");
     inverseResolutionDirectionUniform_ =
@@ -127,11 +170,21 @@ class HbaoBlurShader : public Mn::GL::AbstractShaderProgram {
 // TODO replace with own
 class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
  private:
-  enum : Mn::Int { InputTextureBinding = 0 };
+  enum : Mn::Int { InputTextureBinding = 0, TileUniformBufferBinding = 1 };
 
  public:
+  explicit DepthLinearizeShader(Mn::NoCreateT)
+      : Mn::GL::AbstractShaderProgram{Mn::NoCreate} {}
+
   // TODO MSAA is never used, drop
-  explicit DepthLinearizeShader(bool msaa) : msaa_{msaa} {
+  explicit DepthLinearizeShader(bool msaa,
+                                Mn::Int downsampleFactor = 1,
+                                const Mn::Vector2i& tileCount = Mn::Vector2i{1},
+                                const Mn::Vector2i& tileSize = {})
+      : msaa_{msaa}, tiled_{tileCount.product() != 1} {
+    CORRADE_INTERNAL_ASSERT(!msaa || downsampleFactor == 1);
+    CORRADE_INTERNAL_ASSERT(!tiled_ || downsampleFactor == 1);
+
     Cr::Utility::Resource rs{"gfx-batch-shaders"};
 
     // TODO use our own
@@ -142,15 +195,28 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
     if (msaa) {
       frag.addSource("#define DEPTHLINEARIZE_MSAA\n"_s);
     }
+    if (downsampleFactor != 1) {
+      frag.addSource(Cr::Utility::format("#define DOWNSAMPLE_FACTOR {}\n",
+                                         downsampleFactor));
+    }
+    addTileSources(frag, tileCount, tileSize, /*tileData*/ true);
     frag.addSource(rs.getString("hbao/depthlinearize.frag"));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
-
-    clipInfoUniform_ = uniformLocation("uClipInfo");
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
+
+    if (tiled_) {
+      setUniformBlockBinding(uniformBlockIndex("uTileBuffer"),
+                             TileUniformBufferBinding);
+    } else {
+      clipInfoUniform_ = uniformLocation("uClipInfo");
+    }
     if (msaa) {
       sampleIndexUniform_ = uniformLocation("uSampleIndex");
     }
@@ -158,10 +224,17 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
   }
 
   DepthLinearizeShader& setClipInfo(const Mn::Vector4& info) {
+    CORRADE_INTERNAL_ASSERT(!tiled_);
     setUniform(clipInfoUniform_, info);
     return *this;
   }
 
+  DepthLinearizeShader& bindTileUniformBuffer(Mn::GL::Buffer& buffer) {
+    CORRADE_INTERNAL_ASSERT(tiled_);
+    buffer.bind(Mn::GL::Buffer::Target::Uniform, TileUniformBufferBinding);
+    return *this;
+  }
+
   DepthLinearizeShader& setSampleIndex(Mn::Int index) {
     CORRADE_INTERNAL_ASSERT(msaa_);
     setUniform(sampleIndexUniform_, index);
@@ -185,7 +258,76 @@ class DepthLinearizeShader : public Mn::GL::AbstractShaderProgram {
 
  private:
   Mn::Int clipInfoUniform_, sampleIndexUniform_;
-  bool msaa_;
+  bool msaa_, tiled_;
+};
+
+class HbaoUpsampleShader : public Mn::GL::AbstractShaderProgram {
+ private:
+  enum : Mn::Int {
+    InputTextureBinding = 0,
+    SourceTextureBinding = 1,
+    LinearDepthTextureBinding = 2
+  };
+
+ public:
+  explicit HbaoUpsampleShader(Mn::NoCreateT)
+      : Mn::GL::AbstractShaderProgram{Mn::NoCreate} {}
+
+  explicit HbaoUpsampleShader(Mn::Int upsampleFactor) {
+    Cr::Utility::Resource rs{"gfx-batch-shaders"};
+
+    // TODO use our own
+    Mn::GL::Shader vert{GlslVersion, Mn::GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("hbao/fullscreenquad.vert"));
+
+    Mn::GL::Shader frag{GlslVersion, Mn::GL::Shader::Type::Fragment};
+    frag.addSource(
+            Cr::Utility::format("#define UPSAMPLE_FACTOR {}\n", upsampleFactor))
+        .addSource(rs.getString("hbao/bilateralupsample.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
+
+    clipInfoUniform_ = uniformLocation("uClipInfo");
+    sharpnessUniform_ = uniformLocation("uSharpness");
+    setUniform(uniformLocation("uInputTexture"), InputTextureBinding);
+    setUniform(uniformLocation("uTexSource"), SourceTextureBinding);
+    setUniform(uniformLocation("uTexLinearDepth"), LinearDepthTextureBinding);
+  }
+
+  HbaoUpsampleShader& setClipInfo(const Mn::Vector4& info) {
+    setUniform(clipInfoUniform_, info);
+    return *this;
+  }
+
+  HbaoUpsampleShader& setSharpness(Mn::Float sharpness) {
+    setUniform(sharpnessUniform_, sharpness);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindInputTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(InputTextureBinding);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindSourceTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(SourceTextureBinding);
+    return *this;
+  }
+
+  HbaoUpsampleShader& bindLinearDepthTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(LinearDepthTextureBinding);
+    return *this;
+  }
+
+ private:
+  Mn::Int clipInfoUniform_, sharpnessUniform_;
 };
 
 class ViewNormalShader : public Mn::GL::AbstractShaderProgram {
@@ -203,11 +345,14 @@ class ViewNormalShader : public Mn::GL::AbstractShaderProgram {
     Mn::GL::Shader frag{GlslVersion, Mn::GL::Shader::Type::Fragment};
     frag.addSource(rs.getString("hbao/viewnormal.frag"));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
 
     projectionInfoUniform_ = uniformLocation("uProjInfo");
     projectionOrthographicUniform_ = uniformLocation("uProjOrtho");
@@ -247,7 +392,8 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
     LinearDepthTextureBinding = 0,
     ViewNormalTextureBinding = 1,
     RandomTextureBinding = 1,
-    OutputImageBinding = 0
+    OutputImageBinding = 0,
+    TileUniformBufferBinding = 1
   };
 
  public:
@@ -259,15 +405,22 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
   explicit HbaoCalcShader(bool deinterleaved,
                           bool specialBlur,
                           Layered layered,
-                          bool textureArrayLayer)
+                          bool textureArrayLayer,
+                          const Mn::Vector2i& tileCount = Mn::Vector2i{1},
+                          const Mn::Vector2i& tileSize = {},
+                          Mn::Int temporalFrameCount = 1)
       : deinterleaved_{deinterleaved},
 #ifndef MAGNUM_TARGET_WEBGL
         specialBlur_{specialBlur},
 #endif
         textureArrayLayer_{textureArrayLayer},
+        tiled_{tileCount.product() != 1},
+        temporal_{temporalFrameCount != 1},
         layered_{layered} {
     CORRADE_INTERNAL_ASSERT(deinterleaved || layered == Layered::Off);
     CORRADE_INTERNAL_ASSERT(deinterleaved || !textureArrayLayer);
+    CORRADE_INTERNAL_ASSERT(!deinterleaved || !tiled_);
+    CORRADE_INTERNAL_ASSERT(!deinterleaved || !temporal_);
 
     Cr::Utility::Resource rs{"gfx-batch-shaders"};
 
@@ -303,6 +456,11 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
 
 #endif
 
+    addTileSources(frag, tileCount, tileSize, /*tileData*/ true);
+    if (temporal_) {
+      frag.addSource(Cr::Utility::format("#define AO_TEMPORAL {}\n",
+                                         temporalFrameCount));
+    }
     frag
         .addSource(Cr::Utility::format(
             "{}{}{}"
@@ -314,20 +472,35 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
             Mn::Int(layered), AoRandomTextureSize))
         .addSource(rs.getString("hbao/hbao.frag"));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
 #ifndef MAGNUM_TARGET_WEBGL
     if (layered == Layered::GeometryShader) {
-      CORRADE_INTERNAL_ASSERT(geom.compile());
-      attachShaders({vert, geom, frag});
+      CORRADE_INTERNAL_ASSERT_OUTPUT(
+          linkCachedShaderProgram(*this, {vert, geom, frag}, [&]() {
+            if (!vert.compile() || !geom.compile() || !frag.compile()) {
+              return false;
+            }
+            attachShaders({vert, geom, frag});
+            return link();
+          }));
     } else
 #endif
-      attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    {
+      CORRADE_INTERNAL_ASSERT_OUTPUT(
+          linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+            if (!vert.compile() || !frag.compile()) {
+              return false;
+            }
+            attachShaders({vert, frag});
+            return link();
+          }));
+    }
 
     setUniformBlockBinding(uniformBlockIndex("uControlBuffer"),
                            UniformBufferBinding);
+    if (tiled_) {
+      setUniformBlockBinding(uniformBlockIndex("uTileBuffer"),
+                             TileUniformBufferBinding);
+    }
     if (deinterleaved) {
       if (layered == Layered::Off) {
         float2OffsetUniform_ = uniformLocation("uFloat2Offset");
@@ -346,6 +519,15 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
       setUniform(uniformLocation("texRandom"), RandomTextureBinding);
       randomSliceUniform_ = uniformLocation("uRandomSlice");
     }
+    if (temporal_) {
+      directionOffsetUniform_ = uniformLocation("uDirectionOffset");
+    }
+  }
+
+  HbaoCalcShader& setDirectionOffset(Mn::Int offset) {
+    CORRADE_INTERNAL_ASSERT(temporal_);
+    setUniform(directionOffsetUniform_, Mn::Float(offset));
+    return *this;
   }
 
   HbaoCalcShader& setFloat2Offset(const Mn::Vector2& offset) {
@@ -404,6 +586,12 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
     return *this;
   }
 
+  HbaoCalcShader& bindTileUniformBuffer(Mn::GL::Buffer& buffer) {
+    CORRADE_INTERNAL_ASSERT(tiled_);
+    buffer.bind(Mn::GL::Buffer::Target::Uniform, TileUniformBufferBinding);
+    return *this;
+  }
+
 #ifndef MAGNUM_TARGET_WEBGL
   HbaoCalcShader& bindOutputImage(Mn::GL::Texture2DArray& texture,
                                   Mn::Int level) {
@@ -418,13 +606,13 @@ class HbaoCalcShader : public Mn::GL::AbstractShaderProgram {
 
  private:
   Mn::Int float2OffsetUniform_, jitterUniform_, linearDepthTextureSliceUniform_,
-      randomSliceUniform_;
+      randomSliceUniform_, directionOffsetUniform_;
   bool deinterleaved_,
 #ifndef MAGNUM_TARGET_WEBGL
       specialBlur_,
 #endif
 
-      textureArrayLayer_;
+      textureArrayLayer_, tiled_, temporal_;
   Layered layered_;
 };
 
@@ -451,11 +639,14 @@ class HbaoDeinterleaveShader : public Mn::GL::AbstractShaderProgram {
 #endif
     frag.addSource(rs.getString("hbao/hbao_deinterleave.frag"));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
 
     projectionInfoUniform_ = uniformLocation("uUVOffsetInvResInfo");
     setUniform(uniformLocation("uTexLinearDepth"), LinearDepthTextureBinding);
@@ -497,11 +688,14 @@ class HbaoReinterleaveShader : public Mn::GL::AbstractShaderProgram {
     }
     frag.addSource(rs.getString("hbao/hbao_reinterleave.frag"));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile());
-    CORRADE_INTERNAL_ASSERT(frag.compile());
-
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
 
     setUniform(uniformLocation("uTexResultsArray"), ResultsTextureBinding);
   }
@@ -512,6 +706,98 @@ class HbaoReinterleaveShader : public Mn::GL::AbstractShaderProgram {
   }
 };
 
+class HbaoTemporalShader : public Mn::GL::AbstractShaderProgram {
+ private:
+  enum : Mn::Int {
+    CurrentTextureBinding = 0,
+    LinearDepthTextureBinding = 1,
+    HistoryTextureBinding = 2,
+    HistoryLinearDepthTextureBinding = 3
+  };
+
+ public:
+  explicit HbaoTemporalShader(Mn::NoCreateT)
+      : Mn::GL::AbstractShaderProgram{Mn::NoCreate} {}
+
+  explicit HbaoTemporalShader() {
+    Cr::Utility::Resource rs{"gfx-batch-shaders"};
+
+    Mn::GL::Shader vert{GlslVersion, Mn::GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("hbao/fullscreenquad.vert"));
+
+    Mn::GL::Shader frag{GlslVersion, Mn::GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("hbao/hbao_temporal.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(
+        linkCachedShaderProgram(*this, {vert, frag}, [&]() {
+          if (!vert.compile() || !frag.compile()) {
+            return false;
+          }
+          attachShaders({vert, frag});
+          return link();
+        }));
+
+    projectionInfoUniform_ = uniformLocation("uProjInfo");
+    projectionOrthographicUniform_ = uniformLocation("uProjOrtho");
+    currentToPreviousUniform_ = uniformLocation("uCurrentToPrevious");
+    previousProjectionUniform_ = uniformLocation("uPreviousProjection");
+    currentWeightUniform_ = uniformLocation("uCurrentWeight");
+    setUniform(uniformLocation("uTexCurrent"), CurrentTextureBinding);
+    setUniform(uniformLocation("uTexLinearDepth"), LinearDepthTextureBinding);
+    setUniform(uniformLocation("uTexHistory"), HistoryTextureBinding);
+    setUniform(uniformLocation("uTexHistoryLinearDepth"),
+               HistoryLinearDepthTextureBinding);
+  }
+
+  HbaoTemporalShader& setProjectionInfo(const Mn::Vector4& info) {
+    setUniform(projectionInfoUniform_, info);
+    return *this;
+  }
+
+  HbaoTemporalShader& setProjectionOrthographic(Mn::Int orthographic) {
+    setUniform(projectionOrthographicUniform_, orthographic);
+    return *this;
+  }
+
+  HbaoTemporalShader& setReprojection(const Mn::Matrix4& currentToPrevious,
+                                      const Mn::Matrix4& previousProjection) {
+    setUniform(currentToPreviousUniform_, currentToPrevious);
+    setUniform(previousProjectionUniform_, previousProjection);
+    return *this;
+  }
+
+  HbaoTemporalShader& setCurrentWeight(Mn::Float weight) {
+    setUniform(currentWeightUniform_, weight);
+    return *this;
+  }
+
+  HbaoTemporalShader& bindCurrentTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(CurrentTextureBinding);
+    return *this;
+  }
+
+  HbaoTemporalShader& bindLinearDepthTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(LinearDepthTextureBinding);
+    return *this;
+  }
+
+  HbaoTemporalShader& bindHistoryTexture(Mn::GL::Texture2D& texture) {
+    texture.bind(HistoryTextureBinding);
+    return *this;
+  }
+
+  HbaoTemporalShader& bindHistoryLinearDepthTexture(
+      Mn::GL::Texture2D& texture) {
+    texture.bind(HistoryLinearDepthTextureBinding);
+    return *this;
+  }
+
+ private:
+  Mn::Int projectionInfoUniform_, projectionOrthographicUniform_,
+      currentToPreviousUniform_, previousProjectionUniform_,
+      currentWeightUniform_;
+};
+
 /**
  * @brief This struct holds the uniform data that are passed to the various
  * shaders. If fields are added they should be sized multiples of 16 bytes,
@@ -544,6 +830,20 @@ struct HbaoUniformData {
 
 static_assert(sizeof(HbaoUniformData) % 16 == 0, "Not a nice uniform struct");
 
+/* Has to match HBAOTileData in tiles.glsl */
+struct HbaoTileUniformData {
+  Mn::Vector4 clipInfo;
+  Mn::Vector4 projInfo;
+  Mn::Float radiusToScreen;
+  Mn::Int projOrtho;
+  // padding
+  Mn::Int : 32;
+  Mn::Int : 32;
+};
+
+static_assert(sizeof(HbaoTileUniformData) % 16 == 0,
+              "Not a nice uniform struct");
+
 struct Hbao::State {
   Mn::GL::Texture2D sceneDepthLinear;
   Mn::GL::Framebuffer depthLinear{Mn::NoCreate};
@@ -561,25 +861,16 @@ struct Hbao::State {
   Mn::GL::Texture2DArray hbao2DepthArray;
   Mn::GL::Texture2DArray hbao2ResultArray;
 
-  HbaoBlurShader bilateralBlurShader{
-      /*bilateral*/ true,
-      /*aoBlurPass value is ignored for bilateral*/ 0};
-  HbaoBlurShader hbaoSpecialBlurShaderFirstPass{/*bilateral*/ false,
-                                                /*aoBlurPass*/ 0};
-  HbaoBlurShader hbaoSpecialBlurShader2ndPass{/*bilateral*/ false,
-                                              /*aoBlurPass*/ 1};
-  DepthLinearizeShader depthLinearizeShader{false};
   DepthLinearizeShader depthLinearizeShaderMsaa{true};
   ViewNormalShader viewNormalShader;
-  HbaoCalcShader hbaoCalcShader{/*deinterleaved*/ false,
-                                /*specialBlur*/ false,
-                                {},
-                                false};
-  HbaoCalcShader hbaoCalcSpecialBlurShader{/*deinterleaved*/ false,
-                                           /*specialBlur*/ true,
-                                           {},
-                                           false};
   /* These depend on config, are created in the constructor */
+  HbaoBlurShader bilateralBlurShader{Mn::NoCreate};
+  HbaoBlurShader hbaoSpecialBlurShaderFirstPass{Mn::NoCreate};
+  HbaoBlurShader hbaoSpecialBlurShader2ndPass{Mn::NoCreate};
+  HbaoCalcShader hbaoCalcShader{Mn::NoCreate};
+  HbaoCalcShader hbaoCalcSpecialBlurShader{Mn::NoCreate};
+  DepthLinearizeShader depthLinearizeShader{Mn::NoCreate};
+  HbaoUpsampleShader upsampleShader{Mn::NoCreate};
   HbaoCalcShader hbao2CalcShader{Mn::NoCreate};
   HbaoCalcShader hbao2CalcSpecialBlurShader{Mn::NoCreate};
   HbaoDeinterleaveShader hbao2DeinterleaveShader;
@@ -590,9 +881,40 @@ struct Hbao::State {
   Mn::GL::Buffer hbaoUniform{Mn::GL::Buffer::TargetHint::Uniform};
   HbaoUniformData hbaoUniformData;
 
+  /* Used only if there's more than one tile */
+  Mn::GL::Buffer hbaoTileUniform{Mn::NoCreate};
+  Cr::Containers::Array<HbaoTileUniformData> hbaoTileUniformData;
+
   Mn::GL::Mesh triangle, triangleLayered;
 
   HbaoConfiguration configuration;
+  /* Size all internal buffers are at, configuration.size() divided by the
+     resolution factor */
+  Mn::Vector2i size;
+
+  /* Saved in drawEffect() for the final upsample at reduced resolutions */
+  Mn::Vector4 clipInfo;
+  Mn::GL::Texture2D* depthStencilInput{};
+
+  /* Used only with temporal accumulation. The AO of the current frame is
+     calculated into hbaoTemporalInput, accumulated with hbaoHistory into
+     hbaoResult, which is then copied to hbaoHistory together with the linear
+     depth for the next frame. */
+  Mn::GL::Texture2D hbaoTemporalInput{Mn::NoCreate};
+  Mn::GL::Framebuffer hbaoTemporalCalc{Mn::NoCreate};
+  Mn::GL::Texture2D hbaoHistory{Mn::NoCreate};
+  Mn::GL::Framebuffer hbaoHistoryCopy{Mn::NoCreate};
+  Mn::GL::Texture2D sceneDepthLinearHistory{Mn::NoCreate};
+  Mn::GL::Framebuffer depthLinearHistoryCopy{Mn::NoCreate};
+  HbaoTemporalShader temporalShader{Mn::NoCreate};
+  /* Camera of the current frame, saved in drawEffect() */
+  Mn::Matrix4 projection, cameraMatrix;
+  /* Camera of the frame in the history */
+  Mn::Matrix4 previousProjection, previousCameraMatrix;
+  /* Frames accumulated in the history, zero if there's no history */
+  Mn::Int temporalHistoryCount{};
+  /* Index of the next frame, selecting its directions and jitter */
+  Mn::UnsignedInt temporalFrame{};
 
   Mn::Vector4 random[HbaoRandomNumElements * MaxSamples];
 };
@@ -618,6 +940,38 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
   //  recreate all framebuffers
   CORRADE_INTERNAL_ASSERT(!configuration.size().isZero());
 
+  const Mn::Int resolutionFactor = Mn::Int(configuration.resolution());
+  const Mn::Vector2i size =
+      (configuration.size() + Mn::Vector2i{resolutionFactor - 1}) /
+      resolutionFactor;
+
+  const Mn::Vector2i tileCount = configuration.tileCount();
+  const Mn::Int tileCountTotal = tileCount.product();
+  CORRADE_ASSERT(tileCountTotal >= 1 && tileCountTotal <= MaxTileCount,
+                 "Hbao::setConfiguration(): expected at most" << MaxTileCount
+                                                              << "tiles, got"
+                                                              << tileCount, );
+  CORRADE_ASSERT(configuration.size() % tileCount == Mn::Vector2i{},
+                 "Hbao::setConfiguration(): size" << configuration.size()
+                                                  << "not divisible by"
+                                                  << tileCount << "tiles", );
+  CORRADE_ASSERT(tileCountTotal == 1 ||
+                     configuration.resolution() == HbaoResolution::Full,
+                 "Hbao::setConfiguration(): reduced resolution not supported "
+                 "with tiles", );
+  const Mn::Int temporalFrameCount = configuration.temporalFrameCount();
+  CORRADE_ASSERT(temporalFrameCount >= 1 && temporalFrameCount <= MaxSamples &&
+                     MaxSamples % temporalFrameCount == 0,
+                 "Hbao::setConfiguration(): expected the temporal frame count "
+                 "to be 1, 2, 4 or 8, got"
+                     << temporalFrameCount, );
+  CORRADE_ASSERT(temporalFrameCount == 1 ||
+                     (tileCountTotal == 1 &&
+                      !(configuration.flags() & HbaoFlag::NoBlur)),
+                 "Hbao::setConfiguration(): temporal accumulation not "
+                 "supported with tiles or without blur", );
+  const Mn::Vector2i tileSize = size / tileCount;
+
   /* Only one of these can be set */
   CORRADE_INTERNAL_ASSERT(
       !(configuration.flags() & HbaoFlag::LayeredGeometryShader) ||
@@ -667,9 +1021,9 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
         .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, Mn::GL::TextureFormat::R32F, configuration.size());
+        .setStorage(1, Mn::GL::TextureFormat::R32F, size);
 
-    state_->depthLinear = Mn::GL::Framebuffer{{{}, configuration.size()}};
+    state_->depthLinear = Mn::GL::Framebuffer{{{}, size}};
     state_->depthLinear.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                                       state_->sceneDepthLinear, 0);
 
@@ -677,9 +1031,9 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
         .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
         .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, Mn::GL::TextureFormat::RGBA8, configuration.size());
+        .setStorage(1, Mn::GL::TextureFormat::RGBA8, size);
 
-    state_->viewNormal = Mn::GL::Framebuffer{{{}, configuration.size()}};
+    state_->viewNormal = Mn::GL::Framebuffer{{{}, size}};
     state_->viewNormal.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                                      state_->sceneViewNormal, 0);
 
@@ -688,9 +1042,9 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
             ? Mn::GL::TextureFormat::RG16F
             : Mn::GL::TextureFormat::R8;
     state_->hbaoResult.setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, aoFormat, configuration.size());
+        .setStorage(1, aoFormat, size);
     state_->hbaoBlur.setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
-        .setStorage(1, aoFormat, configuration.size());
+        .setStorage(1, aoFormat, size);
 
 #ifndef MAGNUM_TARGET_WEBGL
     if (configuration.flags() & HbaoFlag::UseAoSpecialBlur) {
@@ -702,15 +1056,59 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
     }
 #endif
 
-    state_->hbaoCalc = Mn::GL::Framebuffer{{{}, configuration.size()}};
+    state_->hbaoCalc = Mn::GL::Framebuffer{{{}, size}};
     state_->hbaoCalc
         .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
                        state_->hbaoResult, 0)
         .attachTexture(Mn::GL::Framebuffer::ColorAttachment{1},
                        state_->hbaoBlur, 0);
 
+    if (temporalFrameCount != 1) {
+      state_->hbaoTemporalInput = Mn::GL::Texture2D{};
+      state_->hbaoTemporalInput
+          .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, aoFormat, size);
+      state_->hbaoTemporalCalc = Mn::GL::Framebuffer{{{}, size}};
+      state_->hbaoTemporalCalc.attachTexture(
+          Mn::GL::Framebuffer::ColorAttachment{0}, state_->hbaoTemporalInput,
+          0);
+
+      // Reprojected positions fall between texels, filter the AO but not
+      // the depth used for the disocclusion test
+      state_->hbaoHistory = Mn::GL::Texture2D{};
+      state_->hbaoHistory.setMinificationFilter(Mn::GL::SamplerFilter::Linear)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Linear)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, aoFormat, size);
+      state_->hbaoHistoryCopy = Mn::GL::Framebuffer{{{}, size}};
+      state_->hbaoHistoryCopy.attachTexture(
+          Mn::GL::Framebuffer::ColorAttachment{0}, state_->hbaoHistory, 0);
+
+      state_->sceneDepthLinearHistory = Mn::GL::Texture2D{};
+      state_->sceneDepthLinearHistory
+          .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+          .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+          .setStorage(1, Mn::GL::TextureFormat::R32F, size);
+      state_->depthLinearHistoryCopy = Mn::GL::Framebuffer{{{}, size}};
+      state_->depthLinearHistoryCopy.attachTexture(
+          Mn::GL::Framebuffer::ColorAttachment{0},
+          state_->sceneDepthLinearHistory, 0);
+    } else {
+      state_->hbaoTemporalInput = Mn::GL::Texture2D{Mn::NoCreate};
+      state_->hbaoTemporalCalc = Mn::GL::Framebuffer{Mn::NoCreate};
+      state_->hbaoHistory = Mn::GL::Texture2D{Mn::NoCreate};
+      state_->hbaoHistoryCopy = Mn::GL::Framebuffer{Mn::NoCreate};
+      state_->sceneDepthLinearHistory = Mn::GL::Texture2D{Mn::NoCreate};
+      state_->depthLinearHistoryCopy = Mn::GL::Framebuffer{Mn::NoCreate};
+    }
+    state_->temporalHistoryCount = 0;
+    state_->temporalFrame = 0;
+
     const Mn::Vector2i quarterSize =
-        (configuration.size() + Mn::Vector2i{3}) / 4;
+        (size + Mn::Vector2i{3}) / 4;
 
     state_->hbao2DepthArray
         .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
@@ -768,23 +1166,102 @@ void Hbao::setConfiguration(const HbaoConfiguration& configuration) {
                        textureArrayLayer};
   }
 
+  state_->bilateralBlurShader = HbaoBlurShader{
+      /*bilateral*/ true,
+      /*aoBlurPass value is ignored for bilateral*/ 0, tileCount, tileSize};
+  state_->hbaoSpecialBlurShaderFirstPass = HbaoBlurShader{
+      /*bilateral*/ false, /*aoBlurPass*/ 0, tileCount, tileSize};
+  state_->hbaoSpecialBlurShader2ndPass = HbaoBlurShader{
+      /*bilateral*/ false, /*aoBlurPass*/ 1, tileCount, tileSize};
+  state_->hbaoCalcShader = HbaoCalcShader{
+      /*deinterleaved*/ false, /*specialBlur*/ false, {}, false, tileCount,
+      tileSize, temporalFrameCount};
+  state_->hbaoCalcSpecialBlurShader = HbaoCalcShader{
+      /*deinterleaved*/ false, /*specialBlur*/ true, {}, false, tileCount,
+      tileSize, temporalFrameCount};
+  state_->temporalShader = temporalFrameCount != 1
+                               ? HbaoTemporalShader{}
+                               : HbaoTemporalShader{Mn::NoCreate};
+  state_->depthLinearizeShader = DepthLinearizeShader{
+      /*msaa*/ false, resolutionFactor, tileCount, tileSize};
+
+  if (tileCountTotal != 1) {
+    state_->hbaoTileUniformData =
+        Cr::Containers::Array<HbaoTileUniformData>{Cr::ValueInit,
+                                                   std::size_t(tileCountTotal)};
+    state_->hbaoTileUniform =
+        Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::Uniform};
+    state_->hbaoTileUniform.setData(
+        {nullptr, tileCountTotal * sizeof(HbaoTileUniformData)},
+        Mn::GL::BufferUsage::DynamicDraw);
+  } else {
+    state_->hbaoTileUniformData = nullptr;
+    state_->hbaoTileUniform = Mn::GL::Buffer{Mn::NoCreate};
+  }
+  state_->upsampleShader = configuration.resolution() == HbaoResolution::Full
+                               ? HbaoUpsampleShader{Mn::NoCreate}
+                               : HbaoUpsampleShader{resolutionFactor};
+
   state_->triangle.setCount(3);
   state_->triangleLayered.setCount(3 * HbaoRandomNumElements);
   state_->configuration = configuration;
+  state_->size = size;
 }
 
 Magnum::Vector2i Hbao::getFrameBufferSize() const {
-  return state_->configuration.size();
+  return state_->size;
 }
 
 namespace {
 
+/**
+ * Projection info used to reconstruct view-space positions from texture
+ * coordinates, see HBAOData::projInfo in hbao.frag
+ */
+Mn::Vector4 buildProjectionInfo(const Mn::Matrix4& projection) {
+  if (projection[3][3] != 0) {
+    // Orthographic rendering
+    return {
+        2.0f / projection[0][0],
+        2.0f / projection[1][1],
+        -(1.0f + projection[3][0]) / projection[0][0],
+        -(1.0f - projection[3][1]) / projection[1][1],
+    };
+  }
+  // Perspective rendering -> projection[3][3] == 0
+  return {
+      2.0f / projection[0][0],
+      2.0f / projection[1][1],
+      -(1.0f - projection[2][0]) / projection[0][0],
+      -(1.0f + projection[2][1]) / projection[1][1],
+  };
+}
+
+/**
+ * Projection of the configured radius into screen space, in pixels for a
+ * viewport of given height
+ */
+Mn::Float radiusToScreen(const HbaoConfiguration& configuration,
+                         Mn::Int height,
+                         const Mn::Matrix4& projection,
+                         const Mn::Vector4& projInfo,
+                         bool orthographic) {
+  const Mn::Float meters2viewspace = 1.0f;
+  const Mn::Float r = configuration.radius() * meters2viewspace;
+  const Mn::Float projectionScale =
+      (orthographic ? height / projInfo[1]  // ortho
+                    // For perspective, projection[0][0] is 1/tan(fov/2)
+                    : 0.5f * height * projection[0][0]);  // persp
+  return r * 0.5f * projectionScale;
+}
+
 /**
  * Populate uniform data with appropriate values from configuration. Should only
  * be performed when configuration changes.
  */
 void prepareHbaoData(
     const HbaoConfiguration& configuration,
+    const Mn::Vector2i& size,
     const Mn::Matrix4& projection,
     HbaoUniformData& uniformData,
     Mn::GL::Buffer& uniform,
@@ -795,12 +1272,9 @@ void prepareHbaoData(
   const Mn::Float r = configuration.radius() * meters2viewspace;
   uniformData.r2 = r * r;
   uniformData.negInvR2 = -1.0f / uniformData.r2;
-  const Mn::Float projectionScale =
-      (uniformData.projOrtho != 0
-           ? configuration.size().y() / uniformData.projInfo[1]  // ortho
-           // For perspective, projection[0][0] is 1/tan(fov/2)
-           : 0.5f * configuration.size().y() * projection[0][0]);  // persp
-  uniformData.radiusToScreen = r * 0.5f * projectionScale;
+  uniformData.radiusToScreen =
+      radiusToScreen(configuration, size.y(), projection, uniformData.projInfo,
+                     uniformData.projOrtho != 0);
 
   /* AO */
   uniformData.powExponent = Mn::Math::max(configuration.intensity(), 0.0f);
@@ -808,11 +1282,10 @@ void prepareHbaoData(
   uniformData.aoMultiplier = 1.0f / (1.0f - uniformData.nDotVBias);
 
   /* Resolution */
-  const Mn::Vector2i quarterSize = (configuration.size() + Mn::Vector2i{3}) / 4;
+  const Mn::Vector2i quarterSize = (size + Mn::Vector2i{3}) / 4;
   uniformData.invQuarterResolution =
       Mn::Vector2{1.0f} / Mn::Vector2{quarterSize};
-  uniformData.invFullResolution =
-      Mn::Vector2{1.0f} / Mn::Vector2{configuration.size()};
+  uniformData.invFullResolution = Mn::Vector2{1.0f} / Mn::Vector2{size};
 
   if (configuration.flags() &
       (HbaoFlag::LayeredGeometryShader | HbaoFlag::LayeredImageLoadStore))
@@ -846,14 +1319,57 @@ Mn::Vector4 buildClipInfo(const Mn::Matrix4& projectionMatrix,
 
 void Hbao::drawLinearDepth(const Mn::Matrix4& projection,
                            Mn::GL::Texture2D& depthStencilInput) {
+  state_->clipInfo =
+      buildClipInfo(projection, state_->hbaoUniformData.projOrtho == 1);
+  state_->depthStencilInput = &depthStencilInput;
+
   state_->depthLinear.bind();
-  state_->depthLinearizeShader
-      .setClipInfo(
-          buildClipInfo(projection, state_->hbaoUniformData.projOrtho == 1))
+  state_->depthLinearizeShader.setClipInfo(state_->clipInfo)
       .bindInputTexture(depthStencilInput)
       .draw(state_->triangle);
 }
 
+void Hbao::bindAoOutput(Mn::GL::AbstractFramebuffer& output) {
+  // At reduced resolutions the final AO goes into hbaoResult first and gets
+  // upsampled into the output in drawAoOutput()
+  if (state_->configuration.resolution() != HbaoResolution::Full) {
+    state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0}).bind();
+    return;
+  }
+
+  output.bind();
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
+  Mn::GL::Renderer::setBlendFunction(
+      Mn::GL::Renderer::BlendFunction::Zero,
+      Mn::GL::Renderer::BlendFunction::SourceColor,
+      Mn::GL::Renderer::BlendFunction::Zero,
+      Mn::GL::Renderer::BlendFunction::One);
+  // TODO Set sample mask if samples > 1
+}
+
+void Hbao::drawAoOutput(Mn::GL::AbstractFramebuffer& output) {
+  if (state_->configuration.resolution() == HbaoResolution::Full) {
+    return;
+  }
+
+  output.bind();
+  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
+  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
+  Mn::GL::Renderer::setBlendFunction(
+      Mn::GL::Renderer::BlendFunction::Zero,
+      Mn::GL::Renderer::BlendFunction::SourceColor,
+      Mn::GL::Renderer::BlendFunction::Zero,
+      Mn::GL::Renderer::BlendFunction::One);
+
+  state_->upsampleShader.setClipInfo(state_->clipInfo)
+      .setSharpness(state_->configuration.blurSharpness())
+      .bindInputTexture(*state_->depthStencilInput)
+      .bindSourceTexture(state_->hbaoResult)
+      .bindLinearDepthTexture(state_->sceneDepthLinear)
+      .draw(state_->triangle);
+}
+
 void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
   constexpr Mn::Float meters2viewspace = 1.0f;
 
@@ -865,22 +1381,14 @@ void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
           : state_->bilateralBlurShader;
   shader.setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
       .setInverseResolutionDirection(
-          {1.0f / state_->configuration.size().x(), 0.0f})
+          {1.0f / state_->size.x(), 0.0f})
       .bindSourceTexture(state_->hbaoResult);
   if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
     shader.bindLinearDepthTexture(state_->sceneDepthLinear);
   }
   shader.draw(state_->triangle);
 
-  output.bind();
-  Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
-  Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
-  Mn::GL::Renderer::setBlendFunction(
-      Mn::GL::Renderer::BlendFunction::Zero,
-      Mn::GL::Renderer::BlendFunction::SourceColor,
-      Mn::GL::Renderer::BlendFunction::Zero,
-      Mn::GL::Renderer::BlendFunction::One);
-  // TODO multi samples masking
+  bindAoOutput(output);
 
   // Only special blur
   HbaoBlurShader& secondShader =
@@ -890,7 +1398,7 @@ void Hbao::drawHbaoBlur(Mn::GL::AbstractFramebuffer& output) {
   secondShader
       .setSharpness(state_->configuration.blurSharpness() / meters2viewspace)
       .setInverseResolutionDirection(
-          {0.0f, 1.0f / state_->configuration.size().y()})
+          {0.0f, 1.0f / state_->size.y()})
       .bindSourceTexture(state_->hbaoBlur);
   if (!(state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur)) {
     secondShader.bindLinearDepthTexture(state_->sceneDepthLinear);
@@ -903,29 +1411,19 @@ void Hbao::drawEffect(const Mn::Matrix4& projection,
                       HbaoType algType,
                       Mn::GL::Texture2D& depthStencilInput,
                       Mn::GL::AbstractFramebuffer& output) {
-  if (projection[3][3] != 0) {
-    // Orthographic rendering
-    state_->hbaoUniformData.projInfo = {
-        2.0f / projection[0][0],
-        2.0f / projection[1][1],
-        -(1.0f + projection[3][0]) / projection[0][0],
-        -(1.0f - projection[3][1]) / projection[1][1],
-    };
-    state_->hbaoUniformData.projOrtho = 1;
-  } else {
-    // Perspective rendering -> projection[3][3] == 0
-    state_->hbaoUniformData.projInfo = {
-        2.0f / projection[0][0],
-        2.0f / projection[1][1],
-        -(1.0f - projection[2][0]) / projection[0][0],
-        -(1.0f + projection[2][1]) / projection[1][1],
-    };
-    state_->hbaoUniformData.projOrtho = 0;
-  }
+  CORRADE_ASSERT(state_->configuration.tileCount().product() == 1,
+                 "Hbao::drawEffect(): expected a projection for each of"
+                     << state_->configuration.tileCount() << "tiles", );
+  CORRADE_ASSERT(state_->configuration.temporalFrameCount() == 1,
+                 "Hbao::drawEffect(): temporal accumulation needs a camera "
+                 "matrix", );
+
+  state_->hbaoUniformData.projInfo = buildProjectionInfo(projection);
+  state_->hbaoUniformData.projOrtho = projection[3][3] != 0 ? 1 : 0;
 
   // TODO much of this data mapping does not need to be redone every frame
-  prepareHbaoData(state_->configuration, projection, state_->hbaoUniformData,
-                  state_->hbaoUniform, state_->random);
+  prepareHbaoData(state_->configuration, state_->size, projection,
+                  state_->hbaoUniformData, state_->hbaoUniform, state_->random);
   drawLinearDepth(projection, depthStencilInput);
   if (algType == HbaoType::CacheAware) {
     drawCacheAwareInternal(output);
@@ -934,17 +1432,85 @@ void Hbao::drawEffect(const Mn::Matrix4& projection,
   }
 }  // Hbao::draw
 
+void Hbao::drawEffect(const Mn::Matrix4& projection,
+                      const Mn::Matrix4& cameraMatrix,
+                      Mn::GL::Texture2D& depthStencilInput,
+                      Mn::GL::AbstractFramebuffer& output) {
+  CORRADE_ASSERT(state_->configuration.tileCount().product() == 1,
+                 "Hbao::drawEffect(): expected a projection for each of"
+                     << state_->configuration.tileCount() << "tiles", );
+
+  // A different projection means a resized or otherwise changed view, the
+  // history doesn't map to it anymore
+  if (projection != state_->previousProjection) {
+    resetTemporalHistory();
+  }
+  state_->projection = projection;
+  state_->cameraMatrix = cameraMatrix;
+
+  state_->hbaoUniformData.projInfo = buildProjectionInfo(projection);
+  state_->hbaoUniformData.projOrtho = projection[3][3] != 0 ? 1 : 0;
+
+  prepareHbaoData(state_->configuration, state_->size, projection,
+                  state_->hbaoUniformData, state_->hbaoUniform, state_->random);
+  drawLinearDepth(projection, depthStencilInput);
+  drawClassicInternal(output);
+}
+
+void Hbao::resetTemporalHistory() {
+  state_->temporalHistoryCount = 0;
+  state_->temporalFrame = 0;
+}
+
+void Hbao::drawEffect(Cr::Containers::ArrayView<const Mn::Matrix4> projections,
+                      Mn::GL::Texture2D& depthStencilInput,
+                      Mn::GL::AbstractFramebuffer& output) {
+  const Mn::Vector2i tileCount = state_->configuration.tileCount();
+  CORRADE_ASSERT(projections.size() == std::size_t(tileCount.product()),
+                 "Hbao::drawEffect(): expected" << tileCount.product()
+                                                << "projections, got"
+                                                << projections.size(), );
+  if (tileCount.product() == 1) {
+    drawEffect(projections[0], HbaoType::Classic, depthStencilInput, output);
+    return;
+  }
+
+  const Mn::Vector2i tileSize = state_->size / tileCount;
+  for (std::size_t i = 0; i != projections.size(); ++i) {
+    const bool orthographic = projections[i][3][3] != 0;
+    HbaoTileUniformData& tile = state_->hbaoTileUniformData[i];
+    tile.clipInfo = buildClipInfo(projections[i], orthographic);
+    tile.projInfo = buildProjectionInfo(projections[i]);
+    tile.radiusToScreen =
+        radiusToScreen(state_->configuration, tileSize.y(), projections[i],
+                       tile.projInfo, orthographic);
+    tile.projOrtho = orthographic ? 1 : 0;
+  }
+  state_->hbaoTileUniform.setSubData(
+      0, Cr::Containers::arrayView(state_->hbaoTileUniformData));
+
+  // The projection-dependent parts of the shared uniform data are unused by
+  // the tiled shaders, fill them from the first tile to have them sane
+  state_->hbaoUniformData.projInfo = state_->hbaoTileUniformData[0].projInfo;
+  state_->hbaoUniformData.projOrtho = state_->hbaoTileUniformData[0].projOrtho;
+  prepareHbaoData(state_->configuration, state_->size, projections[0],
+                  state_->hbaoUniformData, state_->hbaoUniform, state_->random);
+
+  state_->depthLinear.bind();
+  state_->depthLinearizeShader.bindTileUniformBuffer(state_->hbaoTileUniform)
+      .bindInputTexture(depthStencilInput)
+      .draw(state_->triangle);
+
+  drawClassicInternal(output);
+}
+
 void Hbao::drawClassicInternal(Mn::GL::AbstractFramebuffer& output) {
-  if (state_->configuration.flags() & HbaoFlag::NoBlur) {
-    output.bind();
-    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
-    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
-    Mn::GL::Renderer::setBlendFunction(
-        Mn::GL::Renderer::BlendFunction::Zero,
-        Mn::GL::Renderer::BlendFunction::SourceColor,
-        Mn::GL::Renderer::BlendFunction::Zero,
-        Mn::GL::Renderer::BlendFunction::One);
-    // TODO Set sample mask if samples > 1
+  const Mn::Int temporalFrameCount =
+      state_->configuration.temporalFrameCount();
+  if (temporalFrameCount != 1) {
+    state_->hbaoTemporalCalc.bind();
+  } else if (state_->configuration.flags() & HbaoFlag::NoBlur) {
+    bindAoOutput(output);
   } else {
     state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0}).bind();
   }
@@ -954,20 +1520,80 @@ void Hbao::drawClassicInternal(Mn::GL::AbstractFramebuffer& output) {
       state_->configuration.flags() & HbaoFlag::UseAoSpecialBlur
           ? state_->hbaoCalcSpecialBlurShader
           : state_->hbaoCalcShader;
+  if (temporalFrameCount != 1) {
+    // Each frame computes the next group of directions. Once all were
+    // computed, the next cycle uses another jitter so the accumulated result
+    // keeps getting new samples.
+    const Mn::UnsignedInt frameCount = temporalFrameCount;
+    const Mn::Int frame = state_->temporalFrame % frameCount;
+    const Mn::Int cycle = state_->temporalFrame / frameCount % MaxSamples;
+    shader.setDirectionOffset(frame * (MaxSamples / temporalFrameCount))
+        .bindRandomTexture(state_->hbaoRandom, cycle);
+  } else {
+    shader.bindRandomTexture(state_->hbaoRandom, 0);
+  }
   shader.bindLinearDepthTexture(state_->sceneDepthLinear)
-      .bindRandomTexture(state_->hbaoRandom, 0)
-      .bindUniformBuffer(state_->hbaoUniform)
-      .draw(state_->triangle);
+      .bindUniformBuffer(state_->hbaoUniform);
+  if (state_->configuration.tileCount().product() != 1) {
+    shader.bindTileUniformBuffer(state_->hbaoTileUniform);
+  }
+  shader.draw(state_->triangle);
+
+  if (temporalFrameCount != 1) {
+    drawTemporalResolve();
+  }
 
   if (!(state_->configuration.flags() & HbaoFlag::NoBlur)) {
     drawHbaoBlur(output);
   }
+  drawAoOutput(output);
 
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::Blending);
   // TODO reset sample mask if ever used
 }
 
+void Hbao::drawTemporalResolve() {
+  const Mn::Int temporalFrameCount =
+      state_->configuration.temporalFrameCount();
+
+  // Running average until the history has all directions, an exponential
+  // moving average of the same length after
+  const Mn::Float currentWeight =
+      1.0f /
+      Mn::Float(Mn::Math::min(state_->temporalHistoryCount + 1,
+                              temporalFrameCount));
+
+  state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0}).bind();
+  state_->temporalShader.setProjectionInfo(state_->hbaoUniformData.projInfo)
+      .setProjectionOrthographic(state_->hbaoUniformData.projOrtho)
+      .setReprojection(
+          state_->previousCameraMatrix * state_->cameraMatrix.inverted(),
+          state_->previousProjection)
+      .setCurrentWeight(currentWeight)
+      .bindCurrentTexture(state_->hbaoTemporalInput)
+      .bindLinearDepthTexture(state_->sceneDepthLinear)
+      .bindHistoryTexture(state_->hbaoHistory)
+      .bindHistoryLinearDepthTexture(state_->sceneDepthLinearHistory)
+      .draw(state_->triangle);
+
+  // Keep the accumulated AO, before blur, and the depth for the next frame
+  const Mn::Range2Di rectangle{{}, state_->size};
+  state_->hbaoCalc.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+  Mn::GL::AbstractFramebuffer::blit(state_->hbaoCalc, state_->hbaoHistoryCopy,
+                                    rectangle,
+                                    Mn::GL::FramebufferBlit::Color);
+  Mn::GL::AbstractFramebuffer::blit(
+      state_->depthLinear, state_->depthLinearHistoryCopy, rectangle,
+      Mn::GL::FramebufferBlit::Color);
+
+  state_->previousProjection = state_->projection;
+  state_->previousCameraMatrix = state_->cameraMatrix;
+  state_->temporalHistoryCount =
+      Mn::Math::min(state_->temporalHistoryCount + 1, temporalFrameCount);
+  ++state_->temporalFrame;
+}
+
 void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
   state_->viewNormal.bind();
 
@@ -1048,16 +1674,7 @@ void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
 #endif
 
   if (state_->configuration.flags() & HbaoFlag::NoBlur) {
-    output.bind();
-    Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::DepthTest);
-    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::Blending);
-    Mn::GL::Renderer::setBlendFunction(
-        Mn::GL::Renderer::BlendFunction::Zero,
-        Mn::GL::Renderer::BlendFunction::SourceColor,
-        Mn::GL::Renderer::BlendFunction::Zero,
-        Mn::GL::Renderer::BlendFunction::One);
-    // TODO Set sample mask if samples > 1
-
+    bindAoOutput(output);
   } else {
     state_->hbaoCalc.mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0}).bind();
   }
@@ -1074,6 +1691,7 @@ void Hbao::drawCacheAwareInternal(Mn::GL::AbstractFramebuffer& output) {
   if (!(state_->configuration.flags() & HbaoFlag::NoBlur)) {
     drawHbaoBlur(output);
   }
+  drawAoOutput(output);
   Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::DepthTest);
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::Blending);
   // TODO reset sample mask if ever used
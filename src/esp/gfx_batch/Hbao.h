@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_BATCH_HBAO_H_
 #define ESP_GFX_BATCH_HBAO_H_
 
+#include <Corrade/Containers/Containers.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/GL.h>
 #include <Magnum/Magnum.h>
@@ -29,6 +30,13 @@ typedef Corrade::Containers::EnumSet<HbaoFlag> HbaoFlags;
 
 CORRADE_ENUMSET_OPERATORS(HbaoFlags)
 
+/**
+ * Resolution the AO terms are calculated at, relative to the configured size.
+ * Reduced resolutions are bilaterally upsampled using the full-resolution
+ * depth so the occlusion doesn't bleed over depth edges.
+ */
+enum class HbaoResolution { Full = 1, Half = 2, Quarter = 4 };
+
 class HbaoConfiguration {
  public:
   Magnum::Vector2i size() const { return size_; }
@@ -38,6 +46,27 @@ class HbaoConfiguration {
     return *this;
   }
 
+  Magnum::Vector2i tileCount() const { return tileCount_; }
+
+  /**
+   * Treat the @ref size() as a grid of equally sized tiles, each with its own
+   * projection passed to the @ref Hbao::drawEffect() overload taking a list
+   * of projections. The size has to be divisible by the tile count, which
+   * can be at most 256 in total. Reduced resolutions aren't supported for
+   * tiles.
+   */
+  HbaoConfiguration& setTileCount(const Magnum::Vector2i& count) {
+    tileCount_ = count;
+    return *this;
+  }
+
+  HbaoResolution resolution() const { return resolution_; }
+
+  HbaoConfiguration& setResolution(HbaoResolution resolution) {
+    resolution_ = resolution;
+    return *this;
+  }
+
   HbaoFlags flags() const { return flags_; }
 
   // Blur should always be used, otherwise there's nasty grid-like artifacts.
@@ -124,12 +153,31 @@ class HbaoConfiguration {
     return *this;
   }
 
+  Magnum::Int temporalFrameCount() const { return temporalFrameCount_; }
+
+  /**
+   * Spread the AO directions of the classic algorithm over this many frames,
+   * computing only a fraction of them each frame and accumulating the result
+   * with the previous frames reprojected using the previous camera. Pixels
+   * that weren't visible in the previous frame are rejected based on their
+   * depth. Has to be 1, 2, 4 or 8, 1 disables the accumulation. Needs the
+   * @ref Hbao::drawEffect() overload taking a camera matrix, blur enabled
+   * and isn't supported for tiles.
+   */
+  HbaoConfiguration& setTemporalFrameCount(Magnum::Int count) {
+    temporalFrameCount_ = count;
+    return *this;
+  }
+
  private:
   Magnum::Vector2i size_;
+  Magnum::Vector2i tileCount_{1};
   HbaoFlags flags_{};
+  HbaoResolution resolution_ = HbaoResolution::Full;
   Magnum::Int samples_ = 1;
   Magnum::Float intensity_ = 0.732f, bias_ = 0.05f, radius_ = 1.84f,
                 blurSharpness_ = 10.0f;
+  Magnum::Int temporalFrameCount_ = 1;
 };  // class HbaoConfiguration
 
 enum class HbaoType { Classic, CacheAware };
@@ -167,16 +215,64 @@ class Hbao {
                   Magnum::GL::Texture2D& inputDepthStencil,
                   Magnum::GL::AbstractFramebuffer& output);
 
+  /**
+   * @brief Draw the HBAO effect with temporal accumulation
+   * @param projection The current visual sensor's projection matrix
+   * @param cameraMatrix The current camera matrix, i.e. the world-to-camera
+   * transformation, used to reproject the previous frames
+   * @param inputDepthStencil The owning RenderTarget's depthRenderTexture
+   * @param output The framebuffer the effect is to be written to
+   *
+   * Uses the classic algorithm, computing a fraction of the directions each
+   * frame as set by @ref HbaoConfiguration::setTemporalFrameCount(). If the
+   * projection changes or @ref resetTemporalHistory() was called, the
+   * previous frames are discarded.
+   */
+  void drawEffect(const Magnum::Matrix4& projection,
+                  const Magnum::Matrix4& cameraMatrix,
+                  Magnum::GL::Texture2D& inputDepthStencil,
+                  Magnum::GL::AbstractFramebuffer& output);
+
+  /**
+   * @brief Discard the frames accumulated for temporal accumulation
+   *
+   * Should be called on a camera cut or when the scene changes, so the
+   * previous frames aren't reprojected into the next one.
+   */
+  void resetTemporalHistory();
+
+  /**
+   * @brief Draw the HBAO effect on top of a tiled framebuffer.
+   * @param projections Projection matrix for each tile, in row-major order
+   * of @ref HbaoConfiguration::tileCount()
+   * @param inputDepthStencil Depth of the whole tiled framebuffer
+   * @param output The framebuffer the effect is to be written to
+   *
+   * All tiles are processed together in a single set of passes, with samples
+   * clamped to edges of their own tile. Uses the classic algorithm, the
+   * deinterleaved passes of the cache-aware one don't map to tiles.
+   */
+  void drawEffect(
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> projections,
+      Magnum::GL::Texture2D& inputDepthStencil,
+      Magnum::GL::AbstractFramebuffer& output);
+
   /**
    * @brief Retrieve the size of the framebuffer used to build the components of
    * the HBAO algorithms.
+   *
+   * Smaller than the configured size if a reduced
+   * @ref HbaoConfiguration::resolution() is used.
    */
   Magnum::Vector2i getFrameBufferSize() const;
 
  private:
   void drawLinearDepth(const Magnum::Matrix4& projection,
                        Magnum::GL::Texture2D& inputDepthStencil);
+  void bindAoOutput(Magnum::GL::AbstractFramebuffer& output);
+  void drawAoOutput(Magnum::GL::AbstractFramebuffer& output);
   void drawHbaoBlur(Magnum::GL::AbstractFramebuffer& output);
+  void drawTemporalResolve();
   void drawClassicInternal(Magnum::GL::AbstractFramebuffer& output);
   void drawCacheAwareInternal(Magnum::GL::AbstractFramebuffer& output);
 
@@ -9,6 +9,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/Containers/Triple.h>
@@ -18,6 +19,7 @@
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/MurmurHash2.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/GL/AbstractFramebuffer.h>
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
@@ -25,7 +27,11 @@
 #include <Magnum/GL/TextureArray.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Mesh.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/RemoveDuplicates.h>
@@ -43,7 +49,13 @@
 #include <Magnum/Trade/SceneData.h>
 #include <Magnum/Trade/TextureData.h>
 #include <esp/gfx_batch/DepthUnprojection.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -59,8 +71,13 @@ struct RendererConfiguration::State {
   RendererFlags flags;
   Mn::Vector2i tileSize{128, 128};
   Mn::Vector2i tileCount{1, 1};
+  /* If non-empty, used instead of tileSize and tileCount */
+  Cr::Containers::Array<Mn::Vector2i> tileSizes;
+  Mn::Int framebufferWidth{};
   Mn::UnsignedInt maxLightCount{0};
   Mn::Float ambientFactor{0.1f};
+  std::size_t textureMemoryBudget{};
+  Mn::UnsignedInt drawThreadCount{1};
 };
 
 RendererConfiguration::RendererConfiguration() : state{Cr::InPlaceInit} {}
@@ -71,11 +88,39 @@ RendererConfiguration& RendererConfiguration::setFlags(RendererFlags flags) {
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::addFlags(RendererFlags flags) {
+  return setFlags(state->flags | flags);
+}
+
 RendererConfiguration& RendererConfiguration::setTileSizeCount(
     const Mn::Vector2i& tileSize,
     const Mn::Vector2i& tileCount) {
   state->tileSize = tileSize;
   state->tileCount = tileCount;
+  state->tileSizes = {};
+  state->framebufferWidth = {};
+  return *this;
+}
+
+RendererConfiguration& RendererConfiguration::setTileSizes(
+    const Cr::Containers::ArrayView<const Mn::Vector2i> sizes,
+    const Mn::Int framebufferWidth) {
+  CORRADE_ASSERT(!sizes.isEmpty(),
+                 "RendererConfiguration::setTileSizes(): expected at least "
+                 "one size",
+                 *this);
+  for (std::size_t i = 0; i != sizes.size(); ++i) {
+    CORRADE_ASSERT(sizes[i].min() > 0 && sizes[i].x() <= framebufferWidth,
+                   "RendererConfiguration::setTileSizes(): size"
+                       << sizes[i] << "at index" << i
+                       << "is not positive or doesn't fit into a width of"
+                       << framebufferWidth,
+                   *this);
+  }
+  state->tileSizes = Cr::Containers::Array<Mn::Vector2i>{Cr::NoInit,
+                                                         sizes.size()};
+  Cr::Utility::copy(sizes, state->tileSizes);
+  state->framebufferWidth = framebufferWidth;
   return *this;
 }
 
@@ -91,6 +136,18 @@ RendererConfiguration& RendererConfiguration::setAmbientFactor(
   return *this;
 }
 
+RendererConfiguration& RendererConfiguration::setTextureMemoryBudget(
+    const std::size_t bytes) {
+  state->textureMemoryBudget = bytes;
+  return *this;
+}
+
+RendererConfiguration& RendererConfiguration::setDrawThreadCount(
+    const Mn::UnsignedInt count) {
+  state->drawThreadCount = count;
+  return *this;
+}
+
 namespace {
 
 struct MeshView {
@@ -101,6 +158,9 @@ struct MeshView {
   // TODO also parent, when we are able to fetch the whole hierarchy for a
   //  particular root object name instead of having the hierarchy flattened
   Mn::Matrix4 transformation;
+  /* Bounding sphere center and radius in mesh coordinates, with an infinite
+     radius if RendererFlag::FrustumCulling isn't enabled */
+  Mn::Vector4 bounds;
 };
 
 struct Light {
@@ -152,13 +212,24 @@ Mn::UnsignedInt drawBatchId(
 }
 
 struct Scene {
-  /* Camera unprojection. Updated from updateCamera(). */
+  /* Camera unprojection and projection alone. Updated from updateCamera(). */
   Mn::Vector2 cameraUnprojection;
+  Mn::Matrix4 cameraProjection;
 
   /* Node parents and transformations. Appended to with add(). Some of these
      (but not all) are referenced from the transformationIds array below. */
   Cr::Containers::Array<Mn::Int> parents; /* parents[i] < i, always */
   Cr::Containers::Array<Mn::Matrix4> transformations;
+  /* Index into the per-draw arrays below for each node, -1 if the node has no
+     draw and -2 if it was removed. Updated as draws get moved around by
+     removeNodeHierarchy(). */
+  Cr::Containers::Array<Mn::Int> nodeDrawIds;
+  /* First node IDs of contiguous node ranges freed by removeNodeHierarchy(),
+     indexed by the range size. Reused by a subsequent addNodeHierarchy() or
+     addEmptyNode() needing the same size, which keeps the parents[i] < i
+     invariant. */
+  std::unordered_map<std::size_t, Cr::Containers::Array<std::size_t>>
+      freeNodeRanges;
   /* Lights, with node IDs referencing transformations from above */
   Cr::Containers::Array<Light> lights;
 
@@ -177,17 +248,44 @@ struct Scene {
   Cr::Containers::Array<Mn::Shaders::TextureTransformationUniform>
       textureTransformations;
   Cr::Containers::Array<DrawCommand> drawCommands;
+  /* Bounding spheres of draws, used for RendererFlag::FrustumCulling */
+  Cr::Containers::Array<Mn::Vector4> drawBounds;
 
   /* The transformationIds and drawCommands arrays sorted by meshIds. The
      textureTransformations array is uploaded to uniform buffers after sorting
-     and not used from the CPU again so it doesn't need to be cached here. */
+     and is used from the CPU again only with RendererFlag::FrustumCulling,
+     where it's populated. */
   Cr::Containers::Array<Mn::Shaders::PhongDrawUniform> drawsSorted;
   Cr::Containers::Array<Mn::UnsignedInt> transformationIdsSorted;
+  Cr::Containers::Array<Mn::Shaders::TextureTransformationUniform>
+      textureTransformationsSorted;
+  Cr::Containers::Array<Mn::Vector4> drawBoundsSorted;
   // TODO make the layout match GL (... deinterleave) to avoid a copy in draw()
   //  or maybe not and just go with draw indirect directly
   Cr::Containers::Array<Mn::UnsignedInt> drawBatchOffsets;
   Cr::Containers::Array<DrawCommand> drawCommandsSorted;
 
+  /* Subset of the sorted draw commands and draw batch offsets passing the
+     frustum test, updated every frame with RendererFlag::FrustumCulling */
+  Cr::Containers::Array<Mn::UnsignedInt> drawBatchOffsetsVisible;
+  Cr::Containers::Array<DrawCommand> drawCommandsVisible;
+  std::size_t culledDrawCount = 0;
+
+  /* Per-frame data filled by prepareSceneDraws() and uploaded to the
+     uniform buffers below. The absolute transformations are of the sorted
+     draws, or just the visible ones with RendererFlag::FrustumCulling, in
+     which case also the compacted per-draw uniforms are here. The light
+     array has space for light lists of culled draws packed after the scene
+     lights. */
+  Cr::Containers::Array<Mn::Shaders::TransformationUniform3D>
+      absoluteTransformationsSorted;
+  Cr::Containers::Array<Mn::Shaders::PhongDrawUniform> drawsVisible;
+  Cr::Containers::Array<Mn::Shaders::TextureTransformationUniform>
+      textureTransformationsVisible;
+  Cr::Containers::Array<Mn::Shaders::PhongLightUniform> absoluteLights;
+  std::size_t visibleDrawCount = 0;
+  std::size_t lightCount = 0;
+
   /* Updated every frame */
   // TODO make these two global, uploaded just once (plus accounting for
   //  padding)
@@ -200,23 +298,435 @@ struct Scene {
   Mn::GL::Buffer textureTransformationUniform;
 };
 
+/* Temporary state of prepareSceneDraws(), one per thread preparing scenes to
+   avoid allocating inside each draw() */
+// TODO might be useful to have some per-frame bump allocator instead, for
+//  smaller peak memory use
+struct DrawScratch {
+  Cr::Containers::Array<Mn::Shaders::TransformationUniform3D>
+      absoluteTransformations;
+  /* Bounding spheres of draws passing the frustum test */
+  Cr::Containers::Array<Mn::Vector4> drawBoundsVisible;
+  /* Lights reaching a draw, and offsets of the light lists packed after the
+     scene lights, keyed by the light IDs in them */
+  std::vector<Mn::UnsignedInt> drawLights;
+  std::map<std::vector<Mn::UnsignedInt>, Mn::UnsignedInt> lightListOffsets;
+};
+
 struct TextureTransformation {
   Mn::UnsignedInt textureId;
   Mn::UnsignedInt layer;
   Mn::Matrix3 transformation;
 };
 
+/* Levels of at most this size are uploaded upfront for streamed textures and
+   are never evicted */
+constexpr Mn::Int StreamedTextureInitialSize = 64;
+
+/* A texture with a pre-made mip chain, streamed in and out under
+   RendererConfiguration::setTextureMemoryBudget() */
+struct StreamedTexture {
+  Mn::UnsignedInt textureId;
+  Mn::SamplerFilter minificationFilter;
+  Mn::SamplerMipmap mipmapFilter;
+  Mn::SamplerFilter magnificationFilter;
+  Mn::Math::Vector2<Mn::SamplerWrapping> wrapping;
+  /* CPU copies of all levels, 2D images are stored as single-layer 3D
+     images */
+  Cr::Containers::Array<Mn::Trade::ImageData3D> levels;
+  /* The largest level resident on the GPU, the largest one draw() is moving
+     towards and the level that's resident upfront and never evicted */
+  Mn::UnsignedInt residentLevel, targetLevel, initialLevel;
+  /* Frame in which the texture was last referenced by a draw */
+  std::size_t lastReferencedFrame;
+};
+
+/* Size of the given level and all smaller ones */
+std::size_t streamedTextureSize(const StreamedTexture& texture,
+                                const Mn::UnsignedInt level) {
+  std::size_t size = 0;
+  for (std::size_t i = level; i != texture.levels.size(); ++i)
+    size += texture.levels[i].data().size();
+  return size;
+}
+
+/* Estimated size of a full mip chain of given level count uploaded or
+   generated from a base level of given size */
+std::size_t mipChainSize(const std::size_t baseSize,
+                         const Mn::UnsignedInt levelCount) {
+  std::size_t size = 0;
+  for (Mn::UnsignedInt i = 0; i != levelCount; ++i)
+    size += baseSize >> (2 * i);
+  return size;
+}
+
+/* The imported data may be referencing memory-mapped files, which get unmapped
+   at the end of addFile(), so make an owned copy */
+Mn::Trade::ImageData3D streamedLevel(const Mn::Trade::ImageData3D& image) {
+  Cr::Containers::Array<char> data{Cr::NoInit, image.data().size()};
+  Cr::Utility::copy(image.data(), data);
+  if (image.isCompressed())
+    return Mn::Trade::ImageData3D{image.compressedStorage(),
+                                  image.compressedFormat(), image.size(),
+                                  std::move(data)};
+  return Mn::Trade::ImageData3D{image.storage(), image.format(), image.size(),
+                                std::move(data)};
+}
+
+Mn::Trade::ImageData3D streamedLevel(const Mn::Trade::ImageData2D& image) {
+  Cr::Containers::Array<char> data{Cr::NoInit, image.data().size()};
+  Cr::Utility::copy(image.data(), data);
+  if (image.isCompressed())
+    return Mn::Trade::ImageData3D{image.compressedStorage(),
+                                  image.compressedFormat(),
+                                  {image.size(), 1},
+                                  std::move(data)};
+  return Mn::Trade::ImageData3D{image.storage(), image.format(),
+                                {image.size(), 1}, std::move(data)};
+}
+
+/* Imports all levels of a texture for streaming. Returns a NullOpt if the
+   texture doesn't have a pre-made mip chain or if any level fails to import,
+   in which case it's imported the usual way, which eventually reports the
+   error. */
+Cr::Containers::Optional<StreamedTexture> importStreamedTexture(
+    Mn::Trade::AbstractImporter& importer,
+    const Mn::Trade::TextureData& textureData) {
+  const bool is2D = textureData.type() == Mn::Trade::TextureType::Texture2D;
+  const Mn::UnsignedInt levelCount =
+      is2D ? importer.image2DLevelCount(textureData.image())
+           : importer.image3DLevelCount(textureData.image());
+  if (levelCount <= 1)
+    return {};
+
+  StreamedTexture texture;
+  texture.minificationFilter = textureData.minificationFilter();
+  texture.mipmapFilter = textureData.mipmapFilter();
+  texture.magnificationFilter = textureData.magnificationFilter();
+  texture.wrapping = textureData.wrapping().xy();
+  arrayReserve(texture.levels, levelCount);
+  for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
+    if (is2D) {
+      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+          importer.image2D(textureData.image(), level);
+      if (!image)
+        return {};
+      arrayAppend(texture.levels, streamedLevel(*image));
+    } else {
+      Cr::Containers::Optional<Mn::Trade::ImageData3D> image =
+          importer.image3D(textureData.image(), level);
+      if (!image)
+        return {};
+      arrayAppend(texture.levels, streamedLevel(*image));
+    }
+  }
+
+  /* The first level that's small enough gets uploaded upfront, or the last
+     one if none is */
+  texture.initialLevel = levelCount - 1;
+  for (Mn::UnsignedInt level = 0; level != levelCount; ++level) {
+    if (texture.levels[level].size().xy().max() <= StreamedTextureInitialSize) {
+      texture.initialLevel = level;
+      break;
+    }
+  }
+  texture.residentLevel = texture.targetLevel = texture.initialLevel;
+  texture.lastReferencedFrame = 0;
+  return texture;
+}
+
+/* Creates a GPU texture with the given level of a streamed texture and all
+   smaller ones */
+Mn::GL::Texture2DArray uploadStreamedTexture(const StreamedTexture& texture,
+                                             const Mn::UnsignedInt level) {
+  const Mn::Trade::ImageData3D& image = texture.levels[level];
+  const Mn::UnsignedInt levelCount = texture.levels.size() - level;
+
+  Mn::GL::Texture2DArray out;
+  out.setMinificationFilter(texture.minificationFilter, texture.mipmapFilter)
+      .setMagnificationFilter(texture.magnificationFilter)
+      .setWrapping(texture.wrapping);
+  if (image.isCompressed()) {
+    out.setStorage(levelCount, Mn::GL::textureFormat(image.compressedFormat()),
+                   image.size());
+    for (Mn::UnsignedInt i = 0; i != levelCount; ++i) {
+      CORRADE_INTERNAL_ASSERT(
+          texture.levels[level + i].isCompressed() &&
+          texture.levels[level + i].compressedFormat() ==
+              image.compressedFormat());
+      out.setCompressedSubImage(i, {}, texture.levels[level + i]);
+    }
+  } else {
+    out.setStorage(levelCount, Mn::GL::textureFormat(image.format()),
+                   image.size());
+    for (Mn::UnsignedInt i = 0; i != levelCount; ++i)
+      out.setSubImage(i, {}, texture.levels[level + i]);
+  }
+  return out;
+}
+
+/* Bounding sphere of positions referenced by an index range, with the center
+   of their bounding box as the center */
+Mn::Vector4 boundingSphere(
+    const Cr::Containers::ArrayView<const Mn::Vector3> positions,
+    const Cr::Containers::ArrayView<const Mn::UnsignedInt> indices) {
+  if (indices.isEmpty())
+    return {};
+
+  Mn::Range3D range{positions[indices[0]], positions[indices[0]]};
+  for (const Mn::UnsignedInt index : indices)
+    range = Mn::Math::join(range, {positions[index], positions[index]});
+
+  const Mn::Vector3 center = range.center();
+  Mn::Float radiusSquared = 0.0f;
+  for (const Mn::UnsignedInt index : indices)
+    radiusSquared =
+        Mn::Math::max(radiusSquared, (positions[index] - center).dot());
+  return {center, std::sqrt(radiusSquared)};
+}
+
+/* Returns the first ID of a contiguous range of count nodes, either reused
+   from a range freed by Renderer::removeNodeHierarchy() or appended. The
+   caller is expected to fill in all per-node data. */
+std::size_t allocateNodes(Scene& scene, const std::size_t count) {
+  const auto found = scene.freeNodeRanges.find(count);
+  if (found != scene.freeNodeRanges.end() && !found->second.isEmpty()) {
+    const std::size_t id = found->second.back();
+    arrayRemoveSuffix(found->second);
+    return id;
+  }
+
+  const std::size_t id = scene.parents.size();
+  arrayAppend(scene.parents, Cr::NoInit, count);
+  arrayAppend(scene.transformations, Cr::NoInit, count);
+  arrayAppend(scene.nodeDrawIds, Cr::NoInit, count);
+  return id;
+}
+
+/* Calculates absolute transformations of a scene, culls its draws and
+   assigns lights to them, filling the per-frame arrays of the scene to be
+   uploaded. Touches only the scene and the scratch, so different scenes can
+   be prepared on different threads. */
+void prepareSceneDraws(Scene& scene,
+                       const Mn::Matrix4& projectionMatrix,
+                       const RendererFlags flags,
+                       const Mn::UnsignedInt maxLightCount,
+                       DrawScratch& scratch) {
+  /* The first slot holds the root transformation for easier dealing with
+     `parent == -1`. Resize if it's too small. */
+  if (scratch.absoluteTransformations.size() <
+      scene.transformations.size() + 1)
+    arrayResize(scratch.absoluteTransformations, Cr::NoInit,
+                scene.transformations.size() + 1);
+
+  // TODO have a tool for this! AVX512!!
+  scratch.absoluteTransformations[0].setTransformationMatrix(Mn::Matrix4{});
+  for (std::size_t i = 0; i != scene.transformations.size(); ++i)
+    scratch.absoluteTransformations[i + 1].setTransformationMatrix(
+        scratch.absoluteTransformations[scene.parents[i] + 1]
+            .transformationMatrix *
+        scene.transformations[i]);
+
+  /* Copy transformations referenced by actual draws. Resize if destination
+     is too small. */
+  if (scene.absoluteTransformationsSorted.size() <
+      scene.transformationIdsSorted.size())
+    arrayResize(scene.absoluteTransformationsSorted, Cr::NoInit,
+                scene.transformationIdsSorted.size());
+  // TODO the casting situation is GETTING OUT OF HAND
+  Mn::MeshTools::duplicateInto(
+      Cr::Containers::StridedArrayView1D<const Mn::UnsignedInt>{
+          scene.transformationIdsSorted},
+      Cr::Containers::StridedArrayView1D<
+          const Mn::Shaders::TransformationUniform3D>{
+          scratch.absoluteTransformations.exceptPrefix(1)},
+      stridedArrayView(scene.absoluteTransformationsSorted.prefix(
+          scene.transformationIdsSorted.size())));
+
+  /* With frustum culling, compact the sorted per-draw data batch by batch
+     to just the draws with a bounding sphere intersecting the camera
+     frustum. The transformations are compacted in place, the rest goes to
+     the visible arrays. */
+  const std::size_t drawCount = scene.transformationIdsSorted.size();
+  std::size_t visibleDrawCount = drawCount;
+  Cr::Containers::ArrayView<Mn::Shaders::PhongDrawUniform> draws =
+      scene.drawsSorted;
+  if (flags & RendererFlag::FrustumCulling) {
+    if (scene.drawsVisible.size() < drawCount) {
+      arrayResize(scene.drawsVisible, Cr::NoInit, drawCount);
+      arrayResize(scene.textureTransformationsVisible, Cr::NoInit, drawCount);
+    }
+    if (scratch.drawBoundsVisible.size() < drawCount)
+      arrayResize(scratch.drawBoundsVisible, Cr::NoInit, drawCount);
+    arrayResize(scene.drawCommandsVisible, Cr::NoInit, drawCount);
+    arrayResize(scene.drawBatchOffsetsVisible, Cr::NoInit,
+                scene.drawBatches.size() + 1);
+
+    const Mn::Frustum frustum = Mn::Frustum::fromMatrix(projectionMatrix);
+    visibleDrawCount = 0;
+    scene.drawBatchOffsetsVisible[0] = 0;
+    for (std::size_t batch = 0; batch != scene.drawBatches.size(); ++batch) {
+      for (std::size_t i = scene.drawBatchOffsets[batch],
+                       iMax = scene.drawBatchOffsets[batch + 1];
+           i != iMax; ++i) {
+        const Mn::Matrix4& transformation =
+            scene.absoluteTransformationsSorted[i].transformationMatrix;
+        const Mn::Vector4& bounds = scene.drawBoundsSorted[i];
+        if (!Mn::Math::Intersection::sphereFrustum(
+                transformation.transformPoint(bounds.xyz()),
+                bounds.w() * std::sqrt(transformation.scalingSquared().max()),
+                frustum))
+          continue;
+
+        scene.absoluteTransformationsSorted[visibleDrawCount] =
+            scene.absoluteTransformationsSorted[i];
+        scene.drawsVisible[visibleDrawCount] = scene.drawsSorted[i];
+        scene.textureTransformationsVisible[visibleDrawCount] =
+            scene.textureTransformationsSorted[i];
+        scratch.drawBoundsVisible[visibleDrawCount] = bounds;
+        scene.drawCommandsVisible[visibleDrawCount] =
+            scene.drawCommandsSorted[i];
+        ++visibleDrawCount;
+      }
+      scene.drawBatchOffsetsVisible[batch + 1] = visibleDrawCount;
+    }
+    scene.culledDrawCount = drawCount - visibleDrawCount;
+    draws = scene.drawsVisible.prefix(visibleDrawCount);
+  }
+  scene.visibleDrawCount = visibleDrawCount;
+
+  /* Copy light properties and cherry-pick transformations for them. Resize
+     the destination if it's too small, it has space for light lists of
+     culled draws packed after the scene lights. */
+  if (scene.absoluteLights.size() <
+      Mn::Math::max(std::size_t(maxLightCount), scene.lights.size()))
+    arrayResize(
+        scene.absoluteLights, Cr::NoInit,
+        Mn::Math::max(std::size_t(maxLightCount), scene.lights.size()));
+  bool cullLights = false;
+  for (std::size_t i = 0; i != scene.lights.size(); ++i) {
+    const Light& light = scene.lights[i];
+    scene.absoluteLights[i]
+        .setColor(light.color)
+        .setSpecularColor(light.color)
+        .setRange(light.range);
+    if (light.type == RendererLightType::Directional)
+      scene.absoluteLights[i].setPosition(
+          Mn::Vector4{-scratch.absoluteTransformations[light.node + 1]
+                           .transformationMatrix.backward(),
+                      0.0f});
+    else if (light.type == RendererLightType::Point) {
+      scene.absoluteLights[i].setPosition(
+          Mn::Vector4{scratch.absoluteTransformations[light.node + 1]
+                          .transformationMatrix.translation(),
+                      1.0f});
+      /* Culling only makes a difference with lights of a finite range, and
+         not at all if nothing is shaded */
+      if (light.range != Mn::Constants::inf() &&
+          !(flags & RendererFlag::DepthOnly))
+        cullLights = true;
+    } else
+      CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+  }
+
+  /* Finish transformation-dependent per-draw info */
+  std::size_t lightCount = scene.lights.size();
+  scratch.lightListOffsets.clear();
+  for (std::size_t i = 0; i != visibleDrawCount; ++i) {
+    const Mn::Matrix4& transformation =
+        scene.absoluteTransformationsSorted[i].transformationMatrix;
+    /* Extract normal matrix */
+    draws[i].setNormalMatrix(transformation.normalMatrix());
+    if (!cullLights) {
+      draws[i].setLightOffsetCount(0, scene.lights.size());
+      continue;
+    }
+
+    /* Only the lights whose range reaches the bounding sphere of the draw. A
+       light list that's a contiguous range of the scene lights is used
+       directly, other lists are packed after the scene lights as long as
+       they fit into the max light count. Draws whose list doesn't fit get
+       all lights. */
+    const Mn::Vector4& bounds = flags & RendererFlag::FrustumCulling
+                                    ? scratch.drawBoundsVisible[i]
+                                    : scene.drawBoundsSorted[i];
+    const Mn::Vector3 center = transformation.transformPoint(bounds.xyz());
+    const Mn::Float radius =
+        bounds.w() * std::sqrt(transformation.scalingSquared().max());
+    scratch.drawLights.clear();
+    for (Mn::UnsignedInt j = 0; j != scene.lights.size(); ++j) {
+      const Mn::Shaders::PhongLightUniform& light = scene.absoluteLights[j];
+      if (light.position.w() == 0.0f ||
+          (light.position.xyz() - center).length() < light.range + radius)
+        scratch.drawLights.push_back(j);
+    }
+    const std::vector<Mn::UnsignedInt>& drawLights = scratch.drawLights;
+    if (drawLights.empty()) {
+      draws[i].setLightOffsetCount(0, 0);
+    } else if (drawLights.back() - drawLights.front() + 1 ==
+               drawLights.size()) {
+      draws[i].setLightOffsetCount(drawLights.front(), drawLights.size());
+    } else {
+      auto found = scratch.lightListOffsets.find(drawLights);
+      if (found == scratch.lightListOffsets.end() &&
+          lightCount + drawLights.size() <= maxLightCount) {
+        found = scratch.lightListOffsets.emplace(drawLights, lightCount).first;
+        for (const Mn::UnsignedInt light : drawLights)
+          scene.absoluteLights[lightCount++] = scene.absoluteLights[light];
+      }
+      if (found != scratch.lightListOffsets.end())
+        draws[i].setLightOffsetCount(found->second, drawLights.size());
+      else
+        draws[i].setLightOffsetCount(0, scene.lights.size());
+    }
+  }
+  scene.lightCount = lightCount;
+}
+
 /* NVidia requires uniform buffer bindings to have an INSANE 256-byte
    alignment, so we give in and pad our stuff */
 struct ProjectionPadded : Mn::Shaders::ProjectionUniform3D {
   char padding[256 - sizeof(Mn::Shaders::ProjectionUniform3D)];
 };
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+/* Files memory-mapped for RendererFlag::MemoryMapFiles, kept alive for as long
+   as the importer referencing them */
+struct MappedFiles {
+  Cr::Containers::String directory;
+  Cr::Containers::Array<
+      Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+      files;
+};
+
+Cr::Containers::Optional<Cr::Containers::ArrayView<const char>>
+mapFileCallback(const std::string& filename,
+                const Mn::InputFileCallbackPolicy policy,
+                MappedFiles& mapped) {
+  /* The mappings are released all at once with the importer */
+  if (policy == Mn::InputFileCallbackPolicy::Close)
+    return {};
+
+  Cr::Containers::Optional<
+      Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+      file = Cr::Utility::Path::mapRead(
+          Cr::Utility::Path::join(mapped.directory, filename));
+  if (!file)
+    return {};
+  arrayAppend(mapped.files, *std::move(file));
+  return Cr::Containers::ArrayView<const char>{mapped.files.back()};
+}
+#endif
+
 }  // namespace
 
 struct Renderer::State {
   RendererFlags flags;
+  /* Zero if per-scene tile sizes are used */
   Mn::Vector2i tileSize, tileCount;
+  /* Framebuffer area each scene renders into, and their bounds */
+  Cr::Containers::Array<Mn::Range2Di> sceneRectangles;
+  Mn::Vector2i framebufferSize;
   Mn::UnsignedInt maxLightCount;
   Mn::Float ambientFactor;
   /* Indexed with Mn::Shaders::PhongGL::Flag, but I don't want to bother with
@@ -227,11 +737,24 @@ struct Renderer::State {
 
   /* Filled upon addFile() */
   Cr::Containers::Array<Mn::GL::Texture2DArray> textures;
+  /* Used only if textureMemoryBudget is non-zero. Textures with a pre-made mip
+     chain, each referencing an item in the textures array, and estimated
+     size of the remaining textures, which are always resident in full. */
+  std::size_t textureMemoryBudget;
+  Cr::Containers::Array<StreamedTexture> streamedTextures;
+  std::size_t staticTextureMemory = 0;
+  /* Incremented by every draw() to track when textures were last
+     referenced, and temporaries to avoid allocating inside each draw() */
+  std::size_t frame = 0;
+  Cr::Containers::Array<bool> textureReferenced;
+  Cr::Containers::Array<Mn::UnsignedInt> streamedTextureOrder;
   /* Each mesh contains a set of flags it needs from the shader (such as
      enabling vertex colors) */
   Cr::Containers::Array<
       Cr::Containers::Pair<Mn::Shaders::PhongGL::Flags, Mn::GL::Mesh>>
       meshes;
+  /* Vertex and index data size of all meshes */
+  std::size_t meshMemory = 0;
   // TODO clear this array once/if the materialUniform is populated on first
   //  draw() and adding more files is forbidden
   Cr::Containers::Array<Mn::Shaders::PhongMaterialUniform> materials;
@@ -257,14 +780,8 @@ struct Renderer::State {
 
   Cr::Containers::Array<Scene> scenes;
 
-  /* Temporary per-frame state to avoid allocating inside each draw() */
-  // TODO might be useful to have some per-frame bump allocator instead, for
-  //  smaller peak memory use
-  Cr::Containers::Array<Mn::Shaders::TransformationUniform3D>
-      absoluteTransformations;
-  Cr::Containers::Array<Mn::Shaders::TransformationUniform3D>
-      absoluteTransformationsSorted;
-  Cr::Containers::Array<Mn::Shaders::PhongLightUniform> absoluteLights;
+  /* Temporary per-frame state of each thread preparing scenes in draw() */
+  Cr::Containers::Array<DrawScratch> drawScratches;
 };
 
 Renderer::Renderer(Mn::NoCreateT) {}
@@ -276,11 +793,51 @@ void Renderer::create(const RendererConfiguration& configurationWrapper) {
   CORRADE_INTERNAL_ASSERT(!state_);
   state_.emplace();
   state_->flags = configuration.flags;
-  state_->tileSize = configuration.tileSize;
-  state_->tileCount = configuration.tileCount;
+  /* Depth-only rendering has no use for textures, don't even load them */
+  if (state_->flags & RendererFlag::DepthOnly)
+    state_->flags |= RendererFlag::NoTextures;
   state_->maxLightCount = configuration.maxLightCount;
   state_->ambientFactor = configuration.ambientFactor;
-  const std::size_t sceneCount = configuration.tileCount.product();
+  state_->textureMemoryBudget = configuration.textureMemoryBudget;
+  state_->drawScratches = Cr::Containers::Array<DrawScratch>{
+      configuration.drawThreadCount
+          ? configuration.drawThreadCount
+          : Mn::Math::max(1u, std::thread::hardware_concurrency())};
+
+  /* Either a uniform grid of tiles, or tiles of various sizes packed into
+     rows, each as tall as its tallest tile */
+  if (configuration.tileSizes.isEmpty()) {
+    state_->tileSize = configuration.tileSize;
+    state_->tileCount = configuration.tileCount;
+    state_->framebufferSize = configuration.tileSize * configuration.tileCount;
+    state_->sceneRectangles = Cr::Containers::Array<Mn::Range2Di>{
+        Cr::NoInit, std::size_t(configuration.tileCount.product())};
+    for (Mn::Int y = 0; y != configuration.tileCount.y(); ++y)
+      for (Mn::Int x = 0; x != configuration.tileCount.x(); ++x)
+        state_->sceneRectangles[y * configuration.tileCount.x() + x] =
+            Mn::Range2Di::fromSize(
+                Mn::Vector2i{x, y} * configuration.tileSize,
+                configuration.tileSize);
+  } else {
+    state_->sceneRectangles = Cr::Containers::Array<Mn::Range2Di>{
+        Cr::NoInit, configuration.tileSizes.size()};
+    Mn::Vector2i cursor;
+    Mn::Int rowHeight = 0;
+    for (std::size_t i = 0; i != configuration.tileSizes.size(); ++i) {
+      const Mn::Vector2i size = configuration.tileSizes[i];
+      if (cursor.x() + size.x() > configuration.framebufferWidth) {
+        cursor = {0, cursor.y() + rowHeight};
+        rowHeight = 0;
+      }
+      state_->sceneRectangles[i] = Mn::Range2Di::fromSize(cursor, size);
+      cursor.x() += size.x();
+      rowHeight = Mn::Math::max(rowHeight, size.y());
+    }
+    state_->framebufferSize = {configuration.framebufferWidth,
+                               cursor.y() + rowHeight};
+  }
+
+  const std::size_t sceneCount = state_->sceneRectangles.size();
   state_->cameraMatrices = Cr::Containers::Array<ProjectionPadded>{sceneCount};
   state_->scenes = Cr::Containers::Array<Scene>{sceneCount};
 
@@ -297,6 +854,7 @@ void Renderer::create(const RendererConfiguration& configurationWrapper) {
           0, {},
           Mn::ImageView3D{
               Mn::PixelFormat::RGBA8Unorm, {1, 1, 1}, "\xff\xff\xff\xff"});
+  state_->staticTextureMemory = 4;
 
   /* Material 0 is reserved as a white ambient with no texture */
   arrayAppend(state_->materials, Cr::InPlaceInit)
@@ -330,6 +888,38 @@ std::size_t Renderer::sceneCount() const {
   return state_->scenes.size();
 }
 
+Mn::Vector2i Renderer::framebufferSize() const {
+  return state_->framebufferSize;
+}
+
+Mn::Range2Di Renderer::sceneRectangle(const Mn::UnsignedInt sceneId) const {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::sceneRectangle(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes",
+                 {});
+  return state_->sceneRectangles[sceneId];
+}
+
+std::size_t Renderer::textureMemoryBudget() const {
+  return state_->textureMemoryBudget;
+}
+
+std::size_t Renderer::textureMemoryUsage() const {
+  std::size_t usage = state_->staticTextureMemory;
+  for (const StreamedTexture& texture : state_->streamedTextures)
+    usage += streamedTextureSize(texture, texture.residentLevel);
+  return usage;
+}
+
+std::size_t Renderer::meshMemoryUsage() const {
+  return state_->meshMemory;
+}
+
+Mn::UnsignedInt Renderer::drawThreadCount() const {
+  return state_->drawScratches.size();
+}
+
 Mn::UnsignedInt Renderer::maxLightCount() const {
   return state_->maxLightCount;
 }
@@ -355,6 +945,10 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
                        const Cr::Containers::StringView importerPlugin,
                        const RendererFileFlags flags,
                        const Cr::Containers::StringView name) {
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+  /* Declared before the importer so the mappings outlive it */
+  MappedFiles mapped;
+#endif
   Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> manager;
   Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
       manager.loadAndInstantiate(importerPlugin);
@@ -400,9 +994,29 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     metadata->configuration().setValue("format", "Astc4x4RGBA");
   }
 
-  // TODO memory-map self-contained files (have a config option? do implicitly
-  //  for glb, bps and ply?)
-  if (!importer->openFile(filename)) {
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+  /* Buffers and images referenced by the file get mapped through the
+     callback. The file itself too if the importer can open memory, as
+     externally owned so the importer doesn't make a copy of it, otherwise
+     (such as with AnySceneImporter, which needs the extension) the file
+     goes through the callback as well. */
+  if (state_->flags & RendererFlag::MemoryMapFiles) {
+    importer->setFileCallback(mapFileCallback, mapped);
+    if (importer->features() & Mn::Trade::ImporterFeature::OpenData) {
+      /* Without the file name, references come relative to the file */
+      mapped.directory = Cr::Utility::Path::split(filename).first();
+      Cr::Containers::Optional<
+          Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+          file = Cr::Utility::Path::mapRead(filename);
+      if (!file || !importer->openMemory(*file)) {
+        Mn::Error{} << "Renderer::addFile(): can't open the file";
+        return {};
+      }
+      arrayAppend(mapped.files, *std::move(file));
+    }
+  }
+#endif
+  if (!importer->isOpened() && !importer->openFile(filename)) {
     Mn::Error{} << "Renderer::addFile(): can't open the file";
     return {};
   }
@@ -426,6 +1040,20 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
         return {};
       }
 
+      /* With a texture memory budget, textures with a pre-made mip chain get
+         streamed, with just the small levels uploaded now */
+      if (state_->textureMemoryBudget) {
+        Cr::Containers::Optional<StreamedTexture> streamed =
+            importStreamedTexture(*importer, *textureData);
+        if (streamed) {
+          streamed->textureId = state_->textures.size();
+          arrayAppend(state_->textures,
+                      uploadStreamedTexture(*streamed, streamed->initialLevel));
+          arrayAppend(state_->streamedTextures, *std::move(streamed));
+          continue;
+        }
+      }
+
       /* 2D textures are imported as single-layer 2D array textures */
       Mn::GL::Texture2DArray texture;
       if (textureData->type() == Mn::Trade::TextureType::Texture2DArray) {
@@ -476,6 +1104,9 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
           if (generateMipmap)
             texture.generateMipmap();
         }
+        state_->staticTextureMemory += mipChainSize(
+            image->data().size(),
+            image->isCompressed() ? levelCount : desiredLevelCount);
       } else if (textureData->type() == Mn::Trade::TextureType::Texture2D) {
         const Mn::UnsignedInt levelCount =
             importer->image2DLevelCount(textureData->image());
@@ -526,6 +1157,9 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
           if (generateMipmap)
             texture.generateMipmap();
         }
+        state_->staticTextureMemory += mipChainSize(
+            image->data().size(),
+            image->isCompressed() ? levelCount : desiredLevelCount);
       } else
         CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
@@ -533,6 +1167,15 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     }
   }
 
+  /* Positions, indices and index type size of all meshes, for calculating
+     bounds of mesh views referencing them below */
+  const bool calculateBounds = state_->flags & RendererFlag::FrustumCulling;
+  Cr::Containers::Array<
+      Cr::Containers::Triple<Cr::Containers::Array<Mn::Vector3>,
+                             Cr::Containers::Array<Mn::UnsignedInt>,
+                             Mn::UnsignedInt>>
+      meshPositionsIndices;
+
   /* Import all meshes */
   for (Mn::UnsignedInt i = 0, iMax = importer->meshCount(); i != iMax; ++i) {
     Cr::Containers::Optional<Mn::Trade::MeshData> mesh = importer->mesh(i);
@@ -552,6 +1195,12 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     if (mesh->hasAttribute(Mn::Trade::MeshAttribute::Color))
       flags |= Mn::Shaders::PhongGL::Flag::VertexColor;
 
+    if (calculateBounds)
+      arrayAppend(meshPositionsIndices, Cr::InPlaceInit,
+                  mesh->positions3DAsArray(), mesh->indicesAsArray(),
+                  Mn::UnsignedInt(Mn::meshIndexTypeSize(mesh->indexType())));
+
+    state_->meshMemory += mesh->vertexData().size() + mesh->indexData().size();
     arrayAppend(state_->meshes, Cr::InPlaceInit, flags,
                 Mn::MeshTools::compile(*mesh));
   }
@@ -628,7 +1277,7 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
   /* Fill initial projection data for each view. Will be uploaded afresh every
      draw. */
   state_->cameraMatrices = Cr::Containers::Array<ProjectionPadded>{
-      Cr::DefaultInit, std::size_t(state_->tileCount.product())};
+      Cr::DefaultInit, state_->scenes.size()};
   // TODO (mutable) buffer storage
 
   /* Scene-less files are assumed to contain a single material-less mesh (such
@@ -825,6 +1474,22 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     }
   }
 
+  /* Calculate bounds of all added mesh views, or make them infinite so they
+     never get culled */
+  for (std::size_t i = meshViewOffset; i != state_->meshViews.size(); ++i) {
+    MeshView& view = state_->meshViews[i];
+    if (!calculateBounds) {
+      view.bounds = {{}, Mn::Constants::inf()};
+      continue;
+    }
+
+    const auto& mesh = meshPositionsIndices[view.meshId - meshOffset];
+    view.bounds = boundingSphere(
+        mesh.first(), mesh.second().sliceSize(
+                          view.indexOffsetInBytes / mesh.third(),
+                          view.indexCount));
+  }
+
   /* Setup a zero-light (flat) shader in desired combinations. For simplicity
      and stutter-free experience instantiate all possibly needed combinations
      upfront instead of lazy-compiling them once needed. */
@@ -832,13 +1497,21 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
   //  do lazily on first draw() and then FORBID adding more files?
   // TODO also might make sense to use async compilation when the combination
   //  count grows further
+  /* With RendererFlag::DepthOnly both combinations are the same shader with
+     no textures, lights or vertex colors, fetching just positions. The map
+     is still indexed with the per-mesh flags so drawBatchId() doesn't need
+     to care. */
+  const bool depthOnly = state_->flags & RendererFlag::DepthOnly;
   for (Mn::Shaders::PhongGL::Flags extraFlags :
        {{}, Mn::Shaders::PhongGL::Flag::VertexColor}) {
     Mn::Shaders::PhongGL::Flags shaderFlags =
-        extraFlags | Mn::Shaders::PhongGL::Flag::MultiDraw |
+        (depthOnly ? Mn::Shaders::PhongGL::Flags{} : extraFlags) |
+        Mn::Shaders::PhongGL::Flag::MultiDraw |
         Mn::Shaders::PhongGL::Flag::UniformBuffers |
         Mn::Shaders::PhongGL::Flag::NoSpecular |
         Mn::Shaders::PhongGL::Flag::LightCulling;
+    if (state_->flags & RendererFlag::ObjectId)
+      shaderFlags |= Mn::Shaders::PhongGL::Flag::ObjectId;
     if (!(state_->flags >= RendererFlag::NoTextures)) {
       shaderFlags |= Mn::Shaders::PhongGL::Flag::AmbientTexture |
                      Mn::Shaders::PhongGL::Flag::TextureArrays |
@@ -855,7 +1528,7 @@ bool Renderer::addFile(const Cr::Containers::StringView filename,
     state_->shaders[Mn::UnsignedInt(extraFlags)] = Mn::Shaders::PhongGL{
         Mn::Shaders::PhongGL::Configuration{}
             .setFlags(shaderFlags)
-            .setLightCount(state_->maxLightCount)
+            .setLightCount(depthOnly ? 0 : state_->maxLightCount)
             .setMaterialCount(Mn::UnsignedInt(state_->materials.size()))
             .setDrawCount(1024)};
   }
@@ -894,8 +1567,9 @@ std::size_t Renderer::addNodeHierarchy(const Mn::UnsignedInt sceneId,
   CORRADE_ASSERT(found != state_->meshViewRangeForName.end(),
                  "Renderer::add(): name" << name << "not found", {});
 
-  /* The parent and transformation arrays should have the same size */
+  /* The per-node arrays should have the same size */
   CORRADE_INTERNAL_ASSERT(scene.transformations.size() == scene.parents.size());
+  CORRADE_INTERNAL_ASSERT(scene.nodeDrawIds.size() == scene.parents.size());
 
   /* The per-draw arrays should have the same size */
   CORRADE_INTERNAL_ASSERT(scene.transformationIds.size() ==
@@ -905,17 +1579,26 @@ std::size_t Renderer::addNodeHierarchy(const Mn::UnsignedInt sceneId,
                           scene.drawBatchIds.size());
   CORRADE_INTERNAL_ASSERT(scene.drawCommands.size() ==
                           scene.drawBatchIds.size());
+  CORRADE_INTERNAL_ASSERT(scene.drawBounds.size() == scene.drawBatchIds.size());
   CORRADE_INTERNAL_ASSERT(scene.drawsSorted.size() ==
                           scene.drawBatchIds.size());
   CORRADE_INTERNAL_ASSERT(scene.transformationIdsSorted.size() ==
                           scene.drawBatchIds.size());
+  CORRADE_INTERNAL_ASSERT(scene.textureTransformationsSorted.size() ==
+                          scene.drawBatchIds.size());
+  CORRADE_INTERNAL_ASSERT(scene.drawBoundsSorted.size() ==
+                          scene.drawBatchIds.size());
   CORRADE_INTERNAL_ASSERT(scene.drawCommandsSorted.size() ==
                           scene.drawBatchIds.size());
 
-  /* Add a top-level object with no attached mesh */
-  const std::size_t topLevelId = scene.transformations.size();
-  arrayAppend(scene.parents, -1);
-  arrayAppend(scene.transformations, Cr::InPlaceInit);
+  /* Add a top-level object with no attached mesh, followed by the whole
+     hierarchy, reusing a previously removed range of the same size if there's
+     any */
+  const std::size_t topLevelId = allocateNodes(
+      scene, found->second.second() - found->second.first() + 1);
+  scene.parents[topLevelId] = -1;
+  scene.transformations[topLevelId] = Mn::Matrix4{};
+  scene.nodeDrawIds[topLevelId] = -1;
 
   /* Add the whole hierarchy under this name, with a mesh for each */
   // TODO the hierarchy can eventually also have meshless "grouping nodes" or
@@ -925,10 +1608,10 @@ std::size_t Renderer::addNodeHierarchy(const Mn::UnsignedInt sceneId,
     const MeshView& meshView = state_->meshViews[i];
     /* The following meshes are children of the first one, inheriting its
        transformation */
-    const std::size_t id = scene.transformations.size();
-    arrayAppend(scene.parents, topLevelId);
-    arrayAppend(scene.transformations,
-                bakeTransformation * meshView.transformation);
+    const std::size_t id = topLevelId + 1 + i - found->second.first();
+    scene.parents[id] = topLevelId;
+    scene.transformations[id] = bakeTransformation * meshView.transformation;
+    scene.nodeDrawIds[id] = Mn::Int(scene.drawBatchIds.size());
 
     /* Get a batch ID for given shader/mesh/texture combination */
     const Mn::UnsignedInt batchId = drawBatchId(
@@ -948,10 +1631,13 @@ std::size_t Renderer::addNodeHierarchy(const Mn::UnsignedInt sceneId,
             state_->materialTextureTransformations[meshView.materialId].layer);
     arrayAppend(scene.drawCommands, Cr::InPlaceInit,
                 meshView.indexOffsetInBytes, meshView.indexCount);
+    arrayAppend(scene.drawBounds, meshView.bounds);
     /* Just to have them with the right size, they get filled in a next dirty
        state update in draw() */
     arrayAppend(scene.drawsSorted, Cr::NoInit, 1);
     arrayAppend(scene.transformationIdsSorted, Cr::NoInit, 1);
+    arrayAppend(scene.textureTransformationsSorted, Cr::NoInit, 1);
+    arrayAppend(scene.drawBoundsSorted, Cr::NoInit, 1);
     arrayAppend(scene.drawCommandsSorted, Cr::NoInit, 1);
   }
 
@@ -974,13 +1660,15 @@ std::size_t Renderer::addEmptyNode(const Mn::UnsignedInt sceneId) {
 
   Scene& scene = state_->scenes[sceneId];
 
-  /* The parent and transformation arrays should have the same size */
+  /* The per-node arrays should have the same size */
   CORRADE_INTERNAL_ASSERT(scene.transformations.size() == scene.parents.size());
+  CORRADE_INTERNAL_ASSERT(scene.nodeDrawIds.size() == scene.parents.size());
 
   /* Add a top-level object with no attached mesh */
-  const std::size_t id = scene.transformations.size();
-  arrayAppend(scene.parents, -1);
-  arrayAppend(scene.transformations, Cr::InPlaceInit);
+  const std::size_t id = allocateNodes(scene, 1);
+  scene.parents[id] = -1;
+  scene.transformations[id] = Mn::Matrix4{};
+  scene.nodeDrawIds[id] = -1;
 
   /* Not marking the dirty bit as nothing changed rendering-wise, and the
      transformations are processed every frame anyway */
@@ -1014,6 +1702,108 @@ std::size_t Renderer::addLight(const Mn::UnsignedInt sceneId,
   return id;
 }
 
+void Renderer::removeNodeHierarchy(const Mn::UnsignedInt sceneId,
+                                   const std::size_t nodeId) {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::removeNodeHierarchy(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes", );
+
+  Scene& scene = state_->scenes[sceneId];
+  CORRADE_ASSERT(nodeId < scene.parents.size(),
+                 "Renderer::removeNodeHierarchy(): index"
+                     << nodeId << "out of range for" << scene.parents.size()
+                     << "nodes in scene" << sceneId, );
+  CORRADE_ASSERT(scene.parents[nodeId] == -1 && scene.nodeDrawIds[nodeId] == -1,
+                 "Renderer::removeNodeHierarchy(): node"
+                     << nodeId << "in scene" << sceneId
+                     << "isn't a top-level node or was already removed", );
+
+  /* Children of a hierarchy are right after its top-level node */
+  std::size_t end = nodeId + 1;
+  while (end != scene.parents.size() &&
+         scene.parents[end] == Mn::Int(nodeId))
+    ++end;
+
+  for (std::size_t i = nodeId; i != end; ++i) {
+    /* Move the last draw in place of the removed one so the draw arrays stay
+       compact, and update the node referencing it */
+    if (scene.nodeDrawIds[i] >= 0) {
+      const std::size_t drawId = scene.nodeDrawIds[i];
+      const std::size_t lastDrawId = scene.drawBatchIds.size() - 1;
+      if (drawId != lastDrawId) {
+        scene.drawBatchIds[drawId] = scene.drawBatchIds[lastDrawId];
+        scene.transformationIds[drawId] = scene.transformationIds[lastDrawId];
+        scene.draws[drawId] = scene.draws[lastDrawId];
+        scene.textureTransformations[drawId] =
+            scene.textureTransformations[lastDrawId];
+        scene.drawCommands[drawId] = scene.drawCommands[lastDrawId];
+        scene.drawBounds[drawId] = scene.drawBounds[lastDrawId];
+        scene.nodeDrawIds[scene.transformationIds[drawId]] = Mn::Int(drawId);
+      }
+      arrayRemoveSuffix(scene.drawBatchIds);
+      arrayRemoveSuffix(scene.transformationIds);
+      arrayRemoveSuffix(scene.draws);
+      arrayRemoveSuffix(scene.textureTransformations);
+      arrayRemoveSuffix(scene.drawCommands);
+      arrayRemoveSuffix(scene.drawBounds);
+      /* These get filled in a next dirty state update in draw() */
+      arrayRemoveSuffix(scene.drawsSorted);
+      arrayRemoveSuffix(scene.transformationIdsSorted);
+      arrayRemoveSuffix(scene.textureTransformationsSorted);
+      arrayRemoveSuffix(scene.drawBoundsSorted);
+      arrayRemoveSuffix(scene.drawCommandsSorted);
+    }
+
+    /* Zero scale in case a light still references the node */
+    scene.parents[i] = -1;
+    scene.transformations[i] = Mn::Matrix4{Mn::Math::ZeroInit};
+    scene.nodeDrawIds[i] = -2;
+  }
+
+  arrayAppend(scene.freeNodeRanges[end - nodeId], nodeId);
+
+  /* Schedule an update next time draw() is called */
+  scene.dirty = true;
+}
+
+void Renderer::setObjectId(const Mn::UnsignedInt sceneId,
+                           const std::size_t nodeId,
+                           const Mn::UnsignedInt objectId) {
+  CORRADE_ASSERT(state_->flags & RendererFlag::ObjectId,
+                 "Renderer::setObjectId(): object ID output not enabled", );
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::setObjectId(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes", );
+
+  Scene& scene = state_->scenes[sceneId];
+  CORRADE_ASSERT(nodeId < scene.parents.size(),
+                 "Renderer::setObjectId(): index"
+                     << nodeId << "out of range for" << scene.parents.size()
+                     << "nodes in scene" << sceneId, );
+  CORRADE_ASSERT(scene.parents[nodeId] == -1 && scene.nodeDrawIds[nodeId] == -1,
+                 "Renderer::setObjectId(): node"
+                     << nodeId << "in scene" << sceneId
+                     << "isn't a top-level node or was already removed", );
+
+  /* Children of a hierarchy are right after its top-level node, same as in
+     removeNodeHierarchy(). Mark the scene dirty only if an ID actually
+     changed, as this gets called with the same IDs every frame by replay
+     players and the dirty update re-sorts all draws. */
+  for (std::size_t i = nodeId + 1; i != scene.parents.size() &&
+                                   scene.parents[i] == Mn::Int(nodeId);
+       ++i) {
+    if (scene.nodeDrawIds[i] < 0)
+      continue;
+    Mn::Shaders::PhongDrawUniform& draw = scene.draws[scene.nodeDrawIds[i]];
+    if (draw.objectId == objectId)
+      continue;
+    draw.setObjectId(objectId);
+    scene.dirty = true;
+  }
+}
+
 void Renderer::clear(const Mn::UnsignedInt sceneId) {
   CORRADE_ASSERT(sceneId < state_->scenes.size(),
                  "Renderer::clear(): index" << sceneId << "out of range for"
@@ -1025,6 +1815,8 @@ void Renderer::clear(const Mn::UnsignedInt sceneId) {
   /* Resizing instead of `= {}` to not discard the memory */
   arrayResize(scene.parents, 0);
   arrayResize(scene.transformations, 0);
+  arrayResize(scene.nodeDrawIds, 0);
+  scene.freeNodeRanges.clear();
   arrayResize(scene.lights, 0);
   arrayResize(scene.drawBatchIds, 0);
   arrayResize(scene.transformationIds, 0);
@@ -1032,9 +1824,15 @@ void Renderer::clear(const Mn::UnsignedInt sceneId) {
   arrayResize(scene.draws, 0);
   arrayResize(scene.textureTransformations, 0);
   arrayResize(scene.drawCommands, 0);
+  arrayResize(scene.drawBounds, 0);
   arrayResize(scene.drawsSorted, 0);
   arrayResize(scene.transformationIdsSorted, 0);
+  arrayResize(scene.textureTransformationsSorted, 0);
+  arrayResize(scene.drawBoundsSorted, 0);
   arrayResize(scene.drawCommandsSorted, 0);
+  arrayResize(scene.drawBatchOffsetsVisible, 0);
+  arrayResize(scene.drawCommandsVisible, 0);
+  scene.culledDrawCount = 0;
 
   /* There's nothing in the scene, so there's no dirty state to process */
   scene.dirty = false;
@@ -1076,6 +1874,16 @@ Magnum::Vector2 Renderer::cameraDepthUnprojection(
   return state_->scenes[sceneId].cameraUnprojection;
 }
 
+Magnum::Matrix4 Renderer::cameraProjection(Magnum::UnsignedInt sceneId) const {
+  CORRADE_ASSERT(sceneId < state_->scenes.size(),
+                 "Renderer::cameraProjection(): index"
+                     << sceneId << "out of range for" << state_->scenes.size()
+                     << "scenes",
+                 {});
+
+  return state_->scenes[sceneId].cameraProjection;
+}
+
 void Renderer::updateCamera(Magnum::UnsignedInt sceneId,
                             const Magnum::Matrix4& projection,
                             const Magnum::Matrix4& view) {
@@ -1087,6 +1895,7 @@ void Renderer::updateCamera(Magnum::UnsignedInt sceneId,
   state_->cameraMatrices[sceneId].projectionMatrix = projection * view;
   state_->scenes[sceneId].cameraUnprojection =
       calculateDepthUnprojection(projection);
+  state_->scenes[sceneId].cameraProjection = projection;
 }
 
 Cr::Containers::StridedArrayView1D<Mn::Matrix4> Renderer::transformations(
@@ -1134,22 +1943,11 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
   // TODO this could be a separate step to allow the user to control when it
   //  runs
   {
-    // TODO have a dedicated bump allocator for this to avoid allocating on
-    //  every dirty processing
-    Cr::Containers::Array<Mn::Shaders::TextureTransformationUniform>
-        textureTransformationsSorted;
     for (std::size_t sceneId = 0; sceneId != state_->scenes.size(); ++sceneId) {
       Scene& scene = state_->scenes[sceneId];
       if (!scene.dirty)
         continue;
 
-      /* Resize temp arrays if too small */
-      // TODO make this unconditional to catch OOB access?
-      if (textureTransformationsSorted.size() < scene.draws.size()) {
-        arrayResize(textureTransformationsSorted, Cr::NoInit,
-                    scene.draws.size());
-      }
-
       /* Draw batch offsets with two implicit 0s at the begin. Reset all values
          to 0 in case the array wasn't empty before. */
       // TODO Utility::fill() instead
@@ -1183,7 +1981,9 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
             scene.drawBatchOffsets[scene.drawBatchIds[i] + 1];
 
         scene.drawsSorted[offset] = scene.draws[i];
-        textureTransformationsSorted[offset] = scene.textureTransformations[i];
+        scene.textureTransformationsSorted[offset] =
+            scene.textureTransformations[i];
+        scene.drawBoundsSorted[offset] = scene.drawBounds[i];
         scene.transformationIdsSorted[offset] = scene.transformationIds[i];
         scene.drawCommandsSorted[offset] = scene.drawCommands[i];
         ++offset;
@@ -1192,103 +1992,128 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
       CORRADE_INTERNAL_ASSERT(scene.drawBatchOffsets.back() ==
                               scene.draws.size());
 
-      /* Upload the (temporary) sorted data to uniforms */
-      scene.textureTransformationUniform.setData(textureTransformationsSorted);
+      /* Upload the sorted data to uniforms. With frustum culling only the
+         visible subset gets uploaded, every frame. */
+      if (!(state_->flags & RendererFlag::FrustumCulling))
+        scene.textureTransformationUniform.setData(
+            scene.textureTransformationsSorted);
       scene.dirty = false;
     }
   }
 
+  /* Stream textures in and out based on which are referenced by draws in any
+     scene, staying under the memory budget */
+  // TODO this could be a separate step to allow the user to control when it
+  //  runs, and the uploads could be spread over a fixed byte count per frame
+  if (!state_->streamedTextures.isEmpty()) {
+    ++state_->frame;
+
+    arrayResize(state_->textureReferenced, Cr::NoInit, 0);
+    arrayResize(state_->textureReferenced, Cr::ValueInit,
+                state_->textures.size());
+    for (const Scene& scene : state_->scenes) {
+      for (std::size_t i = 0; i != scene.drawBatches.size(); ++i) {
+        /* Batches stay around after all their draws get removed */
+        if (scene.drawBatchOffsets[i] != scene.drawBatchOffsets[i + 1])
+          state_->textureReferenced[scene.drawBatches[i].textureId] = true;
+      }
+    }
+
+    /* Referenced textures want all levels, the others just the initial
+       ones */
+    std::size_t usage = state_->staticTextureMemory;
+    for (StreamedTexture& texture : state_->streamedTextures) {
+      if (state_->textureReferenced[texture.textureId]) {
+        texture.lastReferencedFrame = state_->frame;
+        texture.targetLevel = 0;
+      } else
+        texture.targetLevel = texture.initialLevel;
+      usage += streamedTextureSize(texture, texture.targetLevel);
+    }
+
+    /* If that doesn't fit, drop the largest levels of the least recently
+       referenced textures first */
+    if (usage > state_->textureMemoryBudget) {
+      arrayResize(state_->streamedTextureOrder, Cr::NoInit,
+                  state_->streamedTextures.size());
+      for (std::size_t i = 0; i != state_->streamedTextureOrder.size(); ++i)
+        state_->streamedTextureOrder[i] = i;
+      std::stable_sort(state_->streamedTextureOrder.begin(),
+                       state_->streamedTextureOrder.end(),
+                       [&](Mn::UnsignedInt a, Mn::UnsignedInt b) {
+                         return state_->streamedTextures[a]
+                                    .lastReferencedFrame <
+                                state_->streamedTextures[b].lastReferencedFrame;
+                       });
+      for (const Mn::UnsignedInt i : state_->streamedTextureOrder) {
+        StreamedTexture& texture = state_->streamedTextures[i];
+        while (usage > state_->textureMemoryBudget &&
+               texture.targetLevel < texture.initialLevel) {
+          usage -= texture.levels[texture.targetLevel].data().size();
+          ++texture.targetLevel;
+        }
+        if (usage <= state_->textureMemoryBudget)
+          break;
+      }
+    }
+
+    /* Evict right away, stream in one level at a time so the uploads are
+       spread over multiple frames */
+    for (StreamedTexture& texture : state_->streamedTextures) {
+      if (texture.targetLevel == texture.residentLevel)
+        continue;
+      texture.residentLevel = texture.targetLevel > texture.residentLevel
+                                  ? texture.targetLevel
+                                  : texture.residentLevel - 1;
+      state_->textures[texture.textureId] =
+          uploadStreamedTexture(texture, texture.residentLevel);
+    }
+  }
+
   /* Upload projection uniform, assuming it changes every frame. Do it early to
      minimize stalls. */
   state_->projectionUniform.setData(state_->cameraMatrices);
 
-  /* Calculate absolute transformations */
-  for (std::size_t sceneId = 0; sceneId != state_->scenes.size(); ++sceneId) {
-    Scene& scene = state_->scenes[sceneId];
+  /* Calculate absolute transformations, cull and assign lights, spreading
+     the scenes over the draw threads. Only the GL calls below have to
+     happen on this thread. */
+  {
+    const std::size_t sceneCount = state_->scenes.size();
+    const std::size_t threadCount =
+        Mn::Math::min(state_->drawScratches.size(), sceneCount);
+    std::atomic<std::size_t> nextScene{0};
+    const auto prepareScenes = [&](DrawScratch& scratch) {
+      for (std::size_t sceneId; (sceneId = nextScene++) < sceneCount;)
+        prepareSceneDraws(state_->scenes[sceneId],
+                          state_->cameraMatrices[sceneId].projectionMatrix,
+                          state_->flags, state_->maxLightCount, scratch);
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threadCount; ++i)
+      workers.emplace_back(prepareScenes, std::ref(state_->drawScratches[i]));
+    prepareScenes(state_->drawScratches[0]);
+    for (std::thread& worker : workers)
+      worker.join();
+  }
 
-    /* The first slot holds the root transformation for easier dealing with
-       `parent == -1`. Resize if it's too small. */
-    if (state_->absoluteTransformations.size() <
-        scene.transformations.size() + 1)
-      arrayResize(state_->absoluteTransformations, Cr::NoInit,
-                  scene.transformations.size() + 1);
-
-    // TODO have a tool for this! AVX512!!
-    state_->absoluteTransformations[0].setTransformationMatrix(Mn::Matrix4{});
-    for (std::size_t i = 0; i != scene.transformations.size(); ++i)
-      state_->absoluteTransformations[i + 1].setTransformationMatrix(
-          state_->absoluteTransformations[scene.parents[i] + 1]
-              .transformationMatrix *
-          scene.transformations[i]);
-
-    /* Copy transformations referenced by actual draws. Resize if destination
-       is too small. */
-    if (state_->absoluteTransformationsSorted.size() <
-        scene.transformationIdsSorted.size())
-      arrayResize(state_->absoluteTransformationsSorted, Cr::NoInit,
-                  scene.transformationIdsSorted.size());
-    // TODO the casting situation is GETTING OUT OF HAND
-    Mn::MeshTools::duplicateInto(
-        Cr::Containers::StridedArrayView1D<const Mn::UnsignedInt>{
-            scene.transformationIdsSorted},
-        Cr::Containers::StridedArrayView1D<
-            const Mn::Shaders::TransformationUniform3D>{
-            state_->absoluteTransformations.exceptPrefix(1)},
-        stridedArrayView(state_->absoluteTransformationsSorted.prefix(
-            scene.transformationIdsSorted.size())));
-
-    /* Upload the transformation uniforms, as they get overwritten in the
-       next loop. OTOH, interleaving it with the calculation could hide the
-       driver stalls. */
-    // TODO have this somehow in a single huge buffer instead so we can upload
-    // everything at once? ... but that would need the insane alignment
-    // requirements, not great either :(
+  /* Upload the prepared per-frame data */
+  // TODO have this somehow in a single huge buffer instead so we can upload
+  // everything at once? ... but that would need the insane alignment
+  // requirements, not great either :(
+  for (Scene& scene : state_->scenes) {
+    const bool culled = state_->flags & RendererFlag::FrustumCulling;
+    if (culled && !(state_->flags & RendererFlag::NoTextures))
+      scene.textureTransformationUniform.setData(
+          scene.textureTransformationsVisible.prefix(scene.visibleDrawCount));
     scene.transformationUniform.setData(
-        state_->absoluteTransformationsSorted.prefix(
-            scene.transformationIdsSorted.size()));
-
-    /* Finish transformation-dependent per-draw info, upload it */
-    for (std::size_t i = 0; i != scene.transformationIds.size(); ++i) {
-      scene
-          .drawsSorted[i]
-          /* Extract normal matrix */
-          .setNormalMatrix(state_->absoluteTransformationsSorted[i]
-                               .transformationMatrix.normalMatrix())
-          // TODO light culling should happen here
-          .setLightOffsetCount(0, scene.lights.size());
-    }
-    // TODO have a single buffer for this
-    scene.drawUniform.setData(scene.drawsSorted);
-
-    /* Copy light properties and cherry-pick transformations for them. Resize
-       the temp destination if it's too small. */
-    if (state_->absoluteLights.size() < scene.lights.size())
-      arrayResize(state_->absoluteLights, Cr::NoInit, scene.lights.size());
-    for (std::size_t i = 0; i != scene.lights.size(); ++i) {
-      const Light& light = scene.lights[i];
-      state_->absoluteLights[i]
-          .setColor(light.color)
-          .setSpecularColor(light.color)
-          .setRange(light.range);
-      if (light.type == RendererLightType::Directional)
-        state_->absoluteLights[i].setPosition(
-            Mn::Vector4{-state_->absoluteTransformations[light.node + 1]
-                             .transformationMatrix.backward(),
-                        0.0f});
-      else if (light.type == RendererLightType::Point)
-        state_->absoluteLights[i].setPosition(
-            Mn::Vector4{state_->absoluteTransformations[light.node + 1]
-                            .transformationMatrix.translation(),
-                        1.0f});
-      else
-        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-    }
-
-    /* Upload the light uniforms, as they get overwritten in the next loop. */
-    // TODO again, have a single buffer for this
-    if (!scene.lights.isEmpty())
-      scene.lightUniform.setData(
-          state_->absoluteLights.prefix(scene.lights.size()));
+        scene.absoluteTransformationsSorted.prefix(scene.visibleDrawCount));
+    if (culled)
+      scene.drawUniform.setData(
+          scene.drawsVisible.prefix(scene.visibleDrawCount));
+    else
+      scene.drawUniform.setData(scene.drawsSorted);
+    if (scene.lightCount)
+      scene.lightUniform.setData(scene.absoluteLights.prefix(scene.lightCount));
   }
 
   /* Remember the original viewport to set it back to where it was after.
@@ -1297,58 +2122,61 @@ void Renderer::draw(Mn::GL::AbstractFramebuffer& framebuffer) {
      wants to draw HUD etc. on top. */
   const Mn::Range2Di previousViewport = framebuffer.viewport();
 
-  for (Mn::Int y = 0; y != state_->tileCount.y(); ++y) {
-    for (Mn::Int x = 0; x != state_->tileCount.x(); ++x) {
-      framebuffer.setViewport(Mn::Range2Di::fromSize(
-          Mn::Vector2i{x, y} * state_->tileSize, state_->tileSize));
+  for (std::size_t sceneId = 0; sceneId != state_->scenes.size(); ++sceneId) {
+    framebuffer.setViewport(state_->sceneRectangles[sceneId]);
 
-      const std::size_t sceneId = y * state_->tileCount.x() + x;
-      Scene& scene = state_->scenes[sceneId];
+    Scene& scene = state_->scenes[sceneId];
 
-      /* Bind buffers. Again, all shaders share the same binding points so it
-         doesn't matter which one is used. */
-      // TODO split by draw count limit? hard to do with those batches now, heh
-      //  also hard to do due to the insane alignment rules
-      state_->shaders.begin()
-          ->second
-          // TODO bind all buffers together with a multi API
-          .bindProjectionBuffer(state_->projectionUniform,
-                                sceneId * sizeof(ProjectionPadded),
-                                sizeof(ProjectionPadded))
-          .bindTransformationBuffer(scene.transformationUniform)
-          .bindLightBuffer(scene.lightUniform)
-          .bindDrawBuffer(scene.drawUniform);
-      if (!(state_->flags & RendererFlag::NoTextures))
-        state_->shaders.begin()->second.bindTextureTransformationBuffer(
-            scene.textureTransformationUniform);
-
-      /* Submit all draw batches */
-      for (std::size_t i = 0; i != scene.drawBatches.size(); ++i) {
-        const DrawBatch& drawBatch = scene.drawBatches[i];
+    /* Bind buffers. Again, all shaders share the same binding points so it
+       doesn't matter which one is used. */
+    // TODO split by draw count limit? hard to do with those batches now, heh
+    //  also hard to do due to the insane alignment rules
+    state_->shaders.begin()
+        ->second
+        // TODO bind all buffers together with a multi API
+        .bindProjectionBuffer(state_->projectionUniform,
+                              sceneId * sizeof(ProjectionPadded),
+                              sizeof(ProjectionPadded))
+        .bindTransformationBuffer(scene.transformationUniform)
+        .bindLightBuffer(scene.lightUniform)
+        .bindDrawBuffer(scene.drawUniform);
+    if (!(state_->flags & RendererFlag::NoTextures))
+      state_->shaders.begin()->second.bindTextureTransformationBuffer(
+          scene.textureTransformationUniform);
+
+    /* Submit all draw batches, or just the visible parts of them */
+    const bool culled = state_->flags & RendererFlag::FrustumCulling;
+    const Cr::Containers::ArrayView<const Mn::UnsignedInt> drawBatchOffsets =
+        culled ? scene.drawBatchOffsetsVisible : scene.drawBatchOffsets;
+    const Cr::Containers::ArrayView<DrawCommand> drawCommands =
+        culled ? scene.drawCommandsVisible : scene.drawCommandsSorted;
+    for (std::size_t i = 0; i != scene.drawBatches.size(); ++i) {
+      const DrawBatch& drawBatch = scene.drawBatches[i];
+      const Mn::UnsignedInt drawBatchOffset = drawBatchOffsets[i];
+      const Mn::UnsignedInt nextDrawBatchOffset = drawBatchOffsets[i + 1];
+
+      /* Batches stay around after all their draws get removed or culled */
+      if (drawBatchOffset == nextDrawBatchOffset)
+        continue;
 
-        if (!(state_->flags >= RendererFlag::NoTextures)) {
-          drawBatch.shader->bindAmbientTexture(
+      if (!(state_->flags >= RendererFlag::NoTextures)) {
+        drawBatch.shader->bindAmbientTexture(
+            state_->textures[drawBatch.textureId]);
+        if (state_->maxLightCount)
+          drawBatch.shader->bindDiffuseTexture(
               state_->textures[drawBatch.textureId]);
-          if (state_->maxLightCount)
-            drawBatch.shader->bindDiffuseTexture(
-                state_->textures[drawBatch.textureId]);
-        }
-
-        const Mn::UnsignedInt drawBatchOffset = scene.drawBatchOffsets[i];
-        const Mn::UnsignedInt nextDrawBatchOffset =
-            scene.drawBatchOffsets[i + 1];
-        const Cr::Containers::StridedArrayView1D<DrawCommand>
-            drawBatchCommands =
-                // TODO if unsorted scene.drawCommands is here, the unit test
-                //  still passes -- fix!
-            scene.drawCommandsSorted.slice(drawBatchOffset,
-                                           nextDrawBatchOffset);
-
-        drawBatch.shader->setDrawOffset(drawBatchOffset)
-            .draw(state_->meshes[drawBatch.meshId].second(),
-                  drawBatchCommands.slice(&DrawCommand::indexCount), nullptr,
-                  drawBatchCommands.slice(&DrawCommand::indexOffsetInBytes));
       }
+
+      const Cr::Containers::StridedArrayView1D<DrawCommand>
+          drawBatchCommands =
+              // TODO if unsorted scene.drawCommands is here, the unit test
+              //  still passes -- fix!
+          drawCommands.slice(drawBatchOffset, nextDrawBatchOffset);
+
+      drawBatch.shader->setDrawOffset(drawBatchOffset)
+          .draw(state_->meshes[drawBatch.meshId].second(),
+                drawBatchCommands.slice(&DrawCommand::indexCount), nullptr,
+                drawBatchCommands.slice(&DrawCommand::indexOffsetInBytes));
     }
   }
 
@@ -1373,6 +2201,8 @@ SceneStats Renderer::sceneStats(Mn::UnsignedInt sceneId) const {
      again would be up-to-date only after draw() -- people should just learn to
      only fetch stats after a draw, and not before. */
   out.drawBatchCount = scene.drawBatches.size();
+  out.culledDrawCount = scene.culledDrawCount;
+  out.rectangle = state_->sceneRectangles[sceneId];
   return out;
 }
 
@@ -5,9 +5,11 @@
 #ifndef ESP_GFX_BATCH_RENDERER_H_
 #define ESP_GFX_BATCH_RENDERER_H_
 
+#include <Corrade/Containers/Containers.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/GL.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
 #include <cstddef>
 
 namespace esp {
@@ -25,9 +27,54 @@ enum class RendererFlag {
    * Causes textures to not even get loaded, potentially saving significant
    * amount of memory. Only material and vertex colors are used for rendering.
    */
-  NoTextures = 1 << 0
+  NoTextures = 1 << 0,
 
-  // TODO memory-map
+  /**
+   * Memory-map files passed to @ref Renderer::addFile() and the buffers and
+   * images they reference instead of reading them into memory.
+   *
+   * Mesh and texture data are then uploaded straight from the page cache,
+   * which is shared by all processes loading the same file, instead of
+   * every process holding its own copy during the import. Not supported on
+   * platforms without memory mapping, where files are read as usual.
+   */
+  MemoryMapFiles = 1 << 1,
+
+  /**
+   * Cull draws outside of the camera frustum.
+   *
+   * Bounding spheres of all meshes get calculated in @ref Renderer::addFile(),
+   * and every @ref Renderer::draw() then tests them against the camera of
+   * each scene, submitting and uploading per-draw data only for the visible
+   * ones. Worth enabling for large scenes where most of the geometry is
+   * outside of the view. The count of culled draws is reported in
+   * @ref SceneStats::culledDrawCount.
+   */
+  FrustumCulling = 1 << 2,
+
+  /**
+   * Render just depth.
+   *
+   * Draws use a shader without textures, lights and vertex colors, so only
+   * vertex positions are fetched and the fragment shading is trivial.
+   * Implies @ref RendererFlag::NoTextures, which @ref Renderer::flags() then
+   * reports as well.
+   * @ref RendererStandalone then has no color attachment at all, draws
+   * into a framebuffer passed to @ref Renderer::draw() have their color
+   * output unspecified.
+   */
+  DepthOnly = 1 << 3,
+
+  /**
+   * Output an object ID for each pixel.
+   *
+   * The IDs are set per node hierarchy with @ref Renderer::setObjectId(),
+   * pixels not covered by any draw are @cpp 0 @ce. The shader writes them
+   * into a second fragment output, which @ref RendererStandalone stores
+   * into an integer attachment. Can be combined with
+   * @ref RendererFlag::DepthOnly to get just depth and object IDs.
+   */
+  ObjectId = 1 << 4
 };
 
 /**
@@ -60,6 +107,13 @@ struct RendererConfiguration {
    */
   RendererConfiguration& setFlags(RendererFlags flags);
 
+  /**
+   * @brief Add renderer flags
+   *
+   * Calls @ref setFlags() with the existing flags ORed with @p flags.
+   */
+  RendererConfiguration& addFlags(RendererFlags flags);
+
   /**
    * @brief Set tile size and count
    *
@@ -76,17 +130,48 @@ struct RendererConfiguration {
    * tiles, they only occupy space in the output framebuffer. For example, if
    * you want 13 scenes, set @p tileCount to @cpp {4, 4} @ce and ignore the
    * last 3.
+   *
+   * Overrides sizes set via a previous @ref setTileSizes() call.
    * @see @ref Renderer::tileSize(), @ref Renderer::tileCount()
    */
   RendererConfiguration& setTileSizeCount(const Magnum::Vector2i& tileSize,
                                           const Magnum::Vector2i& tileCount);
 
+  /**
+   * @brief Set a different tile size for each scene
+   * @param sizes             Tile size for each scene
+   * @param framebufferWidth  Width of the framebuffer the tiles get packed
+   *    into
+   *
+   * Alternative to @ref setTileSizeCount() for rendering scenes of different
+   * resolutions in a single renderer, for example low-resolution training
+   * environments alongside high-resolution evaluation ones. Scene count is
+   * the size of @p sizes. Tiles are packed into rows in the order given, a new
+   * row is started once the next tile wouldn't fit into @p framebufferWidth,
+   * and each row is as tall as its tallest tile. To waste the least space,
+   * group tiles of the same height together. The resulting framebuffer size
+   * is available through @ref Renderer::framebufferSize(), placement of
+   * particular scenes through @ref Renderer::sceneRectangle().
+   *
+   * Expects that all sizes are positive and not wider than
+   * @p framebufferWidth. Overrides values set via a previous
+   * @ref setTileSizeCount() call.
+   */
+  RendererConfiguration& setTileSizes(
+      Corrade::Containers::ArrayView<const Magnum::Vector2i> sizes,
+      Magnum::Int framebufferWidth);
+
   /**
    * @brief Set max light count per draw
    *
-   * By default no lights are used, i.e. flat-shaded rendering. At the moment
-   * there's no light culling in place, which means that light count per draw
-   * is equivalent to the total light count used per scene.
+   * By default no lights are used, i.e. flat-shaded rendering. The count is
+   * also the capacity of the light uniform buffer, and the scene lights have
+   * to fit into it. If any point light has a finite range set via
+   * @ref Renderer::lightRanges(), each draw is shaded only with the lights
+   * reaching its bounding sphere. Light lists that aren't a contiguous range
+   * of the scene lights are stored after them, and draws whose list doesn't
+   * fit into the remaining capacity are shaded with all lights, so a count
+   * larger than the scene light count makes culling more effective.
    * @see @ref Renderer::maxLightCount()
    */
   RendererConfiguration& setMaxLightCount(Magnum::UnsignedInt count);
@@ -106,6 +191,41 @@ struct RendererConfiguration {
    */
   RendererConfiguration& setAmbientFactor(Magnum::Float factor);
 
+  /**
+   * @brief Set GPU texture memory budget
+   *
+   * By default it's @cpp 0 @ce, meaning unlimited, and all textures are
+   * uploaded in full in @ref Renderer::addFile(). If non-zero, textures that
+   * come with a pre-made mip chain are streamed instead --- only the levels of
+   * at most 64x64 pixels get uploaded in @ref Renderer::addFile() and higher
+   * levels are then streamed in by @ref Renderer::draw(), one level per
+   * texture per frame, for textures referenced by any draw in any scene. If
+   * the full levels wouldn't fit into @p bytes, textures referenced least
+   * recently get evicted back to the initial levels first. Textures without a
+   * pre-made mip chain are always resident in full and count towards the
+   * budget as well.
+   *
+   * Streaming keeps a CPU copy of all mip levels. Has no effect with
+   * @ref RendererFlag::NoTextures.
+   * @see @ref Renderer::textureMemoryBudget(),
+   *    @ref Renderer::textureMemoryUsage()
+   */
+  RendererConfiguration& setTextureMemoryBudget(std::size_t bytes);
+
+  /**
+   * @brief Set count of threads preparing scenes for drawing
+   *
+   * By default it's @cpp 1 @ce, meaning @ref Renderer::draw() does all work
+   * on the calling thread. With more, the per-scene work done before
+   * submitting draws --- calculating absolute transformations, frustum
+   * culling with @ref RendererFlag::FrustumCulling and assigning lights to
+   * draws --- is spread over that many threads, scene by scene, while all
+   * uploads and draw submission stay on the thread owning the GL context. If
+   * @cpp 0 @ce, one thread per hardware core is used.
+   * @see @ref Renderer::drawThreadCount()
+   */
+  RendererConfiguration& setDrawThreadCount(Magnum::UnsignedInt count);
+
  private:
   friend Renderer;
   struct State;
@@ -196,7 +316,11 @@ and framebuffer, the high-level usage is same for both.
 The renderer gets constructed using a @ref RendererConfiguration with desired
 tile size and count set via @ref RendererConfiguration::setTileSizeCount() as
 described in its documentation. Each tile corresponds to one rendered scene,
-organized in a grid, all scenes have the same rendered size.
+organized in a grid, all scenes have the same rendered size. Alternatively,
+@ref RendererConfiguration::setTileSizes() gives each scene its own size, with
+the tiles packed into rows of the framebuffer. In both cases
+@ref sceneRectangle() tells where in the framebuffer a particular scene is
+rendered.
 
 First, files with meshes, materials and textures that are meant to be rendered
 from should get added via @ref addFile(). The file itself isn't directly
@@ -460,7 +584,9 @@ class Renderer {
   /**
    * @brief Tile size
    *
-   * The default tile size is @cpp {128, 128} @ce.
+   * The default tile size is @cpp {128, 128} @ce. If per-scene sizes were set
+   * with @ref RendererConfiguration::setTileSizes(), returns a zero vector,
+   * use @ref sceneRectangle() instead.
    * @see @ref RendererConfiguration::setTileSizeCount()
    */
   Magnum::Vector2i tileSize() const;
@@ -468,7 +594,9 @@ class Renderer {
   /**
    * @brief Tile count
    *
-   * By default there's a single tile.
+   * By default there's a single tile. If per-scene sizes were set with
+   * @ref RendererConfiguration::setTileSizes(), returns a zero vector, use
+   * @ref sceneCount() instead.
    * @see @ref RendererConfiguration::setTileSizeCount()
    */
   Magnum::Vector2i tileCount() const;
@@ -477,11 +605,61 @@ class Renderer {
    * @brief Scene count
    *
    * Same as the @ref Magnum::Math::Vector::product() "product()" of
-   * @ref tileCount(). Empty scenes are not rendered, they only occupy space in
-   * the output framebuffer.
+   * @ref tileCount(), or the count of sizes passed to
+   * @ref RendererConfiguration::setTileSizes(). Empty scenes are not
+   * rendered, they only occupy space in the output framebuffer.
    */
   std::size_t sceneCount() const;
 
+  /**
+   * @brief Size of the framebuffer all scenes are rendered into
+   *
+   * Same as @ref tileSize() multiplied by @ref tileCount(), or the bounds of
+   * all tiles packed by @ref RendererConfiguration::setTileSizes().
+   */
+  Magnum::Vector2i framebufferSize() const;
+
+  /**
+   * @brief Framebuffer rectangle a scene is rendered into
+   *
+   * Expects that @p sceneId is less than @ref sceneCount(). The rectangle is
+   * contained in @ref framebufferSize(). Also available as
+   * @ref SceneStats::rectangle.
+   */
+  Magnum::Range2Di sceneRectangle(Magnum::UnsignedInt sceneId) const;
+
+  /**
+   * @brief GPU texture memory budget
+   *
+   * If @cpp 0 @ce, the budget is unlimited and textures aren't streamed.
+   * @see @ref RendererConfiguration::setTextureMemoryBudget()
+   */
+  std::size_t textureMemoryBudget() const;
+
+  /**
+   * @brief GPU texture memory usage
+   *
+   * Estimated from the size of resident texture data, not including any
+   * driver overhead. Up-to-date only after @ref draw() if
+   * @ref textureMemoryBudget() is non-zero.
+   */
+  std::size_t textureMemoryUsage() const;
+
+  /**
+   * @brief GPU mesh memory usage
+   *
+   * Estimated from the size of vertex and index data of all meshes added
+   * with @ref addFile(), not including any driver overhead.
+   */
+  std::size_t meshMemoryUsage() const;
+
+  /**
+   * @brief Count of threads preparing scenes for drawing
+   *
+   * @see @ref RendererConfiguration::setDrawThreadCount()
+   */
+  Magnum::UnsignedInt drawThreadCount() const;
+
   /**
    * @brief Max light count
    *
@@ -581,6 +759,10 @@ class Renderer {
    * @ref transformations() at the returned ID is kept as an identity transform
    * and writing to it will not overwrite the baked transformation. This
    * parameter is useful for correcting orientation/scale of the imported mesh.
+   *
+   * If a hierarchy with the same node count was removed with
+   * @ref removeNodeHierarchy() before, its IDs are reused instead of growing
+   * the @ref transformations() array.
    * @see @ref hasNodeHierarchy(), @ref clear()
    */
   std::size_t addNodeHierarchy(Magnum::UnsignedInt sceneId,
@@ -597,6 +779,38 @@ class Renderer {
 
   std::size_t addEmptyNode(Magnum::UnsignedInt sceneId);
 
+  /**
+   * @brief Remove a node hierarchy
+   * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
+   * @param nodeId    Node ID returned from @ref addNodeHierarchy() or
+   *    @ref addEmptyNode() earlier, not removed yet
+   *
+   * Removes the node together with all draws of its hierarchy. The remaining
+   * draws are kept compact by moving the last draws in place of the removed
+   * ones, so the cost is proportional to the size of the hierarchy and not
+   * of the scene. IDs of other nodes stay the same, the removed IDs get
+   * reused by a subsequent @ref addNodeHierarchy() or @ref addEmptyNode()
+   * adding the same count of nodes. Lights attached to the removed nodes are
+   * not removed, they inherit a zero transformation instead.
+   * @see @ref clear()
+   */
+  void removeNodeHierarchy(Magnum::UnsignedInt sceneId, std::size_t nodeId);
+
+  /**
+   * @brief Set object ID of a node hierarchy
+   * @param sceneId   Scene ID, expected to be less than @ref sceneCount()
+   * @param nodeId    Node ID returned from @ref addNodeHierarchy() earlier,
+   *    not removed yet
+   * @param objectId  Object ID to output for all draws of the hierarchy
+   *
+   * Expects that @ref RendererFlag::ObjectId is enabled. Newly added
+   * hierarchies have the ID set to @cpp 0 @ce. Setting the same ID again is
+   * cheap, a change is taken into account in the next @ref draw().
+   */
+  void setObjectId(Magnum::UnsignedInt sceneId,
+                   std::size_t nodeId,
+                   Magnum::UnsignedInt objectId);
+
   /**
    * @brief Add a light
    * @param sceneId         Scene ID, expected to be less than
@@ -626,7 +840,7 @@ class Renderer {
    *
    * Clears everything added by @ref addNodeHierarchy(),
    * @ref addEmptyNode() and @ref addLight().
-   * @see @ref clearLights()
+   * @see @ref clearLights(), @ref removeNodeHierarchy()
    */
   void clear(Magnum::UnsignedInt sceneId);
 
@@ -652,6 +866,14 @@ class Renderer {
    */
   Magnum::Vector2 cameraDepthUnprojection(Magnum::UnsignedInt sceneId) const;
 
+  /**
+   * @brief Get the projection matrix of a camera (read-only)
+   * @param sceneId Scene ID, expected to be less than @ref sceneCount()
+   *
+   * Unlike @ref camera(), without the view matrix applied.
+   */
+  Magnum::Matrix4 cameraProjection(Magnum::UnsignedInt sceneId) const;
+
   /**
    * @brief Set the camera projection and view matrices
    * @param sceneId     Scene ID, expected to be less than @ref sceneCount()
@@ -717,7 +939,7 @@ class Renderer {
    * @brief Draw all scenes into provided framebuffer
    *
    * The @p framebuffer is expected to have a size at least as larger as the
-   * product of @ref tileSize() and @ref tileCount().
+   * @ref framebufferSize().
    */
   void draw(Magnum::GL::AbstractFramebuffer& framebuffer);
 
@@ -771,6 +993,21 @@ struct SceneStats {
    * @ref drawCount.
    */
   std::size_t drawBatchCount;
+
+  /**
+   * @brief Count of draws culled in the last @ref Renderer::draw()
+   *
+   * Always @cpp 0 @ce unless @ref RendererFlag::FrustumCulling is enabled.
+   * Never larger than @ref drawCount.
+   */
+  std::size_t culledDrawCount;
+
+  /**
+   * @brief Framebuffer rectangle the scene is rendered into
+   *
+   * Same as @ref Renderer::sceneRectangle().
+   */
+  Magnum::Range2Di rectangle;
 };
 
 }  // namespace gfx_batch
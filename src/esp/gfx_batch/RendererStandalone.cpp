@@ -4,15 +4,28 @@
 
 #include "RendererStandalone.h"
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Shaders/PhongGL.h>
+
+#include "DepthUnprojection.h"
 
 #ifdef MAGNUM_TARGET_EGL
 #include <Magnum/Platform/WindowlessEglApplication.h>
@@ -44,6 +57,8 @@ struct RendererStandaloneConfiguration::State {
   /* Not picking any CUDA device by default */
   Magnum::UnsignedInt cudaDevice = ~Magnum::UnsignedInt{};
   RendererStandaloneFlags flags;
+  /* If set, the context is owned by the caller */
+  std::function<void()> makeExternalContextCurrent;
 };
 
 RendererStandaloneConfiguration::RendererStandaloneConfiguration()
@@ -62,38 +77,88 @@ RendererStandaloneConfiguration& RendererStandaloneConfiguration::setFlags(
   return *this;
 }
 
+RendererStandaloneConfiguration&
+RendererStandaloneConfiguration::setExternalContext(
+    std::function<void()> makeCurrent) {
+  state->makeExternalContextCurrent = std::move(makeCurrent);
+  return *this;
+}
+
 struct RendererStandalone::State {
   RendererStandaloneFlags flags;
-  Mn::Platform::WindowlessGLContext context;
+  std::function<void()> makeExternalContextCurrent;
+  /* Both not created if the context is external */
+  Mn::Platform::WindowlessGLContext context{Mn::NoCreate};
   Mn::Platform::GLContext magnumContext{Mn::NoCreate};
-  Mn::GL::Renderbuffer color{Mn::NoCreate}, depth{Mn::NoCreate};
+  /* Color is not created with RendererFlag::DepthOnly, object ID only with
+     RendererFlag::ObjectId */
+  Mn::GL::Renderbuffer color{Mn::NoCreate}, depth{Mn::NoCreate},
+      objectId{Mn::NoCreate};
   Mn::GL::Framebuffer framebuffer{Mn::NoCreate};
   Mn::GL::BufferImage2D colorBuffer{Mn::NoCreate};
   Mn::GL::BufferImage2D depthBuffer{Mn::NoCreate};
+  Mn::GL::BufferImage2D objectIdBuffer{Mn::NoCreate};
+  /* Used instead of the depth renderbuffer if UnprojectDepth or PointCloud
+     is enabled, for the unprojection pass to sample from */
+  Mn::GL::Texture2D depthTexture{Mn::NoCreate};
+  /* Unprojected depth in the first attachment, points in the second */
+  Mn::GL::Renderbuffer unprojectedDepth{Mn::NoCreate},
+      pointCloud{Mn::NoCreate};
+  Mn::GL::Framebuffer unprojectionFramebuffer{Mn::NoCreate};
+  Mn::GL::BufferImage2D pointCloudBuffer{Mn::NoCreate};
+  TiledDepthUnprojectionShader unprojectionShader{Mn::NoCreate};
+  Mn::GL::Buffer unprojectionTileUniform{Mn::NoCreate};
+  Cr::Containers::Array<DepthUnprojectionTileUniform> unprojectionTileData;
+  Mn::GL::Mesh unprojectionMesh{Mn::NoCreate};
+  /* Read into by readFrameAsync() */
+  Mn::GL::BufferImage2D colorFrames[FrameSlotCount]{
+      Mn::GL::BufferImage2D{Mn::NoCreate}, Mn::GL::BufferImage2D{Mn::NoCreate}};
+  Mn::GL::BufferImage2D depthFrames[FrameSlotCount]{
+      Mn::GL::BufferImage2D{Mn::NoCreate}, Mn::GL::BufferImage2D{Mn::NoCreate}};
+  Mn::GL::BufferImage2D objectIdFrames[FrameSlotCount]{
+      Mn::GL::BufferImage2D{Mn::NoCreate}, Mn::GL::BufferImage2D{Mn::NoCreate}};
 #ifdef ESP_BUILD_WITH_CUDA
   cudaGraphicsResource* cudaColorBuffer{};
   cudaGraphicsResource* cudaDepthBuffer{};
+  cudaGraphicsResource* cudaObjectIdBuffer{};
+  cudaGraphicsResource* cudaPointCloudBuffer{};
+  /* Device pointers mapped since the last draw(), null if a new draw()
+     happened since */
+  const void* cudaColorPointer{};
+  const void* cudaDepthPointer{};
+  const void* cudaObjectIdPointer{};
+  const void* cudaPointCloudPointer{};
+  /* Recorded after each buffer gets mapped, for consumers on other streams
+     to wait on */
+  cudaEvent_t cudaBufferEvent{};
 #endif
 
   explicit State(const RendererStandaloneConfiguration& configuration)
-      : flags{configuration.state->flags}, context {
-    Mn::Platform::WindowlessGLContext::Configuration {}
+      : flags{configuration.state->flags},
+        makeExternalContextCurrent{
+            configuration.state->makeExternalContextCurrent} {
+    if (makeExternalContextCurrent) {
+      CORRADE_ASSERT(Mn::GL::Context::hasCurrent(),
+                     "RendererStandalone: expected the external context to "
+                     "be current", );
+    } else {
+      context = Mn::Platform::WindowlessGLContext{
+          Mn::Platform::WindowlessGLContext::Configuration{}
 #if defined(MAGNUM_TARGET_EGL) && !defined(CORRADE_TARGET_EMSCRIPTEN)
-    .setCudaDevice(configuration.state->cudaDevice)
+              .setCudaDevice(configuration.state->cudaDevice)
 #endif
-        .addFlags(
-            configuration.state->flags & RendererStandaloneFlag::QuietLog
-                ? Mn::Platform::WindowlessGLContext::Configuration::Flag::
-                      QuietLog
-                : Mn::Platform::WindowlessGLContext::Configuration::Flags{})
-  }
-  {
-    context.makeCurrent();
-    magnumContext.create(Mn::GL::Context::Configuration{}.addFlags(
-        configuration.state->flags & RendererStandaloneFlag::QuietLog
-            ? Mn::GL::Context::Configuration::Flag::QuietLog
-            : Mn::GL::Context::Configuration::Flags{}));
-    color = Mn::GL::Renderbuffer{};
+              .addFlags(
+                  flags & RendererStandaloneFlag::QuietLog
+                      ? Mn::Platform::WindowlessGLContext::Configuration::
+                            Flag::QuietLog
+                      : Mn::Platform::WindowlessGLContext::Configuration::
+                            Flags{})};
+      context.makeCurrent();
+      magnumContext.create(Mn::GL::Context::Configuration{}.addFlags(
+          flags & RendererStandaloneFlag::QuietLog
+              ? Mn::GL::Context::Configuration::Flag::QuietLog
+              : Mn::GL::Context::Configuration::Flags{}));
+    }
     depth = Mn::GL::Renderbuffer{};
   }
 
@@ -108,8 +173,55 @@ struct RendererStandalone::State {
       checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaDepthBuffer, 0));
       checkCudaErrors(cudaGraphicsUnregisterResource(cudaDepthBuffer));
     }
+    if (cudaObjectIdBuffer) {
+      checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaObjectIdBuffer, 0));
+      checkCudaErrors(cudaGraphicsUnregisterResource(cudaObjectIdBuffer));
+    }
+    if (cudaPointCloudBuffer) {
+      checkCudaErrors(cudaGraphicsUnmapResources(1, &cudaPointCloudBuffer, 0));
+      checkCudaErrors(cudaGraphicsUnregisterResource(cudaPointCloudBuffer));
+    }
+    if (cudaBufferEvent)
+      checkCudaErrors(cudaEventDestroy(cudaBufferEvent));
+  }
+
+  void recordCudaBufferEvent() {
+    if (!cudaBufferEvent)
+      checkCudaErrors(
+          cudaEventCreateWithFlags(&cudaBufferEvent, cudaEventDisableTiming));
+    /* The mapping is ordered on the legacy default stream, as is this */
+    checkCudaErrors(cudaEventRecord(cudaBufferEvent, 0));
   }
 #endif
+
+  bool unprojects() const {
+    return flags & (RendererStandaloneFlag::UnprojectDepth |
+                    RendererStandaloneFlag::PointCloud);
+  }
+
+  /* Color and object IDs share the framebuffer, so the read attachment
+     has to be picked every time */
+  Mn::GL::Framebuffer& colorReadFramebuffer() {
+    return framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+  }
+
+  Mn::GL::Framebuffer& objectIdReadFramebuffer() {
+    return framebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{1});
+  }
+
+  /* If depth is unprojected, it's read from the unprojection framebuffer
+     instead of the depth attachment */
+  Mn::GL::Framebuffer& depthReadFramebuffer() {
+    if (!(flags & RendererStandaloneFlag::UnprojectDepth))
+      return framebuffer;
+    unprojectionFramebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{0});
+    return unprojectionFramebuffer;
+  }
+
+  Mn::GL::Framebuffer& pointCloudReadFramebuffer() {
+    unprojectionFramebuffer.mapForRead(Mn::GL::Framebuffer::ColorAttachment{1});
+    return unprojectionFramebuffer;
+  }
 };
 
 RendererStandalone::RendererStandalone(
@@ -119,19 +231,104 @@ RendererStandalone::RendererStandalone(
   /* Create the renderer only once the GL context is ready */
   create(configuration);
 
-  const Mn::Vector2i size = tileSize() * tileCount();
-  state_->color.setStorage(Mn::GL::RenderbufferFormat::RGBA8, size);
-  state_->depth.setStorage(Mn::GL::RenderbufferFormat::DepthComponent32F, size);
+  const Mn::Vector2i size = framebufferSize();
   state_->framebuffer = Mn::GL::Framebuffer{Mn::Range2Di{{}, size}};
-  state_->framebuffer
-      .attachRenderbuffer(Mn::GL::Framebuffer::ColorAttachment{0},
-                          state_->color)
-      .attachRenderbuffer(Mn::GL::Framebuffer::BufferAttachment::Depth,
-                          state_->depth);
+  if (!(flags() & RendererFlag::DepthOnly)) {
+    state_->color = Mn::GL::Renderbuffer{};
+    state_->color.setStorage(Mn::GL::RenderbufferFormat::RGBA8, size);
+    state_->framebuffer.attachRenderbuffer(
+        Mn::GL::Framebuffer::ColorAttachment{0}, state_->color);
+  }
+  if (flags() & RendererFlag::ObjectId) {
+    state_->objectId = Mn::GL::Renderbuffer{};
+    state_->objectId.setStorage(Mn::GL::RenderbufferFormat::R32UI, size);
+    state_->framebuffer.attachRenderbuffer(
+        Mn::GL::Framebuffer::ColorAttachment{1}, state_->objectId);
+  }
+  /* Without a color attachment the color output is discarded, which leaves
+     just the depth test and depth writes */
+  if (flags() & (RendererFlag::DepthOnly | RendererFlag::ObjectId)) {
+    state_->framebuffer.mapForDraw(
+        {{Mn::Shaders::PhongGL::ColorOutput,
+          flags() & RendererFlag::DepthOnly
+              ? Mn::GL::Framebuffer::DrawAttachment::None
+              : Mn::GL::Framebuffer::DrawAttachment{
+                    Mn::GL::Framebuffer::ColorAttachment{0}}},
+         {Mn::Shaders::PhongGL::ObjectIdOutput,
+          flags() & RendererFlag::ObjectId
+              ? Mn::GL::Framebuffer::DrawAttachment{
+                    Mn::GL::Framebuffer::ColorAttachment{1}}
+              : Mn::GL::Framebuffer::DrawAttachment::None}});
+  }
+  if (!state_->unprojects()) {
+    state_->depth.setStorage(Mn::GL::RenderbufferFormat::DepthComponent32F,
+                             size);
+    state_->framebuffer.attachRenderbuffer(
+        Mn::GL::Framebuffer::BufferAttachment::Depth, state_->depth);
+  } else {
+    /* Depth goes to a texture the unprojection pass can sample from,
+       everything gets unprojected in a single instanced draw with one quad
+       for each scene */
+    state_->depthTexture = Mn::GL::Texture2D{};
+    state_->depthTexture
+        .setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+        .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, size);
+    state_->framebuffer.attachTexture(
+        Mn::GL::Framebuffer::BufferAttachment::Depth, state_->depthTexture, 0);
+
+    state_->unprojectedDepth = Mn::GL::Renderbuffer{};
+    state_->unprojectedDepth.setStorage(Mn::GL::RenderbufferFormat::R32F,
+                                        size);
+    state_->unprojectionFramebuffer =
+        Mn::GL::Framebuffer{Mn::Range2Di{{}, size}};
+    state_->unprojectionFramebuffer.attachRenderbuffer(
+        Mn::GL::Framebuffer::ColorAttachment{0}, state_->unprojectedDepth);
+    TiledDepthUnprojectionShader::Flags shaderFlags;
+    if (state_->flags & RendererStandaloneFlag::PointCloud) {
+      state_->pointCloud = Mn::GL::Renderbuffer{};
+      state_->pointCloud.setStorage(Mn::GL::RenderbufferFormat::RGBA32F, size);
+      state_->unprojectionFramebuffer
+          .attachRenderbuffer(Mn::GL::Framebuffer::ColorAttachment{1},
+                              state_->pointCloud)
+          .mapForDraw({{0, Mn::GL::Framebuffer::ColorAttachment{0}},
+                       {1, Mn::GL::Framebuffer::ColorAttachment{1}}});
+      state_->pointCloudBuffer =
+          Mn::GL::BufferImage2D{pointCloudFramebufferFormat()};
+      shaderFlags |= TiledDepthUnprojectionShader::Flag::PointCloud;
+    }
+    state_->unprojectionShader = TiledDepthUnprojectionShader{shaderFlags};
+
+    /* The shader always reads a whole MaxTileCount block, so round the
+       buffer size up to it */
+    const Mn::UnsignedInt tileCount =
+        (sceneCount() + TiledDepthUnprojectionShader::MaxTileCount - 1) /
+        TiledDepthUnprojectionShader::MaxTileCount *
+        TiledDepthUnprojectionShader::MaxTileCount;
+    state_->unprojectionTileData =
+        Cr::Containers::Array<DepthUnprojectionTileUniform>{Cr::ValueInit,
+                                                            tileCount};
+    state_->unprojectionTileUniform = Mn::GL::Buffer{};
+    state_->unprojectionTileUniform.setData(state_->unprojectionTileData,
+                                            Mn::GL::BufferUsage::DynamicDraw);
+    state_->unprojectionMesh =
+        Mn::GL::Mesh{Mn::GL::MeshPrimitive::TriangleStrip};
+    state_->unprojectionMesh.setCount(4);
+  }
   /* Defer the buffer initialization to the point when it's actually read
      into */
   state_->colorBuffer = Mn::GL::BufferImage2D{colorFramebufferFormat()};
   state_->depthBuffer = Mn::GL::BufferImage2D{depthFramebufferFormat()};
+  for (Mn::UnsignedInt slot = 0; slot != FrameSlotCount; ++slot) {
+    state_->colorFrames[slot] = Mn::GL::BufferImage2D{colorFramebufferFormat()};
+    state_->depthFrames[slot] = Mn::GL::BufferImage2D{depthFramebufferFormat()};
+  }
+  if (flags() & RendererFlag::ObjectId) {
+    state_->objectIdBuffer =
+        Mn::GL::BufferImage2D{objectIdFramebufferFormat()};
+    for (Mn::GL::BufferImage2D& frame : state_->objectIdFrames)
+      frame = Mn::GL::BufferImage2D{objectIdFramebufferFormat()};
+  }
 }
 
 RendererStandalone::~RendererStandalone() {
@@ -149,41 +346,119 @@ Mn::PixelFormat RendererStandalone::colorFramebufferFormat() const {
 }
 
 Mn::PixelFormat RendererStandalone::depthFramebufferFormat() const {
-  return Mn::PixelFormat::Depth32F;
+  return state_->flags & RendererStandaloneFlag::UnprojectDepth
+             ? Mn::PixelFormat::R32F
+             : Mn::PixelFormat::Depth32F;
+}
+
+Mn::PixelFormat RendererStandalone::objectIdFramebufferFormat() const {
+  return Mn::PixelFormat::R32UI;
+}
+
+Mn::PixelFormat RendererStandalone::pointCloudFramebufferFormat() const {
+  return Mn::PixelFormat::RGBA32F;
+}
+
+void RendererStandalone::makeCurrent() {
+  if (state_->makeExternalContextCurrent) {
+    state_->makeExternalContextCurrent();
+    return;
+  }
+  state_->context.makeCurrent();
+  Mn::GL::Context::makeCurrent(&state_->magnumContext);
 }
 
 void RendererStandalone::draw() {
-  state_->framebuffer.clear(Mn::GL::FramebufferClear::Color |
-                            Mn::GL::FramebufferClear::Depth);
+  /* A color clear is undefined for the integer object ID attachment, so
+     with it the attachments are cleared one by one, color to the same
+     default as GL uses */
+  if (!(flags() & RendererFlag::ObjectId)) {
+    state_->framebuffer.clear(Mn::GL::FramebufferClear::Color |
+                              Mn::GL::FramebufferClear::Depth);
+  } else {
+    state_->framebuffer.clear(Mn::GL::FramebufferClear::Depth);
+    if (!(flags() & RendererFlag::DepthOnly))
+      state_->framebuffer.clearColor(Mn::Shaders::PhongGL::ColorOutput,
+                                     Mn::Color4{});
+    state_->framebuffer.clearColor(Mn::Shaders::PhongGL::ObjectIdOutput,
+                                   Mn::Vector4ui{});
+  }
   Renderer::draw(state_->framebuffer);
+#ifdef ESP_BUILD_WITH_CUDA
+  state_->cudaColorPointer = state_->cudaDepthPointer =
+      state_->cudaObjectIdPointer = state_->cudaPointCloudPointer = nullptr;
+#endif
+
+  if (!state_->unprojects())
+    return;
+
+  /* Unproject the depth of all scenes in as few draws as possible, each scene
+     being a quad in normalized device coordinates with its own projection */
+  const Mn::Vector2 scale = 2.0f / Mn::Vector2{framebufferSize()};
+  const bool worldFrame =
+      state_->flags & RendererStandaloneFlag::PointCloudWorldFrame;
+  for (Mn::UnsignedInt i = 0; i != sceneCount(); ++i) {
+    const Mn::Range2D rectangle{sceneRectangle(i)};
+    const Mn::Vector2 min = rectangle.min() * scale - Mn::Vector2{1.0f};
+    const Mn::Vector2 max = rectangle.max() * scale - Mn::Vector2{1.0f};
+    const Mn::Vector2 depthUnprojection = cameraDepthUnprojection(i);
+    DepthUnprojectionTileUniform& tile = state_->unprojectionTileData[i];
+    tile.rectangle = {min.x(), min.y(), max.x(), max.y()};
+    tile.depthUnprojection = {depthUnprojection.x(), depthUnprojection.y(),
+                              0.0f, 0.0f};
+    tile.pointUnprojection =
+        (worldFrame ? camera(i) : cameraProjection(i)).inverted();
+  }
+  state_->unprojectionTileUniform.setSubData(0, state_->unprojectionTileData);
+
+  state_->unprojectionFramebuffer.clear(Mn::GL::FramebufferClear::Color)
+      .bind();
+  state_->unprojectionShader.bindDepthTexture(state_->depthTexture);
+  const Mn::UnsignedInt maxTileCount =
+      TiledDepthUnprojectionShader::MaxTileCount;
+  for (Mn::UnsignedInt offset = 0; offset < sceneCount();
+       offset += maxTileCount) {
+    state_->unprojectionShader.bindTileBuffer(state_->unprojectionTileUniform,
+                                              offset);
+    state_->unprojectionMesh.setInstanceCount(
+        Mn::Math::min(sceneCount() - offset, maxTileCount));
+    state_->unprojectionShader.draw(state_->unprojectionMesh);
+  }
 }
 
 Mn::Image2D RendererStandalone::colorImage() {
+  CORRADE_ASSERT(!(flags() & RendererFlag::DepthOnly),
+                 "RendererStandalone::colorImage(): no color output with a "
+                 "depth-only renderer",
+                 (Mn::Image2D{colorFramebufferFormat()}));
   /* Not using state_->framebuffer.viewport() as it's left pointing to whatever
      tile was rendered last */
-  return state_->framebuffer.read({{}, tileCount() * tileSize()},
-                                  colorFramebufferFormat());
+  return state_->colorReadFramebuffer().read({{}, framebufferSize()},
+                                             colorFramebufferFormat());
 }
 
 void RendererStandalone::colorImageInto(const Magnum::Range2Di& rectangle,
                                         const Mn::MutableImageView2D& image) {
   /* Deliberately not checking that image.format() == colorFramebufferFormat()
      in order to allow for pixel format by the driver (such as RGBA to RGB) */
-  CORRADE_ASSERT(rectangle.max() <= tileCount() * tileSize(),
+  CORRADE_ASSERT(!(flags() & RendererFlag::DepthOnly),
+                 "RendererStandalone::colorImageInto(): no color output with "
+                 "a depth-only renderer", );
+  CORRADE_ASSERT(rectangle.max() <= framebufferSize(),
                  "RendererStandalone::colorImageInto():"
                      << rectangle << "doesn't fit in a size of"
-                     << tileCount() * tileSize(), );
+                     << framebufferSize(), );
   CORRADE_ASSERT(image.size() == rectangle.size(),
                  "RendererStandalone::colorImageInto(): expected image size of"
                      << rectangle.size() << "pixels but got" << image.size(), );
-  return state_->framebuffer.read(rectangle, image);
+  return state_->colorReadFramebuffer().read(rectangle, image);
 }
 
 Mn::Image2D RendererStandalone::depthImage() {
   /* Not using state_->framebuffer.viewport() as it's left pointing to whatever
      tile was rendered last */
-  return state_->framebuffer.read({{}, tileCount() * tileSize()},
-                                  depthFramebufferFormat());
+  return state_->depthReadFramebuffer().read({{}, framebufferSize()},
+                                             depthFramebufferFormat());
 }
 
 void RendererStandalone::depthImageInto(const Magnum::Range2Di& rectangle,
@@ -191,18 +466,161 @@ void RendererStandalone::depthImageInto(const Magnum::Range2Di& rectangle,
   /* Deliberately not checking that image.format() == depthFramebufferFormat()
      in order to allow for pixel format by the driver (such as 24-bit to 32-bit
      float) */
-  CORRADE_ASSERT(rectangle.max() <= tileCount() * tileSize(),
+  CORRADE_ASSERT(rectangle.max() <= framebufferSize(),
                  "RendererStandalone::depthImageInto():"
                      << rectangle << "doesn't fit in a size of"
-                     << tileCount() * tileSize(), );
+                     << framebufferSize(), );
   CORRADE_ASSERT(image.size() == rectangle.size(),
                  "RendererStandalone::depthImageInto(): expected image size of"
                      << rectangle.size() << "pixels but got" << image.size(), );
-  return state_->framebuffer.read(rectangle, image);
+  return state_->depthReadFramebuffer().read(rectangle, image);
+}
+
+Mn::Image2D RendererStandalone::objectIdImage() {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdImage(): object ID output not "
+                 "enabled",
+                 (Mn::Image2D{objectIdFramebufferFormat()}));
+  return state_->objectIdReadFramebuffer().read({{}, framebufferSize()},
+                                                objectIdFramebufferFormat());
+}
+
+void RendererStandalone::objectIdImageInto(
+    const Magnum::Range2Di& rectangle,
+    const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdImageInto(): object ID output "
+                 "not enabled", );
+  CORRADE_ASSERT(rectangle.max() <= framebufferSize(),
+                 "RendererStandalone::objectIdImageInto():"
+                     << rectangle << "doesn't fit in a size of"
+                     << framebufferSize(), );
+  CORRADE_ASSERT(
+      image.size() == rectangle.size(),
+      "RendererStandalone::objectIdImageInto(): expected image size of"
+          << rectangle.size() << "pixels but got" << image.size(), );
+  return state_->objectIdReadFramebuffer().read(rectangle, image);
+}
+
+Mn::Image2D RendererStandalone::pointCloudImage() {
+  CORRADE_ASSERT(state_->flags & RendererStandaloneFlag::PointCloud,
+                 "RendererStandalone::pointCloudImage(): point cloud output "
+                 "not enabled",
+                 (Mn::Image2D{pointCloudFramebufferFormat()}));
+  return state_->pointCloudReadFramebuffer().read(
+      {{}, framebufferSize()}, pointCloudFramebufferFormat());
+}
+
+void RendererStandalone::readFrameAsync(const Mn::UnsignedInt slot) {
+  CORRADE_ASSERT(slot < FrameSlotCount,
+                 "RendererStandalone::readFrameAsync(): slot"
+                     << slot << "out of range for" << FrameSlotCount
+                     << "slots", );
+  /* Reading into a buffer image only enqueues the copy, and the flush makes
+     the GPU start on it right away instead of whenever the driver decides */
+  if (!(flags() & RendererFlag::DepthOnly))
+    state_->colorReadFramebuffer().read({{}, framebufferSize()},
+                                        state_->colorFrames[slot],
+                                        Mn::GL::BufferUsage::StreamRead);
+  state_->depthReadFramebuffer().read({{}, framebufferSize()},
+                                      state_->depthFrames[slot],
+                                      Mn::GL::BufferUsage::StreamRead);
+  if (flags() & RendererFlag::ObjectId)
+    state_->objectIdReadFramebuffer().read({{}, framebufferSize()},
+                                           state_->objectIdFrames[slot],
+                                           Mn::GL::BufferUsage::StreamRead);
+  Mn::GL::Renderer::flush();
+}
+
+namespace {
+
+void frameInto(const char* const messagePrefix,
+               Mn::GL::BufferImage2D& frame,
+               const Mn::Range2Di& rectangle,
+               const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(rectangle.max() <= frame.size(),
+                 messagePrefix << rectangle << "doesn't fit in a size of"
+                               << frame.size(), );
+  CORRADE_ASSERT(image.size() == rectangle.size(),
+                 messagePrefix << "expected image size of" << rectangle.size()
+                               << "pixels but got" << image.size(), );
+  /* Same as the driver does in *ImageInto(), formats with fewer channels get
+     the trailing ones dropped */
+  CORRADE_ASSERT(image.pixelSize() <= frame.pixelSize(),
+                 messagePrefix << "can't read a" << frame.pixelSize()
+                               << "byte format into" << image.pixelSize()
+                               << "bytes per pixel", );
+
+  /* Map just the rows the rectangle spans, waiting for the read to finish */
+  const std::size_t rowStride = frame.dataProperties().second.x();
+  const Cr::Containers::ArrayView<char> rows = frame.buffer().map(
+      rectangle.min().y() * rowStride, rectangle.sizeY() * rowStride,
+      Mn::GL::Buffer::MapFlag::Read);
+  CORRADE_INTERNAL_ASSERT(rows.data());
+  const Mn::ImageView2D mapped{frame.storage(), frame.format(),
+                               {frame.size().x(), rectangle.sizeY()}, rows};
+  Cr::Utility::copy(
+      mapped.pixels().sliceSize(
+          {0, std::size_t(rectangle.min().x()), 0},
+          {std::size_t(rectangle.sizeY()), std::size_t(rectangle.sizeX()),
+           image.pixelSize()}),
+      image.pixels());
+  frame.buffer().unmap();
+}
+
+}  // namespace
+
+void RendererStandalone::colorFrameInto(const Mn::UnsignedInt slot,
+                                        const Mn::Range2Di& rectangle,
+                                        const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(slot < FrameSlotCount,
+                 "RendererStandalone::colorFrameInto(): slot"
+                     << slot << "out of range for" << FrameSlotCount
+                     << "slots", );
+  CORRADE_ASSERT(!(flags() & RendererFlag::DepthOnly),
+                 "RendererStandalone::colorFrameInto(): no color output with "
+                 "a depth-only renderer", );
+  frameInto("RendererStandalone::colorFrameInto():", state_->colorFrames[slot],
+            rectangle, image);
+}
+
+void RendererStandalone::depthFrameInto(const Mn::UnsignedInt slot,
+                                        const Mn::Range2Di& rectangle,
+                                        const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(slot < FrameSlotCount,
+                 "RendererStandalone::depthFrameInto(): slot"
+                     << slot << "out of range for" << FrameSlotCount
+                     << "slots", );
+  frameInto("RendererStandalone::depthFrameInto():", state_->depthFrames[slot],
+            rectangle, image);
+}
+
+void RendererStandalone::objectIdFrameInto(
+    const Mn::UnsignedInt slot,
+    const Mn::Range2Di& rectangle,
+    const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(slot < FrameSlotCount,
+                 "RendererStandalone::objectIdFrameInto(): slot"
+                     << slot << "out of range for" << FrameSlotCount
+                     << "slots", );
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdFrameInto(): object ID output "
+                 "not enabled", );
+  frameInto("RendererStandalone::objectIdFrameInto():",
+            state_->objectIdFrames[slot], rectangle, image);
 }
 
 #ifdef ESP_BUILD_WITH_CUDA
 const void* RendererStandalone::colorCudaBufferDevicePointer() {
+  CORRADE_ASSERT(!(flags() & RendererFlag::DepthOnly),
+                 "RendererStandalone::colorCudaBufferDevicePointer(): no color "
+                 "output with a depth-only renderer",
+                 {});
+
+  /* Nothing was drawn since the last copy, reuse it */
+  if (state_->cudaColorPointer)
+    return state_->cudaColorPointer;
+
   /* If the CUDA buffer exists already, it's mapped from the previous call.
      Unmap it first so we can read into it from GL. */
   if (state_->cudaColorBuffer)
@@ -211,8 +629,9 @@ const void* RendererStandalone::colorCudaBufferDevicePointer() {
   /* Read to the buffer image, allocating it if it's not already. Can't really
      return a pointer directly to the renderbuffer because the returned device
      pointer is expected to be linearized. */
-  state_->framebuffer.read({{}, tileCount() * tileSize()}, state_->colorBuffer,
-                           Mn::GL::BufferUsage::DynamicRead);
+  state_->colorReadFramebuffer().read({{}, framebufferSize()},
+                                      state_->colorBuffer,
+                                      Mn::GL::BufferUsage::DynamicRead);
 
   /* Initialize the CUDA buffer from the GL buffer image if it's not already */
   if (!state_->cudaColorBuffer) {
@@ -223,16 +642,34 @@ const void* RendererStandalone::colorCudaBufferDevicePointer() {
 
   /* Map the buffer and return the device pointer */
   checkCudaErrors(cudaGraphicsMapResources(1, &state_->cudaColorBuffer, 0));
+  state_->recordCudaBufferEvent();
   void* pointer;
   std::size_t size;
   checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
       &pointer, &size, state_->cudaColorBuffer));
   CORRADE_INTERNAL_ASSERT(size == state_->colorBuffer.size().product() *
                                       state_->colorBuffer.pixelSize());
-  return pointer;
+  return state_->cudaColorPointer = pointer;
+}
+
+const void* RendererStandalone::colorCudaBufferDevicePointer(
+    const Mn::UnsignedInt sceneId) {
+  CORRADE_ASSERT(sceneId < sceneCount(),
+                 "RendererStandalone::colorCudaBufferDevicePointer(): index"
+                     << sceneId << "out of range for" << sceneCount()
+                     << "scenes",
+                 {});
+  const Mn::Vector2i origin = sceneRectangle(sceneId).min();
+  return static_cast<const char*>(colorCudaBufferDevicePointer()) +
+         (std::size_t(origin.y()) * framebufferSize().x() + origin.x()) *
+             Mn::pixelFormatSize(colorFramebufferFormat());
 }
 
 const void* RendererStandalone::depthCudaBufferDevicePointer() {
+  /* Nothing was drawn since the last copy, reuse it */
+  if (state_->cudaDepthPointer)
+    return state_->cudaDepthPointer;
+
   /* If the CUDA buffer exists already, it's mapped from the previous call.
      Unmap it first so we can read into it from GL. */
   if (state_->cudaDepthBuffer)
@@ -241,8 +678,9 @@ const void* RendererStandalone::depthCudaBufferDevicePointer() {
   /* Read to the buffer image, allocating it if it's not already. Can't really
      return a pointer directly to the renderbuffer because the returned device
      pointer is expected to be linearized. */
-  state_->framebuffer.read({{}, tileCount() * tileSize()}, state_->depthBuffer,
-                           Mn::GL::BufferUsage::DynamicRead);
+  state_->depthReadFramebuffer().read({{}, framebufferSize()},
+                                      state_->depthBuffer,
+                                      Mn::GL::BufferUsage::DynamicRead);
 
   /* Initialize the CUDA buffer from the GL buffer image if it's not already */
   if (!state_->cudaDepthBuffer) {
@@ -253,13 +691,144 @@ const void* RendererStandalone::depthCudaBufferDevicePointer() {
 
   /* Map the buffer and return the device pointer */
   checkCudaErrors(cudaGraphicsMapResources(1, &state_->cudaDepthBuffer, 0));
+  state_->recordCudaBufferEvent();
   void* pointer;
   std::size_t size;
   checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
       &pointer, &size, state_->cudaDepthBuffer));
   CORRADE_INTERNAL_ASSERT(size == state_->depthBuffer.size().product() *
                                       state_->depthBuffer.pixelSize());
-  return pointer;
+  return state_->cudaDepthPointer = pointer;
+}
+
+const void* RendererStandalone::depthCudaBufferDevicePointer(
+    const Mn::UnsignedInt sceneId) {
+  CORRADE_ASSERT(sceneId < sceneCount(),
+                 "RendererStandalone::depthCudaBufferDevicePointer(): index"
+                     << sceneId << "out of range for" << sceneCount()
+                     << "scenes",
+                 {});
+  const Mn::Vector2i origin = sceneRectangle(sceneId).min();
+  return static_cast<const char*>(depthCudaBufferDevicePointer()) +
+         (std::size_t(origin.y()) * framebufferSize().x() + origin.x()) *
+             Mn::pixelFormatSize(depthFramebufferFormat());
+}
+
+const void* RendererStandalone::objectIdCudaBufferDevicePointer() {
+  CORRADE_ASSERT(flags() & RendererFlag::ObjectId,
+                 "RendererStandalone::objectIdCudaBufferDevicePointer(): "
+                 "object ID output not enabled",
+                 {});
+
+  /* Nothing was drawn since the last copy, reuse it */
+  if (state_->cudaObjectIdPointer)
+    return state_->cudaObjectIdPointer;
+
+  /* If the CUDA buffer exists already, it's mapped from the previous call.
+     Unmap it first so we can read into it from GL. */
+  if (state_->cudaObjectIdBuffer)
+    checkCudaErrors(
+        cudaGraphicsUnmapResources(1, &state_->cudaObjectIdBuffer, 0));
+
+  /* Read to the buffer image, allocating it if it's not already */
+  state_->objectIdReadFramebuffer().read({{}, framebufferSize()},
+                                         state_->objectIdBuffer,
+                                         Mn::GL::BufferUsage::DynamicRead);
+
+  /* Initialize the CUDA buffer from the GL buffer image if it's not already */
+  if (!state_->cudaObjectIdBuffer) {
+    checkCudaErrors(cudaGraphicsGLRegisterBuffer(
+        &state_->cudaObjectIdBuffer, state_->objectIdBuffer.buffer().id(),
+        cudaGraphicsRegisterFlagsReadOnly));
+  }
+
+  /* Map the buffer and return the device pointer */
+  checkCudaErrors(cudaGraphicsMapResources(1, &state_->cudaObjectIdBuffer, 0));
+  state_->recordCudaBufferEvent();
+  void* pointer;
+  std::size_t size;
+  checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
+      &pointer, &size, state_->cudaObjectIdBuffer));
+  CORRADE_INTERNAL_ASSERT(size == state_->objectIdBuffer.size().product() *
+                                      state_->objectIdBuffer.pixelSize());
+  return state_->cudaObjectIdPointer = pointer;
+}
+
+const void* RendererStandalone::objectIdCudaBufferDevicePointer(
+    const Mn::UnsignedInt sceneId) {
+  CORRADE_ASSERT(sceneId < sceneCount(),
+                 "RendererStandalone::objectIdCudaBufferDevicePointer(): "
+                 "index"
+                     << sceneId << "out of range for" << sceneCount()
+                     << "scenes",
+                 {});
+  const Mn::Vector2i origin = sceneRectangle(sceneId).min();
+  return static_cast<const char*>(objectIdCudaBufferDevicePointer()) +
+         (std::size_t(origin.y()) * framebufferSize().x() + origin.x()) *
+             Mn::pixelFormatSize(objectIdFramebufferFormat());
+}
+
+const void* RendererStandalone::pointCloudCudaBufferDevicePointer() {
+  CORRADE_ASSERT(state_->flags & RendererStandaloneFlag::PointCloud,
+                 "RendererStandalone::pointCloudCudaBufferDevicePointer(): "
+                 "point cloud output not enabled",
+                 {});
+
+  /* Nothing was drawn since the last copy, reuse it */
+  if (state_->cudaPointCloudPointer)
+    return state_->cudaPointCloudPointer;
+
+  /* If the CUDA buffer exists already, it's mapped from the previous call.
+     Unmap it first so we can read into it from GL. */
+  if (state_->cudaPointCloudBuffer)
+    checkCudaErrors(
+        cudaGraphicsUnmapResources(1, &state_->cudaPointCloudBuffer, 0));
+
+  /* Read to the buffer image, allocating it if it's not already */
+  state_->pointCloudReadFramebuffer().read({{}, framebufferSize()},
+                                           state_->pointCloudBuffer,
+                                           Mn::GL::BufferUsage::DynamicRead);
+
+  /* Initialize the CUDA buffer from the GL buffer image if it's not already */
+  if (!state_->cudaPointCloudBuffer) {
+    checkCudaErrors(cudaGraphicsGLRegisterBuffer(
+        &state_->cudaPointCloudBuffer, state_->pointCloudBuffer.buffer().id(),
+        cudaGraphicsRegisterFlagsReadOnly));
+  }
+
+  /* Map the buffer and return the device pointer */
+  checkCudaErrors(
+      cudaGraphicsMapResources(1, &state_->cudaPointCloudBuffer, 0));
+  state_->recordCudaBufferEvent();
+  void* pointer;
+  std::size_t size;
+  checkCudaErrors(cudaGraphicsResourceGetMappedPointer(
+      &pointer, &size, state_->cudaPointCloudBuffer));
+  CORRADE_INTERNAL_ASSERT(size == state_->pointCloudBuffer.size().product() *
+                                      state_->pointCloudBuffer.pixelSize());
+  return state_->cudaPointCloudPointer = pointer;
+}
+
+const void* RendererStandalone::pointCloudCudaBufferDevicePointer(
+    const Mn::UnsignedInt sceneId) {
+  CORRADE_ASSERT(sceneId < sceneCount(),
+                 "RendererStandalone::pointCloudCudaBufferDevicePointer(): "
+                 "index"
+                     << sceneId << "out of range for" << sceneCount()
+                     << "scenes",
+                 {});
+  const Mn::Vector2i origin = sceneRectangle(sceneId).min();
+  return static_cast<const char*>(pointCloudCudaBufferDevicePointer()) +
+         (std::size_t(origin.y()) * framebufferSize().x() + origin.x()) *
+             Mn::pixelFormatSize(pointCloudFramebufferFormat());
+}
+
+void RendererStandalone::waitForCudaBuffers(void* const stream) {
+  /* Nothing was mapped yet, so there's nothing to wait for */
+  if (!state_->cudaBufferEvent)
+    return;
+  checkCudaErrors(cudaStreamWaitEvent(static_cast<cudaStream_t>(stream),
+                                      state_->cudaBufferEvent, 0));
 }
 #endif
 
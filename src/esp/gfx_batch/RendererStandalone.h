@@ -5,6 +5,8 @@
 #ifndef ESP_GFX_BATCH_RENDERER_STANDALONE_H_
 #define ESP_GFX_BATCH_RENDERER_STANDALONE_H_
 
+#include <functional>
+
 #include "Renderer.h"
 
 // TODO: ideally this would go directly to esp/, so we don't depend on core
@@ -32,7 +34,35 @@ enum class RendererStandaloneFlag {
    *    **Not recommended** to be enabled in end-user applications, as the log
    *    contains vital information for debugging platform-specific issues.
    */
-  QuietLog = 1 << 0
+  QuietLog = 1 << 0,
+
+  /**
+   * Unproject the depth of all scenes on the GPU right after
+   * @ref RendererStandalone::draw(). All depth outputs are then metric depth
+   * in @ref Magnum::PixelFormat::R32F with values on the far plane set to
+   * @cpp 0.0f @ce, same as if @ref unprojectDepth() was applied on each
+   * scene rectangle, and there's no need to unproject on the CPU.
+   * @see @ref RendererStandalone::depthFramebufferFormat(),
+   *    @ref TiledDepthUnprojectionShader
+   */
+  UnprojectDepth = 1 << 1,
+
+  /**
+   * Calculate a point for each pixel on the GPU right after
+   * @ref RendererStandalone::draw(), retrievable with
+   * @ref RendererStandalone::pointCloudImage() and
+   * @ref RendererStandalone::pointCloudCudaBufferDevicePointer(). The points
+   * are in the camera space of each scene unless
+   * @ref RendererStandaloneFlag::PointCloudWorldFrame is set as well.
+   */
+  PointCloud = 1 << 2,
+
+  /**
+   * Calculate the points for @ref RendererStandaloneFlag::PointCloud in world
+   * space instead of camera space. Has no effect if
+   * @ref RendererStandaloneFlag::PointCloud isn't set.
+   */
+  PointCloudWorldFrame = 1 << 3
 };
 
 /**
@@ -74,6 +104,19 @@ struct RendererStandaloneConfiguration {
    */
   RendererStandaloneConfiguration& setFlags(RendererStandaloneFlags flags);
 
+  /**
+   * @brief Use a GL context owned by the caller
+   *
+   * By default the renderer creates its own context. If set, the context
+   * current at construction time is used instead and @p makeCurrent is
+   * called by @ref RendererStandalone::makeCurrent(). The context is
+   * expected to outlive the renderer and be current on its destruction.
+   * @ref setCudaDevice() and @ref RendererStandaloneFlag::QuietLog have no
+   * effect on the context in that case.
+   */
+  RendererStandaloneConfiguration& setExternalContext(
+      std::function<void()> makeCurrent);
+
  private:
   friend RendererStandalone;
   struct State;
@@ -143,7 +186,8 @@ class RendererStandalone : public Renderer {
    *
    * Format in which @ref colorImage() and @ref colorCudaBufferDevicePointer()
    * is returned. At the moment @ref Magnum::PixelFormat::RGBA8Unorm.
-   * Framebuffer size is @ref tileSize() multiplied by @ref tileCount().
+   * Framebuffer size is @ref framebufferSize(). There's no color output if
+   * @ref RendererFlag::DepthOnly is set.
    * @see @ref Magnum::pixelFormatSize(), @ref Magnum::pixelFormatChannelCount()
    */
   Magnum::PixelFormat colorFramebufferFormat() const;
@@ -152,12 +196,46 @@ class RendererStandalone : public Renderer {
    * @brief Depth framebuffer format
    *
    * Format in which @ref depthImage() and @ref colorCudaBufferDevicePointer()
-   * is returned. At the moment @ref Magnum::PixelFormat::Depth32F. Framebuffer
-   * size is @ref tileSize() multiplied by @ref tileCount().
+   * is returned. At the moment @ref Magnum::PixelFormat::Depth32F, or
+   * @ref Magnum::PixelFormat::R32F if
+   * @ref RendererStandaloneFlag::UnprojectDepth is set. Framebuffer size is
+   * @ref framebufferSize().
    * @see @ref Magnum::pixelFormatSize()
    */
   Magnum::PixelFormat depthFramebufferFormat() const;
 
+  /**
+   * @brief Object ID framebuffer format
+   *
+   * Format in which @ref objectIdImage() and
+   * @ref objectIdCudaBufferDevicePointer() is returned. At the moment
+   * @ref Magnum::PixelFormat::R32UI. Framebuffer size is
+   * @ref framebufferSize().
+   * @see @ref RendererFlag::ObjectId
+   */
+  Magnum::PixelFormat objectIdFramebufferFormat() const;
+
+  /**
+   * @brief Point cloud framebuffer format
+   *
+   * Format in which @ref pointCloudImage() and
+   * @ref pointCloudCudaBufferDevicePointer() is returned. At the moment
+   * @ref Magnum::PixelFormat::RGBA32F, with the last component being
+   * @cpp 1.0f @ce for valid points and @cpp 0.0f @ce for pixels on the far
+   * plane. Framebuffer size is @ref framebufferSize().
+   * @see @ref RendererStandaloneFlag::PointCloud
+   */
+  Magnum::PixelFormat pointCloudFramebufferFormat() const;
+
+  /**
+   * @brief Make the renderer GL context current
+   *
+   * The context is made current on construction. When there's more than one
+   * standalone renderer in the process, e.g. one per GPU, call this before
+   * using a renderer after another one was used.
+   */
+  void makeCurrent();
+
   /**
    * @brief Draw all scenes
    *
@@ -171,19 +249,21 @@ class RendererStandalone : public Renderer {
   /**
    * @brief Retrieve the rendered color output
    *
-   * Stalls the CPU until the GPU finishes the last @ref draw() and then
-   * returns an image in @ref colorFramebufferFormat() and with size being
-   * @ref tileSize() multiplied by @ref tileCount().
+   * Expects that @ref RendererFlag::DepthOnly isn't set. Stalls the CPU until
+   * the GPU finishes the last @ref draw() and then returns an image in
+   * @ref colorFramebufferFormat() and with size being
+   * @ref framebufferSize().
    */
   Magnum::Image2D colorImage();
 
   /**
    * @brief Retrieve the rendered color output into a pre-allocated location
    *
-   * Expects that @p rectangle is contained in a size defined
-   * by @ref tileSize() multiplied by @ref tileCount(), that @p image
-   * size corresponds to @p rectangle size and that its format is compatible
-   * with @ref colorFramebufferFormat().
+   * Expects that @ref RendererFlag::DepthOnly isn't set, that @p rectangle
+   * is contained in @ref framebufferSize() --- such as a
+   * @ref sceneRectangle() --- that @p image size corresponds to @p rectangle
+   * size and that its format is compatible with
+   * @ref colorFramebufferFormat().
    */
   void colorImageInto(const Magnum::Range2Di& rectangle,
                       const Magnum::MutableImageView2D& image);
@@ -191,11 +271,13 @@ class RendererStandalone : public Renderer {
   /**
    * @brief Retrieve the raw rendered depth output.
    *
-   * This returns the depth buffer as-is. To unproject, use @ref unprojectDepth().
+   * This returns the depth buffer as-is. To unproject, use
+   * @ref unprojectDepth(), or set @ref RendererStandaloneFlag::UnprojectDepth
+   * to get metric depth directly.
    *
    * Stalls the CPU until the GPU finishes the last @ref draw() and then
    * returns an image in @ref depthFramebufferFormat() and with size being
-   * @ref tileSize() multiplied by @ref tileCount().
+   * @ref framebufferSize().
    */
   Magnum::Image2D depthImage();
 
@@ -205,34 +287,214 @@ class RendererStandalone : public Renderer {
    *
    * This returns the depth buffer as-is. To unproject, use @ref unprojectDepth().
    *
-   * Expects that @p rectangle is contained in a size defined
-   * by @ref tileSize() multiplied by @ref tileCount(), that @p image
+   * Expects that @p rectangle is contained in @ref framebufferSize() ---
+   * such as a @ref sceneRectangle() --- that @p image
    * size corresponds to @p rectangle size and that its format is compatible
    * with @ref depthFramebufferFormat().
    */
   void depthImageInto(const Magnum::Range2Di& rectangle,
                       const Magnum::MutableImageView2D& image);
 
+  /**
+   * @brief Retrieve the point cloud output
+   *
+   * Expects that @ref RendererStandaloneFlag::PointCloud is set. Stalls the
+   * CPU until the GPU finishes the last @ref draw() and then returns an image
+   * in @ref pointCloudFramebufferFormat() and with size being
+   * @ref framebufferSize().
+   */
+  Magnum::Image2D pointCloudImage();
+
+  /**
+   * @brief Retrieve the object ID output
+   *
+   * Expects that @ref RendererFlag::ObjectId is set. Stalls the CPU until the
+   * GPU finishes the last @ref draw() and then returns an image in
+   * @ref objectIdFramebufferFormat() and with size being
+   * @ref framebufferSize().
+   */
+  Magnum::Image2D objectIdImage();
+
+  /**
+   * @brief Retrieve the object ID output into a pre-allocated location
+   *
+   * Expects that @ref RendererFlag::ObjectId is set, @p rectangle is
+   * contained in @ref framebufferSize(), @p image size corresponds to
+   * @p rectangle size and its format is compatible with
+   * @ref objectIdFramebufferFormat().
+   */
+  void objectIdImageInto(const Magnum::Range2Di& rectangle,
+                         const Magnum::MutableImageView2D& image);
+
+  /**
+   * @brief Count of slots for asynchronous frame reads
+   *
+   * @see @ref readFrameAsync()
+   */
+  enum : Magnum::UnsignedInt { FrameSlotCount = 2 };
+
+  /**
+   * @brief Start reading the rendered output without waiting for it
+   *
+   * Enqueues a copy of the whole color, depth and, if
+   * @ref RendererFlag::ObjectId is set, object ID framebuffer into GPU memory
+   * associated with @p slot and returns right away, without waiting for the
+   * last @ref draw() to finish. Scenes can then be updated and drawn again
+   * while the GPU is still busy. Retrieve the output later with
+   * @ref colorFrameInto(), @ref depthFrameInto() and
+   * @ref objectIdFrameInto(), which stall only if the
+   * copy isn't finished yet. With @ref FrameSlotCount slots, one frame can be
+   * retrieved while the next one is in flight. Expects that @p slot is less
+   * than @ref FrameSlotCount.
+   */
+  void readFrameAsync(Magnum::UnsignedInt slot);
+
+  /**
+   * @brief Retrieve a color output read by @ref readFrameAsync()
+   *
+   * Expects that @ref RendererFlag::DepthOnly isn't set, @p slot is less
+   * than @ref FrameSlotCount, @p rectangle is contained in
+   * @ref framebufferSize(), @p image size corresponds to
+   * @p rectangle size and its pixel size is not larger than of
+   * @ref colorFramebufferFormat(). If smaller, such as with RGB output, the
+   * trailing channels are dropped.
+   */
+  void colorFrameInto(Magnum::UnsignedInt slot,
+                      const Magnum::Range2Di& rectangle,
+                      const Magnum::MutableImageView2D& image);
+
+  /**
+   * @brief Retrieve a raw depth output read by @ref readFrameAsync()
+   *
+   * Expects that @p slot is less than @ref FrameSlotCount, @p rectangle is
+   * contained in @ref framebufferSize(), @p image size corresponds to
+   * @p rectangle size and its pixel size is not larger than of
+   * @ref depthFramebufferFormat().
+   */
+  void depthFrameInto(Magnum::UnsignedInt slot,
+                      const Magnum::Range2Di& rectangle,
+                      const Magnum::MutableImageView2D& image);
+
+  /**
+   * @brief Retrieve an object ID output read by @ref readFrameAsync()
+   *
+   * Expects that @ref RendererFlag::ObjectId is set, @p slot is less than
+   * @ref FrameSlotCount, @p rectangle is contained in @ref framebufferSize(),
+   * @p image size corresponds to @p rectangle size and its pixel size is not
+   * larger than of @ref objectIdFramebufferFormat().
+   */
+  void objectIdFrameInto(Magnum::UnsignedInt slot,
+                         const Magnum::Range2Di& rectangle,
+                         const Magnum::MutableImageView2D& image);
+
 #if defined(ESP_BUILD_WITH_CUDA) || defined(DOXYGEN_GENERATING_OUTPUT)
   /**
    * @brief Retrieve the rendered color output as a CUDA device pointer
    *
-   * Copies the internal framebuffer into a linearized and tightly-packed CUDA
-   * buffer of @ref colorFramebufferFormat() and with size given by the
-   * @ref Magnum::Math::Vector::product() "product()" of @ref tileSize()
-   * and @ref tileCount(), and returns its device pointer.
+   * Expects that @ref RendererFlag::DepthOnly isn't set. Copies the internal
+   * framebuffer into a linearized and tightly-packed CUDA buffer of
+   * @ref colorFramebufferFormat() and with size given by the
+   * @ref Magnum::Math::Vector::product() "product()" of
+   * @ref framebufferSize(), and returns its device pointer. The copy is done
+   * only once after each @ref draw(), subsequent calls return the same
+   * pointer.
    */
   const void* colorCudaBufferDevicePointer();
 
+  /**
+   * @brief Retrieve the color output of a scene as a CUDA device pointer
+   *
+   * Like @ref colorCudaBufferDevicePointer(), but returns a pointer to the
+   * first pixel of @ref sceneRectangle() for @p sceneId. Consecutive rows of
+   * the scene are @ref Magnum::Math::Vector2::x() "x()" of
+   * @ref framebufferSize() pixels apart. Expects that @p sceneId is less than
+   * @ref sceneCount().
+   */
+  const void* colorCudaBufferDevicePointer(Magnum::UnsignedInt sceneId);
+
   /**
    * @brief Retrieve the rendered depth output as a CUDA device pointer
    *
    * Copies the internal framebuffer into a linearized and tightly-packed CUDA
    * buffer of @ref depthFramebufferFormat() and with size given by the
-   * @ref Magnum::Math::Vector::product() "product()" of @ref tileSize()
-   * and @ref tileCount(), and returns its device pointer.
+   * @ref Magnum::Math::Vector::product() "product()" of
+   * @ref framebufferSize(), and returns its device pointer. The copy is done
+   * only once after each @ref draw(), subsequent calls return the same
+   * pointer.
    */
   const void* depthCudaBufferDevicePointer();
+
+  /**
+   * @brief Retrieve the depth output of a scene as a CUDA device pointer
+   *
+   * Like @ref depthCudaBufferDevicePointer(), but returns a pointer to the
+   * first pixel of @ref sceneRectangle() for @p sceneId. Consecutive rows of
+   * the scene are @ref Magnum::Math::Vector2::x() "x()" of
+   * @ref framebufferSize() pixels apart. Expects that @p sceneId is less than
+   * @ref sceneCount().
+   */
+  const void* depthCudaBufferDevicePointer(Magnum::UnsignedInt sceneId);
+
+  /**
+   * @brief Retrieve the object ID output as a CUDA device pointer
+   *
+   * Expects that @ref RendererFlag::ObjectId is set. Copies the internal
+   * framebuffer into a linearized and tightly-packed CUDA buffer of
+   * @ref objectIdFramebufferFormat() and with size given by the
+   * @ref Magnum::Math::Vector::product() "product()" of
+   * @ref framebufferSize(), and returns its device pointer. The copy is done
+   * only once after each @ref draw(), subsequent calls return the same
+   * pointer.
+   */
+  const void* objectIdCudaBufferDevicePointer();
+
+  /**
+   * @brief Retrieve the object ID output of a scene as a CUDA device pointer
+   *
+   * Like @ref objectIdCudaBufferDevicePointer(), but returns a pointer to
+   * the first pixel of @ref sceneRectangle() for @p sceneId. Consecutive rows
+   * of the scene are @ref Magnum::Math::Vector2::x() "x()" of
+   * @ref framebufferSize() pixels apart. Expects that @p sceneId is less than
+   * @ref sceneCount().
+   */
+  const void* objectIdCudaBufferDevicePointer(Magnum::UnsignedInt sceneId);
+
+  /**
+   * @brief Retrieve the point cloud output as a CUDA device pointer
+   *
+   * Expects that @ref RendererStandaloneFlag::PointCloud is set. Copies the
+   * internal framebuffer into a linearized and tightly-packed CUDA buffer of
+   * @ref pointCloudFramebufferFormat() and with size given by the
+   * @ref Magnum::Math::Vector::product() "product()" of
+   * @ref framebufferSize(), and returns its device pointer. The copy is done
+   * only once after each @ref draw(), subsequent calls return the same
+   * pointer.
+   */
+  const void* pointCloudCudaBufferDevicePointer();
+
+  /**
+   * @brief Retrieve the point cloud output of a scene as a CUDA device pointer
+   *
+   * Like @ref pointCloudCudaBufferDevicePointer(), but returns a pointer to
+   * the first pixel of @ref sceneRectangle() for @p sceneId. Consecutive rows
+   * of the scene are @ref Magnum::Math::Vector2::x() "x()" of
+   * @ref framebufferSize() pixels apart. Expects that @p sceneId is less than
+   * @ref sceneCount().
+   */
+  const void* pointCloudCudaBufferDevicePointer(Magnum::UnsignedInt sceneId);
+
+  /**
+   * @brief Make a CUDA stream wait for the CUDA buffers
+   *
+   * The buffers returned by @ref colorCudaBufferDevicePointer(),
+   * @ref depthCudaBufferDevicePointer() and
+   * @ref pointCloudCudaBufferDevicePointer() are ready for use on the legacy
+   * default stream. To consume them on a different @p stream, a
+   * @cpp cudaStream_t @ce, call this function after retrieving the pointers.
+   * It makes the stream wait on a CUDA event without blocking the CPU or any
+   * other stream. Does nothing if no buffer was retrieved yet.
+   */
+  void waitForCudaBuffers(void* stream);
 #endif
 
  private:
@@ -0,0 +1,208 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ShaderCache.h"
+
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx_batch {
+
+namespace {
+
+// bump when the file layout changes
+constexpr Mn::UnsignedInt ShaderCacheVersion = 1;
+
+struct ShaderCacheHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedInt binaryFormat;
+  Mn::UnsignedInt binarySize;
+  // the file name is a hash of the key as well, this one is seeded
+  // differently so a collision of the former doesn't load a wrong program
+  std::size_t keyHash;
+};
+
+struct ShaderCacheState {
+  std::mutex mutex;
+  std::string directory;
+  std::atomic<std::size_t> hits{0};
+  std::atomic<std::size_t> misses{0};
+};
+
+ShaderCacheState& shaderCacheState() {
+  static ShaderCacheState state;
+  return state;
+}
+
+}  // namespace
+
+void setShaderCacheDirectory(const std::string& directory) {
+  ShaderCacheState& state = shaderCacheState();
+  std::lock_guard<std::mutex> lock{state.mutex};
+  state.directory = directory;
+}
+
+std::string shaderCacheDirectory() {
+  ShaderCacheState& state = shaderCacheState();
+  std::lock_guard<std::mutex> lock{state.mutex};
+  return state.directory;
+}
+
+bool isShaderCacheSupported() {
+#if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+  return false;
+#else
+#ifndef MAGNUM_TARGET_GLES
+  if (!Mn::GL::Context::current()
+           .isExtensionSupported<
+               Mn::GL::Extensions::ARB::get_program_binary>()) {
+    return false;
+  }
+#else
+  if (!Mn::GL::Context::current().isVersionSupported(
+          Mn::GL::Version::GLES300)) {
+    return false;
+  }
+#endif
+  // drivers are allowed to support the API without any format to store in
+  GLint formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  return formatCount > 0;
+#endif
+}
+
+ShaderCacheStatistics shaderCacheStatistics() {
+  ShaderCacheState& state = shaderCacheState();
+  ShaderCacheStatistics statistics;
+  statistics.hits = state.hits;
+  statistics.misses = state.misses;
+  return statistics;
+}
+
+bool linkCachedShaderProgram(
+    Mn::GL::AbstractShaderProgram& program,
+    std::initializer_list<Cr::Containers::Reference<Mn::GL::Shader>> shaders,
+    const std::function<bool()>& compileAndLink) {
+  ShaderCacheState& state = shaderCacheState();
+  const std::string directory = shaderCacheDirectory();
+  if (directory.empty() || !isShaderCacheSupported()) {
+    ++state.misses;
+    return compileAndLink();
+  }
+
+#if defined(MAGNUM_TARGET_WEBGL) || defined(MAGNUM_TARGET_GLES2)
+  // not reached, isShaderCacheSupported() is always false there
+  return compileAndLink();
+#else
+  // the driver strings change with driver updates, which may invalidate the
+  // binaries. Sources include the #version line and all defines.
+  Mn::GL::Context& context = Mn::GL::Context::current();
+  std::string key;
+  key += std::string{context.vendorString()};
+  key += '\n';
+  key += std::string{context.rendererString()};
+  key += '\n';
+  key += std::string{context.versionString()};
+  for (Mn::GL::Shader& shader : shaders) {
+    key += Cr::Utility::formatString("\n--- {}\n", GLenum(shader.type()));
+    for (const Cr::Containers::StringView source : shader.sources()) {
+      key += std::string{source};
+    }
+  }
+  const std::string filename = Cr::Utility::Path::join(
+      directory,
+      "program_" + Cr::Utility::MurmurHash2{}(key).hexString() + ".bin");
+  std::size_t keyHash;
+  {
+    const auto digest = Cr::Utility::MurmurHash2{0x5eed}(key);
+    std::memcpy(&keyHash, digest.byteArray(), sizeof(keyHash));
+  }
+
+  const GLuint id = program.id();
+  if (Cr::Utility::Path::exists(filename)) {
+    Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(filename);
+    ShaderCacheHeader header;
+    if (data && data->size() >= sizeof(ShaderCacheHeader)) {
+      std::memcpy(&header, data->data(), sizeof(ShaderCacheHeader));
+      if (std::memcmp(header.magic, "HSPC", 4) == 0 &&
+          header.version == ShaderCacheVersion && header.keyHash == keyHash &&
+          data->size() == sizeof(ShaderCacheHeader) + header.binarySize) {
+        glProgramBinary(id, header.binaryFormat,
+                        data->data() + sizeof(ShaderCacheHeader),
+                        header.binarySize);
+        GLint linked = GL_FALSE;
+        glGetProgramiv(id, GL_LINK_STATUS, &linked);
+        if (linked == GL_TRUE) {
+          ++state.hits;
+          return true;
+        }
+      }
+    }
+    // stale or corrupted, overwritten below
+  }
+
+  ++state.misses;
+  glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  if (!compileAndLink()) {
+    return false;
+  }
+
+  GLint binarySize = 0;
+  glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+  if (binarySize <= 0) {
+    return true;
+  }
+  std::string data(sizeof(ShaderCacheHeader) + binarySize, '\0');
+  ShaderCacheHeader header{{'H', 'S', 'P', 'C'}, ShaderCacheVersion, 0, 0,
+                           keyHash};
+  GLsizei written = 0;
+  GLenum binaryFormat = 0;
+  glGetProgramBinary(id, binarySize, &written, &binaryFormat,
+                     &data[sizeof(ShaderCacheHeader)]);
+  if (written <= 0) {
+    return true;
+  }
+  header.binaryFormat = binaryFormat;
+  header.binarySize = Mn::UnsignedInt(written);
+  std::memcpy(&data[0], &header, sizeof(ShaderCacheHeader));
+  data.resize(sizeof(ShaderCacheHeader) + written);
+
+  // thousands of processes may link the same program at once, so each writes
+  // its own file and only moves it in place once it's complete. Failing to
+  // cache isn't fatal.
+  const std::string tmpFilename =
+      Cr::Utility::formatString("{}.{}.tmp", filename, ::getpid());
+  if (Cr::Utility::Path::make(directory) &&
+      Cr::Utility::Path::write(
+          tmpFilename,
+          Cr::Containers::ArrayView<const char>{data.data(), data.size()})) {
+    Cr::Utility::Path::move(tmpFilename, filename);
+  }
+  return true;
+#endif
+}  // linkCachedShaderProgram
+
+}  // namespace gfx_batch
+}  // namespace esp
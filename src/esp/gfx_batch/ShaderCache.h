@@ -0,0 +1,76 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_BATCH_SHADERCACHE_H_
+#define ESP_GFX_BATCH_SHADERCACHE_H_
+
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/GL.h>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <string>
+
+namespace esp {
+namespace gfx_batch {
+
+/**
+@brief Set the directory linked shader programs are cached in
+
+Programs linked through @ref linkCachedShaderProgram() are stored there as
+driver-specific binaries and loaded instead of compiled the next time the same
+sources are linked on the same driver, in this or any other process. The
+directory is created on first write. An empty string, which is the default,
+disables the cache. The setting is process-wide.
+*/
+void setShaderCacheDirectory(const std::string& directory);
+
+/** @brief Directory linked shader programs are cached in */
+std::string shaderCacheDirectory();
+
+/**
+@brief Whether the current GL context can load and retrieve program binaries
+
+Needs OpenGL 4.1, @gl_extension{ARB,get_program_binary} or OpenGL ES 3.0 and a
+driver exposing at least one binary format. Never the case on WebGL.
+*/
+bool isShaderCacheSupported();
+
+/** @brief Shader cache use since the start of the process */
+struct ShaderCacheStatistics {
+  /** @brief Programs loaded from the cache */
+  std::size_t hits = 0;
+  /** @brief Programs compiled, either not cached or with a stale binary */
+  std::size_t misses = 0;
+};
+
+/** @brief Shader cache use since the start of the process */
+ShaderCacheStatistics shaderCacheStatistics();
+
+/**
+@brief Link a shader program, going through the on-disk cache
+@param program          Program to link
+@param shaders          Shaders with all sources added, not compiled yet
+@param compileAndLink   Compiles @p shaders, attaches them to @p program and
+    links it, returning whether all of that succeeded
+
+The cache key is made of the GL vendor, renderer and version strings and the
+type and sources of each of @p shaders, so defines affecting a variant and
+driver updates are accounted for. If a binary for the key exists and the
+driver accepts it, @p compileAndLink is not called. Otherwise, or if the cache
+is disabled or not supported, it is and the resulting binary is stored.
+Attribute and fragment output locations bound before linking as well as
+explicit locations in the sources are part of the binary, uniforms have to be
+set after this function as usual.
+*/
+bool linkCachedShaderProgram(
+    Magnum::GL::AbstractShaderProgram& program,
+    std::initializer_list<Corrade::Containers::Reference<Magnum::GL::Shader>>
+        shaders,
+    const std::function<bool()>& compileAndLink);
+
+}  // namespace gfx_batch
+}  // namespace esp
+
+#endif  // ESP_GFX_BATCH_SHADERCACHE_H_
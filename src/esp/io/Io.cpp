@@ -3,12 +3,25 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "Io.h"
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
+#include <dirent.h>
+#include <fnmatch.h>
 #include <glob.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 
 namespace Cr = Corrade;
 namespace esp {
@@ -46,7 +59,147 @@ std::string normalizePath(const std::string& srcPath) {
   return normalizePath(filteredPath);
 }  // normalizePath
 
+namespace {
+
+enum class PathType { Missing, File, Directory };
+
+//! Entries of a directory with whether each is a directory, sorted by name
+struct DirectoryListing {
+  std::vector<std::pair<std::string, bool>> entries;
+};
+
+struct PathCache {
+  std::atomic<bool> enabled{false};
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<const DirectoryListing>>
+      listings;
+};
+
+PathCache& pathCache() {
+  static PathCache cache;
+  return cache;
+}
+
+std::shared_ptr<const DirectoryListing> readDirectory(
+    const std::string& directory) {
+  auto listing = std::make_shared<DirectoryListing>();
+  DIR* dir = opendir(directory.empty() ? "." : directory.c_str());
+  if (!dir) {
+    return listing;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    bool isDir = entry->d_type == DT_DIR;
+    // some filesystems don't report the type, and links are followed like
+    // Path::exists() does, skipping dangling ones
+    if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+      struct stat st {};
+      if (stat(Cr::Utility::Path::join(directory, name).c_str(), &st) != 0) {
+        continue;
+      }
+      isDir = S_ISDIR(st.st_mode);
+    }
+    listing->entries.emplace_back(name, isDir);
+  }
+  closedir(dir);
+  std::sort(listing->entries.begin(), listing->entries.end());
+  return listing;
+}
+
+std::shared_ptr<const DirectoryListing> cachedListing(
+    const std::string& directory) {
+  PathCache& cache = pathCache();
+  {
+    std::lock_guard<std::mutex> lock{cache.mutex};
+    auto found = cache.listings.find(directory);
+    if (found != cache.listings.end()) {
+      return found->second;
+    }
+  }
+  // listed without the lock, if another thread was faster its listing wins
+  std::shared_ptr<const DirectoryListing> listing = readDirectory(directory);
+  std::lock_guard<std::mutex> lock{cache.mutex};
+  return cache.listings.emplace(directory, std::move(listing)).first->second;
+}
+
+std::string withoutTrailingSlashes(std::string path) {
+  while (path.size() > 1 && path.back() == '/') {
+    path.pop_back();
+  }
+  return path;
+}
+
+PathType getPathType(const std::string& path) {
+  const std::string stripped = withoutTrailingSlashes(path);
+  const auto split = Cr::Utility::Path::split(stripped);
+  const std::string name = split.second();
+  // the root and relative components aren't in any listing
+  if (!isPathCacheEnabled() || name.empty() || name == "." || name == "..") {
+    if (Cr::Utility::Path::isDirectory(path)) {
+      return PathType::Directory;
+    }
+    return Cr::Utility::Path::exists(path) ? PathType::File
+                                           : PathType::Missing;
+  }
+  const std::shared_ptr<const DirectoryListing> listing =
+      cachedListing(split.first());
+  const auto found = std::lower_bound(
+      listing->entries.begin(), listing->entries.end(), name,
+      [](const std::pair<std::string, bool>& entry, const std::string& name) {
+        return entry.first < name;
+      });
+  if (found == listing->entries.end() || found->first != name) {
+    return PathType::Missing;
+  }
+  return found->second ? PathType::Directory : PathType::File;
+}
+
+std::vector<std::string> globCached(const std::string& pattern) {
+  std::vector<std::string> matches{
+      !pattern.empty() && pattern[0] == '/' ? "/" : ""};
+  const std::vector<std::string> components =
+      Cr::Utility::String::splitWithoutEmptyParts(pattern, '/');
+  for (std::size_t i = 0; i != components.size(); ++i) {
+    const std::string& component = components[i];
+    const bool last = i + 1 == components.size();
+    std::vector<std::string> next;
+    for (const std::string& base : matches) {
+      if (component.find_first_of("*?[") == std::string::npos) {
+        next.push_back(Cr::Utility::Path::join(base, component));
+        continue;
+      }
+      for (const auto& entry : cachedListing(base)->entries) {
+        // only directories can have further components
+        if ((last || entry.second) &&
+            fnmatch(component.c_str(), entry.first.c_str(), FNM_PERIOD) == 0) {
+          next.push_back(Cr::Utility::Path::join(base, entry.first));
+        }
+      }
+    }
+    matches = std::move(next);
+  }
+
+  // components without wildcards aren't checked while matching
+  std::vector<std::string> ret;
+  for (const std::string& match : matches) {
+    const PathType type = getPathType(match);
+    if (type != PathType::Missing) {
+      ret.push_back(type == PathType::Directory ? match + '/' : match);
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+}  // namespace
+
 std::vector<std::string> globDirs(const std::string& pattern) {
+  if (isPathCacheEnabled()) {
+    return globCached(pattern);
+  }
   // Check for ellipsis, if so process here.
   glob_t glob_result;
 
@@ -59,5 +212,62 @@ std::vector<std::string> globDirs(const std::string& pattern) {
   return ret;
 }
 
+void setPathCacheEnabled(bool enabled) {
+  pathCache().enabled = enabled;
+  if (!enabled) {
+    clearPathCache();
+  }
+}
+
+bool isPathCacheEnabled() {
+  return pathCache().enabled;
+}
+
+void clearPathCache() {
+  PathCache& cache = pathCache();
+  std::lock_guard<std::mutex> lock{cache.mutex};
+  cache.listings.clear();
+}
+
+void invalidatePathCache(const std::string& path) {
+  PathCache& cache = pathCache();
+  const std::string directory =
+      Cr::Utility::Path::split(withoutTrailingSlashes(path)).first();
+  std::lock_guard<std::mutex> lock{cache.mutex};
+  cache.listings.erase(directory);
+}
+
+bool pathExists(const std::string& path) {
+  return getPathType(path) != PathType::Missing;
+}
+
+bool isDirectory(const std::string& path) {
+  return getPathType(path) == PathType::Directory;
+}
+
+std::vector<std::string> listDirectory(const std::string& path) {
+  std::vector<std::string> names;
+  if (!isPathCacheEnabled()) {
+    Cr::Containers::Optional<Cr::Containers::Array<Cr::Containers::String>>
+        list = Cr::Utility::Path::list(
+            path, Cr::Utility::Path::ListFlag::SortAscending |
+                      Cr::Utility::Path::ListFlag::SkipDotAndDotDot);
+    if (list) {
+      for (const Cr::Containers::String& name : *list) {
+        names.emplace_back(name);
+      }
+    }
+    return names;
+  }
+  if (!isDirectory(path)) {
+    return names;
+  }
+  for (const auto& entry :
+       cachedListing(withoutTrailingSlashes(path))->entries) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
 }  // namespace io
 }  // namespace esp
@@ -36,9 +36,61 @@ std::string normalizePath(const std::string& srcPath);
  * files and directories that match the pattern.
  * @param pattern The pattern to match
  * @return a vector of the fully-qualified paths that match the pattern.
+ * Directories end with a slash.
+ *
+ * If the path cache is enabled, wildcards are matched against cached
+ * directory listings, see @ref setPathCacheEnabled().
  */
 std::vector<std::string> globDirs(const std::string& pattern);
 
+/**
+ * @brief Enable or disable answering @ref pathExists(), @ref isDirectory(),
+ * @ref listDirectory() and @ref globDirs() from cached directory listings.
+ *
+ * Each directory is listed once, with the type of every entry, instead of
+ * querying the filesystem for every path in it, which is much faster on
+ * network filesystems where each query is a round trip. The cache is
+ * process-wide and disabled by default. Files created or removed after their
+ * directory was listed aren't seen until @ref clearPathCache() or
+ * @ref invalidatePathCache() is called, except for those written with
+ * @ref writeJsonToFile().
+ */
+void setPathCacheEnabled(bool enabled);
+
+/** @brief Whether the path cache is enabled */
+bool isPathCacheEnabled();
+
+/** @brief Drop all cached directory listings */
+void clearPathCache();
+
+/**
+ * @brief Drop the cached listing of the directory containing @p path, e.g.
+ * after creating or removing @p path
+ */
+void invalidatePathCache(const std::string& path);
+
+/**
+ * @brief Whether the file or directory @p path exists
+ *
+ * Same as @ref Corrade::Utility::Path::exists(), but answered from the
+ * listing of its parent directory if the path cache is enabled.
+ */
+bool pathExists(const std::string& path);
+
+/**
+ * @brief Whether @p path is a directory
+ *
+ * Same as @ref Corrade::Utility::Path::isDirectory(), but answered from the
+ * listing of its parent directory if the path cache is enabled.
+ */
+bool isDirectory(const std::string& path);
+
+/**
+ * @brief Names of the entries of directory @p path, sorted, without `.` and
+ * `..`. Empty if @p path isn't a directory.
+ */
+std::vector<std::string> listDirectory(const std::string& path);
+
 }  // namespace io
 }  // namespace esp
 
@@ -3,9 +3,13 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "esp/io/Json.h"
+#include "esp/io/Io.h"
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Containers.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <rapidjson/filereadstream.h>
 #include <rapidjson/filewritestream.h>
@@ -13,9 +17,14 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include "esp/core/Configuration.h"
+#include "esp/io/JsonFileSnapshot.h"
 
 #include "esp/core/Esp.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 namespace Cr = Corrade;
 
 namespace esp {
@@ -54,17 +63,29 @@ bool writeJsonToFile(const JsonDocument& document,
     writeSuccess = document.Accept(writer);
   }
   fclose(f);
+  invalidatePathCache(outFilePath);
 
   return writeSuccess;
 }
 
 JsonDocument parseJsonFile(const std::string& file) {
-  FILE* pFile = fopen(file.c_str(), "rb");
-  char buffer[65536];
-  rapidjson::FileReadStream is(pFile, buffer, sizeof(buffer));
   JsonDocument d;
-  d.ParseStream<0, rapidjson::UTF8<>, rapidjson::FileReadStream>(is);
-  fclose(pFile);
+  {
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+    Cr::Containers::Optional<
+        Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+        data = Cr::Utility::Path::mapRead(file);
+#else
+    Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(file);
+#endif
+    if (!data) {
+      ESP_ERROR() << "Unable to read" << file;
+      throw std::runtime_error("JSON read error");
+    }
+    // strings are copied into the document, so the data can go right after
+    d.Parse(data->data(), data->size());
+  }
 
   if (d.HasParseError()) {
     ESP_ERROR() << "Parse error reading" << file << "Error code"
@@ -74,6 +95,74 @@ JsonDocument parseJsonFile(const std::string& file) {
   return d;
 }
 
+std::vector<std::unique_ptr<JsonDocument>> parseJsonFiles(
+    const std::vector<std::string>& files,
+    JsonFileSnapshot* snapshot) {
+  std::vector<std::unique_ptr<JsonDocument>> docs(files.size());
+  // contents of the files that had to be read, to be stored in the snapshot
+  std::vector<std::string> readContents(snapshot ? files.size() : 0);
+  std::vector<JsonFileSnapshot::Stamp> stamps(readContents.size());
+  std::vector<char> fromSnapshot(readContents.size());
+  std::atomic<std::size_t> nextFile{0};
+  const auto parseFiles = [&]() {
+    char buffer[65536];
+    for (std::size_t i; (i = nextFile++) < files.size();) {
+      auto doc = std::make_unique<JsonDocument>();
+      if (!snapshot) {
+        FILE* pFile = fopen(files[i].c_str(), "rb");
+        if (!pFile) {
+          continue;
+        }
+        rapidjson::FileReadStream is(pFile, buffer, sizeof(buffer));
+        doc->ParseStream<0, rapidjson::UTF8<>, rapidjson::FileReadStream>(is);
+        fclose(pFile);
+      } else {
+        stamps[i] = JsonFileSnapshot::stamp(files[i]);
+        const std::string* contents = snapshot->find(files[i], stamps[i]);
+        if (contents) {
+          fromSnapshot[i] = true;
+        } else {
+          FILE* pFile = fopen(files[i].c_str(), "rb");
+          if (!pFile) {
+            continue;
+          }
+          for (std::size_t size;
+               (size = fread(buffer, 1, sizeof(buffer), pFile)) > 0;) {
+            readContents[i].append(buffer, size);
+          }
+          fclose(pFile);
+          contents = &readContents[i];
+        }
+        doc->Parse(contents->data(), contents->size());
+      }
+      if (!doc->HasParseError()) {
+        docs[i] = std::move(doc);
+      }
+    }
+  };
+
+  const std::size_t numThreads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), files.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back(parseFiles);
+  }
+  parseFiles();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  // only valid documents are worth keeping
+  for (std::size_t i = 0; i < readContents.size(); ++i) {
+    if (fromSnapshot[i]) {
+      snapshot->markUsed(files[i]);
+    } else if (docs[i]) {
+      snapshot->update(files[i], stamps[i], std::move(readContents[i]));
+    }
+  }
+  return docs;
+}
+
 JsonDocument parseJsonString(const std::string& jsonString) {
   JsonDocument d;
   d.Parse(jsonString.c_str());
@@ -86,6 +175,18 @@ JsonDocument parseJsonString(const std::string& jsonString) {
   return d;
 }
 
+JsonDocument parseJsonInsitu(char* buffer) {
+  JsonDocument d;
+  d.ParseInsitu(buffer);
+
+  if (d.HasParseError()) {
+    ESP_ERROR() << "Parse error parsing json in place. Error code"
+                << d.GetParseError() << "at" << d.GetErrorOffset();
+    throw std::runtime_error("JSON parse error");
+  }
+  return d;
+}
+
 std::string jsonToString(const JsonDocument& d, int maxDecimalPlaces) {
   rapidjson::StringBuffer buffer{};
   rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
@@ -11,6 +11,7 @@
 #define RAPIDJSON_NO_INT64DEFINE
 #include <rapidjson/document.h>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include "esp/core/Esp.h"
@@ -24,6 +25,8 @@ namespace io {
 
 typedef rapidjson::Document JsonDocument;
 
+class JsonFileSnapshot;
+
 /**
  * @brief Write a Json doc to file
  *
@@ -41,12 +44,43 @@ bool writeJsonToFile(const JsonDocument& document,
                      bool usePrettyWriter = true,
                      int maxDecimalPlaces = -1);
 
-//! Parse JSON file and return as JsonDocument object
+/**
+ * @brief Parse JSON file and return as JsonDocument object
+ *
+ * The file is memory-mapped where possible and parsed straight from the
+ * mapping. Throws if it can't be read or parsed.
+ */
 JsonDocument parseJsonFile(const std::string& file);
 
+/**
+ * @brief Parse many JSON files at once, spread over all hardware threads.
+ *
+ * Nothing is logged; the document of a file that can't be opened or parsed is
+ * left as @cpp nullptr @ce, so the caller can report it.
+ * @param files The files to parse
+ * @param snapshot If not @cpp nullptr @ce, files unchanged since they were
+ * stored in it are parsed from there instead of being read, and the rest is
+ * stored in it after reading.
+ * @return The parsed documents, in the order of @p files
+ */
+std::vector<std::unique_ptr<JsonDocument>> parseJsonFiles(
+    const std::vector<std::string>& files,
+    JsonFileSnapshot* snapshot = nullptr);
+
 //! Parse JSON string and return as JsonDocument object
 JsonDocument parseJsonString(const std::string& jsonString);
 
+/**
+ * @brief Parse the null-terminated JSON in @p buffer in place
+ *
+ * Faster than @ref parseJsonString() for large documents that are only read
+ * once, e.g. replay files, as strings aren't copied out of @p buffer. The
+ * buffer gets overwritten in the process, and strings in the returned
+ * document point into it, so it has to outlive the document. Throws if
+ * @p buffer can't be parsed.
+ */
+JsonDocument parseJsonInsitu(char* buffer);
+
 //! Return string representation of given JsonDocument
 std::string jsonToString(const JsonDocument& d, int maxDecimalPlaces = -1);
 
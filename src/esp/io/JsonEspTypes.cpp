@@ -55,13 +55,16 @@ JsonGenericValue toJsonValue(const gfx::replay::Keyframe& keyframe,
       JsonGenericValue rigObj(rapidjson::kObjectType);
       io::addMember(rigObj, "id", rig.id, allocator);
       JsonGenericValue poseArray(rapidjson::kArrayType);
-      for (const auto& bone : rig.pose) {
+      for (std::size_t i = 0; i != rig.pose.boneCount(); ++i) {
         JsonGenericValue boneObj(rapidjson::kObjectType);
-        io::addMember(boneObj, "t", bone.translation, allocator);
-        io::addMember(boneObj, "r", bone.rotation, allocator);
+        io::addMember(boneObj, "t", rig.pose.translations[i], allocator);
+        io::addMember(boneObj, "r", rig.pose.rotations[i], allocator);
         poseArray.PushBack(boneObj, allocator);
       }
       io::addMember(rigObj, "pose", poseArray, allocator);
+      if (rig.isPartial()) {
+        io::addMember(rigObj, "changedBones", rig.changedBones, allocator);
+      }
       rigUpdatesArray.PushBack(rigObj, allocator);
     }
     io::addMember(obj, "rigUpdates", rigUpdatesArray, allocator);
@@ -142,14 +145,17 @@ bool fromJsonValue(const JsonGenericValue& obj,
       itr = rigObj.FindMember("pose");
       if (itr != rigObj.MemberEnd()) {
         const JsonGenericValue& poseArray = itr->value;
-        rigUpdate.pose.reserve(poseArray.Size());
+        rigUpdate.pose.translations.reserve(poseArray.Size());
+        rigUpdate.pose.rotations.reserve(poseArray.Size());
         for (const auto& boneObj : poseArray.GetArray()) {
           gfx::replay::Transform transform;
           io::readMember(boneObj, "t", transform.translation);
           io::readMember(boneObj, "r", transform.rotation);
-          rigUpdate.pose.emplace_back(transform);
+          rigUpdate.pose.translations.push_back(transform.translation);
+          rigUpdate.pose.rotations.push_back(transform.rotation);
         }
       }
+      io::readMember(rigObj, "changedBones", rigUpdate.changedBones);
       keyframe.rigUpdates.emplace_back(std::move(rigUpdate));
     }
   }
@@ -278,6 +284,7 @@ JsonGenericValue toJsonValue(const esp::nav::NavMeshSettings& x,
   addMember(obj, "filterLedgeSpans", x.filterLedgeSpans, allocator);
   addMember(obj, "filterWalkableLowHeightSpans", x.filterWalkableLowHeightSpans,
             allocator);
+  addMember(obj, "tileSize", x.tileSize, allocator);
 
   return obj;
 }
@@ -300,6 +307,7 @@ bool fromJsonValue(const JsonGenericValue& obj, esp::nav::NavMeshSettings& x) {
   readMember(obj, "filterLedgeSpans", x.filterLedgeSpans);
   readMember(obj, "filterWalkableLowHeightSpans",
              x.filterWalkableLowHeightSpans);
+  readMember(obj, "tileSize", x.tileSize);
 
   return true;
 }
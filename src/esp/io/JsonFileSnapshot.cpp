@@ -0,0 +1,177 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "JsonFileSnapshot.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace io {
+
+namespace {
+
+/* Bump whenever the layout below changes, so stale snapshots aren't used */
+constexpr std::uint32_t snapshotVersion = 1;
+constexpr char snapshotMagic[4]{'H', 'S', 'J', 'S'};
+
+struct SnapshotHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t entryCount;
+};
+
+// followed by the file name and then the contents
+struct SnapshotEntry {
+  std::uint64_t mtime;
+  std::uint64_t size;
+  std::uint64_t nameSize;
+  std::uint64_t contentsSize;
+};
+
+}  // namespace
+
+std::string JsonFileSnapshot::getSnapshotFilename(
+    const std::string& sourceFilename) {
+  return Cr::Utility::formatString("{}.snapshot", sourceFilename);
+}
+
+JsonFileSnapshot::Stamp JsonFileSnapshot::stamp(const std::string& file) {
+  Stamp stamp;
+  struct stat st {};
+  if (::stat(file.c_str(), &st) == 0) {
+#ifdef __APPLE__
+    const struct timespec& mtime = st.st_mtimespec;
+#else
+    const struct timespec& mtime = st.st_mtim;
+#endif
+    stamp.mtime = std::uint64_t(mtime.tv_sec) * 1000000000ull +
+                  std::uint64_t(mtime.tv_nsec);
+    stamp.size = st.st_size;
+  }
+  return stamp;
+}
+
+JsonFileSnapshot::JsonFileSnapshot(std::string filename)
+    : filename_{std::move(filename)} {
+  if (!Cr::Utility::Path::exists(filename_)) {
+    return;
+  }
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename_);
+  if (!data || data->size() < sizeof(SnapshotHeader)) {
+    return;
+  }
+  SnapshotHeader header;
+  std::memcpy(&header, data->data(), sizeof(SnapshotHeader));
+  if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) ||
+      header.version != snapshotVersion) {
+    return;
+  }
+
+  std::size_t offset = sizeof(SnapshotHeader);
+  for (std::uint64_t i = 0; i != header.entryCount; ++i) {
+    SnapshotEntry entry;
+    if (data->size() - offset < sizeof(SnapshotEntry)) {
+      entries_.clear();
+      return;
+    }
+    std::memcpy(&entry, data->data() + offset, sizeof(SnapshotEntry));
+    offset += sizeof(SnapshotEntry);
+    if (data->size() - offset < entry.nameSize ||
+        data->size() - offset - entry.nameSize < entry.contentsSize) {
+      entries_.clear();
+      return;
+    }
+    std::string name{data->data() + offset, std::size_t(entry.nameSize)};
+    offset += entry.nameSize;
+    Entry& stored = entries_[std::move(name)];
+    stored.stamp = {entry.mtime, entry.size};
+    stored.contents.assign(data->data() + offset,
+                           std::size_t(entry.contentsSize));
+    offset += entry.contentsSize;
+  }
+}  // JsonFileSnapshot::JsonFileSnapshot
+
+const std::string* JsonFileSnapshot::find(const std::string& file,
+                                          const Stamp& stamp) const {
+  auto entryIter = entries_.find(file);
+  if (entryIter == entries_.end() || stamp.mtime == 0 ||
+      entryIter->second.stamp.mtime != stamp.mtime ||
+      entryIter->second.stamp.size != stamp.size) {
+    return nullptr;
+  }
+  return &entryIter->second.contents;
+}
+
+void JsonFileSnapshot::update(const std::string& file,
+                              const Stamp& stamp,
+                              std::string contents) {
+  Entry& entry = entries_[file];
+  entry.stamp = stamp;
+  entry.contents = std::move(contents);
+  entry.used = true;
+  dirty_ = true;
+}
+
+void JsonFileSnapshot::markUsed(const std::string& file) {
+  auto entryIter = entries_.find(file);
+  if (entryIter != entries_.end()) {
+    entryIter->second.used = true;
+  }
+}
+
+bool JsonFileSnapshot::save() {
+  for (auto iter = entries_.begin(); iter != entries_.end();) {
+    if (!iter->second.used) {
+      iter = entries_.erase(iter);
+      dirty_ = true;
+    } else {
+      ++iter;
+    }
+  }
+  if (!dirty_) {
+    return true;
+  }
+
+  SnapshotHeader header{};
+  std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+  header.version = snapshotVersion;
+  header.entryCount = entries_.size();
+  std::string data{reinterpret_cast<const char*>(&header),
+                   sizeof(SnapshotHeader)};
+  for (const auto& entry : entries_) {
+    const SnapshotEntry stored{entry.second.stamp.mtime,
+                               entry.second.stamp.size, entry.first.size(),
+                               entry.second.contents.size()};
+    data.append(reinterpret_cast<const char*>(&stored),
+                sizeof(SnapshotEntry));
+    data += entry.first;
+    data += entry.second.contents;
+  }
+
+  // many processes may start against the same dataset at once, so each writes
+  // its own file and only moves it in place once it's complete
+  const std::string tmpFilename =
+      Cr::Utility::formatString("{}.{}.tmp", filename_, ::getpid());
+  if (!Cr::Utility::Path::write(
+          tmpFilename,
+          Cr::Containers::ArrayView<const char>{data.data(), data.size()}) ||
+      !Cr::Utility::Path::move(tmpFilename, filename_)) {
+    return false;
+  }
+  dirty_ = false;
+  return true;
+}  // JsonFileSnapshot::save
+
+}  // namespace io
+}  // namespace esp
@@ -0,0 +1,99 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_IO_JSONFILESNAPSHOT_H_
+#define ESP_IO_JSONFILESNAPSHOT_H_
+
+/** @file
+ * @brief Class @ref esp::io::JsonFileSnapshot
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace io {
+
+/**
+@brief Contents of a set of JSON files, stored together in a single file
+
+Used to load all config files of a scene dataset with one read instead of
+opening each of them, e.g. when many processes start against the same dataset
+on a network filesystem. Each file is stored along with its modification time
+and size when it was read, and is only used while those still match.
+
+@ref find() may be called from multiple threads at once, all other functions
+may not.
+*/
+class JsonFileSnapshot {
+ public:
+  /** @brief Modification time and size of a file */
+  struct Stamp {
+    //! Modification time in nanoseconds, zero if the file doesn't exist
+    std::uint64_t mtime = 0;
+    //! Size in bytes
+    std::uint64_t size = 0;
+  };
+
+  /**
+   * @brief Name of the snapshot kept for @p sourceFilename, stored alongside
+   * it
+   */
+  static std::string getSnapshotFilename(const std::string& sourceFilename);
+
+  /** @brief Current modification time and size of @p file */
+  static Stamp stamp(const std::string& file);
+
+  /**
+   * @brief Load the snapshot stored in @p filename
+   *
+   * The snapshot starts out empty if the file doesn't exist or can't be
+   * read.
+   */
+  explicit JsonFileSnapshot(std::string filename);
+
+  /**
+   * @brief Contents of @p file, if stored and @p stamp still matches it,
+   * @cpp nullptr @ce otherwise
+   */
+  const std::string* find(const std::string& file, const Stamp& stamp) const;
+
+  /** @brief Store the just read @p contents of @p file */
+  void update(const std::string& file,
+              const Stamp& stamp,
+              std::string contents);
+
+  /** @brief Keep @p file when saving, as it's still used */
+  void markUsed(const std::string& file);
+
+  /**
+   * @brief Write the snapshot back if anything changed since it was loaded
+   *
+   * Files that weren't updated or marked as used since loading are dropped.
+   * Returns @cpp false @ce if the file can't be written.
+   */
+  bool save();
+
+ private:
+  struct Entry {
+    Stamp stamp;
+    std::string contents;
+    bool used = false;
+  };
+
+  std::string filename_;
+  std::unordered_map<std::string, Entry> entries_;
+  bool dirty_ = false;
+
+ public:
+  ESP_SMART_POINTERS(JsonFileSnapshot)
+};
+
+}  // namespace io
+}  // namespace esp
+
+#endif  // ESP_IO_JSONFILESNAPSHOT_H_
@@ -50,6 +50,7 @@ void MetadataMediator::buildAttributesManagers() {
 bool MetadataMediator::setSimulatorConfiguration(
     const sim::SimulatorConfiguration& cfg) {
   simConfig_ = cfg;
+  io::setPathCacheEnabled(simConfig_.cacheDirectoryListings);
 
   // set current active dataset name - if unchanged, does nothing
   ESP_CHECK(setActiveSceneDatasetName(simConfig_.sceneDatasetConfigFile),
@@ -151,9 +152,36 @@ bool MetadataMediator::createSceneDataset(const std::string& sceneDatasetName,
     sceneDatasetAttributesManager_->setLock(sceneDatasetName, false);
   }
   // by here dataset either does not exist or exists but is unlocked and
-  // overwrite is specified. attempt to create new/overwrite
+  // overwrite is specified. attempt to create new/overwrite.
+  // If requested, all config files of the dataset are read through a
+  // snapshot stored next to it.
+  const std::string datasetFilename =
+      Cr::Utility::String::endsWith(sceneDatasetName,
+                                    "scene_dataset_config.json")
+          ? sceneDatasetName
+          : sceneDatasetAttributesManager_->getFormattedJSONFileName(
+                sceneDatasetName);
+  sceneDatasetAttributesManager_->setDeferSceneInstanceLoading(
+      simConfig_.lazySceneInstanceLoading);
+  // see the dataset as it is on disk now
+  io::clearPathCache();
+  io::JsonFileSnapshot::ptr snapshot;
+  if (simConfig_.useDatasetConfigSnapshot &&
+      Cr::Utility::Path::exists(datasetFilename)) {
+    snapshot = io::JsonFileSnapshot::create(
+        io::JsonFileSnapshot::getSnapshotFilename(datasetFilename));
+    sceneDatasetAttributesManager_->setJSONFileSnapshot(snapshot);
+  }
   auto datasetAttribs =
       sceneDatasetAttributesManager_->createObject(sceneDatasetName, true);
+  if (snapshot) {
+    sceneDatasetAttributesManager_->setJSONFileSnapshot(nullptr);
+    if (!snapshot->save()) {
+      ESP_WARNING(Mn::Debug::Flag::NoSpace)
+          << "Unable to save the config snapshot of Scene Dataset `"
+          << sceneDatasetName << "`.";
+    }
+  }
   // Failure here means some catastrophic error attempting to create the dataset
   // attributes. Should fail code
   ESP_CHECK(datasetAttribs,
@@ -345,6 +373,7 @@ MetadataMediator::getSceneInstanceAttributesByName(
       datasetAttr->getStageAttributesManager();
 
   attributes::SceneInstanceAttributes::ptr sceneInstanceAttributes = nullptr;
+  loadDeferredSceneInstance(dsSceneAttrMgr, sceneName);
   // get list of scene attributes handles that contain sceneName as a substring
   auto sceneList = dsSceneAttrMgr->getObjectHandlesBySubstring(sceneName);
   // sceneName can legally match any one of the following conditions :
@@ -363,7 +392,7 @@ MetadataMediator::getSceneInstanceAttributesByName(
     const std::string sceneFilenameCandidate =
         dsSceneAttrMgr->getFormattedJSONFileName(sceneName);
 
-    if (Cr::Utility::Path::exists(sceneFilenameCandidate)) {
+    if (io::pathExists(sceneFilenameCandidate)) {
       // 2. Existing, valid SceneInstanceAttributes file on disk, but not in
       // dataset.
       //    If this is the case, then the SceneInstanceAttributes should be
@@ -542,6 +571,26 @@ MetadataMediator::makeSceneAndReferenceStage(
   return sceneInstanceAttributes;
 }  // MetadataMediator::makeSceneAndReferenceStage
 
+void MetadataMediator::loadDeferredSceneInstance(
+    const managers::SceneInstanceAttributesManager::ptr& dsSceneAttrMgr,
+    const std::string& sceneName) {
+  const std::vector<std::string> deferred =
+      dsSceneAttrMgr->getDeferredTemplateFilenamesBySubstring(sceneName);
+  if (deferred.empty()) {
+    return;
+  }
+  // queries use the first of the sorted candidates, so only that one needs
+  // to be loaded
+  const std::vector<std::string> loaded =
+      dsSceneAttrMgr->getObjectHandlesBySubstring(sceneName);
+  if (loaded.empty() || deferred[0] < loaded[0]) {
+    ESP_DEBUG(Mn::Debug::Flag::NoSpace)
+        << "Loading Scene Instance Attributes `" << deferred[0]
+        << "` of Scene Dataset `" << activeSceneDataset_ << "` on first use.";
+    dsSceneAttrMgr->loadDeferredTemplate(deferred[0]);
+  }
+}  // MetadataMediator::loadDeferredSceneInstance
+
 std::shared_ptr<esp::core::config::Configuration>
 MetadataMediator::getSceneInstanceUserConfiguration(
     const std::string& curSceneName) {
@@ -556,6 +605,7 @@ MetadataMediator::getSceneInstanceUserConfiguration(
   // get scene instance attribute manager
   managers::SceneInstanceAttributesManager::ptr dsSceneAttrMgr =
       datasetAttr->getSceneInstanceAttributesManager();
+  loadDeferredSceneInstance(dsSceneAttrMgr, curSceneName);
   // get list of scene attributes handles that contain sceneName as a substring
   auto sceneList = dsSceneAttrMgr->getObjectHandlesBySubstring(curSceneName);
   // returned list of scene names must not be empty, otherwise display error
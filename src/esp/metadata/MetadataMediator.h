@@ -9,6 +9,8 @@
  * @brief Class @ref esp::metadata::MetadataMediator
  */
 
+#include <algorithm>
+
 #include "esp/core/Configuration.h"
 
 #include "esp/metadata/managers/AOAttributesManager.h"
@@ -260,9 +262,18 @@ class MetadataMediator {
    * dataset
    */
   std::vector<std::string> getAllSceneInstanceHandles() {
-    return getActiveDSAttribs()
-        ->getSceneInstanceAttributesManager()
-        ->getObjectHandlesBySubstring();
+    const auto dsSceneAttrMgr =
+        getActiveDSAttribs()->getSceneInstanceAttributesManager();
+    std::vector<std::string> handles =
+        dsSceneAttrMgr->getObjectHandlesBySubstring();
+    // scene instances not loaded yet are known by their file names
+    const std::vector<std::string> deferred =
+        dsSceneAttrMgr->getDeferredTemplateFilenamesBySubstring();
+    if (!deferred.empty()) {
+      handles.insert(handles.end(), deferred.begin(), deferred.end());
+      std::sort(handles.begin(), handles.end());
+    }
+    return handles;
   }
 
   /**
@@ -608,6 +619,18 @@ class MetadataMediator {
       const managers::SceneInstanceAttributesManager::ptr& dsSceneAttrMgr,
       const std::string& sceneName);
 
+  /**
+   * @brief If the scene instance that a query for @p sceneName would pick
+   * hasn't been loaded yet, because the dataset was loaded with
+   * @ref esp::sim::SimulatorConfiguration::lazySceneInstanceLoading, load it.
+   * @param dsSceneAttrMgr The current dataset's
+   * SceneInstanceAttributesManager
+   * @param sceneName The name of the queried scene instance.
+   */
+  void loadDeferredSceneInstance(
+      const managers::SceneInstanceAttributesManager::ptr& dsSceneAttrMgr,
+      const std::string& sceneName);
+
   /**
    * @brief This function will build the @ref esp::metadata::managers::PhysicsAttributesManager
    * and @ref esp::metadata::managers::SceneDatasetAttributesManager this mediator will manage.
@@ -14,6 +14,7 @@
 #include "Corrade/Containers/Containers.h"
 #include "URDFParser.h"
 #include "esp/core/Logging.h"
+#include "esp/io/Io.h"
 #include "esp/io/Json.h"
 
 #include "tinyxml2/tinyxml2.h"
@@ -103,6 +104,42 @@ void Model::setMassScaling(float massScaling) {
   m_massScaling = massScaling;
 }
 
+std::shared_ptr<Model> Model::clone() const {
+  auto model = std::make_shared<Model>(*this);
+  for (auto& link : model->m_links) {
+    link.second = std::make_shared<Link>(*link.second);
+  }
+  for (auto& joint : model->m_joints) {
+    joint.second = std::make_shared<Joint>(*joint.second);
+  }
+  // point the copied links at the copies of their relatives
+  const auto clonedLink =
+      [&](const std::weak_ptr<Link>& link) -> std::shared_ptr<Link> {
+    const std::shared_ptr<Link> original = link.lock();
+    return original ? model->m_links.at(original->m_name) : nullptr;
+  };
+  const auto clonedJoint =
+      [&](const std::weak_ptr<Joint>& joint) -> std::shared_ptr<Joint> {
+    const std::shared_ptr<Joint> original = joint.lock();
+    return original ? model->m_joints.at(original->m_name) : nullptr;
+  };
+  for (auto& linkEntry : model->m_links) {
+    Link& link = *linkEntry.second;
+    link.m_parentLink = clonedLink(link.m_parentLink);
+    link.m_parentJoint = clonedJoint(link.m_parentJoint);
+    for (auto& childJoint : link.m_childJoints) {
+      childJoint = clonedJoint(childJoint);
+    }
+    for (auto& childLink : link.m_childLinks) {
+      childLink = clonedLink(childLink);
+    }
+  }
+  for (auto& rootLink : model->m_rootLinks) {
+    rootLink = model->m_links.at(rootLink->m_name);
+  }
+  return model;
+}  // Model::clone
+
 bool Parser::parseURDF(const std::string& filename,
                        std::shared_ptr<Model>& urdfModel) {
   // override the previous model with a fresh one
@@ -823,7 +860,7 @@ bool Parser::validateMeshFile(std::string& meshFilename) {
 
   bool meshSuccess = false;
   // defer asset loading to instancing time. Check asset file existence here.
-  meshSuccess = Corrade::Utility::Path::exists(meshFilePath);
+  meshSuccess = io::pathExists(meshFilePath);
 
   if (meshSuccess) {
     // modify the meshFilename to full filepath to enable access into
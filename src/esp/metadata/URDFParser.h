@@ -148,6 +148,10 @@ struct CollisionShape : Shape {
   int m_collisionGroup{0};
   //! custom collision mask
   int m_collisionMask{0};
+  //! vertices of the convex hull of each mesh of a mesh shape, in the frame of
+  //! the mesh asset and without m_meshScale, if precomputed. See @ref
+  //! esp::physics::loadURDFModelBundle.
+  std::vector<std::vector<Magnum::Vector3>> m_convexHulls;
   CollisionShape() = default;
 };
 
@@ -338,6 +342,13 @@ class Model {
 
   Model() = default;
 
+  /**
+   * @brief Deep copy of this model, with its own links and joints linked to
+   * each other the same way. Materials are shared, as they aren't modified
+   * after parsing.
+   */
+  std::shared_ptr<Model> clone() const;
+
   /**
    * @brief Set global scaling and re-scale an existing model. Modifies various
    * internal parameters.
@@ -433,15 +444,6 @@ class Parser {
   bool parseCollision(CollisionShape& collision,
                       const tinyxml2::XMLElement* config);
 
-  /**
-   * @brief Traverse the link->joint kinematic chain to cache parent->child
-   * relationships and detect root/base links.
-   *
-   * @param model The URDF::Model datastructure to manipulate.
-   * @return Success or failure.
-   */
-  bool initTreeAndRoot(const std::shared_ptr<Model>& model) const;
-
   /**
    * @brief Parse URDF material info into a datastructure.
    *
@@ -526,6 +528,16 @@ class Parser {
   // return false if the string is not a valid urdf or other error causes abort
   bool parseURDF(const std::string& filename, std::shared_ptr<Model>& model);
 
+  /**
+   * @brief Traverse the link->joint kinematic chain to cache parent->child
+   * relationships and detect root/base links. Also used to link models read
+   * by @ref esp::physics::loadURDFModelBundle.
+   *
+   * @param model The URDF::Model datastructure to manipulate.
+   * @return Success or failure.
+   */
+  bool initTreeAndRoot(const std::shared_ptr<Model>& model) const;
+
   // This is no longer used, instead set the urdf and physics subsystem to
   // veryverbose, i.e. export HABITAT_SIM_LOG="urdf,physics=veryverbose" bool
   // logMessages = false;
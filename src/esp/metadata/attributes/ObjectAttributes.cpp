@@ -20,6 +20,7 @@ ObjectAttributes::ObjectAttributes(const std::string& handle)
 
   setBoundingBoxCollisions(false);
   setJoinCollisionMeshes(false);
+  setConvexDecompositionMaxHulls(0);
   // default to use material-derived shader unless otherwise specified in config
   // or instance config
   setShaderType(getShaderTypeName(ObjectInstanceShaderType::Material));
@@ -48,6 +49,7 @@ void ObjectAttributes::writeValuesToJsonInternal(
   writeValueToJson("inertia", jsonObj, allocator);
   writeValueToJson("semantic_id", jsonObj, allocator);
   writeValueToJson("join_collision_meshes", jsonObj, allocator);
+  writeValueToJson("convex_decomposition_max_hulls", jsonObj, allocator);
 
 }  // ObjectAttributes::writeValuesToJsonInternal
 
@@ -65,6 +65,16 @@ class ObjectAttributes : public AbstractObjectAttributes {
     return get<bool>("join_collision_meshes");
   }
 
+  // if positive, approximate the collision mesh with at most this many convex
+  // hulls, decomposed once and cached alongside the collision asset. Takes
+  // precedence over join_collision_meshes.
+  void setConvexDecompositionMaxHulls(int maxHulls) {
+    set("convex_decomposition_max_hulls", maxHulls);
+  }
+  int getConvexDecompositionMaxHulls() const {
+    return get<int>("convex_decomposition_max_hulls");
+  }
+
   void setSemanticId(int semanticId) { set("semantic_id", semanticId); }
 
   uint32_t getSemanticId() const { return get<int>("semantic_id"); }
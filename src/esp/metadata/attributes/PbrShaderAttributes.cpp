@@ -14,6 +14,7 @@ PbrShaderAttributes::PbrShaderAttributes(const std::string& handle)
   setEnableIBL(true);
 
   setDirectLightIntensity(3.14f);
+  setClusteredLightingMinLightCount(0);
   setSkipCalcMissingTBN(false);
   setUseMikkelsenTBN(false);
   setUseDirectLightTonemap(false);
@@ -56,6 +57,7 @@ void PbrShaderAttributes::writeValuesToJson(
   writeValueToJson("enable_direct_lights", jsonObj, allocator);
   writeValueToJson("enable_ibl", jsonObj, allocator);
   writeValueToJson("direct_light_intensity", jsonObj, allocator);
+  writeValueToJson("clustered_lighting_min_lights", jsonObj, allocator);
   writeValueToJson("skip_missing_tbn_calc", jsonObj, allocator);
   writeValueToJson("use_mikkelsen_tbn", jsonObj, allocator);
   writeValueToJson("use_direct_tonemap", jsonObj, allocator);
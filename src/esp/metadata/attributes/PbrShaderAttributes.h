@@ -53,6 +53,25 @@ class PbrShaderAttributes : public AbstractAttributes {
     return static_cast<float>(get<double>("direct_light_intensity"));
   }
 
+  /**
+   * @brief Set the number of direct lights from which on each fragment is
+   * only shaded with the lights reaching its cluster of the view, instead of
+   * with all of them. Point lights then have a finite range derived from
+   * their intensity. 0 disables clustered lighting.
+   */
+  void setClusteredLightingMinLightCount(int lightCount) {
+    set("clustered_lighting_min_lights", lightCount);
+  }
+
+  /**
+   * @brief Get the number of direct lights from which on each fragment is
+   * only shaded with the lights reaching its cluster of the view. 0 disables
+   * clustered lighting.
+   */
+  int getClusteredLightingMinLightCount() const {
+    return get<int>("clustered_lighting_min_lights");
+  }
+
   /**
    * @brief Set if we should skip the calculation of a TBN frame in the fragment
    * shader if no precalculated TBN is provided. Without this frame normal
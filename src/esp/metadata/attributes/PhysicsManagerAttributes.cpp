@@ -12,9 +12,21 @@ PhysicsManagerAttributes::PhysicsManagerAttributes(const std::string& handle)
     : AbstractAttributes("PhysicsManagerAttributes", handle) {
   setSimulator("bullet");
   setTimestep(0.008);
+  setMaxSubsteps(0);
   setGravity({0, -9.8, 0});
   setFrictionCoefficient(0.4);
   setRestitutionCoefficient(0.1);
+  setNumThreads(1);
+  setDeterministic(false);
+  setAdaptiveTimestep(false);
+  setAdaptiveMaxTimestep(0.032);
+  setAdaptiveMaxContacts(0);
+  setAdaptiveMaxTravel(0.01);
+  setBroadphase("dbvt");
+  setBroadphaseWorldMin({-1000.0, -1000.0, -1000.0});
+  setBroadphaseWorldMax({1000.0, 1000.0, 1000.0});
+  setCollisionMargin(0.001);
+  setSolverIterations(10);
 }  // PhysicsManagerAttributes ctor
 
 void PhysicsManagerAttributes::writeValuesToJson(
@@ -25,6 +37,18 @@ void PhysicsManagerAttributes::writeValuesToJson(
   writeValueToJson("gravity", jsonObj, allocator);
   writeValueToJson("friction_coefficient", jsonObj, allocator);
   writeValueToJson("restitution_coefficient", jsonObj, allocator);
+  writeValueToJson("num_threads", jsonObj, allocator);
+  writeValueToJson("deterministic", jsonObj, allocator);
+  writeValueToJson("max_substeps", jsonObj, allocator);
+  writeValueToJson("adaptive_timestep", jsonObj, allocator);
+  writeValueToJson("adaptive_max_timestep", jsonObj, allocator);
+  writeValueToJson("adaptive_max_contacts", jsonObj, allocator);
+  writeValueToJson("adaptive_max_travel", jsonObj, allocator);
+  writeValueToJson("broadphase", jsonObj, allocator);
+  writeValueToJson("broadphase_world_min", jsonObj, allocator);
+  writeValueToJson("broadphase_world_max", jsonObj, allocator);
+  writeValueToJson("collision_margin", jsonObj, allocator);
+  writeValueToJson("solver_iterations", jsonObj, allocator);
 }  // PhysicsManagerAttributes::writeValuesToJson
 
 }  // namespace attributes
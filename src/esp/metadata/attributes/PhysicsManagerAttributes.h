@@ -45,14 +45,62 @@ class PhysicsManagerAttributes : public AbstractAttributes {
   double getTimestep() const { return get<double>("timestep"); }
 
   /**
-   * @brief Currently not supported.
+   * @brief Set the maximum number of fixed substeps a single simulation step
+   * may take, bounding its worst case duration. Time beyond the budget is
+   * dropped, so the world time falls behind the requested time. A value of 0
+   * means unlimited.
    */
   void setMaxSubsteps(int maxSubsteps) { set("max_substeps", maxSubsteps); }
   /**
-   * @brief Currently not supported.
+   * @brief Get the maximum number of fixed substeps a single simulation step
+   * may take, 0 if unlimited.
    */
   int getMaxSubsteps() const { return get<int>("max_substeps"); }
 
+  /**
+   * @brief Set whether calm scenes are simulated with substeps longer than
+   * the timestep. Substeps stay multiples of the timestep up to
+   * @ref setAdaptiveMaxTimestep, and fall back to the timestep when there are
+   * more active contact points than @ref setAdaptiveMaxContacts or when an
+   * articulated object is awake.
+   */
+  void setAdaptiveTimestep(bool adaptiveTimestep) {
+    set("adaptive_timestep", adaptiveTimestep);
+  }
+  bool getAdaptiveTimestep() const { return get<bool>("adaptive_timestep"); }
+
+  /**
+   * @brief Set the longest substep the adaptive timestep may take.
+   */
+  void setAdaptiveMaxTimestep(double adaptiveMaxTimestep) {
+    set("adaptive_max_timestep", adaptiveMaxTimestep);
+  }
+  double getAdaptiveMaxTimestep() const {
+    return get<double>("adaptive_max_timestep");
+  }
+
+  /**
+   * @brief Set the number of active contact points above which the adaptive
+   * timestep falls back to the timestep.
+   */
+  void setAdaptiveMaxContacts(int adaptiveMaxContacts) {
+    set("adaptive_max_contacts", adaptiveMaxContacts);
+  }
+  int getAdaptiveMaxContacts() const {
+    return get<int>("adaptive_max_contacts");
+  }
+
+  /**
+   * @brief Set the distance any point of an active object may travel in one
+   * adaptive substep, which shortens substeps as objects speed up.
+   */
+  void setAdaptiveMaxTravel(double adaptiveMaxTravel) {
+    set("adaptive_max_travel", adaptiveMaxTravel);
+  }
+  double getAdaptiveMaxTravel() const {
+    return get<double>("adaptive_max_travel");
+  }
+
   /**
    * @brief Set Simulator-wide gravity.
    */
@@ -73,6 +121,87 @@ class PhysicsManagerAttributes : public AbstractAttributes {
     return get<double>("restitution_coefficient");
   }
 
+  /**
+   * @brief Set the number of threads used for collision detection during
+   * dynamic simulation. A value of 1 steps the simulation on the calling
+   * thread only.
+   */
+  void setNumThreads(int numThreads) { set("num_threads", numThreads); }
+  /**
+   * @brief Get the number of threads used for collision detection during
+   * dynamic simulation.
+   */
+  int getNumThreads() const { return get<int>("num_threads"); }
+
+  /**
+   * @brief Set whether simulation results must not depend on the number of
+   * threads or on thread scheduling. Contact constraints are then solved in
+   * a fixed order, at the cost of sorting them every simulation step.
+   */
+  void setDeterministic(bool deterministic) {
+    set("deterministic", deterministic);
+  }
+  /**
+   * @brief Get whether simulation results must not depend on the number of
+   * threads or on thread scheduling.
+   */
+  bool getDeterministic() const { return get<bool>("deterministic"); }
+
+  /**
+   * @brief Set the broadphase used to find potentially colliding pairs.
+   * Either "dbvt" (dynamic AABB trees, the default) or "sap" (sweep and prune
+   * over the fixed world bounds set with @ref setBroadphaseWorldMin and
+   * @ref setBroadphaseWorldMax).
+   */
+  void setBroadphase(const std::string& broadphase) {
+    set("broadphase", broadphase);
+  }
+  /**
+   * @brief Get the broadphase used to find potentially colliding pairs.
+   */
+  std::string getBroadphase() const { return get<std::string>("broadphase"); }
+
+  /**
+   * @brief Set the minimum corner of the world bounds used by the sweep and
+   * prune broadphase. Objects outside the bounds are still simulated but are
+   * paired less efficiently.
+   */
+  void setBroadphaseWorldMin(const Magnum::Vector3& worldMin) {
+    set("broadphase_world_min", worldMin);
+  }
+  Magnum::Vector3 getBroadphaseWorldMin() const {
+    return get<Magnum::Vector3>("broadphase_world_min");
+  }
+
+  /**
+   * @brief Set the maximum corner of the world bounds used by the sweep and
+   * prune broadphase.
+   */
+  void setBroadphaseWorldMax(const Magnum::Vector3& worldMax) {
+    set("broadphase_world_max", worldMax);
+  }
+  Magnum::Vector3 getBroadphaseWorldMax() const {
+    return get<Magnum::Vector3>("broadphase_world_max");
+  }
+
+  /**
+   * @brief Set the collision margin of articulated object link shapes. Rigid
+   * objects and stages use the margin of their own attributes.
+   */
+  void setCollisionMargin(double collisionMargin) {
+    set("collision_margin", collisionMargin);
+  }
+  double getCollisionMargin() const { return get<double>("collision_margin"); }
+
+  /**
+   * @brief Set the number of constraint solver iterations per simulation
+   * step.
+   */
+  void setSolverIterations(int solverIterations) {
+    set("solver_iterations", solverIterations);
+  }
+  int getSolverIterations() const { return get<int>("solver_iterations"); }
+
   /**
    * @brief Populate a json object with all the first-level values held in this
    * configuration.  Default is overridden to handle special cases for
@@ -89,7 +218,11 @@ class PhysicsManagerAttributes : public AbstractAttributes {
 
   std::string getObjectInfoHeaderInternal() const override {
     return "Simulator Type,Timestep,Max Substeps,Gravity XYZ,Friction "
-           "Coefficient,Restitution Coefficient,";
+           "Coefficient,Restitution Coefficient,Num Threads,Deterministic,"
+           "Adaptive Timestep,Adaptive Max Timestep,Adaptive Max Contacts,"
+           "Adaptive Max Travel,Broadphase,"
+           "Broadphase World Min XYZ,Broadphase World Max XYZ,Collision "
+           "Margin,Solver Iterations,";
   }
 
   /**
@@ -98,10 +231,16 @@ class PhysicsManagerAttributes : public AbstractAttributes {
    */
   std::string getObjectInfoInternal() const override {
     return Cr::Utility::formatString(
-        "{},{},{},{},{},{}", getSimulator(), getAsString("timestep"),
-        getAsString("max_substeps"), getAsString("gravity"),
-        getAsString("friction_coefficient"),
-        getAsString("restitution_coefficient"));
+        "{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}", getSimulator(),
+        getAsString("timestep"), getAsString("max_substeps"),
+        getAsString("gravity"), getAsString("friction_coefficient"),
+        getAsString("restitution_coefficient"), getAsString("num_threads"),
+        getAsString("deterministic"), getAsString("adaptive_timestep"),
+        getAsString("adaptive_max_timestep"),
+        getAsString("adaptive_max_contacts"),
+        getAsString("adaptive_max_travel"), getBroadphase(), getAsString("broadphase_world_min"),
+        getAsString("broadphase_world_max"), getAsString("collision_margin"),
+        getAsString("solver_iterations"));
   }
 
  public:
@@ -36,7 +36,7 @@ void AOAttributesManager::setValsFromJSONDoc(
   if (io::readMember<std::string>(jsonConfig, "urdf_filepath", urdf_filepath)) {
     // If specified urdf_filepath is not found directly, prefix it with file
     // directory where the configuration file was found.
-    if (!Corrade::Utility::Path::exists(urdf_filepath)) {
+    if (!io::pathExists(urdf_filepath)) {
       urdf_filepath =
           Cr::Utility::Path::join(aoAttr->getFileDirectory(), urdf_filepath);
     }
@@ -48,7 +48,7 @@ void AOAttributesManager::setValsFromJSONDoc(
   if (io::readMember<std::string>(jsonConfig, "render_asset", render_asset)) {
     // If specified render_asset is not found directly, prefix it with file
     // directory where the configuration file was found.
-    if (!Corrade::Utility::Path::exists(render_asset)) {
+    if (!io::pathExists(render_asset)) {
       render_asset =
           Cr::Utility::Path::join(aoAttr->getFileDirectory(), render_asset);
     }
@@ -188,7 +188,7 @@ AOAttributesManager::preRegisterObjectFinalize(
         << "` does not specify a valid URDF Filepath, so registration is "
            "aborted.";
     return core::managedContainers::ManagedObjectPreregistration::Failed;
-  } else if (!Cr::Utility::Path::exists(urdfFilePath)) {
+  } else if (!io::pathExists(urdfFilePath)) {
     // URDF File not found is bad
     ESP_ERROR(Mn::Debug::Flag::NoSpace)
         << "ArticulatedObjectAttributes template named `" << AOAttributesHandle
@@ -221,7 +221,7 @@ AOAttributesManager::preRegisterObjectFinalize(
           << "`, but no render asset was specifed in the configuration, so "
              "registration is aborted.";
       return core::managedContainers::ManagedObjectPreregistration::Failed;
-    } else if (!Cr::Utility::Path::exists(renderAssetHandle)) {
+    } else if (!io::pathExists(renderAssetHandle)) {
       // Skin render asset specified not found is bad when 'skin' render mode
       // is specified
       ESP_ERROR(Mn::Debug::Flag::NoSpace)
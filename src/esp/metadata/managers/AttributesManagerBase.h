@@ -69,7 +69,9 @@ class AttributesManager : public ManagedFileBasedContainer<T, Access> {
    * locations.
    *
    * This will take the list of file names specified and load the referenced
-   * templates.  It is assumed these files are JSON files currently.
+   * templates.  It is assumed these files are JSON files currently. The files
+   * are read and parsed in parallel, the templates are then built and
+   * registered in the order of @p tmpltFilenames.
    * @param tmpltFilenames list of file names of templates
    * @param saveAsDefaults Set these templates as un-deletable from library.
    * @return vector holding IDs of templates that have been added
@@ -124,6 +126,22 @@ class AttributesManager : public ManagedFileBasedContainer<T, Access> {
                                                   const std::string& extType,
                                                   bool saveAsDefaults = false);
 
+  /**
+   * @brief Find the @p extType files to load from the provided file or
+   * directory path, as described in @ref loadAllTemplatesFromPathAndExt, and
+   * append them to @p paths.
+   *
+   * @param path A global path to configuration files or a directory containing
+   * such files.
+   * @param extType The extension of files to be attempted to be loaded as
+   * templates.
+   * @param paths The list to append the found file names to.
+   * @return Whether @p path was found as a directory or file.
+   */
+  bool findTemplatePathsFromPathAndExt(const std::string& path,
+                                       const std::string& extType,
+                                       std::vector<std::string>& paths);
+
   /**
    * @brief This builds a list of paths to this type of attributes's JSON Config
    * files from the passed @p jsonPaths array element.  It then will load all
@@ -153,6 +171,48 @@ class AttributesManager : public ManagedFileBasedContainer<T, Access> {
                                         const std::string& extType,
                                         const io::JsonGenericValue& jsonPaths);
 
+  /**
+   * @brief Set whether templates to be saved as defaults, i.e. the ones
+   * listed by a scene dataset, are only indexed by file name when loaded
+   * through @ref loadAllFileBasedTemplates, and built on first request with
+   * @ref loadDeferredTemplate instead.
+   */
+  void setDeferDefaultTemplateLoading(bool defer) {
+    deferDefaultTemplateLoading_ = defer;
+  }
+
+  /**
+   * @brief Whether default templates are only indexed on load, see @ref
+   * setDeferDefaultTemplateLoading.
+   */
+  bool getDeferDefaultTemplateLoading() const {
+    return deferDefaultTemplateLoading_;
+  }
+
+  /**
+   * @brief Get a sorted list of the file names of indexed templates that
+   * haven't been loaded yet which contain, or explicitly do not contain, the
+   * passed @p subStr, ignoring case. Their handles will be the file names
+   * once loaded.
+   * @param subStr substring to search for within the file names.
+   * @param contains whether to search for file names containing, or not
+   * containing, @p subStr
+   */
+  std::vector<std::string> getDeferredTemplateFilenamesBySubstring(
+      const std::string& subStr = "",
+      bool contains = true) const {
+    return this->getObjectHandlesBySubStringPerType(deferredTemplateFiles_,
+                                                    subStr, contains, true);
+  }
+
+  /**
+   * @brief Load and register the indexed template from @p filename as a
+   * default template, if it hasn't been yet.
+   * @return The ID of the template, or @ref ID_UNDEFINED if it wasn't
+   * indexed or failed to load.
+   */
+  int loadDeferredTemplate(const std::string& filename);
+
   /**
    * @brief Parse passed JSON Document for @ref
    * esp::metadata::attributes::AbstractAttributes. It always returns a
@@ -342,6 +402,23 @@ class AttributesManager : public ManagedFileBasedContainer<T, Access> {
       const std::string& srcAssetHandle,
       const std::function<void(const std::string&)>& handleSetter);
 
+  // ======== Instance Variables ========
+
+  /**
+   * @brief Whether default templates are only indexed on load, see @ref
+   * setDeferDefaultTemplateLoading.
+   */
+  bool deferDefaultTemplateLoading_ = false;
+
+  /**
+   * @brief File names of indexed default templates not loaded yet, keyed by
+   * order of indexing.
+   */
+  std::unordered_map<int, std::string> deferredTemplateFiles_;
+
+  /** @brief Key of the next entry of @ref deferredTemplateFiles_ */
+  int nextDeferredTemplateIdx_ = 0;
+
  public:
   ESP_SMART_POINTERS(AttributesManager<T, Access>)
 
@@ -354,10 +431,23 @@ std::vector<int> AttributesManager<T, Access>::loadAllFileBasedTemplates(
     const std::vector<std::string>& paths,
     bool saveAsDefaults) {
   std::vector<int> templateIndices(paths.size(), ID_UNDEFINED);
+  if (saveAsDefaults && deferDefaultTemplateLoading_) {
+    // only index the files, see loadDeferredTemplate()
+    for (const std::string& path : paths) {
+      deferredTemplateFiles_.emplace(nextDeferredTemplateIdx_++, path);
+    }
+    ESP_DEBUG() << "Indexed" << paths.size() << "" << this->objectType_
+                << "templates to load on first use.";
+    return templateIndices;
+  }
   if (paths.size() > 0) {
     std::string dir = Cr::Utility::Path::split(paths[0]).first();
     ESP_DEBUG() << "Loading" << paths.size() << "" << this->objectType_
                 << "templates found in" << dir;
+    // reading and parsing dominates, so do that for all files at once. The
+    // templates themselves are built serially, in order, from the parsed
+    // documents, so registration is deterministic.
+    this->preparseJSONFiles(paths);
     for (int i = 0; i < paths.size(); ++i) {
       auto attributesFilename = paths[i];
       ESP_VERY_VERBOSE()
@@ -375,6 +465,8 @@ std::vector<int> AttributesManager<T, Access>::loadAllFileBasedTemplates(
       }
       templateIndices[i] = tmplt->getID();
     }
+    // drop documents of files that weren't loaded through the JSON path
+    this->preparsedDocs_.clear();
   }
   ESP_DEBUG(Mn::Debug::Flag::NoSpace)
       << "<" << this->objectType_
@@ -382,24 +474,60 @@ std::vector<int> AttributesManager<T, Access>::loadAllFileBasedTemplates(
   return templateIndices;
 }  // AttributesManager<T, Access>::loadAllObjectTemplates
 
+template <class T, ManagedObjectAccess Access>
+int AttributesManager<T, Access>::loadDeferredTemplate(
+    const std::string& filename) {
+  bool found = false;
+  for (auto iter = deferredTemplateFiles_.begin();
+       iter != deferredTemplateFiles_.end();) {
+    if (iter->second == filename) {
+      iter = deferredTemplateFiles_.erase(iter);
+      found = true;
+    } else {
+      ++iter;
+    }
+  }
+  if (!found) {
+    return ID_UNDEFINED;
+  }
+  auto tmplt = this->createObject(filename, true);
+  if (tmplt == nullptr) {
+    return ID_UNDEFINED;
+  }
+  this->undeletableObjectNames_.insert(tmplt->getHandle());
+  return tmplt->getID();
+}  // AttributesManager<T, Access>::loadDeferredTemplate
+
 template <class T, ManagedObjectAccess Access>
 std::vector<int> AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt(
     const std::string& path,
     const std::string& extType,
     bool saveAsDefaults) {
-  namespace Dir = Cr::Utility::Path;
   std::vector<std::string> paths;
-  std::vector<int> templateIndices;
+  if (!this->findTemplatePathsFromPathAndExt(path, extType, paths)) {
+    return {};
+  }
+
+  // build templates from aggregated paths
+  return this->loadAllFileBasedTemplates(paths, saveAsDefaults);
+}  // AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt
+
+template <class T, ManagedObjectAccess Access>
+bool AttributesManager<T, Access>::findTemplatePathsFromPathAndExt(
+    const std::string& path,
+    const std::string& extType,
+    std::vector<std::string>& paths) {
+  namespace Dir = Cr::Utility::Path;
   ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
       << "<" << this->objectType_ << "> : Searching for files at path: `"
       << path << "` with `" << extType << "` files";
   // Check if directory
-  const bool dirExists = Dir::isDirectory(path);
+  const bool dirExists = io::isDirectory(path);
   if (dirExists) {
     ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
         << "Searching " << this->objectType_ << " library directory: `" << path
         << "` for `" << extType << "` files";
-    for (auto& file : *Dir::list(path, Dir::ListFlag::SortAscending)) {
+    for (const std::string& file : io::listDirectory(path)) {
       std::string absoluteSubfilePath = Dir::join(path, file);
       if (Cr::Utility::String::endsWith(absoluteSubfilePath, extType)) {
         paths.push_back(absoluteSubfilePath);
@@ -412,7 +540,7 @@ std::vector<int> AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt(
     // not a directory, perhaps a file
     std::string attributesFilepath =
         this->convertFilenameToPassedExt(path, extType);
-    const bool fileExists = Dir::exists(attributesFilepath);
+    const bool fileExists = io::pathExists(attributesFilepath);
 
     if (fileExists) {
       paths.push_back(attributesFilepath);
@@ -421,15 +549,11 @@ std::vector<int> AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt(
           << "<" << this->objectType_ << "> : Parsing `" << extType
           << "` files : Cannot find `" << path << "` as directory or `"
           << attributesFilepath << "` as config file, so template load failed.";
-      return templateIndices;
+      return false;
     }  // if fileExists else
   }    // if dirExists else
-
-  // build templates from aggregated paths
-  templateIndices = this->loadAllFileBasedTemplates(paths, saveAsDefaults);
-
-  return templateIndices;
-}  // AttributesManager<T, Access>::loadAllTemplatesFromPathAndExt
+  return true;
+}  // AttributesManager<T, Access>::findTemplatePathsFromPathAndExt
 
 template <class T, ManagedObjectAccess Access>
 void AttributesManager<T, Access>::buildAttrSrcPathsFromJSONAndLoad(
@@ -437,6 +561,8 @@ void AttributesManager<T, Access>::buildAttrSrcPathsFromJSONAndLoad(
     const std::string& extType,
     const io::JsonGenericValue& filePaths) {
   std::size_t cfgLastDirLoc = configDir.find_last_of('/');
+  // gather the files of all paths first so they're all parsed in parallel
+  std::vector<std::string> attrSrcPaths;
   for (rapidjson::SizeType i = 0; i < filePaths.Size(); ++i) {
     if (!filePaths[i].IsString()) {
       ESP_WARNING(Mn::Debug::Flag::NoSpace)
@@ -471,7 +597,8 @@ void AttributesManager<T, Access>::buildAttrSrcPathsFromJSONAndLoad(
         ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
             << "<" << this->objectType_ << "> : Glob path result for"
             << dsFilePath << ":" << globPath;
-        this->loadAllTemplatesFromPathAndExt(globPath, extType, true);
+        this->findTemplatePathsFromPathAndExt(globPath, extType,
+                                              attrSrcPaths);
       }
     } else {
       ESP_WARNING(Mn::Debug::Flag::NoSpace)
@@ -479,6 +606,7 @@ void AttributesManager<T, Access>::buildAttrSrcPathsFromJSONAndLoad(
           << dsFilePath << "` so unable to load templates from that path.";
     }
   }
+  this->loadAllFileBasedTemplates(attrSrcPaths, true);
   ESP_DEBUG(Mn::Debug::Flag::NoSpace)
       << "<" << this->objectType_ << "> : " << std::to_string(filePaths.Size())
       << " paths specified in JSON doc for " << this->objectType_
@@ -499,7 +627,7 @@ auto AttributesManager<T, Access>::createFromJsonOrDefaultInternal(
            : this->getFormattedJSONFileName(filename));
   // Check if this configuration file exists and if so use it to build
   // attributes
-  bool jsonFileExists = Cr::Utility::Path::exists(jsonAttrFileName);
+  bool jsonFileExists = io::pathExists(jsonAttrFileName);
   ESP_VERY_VERBOSE(Mn::Debug::Flag::NoSpace)
       << "<" << this->objectType_ << ">: Proposing JSON name `"
       << jsonAttrFileName << "` from original name `" << filename
@@ -516,7 +644,7 @@ auto AttributesManager<T, Access>::createFromJsonOrDefaultInternal(
     // default attributes.
     attrs = this->createDefaultObject(filename, registerObj);
     // check if original filename is an actual object
-    bool fileExists = Cr::Utility::Path::exists(filename);
+    bool fileExists = io::pathExists(filename);
     // if filename passed is name of some kind of asset, or if it was not
     // found
     if (ESP_LOG_LEVEL_ENABLED(logging::LoggingLevel::Debug)) {
@@ -581,7 +709,7 @@ bool AttributesManager<T, Access>::setFilenameFromDefaultTag(
   }
   // First check if tag references a file that already exists on disk and is
   // able to be found
-  if (Cr::Utility::Path::exists(srcAssetFilename)) {
+  if (io::pathExists(srcAssetFilename)) {
     // set filename with verified filepath
     filenameSetter(srcAssetFilename);
     return true;
@@ -594,14 +722,14 @@ bool AttributesManager<T, Access>::setFilenameFromDefaultTag(
     // not.
     tempStr.replace(loc, strlen(CONFIG_NAME_AS_ASSET_FILENAME),
                     attributes->getSimplifiedHandle());
-    if (Cr::Utility::Path::exists(tempStr)) {
+    if (io::pathExists(tempStr)) {
       // replace the component of the string containing the tag with the base
       // filename/handle, and verify it exists. Otherwise, clear it.
       filenameSetter(tempStr);
       return true;
     }
     tempStr = Cr::Utility::Path::join(attributes->getFileDirectory(), tempStr);
-    if (Cr::Utility::Path::exists(tempStr)) {
+    if (io::pathExists(tempStr)) {
       // replace the component of the string containing the tag with the base
       // filename/handle, and verify it exists. Otherwise, clear it.
       filenameSetter(tempStr);
@@ -615,7 +743,7 @@ bool AttributesManager<T, Access>::setFilenameFromDefaultTag(
   // no sentinel tag found - check if existing non-empty field exists.
   std::string tempStr =
       Cr::Utility::Path::join(attributes->getFileDirectory(), srcAssetFilename);
-  if (Cr::Utility::Path::exists(tempStr)) {
+  if (io::pathExists(tempStr)) {
     // path-prefixed filename exists on disk, so set as filename
     filenameSetter(tempStr);
     return true;
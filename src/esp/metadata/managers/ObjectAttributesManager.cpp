@@ -105,6 +105,13 @@ void ObjectAttributesManager::setValsFromJSONDoc(
       [objAttributes](bool join_collision_meshes) {
         objAttributes->setJoinCollisionMeshes(join_collision_meshes);
       });
+  // Decompose the collision mesh into convex hulls if specified
+  io::jsonIntoSetter<int>(
+      jsonConfig, "convex_decomposition_max_hulls",
+      [objAttributes](int convex_decomposition_max_hulls) {
+        objAttributes->setConvexDecompositionMaxHulls(
+            convex_decomposition_max_hulls);
+      });
 
   // The object's interia matrix diagonal
   io::jsonIntoConstSetter<Magnum::Vector3>(
@@ -238,7 +245,7 @@ ObjectAttributesManager::preRegisterObjectFinalize(
     // physicsSynthObjTmpltLibByID_
     objectTemplate->setRenderAssetIsPrimitive(true);
     mapToAddTo_ = &physicsSynthObjTmpltLibByID_;
-  } else if (Cr::Utility::Path::exists(renderAssetHandle)) {
+  } else if (io::pathExists(renderAssetHandle)) {
     // Check if renderAssetHandle is valid file name and is found in file system
     // - if so then setRenderAssetIsPrimitive to false and set map of IDs->Names
     // to physicsFileObjTmpltLibByID_ - verify file  exists
@@ -270,7 +277,7 @@ ObjectAttributesManager::preRegisterObjectFinalize(
     // If collisionAssetHandle corresponds to valid/existing primitive
     // attributes then setCollisionAssetIsPrimitive to true
     objectTemplate->setCollisionAssetIsPrimitive(true);
-  } else if (Cr::Utility::Path::exists(collisionAssetHandle)) {
+  } else if (io::pathExists(collisionAssetHandle)) {
     // Check if collisionAssetHandle is valid file name and is found in file
     // system - if so then setCollisionAssetIsPrimitive to false
     objectTemplate->setCollisionAssetIsPrimitive(false);
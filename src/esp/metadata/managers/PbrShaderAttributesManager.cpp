@@ -46,6 +46,12 @@ void PbrShaderAttributesManager::setValsFromJSONDoc(
       [pbrShaderAttribs](double lightIntensity) {
         pbrShaderAttribs->setDirectLightIntensity(lightIntensity);
       });
+  // number of direct lights from which on they are culled per view cluster
+  io::jsonIntoSetter<int>(
+      jsonConfig, "clustered_lighting_min_lights",
+      [pbrShaderAttribs](int lightCount) {
+        pbrShaderAttribs->setClusteredLightingMinLightCount(lightCount);
+      });
   // whether we use the burley/disney diffuse calculation or lambertian diffuse
   // calculation for direct lighting.
   io::jsonIntoSetter<bool>(
@@ -67,6 +67,74 @@ void PhysicsAttributesManager::setValsFromJSONDoc(
             restitution_coefficient);
       });
 
+  // load the number of collision detection threads
+  io::jsonIntoSetter<int>(
+      jsonConfig, "num_threads", [physicsManagerAttributes](int num_threads) {
+        physicsManagerAttributes->setNumThreads(num_threads);
+      });
+
+  // load whether results must not depend on thread count and scheduling
+  io::jsonIntoSetter<bool>(
+      jsonConfig, "deterministic",
+      [physicsManagerAttributes](bool deterministic) {
+        physicsManagerAttributes->setDeterministic(deterministic);
+      });
+
+  // load the adaptive timestep settings
+  io::jsonIntoSetter<bool>(
+      jsonConfig, "adaptive_timestep",
+      [physicsManagerAttributes](bool adaptive_timestep) {
+        physicsManagerAttributes->setAdaptiveTimestep(adaptive_timestep);
+      });
+  io::jsonIntoSetter<double>(
+      jsonConfig, "adaptive_max_timestep",
+      [physicsManagerAttributes](double adaptive_max_timestep) {
+        physicsManagerAttributes->setAdaptiveMaxTimestep(adaptive_max_timestep);
+      });
+  io::jsonIntoSetter<int>(
+      jsonConfig, "adaptive_max_contacts",
+      [physicsManagerAttributes](int adaptive_max_contacts) {
+        physicsManagerAttributes->setAdaptiveMaxContacts(adaptive_max_contacts);
+      });
+  io::jsonIntoSetter<double>(
+      jsonConfig, "adaptive_max_travel",
+      [physicsManagerAttributes](double adaptive_max_travel) {
+        physicsManagerAttributes->setAdaptiveMaxTravel(adaptive_max_travel);
+      });
+
+  // load the broadphase type
+  io::jsonIntoConstSetter<std::string>(
+      jsonConfig, "broadphase",
+      [physicsManagerAttributes](const std::string& broadphase) {
+        physicsManagerAttributes->setBroadphase(broadphase);
+      });
+
+  // load the sweep and prune broadphase world bounds
+  io::jsonIntoConstSetter<Magnum::Vector3>(
+      jsonConfig, "broadphase_world_min",
+      [physicsManagerAttributes](const Magnum::Vector3& worldMin) {
+        physicsManagerAttributes->setBroadphaseWorldMin(worldMin);
+      });
+  io::jsonIntoConstSetter<Magnum::Vector3>(
+      jsonConfig, "broadphase_world_max",
+      [physicsManagerAttributes](const Magnum::Vector3& worldMax) {
+        physicsManagerAttributes->setBroadphaseWorldMax(worldMax);
+      });
+
+  // load the articulated object collision margin
+  io::jsonIntoSetter<double>(
+      jsonConfig, "collision_margin",
+      [physicsManagerAttributes](double collision_margin) {
+        physicsManagerAttributes->setCollisionMargin(collision_margin);
+      });
+
+  // load the number of constraint solver iterations
+  io::jsonIntoSetter<int>(
+      jsonConfig, "solver_iterations",
+      [physicsManagerAttributes](int solver_iterations) {
+        physicsManagerAttributes->setSolverIterations(solver_iterations);
+      });
+
   // load world gravity
   io::jsonIntoConstSetter<Magnum::Vector3>(
       jsonConfig, "gravity",
@@ -61,6 +61,8 @@ SceneDatasetAttributesManager::initNewObjectInternal(
   newAttributes->setPhysicsManagerHandle(physicsManagerAttributesHandle_);
   newAttributes->setDefaultPbrShaderAttrHandle(
       defaultPbrShaderAttributesHandle_);
+  newAttributes->getSceneInstanceAttributesManager()
+      ->setDeferDefaultTemplateLoading(deferSceneInstanceLoading_);
   // any internal default configuration here
   return newAttributes;
 }  // SceneDatasetAttributesManager::initNewObjectInternal
@@ -137,6 +139,8 @@ void SceneDatasetAttributesManager::readDatasetJSONCell(
     const io::JsonGenericValue& jsonConfig,
     const U& attrMgr,
     std::map<std::string, std::string>* strKeyMap) {
+  // config files of the cell are read through the dataset's snapshot, if any
+  attrMgr->setJSONFileSnapshot(this->jsonFileSnapshot_);
   io::JsonGenericValue::ConstMemberIterator jsonIter =
       jsonConfig.FindMember(tag);
   if (jsonIter != jsonConfig.MemberEnd()) {
@@ -288,6 +292,7 @@ void SceneDatasetAttributesManager::readDatasetJSONCell(
       }  // process unexpected member tags
     }    // if cell is an object
   }      // if cell exists
+  attrMgr->setJSONFileSnapshot(nullptr);
 }  // SceneDatasetAttributesManager::readDatasetJSONCell
 
 void SceneDatasetAttributesManager::validateMap(
@@ -298,9 +303,9 @@ void SceneDatasetAttributesManager::validateMap(
   // dsDir-prepended entry
   for (std::pair<const std::string, std::string>& entry : map) {
     const std::string loc = entry.second;
-    if (!Cr::Utility::Path::exists(loc)) {
+    if (!io::pathExists(loc)) {
       std::string newLoc = Cr::Utility::Path::join(dsDir, loc);
-      if (!Cr::Utility::Path::exists(newLoc)) {
+      if (!io::pathExists(newLoc)) {
         ESP_ERROR(Mn::Debug::Flag::NoSpace)
             << "`" << tag << "` Value : `" << loc
             << "` not found on disk as absolute path or relative to `" << dsDir
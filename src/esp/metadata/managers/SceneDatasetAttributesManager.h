@@ -93,6 +93,15 @@ class SceneDatasetAttributesManager
     }
   }  // SceneDatasetAttributesManager::setDefaultPbrShaderAttributesHandle
 
+  /**
+   * @brief Set whether datasets created from here on only index the files of
+   * their scene instances on load, each being loaded on first request
+   * instead. See @ref AttributesManager::setDeferDefaultTemplateLoading.
+   */
+  void setDeferSceneInstanceLoading(bool defer) {
+    deferSceneInstanceLoading_ = defer;
+  }
+
  protected:
   /**
    * @brief This will validate a loaded dataset map with file location values
@@ -228,6 +237,12 @@ class SceneDatasetAttributesManager
    * @brief Name of currently used default PbrShaderAttributes
    */
   std::string defaultPbrShaderAttributesHandle_ = "";
+
+  /**
+   * @brief Whether new datasets only index their scene instances on load, see
+   * @ref setDeferSceneInstanceLoading
+   */
+  bool deferSceneInstanceLoading_ = false;
   /**
    * @brief Reference to PhysicsAttributesManager to give access to default
    * physics manager attributes settings when
@@ -165,7 +165,7 @@ void SemanticAttributesManager::setValsFromJSONDoc(
     // value (override default).
     // semantic asset filename might already be fully qualified; if
     // not, might just be file name
-    if (!Corrade::Utility::Path::exists(semanticAsset)) {
+    if (!io::pathExists(semanticAsset)) {
       semanticAsset =
           Cr::Utility::Path::join(semanticLocFileDir, semanticAsset);
     }
@@ -180,7 +180,7 @@ void SemanticAttributesManager::setValsFromJSONDoc(
     // (override default).
     // semanticSceneDescriptor filename might already be fully qualified; if
     // not, might just be file name
-    if (!Corrade::Utility::Path::exists(semanticSceneDescriptor)) {
+    if (!io::pathExists(semanticSceneDescriptor)) {
       semanticSceneDescriptor =
           Cr::Utility::Path::join(semanticLocFileDir, semanticSceneDescriptor);
     }
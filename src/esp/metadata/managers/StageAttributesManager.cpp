@@ -69,7 +69,7 @@ StageAttributesManager::preRegisterObjectFinalize(
     // then setRenderAssetIsPrimitive to true and set map of IDs->Names to
     // physicsSynthObjTmpltLibByID_
     stageAttributes->setRenderAssetIsPrimitive(true);
-  } else if (Cr::Utility::Path::exists(renderAssetHandle)) {
+  } else if (io::pathExists(renderAssetHandle)) {
     // Check if renderAssetHandle is valid file name and is found in file
     // system
     // - if so then setRenderAssetIsPrimitive to false and set map of
@@ -101,7 +101,7 @@ StageAttributesManager::preRegisterObjectFinalize(
     // If collisionAssetHandle corresponds to valid/existing primitive
     // attributes then setCollisionAssetIsPrimitive to true
     stageAttributes->setCollisionAssetIsPrimitive(true);
-  } else if (Cr::Utility::Path::exists(collisionAssetHandle)) {
+  } else if (io::pathExists(collisionAssetHandle)) {
     // Check if collisionAssetHandle is valid file name and is found in file
     // system - if so then setCollisionAssetIsPrimitive to false
     stageAttributes->setCollisionAssetIsPrimitive(false);
@@ -426,7 +426,7 @@ void StageAttributesManager::setValsFromJSONDoc(
     // if "nav mesh" is specified in stage json set value (override default).
     // navmesh filename might already be fully qualified; if not, might just be
     // file name
-    if (!Corrade::Utility::Path::exists(navmeshFName)) {
+    if (!io::pathExists(navmeshFName)) {
       navmeshFName = Cr::Utility::Path::join(stageLocFileDir, navmeshFName);
     }
     stageAttributes->setNavmeshAssetHandle(navmeshFName);
@@ -438,7 +438,7 @@ void StageAttributesManager::setValsFromJSONDoc(
     // (override default).
     // semanticSceneDescriptor filename might already be fully qualified; if
     // not, might just be file name
-    if (!Corrade::Utility::Path::exists(semanticSceneDescriptor)) {
+    if (!io::pathExists(semanticSceneDescriptor)) {
       semanticSceneDescriptor =
           Cr::Utility::Path::join(stageLocFileDir, semanticSceneDescriptor);
     }
@@ -5,12 +5,16 @@
 
 #include "esp/nav/GreedyFollower.h"
 
+#include <thread>
+
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
 #include "esp/core/Esp.h"
 #include "esp/geo/Geo.h"
+#include "esp/scene/ObjectControls.h"
 
+namespace Cr = Corrade;
 namespace Mn = Magnum;
 using Mn::EigenIntegration::cast;
 
@@ -37,11 +41,45 @@ GreedyGeodesicFollowerImpl::GreedyGeodesicFollowerImpl(
       fixThrashing_{fixThrashing},
       thrashingThreshold_{thrashingThreshold} {};
 
+GreedyGeodesicFollowerImpl::GreedyGeodesicFollowerImpl(
+    const PathFinderQueryContext::ptr& queryContext,
+    MoveFn moveForward,
+    MoveFn turnLeft,
+    MoveFn turnRight,
+    double goalDist,
+    double forwardAmount,
+    double turnAmount,
+    bool fixThrashing,
+    int thrashingThreshold)
+    : queryContext_{queryContext},
+      moveForward_{std::move(moveForward)},
+      turnLeft_{std::move(turnLeft)},
+      turnRight_{std::move(turnRight)},
+      forwardAmount_{forwardAmount},
+      goalDist_{goalDist},
+      turnAmount_{turnAmount},
+      fixThrashing_{fixThrashing},
+      thrashingThreshold_{thrashingThreshold} {}
+
+bool GreedyGeodesicFollowerImpl::queryPath(ShortestPath& path) {
+  return queryContext_ ? queryContext_->findPath(path)
+                       : pathfinder_->findPath(path);
+}
+
+float GreedyGeodesicFollowerImpl::distanceToClosestObstacle(
+    const Mn::Vector3& pt,
+    float maxSearchRadius) {
+  return queryContext_ ? queryContext_->distanceToClosestObstacle(
+                             cast<vec3f>(pt), maxSearchRadius)
+                       : pathfinder_->distanceToClosestObstacle(
+                             cast<vec3f>(pt), maxSearchRadius);
+}
+
 float GreedyGeodesicFollowerImpl::geoDist(const Mn::Vector3& start,
                                           const Mn::Vector3& end) {
   geoDistPath_.requestedStart = cast<vec3f>(start);
   geoDistPath_.requestedEnd = cast<vec3f>(end);
-  pathfinder_->findPath(geoDistPath_);
+  queryPath(geoDistPath_);
   return geoDistPath_.geodesicDistance;
 }
 
@@ -55,8 +93,8 @@ GreedyGeodesicFollowerImpl::TryStepResult GreedyGeodesicFollowerImpl::tryStep(
   const Mn::Vector3 newPose = tryStepDummyNode_.MagnumObject::translation();
 
   const float geoDistAfter = geoDist(newPose, end);
-  const float distToObsAfter = pathfinder_->distanceToClosestObstacle(
-      cast<vec3f>(newPose), 1.1 * closeToObsThreshold_);
+  const float distToObsAfter =
+      distanceToClosestObstacle(newPose, 1.1 * closeToObsThreshold_);
 
   return {geoDistAfter, distToObsAfter, didCollide};
 }
@@ -165,7 +203,7 @@ GreedyGeodesicFollowerImpl::CODES GreedyGeodesicFollowerImpl::nextActionAlong(
   ShortestPath path;
   path.requestedStart = cast<vec3f>(start.translation);
   path.requestedEnd = cast<vec3f>(end);
-  pathfinder_->findPath(path);
+  queryPath(path);
 
   CODES nextAction;
   if (fixThrashing_ && thrashingActions_.size() > 0) {
@@ -202,7 +240,7 @@ GreedyGeodesicFollowerImpl::findPath(const core::RigidState& start,
     ShortestPath path;
     path.requestedStart = cast<vec3f>(state.translation);
     path.requestedEnd = cast<vec3f>(end);
-    pathfinder_->findPath(path);
+    queryPath(path);
     const auto nextPrim = nextBestPrimAlong(state, path);
     if (nextPrim.empty()) {
       actions_.emplace_back(CODES::ERROR);
@@ -260,5 +298,189 @@ void GreedyGeodesicFollowerImpl::reset() {
   thrashingActions_.clear();
 }
 
+namespace {
+
+//! Native "move_forward" action on a dummy node that is a direct child of its
+//! scene root. Returns whether the step collided, using the same test as
+//! habitat_sim.agent.ObjectControls.action().
+bool moveForwardOnNavMesh(scene::SceneNode& node,
+                          PathFinderQueryContext& context,
+                          float amount,
+                          bool allowSliding) {
+  const Mn::Vector3 start = node.MagnumObject::translation();
+  scene::moveForward(node, amount);
+  const Mn::Vector3 end = node.MagnumObject::translation();
+  const Mn::Vector3 filteredEnd = allowSliding
+                                      ? context.tryStep(start, end)
+                                      : context.tryStepNoSliding(start, end);
+  node.MagnumObject::setTranslation(filteredEnd);
+  return (filteredEnd - start).dot() + 1e-5f < (end - start).dot();
+}
+
+}  // namespace
+
+GreedyGeodesicFollowerBatch::GreedyGeodesicFollowerBatch(
+    const PathFinder::ptr& pathfinder,
+    int numAgents,
+    double goalDist,
+    double forwardAmount,
+    double turnAmount,
+    bool allowSliding,
+    bool fixThrashing,
+    int thrashingThreshold,
+    int numThreads)
+    : forwardAmount_{forwardAmount},
+      turnDegrees_{float(Mn::Deg(Mn::Rad(float(turnAmount))))},
+      allowSliding_{allowSliding} {
+  ESP_CHECK(pathfinder && pathfinder->isLoaded(),
+            "GreedyGeodesicFollowerBatch : no navmesh is loaded.");
+  ESP_CHECK(numAgents >= 0,
+            "GreedyGeodesicFollowerBatch : numAgents must not be negative, got"
+                << numAgents);
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  numThreads = std::max(1, std::min(numThreads, numAgents));
+
+  contexts_.reserve(numThreads);
+  for (int i = 0; i < numThreads; ++i) {
+    contexts_.emplace_back(pathfinder->createQueryContext());
+  }
+
+  const float forward = forwardAmount;
+  const float turnDegrees = turnDegrees_;
+  agents_.resize(numAgents);
+  stepNodes_.reserve(numAgents);
+  for (int i = 0; i < numAgents; ++i) {
+    PathFinderQueryContext::ptr context = contexts_[i % numThreads];
+    GreedyGeodesicFollowerImpl::MoveFn moveForward =
+        [context, forward, allowSliding](scene::SceneNode* node) {
+          return moveForwardOnNavMesh(*node, *context, forward, allowSliding);
+        };
+    GreedyGeodesicFollowerImpl::MoveFn turnLeft =
+        [turnDegrees](scene::SceneNode* node) {
+          scene::turnLeft(*node, turnDegrees);
+          return false;
+        };
+    GreedyGeodesicFollowerImpl::MoveFn turnRight =
+        [turnDegrees](scene::SceneNode* node) {
+          scene::turnRight(*node, turnDegrees);
+          return false;
+        };
+
+    agents_[i].follower = GreedyGeodesicFollowerImpl::create_unique(
+        context, std::move(moveForward), std::move(turnLeft),
+        std::move(turnRight), goalDist, forwardAmount, turnAmount,
+        fixThrashing, thrashingThreshold);
+    stepNodes_.push_back(&stepScene_.getRootNode().createChild());
+  }
+}
+
+void GreedyGeodesicFollowerBatch::forEachAgent(
+    const std::function<void(int, PathFinderQueryContext&)>& fn) {
+  const int numAgents = agents_.size();
+  const int numThreads = std::min<int>(contexts_.size(), numAgents);
+  auto work = [&](int thread) {
+    for (int i = thread; i < numAgents; i += numThreads) {
+      fn(i, *contexts_[thread]);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int thread = 1; thread < numThreads; ++thread) {
+    workers.emplace_back(work, thread);
+  }
+  if (numThreads > 0) {
+    work(0);
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void GreedyGeodesicFollowerBatch::checkBatchSize(std::size_t numStates,
+                                                 std::size_t numGoals,
+                                                 const char* function) const {
+  ESP_CHECK(numStates == agents_.size() && numGoals == agents_.size(),
+            "GreedyGeodesicFollowerBatch::"
+                << function << ": expected" << agents_.size()
+                << "states and goals, got" << numStates << "and" << numGoals);
+}
+
+GreedyGeodesicFollowerBatch::CODES GreedyGeodesicFollowerBatch::nextActionOf(
+    int agentIndex,
+    const core::RigidState& state,
+    const Mn::Vector3& goal) {
+  Agent& agent = agents_[agentIndex];
+  if (!agent.lastGoal || *agent.lastGoal != goal) {
+    agent.follower->reset();
+    agent.lastGoal = goal;
+  }
+  return agent.follower->nextActionAlong(state, goal);
+}
+
+std::vector<GreedyGeodesicFollowerBatch::CODES>
+GreedyGeodesicFollowerBatch::nextActionsAlong(
+    const std::vector<core::RigidState>& states,
+    const std::vector<Mn::Vector3>& goals) {
+  checkBatchSize(states.size(), goals.size(), "nextActionsAlong");
+  std::vector<CODES> actions(agents_.size());
+  forEachAgent([&](int i, PathFinderQueryContext&) {
+    actions[i] = nextActionOf(i, states[i], goals[i]);
+  });
+  return actions;
+}
+
+std::vector<GreedyGeodesicFollowerBatch::CODES>
+GreedyGeodesicFollowerBatch::step(std::vector<core::RigidState>& states,
+                                  const std::vector<Mn::Vector3>& goals) {
+  checkBatchSize(states.size(), goals.size(), "step");
+  std::vector<CODES> actions(agents_.size());
+  forEachAgent([&](int i, PathFinderQueryContext& context) {
+    actions[i] = nextActionOf(i, states[i], goals[i]);
+
+    scene::SceneNode& node = *stepNodes_[i];
+    node.setTranslation(states[i].translation);
+    node.setRotation(states[i].rotation);
+    switch (actions[i]) {
+      case CODES::FORWARD:
+        moveForwardOnNavMesh(node, context, forwardAmount_, allowSliding_);
+        break;
+      case CODES::LEFT:
+        scene::turnLeft(node, turnDegrees_);
+        break;
+      case CODES::RIGHT:
+        scene::turnRight(node, turnDegrees_);
+        break;
+      default:
+        return;
+    }
+    states[i] = {node.rotation(), node.MagnumObject::translation()};
+  });
+  return actions;
+}
+
+std::vector<std::vector<GreedyGeodesicFollowerBatch::CODES>>
+GreedyGeodesicFollowerBatch::findPaths(
+    const std::vector<core::RigidState>& states,
+    const std::vector<Mn::Vector3>& goals) {
+  checkBatchSize(states.size(), goals.size(), "findPaths");
+  std::vector<std::vector<CODES>> paths(agents_.size());
+  forEachAgent([&](int i, PathFinderQueryContext&) {
+    Agent& agent = agents_[i];
+    agent.follower->reset();
+    agent.lastGoal = Cr::Containers::NullOpt;
+    paths[i] = agent.follower->findPath(states[i], goals[i]);
+  });
+  return paths;
+}
+
+void GreedyGeodesicFollowerBatch::reset() {
+  for (Agent& agent : agents_) {
+    agent.follower->reset();
+    agent.lastGoal = Cr::Containers::NullOpt;
+  }
+}
+
 }  // namespace nav
 }  // namespace esp
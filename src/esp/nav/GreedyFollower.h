@@ -5,6 +5,8 @@
 #ifndef ESP_NAV_GREEDYFOLLOWER_H_
 #define ESP_NAV_GREEDYFOLLOWER_H_
 
+#include <Corrade/Containers/Optional.h>
+
 #include "esp/core/Esp.h"
 #include "esp/core/RigidState.h"
 #include "esp/nav/PathFinder.h"
@@ -81,6 +83,24 @@ class GreedyGeodesicFollowerImpl {
                              bool fixThrashing = true,
                              int thrashingThreshold = 16);
 
+  /**
+   * @brief Constructor running all navmesh queries through a
+   * @ref PathFinderQueryContext instead of a @ref PathFinder
+   *
+   * Followers constructed on different contexts can plan concurrently with
+   * each other, provided their move functions are thread-safe as well. The
+   * remaining parameters are the same as for the @ref PathFinder overload.
+   */
+  GreedyGeodesicFollowerImpl(const PathFinderQueryContext::ptr& queryContext,
+                             MoveFn moveForward,
+                             MoveFn turnLeft,
+                             MoveFn turnRight,
+                             double goalDist,
+                             double forwardAmount,
+                             double turnAmount,
+                             bool fixThrashing = true,
+                             int thrashingThreshold = 16);
+
   /**
    * @brief Calculates the next action to follow the path
    *
@@ -121,7 +141,9 @@ class GreedyGeodesicFollowerImpl {
   void reset();
 
  private:
+  //! Exactly one of these is set, depending on the constructor used
   PathFinder::ptr pathfinder_;
+  PathFinderQueryContext::ptr queryContext_;
   MoveFn moveForward_, turnLeft_, turnRight_;
   const double forwardAmount_, goalDist_, turnAmount_;
   const bool fixThrashing_;
@@ -138,6 +160,10 @@ class GreedyGeodesicFollowerImpl {
       rightDummyNode_{dummyScene_.getRootNode()},
       tryStepDummyNode_{dummyScene_.getRootNode()};
 
+  bool queryPath(ShortestPath& path);
+  float distanceToClosestObstacle(const Magnum::Vector3& pt,
+                                  float maxSearchRadius);
+
   ShortestPath geoDistPath_;
   float geoDist(const Magnum::Vector3& start, const Magnum::Vector3& end);
 
@@ -162,6 +188,129 @@ class GreedyGeodesicFollowerImpl {
   ESP_SMART_POINTERS(GreedyGeodesicFollowerImpl)
 };
 
+/**
+ * @brief Runs a @ref GreedyGeodesicFollowerImpl for each of many agents in a
+ * single call, spreading the agents across worker threads.
+ *
+ * The move functions are native instead of coming from Python: "move_forward"
+ * translates along the agent's forward axis and filters the step with
+ * @ref PathFinder::tryStep (or @ref PathFinder::tryStepNoSliding), reporting a
+ * collision the same way as `habitat_sim.agent.ObjectControls` does, and
+ * "turn_left" and "turn_right" rotate around the up axis. This matches the
+ * default agent actions without actuation noise.
+ *
+ * Every worker thread queries the navmesh through its own
+ * @ref PathFinderQueryContext, so the @ref PathFinder may be used while a
+ * batch is running but the batch itself only by one thread at a time. Agent
+ * @f$ i @f$ is always handled by the same context, which makes the results
+ * independent of the thread count.
+ */
+class GreedyGeodesicFollowerBatch {
+ public:
+  typedef GreedyGeodesicFollowerImpl::CODES CODES;
+
+  /**
+   * @brief Constructor
+   *
+   * @param[in] pathfinder Pathfinder with the navmesh to follow paths on
+   * @param[in] numAgents Number of agents in the batch
+   * @param[in] goalDist How close the agents need to get to their goals
+   *                     before calling stop
+   * @param[in] forwardAmount The amount "move_forward" moves an agent
+   * @param[in] turnAmount The amount "turn_left"/"turn_right" turns an agent
+   *                       in radians
+   * @param[in] allowSliding Whether "move_forward" may slide along walls
+   * @param[in] fixThrashing Whether or not to fix thrashing
+   * @param[in] thrashingThreshold The length of left, right, left, right
+   *                                actions needed to be considered thrashing
+   * @param[in] numThreads Number of threads to use, including the calling
+   *                       one. If not positive, the number of hardware threads
+   *                       is used.
+   */
+  GreedyGeodesicFollowerBatch(const PathFinder::ptr& pathfinder,
+                              int numAgents,
+                              double goalDist,
+                              double forwardAmount,
+                              double turnAmount,
+                              bool allowSliding = true,
+                              bool fixThrashing = true,
+                              int thrashingThreshold = 16,
+                              int numThreads = 0);
+
+  /** @brief Number of agents in the batch */
+  int numAgents() const { return agents_.size(); }
+
+  /**
+   * @brief Calculates the next action of every agent
+   *
+   * An agent's follower is reset whenever its goal differs from the one it
+   * was given in the previous call, as
+   * `habitat_sim.nav.GreedyGeodesicFollower` does.
+   *
+   * @param[in] states The current state of each agent
+   * @param[in] goals The goal of each agent
+   */
+  std::vector<CODES> nextActionsAlong(
+      const std::vector<core::RigidState>& states,
+      const std::vector<Magnum::Vector3>& goals);
+
+  /**
+   * @brief Same as @ref nextActionsAlong but also applies the chosen action to
+   * each state
+   *
+   * States of agents whose action is @ref CODES::STOP or @ref CODES::ERROR
+   * are left untouched.
+   */
+  std::vector<CODES> step(std::vector<core::RigidState>& states,
+                          const std::vector<Magnum::Vector3>& goals);
+
+  /**
+   * @brief Finds the full action sequence of every agent, see
+   * @ref GreedyGeodesicFollowerImpl::findPath
+   *
+   * Resets every follower first. The sequence is empty for agents for which
+   * no path was found.
+   */
+  std::vector<std::vector<CODES>> findPaths(
+      const std::vector<core::RigidState>& states,
+      const std::vector<Magnum::Vector3>& goals);
+
+  /** @brief Reset the followers of all agents */
+  void reset();
+
+ private:
+  struct Agent {
+    GreedyGeodesicFollowerImpl::uptr follower;
+    //! Goal of the last @ref nextActionsAlong call
+    Corrade::Containers::Optional<Magnum::Vector3> lastGoal;
+  };
+
+  //! Calls @p fn(agent, context) for every agent, agents with the same index
+  //! modulo the number of contexts being handled by the same thread
+  void forEachAgent(
+      const std::function<void(int, PathFinderQueryContext&)>& fn);
+
+  void checkBatchSize(std::size_t numStates,
+                      std::size_t numGoals,
+                      const char* function) const;
+
+  CODES nextActionOf(int agentIndex,
+                     const core::RigidState& state,
+                     const Magnum::Vector3& goal);
+
+  const float forwardAmount_, turnDegrees_;
+  const bool allowSliding_;
+
+  std::vector<PathFinderQueryContext::ptr> contexts_;
+  std::vector<Agent> agents_;
+
+  //! Used by @ref step to apply actions, one node per agent
+  scene::SceneGraph stepScene_;
+  std::vector<scene::SceneNode*> stepNodes_;
+
+  ESP_SMART_POINTERS(GreedyGeodesicFollowerBatch)
+};
+
 }  // namespace nav
 }  // namespace esp
 
@@ -3,9 +3,16 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PathFinder.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <numeric>
+#include <queue>
 #include <stack>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 
 #include <Magnum/Magnum.h>
@@ -14,9 +21,17 @@
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Path.h>
 
+#ifdef CORRADE_TARGET_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <cstdio>
 // NOLINTNEXTLINE
 #define _USE_MATH_DEFINES
@@ -26,6 +41,7 @@
 
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/core/Profiler.h"
 
 #include "DetourCommon.h"
 #include "DetourNavMesh.h"
@@ -55,7 +71,8 @@ bool operator==(const NavMeshSettings& a, const NavMeshSettings& b) {
          CLOSE(edgeMaxError) && CLOSE(vertsPerPoly) &&
          CLOSE(detailSampleDist) && CLOSE(detailSampleMaxError) &&
          EQ(filterLowHangingObstacles) && EQ(filterLedgeSpans) &&
-         EQ(filterWalkableLowHeightSpans) && EQ(includeStaticObjects);
+         EQ(filterWalkableLowHeightSpans) && EQ(includeStaticObjects) &&
+         CLOSE(tileSize);
 
 #undef CLOSE
 #undef EQ
@@ -103,6 +120,20 @@ struct MultiGoalShortestPath::Impl {
 
   std::vector<float> minTheoreticalDist;
   vec3f prevRequestedStart = vec3f::Zero();
+
+  struct DistanceFieldEntry {
+    //! Geodesic distance from the polygon center to the closest end
+    float distance;
+    //! Index of that end in requestedEnds
+    int endIndex;
+  };
+  //! See MultiGoalShortestPath::useDistanceField. Built on first use, reset
+  //! with the requested ends.
+  std::unordered_map<dtPolyRef, DistanceFieldEntry> distanceField;
+  //! Indices of the valid requested ends lying on each polygon
+  std::unordered_map<dtPolyRef, std::vector<int>> endsInPoly;
+  //! Generation of the navmesh the distance field was built on, 0 if none
+  uint64_t distanceFieldGeneration = 0;
 };
 
 MultiGoalShortestPath::MultiGoalShortestPath()
@@ -111,8 +142,12 @@ MultiGoalShortestPath::MultiGoalShortestPath()
 void MultiGoalShortestPath::setRequestedEnds(
     const std::vector<vec3f>& newEnds) {
   pimpl_->endRefs.clear();
+  pimpl_->endIsValid.clear();
   pimpl_->pathEnds.clear();
   pimpl_->requestedEnds = newEnds;
+  pimpl_->distanceField.clear();
+  pimpl_->endsInPoly.clear();
+  pimpl_->distanceFieldGeneration = 0;
 
   pimpl_->minTheoreticalDist.assign(newEnds.size(), 0);
 }
@@ -221,7 +256,8 @@ class IslandSystem {
 
   //! check that island index is valid. indexOptional allows ID_UNDEFINED as
   //! valid.
-  inline void assertValidIsland(int islandIndex, bool indexOptional = true) {
+  inline void assertValidIsland(int islandIndex,
+                                bool indexOptional = true) const {
     if (indexOptional && islandIndex == ID_UNDEFINED) {
       return;
     }
@@ -255,6 +291,12 @@ class IslandSystem {
     return islandRadius_.size();
   }
 
+  //! Polygons of a single island
+  inline const std::vector<dtPolyRef>& islandPolys(int islandIndex) const {
+    assertValidIsland(islandIndex, /*indexOptional*/ false);
+    return islandsToPolys_.at(islandIndex);
+  }
+
   /**
    * @brief Sets a specified poly flag for all polys specified by the
    * islandIndex.
@@ -394,9 +436,29 @@ class IslandSystem {
   void removeZeroAreaPolys(dtNavMesh* navMesh);
 
   //! return the island for a navmesh polygon
-  inline int getPolyIsland(dtPolyRef polyRef) { return polyToIsland_[polyRef]; }
+  inline int getPolyIsland(dtPolyRef polyRef) const {
+    auto itRef = polyToIsland_.find(polyRef);
+    if (itRef == polyToIsland_.end())
+      return ID_UNDEFINED;
+
+    return itRef->second;
+  }
+
+  //! Write the islands, their radii, areas and polygons, see @ref deserialize
+  void serialize(FILE* fp) const;
+
+  /**
+   * @brief Restore islands written by @ref serialize for the same navmesh.
+   *
+   * Reads from @p data and advances it past the islands. Returns nullptr if
+   * the @p size bytes don't hold a valid island section.
+   */
+  static std::shared_ptr<IslandSystem> deserialize(const unsigned char*& data,
+                                                   std::size_t size);
 
  private:
+  IslandSystem() = default;
+
   //! map islands to area for quick query
   std::unordered_map<uint32_t, float> islandsToArea_;
   //! map islands to lists of polys for quick query and enumeration
@@ -459,163 +521,1378 @@ class IslandSystem {
 };
 }  // namespace impl
 
-struct PathFinder::Impl {
-  Impl();
-  ~Impl() = default;
+namespace {
+struct ObstacleDistanceField;
+struct PathHierarchy;
+
+//! Everything the read-only queries below need. Only @ref navQuery holds
+//! mutable scratch state, so each thread querying concurrently needs its own;
+//! the rest is shared and only read.
+struct QueryState {
+  const dtNavMesh* navMesh;
+  dtNavMeshQuery* navQuery;
+  const dtQueryFilter* filter;
+  const impl::IslandSystem* islandSystem;
+  //! Precomputed obstacle distances, if built
+  const ObstacleDistanceField* obstacleDistanceField;
+  //! Regions and portals for long paths, if built
+  const PathHierarchy* pathHierarchy;
+};
 
-  bool build(const NavMeshSettings& bs,
-             const float* verts,
-             int nverts,
-             const int* tris,
-             int ntris,
-             const float* bmin,
-             const float* bmax);
-  bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
+float pathLength(const std::vector<vec3f>& points) {
+  CORRADE_INTERNAL_ASSERT(points.size() > 0);
 
-  vec3f getRandomNavigablePoint(int maxTries,
-                                int islandIndex /*= ID_UNDEFINED*/);
-  vec3f getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
-                                            float radius,
-                                            int maxTries,
-                                            int islandIndex /*= ID_UNDEFINED*/);
-  vec3f getRandomNavigablePointInCircle(const vec3f& circleCenter,
-                                        float radius,
-                                        int maxTries,
-                                        int islandIndex /*= ID_UNDEFINED*/);
+  float length = 0;
+  const vec3f* previousPoint = &points[0];
+  for (const auto& pt : points) {
+    length += (*previousPoint - pt).norm();
+    previousPoint = &pt;
+  }
 
-  bool findPath(ShortestPath& path);
-  bool findPath(MultiGoalShortestPath& path);
+  return length;
+}
 
-  template <typename T>
-  T tryStep(const T& start, const T& end, bool allowSliding);
+Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+findPathHierarchical(const QueryState& state,
+                     const vec3f& start,
+                     dtPolyRef startRef,
+                     const vec3f& pathStart,
+                     const vec3f& end,
+                     dtPolyRef endRef,
+                     const vec3f& pathEnd);
 
-  template <typename T>
-  T snapPoint(const T& pt, int islandIndex = ID_UNDEFINED);
+Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+findPathInternal(const QueryState& state,
+                 const vec3f& start,
+                 dtPolyRef startRef,
+                 const vec3f& pathStart,
+                 const vec3f& end,
+                 dtPolyRef endRef,
+                 const vec3f& pathEnd) {
+  // check if trivial path (start is same as end) and early return
+  if (pathStart.isApprox(pathEnd)) {
+    return std::make_tuple(0.0f, std::vector<vec3f>{pathStart, pathEnd});
+  }
 
-  template <typename T>
-  int getIsland(const T& pt) const;
+  // Check if there is a path between the start and any of the ends
+  if (!state.islandSystem->hasConnection(startRef, endRef)) {
+    return Cr::Containers::NullOpt;
+  }
 
-  bool loadNavMesh(const std::string& path);
+  // long paths are searched for over the portals of the path hierarchy
+  // first, falling back to a direct search if that doesn't find one
+  if (state.pathHierarchy) {
+    Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>> result =
+        findPathHierarchical(state, start, startRef, pathStart, end, endRef,
+                             pathEnd);
+    if (result) {
+      return result;
+    }
+  }
 
-  bool saveNavMesh(const std::string& path);
+  static const int MAX_POLYS = 256;
+  dtPolyRef polys[MAX_POLYS];
 
-  bool isLoaded() const { return navMesh_ != nullptr; };
+  int numPolys = 0;
+  dtStatus status = state.navQuery->findPath(
+      startRef, endRef, pathStart.data(), pathEnd.data(), state.filter, polys,
+      &numPolys, MAX_POLYS);
+  if (status != DT_SUCCESS || numPolys == 0) {
+    return Cr::Containers::NullOpt;
+  }
 
-  float getNavigableArea(int islandIndex /*= ID_UNDEFINED*/) const {
-    return islandSystem_->getNavigableArea(islandIndex);
-  };
+  int numPoints = 0;
+  std::vector<vec3f> points(MAX_POLYS);
+  status = state.navQuery->findStraightPath(
+      start.data(), end.data(), polys, numPolys, points[0].data(), nullptr,
+      nullptr, &numPoints, MAX_POLYS);
+  if (status != DT_SUCCESS || numPoints == 0) {
+    return Corrade::Containers::NullOpt;
+  }
 
-  int numIslands();
+  points.resize(numPoints);
 
-  void seed(uint32_t newSeed);
+  const float length = pathLength(points);
 
-  float islandRadius(const vec3f& pt) const;
+  return std::make_tuple(length, std::move(points));
+}
 
-  float islandRadius(int islandIndex) const;
+bool queryPath(const QueryState& state, ShortestPath& path) {
+  path.geodesicDistance = std::numeric_limits<float>::infinity();
+  path.points.clear();
 
-  float distanceToClosestObstacle(const vec3f& pt,
-                                  float maxSearchRadius = 2.0) const;
-  HitRecord closestObstacleSurfacePoint(const vec3f& pt,
-                                        float maxSearchRadius = 2.0) const;
+  dtStatus status = 0;
+  dtPolyRef startRef = 0;
+  vec3f pathStart;
+  std::tie(status, startRef, pathStart) =
+      projectToPoly(path.requestedStart, state.navQuery, state.filter);
+  if (status != DT_SUCCESS || startRef == 0) {
+    return false;
+  }
 
-  bool isNavigable(const vec3f& pt, float maxYDelta = 0.5) const;
+  dtPolyRef endRef = 0;
+  vec3f pathEnd;
+  std::tie(status, endRef, pathEnd) =
+      projectToPoly(path.requestedEnd, state.navQuery, state.filter);
+  if (status != DT_SUCCESS || endRef == 0) {
+    return false;
+  }
 
-  std::pair<vec3f, vec3f> bounds() const { return bounds_; };
+  Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>> findResult =
+      findPathInternal(state, path.requestedStart, startRef, pathStart,
+                       path.requestedEnd, endRef, pathEnd);
+  if (!findResult) {
+    return false;
+  }
 
-  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownView(float metersPerPixel, float height, float eps) const;
+  path.geodesicDistance = std::get<0>(*findResult);
+  path.points = std::move(std::get<1>(*findResult));
+  return true;
+}
 
-  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownIslandView(float metersPerPixel, float height, float eps) const;
+/**
+ * Project @p pt onto polygon @p ref if it lies on it, which is the case for
+ * the polygon the previous step of an agent ended on unless it was moved
+ * since. Saves the nearest polygon search of @ref projectToPoly().
+ */
+template <typename T>
+bool projectToHintedPoly(const T& pt,
+                         dtPolyRef ref,
+                         const QueryState& state,
+                         vec3f& polyXYZ) {
+  // points from previous steps are on the surface of the navmesh already, a
+  // larger offset means the polygon belongs to a different floor
+  constexpr float maxHeightOffset = 0.01f;
+  bool posOverPoly = false;
+  if (ref == 0 || !state.navMesh->isValidPolyRef(ref) ||
+      dtStatusFailed(state.navQuery->closestPointOnPoly(
+          ref, pt.data(), polyXYZ.data(), &posOverPoly)) ||
+      !posOverPoly) {
+    return false;
+  }
+  return std::abs(polyXYZ[1] - pt[1]) <= maxHeightOffset;
+}
 
-  assets::MeshData::ptr getNavMeshData(int islandIndex /*= ID_UNDEFINED*/);
+/**
+ * @p polygonHint, if not null, is the polygon @p start is expected to be on,
+ * or 0 if unknown. It's replaced with the polygon of the returned point.
+ */
+template <typename T>
+T queryTryStep(const QueryState& state,
+               const T& start,
+               const T& end,
+               bool allowSliding,
+               dtPolyRef* polygonHint = nullptr) {
+  static const int MAX_POLYS = 256;
+  dtPolyRef polys[MAX_POLYS];
 
-  Cr::Containers::Optional<NavMeshSettings> getNavMeshSettings() const {
-    return navMeshSettings_;
+  dtStatus startStatus = 0, endStatus = 0;
+  dtPolyRef startRef = 0, endRef = 0;
+  vec3f pathStart;
+  if (polygonHint &&
+      projectToHintedPoly(start, *polygonHint, state, pathStart)) {
+    startRef = *polygonHint;
+  } else {
+    std::tie(startStatus, startRef, pathStart) =
+        projectToPoly(start, state.navQuery, state.filter);
   }
+  std::tie(endStatus, endRef, std::ignore) =
+      projectToPoly(end, state.navQuery, state.filter);
 
- private:
-  struct NavMeshDeleter {
-    void operator()(dtNavMesh* mesh) { dtFreeNavMesh(mesh); }
-  };
-  struct NavQueryDeleter {
-    void operator()(dtNavMeshQuery* query) { dtFreeNavMeshQuery(query); }
-  };
-
-  std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh_ = nullptr;
-  std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> navQuery_ = nullptr;
-  std::unique_ptr<dtQueryFilter> filter_ = nullptr;
-  std::unique_ptr<impl::IslandSystem> islandSystem_ = nullptr;
+  if (polygonHint) {
+    *polygonHint = dtStatusFailed(startStatus) ? 0 : startRef;
+  }
 
-  //! Holds triangulated geom/topo. Generated when queried. Reset with
-  //! navQuery_.
-  std::unordered_map<int, assets::MeshData::ptr> islandMeshData_;
-  Cr::Containers::Optional<NavMeshSettings> navMeshSettings_;
+  if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
+    return start;
+  }
 
-  std::pair<vec3f, vec3f> bounds_;
+  if (not state.islandSystem->hasConnection(startRef, endRef)) {
+    return start;
+  }
 
-  bool initNavQuery();
+  vec3f endPoint;
+  int numPolys = 0;
+  state.navQuery->moveAlongSurface(startRef, pathStart.data(), end.data(),
+                                   state.filter, endPoint.data(), polys,
+                                   &numPolys, MAX_POLYS, allowSliding);
+  // If there isn't any possible path between start and end, just return
+  // start, that is cleanest
+  if (numPolys == 0) {
+    return start;
+  }
 
-  Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-  findPathInternal(const vec3f& start,
-                   dtPolyRef startRef,
-                   const vec3f& pathStart,
-                   const vec3f& end,
-                   dtPolyRef endRef,
-                   const vec3f& pathEnd);
+  // According to recast's code
+  // (https://github.com/recastnavigation/recastnavigation/blob/master/Detour/Source/DetourNavMeshQuery.cpp#L2006-L2007),
+  // the endPoint is not guaranteed to be actually on the surface of the
+  // navmesh, it seems to be in 99.9% of cases for us, but there are some
+  // extreme edge cases where it won't be, so explicitly get the height of the
+  // surface at the endPoint and set its height to that.
+  // Note, this will never fail as endPoint is always within in the poly
+  // polys[numPolys - 1]
+  state.navQuery->getPolyHeight(polys[numPolys - 1], endPoint.data(),
+                                &endPoint[1]);
+  if (polygonHint) {
+    *polygonHint = polys[numPolys - 1];
+  }
 
-  bool findPathSetup(MultiGoalShortestPath& path,
-                     dtPolyRef& startRef,
-                     vec3f& pathStart);
-};
+  // Hack to deal with infinitely thin walls in recast allowing you to
+  // transition between two different connected components
+  // First check to see if the endPoint as returned by `moveAlongSurface`
+  // is in the same connected component as the startRef according to
+  // findNearestPoly
+  std::tie(std::ignore, endRef, std::ignore) =
+      projectToPoly(endPoint, state.navQuery, state.filter);
+  if (!state.islandSystem->hasConnection(startRef, endRef)) {
+    // There isn't a connection!  This happens when endPoint is on an edge
+    // shared between two different connected components (aka infinitely thin
+    // walls) The way to deal with this is to nudge the point into the polygon
+    // we want it to be 'moveAlongSurface' tells us which polygon we want
+    // endPoint to be in through the polys list
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    state.navMesh->getTileAndPolyByRefUnsafe(polys[numPolys - 1], &tile,
+                                             &poly);
 
-namespace {
-struct Workspace {
-  rcHeightfield* solid = nullptr;
-  unsigned char* triareas = nullptr;
-  rcCompactHeightfield* chf = nullptr;
-  rcContourSet* cset = nullptr;
-  rcPolyMesh* pmesh = nullptr;
-  rcPolyMeshDetail* dmesh = nullptr;
+    // Calculate the center of the polygon we want the points to be in
+    vec3f polyCenter = vec3f::Zero();
+    for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+      polyCenter += Eigen::Map<vec3f>(
+          &tile->verts[static_cast<size_t>(poly->verts[iVert]) * 3]);
+    }
+    polyCenter /= poly->vertCount;
 
-  ~Workspace() {
-    rcFreeHeightField(solid);
-    delete[] triareas;
-    rcFreeCompactHeightfield(chf);
-    rcFreeContourSet(cset);
-    rcFreePolyMesh(pmesh);
-    rcFreePolyMeshDetail(dmesh);
+    constexpr float nudgeDistance = 1e-4;  // 0.1mm
+    const vec3f nudgeDir = (polyCenter - endPoint).normalized();
+    // And nudge the point towards the center by a little tiny bit :)
+    endPoint = endPoint + nudgeDistance * nudgeDir;
   }
-};
 
-enum PolyAreas { POLYAREA_GROUND, POLYAREA_DOOR };
+  return T{std::move(endPoint)};
+}
 
-enum PolyFlags {
-  POLYFLAGS_WALK = 0x01,      // walkable
-  POLYFLAGS_DOOR = 0x02,      // ability to move through doors
-  POLYFLAGS_DISABLED = 0x04,  // disabled polygon
-  POLYFLAGS_OFF_ISLAND =
-      0x08,               // dynamically set to filter all but a specific island
-  POLYFLAGS_ALL = 0xffff  // all abilities
-};
-}  // namespace
+/**
+ * Snap to the closest point on a polygon of the given island, or anywhere on
+ * the navmesh for ID_UNDEFINED. Mirrors the nearest polygon metric of
+ * dtNavMeshQuery::findNearestPoly but filters by island directly instead of
+ * through poly flags, so the shared navmesh is never written to.
+ */
+template <typename T>
+T querySnapPoint(const QueryState& state, const T& pt, int islandIndex) {
+  if (islandIndex == ID_UNDEFINED) {
+    dtStatus status = 0;
+    vec3f projectedPt;
+    std::tie(status, std::ignore, projectedPt) =
+        projectToPoly(pt, state.navQuery, state.filter);
+    if (dtStatusSucceed(status)) {
+      return T{std::move(projectedPt)};
+    }
+    return {Mn::Constants::nan(), Mn::Constants::nan(), Mn::Constants::nan()};
+  }
 
-PathFinder::Impl::Impl() {
-  filter_ = std::make_unique<dtQueryFilter>();
-  filter_->setIncludeFlags(POLYFLAGS_WALK);
-  filter_->setExcludeFlags(0);
+  // same search box as projectToPoly
+  constexpr float polyPickExt[3] = {2, 4, 2};
+  static const int MAX_POLYS = 512;
+  dtPolyRef polys[MAX_POLYS];
+  int numPolys = 0;
+  const vec3f center{pt[0], pt[1], pt[2]};
+  state.navQuery->queryPolygons(center.data(), polyPickExt, state.filter,
+                                polys, &numPolys, MAX_POLYS);
+
+  float nearestDistSqr = std::numeric_limits<float>::max();
+  vec3f nearestPt = vec3f::Constant(Mn::Constants::nan());
+  for (int i = 0; i < numPolys; ++i) {
+    if (state.islandSystem->getPolyIsland(polys[i]) != islandIndex) {
+      continue;
+    }
+    vec3f closestPt;
+    bool posOverPoly = false;
+    state.navQuery->closestPointOnPoly(polys[i], center.data(),
+                                       closestPt.data(), &posOverPoly);
+    // points directly above or below a polygon are as close as the agent's
+    // climb allows
+    const vec3f diff = center - closestPt;
+    float distSqr = diff.squaredNorm();
+    if (posOverPoly) {
+      const dtMeshTile* tile = nullptr;
+      const dtPoly* poly = nullptr;
+      state.navMesh->getTileAndPolyByRefUnsafe(polys[i], &tile, &poly);
+      const float d = std::abs(diff[1]) - tile->header->walkableClimb;
+      distSqr = d > 0 ? d * d : 0;
+    }
+    if (distSqr < nearestDistSqr) {
+      nearestDistSqr = distSqr;
+      nearestPt = closestPt;
+    }
+  }
+
+  if (std::isnan(nearestPt[0])) {
+    return {Mn::Constants::nan(), Mn::Constants::nan(), Mn::Constants::nan()};
+  }
+  return T{std::move(nearestPt)};
 }
 
-bool PathFinder::Impl::build(const NavMeshSettings& bs,
-                             const float* verts,
-                             const int nverts,
-                             const int* tris,
-                             const int ntris,
-                             const float* bmin,
-                             const float* bmax) {
-  Workspace ws;
-  rcContext ctx;
+template <typename T>
+int queryIsland(const QueryState& state, const T& pt) {
+  dtStatus status = 0;
+  vec3f projectedPt;
+  dtPolyRef polyRef = 0;
+  std::tie(status, polyRef, projectedPt) =
+      projectToPoly(pt, state.navQuery, state.filter);
 
+  if (dtStatusSucceed(status)) {
+    return state.islandSystem->getPolyIsland(polyRef);
+  }
+  return ID_UNDEFINED;
+}
+
+float queryIslandRadius(const QueryState& state, const vec3f& pt) {
+  dtPolyRef ptRef = 0;
+  dtStatus status = 0;
+  std::tie(status, ptRef, std::ignore) =
+      projectToPoly(pt, state.navQuery, state.filter);
+  if (status != DT_SUCCESS || ptRef == 0) {
+    return 0.0;
+  }
+  return state.islandSystem->polyIslandRadius(ptRef);
+}
+
+HitRecord queryClosestObstacleSurfacePoint(const QueryState& state,
+                                           const vec3f& pt,
+                                           const float maxSearchRadius) {
+  dtPolyRef ptRef = 0;
+  dtStatus status = 0;
+  vec3f polyPt;
+  std::tie(status, ptRef, polyPt) =
+      projectToPoly(pt, state.navQuery, state.filter);
+  if (status != DT_SUCCESS || ptRef == 0) {
+    return {vec3f(0, 0, 0), vec3f(0, 0, 0),
+            std::numeric_limits<float>::infinity()};
+  }
+  vec3f hitPos, hitNormal;
+  float hitDist = Mn::Constants::nan();
+  state.navQuery->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
+                                     state.filter, &hitDist, hitPos.data(),
+                                     hitNormal.data());
+  return {std::move(hitPos), std::move(hitNormal), hitDist};
+}
+
+bool queryIsNavigable(const QueryState& state,
+                      const vec3f& pt,
+                      const float maxYDelta) {
+  dtPolyRef ptRef = 0;
+  dtStatus status = 0;
+  vec3f polyPt;
+  std::tie(status, ptRef, polyPt) =
+      projectToPoly(pt, state.navQuery, state.filter);
+
+  if (status != DT_SUCCESS || ptRef == 0)
+    return false;
+
+  if (std::abs(polyPt[1] - pt[1]) > maxYDelta ||
+      (Eigen::Vector2f(pt[0], pt[2]) - Eigen::Vector2f(polyPt[0], polyPt[2]))
+              .norm() > 1e-2)
+    return false;
+
+  return true;
+}
+
+vec3f polyCenter(const dtMeshTile* tile, const dtPoly* poly) {
+  vec3f center = vec3f::Zero();
+  for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
+    center += Eigen::Map<const vec3f>(
+        &tile->verts[static_cast<size_t>(poly->verts[iVert]) * 3]);
+  }
+  return center / poly->vertCount;
+}
+
+/**
+ * Calls @p callback with the reference, tile, poly and shared edge midpoint
+ * of every neighbour of @p ref that passes @p filter.
+ */
+template <typename F>
+void forEachNeighbourPoly(const dtNavMesh* navMesh,
+                          const dtQueryFilter* filter,
+                          dtPolyRef ref,
+                          F&& callback) {
+  const dtMeshTile* tile = nullptr;
+  const dtPoly* poly = nullptr;
+  navMesh->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+  for (unsigned int k = poly->firstLink; k != DT_NULL_LINK;
+       k = tile->links[k].next) {
+    const dtLink& link = tile->links[k];
+    if (!link.ref) {
+      continue;
+    }
+    const dtMeshTile* nextTile = nullptr;
+    const dtPoly* nextPoly = nullptr;
+    navMesh->getTileAndPolyByRefUnsafe(link.ref, &nextTile, &nextPoly);
+    if (!filter->passFilter(link.ref, nextTile, nextPoly)) {
+      continue;
+    }
+    const int v0 = poly->verts[link.edge];
+    const int v1 = poly->verts[(link.edge + 1) % poly->vertCount];
+    const vec3f portal =
+        0.5f * (Eigen::Map<const vec3f>(&tile->verts[v0 * 3]) +
+                Eigen::Map<const vec3f>(&tile->verts[v1 * 3]));
+    callback(link.ref, nextTile, nextPoly, portal);
+  }
+}
+
+/**
+ * Navmesh polygons clustered into regions of nearby polygons, with a portal
+ * on every edge shared by polygons of two different regions, see
+ * @ref PathFinder::buildPathHierarchy(). Distances between the portals of
+ * each region are precomputed, so a long path is first searched for over the
+ * portals and then refined on the polygons of the regions it passes.
+ */
+struct PathHierarchy {
+  struct Portal {
+    //! Polygons on either side of the shared edge, the first in regions[0]
+    dtPolyRef refs[2];
+    uint32_t regions[2];
+    //! Midpoint of the shared edge
+    vec3f position;
+  };
+
+  struct Edge {
+    uint32_t portal;
+    //! Region the edge passes through
+    uint32_t region;
+    float distance;
+  };
+
+  //! Region of every polygon the hierarchy covers
+  std::unordered_map<dtPolyRef, uint32_t> polyToRegion;
+  std::vector<Portal> portals;
+  //! Portals of region i are regionPortals[regionPortalOffsets[i]] up to
+  //! regionPortals[regionPortalOffsets[i + 1]], derived from portals
+  std::vector<uint32_t> regionPortalOffsets;
+  std::vector<uint32_t> regionPortals;
+  //! Edges from portal i are edges[edgeOffsets[i]] up to
+  //! edges[edgeOffsets[i + 1]]
+  std::vector<uint32_t> edgeOffsets;
+  std::vector<Edge> edges;
+
+  uint32_t numRegions() const { return regionPortalOffsets.size() - 1; }
+
+  //! Polygon of @p portal that's in @p region
+  static dtPolyRef portalRef(const Portal& portal, uint32_t region) {
+    return portal.refs[portal.regions[0] == region ? 0 : 1];
+  }
+};
+
+//! Fills @ref PathHierarchy::regionPortalOffsets and
+//! @ref PathHierarchy::regionPortals from the portals
+void indexRegionPortals(PathHierarchy& hierarchy, uint32_t numRegions) {
+  hierarchy.regionPortalOffsets.assign(numRegions + 1, 0);
+  for (const PathHierarchy::Portal& portal : hierarchy.portals) {
+    ++hierarchy.regionPortalOffsets[portal.regions[0] + 1];
+    ++hierarchy.regionPortalOffsets[portal.regions[1] + 1];
+  }
+  std::partial_sum(hierarchy.regionPortalOffsets.begin(),
+                   hierarchy.regionPortalOffsets.end(),
+                   hierarchy.regionPortalOffsets.begin());
+  hierarchy.regionPortals.resize(2 * hierarchy.portals.size());
+  std::vector<uint32_t> next(hierarchy.regionPortalOffsets.begin(),
+                             hierarchy.regionPortalOffsets.end() - 1);
+  for (uint32_t i = 0; i < hierarchy.portals.size(); ++i) {
+    for (const uint32_t region : hierarchy.portals[i].regions) {
+      hierarchy.regionPortals[next[region]++] = i;
+    }
+  }
+}
+
+/**
+ * Distances from @p position on polygon @p ref to every portal of @p region,
+ * in the order of @ref PathHierarchy::regionPortals. Measured through polygon
+ * centers and shared edge midpoints inside the region, like the distance
+ * field of @ref MultiGoalShortestPath. Unreachable portals are infinitely
+ * far.
+ */
+std::vector<float> regionPortalDistances(const dtNavMesh* navMesh,
+                                         const dtQueryFilter* filter,
+                                         const PathHierarchy& hierarchy,
+                                         const uint32_t region,
+                                         const dtPolyRef ref,
+                                         const vec3f& position) {
+  typedef std::pair<float, dtPolyRef> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue;
+  std::unordered_map<dtPolyRef, float> distances;
+  {
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+    const float distance = (polyCenter(tile, poly) - position).norm();
+    distances[ref] = distance;
+    queue.emplace(distance, ref);
+  }
+  while (!queue.empty()) {
+    const QueueEntry top = queue.top();
+    queue.pop();
+    if (top.first > distances.at(top.second)) {
+      continue;
+    }
+
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh->getTileAndPolyByRefUnsafe(top.second, &tile, &poly);
+    const vec3f center = polyCenter(tile, poly);
+    forEachNeighbourPoly(
+        navMesh, filter, top.second,
+        [&](dtPolyRef nextRef, const dtMeshTile* nextTile,
+            const dtPoly* nextPoly, const vec3f& portal) {
+          const auto found = hierarchy.polyToRegion.find(nextRef);
+          if (found == hierarchy.polyToRegion.end() ||
+              found->second != region) {
+            return;
+          }
+          const float distance =
+              top.first + (center - portal).norm() +
+              (portal - polyCenter(nextTile, nextPoly)).norm();
+          auto it = distances.find(nextRef);
+          if (it == distances.end() || distance < it->second) {
+            distances[nextRef] = distance;
+            queue.emplace(distance, nextRef);
+          }
+        });
+  }
+
+  const uint32_t begin = hierarchy.regionPortalOffsets[region];
+  const uint32_t end = hierarchy.regionPortalOffsets[region + 1];
+  std::vector<float> portalDistances(end - begin,
+                                     std::numeric_limits<float>::infinity());
+  for (uint32_t i = begin; i != end; ++i) {
+    const PathHierarchy::Portal& portal =
+        hierarchy.portals[hierarchy.regionPortals[i]];
+    const dtPolyRef portalRef = PathHierarchy::portalRef(portal, region);
+    // portals of the starting polygon are reached in a straight line
+    if (portalRef == ref) {
+      portalDistances[i - begin] = (portal.position - position).norm();
+      continue;
+    }
+    const auto found = distances.find(portalRef);
+    if (found == distances.end()) {
+      continue;
+    }
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh->getTileAndPolyByRefUnsafe(portalRef, &tile, &poly);
+    portalDistances[i - begin] =
+        found->second + (polyCenter(tile, poly) - portal.position).norm();
+  }
+  return portalDistances;
+}
+
+Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
+findPathHierarchical(const QueryState& state,
+                     const vec3f& start,
+                     const dtPolyRef startRef,
+                     const vec3f& pathStart,
+                     const vec3f& end,
+                     const dtPolyRef endRef,
+                     const vec3f& pathEnd) {
+  const PathHierarchy& hierarchy = *state.pathHierarchy;
+  const auto foundStart = hierarchy.polyToRegion.find(startRef);
+  const auto foundEnd = hierarchy.polyToRegion.find(endRef);
+  if (foundStart == hierarchy.polyToRegion.end() ||
+      foundEnd == hierarchy.polyToRegion.end()) {
+    return Cr::Containers::NullOpt;
+  }
+  const uint32_t startRegion = foundStart->second;
+  const uint32_t endRegion = foundEnd->second;
+
+  // paths inside a region or into a neighbouring one are short enough for
+  // the direct search
+  if (startRegion == endRegion) {
+    return Cr::Containers::NullOpt;
+  }
+  const uint32_t startBegin = hierarchy.regionPortalOffsets[startRegion];
+  const uint32_t startEnd = hierarchy.regionPortalOffsets[startRegion + 1];
+  for (uint32_t i = startBegin; i != startEnd; ++i) {
+    const PathHierarchy::Portal& portal =
+        hierarchy.portals[hierarchy.regionPortals[i]];
+    if (portal.regions[0] == endRegion || portal.regions[1] == endRegion) {
+      return Cr::Containers::NullOpt;
+    }
+  }
+
+  const std::vector<float> startDistances =
+      regionPortalDistances(state.navMesh, state.filter, hierarchy,
+                            startRegion, startRef, pathStart);
+  const std::vector<float> endDistances = regionPortalDistances(
+      state.navMesh, state.filter, hierarchy, endRegion, endRef, pathEnd);
+  std::unordered_map<uint32_t, float> distancesToEnd;
+  const uint32_t endBegin = hierarchy.regionPortalOffsets[endRegion];
+  for (std::size_t i = 0; i != endDistances.size(); ++i) {
+    if (endDistances[i] != std::numeric_limits<float>::infinity()) {
+      distancesToEnd[hierarchy.regionPortals[endBegin + i]] = endDistances[i];
+    }
+  }
+
+  // A* over the portals, with the end and the start as two extra nodes after
+  // them. The straight line distance to the end never overestimates.
+  const uint32_t endNode = hierarchy.portals.size();
+  const uint32_t startNode = endNode + 1;
+  struct Node {
+    float distance;
+    uint32_t parent;
+    //! Region passed between the parent and this node
+    uint32_t region;
+  };
+  std::unordered_map<uint32_t, Node> nodes;
+  typedef std::pair<float, uint32_t> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue;
+  auto estimate = [&](uint32_t node, float distance) {
+    return node == endNode
+               ? distance
+               : distance + (hierarchy.portals[node].position - pathEnd).norm();
+  };
+  auto visit = [&](uint32_t node, float distance, uint32_t parent,
+                   uint32_t region) {
+    auto it = nodes.find(node);
+    if (it != nodes.end() && it->second.distance <= distance) {
+      return;
+    }
+    nodes[node] = {distance, parent, region};
+    queue.emplace(estimate(node, distance), node);
+  };
+  for (std::size_t i = 0; i != startDistances.size(); ++i) {
+    if (startDistances[i] != std::numeric_limits<float>::infinity()) {
+      visit(hierarchy.regionPortals[startBegin + i], startDistances[i],
+            startNode, startRegion);
+    }
+  }
+  bool found = false;
+  while (!queue.empty()) {
+    const QueueEntry top = queue.top();
+    queue.pop();
+    if (top.second == endNode) {
+      found = true;
+      break;
+    }
+    const Node node = nodes.at(top.second);
+    if (top.first > estimate(top.second, node.distance)) {
+      continue;
+    }
+    const auto toEnd = distancesToEnd.find(top.second);
+    if (toEnd != distancesToEnd.end()) {
+      visit(endNode, node.distance + toEnd->second, top.second, endRegion);
+    }
+    for (uint32_t i = hierarchy.edgeOffsets[top.second];
+         i != hierarchy.edgeOffsets[top.second + 1]; ++i) {
+      const PathHierarchy::Edge& edge = hierarchy.edges[i];
+      visit(edge.portal, node.distance + edge.distance, top.second,
+            edge.region);
+    }
+  }
+  if (!found) {
+    return Cr::Containers::NullOpt;
+  }
+
+  std::vector<uint32_t> chain;
+  for (uint32_t node = endNode; node != startNode;
+       node = nodes.at(node).parent) {
+    chain.push_back(node);
+  }
+  std::reverse(chain.begin(), chain.end());
+
+  // every step between two portals is refined with a local search, and the
+  // polygon corridors of all steps are joined for a single straight path
+  static const int MAX_POLYS = 256;
+  dtPolyRef polys[MAX_POLYS];
+  std::vector<dtPolyRef> corridor;
+  std::unordered_map<dtPolyRef, std::size_t> corridorIndices;
+  dtPolyRef fromRef = startRef;
+  vec3f fromPosition = pathStart;
+  for (const uint32_t node : chain) {
+    const uint32_t region = nodes.at(node).region;
+    dtPolyRef toRef = endRef;
+    vec3f toPosition = pathEnd;
+    if (node != endNode) {
+      toRef = PathHierarchy::portalRef(hierarchy.portals[node], region);
+      toPosition = hierarchy.portals[node].position;
+    }
+
+    int numPolys = 0;
+    const dtStatus status = state.navQuery->findPath(
+        fromRef, toRef, fromPosition.data(), toPosition.data(), state.filter,
+        polys, &numPolys, MAX_POLYS);
+    if (status != DT_SUCCESS || numPolys == 0 ||
+        polys[numPolys - 1] != toRef) {
+      return Cr::Containers::NullOpt;
+    }
+    for (int i = 0; i < numPolys; ++i) {
+      // a step doubling back over polygons of earlier ones cuts the loop
+      const auto visited = corridorIndices.find(polys[i]);
+      if (visited != corridorIndices.end()) {
+        for (std::size_t j = visited->second + 1; j < corridor.size(); ++j) {
+          corridorIndices.erase(corridor[j]);
+        }
+        corridor.resize(visited->second + 1);
+        continue;
+      }
+      corridorIndices.emplace(polys[i], corridor.size());
+      corridor.push_back(polys[i]);
+    }
+
+    if (node != endNode) {
+      const PathHierarchy::Portal& portal = hierarchy.portals[node];
+      fromRef = portal.refs[portal.refs[0] == toRef ? 1 : 0];
+      fromPosition = portal.position;
+    }
+  }
+
+  int numPoints = 0;
+  std::vector<vec3f> points(corridor.size() + 2);
+  const dtStatus status = state.navQuery->findStraightPath(
+      start.data(), end.data(), corridor.data(), int(corridor.size()),
+      points[0].data(), nullptr, nullptr, &numPoints, int(points.size()));
+  if (status != DT_SUCCESS || numPoints == 0) {
+    return Cr::Containers::NullOpt;
+  }
+
+  points.resize(numPoints);
+
+  const float length = pathLength(points);
+
+  return std::make_tuple(length, std::move(points));
+}
+
+//! Sample layout of a top-down view. Sample (h, w) is at x = startx + w *
+//! metersPerPixel, z = startz + h * metersPerPixel.
+struct TopDownGrid {
+  float startx;
+  float startz;
+  float metersPerPixel;
+  int xResolution;
+  int zResolution;
+};
+
+//! Detail mesh triangle of a navmesh polygon
+struct TopDownTriangle {
+  vec3f a, b, c;
+  dtPolyRef ref;
+};
+
+/**
+ * Collects the detail triangles of every polygon passing @p filter whose
+ * height range overlaps [@p height - @p eps, @p height + @p eps].
+ */
+std::vector<TopDownTriangle> collectTopDownTriangles(
+    const dtNavMesh* navMesh,
+    const dtQueryFilter* filter,
+    const float height,
+    const float eps) {
+  std::vector<TopDownTriangle> triangles;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+        continue;
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (!filter->passFilter(ref, tile, poly))
+        continue;
+
+      const dtPolyDetail& detail = tile->detailMeshes[jPoly];
+      for (int kTri = 0; kTri < detail.triCount; ++kTri) {
+        const unsigned char* tri =
+            &tile->detailTris[(detail.triBase + kTri) * 4];
+        vec3f verts[3];
+        for (int l = 0; l < 3; ++l) {
+          const float* v =
+              tri[l] < poly->vertCount
+                  ? &tile->verts[poly->verts[tri[l]] * 3]
+                  : &tile->detailVerts[(detail.vertBase + tri[l] -
+                                        poly->vertCount) *
+                                       3];
+          verts[l] = Eigen::Map<const vec3f>(v);
+        }
+        const float minY = std::min({verts[0][1], verts[1][1], verts[2][1]});
+        const float maxY = std::max({verts[0][1], verts[1][1], verts[2][1]});
+        if (minY > height + eps || maxY < height - eps)
+          continue;
+        triangles.push_back({verts[0], verts[1], verts[2], ref});
+      }
+    }
+  }
+  return triangles;
+}
+
+/**
+ * Calls @p callback(h, w, ref, yDelta) for every sample in rows
+ * [@p rowBegin, @p rowEnd) of @p grid covered by one of @p triangles whose
+ * surface is within @p eps of @p height there.
+ */
+template <typename F>
+void rasterizeTopDownRows(const std::vector<TopDownTriangle>& triangles,
+                          const TopDownGrid& grid,
+                          const float height,
+                          const float eps,
+                          const int rowBegin,
+                          const int rowEnd,
+                          F&& callback) {
+  const auto edge = [](const vec3f& p0, const vec3f& p1, float x, float z) {
+    return (p1[0] - p0[0]) * (z - p0[2]) - (p1[2] - p0[2]) * (x - p0[0]);
+  };
+
+  for (const TopDownTriangle& tri : triangles) {
+    const float area = edge(tri.a, tri.b, tri.c[0], tri.c[2]);
+    if (std::abs(area) < 1e-12f)
+      continue;
+
+    const float minX = std::min({tri.a[0], tri.b[0], tri.c[0]});
+    const float maxX = std::max({tri.a[0], tri.b[0], tri.c[0]});
+    const float minZ = std::min({tri.a[2], tri.b[2], tri.c[2]});
+    const float maxZ = std::max({tri.a[2], tri.b[2], tri.c[2]});
+    const int wBegin = std::max(
+        0, static_cast<int>(
+               std::ceil((minX - grid.startx) / grid.metersPerPixel)));
+    const int wEnd = std::min(
+        grid.xResolution,
+        static_cast<int>(
+            std::floor((maxX - grid.startx) / grid.metersPerPixel)) +
+            1);
+    const int hBegin = std::max(
+        rowBegin, static_cast<int>(std::ceil((minZ - grid.startz) /
+                                             grid.metersPerPixel)));
+    const int hEnd = std::min(
+        rowEnd, static_cast<int>(std::floor((maxZ - grid.startz) /
+                                            grid.metersPerPixel)) +
+                    1);
+
+    for (int h = hBegin; h < hEnd; ++h) {
+      const float z = grid.startz + h * grid.metersPerPixel;
+      for (int w = wBegin; w < wEnd; ++w) {
+        const float x = grid.startx + w * grid.metersPerPixel;
+        // barycentric coordinates, inclusive of the edges so samples on
+        // edges shared by two triangles aren't lost
+        const float u = edge(tri.b, tri.c, x, z) / area;
+        const float v = edge(tri.c, tri.a, x, z) / area;
+        const float t = 1.0f - u - v;
+        if (u < -1e-5f || v < -1e-5f || t < -1e-5f)
+          continue;
+        const float yDelta =
+            std::abs(u * tri.a[1] + v * tri.b[1] + t * tri.c[1] - height);
+        if (yDelta <= eps)
+          callback(h, w, tri.ref, yDelta);
+      }
+    }
+  }
+}
+
+/**
+ * Runs @ref rasterizeTopDownRows over all rows of @p grid, split into bands
+ * across hardware threads. Bands are disjoint, so @p callback may write its
+ * sample without synchronization.
+ */
+template <typename F>
+void rasterizeTopDown(const dtNavMesh* navMesh,
+                      const dtQueryFilter* filter,
+                      const TopDownGrid& grid,
+                      const float height,
+                      const float eps,
+                      F&& callback) {
+  const std::vector<TopDownTriangle> triangles =
+      collectTopDownTriangles(navMesh, filter, height, eps);
+
+  // not worth a thread for less than a few dozen rows
+  const int numThreads = std::max(
+      1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                  grid.zResolution / 32));
+  if (numThreads == 1) {
+    rasterizeTopDownRows(triangles, grid, height, eps, 0, grid.zResolution,
+                         callback);
+    return;
+  }
+
+  const int rowsPerThread = (grid.zResolution + numThreads - 1) / numThreads;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 1; i < numThreads; ++i) {
+    const int rowBegin = i * rowsPerThread;
+    const int rowEnd = std::min(grid.zResolution, rowBegin + rowsPerThread);
+    workers.emplace_back([&, rowBegin, rowEnd]() {
+      rasterizeTopDownRows(triangles, grid, height, eps, rowBegin, rowEnd,
+                           callback);
+    });
+  }
+  rasterizeTopDownRows(triangles, grid, height, eps, 0,
+                       std::min(grid.zResolution, rowsPerThread), callback);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Distances from samples of the walkable surface on a top-down grid to the
+ * closest obstacle, see @ref PathFinder::buildObstacleDistanceField(). Cells
+ * above each other on several floors have a sample on each.
+ */
+struct ObstacleDistanceField {
+  //! Sample layout, the resolution is the number of samples along each axis
+  TopDownGrid grid;
+  //! Radius the obstacles were searched in, all distances are at most that
+  float maxSearchRadius;
+  //! Samples of cell i = h * grid.xResolution + w are
+  //! [cellOffsets[i], cellOffsets[i + 1]), sorted by height
+  std::vector<uint32_t> cellOffsets;
+  std::vector<float> heights;
+  std::vector<float> distances;
+};
+
+//! Largest height difference between a query point and the surface samples
+//! it's interpolated from, the default of PathFinder::isNavigable()
+constexpr float ObstacleDistanceMaxYDelta = 0.5f;
+
+//! Distance of the sample of cell (@p h, @p w) closest in height to @p y, or
+//! NaN if none is within ObstacleDistanceMaxYDelta
+float obstacleDistanceSample(const ObstacleDistanceField& field,
+                             const int h,
+                             const int w,
+                             const float y) {
+  const std::size_t cell = std::size_t(h) * field.grid.xResolution + w;
+  float distance = Mn::Constants::nan();
+  float bestYDelta = ObstacleDistanceMaxYDelta;
+  for (uint32_t i = field.cellOffsets[cell]; i != field.cellOffsets[cell + 1];
+       ++i) {
+    const float yDelta = std::abs(field.heights[i] - y);
+    if (yDelta <= bestYDelta) {
+      bestYDelta = yDelta;
+      distance = field.distances[i];
+    }
+  }
+  return distance;
+}
+
+//! Bilinearly interpolated distance at @p pt, NaN if any of the four
+//! surrounding samples is missing, such as next to the navmesh border
+float interpolateObstacleDistance(const ObstacleDistanceField& field,
+                                  const vec3f& pt) {
+  const TopDownGrid& grid = field.grid;
+  const float fx = (pt[0] - grid.startx) / grid.metersPerPixel;
+  const float fz = (pt[2] - grid.startz) / grid.metersPerPixel;
+  // negated so NaN coordinates are rejected as well
+  if (grid.xResolution < 2 || grid.zResolution < 2 ||
+      !(fx >= 0.0f && fz >= 0.0f && fx <= grid.xResolution - 1 &&
+        fz <= grid.zResolution - 1))
+    return Mn::Constants::nan();
+
+  const int w = std::min(static_cast<int>(fx), grid.xResolution - 2);
+  const int h = std::min(static_cast<int>(fz), grid.zResolution - 2);
+  const float tx = fx - w;
+  const float tz = fz - h;
+  const float d00 = obstacleDistanceSample(field, h, w, pt[1]);
+  const float d01 = obstacleDistanceSample(field, h, w + 1, pt[1]);
+  const float d10 = obstacleDistanceSample(field, h + 1, w, pt[1]);
+  const float d11 = obstacleDistanceSample(field, h + 1, w + 1, pt[1]);
+  return (d00 * (1.0f - tx) + d01 * tx) * (1.0f - tz) +
+         (d10 * (1.0f - tx) + d11 * tx) * tz;
+}
+
+//! Interpolated from the obstacle distance field if there's one covering
+//! @p pt, otherwise a findDistanceToWall() query
+float queryDistanceToClosestObstacle(const QueryState& state,
+                                     const vec3f& pt,
+                                     const float maxSearchRadius) {
+  if (state.obstacleDistanceField) {
+    const ObstacleDistanceField& field = *state.obstacleDistanceField;
+    const float distance = interpolateObstacleDistance(field, pt);
+    // distances saturated at the field radius only tell there's no obstacle
+    // within it, which isn't enough for a larger search radius
+    if (!std::isnan(distance) && (distance < field.maxSearchRadius ||
+                                  maxSearchRadius <= field.maxSearchRadius))
+      return std::min(distance, maxSearchRadius);
+  }
+  return queryClosestObstacleSurfacePoint(state, pt, maxSearchRadius).hitDist;
+}
+
+//! Detail triangles of a set of polygons with their cumulative areas, to draw
+//! uniformly distributed points from
+struct NavigableTriangles {
+  //! Three vertices per triangle
+  std::vector<Mn::Vector3> vertices;
+  //! Total area of the triangles up to and including each one. Double, as
+  //! large scenes sum up hundreds of thousands of small triangles.
+  std::vector<double> cumulativeAreas;
+};
+
+NavigableTriangles collectNavigableTriangles(
+    const dtNavMesh* navMesh,
+    const dtQueryFilter* filter,
+    const std::vector<dtPolyRef>& polys) {
+  NavigableTriangles triangles;
+  double area = 0.0;
+  for (const dtPolyRef ref : polys) {
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+    if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+        !filter->passFilter(ref, tile, poly))
+      continue;
+
+    const std::size_t jPoly = poly - tile->polys;
+    const dtPolyDetail& detail = tile->detailMeshes[jPoly];
+    for (int kTri = 0; kTri < detail.triCount; ++kTri) {
+      const unsigned char* tri = &tile->detailTris[(detail.triBase + kTri) * 4];
+      Mn::Vector3 verts[3];
+      for (int l = 0; l < 3; ++l) {
+        const float* v =
+            tri[l] < poly->vertCount
+                ? &tile->verts[poly->verts[tri[l]] * 3]
+                : &tile->detailVerts[(detail.vertBase + tri[l] -
+                                      poly->vertCount) *
+                                     3];
+        verts[l] = Mn::Vector3::from(v);
+      }
+      const float triangleArea =
+          0.5f * Mn::Math::cross(verts[1] - verts[0], verts[2] - verts[0])
+                     .length();
+      if (triangleArea <= 0.0f)
+        continue;
+      area += triangleArea;
+      triangles.vertices.insert(triangles.vertices.end(), verts, verts + 3);
+      triangles.cumulativeAreas.push_back(area);
+    }
+  }
+  return triangles;
+}
+
+//! SplitMix64 of @p counter in the stream of @p seed. Every random number is
+//! a pure function of both, so it doesn't matter which thread draws it.
+uint64_t counterRandom(uint64_t seed, uint64_t counter) {
+  uint64_t z = seed + (counter + 1) * 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+//! Point @p index of the random points drawn by
+//! @ref PathFinder::getRandomNavigablePoints()
+Mn::Vector3 sampleNavigableTriangles(const NavigableTriangles& triangles,
+                                     uint64_t seed,
+                                     std::size_t index) {
+  const uint64_t triangleBits = counterRandom(seed, 2 * uint64_t(index));
+  const uint64_t pointBits = counterRandom(seed, 2 * uint64_t(index) + 1);
+
+  // 53 random bits pick the triangle, 24 each the point on it
+  const double u = double(triangleBits >> 11) / double(uint64_t(1) << 53) *
+                   triangles.cumulativeAreas.back();
+  const std::size_t tri = std::min<std::size_t>(
+      std::upper_bound(triangles.cumulativeAreas.begin(),
+                       triangles.cumulativeAreas.end(), u) -
+          triangles.cumulativeAreas.begin(),
+      triangles.cumulativeAreas.size() - 1);
+  const float s = std::sqrt(float(pointBits >> 40) / float(1 << 24));
+  const float t = float((pointBits >> 16) & 0xffffff) / float(1 << 24);
+  const Mn::Vector3* v = &triangles.vertices[tri * 3];
+  return v[0] * (1.0f - s) + v[1] * (s * (1.0f - t)) + v[2] * (s * t);
+}
+}  // namespace
+
+struct PathFinder::Impl {
+  Impl();
+  ~Impl() = default;
+
+  bool build(const NavMeshSettings& bs,
+             const float* verts,
+             int nverts,
+             const int* tris,
+             int ntris,
+             const float* bmin,
+             const float* bmax);
+  bool build(const NavMeshSettings& bs, const esp::assets::MeshData& mesh);
+
+  //! @ref build with NavMeshSettings::tileSize set
+  bool buildTiled(const NavMeshSettings& bs,
+                  const float* verts,
+                  int nverts,
+                  const int* tris,
+                  int ntris,
+                  const float* bmin,
+                  const float* bmax);
+
+  vec3f getRandomNavigablePoint(int maxTries,
+                                int islandIndex /*= ID_UNDEFINED*/);
+  vec3f getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
+                                            float radius,
+                                            int maxTries,
+                                            int islandIndex /*= ID_UNDEFINED*/);
+  vec3f getRandomNavigablePointInCircle(const vec3f& circleCenter,
+                                        float radius,
+                                        int maxTries,
+                                        int islandIndex /*= ID_UNDEFINED*/);
+  std::vector<Mn::Vector3> getRandomNavigablePoints(std::size_t count,
+                                                    uint64_t seed,
+                                                    int islandIndex,
+                                                    int numThreads);
+
+  bool findPath(ShortestPath& path);
+  bool findPath(MultiGoalShortestPath& path);
+
+  int findPaths(std::vector<ShortestPath>& paths, int numThreads);
+
+  Eigen::MatrixXf geodesicDistanceMatrix(
+      const std::vector<Mn::Vector3>& points,
+      int numThreads);
+
+  std::vector<Mn::Vector3> trySteps(
+      const std::vector<Mn::Vector3>& starts,
+      const std::vector<Mn::Vector3>& ends,
+      std::vector<std::uint64_t>* polygonHints,
+      bool allowSliding,
+      int numThreads);
+
+  std::shared_ptr<const dtNavMesh> sharedNavMesh() const { return navMesh_; }
+
+  std::shared_ptr<const impl::IslandSystem> sharedIslandSystem() const {
+    return islandSystem_;
+  }
+
+  const dtQueryFilter& filter() const { return *filter_; }
+
+  template <typename T>
+  T tryStep(const T& start, const T& end, bool allowSliding);
+
+  Mn::Vector3 tryStep(const Mn::Vector3& start,
+                      const Mn::Vector3& end,
+                      std::uint64_t& polygonHint,
+                      bool allowSliding);
+
+  template <typename T>
+  T snapPoint(const T& pt, int islandIndex = ID_UNDEFINED);
+
+  template <typename T>
+  int getIsland(const T& pt) const;
+
+  bool loadNavMesh(const std::string& path);
+
+  bool saveNavMesh(const std::string& path);
+
+  bool isLoaded() const { return navMesh_ != nullptr; };
+
+  std::size_t getMemoryUsage() const;
+
+  float getNavigableArea(int islandIndex /*= ID_UNDEFINED*/) const {
+    return islandSystem_->getNavigableArea(islandIndex);
+  };
+
+  int numIslands();
+
+  void seed(uint32_t newSeed);
+
+  float islandRadius(const vec3f& pt) const;
+
+  float islandRadius(int islandIndex) const;
+
+  float distanceToClosestObstacle(const vec3f& pt,
+                                  float maxSearchRadius = 2.0) const;
+  HitRecord closestObstacleSurfacePoint(const vec3f& pt,
+                                        float maxSearchRadius = 2.0) const;
+  std::vector<float> distancesToClosestObstacle(
+      const std::vector<Mn::Vector3>& pts,
+      float maxSearchRadius,
+      int numThreads);
+
+  void buildObstacleDistanceField(float metersPerPixel,
+                                  float maxSearchRadius,
+                                  int numThreads);
+
+  bool hasObstacleDistanceField() const {
+    return obstacleDistanceField_ != nullptr;
+  }
+
+  void clearObstacleDistanceField() { obstacleDistanceField_ = nullptr; }
+
+  std::shared_ptr<const ObstacleDistanceField> sharedObstacleDistanceField()
+      const {
+    return obstacleDistanceField_;
+  }
+
+  void buildPathHierarchy(int regionSize, int numThreads);
+
+  bool hasPathHierarchy() const { return pathHierarchy_ != nullptr; }
+
+  void clearPathHierarchy() { pathHierarchy_ = nullptr; }
+
+  std::shared_ptr<const PathHierarchy> sharedPathHierarchy() const {
+    return pathHierarchy_;
+  }
+
+  bool isNavigable(const vec3f& pt, float maxYDelta = 0.5) const;
+
+  std::pair<vec3f, vec3f> bounds() const { return bounds_; };
+
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
+  getTopDownView(float metersPerPixel, float height, float eps, bool rasterize);
+
+  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> getTopDownIslandView(
+      float metersPerPixel,
+      float height,
+      float eps,
+      bool rasterize);
+
+  assets::MeshData::ptr getNavMeshData(int islandIndex /*= ID_UNDEFINED*/);
+
+  std::map<std::pair<int, int>, uint64_t> getNavMeshTileRevisions() const {
+    return tileRevisions_;
+  }
+
+  assets::MeshData::ptr getNavMeshTileData(int tileX, int tileZ) const;
+
+  Cr::Containers::Optional<NavMeshSettings> getNavMeshSettings() const {
+    return navMeshSettings_;
+  }
+
+ private:
+  //! Search node pool size of every dtNavMeshQuery
+  static constexpr int QueryMaxNodes = 2048;
+
+  struct NavMeshDeleter {
+    void operator()(dtNavMesh* mesh) { dtFreeNavMesh(mesh); }
+  };
+  struct NavQueryDeleter {
+    void operator()(dtNavMeshQuery* query) { dtFreeNavMeshQuery(query); }
+  };
+
+  //! Shared with every @ref PathFinderQueryContext created from it, which
+  //! keeps the navmesh alive even if this one gets rebuilt or reloaded.
+  std::shared_ptr<dtNavMesh> navMesh_ = nullptr;
+  std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> navQuery_ = nullptr;
+  std::unique_ptr<dtQueryFilter> filter_ = nullptr;
+  std::shared_ptr<impl::IslandSystem> islandSystem_ = nullptr;
+
+  //! Additional queries on @ref navMesh_ used by the worker threads of
+  //! @ref findPaths and @ref trySteps, since a dtNavMeshQuery can't be shared
+  //! between threads. Grown on demand and reset with navQuery_.
+  std::vector<std::unique_ptr<dtNavMeshQuery, NavQueryDeleter>>
+      workerQueries_;
+
+  //! Holds triangulated geom/topo. Generated when queried. Reset with
+  //! navQuery_.
+  std::unordered_map<int, assets::MeshData::ptr> islandMeshData_;
+  //! Top-down views keyed by (metersPerPixel, height, eps, rasterize).
+  //! Generated when queried. Reset with navQuery_.
+  typedef std::tuple<float, float, float, bool> TopDownViewKey;
+  std::map<TopDownViewKey, Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>>
+      topDownViews_;
+  std::map<TopDownViewKey, Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>>
+      topDownIslandViews_;
+  //! Built by @ref buildObstacleDistanceField or loaded with the navmesh.
+  //! Reset with navQuery_.
+  std::shared_ptr<const ObstacleDistanceField> obstacleDistanceField_;
+  //! Built by @ref buildPathHierarchy or loaded with the navmesh. Reset with
+  //! navQuery_.
+  std::shared_ptr<const PathHierarchy> pathHierarchy_;
+  //! Sampling distributions of @ref getRandomNavigablePoints per island,
+  //! ID_UNDEFINED for the full navmesh. Generated when queried. Reset with
+  //! navQuery_.
+  std::unordered_map<int, NavigableTriangles> navigableTriangles_;
+  Cr::Containers::Optional<NavMeshSettings> navMeshSettings_;
+
+  //! Inputs of the last tiled @ref build, so the next one on the same tile
+  //! grid only rebuilds the tiles whose input triangles changed
+  struct TiledBuild {
+    NavMeshSettings settings;
+    vec3f bmin, bmax;
+    int tilesX, tilesZ;
+    //! Hash of the input triangles of each tile, row-major
+    std::vector<uint64_t> inputHashes;
+  };
+  Cr::Containers::Optional<TiledBuild> tiledBuild_;
+
+  //! Revision of each tile of navMesh_ by its (x, z) grid location, see
+  //! @ref PathFinder::getNavMeshTileRevisions(). Renewed with navQuery_.
+  std::map<std::pair<int, int>, uint64_t> tileRevisions_;
+  //! Identifies the navmesh in navMesh_, as a freed navmesh's address may be
+  //! reused by the next one. Renewed with navQuery_.
+  uint64_t navMeshGeneration_ = 0;
+
+  std::pair<vec3f, vec3f> bounds_;
+
+  //! Reinitializes the queries on navMesh_ and the per-navmesh caches. Islands
+  //! are recomputed unless @p islandSystem is passed.
+  bool initNavQuery(std::shared_ptr<impl::IslandSystem> islandSystem = nullptr);
+
+  //! Read-only query state on navQuery_, or on another query of the same
+  //! navmesh.
+  QueryState queryState(dtNavMeshQuery* navQuery = nullptr) const {
+    return {navMesh_.get(), navQuery ? navQuery : navQuery_.get(),
+            filter_.get(), islandSystem_.get(), obstacleDistanceField_.get(),
+            pathHierarchy_.get()};
+  }
+
+  //! Clamps @p numThreads to [1, @p numItems], defaulting to the number of
+  //! hardware threads, and makes sure there's a worker query for each thread
+  //! but the calling one.
+  int prepareWorkerQueries(int numThreads, std::size_t numItems);
+
+  bool findPathSetup(MultiGoalShortestPath& path,
+                     dtPolyRef& startRef,
+                     vec3f& pathStart);
+
+  //! Sample layout of the top-down views at @p metersPerPixel
+  TopDownGrid topDownGrid(float metersPerPixel) const;
+
+  //! Dijkstra from all valid ends of @p path over the polygon graph
+  void buildDistanceField(MultiGoalShortestPath& path) const;
+
+  bool findPathWithDistanceField(MultiGoalShortestPath& path,
+                                 dtPolyRef startRef,
+                                 const vec3f& pathStart);
+};
+
+namespace {
+struct Workspace {
+  rcHeightfield* solid = nullptr;
+  unsigned char* triareas = nullptr;
+  rcCompactHeightfield* chf = nullptr;
+  rcContourSet* cset = nullptr;
+  rcPolyMesh* pmesh = nullptr;
+  rcPolyMeshDetail* dmesh = nullptr;
+
+  ~Workspace() {
+    rcFreeHeightField(solid);
+    delete[] triareas;
+    rcFreeCompactHeightfield(chf);
+    rcFreeContourSet(cset);
+    rcFreePolyMesh(pmesh);
+    rcFreePolyMeshDetail(dmesh);
+  }
+};
+
+enum PolyAreas { POLYAREA_GROUND, POLYAREA_DOOR };
+
+enum PolyFlags {
+  POLYFLAGS_WALK = 0x01,      // walkable
+  POLYFLAGS_DOOR = 0x02,      // ability to move through doors
+  POLYFLAGS_DISABLED = 0x04,  // disabled polygon
+  POLYFLAGS_OFF_ISLAND =
+      0x08,               // dynamically set to filter all but a specific island
+  POLYFLAGS_ALL = 0xffff  // all abilities
+};
+}  // namespace
+
+PathFinder::Impl::Impl() {
+  filter_ = std::make_unique<dtQueryFilter>();
+  filter_->setIncludeFlags(POLYFLAGS_WALK);
+  filter_->setExcludeFlags(0);
+}
+
+namespace {
+//! Recast configuration for building the whole area within @p bmin and
+//! @p bmax as a single tile
+rcConfig navMeshConfig(const NavMeshSettings& bs,
+                       const float* bmin,
+                       const float* bmax) {
   //
   // Step 1. Initialize build config.
   //
@@ -646,8 +1923,34 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   rcVcopy(cfg.bmin, bmin);
   rcVcopy(cfg.bmax, bmax);
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-  ESP_DEBUG() << "Building navmesh with" << cfg.width << "x" << cfg.height
-              << "cells";
+  return cfg;
+}
+
+/**
+ * Runs the Recast pipeline on the triangles @p tris within the bounds of
+ * @p cfg and packs the result as Detour data for tile (@p tileX, @p tileY).
+ *
+ * Safe to call from several threads at once. On success, @p navData is
+ * nullptr if the area holds no polygons; otherwise it's to be freed with
+ * dtFree() or handed over to a dtNavMesh.
+ */
+bool buildNavMeshData(const NavMeshSettings& bs,
+                      const rcConfig& cfg,
+                      const float* verts,
+                      const int nverts,
+                      const int* tris,
+                      const int ntris,
+                      const int tileX,
+                      const int tileY,
+                      unsigned char*& navData,
+                      int& navDataSize) {
+  Workspace ws;
+  rcContext ctx;
+  navData = nullptr;
+  navDataSize = 0;
+  if (ntris == 0) {
+    return true;
+  }
 
   //
   // Step 2. Rasterize input polygon soup.
@@ -771,7 +2074,7 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     return false;
   }
   // Partition the walkable surface into simple regions without holes.
-  if (!rcBuildRegions(&ctx, *ws.chf, 0, cfg.minRegionArea,
+  if (!rcBuildRegions(&ctx, *ws.chf, cfg.borderSize, cfg.minRegionArea,
                       cfg.mergeRegionArea)) {
     ESP_ERROR() << "Could not build watershed regions";
     return false;
@@ -836,109 +2139,416 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
   // access the data.
 
   //
-  // (Optional) Step 8. Create Detour data from Recast poly mesh.
+  // Step 8. Create Detour data from Recast poly mesh.
   //
 
+  // Nothing walkable in this tile
+  if (ws.pmesh->npolys == 0) {
+    return true;
+  }
+
+  // Update poly flags from areas.
+  for (int i = 0; i < ws.pmesh->npolys; ++i) {
+    if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
+      ws.pmesh->areas[i] = POLYAREA_GROUND;
+    }
+    if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK;
+    } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
+      ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
+    }
+  }
+
+  dtNavMeshCreateParams params{};
+  memset(&params, 0, sizeof(params));
+  params.verts = ws.pmesh->verts;
+  params.vertCount = ws.pmesh->nverts;
+  params.polys = ws.pmesh->polys;
+  params.polyAreas = ws.pmesh->areas;
+  params.polyFlags = ws.pmesh->flags;
+  params.polyCount = ws.pmesh->npolys;
+  params.nvp = ws.pmesh->nvp;
+  params.detailMeshes = ws.dmesh->meshes;
+  params.detailVerts = ws.dmesh->verts;
+  params.detailVertsCount = ws.dmesh->nverts;
+  params.detailTris = ws.dmesh->tris;
+  params.detailTriCount = ws.dmesh->ntris;
+  // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
+  // params.offMeshConRad = geom->getOffMeshConnectionRads();
+  // params.offMeshConDir = geom->getOffMeshConnectionDirs();
+  // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
+  // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
+  // params.offMeshConUserID = geom->getOffMeshConnectionId();
+  // params.offMeshConCount = geom->getOffMeshConnectionCount();
+  params.walkableHeight = bs.agentHeight;
+  params.walkableRadius = bs.agentRadius;
+  params.walkableClimb = bs.agentMaxClimb;
+  params.tileX = tileX;
+  params.tileY = tileY;
+  rcVcopy(params.bmin, ws.pmesh->bmin);
+  rcVcopy(params.bmax, ws.pmesh->bmax);
+  params.cs = cfg.cs;
+  params.ch = cfg.ch;
+  params.buildBvTree = true;
+
+  if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
+    ESP_ERROR() << "Could not build Detour navmesh";
+    return false;
+  }
+
+  return true;
+}
+
+//! FNV-1a over the triangle vertices referenced by @p indices, identifying
+//! the input of one tile
+uint64_t hashTileInput(const float* verts, const std::vector<int>& indices) {
+  uint64_t hash = 14695981039346656037ull;
+  for (int index : indices) {
+    const unsigned char* bytes =
+        reinterpret_cast<const unsigned char*>(&verts[index * 3]);
+    for (std::size_t i = 0; i < 3 * sizeof(float); ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+}  // namespace
+
+bool PathFinder::Impl::build(const NavMeshSettings& bs,
+                             const float* verts,
+                             const int nverts,
+                             const int* tris,
+                             const int ntris,
+                             const float* bmin,
+                             const float* bmax) {
   // The GUI may allow more max points per polygon than Detour can handle.
   // Only build the detour navmesh if we do not exceed the limit.
-  if (cfg.maxVertsPerPoly <= DT_VERTS_PER_POLYGON) {
-    unsigned char* navData = nullptr;
-    int navDataSize = 0;
-
-    // Update poly flags from areas.
-    for (int i = 0; i < ws.pmesh->npolys; ++i) {
-      if (ws.pmesh->areas[i] == RC_WALKABLE_AREA) {
-        ws.pmesh->areas[i] = POLYAREA_GROUND;
-      }
-      if (ws.pmesh->areas[i] == POLYAREA_GROUND) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK;
-      } else if (ws.pmesh->areas[i] == POLYAREA_DOOR) {
-        ws.pmesh->flags[i] = POLYFLAGS_WALK | POLYFLAGS_DOOR;
+  if (static_cast<int>(bs.vertsPerPoly) > DT_VERTS_PER_POLYGON) {
+    ESP_ERROR() << "cfg.maxVertsPerPoly(" << static_cast<int>(bs.vertsPerPoly)
+                << ") > DT_VERTS_PER_POLYGON(" << DT_VERTS_PER_POLYGON
+                << "), so cannot build the Detour NavMesh. Aborting NavMesh "
+                   "construction.";
+    return false;
+  }
+
+  if (bs.tileSize > 0) {
+    return buildTiled(bs, verts, nverts, tris, ntris, bmin, bmax);
+  }
+
+  const rcConfig cfg = navMeshConfig(bs, bmin, bmax);
+  ESP_DEBUG() << "Building navmesh with" << cfg.width << "x" << cfg.height
+              << "cells";
+
+  unsigned char* navData = nullptr;
+  int navDataSize = 0;
+  if (!buildNavMeshData(bs, cfg, verts, nverts, tris, ntris, 0, 0, navData,
+                        navDataSize)) {
+    return false;
+  }
+  if (!navData) {
+    ESP_ERROR() << "Could not build Detour navmesh, nothing is walkable";
+    return false;
+  }
+
+  navMesh_.reset(dtAllocNavMesh(), NavMeshDeleter{});
+  if (!navMesh_) {
+    dtFree(navData);
+    ESP_ERROR() << "Could not allocate Detour navmesh";
+    return false;
+  }
+
+  dtStatus status = 0;
+  status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
+  if (dtStatusFailed(status)) {
+    dtFree(navData);
+    ESP_ERROR() << "Could not init Detour navmesh";
+    return false;
+  }
+  tiledBuild_ = Cr::Containers::NullOpt;
+  if (!initNavQuery()) {
+    return false;
+  }
+  navMeshSettings_ = {bs};
+
+  bounds_ = std::make_pair(vec3f(bmin), vec3f(bmax));
+
+  const dtMeshTile* tile =
+      const_cast<const dtNavMesh*>(navMesh_.get())->getTile(0);
+  ESP_DEBUG() << "Created navmesh with" << tile->header->vertCount
+              << "vertices" << tile->header->polyCount << "polygons";
+
+  return true;
+}
+
+bool PathFinder::Impl::buildTiled(const NavMeshSettings& bs,
+                                  const float* verts,
+                                  const int nverts,
+                                  const int* tris,
+                                  const int ntris,
+                                  const float* bmin,
+                                  const float* bmax) {
+  rcConfig cfg = navMeshConfig(bs, bmin, bmax);
+  cfg.tileSize = static_cast<int>(ceilf(bs.tileSize / cfg.cs));
+  cfg.borderSize = cfg.walkableRadius + 3;
+  const int tilesX = (cfg.width + cfg.tileSize - 1) / cfg.tileSize;
+  const int tilesZ = (cfg.height + cfg.tileSize - 1) / cfg.tileSize;
+  cfg.width = cfg.tileSize + cfg.borderSize * 2;
+  cfg.height = cfg.tileSize + cfg.borderSize * 2;
+  const int numTiles = tilesX * tilesZ;
+
+  // same bit split as the Recast demo: up to 2^14 tiles, the remainder of 22
+  // bits for polygons, leaving 10 for the salt
+  const int tileBits =
+      std::max(1, static_cast<int>(dtIlog2(dtNextPow2(numTiles))));
+  if (tileBits > 14) {
+    ESP_ERROR() << "Navmesh would need" << numTiles
+                << "tiles, more than fit into a polygon reference. Increase "
+                   "NavMeshSettings::tileSize.";
+    return false;
+  }
+  const int polyBits = 22 - tileBits;
+  const float tileWorldSize = cfg.tileSize * cfg.cs;
+  const float borderWorldSize = cfg.borderSize * cfg.cs;
+  ESP_DEBUG() << "Building navmesh with" << tilesX << "x" << tilesZ
+              << "tiles of" << cfg.tileSize << "x" << cfg.tileSize << "cells";
+
+  // bucket triangles into every tile their XZ bounds touch, border included
+  std::vector<std::vector<int>> tileTris(numTiles);
+  for (int i = 0; i < ntris; ++i) {
+    float triMin[2] = {std::numeric_limits<float>::max(),
+                       std::numeric_limits<float>::max()};
+    float triMax[2] = {std::numeric_limits<float>::lowest(),
+                       std::numeric_limits<float>::lowest()};
+    for (int j = 0; j < 3; ++j) {
+      const float* v = &verts[tris[i * 3 + j] * 3];
+      triMin[0] = std::min(triMin[0], v[0]);
+      triMax[0] = std::max(triMax[0], v[0]);
+      triMin[1] = std::min(triMin[1], v[2]);
+      triMax[1] = std::max(triMax[1], v[2]);
+    }
+    const auto tileCoord = [&](float coord, float origin, int numTilesAxis) {
+      const int tile =
+          static_cast<int>(std::floor((coord - origin) / tileWorldSize));
+      return std::max(0, std::min(tile, numTilesAxis - 1));
+    };
+    const int x0 = tileCoord(triMin[0] - borderWorldSize, bmin[0], tilesX);
+    const int x1 = tileCoord(triMax[0] + borderWorldSize, bmin[0], tilesX);
+    const int z0 = tileCoord(triMin[1] - borderWorldSize, bmin[2], tilesZ);
+    const int z1 = tileCoord(triMax[1] + borderWorldSize, bmin[2], tilesZ);
+    for (int z = z0; z <= z1; ++z) {
+      for (int x = x0; x <= x1; ++x) {
+        tileTris[z * tilesX + x].push_back(i);
       }
     }
+  }
 
-    dtNavMeshCreateParams params{};
-    memset(&params, 0, sizeof(params));
-    params.verts = ws.pmesh->verts;
-    params.vertCount = ws.pmesh->nverts;
-    params.polys = ws.pmesh->polys;
-    params.polyAreas = ws.pmesh->areas;
-    params.polyFlags = ws.pmesh->flags;
-    params.polyCount = ws.pmesh->npolys;
-    params.nvp = ws.pmesh->nvp;
-    params.detailMeshes = ws.dmesh->meshes;
-    params.detailVerts = ws.dmesh->verts;
-    params.detailVertsCount = ws.dmesh->nverts;
-    params.detailTris = ws.dmesh->tris;
-    params.detailTriCount = ws.dmesh->ntris;
-    // params.offMeshConVerts = geom->getOffMeshConnectionVerts();
-    // params.offMeshConRad = geom->getOffMeshConnectionRads();
-    // params.offMeshConDir = geom->getOffMeshConnectionDirs();
-    // params.offMeshConAreas = geom->getOffMeshConnectionAreas();
-    // params.offMeshConFlags = geom->getOffMeshConnectionFlags();
-    // params.offMeshConUserID = geom->getOffMeshConnectionId();
-    // params.offMeshConCount = geom->getOffMeshConnectionCount();
-    params.walkableHeight = bs.agentHeight;
-    params.walkableRadius = bs.agentRadius;
-    params.walkableClimb = bs.agentMaxClimb;
-    rcVcopy(params.bmin, ws.pmesh->bmin);
-    rcVcopy(params.bmax, ws.pmesh->bmax);
-    params.cs = cfg.cs;
-    params.ch = cfg.ch;
-    params.buildBvTree = true;
-
-    if (!dtCreateNavMeshData(&params, &navData, &navDataSize)) {
-      ESP_ERROR() << "Could not build Detour navmesh";
-      return false;
+  // only tiles whose input changed since the previous tiled build on the same
+  // grid need to go through Recast again
+  std::vector<uint64_t> inputHashes(numTiles);
+  std::vector<std::vector<int>> tileIndices(numTiles);
+  for (int i = 0; i < numTiles; ++i) {
+    tileIndices[i].reserve(tileTris[i].size() * 3);
+    for (int tri : tileTris[i]) {
+      tileIndices[i].insert(tileIndices[i].end(), &tris[tri * 3],
+                            &tris[tri * 3 + 3]);
+    }
+    inputHashes[i] = hashTileInput(verts, tileIndices[i]);
+  }
+  // whether static objects were included only shows in the input itself
+  NavMeshSettings gridSettings = bs;
+  gridSettings.includeStaticObjects = false;
+  const bool incremental =
+      navMesh_ && tiledBuild_ && tiledBuild_->settings == gridSettings &&
+      tiledBuild_->tilesX == tilesX && tiledBuild_->tilesZ == tilesZ &&
+      (tiledBuild_->bmin - vec3f(bmin)).cwiseAbs().maxCoeff() < 1e-5f &&
+      (tiledBuild_->bmax - vec3f(bmax)).cwiseAbs().maxCoeff() < 1e-5f;
+  std::vector<int> dirtyTiles;
+  for (int i = 0; i < numTiles; ++i) {
+    if (!incremental || inputHashes[i] != tiledBuild_->inputHashes[i]) {
+      dirtyTiles.push_back(i);
     }
+  }
 
-    navMesh_.reset(dtAllocNavMesh());
-    if (!navMesh_) {
-      dtFree(navData);
-      ESP_ERROR() << "Could not allocate Detour navmesh";
-      return false;
+  struct TileData {
+    unsigned char* data = nullptr;
+    int size = 0;
+    bool success = false;
+  };
+  std::vector<TileData> builtTiles(dirtyTiles.size());
+  std::atomic<std::size_t> nextTile{0};
+  const auto work = [&]() {
+    for (std::size_t i = nextTile++; i < dirtyTiles.size(); i = nextTile++) {
+      const int tile = dirtyTiles[i];
+      const int x = tile % tilesX;
+      const int z = tile / tilesX;
+      rcConfig tileCfg = cfg;
+      tileCfg.bmin[0] = bmin[0] + x * tileWorldSize - borderWorldSize;
+      tileCfg.bmin[2] = bmin[2] + z * tileWorldSize - borderWorldSize;
+      tileCfg.bmax[0] = bmin[0] + (x + 1) * tileWorldSize + borderWorldSize;
+      tileCfg.bmax[2] = bmin[2] + (z + 1) * tileWorldSize + borderWorldSize;
+      builtTiles[i].success = buildNavMeshData(
+          bs, tileCfg, verts, nverts, tileIndices[tile].data(),
+          static_cast<int>(tileIndices[tile].size() / 3), x, z,
+          builtTiles[i].data,
+          builtTiles[i].size);
     }
+  };
+  const int numThreads = std::max(
+      1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                  static_cast<int>(dirtyTiles.size())));
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 1; i < numThreads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
 
-    dtStatus status = 0;
-    status = navMesh_->init(navData, navDataSize, DT_TILE_FREE_DATA);
-    if (dtStatusFailed(status)) {
-      dtFree(navData);
-      ESP_ERROR() << "Could not init Detour navmesh";
-      return false;
+  bool success = true;
+  for (const TileData& tile : builtTiles) {
+    success = success && tile.success;
+  }
+  if (!success) {
+    for (const TileData& tile : builtTiles) {
+      dtFree(tile.data);
     }
-    if (!initNavQuery()) {
-      return false;
+    return false;
+  }
+
+  // Assemble into a new navmesh rather than patching the current one, which
+  // might still be queried through a PathFinderQueryContext. Tiles that
+  // didn't change are copied over.
+  std::shared_ptr<dtNavMesh> navMesh{dtAllocNavMesh(), NavMeshDeleter{}};
+  if (!navMesh) {
+    for (const TileData& tile : builtTiles) {
+      dtFree(tile.data);
     }
-    navMeshSettings_ = {bs};
-  } else {
-    ESP_ERROR() << "cfg.maxVertsPerPoly(" << cfg.maxVertsPerPoly
-                << ") > DT_VERTS_PER_POLYGON(" << DT_VERTS_PER_POLYGON
-                << "), so cannot build the Detour NavMesh. Aborting NavMesh "
-                   "construction.";
+    ESP_ERROR() << "Could not allocate Detour navmesh";
+    return false;
+  }
+  dtNavMeshParams params{};
+  rcVcopy(params.orig, bmin);
+  params.tileWidth = tileWorldSize;
+  params.tileHeight = tileWorldSize;
+  params.maxTiles = 1 << tileBits;
+  params.maxPolys = 1 << polyBits;
+  if (dtStatusFailed(navMesh->init(&params))) {
+    for (const TileData& tile : builtTiles) {
+      dtFree(tile.data);
+    }
+    ESP_ERROR() << "Could not init Detour navmesh";
+    return false;
+  }
+
+  const auto addTile = [&](unsigned char* data, int size) {
+    if (dtStatusFailed(
+            navMesh->addTile(data, size, DT_TILE_FREE_DATA, 0, nullptr))) {
+      dtFree(data);
+      success = false;
+    }
+  };
+  if (incremental) {
+    const dtNavMesh* oldNavMesh = navMesh_.get();
+    std::size_t nextDirty = 0;
+    for (int i = 0; i < numTiles; ++i) {
+      if (nextDirty < dirtyTiles.size() && dirtyTiles[nextDirty] == i) {
+        ++nextDirty;
+        continue;
+      }
+      const dtMeshTile* tile = oldNavMesh->getTileAt(i % tilesX, i / tilesX, 0);
+      if (!tile || !tile->header || tile->dataSize == 0)
+        continue;
+      unsigned char* data = static_cast<unsigned char*>(
+          dtAlloc(tile->dataSize, DT_ALLOC_PERM));
+      memcpy(data, tile->data, tile->dataSize);
+      addTile(data, tile->dataSize);
+    }
+  }
+  for (const TileData& tile : builtTiles) {
+    if (tile.data)
+      addTile(tile.data, tile.size);
+  }
+  if (!success) {
+    ESP_ERROR() << "Could not add tiles to Detour navmesh";
     return false;
   }
 
+  navMesh_ = std::move(navMesh);
+  std::map<std::pair<int, int>, uint64_t> previousTileRevisions =
+      std::move(tileRevisions_);
+  if (!initNavQuery()) {
+    tiledBuild_ = Cr::Containers::NullOpt;
+    return false;
+  }
+  // tiles copied over from the previous navmesh are still the same
+  if (incremental) {
+    std::size_t nextDirty = 0;
+    for (int i = 0; i < numTiles; ++i) {
+      if (nextDirty < dirtyTiles.size() && dirtyTiles[nextDirty] == i) {
+        ++nextDirty;
+        continue;
+      }
+      const std::pair<int, int> location{i % tilesX, i / tilesX};
+      const auto found = previousTileRevisions.find(location);
+      if (found != previousTileRevisions.end() &&
+          tileRevisions_.count(location)) {
+        tileRevisions_[location] = found->second;
+      }
+    }
+  }
+  navMeshSettings_ = {bs};
   bounds_ = std::make_pair(vec3f(bmin), vec3f(bmax));
+  tiledBuild_ = TiledBuild{gridSettings, vec3f(bmin), vec3f(bmax),
+                           tilesX,       tilesZ,      std::move(inputHashes)};
 
-  ESP_DEBUG() << "Created navmesh with" << ws.pmesh->nverts << "vertices"
-              << ws.pmesh->npolys << "polygons";
+  ESP_DEBUG() << "Built" << dirtyTiles.size() << "of" << numTiles
+              << "navmesh tiles";
 
   return true;
 }
 
-bool PathFinder::Impl::initNavQuery() {
+bool PathFinder::Impl::initNavQuery(
+    std::shared_ptr<impl::IslandSystem> islandSystem) {
   // if we are reinitializing the NavQuery, then also reset the MeshData
   islandMeshData_.clear();
+  topDownViews_.clear();
+  topDownIslandViews_.clear();
+  navigableTriangles_.clear();
+  obstacleDistanceField_ = nullptr;
+  pathHierarchy_ = nullptr;
+  workerQueries_.clear();
+
+  // shared by all instances, so a tile or navmesh of one PathFinder is never
+  // mistaken for the same one of another
+  static std::atomic<uint64_t> lastTileRevision{0};
+  static std::atomic<uint64_t> lastNavMeshGeneration{0};
+  navMeshGeneration_ = ++lastNavMeshGeneration;
+  tileRevisions_.clear();
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+    const dtMeshTile* tile = navMesh->getTile(i);
+    if (tile && tile->header) {
+      tileRevisions_[{tile->header->x, tile->header->y}] = ++lastTileRevision;
+    }
+  }
 
   navQuery_.reset(dtAllocNavMeshQuery());
-  dtStatus status = navQuery_->init(navMesh_.get(), 2048);
+  dtStatus status = navQuery_->init(navMesh_.get(), QueryMaxNodes);
   if (dtStatusFailed(status)) {
     ESP_ERROR() << "Could not init Detour navmesh query";
     return false;
   }
 
+  // precomputed islands were saved after the zero area polys were disabled
+  if (islandSystem) {
+    islandSystem_ = std::move(islandSystem);
+    return true;
+  }
+
   islandSystem_ =
-      std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+      std::make_shared<impl::IslandSystem>(navMesh_.get(), filter_.get());
 
   // Added as we also need to remove these on navmesh recomputation
   islandSystem_->removeZeroAreaPolys(navMesh_.get());
@@ -973,7 +2583,14 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
 
 namespace {
 const int NAVMESHSET_MAGIC = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';  //'MSET';
-const int NAVMESHSET_VERSION = 2;
+//! Version 3 added NavMeshSettings::tileSize, version 4 the islands after the
+//! tiles, version 5 the optional obstacle distance field after the islands,
+//! version 6 the optional path hierarchy after that
+const int NAVMESHSET_VERSION = 6;
+const int OBSTACLE_DISTANCES_MAGIC =
+    'O' << 24 | 'D' << 16 | 'S' << 8 | 'T';  //'ODST';
+const int PATH_HIERARCHY_MAGIC =
+    'P' << 24 | 'H' << 16 | 'R' << 8 | 'C';  //'PHRC';
 
 struct NavMeshSetHeader {
   int magic;
@@ -1081,34 +2698,384 @@ void impl::IslandSystem::removeZeroAreaPolys(dtNavMesh* navMesh) {
   islandsToArea_[ID_UNDEFINED] = totalArea;
 }
 
+namespace {
+const int ISLANDS_MAGIC = 'I' << 24 | 'S' << 16 | 'L' << 8 | 'D';  //'ISLD';
+}  // namespace
+
+void impl::IslandSystem::serialize(FILE* fp) const {
+  const auto area = [&](uint32_t island) {
+    auto it = islandsToArea_.find(island);
+    return it == islandsToArea_.end() ? 0.0f : it->second;
+  };
+
+  const int numIslands = islandRadius_.size();
+  const float totalArea = area(ID_UNDEFINED);
+  fwrite(&ISLANDS_MAGIC, sizeof(int), 1, fp);
+  fwrite(&numIslands, sizeof(int), 1, fp);
+  fwrite(&totalArea, sizeof(float), 1, fp);
+  for (int i = 0; i < numIslands; ++i) {
+    const float islandArea = area(i);
+    const std::vector<dtPolyRef>& polys = islandsToPolys_.at(i);
+    const int numPolys = polys.size();
+    fwrite(&islandRadius_[i], sizeof(float), 1, fp);
+    fwrite(&islandArea, sizeof(float), 1, fp);
+    fwrite(&numPolys, sizeof(int), 1, fp);
+    fwrite(polys.data(), sizeof(dtPolyRef), numPolys, fp);
+  }
+}
+
+std::shared_ptr<impl::IslandSystem> impl::IslandSystem::deserialize(
+    const unsigned char*& data,
+    std::size_t size) {
+  const unsigned char* const end = data + size;
+  const unsigned char* cursor = data;
+  const auto read = [&](void* out, std::size_t outSize) {
+    if (std::size_t(end - cursor) < outSize)
+      return false;
+    memcpy(out, cursor, outSize);
+    cursor += outSize;
+    return true;
+  };
+
+  int magic = 0;
+  int numIslands = 0;
+  float totalArea = 0;
+  if (!read(&magic, sizeof(int)) || magic != ISLANDS_MAGIC ||
+      !read(&numIslands, sizeof(int)) || numIslands < 0 ||
+      !read(&totalArea, sizeof(float)))
+    return nullptr;
+
+  std::shared_ptr<IslandSystem> islandSystem{new IslandSystem{}};
+  islandSystem->islandRadius_.resize(numIslands);
+  islandSystem->islandsToPolys_.reserve(numIslands);
+  islandSystem->islandsToArea_.reserve(numIslands + 1);
+  for (int i = 0; i < numIslands; ++i) {
+    float area = 0;
+    int numPolys = 0;
+    if (!read(&islandSystem->islandRadius_[i], sizeof(float)) ||
+        !read(&area, sizeof(float)) || !read(&numPolys, sizeof(int)) ||
+        numPolys < 0)
+      return nullptr;
+    islandSystem->islandsToArea_[i] = area;
+    std::vector<dtPolyRef>& polys = islandSystem->islandsToPolys_[i];
+    polys.resize(numPolys);
+    if (!read(polys.data(), numPolys * sizeof(dtPolyRef)))
+      return nullptr;
+    for (dtPolyRef ref : polys) {
+      islandSystem->polyToIsland_.emplace(ref, i);
+    }
+  }
+  islandSystem->islandsToArea_[ID_UNDEFINED] = totalArea;
+
+  data = cursor;
+  return islandSystem;
+}
+
+std::size_t PathFinder::Impl::getMemoryUsage() const {
+  std::size_t usage = 0;
+  if (navMesh_) {
+    const dtNavMesh* navMesh = navMesh_.get();
+    for (int i = 0; i < navMesh->getMaxTiles(); ++i) {
+      const dtMeshTile* tile = navMesh->getTile(i);
+      if (tile && tile->header) {
+        usage += tile->dataSize;
+      }
+    }
+  }
+  // each query allocates its node pool and open list up front
+  const std::size_t queryCount = (navQuery_ ? 1 : 0) + workerQueries_.size();
+  usage += queryCount * (sizeof(dtNavMeshQuery) +
+                         QueryMaxNodes * (sizeof(dtNode) + sizeof(dtNodeIndex) +
+                                          sizeof(dtNode*)));
+  for (const auto& item : islandMeshData_) {
+    const assets::MeshData& mesh = *item.second;
+    usage += mesh.vbo.size() * sizeof(vec3f) + mesh.nbo.size() * sizeof(vec3f) +
+             mesh.tbo.size() * sizeof(vec2f) + mesh.cbo.size() * sizeof(vec3f) +
+             mesh.ibo.size() * sizeof(uint32_t);
+  }
+  for (const auto& item : topDownViews_) {
+    usage += item.second.size() * sizeof(bool);
+  }
+  for (const auto& item : topDownIslandViews_) {
+    usage += item.second.size() * sizeof(int);
+  }
+  for (const auto& item : navigableTriangles_) {
+    usage += item.second.vertices.size() * sizeof(Mn::Vector3) +
+             item.second.cumulativeAreas.size() * sizeof(double);
+  }
+  if (obstacleDistanceField_) {
+    usage += obstacleDistanceField_->cellOffsets.size() * sizeof(uint32_t) +
+             obstacleDistanceField_->heights.size() * sizeof(float) +
+             obstacleDistanceField_->distances.size() * sizeof(float);
+  }
+  if (pathHierarchy_) {
+    usage += pathHierarchy_->polyToRegion.size() *
+                 (sizeof(dtPolyRef) + sizeof(uint32_t)) +
+             pathHierarchy_->portals.size() * sizeof(PathHierarchy::Portal) +
+             (pathHierarchy_->regionPortalOffsets.size() +
+              pathHierarchy_->regionPortals.size() +
+              pathHierarchy_->edgeOffsets.size()) *
+                 sizeof(uint32_t) +
+             pathHierarchy_->edges.size() * sizeof(PathHierarchy::Edge);
+  }
+  return usage;
+}  // PathFinder::Impl::getMemoryUsage
+
 int PathFinder::Impl::numIslands() {
   return islandSystem_->numIslands();
 }
 
+namespace {
+/**
+ * Contents of a .navmesh file, read sequentially.
+ *
+ * Memory-mapped copy-on-write where supported, so the tiles can point right
+ * into the file and the pages Detour never writes to (vertices, detail
+ * meshes, BV trees) are shared between all processes loading the same file.
+ */
+class NavMeshFile {
+ public:
+  static std::shared_ptr<NavMeshFile> fromFile(const std::string& path) {
+    std::shared_ptr<NavMeshFile> file{new NavMeshFile{}};
+#ifdef CORRADE_TARGET_UNIX
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return nullptr;
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* mapped = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE, fd, 0);
+      if (mapped != MAP_FAILED) {
+        file->data_ = static_cast<unsigned char*>(mapped);
+        file->size_ = st.st_size;
+        file->mapped_ = true;
+      }
+    }
+    close(fd);
+    if (file->mapped_)
+      return file;
+#endif
+    Cr::Containers::Optional<Cr::Containers::Array<char>> contents =
+        Cr::Utility::Path::read(path);
+    if (!contents)
+      return nullptr;
+    file->buffer_ = std::move(*contents);
+    file->data_ = reinterpret_cast<unsigned char*>(file->buffer_.data());
+    file->size_ = file->buffer_.size();
+    return file;
+  }
+
+  ~NavMeshFile() {
+#ifdef CORRADE_TARGET_UNIX
+    if (mapped_)
+      munmap(data_, size_);
+#endif
+  }
+
+  //! Returns the next @p size bytes, or nullptr if the file is shorter
+  unsigned char* take(std::size_t size) {
+    if (size_ - offset_ < size)
+      return nullptr;
+    unsigned char* data = data_ + offset_;
+    offset_ += size;
+    return data;
+  }
+
+  //! Copies the next sizeof(T) bytes into @p out
+  template <typename T>
+  bool read(T& out) {
+    return read(&out, sizeof(T));
+  }
+
+  //! Copies the next sizeof(T) bytes into @p out without consuming them
+  template <typename T>
+  bool peek(T& out) const {
+    if (size_ - offset_ < sizeof(T))
+      return false;
+    memcpy(&out, data_ + offset_, sizeof(T));
+    return true;
+  }
+
+  bool read(void* out, std::size_t size) {
+    const unsigned char* data = take(size);
+    if (!data)
+      return false;
+    memcpy(out, data, size);
+    return true;
+  }
+
+  //! Islands come after the tiles
+  std::shared_ptr<impl::IslandSystem> readIslands() {
+    const unsigned char* data = data_ + offset_;
+    std::shared_ptr<impl::IslandSystem> islandSystem =
+        impl::IslandSystem::deserialize(data, size_ - offset_);
+    offset_ = data - data_;
+    return islandSystem;
+  }
+
+  bool atEnd() const { return offset_ == size_; }
+
+ private:
+  NavMeshFile() = default;
+
+  unsigned char* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t offset_ = 0;
+  bool mapped_ = false;
+  Cr::Containers::Array<char> buffer_;
+};
+}  // namespace
+
+namespace {
+void serializeObstacleDistanceField(FILE* fp,
+                                    const ObstacleDistanceField& field) {
+  const int numSamples = field.heights.size();
+  fwrite(&OBSTACLE_DISTANCES_MAGIC, sizeof(int), 1, fp);
+  fwrite(&field.grid, sizeof(TopDownGrid), 1, fp);
+  fwrite(&field.maxSearchRadius, sizeof(float), 1, fp);
+  fwrite(&numSamples, sizeof(int), 1, fp);
+  fwrite(field.cellOffsets.data(), sizeof(uint32_t), field.cellOffsets.size(),
+         fp);
+  fwrite(field.heights.data(), sizeof(float), numSamples, fp);
+  fwrite(field.distances.data(), sizeof(float), numSamples, fp);
+}
+
+//! Returns nullptr if what follows isn't a valid obstacle distance field
+std::shared_ptr<ObstacleDistanceField> deserializeObstacleDistanceField(
+    NavMeshFile& file) {
+  int magic = 0;
+  int numSamples = 0;
+  auto field = std::make_shared<ObstacleDistanceField>();
+  if (!file.read(magic) || magic != OBSTACLE_DISTANCES_MAGIC ||
+      !file.read(field->grid) || !file.read(field->maxSearchRadius) ||
+      !file.read(numSamples) || numSamples < 0 ||
+      field->grid.xResolution < 2 || field->grid.zResolution < 2 ||
+      !(field->grid.metersPerPixel > 0.0f))
+    return nullptr;
+
+  const std::size_t numCells =
+      std::size_t(field->grid.xResolution) * field->grid.zResolution;
+  field->cellOffsets.resize(numCells + 1);
+  field->heights.resize(numSamples);
+  field->distances.resize(numSamples);
+  if (!file.read(field->cellOffsets.data(),
+                 (numCells + 1) * sizeof(uint32_t)) ||
+      !file.read(field->heights.data(), numSamples * sizeof(float)) ||
+      !file.read(field->distances.data(), numSamples * sizeof(float)))
+    return nullptr;
+  // the offsets index the samples, so make sure they stay in bounds
+  if (field->cellOffsets.front() != 0 ||
+      field->cellOffsets.back() != uint32_t(numSamples) ||
+      !std::is_sorted(field->cellOffsets.begin(), field->cellOffsets.end()))
+    return nullptr;
+  return field;
+}
+
+struct PathHierarchyPolyRegion {
+  dtPolyRef ref;
+  uint32_t region;
+};
+
+void serializePathHierarchy(FILE* fp, const PathHierarchy& hierarchy) {
+  const uint32_t numRegions = hierarchy.numRegions();
+  const uint32_t numPolys = hierarchy.polyToRegion.size();
+  const uint32_t numPortals = hierarchy.portals.size();
+  const uint32_t numEdges = hierarchy.edges.size();
+  std::vector<PathHierarchyPolyRegion> polyRegions;
+  polyRegions.reserve(numPolys);
+  for (const auto& item : hierarchy.polyToRegion) {
+    polyRegions.push_back({item.first, item.second});
+  }
+  fwrite(&PATH_HIERARCHY_MAGIC, sizeof(int), 1, fp);
+  fwrite(&numRegions, sizeof(uint32_t), 1, fp);
+  fwrite(&numPolys, sizeof(uint32_t), 1, fp);
+  fwrite(&numPortals, sizeof(uint32_t), 1, fp);
+  fwrite(&numEdges, sizeof(uint32_t), 1, fp);
+  fwrite(polyRegions.data(), sizeof(PathHierarchyPolyRegion), numPolys, fp);
+  fwrite(hierarchy.portals.data(), sizeof(PathHierarchy::Portal), numPortals,
+         fp);
+  fwrite(hierarchy.edgeOffsets.data(), sizeof(uint32_t), numPortals + 1, fp);
+  fwrite(hierarchy.edges.data(), sizeof(PathHierarchy::Edge), numEdges, fp);
+}
+
+//! Returns nullptr if what follows isn't a valid path hierarchy
+std::shared_ptr<PathHierarchy> deserializePathHierarchy(NavMeshFile& file) {
+  int magic = 0;
+  uint32_t numRegions = 0;
+  uint32_t numPolys = 0;
+  uint32_t numPortals = 0;
+  uint32_t numEdges = 0;
+  if (!file.read(magic) || magic != PATH_HIERARCHY_MAGIC ||
+      !file.read(numRegions) || !file.read(numPolys) ||
+      !file.read(numPortals) || !file.read(numEdges))
+    return nullptr;
+
+  auto hierarchy = std::make_shared<PathHierarchy>();
+  std::vector<PathHierarchyPolyRegion> polyRegions(numPolys);
+  hierarchy->portals.resize(numPortals);
+  hierarchy->edgeOffsets.resize(std::size_t(numPortals) + 1);
+  hierarchy->edges.resize(numEdges);
+  if (!file.read(polyRegions.data(),
+                 polyRegions.size() * sizeof(PathHierarchyPolyRegion)) ||
+      !file.read(hierarchy->portals.data(),
+                 hierarchy->portals.size() * sizeof(PathHierarchy::Portal)) ||
+      !file.read(hierarchy->edgeOffsets.data(),
+                 hierarchy->edgeOffsets.size() * sizeof(uint32_t)) ||
+      !file.read(hierarchy->edges.data(),
+                 hierarchy->edges.size() * sizeof(PathHierarchy::Edge)))
+    return nullptr;
+
+  // everything indexes something else, so make sure it stays in bounds
+  hierarchy->polyToRegion.reserve(numPolys);
+  for (const PathHierarchyPolyRegion& polyRegion : polyRegions) {
+    if (polyRegion.region >= numRegions)
+      return nullptr;
+    hierarchy->polyToRegion.emplace(polyRegion.ref, polyRegion.region);
+  }
+  for (const PathHierarchy::Portal& portal : hierarchy->portals) {
+    for (int i = 0; i != 2; ++i) {
+      const auto found = hierarchy->polyToRegion.find(portal.refs[i]);
+      if (found == hierarchy->polyToRegion.end() ||
+          found->second != portal.regions[i])
+        return nullptr;
+    }
+  }
+  if (hierarchy->edgeOffsets.front() != 0 ||
+      hierarchy->edgeOffsets.back() != numEdges ||
+      !std::is_sorted(hierarchy->edgeOffsets.begin(),
+                      hierarchy->edgeOffsets.end()))
+    return nullptr;
+  for (const PathHierarchy::Edge& edge : hierarchy->edges) {
+    if (edge.portal >= numPortals || edge.region >= numRegions)
+      return nullptr;
+  }
+  indexRegionPortals(*hierarchy, numRegions);
+  return hierarchy;
+}
+}  // namespace
+
 bool PathFinder::Impl::loadNavMesh(const std::string& path) {
-  FILE* fp = fopen(path.c_str(), "rb");
-  if (!fp)
+  std::shared_ptr<NavMeshFile> file = NavMeshFile::fromFile(path);
+  if (!file)
     return false;
 
   // Read header.
   NavMeshSetHeader header{};
-  size_t readLen = fread(&header, sizeof(NavMeshSetHeader), 1, fp);
-  if (readLen != 1) {
-    fclose(fp);
+  if (!file->read(header))
     return false;
-  }
-  if (header.magic != NAVMESHSET_MAGIC) {
-    fclose(fp);
+  if (header.magic != NAVMESHSET_MAGIC)
     return false;
-  }
-  if (header.version < 1 || header.version > NAVMESHSET_VERSION) {
-    fclose(fp);
+  if (header.version < 1 || header.version > NAVMESHSET_VERSION)
     return false;
-  }
 
-  navMeshSettings_ = {NavMeshSettings{}};
-  if (header.version >= 2) {
-    fread(&(*navMeshSettings_), sizeof(NavMeshSettings), 1, fp);
+  NavMeshSettings settings{};
+  if (header.version >= 3) {
+    if (!file->read(settings))
+      return false;
+  } else if (header.version == 2) {
+    // settings up to (and excluding) tileSize, which was appended later
+    if (!file->read(&settings, offsetof(NavMeshSettings, tileSize)))
+      return false;
   } else {
     ESP_DEBUG()
         << "NavMeshSettings aren't present, guessing that they are the default";
@@ -1116,43 +3083,48 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
 
   vec3f bmin, bmax;
 
-  dtNavMesh* mesh = dtAllocNavMesh();
-  if (!mesh) {
-    fclose(fp);
+  // The tiles point into the file, so it stays alive with the navmesh
+  std::shared_ptr<dtNavMesh> mesh{
+      dtAllocNavMesh(), [file](dtNavMesh* navMesh) { dtFreeNavMesh(navMesh); }};
+  if (!mesh)
     return false;
-  }
   dtStatus status = mesh->init(&header.params);
-  if (dtStatusFailed(status)) {
-    fclose(fp);
+  if (dtStatusFailed(status))
     return false;
-  }
 
   // Read tiles.
   for (int i = 0; i < header.numTiles; ++i) {
     NavMeshTileHeader tileHeader{};
-    readLen = fread(&tileHeader, sizeof(tileHeader), 1, fp);
-    if (readLen != 1) {
-      fclose(fp);
+    if (!file->read(tileHeader))
       return false;
-    }
 
     if ((tileHeader.tileRef == 0u) || (tileHeader.dataSize == 0))
       break;
 
-    unsigned char* data = static_cast<unsigned char*>(
-        dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
+    unsigned char* data = file->take(tileHeader.dataSize);
     if (!data)
-      break;
-    memset(data, 0, tileHeader.dataSize);
-    readLen = fread(data, tileHeader.dataSize, 1, fp);
-    if (readLen != 1) {
-      dtFree(data);
-      fclose(fp);
       return false;
+
+    // Detour needs 4-byte aligned tile data, which files written by
+    // saveNavMesh() always have; copy if some other writer didn't
+    int flags = 0;
+    if (reinterpret_cast<std::uintptr_t>(data) % 4 != 0) {
+      unsigned char* copy = static_cast<unsigned char*>(
+          dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
+      if (!copy)
+        return false;
+      memcpy(copy, data, tileHeader.dataSize);
+      data = copy;
+      flags = DT_TILE_FREE_DATA;
     }
 
-    mesh->addTile(data, tileHeader.dataSize, DT_TILE_FREE_DATA,
-                  tileHeader.tileRef, nullptr);
+    status = mesh->addTile(data, tileHeader.dataSize, flags,
+                           tileHeader.tileRef, nullptr);
+    if (dtStatusFailed(status)) {
+      if (flags & DT_TILE_FREE_DATA)
+        dtFree(data);
+      return false;
+    }
     const dtMeshTile* tile = mesh->getTileByRef(tileHeader.tileRef);
     if (i == 0) {
       bmin = vec3f(tile->header->bmin);
@@ -1163,12 +3135,44 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     }
   }
 
-  fclose(fp);
+  std::shared_ptr<impl::IslandSystem> islandSystem;
+  if (header.version >= 4) {
+    islandSystem = file->readIslands();
+    if (!islandSystem) {
+      ESP_WARNING() << "Stored navmesh islands are invalid, recomputing them";
+    }
+  }
+
+  // both optional, so told apart by their magic
+  int magic = 0;
+  std::shared_ptr<ObstacleDistanceField> obstacleDistanceField;
+  if (header.version >= 5 && islandSystem && file->peek(magic) &&
+      magic == OBSTACLE_DISTANCES_MAGIC) {
+    obstacleDistanceField = deserializeObstacleDistanceField(*file);
+    if (!obstacleDistanceField) {
+      ESP_WARNING() << "Stored obstacle distance field is invalid, ignoring it";
+    }
+  }
+
+  std::shared_ptr<PathHierarchy> pathHierarchy;
+  if (header.version >= 6 && islandSystem && file->peek(magic) &&
+      magic == PATH_HIERARCHY_MAGIC) {
+    pathHierarchy = deserializePathHierarchy(*file);
+    if (!pathHierarchy) {
+      ESP_WARNING() << "Stored path hierarchy is invalid, ignoring it";
+    }
+  }
 
-  navMesh_.reset(mesh);
+  navMesh_ = std::move(mesh);
+  navMeshSettings_ = {settings};
   bounds_ = std::make_pair(bmin, bmax);
+  tiledBuild_ = Cr::Containers::NullOpt;
 
-  return initNavQuery();
+  if (!initNavQuery(std::move(islandSystem)))
+    return false;
+  obstacleDistanceField_ = std::move(obstacleDistanceField);
+  pathHierarchy_ = std::move(pathHierarchy);
+  return true;
 }
 
 bool PathFinder::Impl::saveNavMesh(const std::string& path) {
@@ -1214,6 +3218,14 @@ bool PathFinder::Impl::saveNavMesh(const std::string& path) {
     fwrite(tile->data, tile->dataSize, 1, fp);
   }
 
+  islandSystem_->serialize(fp);
+  if (obstacleDistanceField_) {
+    serializeObstacleDistanceField(fp, *obstacleDistanceField_);
+  }
+  if (pathHierarchy_) {
+    serializePathHierarchy(fp, *pathHierarchy_);
+  }
+
   fclose(fp);
 
   return true;
@@ -1392,75 +3404,586 @@ vec3f PathFinder::Impl::getRandomNavigablePointAroundSphere(
   return pt;
 }
 
-namespace {
-float pathLength(const std::vector<vec3f>& points) {
-  CORRADE_INTERNAL_ASSERT(points.size() > 0);
+bool PathFinder::Impl::findPath(ShortestPath& path) {
+  return queryPath(queryState(), path);
+}
 
-  float length = 0;
-  const vec3f* previousPoint = &points[0];
-  for (const auto& pt : points) {
-    length += (*previousPoint - pt).norm();
-    previousPoint = &pt;
+int PathFinder::Impl::findPaths(std::vector<ShortestPath>& paths,
+                                int numThreads) {
+  if (paths.empty()) {
+    return 0;
   }
+  ESP_CHECK(isLoaded(), "PathFinder::findPaths : no navmesh is loaded.");
+  numThreads = prepareWorkerQueries(numThreads, paths.size());
+
+  // paths are handed out one at a time since their cost varies a lot
+  std::atomic<std::size_t> nextPath{0};
+  std::atomic<int> numFound{0};
+  auto work = [&](dtNavMeshQuery* navQuery) {
+    int found = 0;
+    for (std::size_t i = nextPath++; i < paths.size(); i = nextPath++) {
+      found += queryPath(queryState(navQuery), paths[i]);
+    }
+    numFound += found;
+  };
 
-  return length;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work, workerQueries_[i].get());
+  }
+  work(navQuery_.get());
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return numFound;
 }
-}  // namespace
 
-bool PathFinder::Impl::findPath(ShortestPath& path) {
-  MultiGoalShortestPath tmp;
-  tmp.requestedStart = path.requestedStart;
-  tmp.setRequestedEnds({path.requestedEnd});
+Eigen::MatrixXf PathFinder::Impl::geodesicDistanceMatrix(
+    const std::vector<Mn::Vector3>& points,
+    int numThreads) {
+  const std::size_t numPoints = points.size();
+  Eigen::MatrixXf distances = Eigen::MatrixXf::Constant(
+      numPoints, numPoints, std::numeric_limits<float>::infinity());
+  if (!numPoints) {
+    return distances;
+  }
+  ESP_CHECK(isLoaded(),
+            "PathFinder::geodesicDistanceMatrix : no navmesh is loaded.");
+  const dtNavMesh* navMesh = navMesh_.get();
+
+  // the graph nodes are the midpoints of edges shared by two polygons,
+  // connected in a straight line to all other such midpoints of both
+  std::vector<dtPolyRef> polys;
+  std::unordered_map<dtPolyRef, uint32_t> polyIndices;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+        continue;
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (!filter_->passFilter(ref, tile, poly))
+        continue;
+      polyIndices.emplace(ref, uint32_t(polys.size()));
+      polys.push_back(ref);
+    }
+  }
+  struct Node {
+    vec3f position;
+    uint32_t polys[2];
+  };
+  std::vector<Node> nodes;
+  std::vector<std::vector<uint32_t>> polyNodes(polys.size());
+  for (uint32_t i = 0; i < polys.size(); ++i) {
+    forEachNeighbourPoly(
+        navMesh, filter_.get(), polys[i],
+        [&](dtPolyRef nextRef, const dtMeshTile*, const dtPoly*,
+            const vec3f& portal) {
+          const auto next = polyIndices.find(nextRef);
+          // every shared edge is seen from both sides, keep it once
+          if (next == polyIndices.end() || next->second <= i) {
+            return;
+          }
+          polyNodes[i].push_back(nodes.size());
+          polyNodes[next->second].push_back(nodes.size());
+          nodes.push_back({portal, {i, next->second}});
+        });
+  }
+
+  // points are projected once, ones off the navmesh stay infinitely far from
+  // everything
+  std::vector<vec3f> projected(numPoints);
+  std::vector<uint32_t> pointPolys(numPoints, ~uint32_t{});
+  for (std::size_t i = 0; i < numPoints; ++i) {
+    dtStatus status = 0;
+    dtPolyRef ref = 0;
+    std::tie(status, ref, projected[i]) =
+        projectToPoly(points[i], navQuery_.get(), filter_.get());
+    const auto found = polyIndices.find(ref);
+    if (status == DT_SUCCESS && ref != 0 && found != polyIndices.end())
+      pointPolys[i] = found->second;
+  }
+
+  // sources are handed out one at a time, each filling its column
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  numThreads = std::max<int>(1, std::min<std::size_t>(numThreads, numPoints));
+  std::atomic<std::size_t> nextSource{0};
+  auto work = [&]() {
+    typedef std::pair<float, uint32_t> QueueEntry;
+    std::vector<float> nodeDistances(nodes.size());
+    for (std::size_t source = nextSource++; source < numPoints;
+         source = nextSource++) {
+      const uint32_t sourcePoly = pointPolys[source];
+      if (sourcePoly == ~uint32_t{})
+        continue;
+      const vec3f& sourcePoint = projected[source];
+
+      std::fill(nodeDistances.begin(), nodeDistances.end(),
+                std::numeric_limits<float>::infinity());
+      std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                          std::greater<QueueEntry>>
+          queue;
+      for (const uint32_t node : polyNodes[sourcePoly]) {
+        nodeDistances[node] = (nodes[node].position - sourcePoint).norm();
+        queue.emplace(nodeDistances[node], node);
+      }
+      while (!queue.empty()) {
+        const QueueEntry top = queue.top();
+        queue.pop();
+        if (top.first > nodeDistances[top.second])
+          continue;
+        const Node& node = nodes[top.second];
+        for (const uint32_t poly : node.polys) {
+          for (const uint32_t next : polyNodes[poly]) {
+            const float distance =
+                top.first + (nodes[next].position - node.position).norm();
+            if (distance < nodeDistances[next]) {
+              nodeDistances[next] = distance;
+              queue.emplace(distance, next);
+            }
+          }
+        }
+      }
 
-  bool status = findPath(tmp);
+      // within the polygon of a target, which is convex, the rest of the
+      // way is a straight line from whichever shared edge is closest overall
+      for (std::size_t target = 0; target < numPoints; ++target) {
+        const uint32_t targetPoly = pointPolys[target];
+        if (targetPoly == ~uint32_t{})
+          continue;
+        const vec3f& targetPoint = projected[target];
+        float distance = targetPoly == sourcePoly
+                             ? (targetPoint - sourcePoint).norm()
+                             : std::numeric_limits<float>::infinity();
+        for (const uint32_t node : polyNodes[targetPoly]) {
+          distance = std::min(distance,
+                              nodeDistances[node] +
+                                  (targetPoint - nodes[node].position).norm());
+        }
+        distances(target, source) = distance;
+      }
+    }
+  };
 
-  path.geodesicDistance = tmp.geodesicDistance;
-  path.points = std::move(tmp.points);
-  return status;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return distances;
 }
 
-Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
-PathFinder::Impl::findPathInternal(const vec3f& start,
-                                   dtPolyRef startRef,
-                                   const vec3f& pathStart,
-                                   const vec3f& end,
-                                   dtPolyRef endRef,
-                                   const vec3f& pathEnd) {
-  // check if trivial path (start is same as end) and early return
-  if (pathStart.isApprox(pathEnd)) {
-    return std::make_tuple(0.0f, std::vector<vec3f>{pathStart, pathEnd});
+std::vector<Mn::Vector3> PathFinder::Impl::getRandomNavigablePoints(
+    const std::size_t count,
+    const uint64_t seed,
+    const int islandIndex,
+    int numThreads) {
+  ESP_CHECK(isLoaded(),
+            "PathFinder::getRandomNavigablePoints : no navmesh is loaded.");
+  islandSystem_->assertValidIsland(islandIndex);
+  std::vector<Mn::Vector3> points(count);
+  if (!count) {
+    return points;
   }
 
-  // Check if there is a path between the start and any of the ends
-  if (!islandSystem_->hasConnection(startRef, endRef)) {
-    return Cr::Containers::NullOpt;
+  auto found = navigableTriangles_.find(islandIndex);
+  if (found == navigableTriangles_.end()) {
+    std::vector<dtPolyRef> polys;
+    if (islandIndex == ID_UNDEFINED) {
+      // in island order, so the distribution doesn't depend on hashing
+      for (int i = 0; i < islandSystem_->numIslands(); ++i) {
+        const std::vector<dtPolyRef>& islandPolys =
+            islandSystem_->islandPolys(i);
+        polys.insert(polys.end(), islandPolys.begin(), islandPolys.end());
+      }
+    } else {
+      polys = islandSystem_->islandPolys(islandIndex);
+    }
+    found = navigableTriangles_
+                .emplace(islandIndex,
+                         collectNavigableTriangles(navMesh_.get(),
+                                                   filter_.get(), polys))
+                .first;
   }
+  const NavigableTriangles& triangles = found->second;
+  if (triangles.cumulativeAreas.empty())
+    throw std::runtime_error(
+        "NavMesh has no navigable area, this indicates an issue with the "
+        "NavMesh");
 
-  static const int MAX_POLYS = 256;
-  dtPolyRef polys[MAX_POLYS];
+  // a point costs a few dozen nanoseconds, not worth a thread for less than
+  // a few thousand
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  numThreads =
+      std::max<int>(1, std::min<std::size_t>(numThreads, count / 4096));
+
+  const std::size_t chunkSize = (count + numThreads - 1) / numThreads;
+  auto work = [&](std::size_t begin) {
+    const std::size_t end = std::min(begin + chunkSize, count);
+    for (std::size_t i = begin; i < end; ++i) {
+      points[i] = sampleNavigableTriangles(triangles, seed, i);
+    }
+  };
 
-  int numPolys = 0;
-  dtStatus status =
-      navQuery_->findPath(startRef, endRef, pathStart.data(), pathEnd.data(),
-                          filter_.get(), polys, &numPolys, MAX_POLYS);
-  if (status != DT_SUCCESS || numPolys == 0) {
-    return Cr::Containers::NullOpt;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 1; i < numThreads; ++i) {
+    workers.emplace_back(work, i * chunkSize);
   }
+  work(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return points;
+}
 
-  int numPoints = 0;
-  std::vector<vec3f> points(MAX_POLYS);
-  status = navQuery_->findStraightPath(start.data(), end.data(), polys,
-                                       numPolys, points[0].data(), nullptr,
-                                       nullptr, &numPoints, MAX_POLYS);
-  if (status != DT_SUCCESS || numPoints == 0) {
-    return Corrade::Containers::NullOpt;
+int PathFinder::Impl::prepareWorkerQueries(int numThreads,
+                                           std::size_t numItems) {
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
   }
+  numThreads = std::max<int>(1, std::min<std::size_t>(numThreads, numItems));
+
+  // the calling thread works on navQuery_, every other worker gets its own
+  while (workerQueries_.size() + 1 < numThreads) {
+    std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> query{
+        dtAllocNavMeshQuery()};
+    ESP_CHECK(query &&
+                  dtStatusSucceed(query->init(navMesh_.get(), QueryMaxNodes)),
+              "PathFinder : could not init Detour navmesh query.");
+    workerQueries_.emplace_back(std::move(query));
+  }
+  return numThreads;
+}
 
-  points.resize(numPoints);
+std::vector<Mn::Vector3> PathFinder::Impl::trySteps(
+    const std::vector<Mn::Vector3>& starts,
+    const std::vector<Mn::Vector3>& ends,
+    std::vector<std::uint64_t>* polygonHints,
+    bool allowSliding,
+    int numThreads) {
+  ESP_CHECK(starts.size() == ends.size(),
+            "PathFinder::trySteps : got" << starts.size() << "starts but"
+                                         << ends.size() << "ends.");
+  if (polygonHints) {
+    ESP_CHECK(polygonHints->empty() || polygonHints->size() == starts.size(),
+              "PathFinder::trySteps : got" << polygonHints->size()
+                                           << "polygon hints for"
+                                           << starts.size() << "starts.");
+    polygonHints->resize(starts.size(), 0);
+  }
+  std::vector<Mn::Vector3> results(starts.size());
+  if (starts.empty()) {
+    return results;
+  }
+  ESP_CHECK(isLoaded(), "PathFinder::trySteps : no navmesh is loaded.");
+  numThreads = prepareWorkerQueries(numThreads, starts.size());
+
+  // steps all cost about the same, so each worker takes a contiguous chunk
+  const std::size_t chunkSize = (starts.size() + numThreads - 1) / numThreads;
+  auto work = [&](dtNavMeshQuery* navQuery, std::size_t begin) {
+    const std::size_t end = std::min(begin + chunkSize, starts.size());
+    for (std::size_t i = begin; i < end; ++i) {
+      if (!polygonHints) {
+        results[i] = queryTryStep(queryState(navQuery), starts[i], ends[i],
+                                  allowSliding);
+        continue;
+      }
+      dtPolyRef hint = dtPolyRef((*polygonHints)[i]);
+      results[i] = queryTryStep(queryState(navQuery), starts[i], ends[i],
+                                allowSliding, &hint);
+      (*polygonHints)[i] = hint;
+    }
+  };
 
-  const float length = pathLength(points);
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work, workerQueries_[i].get(), (i + 1) * chunkSize);
+  }
+  work(navQuery_.get(), 0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return results;
+}
 
-  return std::make_tuple(length, std::move(points));
+std::vector<float> PathFinder::Impl::distancesToClosestObstacle(
+    const std::vector<Mn::Vector3>& pts,
+    const float maxSearchRadius,
+    int numThreads) {
+  std::vector<float> distances(pts.size());
+  if (pts.empty()) {
+    return distances;
+  }
+  ESP_CHECK(isLoaded(),
+            "PathFinder::distancesToClosestObstacle : no navmesh is loaded.");
+  numThreads = prepareWorkerQueries(numThreads, pts.size());
+
+  const std::size_t chunkSize = (pts.size() + numThreads - 1) / numThreads;
+  auto work = [&](dtNavMeshQuery* navQuery, std::size_t begin) {
+    const std::size_t end = std::min(begin + chunkSize, pts.size());
+    for (std::size_t i = begin; i < end; ++i) {
+      distances[i] = queryDistanceToClosestObstacle(
+          queryState(navQuery), Mn::EigenIntegration::cast<vec3f>(pts[i]),
+          maxSearchRadius);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work, workerQueries_[i].get(), (i + 1) * chunkSize);
+  }
+  work(navQuery_.get(), 0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return distances;
+}
+
+void PathFinder::Impl::buildObstacleDistanceField(const float metersPerPixel,
+                                                  const float maxSearchRadius,
+                                                  int numThreads) {
+  ESP_CHECK(isLoaded(),
+            "PathFinder::buildObstacleDistanceField : no navmesh is loaded.");
+  ESP_CHECK(metersPerPixel > 0.0f && maxSearchRadius > 0.0f,
+            "PathFinder::buildObstacleDistanceField : expected a positive "
+            "resolution and search radius but got"
+                << metersPerPixel << "and" << maxSearchRadius);
+
+  // one more sample than top-down views along each axis, so the far bounds
+  // are covered as well
+  auto field = std::make_shared<ObstacleDistanceField>();
+  field->grid = topDownGrid(metersPerPixel);
+  field->grid.xResolution += 1;
+  field->grid.zResolution += 1;
+  field->maxSearchRadius = maxSearchRadius;
+  const TopDownGrid& grid = field->grid;
+
+  // every floor, rasterized relative to a height below all of them
+  const float height = bounds_.first[1] - 1.0f;
+  const float eps = bounds_.second[1] - bounds_.first[1] + 2.0f;
+  const std::vector<TopDownTriangle> triangles =
+      collectTopDownTriangles(navMesh_.get(), filter_.get(), height, eps);
+
+  struct Sample {
+    int w;
+    float y;
+    dtPolyRef ref;
+    float distance;
+  };
+  std::vector<std::vector<Sample>> rows(grid.zResolution);
+
+  // rows are handed out in chunks, each rasterizing all triangles once
+  constexpr int RowsPerChunk = 16;
+  const std::size_t numChunks =
+      (grid.zResolution + RowsPerChunk - 1) / RowsPerChunk;
+  numThreads = prepareWorkerQueries(numThreads, numChunks);
+  std::atomic<std::size_t> nextChunk{0};
+  auto work = [&](dtNavMeshQuery* navQuery) {
+    for (std::size_t chunk = nextChunk++; chunk < numChunks;
+         chunk = nextChunk++) {
+      const int rowBegin = chunk * RowsPerChunk;
+      const int rowEnd = std::min(grid.zResolution, rowBegin + RowsPerChunk);
+      rasterizeTopDownRows(
+          triangles, grid, height, eps, rowBegin, rowEnd,
+          [&](int h, int w, dtPolyRef ref, float yDelta) {
+            rows[h].push_back({w, height + yDelta, ref, 0.0f});
+          });
+
+      for (int h = rowBegin; h < rowEnd; ++h) {
+        std::vector<Sample>& row = rows[h];
+        std::sort(row.begin(), row.end(),
+                  [](const Sample& a, const Sample& b) {
+                    return a.w < b.w || (a.w == b.w && a.y < b.y);
+                  });
+        // samples on edges shared by two triangles are rasterized twice
+        row.erase(std::unique(row.begin(), row.end(),
+                              [](const Sample& a, const Sample& b) {
+                                return a.w == b.w &&
+                                       std::abs(a.y - b.y) < 1e-3f;
+                              }),
+                  row.end());
+        for (Sample& sample : row) {
+          const vec3f pos{grid.startx + sample.w * grid.metersPerPixel,
+                          sample.y, grid.startz + h * grid.metersPerPixel};
+          vec3f hitPos, hitNormal;
+          sample.distance = maxSearchRadius;
+          navQuery->findDistanceToWall(sample.ref, pos.data(), maxSearchRadius,
+                                       filter_.get(), &sample.distance,
+                                       hitPos.data(), hitNormal.data());
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work, workerQueries_[i].get());
+  }
+  work(navQuery_.get());
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  const std::size_t numCells =
+      std::size_t(grid.xResolution) * grid.zResolution;
+  field->cellOffsets.reserve(numCells + 1);
+  field->cellOffsets.push_back(0);
+  for (const std::vector<Sample>& row : rows) {
+    auto sample = row.begin();
+    for (int w = 0; w < grid.xResolution; ++w) {
+      for (; sample != row.end() && sample->w == w; ++sample) {
+        field->heights.push_back(sample->y);
+        field->distances.push_back(std::min(sample->distance, maxSearchRadius));
+      }
+      field->cellOffsets.push_back(field->heights.size());
+    }
+  }
+  obstacleDistanceField_ = std::move(field);
+}
+
+void PathFinder::Impl::buildPathHierarchy(const int regionSize,
+                                          int numThreads) {
+  ESP_CHECK(isLoaded(),
+            "PathFinder::buildPathHierarchy : no navmesh is loaded.");
+  ESP_CHECK(regionSize > 0,
+            "PathFinder::buildPathHierarchy : expected a positive region size "
+            "but got"
+                << regionSize);
+  const dtNavMesh* navMesh = navMesh_.get();
+  auto hierarchy = std::make_shared<PathHierarchy>();
+
+  // regions grow breadth-first from the first polygon not in any region yet,
+  // which keeps them compact
+  std::vector<dtPolyRef> polys;
+  uint32_t numRegions = 0;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+        continue;
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (!filter_->passFilter(ref, tile, poly) ||
+          !hierarchy->polyToRegion.emplace(ref, numRegions).second)
+        continue;
+
+      const std::size_t regionBegin = polys.size();
+      polys.push_back(ref);
+      for (std::size_t k = regionBegin;
+           k < polys.size() &&
+           polys.size() - regionBegin < std::size_t(regionSize);
+           ++k) {
+        forEachNeighbourPoly(
+            navMesh, filter_.get(), polys[k],
+            [&](dtPolyRef nextRef, const dtMeshTile*, const dtPoly*,
+                const vec3f&) {
+              if (polys.size() - regionBegin < std::size_t(regionSize) &&
+                  hierarchy->polyToRegion.emplace(nextRef, numRegions)
+                      .second) {
+                polys.push_back(nextRef);
+              }
+            });
+      }
+      ++numRegions;
+    }
+  }
+
+  // every edge between two regions is seen from both sides, keep it once
+  for (const dtPolyRef ref : polys) {
+    const uint32_t region = hierarchy->polyToRegion.at(ref);
+    forEachNeighbourPoly(
+        navMesh, filter_.get(), ref,
+        [&](dtPolyRef nextRef, const dtMeshTile*, const dtPoly*,
+            const vec3f& portal) {
+          const auto found = hierarchy->polyToRegion.find(nextRef);
+          if (found != hierarchy->polyToRegion.end() &&
+              found->second != region && ref < nextRef) {
+            hierarchy->portals.push_back(
+                {{ref, nextRef}, {region, found->second}, portal});
+          }
+        });
+  }
+  indexRegionPortals(*hierarchy, numRegions);
+
+  // distances between all portals of a region, regions handed out one at a
+  // time. Only the navmesh is read, so the workers don't need queries.
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  numThreads = std::max<int>(1, std::min<std::size_t>(numThreads, numRegions));
+  std::vector<std::vector<std::pair<uint32_t, PathHierarchy::Edge>>>
+      regionEdges(numRegions);
+  std::atomic<uint32_t> nextRegion{0};
+  auto work = [&]() {
+    for (uint32_t region = nextRegion++; region < numRegions;
+         region = nextRegion++) {
+      const uint32_t begin = hierarchy->regionPortalOffsets[region];
+      const uint32_t end = hierarchy->regionPortalOffsets[region + 1];
+      for (uint32_t i = begin; i != end; ++i) {
+        const uint32_t from = hierarchy->regionPortals[i];
+        const PathHierarchy::Portal& portal = hierarchy->portals[from];
+        const std::vector<float> distances = regionPortalDistances(
+            navMesh, filter_.get(), *hierarchy, region,
+            PathHierarchy::portalRef(portal, region), portal.position);
+        for (uint32_t j = begin; j != end; ++j) {
+          if (j != i &&
+              distances[j - begin] != std::numeric_limits<float>::infinity()) {
+            regionEdges[region].push_back(
+                {from,
+                 {hierarchy->regionPortals[j], region, distances[j - begin]}});
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  hierarchy->edgeOffsets.assign(hierarchy->portals.size() + 1, 0);
+  for (const auto& edges : regionEdges) {
+    for (const auto& edge : edges) {
+      ++hierarchy->edgeOffsets[edge.first + 1];
+    }
+  }
+  std::partial_sum(hierarchy->edgeOffsets.begin(),
+                   hierarchy->edgeOffsets.end(),
+                   hierarchy->edgeOffsets.begin());
+  hierarchy->edges.resize(hierarchy->edgeOffsets.back());
+  std::vector<uint32_t> next(hierarchy->edgeOffsets.begin(),
+                             hierarchy->edgeOffsets.end() - 1);
+  for (const auto& edges : regionEdges) {
+    for (const auto& edge : edges) {
+      hierarchy->edges[next[edge.first]++] = edge.second;
+    }
+  }
+  pathHierarchy_ = std::move(hierarchy);
 }
 
 bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
@@ -1508,12 +4031,118 @@ bool PathFinder::Impl::findPathSetup(MultiGoalShortestPath& path,
   return true;
 }
 
+void PathFinder::Impl::buildDistanceField(MultiGoalShortestPath& path) const {
+  auto& field = path.pimpl_->distanceField;
+  auto& endsInPoly = path.pimpl_->endsInPoly;
+  field.clear();
+  endsInPoly.clear();
+
+  typedef std::pair<float, dtPolyRef> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue;
+
+  // seed with the distance from each end to the center of its polygon
+  for (int i = 0; i < static_cast<int>(path.pimpl_->endRefs.size()); ++i) {
+    if (!path.pimpl_->endIsValid[i])
+      continue;
+    const dtPolyRef ref = path.pimpl_->endRefs[i];
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh_->getTileAndPolyByRefUnsafe(ref, &tile, &poly);
+    const float distance =
+        (polyCenter(tile, poly) - path.pimpl_->pathEnds[i]).norm();
+    endsInPoly[ref].push_back(i);
+
+    auto it = field.find(ref);
+    if (it == field.end() || distance < it->second.distance) {
+      field[ref] = {distance, i};
+      queue.emplace(distance, ref);
+    }
+  }
+
+  // edges connect polygon centers through the midpoint of their shared edge
+  while (!queue.empty()) {
+    const QueueEntry top = queue.top();
+    queue.pop();
+    const MultiGoalShortestPath::Impl::DistanceFieldEntry entry =
+        field.at(top.second);
+    if (top.first > entry.distance)
+      continue;
+
+    const dtMeshTile* tile = nullptr;
+    const dtPoly* poly = nullptr;
+    navMesh_->getTileAndPolyByRefUnsafe(top.second, &tile, &poly);
+    const vec3f center = polyCenter(tile, poly);
+    forEachNeighbourPoly(
+        navMesh_.get(), filter_.get(), top.second,
+        [&](dtPolyRef nextRef, const dtMeshTile* nextTile,
+            const dtPoly* nextPoly, const vec3f& portal) {
+          const float distance =
+              entry.distance + (center - portal).norm() +
+              (portal - polyCenter(nextTile, nextPoly)).norm();
+          auto it = field.find(nextRef);
+          if (it == field.end() || distance < it->second.distance) {
+            field[nextRef] = {distance, entry.endIndex};
+            queue.emplace(distance, nextRef);
+          }
+        });
+  }
+
+  path.pimpl_->distanceFieldGeneration = navMeshGeneration_;
+}
+
+bool PathFinder::Impl::findPathWithDistanceField(MultiGoalShortestPath& path,
+                                                 dtPolyRef startRef,
+                                                 const vec3f& pathStart) {
+  if (path.pimpl_->distanceFieldGeneration != navMeshGeneration_) {
+    buildDistanceField(path);
+  }
+  const auto& field = path.pimpl_->distanceField;
+
+  // ends on the start polygon are reached in a straight line
+  auto endsHere = path.pimpl_->endsInPoly.find(startRef);
+  if (endsHere != path.pimpl_->endsInPoly.end()) {
+    for (int i : endsHere->second) {
+      const float distance = (pathStart - path.pimpl_->pathEnds[i]).norm();
+      if (distance < path.geodesicDistance) {
+        path.geodesicDistance = distance;
+        path.closestEndPointIndex = i;
+      }
+    }
+  }
+
+  // everything else leaves through one of the start polygon's edges
+  forEachNeighbourPoly(
+      navMesh_.get(), filter_.get(), startRef,
+      [&](dtPolyRef nextRef, const dtMeshTile* nextTile, const dtPoly* nextPoly,
+          const vec3f& portal) {
+        auto it = field.find(nextRef);
+        if (it == field.end())
+          return;
+        const float distance =
+            (pathStart - portal).norm() +
+            (portal - polyCenter(nextTile, nextPoly)).norm() +
+            it->second.distance;
+        if (distance < path.geodesicDistance) {
+          path.geodesicDistance = distance;
+          path.closestEndPointIndex = it->second.endIndex;
+        }
+      });
+
+  return path.geodesicDistance < std::numeric_limits<float>::infinity();
+}
+
 bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
   dtPolyRef startRef = 0;
   vec3f pathStart;
   if (!findPathSetup(path, startRef, pathStart))
     return false;
 
+  if (path.useDistanceField) {
+    return findPathWithDistanceField(path, startRef, pathStart);
+  }
+
   if (path.pimpl_->requestedEnds.size() > 1) {
     // Bound the minimum distance any point could be from the start by either
     // how close it use to be minus how much we moved from the last search point
@@ -1552,8 +4181,8 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
 
     const Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
         findResult =
-            findPathInternal(path.requestedStart, startRef, pathStart,
-                             path.pimpl_->requestedEnds[i],
+            findPathInternal(queryState(), path.requestedStart, startRef,
+                             pathStart, path.pimpl_->requestedEnds[i],
                              path.pimpl_->endRefs[i], path.pimpl_->pathEnds[i]);
 
     if (findResult && std::get<0>(*findResult) < path.geodesicDistance) {
@@ -1569,127 +4198,29 @@ bool PathFinder::Impl::findPath(MultiGoalShortestPath& path) {
 
 template <typename T>
 T PathFinder::Impl::tryStep(const T& start, const T& end, bool allowSliding) {
-  static const int MAX_POLYS = 256;
-  dtPolyRef polys[MAX_POLYS];
-
-  dtStatus startStatus = 0, endStatus = 0;
-  dtPolyRef startRef = 0, endRef = 0;
-  vec3f pathStart;
-  std::tie(startStatus, startRef, pathStart) =
-      projectToPoly(start, navQuery_.get(), filter_.get());
-  std::tie(endStatus, endRef, std::ignore) =
-      projectToPoly(end, navQuery_.get(), filter_.get());
-
-  if (dtStatusFailed(startStatus) || dtStatusFailed(endStatus)) {
-    return start;
-  }
-
-  if (not islandSystem_->hasConnection(startRef, endRef)) {
-    return start;
-  }
-
-  vec3f endPoint;
-  int numPolys = 0;
-  navQuery_->moveAlongSurface(startRef, pathStart.data(), end.data(),
-                              filter_.get(), endPoint.data(), polys, &numPolys,
-                              MAX_POLYS, allowSliding);
-  // If there isn't any possible path between start and end, just return
-  // start, that is cleanest
-  if (numPolys == 0) {
-    return start;
-  }
-
-  // According to recast's code
-  // (https://github.com/recastnavigation/recastnavigation/blob/master/Detour/Source/DetourNavMeshQuery.cpp#L2006-L2007),
-  // the endPoint is not guaranteed to be actually on the surface of the
-  // navmesh, it seems to be in 99.9% of cases for us, but there are some
-  // extreme edge cases where it won't be, so explicitly get the height of the
-  // surface at the endPoint and set its height to that.
-  // Note, this will never fail as endPoint is always within in the poly
-  // polys[numPolys - 1]
-  navQuery_->getPolyHeight(polys[numPolys - 1], endPoint.data(), &endPoint[1]);
-
-  // Hack to deal with infinitely thin walls in recast allowing you to
-  // transition between two different connected components
-  // First check to see if the endPoint as returned by `moveAlongSurface`
-  // is in the same connected component as the startRef according to
-  // findNearestPoly
-  std::tie(std::ignore, endRef, std::ignore) =
-      projectToPoly(endPoint, navQuery_.get(), filter_.get());
-  if (!this->islandSystem_->hasConnection(startRef, endRef)) {
-    // There isn't a connection!  This happens when endPoint is on an edge
-    // shared between two different connected components (aka infinitely thin
-    // walls) The way to deal with this is to nudge the point into the polygon
-    // we want it to be 'moveAlongSurface' tells us which polygon we want
-    // endPoint to be in through the polys list
-    const dtMeshTile* tile = nullptr;
-    const dtPoly* poly = nullptr;
-    navMesh_->getTileAndPolyByRefUnsafe(polys[numPolys - 1], &tile, &poly);
-
-    // Calculate the center of the polygon we want the points to be in
-    vec3f polyCenter = vec3f::Zero();
-    for (int iVert = 0; iVert < poly->vertCount; ++iVert) {
-      polyCenter += Eigen::Map<vec3f>(
-          &tile->verts[static_cast<size_t>(poly->verts[iVert]) * 3]);
-    }
-    polyCenter /= poly->vertCount;
-
-    constexpr float nudgeDistance = 1e-4;  // 0.1mm
-    const vec3f nudgeDir = (polyCenter - endPoint).normalized();
-    // And nudge the point towards the center by a little tiny bit :)
-    endPoint = endPoint + nudgeDistance * nudgeDir;
-  }
+  return queryTryStep(queryState(), start, end, allowSliding);
+}
 
-  return T{std::move(endPoint)};
+Mn::Vector3 PathFinder::Impl::tryStep(const Mn::Vector3& start,
+                                      const Mn::Vector3& end,
+                                      std::uint64_t& polygonHint,
+                                      bool allowSliding) {
+  dtPolyRef hint = dtPolyRef(polygonHint);
+  const Mn::Vector3 result =
+      queryTryStep(queryState(), start, end, allowSliding, &hint);
+  polygonHint = hint;
+  return result;
 }
 
 template <typename T>
 T PathFinder::Impl::snapPoint(const T& pt, int islandIndex /*=ID_UNDEFINED*/) {
   islandSystem_->assertValidIsland(islandIndex);
-
-  // If this query should be island specific
-  if (islandIndex != ID_UNDEFINED) {
-    // set the poly flag to identify polys not on the target island
-    islandSystem_->setPolyFlagForIsland(
-        navMesh_.get(), PolyFlags::POLYFLAGS_OFF_ISLAND, islandIndex,
-        /*setFlag=*/true, /*invert=*/true);
-    filter_->setExcludeFlags(filter_->getExcludeFlags() |
-                             PolyFlags::POLYFLAGS_OFF_ISLAND);
-  }
-
-  dtStatus status = 0;
-  vec3f projectedPt;
-  std::tie(status, std::ignore, projectedPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-
-  // Clean up if this query was island specific
-  if (islandIndex != ID_UNDEFINED) {
-    // reset the poly flag identifing polys off the target island
-    islandSystem_->setPolyFlagForIsland(
-        navMesh_.get(), PolyFlags::POLYFLAGS_OFF_ISLAND, islandIndex,
-        /*setFlag=*/false, /*invert=*/true);
-    filter_->setExcludeFlags(filter_->getExcludeFlags() &
-                             ~PolyFlags::POLYFLAGS_OFF_ISLAND);
-  }
-
-  if (dtStatusSucceed(status)) {
-    return T{std::move(projectedPt)};
-  }
-  return {Mn::Constants::nan(), Mn::Constants::nan(), Mn::Constants::nan()};
+  return querySnapPoint(queryState(), pt, islandIndex);
 }
 
 template <typename T>
 int PathFinder::Impl::getIsland(const T& pt) const {
-  dtStatus status = 0;
-  vec3f projectedPt;
-  dtPolyRef polyRef = 0;
-  std::tie(status, polyRef, projectedPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-
-  if (dtStatusSucceed(status)) {
-    return islandSystem_->getPolyIsland(polyRef);
-  }
-  return ID_UNDEFINED;
+  return queryIsland(queryState(), pt);
 }
 
 float PathFinder::Impl::islandRadius(int islandIndex) const {
@@ -1697,129 +4228,127 @@ float PathFinder::Impl::islandRadius(int islandIndex) const {
 }
 
 float PathFinder::Impl::islandRadius(const vec3f& pt) const {
-  dtPolyRef ptRef = 0;
-  dtStatus status = 0;
-  std::tie(status, ptRef, std::ignore) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-  if (status != DT_SUCCESS || ptRef == 0) {
-    return 0.0;
-  }
-  return islandSystem_->polyIslandRadius(ptRef);
+  return queryIslandRadius(queryState(), pt);
 }
 
 float PathFinder::Impl::distanceToClosestObstacle(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
-  return closestObstacleSurfacePoint(pt, maxSearchRadius).hitDist;
+  return queryDistanceToClosestObstacle(queryState(), pt, maxSearchRadius);
 }
 
 HitRecord PathFinder::Impl::closestObstacleSurfacePoint(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
-  dtPolyRef ptRef = 0;
-  dtStatus status = 0;
-  vec3f polyPt;
-  std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-  if (status != DT_SUCCESS || ptRef == 0) {
-    return {vec3f(0, 0, 0), vec3f(0, 0, 0),
-            std::numeric_limits<float>::infinity()};
-  }
-  vec3f hitPos, hitNormal;
-  float hitDist = Mn::Constants::nan();
-  navQuery_->findDistanceToWall(ptRef, polyPt.data(), maxSearchRadius,
-                                filter_.get(), &hitDist, hitPos.data(),
-                                hitNormal.data());
-  return {std::move(hitPos), std::move(hitNormal), hitDist};
+  return queryClosestObstacleSurfacePoint(queryState(), pt, maxSearchRadius);
 }
 
 bool PathFinder::Impl::isNavigable(const vec3f& pt,
                                    const float maxYDelta /*= 0.5*/) const {
-  dtPolyRef ptRef = 0;
-  dtStatus status = 0;
-  vec3f polyPt;
-  std::tie(status, ptRef, polyPt) =
-      projectToPoly(pt, navQuery_.get(), filter_.get());
-
-  if (status != DT_SUCCESS || ptRef == 0)
-    return false;
-
-  if (std::abs(polyPt[1] - pt[1]) > maxYDelta ||
-      (Eigen::Vector2f(pt[0], pt[2]) - Eigen::Vector2f(polyPt[0], polyPt[2]))
-              .norm() > 1e-2)
-    return false;
-
-  return true;
+  return queryIsNavigable(queryState(), pt, maxYDelta);
 }
 
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
 
-Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-PathFinder::Impl::getTopDownView(const float metersPerPixel,
-                                 const float height,
-                                 const float eps) const {
+TopDownGrid PathFinder::Impl::topDownGrid(const float metersPerPixel) const {
   std::pair<vec3f, vec3f> mapBounds = bounds();
   vec3f bound1 = std::move(mapBounds.first);
   vec3f bound2 = std::move(mapBounds.second);
 
   float xspan = std::abs(bound1[0] - bound2[0]);
   float zspan = std::abs(bound1[2] - bound2[2]);
-  int xResolution = xspan / metersPerPixel;
-  int zResolution = zspan / metersPerPixel;
-  float startx = fmin(bound1[0], bound2[0]);
-  float startz = fmin(bound1[2], bound2[2]);
-  MatrixXb topdownMap(zResolution, xResolution);
+  TopDownGrid grid{};
+  grid.startx = fmin(bound1[0], bound2[0]);
+  grid.startz = fmin(bound1[2], bound2[2]);
+  grid.metersPerPixel = metersPerPixel;
+  grid.xResolution = xspan / metersPerPixel;
+  grid.zResolution = zspan / metersPerPixel;
+  return grid;
+}
 
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; ++h) {
-    for (int w = 0; w < xResolution; ++w) {
-      vec3f point = vec3f(curx, height, curz);
-      topdownMap(h, w) = isNavigable(point, eps);
-      curx = curx + metersPerPixel;
+Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
+PathFinder::Impl::getTopDownView(const float metersPerPixel,
+                                 const float height,
+                                 const float eps,
+                                 const bool rasterize) {
+  const TopDownViewKey key{metersPerPixel, height, eps, rasterize};
+  auto cached = topDownViews_.find(key);
+  if (cached != topDownViews_.end())
+    return cached->second;
+
+  const TopDownGrid grid = topDownGrid(metersPerPixel);
+  MatrixXb topdownMap(grid.zResolution, grid.xResolution);
+
+  if (rasterize) {
+    topdownMap.setConstant(false);
+    rasterizeTopDown(
+        navMesh_.get(), filter_.get(), grid, height, eps,
+        [&](int h, int w, dtPolyRef, float) { topdownMap(h, w) = true; });
+  } else {
+    float curz = grid.startz;
+    float curx = grid.startx;
+    for (int h = 0; h < grid.zResolution; ++h) {
+      for (int w = 0; w < grid.xResolution; ++w) {
+        vec3f point = vec3f(curx, height, curz);
+        topdownMap(h, w) = isNavigable(point, eps);
+        curx = curx + metersPerPixel;
+      }
+      curz = curz + metersPerPixel;
+      curx = grid.startx;
     }
-    curz = curz + metersPerPixel;
-    curx = startx;
   }
 
-  return topdownMap;
+  return topDownViews_.emplace(key, std::move(topdownMap)).first->second;
 }
 
 typedef Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> MatrixXi;
 
 MatrixXi PathFinder::Impl::getTopDownIslandView(const float metersPerPixel,
                                                 const float height,
-                                                const float eps) const {
-  std::pair<vec3f, vec3f> mapBounds = bounds();
-  vec3f bound1 = std::move(mapBounds.first);
-  vec3f bound2 = std::move(mapBounds.second);
-
-  float xspan = std::abs(bound1[0] - bound2[0]);
-  float zspan = std::abs(bound1[2] - bound2[2]);
-  int xResolution = xspan / metersPerPixel;
-  int zResolution = zspan / metersPerPixel;
-  float startx = fmin(bound1[0], bound2[0]);
-  float startz = fmin(bound1[2], bound2[2]);
-  MatrixXi topdownMap(zResolution, xResolution);
-
-  float curz = startz;
-  float curx = startx;
-  for (int h = 0; h < zResolution; ++h) {
-    for (int w = 0; w < xResolution; ++w) {
-      vec3f point = vec3f(curx, height, curz);
-      if (isNavigable(point, eps)) {
-        // get the island
-        topdownMap(h, w) = getIsland(point);
-      } else {
-        topdownMap(h, w) = -1;
+                                                const float eps,
+                                                const bool rasterize) {
+  const TopDownViewKey key{metersPerPixel, height, eps, rasterize};
+  auto cached = topDownIslandViews_.find(key);
+  if (cached != topDownIslandViews_.end())
+    return cached->second;
+
+  const TopDownGrid grid = topDownGrid(metersPerPixel);
+  MatrixXi topdownMap(grid.zResolution, grid.xResolution);
+
+  if (rasterize) {
+    // where polygons overlap, the one closest to the slice wins, as with
+    // the nearest polygon getIsland() would snap to
+    topdownMap.setConstant(-1);
+    Eigen::MatrixXf minYDelta = Eigen::MatrixXf::Constant(
+        grid.zResolution, grid.xResolution,
+        std::numeric_limits<float>::infinity());
+    rasterizeTopDown(navMesh_.get(), filter_.get(), grid, height, eps,
+                     [&](int h, int w, dtPolyRef ref, float yDelta) {
+                       if (yDelta < minYDelta(h, w)) {
+                         minYDelta(h, w) = yDelta;
+                         topdownMap(h, w) = islandSystem_->getPolyIsland(ref);
+                       }
+                     });
+  } else {
+    float curz = grid.startz;
+    float curx = grid.startx;
+    for (int h = 0; h < grid.zResolution; ++h) {
+      for (int w = 0; w < grid.xResolution; ++w) {
+        vec3f point = vec3f(curx, height, curz);
+        if (isNavigable(point, eps)) {
+          // get the island
+          topdownMap(h, w) = getIsland(point);
+        } else {
+          topdownMap(h, w) = -1;
+        }
+        curx = curx + metersPerPixel;
       }
-      curx = curx + metersPerPixel;
+      curz = curz + metersPerPixel;
+      curx = grid.startx;
     }
-    curz = curz + metersPerPixel;
-    curx = startx;
   }
 
-  return topdownMap;
+  return topDownIslandViews_.emplace(key, std::move(topdownMap)).first->second;
 }
 
 assets::MeshData::ptr PathFinder::Impl::getNavMeshData(
@@ -1873,6 +4402,32 @@ assets::MeshData::ptr PathFinder::Impl::getNavMeshData(
   return islandMeshData_[islandIndex];
 }
 
+assets::MeshData::ptr PathFinder::Impl::getNavMeshTileData(
+    const int tileX,
+    const int tileZ) const {
+  assets::MeshData::ptr tileMeshData = assets::MeshData::create();
+  if (!isLoaded())
+    return tileMeshData;
+  const dtMeshTile* tile = navMesh_->getTileAt(tileX, tileZ, 0);
+  if (!tile || !tile->header)
+    return tileMeshData;
+
+  std::vector<esp::vec3f>& vbo = tileMeshData->vbo;
+  std::vector<uint32_t>& ibo = tileMeshData->ibo;
+  for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+    const dtPoly* poly = &tile->polys[jPoly];
+    if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+      continue;
+    for (auto& tri : getPolygonTriangles(poly, tile)) {
+      for (int k = 0; k < 3; ++k) {
+        vbo.push_back(tri.v[k]);
+        ibo.push_back(vbo.size() - 1);
+      }
+    }
+  }
+  return tileMeshData;
+}
+
 PathFinder::PathFinder() : pimpl_{spimpl::make_unique_impl<Impl>()} {};
 
 bool PathFinder::build(const NavMeshSettings& bs,
@@ -1903,14 +4458,38 @@ vec3f PathFinder::getRandomNavigablePointAroundSphere(
                                                  islandIndex);
 }
 
+std::vector<Mn::Vector3> PathFinder::getRandomNavigablePoints(
+    const std::size_t count,
+    const uint64_t seed,
+    int islandIndex /*= ID_UNDEFINED*/,
+    int numThreads /*= 0*/) {
+  ESP_PROFILE_SCOPE("PathFinder::getRandomNavigablePoints");
+  return pimpl_->getRandomNavigablePoints(count, seed, islandIndex,
+                                          numThreads);
+}
+
 bool PathFinder::findPath(ShortestPath& path) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath");
   return pimpl_->findPath(path);
 }
 
 bool PathFinder::findPath(MultiGoalShortestPath& path) {
+  ESP_PROFILE_SCOPE("PathFinder::findPath(MultiGoalShortestPath)");
   return pimpl_->findPath(path);
 }
 
+int PathFinder::findPaths(std::vector<ShortestPath>& paths, int numThreads) {
+  ESP_PROFILE_SCOPE("PathFinder::findPaths");
+  return pimpl_->findPaths(paths, numThreads);
+}
+
+Eigen::MatrixXf PathFinder::geodesicDistanceMatrix(
+    const std::vector<Mn::Vector3>& points,
+    int numThreads) {
+  ESP_PROFILE_SCOPE("PathFinder::geodesicDistanceMatrix");
+  return pimpl_->geodesicDistanceMatrix(points, numThreads);
+}
+
 template vec3f PathFinder::tryStep<vec3f>(const vec3f&, const vec3f&);
 template Mn::Vector3 PathFinder::tryStep<Mn::Vector3>(const Mn::Vector3&,
                                                       const Mn::Vector3&);
@@ -1920,6 +4499,31 @@ T PathFinder::tryStep(const T& start, const T& end) {
   return pimpl_->tryStep(start, end, /*allowSliding=*/true);
 }
 
+Mn::Vector3 PathFinder::tryStep(const Mn::Vector3& start,
+                                const Mn::Vector3& end,
+                                std::uint64_t& polygonHint,
+                                bool allowSliding) {
+  return pimpl_->tryStep(start, end, polygonHint, allowSliding);
+}
+
+std::vector<Mn::Vector3> PathFinder::trySteps(
+    const std::vector<Mn::Vector3>& starts,
+    const std::vector<Mn::Vector3>& ends,
+    bool allowSliding,
+    int numThreads) {
+  return pimpl_->trySteps(starts, ends, nullptr, allowSliding, numThreads);
+}
+
+std::vector<Mn::Vector3> PathFinder::trySteps(
+    const std::vector<Mn::Vector3>& starts,
+    const std::vector<Mn::Vector3>& ends,
+    std::vector<std::uint64_t>& polygonHints,
+    bool allowSliding,
+    int numThreads) {
+  return pimpl_->trySteps(starts, ends, &polygonHints, allowSliding,
+                          numThreads);
+}
+
 template vec3f PathFinder::tryStepNoSliding<vec3f>(const vec3f&, const vec3f&);
 template Mn::Vector3 PathFinder::tryStepNoSliding<Mn::Vector3>(
     const Mn::Vector3&,
@@ -1959,6 +4563,10 @@ bool PathFinder::isLoaded() const {
   return pimpl_->isLoaded();
 }
 
+std::size_t PathFinder::getMemoryUsage() const {
+  return pimpl_->getMemoryUsage();
+}
+
 void PathFinder::seed(uint32_t newSeed) {
   return pimpl_->seed(newSeed);
 }
@@ -1986,6 +4594,43 @@ HitRecord PathFinder::closestObstacleSurfacePoint(
   return pimpl_->closestObstacleSurfacePoint(pt, maxSearchRadius);
 }
 
+std::vector<float> PathFinder::distancesToClosestObstacle(
+    const std::vector<Mn::Vector3>& pts,
+    const float maxSearchRadius,
+    int numThreads) {
+  ESP_PROFILE_SCOPE("PathFinder::distancesToClosestObstacle");
+  return pimpl_->distancesToClosestObstacle(pts, maxSearchRadius, numThreads);
+}
+
+void PathFinder::buildObstacleDistanceField(const float metersPerPixel,
+                                            const float maxSearchRadius,
+                                            int numThreads) {
+  ESP_PROFILE_SCOPE("PathFinder::buildObstacleDistanceField");
+  pimpl_->buildObstacleDistanceField(metersPerPixel, maxSearchRadius,
+                                     numThreads);
+}
+
+bool PathFinder::hasObstacleDistanceField() const {
+  return pimpl_->hasObstacleDistanceField();
+}
+
+void PathFinder::clearObstacleDistanceField() {
+  pimpl_->clearObstacleDistanceField();
+}
+
+void PathFinder::buildPathHierarchy(const int regionSize, int numThreads) {
+  ESP_PROFILE_SCOPE("PathFinder::buildPathHierarchy");
+  pimpl_->buildPathHierarchy(regionSize, numThreads);
+}
+
+bool PathFinder::hasPathHierarchy() const {
+  return pimpl_->hasPathHierarchy();
+}
+
+void PathFinder::clearPathHierarchy() {
+  pimpl_->clearPathHierarchy();
+}
+
 bool PathFinder::isNavigable(const vec3f& pt, const float maxYDelta) const {
   return pimpl_->isNavigable(pt, maxYDelta);
 }
@@ -2001,15 +4646,27 @@ std::pair<vec3f, vec3f> PathFinder::bounds() const {
 Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> PathFinder::getTopDownView(
     const float metersPerPixel,
     const float height,
-    const float eps) {
-  return pimpl_->getTopDownView(metersPerPixel, height, eps);
+    const float eps,
+    const bool rasterize) {
+  return pimpl_->getTopDownView(metersPerPixel, height, eps, rasterize);
 }
 
 Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
 PathFinder::getTopDownIslandView(const float metersPerPixel,
                                  const float height,
-                                 const float eps) {
-  return pimpl_->getTopDownIslandView(metersPerPixel, height, eps);
+                                 const float eps,
+                                 const bool rasterize) {
+  return pimpl_->getTopDownIslandView(metersPerPixel, height, eps, rasterize);
+}
+
+std::map<std::pair<int, int>, uint64_t> PathFinder::getNavMeshTileRevisions()
+    const {
+  return pimpl_->getNavMeshTileRevisions();
+}
+
+assets::MeshData::ptr PathFinder::getNavMeshTileData(const int tileX,
+                                                     const int tileZ) const {
+  return pimpl_->getNavMeshTileData(tileX, tileZ);
 }
 
 assets::MeshData::ptr PathFinder::getNavMeshData(
@@ -2022,5 +4679,115 @@ Cr::Containers::Optional<NavMeshSettings> PathFinder::getNavMeshSettings()
   return pimpl_->getNavMeshSettings();
 }
 
+PathFinderQueryContext::ptr PathFinder::createQueryContext() const {
+  return PathFinderQueryContext::create(*this);
+}
+
+struct PathFinderQueryContext::Impl {
+  std::shared_ptr<const dtNavMesh> navMesh;
+  std::shared_ptr<const impl::IslandSystem> islandSystem;
+  std::shared_ptr<const ObstacleDistanceField> obstacleDistanceField;
+  std::shared_ptr<const PathHierarchy> pathHierarchy;
+  std::unique_ptr<dtNavMeshQuery, void (*)(dtNavMeshQuery*)> navQuery{
+      nullptr, dtFreeNavMeshQuery};
+  dtQueryFilter filter;
+
+  QueryState queryState() {
+    return {navMesh.get(), navQuery.get(), &filter, islandSystem.get(),
+            obstacleDistanceField.get(), pathHierarchy.get()};
+  }
+};
+
+PathFinderQueryContext::PathFinderQueryContext(const PathFinder& pathFinder)
+    : pimpl_{spimpl::make_unique_impl<Impl>()} {
+  ESP_CHECK(pathFinder.isLoaded(),
+            "PathFinderQueryContext : the PathFinder has no navmesh loaded.");
+  pimpl_->navMesh = pathFinder.pimpl_->sharedNavMesh();
+  pimpl_->islandSystem = pathFinder.pimpl_->sharedIslandSystem();
+  pimpl_->obstacleDistanceField =
+      pathFinder.pimpl_->sharedObstacleDistanceField();
+  pimpl_->pathHierarchy = pathFinder.pimpl_->sharedPathHierarchy();
+  // copied so island-restricted sampling on the PathFinder, which edits its
+  // filter, never affects queries made through this context
+  pimpl_->filter = pathFinder.pimpl_->filter();
+  pimpl_->navQuery.reset(dtAllocNavMeshQuery());
+  ESP_CHECK(pimpl_->navQuery &&
+                dtStatusSucceed(
+                    pimpl_->navQuery->init(pimpl_->navMesh.get(), 2048)),
+            "PathFinderQueryContext : could not init Detour navmesh query.");
+}
+
+bool PathFinderQueryContext::findPath(ShortestPath& path) {
+  return queryPath(pimpl_->queryState(), path);
+}
+
+template vec3f PathFinderQueryContext::tryStep<vec3f>(const vec3f&,
+                                                      const vec3f&);
+template Mn::Vector3 PathFinderQueryContext::tryStep<Mn::Vector3>(
+    const Mn::Vector3&,
+    const Mn::Vector3&);
+
+template <typename T>
+T PathFinderQueryContext::tryStep(const T& start, const T& end) {
+  return queryTryStep(pimpl_->queryState(), start, end,
+                      /*allowSliding=*/true);
+}
+
+template vec3f PathFinderQueryContext::tryStepNoSliding<vec3f>(const vec3f&,
+                                                               const vec3f&);
+template Mn::Vector3 PathFinderQueryContext::tryStepNoSliding<Mn::Vector3>(
+    const Mn::Vector3&,
+    const Mn::Vector3&);
+
+template <typename T>
+T PathFinderQueryContext::tryStepNoSliding(const T& start, const T& end) {
+  return queryTryStep(pimpl_->queryState(), start, end,
+                      /*allowSliding=*/false);
+}
+
+template vec3f PathFinderQueryContext::snapPoint<vec3f>(const vec3f& pt,
+                                                        int islandIndex);
+template Mn::Vector3 PathFinderQueryContext::snapPoint<Mn::Vector3>(
+    const Mn::Vector3& pt,
+    int islandIndex);
+
+template <typename T>
+T PathFinderQueryContext::snapPoint(const T& pt, int islandIndex) {
+  pimpl_->islandSystem->assertValidIsland(islandIndex);
+  return querySnapPoint(pimpl_->queryState(), pt, islandIndex);
+}
+
+template int PathFinderQueryContext::getIsland<vec3f>(const vec3f& pt);
+template int PathFinderQueryContext::getIsland<Mn::Vector3>(
+    const Mn::Vector3& pt);
+
+template <typename T>
+int PathFinderQueryContext::getIsland(const T& pt) {
+  return queryIsland(pimpl_->queryState(), pt);
+}
+
+float PathFinderQueryContext::islandRadius(const vec3f& pt) {
+  return queryIslandRadius(pimpl_->queryState(), pt);
+}
+
+float PathFinderQueryContext::distanceToClosestObstacle(
+    const vec3f& pt,
+    const float maxSearchRadius) {
+  return queryDistanceToClosestObstacle(pimpl_->queryState(), pt,
+                                        maxSearchRadius);
+}
+
+HitRecord PathFinderQueryContext::closestObstacleSurfacePoint(
+    const vec3f& pt,
+    const float maxSearchRadius) {
+  return queryClosestObstacleSurfacePoint(pimpl_->queryState(), pt,
+                                          maxSearchRadius);
+}
+
+bool PathFinderQueryContext::isNavigable(const vec3f& pt,
+                                         const float maxYDelta) {
+  return queryIsNavigable(pimpl_->queryState(), pt, maxYDelta);
+}
+
 }  // namespace nav
 }  // namespace esp
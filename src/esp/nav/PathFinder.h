@@ -6,7 +6,10 @@
 #define ESP_NAV_PATHFINDER_H_
 
 #include <Corrade/Containers/Optional.h>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "esp/core/Esp.h"
@@ -113,6 +116,18 @@ struct MultiGoalShortestPath {
    */
   int closestEndPointIndex{};
 
+  /**
+   * @brief Answer queries from a geodesic distance field over the navmesh
+   * polygons instead of searching paths to the ends.
+   *
+   * The field is built by the first query and reused until the requested ends
+   * or the navmesh change, so repeated queries against the same ends cost only
+   * a projection of the start point. Distances are approximate (routed through
+   * polygon centers and shared edge midpoints) and only @ref geodesicDistance
+   * and @ref closestEndPointIndex are filled, @ref points is left empty.
+   */
+  bool useDistanceField = false;
+
   friend class PathFinder;
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(MultiGoalShortestPath)
@@ -263,6 +278,17 @@ struct NavMeshSettings {
    */
   bool includeStaticObjects{};
 
+  /**
+   * @brief XZ-plane edge length of navmesh tiles in world units, or 0 to build
+   * the navmesh as a single tile.
+   *
+   * Tiles are built in parallel, and rebuilding with the same settings and
+   * bounds only rebuilds the tiles whose input triangles changed, e.g.
+   * around STATIC objects that were added or moved. Kept last, as older
+   * .navmesh files store the settings without it.
+   */
+  float tileSize{};
+
   void setDefaults() {
     cellSize = 0.05f;
     cellHeight = 0.2f;
@@ -281,6 +307,7 @@ struct NavMeshSettings {
     filterLedgeSpans = true;
     filterWalkableLowHeightSpans = true;
     includeStaticObjects = false;
+    tileSize = 0.0f;
   }
 
   //! Load the settings from a JSON file
@@ -305,6 +332,82 @@ bool operator==(const NavMeshSettings& a, const NavMeshSettings& b);
  */
 bool operator!=(const NavMeshSettings& a, const NavMeshSettings& b);
 
+/**
+ * @brief Handle for read-only navigation queries on the navmesh of a @ref
+ * PathFinder from one thread.
+ *
+ * Each context owns its own Detour query and filter while sharing the navmesh
+ * itself, so many threads can query one loaded navmesh concurrently, one
+ * context per thread, without duplicating it in memory. Queries behave like
+ * the @ref PathFinder methods of the same name.
+ *
+ * A context keeps the navmesh it was created from alive, and keeps querying
+ * it even after the @ref PathFinder has been rebuilt or reloaded. A single
+ * context must not be used by more than one thread at a time.
+ */
+class PathFinderQueryContext {
+ public:
+  /**
+   * @brief Create a context on the navmesh currently loaded in @p pathFinder.
+   * See also @ref PathFinder::createQueryContext.
+   */
+  explicit PathFinderQueryContext(const PathFinder& pathFinder);
+  ~PathFinderQueryContext() = default;
+
+  /**
+   * @brief See @ref PathFinder::findPath(ShortestPath&).
+   */
+  bool findPath(ShortestPath& path);
+
+  /**
+   * @brief See @ref PathFinder::tryStep.
+   */
+  template <typename T>
+  T tryStep(const T& start, const T& end);
+
+  /**
+   * @brief See @ref PathFinder::tryStepNoSliding.
+   */
+  template <typename T>
+  T tryStepNoSliding(const T& start, const T& end);
+
+  /**
+   * @brief See @ref PathFinder::snapPoint.
+   */
+  template <typename T>
+  T snapPoint(const T& pt, int islandIndex = ID_UNDEFINED);
+
+  /**
+   * @brief See @ref PathFinder::getIsland.
+   */
+  template <typename T>
+  int getIsland(const T& pt);
+
+  /**
+   * @brief See @ref PathFinder::islandRadius(const vec3f&) const.
+   */
+  float islandRadius(const vec3f& pt);
+
+  /**
+   * @brief See @ref PathFinder::distanceToClosestObstacle.
+   */
+  float distanceToClosestObstacle(const vec3f& pt,
+                                  float maxSearchRadius = 2.0);
+
+  /**
+   * @brief See @ref PathFinder::closestObstacleSurfacePoint.
+   */
+  HitRecord closestObstacleSurfacePoint(const vec3f& pt,
+                                        float maxSearchRadius = 2.0);
+
+  /**
+   * @brief See @ref PathFinder::isNavigable.
+   */
+  bool isNavigable(const vec3f& pt, float maxYDelta = 0.5);
+
+  ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(PathFinderQueryContext)
+};
+
 /** @brief Loads and/or builds a navigation mesh and then allows point sampling,
  * path finding, collision, and island queries on that navmesh.
  *
@@ -411,6 +514,33 @@ class PathFinder {
                                             int maxTries = 10,
                                             int islandIndex = ID_UNDEFINED);
 
+  /**
+   * @brief Draws @p count random navigable points, uniformly distributed by
+   * area, spread across worker threads.
+   *
+   * Unlike @ref getRandomNavigablePoint, which samples a polygon and then a
+   * point on it through the Detour query, points are drawn from a cumulative
+   * area distribution over the detail triangles of the walkable polygons,
+   * built on first use per island and kept until the navmesh changes. Each
+   * point comes from its own counter-based random stream derived from
+   * @p seed and its index, so the result depends neither on
+   * @p numThreads nor on @ref seed.
+   *
+   *  @param[in] count Number of points to draw
+   *  @param[in] seed Seed of the random streams
+   *  @param[in] islandIndex Optionally specify the island from which to
+   * sample the points. Default -1 samples the full navmesh.
+   *  @param[in] numThreads Number of threads to use, including the calling
+   * one. If not positive, the number of hardware threads is used.
+   *
+   * @return The navigable points.
+   */
+  std::vector<Magnum::Vector3> getRandomNavigablePoints(
+      std::size_t count,
+      uint64_t seed,
+      int islandIndex = ID_UNDEFINED,
+      int numThreads = 0);
+
   /**
    * @brief Finds the shortest path between two points on the navigation mesh
    *
@@ -444,6 +574,58 @@ class PathFinder {
    */
   bool findPath(MultiGoalShortestPath& path);
 
+  /**
+   * @brief Finds the shortest paths for a batch of start/end pairs, spreading
+   * the queries across worker threads.
+   *
+   * Each worker runs its own navmesh query on the shared navmesh, so results
+   * are identical to calling @ref findPath(ShortestPath&) on every element.
+   * No other method of this @ref PathFinder may be called while the batch is
+   * running.
+   *
+   * @param[inout] paths The @ref ShortestPath structures to solve. Their
+   * @ref ShortestPath.points and @ref ShortestPath.geodesicDistance fields are
+   * populated as in @ref findPath(ShortestPath&).
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   *
+   * @return The number of paths that were found.
+   */
+  int findPaths(std::vector<ShortestPath>& paths, int numThreads = 0);
+
+  /**
+   * @brief Geodesic distances between all pairs of @p points.
+   *
+   * Instead of a path query for every pair, this runs one Dijkstra search
+   * per point over the graph of midpoints of the edges shared by two
+   * polygons, with the sources spread across worker threads. The distance to
+   * every other point is then refined inside its polygon, which is convex,
+   * by going straight from the closest shared edge. Since paths cross
+   * polygon edges at their midpoints, distances can be slightly longer than
+   * those of @ref findPath, but they're symmetric up to rounding.
+   *
+   * @param points Points to measure between, projected onto the navmesh
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   *
+   * @return Matrix whose element (i, j) is the distance between points i and
+   * j. Points on different islands or off the navmesh are infinitely far
+   * apart.
+   */
+  Eigen::MatrixXf geodesicDistanceMatrix(
+      const std::vector<Magnum::Vector3>& points,
+      int numThreads = 0);
+
+  /**
+   * @brief Create a @ref PathFinderQueryContext for issuing read-only queries
+   * on the current navmesh from another thread.
+   *
+   * Contexts share the navmesh with this @ref PathFinder rather than copying
+   * it. Queries through different contexts may run concurrently with each
+   * other and with this @ref PathFinder's read-only queries.
+   */
+  PathFinderQueryContext::ptr createQueryContext() const;
+
   /**
    * @brief Attempts to move from @ref start to @ref end and returns the
    * navigable point closest to @ref end that is feasibly reachable from @ref
@@ -463,6 +645,58 @@ class PathFinder {
   template <typename T>
   T tryStepNoSliding(const T& start, const T& end);
 
+  /**
+   * @brief @ref tryStep or @ref tryStepNoSliding starting from a known
+   * navmesh polygon
+   *
+   * @param[in] start The starting location
+   * @param[in] end The desired end location
+   * @param[in,out] polygonHint The polygon @p start is expected to be on, or
+   * @cpp 0 @ce if unknown. Replaced with the polygon of the returned location,
+   * so feeding it back in on the next step of the same agent skips searching
+   * for the nearest polygon of the start. A hint @p start isn't on is
+   * ignored.
+   * @param allowSliding Whether the step may slide along walls
+   *
+   * @return The found end location.
+   */
+  Magnum::Vector3 tryStep(const Magnum::Vector3& start,
+                          const Magnum::Vector3& end,
+                          std::uint64_t& polygonHint,
+                          bool allowSliding = true);
+
+  /**
+   * @brief Batched @ref tryStep / @ref tryStepNoSliding, spreading the steps
+   * across worker threads the same way as @ref findPaths.
+   *
+   * @param[in] starts The starting locations
+   * @param[in] ends The desired end locations, one per start
+   * @param allowSliding Whether steps may slide along walls
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   *
+   * @return The found end location for every start/end pair.
+   */
+  std::vector<Magnum::Vector3> trySteps(
+      const std::vector<Magnum::Vector3>& starts,
+      const std::vector<Magnum::Vector3>& ends,
+      bool allowSliding = true,
+      int numThreads = 0);
+
+  /**
+   * @brief Batched @ref tryStep with polygon hints, spreading the steps
+   * across worker threads like the other @ref trySteps overload
+   *
+   * @param[in,out] polygonHints One polygon hint per start, or empty if none
+   * are known. Filled with the polygon of each returned location.
+   */
+  std::vector<Magnum::Vector3> trySteps(
+      const std::vector<Magnum::Vector3>& starts,
+      const std::vector<Magnum::Vector3>& ends,
+      std::vector<std::uint64_t>& polygonHints,
+      bool allowSliding = true,
+      int numThreads = 0);
+
   /**
    * @brief Snaps a point to the navigation mesh.
    *
@@ -522,6 +756,12 @@ class PathFinder {
    */
   bool isLoaded() const;
 
+  /**
+   * @brief Estimated host memory held by the navmesh, its queries and the
+   * cached island meshes and top-down views, in bytes.
+   */
+  std::size_t getMemoryUsage() const;
+
   /**
    * @brief Seed the pathfinder.  Useful for @ref getRandomNavigablePoint
    *
@@ -569,6 +809,11 @@ class PathFinder {
    *
    * @return The distance to the closest non-navigable location or @ref
    * maxSearchRadius if all locations within @ref maxSearchRadius are navigable
+   *
+   * If an obstacle distance field was built with
+   * @ref buildObstacleDistanceField() or loaded with the navmesh, the
+   * distance is interpolated from it wherever it covers @p pt and
+   * @p maxSearchRadius.
    */
   float distanceToClosestObstacle(const vec3f& pt,
                                   float maxSearchRadius = 2.0) const;
@@ -576,10 +821,94 @@ class PathFinder {
   /**
    * @brief Same as @ref distanceToClosestObstacle but returns additional
    * information.
+   *
+   * Always queries the navmesh, since the obstacle distance field doesn't
+   * store the obstacle locations.
    */
   HitRecord closestObstacleSurfacePoint(const vec3f& pt,
                                         float maxSearchRadius = 2.0) const;
 
+  /**
+   * @brief Batched @ref distanceToClosestObstacle, spreading the points
+   * across worker threads the same way as @ref trySteps.
+   *
+   * @param[in] pts The points to begin searching from
+   * @param maxSearchRadius The radius to search in
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   *
+   * @return The distance for every point.
+   */
+  std::vector<float> distancesToClosestObstacle(
+      const std::vector<Magnum::Vector3>& pts,
+      float maxSearchRadius = 2.0,
+      int numThreads = 0);
+
+  /**
+   * @brief Precompute the distance to the closest obstacle on a top-down grid
+   * over the navmesh.
+   *
+   * The walkable surface is sampled at every grid point, on every floor
+   * above it, and each sample is queried in parallel. Afterwards
+   * @ref distanceToClosestObstacle interpolates bilinearly between the four
+   * samples around the point at its height, and falls back to querying the
+   * navmesh next to its border or for a larger search radius. The field is
+   * written by @ref saveNavMesh and restored by @ref loadNavMesh, and
+   * discarded whenever the navmesh changes.
+   *
+   * @param metersPerPixel Grid spacing. Interpolation error is up to about
+   * half of it next to obstacle corners.
+   * @param maxSearchRadius Radius to search for obstacles in, larger
+   * distances are stored as this
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   */
+  void buildObstacleDistanceField(float metersPerPixel = 0.05f,
+                                  float maxSearchRadius = 2.0f,
+                                  int numThreads = 0);
+
+  /** @brief Whether an obstacle distance field is built or loaded */
+  bool hasObstacleDistanceField() const;
+
+  /**
+   * @brief Drop the obstacle distance field, going back to querying the
+   * navmesh for every distance
+   */
+  void clearObstacleDistanceField();
+
+  /**
+   * @brief Precompute a hierarchy of regions and portals for finding long
+   * paths on large navmeshes.
+   *
+   * Polygons are clustered into compact regions of up to @p regionSize
+   * polygons each, with a portal on every polygon edge between two regions,
+   * and the distances between the portals of every region are precomputed.
+   * Afterwards @ref findPath, @ref findPaths and queries of a
+   * @ref PathFinderQueryContext search paths between regions that aren't
+   * neighbours over the portals first, which visits far fewer nodes than a
+   * search over all polygons. Each step between two portals is then refined
+   * with a local polygon search, and the whole path is straightened at once.
+   * Such paths may be slightly longer than the exact shortest path. Paths
+   * within a region or into a neighbouring one, and paths the hierarchy
+   * can't find, use the direct search. The hierarchy is written by
+   * @ref saveNavMesh and restored by @ref loadNavMesh, and discarded whenever
+   * the navmesh changes.
+   *
+   * @param regionSize Maximum number of polygons in a region
+   * @param numThreads Number of threads to use, including the calling one. If
+   * not positive, the number of hardware threads is used.
+   */
+  void buildPathHierarchy(int regionSize = 64, int numThreads = 0);
+
+  /** @brief Whether a path hierarchy is built or loaded */
+  bool hasPathHierarchy() const;
+
+  /**
+   * @brief Drop the path hierarchy, going back to searching all paths over
+   * the navmesh polygons directly
+   */
+  void clearPathHierarchy();
+
   /**
    * @brief Query whether or not a given location is navigable
    *
@@ -624,11 +953,20 @@ class PathFinder {
    * @param height The vertical height of the 2D slice.
    * @param eps Sets allowable epsilon meter Y offsets from the configured
    * height value.
+   * @param rasterize Rasterize the navmesh polygons at the height slice
+   * directly into the grid, in parallel across rows, instead of querying
+   * @ref isNavigable for every cell. Much faster at fine resolutions, but
+   * cells right at polygon borders may differ from the sampled result.
+   *
+   * Results are cached per argument set until the navmesh changes.
    *
    * @return The 2D grid marking cells as navigable or not.
    */
-  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownView(float metersPerPixel, float height, float eps = 0.5);
+  Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> getTopDownView(
+      float metersPerPixel,
+      float height,
+      float eps = 0.5,
+      bool rasterize = false);
 
   /**
    * @brief Get a 2D grid marking island index for navigable cells and -1 for
@@ -641,11 +979,18 @@ class PathFinder {
    * @param height The vertical height of the 2D slice.
    * @param eps Sets allowable epsilon meter Y offsets from the configured
    * height value.
+   * @param rasterize See @ref getTopDownView. Where polygons overlap, the
+   * island of the one closest to the height slice is used.
+   *
+   * Results are cached per argument set until the navmesh changes.
    *
    * @return The 2D grid marking cell islands or -1 for not navigable.
    */
-  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic>
-  getTopDownIslandView(float metersPerPixel, float height, float eps = 0.5);
+  Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> getTopDownIslandView(
+      float metersPerPixel,
+      float height,
+      float eps = 0.5,
+      bool rasterize = false);
 
   /**
    * @brief Returns a MeshData object containing triangulated NavMesh polys.
@@ -663,12 +1008,36 @@ class PathFinder {
   std::shared_ptr<assets::MeshData> getNavMeshData(
       int islandIndex = ID_UNDEFINED);
 
+  /**
+   * @brief Revisions of the NavMesh tiles, keyed by their (x, z) location on
+   * the tile grid.
+   *
+   * Every tile gets a new revision, unique across all PathFinder instances,
+   * whenever the NavMesh is built or loaded, except for tiles an incremental
+   * tiled @ref build() left untouched, which keep theirs. Non-tiled NavMeshes
+   * have a single tile at (0, 0). Meant for updating data derived from the
+   * NavMesh, such as its visualization, only where it changed.
+   */
+  std::map<std::pair<int, int>, uint64_t> getNavMeshTileRevisions() const;
+
+  /**
+   * @brief Returns a MeshData object containing the triangulated polys of the
+   * NavMesh tile at (@p tileX, @p tileZ), see @ref getNavMeshTileRevisions().
+   *
+   * Unlike @ref getNavMeshData, the result isn't cached. Empty if there's no
+   * such tile.
+   */
+  std::shared_ptr<assets::MeshData> getNavMeshTileData(int tileX,
+                                                       int tileZ) const;
+
   /**
    * @brief Return the settings for the current NavMesh.
    */
   Corrade::Containers::Optional<NavMeshSettings> getNavMeshSettings() const;
 
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(PathFinder)
+
+  friend class PathFinderQueryContext;
 };
 
 }  // namespace nav
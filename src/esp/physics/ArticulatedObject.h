@@ -11,6 +11,8 @@
  * JointMotorType, struct @ref JointMotorSettings
  */
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "RigidBase.h"
 #include "esp/core/Esp.h"
 #include "esp/metadata/URDFParser.h"
@@ -510,6 +512,67 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
    */
   virtual std::vector<float> getJointPositions() { return {}; }
 
+  /**
+   * @brief Get the number of degrees of freedom of all joints, the size of
+   * the joint velocities and forces.
+   */
+  virtual int getNumDofs() const { return 0; }
+
+  /**
+   * @brief Get the number of position variables of all joints, the size of
+   * the joint positions.
+   */
+  virtual int getNumJointPositions() const { return 0; }
+
+  /**
+   * @brief Set forces/torques for all joints from a view of @ref getNumDofs
+   * values.
+   */
+  virtual void setJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> forces) {}
+
+  /**
+   * @brief Add forces/torques to all joints from a view of @ref getNumDofs
+   * values.
+   */
+  virtual void addJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> forces) {}
+
+  /**
+   * @brief Write the current forces/torques of all joints into the first
+   * @ref getNumDofs values of @p forces, without allocating.
+   */
+  virtual void getJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> forces) {}
+
+  /**
+   * @brief Set velocities for all joints from a view of @ref getNumDofs
+   * values.
+   */
+  virtual void setJointVelocities(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> vels) {}
+
+  /**
+   * @brief Write the current velocities of all joints into the first
+   * @ref getNumDofs values of @p vels, without allocating.
+   */
+  virtual void getJointVelocities(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> vels) {}
+
+  /**
+   * @brief Set positions for all joints from a view of
+   * @ref getNumJointPositions values.
+   */
+  virtual void setJointPositions(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> positions) {}
+
+  /**
+   * @brief Write the current positions of all joints into the first
+   * @ref getNumJointPositions values of @p positions, without allocating.
+   */
+  virtual void getJointPositions(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> positions) {}
+
   /**
    * @brief Get the torques on each joint
    *
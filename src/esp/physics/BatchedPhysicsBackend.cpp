@@ -0,0 +1,262 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BatchedPhysicsBackend.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "PhysicsManager.h"
+#include "esp/core/Check.h"
+#include "esp/core/ThreadAffinity.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+/**
+ * @brief Call @p fn for each articulated object in @p objectIds with its
+ * slice of @p values, @p countFn values per object. The ids and the size of
+ * @p values are checked by the object managers already.
+ */
+template <class T, class CountFn, class Fn>
+void forEachJointStateSlice(PhysicsManager& physMgr,
+                            Cr::Containers::ArrayView<const int> objectIds,
+                            Cr::Containers::ArrayView<T> values,
+                            const CountFn& countFn,
+                            const Fn& fn) {
+  std::size_t offset = 0;
+  for (const int objectId : objectIds) {
+    ArticulatedObject& ao = physMgr.getArticulatedObject(objectId);
+    const std::size_t count = countFn(ao);
+    fn(ao, values.slice(offset, offset + count));
+    offset += count;
+  }
+}
+
+std::size_t dofCount(const ArticulatedObject& ao) {
+  return ao.getNumDofs();
+}
+
+std::size_t jointPositionCount(const ArticulatedObject& ao) {
+  return ao.getNumJointPositions();
+}
+
+}  // namespace
+
+BatchedPhysicsBackend::~BatchedPhysicsBackend() = default;
+
+CpuBatchedPhysicsBackend::CpuBatchedPhysicsBackend(int numThreads)
+    : numThreads_{numThreads} {
+  if (numThreads_ <= 0) {
+    numThreads_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+int CpuBatchedPhysicsBackend::addWorld(PhysicsManager& physicsManager) {
+  if (!freeWorldIds_.empty()) {
+    const int worldId = freeWorldIds_.back();
+    freeWorldIds_.pop_back();
+    worlds_[worldId] = &physicsManager;
+    return worldId;
+  }
+  worlds_.push_back(&physicsManager);
+  return int(worlds_.size()) - 1;
+}
+
+void CpuBatchedPhysicsBackend::removeWorld(int worldId) {
+  world(worldId);
+  worlds_[worldId] = nullptr;
+  freeWorldIds_.push_back(worldId);
+}
+
+std::size_t CpuBatchedPhysicsBackend::getNumWorlds() const {
+  return worlds_.size() - freeWorldIds_.size();
+}
+
+PhysicsManager& CpuBatchedPhysicsBackend::world(int worldId) const {
+  ESP_CHECK(worldId >= 0 && std::size_t(worldId) < worlds_.size() &&
+                worlds_[worldId],
+            "CpuBatchedPhysicsBackend : no world with ID" << worldId);
+  return *worlds_[worldId];
+}
+
+void CpuBatchedPhysicsBackend::stepWorlds(
+    Cr::Containers::ArrayView<const int> worldIds,
+    double dt) {
+  std::vector<PhysicsManager*> worlds;
+  worlds.reserve(worldIds.size());
+  for (const int worldId : worldIds) {
+    worlds.push_back(&world(worldId));
+  }
+
+  std::atomic<std::size_t> nextWorld{0};
+  const auto stepWorlds = [&]() {
+    for (std::size_t i; (i = nextWorld++) < worlds.size();) {
+      worlds[i]->stepPhysics(dt);
+    }
+  };
+  const std::size_t numThreads =
+      std::min<std::size_t>(numThreads_, worlds.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back([&]() {
+      core::pinCurrentThread(core::ThreadRole::Worker);
+      stepWorlds();
+    });
+  }
+  stepWorlds();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getRigidTransformations(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Matrix4> transformations) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    transformations[i] =
+        physMgr.getRigidObject(objectIds[i]).getTransformation();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getRigidLinearVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    vels[i] = physMgr.getRigidObject(objectIds[i]).getLinearVelocity();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getRigidAngularVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    vels[i] = physMgr.getRigidObject(objectIds[i]).getAngularVelocity();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getArticulatedTransformations(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Matrix4> transformations) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    transformations[i] =
+        physMgr.getArticulatedObject(objectIds[i]).getTransformation();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getArticulatedRootLinearVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    vels[i] =
+        physMgr.getArticulatedObject(objectIds[i]).getRootLinearVelocity();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getArticulatedRootAngularVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) {
+  PhysicsManager& physMgr = world(worldId);
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    vels[i] =
+        physMgr.getArticulatedObject(objectIds[i]).getRootAngularVelocity();
+  }
+}
+
+void CpuBatchedPhysicsBackend::getJointPositions(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> positions) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, positions, jointPositionCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+        ao.getJointPositions(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::setJointPositions(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> positions) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, positions, jointPositionCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<const float> slice) {
+        ao.setJointPositions(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::getJointVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> vels) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, vels, dofCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+        ao.getJointVelocities(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::setJointVelocities(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> vels) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, vels, dofCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<const float> slice) {
+        ao.setJointVelocities(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::getJointForces(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> forces) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, forces, dofCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+        ao.getJointForces(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::setJointForces(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> forces) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, forces, dofCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<const float> slice) {
+        ao.setJointForces(slice);
+      });
+}
+
+void CpuBatchedPhysicsBackend::addJointForces(
+    int worldId,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> forces) {
+  forEachJointStateSlice(
+      world(worldId), objectIds, forces, dofCount,
+      [](ArticulatedObject& ao, Cr::Containers::ArrayView<const float> slice) {
+        ao.addJointForces(slice);
+      });
+}
+
+}  // namespace physics
+}  // namespace esp
@@ -0,0 +1,277 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BATCHEDPHYSICSBACKEND_H_
+#define ESP_PHYSICS_BATCHEDPHYSICSBACKEND_H_
+
+/** @file
+ * @brief Class @ref esp::physics::BatchedPhysicsBackend, class
+ * @ref esp::physics::CpuBatchedPhysicsBackend
+ */
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace physics {
+
+class PhysicsManager;
+
+/**
+ * @brief Interface of a physics engine simulating many worlds at once
+ *
+ * A world is the content of one @ref PhysicsManager, attached with
+ * @ref PhysicsManager::setBatchedBackend(). All attached worlds are advanced
+ * together by a single @ref stepWorlds() call, which lets an engine keep the
+ * state of all of them in a few large arrays, one per quantity, and update
+ * them in one go, for example on a GPU.
+ *
+ * Once a world is attached, the batched accessors of its
+ * @ref RigidObjectManager and @ref ArticulatedObjectManager, such as
+ * @ref RigidObjectManager::getTransformations() or
+ * @ref ArticulatedObjectManager::setJointPositions(), go to the backend
+ * instead of to the objects one by one. The managers validate the object ids
+ * and view sizes first, so the backend gets only ids of existing objects of
+ * the right kind and views of exactly the right size. Views are always host
+ * memory laid out like the manager APIs, a backend keeping its state
+ * elsewhere copies from and to them.
+ *
+ * Objects are still added, removed and configured through the
+ * @ref PhysicsManager of the world, which the backend gets in
+ * @ref addWorld() to mirror its content from.
+ */
+class BatchedPhysicsBackend {
+ public:
+  virtual ~BatchedPhysicsBackend();
+
+  /**
+   * @brief Add the world of @p physicsManager
+   * @return ID of the world, passed to all other functions
+   *
+   * Called by @ref PhysicsManager::setBatchedBackend().
+   */
+  virtual int addWorld(PhysicsManager& physicsManager) = 0;
+
+  /**
+   * @brief Remove world @p worldId
+   *
+   * Called when its @ref PhysicsManager is detached or destroyed.
+   */
+  virtual void removeWorld(int worldId) = 0;
+
+  /** @brief Number of attached worlds */
+  virtual std::size_t getNumWorlds() const = 0;
+
+  /**
+   * @brief Advance the worlds @p worldIds by @p dt seconds in one call
+   *
+   * The worlds are expected to be independent of each other.
+   */
+  virtual void stepWorlds(Corrade::Containers::ArrayView<const int> worldIds,
+                          double dt) = 0;
+
+  //============ Rigid objects =============
+
+  /** @brief Transformations of rigid objects @p objectIds of a world */
+  virtual void getRigidTransformations(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations) = 0;
+
+  /** @brief Linear velocities of rigid objects @p objectIds of a world */
+  virtual void getRigidLinearVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) = 0;
+
+  /** @brief Angular velocities of rigid objects @p objectIds of a world */
+  virtual void getRigidAngularVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) = 0;
+
+  //============ Articulated objects =============
+
+  /**
+   * @brief Root transformations of articulated objects @p objectIds of a
+   * world
+   */
+  virtual void getArticulatedTransformations(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations) = 0;
+
+  /**
+   * @brief Root linear velocities of articulated objects @p objectIds of a
+   * world
+   */
+  virtual void getArticulatedRootLinearVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) = 0;
+
+  /**
+   * @brief Root angular velocities of articulated objects @p objectIds of a
+   * world
+   */
+  virtual void getArticulatedRootAngularVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) = 0;
+
+  /**
+   * @brief Joint positions of articulated objects @p objectIds of a world,
+   * laid out as in @ref ArticulatedObjectManager::getJointPositions()
+   */
+  virtual void getJointPositions(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<float> positions) = 0;
+
+  /** @brief Set joint positions of articulated objects of a world */
+  virtual void setJointPositions(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> positions) = 0;
+
+  /** @brief Joint velocities of articulated objects of a world */
+  virtual void getJointVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<float> vels) = 0;
+
+  /** @brief Set joint velocities of articulated objects of a world */
+  virtual void setJointVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> vels) = 0;
+
+  /** @brief Joint forces of articulated objects of a world */
+  virtual void getJointForces(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<float> forces) = 0;
+
+  /** @brief Set joint forces of articulated objects of a world */
+  virtual void setJointForces(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> forces) = 0;
+
+  /** @brief Add joint forces to articulated objects of a world */
+  virtual void addJointForces(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> forces) = 0;
+
+ public:
+  ESP_SMART_POINTERS(BatchedPhysicsBackend)
+};
+
+/**
+ * @brief Batched backend stepping the worlds with their own physics managers
+ *
+ * The reference implementation of @ref BatchedPhysicsBackend. Every world is
+ * simulated by its @ref PhysicsManager as usual, @ref stepWorlds() calls
+ * @ref PhysicsManager::stepPhysics() of the worlds on a pool of threads and
+ * the state accessors read and write the objects directly.
+ *
+ * Stepping on more than one thread requires the worlds not to share a scene
+ * graph and their contact event callbacks, if any, to be thread-safe.
+ */
+class CpuBatchedPhysicsBackend : public BatchedPhysicsBackend {
+ public:
+  /**
+   * @brief Constructor
+   * @param numThreads  Number of threads stepping the worlds. If zero or
+   *    negative, one per hardware core is used.
+   */
+  explicit CpuBatchedPhysicsBackend(int numThreads = 1);
+
+  /** @brief Number of threads stepping the worlds */
+  int getNumThreads() const { return numThreads_; }
+
+  int addWorld(PhysicsManager& physicsManager) override;
+  void removeWorld(int worldId) override;
+  std::size_t getNumWorlds() const override;
+  void stepWorlds(Corrade::Containers::ArrayView<const int> worldIds,
+                  double dt) override;
+
+  void getRigidTransformations(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations)
+      override;
+  void getRigidLinearVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) override;
+  void getRigidAngularVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) override;
+
+  void getArticulatedTransformations(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations)
+      override;
+  void getArticulatedRootLinearVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) override;
+  void getArticulatedRootAngularVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) override;
+  void getJointPositions(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<float> positions) override;
+  void setJointPositions(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> positions) override;
+  void getJointVelocities(int worldId,
+                          Corrade::Containers::ArrayView<const int> objectIds,
+                          Corrade::Containers::ArrayView<float> vels) override;
+  void setJointVelocities(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> vels) override;
+  void getJointForces(int worldId,
+                      Corrade::Containers::ArrayView<const int> objectIds,
+                      Corrade::Containers::ArrayView<float> forces) override;
+  void setJointForces(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> forces) override;
+  void addJointForces(
+      int worldId,
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> forces) override;
+
+ private:
+  PhysicsManager& world(int worldId) const;
+
+  int numThreads_;
+  //! Indexed by world ID, null for removed worlds
+  std::vector<PhysicsManager*> worlds_;
+  //! Removed world IDs, reused by @ref addWorld()
+  std::vector<int> freeWorldIds_;
+
+ public:
+  ESP_SMART_POINTERS(CpuBatchedPhysicsBackend)
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BATCHEDPHYSICSBACKEND_H_
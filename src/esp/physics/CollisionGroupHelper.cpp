@@ -69,6 +69,25 @@ std::map<CollisionGroup, CollisionGroups>
         // everything except Noncollidable
         {CollisionGroup::UserGroup9, ~CollisionGroup::Noncollidable}};
 
+// initialize the group pair table from the default masks above
+std::map<CollisionGroup, CollisionGroups>
+    CollisionGroupHelper::collisionGroupPairs =
+        CollisionGroupHelper::computeGroupPairs();
+
+std::map<CollisionGroup, CollisionGroups>
+CollisionGroupHelper::computeGroupPairs() {
+  std::map<CollisionGroup, CollisionGroups> groupPairs;
+  for (const auto& groupA : collisionGroupMasks) {
+    CollisionGroups& pairs = groupPairs[groupA.first];
+    for (const auto& groupB : collisionGroupMasks) {
+      if ((groupA.second & groupB.first) && (groupB.second & groupA.first)) {
+        pairs |= groupB.first;
+      }
+    }
+  }
+  return groupPairs;
+}
+
 CollisionGroups CollisionGroupHelper::getMaskForGroup(CollisionGroup group) {
   return collisionGroupMasks.at(group);
 }
@@ -84,11 +103,23 @@ void CollisionGroupHelper::setGroupInteractsWith(CollisionGroup groupA,
   CollisionGroups groupAMask = collisionGroupMasks.at(groupA);
   groupAMask = interacts ? groupAMask | groupB : groupAMask & ~groupB;
   collisionGroupMasks.at(groupA) = groupAMask;
+  collisionGroupPairs = computeGroupPairs();
 }
 
 void CollisionGroupHelper::setMaskForGroup(CollisionGroup group,
                                            CollisionGroups mask) {
   collisionGroupMasks.at(group) = mask;
+  collisionGroupPairs = computeGroupPairs();
+}
+
+bool CollisionGroupHelper::groupsInteract(CollisionGroup groupA,
+                                          CollisionGroup groupB) {
+  return bool(collisionGroupPairs.at(groupA) & groupB);
+}
+
+CollisionGroups CollisionGroupHelper::getInteractingGroups(
+    CollisionGroup group) {
+  return collisionGroupPairs.at(group);
 }
 
 CollisionGroup CollisionGroupHelper::getGroup(const std::string& groupName) {
@@ -87,6 +87,16 @@ class CollisionGroupHelper {
   static std::map<std::string, CollisionGroup> collisionGroupNames;
   //! maps collision groups to collision group filter masks
   static std::map<CollisionGroup, CollisionGroups> collisionGroupMasks;
+  //! maps collision groups to the groups they collide with, i.e. the two-way
+  //! mask check precomputed for every pair of groups
+  static std::map<CollisionGroup, CollisionGroups> collisionGroupPairs;
+
+  /**
+   * @brief Compute the group pair table from the current group masks.
+   *
+   * Called whenever a mask changes so pair queries are a single lookup.
+   */
+  static std::map<CollisionGroup, CollisionGroups> computeGroupPairs();
 
  public:
   /**
@@ -125,6 +135,28 @@ class CollisionGroupHelper {
    */
   static void setMaskForGroup(CollisionGroup group, CollisionGroups mask);
 
+  /**
+   * @brief Check whether objects of two groups collide with each other.
+   *
+   * Equivalent to the two-way mask check (GroupA & MaskB) && (GroupB & MaskA)
+   * but answered from a table precomputed when masks change.
+   *
+   * @param groupA The first group.
+   * @param groupB The second group.
+   * @return Whether or not the groups collide.
+   */
+  static bool groupsInteract(CollisionGroup groupA, CollisionGroup groupB);
+
+  /**
+   * @brief Get all groups colliding with a group under the two-way mask
+   * check.
+   *
+   * A group for which this is empty never produces collision pairs.
+   *
+   * @param group The collision group being queried.
+   */
+  static CollisionGroups getInteractingGroups(CollisionGroup group);
+
   /**
    * @brief Get the collision group by its name. Must pass a valid name.
    *
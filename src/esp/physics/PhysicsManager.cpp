@@ -5,9 +5,15 @@
 #include "PhysicsManager.h"
 #include <Magnum/Math/Range.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <unordered_set>
 #include <utility>
 #include "esp/assets/CollisionMeshData.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Profiler.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/replay/ReplayManager.h"
 #include "esp/metadata/managers/AOAttributesManager.h"
 #include "esp/metadata/managers/ObjectAttributesManager.h"
 #include "esp/metadata/managers/PhysicsAttributesManager.h"
@@ -18,6 +24,31 @@
 namespace esp {
 namespace physics {
 
+bool ContactPointFilter::matches(const int objectIdA,
+                                 const int linkIndexA,
+                                 const int objectIdB,
+                                 const int linkIndexB) const {
+  const auto matchesObject = [](int filterId, int objectId) {
+    return filterId == ID_UNDEFINED || filterId == objectId;
+  };
+  if (!objectPairs.empty() &&
+      std::none_of(objectPairs.begin(), objectPairs.end(),
+                   [&](const std::pair<int, int>& pair) {
+                     return (matchesObject(pair.first, objectIdA) &&
+                             matchesObject(pair.second, objectIdB)) ||
+                            (matchesObject(pair.first, objectIdB) &&
+                             matchesObject(pair.second, objectIdA));
+                   })) {
+    return false;
+  }
+  return links.empty() ||
+         std::any_of(links.begin(), links.end(),
+                     [&](const std::pair<int, int>& link) {
+                       return link == std::make_pair(objectIdA, linkIndexA) ||
+                              link == std::make_pair(objectIdB, linkIndexB);
+                     });
+}
+
 PhysicsManager::PhysicsManager(
     assets::ResourceManager& _resourceManager,
     const metadata::attributes::PhysicsManagerAttributes::cptr&
@@ -55,6 +86,19 @@ bool PhysicsManager::initPhysicsFinalize() {
 
 PhysicsManager::~PhysicsManager() {
   ESP_DEBUG() << "Deconstructing PhysicsManager";
+  setBatchedBackend(nullptr);
+}
+
+void PhysicsManager::setBatchedBackend(
+    std::shared_ptr<BatchedPhysicsBackend> backend) {
+  if (batchedBackend_) {
+    batchedBackend_->removeWorld(batchedWorldId_);
+    batchedWorldId_ = ID_UNDEFINED;
+  }
+  batchedBackend_ = std::move(backend);
+  if (batchedBackend_) {
+    batchedWorldId_ = batchedBackend_->addWorld(*this);
+  }
 }
 
 bool PhysicsManager::addStageInstance(
@@ -128,6 +172,34 @@ int PhysicsManager::addObjectInstance(
     DrawableGroup* drawables,
     scene::SceneNode* attachmentNode,
     const std::string& lightSetup) {
+  return addObjectInstance(
+      objInstAttributes,
+      createObjectInstanceAttributes(objInstAttributes, attributesHandle),
+      defaultCOMCorrection, drawables, attachmentNode, lightSetup);
+}  // PhysicsManager::addObjectInstance
+
+int PhysicsManager::addObjectInstance(
+    const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+        objInstAttributes,
+    const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
+    bool defaultCOMCorrection,
+    DrawableGroup* drawables,
+    scene::SceneNode* attachmentNode,
+    const std::string& lightSetup) {
+  // the failure was reported when creating the attributes
+  if (!objAttributes) {
+    return ID_UNDEFINED;
+  }
+  return addObjectAndSaveAttributes(objAttributes, drawables, attachmentNode,
+                                    lightSetup, defaultCOMCorrection,
+                                    objInstAttributes);
+}  // PhysicsManager::addObjectInstance
+
+esp::metadata::attributes::ObjectAttributes::ptr
+PhysicsManager::createObjectInstanceAttributes(
+    const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+        objInstAttributes,
+    const std::string& attributesHandle) const {
   // Get ObjectAttributes
   auto objAttributes =
       resourceManager_.getObjectAttributesManager()->getObjectCopyByHandle(
@@ -140,7 +212,7 @@ int PhysicsManager::addObjectInstance(
         << objInstAttributes->getHandle()
         << "' as specified in object instance attributes, so addObjectInstance "
            "aborted.";
-    return ID_UNDEFINED;
+    return nullptr;
   }
   // check if an object is being set to be not visible for a particular
   // instance.
@@ -178,11 +250,8 @@ int PhysicsManager::addObjectInstance(
   objAttributes->setMass(objAttributes->getMass() *
                          objInstAttributes->getMassScale());
 
-  return addObjectAndSaveAttributes(objAttributes, drawables, attachmentNode,
-                                    lightSetup, defaultCOMCorrection,
-                                    objInstAttributes);
-
-}  // PhysicsManager::addObjectInstance
+  return objAttributes;
+}  // PhysicsManager::createObjectInstanceAttributes
 
 int PhysicsManager::addObjectAndSaveAttributes(
     const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
@@ -208,9 +277,18 @@ int PhysicsManager::addObjectAndSaveAttributes(
                                 objAttributes->getHandle(), objAttributes);
   }
 
-  // create and add object using provided object attributes
-  int objID =
-      addObjectInternal(objAttributes, drawables, attachmentNode, lightSetup);
+  // reuse a pooled object made from the same template if there is one,
+  // otherwise create and add object using provided object attributes
+  std::string poolKey;
+  int objID = ID_UNDEFINED;
+  if (objectPoolingEnabled_ && attachmentNode == nullptr) {
+    poolKey = getObjectPoolKey(objAttributes, drawables, lightSetup);
+    objID = reusePooledObject(poolKey);
+  }
+  if (objID == ID_UNDEFINED) {
+    objID =
+        addObjectInternal(objAttributes, drawables, attachmentNode, lightSetup);
+  }
 
   if (objID == ID_UNDEFINED) {
     // instancing failed for some reason.
@@ -222,6 +300,9 @@ int PhysicsManager::addObjectAndSaveAttributes(
            "aborted.";
     return ID_UNDEFINED;
   }
+  if (!poolKey.empty()) {
+    objectPoolKeys_[objID] = std::move(poolKey);
+  }
   auto objPtr = this->existingObjects_.at(objID);
 
   // save the scene init attributes used to configure object's initial state
@@ -319,6 +400,14 @@ int PhysicsManager::addObjectInternal(
   // Valid object exists by here.
   // Now we need to create wrapper, wrap around object,
   // and register wrapper with wrapper manager
+  registerRigidObjectWrapper(nextObjectID_, objectAttributes);
+
+  return nextObjectID_;
+}  // PhysicsManager::addObject
+
+void PhysicsManager::registerRigidObjectWrapper(
+    int objectID,
+    const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes) {
   // 1.0 Get unique name for object using simplified attributes name.
   std::string simpleObjectHandle = objectAttributes->getSimplifiedHandle();
   std::string newObjectHandle =
@@ -326,19 +415,17 @@ int PhysicsManager::addObjectInternal(
   ESP_DEBUG() << "Simplified template handle :" << simpleObjectHandle
               << " | newObjectHandle :" << newObjectHandle;
 
-  existingObjects_.at(nextObjectID_)->setObjectName(newObjectHandle);
+  existingObjects_.at(objectID)->setObjectName(newObjectHandle);
 
   // 2.0 Get wrapper - name is irrelevant, do not register.
   ManagedRigidObject::ptr objWrapper = getRigidObjectWrapper();
 
   // 3.0 Put object in wrapper
-  objWrapper->setObjectRef(existingObjects_.at(nextObjectID_));
+  objWrapper->setObjectRef(existingObjects_.at(objectID));
 
   // 4.0 register wrapper in manager
   rigidObjectManager_->registerObject(std::move(objWrapper), newObjectHandle);
-
-  return nextObjectID_;
-}  // PhysicsManager::addObject
+}  // PhysicsManager::registerRigidObjectWrapper
 
 /////////////////////////////////
 // Articulated Object Creation
@@ -433,6 +520,35 @@ int PhysicsManager::addArticulatedObjectInstance(
     const std::string& artObjAttrHandle,
     DrawableGroup* drawables,
     const std::string& lightSetup) {
+  return addArticulatedObjectInstance(
+      aObjInstAttributes,
+      createArticulatedObjectInstanceAttributes(aObjInstAttributes,
+                                                artObjAttrHandle),
+      drawables, lightSetup);
+}  // PhysicsManager::addArticulatedObjectInstance
+
+int PhysicsManager::addArticulatedObjectInstance(
+    const std::shared_ptr<
+        const esp::metadata::attributes::SceneAOInstanceAttributes>&
+        aObjInstAttributes,
+    const esp::metadata::attributes::ArticulatedObjectAttributes::ptr&
+        artObjAttributes,
+    DrawableGroup* drawables,
+    const std::string& lightSetup) {
+  // the failure was reported when creating the attributes
+  if (!artObjAttributes) {
+    return ID_UNDEFINED;
+  }
+  return addArticulatedObjectAndSaveAttributes(
+      artObjAttributes, drawables, false, lightSetup, aObjInstAttributes);
+}  // PhysicsManager::addArticulatedObjectInstance
+
+esp::metadata::attributes::ArticulatedObjectAttributes::ptr
+PhysicsManager::createArticulatedObjectInstanceAttributes(
+    const std::shared_ptr<
+        const esp::metadata::attributes::SceneAOInstanceAttributes>&
+        aObjInstAttributes,
+    const std::string& artObjAttrHandle) const {
   // Get ArticulatedObjectAttributes
   auto artObjAttributes =
       resourceManager_.getAOAttributesManager()->getObjectCopyByHandle(
@@ -445,7 +561,7 @@ int PhysicsManager::addArticulatedObjectInstance(
         << aObjInstAttributes->getHandle()
         << "' as specified in articulated object instance attributes, so "
            "addArticulatedObjectInstance aborted.";
-    return ID_UNDEFINED;
+    return nullptr;
   }
 
   // check if an object is being set to be not visible for a particular
@@ -501,10 +617,8 @@ int PhysicsManager::addArticulatedObjectInstance(
         metadata::attributes::getAOLinkOrderName(linkOrder));
   }
 
-  return addArticulatedObjectAndSaveAttributes(
-      artObjAttributes, drawables, false, lightSetup, aObjInstAttributes);
-
-}  // PhysicsManager::addArticulatedObjectInstance
+  return artObjAttributes;
+}  // PhysicsManager::createArticulatedObjectInstanceAttributes
 
 int PhysicsManager::addArticulatedObjectAndSaveAttributes(
     const esp::metadata::attributes::ArticulatedObjectAttributes::ptr&
@@ -593,6 +707,209 @@ void PhysicsManager::buildCurrentStateSceneAttributes(
 
 }  // PhysicsManager::buildCurrentStateSceneAttributes
 
+namespace {
+
+//! Version of the physics section of a state blob written by
+//! PhysicsManager::captureState. Bump whenever the layout changes.
+constexpr uint32_t PhysicsStateVersion = 1;
+
+//! Dynamic state of a single rigid or articulated object within a state blob.
+struct ObjectState {
+  int objectId = ID_UNDEFINED;
+  std::string name;
+  MotionType motionType = MotionType::UNDEFINED;
+  core::RigidState rigidState;
+  Mn::Vector3 linearVelocity;
+  Mn::Vector3 angularVelocity;
+  std::vector<float> jointPositions;
+  std::vector<float> jointVelocities;
+  bool active = false;
+};
+
+void writeObjectState(core::BlobWriter& writer, const ObjectState& state) {
+  writer.write<int>(state.objectId);
+  writer.writeString(state.name);
+  writer.write<int>(static_cast<int>(state.motionType));
+  writer.write(state.rigidState);
+  writer.write(state.linearVelocity);
+  writer.write(state.angularVelocity);
+  writer.writeArray(state.jointPositions);
+  writer.writeArray(state.jointVelocities);
+  writer.write<uint8_t>(state.active);
+}
+
+ObjectState readObjectState(core::BlobReader& reader) {
+  ObjectState state;
+  state.objectId = reader.read<int>();
+  state.name = reader.readString();
+  state.motionType = static_cast<MotionType>(reader.read<int>());
+  state.rigidState = reader.read<core::RigidState>();
+  state.linearVelocity = reader.read<Mn::Vector3>();
+  state.angularVelocity = reader.read<Mn::Vector3>();
+  state.jointPositions = reader.readArray<float>();
+  state.jointVelocities = reader.readArray<float>();
+  state.active = reader.read<uint8_t>() != 0;
+  return state;
+}
+
+}  // namespace
+
+void PhysicsManager::captureState(core::BlobWriter& writer) {
+  writer.write<uint32_t>(PhysicsStateVersion);
+  writer.write<double>(worldTime_);
+
+  ObjectState state;
+  writer.write<uint32_t>(existingObjects_.size());
+  for (const auto& objPair : existingObjects_) {
+    RigidObject& obj = *objPair.second;
+    state.objectId = objPair.first;
+    state.name = obj.getObjectName();
+    state.motionType = obj.getMotionType();
+    state.rigidState = obj.getRigidState();
+    state.linearVelocity = obj.getLinearVelocity();
+    state.angularVelocity = obj.getAngularVelocity();
+    state.active = obj.isActive();
+    writeObjectState(writer, state);
+  }
+
+  writer.write<uint32_t>(existingArticulatedObjects_.size());
+  for (const auto& aoPair : existingArticulatedObjects_) {
+    ArticulatedObject& ao = *aoPair.second;
+    state.objectId = aoPair.first;
+    state.name = ao.getObjectName();
+    state.motionType = ao.getMotionType();
+    state.rigidState = ao.getRigidState();
+    state.linearVelocity = ao.getRootLinearVelocity();
+    state.angularVelocity = ao.getRootAngularVelocity();
+    state.jointPositions = ao.getJointPositions();
+    state.jointVelocities = ao.getJointVelocities();
+    state.active = ao.isActive();
+    writeObjectState(writer, state);
+  }
+
+  writer.write<uint32_t>(rigidConstraintSettings_.size());
+  for (const auto& constraintPair : rigidConstraintSettings_) {
+    writer.write<int>(constraintPair.first);
+    writer.write(constraintPair.second);
+  }
+}  // PhysicsManager::captureState
+
+void PhysicsManager::restoreState(core::BlobReader& reader) {
+  const uint32_t version = reader.read<uint32_t>();
+  ESP_CHECK(version == PhysicsStateVersion,
+            "PhysicsManager::restoreState() : unsupported state version"
+                << version << ", expected" << PhysicsStateVersion);
+  const double worldTime = reader.read<double>();
+
+  std::vector<ObjectState> objectStates(reader.read<uint32_t>());
+  for (ObjectState& state : objectStates) {
+    state = readObjectState(reader);
+  }
+  std::vector<ObjectState> aoStates(reader.read<uint32_t>());
+  for (ObjectState& state : aoStates) {
+    state = readObjectState(reader);
+  }
+  std::map<int, RigidConstraintSettings> constraintSettings;
+  const uint32_t numConstraints = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < numConstraints; ++i) {
+    const int constraintId = reader.read<int>();
+    constraintSettings[constraintId] = reader.read<RigidConstraintSettings>();
+  }
+
+  // remove constraints and objects created after the snapshot, constraints
+  // first since they may reference those objects.
+  std::vector<int> idsToRemove;
+  for (const auto& constraintPair : rigidConstraintSettings_) {
+    if (constraintSettings.count(constraintPair.first) == 0) {
+      idsToRemove.push_back(constraintPair.first);
+    }
+  }
+  for (int constraintId : idsToRemove) {
+    removeRigidConstraint(constraintId);
+  }
+  idsToRemove.clear();
+  std::unordered_set<int> capturedIds;
+  for (const ObjectState& state : objectStates) {
+    capturedIds.insert(state.objectId);
+  }
+  for (const auto& objPair : existingObjects_) {
+    if (capturedIds.count(objPair.first) == 0) {
+      idsToRemove.push_back(objPair.first);
+    }
+  }
+  for (int objectId : idsToRemove) {
+    removeObject(objectId);
+  }
+  idsToRemove.clear();
+  capturedIds.clear();
+  for (const ObjectState& state : aoStates) {
+    capturedIds.insert(state.objectId);
+  }
+  for (const auto& aoPair : existingArticulatedObjects_) {
+    if (capturedIds.count(aoPair.first) == 0) {
+      idsToRemove.push_back(aoPair.first);
+    }
+  }
+  for (int objectId : idsToRemove) {
+    removeArticulatedObject(objectId);
+  }
+
+  // restore the captured objects in place
+  for (const ObjectState& state : objectStates) {
+    auto objIter = existingObjects_.find(state.objectId);
+    ESP_CHECK(objIter != existingObjects_.end() &&
+                  objIter->second->getObjectName() == state.name,
+              "PhysicsManager::restoreState() : rigid object"
+                  << state.name << "with ID" << state.objectId
+                  << "no longer exists. Restoring removed objects requires "
+                     "rebuilding the scene.");
+    RigidObject& obj = *objIter->second;
+    if (obj.getMotionType() != state.motionType) {
+      obj.setMotionType(state.motionType);
+    }
+    obj.setRigidState(state.rigidState);
+    obj.setLinearVelocity(state.linearVelocity);
+    obj.setAngularVelocity(state.angularVelocity);
+    obj.setActive(state.active);
+  }
+  for (const ObjectState& state : aoStates) {
+    auto aoIter = existingArticulatedObjects_.find(state.objectId);
+    ESP_CHECK(aoIter != existingArticulatedObjects_.end() &&
+                  aoIter->second->getObjectName() == state.name,
+              "PhysicsManager::restoreState() : articulated object"
+                  << state.name << "with ID" << state.objectId
+                  << "no longer exists. Restoring removed objects requires "
+                     "rebuilding the scene.");
+    ArticulatedObject& ao = *aoIter->second;
+    if (ao.getMotionType() != state.motionType) {
+      ao.setMotionType(state.motionType);
+    }
+    ao.setRigidState(state.rigidState);
+    ao.setRootLinearVelocity(state.linearVelocity);
+    ao.setRootAngularVelocity(state.angularVelocity);
+    ao.setJointPositions(state.jointPositions);
+    ao.setJointVelocities(state.jointVelocities);
+    ao.setActive(state.active);
+  }
+
+  // restore constraint settings, re-creating those removed since the snapshot
+  for (const auto& constraintPair : constraintSettings) {
+    if (rigidConstraintSettings_.count(constraintPair.first) > 0) {
+      updateRigidConstraint(constraintPair.first, constraintPair.second);
+    } else {
+      const int newConstraintId = createRigidConstraint(constraintPair.second);
+      if (newConstraintId != constraintPair.first) {
+        ESP_WARNING() << "Rigid constraint" << constraintPair.first
+                      << "was removed after the state was captured and has "
+                         "been re-created with ID"
+                      << newConstraintId;
+      }
+    }
+  }
+
+  worldTime_ = worldTime;
+}  // PhysicsManager::restoreState
+
 int PhysicsManager::addTrajectoryObject(const std::string& trajVisName,
                                         const std::vector<Mn::Vector3>& pts,
                                         const std::vector<Mn::Color3>& colorVec,
@@ -679,10 +996,22 @@ void PhysicsManager::removeObject(const int objectId,
     simulator_->getRenderGLContext();
   }
   auto existingObjIter = getRigidObjIteratorOrAssert(objectId);
+  if (deleteObjectNode && poolObject(existingObjIter->second)) {
+    // keep the ID and nodes, only the wrapper is removed
+    const std::string pooledName = existingObjIter->second->getObjectName();
+    existingObjects_.erase(existingObjIter);
+    velocityControlTargetsDirty_ = true;
+    if (rigidObjectManager_->getObjectLibHasHandle(pooledName)) {
+      rigidObjectManager_->removeObjectByID(objectId);
+    }
+    return;
+  }
+  objectPoolKeys_.erase(objectId);
   scene::SceneNode* objectNode = &existingObjIter->second->node();
   scene::SceneNode* visualNode = existingObjIter->second->visualNode_;
   std::string objName = existingObjIter->second->getObjectName();
   existingObjects_.erase(existingObjIter);
+  velocityControlTargetsDirty_ = true;
   deallocateObjectID(objectId);
   if (deleteObjectNode) {
     delete objectNode;
@@ -731,6 +1060,117 @@ void PhysicsManager::removeArticulatedObject(int objectId) {
   }
 }
 
+void PhysicsManager::setObjectPoolingEnabled(bool enabled) {
+  objectPoolingEnabled_ = enabled;
+  if (!enabled) {
+    clearObjectPool();
+    objectPoolKeys_.clear();
+  }
+}
+
+int PhysicsManager::getNumPooledObjects() const {
+  int numPooled = 0;
+  for (const auto& entry : objectPool_) {
+    numPooled += static_cast<int>(entry.second.size());
+  }
+  return numPooled;
+}
+
+void PhysicsManager::clearObjectPool() {
+  if (objectPool_.empty()) {
+    return;
+  }
+  if (simulator_ != nullptr) {
+    // acquire context if available
+    simulator_->getRenderGLContext();
+  }
+  for (auto& entry : objectPool_) {
+    for (PooledObject& pooled : entry.second) {
+      const int objectId = pooled.object->getID();
+      scene::SceneNode* objectNode = &pooled.object->node();
+      pooled.object.reset();
+      deallocateObjectID(objectId);
+      delete objectNode;
+    }
+  }
+  objectPool_.clear();
+}
+
+std::string PhysicsManager::getObjectPoolKey(
+    const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes,
+    const DrawableGroup* drawables,
+    const std::string& lightSetup) {
+  // the full template contents, as a template may be modified and registered
+  // again under the same handle
+  return objectAttributes->getHandle() + "|" +
+         std::to_string(reinterpret_cast<std::uintptr_t>(drawables)) + "|" +
+         lightSetup + "|" + objectAttributes->getAllValsAsString("|");
+}
+
+namespace {
+bool isGfxReplayRecording(esp::sim::Simulator* simulator) {
+  return simulator != nullptr && simulator->getGfxReplayManager() &&
+         simulator->getGfxReplayManager()->getRecorder();
+}
+}  // namespace
+
+int PhysicsManager::reusePooledObject(const std::string& poolKey) {
+  auto poolIter = objectPool_.find(poolKey);
+  if (poolIter == objectPool_.end() || isGfxReplayRecording(simulator_)) {
+    return ID_UNDEFINED;
+  }
+  PooledObject pooled = std::move(poolIter->second.back());
+  poolIter->second.pop_back();
+  if (poolIter->second.empty()) {
+    objectPool_.erase(poolIter);
+  }
+  if (simulator_ != nullptr) {
+    // acquire context if available
+    simulator_->getRenderGLContext();
+  }
+  for (const auto& drawable : pooled.drawables) {
+    drawable.second->add(*drawable.first);
+  }
+  const int objectId = pooled.object->getID();
+  pooled.object->resetForPoolReuse();
+  existingObjects_.emplace(objectId, pooled.object);
+  velocityControlTargetsDirty_ = true;
+  registerRigidObjectWrapper(objectId,
+                             pooled.object->getInitializationAttributes());
+  return objectId;
+}
+
+bool PhysicsManager::poolObject(const RigidObject::ptr& object) {
+  auto keyIter = objectPoolKeys_.find(object->getID());
+  if (keyIter == objectPoolKeys_.end()) {
+    return false;
+  }
+  std::string poolKey = std::move(keyIter->second);
+  objectPoolKeys_.erase(keyIter);
+  if (!objectPoolingEnabled_ || isGfxReplayRecording(simulator_)) {
+    return false;
+  }
+
+  PooledObject pooled{object, {}};
+  if (object->BBNode_ != nullptr) {
+    delete object->BBNode_;
+    object->BBNode_ = nullptr;
+  }
+  // hide the object by taking its drawables out of their groups
+  scene::preOrderFeatureTraversalWithCallback<gfx::Drawable>(
+      object->node(), [&pooled](gfx::Drawable& drawable) {
+        if (DrawableGroup* group = drawable.drawables()) {
+          pooled.drawables.emplace_back(&drawable, group);
+        }
+      });
+  for (const auto& drawable : pooled.drawables) {
+    drawable.second->remove(*drawable.first);
+  }
+  object->deactivateForPool();
+  objectPool_[poolKey].push_back(std::move(pooled));
+  return true;
+}
+
 int PhysicsManager::allocateObjectID() {
   if (!recycledObjectIDs_.empty()) {
     int recycledID = recycledObjectIDs_.back();
@@ -755,10 +1195,23 @@ bool PhysicsManager::makeAndAddRigidObject(
   bool objSuccess = ptr->initialize(objectAttributes);
   if (objSuccess) {
     existingObjects_.emplace(newObjectID, std::move(ptr));
+    velocityControlTargetsDirty_ = true;
   }
   return objSuccess;
 }
 
+const std::vector<RigidObject*>& PhysicsManager::velocityControlTargets() {
+  if (velocityControlTargetsDirty_) {
+    velocityControlTargets_.clear();
+    velocityControlTargets_.reserve(existingObjects_.size());
+    for (const auto& object : existingObjects_) {
+      velocityControlTargets_.push_back(object.second.get());
+    }
+    velocityControlTargetsDirty_ = false;
+  }
+  return velocityControlTargets_;
+}
+
 // TODO: this function should do any engine specific setting which is
 // necessary to change the timestep
 void PhysicsManager::setTimestep(double dt) {
@@ -788,19 +1241,48 @@ void PhysicsManager::stepPhysics(double dt) {
 
   // handle in-between step times? Ideally dt is a multiple of
   // sceneMetaData_.timestep
+  // kinematic velocity control integration. The states are gathered once,
+  // integrated over all fixed steps and written back at the end.
+  velocityControlBatch_.clear();
+  velocityControlBatchObjects_.clear();
+  std::vector<RigidObject*> unbatchedObjects;
+  for (RigidObject* object : velocityControlTargets()) {
+    const VelocityControl& velControl = *object->getVelocityControl();
+    if (!velControl.controllingAngVel && !velControl.controllingLinVel) {
+      continue;
+    }
+    if (VelocityControlBatch::isBatchable(velControl)) {
+      velocityControlBatch_.add(velControl, object->getRigidState());
+      velocityControlBatchObjects_.push_back(object);
+    } else {
+      unbatchedObjects.push_back(object);
+    }
+  }
+
   double targetTime = worldTime_ + dt;
-  while (worldTime_ < targetTime) {
+  const int maxSubSteps = physicsManagerAttributes_->getMaxSubsteps();
+  int numSubSteps = 0;
+  bool stepped = false;
+  while (worldTime_ < targetTime &&
+         (maxSubSteps <= 0 || numSubSteps < maxSubSteps)) {
     // per fixed-step operations can be added here
 
-    // kinematic velocity control integration
-    for (auto& object : existingObjects_) {
-      VelocityControl::ptr velControl = object.second->getVelocityControl();
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        object.second->setRigidState(velControl->integrateTransform(
-            fixedTimeStep_, object.second->getRigidState()));
-      }
+    velocityControlBatch_.integrate(fixedTimeStep_);
+    for (RigidObject* object : unbatchedObjects) {
+      object->setRigidState(object->getVelocityControl()->integrateTransform(
+          fixedTimeStep_, object->getRigidState()));
     }
     worldTime_ += fixedTimeStep_;
+    ++numSubSteps;
+    stepped = true;
+  }
+  ESP_PROFILE_COUNT("PhysicsManager::substeps", numSubSteps);
+
+  if (stepped) {
+    for (std::size_t i = 0; i != velocityControlBatchObjects_.size(); ++i) {
+      velocityControlBatchObjects_[i]->setRigidState(
+          velocityControlBatch_.state(i));
+    }
   }
 }
 
@@ -865,6 +1347,230 @@ void PhysicsManager::setObjectBBDraw(int physObjectID,
   }
 }
 
+void PhysicsManager::updateRigidConstraints(
+    Corrade::Containers::ArrayView<const int> constraintIds,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+    Corrade::Containers::ArrayView<const float> maxImpulses) {
+  const std::size_t count = constraintIds.size();
+  ESP_CHECK((pivotsA.isEmpty() || pivotsA.size() == count) &&
+                (pivotsB.isEmpty() || pivotsB.size() == count) &&
+                (framesA.isEmpty() || framesA.size() == count) &&
+                (framesB.isEmpty() || framesB.size() == count) &&
+                (maxImpulses.isEmpty() || maxImpulses.size() == count),
+            "PhysicsManager::updateRigidConstraints(): expected either no "
+            "values or"
+                << count << "values for each parameter");
+  updateRigidConstraintsInternal(constraintIds, pivotsA, pivotsB, framesA,
+                                 framesB, maxImpulses);
+}
+
+void PhysicsManager::updateRigidConstraintsInternal(
+    Corrade::Containers::ArrayView<const int> constraintIds,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+    Corrade::Containers::ArrayView<const float> maxImpulses) {
+  for (std::size_t i = 0; i != constraintIds.size(); ++i) {
+    RigidConstraintSettings settings =
+        getRigidConstraintSettings(constraintIds[i]);
+    if (!pivotsA.isEmpty()) {
+      settings.pivotA = pivotsA[i];
+    }
+    if (!pivotsB.isEmpty()) {
+      settings.pivotB = pivotsB[i];
+    }
+    if (!framesA.isEmpty()) {
+      settings.frameA = framesA[i];
+    }
+    if (!framesB.isEmpty()) {
+      settings.frameB = framesB[i];
+    }
+    if (!maxImpulses.isEmpty()) {
+      settings.maxImpulse = maxImpulses[i];
+    }
+    updateRigidConstraint(constraintIds[i], settings);
+  }
+}
+
+void PhysicsManager::getRigidConstraintForces(
+    Corrade::Containers::ArrayView<const int> constraintIds,
+    Corrade::Containers::ArrayView<float> forces) {
+  ESP_CHECK(forces.size() == constraintIds.size(),
+            "PhysicsManager::getRigidConstraintForces(): expected"
+                << constraintIds.size() << "outputs but got" << forces.size());
+  for (float& force : forces) {
+    force = 0.0f;
+  }
+  getRigidConstraintForcesInternal(constraintIds, forces);
+}
+
+void PhysicsManager::castRays(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    double maxDistance,
+    Corrade::Containers::ArrayView<float> distances,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals) {
+  ESP_CHECK(directions.size() == origins.size() &&
+                distances.size() == origins.size() &&
+                objectIds.size() == origins.size() &&
+                (normals.isEmpty() || normals.size() == origins.size()),
+            "PhysicsManager::castRays(): expected" << origins.size()
+                                                   << "directions and outputs");
+  for (std::size_t i = 0; i != origins.size(); ++i) {
+    distances[i] = float(maxDistance);
+    objectIds[i] = ID_UNDEFINED;
+  }
+  for (Magnum::Vector3& normal : normals) {
+    normal = {};
+  }
+  castRaysInternal(origins, directions, maxDistance, 1, distances, objectIds,
+                   normals, nullptr);
+}
+
+void PhysicsManager::castRaysAllHits(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    double maxDistance,
+    std::size_t maxHitsPerRay,
+    Corrade::Containers::ArrayView<float> distances,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+    Corrade::Containers::ArrayView<int> hitCounts) {
+  ESP_CHECK(maxHitsPerRay > 0,
+            "PhysicsManager::castRaysAllHits(): maxHitsPerRay can't be zero");
+  const std::size_t slotCount = origins.size() * maxHitsPerRay;
+  ESP_CHECK(directions.size() == origins.size() &&
+                hitCounts.size() == origins.size() &&
+                distances.size() == slotCount &&
+                objectIds.size() == slotCount &&
+                (normals.isEmpty() || normals.size() == slotCount),
+            "PhysicsManager::castRaysAllHits(): expected"
+                << origins.size() << "directions and hit counts and"
+                << slotCount << "output slots");
+  for (std::size_t i = 0; i != slotCount; ++i) {
+    distances[i] = float(maxDistance);
+    objectIds[i] = ID_UNDEFINED;
+  }
+  for (Magnum::Vector3& normal : normals) {
+    normal = {};
+  }
+  for (int& hitCount : hitCounts) {
+    hitCount = 0;
+  }
+  // an empty hitCounts view means a closest-hit query, so skip the call for
+  // an empty batch
+  if (origins.isEmpty()) {
+    return;
+  }
+  castRaysInternal(origins, directions, maxDistance, maxHitsPerRay, distances,
+                   objectIds, normals, hitCounts);
+}
+
+void PhysicsManager::castCapsules(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    float radius,
+    float height,
+    double maxDistance,
+    Corrade::Containers::ArrayView<float> distances,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals) {
+  ESP_CHECK(radius > 0.0f && height >= 0.0f,
+            "PhysicsManager::castCapsules(): expected a positive radius and a "
+            "non-negative height but got"
+                << radius << "and" << height);
+  ESP_CHECK(directions.size() == origins.size() &&
+                distances.size() == origins.size() &&
+                objectIds.size() == origins.size() &&
+                (normals.isEmpty() || normals.size() == origins.size()),
+            "PhysicsManager::castCapsules(): expected"
+                << origins.size() << "directions and outputs");
+  for (std::size_t i = 0; i != origins.size(); ++i) {
+    distances[i] = float(maxDistance);
+    objectIds[i] = ID_UNDEFINED;
+  }
+  for (Magnum::Vector3& normal : normals) {
+    normal = {};
+  }
+  castCapsulesInternal(origins, directions, radius, height, maxDistance,
+                       distances, objectIds, normals);
+}
+
+namespace {
+/**
+ * @brief Check the output buffers of an overlap query of @p queryCount
+ * volumes and fill them as empty.
+ */
+void prepareOverlapOutputs(const char* const function,
+                           const std::size_t queryCount,
+                           const std::size_t maxOverlapsPerQuery,
+                           Corrade::Containers::ArrayView<int> objectIds,
+                           Corrade::Containers::ArrayView<int> linkIds,
+                           Corrade::Containers::ArrayView<int> overlapCounts) {
+  ESP_CHECK(maxOverlapsPerQuery > 0,
+            function << "maxOverlapsPerQuery can't be zero");
+  const std::size_t slotCount = queryCount * maxOverlapsPerQuery;
+  ESP_CHECK(overlapCounts.size() == queryCount &&
+                objectIds.size() == slotCount && linkIds.size() == slotCount,
+            function << "expected" << queryCount << "overlap counts and"
+                     << slotCount << "output slots");
+  for (std::size_t i = 0; i != slotCount; ++i) {
+    objectIds[i] = ID_UNDEFINED;
+    linkIds[i] = ID_UNDEFINED;
+  }
+  for (int& overlapCount : overlapCounts) {
+    overlapCount = 0;
+  }
+}
+}  // namespace
+
+void PhysicsManager::queryBoxOverlaps(
+    Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+    std::size_t maxOverlapsPerQuery,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<int> linkIds,
+    Corrade::Containers::ArrayView<int> overlapCounts) {
+  prepareOverlapOutputs("PhysicsManager::queryBoxOverlaps():", boxes.size(),
+                        maxOverlapsPerQuery, objectIds, linkIds,
+                        overlapCounts);
+  if (boxes.isEmpty()) {
+    return;
+  }
+  queryOverlapsInternal(boxes, nullptr, nullptr, maxOverlapsPerQuery,
+                        objectIds, linkIds, overlapCounts);
+}
+
+void PhysicsManager::querySphereOverlaps(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> centers,
+    Corrade::Containers::ArrayView<const float> radii,
+    std::size_t maxOverlapsPerQuery,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<int> linkIds,
+    Corrade::Containers::ArrayView<int> overlapCounts) {
+  ESP_CHECK(radii.size() == centers.size(),
+            "PhysicsManager::querySphereOverlaps(): expected"
+                << centers.size() << "radii but got" << radii.size());
+  for (const float radius : radii) {
+    ESP_CHECK(radius >= 0.0f,
+              "PhysicsManager::querySphereOverlaps(): expected non-negative "
+              "radii but got"
+                  << radius);
+  }
+  prepareOverlapOutputs("PhysicsManager::querySphereOverlaps():",
+                        centers.size(), maxOverlapsPerQuery, objectIds,
+                        linkIds, overlapCounts);
+  if (centers.isEmpty()) {
+    return;
+  }
+  queryOverlapsInternal(nullptr, centers, radii, maxOverlapsPerQuery,
+                        objectIds, linkIds, overlapCounts);
+}
+
 metadata::attributes::PhysicsManagerAttributes::ptr
 PhysicsManager::getInitializationAttributes() const {
   return metadata::attributes::PhysicsManagerAttributes::create(
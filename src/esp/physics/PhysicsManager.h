@@ -10,14 +10,21 @@
  * PhysicsManager::PhysicsSimulationLibrary
  */
 
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/Range.h>
+
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /* Bullet Physics Integration */
 
 #include "ArticulatedObject.h"
+#include "BatchedPhysicsBackend.h"
 #include "CollisionGroupHelper.h"
 #include "RigidObject.h"
 #include "RigidStage.h"
@@ -27,6 +34,7 @@
 #include "esp/assets/CollisionMeshData.h"
 #include "esp/assets/GenericSemanticMeshData.h"
 #include "esp/assets/MeshMetaData.h"
+#include "esp/core/Blob.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/metadata/URDFParser.h"
 #include "esp/physics/objectWrappers/ManagedArticulatedObject.h"
@@ -121,6 +129,77 @@ struct ContactPointData {
   ESP_SMART_POINTERS(ContactPointData)
 };
 
+/**
+ * @brief Kind of a @ref ContactEvent.
+ */
+enum class ContactEventType {
+  /** @brief The objects started touching during the step. */
+  Begin,
+  /** @brief The objects were touching throughout the step. */
+  Persist,
+  /** @brief The objects stopped touching during the step. */
+  End,
+};
+
+/**
+ * @brief A change of the contact state between two objects or links, see
+ * @ref PhysicsManager::subscribeContactEvents.
+ *
+ * The side with the lower object id, or link id for two links of the same
+ * articulated object, is always A.
+ */
+struct ContactEvent {
+  ContactEventType type = ContactEventType::Begin;
+  int objectIdA = ID_UNDEFINED;
+  int linkIndexA = -1;  // -1 if not a multibody link
+  int objectIdB = ID_UNDEFINED;
+  int linkIndexB = -1;
+  /** @brief Number of contact points, 0 for @ref ContactEventType::End. */
+  int numContactPoints = 0;
+
+  ESP_SMART_POINTERS(ContactEvent)
+};
+
+/**
+ * @brief Selects the contacts reported by the filtered
+ * @ref PhysicsManager::getContactPoints() overload.
+ *
+ * A contact is reported if it's between one of the @ref objectPairs and
+ * involves one of the @ref links. An empty list doesn't constrain the
+ * contacts, so a default-constructed filter reports everything.
+ */
+struct ContactPointFilter {
+  /**
+   * @brief Pairs of object ids to report contacts between, in either order.
+   *
+   * @ref ID_UNDEFINED on one side matches any object, so
+   * @cpp {objectId, ID_UNDEFINED} @ce reports all contacts of an object.
+   */
+  std::vector<std::pair<int, int>> objectPairs;
+
+  /**
+   * @brief Object id and link id pairs to report contacts of.
+   *
+   * Rigid objects, the stage and articulated object bases have a link id of
+   * -1.
+   */
+  std::vector<std::pair<int, int>> links;
+
+  /** @brief Whether to skip contacts between sleeping objects. */
+  bool activeOnly = false;
+
+  /**
+   * @brief Whether a contact between the given objects and links passes the
+   * filter.
+   */
+  bool matches(int objectIdA,
+               int linkIndexA,
+               int objectIdB,
+               int linkIndexB) const;
+
+  ESP_SMART_POINTERS(ContactPointFilter)
+};
+
 /**
  * @brief describes the type of a rigid constraint.
  */
@@ -319,6 +398,38 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
       scene::SceneNode* attachmentNode = nullptr,
       const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
 
+  /**
+   * @brief Instance and place a physics object from a @ref
+   * esp::metadata::attributes::SceneObjectInstanceAttributes file, using
+   * @p objAttributes made by @ref createObjectInstanceAttributes.
+   * @return the instanced object's ID, or @ref esp::ID_UNDEFINED if
+   * @p objAttributes is nullptr or instancing failed.
+   */
+  int addObjectInstance(
+      const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+          objInstAttributes,
+      const esp::metadata::attributes::ObjectAttributes::ptr& objAttributes,
+      bool defaultCOMCorrection = false,
+      DrawableGroup* drawables = nullptr,
+      scene::SceneNode* attachmentNode = nullptr,
+      const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
+
+  /**
+   * @brief Create the attributes an object instance is made from: a copy of
+   * the object attributes @p attributesHandle with the visibility, shader
+   * type, scale and mass of @p objInstAttributes applied.
+   *
+   * Only reads the attributes managers, so the instances of a scene can be
+   * prepared on several threads at once, as long as no attributes are
+   * registered or removed meanwhile.
+   * @return The attributes, or nullptr if @p attributesHandle is unknown.
+   */
+  esp::metadata::attributes::ObjectAttributes::ptr
+  createObjectInstanceAttributes(
+      const esp::metadata::attributes::SceneObjectInstanceAttributes::cptr&
+          objInstAttributes,
+      const std::string& attributesHandle) const;
+
   /** @brief Instance a physical object from an object properties template in
    * the @ref esp::metadata::managers::ObjectAttributesManager.  This method
    * will query for a drawable group from simulator.
@@ -382,6 +493,31 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
                             bool deleteObjectNode = true,
                             bool deleteVisualNode = true);
 
+  /**
+   * @brief Keep removed objects for reuse by later @ref addObject calls.
+   *
+   * With pooling enabled, an object removed with @ref removeObject is taken
+   * out of the simulation and hidden instead of destroyed, keeping its ID,
+   * scene nodes, collision shapes and drawables. The next time an object is
+   * added from an identical template with the same drawable group and light
+   * setup, the pooled object is put back with the state of a newly created
+   * one instead, which saves loading and building its resources again. Only
+   * objects created without an attachment node and removed together with
+   * their nodes are pooled. While a gfx replay recorder is active, objects
+   * are always destroyed, as it would keep recording pooled objects.
+   * Disabling pooling destroys the pooled objects.
+   */
+  void setObjectPoolingEnabled(bool enabled);
+
+  /** @brief Whether removed objects are kept for reuse */
+  bool getObjectPoolingEnabled() const { return objectPoolingEnabled_; }
+
+  /** @brief Number of removed objects kept for reuse */
+  int getNumPooledObjects() const;
+
+  /** @brief Destroy all objects kept for reuse, releasing their IDs */
+  void clearObjectPool();
+
   /** @brief Get the number of objects mapped in @ref
    * PhysicsManager::existingObjects_.
    *  @return The size of @ref PhysicsManager::existingObjects_.
@@ -401,6 +537,11 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return v;
   }
 
+  RigidObject& getRigidObject(int objectId) {
+    auto existObjIter = getRigidObjIteratorOrAssert(objectId);
+    return *existObjIter->second;
+  }
+
   //============= ArticulatedObject functions =============
 
   /**
@@ -428,6 +569,41 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
       DrawableGroup* drawables = nullptr,
       const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
 
+  /**
+   * @brief Instance and place an @ref ArticulatedObject from a @ref
+   * esp::metadata::attributes::SceneAOInstanceAttributes file, using
+   * @p artObjAttributes made by
+   * @ref createArticulatedObjectInstanceAttributes.
+   * @return The instanced @ref ArticulatedObject 's ID, or
+   * @ref esp::ID_UNDEFINED if @p artObjAttributes is nullptr or instancing
+   * failed.
+   */
+  int addArticulatedObjectInstance(
+      const std::shared_ptr<
+          const esp::metadata::attributes::SceneAOInstanceAttributes>&
+          aObjInstAttributes,
+      const esp::metadata::attributes::ArticulatedObjectAttributes::ptr&
+          artObjAttributes,
+      DrawableGroup* drawables = nullptr,
+      const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
+
+  /**
+   * @brief Create the attributes an articulated object instance is made from:
+   * a copy of the articulated object attributes @p attributesHandle with the
+   * shader type, scale, mass, base type, inertia source and link order of
+   * @p aObjInstAttributes applied.
+   *
+   * Only reads the attributes managers, so it can run on several threads at
+   * once like @ref createObjectInstanceAttributes.
+   * @return The attributes, or nullptr if @p attributesHandle is unknown.
+   */
+  esp::metadata::attributes::ArticulatedObjectAttributes::ptr
+  createArticulatedObjectInstanceAttributes(
+      const std::shared_ptr<
+          const esp::metadata::attributes::SceneAOInstanceAttributes>&
+          aObjInstAttributes,
+      const std::string& attributesHandle) const;
+
   /**
    * @brief Instance an @ref ArticulatedObject from an
    * @ref esp::metadata::attributes::ArticulatedObjectAttributes retrieved from the
@@ -570,6 +746,28 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual void updateNodes();
 
+  /**
+   * @brief Attach this world to a batched physics backend, or detach it if
+   * @p backend is null.
+   *
+   * Detaches the world from its previous backend first. While attached, the
+   * batched accessors of @ref getRigidObjectManager and
+   * @ref getArticulatedObjectManager go through the backend, see
+   * @ref BatchedPhysicsBackend. The world is detached on destruction.
+   */
+  void setBatchedBackend(std::shared_ptr<BatchedPhysicsBackend> backend);
+
+  /** @brief The batched physics backend of this world, if any */
+  BatchedPhysicsBackend* getBatchedBackend() const {
+    return batchedBackend_.get();
+  }
+
+  /**
+   * @brief ID of this world in @ref getBatchedBackend, or @ref ID_UNDEFINED
+   * if not attached
+   */
+  int getBatchedWorldId() const { return batchedWorldId_; }
+
   // =========== Global Setter functions ===========
 
   /** @brief Set the @ref fixedTimeStep_ of the physical world. See @ref
@@ -733,6 +931,13 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual std::string getStepCollisionSummary() { return "not implemented"; }
 
+  /**
+   * @brief Estimated host memory held by the physics world, in bytes.
+   *
+   * Not implemented for default PhysicsManager.
+   */
+  virtual std::size_t getMemoryUsage() const { return 0; }
+
   /**
    * @brief Query physics simulation implementation for contact point data from
    * the most recent collision detection cache.
@@ -742,6 +947,76 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual std::vector<ContactPointData> getContactPoints() const { return {}; }
 
+  /**
+   * @brief Query contact point data from the most recent collision detection
+   * cache, keeping only the contacts selected by @p filter.
+   *
+   * Overwrites the contents of @p contactPoints, so the same vector can be
+   * passed every step without reallocating. Manifolds rejected by the filter
+   * are skipped without looking at their contact points.
+   *
+   * Not implemented for default PhysicsManager implementation, which leaves
+   * @p contactPoints empty.
+   */
+  virtual void getContactPoints(
+      CORRADE_UNUSED const ContactPointFilter& filter,
+      std::vector<ContactPointData>& contactPoints) const {
+    contactPoints.clear();
+  }
+
+  /**
+   * @brief Signature of a callback receiving the contact events of a step.
+   */
+  typedef std::function<void(const std::vector<ContactEvent>&)>
+      ContactEventCallback;
+
+  /**
+   * @brief Report contact events of an object during @ref stepPhysics.
+   *
+   * Every physics substep, the contacts of subscribed objects are compared
+   * against the previous substep and contacts that appeared or disappeared
+   * are recorded as @ref ContactEventType::Begin and @ref ContactEventType::End
+   * events. Contacts that lasted through the whole step get a single
+   * @ref ContactEventType::Persist event at its end. Events of a step are
+   * available with @ref getContactEvents and passed to the callback set with
+   * @ref setContactEventCallback.
+   *
+   * Not implemented for default PhysicsManager implementation.
+   *
+   * @param objectId The id of a rigid object, an articulated object, whose
+   * link contacts are reported as well, or @ref RIGID_STAGE_ID.
+   */
+  virtual void subscribeContactEvents(CORRADE_UNUSED int objectId) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+  }
+
+  /**
+   * @brief Stop reporting contact events of an object.
+   *
+   * Contacts only kept track of for this object are dropped without an
+   * @ref ContactEventType::End event.
+   */
+  virtual void unsubscribeContactEvents(CORRADE_UNUSED int objectId) {}
+
+  /**
+   * @brief Contact events of subscribed objects during the most recent
+   * @ref stepPhysics call, in the order they happened.
+   */
+  const std::vector<ContactEvent>& getContactEvents() const {
+    return contactEvents_;
+  }
+
+  /**
+   * @brief Call @p callback at the end of each @ref stepPhysics call that
+   * produced contact events.
+   *
+   * Pass an empty function to remove the callback.
+   */
+  void setContactEventCallback(ContactEventCallback callback) {
+    contactEventCallback_ = std::move(callback);
+  }
+
   /**
    * @brief Set the stage to collidable or not.
    *
@@ -807,6 +1082,208 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return results;
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world and write the
+   * closest hit of each into preallocated buffers.
+   *
+   * Ray @p i starts at @p origins[i] and goes along @p directions[i]. The
+   * rays are cast in parallel on the threads configured with
+   * @ref metadata::attributes::PhysicsManagerAttributes::setNumThreads.
+   * Rays with a zero-length direction are reported as misses.
+   *
+   * Note: not implemented in the default PhysicsManager, which reports all
+   * rays as misses.
+   *
+   * @param origins Ray origins.
+   * @param directions Ray directions, expected to have the same size as
+   * @p origins. Need not be unit length, but distances will be in units of
+   * ray length.
+   * @param maxDistance The maximum distance along each ray to search. In units
+   * of ray length.
+   * @param[out] distances Distance of the closest hit, @p maxDistance for rays
+   * that hit nothing. Expected to have the same size as @p origins.
+   * @param[out] objectIds The id of the object hit, @ref ID_UNDEFINED for rays
+   * that hit nothing. Expected to have the same size as @p origins.
+   * @param[out] normals The collision object normal at the closest hit, zero
+   * for rays that hit nothing. Either the same size as @p origins or empty to
+   * skip.
+   */
+  void castRays(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      double maxDistance,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals = nullptr);
+
+  /**
+   * @brief Cast a batch of rays into the collision world and write all hits
+   * of each into preallocated buffers.
+   *
+   * Like @ref castRays(), but records up to @p maxHitsPerRay hits per ray,
+   * sorted by distance. Hits of ray @p i occupy the slots
+   * @cpp i*maxHitsPerRay @ce to @cpp i*maxHitsPerRay + hitCounts[i] @ce of
+   * the output buffers, the remaining slots of the ray are filled as misses.
+   * Hits beyond @p maxHitsPerRay are dropped.
+   *
+   * @param origins Ray origins.
+   * @param directions Ray directions, expected to have the same size as
+   * @p origins.
+   * @param maxDistance The maximum distance along each ray to search. In units
+   * of ray length.
+   * @param maxHitsPerRay Number of output slots per ray, expected to be
+   * positive.
+   * @param[out] distances Hit distances, expected to have
+   * @p maxHitsPerRay entries per ray.
+   * @param[out] objectIds Hit object ids, expected to have @p maxHitsPerRay
+   * entries per ray.
+   * @param[out] normals Hit normals, either @p maxHitsPerRay entries per ray
+   * or empty to skip.
+   * @param[out] hitCounts Number of hits recorded for each ray, expected to
+   * have the same size as @p origins.
+   */
+  void castRaysAllHits(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      double maxDistance,
+      std::size_t maxHitsPerRay,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+      Corrade::Containers::ArrayView<int> hitCounts);
+
+  /**
+   * @brief Sweep an upright capsule through the collision world and return a
+   * @ref RaycastResults with the first hit.
+   *
+   * The capsule is aligned with the Y axis and centered at the ray origin, so
+   * this is the swept-volume counterpart of @ref castRay for an agent body
+   * moving along the ray direction, e.g. a candidate velocity.
+   *
+   * Note: not implemented here in default PhysicsManager as there are no
+   * collision objects without a simulation implementation.
+   *
+   * @param ray The sweep to perform. Need not be unit length, but returned
+   * hit distances will be in units of ray length, i.e. the time of impact for
+   * a velocity.
+   * @param radius The capsule radius.
+   * @param height The distance between the centers of the capsule's
+   * hemispherical caps. A height of zero sweeps a sphere.
+   * @param maxDistance The maximum distance along the ray direction to
+   * sweep. In units of ray length.
+   * @return The raycast results, with at most the first hit.
+   */
+  virtual RaycastResults castCapsule(const esp::geo::Ray& ray,
+                                     CORRADE_UNUSED float radius,
+                                     CORRADE_UNUSED float height,
+                                     CORRADE_UNUSED double maxDistance = 100.0) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+    RaycastResults results;
+    results.ray = ray;
+    return results;
+  }
+
+  /**
+   * @brief Sweep an upright capsule along a batch of rays and write the
+   * first hit of each into preallocated buffers.
+   *
+   * The batched variant of @ref castCapsule(), with outputs as in
+   * @ref castRays(). Sweeps are run in parallel on the threads configured
+   * with @ref metadata::attributes::PhysicsManagerAttributes::setNumThreads
+   * and sweeps with a zero-length direction are reported as misses.
+   *
+   * @param origins Capsule center at the start of each sweep.
+   * @param directions Sweep directions, expected to have the same size as
+   * @p origins.
+   * @param radius The capsule radius.
+   * @param height The distance between the centers of the capsule's
+   * hemispherical caps.
+   * @param maxDistance The maximum distance along each direction to sweep. In
+   * units of direction length.
+   * @param[out] distances Distance of the first hit, @p maxDistance for
+   * sweeps that hit nothing. Expected to have the same size as @p origins.
+   * @param[out] objectIds The id of the object hit, @ref ID_UNDEFINED for
+   * sweeps that hit nothing. Expected to have the same size as @p origins.
+   * @param[out] normals The collision normal at the first hit, zero for
+   * sweeps that hit nothing. Either the same size as @p origins or empty to
+   * skip.
+   */
+  void castCapsules(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float radius,
+      float height,
+      double maxDistance,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals = nullptr);
+
+  /**
+   * @brief Find the objects overlapping a batch of axis-aligned boxes and
+   * write them into preallocated buffers.
+   *
+   * Each box is looked up in the broadphase of the collision world, so a
+   * query costs a tree traversal rather than a test against every object.
+   * Objects are tested with the bounding boxes the broadphase keeps for them,
+   * which enclose their collision shapes with a small margin, so an object
+   * close to a box may be reported without its shape actually reaching into
+   * it. The stage is never reported.
+   *
+   * Overlaps of box @p i are sorted by object and link id and occupy the
+   * slots @cpp i*maxOverlapsPerQuery @ce to
+   * @cpp i*maxOverlapsPerQuery + overlapCounts[i] @ce of the output buffers,
+   * the remaining slots of the box are filled with @ref ID_UNDEFINED.
+   * Overlaps beyond @p maxOverlapsPerQuery are dropped. The buffers can be
+   * reused between calls, e.g. every frame.
+   *
+   * Note: not implemented in the default PhysicsManager as there are no
+   * collision objects without a simulation implementation.
+   *
+   * @param boxes Query boxes.
+   * @param maxOverlapsPerQuery Number of output slots per box, expected to
+   * be positive.
+   * @param[out] objectIds Ids of the overlapping rigid or articulated
+   * objects, expected to have @p maxOverlapsPerQuery entries per box.
+   * @param[out] linkIds Overlapping link of an articulated object, -1 for
+   * rigid objects and articulated object bases. Expected to have
+   * @p maxOverlapsPerQuery entries per box.
+   * @param[out] overlapCounts Number of overlaps recorded for each box,
+   * expected to have the same size as @p boxes.
+   */
+  void queryBoxOverlaps(
+      Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+      std::size_t maxOverlapsPerQuery,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<int> linkIds,
+      Corrade::Containers::ArrayView<int> overlapCounts);
+
+  /**
+   * @brief Find the objects overlapping a batch of spheres and write them
+   * into preallocated buffers.
+   *
+   * The sphere variant of @ref queryBoxOverlaps(), e.g. for finding what is
+   * within a given distance of a point. An object is reported if its
+   * broadphase bounding box comes within the radius of the center.
+   *
+   * @param centers Sphere centers.
+   * @param radii Sphere radii, expected to have the same size as @p centers
+   * and to be non-negative.
+   * @param maxOverlapsPerQuery Number of output slots per sphere, expected to
+   * be positive.
+   * @param[out] objectIds See @ref queryBoxOverlaps().
+   * @param[out] linkIds See @ref queryBoxOverlaps().
+   * @param[out] overlapCounts Number of overlaps recorded for each sphere,
+   * expected to have the same size as @p centers.
+   */
+  void querySphereOverlaps(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> centers,
+      Corrade::Containers::ArrayView<const float> radii,
+      std::size_t maxOverlapsPerQuery,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<int> linkIds,
+      Corrade::Containers::ArrayView<int> overlapCounts);
+
   /**
    * @brief returns the wrapper manager for the currently created rigid
    * objects.
@@ -902,6 +1379,41 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
               "No RigidConstraint exists with constraintId =" << constraintId);
     return rigidCnstrntSettingsIter->second;
   }
+
+  /**
+   * @brief Update the pivots, frames and maximum impulses of many rigid
+   * constraints in one call.
+   *
+   * Constraint @p constraintIds[i] gets @p pivotsA[i], @p pivotsB[i] and so
+   * on. Each parameter view is either the same size as @p constraintIds or
+   * empty to leave that parameter of all the constraints unchanged. The same
+   * restrictions as with @ref updateRigidConstraint() apply.
+   *
+   * Note: requires a simulation implementation, not available in the base
+   * PhysicsManager.
+   */
+  void updateRigidConstraints(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+      Corrade::Containers::ArrayView<const float> maxImpulses);
+
+  /**
+   * @brief Get the magnitude of the linear force each of the rigid
+   * constraints applied during the last simulation substep.
+   *
+   * @param constraintIds The ids of the constraints.
+   * @param[out] forces The force magnitudes, expected to have the same size
+   * as @p constraintIds.
+   *
+   * Note: requires a simulation implementation, not available in the base
+   * PhysicsManager.
+   */
+  void getRigidConstraintForces(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<float> forces);
   /**
    * @brief This will populate the passed @p sceneInstanceAttrs with the current
    * stage, object and articulated object instances reflecting the current
@@ -914,6 +1426,26 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
       const metadata::attributes::SceneInstanceAttributes::ptr&
           sceneInstanceAttrs) const;
 
+  /**
+   * @brief Append a compact binary snapshot of the dynamic state of the
+   * physical world to @p writer : world time, the rigid state, velocities,
+   * motion type and activation of every rigid and articulated object, joint
+   * positions and velocities of articulated objects, and all rigid constraint
+   * settings. Static stage geometry is not included.
+   */
+  void captureState(core::BlobWriter& writer);
+
+  /**
+   * @brief Restore a snapshot written by @ref captureState, reusing the
+   * existing object instances instead of rebuilding them.
+   *
+   * Objects and constraints created after the snapshot was taken are removed.
+   * Every object in the snapshot must still exist; snapshots cannot bring back
+   * removed objects, which requires a scene rebuild. Constraints removed since
+   * the snapshot are re-created, possibly under new ids.
+   */
+  void restoreState(core::BlobReader& reader);
+
   /**
    * @brief Compute a trajectory visualization for the passed points.
    * @param trajVisName The name to use for the trajectory visualization
@@ -971,6 +1503,114 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
   }
 
  protected:
+  /**
+   * @brief All existing rigid objects, see @ref velocityControlTargets_.
+   */
+  const std::vector<RigidObject*>& velocityControlTargets();
+
+  /**
+   * @brief Update the constraints of @ref updateRigidConstraints().
+   *
+   * Sizes are already checked. The default goes through
+   * @ref updateRigidConstraint() for each constraint.
+   */
+  virtual void updateRigidConstraintsInternal(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+      Corrade::Containers::ArrayView<const float> maxImpulses);
+
+  /**
+   * @brief Read back the forces of @ref getRigidConstraintForces().
+   *
+   * Sizes are already checked and @p forces zero-filled.
+   *
+   * Note: not implemented in the default PhysicsManager as there are no
+   * constraints without a simulation implementation.
+   */
+  virtual void getRigidConstraintForcesInternal(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const int> constraintIds,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> forces) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+  }
+
+  /**
+   * @brief Cast the rays of @ref castRays() or @ref castRaysAllHits().
+   *
+   * Buffer sizes are already checked and all outputs filled as misses, so
+   * implementations only need to write the hits. @p hitCounts is empty for
+   * a closest-hit query, in which case @p maxHitsPerRay is 1.
+   *
+   * Note: not implemented in the default PhysicsManager as there are no
+   * collision objects without a simulation implementation.
+   */
+  virtual void castRaysInternal(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Vector3>
+          origins,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Vector3>
+          directions,
+      CORRADE_UNUSED double maxDistance,
+      CORRADE_UNUSED std::size_t maxHitsPerRay,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> distances,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> objectIds,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> hitCounts) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+  }
+
+  /**
+   * @brief Sweep the capsules of @ref castCapsules().
+   *
+   * Buffer sizes are already checked and all outputs filled as misses, so
+   * implementations only need to write the hits.
+   *
+   * Note: not implemented in the default PhysicsManager as there are no
+   * collision objects without a simulation implementation.
+   */
+  virtual void castCapsulesInternal(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Vector3>
+          origins,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Vector3>
+          directions,
+      CORRADE_UNUSED float radius,
+      CORRADE_UNUSED float height,
+      CORRADE_UNUSED double maxDistance,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> distances,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> objectIds,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<Magnum::Vector3> normals) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+  }
+
+  /**
+   * @brief Run the queries of @ref queryBoxOverlaps() or
+   * @ref querySphereOverlaps().
+   *
+   * Either @p boxes or @p centers and @p radii are non-empty. Buffer sizes
+   * are already checked and all outputs filled as empty, so implementations
+   * only need to write the overlaps.
+   *
+   * Note: not implemented in the default PhysicsManager as there are no
+   * collision objects without a simulation implementation.
+   */
+  virtual void queryOverlapsInternal(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Range3D>
+          boxes,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Vector3>
+          centers,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> radii,
+      CORRADE_UNUSED std::size_t maxOverlapsPerQuery,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> objectIds,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> linkIds,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<int> overlapCounts) {
+    ESP_ERROR() << "Not implemented in base PhysicsManager. Install with "
+                   "--bullet to use this feature.";
+  }
+
   /**
    * @brief This method will create a physical object using the passed values by
    * calling addObjectInternal, will initialize its state and save
@@ -1164,6 +1804,39 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   int deallocateObjectID(int physObjectID);
 
+  /**
+   * @brief Key under which objects are pooled, see
+   * @ref setObjectPoolingEnabled.
+   */
+  static std::string getObjectPoolKey(
+      const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes,
+      const DrawableGroup* drawables,
+      const std::string& lightSetup);
+
+  /**
+   * @brief Put a pooled object stored under @p poolKey back into the world.
+   * @return The ID of the reused object or @ref esp::ID_UNDEFINED if there is
+   * no such object.
+   */
+  int reusePooledObject(const std::string& poolKey);
+
+  /**
+   * @brief Take an object being removed out of the simulation and keep it in
+   * the pool if it qualifies for pooling.
+   * @return Whether the object was pooled, in which case its ID and nodes
+   * must not be released.
+   */
+  bool poolObject(const RigidObject::ptr& object);
+
+  /**
+   * @brief Give a new or reused object a unique name and register a wrapper
+   * for it with @ref rigidObjectManager_.
+   */
+  void registerRigidObjectWrapper(
+      int objectID,
+      const esp::metadata::attributes::ObjectAttributes::ptr&
+          objectAttributes);
+
   /**
    * @brief Finalize physics initialization. Setup staticStageObject_ and
    * initialize any other physics-related values for physics-based scenes.
@@ -1255,11 +1928,38 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   std::map<int, RigidObject::ptr> existingObjects_;
 
+  /**
+   * @brief The objects of @ref existingObjects_ in a contiguous array, so the
+   * per-step check for velocity control doesn't chase map nodes or copy
+   * shared pointers. Rebuilt by @ref velocityControlTargets after
+   * @ref velocityControlTargetsDirty_ is set by adding or removing objects.
+   */
+  std::vector<RigidObject*> velocityControlTargets_;
+
+  //! Set whenever @ref existingObjects_ changes.
+  bool velocityControlTargetsDirty_ = true;
+
+  //! States of velocity-controlled objects, reused by @ref stepPhysics.
+  VelocityControlBatch velocityControlBatch_;
+
+  //! Objects whose states are in @ref velocityControlBatch_, in order.
+  std::vector<RigidObject*> velocityControlBatchObjects_;
+
   /** @brief Maps articulated object IDs to all existing physical object
    * instances in the world.
    */
   std::map<int, ArticulatedObject::ptr> existingArticulatedObjects_;
 
+  //! See @ref setBatchedBackend.
+  std::shared_ptr<BatchedPhysicsBackend> batchedBackend_;
+  int batchedWorldId_ = ID_UNDEFINED;
+
+  //! Contact events of the most recent step, see @ref getContactEvents.
+  std::vector<ContactEvent> contactEvents_;
+
+  //! See @ref setContactEventCallback.
+  ContactEventCallback contactEventCallback_;
+
   /** @brief A counter of unique object ID's allocated thus far. Used to
    * allocate new IDs when  @ref recycledObjectIDs_ is empty without needing
    * to check @ref existingObjects_ explicitly.*/
@@ -1273,6 +1973,22 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   std::vector<int> recycledObjectIDs_;
 
+  //! A removed object kept for reuse, see @ref setObjectPoolingEnabled.
+  struct PooledObject {
+    RigidObject::ptr object;
+    //! Drawables taken out of their groups while the object is pooled.
+    std::vector<std::pair<gfx::Drawable*, gfx::DrawableGroup*>> drawables;
+  };
+
+  //! See @ref setObjectPoolingEnabled.
+  bool objectPoolingEnabled_ = false;
+
+  //! Pooled objects by @ref getObjectPoolKey.
+  std::unordered_map<std::string, std::vector<PooledObject>> objectPool_;
+
+  //! Pool keys of existing objects that can be pooled when removed.
+  std::unordered_map<int, std::string> objectPoolKeys_;
+
   /** @brief Tmaps constraint ids to their settings */
   std::unordered_map<int, RigidConstraintSettings> rigidConstraintSettings_;
 
@@ -4,6 +4,8 @@
 
 #include "RigidObject.h"
 
+#include <typeinfo>
+
 namespace esp {
 namespace physics {
 
@@ -94,6 +96,16 @@ void RigidObject::resetStateFromSceneInstanceAttr() {
   }
 }  // RigidObject::resetStateFromSceneInstanceAttr
 
+void RigidObject::resetForPoolReuse() {
+  velControl_ = VelocityControl::create();
+  setUserAttributes(initializationAttributes_->getUserConfiguration());
+  setSemanticId(
+      std::static_pointer_cast<const metadata::attributes::ObjectAttributes>(
+          initializationAttributes_)
+          ->getSemanticId());
+  initialization_LibSpecific();
+}  // RigidObject::resetForPoolReuse
+
 //////////////////
 // VelocityControl
 
@@ -125,5 +137,66 @@ core::RigidState VelocityControl::integrateTransform(
   return newRigidState;
 }
 
+///////////////////////
+// VelocityControlBatch
+
+bool VelocityControlBatch::isBatchable(const VelocityControl& control) {
+  return typeid(control) == typeid(VelocityControl);
+}
+
+void VelocityControlBatch::clear() {
+  translations_.clear();
+  rotations_.clear();
+  linVels_.clear();
+  angVels_.clear();
+  flags_.clear();
+}
+
+void VelocityControlBatch::add(const VelocityControl& control,
+                               const core::RigidState& state) {
+  std::uint8_t flags = 0;
+  if (control.linVelIsLocal) {
+    flags |= LinearIsLocal;
+  }
+  // same condition as in VelocityControl::integrateTransform()
+  if (control.controllingAngVel && control.angVel != Magnum::Vector3{0.0}) {
+    flags |= Rotating;
+  }
+  if (control.angVelIsLocal) {
+    flags |= AngularIsLocal;
+  }
+  translations_.push_back(state.translation);
+  rotations_.push_back(state.rotation);
+  linVels_.push_back(control.controllingLinVel ? control.linVel
+                                               : Magnum::Vector3{});
+  angVels_.push_back(control.angVel);
+  flags_.push_back(flags);
+}
+
+void VelocityControlBatch::integrate(const float dt) {
+  const std::size_t count = size();
+  // linear first, with the rotations from before this step
+  for (std::size_t i = 0; i != count; ++i) {
+    const Magnum::Vector3 step = linVels_[i] * dt;
+    translations_[i] += (flags_[i] & LinearIsLocal)
+                            ? rotations_[i].transformVector(step)
+                            : step;
+  }
+
+  // then angular
+  for (std::size_t i = 0; i != count; ++i) {
+    if (!(flags_[i] & Rotating)) {
+      continue;
+    }
+    const Magnum::Vector3 globalAngVel =
+        (flags_[i] & AngularIsLocal)
+            ? rotations_[i].transformVector(angVels_[i])
+            : angVels_[i];
+    const Magnum::Quaternion q = Magnum::Quaternion::rotation(
+        Magnum::Rad{(globalAngVel * dt).length()}, globalAngVel.normalized());
+    rotations_[i] = (q * rotations_[i]).normalized();
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
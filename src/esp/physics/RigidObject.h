@@ -7,11 +7,14 @@
 
 /** @file
  * @brief Class @ref esp::physics::RigidObject, enum @ref
- * esp::physics::MotionType, struct @ref esp::physics::VelocityControl
+ * esp::physics::MotionType, struct @ref esp::physics::VelocityControl, class
+ * @ref esp::physics::VelocityControlBatch
  */
 
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Reference.h>
+#include <cstdint>
+#include <vector>
 #include "esp/assets/Asset.h"
 #include "esp/assets/BaseMesh.h"
 #include "esp/assets/GenericSemanticMeshData.h"
@@ -77,6 +80,63 @@ struct VelocityControl {
   ESP_SMART_POINTERS(VelocityControl)
 };
 
+/**
+ * @brief Batch of object states integrated with constant control velocities.
+ *
+ * The batched equivalent of @ref VelocityControl::integrateTransform, with
+ * the states and controls of all objects stored as structure of arrays so
+ * integrating them is a tight loop instead of a virtual call and a
+ * @ref core::RigidState copy per object. Only for controls of the
+ * @ref VelocityControl type itself, which @ref isBatchable checks, as derived
+ * controls may override the integration.
+ */
+class VelocityControlBatch {
+ public:
+  /** @brief Whether @p control can be integrated by this batch */
+  static bool isBatchable(const VelocityControl& control);
+
+  /** @brief Remove all states, keeping the allocated memory */
+  void clear();
+
+  /**
+   * @brief Add a state to integrate
+   *
+   * Copies the control velocities, later changes to @p control don't affect
+   * the batch.
+   */
+  void add(const VelocityControl& control, const core::RigidState& state);
+
+  /** @brief Number of states in the batch */
+  std::size_t size() const { return translations_.size(); }
+
+  /**
+   * @brief Integrate all states over @p dt
+   *
+   * Gives the same result as calling @ref VelocityControl::integrateTransform
+   * on each state, and can be called repeatedly to integrate several steps.
+   */
+  void integrate(float dt);
+
+  /** @brief Current state at index @p i in order of @ref add calls */
+  core::RigidState state(std::size_t i) const {
+    return core::RigidState{rotations_[i], translations_[i]};
+  }
+
+ private:
+  enum : std::uint8_t {
+    LinearIsLocal = 1 << 0,
+    Rotating = 1 << 1,
+    AngularIsLocal = 1 << 2,
+  };
+
+  std::vector<Magnum::Vector3> translations_;
+  std::vector<Magnum::Quaternion> rotations_;
+  // zero if the linear velocity isn't controlled
+  std::vector<Magnum::Vector3> linVels_;
+  std::vector<Magnum::Vector3> angVels_;
+  std::vector<std::uint8_t> flags_;
+};
+
 /**
  * @brief A @ref RigidBase representing an individual rigid object instance
  * attached to a SceneNode, updating its state through simulation. This may be a
@@ -198,7 +258,7 @@ class RigidObject : public RigidBase {
   /**
    * @brief Retrieves a reference to the VelocityControl struct for this object.
    */
-  VelocityControl::ptr getVelocityControl() { return velControl_; };
+  const VelocityControl::ptr& getVelocityControl() { return velControl_; };
 
   /**
    * @brief Set the object's state from a @ref
@@ -206,6 +266,18 @@ class RigidObject : public RigidBase {
    */
   void resetStateFromSceneInstanceAttr() override;
 
+  /**
+   * @brief Take the object out of the simulation while it is kept in the
+   * object pool of its @ref PhysicsManager.
+   */
+  virtual void deactivateForPool() {}
+
+  /**
+   * @brief Give an object taken out of the object pool the state of an object
+   * newly created from its initialization attributes.
+   */
+  virtual void resetForPoolReuse();
+
  protected:
   /**
    * @brief Whether or not this object's placement should be COM corrected.
@@ -6,10 +6,19 @@
 
 #include "URDFImporter.h"
 
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Path.h>
+#include "URDFModelBundle.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
 
@@ -18,10 +27,131 @@ namespace Mn = Magnum;
 namespace esp {
 namespace physics {
 
+namespace {
+
+//! Modification time in nanoseconds and size of @p filename
+std::pair<std::uint64_t, std::uint64_t> getFileStamp(
+    const std::string& filename) {
+  struct stat st {};
+  if (::stat(filename.c_str(), &st) != 0) {
+    return {};
+  }
+#ifdef __APPLE__
+  const struct timespec& mtime = st.st_mtimespec;
+#else
+  const struct timespec& mtime = st.st_mtim;
+#endif
+  return {std::uint64_t(mtime.tv_sec) * 1000000000ull +
+              std::uint64_t(mtime.tv_nsec),
+          std::uint64_t(st.st_size)};
+}
+
+/**
+ * @brief URDF models parsed by any importer in this process, unscaled, along
+ * with the stamp of their file when parsed. Importers only get clones, as they
+ * rescale their models and register assets for them.
+ */
+struct ParsedModelCache {
+  struct Entry {
+    std::pair<std::uint64_t, std::uint64_t> stamp;
+    std::shared_ptr<const metadata::URDF::Model> model;
+  };
+
+  static ParsedModelCache& instance() {
+    static ParsedModelCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<metadata::URDF::Model> find(
+      const std::string& filename,
+      const std::pair<std::uint64_t, std::uint64_t>& stamp) {
+    std::shared_ptr<const metadata::URDF::Model> model;
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      auto entryIter = entries.find(filename);
+      if (entryIter == entries.end() || entryIter->second.stamp != stamp) {
+        return nullptr;
+      }
+      model = entryIter->second.model;
+    }
+    return model->clone();
+  }
+
+  void publish(const std::string& filename,
+               const std::pair<std::uint64_t, std::uint64_t>& stamp,
+               std::shared_ptr<const metadata::URDF::Model> model) {
+    std::lock_guard<std::mutex> lock{mutex};
+    entries[filename] = Entry{stamp, std::move(model)};
+  }
+
+  std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+};
+
+/**
+ * @brief Read all mesh files referenced by the links of @p model, spread over
+ * all hardware threads. Collision meshes with precomputed hulls aren't needed.
+ */
+std::unordered_map<std::string, Corrade::Containers::Array<char>>
+readLinkMeshFiles(const metadata::URDF::Model& model) {
+  std::vector<std::string> filenames;
+  const auto addFilename = [&](const metadata::URDF::Shape& shape) {
+    if (shape.m_geometry.m_type == metadata::URDF::GEOM_MESH &&
+        std::find(filenames.begin(), filenames.end(),
+                  shape.m_geometry.m_meshFileName) == filenames.end()) {
+      filenames.push_back(shape.m_geometry.m_meshFileName);
+    }
+  };
+  for (const auto& link : model.m_links) {
+    for (const auto& visual : link.second->m_visualArray) {
+      addFilename(visual);
+    }
+    for (const auto& collision : link.second->m_collisionArray) {
+      if (collision.m_convexHulls.empty()) {
+        addFilename(collision);
+      }
+    }
+  }
+
+  std::vector<Corrade::Containers::Optional<Corrade::Containers::Array<char>>>
+      contents(filenames.size());
+  std::atomic<std::size_t> nextFile{0};
+  const auto readFiles = [&]() {
+    for (std::size_t i; (i = nextFile++) < filenames.size();) {
+      contents[i] = Corrade::Utility::Path::read(filenames[i]);
+    }
+  };
+  const std::size_t numThreads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), filenames.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back(readFiles);
+  }
+  readFiles();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  // files that can't be read are left for the importer to report
+  std::unordered_map<std::string, Corrade::Containers::Array<char>> files;
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (contents[i]) {
+      files.emplace(filenames[i], *std::move(contents[i]));
+    }
+  }
+  return files;
+}  // readLinkMeshFiles
+
+}  // namespace
+
 bool URDFImporter::loadURDF(const std::string& urdfFilepath, bool forceReload) {
+  const std::pair<std::uint64_t, std::uint64_t> stamp =
+      getFileStamp(urdfFilepath);
   auto modelCacheIter = modelCache_.find(urdfFilepath);
-  // if map not found or forcing reload
-  if ((modelCacheIter == modelCache_.end()) || forceReload) {
+  // if map not found, file changed since parsing or forcing reload. A cached
+  // model of a file that's gone is still used.
+  if ((modelCacheIter == modelCache_.end()) || forceReload ||
+      (stamp.first != 0 && modelCacheStamps_[urdfFilepath] != stamp)) {
     if (!Corrade::Utility::Path::exists(urdfFilepath) ||
         Corrade::Utility::Path::isDirectory(urdfFilepath)) {
       ESP_DEBUG() << "URDF File does not exist:" << urdfFilepath
@@ -29,12 +159,24 @@ bool URDFImporter::loadURDF(const std::string& urdfFilepath, bool forceReload) {
       return false;
     }
 
-    // parse the URDF from file
-    std::shared_ptr<metadata::URDF::Model> urdfModel;
-    bool success = urdfParser_.parseURDF(urdfFilepath, urdfModel);
-    if (!success) {
-      ESP_DEBUG() << "Failed to parse URDF:" << urdfFilepath << ", aborting.";
-      return false;
+    // reuse the model another importer parsed from the same file
+    std::shared_ptr<metadata::URDF::Model> urdfModel =
+        forceReload ? nullptr
+                    : ParsedModelCache::instance().find(urdfFilepath, stamp);
+    if (!urdfModel) {
+      // use the compiled model if there's an up-to-date one, otherwise parse
+      // the URDF from file
+      urdfModel = loadURDFModelBundle(getURDFModelBundleFilename(urdfFilepath),
+                                      urdfFilepath);
+      if (!urdfModel && !urdfParser_.parseURDF(urdfFilepath, urdfModel)) {
+        ESP_DEBUG() << "Failed to parse URDF:" << urdfFilepath << ", aborting.";
+        return false;
+      }
+      ParsedModelCache::instance().publish(urdfFilepath, stamp,
+                                           urdfModel->clone());
+      // the meshes were most likely never loaded either, so read them all at
+      // once instead of one by one during import
+      resourceManager_.addPrefetchedFiles(readLinkMeshFiles(*urdfModel));
     }
 
     if (ESP_LOG_LEVEL_ENABLED(logging::LoggingLevel::VeryVerbose)) {
@@ -49,6 +191,7 @@ bool URDFImporter::loadURDF(const std::string& urdfFilepath, bool forceReload) {
 
     // register the new model and set to iterator
     modelCacheIter = modelCache_.emplace(urdfFilepath, urdfModel).first;
+    modelCacheStamps_[urdfFilepath] = stamp;
   }
 
   activeModel_ = modelCacheIter->second;
@@ -255,7 +398,9 @@ void URDFImporter::importURDFAssets(
     auto link = activeModel_->getLink(linkIx);
     // load collision shapes
     for (auto& collision : link->m_collisionArray) {
-      if (collision.m_geometry.m_type == metadata::URDF::GEOM_MESH) {
+      // precomputed hulls replace the collision mesh
+      if (collision.m_geometry.m_type == metadata::URDF::GEOM_MESH &&
+          collision.m_convexHulls.empty()) {
         // pre-load the mesh asset for its collision shape
         assets::AssetInfo meshAsset{assets::AssetType::UNKNOWN,
                                     collision.m_geometry.m_meshFileName};
@@ -7,6 +7,9 @@
 #ifndef ESP_PHYSICS_URDFIMPORTER_H_
 #define ESP_PHYSICS_URDFIMPORTER_H_
 
+#include <cstdint>
+#include <utility>
+
 #include "esp/metadata/URDFParser.h"
 #include "esp/metadata/attributes/ArticulatedObjectAttributes.h"
 
@@ -51,10 +54,15 @@ class URDFImporter {
 
   virtual ~URDFImporter() = default;
   /**
-   * @brief Sets the activeModel_ for the importer. If new or forceReload, parse
-   * a URDF file and cache the resulting model. Note: when applying uniform
-   * scaling to a 3D model consider scale^3 mass scaling to approximate uniform
-   * density.
+   * @brief Sets the activeModel_ for the importer. If new, changed on disk
+   * since it was cached or forceReload, parse a URDF file and cache the
+   * resulting model. Models parsed by any importer in the process are shared
+   * as long as the file doesn't change, so only the first importer loading a
+   * URDF parses it. That one also reads all link meshes of the model in
+   * parallel and passes them to @ref
+   * esp::assets::ResourceManager::addPrefetchedFiles. Note: when applying
+   * uniform scaling to a 3D model consider scale^3 mass scaling to approximate
+   * uniform density.
    * @param urdfFilepath The filepath for the URDF and key for the cached model.
    * @param forceReload If true, reload the URDF from file, replacing the cached
    * model.
@@ -152,6 +160,10 @@ class URDFImporter {
   //! cache parsed URDF models by filename
   std::map<std::string, std::shared_ptr<metadata::URDF::Model>> modelCache_;
 
+  //! modification time and size of the files of @ref modelCache_ when parsed
+  std::map<std::string, std::pair<std::uint64_t, std::uint64_t>>
+      modelCacheStamps_;
+
   //! which model is being actively manipulated. Changed by calling
   //! loadURDF(filename).
   std::shared_ptr<metadata::URDF::Model> activeModel_ = nullptr;
@@ -0,0 +1,419 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "URDFModelBundle.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+using metadata::URDF::CollisionShape;
+using metadata::URDF::Joint;
+using metadata::URDF::Link;
+using metadata::URDF::Material;
+using metadata::URDF::Model;
+using metadata::URDF::Shape;
+using metadata::URDF::VisualShape;
+
+namespace {
+
+/* Bump whenever the bundle layout or the URDF data structures change, so
+   stale bundles aren't used */
+constexpr Mn::UnsignedInt urdfBundleVersion = 1;
+constexpr char urdfBundleMagic[4]{'H', 'S', 'U', 'B'};
+
+struct URDFBundleHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedLong urdfSize;
+  Mn::UnsignedLong urdfHash;
+  Mn::UnsignedInt linkCount;
+  Mn::UnsignedInt jointCount;
+  Mn::UnsignedInt materialCount;
+};
+
+// FNV-1a, only used to detect changed URDF files, not for security
+Mn::UnsignedLong hashBytes(Cr::Containers::ArrayView<const char> data) {
+  Mn::UnsignedLong hash = 14695981039346656037ull;
+  for (const char byte : data) {
+    hash = (hash ^ static_cast<unsigned char>(byte)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+class BundleWriter {
+ public:
+  template <class T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be written directly");
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void writeString(const std::string& value) {
+    write(Mn::UnsignedInt(value.size()));
+    data += value;
+  }
+
+  void writeMaterial(const Material& material) {
+    writeString(material.m_name);
+    writeString(material.m_textureFilename);
+    write(material.m_matColor.m_rgbaColor);
+    write(material.m_matColor.m_specularColor);
+  }
+
+  std::string data;
+};
+
+class BundleReader {
+ public:
+  explicit BundleReader(Cr::Containers::ArrayView<const char> data)
+      : data_{data} {}
+
+  template <class T>
+  bool read(T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be read directly");
+    if (data_.size() - offset_ < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string& value) {
+    Mn::UnsignedInt size;
+    if (!read(size) || data_.size() - offset_ < size) {
+      return false;
+    }
+    value.assign(data_.data() + offset_, size);
+    offset_ += size;
+    return true;
+  }
+
+  bool readMaterial(Material& material) {
+    return readString(material.m_name) &&
+           readString(material.m_textureFilename) &&
+           read(material.m_matColor.m_rgbaColor) &&
+           read(material.m_matColor.m_specularColor);
+  }
+
+  bool atEnd() const { return offset_ == data_.size(); }
+
+ private:
+  Cr::Containers::ArrayView<const char> data_;
+  std::size_t offset_ = 0;
+};
+
+// mesh references are stored relative to the URDF, so bundles can be moved
+// along with it
+std::string relativeToDirectory(const std::string& filename,
+                                const std::string& directory) {
+  const std::string prefix = directory + "/";
+  return !directory.empty() &&
+                 Cr::Utility::String::beginsWith(filename, prefix)
+             ? filename.substr(prefix.size())
+             : filename;
+}
+
+void writeShape(BundleWriter& writer,
+                const Shape& shape,
+                const std::string& urdfDirectory) {
+  writer.writeString(shape.m_sourceFileLocation);
+  writer.write(shape.m_linkLocalFrame);
+  writer.writeString(shape.m_name);
+  const metadata::URDF::Geometry& geometry = shape.m_geometry;
+  writer.write(Mn::Int(geometry.m_type));
+  writer.write(geometry.m_sphereRadius);
+  writer.write(geometry.m_boxSize);
+  writer.write(geometry.m_capsuleRadius);
+  writer.write(geometry.m_capsuleHeight);
+  writer.write(geometry.m_planeNormal);
+  writer.writeString(
+      relativeToDirectory(geometry.m_meshFileName, urdfDirectory));
+  writer.write(geometry.m_meshScale);
+  writer.write(geometry.m_hasLocalMaterial);
+  writer.write(bool(geometry.m_localMaterial));
+  if (geometry.m_localMaterial) {
+    writer.writeMaterial(*geometry.m_localMaterial);
+  }
+}
+
+bool readShape(BundleReader& reader,
+               Shape& shape,
+               const std::string& urdfDirectory) {
+  metadata::URDF::Geometry& geometry = shape.m_geometry;
+  Mn::Int type;
+  bool hasMaterial;
+  if (!reader.readString(shape.m_sourceFileLocation) ||
+      !reader.read(shape.m_linkLocalFrame) ||
+      !reader.readString(shape.m_name) ||
+      !reader.read(type) || !reader.read(geometry.m_sphereRadius) ||
+      !reader.read(geometry.m_boxSize) ||
+      !reader.read(geometry.m_capsuleRadius) ||
+      !reader.read(geometry.m_capsuleHeight) ||
+      !reader.read(geometry.m_planeNormal) ||
+      !reader.readString(geometry.m_meshFileName) ||
+      !reader.read(geometry.m_meshScale) ||
+      !reader.read(geometry.m_hasLocalMaterial) || !reader.read(hasMaterial)) {
+    return false;
+  }
+  geometry.m_type = metadata::URDF::GeomTypes(type);
+  if (!geometry.m_meshFileName.empty()) {
+    geometry.m_meshFileName =
+        Cr::Utility::Path::join(urdfDirectory, geometry.m_meshFileName);
+  }
+  if (hasMaterial) {
+    geometry.m_localMaterial = std::make_shared<Material>();
+    if (!reader.readMaterial(*geometry.m_localMaterial)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string getURDFModelBundleFilename(const std::string& urdfFilename) {
+  return Cr::Utility::formatString("{}.bundle", urdfFilename);
+}
+
+std::shared_ptr<Model> loadURDFModelBundle(const std::string& filename,
+                                           const std::string& urdfFilename) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return nullptr;
+  }
+  // the URDF is only hashed, which is much cheaper than parsing it
+  Cr::Containers::Optional<Cr::Containers::Array<char>> urdfData =
+      Cr::Utility::Path::read(urdfFilename);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  if (!urdfData || !data) {
+    return nullptr;
+  }
+
+  BundleReader reader{*data};
+  URDFBundleHeader header;
+  if (!reader.read(header) ||
+      std::memcmp(header.magic, urdfBundleMagic, sizeof(urdfBundleMagic)) ||
+      header.version != urdfBundleVersion ||
+      header.urdfSize != urdfData->size() ||
+      header.urdfHash != hashBytes(*urdfData)) {
+    return nullptr;
+  }
+  const std::string urdfDirectory =
+      Cr::Utility::Path::split(urdfFilename).first();
+
+  auto model = std::make_shared<Model>();
+  model->m_sourceFile = urdfFilename;
+  if (!reader.readString(model->m_name) ||
+      !reader.read(model->m_rootTransformInWorld) ||
+      !reader.read(model->m_overrideFixedBase)) {
+    return nullptr;
+  }
+
+  for (Mn::UnsignedInt i = 0; i != header.materialCount; ++i) {
+    auto material = std::make_shared<Material>();
+    if (!reader.readMaterial(*material)) {
+      return nullptr;
+    }
+    model->m_materials[material->m_name] = std::move(material);
+  }
+
+  for (Mn::UnsignedInt i = 0; i != header.linkCount; ++i) {
+    auto link = std::make_shared<Link>();
+    Mn::UnsignedInt visualCount;
+    Mn::UnsignedInt collisionCount;
+    if (!reader.readString(link->m_name) || !reader.read(link->m_linkIndex) ||
+        !reader.read(link->m_inertia) || !reader.read(link->m_contactInfo) ||
+        !reader.read(visualCount) || !reader.read(collisionCount)) {
+      return nullptr;
+    }
+    link->m_visualArray.resize(visualCount);
+    for (VisualShape& visual : link->m_visualArray) {
+      if (!readShape(reader, visual, urdfDirectory) ||
+          !reader.readString(visual.m_materialName)) {
+        return nullptr;
+      }
+    }
+    link->m_collisionArray.resize(collisionCount);
+    for (CollisionShape& collision : link->m_collisionArray) {
+      Mn::UnsignedInt hullCount;
+      if (!readShape(reader, collision, urdfDirectory) ||
+          !reader.read(collision.m_flags) ||
+          !reader.read(collision.m_collisionGroup) ||
+          !reader.read(collision.m_collisionMask) || !reader.read(hullCount)) {
+        return nullptr;
+      }
+      if (hullCount == 0) {
+        continue;
+      }
+      // hulls are only valid for the mesh they were computed from
+      Mn::UnsignedLong meshSize;
+      const Cr::Containers::Optional<std::size_t> currentMeshSize =
+          Cr::Utility::Path::size(collision.m_geometry.m_meshFileName);
+      if (!reader.read(meshSize) || !currentMeshSize ||
+          *currentMeshSize != meshSize) {
+        return nullptr;
+      }
+      collision.m_convexHulls.resize(hullCount);
+      for (std::vector<Mn::Vector3>& hull : collision.m_convexHulls) {
+        Mn::UnsignedInt pointCount;
+        if (!reader.read(pointCount)) {
+          return nullptr;
+        }
+        hull.resize(pointCount);
+        for (Mn::Vector3& point : hull) {
+          if (!reader.read(point)) {
+            return nullptr;
+          }
+        }
+      }
+    }
+    model->m_linkIndicesToNames[link->m_linkIndex] = link->m_name;
+    model->m_links[link->m_name] = std::move(link);
+  }
+
+  for (Mn::UnsignedInt i = 0; i != header.jointCount; ++i) {
+    auto joint = std::make_shared<Joint>();
+    Mn::Int type;
+    if (!reader.readString(joint->m_name) || !reader.read(type) ||
+        !reader.read(joint->m_parentLinkToJointTransform) ||
+        !reader.readString(joint->m_parentLinkName) ||
+        !reader.readString(joint->m_childLinkName) ||
+        !reader.read(joint->m_localJointAxis) ||
+        !reader.read(joint->m_lowerLimit) ||
+        !reader.read(joint->m_upperLimit) ||
+        !reader.read(joint->m_effortLimit) ||
+        !reader.read(joint->m_velocityLimit) ||
+        !reader.read(joint->m_jointDamping) ||
+        !reader.read(joint->m_jointFriction)) {
+      return nullptr;
+    }
+    joint->m_type = metadata::URDF::JointTypes(type);
+    model->m_joints[joint->m_name] = std::move(joint);
+  }
+
+  if (!reader.atEnd() || model->m_links.size() != header.linkCount ||
+      model->m_joints.size() != header.jointCount ||
+      !metadata::URDF::Parser{}.initTreeAndRoot(model)) {
+    return nullptr;
+  }
+  return model;
+}  // loadURDFModelBundle
+
+bool saveURDFModelBundle(const Model& model,
+                         const std::string& filename,
+                         const std::string& urdfFilename) {
+  Cr::Containers::Optional<Cr::Containers::Array<char>> urdfData =
+      Cr::Utility::Path::read(urdfFilename);
+  if (!urdfData || model.getGlobalScaling() != 1.0f ||
+      model.getMassScaling() != 1.0f) {
+    return false;
+  }
+  const std::string urdfDirectory =
+      Cr::Utility::Path::split(urdfFilename).first();
+
+  URDFBundleHeader header{};
+  std::memcpy(header.magic, urdfBundleMagic, sizeof(urdfBundleMagic));
+  header.version = urdfBundleVersion;
+  header.urdfSize = urdfData->size();
+  header.urdfHash = hashBytes(*urdfData);
+  header.linkCount = model.m_links.size();
+  header.jointCount = model.m_joints.size();
+  header.materialCount = model.m_materials.size();
+
+  BundleWriter writer;
+  writer.write(header);
+  writer.writeString(model.m_name);
+  writer.write(model.m_rootTransformInWorld);
+  writer.write(model.m_overrideFixedBase);
+
+  for (const auto& material : model.m_materials) {
+    writer.writeMaterial(*material.second);
+  }
+
+  // links go in index order, so the index map is rebuilt the same on load
+  for (const auto& linkIndexName : model.m_linkIndicesToNames) {
+    const Link& link = *model.m_links.at(linkIndexName.second);
+    writer.writeString(link.m_name);
+    writer.write(link.m_linkIndex);
+    writer.write(link.m_inertia);
+    writer.write(link.m_contactInfo);
+    writer.write(Mn::UnsignedInt(link.m_visualArray.size()));
+    writer.write(Mn::UnsignedInt(link.m_collisionArray.size()));
+    for (const VisualShape& visual : link.m_visualArray) {
+      writeShape(writer, visual, urdfDirectory);
+      writer.writeString(visual.m_materialName);
+    }
+    for (const CollisionShape& collision : link.m_collisionArray) {
+      writeShape(writer, collision, urdfDirectory);
+      writer.write(collision.m_flags);
+      writer.write(collision.m_collisionGroup);
+      writer.write(collision.m_collisionMask);
+      writer.write(Mn::UnsignedInt(collision.m_convexHulls.size()));
+      if (collision.m_convexHulls.empty()) {
+        continue;
+      }
+      const Cr::Containers::Optional<std::size_t> meshSize =
+          Cr::Utility::Path::size(collision.m_geometry.m_meshFileName);
+      if (!meshSize) {
+        return false;
+      }
+      writer.write(Mn::UnsignedLong(*meshSize));
+      for (const std::vector<Mn::Vector3>& hull : collision.m_convexHulls) {
+        writer.write(Mn::UnsignedInt(hull.size()));
+        for (const Mn::Vector3& point : hull) {
+          writer.write(point);
+        }
+      }
+    }
+  }
+  if (model.m_linkIndicesToNames.size() != model.m_links.size()) {
+    return false;
+  }
+
+  for (const auto& jointEntry : model.m_joints) {
+    const Joint& joint = *jointEntry.second;
+    writer.writeString(joint.m_name);
+    writer.write(Mn::Int(joint.m_type));
+    writer.write(joint.m_parentLinkToJointTransform);
+    writer.writeString(joint.m_parentLinkName);
+    writer.writeString(joint.m_childLinkName);
+    writer.write(joint.m_localJointAxis);
+    writer.write(joint.m_lowerLimit);
+    writer.write(joint.m_upperLimit);
+    writer.write(joint.m_effortLimit);
+    writer.write(joint.m_velocityLimit);
+    writer.write(joint.m_jointDamping);
+    writer.write(joint.m_jointFriction);
+  }
+
+  // URDFs may be loaded by other processes while compiling, so only move the
+  // file in place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&writer));
+  return Cr::Utility::Path::write(
+             tmpFilename, Cr::Containers::ArrayView<const char>{
+                              writer.data.data(), writer.data.size()}) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveURDFModelBundle
+
+}  // namespace physics
+}  // namespace esp
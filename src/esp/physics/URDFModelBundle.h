@@ -0,0 +1,56 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_URDFMODELBUNDLE_H_
+#define ESP_PHYSICS_URDFMODELBUNDLE_H_
+
+/** @file
+ * @brief Functions reading and writing a compiled @ref
+ * esp::metadata::URDF::Model, see @ref esp::physics::loadURDFModelBundle
+ */
+
+#include <memory>
+#include <string>
+
+#include "esp/metadata/URDFParser.h"
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Name of the bundle compiled from @p urdfFilename, stored alongside it
+ */
+std::string getURDFModelBundleFilename(const std::string& urdfFilename);
+
+/**
+ * @brief Load a model saved by @ref saveURDFModelBundle()
+ *
+ * Holds everything parsing @p urdfFilename produces: the kinematic tree,
+ * inertias, joint limits, materials and link shapes with their mesh
+ * references, and also the convex hulls of mesh collision shapes if they were
+ * computed when saving, so neither the XML has to be parsed nor the collision
+ * meshes loaded. Mesh references are stored relative to @p urdfFilename.
+ *
+ * Returns @cpp nullptr @ce if the file doesn't exist, is corrupted, or was
+ * compiled from a different version of @p urdfFilename or of any mesh the
+ * hulls were computed from.
+ */
+std::shared_ptr<metadata::URDF::Model> loadURDFModelBundle(
+    const std::string& filename,
+    const std::string& urdfFilename);
+
+/**
+ * @brief Save @p model parsed from @p urdfFilename
+ *
+ * The model has to be unscaled. Returns @cpp false @ce if the file can't be
+ * written.
+ */
+bool saveURDFModelBundle(const metadata::URDF::Model& model,
+                         const std::string& filename,
+                         const std::string& urdfFilename);
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_URDFMODELBUNDLE_H_
@@ -5,6 +5,9 @@
 // Construction code adapted from Bullet3/examples/
 
 #include "BulletArticulatedObject.h"
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <algorithm>
+#include <thread>
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletPhysicsManager.h"
 #include "BulletURDFImporter.h"
@@ -216,6 +219,18 @@ void BulletArticulatedObject::constructStaticRigidBaseObject() {
 
 void BulletArticulatedObject::updateNodes(bool force) {
   isDeferringUpdate_ = false;
+  if (objectMotionType_ != MotionType::DYNAMIC) {
+    // not simulated, the transforms only change with kinematic updates
+    if (!force && !kinematicNodesDirty_) {
+      return;
+    }
+    force = true;
+  }
+  kinematicNodesDirty_ = false;
+  // a sleeping multibody has all its colliders deactivated
+  if (!force && !btMultiBody_->isAwake()) {
+    return;
+  }
   if (force || btMultiBody_->getBaseCollider()->isActive()) {
     setRotationScalingFromBulletTransform(btMultiBody_->getBaseWorldTransform(),
                                           &node());
@@ -351,10 +366,18 @@ void BulletArticulatedObject::setRootAngularVelocity(
 }
 
 void BulletArticulatedObject::setJointForces(const std::vector<float>& forces) {
+  setJointForces(Cr::Containers::arrayView(forces));
+}
+
+void BulletArticulatedObject::setJointForces(
+    Cr::Containers::ArrayView<const float> forces) {
   if (forces.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Force vector size mis-match (input:" << forces.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (forces.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -368,10 +391,18 @@ void BulletArticulatedObject::setJointForces(const std::vector<float>& forces) {
 }
 
 void BulletArticulatedObject::addJointForces(const std::vector<float>& forces) {
+  addJointForces(Cr::Containers::arrayView(forces));
+}
+
+void BulletArticulatedObject::addJointForces(
+    Cr::Containers::ArrayView<const float> forces) {
   if (forces.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Force vector size mis-match (input:" << forces.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (forces.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -386,6 +417,18 @@ void BulletArticulatedObject::addJointForces(const std::vector<float>& forces) {
 
 std::vector<float> BulletArticulatedObject::getJointForces() {
   std::vector<float> forces(btMultiBody_->getNumDofs());
+  getJointForces(Cr::Containers::arrayView(forces));
+  return forces;
+}
+
+void BulletArticulatedObject::getJointForces(
+    Cr::Containers::ArrayView<float> forces) {
+  if (forces.size() < size_t(btMultiBody_->getNumDofs())) {
+    ESP_ERROR() << "Force vector too small (input:" << forces.size()
+                << ", expected:" << btMultiBody_->getNumDofs()
+                << "), aborting.";
+    return;
+  }
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofForces = btMultiBody_->getJointTorqueMultiDof(i);
@@ -394,15 +437,22 @@ std::vector<float> BulletArticulatedObject::getJointForces() {
       ++dofCount;
     }
   }
-  return forces;
 }
 
 void BulletArticulatedObject::setJointVelocities(
     const std::vector<float>& vels) {
+  setJointVelocities(Cr::Containers::arrayView(vels));
+}
+
+void BulletArticulatedObject::setJointVelocities(
+    Cr::Containers::ArrayView<const float> vels) {
   if (vels.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Velocity vector size mis-match (input:" << vels.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (vels.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -418,6 +468,18 @@ void BulletArticulatedObject::setJointVelocities(
 
 std::vector<float> BulletArticulatedObject::getJointVelocities() {
   std::vector<float> vels(btMultiBody_->getNumDofs());
+  getJointVelocities(Cr::Containers::arrayView(vels));
+  return vels;
+}
+
+void BulletArticulatedObject::getJointVelocities(
+    Cr::Containers::ArrayView<float> vels) {
+  if (vels.size() < size_t(btMultiBody_->getNumDofs())) {
+    ESP_ERROR() << "Velocity vector too small (input:" << vels.size()
+                << ", expected:" << btMultiBody_->getNumDofs()
+                << "), aborting.";
+    return;
+  }
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofVels = btMultiBody_->getJointVelMultiDof(i);
@@ -426,15 +488,22 @@ std::vector<float> BulletArticulatedObject::getJointVelocities() {
       ++dofCount;
     }
   }
-  return vels;
 }
 
 void BulletArticulatedObject::setJointPositions(
     const std::vector<float>& positions) {
+  setJointPositions(Cr::Containers::arrayView(positions));
+}
+
+void BulletArticulatedObject::setJointPositions(
+    Cr::Containers::ArrayView<const float> positions) {
   if (positions.size() != size_t(btMultiBody_->getNumPosVars())) {
     ESP_DEBUG(Mn::Debug::Flag::NoSpace)
         << "Position vector size mis-match (input:" << positions.size()
         << ", expected:" << btMultiBody_->getNumPosVars() << "), aborting.";
+    if (positions.size() < size_t(btMultiBody_->getNumPosVars())) {
+      return;
+    }
   }
 
   int posCount = 0;
@@ -453,6 +522,18 @@ void BulletArticulatedObject::setJointPositions(
 
 std::vector<float> BulletArticulatedObject::getJointPositions() {
   std::vector<float> positions(btMultiBody_->getNumPosVars());
+  getJointPositions(Cr::Containers::arrayView(positions));
+  return positions;
+}
+
+void BulletArticulatedObject::getJointPositions(
+    Cr::Containers::ArrayView<float> positions) {
+  if (positions.size() < size_t(btMultiBody_->getNumPosVars())) {
+    ESP_ERROR() << "Position vector too small (input:" << positions.size()
+                << ", expected:" << btMultiBody_->getNumPosVars()
+                << "), aborting.";
+    return;
+  }
   int posCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* linkPos = btMultiBody_->getJointPosMultiDof(i);
@@ -461,7 +542,6 @@ std::vector<float> BulletArticulatedObject::getJointPositions() {
       ++posCount;
     }
   }
-  return positions;
 }
 
 std::vector<float> BulletArticulatedObject::getJointMotorTorques(
@@ -615,14 +695,36 @@ void BulletArticulatedObject::setMotionType(MotionType mt) {
   // DYNAMIC -> other)
   if (mt == MotionType::DYNAMIC) {
     bWorld_->addMultiBody(btMultiBody_.get());
+    setMultiBodyConstraintsInWorld(true);
   } else if (objectMotionType_ == MotionType::DYNAMIC) {
     // TODO: STATIC and KINEMATIC are equivalent for simplicity. Could manually
     // limit STATIC...
     bWorld_->removeMultiBody(btMultiBody_.get());
+    // motors and joint limits would otherwise still be solved every step
+    setMultiBodyConstraintsInWorld(false);
   }
   objectMotionType_ = mt;
 }
 
+void BulletArticulatedObject::setMultiBodyConstraintsInWorld(bool inWorld) {
+  const auto update = [&](btMultiBodyConstraint* constraint) {
+    if (inWorld) {
+      bWorld_->addMultiBodyConstraint(constraint);
+    } else {
+      bWorld_->removeMultiBodyConstraint(constraint);
+    }
+  };
+  for (auto& motor : articulatedJointMotors) {
+    update(motor.second.get());
+  }
+  for (auto& motor : articulatedSphericalJointMotors) {
+    update(motor.second.get());
+  }
+  for (auto& jointLimit : jointLimitConstraints_) {
+    update(jointLimit.second.con);
+  }
+}
+
 void BulletArticulatedObject::clampJointLimits() {
   auto pose = getJointPositions();
   bool poseModified = false;
@@ -691,6 +793,10 @@ void BulletArticulatedObject::overrideCollisionGroup(CollisionGroup group) {
 }
 
 void BulletArticulatedObject::updateKinematicState() {
+  if (objectMotionType_ != MotionType::DYNAMIC) {
+    updateKinematicStateDirect();
+    return;
+  }
   if (!isActive()) {
     // activate if not already active and kinematically updated
     setActive(true);
@@ -711,6 +817,256 @@ void BulletArticulatedObject::updateKinematicState() {
   }
 }
 
+void BulletArticulatedObject::computeLinkWorldTransforms() {
+  // one pass down the link tree, parents are always ordered before children
+  const int numLinks = btMultiBody_->getNumLinks();
+  scratch_q_.resize(numLinks + 1);
+  scratch_m_.resize(numLinks + 1);
+  scratch_q_[0] = btMultiBody_->getWorldToBaseRot();
+  scratch_m_[0] = btMultiBody_->getBasePos();
+  for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+    const int parentIx = btMultiBody_->getParent(linkIx) + 1;
+    scratch_q_[linkIx + 1] =
+        btMultiBody_->getParentToLocalRot(linkIx) * scratch_q_[parentIx];
+    scratch_m_[linkIx + 1] =
+        scratch_m_[parentIx] + quatRotate(scratch_q_[linkIx + 1].inverse(),
+                                          btMultiBody_->getRVector(linkIx));
+  }
+}
+
+// Rotation from the parent frame and offset from the parent origin of a link
+// at the joint positions @p jointPos, as btMultibodyLink::updateCacheMultiDof()
+// computes them, but without writing them to the link
+static void linkParentToLocal(const btMultibodyLink& link,
+                              const btScalar* jointPos,
+                              btQuaternion& rotParentToThis,
+                              btVector3& rVector) {
+  switch (link.m_jointType) {
+    case btMultibodyLink::eRevolute:
+      rotParentToThis = btQuaternion(link.getAxisTop(0), -jointPos[0]) *
+                        link.m_zeroRotParentToThis;
+      rVector = link.m_dVector + quatRotate(rotParentToThis, link.m_eVector);
+      break;
+    case btMultibodyLink::ePrismatic:
+      rotParentToThis = link.m_zeroRotParentToThis;
+      rVector = link.m_dVector + quatRotate(rotParentToThis, link.m_eVector) +
+                jointPos[0] * link.getAxisBottom(0);
+      break;
+    case btMultibodyLink::eSpherical:
+      rotParentToThis =
+          btQuaternion(jointPos[0], jointPos[1], jointPos[2], -jointPos[3]) *
+          link.m_zeroRotParentToThis;
+      rVector = link.m_dVector + quatRotate(rotParentToThis, link.m_eVector);
+      break;
+    case btMultibodyLink::ePlanar:
+      rotParentToThis = btQuaternion(link.getAxisTop(0), -jointPos[0]) *
+                        link.m_zeroRotParentToThis;
+      rVector = quatRotate(btQuaternion(link.getAxisTop(0), -jointPos[0]),
+                           jointPos[1] * link.getAxisBottom(1) +
+                               jointPos[2] * link.getAxisBottom(2)) +
+                quatRotate(rotParentToThis, link.m_eVector);
+      break;
+    default:
+      rotParentToThis = link.m_zeroRotParentToThis;
+      rVector = link.m_dVector + quatRotate(rotParentToThis, link.m_eVector);
+      break;
+  }
+}
+
+// Call @p work with contiguous ranges of @p count items split across
+// @p numThreads threads, one per hardware core if it's zero or negative
+template <class F>
+static void forEachRangeInParallel(std::size_t count, int numThreads, F work) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const std::size_t threadCount =
+      std::max<std::size_t>(1, std::min<std::size_t>(numThreads, count));
+  const std::size_t rangeSize = (count + threadCount - 1) / threadCount;
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < threadCount; ++i) {
+    const std::size_t begin = std::min(count, i * rangeSize);
+    const std::size_t end = std::min(count, begin + rangeSize);
+    workers.emplace_back(work, begin, end);
+  }
+  work(0, std::min(count, rangeSize));
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void BulletArticulatedObject::computeLinkWorldTransforms(
+    const float* positions,
+    btAlignedObjectArray<btQuaternion>& q,
+    btAlignedObjectArray<btVector3>& m) const {
+  const int numLinks = btMultiBody_->getNumLinks();
+  q.resize(numLinks + 1);
+  m.resize(numLinks + 1);
+  q[0] = btMultiBody_->getWorldToBaseRot();
+  m[0] = btMultiBody_->getBasePos();
+  btQuaternion rotParentToThis;
+  btVector3 rVector;
+  for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+    const btMultibodyLink& link = btMultiBody_->getLink(linkIx);
+    const int parentIx = link.m_parent + 1;
+    linkParentToLocal(link, positions + link.m_cfgOffset, rotParentToThis,
+                      rVector);
+    q[linkIx + 1] = rotParentToThis * q[parentIx];
+    m[linkIx + 1] = m[parentIx] + quatRotate(q[linkIx + 1].inverse(), rVector);
+  }
+}
+
+void BulletArticulatedObject::computeLinkTransformations(
+    Cr::Containers::ArrayView<const float> positions,
+    Cr::Containers::ArrayView<Mn::Matrix4> transformations,
+    int numThreads) const {
+  const std::size_t numPosVars = btMultiBody_->getNumPosVars();
+  const std::size_t numLinks = btMultiBody_->getNumLinks();
+  ESP_CHECK(numPosVars && positions.size() % numPosVars == 0,
+            "BulletArticulatedObject::computeLinkTransformations(): expected "
+            "a multiple of"
+                << numPosVars << "joint positions but got" << positions.size());
+  const std::size_t numConfigurations = positions.size() / numPosVars;
+  ESP_CHECK(transformations.size() == numConfigurations * (numLinks + 1),
+            "BulletArticulatedObject::computeLinkTransformations(): expected"
+                << numConfigurations * (numLinks + 1)
+                << "transformations but got" << transformations.size());
+
+  forEachRangeInParallel(
+      numConfigurations, numThreads, [&](std::size_t begin, std::size_t end) {
+        btAlignedObjectArray<btQuaternion> q;
+        btAlignedObjectArray<btVector3> m;
+        for (std::size_t i = begin; i != end; ++i) {
+          computeLinkWorldTransforms(positions.data() + i * numPosVars, q, m);
+          Mn::Matrix4* out = transformations.data() + i * (numLinks + 1);
+          for (std::size_t linkIx = 0; linkIx != numLinks + 1; ++linkIx) {
+            out[linkIx] = Mn::Matrix4{btTransform(q[linkIx].inverse(),
+                                                  m[linkIx])};
+          }
+        }
+      });
+}
+
+void BulletArticulatedObject::computeLinkJacobians(
+    int linkId,
+    Cr::Containers::ArrayView<const float> positions,
+    Cr::Containers::ArrayView<float> jacobians,
+    int numThreads) const {
+  const std::size_t numPosVars = btMultiBody_->getNumPosVars();
+  const std::size_t numDofs = btMultiBody_->getNumDofs();
+  ESP_CHECK(linkId >= 0 && linkId < btMultiBody_->getNumLinks(),
+            "BulletArticulatedObject::computeLinkJacobians(): no link with id"
+                << linkId);
+  ESP_CHECK(numPosVars && positions.size() % numPosVars == 0,
+            "BulletArticulatedObject::computeLinkJacobians(): expected a "
+            "multiple of"
+                << numPosVars << "joint positions but got" << positions.size());
+  const std::size_t numConfigurations = positions.size() / numPosVars;
+  ESP_CHECK(jacobians.size() == numConfigurations * 6 * numDofs,
+            "BulletArticulatedObject::computeLinkJacobians(): expected"
+                << numConfigurations * 6 * numDofs << "values but got"
+                << jacobians.size());
+
+  forEachRangeInParallel(
+      numConfigurations, numThreads, [&](std::size_t begin, std::size_t end) {
+        btAlignedObjectArray<btQuaternion> q;
+        btAlignedObjectArray<btVector3> m;
+        for (std::size_t i = begin; i != end; ++i) {
+          computeLinkWorldTransforms(positions.data() + i * numPosVars, q, m);
+          float* out = jacobians.data() + i * 6 * numDofs;
+          std::fill(out, out + 6 * numDofs, 0.0f);
+          const auto setColumn = [&](int dof, const btVector3& linear,
+                                     const btVector3& angular) {
+            for (int row = 0; row != 3; ++row) {
+              out[row * numDofs + dof] = linear[row];
+              out[(row + 3) * numDofs + dof] = angular[row];
+            }
+          };
+
+          // only the joints on the path from the link to the base move it
+          const btVector3& target = m[linkId + 1];
+          for (int linkIx = linkId; linkIx != -1;
+               linkIx = btMultiBody_->getParent(linkIx)) {
+            const btMultibodyLink& link = btMultiBody_->getLink(linkIx);
+            const btQuaternion linkToWorld = q[linkIx + 1].inverse();
+            const btVector3& origin = m[linkIx + 1];
+            switch (link.m_jointType) {
+              case btMultibodyLink::eRevolute:
+              case btMultibodyLink::eSpherical: {
+                // the joint pivot stays fixed in the parent's frame
+                const btVector3 pivot =
+                    origin - quatRotate(linkToWorld, link.m_dVector);
+                for (int dof = 0; dof != link.m_dofCount; ++dof) {
+                  const btVector3 axis =
+                      quatRotate(linkToWorld, link.getAxisTop(dof));
+                  setColumn(link.m_dofOffset + dof, axis.cross(target - pivot),
+                            axis);
+                }
+                break;
+              }
+              case btMultibodyLink::ePrismatic:
+                setColumn(link.m_dofOffset,
+                          quatRotate(linkToWorld, link.getAxisBottom(0)),
+                          btVector3(0, 0, 0));
+                break;
+              case btMultibodyLink::ePlanar: {
+                // rotates around the link origin, translates in the
+                // parent's frame
+                const btVector3 axis =
+                    quatRotate(linkToWorld, link.getAxisTop(0));
+                setColumn(link.m_dofOffset, axis.cross(target - origin), axis);
+                const btQuaternion planeToWorld =
+                    q[link.m_parent + 1].inverse() *
+                    link.m_zeroRotParentToThis.inverse();
+                for (int dof = 1; dof != 3; ++dof) {
+                  setColumn(link.m_dofOffset + dof,
+                            quatRotate(planeToWorld, link.getAxisBottom(dof)),
+                            btVector3(0, 0, 0));
+                }
+                break;
+              }
+              default:
+                break;
+            }
+          }
+        }
+      });
+}
+
+void BulletArticulatedObject::updateKinematicStateDirect() {
+  computeLinkWorldTransforms();
+  if (btCollisionObject* baseCollider = btMultiBody_->getBaseCollider()) {
+    setKinematicColliderTransform(baseCollider,
+                                  btMultiBody_->getBaseWorldTransform());
+  }
+  for (int linkIx = 0; linkIx < btMultiBody_->getNumLinks(); ++linkIx) {
+    btMultibodyLink& link = btMultiBody_->getLink(linkIx);
+    link.m_cachedWorldTransform =
+        btTransform(scratch_q_[linkIx + 1].inverse(), scratch_m_[linkIx + 1]);
+    if (link.m_collider != nullptr) {
+      setKinematicColliderTransform(link.m_collider,
+                                    link.m_cachedWorldTransform);
+    }
+  }
+  if (bFixedObjectRigidBody_) {
+    bWorld_->updateSingleAabb(bFixedObjectRigidBody_.get());
+  }
+  kinematicNodesDirty_ = true;
+  if (!isDeferringUpdate_) {
+    updateNodes(true);
+  }
+}
+
+void BulletArticulatedObject::setKinematicColliderTransform(
+    btCollisionObject* collider,
+    const btTransform& transform) {
+  collider->setWorldTransform(transform);
+  collider->setInterpolationWorldTransform(transform);
+  // wake objects resting on the moved collider
+  collider->activate();
+  bWorld_->updateSingleAabb(collider);
+}
+
 /**
  * @brief Specific callback function for ArticulatedObject::contactTest to
  * screen self-collisions.
@@ -719,14 +1075,19 @@ struct AOSimulationContactResultCallback
     : public SimulationContactResultCallback {
   btMultiBody* mb_ = nullptr;
   btRigidBody* fixedBaseColObj_ = nullptr;
+  bool screenSelfCollisions_ = false;
 
   /**
    * @brief Constructor taking the AO's btMultiBody as input to screen
-   * self-collisions.
+   * self-collisions. Self-collisions are screened if the multibody doesn't
+   * have them enabled or if @p screenSelfCollisions is set.
    */
   AOSimulationContactResultCallback(btMultiBody* mb,
-                                    btRigidBody* fixedBaseColObj)
-      : mb_(mb), fixedBaseColObj_(fixedBaseColObj) {
+                                    btRigidBody* fixedBaseColObj,
+                                    bool screenSelfCollisions = false)
+      : mb_(mb),
+        fixedBaseColObj_(fixedBaseColObj),
+        screenSelfCollisions_(screenSelfCollisions) {
     bCollision = false;
   }
 
@@ -734,7 +1095,7 @@ struct AOSimulationContactResultCallback
     // base method checks for group|mask filter
     bool collides = SimulationContactResultCallback::needsCollision(proxy0);
     // check for self-collision
-    if (!mb_->hasSelfCollision()) {
+    if (screenSelfCollisions_ || !mb_->hasSelfCollision()) {
       // This should always be a valid conversion to btCollisionObject
       auto* co = static_cast<btCollisionObject*>(proxy0->m_clientObject);
       auto* mblc = dynamic_cast<btMultiBodyLinkCollider*>(co);
@@ -794,6 +1155,95 @@ bool BulletArticulatedObject::contactTest() {
   return false;
 }  // contactTest
 
+std::vector<bool> BulletArticulatedObject::contactTestJointPositions(
+    const std::vector<float>& positions) {
+  const int numPosVars = btMultiBody_->getNumPosVars();
+  const int numLinks = btMultiBody_->getNumLinks();
+  if (numPosVars == 0 || positions.size() % numPosVars != 0) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Position vector size (" << positions.size()
+        << ") is not a multiple of the number of joint positions ("
+        << numPosVars << "), aborting.";
+    return {};
+  }
+  const std::size_t numConfigurations = positions.size() / numPosVars;
+
+  // The other links' broadphase proxies aren't moved with the queried
+  // configuration, so self-collisions can't be reported reliably.
+  AOSimulationContactResultCallback src(btMultiBody_.get(),
+                                        bFixedObjectRigidBody_.get(), true);
+  auto contactTestCollider = [&](btCollisionObject* collider) {
+    src.m_collisionFilterGroup =
+        collider->getBroadphaseHandle()->m_collisionFilterGroup;
+    src.m_collisionFilterMask =
+        collider->getBroadphaseHandle()->m_collisionFilterMask;
+    bWorld_->getCollisionWorld()->contactTest(collider, src);
+    return src.bCollision;
+  };
+
+  // the base doesn't depend on the joint positions, test it only once
+  btCollisionObject* baseCollider = bFixedObjectRigidBody_
+                                        ? bFixedObjectRigidBody_.get()
+                                        : btMultiBody_->getBaseCollider();
+  if (baseCollider && contactTestCollider(baseCollider)) {
+    return std::vector<bool>(numConfigurations, true);
+  }
+
+  // Each configuration is written to the joint position cache and the link
+  // colliders, both restored afterwards. contactTest computes the query aabb
+  // from the collider's world transform, so the broadphase, the contact
+  // manifolds and the activation state are never touched.
+  std::vector<float> savedPositions = getJointPositions();
+  std::vector<btTransform> savedColliderTransforms(numLinks);
+  for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+    if (auto* linkCollider = btMultiBody_->getLinkCollider(linkIx)) {
+      savedColliderTransforms[linkIx] = linkCollider->getWorldTransform();
+    }
+  }
+
+  std::vector<bool> results(numConfigurations, false);
+  for (std::size_t configIx = 0; configIx < numConfigurations; ++configIx) {
+    const float* configuration = positions.data() + configIx * numPosVars;
+    int posCount = 0;
+    for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+      auto& link = btMultiBody_->getLink(linkIx);
+      if (link.m_posVarCount > 0) {
+        btMultiBody_->setJointPosMultiDof(
+            linkIx, const_cast<float*>(&configuration[posCount]));
+        posCount += link.m_posVarCount;
+      }
+    }
+    computeLinkWorldTransforms();
+    for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+      if (auto* linkCollider = btMultiBody_->getLinkCollider(linkIx)) {
+        linkCollider->setWorldTransform(btTransform(
+            scratch_q_[linkIx + 1].inverse(), scratch_m_[linkIx + 1]));
+      }
+    }
+    for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+      auto* linkCollider = btMultiBody_->getLinkCollider(linkIx);
+      if (linkCollider && contactTestCollider(linkCollider)) {
+        results[configIx] = true;
+        break;
+      }
+    }
+    src.bCollision = false;
+  }
+
+  int posCount = 0;
+  for (int linkIx = 0; linkIx < numLinks; ++linkIx) {
+    auto& link = btMultiBody_->getLink(linkIx);
+    if (link.m_posVarCount > 0) {
+      btMultiBody_->setJointPosMultiDof(linkIx, &savedPositions[posCount]);
+      posCount += link.m_posVarCount;
+    }
+    if (auto* linkCollider = btMultiBody_->getLinkCollider(linkIx)) {
+      linkCollider->setWorldTransform(savedColliderTransforms[linkIx]);
+    }
+  }
+  return results;
+}  // contactTestJointPositions
+
 // ------------------------
 // Joint Motor API
 // ------------------------
@@ -864,7 +1314,9 @@ int BulletArticulatedObject::createJointMotor(
         settings.maxImpulse);
     btMotor->setPositionTarget(settings.positionTarget, settings.positionGain);
     btMotor->setVelocityTarget(settings.velocityTarget, settings.velocityGain);
-    bWorld_->addMultiBodyConstraint(btMotor.get());
+    if (objectMotionType_ == MotionType::DYNAMIC) {
+      bWorld_->addMultiBodyConstraint(btMotor.get());
+    }
     btMotor->finalizeMultiDof();
     articulatedJointMotors.emplace(
         nextJointMotorId_, std::move(btMotor));  // cache the Bullet structure
@@ -876,7 +1328,9 @@ int BulletArticulatedObject::createJointMotor(
                                settings.positionGain);
     btMotor->setVelocityTarget(btVector3(settings.sphericalVelocityTarget),
                                settings.velocityGain);
-    bWorld_->addMultiBodyConstraint(btMotor.get());
+    if (objectMotionType_ == MotionType::DYNAMIC) {
+      bWorld_->addMultiBodyConstraint(btMotor.get());
+    }
     btMotor->finalizeMultiDof();
     articulatedSphericalJointMotors.emplace(
         nextJointMotorId_, std::move(btMotor));  // cache the Bullet structure
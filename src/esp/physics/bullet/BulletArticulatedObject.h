@@ -62,6 +62,9 @@ class BulletArticulatedLink : public ArticulatedLink, public BulletBase {
 ////////////////////////////////////
 
 class BulletArticulatedObject : public ArticulatedObject {
+  //! copies the motors and joint limits
+  friend class BulletWorldClone;
+
  public:
   BulletArticulatedObject(
       scene::SceneNode* rootNode,
@@ -221,6 +224,31 @@ class BulletArticulatedObject : public ArticulatedObject {
    */
   std::vector<float> getJointPositions() override;
 
+  int getNumDofs() const override { return btMultiBody_->getNumDofs(); }
+
+  int getNumJointPositions() const override {
+    return btMultiBody_->getNumPosVars();
+  }
+
+  void setJointForces(
+      Corrade::Containers::ArrayView<const float> forces) override;
+
+  void addJointForces(
+      Corrade::Containers::ArrayView<const float> forces) override;
+
+  void getJointForces(Corrade::Containers::ArrayView<float> forces) override;
+
+  void setJointVelocities(
+      Corrade::Containers::ArrayView<const float> vels) override;
+
+  void getJointVelocities(Corrade::Containers::ArrayView<float> vels) override;
+
+  void setJointPositions(
+      Corrade::Containers::ArrayView<const float> positions) override;
+
+  void getJointPositions(
+      Corrade::Containers::ArrayView<float> positions) override;
+
   /**
    * @brief Get the torques on each joint
    *
@@ -354,6 +382,71 @@ class BulletArticulatedObject : public ArticulatedObject {
    */
   bool contactTest() override;
 
+  /**
+   * @brief Run @ref contactTest for a batch of joint configurations without
+   * changing the object's state.
+   *
+   * Each configuration is a block of @ref getNumJointPositions values laid
+   * out as for @ref setJointPositions. Only the broadphase is queried for
+   * candidate pairs against the rest of the world; the broadphase proxies,
+   * contact manifolds, activation and joint state of the object are left as
+   * they were, so this is suited to the many collision checks of a motion
+   * planner. Self-collisions are not reported.
+   * @param positions The joint configurations, one after another.
+   * @return Whether or not the object would be in contact with any other
+   * collision enabled objects, one entry per configuration. Empty if the size
+   * of @p positions is not a multiple of @ref getNumJointPositions.
+   */
+  std::vector<bool> contactTestJointPositions(
+      const std::vector<float>& positions);
+
+  /**
+   * @brief Compute the world transformations of the base and all links for a
+   * batch of joint configurations without changing the object's state.
+   *
+   * Each configuration is a block of @ref getNumJointPositions values laid
+   * out as for @ref setJointPositions. The links are posed from the current
+   * base transformation the same way @ref setJointPositions would pose them,
+   * but in local scratch memory, so inverse kinematics or reachability
+   * sampling can evaluate many configurations while the simulation keeps
+   * running. The configurations are split across threads.
+   * @param positions The joint configurations, one after another.
+   * @param[out] transformations The base transformation followed by the
+   * @ref getNumLinks link transformations, ordered by link id, for each
+   * configuration. Expected to be @ref getNumLinks + 1 times the number of
+   * configurations long.
+   * @param numThreads Number of threads to use. If zero or negative, one
+   * thread per hardware core is used.
+   */
+  void computeLinkTransformations(
+      Corrade::Containers::ArrayView<const float> positions,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations,
+      int numThreads = 0) const;
+
+  /**
+   * @brief Compute the Jacobian of a link for a batch of joint configurations
+   * without changing the object's state.
+   *
+   * Configurations are laid out as for @ref computeLinkTransformations().
+   * The Jacobian maps the @ref getNumDofs joint velocities to the linear
+   * velocity of the link's origin and the angular velocity of the link, both
+   * in world space, with the base held fixed. For spherical joints the three
+   * columns are rotations around the link's local axes, like their joint
+   * velocities. Columns of joints that don't move the link are zero.
+   * @param linkId The link to compute the Jacobian of.
+   * @param positions The joint configurations, one after another.
+   * @param[out] jacobians A row-major 6 x @ref getNumDofs matrix for each
+   * configuration, the linear part in the first three rows and the angular
+   * part in the last three.
+   * @param numThreads Number of threads to use. If zero or negative, one
+   * thread per hardware core is used.
+   */
+  void computeLinkJacobians(
+      int linkId,
+      Corrade::Containers::ArrayView<const float> positions,
+      Corrade::Containers::ArrayView<float> jacobians,
+      int numThreads = 0) const;
+
   //! clamp current pose to joint limits
   void clampJointLimits() override;
 
@@ -449,6 +542,36 @@ class BulletArticulatedObject : public ArticulatedObject {
   //! broadphase aabbs for the object. Do this with manual state setters.
   void updateKinematicState();
 
+  //! @ref updateKinematicState for objects which are not @ref
+  //! MotionType::DYNAMIC and so aren't in the multibody solver. Computes the
+  //! link transforms in a single pass and writes them straight to the link
+  //! colliders and scene nodes.
+  void updateKinematicStateDirect();
+
+  //! Compute the world rotations and positions of the base and all links from
+  //! the current joint positions into @ref scratch_q_ and @ref scratch_m_,
+  //! without writing them anywhere else.
+  void computeLinkWorldTransforms();
+
+  //! Compute the world rotations and positions of the base and all links for
+  //! the joint positions @p positions into @p q and @p m, laid out like
+  //! @ref scratch_q_ and @ref scratch_m_. Doesn't touch the multibody.
+  void computeLinkWorldTransforms(const float* positions,
+                                  btAlignedObjectArray<btQuaternion>& q,
+                                  btAlignedObjectArray<btVector3>& m) const;
+
+  //! Move a base or link collider of an object which is not simulated
+  void setKinematicColliderTransform(btCollisionObject* collider,
+                                     const btTransform& transform);
+
+  //! Add or remove the joint motor and joint limit constraints of this object
+  //! to or from the world's multibody solver
+  void setMultiBodyConstraintsInWorld(bool inWorld);
+
+  //! Whether a kinematic update of an object which is not @ref
+  //! MotionType::DYNAMIC has not been applied to the scene nodes yet
+  bool kinematicNodesDirty_ = false;
+
   //! Instantly set activation state of the base and link collision objects,
   //! otherwise deferred to simulation time
   void setCollisionObjectsActivateState(bool activate) const;
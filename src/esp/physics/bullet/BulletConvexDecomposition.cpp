@@ -0,0 +1,347 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletConvexDecomposition.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Mesh.h>
+
+#include <LinearMath/btConvexHullComputer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+/* Parts whose hull exceeds the volume of the mesh they enclose by less than
+   this fraction of the asset's hull volume are considered convex enough */
+constexpr float minRelativeConcavity = 0.02f;
+
+/* Bump whenever the cache file layout or the decomposition changes, so stale
+   cache entries aren't used */
+constexpr Mn::UnsignedInt hullCacheVersion = 1;
+constexpr char hullCacheMagic[4]{'H', 'S', 'C', 'D'};
+
+struct HullCacheHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedLong assetSize;
+  Mn::UnsignedInt hullCount;
+  Mn::UnsignedInt vertexCount;
+};
+
+// flatten the triangles of the subtree into the asset frame, three corners
+// per triangle
+void collectTriangles(const Mn::Matrix4& transformFromParentToWorld,
+                      const std::vector<assets::CollisionMeshData>& meshGroup,
+                      const assets::MeshTransformNode& node,
+                      std::vector<Mn::Vector3>& corners) {
+  const Mn::Matrix4 transformFromLocalToWorld =
+      transformFromParentToWorld * node.transformFromLocalToParent;
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
+    if (mesh.primitive == Mn::MeshPrimitive::Triangles) {
+      for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        for (std::size_t j = 0; j != 3; ++j) {
+          corners.push_back(transformFromLocalToWorld.transformPoint(
+              mesh.positions[mesh.indices[i + j]]));
+        }
+      }
+    }
+  }
+  for (const auto& child : node.children) {
+    collectTriangles(transformFromLocalToWorld, meshGroup, child, corners);
+  }
+}
+
+// a subset of the asset triangles approximated by one hull
+struct Part {
+  std::vector<std::size_t> triangles;
+  float concavity = 0.0f;
+  bool isFinal = false;
+};
+
+class Decomposer {
+ public:
+  explicit Decomposer(std::vector<Mn::Vector3> corners)
+      : corners_{std::move(corners)} {
+    // the signed volumes of the cones from a common apex to each triangle
+    // sum up to the volume of a closed mesh, so the parts share it exactly
+    Mn::Vector3 sum;
+    for (const Mn::Vector3& corner : corners_) {
+      sum += corner;
+    }
+    if (!corners_.empty()) {
+      apex_ = sum / Mn::Float(corners_.size());
+    }
+    float meshVolume = 0.0f;
+    for (std::size_t t = 0; t != triangleCount(); ++t) {
+      meshVolume += coneVolume(t);
+    }
+    // inward-facing winding flips the sign of every cone
+    orientation_ = meshVolume < 0.0f ? -1.0f : 1.0f;
+  }
+
+  std::size_t triangleCount() const { return corners_.size() / 3; }
+
+  const Mn::Vector3& corner(std::size_t t, std::size_t i) const {
+    return corners_[3 * t + i];
+  }
+
+  float coneVolume(std::size_t t) const {
+    return Mn::Math::dot(
+               corner(t, 0) - apex_,
+               Mn::Math::cross(corner(t, 1) - apex_, corner(t, 2) - apex_)) /
+           6.0f;
+  }
+
+  // compute the hull of the part's triangles into hull_, returning its volume
+  float computeHull(const std::vector<std::size_t>& triangles) {
+    points_.clear();
+    for (std::size_t t : triangles) {
+      points_.insert(points_.end(), &corner(t, 0), &corner(t, 0) + 3);
+    }
+    hull_.compute(points_.data()->data(), sizeof(Mn::Vector3),
+                  int(points_.size()), 0.0f, 0.0f);
+    // sum the tetrahedra of a fan triangulation of each face
+    btScalar volume = 0.0f;
+    for (int f = 0; f < hull_.faces.size(); ++f) {
+      const btConvexHullComputer::Edge* first = &hull_.edges[hull_.faces[f]];
+      const btVector3& a = hull_.vertices[first->getSourceVertex()];
+      const btConvexHullComputer::Edge* edge = first->getNextEdgeOfFace();
+      while (edge->getTargetVertex() != first->getSourceVertex()) {
+        volume += a.dot(hull_.vertices[edge->getSourceVertex()].cross(
+            hull_.vertices[edge->getTargetVertex()]));
+        edge = edge->getNextEdgeOfFace();
+      }
+    }
+    return std::abs(volume) / 6.0f;
+  }
+
+  // how much the part's hull exceeds the mesh volume it encloses
+  float concavity(const std::vector<std::size_t>& triangles) {
+    float meshVolume = 0.0f;
+    for (std::size_t t : triangles) {
+      meshVolume += coneVolume(t);
+    }
+    return computeHull(triangles) - orientation_ * meshVolume;
+  }
+
+  // split the triangles in half at the median centroid along the longest
+  // extent
+  void split(const std::vector<std::size_t>& triangles,
+             std::vector<std::size_t>& lower,
+             std::vector<std::size_t>& upper) const {
+    Mn::Vector3 min = centroid(triangles.front());
+    Mn::Vector3 max = min;
+    for (std::size_t t : triangles) {
+      min = Mn::Math::min(min, centroid(t));
+      max = Mn::Math::max(max, centroid(t));
+    }
+    const Mn::Vector3 size = max - min;
+    const int axis = size.x() >= size.y() && size.x() >= size.z()
+                         ? 0
+                         : (size.y() >= size.z() ? 1 : 2);
+    lower = triangles;
+    const auto middle = lower.begin() + lower.size() / 2;
+    std::nth_element(lower.begin(), middle, lower.end(),
+                     [&](std::size_t a, std::size_t b) {
+                       return centroid(a)[axis] < centroid(b)[axis];
+                     });
+    upper.assign(middle, lower.end());
+    lower.erase(middle, lower.end());
+  }
+
+  std::vector<Mn::Vector3> hullVertices(
+      const std::vector<std::size_t>& triangles) {
+    computeHull(triangles);
+    std::vector<Mn::Vector3> vertices;
+    vertices.reserve(hull_.vertices.size());
+    for (int i = 0; i < hull_.vertices.size(); ++i) {
+      vertices.emplace_back(hull_.vertices[i].x(), hull_.vertices[i].y(),
+                            hull_.vertices[i].z());
+    }
+    return vertices;
+  }
+
+ private:
+  // three times the centroid, which orders the same
+  Mn::Vector3 centroid(std::size_t t) const {
+    return corner(t, 0) + corner(t, 1) + corner(t, 2);
+  }
+
+  std::vector<Mn::Vector3> corners_;
+  Mn::Vector3 apex_;
+  float orientation_ = 1.0f;
+  std::vector<Mn::Vector3> points_;
+  btConvexHullComputer hull_;
+};
+
+}  // namespace
+
+ConvexDecomposition computeConvexDecomposition(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root,
+    int maxHulls) {
+  std::vector<Mn::Vector3> corners;
+  collectTriangles(Mn::Matrix4{}, meshGroup, root, corners);
+  Decomposer decomposer{std::move(corners)};
+  if (decomposer.triangleCount() == 0 || maxHulls < 1) {
+    return {};
+  }
+
+  std::vector<Part> parts(1);
+  parts[0].triangles.resize(decomposer.triangleCount());
+  std::iota(parts[0].triangles.begin(), parts[0].triangles.end(), 0);
+  const float minConcavity =
+      minRelativeConcavity * decomposer.computeHull(parts[0].triangles);
+  parts[0].concavity = decomposer.concavity(parts[0].triangles);
+
+  std::vector<std::size_t> lower;
+  std::vector<std::size_t> upper;
+  while (int(parts.size()) < maxHulls) {
+    // split the most concave part first
+    auto mostConcave = parts.end();
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+      if (!it->isFinal && (mostConcave == parts.end() ||
+                           it->concavity > mostConcave->concavity)) {
+        mostConcave = it;
+      }
+    }
+    if (mostConcave == parts.end()) {
+      break;
+    }
+    if (mostConcave->concavity <= minConcavity ||
+        mostConcave->triangles.size() < 2) {
+      mostConcave->isFinal = true;
+      continue;
+    }
+    decomposer.split(mostConcave->triangles, lower, upper);
+    mostConcave->triangles = lower;
+    mostConcave->concavity = decomposer.concavity(lower);
+    Part upperPart;
+    upperPart.triangles = upper;
+    upperPart.concavity = decomposer.concavity(upper);
+    // invalidates mostConcave
+    parts.push_back(std::move(upperPart));
+  }
+
+  ConvexDecomposition hulls;
+  hulls.reserve(parts.size());
+  for (const Part& part : parts) {
+    hulls.push_back(decomposer.hullVertices(part.triangles));
+  }
+  return hulls;
+}  // computeConvexDecomposition
+
+std::string getConvexDecompositionCacheFilename(
+    const std::string& assetFilename,
+    int maxHulls) {
+  return Cr::Utility::formatString("{}.{}.hulls", assetFilename, maxHulls);
+}
+
+bool loadConvexDecompositionFromCache(const std::string& filename,
+                                      const std::string& assetFilename,
+                                      ConvexDecomposition& hulls) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  if (!assetSize || !data || data->size() < sizeof(HullCacheHeader)) {
+    return false;
+  }
+  HullCacheHeader header;
+  std::memcpy(&header, data->data(), sizeof(HullCacheHeader));
+  const std::size_t vertexOffset =
+      sizeof(HullCacheHeader) + header.hullCount * sizeof(Mn::UnsignedInt);
+  if (std::memcmp(header.magic, hullCacheMagic, sizeof(hullCacheMagic)) ||
+      header.version != hullCacheVersion || header.assetSize != *assetSize ||
+      data->size() !=
+          vertexOffset + header.vertexCount * sizeof(Mn::Vector3)) {
+    return false;
+  }
+
+  ConvexDecomposition loaded(header.hullCount);
+  std::size_t vertexCount = 0;
+  for (Mn::UnsignedInt i = 0; i != header.hullCount; ++i) {
+    Mn::UnsignedInt hullVertexCount;
+    std::memcpy(&hullVertexCount,
+                data->data() + sizeof(HullCacheHeader) +
+                    i * sizeof(Mn::UnsignedInt),
+                sizeof(Mn::UnsignedInt));
+    if (vertexCount + hullVertexCount > header.vertexCount) {
+      return false;
+    }
+    loaded[i].resize(hullVertexCount);
+    std::memcpy(loaded[i].data(),
+                data->data() + vertexOffset + vertexCount * sizeof(Mn::Vector3),
+                hullVertexCount * sizeof(Mn::Vector3));
+    vertexCount += hullVertexCount;
+  }
+  if (vertexCount != header.vertexCount) {
+    return false;
+  }
+  hulls = std::move(loaded);
+  return true;
+}  // loadConvexDecompositionFromCache
+
+bool saveConvexDecompositionToCache(const std::string& filename,
+                                    const std::string& assetFilename,
+                                    const ConvexDecomposition& hulls) {
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  if (!assetSize) {
+    return false;
+  }
+  HullCacheHeader header{};
+  std::memcpy(header.magic, hullCacheMagic, sizeof(hullCacheMagic));
+  header.version = hullCacheVersion;
+  header.assetSize = *assetSize;
+  header.hullCount = hulls.size();
+  for (const auto& hull : hulls) {
+    header.vertexCount += hull.size();
+  }
+  const std::size_t vertexOffset =
+      sizeof(HullCacheHeader) + header.hullCount * sizeof(Mn::UnsignedInt);
+  Cr::Containers::Array<char> data{
+      Cr::ValueInit, vertexOffset + header.vertexCount * sizeof(Mn::Vector3)};
+  std::memcpy(data.data(), &header, sizeof(HullCacheHeader));
+  std::size_t vertexCount = 0;
+  for (std::size_t i = 0; i != hulls.size(); ++i) {
+    const Mn::UnsignedInt hullVertexCount = hulls[i].size();
+    std::memcpy(data.data() + sizeof(HullCacheHeader) +
+                    i * sizeof(Mn::UnsignedInt),
+                &hullVertexCount, sizeof(Mn::UnsignedInt));
+    std::memcpy(data.data() + vertexOffset + vertexCount * sizeof(Mn::Vector3),
+                hulls[i].data(), hullVertexCount * sizeof(Mn::Vector3));
+    vertexCount += hullVertexCount;
+  }
+
+  // other processes may be loading the same asset, so only move the file in
+  // place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&data));
+  return Cr::Utility::Path::write(tmpFilename, data) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveConvexDecompositionToCache
+
+}  // namespace physics
+}  // namespace esp
@@ -0,0 +1,80 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETCONVEXDECOMPOSITION_H_
+#define ESP_PHYSICS_BULLET_BULLETCONVEXDECOMPOSITION_H_
+
+/** @file
+ * @brief Approximate convex decomposition of collision assets and its on-disk
+ * cache, see @ref esp::physics::computeConvexDecomposition
+ */
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <string>
+#include <vector>
+
+#include "esp/assets/CollisionMeshData.h"
+#include "esp/assets/MeshMetaData.h"
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Vertices of each convex hull of a decomposed collision asset
+ */
+typedef std::vector<std::vector<Magnum::Vector3>> ConvexDecomposition;
+
+/**
+ * @brief Approximate a collision asset with at most @p maxHulls convex hulls
+ *
+ * The triangles of all meshes referenced from @p root, transformed into the
+ * asset frame, are recursively split in half along the longest extent of their
+ * centroids. A part is only split while its hull is noticeably larger than
+ * the volume of the mesh it encloses, so convex assets stay a single hull, and
+ * the most concave part is split first. This assumes closed meshes, open ones
+ * are split up to @p maxHulls.
+ * Only the vertices of each hull are kept, which are usually much fewer than
+ * the vertices of the triangles it encloses.
+ */
+ConvexDecomposition computeConvexDecomposition(
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& root,
+    int maxHulls);
+
+/**
+ * @brief Name of the file caching the decomposition of @p assetFilename
+ *
+ * The cache is stored alongside the asset.
+ */
+std::string getConvexDecompositionCacheFilename(
+    const std::string& assetFilename,
+    int maxHulls);
+
+/**
+ * @brief Load a decomposition saved by @ref saveConvexDecompositionToCache
+ *
+ * Returns @cpp false @ce if the file doesn't exist, is corrupted, was written
+ * by a different version of the decomposition or for a different size of
+ * @p assetFilename, in which case the decomposition has to be recomputed.
+ */
+bool loadConvexDecompositionFromCache(const std::string& filename,
+                                      const std::string& assetFilename,
+                                      ConvexDecomposition& hulls);
+
+/**
+ * @brief Save a decomposition of @p assetFilename to a cache file
+ *
+ * Returns @cpp false @ce if the file can't be written, e.g. because the asset
+ * directory is read-only.
+ */
+bool saveConvexDecompositionToCache(const std::string& filename,
+                                    const std::string& assetFilename,
+                                    const ConvexDecomposition& hulls);
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETCONVEXDECOMPOSITION_H_
@@ -7,13 +7,19 @@
 
 #include "BulletPhysicsManager.h"
 
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 #include <utility>
 #include "BulletArticulatedObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletRigidObject.h"
 #include "BulletURDFImporter.h"
+#include "LinearMath/btThreads.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Profiler.h"
 #include "esp/metadata/attributes/PhysicsManagerAttributes.h"
 #include "esp/physics/bullet/BulletRigidStage.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
@@ -24,6 +30,99 @@
 namespace esp {
 namespace physics {
 
+namespace {
+
+/* Bullet has a single task scheduler for the whole process, shared by all
+   physics managers. Returns nullptr if Bullet was built without
+   multithreading support. */
+btITaskScheduler* bulletTaskScheduler() {
+  static btITaskScheduler* scheduler = nullptr;
+  static std::once_flag flag;
+  std::call_once(flag, []() {
+    scheduler = btCreateDefaultTaskScheduler();
+    if (scheduler) {
+      btSetTaskScheduler(scheduler);
+    }
+  });
+  return scheduler;
+}
+
+// Total order on manifolds that doesn't depend on when they were created:
+// the world indices of the two bodies, then the shape parts of the first
+// contact, which tells apart the manifolds of compound children of one pair
+std::array<int, 6> manifoldSortKey(const btPersistentManifold* manifold) {
+  std::array<int, 6> key{manifold->getBody0()->getWorldArrayIndex(),
+                         manifold->getBody1()->getWorldArrayIndex(),
+                         -1,
+                         -1,
+                         -1,
+                         -1};
+  if (manifold->getNumContacts() > 0) {
+    const btManifoldPoint& point = manifold->getContactPoint(0);
+    key[2] = point.m_partId0;
+    key[3] = point.m_index0;
+    key[4] = point.m_partId1;
+    key[5] = point.m_index1;
+  }
+  return key;
+}
+
+/* Collision dispatcher keeping its manifolds in a fixed order. Constraints
+   are solved in manifold order, which for btCollisionDispatcherMt depends on
+   which thread created or released a manifold, and for both dispatchers on
+   the order contacts began. Sorting after each dispatch makes a step depend
+   only on the simulated state, whatever the thread count. */
+template <class Dispatcher>
+class DeterministicCollisionDispatcher : public Dispatcher {
+ public:
+  using Dispatcher::Dispatcher;
+
+  void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,
+                                 const btDispatcherInfo& dispatchInfo,
+                                 btDispatcher* dispatcher) override {
+    Dispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+    auto& manifolds = this->m_manifoldsPtr;
+    if (manifolds.size() == 0) {
+      return;
+    }
+    std::stable_sort(&manifolds[0], &manifolds[0] + manifolds.size(),
+                     [](const btPersistentManifold* a,
+                        const btPersistentManifold* b) {
+                       return manifoldSortKey(a) < manifoldSortKey(b);
+                     });
+    // releaseManifold() relies on each manifold knowing its index
+    for (int i = 0; i < manifolds.size(); ++i) {
+      manifolds[i]->m_index1a = i;
+    }
+  }
+};
+
+// logic copied from btSimulationIslandManager::buildIslands. We count
+// manifolds as active only if related to non-sleeping bodies.
+bool isManifoldActive(const btPersistentManifold& manifold) {
+  const btCollisionObject* colObj0 = manifold.getBody0();
+  const btCollisionObject* colObj1 = manifold.getBody1();
+  return ((colObj0 != nullptr) &&
+          colObj0->getActivationState() != ISLAND_SLEEPING) ||
+         ((colObj1 != nullptr) &&
+          colObj1->getActivationState() != ISLAND_SLEEPING);
+}
+
+ContactEvent makeContactEvent(ContactEventType type,
+                              const std::array<int, 4>& ids,
+                              int numContactPoints) {
+  ContactEvent event;
+  event.type = type;
+  event.objectIdA = ids[0];
+  event.linkIndexA = ids[1];
+  event.objectIdB = ids[2];
+  event.linkIndexB = ids[3];
+  event.numContactPoints = numContactPoints;
+  return event;
+}
+
+}  // namespace
+
 BulletPhysicsManager::BulletPhysicsManager(
     assets::ResourceManager& _resourceManager,
     const metadata::attributes::PhysicsManagerAttributes::cptr&
@@ -31,6 +130,8 @@ BulletPhysicsManager::BulletPhysicsManager(
     : PhysicsManager(_resourceManager, _physicsManagerAttributes) {
   collisionObjToObjIds_ =
       std::make_shared<std::map<const btCollisionObject*, int>>();
+  deferredNodeUpdates_ = std::make_shared<BulletDeferredNodeUpdates>();
+  collisionShapeCache_ = std::make_shared<BulletCollisionShapeCache>();
   urdfImporter_ = std::make_unique<BulletURDFImporter>(_resourceManager);
   if (_resourceManager.getCreateRenderer()) {
     debugDrawer_ = std::make_unique<Magnum::BulletIntegration::DebugDraw>();
@@ -39,7 +140,9 @@ BulletPhysicsManager::BulletPhysicsManager(
 
 BulletPhysicsManager::~BulletPhysicsManager() {
   ESP_DEBUG() << "Deconstructing BulletPhysicsManager";
+  objectPool_.clear();
   existingObjects_.clear();
+  velocityControlTargetsDirty_ = true;
   existingArticulatedObjects_.clear();
   staticStageObject_.reset();
 }
@@ -49,6 +152,9 @@ void BulletPhysicsManager::removeObject(const int objectId,
                                         bool deleteVisualNode) {
   removeObjectRigidConstraints(objectId);
   PhysicsManager::removeObject(objectId, deleteObjectNode, deleteVisualNode);
+  cachedObjectAndLinkIds_.clear();
+  // its contacts get end events on the next substep
+  contactEventObjects_.erase(objectId);
 }
 
 void BulletPhysicsManager::removeArticulatedObject(int objectId) {
@@ -60,16 +166,81 @@ void BulletPhysicsManager::removeArticulatedObject(int objectId) {
 
   removeObjectRigidConstraints(objectId);
   PhysicsManager::removeArticulatedObject(objectId);
+  cachedObjectAndLinkIds_.clear();
+  // its contacts get end events on the next substep
+  contactEventObjects_.erase(objectId);
 }
 
 bool BulletPhysicsManager::initPhysicsFinalize() {
   activePhysSimLib_ = PhysicsSimulationLibrary::Bullet;
 
+  // Collision detection is the only part of a multibody world step Bullet
+  // can spread over several threads, constraints are solved serially
+  const int numThreads = physicsManagerAttributes_->getNumThreads();
+  const bool deterministic = physicsManagerAttributes_->getDeterministic();
+  btITaskScheduler* scheduler =
+      numThreads > 1 ? bulletTaskScheduler() : nullptr;
+  if (scheduler) {
+    scheduler->setNumThreadsToUse(
+        std::min(numThreads, scheduler->getMaxNumThreads()));
+    if (deterministic) {
+      bDispatcher_ = std::make_unique<
+          DeterministicCollisionDispatcher<btCollisionDispatcherMt>>(
+          &bCollisionConfig_);
+    } else {
+      bDispatcher_ =
+          std::make_unique<btCollisionDispatcherMt>(&bCollisionConfig_);
+    }
+  } else {
+    if (numThreads > 1) {
+      ESP_WARNING() << "Bullet was built without multithreading support, "
+                       "ignoring num_threads of"
+                    << numThreads << "and simulating on a single thread.";
+    }
+    if (deterministic) {
+      bDispatcher_ = std::make_unique<
+          DeterministicCollisionDispatcher<btCollisionDispatcher>>(
+          &bCollisionConfig_);
+    } else {
+      bDispatcher_ =
+          std::make_unique<btCollisionDispatcher>(&bCollisionConfig_);
+    }
+  }
+
+  // Sweep and prune pairs objects along the three axes of fixed world bounds,
+  // which can beat the dbvt for large, densely populated stages
+  const std::string broadphase = physicsManagerAttributes_->getBroadphase();
+  if (broadphase == "sap") {
+    bBroadphase_ = std::make_unique<bt32BitAxisSweep3>(
+        btVector3(physicsManagerAttributes_->getBroadphaseWorldMin()),
+        btVector3(physicsManagerAttributes_->getBroadphaseWorldMax()));
+  } else {
+    if (broadphase != "dbvt") {
+      ESP_WARNING() << "Unknown broadphase" << broadphase
+                    << "requested, using \"dbvt\".";
+    }
+    bBroadphase_ = std::make_unique<btDbvtBroadphase>();
+  }
+
   //! We can potentially use other collision checking algorithms, by
   //! uncommenting the line below
-  // btGImpactCollisionAlgorithm::registerAlgorithm(&bDispatcher_);
+  // btGImpactCollisionAlgorithm::registerAlgorithm(bDispatcher_.get());
   bWorld_ = std::make_shared<btMultiBodyDynamicsWorld>(
-      &bDispatcher_, &bBroadphase_, &bSolver_, &bCollisionConfig_);
+      bDispatcher_.get(), bBroadphase_.get(), &bSolver_, &bCollisionConfig_);
+  // Bullet's gContactStartedCallback and gContactEndedCallback are process
+  // globals that can't tell managers stepping in parallel apart, the tick
+  // callback is per world
+  bWorld_->setInternalTickCallback(
+      &BulletPhysicsManager::contactEventTickCallback, this);
+  // Only recompute the broadphase aabbs of active objects each step. Static
+  // and sleeping colliders keep their aabb, so static clutter settles into the
+  // broadphase's fixed tree and is never paired with itself. Every manual pose
+  // change (syncPose, kinematic updates) refreshes the moved aabbs itself.
+  bWorld_->setForceUpdateAllAabbs(false);
+  bWorld_->getSolverInfo().m_numIterations =
+      physicsManagerAttributes_->getSolverIterations();
+  static_cast<BulletURDFImporter*>(urdfImporter_.get())
+      ->setCollisionMargin(physicsManagerAttributes_->getCollisionMargin());
 
   if (debugDrawer_) {
     debugDrawer_->setMode(
@@ -97,6 +268,7 @@ bool BulletPhysicsManager::addStageFinalize(
     const metadata::attributes::StageAttributes::ptr& initAttributes) {
   //! Initialize BulletRigidStage
   bool sceneSuccess = staticStageObject_->initialize(initAttributes);
+  cachedObjectAndLinkIds_.clear();
 
   return sceneSuccess;
 }
@@ -107,10 +279,14 @@ bool BulletPhysicsManager::makeAndAddRigidObject(
     scene::SceneNode* objectNode) {
   auto ptr = physics::BulletRigidObject::create(objectNode, newObjectID,
                                                 resourceManager_, bWorld_,
-                                                collisionObjToObjIds_);
+                                                collisionObjToObjIds_,
+                                                deferredNodeUpdates_,
+                                                collisionShapeCache_);
   bool objSuccess = ptr->initialize(objectAttributes);
+  cachedObjectAndLinkIds_.clear();
   if (objSuccess) {
     existingObjects_.emplace(newObjectID, std::move(ptr));
+    velocityControlTargetsDirty_ = true;
   }
   return objSuccess;
 }
@@ -126,6 +302,9 @@ int BulletPhysicsManager::addArticulatedObjectInternal(
     simulator_->getRenderGLContext();
   }
   const std::string urdfFilepath = artObjAttributes->getURDFPath();
+  // link meshes read ahead by loadURDF() are only needed while adding this
+  // object, unless a whole scene is being loaded from prefetched files
+  const bool hadPrefetchedFiles = resourceManager_.hasPrefetchedFiles();
   // Load model and set active
   ESP_CHECK(urdfImporter_->loadURDF(urdfFilepath, forceReload),
             "failed to parse/load URDF file" << urdfFilepath);
@@ -201,6 +380,9 @@ int BulletPhysicsManager::addArticulatedObjectInternal(
 
   // clear the cache
   u2b->cache = nullptr;
+  if (!hadPrefetchedFiles) {
+    resourceManager_.clearPrefetchedFiles();
+  }
 
   // base collider refers to the articulated object's id
   collisionObjToObjIds_->emplace(
@@ -208,6 +390,7 @@ int BulletPhysicsManager::addArticulatedObjectInternal(
 
   existingArticulatedObjects_.emplace(articulatedObjectID,
                                       std::move(articulatedObject));
+  cachedObjectAndLinkIds_.clear();
 
   // get a simplified name of the handle for the object
   std::string simpleArtObjHandle = artObjAttributes->getSimplifiedHandle();
@@ -381,6 +564,7 @@ Magnum::Vector3 BulletPhysicsManager::getGravity() const {
 }
 
 void BulletPhysicsManager::stepPhysics(double dt) {
+  ESP_PROFILE_SCOPE("BulletPhysicsManager::stepPhysics");
   // We don't step uninitialized physics sim...
   if (!initialized_) {
     return;
@@ -389,37 +573,49 @@ void BulletPhysicsManager::stepPhysics(double dt) {
     dt = fixedTimeStep_;
   }
 
-  // set specified control velocities
-  for (auto& objectItr : existingObjects_) {
-    VelocityControl::ptr velControl = objectItr.second->getVelocityControl();
-    if (objectItr.second->getMotionType() == MotionType::KINEMATIC) {
-      // kinematic velocity control integration
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        objectItr.second->setRigidState(velControl->integrateTransform(
-            dt, objectItr.second->getRigidState()));
-        objectItr.second->setActive(true);
+  // set specified control velocities. Kinematic objects are gathered and
+  // integrated together, dynamic ones get their velocities set directly.
+  velocityControlBatch_.clear();
+  velocityControlBatchObjects_.clear();
+  for (RigidObject* object : velocityControlTargets()) {
+    VelocityControl& velControl = *object->getVelocityControl();
+    if (!velControl.controllingAngVel && !velControl.controllingLinVel) {
+      continue;
+    }
+    if (object->getMotionType() == MotionType::KINEMATIC) {
+      if (VelocityControlBatch::isBatchable(velControl)) {
+        velocityControlBatch_.add(velControl, object->getRigidState());
+        velocityControlBatchObjects_.push_back(object);
+      } else {
+        object->setRigidState(
+            velControl.integrateTransform(dt, object->getRigidState()));
+        object->setActive(true);
       }
-    } else if (objectItr.second->getMotionType() == MotionType::DYNAMIC) {
-      if (velControl->controllingLinVel) {
-        if (velControl->linVelIsLocal) {
-          objectItr.second->setLinearVelocity(
-              objectItr.second->node().rotation().transformVector(
-                  velControl->linVel));
+    } else if (object->getMotionType() == MotionType::DYNAMIC) {
+      if (velControl.controllingLinVel) {
+        if (velControl.linVelIsLocal) {
+          object->setLinearVelocity(
+              object->node().rotation().transformVector(velControl.linVel));
         } else {
-          objectItr.second->setLinearVelocity(velControl->linVel);
+          object->setLinearVelocity(velControl.linVel);
         }
       }
-      if (velControl->controllingAngVel) {
-        if (velControl->angVelIsLocal) {
-          objectItr.second->setAngularVelocity(
-              objectItr.second->node().rotation().transformVector(
-                  velControl->angVel));
+      if (velControl.controllingAngVel) {
+        if (velControl.angVelIsLocal) {
+          object->setAngularVelocity(
+              object->node().rotation().transformVector(velControl.angVel));
         } else {
-          objectItr.second->setAngularVelocity(velControl->angVel);
+          object->setAngularVelocity(velControl.angVel);
         }
       }
     }
   }
+  velocityControlBatch_.integrate(dt);
+  for (std::size_t i = 0; i != velocityControlBatchObjects_.size(); ++i) {
+    velocityControlBatchObjects_[i]->setRigidState(
+        velocityControlBatch_.state(i));
+    velocityControlBatchObjects_[i]->setActive(true);
+  }
 
   // extra step to validate joint states against limits for corrective clamping
   for (auto& objectItr : existingArticulatedObjects_) {
@@ -431,11 +627,187 @@ void BulletPhysicsManager::stepPhysics(double dt) {
 
   // ==== Physics stepforward ======
   // NOTE: worldTime_ will always be a multiple of sceneMetaData_.timestep
+  contactEvents_.clear();
+  const double timeStep = physicsManagerAttributes_->getAdaptiveTimestep()
+                              ? computeAdaptiveTimestep()
+                              : fixedTimeStep_;
+  const int maxSubSteps = physicsManagerAttributes_->getMaxSubsteps() > 0
+                              ? physicsManagerAttributes_->getMaxSubsteps()
+                              : 10000;
+  // Bullet reports the substeps the time asked for, not the clamped count
+  // it took
   int numSubStepsTaken =
-      bWorld_->stepSimulation(dt, /*maxSubSteps*/ 10000, fixedTimeStep_);
-  worldTime_ += numSubStepsTaken * fixedTimeStep_;
+      std::min(bWorld_->stepSimulation(dt, maxSubSteps, timeStep), maxSubSteps);
+  worldTime_ += numSubStepsTaken * timeStep;
   recentNumSubStepsTaken_ = numSubStepsTaken;
-  recentTimeStep_ = fixedTimeStep_;
+  recentTimeStep_ = timeStep;
+  ESP_PROFILE_COUNT("BulletPhysicsManager::substeps", numSubStepsTaken);
+  finishContactEvents();
+}
+
+std::unique_ptr<BulletWorldClone> BulletPhysicsManager::cloneWorld() const {
+  // the constructor is private so clones only come from here
+  return std::unique_ptr<BulletWorldClone>{new BulletWorldClone{*this}};
+}
+
+double BulletPhysicsManager::computeAdaptiveTimestep() {
+  // articulated objects are stiff, simulate them at the configured rate
+  for (int i = 0; i < bWorld_->getNumMultibodies(); ++i) {
+    if (bWorld_->getMultiBody(i)->isAwake()) {
+      return fixedTimeStep_;
+    }
+  }
+  if (getNumActiveContactPoints() >
+      physicsManagerAttributes_->getAdaptiveMaxContacts()) {
+    return fixedTimeStep_;
+  }
+
+  // fastest point of any active body, bounded by its linear speed plus its
+  // angular speed over its bounding sphere
+  btScalar maxSpeed = 0;
+  const auto& colObjs = bWorld_->getCollisionObjectArray();
+  for (int i = 0; i < colObjs.size(); ++i) {
+    const btRigidBody* body = btRigidBody::upcast(colObjs[i]);
+    if (!body || !body->isActive() || body->isStaticOrKinematicObject()) {
+      continue;
+    }
+    btVector3 center;
+    btScalar radius = 0;
+    body->getCollisionShape()->getBoundingSphere(center, radius);
+    maxSpeed = std::max(maxSpeed, body->getLinearVelocity().length() +
+                                      body->getAngularVelocity().length() *
+                                          (center.length() + radius));
+  }
+
+  const double maxTimeStep = std::max(
+      physicsManagerAttributes_->getAdaptiveMaxTimestep(), fixedTimeStep_);
+  double timeStep = maxTimeStep;
+  if (maxSpeed > 0) {
+    timeStep = std::min(
+        timeStep, physicsManagerAttributes_->getAdaptiveMaxTravel() / maxSpeed);
+  }
+  // keep the world time a multiple of the configured timestep, the epsilon
+  // keeps exact multiples from rounding down
+  return std::max(1.0, std::floor(timeStep / fixedTimeStep_ + 1.0e-6)) *
+         fixedTimeStep_;
+}
+
+void BulletPhysicsManager::subscribeContactEvents(const int objectId) {
+  ESP_CHECK(objectId == RIGID_STAGE_ID ||
+                existingObjects_.count(objectId) != 0u ||
+                existingArticulatedObjects_.count(objectId) != 0u,
+            "BulletPhysicsManager::subscribeContactEvents(): no object with id"
+                << objectId);
+  contactEventObjects_.insert(objectId);
+}
+
+void BulletPhysicsManager::unsubscribeContactEvents(const int objectId) {
+  if (contactEventObjects_.erase(objectId) == 0) {
+    return;
+  }
+  for (auto it = activeContacts_.begin(); it != activeContacts_.end();) {
+    const std::array<int, 4>& key = it->first;
+    if (contactEventObjects_.count(key[0]) == 0 &&
+        contactEventObjects_.count(key[2]) == 0) {
+      it = activeContacts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void BulletPhysicsManager::contactEventTickCallback(btDynamicsWorld* world,
+                                                    btScalar) {
+  static_cast<BulletPhysicsManager*>(world->getWorldUserInfo())
+      ->updateContactEvents();
+}
+
+void BulletPhysicsManager::updateContactEvents() {
+  if (contactEventObjects_.empty() && activeContacts_.empty()) {
+    return;
+  }
+
+  substepContacts_.clear();
+  auto* dispatcher = bWorld_->getDispatcher();
+  const int numContactManifolds = dispatcher->getNumManifolds();
+  for (int i = 0; i < numContactManifolds; ++i) {
+    const btPersistentManifold* manifold =
+        dispatcher->getInternalManifoldPointer()[i];
+    if (manifold->getNumContacts() == 0) {
+      continue;
+    }
+    const std::pair<int, int>& idsA =
+        cachedObjectIdAndLinkId(manifold->getBody0());
+    const std::pair<int, int>& idsB =
+        cachedObjectIdAndLinkId(manifold->getBody1());
+    if (contactEventObjects_.count(idsA.first) == 0 &&
+        contactEventObjects_.count(idsB.first) == 0) {
+      continue;
+    }
+    // several manifolds can map to the same pair, e.g. for stage subparts
+    const std::array<int, 4> key =
+        idsA < idsB ? std::array<int, 4>{idsA.first, idsA.second, idsB.first,
+                                         idsB.second}
+                    : std::array<int, 4>{idsB.first, idsB.second, idsA.first,
+                                         idsA.second};
+    substepContacts_[key].numContactPoints += manifold->getNumContacts();
+  }
+
+  for (auto& contact : substepContacts_) {
+    auto found = activeContacts_.find(contact.first);
+    if (found == activeContacts_.end()) {
+      contactEvents_.push_back(makeContactEvent(
+          ContactEventType::Begin, contact.first,
+          contact.second.numContactPoints));
+      contact.second.begunThisStep = true;
+    } else {
+      contact.second.begunThisStep = found->second.begunThisStep;
+    }
+  }
+  for (const auto& contact : activeContacts_) {
+    if (substepContacts_.count(contact.first) == 0) {
+      contactEvents_.push_back(
+          makeContactEvent(ContactEventType::End, contact.first, 0));
+    }
+  }
+  std::swap(activeContacts_, substepContacts_);
+}
+
+void BulletPhysicsManager::finishContactEvents() {
+  for (auto& contact : activeContacts_) {
+    if (!contact.second.begunThisStep) {
+      contactEvents_.push_back(
+          makeContactEvent(ContactEventType::Persist, contact.first,
+                           contact.second.numContactPoints));
+    }
+    contact.second.begunThisStep = false;
+  }
+  if (contactEventCallback_ && !contactEvents_.empty()) {
+    contactEventCallback_(contactEvents_);
+  }
+}
+
+void BulletPhysicsManager::deferNodesUpdate() {
+  deferredNodeUpdates_->deferring = true;
+  for (auto& ao : existingArticulatedObjects_) {
+    ao.second->deferUpdate();
+  }
+}
+
+void BulletPhysicsManager::updateNodes() {
+  deferredNodeUpdates_->deferring = false;
+  // only objects that were awake got a new transform while deferring
+  for (const int objectId : deferredNodeUpdates_->objectIds) {
+    auto objectIter = existingObjects_.find(objectId);
+    if (objectIter != existingObjects_.end()) {
+      objectIter->second->updateNodes();
+    }
+  }
+  deferredNodeUpdates_->objectIds.clear();
+
+  for (auto& ao : existingArticulatedObjects_) {
+    ao.second->updateNodes();
+  }
 }
 
 void BulletPhysicsManager::setStageFrictionCoefficient(
@@ -491,6 +863,7 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
   bWorld_->rayTest(from, to, allResults);
 
   // convert to RaycastResults
+  results.hits.reserve(allResults.m_hitPointWorld.size());
   for (int i = 0; i < allResults.m_hitPointWorld.size(); ++i) {
     RayHitInfo hit;
 
@@ -512,6 +885,290 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
   return results;
 }
 
+void BulletPhysicsManager::castRaysInternal(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    double maxDistance,
+    std::size_t maxHitsPerRay,
+    Corrade::Containers::ArrayView<float> distances,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+    Corrade::Containers::ArrayView<int> hitCounts) {
+  /* Bullet keeps a ray test stack per scheduler thread, so the world can be
+     queried concurrently as long as nothing modifies it. The task scheduler
+     threads are used instead of our own as Bullet never recycles the indices
+     it assigns to threads. */
+  struct RayBatch : btIParallelForBody {
+    void forLoop(int begin, int end) const override {
+      std::vector<int> order;
+      for (int i = begin; i != end; ++i) {
+        if (directions[i].isZero()) {
+          continue;
+        }
+        const btVector3 from(origins[i]);
+        const btVector3 to(origins[i] + directions[i] * maxDistance);
+        const std::size_t first = i * maxHitsPerRay;
+        if (hitCounts.isEmpty()) {
+          btCollisionWorld::ClosestRayResultCallback closest(from, to);
+          world->rayTest(from, to, closest);
+          if (closest.hasHit()) {
+            writeHit(first, closest.m_closestHitFraction,
+                     closest.m_collisionObject, closest.m_hitNormalWorld);
+          }
+          continue;
+        }
+
+        btCollisionWorld::AllHitsRayResultCallback all(from, to);
+        world->rayTest(from, to, all);
+        order.resize(all.m_hitFractions.size());
+        for (std::size_t hit = 0; hit != order.size(); ++hit) {
+          order[hit] = int(hit);
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+          return all.m_hitFractions[a] < all.m_hitFractions[b];
+        });
+        const std::size_t count = std::min(order.size(), maxHitsPerRay);
+        for (std::size_t hit = 0; hit != count; ++hit) {
+          const int index = order[hit];
+          writeHit(first + hit, all.m_hitFractions[index],
+                   all.m_collisionObjects[index],
+                   all.m_hitNormalWorld[index]);
+        }
+        hitCounts[i] = int(count);
+      }
+    }
+
+    void writeHit(std::size_t slot,
+                  btScalar fraction,
+                  const btCollisionObject* object,
+                  const btVector3& normal) const {
+      distances[slot] = float(double(fraction) * maxDistance);
+      // default to RIGID_STAGE_ID for "scene collision" if we don't know
+      // which object was involved
+      auto objectIdIter = collisionObjToObjIds->find(object);
+      objectIds[slot] = objectIdIter != collisionObjToObjIds->end()
+                            ? objectIdIter->second
+                            : RIGID_STAGE_ID;
+      if (!normals.isEmpty()) {
+        normals[slot] = Magnum::Vector3{normal};
+      }
+    }
+
+    const btCollisionWorld* world = nullptr;
+    const std::map<const btCollisionObject*, int>* collisionObjToObjIds =
+        nullptr;
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins;
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions;
+    double maxDistance = 0.0;
+    std::size_t maxHitsPerRay = 1;
+    Corrade::Containers::ArrayView<float> distances;
+    Corrade::Containers::ArrayView<int> objectIds;
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals;
+    Corrade::Containers::ArrayView<int> hitCounts;
+  };
+
+  RayBatch batch;
+  batch.world = bWorld_.get();
+  batch.collisionObjToObjIds = collisionObjToObjIds_.get();
+  batch.origins = origins;
+  batch.directions = directions;
+  batch.maxDistance = maxDistance;
+  batch.maxHitsPerRay = maxHitsPerRay;
+  batch.distances = distances;
+  batch.objectIds = objectIds;
+  batch.normals = normals;
+  batch.hitCounts = hitCounts;
+  // small enough to balance lidar scans with many misses and few expensive
+  // mesh hits
+  constexpr int RaysPerTask = 64;
+  btParallelFor(0, int(origins.size()), RaysPerTask, batch);
+}
+
+RaycastResults BulletPhysicsManager::castCapsule(const esp::geo::Ray& ray,
+                                                 float radius,
+                                                 float height,
+                                                 double maxDistance) {
+  RaycastResults results;
+  results.ray = ray;
+  if (ray.direction.isZero()) {
+    ESP_ERROR() << "Cannot sweep a capsule with zero length, aborting.";
+    return results;
+  }
+  if (radius <= 0.0f || height < 0.0f) {
+    ESP_ERROR() << "Expected a positive capsule radius and a non-negative "
+                   "height but got"
+                << radius << "and" << height << Mn::Debug::nospace
+                << ", aborting.";
+    return results;
+  }
+  btCapsuleShape capsule(radius, height);
+  const btTransform from(btQuaternion::getIdentity(), btVector3(ray.origin));
+  const btTransform to(btQuaternion::getIdentity(),
+                       btVector3(ray.origin + ray.direction * maxDistance));
+  btCollisionWorld::ClosestConvexResultCallback closest(from.getOrigin(),
+                                                        to.getOrigin());
+  bWorld_->convexSweepTest(&capsule, from, to, closest);
+  if (closest.hasHit()) {
+    RayHitInfo hit;
+    hit.normal = Magnum::Vector3{closest.m_hitNormalWorld};
+    hit.point = Magnum::Vector3{closest.m_hitPointWorld};
+    hit.rayDistance =
+        static_cast<double>(closest.m_closestHitFraction) * maxDistance;
+    // default to RIGID_STAGE_ID for "scene collision" if we don't know which
+    // object was involved
+    hit.objectId = RIGID_STAGE_ID;
+    auto rawColObjIdIter =
+        collisionObjToObjIds_->find(closest.m_hitCollisionObject);
+    if (rawColObjIdIter != collisionObjToObjIds_->end()) {
+      hit.objectId = rawColObjIdIter->second;
+    }
+    results.hits.push_back(hit);
+  }
+  return results;
+}
+
+void BulletPhysicsManager::castCapsulesInternal(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+    float radius,
+    float height,
+    double maxDistance,
+    Corrade::Containers::ArrayView<float> distances,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals) {
+  /* Like the ray tests in castRaysInternal(), sweep tests only read the world
+     and use per-thread broadphase stacks, and the shared capsule shape is
+     never modified. */
+  struct SweepBatch : btIParallelForBody {
+    void forLoop(int begin, int end) const override {
+      for (int i = begin; i != end; ++i) {
+        if (directions[i].isZero()) {
+          continue;
+        }
+        const btTransform from(btQuaternion::getIdentity(),
+                               btVector3(origins[i]));
+        const btTransform to(
+            btQuaternion::getIdentity(),
+            btVector3(origins[i] + directions[i] * maxDistance));
+        btCollisionWorld::ClosestConvexResultCallback closest(
+            from.getOrigin(), to.getOrigin());
+        world->convexSweepTest(capsule, from, to, closest);
+        if (!closest.hasHit()) {
+          continue;
+        }
+        distances[i] =
+            float(double(closest.m_closestHitFraction) * maxDistance);
+        // default to RIGID_STAGE_ID for "scene collision" if we don't know
+        // which object was involved
+        auto objectIdIter =
+            collisionObjToObjIds->find(closest.m_hitCollisionObject);
+        objectIds[i] = objectIdIter != collisionObjToObjIds->end()
+                           ? objectIdIter->second
+                           : RIGID_STAGE_ID;
+        if (!normals.isEmpty()) {
+          normals[i] = Magnum::Vector3{closest.m_hitNormalWorld};
+        }
+      }
+    }
+
+    const btCollisionWorld* world = nullptr;
+    const btConvexShape* capsule = nullptr;
+    const std::map<const btCollisionObject*, int>* collisionObjToObjIds =
+        nullptr;
+    Corrade::Containers::ArrayView<const Magnum::Vector3> origins;
+    Corrade::Containers::ArrayView<const Magnum::Vector3> directions;
+    double maxDistance = 0.0;
+    Corrade::Containers::ArrayView<float> distances;
+    Corrade::Containers::ArrayView<int> objectIds;
+    Corrade::Containers::ArrayView<Magnum::Vector3> normals;
+  };
+
+  btCapsuleShape capsule(radius, height);
+  SweepBatch batch;
+  batch.world = bWorld_.get();
+  batch.capsule = &capsule;
+  batch.collisionObjToObjIds = collisionObjToObjIds_.get();
+  batch.origins = origins;
+  batch.directions = directions;
+  batch.maxDistance = maxDistance;
+  batch.distances = distances;
+  batch.objectIds = objectIds;
+  batch.normals = normals;
+  // sweeps are a lot more expensive than rays, so use smaller tasks
+  constexpr int SweepsPerTask = 16;
+  btParallelFor(0, int(origins.size()), SweepsPerTask, batch);
+}
+
+void BulletPhysicsManager::queryOverlapsInternal(
+    Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> centers,
+    Corrade::Containers::ArrayView<const float> radii,
+    std::size_t maxOverlapsPerQuery,
+    Corrade::Containers::ArrayView<int> objectIds,
+    Corrade::Containers::ArrayView<int> linkIds,
+    Corrade::Containers::ArrayView<int> overlapCounts) {
+  struct ProxyCollector : btBroadphaseAabbCallback {
+    bool process(const btBroadphaseProxy* proxy) override {
+      proxies.push_back(proxy);
+      return true;
+    }
+    std::vector<const btBroadphaseProxy*> proxies;
+  };
+
+  // objects moved since the last step, e.g. kinematically, have stale
+  // broadphase bounds otherwise
+  bWorld_->updateAabbs();
+
+  const bool spheres = boxes.isEmpty();
+  const std::size_t queryCount = spheres ? centers.size() : boxes.size();
+  ProxyCollector collector;
+  std::vector<std::pair<int, int>> overlaps;
+  for (std::size_t i = 0; i != queryCount; ++i) {
+    btVector3 min, max;
+    if (spheres) {
+      min = btVector3(centers[i] - Magnum::Vector3{radii[i]});
+      max = btVector3(centers[i] + Magnum::Vector3{radii[i]});
+    } else {
+      min = btVector3(boxes[i].min());
+      max = btVector3(boxes[i].max());
+    }
+    collector.proxies.clear();
+    bBroadphase_->aabbTest(min, max, collector);
+
+    overlaps.clear();
+    for (const btBroadphaseProxy* proxy : collector.proxies) {
+      if (spheres) {
+        // the broadphase test above is against the bounds of the sphere, so
+        // drop bounding boxes only reaching into its corners
+        const btVector3 center(centers[i]);
+        btVector3 closest = center;
+        closest.setMax(proxy->m_aabbMin);
+        closest.setMin(proxy->m_aabbMax);
+        if (closest.distance2(center) > radii[i] * radii[i]) {
+          continue;
+        }
+      }
+      const std::pair<int, int>& ids = cachedObjectIdAndLinkId(
+          static_cast<const btCollisionObject*>(proxy->m_clientObject));
+      if (ids.first != RIGID_STAGE_ID) {
+        overlaps.push_back(ids);
+      }
+    }
+    // an object may own more than one collision object, e.g. a fixed base
+    std::sort(overlaps.begin(), overlaps.end());
+    overlaps.erase(std::unique(overlaps.begin(), overlaps.end()),
+                   overlaps.end());
+
+    const std::size_t count = std::min(overlaps.size(), maxOverlapsPerQuery);
+    const std::size_t offset = i * maxOverlapsPerQuery;
+    for (std::size_t j = 0; j != count; ++j) {
+      objectIds[offset + j] = overlaps[j].first;
+      linkIds[offset + j] = overlaps[j].second;
+    }
+    overlapCounts[i] = int(count);
+  }
+}
+
 void BulletPhysicsManager::lookUpObjectIdAndLinkId(
     const btCollisionObject* colObj,
     int* objectId,
@@ -545,6 +1202,53 @@ void BulletPhysicsManager::lookUpObjectIdAndLinkId(
   // lookup failed
 }
 
+const std::pair<int, int>& BulletPhysicsManager::cachedObjectIdAndLinkId(
+    const btCollisionObject* colObj) const {
+  auto found = cachedObjectAndLinkIds_.find(colObj);
+  if (found == cachedObjectAndLinkIds_.end()) {
+    std::pair<int, int> ids{ID_UNDEFINED, -1};
+    lookUpObjectIdAndLinkId(colObj, &ids.first, &ids.second);
+    found = cachedObjectAndLinkIds_.emplace(colObj, ids).first;
+  }
+  return found->second;
+}
+
+void BulletPhysicsManager::appendContactPoints(
+    const btPersistentManifold& manifold,
+    const std::pair<int, int>& idsA,
+    const std::pair<int, int>& idsB,
+    const bool isActive,
+    std::vector<ContactPointData>& contactPoints) const {
+  for (int p = 0; p < manifold.getNumContacts(); ++p) {
+    ContactPointData pt;
+    pt.objectIdA = idsA.first;
+    pt.objectIdB = idsB.first;
+    const btManifoldPoint& srcPt = manifold.getContactPoint(p);
+    pt.contactDistance = static_cast<double>(srcPt.getDistance());
+    pt.linkIndexA = idsA.second;
+    pt.linkIndexB = idsB.second;
+    pt.contactNormalOnBInWS = Mn::Vector3(srcPt.m_normalWorldOnB);
+    pt.positionOnAInWS = Mn::Vector3(srcPt.getPositionWorldOnA());
+    pt.positionOnBInWS = Mn::Vector3(srcPt.getPositionWorldOnB());
+
+    // convert impulses to forces w/ recent physics timestep
+    pt.normalForce =
+        static_cast<double>(srcPt.getAppliedImpulse()) / recentTimeStep_;
+
+    pt.linearFrictionForce1 =
+        static_cast<double>(srcPt.m_appliedImpulseLateral1) / recentTimeStep_;
+    pt.linearFrictionForce2 =
+        static_cast<double>(srcPt.m_appliedImpulseLateral2) / recentTimeStep_;
+
+    pt.linearFrictionDirection1 = Mn::Vector3(srcPt.m_lateralFrictionDir1);
+    pt.linearFrictionDirection2 = Mn::Vector3(srcPt.m_lateralFrictionDir2);
+
+    pt.isActive = isActive;
+
+    contactPoints.push_back(pt);
+  }
+}
+
 std::vector<ContactPointData> BulletPhysicsManager::getContactPoints() const {
   std::vector<ContactPointData> contactPoints;
 
@@ -554,60 +1258,45 @@ std::vector<ContactPointData> BulletPhysicsManager::getContactPoints() const {
   for (int i = 0; i < numContactManifolds; ++i) {
     const btPersistentManifold* manifold =
         dispatcher->getInternalManifoldPointer()[i];
+    appendContactPoints(
+        *manifold, cachedObjectIdAndLinkId(manifold->getBody0()),
+        cachedObjectIdAndLinkId(manifold->getBody1()),
+        isManifoldActive(*manifold), contactPoints);
+  }
 
-    int objectIdA = ID_UNDEFINED;
-    int objectIdB = ID_UNDEFINED;
-    int linkIndexA = -1;  // -1 if not a multibody
-    int linkIndexB = -1;
-
-    const btCollisionObject* colObj0 = manifold->getBody0();
-    const btCollisionObject* colObj1 = manifold->getBody1();
-
-    lookUpObjectIdAndLinkId(colObj0, &objectIdA, &linkIndexA);
-    lookUpObjectIdAndLinkId(colObj1, &objectIdB, &linkIndexB);
-
-    // logic copied from btSimulationIslandManager::buildIslands. We count
-    // manifolds as active only if related to non-sleeping bodies.
-    bool isActive = ((((colObj0) != nullptr) &&
-                      colObj0->getActivationState() != ISLAND_SLEEPING) ||
-                     (((colObj1) != nullptr) &&
-                      colObj1->getActivationState() != ISLAND_SLEEPING));
-
-    for (int p = 0; p < manifold->getNumContacts(); ++p) {
-      ContactPointData pt;
-      pt.objectIdA = objectIdA;
-      pt.objectIdB = objectIdB;
-      const btManifoldPoint& srcPt = manifold->getContactPoint(p);
-      pt.contactDistance = static_cast<double>(srcPt.getDistance());
-      pt.linkIndexA = linkIndexA;
-      pt.linkIndexB = linkIndexB;
-      pt.contactNormalOnBInWS = Mn::Vector3(srcPt.m_normalWorldOnB);
-      pt.positionOnAInWS = Mn::Vector3(srcPt.getPositionWorldOnA());
-      pt.positionOnBInWS = Mn::Vector3(srcPt.getPositionWorldOnB());
-
-      // convert impulses to forces w/ recent physics timestep
-      pt.normalForce =
-          static_cast<double>(srcPt.getAppliedImpulse()) / recentTimeStep_;
-
-      pt.linearFrictionForce1 =
-          static_cast<double>(srcPt.m_appliedImpulseLateral1) / recentTimeStep_;
-      pt.linearFrictionForce2 =
-          static_cast<double>(srcPt.m_appliedImpulseLateral2) / recentTimeStep_;
-
-      pt.linearFrictionDirection1 = Mn::Vector3(srcPt.m_lateralFrictionDir1);
-      pt.linearFrictionDirection2 = Mn::Vector3(srcPt.m_lateralFrictionDir2);
+  return contactPoints;
+}
 
-      pt.isActive = isActive;
+void BulletPhysicsManager::getContactPoints(
+    const ContactPointFilter& filter,
+    std::vector<ContactPointData>& contactPoints) const {
+  contactPoints.clear();
 
-      contactPoints.push_back(pt);
+  auto* dispatcher = bWorld_->getDispatcher();
+  const int numContactManifolds = dispatcher->getNumManifolds();
+  for (int i = 0; i < numContactManifolds; ++i) {
+    const btPersistentManifold* manifold =
+        dispatcher->getInternalManifoldPointer()[i];
+    // cheapest checks first, most manifolds of a resting scene are inactive
+    // or between objects the caller doesn't care about
+    if (manifold->getNumContacts() == 0) {
+      continue;
+    }
+    const bool isActive = isManifoldActive(*manifold);
+    if (filter.activeOnly && !isActive) {
+      continue;
     }
+    const std::pair<int, int>& idsA =
+        cachedObjectIdAndLinkId(manifold->getBody0());
+    const std::pair<int, int>& idsB =
+        cachedObjectIdAndLinkId(manifold->getBody1());
+    if (!filter.matches(idsA.first, idsA.second, idsB.first, idsB.second)) {
+      continue;
+    }
+    appendContactPoints(*manifold, idsA, idsB, isActive, contactPoints);
   }
-
-  return contactPoints;
 }
 
-//============ Rigid Constraints =============
-
 int BulletPhysicsManager::createRigidConstraint(
     const RigidConstraintSettings& settings) {
   auto rigidObjAIter = existingObjects_.find(settings.objectIdA);
@@ -722,6 +1411,7 @@ int BulletPhysicsManager::createRigidConstraint(
                                                     btVector3(settings.pivotA),
                                                     btVector3(settings.pivotB));
       bWorld_->addConstraint(p2p.get());
+      enableRigidConstraintFeedback(*p2p, nextConstraintId_);
       rigidP2PConstraints_.emplace(nextConstraintId_, std::move(p2p));
     } else {
       // fixed
@@ -733,6 +1423,7 @@ int BulletPhysicsManager::createRigidConstraint(
               btTransform(btMatrix3x3(settings.frameB),
                           btVector3(settings.pivotB)));
       bWorld_->addConstraint(fixedConstraint.get());
+      enableRigidConstraintFeedback(*fixedConstraint, nextConstraintId_);
       rigidFixedConstraints_.emplace(nextConstraintId_,
                                      std::move(fixedConstraint));
     }
@@ -783,6 +1474,98 @@ void BulletPhysicsManager::updateRigidConstraint(
                 << int(settings.constraintType) << " vs."
                 << int(cachedSettings.constraintType) << ")");
 
+  applyRigidConstraintSettings(constraintId, cachedSettings, settings);
+  // cache the new settings
+  cachedSettings = settings;
+}
+
+void BulletPhysicsManager::updateRigidConstraintsInternal(
+    Corrade::Containers::ArrayView<const int> constraintIds,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+    Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+    Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+    Corrade::Containers::ArrayView<const float> maxImpulses) {
+  // object, link and type ids can't be changed through the batch API, so
+  // only the constraint id needs validating
+  for (std::size_t i = 0; i != constraintIds.size(); ++i) {
+    const int constraintId = constraintIds[i];
+    auto rigidConstraintCacheIter = rigidConstraintSettings_.find(constraintId);
+    ESP_CHECK(rigidConstraintCacheIter != rigidConstraintSettings_.end(),
+              "::updateRigidConstraints - Provided invalid constraintId ="
+                  << constraintId);
+    auto& cachedSettings = rigidConstraintCacheIter->second;
+    RigidConstraintSettings settings = cachedSettings;
+    if (!pivotsA.isEmpty()) {
+      settings.pivotA = pivotsA[i];
+    }
+    if (!pivotsB.isEmpty()) {
+      settings.pivotB = pivotsB[i];
+    }
+    if (!framesA.isEmpty()) {
+      settings.frameA = framesA[i];
+    }
+    if (!framesB.isEmpty()) {
+      settings.frameB = framesB[i];
+    }
+    if (!maxImpulses.isEmpty()) {
+      settings.maxImpulse = maxImpulses[i];
+    }
+    applyRigidConstraintSettings(constraintId, cachedSettings, settings);
+    cachedSettings = settings;
+  }
+}
+
+void BulletPhysicsManager::getRigidConstraintForcesInternal(
+    Corrade::Containers::ArrayView<const int> constraintIds,
+    Corrade::Containers::ArrayView<float> forces) {
+  for (std::size_t i = 0; i != constraintIds.size(); ++i) {
+    const int constraintId = constraintIds[i];
+    btMultiBodyConstraint* multiBodyConstraint = nullptr;
+    auto articulatedP2PConstraintIter =
+        articulatedP2PConstraints_.find(constraintId);
+    if (articulatedP2PConstraintIter != articulatedP2PConstraints_.end()) {
+      multiBodyConstraint = articulatedP2PConstraintIter->second.get();
+    } else {
+      auto articulatedFixedConstraintIter =
+          articulatedFixedConstraints_.find(constraintId);
+      if (articulatedFixedConstraintIter !=
+          articulatedFixedConstraints_.end()) {
+        multiBodyConstraint = articulatedFixedConstraintIter->second.get();
+      }
+    }
+
+    if (multiBodyConstraint != nullptr) {
+      // the first three rows of both multibody constraint types are the
+      // linear ones, their impulses are from the last substep
+      btVector3 impulse{multiBodyConstraint->getAppliedImpulse(0),
+                        multiBodyConstraint->getAppliedImpulse(1),
+                        multiBodyConstraint->getAppliedImpulse(2)};
+      forces[i] = float(impulse.length() / fixedTimeStep_);
+      continue;
+    }
+
+    auto feedbackIter = rigidConstraintFeedback_.find(constraintId);
+    ESP_CHECK(feedbackIter != rigidConstraintFeedback_.end(),
+              "::getRigidConstraintForces - Provided invalid constraintId ="
+                  << constraintId);
+    forces[i] = float(feedbackIter->second->m_appliedForceBodyA.length());
+  }
+}
+
+void BulletPhysicsManager::enableRigidConstraintFeedback(
+    btTypedConstraint& constraint,
+    int constraintId) {
+  auto feedback = std::make_unique<btJointFeedback>();
+  constraint.setJointFeedback(feedback.get());
+  constraint.enableFeedback(true);
+  rigidConstraintFeedback_[constraintId] = std::move(feedback);
+}
+
+void BulletPhysicsManager::applyRigidConstraintSettings(
+    int constraintId,
+    const RigidConstraintSettings& cachedSettings,
+    const RigidConstraintSettings& settings) {
   auto articulatedP2PConstraintIter =
       articulatedP2PConstraints_.find(constraintId);
 
@@ -845,8 +1628,6 @@ void BulletPhysicsManager::updateRigidConstraint(
       }
     }
   }
-  // cache the new settings
-  rigidConstraintSettings_[constraintId] = settings;
 }
 
 void BulletPhysicsManager::removeRigidConstraint(int constraintId) {
@@ -883,6 +1664,7 @@ void BulletPhysicsManager::removeRigidConstraint(int constraintId) {
     }
   }
   rigidConstraintSettings_.erase(constraintId);
+  rigidConstraintFeedback_.erase(constraintId);
   // remove the constraint from any referencing object maps
   for (auto& itr : objectConstraints_) {
     auto conIdItr =
@@ -912,6 +1694,65 @@ void BulletPhysicsManager::removeRigidConstraint(int constraintId) {
   }
 }
 
+namespace {
+
+std::size_t collisionShapeMemoryUsage(
+    const btCollisionShape* shape,
+    std::unordered_set<const void*>& visited) {
+  if (!shape || !visited.insert(shape).second) {
+    return 0;
+  }
+  std::size_t usage = 0;
+  switch (shape->getShapeType()) {
+    case COMPOUND_SHAPE_PROXYTYPE: {
+      const auto* compound = static_cast<const btCompoundShape*>(shape);
+      usage += sizeof(btCompoundShape) +
+               compound->getNumChildShapes() * sizeof(btCompoundShapeChild);
+      for (int i = 0; i < compound->getNumChildShapes(); ++i) {
+        usage += collisionShapeMemoryUsage(compound->getChildShape(i),
+                                           visited);
+      }
+      break;
+    }
+    case CONVEX_HULL_SHAPE_PROXYTYPE:
+      usage += sizeof(btConvexHullShape) +
+               static_cast<const btConvexHullShape*>(shape)->getNumPoints() *
+                   sizeof(btVector3);
+      break;
+    case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+      usage += sizeof(btBvhTriangleMeshShape);
+      // BVHs may be shared between shapes of the same mesh
+      const btOptimizedBvh* bvh =
+          const_cast<btBvhTriangleMeshShape*>(
+              static_cast<const btBvhTriangleMeshShape*>(shape))
+              ->getOptimizedBvh();
+      if (bvh && visited.insert(bvh).second) {
+        usage += bvh->calculateSerializeBufferSize();
+      }
+      break;
+    }
+    default:
+      // primitives only store a few scalars
+      usage += sizeof(btConvexInternalShape);
+  }
+  return usage;
+}
+
+}  // namespace
+
+std::size_t BulletPhysicsManager::getMemoryUsage() const {
+  const btCollisionObjectArray& objects = bWorld_->getCollisionObjectArray();
+  std::unordered_set<const void*> visited;
+  std::size_t usage = 0;
+  for (int i = 0; i < objects.size(); ++i) {
+    usage += btRigidBody::upcast(objects[i]) ? sizeof(btRigidBody)
+                                             : sizeof(btCollisionObject);
+    usage += collisionShapeMemoryUsage(objects[i]->getCollisionShape(),
+                                       visited);
+  }
+  return usage;
+}  // BulletPhysicsManager::getMemoryUsage
+
 void BulletPhysicsManager::instantiateSkinnedModel(
     const BulletArticulatedObject::ptr& ao,
     const esp::metadata::attributes::ArticulatedObjectAttributes::ptr&
@@ -9,6 +9,10 @@
  * @brief Class @ref esp::physics::BulletPhysicsManager
  */
 
+#include <array>
+#include <map>
+#include <unordered_set>
+
 /* Bullet Physics Integration */
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
@@ -25,6 +29,7 @@
 #include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
 #include "esp/physics/PhysicsManager.h"
 #include "esp/physics/bullet/BulletArticulatedObject.h"
+#include "esp/physics/bullet/BulletWorldClone.h"
 
 namespace esp {
 namespace physics {
@@ -44,6 +49,8 @@ handles most of the specific implementations for object interactions with
 Bullet.
 */
 class BulletPhysicsManager : public PhysicsManager {
+  friend class BulletWorldClone;
+
  public:
   /**
    * @brief Construct a @ref BulletPhysicsManager with access to specific
@@ -105,6 +112,41 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   void stepPhysics(double dt) override;
 
+  /**
+   * @brief Get the number of fixed substeps the most recent @ref stepPhysics
+   * took, -1 if there was none since the last discrete collision detection.
+   */
+  int getRecentNumSubStepsTaken() const { return recentNumSubStepsTaken_; }
+
+  /**
+   * @brief Get the substep size used by the most recent @ref stepPhysics,
+   * which differs from the timestep with the adaptive timestep enabled.
+   */
+  double getRecentTimeStep() const { return recentTimeStep_; }
+
+  /**
+   * @brief Fork the current dynamics state into an independent world.
+   *
+   * Duplicates the bodies, multibodies and constraints of the world while
+   * sharing their collision shapes and leaving out the scene graph, so the
+   * copies can be rolled forward in parallel, e.g. for lookahead planning.
+   * See @ref BulletWorldClone for what is and isn't copied.
+   */
+  std::unique_ptr<BulletWorldClone> cloneWorld() const;
+
+  /**
+   * @brief Override of @ref PhysicsManager::deferNodesUpdate that flags all
+   * rigid objects at once instead of one by one.
+   */
+  void deferNodesUpdate() override;
+
+  /**
+   * @brief Override of @ref PhysicsManager::updateNodes that only visits the
+   * rigid objects Bullet moved since @ref deferNodesUpdate, skipping the
+   * sleeping ones.
+   */
+  void updateNodes() override;
+
   /** @brief Set the gravity of the physical world.
    * @param gravity The desired gravity force of the physical world.
    */
@@ -185,6 +227,32 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   std::vector<ContactPointData> getContactPoints() const override;
 
+  /**
+   * @brief Return ContactPointData objects describing the contacts from the
+   * most recent physics substep selected by @p filter.
+   *
+   * Object and link ids of collision objects are resolved once and cached
+   * until objects are added or removed. Not safe to call from several threads
+   * at once.
+   */
+  void getContactPoints(
+      const ContactPointFilter& filter,
+      std::vector<ContactPointData>& contactPoints) const override;
+
+  /**
+   * @brief Report contact events of an object during @ref stepPhysics.
+   *
+   * Contacts are diffed after every substep from Bullet's internal tick
+   * callback. Only manifolds touching subscribed objects are looked at and
+   * their contact points aren't converted.
+   */
+  void subscribeContactEvents(int objectId) override;
+
+  /**
+   * @brief Stop reporting contact events of an object.
+   */
+  void unsubscribeContactEvents(int objectId) override;
+
   /**
    * @brief Cast a ray into the collision world and return a @ref RaycastResults
    * with hit information.
@@ -198,6 +266,24 @@ class BulletPhysicsManager : public PhysicsManager {
   RaycastResults castRay(const esp::geo::Ray& ray,
                          double maxDistance = 100.0) override;
 
+  /**
+   * @brief Sweep an upright capsule through the collision world and return a
+   * @ref RaycastResults with the first hit.
+   *
+   * @param ray The sweep to perform. Need not be unit length, but returned
+   * hit distances will be in units of ray length.
+   * @param radius The capsule radius.
+   * @param height The distance between the centers of the capsule's
+   * hemispherical caps.
+   * @param maxDistance The maximum distance along the ray direction to sweep.
+   * In units of ray length.
+   * @return The raycast results, with at most the first hit.
+   */
+  RaycastResults castCapsule(const esp::geo::Ray& ray,
+                             float radius,
+                             float height,
+                             double maxDistance = 100.0) override;
+
   /**
    * @brief Query the number of contact points that were active during the
    * collision detection check.
@@ -237,6 +323,15 @@ class BulletPhysicsManager : public PhysicsManager {
     return BulletCollisionHelper::get().getStepCollisionSummary(bWorld_.get());
   }
 
+  /**
+   * @brief Estimated host memory of the collision objects, their shapes and
+   * the triangle mesh BVHs in the world, in bytes.
+   *
+   * Triangle mesh vertex and index data is referenced from the
+   * @ref esp::assets::ResourceManager and counted there.
+   */
+  std::size_t getMemoryUsage() const override;
+
   /**
    * @brief Perform discrete collision detection for the scene.
    */
@@ -306,6 +401,90 @@ class BulletPhysicsManager : public PhysicsManager {
       bool forceReload = false,
       const std::string& lightSetup = DEFAULT_LIGHTING_KEY) override;
 
+  /**
+   * @brief Cast the rays of @ref castRays() or @ref castRaysAllHits() with
+   * @ref btParallelFor, so they're spread over the threads of Bullet's task
+   * scheduler.
+   */
+  void castRaysInternal(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      double maxDistance,
+      std::size_t maxHitsPerRay,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+      Corrade::Containers::ArrayView<int> hitCounts) override;
+
+  /**
+   * @brief Sweep the capsules of @ref castCapsules() with @ref btParallelFor,
+   * like @ref castRaysInternal().
+   */
+  void castCapsulesInternal(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float radius,
+      float height,
+      double maxDistance,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals) override;
+
+  /**
+   * @brief Run the queries of @ref queryBoxOverlaps() or
+   * @ref querySphereOverlaps() against the broadphase of the collision world.
+   *
+   * Runs serially, as resolving the hit collision objects to object and link
+   * ids goes through the shared @ref cachedObjectAndLinkIds_.
+   */
+  void queryOverlapsInternal(
+      Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> centers,
+      Corrade::Containers::ArrayView<const float> radii,
+      std::size_t maxOverlapsPerQuery,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<int> linkIds,
+      Corrade::Containers::ArrayView<int> overlapCounts) override;
+
+  /**
+   * @brief Update the constraints of @ref updateRigidConstraints() with a
+   * single settings lookup per constraint.
+   */
+  void updateRigidConstraintsInternal(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+      Corrade::Containers::ArrayView<const float> maxImpulses) override;
+
+  /**
+   * @brief Read back the forces of @ref getRigidConstraintForces() from the
+   * multibody constraint impulses or the joint feedback of rigid constraints.
+   */
+  void getRigidConstraintForcesInternal(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<float> forces) override;
+
+  /**
+   * @brief Push already validated constraint settings to the Bullet
+   * constraint object.
+   *
+   * @param constraintId The id of the constraint to update.
+   * @param cachedSettings The settings the constraint currently has.
+   * @param settings The new settings of the constraint.
+   */
+  void applyRigidConstraintSettings(
+      int constraintId,
+      const RigidConstraintSettings& cachedSettings,
+      const RigidConstraintSettings& settings);
+
+  /**
+   * @brief Let the solver record the forces a new rigid constraint applies.
+   */
+  void enableRigidConstraintFeedback(btTypedConstraint& constraint,
+                                     int constraintId);
+
   //! counter for constraint id generation
   int nextConstraintId_ = 0;
   //! caches for various types of Bullet rigid constraint objects.
@@ -317,6 +496,10 @@ class BulletPhysicsManager : public PhysicsManager {
       rigidP2PConstraints_;
   std::unordered_map<int, std::unique_ptr<btFixedConstraint>>
       rigidFixedConstraints_;
+  //! force feedback of the rigid (non-multibody) constraints, filled by the
+  //! solver every substep
+  std::unordered_map<int, std::unique_ptr<btJointFeedback>>
+      rigidConstraintFeedback_;
   //! when constraining objects to the global frame, a dummy object with 0 mass
   //! is required.
   std::unique_ptr<btRigidBody> globalFrameObject = nullptr;
@@ -371,11 +554,16 @@ class BulletPhysicsManager : public PhysicsManager {
       const esp::metadata::attributes::ObjectAttributes::ptr& objectAttributes,
       scene::SceneNode* objectNode) override;
 
-  btDbvtBroadphase bBroadphase_;
+  /** @brief A @ref btDbvtBroadphase or a @ref bt32BitAxisSweep3 as selected
+   * by the physics attributes.*/
+  std::unique_ptr<btBroadphaseInterface> bBroadphase_;
   btDefaultCollisionConfiguration bCollisionConfig_;
 
   btMultiBodyConstraintSolver bSolver_;
-  btCollisionDispatcher bDispatcher_{&bCollisionConfig_};
+  /** @brief A @ref btCollisionDispatcherMt if the physics attributes ask for
+   * more than one thread and Bullet supports it, a plain
+   * @ref btCollisionDispatcher otherwise.*/
+  std::unique_ptr<btCollisionDispatcher> bDispatcher_;
 
   /** @brief A pointer to the Bullet world. See @ref btMultiBodyDynamicsWorld.*/
   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld_;
@@ -387,6 +575,20 @@ class BulletPhysicsManager : public PhysicsManager {
   std::shared_ptr<std::map<const btCollisionObject*, int>>
       collisionObjToObjIds_;
 
+  //! node updates deferred by the rigid objects during a step
+  std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates_;
+
+  //! convex hulls shared by rigid objects built from the same asset
+  std::shared_ptr<BulletCollisionShapeCache> collisionShapeCache_;
+
+  /**
+   * @brief Choose the substep size for the adaptive timestep: the longest
+   * multiple of the timestep, up to the adaptive maximum, for which no active
+   * body moves further than the configured travel distance. Scenes with awake
+   * articulated objects or many active contacts use the timestep.
+   */
+  double computeAdaptiveTimestep();
+
   //! necessary to acquire forces from impulses
   double recentTimeStep_ = fixedTimeStep_;
   //! for recent call to stepPhysics
@@ -407,6 +609,67 @@ class BulletPhysicsManager : public PhysicsManager {
                                int* objectId,
                                int* linkId) const;
 
+  /**
+   * @brief Object and link id of a collision object, looked up with
+   * @ref lookUpObjectIdAndLinkId on first use and cached in
+   * @ref cachedObjectAndLinkIds_.
+   */
+  const std::pair<int, int>& cachedObjectIdAndLinkId(
+      const btCollisionObject* colObj) const;
+
+  /**
+   * @brief Append the contact points of a manifold between objects with the
+   * given ids to @p contactPoints.
+   */
+  void appendContactPoints(const btPersistentManifold& manifold,
+                           const std::pair<int, int>& idsA,
+                           const std::pair<int, int>& idsB,
+                           bool isActive,
+                           std::vector<ContactPointData>& contactPoints) const;
+
+  /**
+   * @brief Bullet internal tick callback, forwards to
+   * @ref updateContactEvents.
+   */
+  static void contactEventTickCallback(btDynamicsWorld* world,
+                                       btScalar timeStep);
+
+  /**
+   * @brief Diff the contacts of subscribed objects after a substep against
+   * @ref activeContacts_ and record begin and end events.
+   */
+  void updateContactEvents();
+
+  /**
+   * @brief Record persist events for contacts that lasted through the step
+   * and pass the events to the callback.
+   */
+  void finishContactEvents();
+
+  /**
+   * @brief Contact state between two objects or links, keyed by the object
+   * and link ids of both sides in @ref ContactEvent order.
+   */
+  struct ActiveContact {
+    int numContactPoints = 0;
+    //! whether a begin event was recorded for it during the current step
+    bool begunThisStep = false;
+  };
+  typedef std::map<std::array<int, 4>, ActiveContact> ActiveContactMap;
+
+  //! objects whose contacts are reported, see @ref subscribeContactEvents
+  std::unordered_set<int> contactEventObjects_;
+  //! contacts of subscribed objects after the most recent substep
+  ActiveContactMap activeContacts_;
+  //! contacts found by the current substep, reused between substeps
+  ActiveContactMap substepContacts_;
+
+  //! object and link ids of collision objects seen by contact queries,
+  //! cleared whenever objects are added or removed as their collision
+  //! objects may be freed and their addresses reused
+  mutable std::unordered_map<const btCollisionObject*, std::pair<int, int>>
+      cachedObjectAndLinkIds_;
+
   /**
    * @brief Helper function for removing all rigid constraints referencing an
    * object.
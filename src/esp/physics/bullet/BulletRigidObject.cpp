@@ -6,6 +6,7 @@
 #include <Magnum/BulletIntegration/Integration.h>
 
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/FormatStl.h>
 
 #include <utility>
 
@@ -15,6 +16,7 @@
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletCollisionHelper.h"
+#include "BulletConvexDecomposition.h"
 #include "BulletRigidObject.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
@@ -41,10 +43,14 @@ BulletRigidObject::BulletRigidObject(
     const assets::ResourceManager& resMgr,
     std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
     std::shared_ptr<std::map<const btCollisionObject*, int> >
-        collisionObjToObjIds)
+        collisionObjToObjIds,
+    std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates,
+    std::shared_ptr<BulletCollisionShapeCache> collisionShapeCache)
     : BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)),
       RigidObject(rigidBodyNode, objectId, resMgr),
-      MotionState{*rigidBodyNode} {}
+      MotionState{*rigidBodyNode},
+      deferredNodeUpdates_(std::move(deferredNodeUpdates)),
+      collisionShapeCache_(std::move(collisionShapeCache)) {}
 
 BulletRigidObject::~BulletRigidObject() {
   if (!BulletRigidObject::isActive()) {
@@ -78,6 +84,22 @@ bool BulletRigidObject::finalizeObject_LibSpecific() {
   return true;
 }  // finalizeObject_LibSpecifc
 
+void BulletRigidObject::deactivateForPool() {
+  if (!isActive()) {
+    // wake any sleeping objects this one may be supporting
+    activateCollisionIsland();
+  }
+  bWorld_->removeRigidBody(bObjectRigidBody_.get());
+  collisionObjToObjIds_->erase(bObjectRigidBody_.get());
+}  // deactivateForPool
+
+void BulletRigidObject::resetForPoolReuse() {
+  // drop the possibly modified body so that a new one is constructed from the
+  // initialization attributes
+  bObjectRigidBody_.reset();
+  RigidObject::resetForPoolReuse();
+}  // resetForPoolReuse
+
 bool BulletRigidObject::constructCollisionShape() {
   // get this object's creation template, appropriately cast
   auto tmpAttr = getInitializationAttributes();
@@ -94,6 +116,7 @@ bool BulletRigidObject::constructCollisionShape() {
   //! Iterate through all mesh components for one object
   //! The components are combined into a convex compound shape
   bObjectShape_ = std::make_unique<btCompoundShape>();
+  bSharedConvexShapes_.reset();
   auto initAttr = PhysicsObjectBase::getInitializationAttributes<
       metadata::attributes::ObjectAttributes>();
   // collision mesh/asset handle
@@ -118,40 +141,88 @@ bool BulletRigidObject::constructCollisionShape() {
     bObjectShape_->addChildShape(btTransform::getIdentity(),
                                  bGenericShapes_.back().get());
     bObjectShape_->recalculateLocalAabb();
-  } else {
-    // mesh collider
-    const std::vector<assets::CollisionMeshData>& meshGroup =
-        resMgr_.getCollisionMesh(collisionAssetHandle);
-    const assets::MeshMetaData& metaData =
-        resMgr_.getMeshMetaData(collisionAssetHandle);
-
-    if (!usingBBCollisionShape_) {
-      if (joinCollisionMeshes) {
-        bObjectConvexShapes_.emplace_back(
-            std::make_unique<btConvexHullShape>());
+  } else if (!usingBBCollisionShape_) {
+    // mesh collider. Instances built from the same asset with the same
+    // settings share their hulls, which are by far the largest part of the
+    // shape.
+    const int maxHulls = initAttr->getConvexDecompositionMaxHulls();
+    const Magnum::Vector3 collisionAssetSize = tmpAttr->getCollisionAssetSize();
+    const Magnum::Vector3 scale = tmpAttr->getScale();
+    const std::string sharedShapesKey = Corrade::Utility::formatString(
+        "{}:join={}:hulls={}:size={},{},{}:scale={},{},{}",
+        collisionAssetHandle, int(joinCollisionMeshes), maxHulls,
+        collisionAssetSize.x(), collisionAssetSize.y(), collisionAssetSize.z(),
+        scale.x(), scale.y(), scale.z());
+    std::weak_ptr<BulletSharedConvexShapes>& cachedShapes =
+        collisionShapeCache_->convexShapes[sharedShapesKey];
+    bSharedConvexShapes_ = cachedShapes.lock();
+
+    if (!bSharedConvexShapes_) {
+      bSharedConvexShapes_ = std::make_shared<BulletSharedConvexShapes>();
+      std::vector<std::unique_ptr<btConvexHullShape>>& shapes =
+          bSharedConvexShapes_->shapes;
+      const std::vector<assets::CollisionMeshData>& meshGroup =
+          resMgr_.getCollisionMesh(collisionAssetHandle);
+      const assets::MeshMetaData& metaData =
+          resMgr_.getMeshMetaData(collisionAssetHandle);
+
+      if (maxHulls > 0) {
+        // decompose once and reuse the hulls for later instances and runs
+        ConvexDecomposition hulls;
+        const std::string cacheFilename =
+            getConvexDecompositionCacheFilename(collisionAssetHandle,
+                                                maxHulls);
+        if (!loadConvexDecompositionFromCache(
+                cacheFilename, collisionAssetHandle, hulls)) {
+          hulls = computeConvexDecomposition(meshGroup, metaData.root,
+                                             maxHulls);
+          if (!saveConvexDecompositionToCache(
+                  cacheFilename, collisionAssetHandle, hulls)) {
+            ESP_WARNING() << "Unable to cache the convex decomposition of"
+                          << collisionAssetHandle << "in" << cacheFilename
+                          << ", it'll be decomposed again";
+          }
+        }
+        for (const std::vector<Magnum::Vector3>& hull : hulls) {
+          shapes.emplace_back(std::make_unique<btConvexHullShape>());
+          for (const Magnum::Vector3& vertex : hull) {
+            shapes.back()->addPoint(btVector3(vertex), false);
+          }
+          shapes.back()->setLocalScaling(btVector3(collisionAssetSize));
+          shapes.back()->setMargin(0.0);
+        }
+      } else if (joinCollisionMeshes) {
+        shapes.emplace_back(std::make_unique<btConvexHullShape>());
         constructJoinedConvexShapeFromMeshes(Magnum::Matrix4{}, meshGroup,
                                              metaData.root,
-                                             bObjectConvexShapes_.back().get());
-
-        // add the final object after joining meshes
-        bObjectConvexShapes_.back()->setLocalScaling(
-            btVector3(tmpAttr->getCollisionAssetSize()));
-        bObjectConvexShapes_.back()->setMargin(0.0);
-        bObjectConvexShapes_.back()->recalcLocalAabb();
-        bObjectShape_->addChildShape(btTransform::getIdentity(),
-                                     bObjectConvexShapes_.back().get());
+                                             shapes.back().get());
+        shapes.back()->setLocalScaling(btVector3(collisionAssetSize));
+        shapes.back()->setMargin(0.0);
       } else {
         constructConvexShapesFromMeshes(Magnum::Matrix4{}, meshGroup,
-                                        metaData.root, bObjectShape_.get(),
-                                        bObjectConvexShapes_);
+                                        metaData.root, nullptr, shapes);
       }
+
+      // scaling the compound would scale the shared hulls once more for
+      // every instance, so bake the object scale into them instead
+      for (const auto& shape : shapes) {
+        shape->setLocalScaling(shape->getLocalScaling() * btVector3(scale));
+        shape->recalcLocalAabb();
+      }
+      cachedShapes = bSharedConvexShapes_;
+    }
+
+    for (const auto& shape : bSharedConvexShapes_->shapes) {
+      bObjectShape_->addChildShape(btTransform::getIdentity(), shape.get());
     }
   }  // if using prim collider else use mesh collider
 
   //! Set properties
   bObjectShape_->setMargin(margin);
 
-  bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
+  if (!bSharedConvexShapes_) {
+    bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
+  }
   bObjectShape_->recalculateLocalAabb();
 
   if (!originShift_.isZero()) {
@@ -305,6 +376,36 @@ void BulletRigidObject::shiftOrigin(const Magnum::Vector3& shift) {
   }
 }  // shiftOrigin
 
+void BulletRigidObject::unshareConvexShapes() {
+  if (!bSharedConvexShapes_) {
+    return;
+  }
+  // the shared hulls are the only children, rebuild the compound from copies
+  // keeping the child order and any origin shift
+  bObjectConvexShapes_.clear();
+  std::vector<btTransform> childTransforms;
+  for (int i = 0; i < bObjectShape_->getNumChildShapes(); ++i) {
+    const auto* shared =
+        static_cast<const btConvexHullShape*>(bObjectShape_->getChildShape(i));
+    bObjectConvexShapes_.emplace_back(std::make_unique<btConvexHullShape>(
+        &shared->getUnscaledPoints()->x(), shared->getNumPoints(),
+        sizeof(btVector3)));
+    bObjectConvexShapes_.back()->setLocalScaling(shared->getLocalScaling());
+    bObjectConvexShapes_.back()->setMargin(shared->getMargin());
+    childTransforms.push_back(bObjectShape_->getChildTransform(i));
+  }
+  while (bObjectShape_->getNumChildShapes() > 0) {
+    bObjectShape_->removeChildShapeByIndex(bObjectShape_->getNumChildShapes() -
+                                           1);
+  }
+  for (std::size_t i = 0; i < childTransforms.size(); ++i) {
+    bObjectShape_->addChildShape(childTransforms[i],
+                                 bObjectConvexShapes_[i].get());
+  }
+  bObjectShape_->recalculateLocalAabb();
+  bSharedConvexShapes_.reset();
+}  // unshareConvexShapes
+
 void BulletRigidObject::shiftObjectCollisionShape(
     const Magnum::Vector3& shift) {
   // shift all children of the parent collision shape
@@ -495,6 +596,27 @@ bool BulletRigidObject::contactTest() {
   return src.bCollision;
 }  // contactTest
 
+std::vector<bool> BulletRigidObject::contactTestTransforms(
+    const std::vector<Magnum::Matrix4>& transforms) {
+  std::vector<bool> results(transforms.size(), false);
+  SimulationContactResultCallback src;
+  src.m_collisionFilterGroup =
+      bObjectRigidBody_->getBroadphaseHandle()->m_collisionFilterGroup;
+  src.m_collisionFilterMask =
+      bObjectRigidBody_->getBroadphaseHandle()->m_collisionFilterMask;
+  // contactTest computes the query aabb from the current world transform, so
+  // the proxy in the broadphase doesn't need to be updated
+  const btTransform savedTransform = bObjectRigidBody_->getWorldTransform();
+  for (std::size_t i = 0; i < transforms.size(); ++i) {
+    bObjectRigidBody_->setWorldTransform(btTransform(transforms[i]));
+    src.bCollision = false;
+    bWorld_->getCollisionWorld()->contactTest(bObjectRigidBody_.get(), src);
+    results[i] = src.bCollision;
+  }
+  bObjectRigidBody_->setWorldTransform(savedTransform);
+  return results;
+}  // contactTestTransforms
+
 void BulletRigidObject::overrideCollisionGroup(CollisionGroup group) {
   if (!bObjectRigidBody_->isInWorld()) {
     ESP_ERROR() << "Failed because "
@@ -531,7 +653,10 @@ void BulletRigidObject::updateNodes(bool force) {
 }
 
 void BulletRigidObject::setWorldTransform(const btTransform& worldTrans) {
-  if (isDeferringUpdate_) {
+  if (isDeferringUpdate_ || deferredNodeUpdates_->deferring) {
+    if (!deferredUpdate_) {
+      deferredNodeUpdates_->objectIds.push_back(objectId_);
+    }
     deferredUpdate_ = {worldTrans};
   } else {
     MotionState::setWorldTransform(worldTrans);
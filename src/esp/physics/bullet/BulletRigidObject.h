@@ -6,10 +6,17 @@
 #define ESP_PHYSICS_BULLET_BULLETRIGIDOBJECT_H_
 
 /** @file
- * @brief Struct SimulationContactResultCallback, class @ref
+ * @brief Struct SimulationContactResultCallback, struct @ref
+ * esp::physics::BulletDeferredNodeUpdates, struct @ref
+ * esp::physics::BulletCollisionShapeCache, class @ref
  * esp::physics::BulletRigidObject
  */
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
 
@@ -27,6 +34,46 @@
 namespace esp {
 namespace physics {
 
+/**
+ * @brief Node updates deferred during a physics step, shared between a
+ * @ref BulletPhysicsManager and its rigid objects.
+ *
+ * Bullet only reports new transforms of bodies that are awake, so collecting
+ * the objects that got one lets @ref BulletPhysicsManager::updateNodes skip
+ * the sleeping ones instead of visiting every object.
+ */
+struct BulletDeferredNodeUpdates {
+  //! Whether all rigid objects defer node updates, like after
+  //! @ref PhysicsObjectBase::deferUpdate.
+  bool deferring = false;
+
+  //! IDs of objects with a deferred node update, possibly repeated.
+  std::vector<int> objectIds;
+};
+
+/**
+ * @brief Convex hulls of a collision asset shared by all @ref
+ * BulletRigidObject instances built from it with the same settings
+ *
+ * The hulls are immutable once built and already have the instance scaling
+ * applied, each instance only owns the @ref btCompoundShape referencing them.
+ */
+struct BulletSharedConvexShapes {
+  std::vector<std::unique_ptr<btConvexHullShape>> shapes;
+};
+
+/**
+ * @brief Cache of the @ref BulletSharedConvexShapes of a world
+ *
+ * Only weak references are kept, so the hulls are released together with the
+ * last object using them.
+ */
+struct BulletCollisionShapeCache {
+  //! Hulls by collision asset and the settings they were built with.
+  std::unordered_map<std::string, std::weak_ptr<BulletSharedConvexShapes>>
+      convexShapes;
+};
+
 /**
  * @brief An individual rigid object instance implementing an interface with
  * Bullet physics to enable dynamic objects. See @ref btRigidBody.
@@ -48,13 +95,21 @@ class BulletRigidObject : public BulletBase,
    * @param bWorld The Bullet world to which this object will belong.
    * @param collisionObjToObjIds The global map of btCollisionObjects to Habitat
    * object IDs for contact query identification.
+   * @param deferredNodeUpdates The node updates deferred by all objects of
+   * the world.
+   * @param collisionShapeCache The convex hulls shared by all objects of the
+   * world.
    */
   BulletRigidObject(scene::SceneNode* rigidBodyNode,
                     int objectId,
                     const assets::ResourceManager& resMgr,
                     std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
                     std::shared_ptr<std::map<const btCollisionObject*, int>>
-                        collisionObjToObjIds);
+                        collisionObjToObjIds,
+                    std::shared_ptr<BulletDeferredNodeUpdates>
+                        deferredNodeUpdates,
+                    std::shared_ptr<BulletCollisionShapeCache>
+                        collisionShapeCache);
 
   /**
    * @brief Destructor cleans up simulation structures for the object.
@@ -67,6 +122,18 @@ class BulletRigidObject : public BulletBase,
    */
   bool finalizeObject_LibSpecific() override;
 
+  /**
+   * @brief Remove the rigid body from the world, keeping it and the collision
+   * shape for reuse.
+   */
+  void deactivateForPool() override;
+
+  /**
+   * @brief Add a rigid body with the physical properties of the
+   * initialization attributes back to the world.
+   */
+  void resetForPoolReuse() override;
+
   /**
    * @brief Instantiate a bullet primtive appropriate for the passed
    * AbstractPrimitiveAttributes object
@@ -439,6 +506,8 @@ class BulletRigidObject : public BulletBase,
    * @param margin The new scalar collision margin of the object.
    */
   void setMargin(const double margin) override {
+    // the margin is set on the hulls, which other instances may share
+    unshareConvexShapes();
     for (std::size_t i = 0; i < bObjectConvexShapes_.size(); ++i) {
       bObjectConvexShapes_[i]->setMargin(margin);
     }
@@ -468,6 +537,21 @@ class BulletRigidObject : public BulletBase,
    */
   bool contactTest() override;
 
+  /**
+   * @brief Run @ref contactTest with the object placed at each of
+   * @p transforms, without moving it.
+   *
+   * Only the broadphase is queried for candidate pairs, the object's own
+   * broadphase proxy, contact manifolds and activation state are left
+   * untouched and its pose is restored before returning, so this is cheap
+   * enough to validate many candidate placements per frame.
+   * @param transforms Candidate object-to-world transformations.
+   * @return Whether or not the object would be in contact with any other
+   * collision enabled objects, one entry per transformation.
+   */
+  std::vector<bool> contactTestTransforms(
+      const std::vector<Magnum::Matrix4>& transforms);
+
   /**
    * @brief Manually set the collision group for an object.
    * @param group The desired CollisionGroup for the object.
@@ -541,9 +625,23 @@ class BulletRigidObject : public BulletBase,
 
   std::string getCollisionDebugName();
 
+  /**
+   * @brief Replace the hulls shared with other instances by private copies
+   * before modifying them.
+   */
+  void unshareConvexShapes();
+
   Corrade::Containers::Optional<btTransform> deferredUpdate_ =
       Corrade::Containers::NullOpt;
 
+  std::shared_ptr<BulletDeferredNodeUpdates> deferredNodeUpdates_;
+
+  std::shared_ptr<BulletCollisionShapeCache> collisionShapeCache_;
+
+  //! hulls referenced by @ref bObjectShape_ and shared with other instances,
+  //! if any
+  std::shared_ptr<BulletSharedConvexShapes> bSharedConvexShapes_;
+
   ESP_SMART_POINTERS(BulletRigidObject)
 };
 
@@ -5,6 +5,8 @@
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
 
+#include <Corrade/Utility/Path.h>
+
 #include <utility>
 
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
@@ -14,9 +16,12 @@
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletCollisionHelper.h"
 #include "BulletRigidStage.h"
+#include "BulletStageBvhCache.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/physics/CollisionGroupHelper.h"
 
+namespace Cr = Corrade;
+
 namespace esp {
 namespace physics {
 
@@ -79,6 +84,7 @@ void BulletRigidStage::constructAndAddCollisionObjects() {
         resMgr_.getMeshMetaData(collisionAssetHandle);
 
     constructBulletSceneFromMeshes(Magnum::Matrix4{}, meshGroup, metaData.root);
+    buildOrLoadStageBvhs(collisionAssetHandle);
 
     for (auto& object : bStaticCollisionObjects_) {
       object->setFriction(initAttr->getFrictionCoefficient());
@@ -95,6 +101,30 @@ void BulletRigidStage::constructAndAddCollisionObjects() {
   }
 }
 
+void BulletRigidStage::buildOrLoadStageBvhs(
+    const std::string& collisionAssetHandle) {
+  if (bStageShapes_.empty()) {
+    return;
+  }
+  // only file assets can be cached alongside
+  const bool cacheable = Cr::Utility::Path::exists(collisionAssetHandle);
+  const std::string cacheFilename =
+      getStageBvhCacheFilename(collisionAssetHandle);
+  if (cacheable && loadStageBvhsFromCache(cacheFilename, collisionAssetHandle,
+                                          bStageShapes_, bStageBvhData_)) {
+    ESP_DEBUG() << "Loaded stage collision bvhs from" << cacheFilename;
+    return;
+  }
+
+  for (auto& shape : bStageShapes_) {
+    shape->buildOptimizedBvh();
+  }
+  if (cacheable && !saveStageBvhsToCache(cacheFilename, collisionAssetHandle,
+                                         bStageShapes_)) {
+    ESP_DEBUG() << "Unable to cache stage collision bvhs to" << cacheFilename;
+  }
+}  // buildOrLoadStageBvhs
+
 void BulletRigidStage::constructBulletSceneFromMeshes(
     const Magnum::Matrix4& transformFromParentToWorld,
     const std::vector<assets::CollisionMeshData>& meshGroup,
@@ -138,18 +168,18 @@ void BulletRigidStage::constructBulletSceneFromMeshes(
     //! Embed 3D mesh into bullet shape
     //! btBvhTriangleMeshShape is the most generic/slow choice
     //! which allows concavity if the object is static
+    //! The bvh is built or loaded from the cache once all shapes exist, see
+    //! buildOrLoadStageBvhs()
     std::unique_ptr<btBvhTriangleMeshShape> meshShape =
         std::make_unique<btBvhTriangleMeshShape>(indexedVertexArray.get(),
-                                                 true);
+                                                 true, false);
     auto initAttr = PhysicsObjectBase::getInitializationAttributes<
         metadata::attributes::StageAttributes>();
     meshShape->setMargin(initAttr->getMargin());
-    meshShape->setLocalScaling(
-        btVector3{transformFromLocalToWorld
-                      .scaling()});  // scale is a property of the shape
-
-    // re-build the bvh after setting margin
-    meshShape->buildOptimizedBvh();
+    // scale is a property of the shape, set it without the rebuild
+    // btBvhTriangleMeshShape::setLocalScaling would trigger
+    meshShape->btTriangleMeshShape::setLocalScaling(
+        btVector3{transformFromLocalToWorld.scaling()});
     // mass == 0 to indicate static. See isStaticObject assert below. See also
     // examples/MultiThreadedDemo/CommonRigidBodyMTBase.h
     btVector3 localInertia(0, 0, 0);
@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 #define ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 
+#include <Corrade/Containers/Array.h>
+
 #include "esp/physics/RigidStage.h"
 #include "esp/physics/bullet/BulletBase.h"
 
@@ -54,6 +56,14 @@ class BulletRigidStage : public BulletBase, public RigidStage {
       const std::vector<assets::CollisionMeshData>& meshGroup,
       const assets::MeshTransformNode& node);
 
+  /**
+   * @brief Build the bvhs of all stage mesh shapes, or load them from the
+   * on-disk cache next to the collision asset if it is up to date. Freshly
+   * built bvhs are written to the cache for later loads of the stage.
+   * @param collisionAssetHandle The stage's collision asset.
+   */
+  void buildOrLoadStageBvhs(const std::string& collisionAssetHandle);
+
   /**
    * @brief Adds static stage collision objects to the simulation world after
    * contracting them if necessary.
@@ -114,6 +124,10 @@ class BulletRigidStage : public BulletBase, public RigidStage {
   //! Stage data: Bullet triangular mesh shape
   std::vector<std::unique_ptr<btBvhTriangleMeshShape>> bStageShapes_;
 
+  //! Stage data: bvhs deserialized in place from the on-disk cache, used but
+  //! not owned by @ref bStageShapes_
+  std::vector<Corrade::Containers::Array<char>> bStageBvhData_;
+
  public:
   ESP_SMART_POINTERS(BulletRigidStage)
 
@@ -0,0 +1,216 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletStageBvhCache.h"
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Magnum.h>
+
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+/* Bump whenever the cache file layout or the tree construction changes, so
+   stale cache entries aren't used */
+constexpr Mn::UnsignedInt bvhCacheVersion = 1;
+constexpr char bvhCacheMagic[4]{'H', 'S', 'B', 'V'};
+
+struct BvhCacheHeader {
+  char magic[4];
+  Mn::UnsignedInt version;
+  Mn::UnsignedLong assetSize;
+  Mn::UnsignedLong meshHash;
+  Mn::UnsignedInt shapeCount;
+  // trees are serialized in place, so they are only valid for the same
+  // pointer and scalar sizes
+  Mn::UnsignedShort pointerSize;
+  Mn::UnsignedShort scalarSize;
+};
+
+// FNV-1a, only used to detect changed mesh data, not for security
+void hashBytes(Mn::UnsignedLong& hash, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i != size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+// the trees depend on the triangles, their scaling and the margin, which all
+// go into the hash
+Mn::UnsignedLong computeMeshHash(
+    const std::vector<std::unique_ptr<btBvhTriangleMeshShape>>& shapes) {
+  Mn::UnsignedLong hash = 14695981039346656037ull;
+  for (const auto& shape : shapes) {
+    const btStridingMeshInterface* meshInterface = shape->getMeshInterface();
+    for (int part = 0; part != meshInterface->getNumSubParts(); ++part) {
+      const unsigned char* vertexBase = nullptr;
+      const unsigned char* indexBase = nullptr;
+      int numVertices = 0;
+      int vertexStride = 0;
+      int indexStride = 0;
+      int numFaces = 0;
+      PHY_ScalarType vertexType{};
+      PHY_ScalarType indexType{};
+      meshInterface->getLockedReadOnlyVertexIndexBase(
+          &vertexBase, numVertices, vertexType, vertexStride, &indexBase,
+          indexStride, numFaces, indexType, part);
+      hashBytes(hash, vertexBase, std::size_t(numVertices) * vertexStride);
+      hashBytes(hash, indexBase, std::size_t(numFaces) * indexStride);
+      meshInterface->unLockReadOnlyVertexBase(part);
+    }
+    const btVector3& scaling = shape->getLocalScaling();
+    const btScalar margin = shape->getMargin();
+    hashBytes(hash, scaling.m_floats, 3 * sizeof(btScalar));
+    hashBytes(hash, &margin, sizeof(btScalar));
+  }
+  return hash;
+}
+
+Cr::Containers::Array<char> allocateAlignedBuffer(std::size_t size) {
+  // Bullet serializes and deserializes trees only into 16-byte aligned memory
+  return Cr::Containers::Array<char>{
+      static_cast<char*>(btAlignedAlloc(size, 16)), size,
+      [](char* data, std::size_t) { btAlignedFree(data); }};
+}
+
+}  // namespace
+
+std::string getStageBvhCacheFilename(const std::string& assetFilename) {
+  return Cr::Utility::formatString("{}.bvh", assetFilename);
+}
+
+bool loadStageBvhsFromCache(
+    const std::string& filename,
+    const std::string& assetFilename,
+    const std::vector<std::unique_ptr<btBvhTriangleMeshShape>>& shapes,
+    std::vector<Cr::Containers::Array<char>>& bvhData) {
+  if (!Cr::Utility::Path::exists(filename)) {
+    return false;
+  }
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+  if (!assetSize || !data || data->size() < sizeof(BvhCacheHeader)) {
+    return false;
+  }
+  BvhCacheHeader header;
+  std::memcpy(&header, data->data(), sizeof(BvhCacheHeader));
+  if (std::memcmp(header.magic, bvhCacheMagic, sizeof(bvhCacheMagic)) ||
+      header.version != bvhCacheVersion || header.assetSize != *assetSize ||
+      header.pointerSize != sizeof(void*) ||
+      header.scalarSize != sizeof(btScalar) ||
+      header.shapeCount != shapes.size() ||
+      data->size() < sizeof(BvhCacheHeader) +
+                         header.shapeCount * sizeof(Mn::UnsignedInt) ||
+      header.meshHash != computeMeshHash(shapes)) {
+    return false;
+  }
+
+  // copy every tree into its own aligned buffer before touching any shape
+  std::vector<Cr::Containers::Array<char>> loaded;
+  loaded.reserve(header.shapeCount);
+  std::size_t offset =
+      sizeof(BvhCacheHeader) + header.shapeCount * sizeof(Mn::UnsignedInt);
+  for (Mn::UnsignedInt i = 0; i != header.shapeCount; ++i) {
+    Mn::UnsignedInt bvhSize;
+    std::memcpy(&bvhSize,
+                data->data() + sizeof(BvhCacheHeader) +
+                    i * sizeof(Mn::UnsignedInt),
+                sizeof(Mn::UnsignedInt));
+    if (bvhSize == 0 || offset + bvhSize > data->size()) {
+      return false;
+    }
+    loaded.emplace_back(allocateAlignedBuffer(bvhSize));
+    std::memcpy(loaded.back().data(), data->data() + offset, bvhSize);
+    offset += bvhSize;
+  }
+  if (offset != data->size()) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i != shapes.size(); ++i) {
+    btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(
+        loaded[i].data(), loaded[i].size(), false);
+    // passing the current scaling keeps the shape from rebuilding the tree
+    shapes[i]->setOptimizedBvh(bvh, shapes[i]->getLocalScaling());
+  }
+  for (auto& buffer : loaded) {
+    bvhData.emplace_back(std::move(buffer));
+  }
+  return true;
+}  // loadStageBvhsFromCache
+
+bool saveStageBvhsToCache(
+    const std::string& filename,
+    const std::string& assetFilename,
+    const std::vector<std::unique_ptr<btBvhTriangleMeshShape>>& shapes) {
+  Cr::Containers::Optional<std::size_t> assetSize =
+      Cr::Utility::Path::size(assetFilename);
+  if (!assetSize) {
+    return false;
+  }
+  BvhCacheHeader header{};
+  std::memcpy(header.magic, bvhCacheMagic, sizeof(bvhCacheMagic));
+  header.version = bvhCacheVersion;
+  header.assetSize = *assetSize;
+  header.meshHash = computeMeshHash(shapes);
+  header.shapeCount = shapes.size();
+  header.pointerSize = sizeof(void*);
+  header.scalarSize = sizeof(btScalar);
+
+  std::vector<Cr::Containers::Array<char>> serialized;
+  serialized.reserve(shapes.size());
+  std::size_t dataSize =
+      sizeof(BvhCacheHeader) + header.shapeCount * sizeof(Mn::UnsignedInt);
+  for (const auto& shape : shapes) {
+    const btOptimizedBvh* bvh = shape->getOptimizedBvh();
+    if (!bvh) {
+      return false;
+    }
+    serialized.emplace_back(
+        allocateAlignedBuffer(bvh->calculateSerializeBufferSize()));
+    if (!bvh->serializeInPlace(serialized.back().data(),
+                               serialized.back().size(), false)) {
+      return false;
+    }
+    dataSize += serialized.back().size();
+  }
+
+  Cr::Containers::Array<char> data{Cr::ValueInit, dataSize};
+  std::memcpy(data.data(), &header, sizeof(BvhCacheHeader));
+  std::size_t offset =
+      sizeof(BvhCacheHeader) + header.shapeCount * sizeof(Mn::UnsignedInt);
+  for (std::size_t i = 0; i != serialized.size(); ++i) {
+    const Mn::UnsignedInt bvhSize = serialized[i].size();
+    std::memcpy(data.data() + sizeof(BvhCacheHeader) +
+                    i * sizeof(Mn::UnsignedInt),
+                &bvhSize, sizeof(Mn::UnsignedInt));
+    std::memcpy(data.data() + offset, serialized[i].data(), bvhSize);
+    offset += bvhSize;
+  }
+
+  // other processes may be loading the same stage, so only move the file in
+  // place once it's complete
+  const std::string tmpFilename = Cr::Utility::formatString(
+      "{}.{}.tmp", filename, reinterpret_cast<std::uintptr_t>(&data));
+  return Cr::Utility::Path::write(tmpFilename, data) &&
+         Cr::Utility::Path::move(tmpFilename, filename);
+}  // saveStageBvhsToCache
+
+}  // namespace physics
+}  // namespace esp
@@ -0,0 +1,65 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETSTAGEBVHCACHE_H_
+#define ESP_PHYSICS_BULLET_BULLETSTAGEBVHCACHE_H_
+
+/** @file
+ * @brief On-disk cache of the quantized AABB trees of stage collision meshes,
+ * see @ref esp::physics::loadStageBvhsFromCache
+ */
+
+#include <Corrade/Containers/Array.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class btBvhTriangleMeshShape;
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Name of the file caching the stage collision trees of
+ * @p assetFilename
+ *
+ * The cache is stored alongside the asset.
+ */
+std::string getStageBvhCacheFilename(const std::string& assetFilename);
+
+/**
+ * @brief Load the trees saved by @ref saveStageBvhsToCache into @p shapes
+ *
+ * The shapes must have been constructed without building their tree and have
+ * their final scaling and margin already set. On success every shape uses the
+ * tree deserialized in place into the matching buffer of @p bvhData, which
+ * has to outlive the shapes.
+ *
+ * Returns @cpp false @ce without touching the shapes if the file doesn't
+ * exist, is corrupted, was written by a different version or platform, for a
+ * different size of @p assetFilename or for different mesh data, in which
+ * case the trees have to be built.
+ */
+bool loadStageBvhsFromCache(
+    const std::string& filename,
+    const std::string& assetFilename,
+    const std::vector<std::unique_ptr<btBvhTriangleMeshShape>>& shapes,
+    std::vector<Corrade::Containers::Array<char>>& bvhData);
+
+/**
+ * @brief Save the built trees of @p shapes to a cache file
+ *
+ * Returns @cpp false @ce if a shape has no tree or the file can't be written,
+ * e.g. because the asset directory is read-only.
+ */
+bool saveStageBvhsToCache(
+    const std::string& filename,
+    const std::string& assetFilename,
+    const std::vector<std::unique_ptr<btBvhTriangleMeshShape>>& shapes);
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETSTAGEBVHCACHE_H_
@@ -8,13 +8,16 @@
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/BulletIntegration/Integration.h>
+#include <Magnum/Math/Vector3.h>
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "BulletCollisionHelper.h"
 #include "BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.h"
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletURDFImporter.h"
 #include "esp/assets/ResourceManager.h"
+#include "LinearMath/btConvexHullComputer.h"
 #include "esp/physics/CollisionGroupHelper.h"
+#include "esp/physics/URDFModelBundle.h"
 #include "esp/physics/bullet/BulletBase.h"
 
 namespace Mn = Magnum;
@@ -23,8 +26,93 @@ namespace Cr = Corrade;
 namespace esp {
 namespace physics {
 
-// TODO: make this configurable?
-static float gUrdfDefaultCollisionMargin = 0.001;
+namespace {
+
+/**
+ * @brief Vertices of the hulls @ref BulletBase::constructConvexShapesFromMeshes
+ * builds for the meshes referenced from @p node, one hull per mesh
+ */
+void collectConvexHulls(const Mn::Matrix4& transformFromParentToWorld,
+                        const std::vector<assets::CollisionMeshData>& meshGroup,
+                        const assets::MeshTransformNode& node,
+                        btConvexHullComputer& hullComputer,
+                        std::vector<std::vector<Mn::Vector3>>& hulls) {
+  const Mn::Matrix4 transformFromLocalToWorld =
+      transformFromParentToWorld * node.transformFromLocalToParent;
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
+    std::vector<Mn::Vector3> points;
+    points.reserve(mesh.positions.size());
+    for (const Mn::Vector3& position : mesh.positions) {
+      points.push_back(transformFromLocalToWorld.transformPoint(position));
+    }
+    // only the hull vertices matter for collisions, which are usually much
+    // fewer than the mesh vertices. Degenerate hulls keep all points.
+    if (!points.empty() &&
+        hullComputer.compute(points[0].data(), sizeof(Mn::Vector3),
+                             points.size(), 0.0f, 0.0f) >= 0.0f &&
+        hullComputer.vertices.size() != 0) {
+      points.clear();
+      for (int i = 0; i < hullComputer.vertices.size(); ++i) {
+        points.emplace_back(hullComputer.vertices[i].x(),
+                            hullComputer.vertices[i].y(),
+                            hullComputer.vertices[i].z());
+      }
+    }
+    hulls.push_back(std::move(points));
+  }
+  for (const auto& child : node.children) {
+    collectConvexHulls(transformFromLocalToWorld, meshGroup, child,
+                       hullComputer, hulls);
+  }
+}
+
+}  // namespace
+
+bool BulletURDFImporter::bakeURDFModelBundle(
+    const std::string& urdfFilepath,
+    const std::string& bundleFilename) {
+  // parse anew, the cached models may be scaled already
+  metadata::URDF::Parser parser;
+  std::shared_ptr<metadata::URDF::Model> model;
+  if (!parser.parseURDF(urdfFilepath, model)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Can't bake `" << urdfFilepath << "`, it failed to parse.";
+    return false;
+  }
+
+  btConvexHullComputer hullComputer;
+  for (const auto& link : model->m_links) {
+    for (auto& collision : link.second->m_collisionArray) {
+      if (collision.m_geometry.m_type != metadata::URDF::GEOM_MESH) {
+        continue;
+      }
+      const std::string& meshFilename = collision.m_geometry.m_meshFileName;
+      if (!resourceManager_.loadRenderAsset(
+              assets::AssetInfo{assets::AssetType::UNKNOWN, meshFilename})) {
+        ESP_ERROR(Mn::Debug::Flag::NoSpace)
+            << "Can't bake `" << urdfFilepath << "`, collision mesh `"
+            << meshFilename << "` failed to load.";
+        return false;
+      }
+      collectConvexHulls(Mn::Matrix4{},
+                         resourceManager_.getCollisionMesh(meshFilename),
+                         resourceManager_.getMeshMetaData(meshFilename).root,
+                         hullComputer, collision.m_convexHulls);
+    }
+  }
+
+  const std::string filename = bundleFilename.empty()
+                                   ? getURDFModelBundleFilename(urdfFilepath)
+                                   : bundleFilename;
+  if (!saveURDFModelBundle(*model, filename, urdfFilepath)) {
+    ESP_ERROR(Mn::Debug::Flag::NoSpace)
+        << "Unable to save the URDF bundle of `" << urdfFilepath << "` to `"
+        << filename << "`.";
+    return false;
+  }
+  return true;
+}  // BulletURDFImporter::bakeURDFModelBundle
 
 btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
     const metadata::URDF::CollisionShape* collision,
@@ -40,7 +128,7 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
       auto plane = std::make_unique<btStaticPlaneShape>(btVector3(planeNormal),
                                                         planeConstant);
       shape = plane.get();
-      shape->setMargin(gUrdfDefaultCollisionMargin);
+      shape->setMargin(collisionMargin_);
       linkChildShapes.emplace_back(std::move(plane));
       break;
     }
@@ -49,7 +137,7 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
       float height = collision->m_geometry.m_capsuleHeight;
       auto capsuleShape = std::make_unique<btCapsuleShapeZ>(radius, height);
       shape = capsuleShape.get();
-      shape->setMargin(gUrdfDefaultCollisionMargin);
+      shape->setMargin(collisionMargin_);
       linkChildShapes.emplace_back(std::move(capsuleShape));
       break;
     }
@@ -63,7 +151,7 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
       btVector3 halfExtents(cylRadius, cylRadius, cylHalfLength);
       auto cylZShape = std::make_unique<btCylinderShapeZ>(halfExtents);
       shape = cylZShape.get();
-      shape->setMargin(gUrdfDefaultCollisionMargin);
+      shape->setMargin(collisionMargin_);
       linkChildShapes.emplace_back(std::move(cylZShape));
       break;
     }
@@ -78,7 +166,7 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
                       }
       */
       shape = boxShape.get();
-      shape->setMargin(gUrdfDefaultCollisionMargin);
+      shape->setMargin(collisionMargin_);
       linkChildShapes.emplace_back(std::move(boxShape));
       break;
     }
@@ -86,29 +174,44 @@ btCollisionShape* BulletURDFImporter::convertURDFToCollisionShape(
       float radius = collision->m_geometry.m_sphereRadius;
       auto sphereShape = std::make_unique<btSphereShape>(radius);
       shape = sphereShape.get();
-      shape->setMargin(gUrdfDefaultCollisionMargin);
+      shape->setMargin(collisionMargin_);
       linkChildShapes.emplace_back(std::move(sphereShape));
       break;
     }
     case metadata::URDF::GEOM_MESH: {
-      const std::vector<assets::CollisionMeshData>& meshGroup =
-          resourceManager_.getCollisionMesh(
-              collision->m_geometry.m_meshFileName);
-      const assets::MeshMetaData& metaData = resourceManager_.getMeshMetaData(
-          collision->m_geometry.m_meshFileName);
-
       auto compoundShape = std::make_unique<btCompoundShape>();
       std::vector<std::unique_ptr<btConvexHullShape>> convexShapes;
-      esp::physics::BulletBase::constructConvexShapesFromMeshes(
-          Magnum::Matrix4{}, meshGroup, metaData.root, compoundShape.get(),
-          convexShapes);
+      if (!collision->m_convexHulls.empty()) {
+        // hulls precomputed by bakeURDFModelBundle(), the mesh isn't loaded
+        for (const std::vector<Mn::Vector3>& hull :
+             collision->m_convexHulls) {
+          convexShapes.emplace_back(std::make_unique<btConvexHullShape>());
+          for (const Mn::Vector3& point : hull) {
+            convexShapes.back()->addPoint(btVector3(point), false);
+          }
+          convexShapes.back()->setMargin(0.0);
+          convexShapes.back()->recalcLocalAabb();
+          compoundShape->addChildShape(btTransform::getIdentity(),
+                                       convexShapes.back().get());
+        }
+      } else {
+        const std::vector<assets::CollisionMeshData>& meshGroup =
+            resourceManager_.getCollisionMesh(
+                collision->m_geometry.m_meshFileName);
+        const assets::MeshMetaData& metaData =
+            resourceManager_.getMeshMetaData(
+                collision->m_geometry.m_meshFileName);
+        esp::physics::BulletBase::constructConvexShapesFromMeshes(
+            Magnum::Matrix4{}, meshGroup, metaData.root, compoundShape.get(),
+            convexShapes);
+      }
       // move ownership of convexes
       for (auto& convex : convexShapes) {
         linkChildShapes.emplace_back(std::move(convex));
       }
       compoundShape->setLocalScaling(
           btVector3(collision->m_geometry.m_meshScale));
-      compoundShape->setMargin(gUrdfDefaultCollisionMargin);
+      compoundShape->setMargin(collisionMargin_);
       compoundShape->recalculateLocalAabb();
       shape = compoundShape.get();
       linkChildShapes.emplace_back(std::move(compoundShape));
@@ -129,7 +232,7 @@ btCompoundShape* BulletURDFImporter::convertLinkCollisionShapes(
   // TODO: smart pointer
   btCompoundShape* compoundShape = new btCompoundShape();
 
-  compoundShape->setMargin(gUrdfDefaultCollisionMargin);
+  compoundShape->setMargin(collisionMargin_);
 
   auto link = activeModel_->getLink(urdfLinkIndex);
 
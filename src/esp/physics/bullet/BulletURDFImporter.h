@@ -83,6 +83,27 @@ class BulletURDFImporter : public URDFImporter {
 
   ~BulletURDFImporter() override = default;
 
+  //! Set the collision margin applied to all link collision shapes
+  void setCollisionMargin(float collisionMargin) {
+    collisionMargin_ = collisionMargin;
+  }
+
+  //! Get the collision margin applied to all link collision shapes
+  float getCollisionMargin() const { return collisionMargin_; }
+
+  /**
+   * @brief Parse @p urdfFilepath, compute the convex hulls of its mesh
+   * collision shapes and save the result as a bundle that @ref loadURDF uses
+   * instead of parsing the URDF and loading its collision meshes. See @ref
+   * loadURDFModelBundle.
+   * @param urdfFilepath The URDF to compile.
+   * @param bundleFilename The file to save the bundle to. If empty, it's saved
+   * alongside the URDF, where it's picked up by @ref loadURDF.
+   * @return Whether the bundle was saved.
+   */
+  bool bakeURDFModelBundle(const std::string& urdfFilepath,
+                           const std::string& bundleFilename = "");
+
   /////////////////////////////////////
   // multi-body construction functions
 
@@ -144,6 +165,9 @@ class BulletURDFImporter : public URDFImporter {
   void computeParentIndices(URDFToBulletCached& bulletCache,
                             int urdfLinkIndex,
                             int urdfParentIndex);
+
+  //! Collision margin applied to all link collision shapes
+  float collisionMargin_ = 0.001;
 };
 
 void processContactParameters(
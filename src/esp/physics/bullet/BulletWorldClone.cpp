@@ -0,0 +1,445 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletWorldClone.h"
+
+#include <Magnum/BulletIntegration/Integration.h>
+
+#include <algorithm>
+
+#include "BulletDynamics/Featherstone/btMultiBodyFixedConstraint.h"
+#include "BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.h"
+#include "BulletDynamics/Featherstone/btMultiBodyJointMotor.h"
+#include "BulletDynamics/Featherstone/btMultiBodyPoint2Point.h"
+#include "BulletDynamics/Featherstone/btMultiBodySphericalJointMotor.h"
+#include "BulletPhysicsManager.h"
+#include "BulletRigidObject.h"
+#include "esp/core/Check.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+BulletWorldClone::BulletWorldClone(const BulletPhysicsManager& source)
+    : bWorld_{std::make_unique<btMultiBodyDynamicsWorld>(
+          &bDispatcher_,
+          &bBroadphase_,
+          &bSolver_,
+          &bCollisionConfig_)},
+      fixedTimeStep_{source.fixedTimeStep_},
+      worldTime_{source.worldTime_} {
+  const btMultiBodyDynamicsWorld& sourceWorld = *source.bWorld_;
+  bWorld_->setGravity(sourceWorld.getGravity());
+  bWorld_->getSolverInfo() = sourceWorld.getSolverInfo();
+
+  // stage, rigid objects and fixed articulated bases, in the source order so
+  // the clone resolves contacts the same way
+  const btCollisionObjectArray& sourceObjects =
+      sourceWorld.getCollisionObjectArray();
+  for (int i = 0; i < sourceObjects.size(); ++i) {
+    if (!btMultiBodyLinkCollider::upcast(sourceObjects[i])) {
+      cloneCollisionObject(*sourceObjects[i]);
+    }
+  }
+  for (const auto& object : source.existingObjects_) {
+    const btRigidBody* body =
+        static_cast<BulletRigidObject*>(object.second.get())
+            ->bObjectRigidBody_.get();
+    auto clonedIter = clonedCollisionObjects_.find(body);
+    if (clonedIter != clonedCollisionObjects_.end()) {
+      rigidObjects_.emplace(object.first,
+                            btRigidBody::upcast(clonedIter->second));
+    }
+  }
+
+  // articulated objects with their motors and joint limits, which are only in
+  // the dynamics while the object is DYNAMIC
+  for (const auto& object : source.existingArticulatedObjects_) {
+    auto* ao = static_cast<BulletArticulatedObject*>(object.second.get());
+    const bool dynamic = ao->getMotionType() == MotionType::DYNAMIC;
+    btMultiBody* mb = cloneMultiBody(*ao->btMultiBody_, dynamic);
+    articulatedObjects_.emplace(object.first, mb);
+    if (!dynamic) {
+      continue;
+    }
+    for (const auto& motor : ao->jointMotors_) {
+      const JointMotorSettings& settings = motor.second->settings;
+      std::unique_ptr<btMultiBodyConstraint> constraint;
+      if (settings.motorType == JointMotorType::SingleDof) {
+        auto btMotor = std::make_unique<btMultiBodyJointMotor>(
+            mb, motor.second->index, settings.velocityTarget,
+            settings.maxImpulse);
+        btMotor->setPositionTarget(settings.positionTarget,
+                                   settings.positionGain);
+        btMotor->setVelocityTarget(settings.velocityTarget,
+                                   settings.velocityGain);
+        constraint = std::move(btMotor);
+      } else {
+        auto btMotor = std::make_unique<btMultiBodySphericalJointMotor>(
+            mb, motor.second->index, settings.maxImpulse);
+        btMotor->setPositionTarget(
+            btQuaternion(settings.sphericalPositionTarget),
+            settings.positionGain);
+        btMotor->setVelocityTarget(btVector3(settings.sphericalVelocityTarget),
+                                   settings.velocityGain);
+        constraint = std::move(btMotor);
+      }
+      bWorld_->addMultiBodyConstraint(constraint.get());
+      constraint->finalizeMultiDof();
+      multiBodyConstraints_.emplace_back(std::move(constraint));
+    }
+    for (const auto& jointLimit : ao->jointLimitConstraints_) {
+      auto constraint = std::make_unique<btMultiBodyJointLimitConstraint>(
+          mb, jointLimit.first, jointLimit.second.lowerLimit,
+          jointLimit.second.upperLimit);
+      constraint->setMaxAppliedImpulse(
+          jointLimit.second.con->getMaxAppliedImpulse());
+      bWorld_->addMultiBodyConstraint(constraint.get());
+      multiBodyConstraints_.emplace_back(std::move(constraint));
+    }
+  }
+
+  // rigid constraints, rebuilt from their settings like
+  // BulletPhysicsManager::createRigidConstraint does
+  for (const auto& item : source.rigidConstraintSettings_) {
+    const RigidConstraintSettings& settings = item.second;
+    btRigidBody* rbB = nullptr;
+    auto rigidBIter = rigidObjects_.find(settings.objectIdB);
+    if (rigidBIter != rigidObjects_.end()) {
+      rbB = rigidBIter->second;
+    }
+    auto artAIter = articulatedObjects_.find(settings.objectIdA);
+    if (artAIter != articulatedObjects_.end()) {
+      btMultiBody* mbA = artAIter->second;
+      btMultiBody* mbB = nullptr;
+      auto artBIter = articulatedObjects_.find(settings.objectIdB);
+      if (artBIter != articulatedObjects_.end()) {
+        mbB = artBIter->second;
+      }
+      std::unique_ptr<btMultiBodyConstraint> constraint;
+      if (settings.constraintType == RigidConstraintType::PointToPoint) {
+        if (mbB != nullptr) {
+          constraint = std::make_unique<btMultiBodyPoint2Point>(
+              mbA, settings.linkIdA, mbB, settings.linkIdB,
+              btVector3(settings.pivotA), btVector3(settings.pivotB));
+        } else {
+          constraint = std::make_unique<btMultiBodyPoint2Point>(
+              mbA, settings.linkIdA, rbB, btVector3(settings.pivotA),
+              btVector3(settings.pivotB));
+        }
+      } else {
+        if (mbB != nullptr) {
+          constraint = std::make_unique<btMultiBodyFixedConstraint>(
+              mbA, settings.linkIdA, mbB, settings.linkIdB,
+              btVector3(settings.pivotA), btVector3(settings.pivotB),
+              btMatrix3x3(settings.frameA), btMatrix3x3(settings.frameB));
+        } else {
+          constraint = std::make_unique<btMultiBodyFixedConstraint>(
+              mbA, settings.linkIdA, rbB, btVector3(settings.pivotA),
+              btVector3(settings.pivotB), btMatrix3x3(settings.frameA),
+              btMatrix3x3(settings.frameB));
+        }
+      }
+      constraint->setMaxAppliedImpulse(settings.maxImpulse);
+      bWorld_->addMultiBodyConstraint(constraint.get());
+      multiBodyConstraints_.emplace_back(std::move(constraint));
+      continue;
+    }
+
+    auto rigidAIter = rigidObjects_.find(settings.objectIdA);
+    if (rigidAIter == rigidObjects_.end()) {
+      continue;
+    }
+    btRigidBody* rbA = rigidAIter->second;
+    if (rbB == nullptr) {
+      if (globalFrameObject_ == nullptr) {
+        btRigidBody::btRigidBodyConstructionInfo info(0, nullptr, nullptr);
+        globalFrameObject_ = std::make_unique<btRigidBody>(info);
+      }
+      rbB = globalFrameObject_.get();
+    }
+    std::unique_ptr<btTypedConstraint> constraint;
+    if (settings.constraintType == RigidConstraintType::PointToPoint) {
+      auto p2p = std::make_unique<btPoint2PointConstraint>(
+          *rbA, *rbB, btVector3(settings.pivotA), btVector3(settings.pivotB));
+      p2p->m_setting.m_impulseClamp = settings.maxImpulse;
+      constraint = std::move(p2p);
+    } else {
+      auto fixedConstraint = std::make_unique<btFixedConstraint>(
+          *rbA, *rbB,
+          btTransform(btMatrix3x3(settings.frameA), btVector3(settings.pivotA)),
+          btTransform(btMatrix3x3(settings.frameB),
+                      btVector3(settings.pivotB)));
+      // NOTE: impulse is interpreted as force for this constraint.
+      for (int i = 0; i < 6; ++i) {
+        fixedConstraint->setMaxMotorForce(i, settings.maxImpulse);
+      }
+      constraint = std::move(fixedConstraint);
+    }
+    bWorld_->addConstraint(constraint.get());
+    constraints_.emplace_back(std::move(constraint));
+  }
+}
+
+BulletWorldClone::~BulletWorldClone() {
+  // the world releases the broadphase proxies of the objects, so it has to go
+  // while they're still alive
+  bWorld_.reset();
+}
+
+btCollisionObject* BulletWorldClone::cloneCollisionObject(
+    const btCollisionObject& source) {
+  // shapes are shared and never modified through the clone
+  auto* shape = const_cast<btCollisionShape*>(source.getCollisionShape());
+  std::unique_ptr<btCollisionObject> object;
+  if (const btRigidBody* sourceBody = btRigidBody::upcast(&source)) {
+    const btScalar invMass = sourceBody->getInvMass();
+    btRigidBody::btRigidBodyConstructionInfo info(
+        invMass == 0 ? btScalar(0) : 1 / invMass, nullptr, shape,
+        sourceBody->getLocalInertia());
+    info.m_startWorldTransform = sourceBody->getWorldTransform();
+    info.m_linearDamping = sourceBody->getLinearDamping();
+    info.m_angularDamping = sourceBody->getAngularDamping();
+    info.m_linearSleepingThreshold = sourceBody->getLinearSleepingThreshold();
+    info.m_angularSleepingThreshold =
+        sourceBody->getAngularSleepingThreshold();
+    auto body = std::make_unique<btRigidBody>(info);
+    body->setLinearFactor(sourceBody->getLinearFactor());
+    body->setAngularFactor(sourceBody->getAngularFactor());
+    body->setLinearVelocity(sourceBody->getLinearVelocity());
+    body->setAngularVelocity(sourceBody->getAngularVelocity());
+    body->setFlags(sourceBody->getFlags());
+    object = std::move(body);
+  } else {
+    object = std::make_unique<btCollisionObject>();
+    object->setCollisionShape(shape);
+    object->setWorldTransform(source.getWorldTransform());
+  }
+  object->setInterpolationWorldTransform(
+      source.getInterpolationWorldTransform());
+  object->setCollisionFlags(source.getCollisionFlags());
+  object->setFriction(source.getFriction());
+  object->setRollingFriction(source.getRollingFriction());
+  object->setSpinningFriction(source.getSpinningFriction());
+  object->setRestitution(source.getRestitution());
+  object->setContactProcessingThreshold(
+      source.getContactProcessingThreshold());
+  object->setCcdMotionThreshold(source.getCcdMotionThreshold());
+  object->setCcdSweptSphereRadius(source.getCcdSweptSphereRadius());
+
+  const btBroadphaseProxy* proxy = source.getBroadphaseHandle();
+  if (btRigidBody* body = btRigidBody::upcast(object.get())) {
+    bWorld_->addRigidBody(body, proxy->m_collisionFilterGroup,
+                          proxy->m_collisionFilterMask);
+    // adding overrides the gravity of bodies which don't opt out of it
+    body->setGravity(btRigidBody::upcast(&source)->getGravity());
+  } else {
+    bWorld_->addCollisionObject(object.get(), proxy->m_collisionFilterGroup,
+                                proxy->m_collisionFilterMask);
+  }
+  object->forceActivationState(source.getActivationState());
+  object->setDeactivationTime(source.getDeactivationTime());
+
+  btCollisionObject* cloned = object.get();
+  clonedCollisionObjects_.emplace(&source, cloned);
+  collisionObjects_.emplace_back(std::move(object));
+  return cloned;
+}
+
+btMultiBody* BulletWorldClone::cloneMultiBody(const btMultiBody& source,
+                                              bool dynamic) {
+  const int numLinks = source.getNumLinks();
+  auto mb = std::make_unique<btMultiBody>(
+      numLinks, source.getBaseMass(), source.getBaseInertia(),
+      source.hasFixedBase(), source.getCanSleep());
+  // the links hold the joint setup and positions, only the pointers to
+  // objects of the source world have to be replaced
+  for (int i = 0; i < numLinks; ++i) {
+    btMultibodyLink& link = mb->getLink(i);
+    link = source.getLink(i);
+    link.m_collider = nullptr;
+    link.m_jointFeedback = nullptr;
+  }
+  mb->finalizeMultiDof();
+
+  mb->setBaseWorldTransform(source.getBaseWorldTransform());
+  mb->setBaseVel(source.getBaseVel());
+  mb->setBaseOmega(source.getBaseOmega());
+  const btScalar* velocities = source.getVelocityVector();
+  for (int i = 0; i < numLinks; ++i) {
+    if (mb->getLink(i).m_dofCount > 0) {
+      mb->setJointVelMultiDof(
+          i, const_cast<btScalar*>(velocities + 6 +
+                                   source.getLink(i).m_dofOffset));
+    }
+  }
+  mb->setHasSelfCollision(source.hasSelfCollision());
+  mb->setLinearDamping(source.getLinearDamping());
+  mb->setAngularDamping(source.getAngularDamping());
+  mb->setUseGyroTerm(source.getUseGyroTerm());
+  mb->setMaxAppliedImpulse(source.getMaxAppliedImpulse());
+  mb->setMaxCoordinateVelocity(source.getMaxCoordinateVelocity());
+  mb->setCanWakeup(source.getCanWakeup());
+
+  auto cloneCollider = [&](const btMultiBodyLinkCollider& sourceCollider,
+                           int linkIx) {
+    auto collider = std::make_unique<btMultiBodyLinkCollider>(mb.get(), linkIx);
+    collider->setCollisionShape(
+        const_cast<btCollisionShape*>(sourceCollider.getCollisionShape()));
+    collider->setWorldTransform(sourceCollider.getWorldTransform());
+    collider->setInterpolationWorldTransform(
+        sourceCollider.getInterpolationWorldTransform());
+    collider->setCollisionFlags(sourceCollider.getCollisionFlags());
+    collider->setFriction(sourceCollider.getFriction());
+    collider->setRollingFriction(sourceCollider.getRollingFriction());
+    collider->setSpinningFriction(sourceCollider.getSpinningFriction());
+    collider->setRestitution(sourceCollider.getRestitution());
+    const btBroadphaseProxy* proxy = sourceCollider.getBroadphaseHandle();
+    bWorld_->addCollisionObject(collider.get(), proxy->m_collisionFilterGroup,
+                                proxy->m_collisionFilterMask);
+    collider->forceActivationState(sourceCollider.getActivationState());
+    clonedCollisionObjects_.emplace(&sourceCollider, collider.get());
+    if (linkIx == -1) {
+      mb->setBaseCollider(collider.get());
+    } else {
+      mb->getLink(linkIx).m_collider = collider.get();
+    }
+    linkColliders_.emplace_back(std::move(collider));
+  };
+  if (const btMultiBodyLinkCollider* baseCollider = source.getBaseCollider()) {
+    cloneCollider(*baseCollider, -1);
+  }
+  for (int i = 0; i < numLinks; ++i) {
+    if (const btMultiBodyLinkCollider* linkCollider =
+            source.getLink(i).m_collider) {
+      cloneCollider(*linkCollider, i);
+    }
+  }
+
+  if (dynamic) {
+    bWorld_->addMultiBody(mb.get());
+  }
+  btMultiBody* cloned = mb.get();
+  clonedMultiBodies_.emplace(&source, cloned);
+  multiBodies_.emplace_back(std::move(mb));
+  return cloned;
+}
+
+int BulletWorldClone::stepPhysics(double dt) {
+  if (dt <= 0) {
+    dt = fixedTimeStep_;
+  }
+  constexpr int maxSubSteps = 10000;
+  const int numSubStepsTaken = std::min(
+      bWorld_->stepSimulation(dt, maxSubSteps, fixedTimeStep_), maxSubSteps);
+  worldTime_ += numSubStepsTaken * fixedTimeStep_;
+  return numSubStepsTaken;
+}
+
+btRigidBody& BulletWorldClone::rigidBody(int objectId) const {
+  auto iter = rigidObjects_.find(objectId);
+  ESP_CHECK(iter != rigidObjects_.end(),
+            "BulletWorldClone: no rigid object with id" << objectId);
+  return *iter->second;
+}
+
+btMultiBody& BulletWorldClone::multiBody(int objectId) const {
+  auto iter = articulatedObjects_.find(objectId);
+  ESP_CHECK(iter != articulatedObjects_.end(),
+            "BulletWorldClone: no articulated object with id" << objectId);
+  return *iter->second;
+}
+
+Mn::Matrix4 BulletWorldClone::getRigidObjectTransformation(int objectId) const {
+  return Mn::Matrix4{rigidBody(objectId).getWorldTransform()};
+}
+
+void BulletWorldClone::setRigidObjectTransformation(
+    int objectId,
+    const Mn::Matrix4& transformation) {
+  btRigidBody& body = rigidBody(objectId);
+  body.setWorldTransform(btTransform(transformation));
+  body.setInterpolationWorldTransform(body.getWorldTransform());
+  bWorld_->updateSingleAabb(&body);
+  body.activate();
+}
+
+Mn::Vector3 BulletWorldClone::getRigidObjectLinearVelocity(int objectId) const {
+  return Mn::Vector3{rigidBody(objectId).getLinearVelocity()};
+}
+
+void BulletWorldClone::setRigidObjectLinearVelocity(
+    int objectId,
+    const Mn::Vector3& linVel) {
+  btRigidBody& body = rigidBody(objectId);
+  body.setLinearVelocity(btVector3(linVel));
+  body.activate();
+}
+
+Mn::Vector3 BulletWorldClone::getRigidObjectAngularVelocity(
+    int objectId) const {
+  return Mn::Vector3{rigidBody(objectId).getAngularVelocity()};
+}
+
+void BulletWorldClone::setRigidObjectAngularVelocity(
+    int objectId,
+    const Mn::Vector3& angVel) {
+  btRigidBody& body = rigidBody(objectId);
+  body.setAngularVelocity(btVector3(angVel));
+  body.activate();
+}
+
+Mn::Matrix4 BulletWorldClone::getArticulatedObjectTransformation(
+    int objectId) const {
+  return Mn::Matrix4{multiBody(objectId).getBaseWorldTransform()};
+}
+
+std::vector<float> BulletWorldClone::getArticulatedObjectJointPositions(
+    int objectId) const {
+  btMultiBody& mb = multiBody(objectId);
+  std::vector<float> positions;
+  positions.reserve(mb.getNumPosVars());
+  for (int i = 0; i < mb.getNumLinks(); ++i) {
+    const btScalar* linkPositions = mb.getJointPosMultiDof(i);
+    for (int j = 0; j < mb.getLink(i).m_posVarCount; ++j) {
+      positions.push_back(linkPositions[j]);
+    }
+  }
+  return positions;
+}
+
+std::vector<float> BulletWorldClone::getArticulatedObjectJointVelocities(
+    int objectId) const {
+  btMultiBody& mb = multiBody(objectId);
+  std::vector<float> vels;
+  vels.reserve(mb.getNumDofs());
+  for (int i = 0; i < mb.getNumLinks(); ++i) {
+    const btScalar* linkVels = mb.getJointVelMultiDof(i);
+    for (int j = 0; j < mb.getLink(i).m_dofCount; ++j) {
+      vels.push_back(linkVels[j]);
+    }
+  }
+  return vels;
+}
+
+void BulletWorldClone::setArticulatedObjectJointVelocities(
+    int objectId,
+    const std::vector<float>& vels) {
+  btMultiBody& mb = multiBody(objectId);
+  ESP_CHECK(vels.size() == std::size_t(mb.getNumDofs()),
+            "BulletWorldClone::setArticulatedObjectJointVelocities(): expected"
+                << mb.getNumDofs() << "velocities but got" << vels.size());
+  int dofCount = 0;
+  for (int i = 0; i < mb.getNumLinks(); ++i) {
+    if (mb.getLink(i).m_dofCount > 0) {
+      mb.setJointVelMultiDof(i, const_cast<float*>(&vels[dofCount]));
+      dofCount += mb.getLink(i).m_dofCount;
+    }
+  }
+  mb.wakeUp();
+}
+
+}  // namespace physics
+}  // namespace esp
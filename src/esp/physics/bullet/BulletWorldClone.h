@@ -0,0 +1,153 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETWORLDCLONE_H_
+#define ESP_PHYSICS_BULLET_BULLETWORLDCLONE_H_
+
+/** @file
+ * @brief Class @ref esp::physics::BulletWorldClone
+ */
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <btBulletDynamicsCommon.h>
+
+#include "BulletDynamics/Featherstone/btMultiBody.h"
+#include "BulletDynamics/Featherstone/btMultiBodyConstraint.h"
+#include "BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h"
+#include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
+#include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
+
+namespace esp {
+namespace physics {
+
+class BulletPhysicsManager;
+
+/**
+@brief An independent copy of the dynamics state of a @ref BulletPhysicsManager,
+created with @ref BulletPhysicsManager::cloneWorld.
+
+The clone has its own @ref btMultiBodyDynamicsWorld with copies of all rigid
+bodies, multibodies, joint motors, joint limits and rigid constraints at the
+time of cloning, so it can be stepped forward without affecting the source
+world or any other clone, e.g. one clone per thread for parallel lookahead
+rollouts. There is no scene graph: objects are addressed by the ids they have
+in the source @ref BulletPhysicsManager and their state is only readable
+through this class.
+
+Collision shapes are shared with the source objects and are never modified,
+so a clone must not outlive the objects and stage it was cloned from.
+Velocity control, contact events and the source's threading and broadphase
+configuration are not carried over; the clone always steps serially with a
+@ref btDbvtBroadphase.
+*/
+class BulletWorldClone {
+ public:
+  ~BulletWorldClone();
+
+  /**
+   * @brief Step the cloned world forward by @p dt, in increments of the
+   * fixed timestep of the source world.
+   * @return The number of substeps taken.
+   */
+  int stepPhysics(double dt);
+
+  /** @brief Simulated time since the clone was created plus the world time of
+   * the source at cloning. */
+  double getWorldTime() const { return worldTime_; }
+
+  /** @brief Get the transformation of a rigid object. */
+  Magnum::Matrix4 getRigidObjectTransformation(int objectId) const;
+
+  /** @brief Set the transformation of a rigid object. */
+  void setRigidObjectTransformation(int objectId,
+                                    const Magnum::Matrix4& transformation);
+
+  /** @brief Get the linear velocity of a rigid object. */
+  Magnum::Vector3 getRigidObjectLinearVelocity(int objectId) const;
+
+  /** @brief Set the linear velocity of a rigid object, waking it up. */
+  void setRigidObjectLinearVelocity(int objectId,
+                                    const Magnum::Vector3& linVel);
+
+  /** @brief Get the angular velocity of a rigid object. */
+  Magnum::Vector3 getRigidObjectAngularVelocity(int objectId) const;
+
+  /** @brief Set the angular velocity of a rigid object, waking it up. */
+  void setRigidObjectAngularVelocity(int objectId,
+                                     const Magnum::Vector3& angVel);
+
+  /** @brief Get the root transformation of an articulated object. */
+  Magnum::Matrix4 getArticulatedObjectTransformation(int objectId) const;
+
+  /**
+   * @brief Get the joint positions of an articulated object, laid out as in
+   * @ref ArticulatedObject::getJointPositions.
+   */
+  std::vector<float> getArticulatedObjectJointPositions(int objectId) const;
+
+  /**
+   * @brief Get the joint velocities of an articulated object, laid out as in
+   * @ref ArticulatedObject::getJointVelocities.
+   */
+  std::vector<float> getArticulatedObjectJointVelocities(int objectId) const;
+
+  /**
+   * @brief Set the joint velocities of an articulated object, waking it up.
+   */
+  void setArticulatedObjectJointVelocities(int objectId,
+                                           const std::vector<float>& vels);
+
+ private:
+  friend class BulletPhysicsManager;
+
+  explicit BulletWorldClone(const BulletPhysicsManager& source);
+
+  //! Copy a rigid body or plain collision object of the source world.
+  btCollisionObject* cloneCollisionObject(const btCollisionObject& source);
+
+  //! Copy a multibody and its colliders, adding it to the dynamics only if
+  //! @p dynamic.
+  btMultiBody* cloneMultiBody(const btMultiBody& source, bool dynamic);
+
+  btRigidBody& rigidBody(int objectId) const;
+  btMultiBody& multiBody(int objectId) const;
+
+  // the world is destroyed explicitly in the destructor, before the objects
+  // it references and after nothing else needs it
+  btDefaultCollisionConfiguration bCollisionConfig_;
+  btCollisionDispatcher bDispatcher_{&bCollisionConfig_};
+  btDbvtBroadphase bBroadphase_;
+  btMultiBodyConstraintSolver bSolver_;
+  std::unique_ptr<btMultiBodyDynamicsWorld> bWorld_;
+
+  std::vector<std::unique_ptr<btCollisionObject>> collisionObjects_;
+  std::vector<std::unique_ptr<btMultiBody>> multiBodies_;
+  std::vector<std::unique_ptr<btMultiBodyLinkCollider>> linkColliders_;
+  std::vector<std::unique_ptr<btMultiBodyConstraint>> multiBodyConstraints_;
+  std::vector<std::unique_ptr<btTypedConstraint>> constraints_;
+  //! stands in for the world frame in constraints without a second object
+  std::unique_ptr<btRigidBody> globalFrameObject_;
+
+  //! maps source collision objects and multibodies to their copies
+  std::unordered_map<const btCollisionObject*, btCollisionObject*>
+      clonedCollisionObjects_;
+  std::unordered_map<const btMultiBody*, btMultiBody*> clonedMultiBodies_;
+
+  //! object ids of the source manager
+  std::unordered_map<int, btRigidBody*> rigidObjects_;
+  std::unordered_map<int, btMultiBody*> articulatedObjects_;
+
+  double fixedTimeStep_ = 1.0 / 240.0;
+  double worldTime_ = 0.0;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETWORLDCLONE_H_
@@ -32,6 +32,33 @@ class ManagedBulletArticulatedObject
     return false;
   }
 
+  std::vector<bool> contactTestJointPositions(
+      const std::vector<float>& positions) {
+    if (auto sp = getBulletObjectReference()) {
+      return sp->contactTestJointPositions(positions);
+    }
+    return {};
+  }
+
+  void computeLinkTransformations(
+      Corrade::Containers::ArrayView<const float> positions,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations,
+      int numThreads = 0) {
+    if (auto sp = getBulletObjectReference()) {
+      sp->computeLinkTransformations(positions, transformations, numThreads);
+    }
+  }
+
+  void computeLinkJacobians(
+      int linkId,
+      Corrade::Containers::ArrayView<const float> positions,
+      Corrade::Containers::ArrayView<float> jacobians,
+      int numThreads = 0) {
+    if (auto sp = getBulletObjectReference()) {
+      sp->computeLinkJacobians(linkId, positions, jacobians, numThreads);
+    }
+  }
+
  protected:
   /**
    * @brief This function accesses the
@@ -54,6 +81,31 @@ class ManagedBulletArticulatedObject
     return false;
   }
 
+  std::vector<bool> contactTestJointPositions(
+      CORRADE_UNUSED const std::vector<float>& positions) {
+    ESP_WARNING() << "This functionally requires Habitat-Sim to be compiled "
+                     "with Bullet enabled..";
+    return {};
+  }
+
+  void computeLinkTransformations(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> positions,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<Magnum::Matrix4>
+          transformations,
+      CORRADE_UNUSED int numThreads = 0) {
+    ESP_WARNING() << "This functionally requires Habitat-Sim to be compiled "
+                     "with Bullet enabled..";
+  }
+
+  void computeLinkJacobians(
+      CORRADE_UNUSED int linkId,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> positions,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> jacobians,
+      CORRADE_UNUSED int numThreads = 0) {
+    ESP_WARNING() << "This functionally requires Habitat-Sim to be compiled "
+                     "with Bullet enabled..";
+  }
+
   std::shared_ptr<ArticulatedObject> getBulletObjectReference() const {
     ESP_WARNING() << "This functionally requires Habitat-Sim to be compiled "
                      "with Bullet enabled..";
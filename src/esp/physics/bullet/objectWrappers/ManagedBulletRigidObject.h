@@ -42,6 +42,14 @@ class ManagedBulletRigidObject : public esp::physics::ManagedRigidObject {
     return {};
   }  // getCollisionShapeAabb
 
+  std::vector<bool> contactTestTransforms(
+      const std::vector<Magnum::Matrix4>& transforms) {
+    if (auto sp = this->getBulletObjectReference()) {
+      return sp->contactTestTransforms(transforms);
+    }
+    return {};
+  }  // contactTestTransforms
+
  protected:
   /**
    * @brief This function accesses the
@@ -78,6 +86,13 @@ class ManagedBulletRigidObject : public esp::physics::ManagedRigidObject {
     return {};
   }  // getCollisionShapeAabbb
 
+  std::vector<bool> contactTestTransforms(
+      CORRADE_UNUSED const std::vector<Magnum::Matrix4>& transforms) {
+    ESP_WARNING() << "This functionally requires Habitat-Sim to be compiled "
+                     "with Bullet enabled..";
+    return {};
+  }  // contactTestTransforms
+
 #endif
 
  public:
@@ -3,16 +3,114 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "ArticulatedObjectManager.h"
+#include "esp/core/Check.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
 
 namespace esp {
 namespace physics {
 
+namespace {
+
+ArticulatedObject& getCheckedArticulatedObject(PhysicsManager& physMgr,
+                                               const int objectId) {
+  ESP_CHECK(physMgr.isValidArticulatedObjectId(objectId),
+            "ArticulatedObjectManager : no articulated object with ID"
+                << objectId << "exists.");
+  return physMgr.getArticulatedObject(objectId);
+}
+
+/**
+ * @brief Check that the articulated objects in @p objectIds exist and that
+ * @p valueCount is exactly the size of their state. @p countFn gives the
+ * number of values of one object.
+ */
+template <class CountFn>
+void checkJointStateSize(PhysicsManager& physMgr,
+                         Cr::Containers::ArrayView<const int> objectIds,
+                         std::size_t valueCount,
+                         const CountFn& countFn) {
+  std::size_t total = 0;
+  for (const int objectId : objectIds) {
+    total += countFn(getCheckedArticulatedObject(physMgr, objectId));
+  }
+  ESP_CHECK(valueCount == total,
+            "ArticulatedObjectManager : expected"
+                << total << "joint state values but got" << valueCount);
+}
+
+/**
+ * @brief Call @p fn for each articulated object in @p objectIds with the slice
+ * of @p values belonging to it, after checking that the objects exist and
+ * that @p values holds exactly their state. @p countFn gives the number of
+ * values of one object.
+ */
+template <class T, class CountFn, class Fn>
+void forEachJointStateSlice(PhysicsManager& physMgr,
+                            Cr::Containers::ArrayView<const int> objectIds,
+                            Cr::Containers::ArrayView<T> values,
+                            const CountFn& countFn,
+                            const Fn& fn) {
+  checkJointStateSize(physMgr, objectIds, values.size(), countFn);
+  std::size_t offset = 0;
+  for (const int objectId : objectIds) {
+    ArticulatedObject& ao = physMgr.getArticulatedObject(objectId);
+    const std::size_t count = countFn(ao);
+    fn(ao, values.slice(offset, offset + count));
+    offset += count;
+  }
+}
+
+/**
+ * @brief Check that the articulated objects in @p objectIds exist and that
+ * there's one value for each of them.
+ */
+void checkArticulatedObjectIds(PhysicsManager& physMgr,
+                               Cr::Containers::ArrayView<const int> objectIds,
+                               std::size_t valueCount) {
+  ESP_CHECK(valueCount == objectIds.size(),
+            "ArticulatedObjectManager : expected" << objectIds.size()
+                                                  << "values but got"
+                                                  << valueCount);
+  for (const int objectId : objectIds) {
+    getCheckedArticulatedObject(physMgr, objectId);
+  }
+}
+
+/**
+ * @brief Write @p fn of each articulated object in @p objectIds to the
+ * matching element of @p values, after checking that the objects exist.
+ */
+template <class T, class Fn>
+void gatherArticulatedObjectState(
+    PhysicsManager& physMgr,
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<T> values,
+    const Fn& fn) {
+  checkArticulatedObjectIds(physMgr, objectIds, values.size());
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    values[i] = fn(physMgr.getArticulatedObject(objectIds[i]));
+  }
+}
+
+std::size_t dofCount(const ArticulatedObject& ao) {
+  return ao.getNumDofs();
+}
+
+std::size_t jointPositionCount(const ArticulatedObject& ao) {
+  return ao.getNumJointPositions();
+}
+
+}  // namespace
+
 ArticulatedObjectManager::ArticulatedObjectManager()
     : esp::physics::PhysicsObjectBaseManager<ManagedArticulatedObject>::
           PhysicsObjectBaseManager("ArticulatedObject") {
-  // build this manager's copy constructor map
+  // build this manager's copy constructor map, sharing the registered wrapper
+  // of an object instead of copying it, as in RigidObjectManager
   this->copyConstructorMap_["ManagedArticulatedObject"] =
-      &ArticulatedObjectManager::createObjectCopy<ManagedArticulatedObject>;
+      &ArticulatedObjectManager::shareObject;
 
   // build the function pointers to proper wrapper construction methods, keyed
   // by the wrapper names
@@ -21,8 +119,7 @@ ArticulatedObjectManager::ArticulatedObjectManager()
           ManagedArticulatedObject>;
 
   this->copyConstructorMap_["ManagedBulletArticulatedObject"] =
-      &ArticulatedObjectManager::createObjectCopy<
-          ManagedBulletArticulatedObject>;
+      &ArticulatedObjectManager::shareObject;
   managedObjTypeConstructorMap_["ManagedBulletArticulatedObject"] =
       &ArticulatedObjectManager::createPhysicsObjectWrapper<
           ManagedBulletArticulatedObject>;
@@ -74,5 +171,217 @@ ArticulatedObjectManager::addArticulatedObjectByID(
   return nullptr;
 }
 
+int ArticulatedObjectManager::getNumDofs(
+    Cr::Containers::ArrayView<const int> objectIds) const {
+  int numDofs = 0;
+  if (auto physMgr = this->getPhysicsManager()) {
+    for (const int objectId : objectIds) {
+      numDofs += getCheckedArticulatedObject(*physMgr, objectId).getNumDofs();
+    }
+  }
+  return numDofs;
+}
+
+int ArticulatedObjectManager::getNumJointPositions(
+    Cr::Containers::ArrayView<const int> objectIds) const {
+  int numPositions = 0;
+  if (auto physMgr = this->getPhysicsManager()) {
+    for (const int objectId : objectIds) {
+      numPositions += getCheckedArticulatedObject(*physMgr, objectId)
+                          .getNumJointPositions();
+    }
+  }
+  return numPositions;
+}
+
+void ArticulatedObjectManager::getJointPositions(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> positions) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, positions.size(),
+                          jointPositionCount);
+      backend->getJointPositions(physMgr->getBatchedWorldId(), objectIds,
+                                 positions);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, positions, jointPositionCount,
+        [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+          ao.getJointPositions(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::setJointPositions(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> positions) {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, positions.size(),
+                          jointPositionCount);
+      backend->setJointPositions(physMgr->getBatchedWorldId(), objectIds,
+                                 positions);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, positions, jointPositionCount,
+        [](ArticulatedObject& ao,
+           Cr::Containers::ArrayView<const float> slice) {
+          ao.setJointPositions(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::getJointVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> vels) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, vels.size(), dofCount);
+      backend->getJointVelocities(physMgr->getBatchedWorldId(), objectIds,
+                                  vels);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, vels, dofCount,
+        [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+          ao.getJointVelocities(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::setJointVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> vels) {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, vels.size(), dofCount);
+      backend->setJointVelocities(physMgr->getBatchedWorldId(), objectIds,
+                                  vels);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, vels, dofCount,
+        [](ArticulatedObject& ao,
+           Cr::Containers::ArrayView<const float> slice) {
+          ao.setJointVelocities(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::getJointForces(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<float> forces) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, forces.size(), dofCount);
+      backend->getJointForces(physMgr->getBatchedWorldId(), objectIds, forces);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, forces, dofCount,
+        [](ArticulatedObject& ao, Cr::Containers::ArrayView<float> slice) {
+          ao.getJointForces(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::setJointForces(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> forces) {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, forces.size(), dofCount);
+      backend->setJointForces(physMgr->getBatchedWorldId(), objectIds, forces);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, forces, dofCount,
+        [](ArticulatedObject& ao,
+           Cr::Containers::ArrayView<const float> slice) {
+          ao.setJointForces(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::addJointForces(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<const float> forces) {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkJointStateSize(*physMgr, objectIds, forces.size(), dofCount);
+      backend->addJointForces(physMgr->getBatchedWorldId(), objectIds, forces);
+      return;
+    }
+    forEachJointStateSlice(
+        *physMgr, objectIds, forces, dofCount,
+        [](ArticulatedObject& ao,
+           Cr::Containers::ArrayView<const float> slice) {
+          ao.addJointForces(slice);
+        });
+  }
+}
+
+void ArticulatedObjectManager::getTransformations(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Matrix4> transformations) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkArticulatedObjectIds(*physMgr, objectIds, transformations.size());
+      backend->getArticulatedTransformations(physMgr->getBatchedWorldId(),
+                                             objectIds, transformations);
+      return;
+    }
+    gatherArticulatedObjectState(
+        *physMgr, objectIds, transformations,
+        [](const ArticulatedObject& ao) { return ao.getTransformation(); });
+  }
+}
+
+void ArticulatedObjectManager::getRootLinearVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkArticulatedObjectIds(*physMgr, objectIds, vels.size());
+      backend->getArticulatedRootLinearVelocities(physMgr->getBatchedWorldId(),
+                                                  objectIds, vels);
+      return;
+    }
+    gatherArticulatedObjectState(
+        *physMgr, objectIds, vels, [](const ArticulatedObject& ao) {
+          return ao.getRootLinearVelocity();
+        });
+  }
+}
+
+void ArticulatedObjectManager::getRootAngularVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkArticulatedObjectIds(*physMgr, objectIds, vels.size());
+      backend->getArticulatedRootAngularVelocities(physMgr->getBatchedWorldId(),
+                                                   objectIds, vels);
+      return;
+    }
+    gatherArticulatedObjectState(
+        *physMgr, objectIds, vels, [](const ArticulatedObject& ao) {
+          return ao.getRootAngularVelocity();
+        });
+  }
+}
+
+void ArticulatedObjectManager::getMotionTypes(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<MotionType> motionTypes) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    gatherArticulatedObjectState(
+        *physMgr, objectIds, motionTypes,
+        [](const ArticulatedObject& ao) { return ao.getMotionType(); });
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
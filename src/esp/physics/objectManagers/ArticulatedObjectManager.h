@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_ARTICULATEDOBJECTMANAGER_H
 #define ESP_PHYSICS_ARTICULATEDOBJECTMANAGER_H
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "PhysicsObjectBaseManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletArticulatedObject.h"
 #include "esp/physics/objectWrappers/ManagedArticulatedObject.h"
@@ -199,6 +201,114 @@ class ArticulatedObjectManager
     return objPtr;
   }
 
+  /**
+   * @brief Get the total number of joint degrees of freedom of the articulated
+   * objects with the given @p objectIds, the size of their batched joint
+   * velocities and forces.
+   */
+  int getNumDofs(Corrade::Containers::ArrayView<const int> objectIds) const;
+
+  /**
+   * @brief Get the total number of joint position variables of the
+   * articulated objects with the given @p objectIds, the size of their
+   * batched joint positions.
+   */
+  int getNumJointPositions(
+      Corrade::Containers::ArrayView<const int> objectIds) const;
+
+  /**
+   * @brief Gather the joint positions of the articulated objects with the
+   * given @p objectIds into one contiguous array.
+   *
+   * The positions of each object follow those of the previous one, in the
+   * order of @p objectIds. @p positions must have exactly @ref
+   * getNumJointPositions values. Nothing is allocated, so the same buffer can
+   * be reused every step. If the world is attached to a
+   * @ref BatchedPhysicsBackend, this and the other batched accessors go
+   * through it.
+   */
+  void getJointPositions(Corrade::Containers::ArrayView<const int> objectIds,
+                         Corrade::Containers::ArrayView<float> positions) const;
+
+  /**
+   * @brief Scatter one contiguous array of joint positions to the articulated
+   * objects with the given @p objectIds, laid out as in @ref
+   * getJointPositions.
+   */
+  void setJointPositions(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<const float> positions);
+
+  /**
+   * @brief Gather the joint velocities of the articulated objects with the
+   * given @p objectIds into one contiguous array of @ref getNumDofs values.
+   */
+  void getJointVelocities(Corrade::Containers::ArrayView<const int> objectIds,
+                          Corrade::Containers::ArrayView<float> vels) const;
+
+  /**
+   * @brief Scatter one contiguous array of @ref getNumDofs joint velocities to
+   * the articulated objects with the given @p objectIds.
+   */
+  void setJointVelocities(Corrade::Containers::ArrayView<const int> objectIds,
+                          Corrade::Containers::ArrayView<const float> vels);
+
+  /**
+   * @brief Gather the joint forces/torques of the articulated objects with the
+   * given @p objectIds into one contiguous array of @ref getNumDofs values.
+   */
+  void getJointForces(Corrade::Containers::ArrayView<const int> objectIds,
+                      Corrade::Containers::ArrayView<float> forces) const;
+
+  /**
+   * @brief Scatter one contiguous array of @ref getNumDofs joint
+   * forces/torques to the articulated objects with the given @p objectIds.
+   */
+  void setJointForces(Corrade::Containers::ArrayView<const int> objectIds,
+                      Corrade::Containers::ArrayView<const float> forces);
+
+  /**
+   * @brief Add one contiguous array of @ref getNumDofs joint forces/torques to
+   * those of the articulated objects with the given @p objectIds.
+   */
+  void addJointForces(Corrade::Containers::ArrayView<const int> objectIds,
+                      Corrade::Containers::ArrayView<const float> forces);
+
+  /**
+   * @brief Gather the root transformations of the articulated objects with
+   * the given @p objectIds into @p transformations, which has to have the
+   * same size.
+   *
+   * Goes to the objects directly instead of through a wrapper per object.
+   */
+  void getTransformations(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations) const;
+
+  /**
+   * @brief Gather the root linear velocities of the articulated objects with
+   * the given @p objectIds into @p vels, which has to have the same size.
+   */
+  void getRootLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) const;
+
+  /**
+   * @brief Gather the root angular velocities of the articulated objects with
+   * the given @p objectIds into @p vels, which has to have the same size.
+   */
+  void getRootAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) const;
+
+  /**
+   * @brief Gather the motion types of the articulated objects with the given
+   * @p objectIds into @p motionTypes, which has to have the same size.
+   */
+  void getMotionTypes(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<MotionType> motionTypes) const;
+
  protected:
   /**
    * @brief This method will remove articulated objects from physics manager.
@@ -3,16 +3,59 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "RigidObjectManager.h"
+#include "esp/core/Check.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
 namespace esp {
 namespace physics {
 
+namespace {
+
+/**
+ * @brief Check that the rigid objects in @p objectIds exist and that there's
+ * one value for each of them.
+ */
+void checkRigidObjectIds(PhysicsManager& physMgr,
+                         Cr::Containers::ArrayView<const int> objectIds,
+                         std::size_t valueCount) {
+  ESP_CHECK(valueCount == objectIds.size(),
+            "RigidObjectManager : expected" << objectIds.size()
+                                            << "values but got" << valueCount);
+  for (const int objectId : objectIds) {
+    ESP_CHECK(physMgr.isValidRigidObjectId(objectId),
+              "RigidObjectManager : no rigid object with ID" << objectId
+                                                             << "exists.");
+  }
+}
+
+/**
+ * @brief Write @p fn of each rigid object in @p objectIds to the matching
+ * element of @p values, after checking that the objects exist.
+ */
+template <class T, class Fn>
+void gatherRigidObjectState(PhysicsManager& physMgr,
+                            Cr::Containers::ArrayView<const int> objectIds,
+                            Cr::Containers::ArrayView<T> values,
+                            const Fn& fn) {
+  checkRigidObjectIds(physMgr, objectIds, values.size());
+  for (std::size_t i = 0; i != objectIds.size(); ++i) {
+    values[i] = fn(physMgr.getRigidObject(objectIds[i]));
+  }
+}
+
+}  // namespace
+
 RigidObjectManager::RigidObjectManager()
     : esp::physics::RigidBaseManager<ManagedRigidObject>::RigidBaseManager(
           "RigidObject") {
   // build this manager's copy constructor map, keyed by the type name of the
-  // wrappers it will manage
+  // wrappers it will manage. Wrappers only refer to the object they wrap, so
+  // every lookup shares the one registered wrapper of an object instead of
+  // copying it.
   this->copyConstructorMap_["ManagedRigidObject"] =
-      &RigidObjectManager::createObjectCopy<ManagedRigidObject>;
+      &RigidObjectManager::shareObject;
 
   // build the function pointers to proper wrapper construction methods, keyed
   // by the wrapper names
@@ -20,7 +63,7 @@ RigidObjectManager::RigidObjectManager()
       &RigidObjectManager::createPhysicsObjectWrapper<ManagedRigidObject>;
 
   this->copyConstructorMap_["ManagedBulletRigidObject"] =
-      &RigidObjectManager::createObjectCopy<ManagedBulletRigidObject>;
+      &RigidObjectManager::shareObject;
   managedObjTypeConstructorMap_["ManagedBulletRigidObject"] =
       &RigidObjectManager::createPhysicsObjectWrapper<ManagedBulletRigidObject>;
 }
@@ -75,5 +118,63 @@ RigidObjectManager::removePhysObjectByHandle(const std::string& objectHandle,
   return nullptr;
 }  // RigidObjectManager::removeObjectByHandle
 
+void RigidObjectManager::getTransformations(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Matrix4> transformations) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkRigidObjectIds(*physMgr, objectIds, transformations.size());
+      backend->getRigidTransformations(physMgr->getBatchedWorldId(), objectIds,
+                                       transformations);
+      return;
+    }
+    gatherRigidObjectState(
+        *physMgr, objectIds, transformations,
+        [](const RigidObject& obj) { return obj.getTransformation(); });
+  }
+}
+
+void RigidObjectManager::getLinearVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkRigidObjectIds(*physMgr, objectIds, vels.size());
+      backend->getRigidLinearVelocities(physMgr->getBatchedWorldId(),
+                                        objectIds, vels);
+      return;
+    }
+    gatherRigidObjectState(
+        *physMgr, objectIds, vels,
+        [](const RigidObject& obj) { return obj.getLinearVelocity(); });
+  }
+}
+
+void RigidObjectManager::getAngularVelocities(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<Mn::Vector3> vels) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    if (BatchedPhysicsBackend* backend = physMgr->getBatchedBackend()) {
+      checkRigidObjectIds(*physMgr, objectIds, vels.size());
+      backend->getRigidAngularVelocities(physMgr->getBatchedWorldId(),
+                                         objectIds, vels);
+      return;
+    }
+    gatherRigidObjectState(
+        *physMgr, objectIds, vels,
+        [](const RigidObject& obj) { return obj.getAngularVelocity(); });
+  }
+}
+
+void RigidObjectManager::getMotionTypes(
+    Cr::Containers::ArrayView<const int> objectIds,
+    Cr::Containers::ArrayView<MotionType> motionTypes) const {
+  if (auto physMgr = this->getPhysicsManager()) {
+    gatherRigidObjectState(
+        *physMgr, objectIds, motionTypes,
+        [](const RigidObject& obj) { return obj.getMotionType(); });
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
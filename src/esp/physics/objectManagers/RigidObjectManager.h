@@ -5,6 +5,8 @@
 #ifndef ESP_PHYSICS_RIGIDOBJECTMANAGER_H
 #define ESP_PHYSICS_RIGIDOBJECTMANAGER_H
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "RigidBaseManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #include "esp/physics/objectWrappers/ManagedRigidObject.h"
@@ -137,6 +139,43 @@ class RigidObjectManager
       bool deleteObjectNode = true,
       bool deleteVisualNode = true);
 
+  /**
+   * @brief Gather the transformations of the rigid objects with the given
+   * @p objectIds into @p transformations, which has to have the same size.
+   *
+   * Goes to the objects directly instead of through a wrapper per object.
+   * Nothing is allocated, so the same buffer can be reused every step. If the
+   * world is attached to a @ref BatchedPhysicsBackend, this and the velocity
+   * accessors go through it.
+   */
+  void getTransformations(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Matrix4> transformations) const;
+
+  /**
+   * @brief Gather the linear velocities of the rigid objects with the given
+   * @p objectIds into @p vels, which has to have the same size.
+   */
+  void getLinearVelocities(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) const;
+
+  /**
+   * @brief Gather the angular velocities of the rigid objects with the given
+   * @p objectIds into @p vels, which has to have the same size.
+   */
+  void getAngularVelocities(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> vels) const;
+
+  /**
+   * @brief Gather the motion types of the rigid objects with the given
+   * @p objectIds into @p motionTypes, which has to have the same size.
+   */
+  void getMotionTypes(
+      Corrade::Containers::ArrayView<const int> objectIds,
+      Corrade::Containers::ArrayView<MotionType> motionTypes) const;
+
  protected:
   /**
    * @brief This method will remove rigid objects from physics manager.  The
@@ -67,6 +67,20 @@ class ManagedArticulatedObject
     return -1;
   }
 
+  int getNumDofs() const {
+    if (auto sp = getObjectReference()) {
+      return sp->getNumDofs();
+    }
+    return 0;
+  }
+
+  int getNumJointPositions() const {
+    if (auto sp = getObjectReference()) {
+      return sp->getNumJointPositions();
+    }
+    return 0;
+  }
+
   std::vector<int> getLinkIds() const {
     if (auto sp = getObjectReference()) {
       return sp->getLinkIds();
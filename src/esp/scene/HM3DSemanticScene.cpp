@@ -6,9 +6,8 @@
 #include "SemanticScene.h"
 
 #include <Corrade/Utility/FormatStl.h>
-#include <fstream>
+#include <algorithm>
 #include <map>
-#include <sstream>
 #include <string>
 
 namespace Cr = Corrade;
@@ -23,18 +22,16 @@ bool SemanticScene::loadHM3DHouse(
   if (!checkFileExists(houseFilename, "loadHM3DHouse")) {
     return false;
   }
-  // open stream and determine house format version
-  std::ifstream ifs = std::ifstream(houseFilename);
-  std::string header;
-  std::getline(ifs, header);
-
-  if (header.find("HM3D Semantic Annotations") == std::string::npos) {
-    ESP_ERROR() << "Unsupported HM3D House format header" << header
-                << "in file name" << houseFilename;
-    return false;
-  }
-
-  return buildHM3DHouse(ifs, scene, rotation);
+  // map the file and determine house format version
+  return readHouseText(houseFilename, [&](Cr::Containers::StringView header,
+                                          Cr::Containers::StringView text) {
+    if (!header.contains("HM3D Semantic Annotations")) {
+      ESP_ERROR() << "Unsupported HM3D House format header" << header
+                  << "in file name" << houseFilename;
+      return false;
+    }
+    return buildHM3DHouse(text, scene, rotation);
+  });
 }  // SemanticScene::loadHM3DHouse
 
 namespace {
@@ -88,9 +85,51 @@ void buildInstanceRegionCategory(
   regionIter.first->second.objInstances.push_back(&objInstance[instanceID]);
 }  // buildInstanceRegionCategory
 
+bool parseInt(Cr::Containers::StringView text, int& out) {
+  const char* it = text.begin();
+  const bool negative = it != text.end() && *it == '-';
+  if (negative) {
+    ++it;
+  }
+  if (it == text.end()) {
+    return false;
+  }
+  int value = 0;
+  for (; it != text.end(); ++it) {
+    if (*it < '0' || *it > '9') {
+      return false;
+    }
+    value = value * 10 + (*it - '0');
+  }
+  out = negative ? -value : value;
+  return true;
+}
+
+bool parseHex(Cr::Containers::StringView text, unsigned& out) {
+  if (text.isEmpty()) {
+    return false;
+  }
+  unsigned value = 0;
+  for (const char c : text) {
+    unsigned digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    value = value * 16 + digit;
+  }
+  out = value;
+  return true;
+}
+
 }  // namespace
 
-bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
+bool SemanticScene::buildHM3DHouse(Cr::Containers::StringView text,
                                    SemanticScene& scene,
                                    const quatf& /*rotation*/) {
   // temp constructs
@@ -101,9 +140,16 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
   buildInstanceRegionCategory(0, 0, "Unknown", -1, objInstance, regions,
                               categories);
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
+  // the text is parsed in place, only the category names get copied
+  std::string objCategoryName;
+  const char* lineBegin = text.begin();
+  while (lineBegin != text.end()) {
+    const char* lineEnd = std::find(lineBegin, text.end(), '\n');
+    const Cr::Containers::StringView line =
+        Cr::Containers::StringView{lineBegin, std::size_t(lineEnd - lineBegin)}
+            .trimmed();
+    lineBegin = lineEnd == text.end() ? lineEnd : lineEnd + 1;
+    if (line.isEmpty()) {
       continue;
     }
 
@@ -112,31 +158,33 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
     // Unique Instance ID (int), color (hex RGB), category name (may be multiple
     // tokens) (string), room/region ID (int) unique instance ID is first token
 
-    // NOTE : label (idx 2) can include commas, so split on quotes, which will
-    // always be around category name
-    // idx 0 will be "<ID>,<color>,"
-    // idx 1 will be "<category with possible commas>"
-    // idx 2 will be ",<region ID>"
-    const std::vector<std::string> tokens =
-        Cr::Utility::String::splitWithoutEmptyParts(line, '"');
-    // sub tokens are ID and color
-    const std::vector<std::string> subtokens =
-        Cr::Utility::String::splitWithoutEmptyParts(tokens[0], ',');
-    // ID is integer
-    int instanceID = std::stoi(Cr::Utility::String::trim(subtokens[0]));
-    // semantic color is 2nd token, as hex string
-    const unsigned colorInt =
-        std::stoul(Cr::Utility::String::trim(subtokens[1]), nullptr, 16);
-    // convert a hex string containing 3 bytes to a vector3ub (represents a
-    // color)
-    Mn::Vector3ub colorVec = {uint8_t((colorInt >> 16) & 0xff),
-                              uint8_t((colorInt >> 8) & 0xff),
-                              uint8_t(colorInt & 0xff)};
+    // NOTE : label can include commas, so split on the first and last quote,
+    // which will always be around category name
+    // before will be "<ID>,<color>,"
+    // between will be "<category with possible commas>"
+    // after will be ",<region ID>"
+    const char* const nameBegin = std::find(line.begin(), line.end(), '"');
+    const char* nameEnd = line.end();
+    while (nameEnd != nameBegin && *(nameEnd - 1) != '"') {
+      --nameEnd;
+    }
+    // ID and color, separated by a comma
+    const Cr::Containers::StringView idAndColor = line.prefix(nameBegin);
+    const char* const comma =
+        std::find(idAndColor.begin(), idAndColor.end(), ',');
+    int instanceID = 0;
+    unsigned colorInt = 0;
+    int regionID = 0;
+    if (nameEnd - nameBegin < 2 || comma == idAndColor.end() ||
+        !parseInt(idAndColor.prefix(comma).trimmed(), instanceID) ||
+        !parseHex(idAndColor.suffix(comma + 1).trimmed(" ,"), colorInt) ||
+        // room/region is always last token - get rid of first comma
+        !parseInt(line.suffix(nameEnd).trimmed(" ,"), regionID)) {
+      ESP_ERROR() << "Malformed HM3D semantic annotation line" << line;
+      return false;
+    }
     // object category will possibly have commas
-    const std::string& objCategoryName = tokens[1];
-    // room/region is always last token - get rid of first comma
-    int regionID =
-        std::stoi(Cr::Utility::String::trim(tokens[tokens.size() - 1], " ,"));
+    objCategoryName.assign(nameBegin + 1, nameEnd - 1);
 
     buildInstanceRegionCategory(instanceID, colorInt, objCategoryName, regionID,
                                 objInstance, regions, categories);
@@ -181,7 +229,7 @@ bool SemanticScene::buildHM3DHouse(std::ifstream& ifs,
   scene.objects_.clear();
   scene.objects_.reserve(objInstance.size());
   for (auto& item : objInstance) {
-    TempHM3DObject obj = item.second;
+    const TempHM3DObject& obj = item.second;
     auto objPtr = std::make_shared<HM3DObjectInstance>(HM3DObjectInstance(
         obj.objInstanceID, obj.objCatID, obj.objInstanceName, obj.colorInt));
     objPtr->category_ = categories[obj.categoryName].category_;
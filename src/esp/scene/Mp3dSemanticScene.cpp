@@ -6,14 +6,77 @@
 #include "SemanticScene.h"
 
 #include <algorithm>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
 #include <map>
-#include <sstream>
 #include <string>
 
+namespace Cr = Corrade;
+
 namespace esp {
 namespace scene {
 
+namespace {
+
+/**
+ * @brief Numbers out of the space-separated tokens of a house file line.
+ * Instead of throwing, a missing or malformed token sets @ref failed.
+ */
+struct Mp3dTokenParser {
+  const std::vector<Cr::Containers::StringView>& tokens;
+  bool failed = false;
+
+  Cr::Containers::StringView token(std::size_t i) {
+    if (i >= tokens.size()) {
+      failed = true;
+      return {};
+    }
+    return tokens[i];
+  }
+
+  int integer(std::size_t i) {
+    const Cr::Containers::StringView text = token(i);
+    const char* it = text.begin();
+    const bool negative = it != text.end() && *it == '-';
+    if (negative) {
+      ++it;
+    }
+    if (it == text.end()) {
+      failed = true;
+      return 0;
+    }
+    int value = 0;
+    for (; it != text.end(); ++it) {
+      if (*it < '0' || *it > '9') {
+        failed = true;
+        return 0;
+      }
+      value = value * 10 + (*it - '0');
+    }
+    return negative ? -value : value;
+  }
+
+  float real(std::size_t i) {
+    const Cr::Containers::StringView text = token(i);
+    // the mapped file isn't null-terminated, so copy to a local buffer
+    char buffer[64];
+    if (text.isEmpty() || text.size() >= sizeof(buffer)) {
+      failed = true;
+      return 0.0f;
+    }
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+    char* end;
+    const float value = std::strtof(buffer, &end);
+    if (end != buffer + text.size()) {
+      failed = true;
+    }
+    return value;
+  }
+};
+
+}  // namespace
+
 static const std::map<char, std::string> kRegionCategoryMap = {
     {'a', "bathroom"},  // with toilet and sink
     {'b', "bedroom"},
@@ -89,29 +152,31 @@ bool SemanticScene::loadMp3dHouse(
     return false;
   }
 
-  // open stream and determine house format version
-  std::ifstream ifs = std::ifstream(houseFilename);
-  std::string header;
-  std::getline(ifs, header);
-  if (header != "ASCII 1.1") {
-    ESP_ERROR() << "Unsupported Mp3d House format header" << header
-                << "in file name" << houseFilename;
-    return false;
-  }
-
-  return buildMp3dHouse(ifs, scene, rotation);
+  // map the file and determine house format version
+  return readHouseText(houseFilename, [&](Cr::Containers::StringView header,
+                                          Cr::Containers::StringView text) {
+    if (header != "ASCII 1.1") {
+      ESP_ERROR() << "Unsupported Mp3d House format header" << header
+                  << "in file name" << houseFilename;
+      return false;
+    }
+    return buildMp3dHouse(text, scene, rotation);
+  });
 }  // SemanticScene::loadMp3dHouse
 
-bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
+bool SemanticScene::buildMp3dHouse(Cr::Containers::StringView text,
                                    SemanticScene& scene,
                                    const quatf& rotation) {
   const bool hasWorldRotation = !rotation.isApprox(quatf::Identity());
 
-  auto getVec3f = [&](const std::vector<std::string>& tokens, int offset,
-                      bool applyRotation = true) -> vec3f {
-    const float x = std::stof(tokens[offset]);
-    const float y = std::stof(tokens[offset + 1]);
-    const float z = std::stof(tokens[offset + 2]);
+  // tokens of the current line, pointing into the text
+  std::vector<Cr::Containers::StringView> tokens;
+  Mp3dTokenParser parser{tokens};
+
+  auto getVec3f = [&](int offset, bool applyRotation = true) -> vec3f {
+    const float x = parser.real(offset);
+    const float y = parser.real(offset + 1);
+    const float z = parser.real(offset + 2);
     vec3f p = vec3f(x, y, z);
     if (applyRotation && hasWorldRotation) {
       p = rotation * p;
@@ -119,11 +184,10 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
     return p;
   };
 
-  auto getBBox = [&](const std::vector<std::string>& tokens,
-                     int offset) -> box3f {
+  auto getBBox = [&](int offset) -> box3f {
     // Get the bounding box without rotating as rotating min/max is odd
-    box3f sceneBox{getVec3f(tokens, offset, /*applyRotation=*/false),
-                   getVec3f(tokens, offset + 3, /*applyRotation=*/false)};
+    box3f sceneBox{getVec3f(offset, /*applyRotation=*/false),
+                   getVec3f(offset + 3, /*applyRotation=*/false)};
     if (!hasWorldRotation)
       return sceneBox;
 
@@ -136,17 +200,17 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
                  (worldCenter + worldHalfSizes).eval()};
   };
 
-  auto getOBB = [&](const std::vector<std::string>& tokens, int offset) {
-    const vec3f center = getVec3f(tokens, offset);
+  auto getOBB = [&](int offset) {
+    const vec3f center = getVec3f(offset);
 
     // Don't need to apply rotation here, it'll already be added in by getVec3f
     mat3f boxRotation;
-    boxRotation.col(0) << getVec3f(tokens, offset + 3);
-    boxRotation.col(1) << getVec3f(tokens, offset + 6);
+    boxRotation.col(0) << getVec3f(offset + 3);
+    boxRotation.col(1) << getVec3f(offset + 6);
     boxRotation.col(2) << boxRotation.col(0).cross(boxRotation.col(1));
 
     // Don't apply the world rotation here, that'll get added by boxRotation
-    const vec3f radius = getVec3f(tokens, offset + 9, /*applyRotation=*/false);
+    const vec3f radius = getVec3f(offset + 9, /*applyRotation=*/false);
 
     return geo::OBB(center, 2 * radius, quatf(boxRotation));
   };
@@ -156,31 +220,56 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
   scene.regions_.clear();
   scene.objects_.clear();
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
+  const char* lineBegin = text.begin();
+  while (lineBegin != text.end()) {
+    const char* lineEnd = std::find(lineBegin, text.end(), '\n');
+    const Cr::Containers::StringView line{lineBegin,
+                                          std::size_t(lineEnd - lineBegin)};
+    lineBegin = lineEnd == text.end() ? lineEnd : lineEnd + 1;
+
+    // split on spaces in place, the vector keeps its capacity across lines
+    tokens.clear();
+    for (const char* it = line.begin(); it != line.end();) {
+      if (*it == ' ' || *it == '\r') {
+        ++it;
+        continue;
+      }
+      const char* tokenEnd = it;
+      while (tokenEnd != line.end() && *tokenEnd != ' ' && *tokenEnd != '\r') {
+        ++tokenEnd;
+      }
+      tokens.emplace_back(it, std::size_t(tokenEnd - it));
+      it = tokenEnd;
+    }
+    if (tokens.empty()) {
       continue;
     }
-    const std::vector<std::string> tokens =
-        Cr::Utility::String::splitWithoutEmptyParts(line, ' ');
+
+    parser.failed = false;
     switch (line[0]) {
       case 'H': {  // house
         // H name label #images #panoramas #vertices #surfaces #segments
         //   #objects #categories #regions #portals #levels  0 0 0 0 0
         //   xlo ylo zlo xhi yhi zhi  0 0 0 0 0
-        scene.name_ = tokens[1];
-        scene.label_ = tokens[2];
-        scene.elementCounts_["images"] = std::stoi(tokens[3]);
-        scene.elementCounts_["panoramas"] = std::stoi(tokens[4]);
-        scene.elementCounts_["vertices"] = std::stoi(tokens[5]);
-        scene.elementCounts_["surfaces"] = std::stoi(tokens[6]);
-        scene.elementCounts_["segments"] = std::stoi(tokens[7]);
-        scene.elementCounts_["objects"] = std::stoi(tokens[8]);
-        scene.elementCounts_["categories"] = std::stoi(tokens[9]);
-        scene.elementCounts_["regions"] = std::stoi(tokens[10]);
-        scene.elementCounts_["portals"] = std::stoi(tokens[11]);
-        scene.elementCounts_["levels"] = std::stoi(tokens[12]);
-        scene.bbox_ = getBBox(tokens, 18);
+        scene.name_ = parser.token(1);
+        scene.label_ = parser.token(2);
+        scene.elementCounts_["images"] = parser.integer(3);
+        scene.elementCounts_["panoramas"] = parser.integer(4);
+        scene.elementCounts_["vertices"] = parser.integer(5);
+        scene.elementCounts_["surfaces"] = parser.integer(6);
+        scene.elementCounts_["segments"] = parser.integer(7);
+        scene.elementCounts_["objects"] = parser.integer(8);
+        scene.elementCounts_["categories"] = parser.integer(9);
+        scene.elementCounts_["regions"] = parser.integer(10);
+        scene.elementCounts_["portals"] = parser.integer(11);
+        scene.elementCounts_["levels"] = parser.integer(12);
+        scene.bbox_ = getBBox(18);
+        // everything gets allocated up front
+        scene.objects_.reserve(std::max(0, scene.elementCounts_["objects"]));
+        scene.categories_.reserve(
+            std::max(0, scene.elementCounts_["categories"]));
+        scene.regions_.reserve(std::max(0, scene.elementCounts_["regions"]));
+        scene.levels_.reserve(std::max(0, scene.elementCounts_["levels"]));
         break;
       }
       case 'L': {  // level
@@ -188,11 +277,11 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         //   0 0 0
         scene.levels_.emplace_back(SemanticLevel::create());
         auto& level = scene.levels_.back();
-        level->index_ = std::stoi(tokens[1]);
+        level->index_ = parser.integer(1);
         // NOTE tokens[2] is number of regions in level which we don't need
-        level->labelCode_ = tokens[3];
-        level->position_ = getVec3f(tokens, 4);
-        level->bbox_ = getBBox(tokens, 7);
+        level->labelCode_ = parser.token(3);
+        level->position_ = getVec3f(4);
+        level->bbox_ = getBBox(7);
         break;
       }
       case 'R': {  // region
@@ -200,11 +289,13 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         //   zhi height  0 0 0 0
         scene.regions_.emplace_back(SemanticRegion::create());
         auto& region = scene.regions_.back();
-        region->index_ = std::stoi(tokens[1]);
-        region->parentIndex_ = std::stoi(tokens[2]);
-        region->category_ = std::make_shared<Mp3dRegionCategory>(tokens[5][0]);
-        region->position_ = getVec3f(tokens, 6);
-        region->bbox_ = getBBox(tokens, 9);
+        region->index_ = parser.integer(1);
+        region->parentIndex_ = parser.integer(2);
+        const Cr::Containers::StringView label = parser.token(5);
+        region->category_ = std::make_shared<Mp3dRegionCategory>(
+            label.isEmpty() ? 'z' : label[0]);
+        region->position_ = getVec3f(6);
+        region->bbox_ = getBBox(9);
         if (region->parentIndex_ >= 0) {
           region->level_ = scene.levels_[region->parentIndex_];
           region->level_->regions_.push_back(region);
@@ -243,13 +334,13 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         scene.categories_.emplace_back(std::make_shared<Mp3dObjectCategory>());
         auto& category =
             static_cast<Mp3dObjectCategory&>(*scene.categories_.back());
-        category.index_ = std::stoi(tokens[1]);
-        category.categoryMappingIndex_ = std::stoi(tokens[2]);
-        std::string catName = tokens[3];
+        category.index_ = parser.integer(1);
+        category.categoryMappingIndex_ = parser.integer(2);
+        std::string catName = parser.token(3);
         std::replace(catName.begin(), catName.end(), '#', ' ');
         category.categoryMappingName_ = catName;
-        category.mpcat40Index_ = std::stoi(tokens[4]);
-        category.mpcat40Name_ = tokens[5];
+        category.mpcat40Index_ = parser.integer(4);
+        category.mpcat40Name_ = parser.token(5);
         break;
       }
       case 'O': {  // object
@@ -257,15 +348,15 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         //   a1x a1y a1z  r0 r1 r2 0 0 0 0 0 0 0 0
         scene.objects_.emplace_back(SemanticObject::create());
         auto& object = scene.objects_.back();
-        object->index_ = std::stoi(tokens[1]);
-        object->parentIndex_ = std::stoi(tokens[2]);
-        int categoryIndex = std::stoi(tokens[3]);
+        object->index_ = parser.integer(1);
+        object->parentIndex_ = parser.integer(2);
+        int categoryIndex = parser.integer(3);
         if (categoryIndex < 0) {  // no category
           object->category_ = std::make_shared<Mp3dObjectCategory>();
         } else {
           object->category_ = scene.categories_[categoryIndex];
         }
-        object->obb_ = getOBB(tokens, 4);
+        object->obb_ = getOBB(4);
         if (object->parentIndex_ >= 0) {
           object->region_ = scene.regions_[object->parentIndex_];
           object->region_->objects_.push_back(object);
@@ -275,8 +366,8 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
       case 'E': {  // segment
         // E segment_index object_index id area px py pz xlo ylo zlo xhi yhi
         // zhi 0 0 0 0 0
-        const int objectIndex = std::stoi(tokens[2]);
-        const int segmentId = std::stoi(tokens[3]);
+        const int objectIndex = parser.integer(2);
+        const int segmentId = parser.integer(3);
         // NOTE: segmentId = regionIndex * 1000000 + segmentId
         scene.segmentToObjectIndex_[segmentId] = objectIndex;
         break;
@@ -285,6 +376,10 @@ bool SemanticScene::buildMp3dHouse(std::ifstream& ifs,
         break;
       }
     }
+    if (parser.failed) {
+      ESP_ERROR() << "Malformed Mp3d house line" << line;
+      return false;
+    }
   }
   scene.hasVertColors_ = true;
   return true;
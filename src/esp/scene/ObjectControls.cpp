@@ -8,6 +8,8 @@
 
 #include <utility>
 
+#include "esp/core/Check.h"
+
 #include "SceneNode.h"
 #include "esp/core/Esp.h"
 
@@ -91,20 +93,9 @@ ObjectControls& ObjectControls::action(SceneNode& object,
                                        const std::string& actName,
                                        float distance,
                                        bool applyFilter /* = true */) {
-  auto moveFuncMapIter = moveFuncMap_.find(actName);
-  if (moveFuncMapIter != moveFuncMap_.end()) {
-    if (applyFilter) {
-      // TODO: use magnum math for the filter func as well?
-      const auto startPosition =
-          cast<vec3f>(object.absoluteTransformation().translation());
-      moveFuncMapIter->second(object, distance);
-      const auto endPos =
-          cast<vec3f>(object.absoluteTransformation().translation());
-      const vec3f filteredEndPosition = moveFilterFunc_(startPosition, endPos);
-      object.translate(Magnum::Vector3(vec3f(filteredEndPosition - endPos)));
-    } else {
-      moveFuncMapIter->second(object, distance);
-    }
+  const MoveFunc* moveFunc = getMoveFunc(actName);
+  if (moveFunc) {
+    action(object, *moveFunc, distance, applyFilter);
   } else {
     ESP_ERROR() << "Tried to perform unknown action with name" << actName;
   }
@@ -112,5 +103,62 @@ ObjectControls& ObjectControls::action(SceneNode& object,
   return *this;
 }
 
+ObjectControls& ObjectControls::action(SceneNode& object,
+                                       const MoveFunc& moveFunc,
+                                       float distance,
+                                       bool applyFilter /* = true */) {
+  if (applyFilter) {
+    // TODO: use magnum math for the filter func as well?
+    const auto startPosition =
+        cast<vec3f>(object.absoluteTransformation().translation());
+    moveFunc(object, distance);
+    const auto endPos =
+        cast<vec3f>(object.absoluteTransformation().translation());
+    const vec3f filteredEndPosition = moveFilterFunc_(startPosition, endPos);
+    object.translate(Magnum::Vector3(vec3f(filteredEndPosition - endPos)));
+  } else {
+    moveFunc(object, distance);
+  }
+
+  return *this;
+}
+
+std::vector<bool> ObjectControls::batchAction(
+    const std::vector<SceneNode*>& objects,
+    const std::vector<const MoveFunc*>& moveFuncs,
+    const std::vector<float>& distances,
+    const MoveBatchFilterFunc& filterFunc) {
+  ESP_CHECK(moveFuncs.size() == objects.size() &&
+                distances.size() == objects.size(),
+            "ObjectControls::batchAction(): expected one move and distance "
+            "per object but got"
+                << moveFuncs.size() << "moves and" << distances.size()
+                << "distances for" << objects.size() << "objects");
+  std::vector<bool> collided(objects.size(), false);
+  std::vector<Magnum::Vector3> starts, ends;
+  starts.reserve(objects.size());
+  ends.reserve(objects.size());
+  for (std::size_t i = 0; i != objects.size(); ++i) {
+    starts.push_back(objects[i]->absoluteTransformation().translation());
+    (*moveFuncs[i])(*objects[i], distances[i]);
+    ends.push_back(objects[i]->absoluteTransformation().translation());
+  }
+  if (!filterFunc) {
+    return collided;
+  }
+
+  const std::vector<Magnum::Vector3> filteredEnds = filterFunc(starts, ends);
+  CORRADE_INTERNAL_ASSERT(filteredEnds.size() == objects.size());
+  // same tolerance as the collision check of the Python ObjectControls
+  constexpr float eps = 1.0e-5f;
+  for (std::size_t i = 0; i != objects.size(); ++i) {
+    objects[i]->translate(filteredEnds[i] - ends[i]);
+    const float distanceBeforeFilter = (ends[i] - starts[i]).length();
+    const float distanceAfterFilter = (filteredEnds[i] - starts[i]).length();
+    collided[i] = distanceAfterFilter + eps < distanceBeforeFilter;
+  }
+  return collided;
+}
+
 }  // namespace scene
 }  // namespace esp
@@ -8,6 +8,10 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
 
 #include "esp/core/Esp.h"
 #include "esp/core/EspEigen.h"
@@ -18,6 +22,13 @@ namespace scene {
 // forward declaration
 class SceneNode;
 
+//! Moves @p object @p distance along its local forward (-Z) axis
+SceneNode& moveForward(SceneNode& object, float distance);
+//! Rotates @p object counter-clockwise around its local up (Y) axis
+SceneNode& turnLeft(SceneNode& object, float angleInDegrees);
+//! Rotates @p object clockwise around its local up (Y) axis
+SceneNode& turnRight(SceneNode& object, float angleInDegrees);
+
 class ObjectControls {
  public:
   ObjectControls();
@@ -26,10 +37,45 @@ class ObjectControls {
   typedef std::function<vec3f(const vec3f&, const vec3f&)> MoveFilterFunc;
   ObjectControls& setMoveFilterFunction(MoveFilterFunc filterFunc);
 
+  /**
+   * @brief Filter for the moves of many objects at once, taking their start
+   * and desired end positions and returning the filtered end positions
+   */
+  typedef std::function<std::vector<Magnum::Vector3>(
+      const std::vector<Magnum::Vector3>&,
+      const std::vector<Magnum::Vector3>&)>
+      MoveBatchFilterFunc;
+
+  /**
+   * @brief Apply @p moveFuncs to @p objects and filter all the moves with a
+   * single call of @p filterFunc
+   * @param objects     Objects to move
+   * @param moveFuncs   Move of each object, found with @ref getMoveFunc()
+   * @param distances   Distance or angle of each move
+   * @param filterFunc  Filter for the moves. If empty, the moves aren't
+   *    filtered.
+   * @return Whether the filter shortened the move of each object, such as
+   *    when it got blocked by a wall
+   */
+  static std::vector<bool> batchAction(
+      const std::vector<SceneNode*>& objects,
+      const std::vector<const MoveFunc*>& moveFuncs,
+      const std::vector<float>& distances,
+      const MoveBatchFilterFunc& filterFunc);
+
   ObjectControls& action(SceneNode& object,
                          const std::string& actName,
                          float distance,
                          bool applyFilter = true);
+
+  /**
+   * @brief Apply @p moveFunc, found with @ref getMoveFunc() beforehand, to
+   * @p object without looking it up by name
+   */
+  ObjectControls& action(SceneNode& object,
+                         const MoveFunc& moveFunc,
+                         float distance,
+                         bool applyFilter = true);
   ObjectControls& operator()(SceneNode& object,
                              const std::string& actName,
                              float distance,
@@ -41,6 +87,16 @@ class ObjectControls {
     return moveFuncMap_;
   }
 
+  /**
+   * @brief The move function of action @p actName, or @cpp nullptr @ce if
+   * there's none. Stays valid for the lifetime of this object.
+   */
+  const MoveFunc* getMoveFunc(const std::string& actName) const {
+    auto moveFuncMapIter = moveFuncMap_.find(actName);
+    return moveFuncMapIter == moveFuncMap_.end() ? nullptr
+                                                 : &moveFuncMapIter->second;
+  }
+
  protected:
   MoveFilterFunc moveFilterFunc_ = [](const vec3f& /*start*/,
                                       const vec3f& end) { return end; };
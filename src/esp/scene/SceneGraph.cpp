@@ -38,5 +38,33 @@ bool SceneGraph::deleteDrawableGroup(const std::string& id) {
   return drawableGroups_.erase(id) != 0u;
 }
 
+std::size_t SceneGraph::updateTransformations() {
+  if (flattenedGeneration_ != SceneNode::hierarchyGeneration()) {
+    flattenedGeneration_ = SceneNode::hierarchyGeneration();
+    flattenedNodes_.clear();
+    // breadth first, so parents come before their children and siblings are
+    // next to each other
+    flattenedNodes_.push_back(&rootNode_);
+    for (std::size_t i = 0; i != flattenedNodes_.size(); ++i) {
+      for (auto* child = flattenedNodes_[i]->children().first(); child;
+           child = child->nextSibling()) {
+        if (auto* childNode = dynamic_cast<SceneNode*>(child)) {
+          flattenedNodes_.push_back(childNode);
+        }
+      }
+    }
+  }
+
+  std::vector<std::reference_wrapper<MagnumObject>> dirtyNodes;
+  for (SceneNode* node : flattenedNodes_) {
+    if (node->isDirty()) {
+      dirtyNodes.emplace_back(*node);
+    }
+  }
+  const std::size_t dirtyCount = dirtyNodes.size();
+  MagnumObject::setClean(std::move(dirtyNodes));
+  return dirtyCount;
+}
+
 }  // namespace scene
 }  // namespace esp
@@ -7,6 +7,7 @@
 
 #include <Magnum/SceneGraph/Scene.h>
 #include <unordered_map>
+#include <vector>
 #include "esp/core/Esp.h"
 #include "esp/gfx/magnum.h"
 
@@ -93,6 +94,23 @@ class SceneGraph {
    */
   bool deleteDrawableGroup(const std::string& id);
 
+  /**
+   * @brief Clean absolute transformations of all nodes in one pass
+   *
+   * Walks a flattened copy of the hierarchy, sorted so parents come before
+   * their children, and cleans every dirty node together, computing each
+   * shared parent transformation only once. The flattened copy is only
+   * rebuilt after nodes were added, removed or reparented.
+   *
+   * Call once per frame after moving nodes, e.g. after
+   * @ref physics::PhysicsManager::updateNodes(). Culling, drawing, replay
+   * recording and sensors then read the cached
+   * @ref SceneNode::cleanAbsoluteTransformation() instead of walking the
+   * hierarchy again.
+   * @return Number of nodes that were dirty
+   */
+  std::size_t updateTransformations();
+
  protected:
   MagnumScene world_;
 
@@ -119,6 +137,11 @@ class SceneGraph {
   // drawable groups for this scene graph
   // This is a mapping from (groupID -> group of drawables).
   DrawableGroups drawableGroups_;
+
+  // all nodes in the order updateTransformations() walks them, rebuilt
+  // whenever SceneNode::hierarchyGeneration() changes
+  std::vector<SceneNode*> flattenedNodes_;
+  std::uint64_t flattenedGeneration_ = ~std::uint64_t{};
 };
 }  // namespace scene
 }  // namespace esp
@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/SceneGraph/Drawable.h>
 
 #include "SceneGraph.h"
 #include "SceneNode.h"
@@ -15,6 +16,9 @@ namespace Mn = Magnum;
 namespace esp {
 namespace scene {
 
+std::atomic<std::uint64_t> SceneNode::hierarchyGeneration_{0};
+std::atomic<std::uint64_t> SceneNode::appearanceGeneration_{0};
+
 SceneNode::SceneNode()
     : Mn::SceneGraph::AbstractFeature3D{*this},
       nodeSensorSuite_(new esp::sensor::SensorSuite(*this)),
@@ -29,12 +33,15 @@ SceneNode::SceneNode()
 SceneNode::SceneNode(SceneNode& parent) : SceneNode() {
   MagnumObject::setParent(&parent);
   setId(parent.getId());
+  ++hierarchyGeneration_;
 }
 SceneNode::SceneNode(MagnumScene& parentNode) : SceneNode() {
   MagnumObject::setParent(&parentNode);
+  ++hierarchyGeneration_;
 }
 
 SceneNode::~SceneNode() {
+  ++hierarchyGeneration_;
   // If the entire scene graph is being deleted no need to update anything
   if (SceneGraph::isRootNode(*this)) {
     return;
@@ -47,6 +54,9 @@ SceneNode::~SceneNode() {
     return;
   }
 
+  // the subtree no longer contributes to the boxes of the ancestors
+  invalidateSubtreeAABB();
+
   // If parent node is not nullptr, update the sensorSuites stored in each
   // ancestor node in a bottom-up manner.
 
@@ -99,6 +109,9 @@ SceneNode& SceneNode::setParent(SceneNode* newParent) {
     p = p->parent();
   }
 
+  // both the old and the new ancestors' boxes change
+  invalidateSubtreeAABB();
+
   // Remove sensors from old parent node's nodeSensorSuite
   removeSensorFromParentNodeSensorSuite();
 
@@ -106,6 +119,8 @@ SceneNode& SceneNode::setParent(SceneNode* newParent) {
   removeSubtreeSensorsFromAncestors();
 
   MagnumObject::setParent(newParent);
+  newParent->invalidateSubtreeAABB();
+  ++hierarchyGeneration_;
 
   // Update new ancestors'SubtreeSensorSuites
   addSubtreeSensorsToAncestors();
@@ -209,9 +224,58 @@ const Mn::Range3D& SceneNode::computeCumulativeBB() {
     }
     child = child->nextSibling();
   }
+  invalidateSubtreeAABB();
   return cumulativeBB_;
 }
 
+const Cr::Containers::Optional<Mn::Range3D>& SceneNode::getSubtreeAABB() {
+  if (subtreeAABBValid_) {
+    return subtreeAABB_;
+  }
+
+  setClean();
+  subtreeAABB_ = Cr::Containers::NullOpt;
+  for (auto* feature = features().first(); feature;
+       feature = feature->nextFeature()) {
+    if (dynamic_cast<Mn::SceneGraph::Drawable3D*>(feature)) {
+      subtreeAABB_ = getAbsoluteAABB();
+      break;
+    }
+  }
+  for (auto* child = children().first(); child; child = child->nextSibling()) {
+    auto* childNode = dynamic_cast<SceneNode*>(child);
+    if (!childNode) {
+      continue;
+    }
+    const Cr::Containers::Optional<Mn::Range3D>& childAABB =
+        childNode->getSubtreeAABB();
+    if (childAABB) {
+      subtreeAABB_ =
+          subtreeAABB_ ? Mn::Math::join(*subtreeAABB_, *childAABB) : *childAABB;
+    }
+  }
+  subtreeAABBValid_ = true;
+  return subtreeAABB_;
+}
+
+void SceneNode::invalidateSubtreeAABB() {
+  // boxes of ancestors of an invalid node are invalid already
+  SceneNode* node = this;
+  while (node && node->subtreeAABBValid_) {
+    node->subtreeAABBValid_ = false;
+    auto* parent = node->parent();
+    node = parent && !parent->isScene() ? static_cast<SceneNode*>(parent)
+                                        : nullptr;
+  }
+}
+
+void SceneNode::markDirty() {
+  // called only when a clean node gets dirty, moves of a node that's dirty
+  // already don't need to be counted as nobody saw the clean state yet
+  ++transformGeneration_;
+  invalidateSubtreeAABB();
+}
+
 void SceneNode::clean(const Magnum::Matrix4& absoluteTransformation) {
   worldCumulativeBB_ = Cr::Containers::NullOpt;
 
@@ -247,6 +311,7 @@ void SceneNode::setSemanticIDVector(const std::vector<int>& _semanticIDs) {
   }
   std::copy(std::begin(_semanticIDs), std::end(_semanticIDs),
             std::begin(semanticIDs_));
+  markAppearanceChanged();
 }
 
 void setSemanticIdForSubtree(SceneNode* node, int semanticId) {
@@ -5,10 +5,13 @@
 #ifndef ESP_SCENE_SCENENODE_H_
 #define ESP_SCENE_SCENENODE_H_
 
+#include <atomic>
+#include <cstdint>
 #include <stack>
 
 #include <Corrade/Containers/Containers.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Assert.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Object.h>
 #include <Magnum/SceneGraph/TranslationRotationScalingTransformation3D.h>
@@ -95,11 +98,12 @@ class SceneNode : public MagnumObject,
   SceneNodeType getType() const { return type_; }
   void setType(SceneNodeType type) { type_ = type; }
 
-  // Add a feature. Used to avoid naked `new` and makes intent clearer.
+  // Add a feature and return it. Used to avoid naked `new` and makes intent
+  // clearer.
   template <class U, class... Args>
-  void addFeature(Args&&... args) {
+  U& addFeature(Args&&... args) {
     // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
-    new U{*this, std::forward<Args>(args)...};
+    return *new U{*this, std::forward<Args>(args)...};
   }
 
   // Returns sceneNodeTags of SceneNode
@@ -147,6 +151,38 @@ class SceneNode : public MagnumObject,
    */
   SceneNode& setParent(SceneNode* newParent);
 
+  /**
+   * @brief Counter changed whenever any node is created, destroyed or
+   * reparented
+   *
+   * Lets @ref SceneGraph::updateTransformations() know when its flattened
+   * hierarchy has to be rebuilt.
+   */
+  static std::uint64_t hierarchyGeneration() { return hierarchyGeneration_; }
+
+  /**
+   * @brief Counter changed whenever something changes how drawables look
+   * without moving them
+   *
+   * That is semantic IDs, drawables being created or destroyed, and changes
+   * to their materials or light setups. Lets sensors tell whether they can
+   * reuse their previous observation, see
+   * @ref sensor::CameraSensor::setSkipUnchangedDraws().
+   */
+  static std::uint64_t appearanceGeneration() { return appearanceGeneration_; }
+
+  //! Change @ref appearanceGeneration()
+  static void markAppearanceChanged() { ++appearanceGeneration_; }
+
+  /**
+   * @brief Counter changed whenever this node or any of its parents moves
+   *
+   * Unlike @ref isDirty(), it isn't reset by cleaning the node, so it tells
+   * whether the node moved since it was last looked at, no matter who
+   * cleaned it in between.
+   */
+  std::uint64_t transformGeneration() const { return transformGeneration_; }
+
   //! Returns node id
   virtual int getId() const { return id_; }
 
@@ -163,6 +199,7 @@ class SceneNode : public MagnumObject,
   virtual void setSemanticId(int semanticId) {
     semanticIDs_[static_cast<int>(SceneNodeSemanticDataIDX::SEMANTIC_ID)] =
         semanticId;
+    markAppearanceChanged();
   }
 
   //! Gets node's owning objectID, for panoptic rendering.
@@ -174,6 +211,7 @@ class SceneNode : public MagnumObject,
   void setBaseObjectId(int objectId) {
     semanticIDs_[static_cast<int>(SceneNodeSemanticDataIDX::OBJECT_ID)] =
         objectId;
+    markAppearanceChanged();
   }
   //! Gets node's corresponding drawable's id, for panoptic rendering.
   virtual int getDrawableId() const {
@@ -185,6 +223,7 @@ class SceneNode : public MagnumObject,
   void setDrawableId(int drawableId) {
     semanticIDs_[static_cast<int>(SceneNodeSemanticDataIDX::DRAWABLE_ID)] =
         drawableId;
+    markAppearanceChanged();
   }
 
   /**
@@ -216,6 +255,23 @@ class SceneNode : public MagnumObject,
 
   Magnum::Vector3 absoluteTranslation();
 
+  /**
+   * @brief Absolute transformation computed by the most recent clean.
+   *
+   * Unlike @ref absoluteTransformation(), doesn't walk up the hierarchy. The
+   * node has to be clean, which is the case after @ref setClean() or after
+   * it was drawn, as long as neither it nor any of its parents moved since.
+   * The static batch variant of @ref setClean() cleans many nodes with
+   * shared parents in a single pass.
+   */
+  const Magnum::Matrix4& cleanAbsoluteTransformation() const {
+    CORRADE_ASSERT(
+        !isDirty(),
+        "SceneNode::cleanAbsoluteTransformation(): the node is dirty",
+        absoluteTransformation_);
+    return absoluteTransformation_;
+  }
+
   //! recursively compute the cumulative bounding box of the full scene graph
   //! tree for which this node is the root
   const Magnum::Range3D& computeCumulativeBB();
@@ -230,6 +286,30 @@ class SceneNode : public MagnumObject,
   //! this node is the root
   const Magnum::Range3D& getCumulativeBB() const { return cumulativeBB_; };
 
+  /**
+   * @brief World space bounding box of all drawables in the subtree rooted at
+   * this node
+   *
+   * Union of @ref getAbsoluteAABB() of this node and all its descendants that
+   * have drawables attached, or @ref Corrade::Containers::NullOpt if there are
+   * none. A drawable culled by this box is culled by its own box as well, so
+   * a whole object can be rejected with a single test.
+   *
+   * The box is cached. Moving a node, changing its bounding boxes, attaching
+   * drawables to it or reparenting it only invalidates the boxes of it and
+   * its ancestors, so only those are recomputed on the next query. Cleans the
+   * nodes it recomputes the box of.
+   */
+  const Corrade::Containers::Optional<Magnum::Range3D>& getSubtreeAABB();
+
+  /**
+   * @brief Invalidate the subtree AABB of this node and its ancestors
+   *
+   * Done automatically when the node moves or its bounding boxes change, see
+   * @ref getSubtreeAABB().
+   */
+  void invalidateSubtreeAABB();
+
   /**
    * @brief Return SensorSuite containing references to Sensors this SceneNode
    * holds
@@ -282,10 +362,20 @@ class SceneNode : public MagnumObject,
   void addSubtreeSensorsToAncestors();
 
   //! set local bounding box for meshes stored at this node
-  void setMeshBB(Magnum::Range3D meshBB) { meshBB_ = meshBB; };
+  void setMeshBB(Magnum::Range3D meshBB) {
+    meshBB_ = meshBB;
+    invalidateSubtreeAABB();
+  };
 
   //! set the global bounding box for mesh stored in this node
-  void setAbsoluteAABB(Magnum::Range3D aabb) { aabb_ = aabb; };
+  void setAbsoluteAABB(Magnum::Range3D aabb) {
+    aabb_ = aabb;
+    invalidateSubtreeAABB();
+  };
+
+  //! whether this node has a precomputed global bounding box, i.e. holds a
+  //! *static* mesh, see @ref setAbsoluteAABB
+  bool hasStaticAbsoluteAABB() const { return bool(aabb_); }
 
   //! return the frustum plane in last frame that culls this node
   int getFrustumPlaneIndex() const { return frustumPlaneIndex; };
@@ -309,6 +399,12 @@ class SceneNode : public MagnumObject,
 
   void clean(const Magnum::Matrix4& absoluteTransformation) override;
 
+  //! called by magnum for this node and all its descendants when one moves
+  void markDirty() override;
+
+  static std::atomic<std::uint64_t> hierarchyGeneration_;
+  static std::atomic<std::uint64_t> appearanceGeneration_;
+
   // the type of the attached object (e.g., sensor, agent etc.)
   SceneNodeType type_ = SceneNodeType::EMPTY;
   int id_ = ID_UNDEFINED;
@@ -340,9 +436,18 @@ class SceneNode : public MagnumObject,
   Corrade::Containers::Optional<Magnum::Range3D> aabb_ =
       Corrade::Containers::NullOpt;
 
+  //! the cached @ref getSubtreeAABB(). If it's invalid, so are the boxes of
+  //! all ancestors, which lets invalidation stop at the first invalid one.
+  Corrade::Containers::Optional<Magnum::Range3D> subtreeAABB_ =
+      Corrade::Containers::NullOpt;
+  bool subtreeAABBValid_ = false;
+
   //! the frustum plane in last frame that culls this node
   int frustumPlaneIndex = 0;
 
+  //! see @ref transformGeneration()
+  std::uint64_t transformGeneration_ = 0;
+
   // Pointer to SensorSuite containing references to Sensors this SceneNode
   // holds
   esp::sensor::SensorSuite* nodeSensorSuite_;
@@ -8,13 +8,21 @@
 #include "Mp3dSemanticScene.h"
 #include "ReplicaSemanticScene.h"
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "esp/io/Io.h"
 #include "esp/io/Json.h"
@@ -40,17 +48,19 @@ bool SemanticScene::
       try {
         // only returns false if file does not exist, or attempting to open it
         // fails
-        // open stream and determine house format version
+        // map the file and determine house format version
         try {
-          std::ifstream ifs = std::ifstream(ssdFileName);
-          std::string header;
-          std::getline(ifs, header);
-          if (header.find("ASCII 1.1") != std::string::npos) {
-            loadSuccess = buildMp3dHouse(ifs, scene, rotation);
-          } else if (header.find("HM3D Semantic Annotations") !=
-                     std::string::npos) {
-            loadSuccess = buildHM3DHouse(ifs, scene, rotation);
-          }
+          loadSuccess = readHouseText(
+              ssdFileName, [&](Cr::Containers::StringView header,
+                               Cr::Containers::StringView text) {
+                if (header.contains("ASCII 1.1")) {
+                  return buildMp3dHouse(text, scene, rotation);
+                }
+                if (header.contains("HM3D Semantic Annotations")) {
+                  return buildHM3DHouse(text, scene, rotation);
+                }
+                return false;
+              });
         } catch (...) {
           loadSuccess = false;
         }
@@ -207,6 +217,7 @@ bool SemanticScene::
         regionPtr->area_ = .5 * abs(polyArea);
         scene.regions_.emplace_back(std::move(regionPtr));
       }
+      scene.buildRegionIndex();
     } else {  // if semantic attributes specifes region annotations
       ESP_DEBUG(Mn::Debug::Flag::NoSpace)
           << "Semantic Attributes : `" << semanticAttr->getHandle()
@@ -220,6 +231,36 @@ bool SemanticScene::
 
 }  // SemanticScene::loadSemanticSceneDescriptor
 
+bool SemanticScene::readHouseText(
+    const std::string& filename,
+    const std::function<bool(Cr::Containers::StringView header,
+                             Cr::Containers::StringView text)>& build) {
+  // parsed in place, without copying the file or its lines
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+  Cr::Containers::Optional<
+      Cr::Containers::Array<const char, Cr::Utility::Path::MapDeleter>>
+      data = Cr::Utility::Path::mapRead(filename);
+#else
+  Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+      Cr::Utility::Path::read(filename);
+#endif
+  if (!data) {
+    ESP_ERROR() << "Unable to read semantic descriptor" << filename;
+    return false;
+  }
+
+  const Cr::Containers::StringView contents{data->data(), data->size()};
+  const char* const headerEnd =
+      std::find(contents.begin(), contents.end(), '\n');
+  Cr::Containers::StringView header = contents.prefix(headerEnd);
+  if (!header.isEmpty() && header[header.size() - 1] == '\r') {
+    header = header.prefix(header.size() - 1);
+  }
+  return build(header, contents.suffix(
+                           headerEnd == contents.end() ? headerEnd
+                                                       : headerEnd + 1));
+}  // SemanticScene::readHouseText
+
 bool SemanticRegion::contains(const Mn::Vector3& pt) const {
   auto checkPt = [&](float x, float x0, float x1, float y, float y0,
                      float y1) -> bool {
@@ -264,37 +305,106 @@ void SemanticRegion::setBBox(const Mn::Vector3& min, const Mn::Vector3& max) {
 
 namespace {
 /**
- * @brief Build an AABB for a given set of vertex indices in @p verts list,
- * and return in a std::pair, along with the count of verts used to build the
- * AABB.
- * @param colorInt Semantic Color of object
- * @param verts The mesh's vertex buffer.
- * @param setOfIDXs set of vertex IDXs in the vertex buffer being used to
- * build the resultant AABB.
+ * @brief Run @p job for every index in [0, @p count), spread over all cores.
+ * Indices are handed out one at a time, as the cost of each can differ
+ * wildly between semantic objects.
  */
-CCSemanticObject::ptr buildCCSemanticObjForSetOfVerts(
-    uint32_t colorInt,
+template <class F>
+void parallelFor(std::size_t count, const F& job) {
+  // not worth a thread for just a few jobs
+  const std::size_t numThreads = std::max<std::size_t>(
+      1, std::min<std::size_t>(std::thread::hardware_concurrency(), count / 8));
+  if (numThreads == 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      job(i);
+    }
+    return;
+  }
+  std::atomic<std::size_t> next{0};
+  const auto worker = [&]() {
+    for (std::size_t i = next++; i < count; i = next++) {
+      job(i);
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+}  // parallelFor
+
+/**
+ * @brief AABB of the verts at @p idxs in @p verts
+ */
+Mn::Range3D computeAABBForVerts(
     const std::vector<Mn::Vector3>& verts,
-    const std::set<uint32_t>& setOfIDXs) {
+    Cr::Containers::ArrayView<const uint32_t> idxs) {
+  return geo::computeAABB(Cr::Containers::arrayView(verts), idxs);
+}
+
+Mn::Range3D computeAABBForVerts(const std::vector<Mn::Vector3>& verts,
+                                const std::set<uint32_t>& idxs) {
   Mn::Vector3 vertMax{-Mn::Constants::inf(), -Mn::Constants::inf(),
                       -Mn::Constants::inf()};
   Mn::Vector3 vertMin{Mn::Constants::inf(), Mn::Constants::inf(),
                       Mn::Constants::inf()};
 
-  for (uint32_t idx : setOfIDXs) {
+  for (uint32_t idx : idxs) {
     Mn::Vector3 vert = verts[idx];
     vertMax = Mn::Math::max(vertMax, vert);
     vertMin = Mn::Math::min(vertMin, vert);
   }
+  return {vertMin, vertMax};
+}
+
+/**
+ * @brief Build a bounding box around the verts at @p idxs in @p verts, either
+ * a world-space AABB or a minimum volume OBB.
+ */
+template <class Container>
+geo::OBB buildOBBForVerts(const std::vector<Mn::Vector3>& verts,
+                          const Container& idxs,
+                          bool minVolumeOBBs) {
+  if (minVolumeOBBs) {
+    std::vector<vec3f> points;
+    points.reserve(idxs.size());
+    for (uint32_t idx : idxs) {
+      points.emplace_back(Mn::EigenIntegration::cast<vec3f>(verts[idx]));
+    }
+    return geo::computeMinVolumeOBB(points);
+  }
 
-  Mn::Vector3 center = .5f * (vertMax + vertMin);
-  Mn::Vector3 dims = vertMax - vertMin;
+  const Mn::Range3D aabb = computeAABBForVerts(verts, idxs);
+  Mn::Vector3 center = aabb.center();
+  Mn::Vector3 dims = aabb.size();
+  return geo::OBB{Mn::EigenIntegration::cast<esp::vec3f>(center),
+                  Mn::EigenIntegration::cast<esp::vec3f>(dims),
+                  quatf::Identity()};
+}  // buildOBBForVerts
 
+/**
+ * @brief Build a @ref CCSemanticObject for a given set of vertex indices in
+ * @p verts list, with a bounding box around them.
+ * @param colorInt Semantic Color of object
+ * @param verts The mesh's vertex buffer.
+ * @param setOfIDXs set of vertex IDXs in the vertex buffer being used to
+ * build the resultant bounding box.
+ * @param minVolumeOBBs Whether to build a minimum volume OBB instead of an
+ * AABB.
+ */
+CCSemanticObject::ptr buildCCSemanticObjForSetOfVerts(
+    uint32_t colorInt,
+    const std::vector<Mn::Vector3>& verts,
+    const std::set<uint32_t>& setOfIDXs,
+    bool minVolumeOBBs) {
   auto obj =
       std::make_shared<CCSemanticObject>(CCSemanticObject(colorInt, setOfIDXs));
   // set obj's bounding box
-  obj->setObb(Mn::EigenIntegration::cast<esp::vec3f>(center),
-              Mn::EigenIntegration::cast<esp::vec3f>(dims), quatf::Identity());
+  obj->setObb(buildOBBForVerts(verts, setOfIDXs, minVolumeOBBs));
   return obj;
 }  // buildCCSemanticObjForSetOfVerts
 
@@ -327,24 +437,26 @@ SemanticScene::buildCCBasedSemanticObjs(
     const std::unordered_map<uint32_t, std::vector<std::set<uint32_t>>>&
         clrsToComponents,
     const std::shared_ptr<SemanticScene>& semanticScene) {
-  // build color-keyed map of lists of pairs of vert-count/bboxes
+  const bool minVolumeOBBs = semanticScene && semanticScene->useMinVolumeOBBs();
+  // build color-keyed map of lists of pairs of vert-count/bboxes, with every
+  // CC's bbox built in parallel
   std::unordered_map<uint32_t, std::vector<CCSemanticObject::ptr>>
       semanticCCObjsByVertTag(clrsToComponents.size());
+  std::vector<std::pair<uint32_t, const std::set<uint32_t>*>> vertSets;
+  std::vector<CCSemanticObject::ptr*> ccObjs;
   for (const auto& elem : clrsToComponents) {
-    const uint32_t colorKey = elem.first;
-    const std::vector<std::set<uint32_t>>& vectorOfSets = elem.second;
-    auto findIter = semanticCCObjsByVertTag.find(colorKey);
-    if (findIter == semanticCCObjsByVertTag.end()) {
-      // not found already - initialize new entry
-      findIter = semanticCCObjsByVertTag
-                     .emplace(colorKey, std::vector<CCSemanticObject::ptr>{})
-                     .first;
-    }
-    for (const std::set<uint32_t>& vertSet : vectorOfSets) {
-      findIter->second.emplace_back(
-          buildCCSemanticObjForSetOfVerts(colorKey, verts, vertSet));
+    std::vector<CCSemanticObject::ptr>& objs =
+        semanticCCObjsByVertTag[elem.first];
+    objs.resize(elem.second.size());
+    for (std::size_t i = 0; i < elem.second.size(); ++i) {
+      vertSets.emplace_back(elem.first, &elem.second[i]);
+      ccObjs.push_back(&objs[i]);
     }
   }
+  parallelFor(vertSets.size(), [&](std::size_t i) {
+    *ccObjs[i] = buildCCSemanticObjForSetOfVerts(
+        vertSets[i].first, verts, *vertSets[i].second, minVolumeOBBs);
+  });
 
   // only map to semantic ID if semanticScene exists, otherwise return map
   // with objects keyed by hex color
@@ -502,8 +614,8 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBsFromCCs(
         }
 
         // build CCSemanticObj, which will build
-        auto ccObbPtr =
-            buildCCSemanticObjForSetOfVerts(clrOfVerts, verts, setOfIDXs);
+        auto ccObbPtr = buildCCSemanticObjForSetOfVerts(
+            clrOfVerts, verts, setOfIDXs, semanticScene->useMinVolumeOBBs());
         // get merged sets' obb
         obbToUse = ccObbPtr->obb();
       }
@@ -523,45 +635,56 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBs(
     const std::vector<Mn::Vector3>& vertices,
     const std::vector<uint16_t>& vertSemanticIDs,
     const std::vector<std::shared_ptr<esp::scene::SemanticObject>>& ssdObjs,
-    const std::string& msgPrefix) {
+    const std::string& msgPrefix,
+    bool minVolumeOBBs) {
   // build per-SSD object vector of known semantic IDs
   // doing this in case semanticIDs are not contiguous.
   std::vector<int> semanticIDToSSOBJidx = getObjsIdxToIDMap(ssdObjs);
-
-  // aggegates of per-semantic ID mins and maxes
-  std::vector<Mn::Vector3> vertMax(
-      semanticIDToSSOBJidx.size(),
-      {-Mn::Constants::inf(), -Mn::Constants::inf(), -Mn::Constants::inf()});
-  std::vector<Mn::Vector3> vertMin(
-      semanticIDToSSOBJidx.size(),
-      {Mn::Constants::inf(), Mn::Constants::inf(), Mn::Constants::inf()});
-  std::vector<int> vertCounts(semanticIDToSSOBJidx.size());
-
-  // for each vertex, map vert min and max for each known semantic ID
-  // Known semantic IDs are expected to be contiguous, and correspond to the
-  // number of unique ssdObjs mappings.
-
-  for (int vertIdx = 0; vertIdx < vertSemanticIDs.size(); ++vertIdx) {
-    // semantic ID on vertex - valid values are
-    // 1->semanticIDToSSOBJidx.size(). Invalid/unknown semantic ids are >
-    // semanticIDToSSOBJidx.size()
-    const auto semanticID = vertSemanticIDs[vertIdx];
-    if ((semanticID >= 0) && (semanticID < semanticIDToSSOBJidx.size())) {
-      const auto vert = vertices[vertIdx];
-      // FOR VERT-BASED OBB CALC
-      // only support bbs for known colors that map to semantic objects
-      vertMax[semanticID] = Mn::Math::max(vertMax[semanticID], vert);
-      vertMin[semanticID] = Mn::Math::min(vertMin[semanticID], vert);
-      vertCounts[semanticID] += 1;
+  const std::size_t numSemanticIDs = semanticIDToSSOBJidx.size();
+
+  // bucket the verts by known semantic ID, so every ID's bbox can be built
+  // independently. Known semantic IDs are expected to be contiguous, and
+  // correspond to the number of unique ssdObjs mappings. Invalid/unknown
+  // semantic ids are >= semanticIDToSSOBJidx.size()
+  std::vector<uint32_t> vertOffsets(numSemanticIDs + 1, 0);
+  for (const auto semanticID : vertSemanticIDs) {
+    if (semanticID < numSemanticIDs) {
+      ++vertOffsets[semanticID + 1];
+    }
+  }
+  for (std::size_t i = 0; i < numSemanticIDs; ++i) {
+    vertOffsets[i + 1] += vertOffsets[i];
+  }
+  std::vector<uint32_t> vertIdxsByID(vertOffsets[numSemanticIDs]);
+  {
+    std::vector<uint32_t> fill(vertOffsets.begin(), vertOffsets.end() - 1);
+    for (uint32_t vertIdx = 0; vertIdx < vertSemanticIDs.size(); ++vertIdx) {
+      const auto semanticID = vertSemanticIDs[vertIdx];
+      if (semanticID < numSemanticIDs) {
+        vertIdxsByID[fill[semanticID]++] = vertIdx;
+      }
     }
   }
 
+  // FOR VERT-BASED OBB CALC
+  // only support bbs for known colors that map to semantic objects
+  std::vector<geo::OBB> obbs(numSemanticIDs);
+  parallelFor(numSemanticIDs, [&](std::size_t semanticID) {
+    if (semanticIDToSSOBJidx[semanticID] == -1 ||
+        vertOffsets[semanticID] == vertOffsets[semanticID + 1]) {
+      return;
+    }
+    obbs[semanticID] = buildOBBForVerts(
+        vertices,
+        Cr::Containers::arrayView(vertIdxsByID)
+            .slice(vertOffsets[semanticID], vertOffsets[semanticID + 1]),
+        minVolumeOBBs);
+  });
+
   std::vector<uint32_t> unMappedObjectIDXs;
 
-  // with mins/maxs per ID, map to objs
-  // give each ssdObj the values to build its OBB
-  for (int semanticID = 0; semanticID < semanticIDToSSOBJidx.size();
-       ++semanticID) {
+  // give each ssdObj its OBB
+  for (int semanticID = 0; semanticID < numSemanticIDs; ++semanticID) {
     // no index corresponds with given semantic ID
     if (semanticIDToSSOBJidx[semanticID] == -1) {
       continue;
@@ -570,38 +693,137 @@ std::vector<uint32_t> SemanticScene::buildSemanticOBBs(
     uint32_t objIdx = semanticIDToSSOBJidx[semanticID];
     // get object with given semantic ID
     auto& ssdObj = *ssdObjs[objIdx];
-    Mn::Vector3 center{};
-    Mn::Vector3 dims{};
+    const uint32_t vertCount =
+        vertOffsets[semanticID + 1] - vertOffsets[semanticID];
 
-    if (vertCounts[semanticID] == 0) {
+    if (vertCount == 0) {
       // keep a record of semantic IDs without any corresponding verts
       unMappedObjectIDXs.emplace_back(objIdx);
       // ESP_DEBUG() << Cr::Utility::formatString(
       //     "{} Semantic ID : {} : color : {} tag : {} | No verts have color
       //     for " "specified Semantic ID.", msgPrefix, semanticID,
       //     geo::getColorAsString(ssdObj.getColor()), ssdObj.id());
+      ssdObj.setObb(vec3f::Zero(), vec3f::Zero());
     } else {
-      center = .5f * (vertMax[semanticID] + vertMin[semanticID]);
-      dims = vertMax[semanticID] - vertMin[semanticID];
+      const vec3f center = obbs[semanticID].center();
+      const vec3f dims = obbs[semanticID].sizes();
       ESP_VERY_VERBOSE() << Cr::Utility::formatString(
           "{} Semantic ID : {} : color : {} tag : {} present in {} verts | "
           "BB "
           "Center [{} {} {}] Dims [{} {} {}]",
           msgPrefix, semanticID, geo::getColorAsString(ssdObj.getColor()),
-          ssdObj.id(), vertCounts[semanticID], center.x(), center.y(),
-          center.z(), dims.x(), dims.y(), dims.z());
+          ssdObj.id(), vertCount, center.x(), center.y(), center.z(),
+          dims.x(), dims.y(), dims.z());
+      ssdObj.setObb(obbs[semanticID]);
     }
-    ssdObj.setObb(Mn::EigenIntegration::cast<esp::vec3f>(center),
-                  Mn::EigenIntegration::cast<esp::vec3f>(dims));
   }
   // return listing of semantic object idxs that have no presence in the mesh
   return unMappedObjectIDXs;
 }  // SemanticScene::buildSemanticOBBs
 
+void SemanticScene::buildRegionIndex() {
+  regionIndex_ = {};
+  regionIndex_.numRegions = regions_.size();
+
+  // regions with an empty bounding box can't contain any point, so they can
+  // be left out of the index completely
+  Mn::Vector2 min{std::numeric_limits<float>::max()};
+  Mn::Vector2 max{-std::numeric_limits<float>::max()};
+  float extentSum = 0.0f;
+  int numIndexed = 0;
+  for (const auto& region : regions_) {
+    const box3f& bbox = region->bbox_;
+    if (bbox.isEmpty()) {
+      continue;
+    }
+    min = Mn::Math::min(min, Mn::Vector2{bbox.min().x(), bbox.min().z()});
+    max = Mn::Math::max(max, Mn::Vector2{bbox.max().x(), bbox.max().z()});
+    extentSum += std::max(bbox.sizes().x(), bbox.sizes().z());
+    ++numIndexed;
+  }
+  if (numIndexed == 0) {
+    regionIndex_.cellOffsets = {0, 0};
+    regionIndex_.size = {1, 1};
+    return;
+  }
+
+  // cells about half the average region size keep the per-cell lists short,
+  // capped so degenerate layouts don't blow up the grid
+  constexpr int maxCellsPerSide = 256;
+  const Mn::Vector2 extent = max - min;
+  regionIndex_.origin = min;
+  regionIndex_.cellSize =
+      std::max({0.5f * extentSum / numIndexed,
+                extent.max() / (maxCellsPerSide - 1), 1.0e-3f});
+  regionIndex_.size =
+      Mn::Vector2i{Mn::Math::floor(extent / regionIndex_.cellSize)} +
+      Mn::Vector2i{1};
+
+  // count, then fill, so the cells end up in one contiguous array
+  const std::size_t numCells = regionIndex_.size.product();
+  std::vector<int>& offsets = regionIndex_.cellOffsets;
+  offsets.assign(numCells + 1, 0);
+  auto forEachCell = [&](const box3f& bbox, auto&& fn) {
+    const Mn::Vector2i cellMin{Mn::Math::floor(
+        (Mn::Vector2{bbox.min().x(), bbox.min().z()} - regionIndex_.origin) /
+        regionIndex_.cellSize)};
+    const Mn::Vector2i cellMax = Mn::Math::min(
+        Mn::Vector2i{Mn::Math::floor(
+            (Mn::Vector2{bbox.max().x(), bbox.max().z()} -
+             regionIndex_.origin) /
+            regionIndex_.cellSize)},
+        regionIndex_.size - Mn::Vector2i{1});
+    for (int z = cellMin.y(); z <= cellMax.y(); ++z) {
+      for (int x = cellMin.x(); x <= cellMax.x(); ++x) {
+        fn(z * regionIndex_.size.x() + x);
+      }
+    }
+  };
+  for (const auto& region : regions_) {
+    if (!region->bbox_.isEmpty()) {
+      forEachCell(region->bbox_, [&](int cell) { ++offsets[cell + 1]; });
+    }
+  }
+  for (std::size_t c = 0; c < numCells; ++c) {
+    offsets[c + 1] += offsets[c];
+  }
+  regionIndex_.cellRegions.resize(offsets.back());
+  std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+  for (int rix = 0; rix < regions_.size(); ++rix) {
+    if (!regions_[rix]->bbox_.isEmpty()) {
+      forEachCell(regions_[rix]->bbox_, [&](int cell) {
+        regionIndex_.cellRegions[fill[cell]++] = rix;
+      });
+    }
+  }
+}  // SemanticScene::buildRegionIndex
+
 std::vector<int> SemanticScene::getRegionsForPoint(
     const Mn::Vector3& point) const {
   std::vector<int> containingRegions;
-  for (int rix = 0; rix < regions_.size(); ++rix) {
+  if (regionIndex_.numRegions != regions_.size()) {
+    for (int rix = 0; rix < regions_.size(); ++rix) {
+      if (regions_[rix]->contains(point)) {
+        containingRegions.push_back(rix);
+      }
+    }
+    return containingRegions;
+  }
+
+  // every region containing the point overlaps its cell, points outside of
+  // the grid aren't in any region
+  const Mn::Vector2 cellCoords =
+      (Mn::Vector2{point.x(), point.z()} - regionIndex_.origin) /
+      regionIndex_.cellSize;
+  if (!(cellCoords >= Mn::Vector2{0.0f}).all() ||
+      !(cellCoords < Mn::Vector2{regionIndex_.size}).all()) {
+    return containingRegions;
+  }
+  const Mn::Vector2i cell{Mn::Math::floor(cellCoords)};
+  const int c = cell.y() * regionIndex_.size.x() + cell.x();
+  for (int i = regionIndex_.cellOffsets[c];
+       i < regionIndex_.cellOffsets[c + 1]; ++i) {
+    const int rix = regionIndex_.cellRegions[i];
     if (regions_[rix]->contains(point)) {
       containingRegions.push_back(rix);
     }
@@ -646,41 +868,38 @@ std::vector<std::pair<int, double>> SemanticScene::getWeightedRegionsForPoint(
 
 std::vector<std::pair<int, double>> SemanticScene::getRegionsForPoints(
     const std::vector<Mn::Vector3>& points) const {
-  // Weights for every point for every region
-  std::vector<std::vector<double>> regAreaWeightsForPoints;
-  regAreaWeightsForPoints.reserve(points.size());
-  for (int i = 0; i < points.size(); ++i) {
-    // Get this point's weighted regions
-    auto regWeightsForPoint = getWeightedRegionsForPoint(points[i]);
-    // Initialize all region weights to be 0
-    std::vector<double> allRegionWeights(regions_.size(), 0);
-    // Set the weight for the containing region with the smallest area (if
-    // nested regions) for this particular point.
-    // Set the vote for each region to be equal.
-    for (const std::pair<int, double>& regionWeight : regWeightsForPoint) {
-      allRegionWeights[regionWeight.first] = 1.0;
+  // Number of points contained in every region. Every containing region gets
+  // an equal vote from a point, regardless of nesting.
+  std::vector<int> numPointsInRegion(regions_.size(), 0);
+  // points outside of a region's bbox can't be in the region, so the exact
+  // test runs only on the points a batched bbox test lets through. Regions
+  // not overlapping the points at all are skipped right away.
+  const Mn::Range3D pointsBox =
+      geo::computeAABB(Cr::Containers::arrayView(points));
+  Cr::Containers::Array<bool> inBox{Cr::Containers::NoInit, points.size()};
+  for (int rix = 0; rix < regions_.size(); ++rix) {
+    const SemanticRegion& region = *regions_[rix];
+    const Mn::Range3D regionBox{region.bbox_};
+    if (points.empty() || (regionBox.min() > pointsBox.max()).any() ||
+        (regionBox.max() < pointsBox.min()).any() ||
+        !geo::pointsInAABB(regionBox, Cr::Containers::arrayView(points),
+                           inBox)) {
+      continue;
+    }
+    for (std::size_t i = 0; i != points.size(); ++i) {
+      if (inBox[i] && region.contains(points[i])) {
+        ++numPointsInRegion[rix];
+      }
     }
-    // Save this points region weight vector
-    regAreaWeightsForPoints.emplace_back(allRegionWeights);
   }
 
   std::vector<std::pair<int, double>> containingRegionWeights;
-  // Will only have at max the number of regions in the scene
-  containingRegionWeights.reserve(regions_.size());
   for (int rix = 0; rix < regions_.size(); ++rix) {
-    double containmentWeight = 0;
-    for (int i = 0; i < points.size(); ++i) {
-      std::vector<double> regWtsForPoint = regAreaWeightsForPoints[i];
-      containmentWeight += regWtsForPoint[rix];
-    }
-    if (containmentWeight > 0) {
-      containingRegionWeights.emplace_back(
-          std::pair<int, double>(rix, containmentWeight / points.size()));
+    if (numPointsInRegion[rix] > 0) {
+      containingRegionWeights.emplace_back(std::pair<int, double>(
+          rix, double(numPointsInRegion[rix]) / points.size()));
     }
   }
-  // Free up unused capacity - every region probably does not contain a tested
-  // point
-  containingRegionWeights.shrink_to_fit();
   std::sort(containingRegionWeights.begin(), containingRegionWeights.end(),
             [](const std::pair<int, double>& a, std::pair<int, double>& b) {
               return a.second > b.second;
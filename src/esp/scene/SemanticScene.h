@@ -6,7 +6,9 @@
 #define ESP_SCENE_SEMANTICSCENE_H_
 
 #include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Path.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -15,6 +17,7 @@
 
 #include "esp/core/Esp.h"
 #include "esp/geo/OBB.h"
+#include "esp/io/Io.h"
 #include "esp/io/Json.h"
 
 namespace esp {
@@ -209,6 +212,8 @@ class SemanticScene {
    * expected to start at 1 and be contiguous, followed by unknown semantic IDs
    * @param ssdObjs The known semantic scene descriptor objects for the mesh
    * @param msgPrefix Debug message prefix, referencing caller.
+   * @param minVolumeOBBs Whether to build tight, arbitrarily oriented OBBs
+   * instead of AABBs, see @ref useMinVolumeOBBs.
    * @return vector of semantic object IDXs that have no vertex mapping/presence
    * in the source mesh.
    */
@@ -216,7 +221,8 @@ class SemanticScene {
       const std::vector<Mn::Vector3>& verts,
       const std::vector<uint16_t>& vertSemanticIDs,
       const std::vector<std::shared_ptr<SemanticObject>>& ssdObjs,
-      const std::string& msgPrefix);
+      const std::string& msgPrefix,
+      bool minVolumeOBBs = false);
 
   /**
    * @brief Build semantic object OBBs based on the accumulated
@@ -284,6 +290,22 @@ class SemanticScene {
    */
   float CCFractionToUseForBBox() const { return ccLargestVolToUseForBBox_; }
 
+  /**
+   * @brief Whether bounding boxes built around vertex annotations are tight,
+   * approximately minimum volume OBBs (see @ref geo::computeMinVolumeOBB)
+   * instead of world-space AABBs. Only used if @ref buildBBoxFromVertColors
+   * is true.
+   */
+  bool useMinVolumeOBBs() const { return useMinVolumeOBBs_; }
+
+  /**
+   * @brief Set whether bounding boxes built around vertex annotations are
+   * minimum volume OBBs, see @ref useMinVolumeOBBs.
+   */
+  void setUseMinVolumeOBBs(bool useMinVolumeOBBs) {
+    useMinVolumeOBBs_ = useMinVolumeOBBs;
+  }
+
   /**
    * @brief Compute all SemanticRegions which contain the point and return a
    * list of indices for regions in this SemanticScene.
@@ -315,6 +337,18 @@ class SemanticScene {
   std::vector<std::pair<int, double>> getRegionsForPoints(
       const std::vector<Mn::Vector3>& points) const;
 
+  /**
+   * @brief Build the spatial index used by the region queries above.
+   *
+   * Regions are bucketed by the x-z extent of their bounding box on a
+   * uniform grid, so a query only tests the regions overlapping the point's
+   * cell instead of every region in the scene. Called automatically when
+   * regions are loaded through @ref loadSemanticSceneDescriptor. Queries fall
+   * back to testing every region while the index is out of date with
+   * @ref regions.
+   */
+  void buildRegionIndex();
+
  protected:
   /**
    * @brief Verify a requested file exists.
@@ -324,7 +358,7 @@ class SemanticScene {
    */
   static bool checkFileExists(const std::string& filename,
                               const std::string& srcFunc) {
-    if (!Cr::Utility::Path::exists(filename)) {
+    if (!io::pathExists(filename)) {
       ESP_WARNING(Mn::Debug::Flag::NoSpace)
           << "::" << srcFunc << ": File" << filename
           << "does not exist.  Aborting load.";
@@ -334,31 +368,42 @@ class SemanticScene {
   }  // checkFileExists
 
   /**
-   * @brief Build the HM3D semantic data from the passed file stream.  File
-   * being streamed is expected to be appropriate format.
-   * @param ifs The opened file stream describing the HM3D semantic annotations.
+   * @brief Map the text semantic descriptor @p filename into memory and pass
+   * its header line and the rest of the file to @p build. The text is only
+   * valid during the call.
+   * @return Whatever @p build returned, false if the file can't be read
+   */
+  static bool readHouseText(
+      const std::string& filename,
+      const std::function<bool(Corrade::Containers::StringView header,
+                               Corrade::Containers::StringView text)>& build);
+
+  /**
+   * @brief Build the HM3D semantic data from the passed file contents. The
+   * contents are expected to be of appropriate format.
+   * @param text The HM3D semantic annotations following the header line.
    * @param scene reference to sceneNode to assign semantic scene to
    * @param rotation rotation to apply to semantic scene upon load (currently
    * not used for HM3D)
    * @return successfully built. Currently only returns true, but retaining
    * return value for future support.
    */
-  static bool buildHM3DHouse(std::ifstream& ifs,
+  static bool buildHM3DHouse(Corrade::Containers::StringView text,
                              SemanticScene& scene,
                              CORRADE_UNUSED const quatf& rotation =
                                  quatf::FromTwoVectors(-vec3f::UnitZ(),
                                                        geo::ESP_GRAVITY));
   /**
-   * @brief Build the mp3 semantic data from the passed file stream. File being
-   * streamed is expected to be appropriate format.
-   * @param ifs The opened file stream describing the Mp3d semantic annotations.
+   * @brief Build the mp3 semantic data from the passed file contents. The
+   * contents are expected to be of appropriate format.
+   * @param text The Mp3d semantic annotations following the header line.
    * @param scene reference to sceneNode to assign semantic scene to
    * @param rotation rotation to apply to semantic scene upon load.
    * @return successfully built. Currently only returns true, but retaining
    * return value for future support.
    */
   static bool buildMp3dHouse(
-      std::ifstream& ifs,
+      Corrade::Containers::StringView text,
       SemanticScene& scene,
       const quatf& rotation = quatf::FromTwoVectors(-vec3f::UnitZ(),
                                                     geo::ESP_GRAVITY));
@@ -411,6 +456,12 @@ class SemanticScene {
    */
   float ccLargestVolToUseForBBox_ = 0.0f;
 
+  /**
+   * @brief Whether to build minimum volume OBBs instead of AABBs around vertex
+   * annotations.
+   */
+  bool useMinVolumeOBBs_ = false;
+
   std::string name_;
   std::string label_;
   box3f bbox_;
@@ -433,6 +484,23 @@ class SemanticScene {
   std::unordered_map<uint32_t, std::pair<int, int>>
       semanticColorToIdAndRegion_{};
 
+  /**
+   * @brief Uniform x-z grid over the bounding boxes of @ref regions_, built
+   * by @ref buildRegionIndex.
+   */
+  struct RegionIndex {
+    //! Number of regions the index was built for, used to detect staleness
+    std::size_t numRegions = 0;
+    Mn::Vector2 origin;
+    float cellSize = 1.0f;
+    Mn::Vector2i size;
+    //! Region indices overlapping cell `c`, in increasing order, are
+    //! `cellRegions[cellOffsets[c]]` to `cellRegions[cellOffsets[c + 1]]`
+    std::vector<int> cellOffsets;
+    std::vector<int> cellRegions;
+  };
+  RegionIndex regionIndex_;
+
   ESP_SMART_POINTERS(SemanticScene)
 };
 
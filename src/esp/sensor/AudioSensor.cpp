@@ -2,11 +2,15 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <cmath>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "AudioSensor.h"
+#include "esp/core/Check.h"
+#include "esp/nav/PathFinder.h"
 #include "esp/sim/Simulator.h"
 
 namespace esp {
@@ -73,8 +77,18 @@ AudioSensor::~AudioSensor() {
 
 #ifdef ESP_BUILD_WITH_AUDIO
 void AudioSensor::reset() {
-  audioSimulator_ = nullptr;
   impulseResponse_.clear();
+  irFromCache_ = false;
+  if (audioSimulator_ && audioSensorSpec_->cacheSceneGeometry_ &&
+      !uploadedSceneKey_.empty()) {
+    // keep the uploaded geometry, the listener is added anew on the next
+    // transform update
+    lastAgentPos_ = {__FLT_MIN__, __FLT_MIN__, __FLT_MIN__};
+    return;
+  }
+  audioSimulator_ = nullptr;
+  semanticGeometry_ = nullptr;
+  uploadedSceneKey_.clear();
 }
 
 void AudioSensor::setAudioSourceTransform(const Magnum::Vector3& sourcePos) {
@@ -101,19 +115,51 @@ void AudioSensor::setAudioListenerTransform(
   //    add a listener
   if (newInitialization_ || (lastAgentPos_ != agentPos) ||
       (lastAgentRot_ != agentRotQuat)) {
-    audioSimulator_->AddListener(
-        RLRAudioPropagation::Vector3f{agentPos[0], agentPos[1], agentPos[2]},
-        RLRAudioPropagation::Quaternion{agentRotQuat[0], agentRotQuat[1],
-                                        agentRotQuat[2], agentRotQuat[3]},
-        audioSensorSpec_->channelLayout_);
+    lastAgentPos_ = agentPos;
+    lastAgentRot_ = agentRotQuat;
+    addListener();
   }
 }
 
+void AudioSensor::addListener() {
+  audioSimulator_->AddListener(
+      RLRAudioPropagation::Vector3f{lastAgentPos_[0], lastAgentPos_[1],
+                                    lastAgentPos_[2]},
+      RLRAudioPropagation::Quaternion{lastAgentRot_[0], lastAgentRot_[1],
+                                      lastAgentRot_[2], lastAgentRot_[3]},
+      audioSensorSpec_->channelLayout_);
+}
+
 void AudioSensor::runSimulation(sim::Simulator& sim) {
   CORRADE_ASSERT(audioSimulator_,
                  "runSimulation: audioSimulator_ should exist", );
   ESP_DEBUG() << logHeader_ << "Running the audio simulator";
 
+  const std::string sceneKey = getSceneGeometryKey(sim);
+  if (!newInitialization_ && sceneKey != uploadedSceneKey_) {
+    // the stage changed since the geometry was uploaded, start over with
+    // the current source and listener
+    ESP_DEBUG() << logHeader_ << "Stage changed, recreating the simulator";
+    audioSimulator_ = std::make_unique<RLRAudioPropagation::Simulator>();
+    audioSimulator_->Configure(audioSensorSpec_->acousticsConfig_);
+    audioMaterialsJsonSet_ = false;
+    newInitialization_ = true;
+    newSource_ = true;
+    addListener();
+  }
+
+  // a cached response needs neither the geometry nor the source uploaded
+  const std::string irCacheKey = getIRCacheKey(sceneKey);
+  if (!irCacheKey.empty()) {
+    if (const ImpulseResponseCache::ImpulseResponse* cached =
+            irCache_->find(irCacheKey)) {
+      ESP_DEBUG() << logHeader_ << "Using a cached impulse response";
+      impulseResponse_ = *cached;
+      irFromCache_ = true;
+      return;
+    }
+  }
+
   if (newInitialization_) {
     // If its a new initialization, upload the geometry
     newInitialization_ = false;
@@ -133,6 +179,7 @@ void AudioSensor::runSimulation(sim::Simulator& sim) {
                      "will use default material";
       loadMesh(sim);
     }
+    uploadedSceneKey_ = sceneKey;
   }
 
   if (newSource_) {
@@ -144,7 +191,7 @@ void AudioSensor::runSimulation(sim::Simulator& sim) {
     ESP_DEBUG() << logHeader_
                 << "Adding source at position : " << lastSourcePos_;
     audioSimulator_->AddSource(RLRAudioPropagation::Vector3f{
-        lastSourcePos_[1], lastSourcePos_[2], lastSourcePos_[3]});
+        lastSourcePos_[0], lastSourcePos_[1], lastSourcePos_[2]});
   }
 
   // Run the audio simulation
@@ -154,6 +201,100 @@ void AudioSensor::runSimulation(sim::Simulator& sim) {
 
   // Each time simulation is run, clear the impulse response
   impulseResponse_.clear();
+  irFromCache_ = false;
+  if (!irCacheKey.empty()) {
+    irCache_->insert(irCacheKey, getIR());
+  }
+}
+
+std::string AudioSensor::getIRCacheKey(const std::string& sceneKey) {
+  if (audioSensorSpec_->irCacheGridSize_ <= 0.0f) {
+    return {};
+  }
+  if (!irCache_) {
+    irCache_ = std::make_unique<ImpulseResponseCache>(
+        audioSensorSpec_->irCacheGridSize_,
+        audioSensorSpec_->irCacheRotationStep_,
+        audioSensorSpec_->irCacheMemoryBudget_);
+  }
+  // the listener rotation is passed as (w, x, y, z)
+  return irCache_->key(
+      sceneKey + '\0' + audioMaterialsJSON_, lastSourcePos_, lastAgentPos_,
+      Magnum::Quaternion{{lastAgentRot_[1], lastAgentRot_[2], lastAgentRot_[3]},
+                         lastAgentRot_[0]});
+}
+
+std::size_t AudioSensor::precomputeIRCache(
+    sim::Simulator& sim,
+    nav::PathFinder& pathfinder,
+    const std::vector<Magnum::Vector4>& listenerRotQuats,
+    const float listenerHeight) {
+  const float gridSize = audioSensorSpec_->irCacheGridSize_;
+  ESP_CHECK(gridSize > 0.0f,
+            "AudioSensor::precomputeIRCache(): the impulse response cache is "
+            "disabled");
+  ESP_CHECK(pathfinder.isLoaded(),
+            "AudioSensor::precomputeIRCache(): the navmesh is not loaded");
+
+  // grid points are snapped to the navmesh, several floors are covered by
+  // stepping through the height as well, points that snap to the same cell
+  // are only simulated once
+  const std::pair<vec3f, vec3f> bounds = pathfinder.bounds();
+  const Magnum::Vector3i min{
+      int(std::floor(bounds.first[0] / gridSize)),
+      int(std::floor(bounds.first[1] / gridSize)),
+      int(std::floor(bounds.first[2] / gridSize))};
+  const Magnum::Vector3i max{int(std::ceil(bounds.second[0] / gridSize)),
+                             int(std::ceil(bounds.second[1] / gridSize)),
+                             int(std::ceil(bounds.second[2] / gridSize))};
+  std::unordered_set<std::string> visited;
+  std::size_t simulated = 0;
+  for (int y = min.y(); y <= max.y(); ++y) {
+    for (int z = min.z(); z <= max.z(); ++z) {
+      for (int x = min.x(); x <= max.x(); ++x) {
+        const Magnum::Vector3 cell =
+            Magnum::Vector3{Magnum::Vector3i{x, y, z}} * gridSize;
+        const Magnum::Vector3 point = pathfinder.snapPoint(cell);
+        if (std::isnan(point.x()) || (point - cell).length() > gridSize) {
+          continue;
+        }
+        const Magnum::Vector3 listener =
+            point + Magnum::Vector3::yAxis(listenerHeight);
+        for (const Magnum::Vector4& rotation : listenerRotQuats) {
+          setAudioListenerTransform(listener, rotation);
+          const std::string key = getIRCacheKey(getSceneGeometryKey(sim));
+          if (!visited.insert(key).second || irCache_->contains(key)) {
+            continue;
+          }
+          runSimulation(sim);
+          ++simulated;
+        }
+      }
+    }
+  }
+  ESP_DEBUG() << logHeader_ << "Precomputed" << simulated
+              << "impulse responses, the cache holds" << irCache_->size()
+              << "of them in" << irCache_->memoryUsage() << "bytes";
+  return simulated;
+}
+
+std::vector<std::vector<std::vector<float>>> AudioSensor::runSimulations(
+    sim::Simulator& sim,
+    const std::vector<Magnum::Vector3>& listenerPositions,
+    const std::vector<Magnum::Vector4>& listenerRotQuats) {
+  ESP_CHECK(listenerPositions.size() == listenerRotQuats.size(),
+            "AudioSensor::runSimulations(): got" << listenerPositions.size()
+                                                 << "positions but"
+                                                 << listenerRotQuats.size()
+                                                 << "rotations");
+  std::vector<std::vector<std::vector<float>>> impulseResponses;
+  impulseResponses.reserve(listenerPositions.size());
+  for (std::size_t i = 0; i != listenerPositions.size(); ++i) {
+    setAudioListenerTransform(listenerPositions[i], listenerRotQuats[i]);
+    runSimulation(sim);
+    impulseResponses.push_back(getIR());
+  }
+  return impulseResponses;
 }
 
 void AudioSensor::setAudioMaterialsJSON(const std::string& jsonPath) {
@@ -172,6 +313,7 @@ void AudioSensor::setAudioMaterialsJSON(const std::string& jsonPath) {
 }
 
 const std::vector<std::vector<float>>& AudioSensor::getIR() {
+  // a cached response is already in impulseResponse_
   if (impulseResponse_.empty()) {
     ObservationSpace obsSpace;
     getObservationSpace(obsSpace);
@@ -225,7 +367,9 @@ bool AudioSensor::getObservation(sim::Simulator&, Observation& obs) {
   for (std::size_t channelIndex = 0; channelIndex < obsSpace.shape[0];
        ++channelIndex) {
     const float* ir =
-        audioSimulator_->GetImpulseResponseForChannel(channelIndex);
+        irFromCache_
+            ? impulseResponse_[channelIndex].data()
+            : audioSimulator_->GetImpulseResponseForChannel(channelIndex);
     // Copy the ir for the specific channel into the data buffer
     memcpy(obs.buffer->data + bufIndex, ir, sizeToCopy);
     bufIndex += sizeToCopy;
@@ -252,8 +396,13 @@ bool AudioSensor::getObservationSpace(ObservationSpace& obsSpace) {
   // shape is a 2 ints
   //    index 0 = channel count
   //    index 1 = sample count
-  obsSpace.shape = {audioSimulator_->GetChannelCount(),
-                    audioSimulator_->GetSampleCount()};
+  if (irFromCache_ && !impulseResponse_.empty()) {
+    // the simulator may not have run anything yet
+    obsSpace.shape = {impulseResponse_.size(), impulseResponse_[0].size()};
+  } else {
+    obsSpace.shape = {audioSimulator_->GetChannelCount(),
+                      audioSimulator_->GetSampleCount()};
+  }
 
   obsSpace.dataType = core::DataType::DT_FLOAT;
 
@@ -290,51 +439,45 @@ void AudioSensor::createAudioSimulator() {
   audioSimulator_->Configure(audioSensorSpec_->acousticsConfig_);
 }
 
-void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
-  ESP_DEBUG() << logHeader_ << "Loading semantic mesh";
-
-  CORRADE_ASSERT(audioSimulator_,
-                 "loadSemanticMesh: audioSimulator_ should exist", );
+std::string AudioSensor::getSceneGeometryKey(sim::Simulator& sim) const {
+  auto stageAttrs = sim.getStageInitializationTemplate();
+  if (stageAttrs == nullptr) {
+    return {};
+  }
+  if (audioSensorSpec_->acousticsConfig_.enableMaterials &&
+      sim.semanticSceneExists()) {
+    return "semantic:" + stageAttrs->getSemanticAssetHandle();
+  }
+  return "render:" + stageAttrs->getRenderAssetHandle();
+}
 
-  // Load the audio materials JSON if it was set
-  if (!audioMaterialsJsonSet_ && audioMaterialsJSON_.size() > 0) {
-    auto errorCode =
-        audioSimulator_->LoadAudioMaterialJSON(audioMaterialsJSON_);
-    if (errorCode != RLRAudioPropagation::ErrorCodes::Success) {
-      ESP_ERROR() << "Audio material json could not be loaded. ErrorCode: "
-                  << static_cast<int>(errorCode)
-                  << ". Please check if the file exists and the format is "
-                     "correct. FilePath:"
-                  << audioMaterialsJSON_;
-      CORRADE_ASSERT(false, "", );
+std::shared_ptr<const AudioSensor::SemanticGeometry>
+AudioSensor::getSemanticGeometry(sim::Simulator& sim, const std::string& key) {
+  // sensors of all agents and simulators share the geometry of a stage, it's
+  // released once none of them uses it anymore
+  static std::mutex cacheMutex;
+  static std::unordered_map<std::string, std::weak_ptr<const SemanticGeometry>>
+      cache;
+  std::lock_guard<std::mutex> lock{cacheMutex};
+  if (!key.empty()) {
+    if (auto cached = cache[key].lock()) {
+      return cached;
     }
-    audioMaterialsJsonSet_ = true;
   }
 
+  auto geometry = std::make_shared<SemanticGeometry>();
   std::vector<std::uint16_t> objectIds;
 
-  sceneMesh_ = sim.getJoinedSemanticMesh(objectIds);
+  geometry->mesh = sim.getJoinedSemanticMesh(objectIds);
 
   std::shared_ptr<scene::SemanticScene> semanticScene = sim.getSemanticScene();
 
-  const std::vector<std::shared_ptr<scene::SemanticCategory>>& categories =
-      semanticScene->categories();
   const std::vector<std::shared_ptr<scene::SemanticObject>>& objects =
       semanticScene->objects();
 
-  RLRAudioPropagation::VertexData vertices;
-
-  vertices.vertices = sceneMesh_->vbo.data();
-  vertices.byteOffset = 0;
-  vertices.vertexCount = sceneMesh_->vbo.size();
-  vertices.vertexStride = 0;
-
-  // Send the vertex data
-  audioSimulator_->LoadMeshVertices(vertices);
-
   std::unordered_map<std::string, std::vector<uint32_t>> categoryNameToIndices;
 
-  auto& ibo = sceneMesh_->ibo;
+  auto& ibo = geometry->mesh->ibo;
   for (std::size_t iboIdx = 0; iboIdx < ibo.size(); iboIdx += 3) {
     // For each index in the ibo
     //  get the object id
@@ -382,19 +525,67 @@ void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
     categoryNameToIndices[catToUse].push_back(ibo[iboIdx + 2]);
   }
 
+  geometry->categoryIndices.reserve(categoryNameToIndices.size());
+  for (auto& catToIndices : categoryNameToIndices) {
+    geometry->categoryIndices.emplace_back(catToIndices.first,
+                                           std::move(catToIndices.second));
+  }
+
+  if (!key.empty()) {
+    cache[key] = geometry;
+  }
+  return geometry;
+}
+
+void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
+  ESP_DEBUG() << logHeader_ << "Loading semantic mesh";
+
+  CORRADE_ASSERT(audioSimulator_,
+                 "loadSemanticMesh: audioSimulator_ should exist", );
+
+  // Load the audio materials JSON if it was set
+  if (!audioMaterialsJsonSet_ && audioMaterialsJSON_.size() > 0) {
+    auto errorCode =
+        audioSimulator_->LoadAudioMaterialJSON(audioMaterialsJSON_);
+    if (errorCode != RLRAudioPropagation::ErrorCodes::Success) {
+      ESP_ERROR() << "Audio material json could not be loaded. ErrorCode: "
+                  << static_cast<int>(errorCode)
+                  << ". Please check if the file exists and the format is "
+                     "correct. FilePath:"
+                  << audioMaterialsJSON_;
+      CORRADE_ASSERT(false, "", );
+    }
+    audioMaterialsJsonSet_ = true;
+  }
+
+  semanticGeometry_ = getSemanticGeometry(sim, getSceneGeometryKey(sim));
+  sceneMesh_ = semanticGeometry_->mesh;
+
+  RLRAudioPropagation::VertexData vertices;
+
+  vertices.vertices = sceneMesh_->vbo.data();
+  vertices.byteOffset = 0;
+  vertices.vertexCount = sceneMesh_->vbo.size();
+  vertices.vertexStride = 0;
+
+  // Send the vertex data
+  audioSimulator_->LoadMeshVertices(vertices);
+
   std::size_t indicesLoaded = 0;
   std::size_t totalIndicesLoaded = 0;
 
   // Send indices by category
-  for (auto catToIndices : categoryNameToIndices) {
+  for (const auto& catToIndices : semanticGeometry_->categoryIndices) {
     RLRAudioPropagation::IndexData indices;
 
-    indices.indices = catToIndices.second.data();
+    // the engine only reads the indices
+    indices.indices = const_cast<uint32_t*>(catToIndices.second.data());
     indices.byteOffset = 0;
     indices.indexCount = catToIndices.second.size();
 
     ++indicesLoaded;
-    const bool lastUpdate = (indicesLoaded == categoryNameToIndices.size());
+    const bool lastUpdate =
+        (indicesLoaded == semanticGeometry_->categoryIndices.size());
 
     ESP_DEBUG() << logHeader_ << "Vertex count : " << vertices.vertexCount
                 << ", Index count : " << indices.indexCount
@@ -421,6 +612,7 @@ void AudioSensor::loadSemanticMesh(sim::Simulator& sim) {
 void AudioSensor::loadMesh(sim::Simulator& sim) {
   ESP_DEBUG() << logHeader_ << "Loading non-semantic mesh";
   CORRADE_ASSERT(audioSimulator_, "loadMesh: audioSimulator_ should exist", );
+  semanticGeometry_ = nullptr;
   sceneMesh_ = sim.getJoinedMesh(true);
 
   RLRAudioPropagation::VertexData vertices;
@@ -5,11 +5,14 @@
 #include <cstdint>
 #include <fstream>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
 #include "esp/scene/SemanticScene.h"
+#include "esp/sensor/ImpulseResponseCache.h"
 #include "esp/sensor/Sensor.h"
 
 #ifdef ESP_BUILD_WITH_AUDIO
@@ -22,6 +25,9 @@
 #define ESP_SENSOR_AUDIOSENSOR_H_
 
 namespace esp {
+namespace nav {
+class PathFinder;
+}
 namespace sensor {
 
 struct AudioSensorSpec : public SensorSpec {
@@ -36,6 +42,27 @@ struct AudioSensorSpec : public SensorSpec {
   RLRAudioPropagation::Configuration acousticsConfig_;
   RLRAudioPropagation::ChannelLayout channelLayout_;
   std::string outputDirectory_;
+  /**
+   * Keep the acoustic simulator and the scene geometry uploaded to it across
+   * @ref AudioSensor::reset() calls, as long as the stage doesn't change.
+   * Static objects are assumed to not change between such resets.
+   */
+  bool cacheSceneGeometry_ = true;
+  /**
+   * Size of the grid cells source and listener positions are quantized to
+   * for caching impulse responses, see @ref ImpulseResponseCache. Zero
+   * disables the cache.
+   */
+  float irCacheGridSize_ = 0.0f;
+  /**
+   * Quantization step of the listener rotation quaternion components for
+   * caching impulse responses
+   */
+  float irCacheRotationStep_ = 0.05f;
+  /**
+   * Bytes of cached impulse response samples to keep at most
+   */
+  std::size_t irCacheMemoryBudget_ = std::size_t{512} << 20;
 #endif  // ESP_BUILD_WITH_AUDIO
 
  public:
@@ -62,6 +89,10 @@ class AudioSensor : public Sensor {
 #ifdef ESP_BUILD_WITH_AUDIO
   /**
    * @brief Clear the audio simulator object
+   *
+   * If @ref AudioSensorSpec::cacheSceneGeometry_ is set, the simulator and its
+   * scene geometry are kept for the next simulation, unless the stage
+   * changes in the meantime.
    * */
   void reset();
 
@@ -85,6 +116,46 @@ class AudioSensor : public Sensor {
    * */
   void runSimulation(sim::Simulator& sim);
 
+  /**
+   * @brief Run the audio simulation for several listener poses at once
+   * @param listenerPositions = vec3 listener positions
+   * @param listenerRotQuats = vec4 listener rotation quaternions, one for
+   * each position
+   * @return the impulse responses, indexed by listener, channel and sample
+   *
+   * The scene geometry and the source are uploaded only once for all of them.
+   * */
+  std::vector<std::vector<std::vector<float>>> runSimulations(
+      sim::Simulator& sim,
+      const std::vector<Magnum::Vector3>& listenerPositions,
+      const std::vector<Magnum::Vector4>& listenerRotQuats);
+
+  /**
+   * @brief Fill the impulse response cache for all navigable grid points
+   * @param pathfinder = navmesh the grid points are snapped to
+   * @param listenerRotQuats = vec4 listener rotation quaternions to simulate
+   * at each point
+   * @param listenerHeight = height of the listener above the navmesh
+   * @return the number of impulse responses simulated
+   *
+   * Uses the last set source position. Expects that
+   * @ref AudioSensorSpec::irCacheGridSize_ is set. Points already cached are
+   * skipped, and if all points don't fit into
+   * @ref AudioSensorSpec::irCacheMemoryBudget_, the first simulated ones are
+   * evicted again.
+   * */
+  std::size_t precomputeIRCache(
+      sim::Simulator& sim,
+      nav::PathFinder& pathfinder,
+      const std::vector<Magnum::Vector4>& listenerRotQuats,
+      float listenerHeight);
+
+  /**
+   * @brief The impulse response cache, @cpp nullptr @ce if disabled or not
+   * used yet
+   * */
+  const ImpulseResponseCache* irCache() const { return irCache_.get(); }
+
   /**
    * @brief Set the audio materials database from a json file
    * */
@@ -106,6 +177,15 @@ class AudioSensor : public Sensor {
 
 #ifdef ESP_BUILD_WITH_AUDIO
  private:
+  /**
+   * @brief Semantic mesh of a stage with its triangle indices grouped by
+   * material category, shared by all sensors using the stage
+   */
+  struct SemanticGeometry {
+    esp::assets::MeshData::ptr mesh;
+    std::vector<std::pair<std::string, std::vector<uint32_t>>> categoryIndices;
+  };
+
   /**
    * @brief Create the audio simulator object
    * */
@@ -121,6 +201,31 @@ class AudioSensor : public Sensor {
    * */
   void loadMesh(sim::Simulator& sim);
 
+  /**
+   * @brief Identifies the geometry @ref runSimulation would upload for the
+   * current stage, empty if there's no stage
+   * */
+  std::string getSceneGeometryKey(sim::Simulator& sim) const;
+
+  /**
+   * @brief Get the semantic geometry of the current stage, built on first
+   * use and kept while any sensor uses it
+   * */
+  static std::shared_ptr<const SemanticGeometry> getSemanticGeometry(
+      sim::Simulator& sim,
+      const std::string& key);
+
+  /**
+   * @brief Add the listener at the last set transform
+   * */
+  void addListener();
+
+  /**
+   * @brief Key of the last set source and listener transforms in
+   * @ref irCache_, creating the cache if needed. Empty if disabled.
+   * */
+  std::string getIRCacheKey(const std::string& sceneKey);
+
   /**
    * @brief Get the simulation folder path.
    * This path is based on the AudioSensorSpec->outputDirectoryPrefix and the
@@ -140,9 +245,15 @@ class AudioSensor : public Sensor {
 
 #ifdef ESP_BUILD_WITH_AUDIO
   std::unique_ptr<RLRAudioPropagation::Simulator> audioSimulator_ = nullptr;
+  //! semantic geometry uploaded to the simulator, if any
+  std::shared_ptr<const SemanticGeometry> semanticGeometry_;
+  //! impulse responses of visited poses, created on first use
+  ImpulseResponseCache::uptr irCache_;
 #endif  // ESP_BUILD_WITH_AUDIO
 
   esp::assets::MeshData::ptr sceneMesh_;
+  //! @ref getSceneGeometryKey of the geometry uploaded to the simulator
+  std::string uploadedSceneKey_;
 
   //! track the number of simulations
   std::int32_t currentSimCount_ = -1;
@@ -158,6 +269,8 @@ class AudioSensor : public Sensor {
   bool audioMaterialsJsonSet_ = false;
   bool newInitialization_ = false;
   bool newSource_ = false;
+  //! whether @ref impulseResponse_ was found in the cache and not simulated
+  bool irFromCache_ = false;
 
   const std::string logHeader_ = "[Audio] ";
 
@@ -10,6 +10,9 @@
 #include <cmath>
 
 #include "CameraSensor.h"
+#include "esp/gfx/DebugLineRender.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/TrajectoryRender.h"
 #include "esp/gfx_batch/DepthUnprojection.h"
 #include "esp/sim/Simulator.h"
 
@@ -123,55 +126,146 @@ void CameraSensor::draw(scene::SceneGraph& sceneGraph,
   renderCamera_->draw(defaultRenderingGroup, flags);
 }
 
+bool CameraSensor::isLastDrawReusable(
+    const gfx::RenderCamera::DrawableTransforms& drawableTransforms,
+    gfx::RenderCamera::Flags flags,
+    std::uint64_t trajectoryRevision) const {
+  if (!lastDrawState_) {
+    return false;
+  }
+  const DrawState& last = *lastDrawState_;
+  // another sensor sharing the target may have drawn over it since
+  if (last.flags != flags || last.trajectoryRevision != trajectoryRevision ||
+      last.projection != renderCamera_->projectionMatrix() ||
+      last.appearanceGeneration != scene::SceneNode::appearanceGeneration() ||
+      last.renderTarget != &renderTarget() ||
+      last.renderCount != renderTarget().renderCount() ||
+      last.drawables.size() != drawableTransforms.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i != drawableTransforms.size(); ++i) {
+    if (last.drawables[i].first != &drawableTransforms[i].first.get() ||
+        last.drawables[i].second != drawableTransforms[i].second) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool CameraSensor::drawObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
   }
 
-  renderTarget().renderEnter();
-
   gfx::RenderCamera::Flags flags;
   if (sim.isFrustumCullingEnabled()) {
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
   }
+  if (sim.isInstancedRenderingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::Instancing;
+  }
+  if (sim.isMeshLodEnabled()) {
+    flags |= gfx::RenderCamera::Flag::LevelOfDetail;
+  }
+  if (cameraSensorSpec_->sensorType == SensorType::Depth) {
+    flags |= gfx::RenderCamera::Flag::DepthOnly;
+  }
 
   if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
-    // TODO: check sim has semantic scene graph
-    bool twoSceneGraphs =
-        (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph());
-
-    if (twoSceneGraphs) {
-      // Helper's constructor moves this camera to the semantic scene graph.
-      // When helper goes out of scope, its destructor moves it back to main
-      // scene graph.
-      VisualSensor::MoveSemanticSensorNodeHelper helper(*this, sim);
-      draw(sim.getActiveSemanticSceneGraph(), flags);
-    } else {
-      draw(sim.getActiveSemanticSceneGraph(), flags);
-    }
+    checkCompactSemanticIds(sim);
+    flags |= gfx::RenderCamera::Flag::ObjectIdOnly;
+  }
+  // TODO: check sim has semantic scene graph
+  const bool twoSceneGraphs =
+      cameraSensorSpec_->sensorType == SensorType::Semantic &&
+      &sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph();
+
+  if (!twoSceneGraphs) {
+    scene::SceneGraph& sceneGraph =
+        cameraSensorSpec_->sensorType == SensorType::Semantic
+            ? sim.getActiveSemanticSceneGraph()
+            : sim.getActiveSceneGraph();
+    gfx::DrawableGroup& group = sceneGraph.getDrawables();
+    group.prepareForDraw(*renderCamera_);
+    gfx::RenderCamera::DrawableTransforms drawableTransforms =
+        renderCamera_->filteredDrawableTransformations(group, flags);
 
-    if (twoSceneGraphs) {
-      flags |= gfx::RenderCamera::Flag::ObjectsOnly;
-      draw(sim.getActiveSceneGraph(), flags);
+    const auto debugLineRender =
+        cameraSensorSpec_->sensorType == SensorType::Color
+            ? sim.getDebugLineRender()
+            : nullptr;
+    gfx::TrajectoryRender* const trajectoryRender =
+        cameraSensorSpec_->sensorType == SensorType::Color
+            ? sim.trajectoryRenderIfCreated()
+            : nullptr;
+    const std::uint64_t trajectoryRevision =
+        trajectoryRender ? trajectoryRender->revision() : 0;
+    bool reusable = skipUnchangedDraws_ &&
+                    !(debugLineRender && debugLineRender->hasLines());
+    for (const auto& drawableTransform : drawableTransforms) {
+      // bones move the mesh without moving the node it's attached to
+      auto* drawable =
+          dynamic_cast<const gfx::Drawable*>(&drawableTransform.first.get());
+      reusable = reusable && !(drawable && drawable->isSkinned());
+    }
+    if (reusable &&
+        isLastDrawReusable(drawableTransforms, flags, trajectoryRevision)) {
+      ++skippedDrawCount_;
+      return true;
     }
-  } else {
-    // SensorType is Color, Depth or any other type
-    draw(sim.getActiveSceneGraph(), flags);
 
+    ++drawCount_;
+    renderTarget().renderEnter();
+    renderCamera_->draw(drawableTransforms, flags);
+    if (trajectoryRender) {
+      trajectoryRender->draw(renderCamera_->cameraMatrix(),
+                             renderCamera_->projectionMatrix());
+    }
     if (cameraSensorSpec_->sensorType == SensorType::Color) {
       // include HBAO in Color sensors (only if enabled for render target)
       renderTarget().tryDrawHbao();
 
       // include DebugLineRender in Color sensors
-      const auto debugLineRender = sim.getDebugLineRender();
       if (debugLineRender) {
         debugLineRender->flushLines(renderCamera_->cameraMatrix(),
                                     renderCamera_->projectionMatrix(),
                                     renderCamera_->viewport());
       }
     }
+    renderTarget().renderExit();
+
+    lastDrawState_ = Cr::Containers::NullOpt;
+    if (reusable) {
+      DrawState state;
+      state.flags = flags;
+      state.projection = renderCamera_->projectionMatrix();
+      state.appearanceGeneration = scene::SceneNode::appearanceGeneration();
+      state.renderTarget = &renderTarget();
+      state.renderCount = renderTarget().renderCount();
+      state.trajectoryRevision = trajectoryRevision;
+      state.drawables.reserve(drawableTransforms.size());
+      for (const auto& drawableTransform : drawableTransforms) {
+        state.drawables.emplace_back(&drawableTransform.first.get(),
+                                     drawableTransform.second);
+      }
+      lastDrawState_ = std::move(state);
+    }
+    return true;
   }
 
+  // the camera moves between the two scene graphs, so this is always drawn
+  lastDrawState_ = Cr::Containers::NullOpt;
+  ++drawCount_;
+  renderTarget().renderEnter();
+  {
+    // Helper's constructor moves this camera to the semantic scene graph.
+    // When helper goes out of scope, its destructor moves it back to main
+    // scene graph.
+    VisualSensor::MoveSemanticSensorNodeHelper helper(*this, sim);
+    draw(sim.getActiveSemanticSceneGraph(), flags);
+  }
+  flags |= gfx::RenderCamera::Flag::ObjectsOnly;
+  draw(sim.getActiveSceneGraph(), flags);
   renderTarget().renderExit();
 
   return true;
@@ -5,7 +5,13 @@
 #ifndef ESP_SENSOR_CAMERASENSOR_H_
 #define ESP_SENSOR_CAMERASENSOR_H_
 
+#include <Corrade/Containers/Optional.h>
 #include <Magnum/Math/ConfigurationValue.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "VisualSensor.h"
 #include "esp/core/Esp.h"
 
@@ -61,6 +67,42 @@ class CameraSensor : public VisualSensor {
    */
   bool drawObservation(sim::Simulator& sim) override;
 
+  /**
+   * @brief Whether to reuse the previous observation if nothing it shows
+   * changed
+   *
+   * If the projection and the camera relative transformations of all
+   * drawables that passed culling are the same as in the last draw, and
+   * nothing changed how they look, see
+   * @ref scene::SceneNode::appearanceGeneration(), @ref drawObservation()
+   * keeps the previous image in the render target instead of drawing again.
+   * Observations with skinned drawables or debug lines, and semantic
+   * observations drawn from a separate semantic scene graph, are always
+   * drawn.
+   *
+   * Disabled by default, as not everything affecting the image is tracked.
+   * Texture swaps, changes to image-based lighting or the background, and
+   * changes to the clear color or HBAO settings of the render target don't
+   * cause a redraw, so enable it only if none of those change between
+   * observations.
+   */
+  void setSkipUnchangedDraws(bool skip) {
+    skipUnchangedDraws_ = skip;
+    lastDrawState_ = Corrade::Containers::NullOpt;
+  }
+
+  /** @brief Whether unchanged observations are reused */
+  bool getSkipUnchangedDraws() const { return skipUnchangedDraws_; }
+
+  /** @brief Number of observations drawn */
+  std::size_t drawCount() const { return drawCount_; }
+
+  /**
+   * @brief Number of observations that reused the previous one, see
+   * @ref setSkipUnchangedDraws()
+   */
+  std::size_t skippedDrawCount() const { return skippedDrawCount_; }
+
   /**
    * @brief Modify the zoom matrix for perspective and ortho cameras
    * @param factor Modification amount.
@@ -193,6 +235,35 @@ class CameraSensor : public VisualSensor {
    */
   void draw(scene::SceneGraph& sceneGraph, gfx::RenderCamera::Flags flags);
 
+  /**
+   * @brief What the previous observation was drawn from, see
+   * @ref setSkipUnchangedDraws()
+   */
+  struct DrawState {
+    gfx::RenderCamera::Flags flags;
+    Magnum::Matrix4 projection;
+    std::uint64_t appearanceGeneration = 0;
+    const gfx::RenderTarget* renderTarget = nullptr;
+    std::size_t renderCount = 0;
+    std::uint64_t trajectoryRevision = 0;
+    std::vector<
+        std::pair<const Magnum::SceneGraph::Drawable3D*, Magnum::Matrix4>>
+        drawables;
+  };
+
+  /**
+   * @brief Whether drawing @p drawableTransforms would produce the image
+   * already in the render target
+   * @param drawableTransforms  Drawables to draw
+   * @param flags               Flags to draw them with
+   * @param trajectoryRevision  @ref gfx::TrajectoryRender::revision() of the
+   *    trajectories to draw, @cpp 0 @ce if none
+   */
+  bool isLastDrawReusable(
+      const gfx::RenderCamera::DrawableTransforms& drawableTransforms,
+      gfx::RenderCamera::Flags flags,
+      std::uint64_t trajectoryRevision) const;
+
   /**
    * @brief This camera's projection matrix. Should be recomputed every time
    * size changes.
@@ -221,6 +292,12 @@ class CameraSensor : public VisualSensor {
   CameraSensorSpec::ptr cameraSensorSpec_ =
       std::dynamic_pointer_cast<CameraSensorSpec>(spec_);
 
+  //! Previous draw, or NullOpt if it can't be reused
+  Corrade::Containers::Optional<DrawState> lastDrawState_;
+  bool skipUnchangedDraws_ = false;
+  std::size_t drawCount_ = 0;
+  std::size_t skippedDrawCount_ = 0;
+
  public:
   ESP_SMART_POINTERS(CameraSensor)
 };
@@ -8,6 +8,8 @@
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/FormatStl.h>
 
+#include <algorithm>
+
 namespace Mn = Magnum;
 namespace Cr = Corrade;
 
@@ -28,6 +30,40 @@ void CubeMapSensorBaseSpec::sanityCheck() const {
   }
 }
 
+namespace {
+
+gfx::CubeMap::Flag cubeMapFlag(SensorType sensorType) {
+  switch (sensorType) {
+    case SensorType::Color:
+      return gfx::CubeMap::Flag::ColorTexture;
+    case SensorType::Depth:
+      return gfx::CubeMap::Flag::DepthTexture;
+    case SensorType::Semantic:
+      return gfx::CubeMap::Flag::ObjectIdTexture;
+    default:
+      CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+  }
+}
+
+// flags common to rendering any type of cubemap
+gfx::RenderCamera::Flags cubeMapRenderFlags(sim::Simulator& sim) {
+  gfx::RenderCamera::Flags flags = {gfx::RenderCamera::Flag::ClearColor |
+                                    gfx::RenderCamera::Flag::ClearDepth |
+                                    gfx::RenderCamera::Flag::ClearObjectId};
+  if (sim.isFrustumCullingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::FrustumCulling;
+  }
+  if (sim.isInstancedRenderingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::Instancing;
+  }
+  if (sim.isMeshLodEnabled()) {
+    flags |= gfx::RenderCamera::Flag::LevelOfDetail;
+  }
+  return flags;
+}
+
+}  // namespace
+
 int computeCubemapSize(const Magnum::Vector2i& resolution,
                        const Cr::Containers::Optional<int>& cubemapSize) {
   int size = (resolution[0] < resolution[1] ? resolution[0] : resolution[1]);
@@ -47,22 +83,8 @@ CubeMapSensorBase::CubeMapSensorBase(scene::SceneNode& cameraNode,
   // initialize a cubemap
   int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
                                 cubeMapSensorBaseSpec_->cubemapSize);
-  gfx::CubeMap::Flags cubeMapFlags = {};
-  switch (cubeMapSensorBaseSpec_->sensorType) {
-    case SensorType::Color:
-      cubeMapFlags |= gfx::CubeMap::Flag::ColorTexture;
-      break;
-    case SensorType::Depth:
-      cubeMapFlags |= gfx::CubeMap::Flag::DepthTexture;
-      break;
-    case SensorType::Semantic:
-      cubeMapFlags |= gfx::CubeMap::Flag::ObjectIdTexture;
-      break;
-    default:
-      CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-      break;
-  }
-  cubeMap_ = esp::gfx::CubeMap{size, cubeMapFlags};
+  cubeMap_ = std::make_shared<gfx::CubeMap>(
+      size, cubeMapFlag(cubeMapSensorBaseSpec_->sensorType));
 
   // Sets the cubemap camera, it attaches to the same node as the sensor
   // You do not have to release it in the dtor since magnum scene graph will
@@ -92,6 +114,11 @@ CubeMapSensorBase::CubeMapSensorBase(scene::SceneNode& cameraNode,
   mesh_.setCount(3);
 }
 
+int CubeMapSensorBase::getCubemapSize() const {
+  return computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
+                            cubeMapSensorBaseSpec_->cubemapSize);
+}
+
 bool CubeMapSensorBaseSpec::operator==(const CubeMapSensorBaseSpec& a) const {
   return (VisualSensorSpec::operator==(a) && cubemapSize == a.cubemapSize);
 }
@@ -101,27 +128,28 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
     return false;
   }
 
-  // in case the fisheye sensor resolution changed at runtime
+  // in case the fisheye sensor resolution changed at runtime. A shared
+  // cubemap may have been resized by another sensor, so the projection is
+  // set even if the size didn't change.
   {
-    int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
-                                  cubeMapSensorBaseSpec_->cubemapSize);
-    bool reset = cubeMap_->reset(size);
-    if (reset) {
-      cubeMapCamera_->setProjectionMatrix(size, cubeMapSensorBaseSpec_->near,
-                                          cubeMapSensorBaseSpec_->far);
-    }
+    int size = getCubemapSize();
+    cubeMap_->reset(size);
+    cubeMapCamera_->setProjectionMatrix(size, cubeMapSensorBaseSpec_->near,
+                                        cubeMapSensorBaseSpec_->far);
   }
 
-  esp::gfx::RenderCamera::Flags flags = {
-      gfx::RenderCamera::Flag::ClearColor |
-      gfx::RenderCamera::Flag::ClearDepth |
-      gfx::RenderCamera::Flag::ClearObjectId};
-  if (sim.isFrustumCullingEnabled()) {
-    flags |= gfx::RenderCamera::Flag::FrustumCulling;
+  esp::gfx::RenderCamera::Flags flags = cubeMapRenderFlags(sim);
+  if (cubeMapSensorBaseSpec_->sensorType == SensorType::Depth) {
+    flags |= gfx::RenderCamera::Flag::DepthOnly;
+  }
+  if (cubeMapSensorBaseSpec_->sensorType == SensorType::Semantic) {
+    checkCompactSemanticIds(sim);
+    flags |= gfx::RenderCamera::Flag::ObjectIdOnly;
   }
 
   // generate the cubemap texture
   const char* defaultDrawableGroupName = "";
+  const gfx::CubeMap::Faces faces = getVisibleFaces();
   if (cubeMapSensorBaseSpec_->sensorType == SensorType::Semantic) {
     bool twoSceneGraphs =
         (&sim.getActiveSemanticSceneGraph() != &sim.getActiveSceneGraph());
@@ -133,11 +161,11 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       VisualSensor::MoveSemanticSensorNodeHelper helper(*this, sim);
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     } else {
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
 
     if (twoSceneGraphs) {
@@ -149,16 +177,113 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       flags &= ~gfx::RenderCamera::Flag::ClearDepth;
       flags &= ~gfx::RenderCamera::Flag::ClearObjectId;
       cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
   } else {
     cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                              defaultDrawableGroupName, flags);
+                              defaultDrawableGroupName, flags, faces);
   }
 
   return true;
 }
 
+void CubeMapSensorBase::bindSharedCubeMap(
+    const std::vector<CubeMapSensorBase*>& sensors) {
+  ESP_CHECK(!sensors.empty(),
+            "CubeMapSensorBase::bindSharedCubeMap(): the sensor group is "
+            "empty");
+  const CubeMapSensorBase& first = *sensors.front();
+  gfx::CubeMap::Flags flags;
+  int size = 0;
+  for (const CubeMapSensorBase* sensor : sensors) {
+    const CubeMapSensorBaseSpec& spec = *sensor->cubeMapSensorBaseSpec_;
+    ESP_CHECK(spec.near == first.cubeMapSensorBaseSpec_->near &&
+                  spec.far == first.cubeMapSensorBaseSpec_->far,
+              "CubeMapSensorBase::bindSharedCubeMap(): sensor"
+                  << spec.uuid
+                  << "doesn't share near and far planes with sensor"
+                  << first.cubeMapSensorBaseSpec_->uuid);
+    ESP_CHECK(spec.sensorType == SensorType::Color ||
+                  spec.sensorType == SensorType::Depth ||
+                  spec.sensorType == SensorType::Semantic,
+              "CubeMapSensorBase::bindSharedCubeMap(): sensor"
+                  << spec.uuid << "is not a color, depth or semantic sensor");
+    flags |= cubeMapFlag(spec.sensorType);
+    size = std::max(size, sensor->getCubemapSize());
+  }
+
+  auto cubeMap = std::make_shared<gfx::CubeMap>(size, flags);
+  for (CubeMapSensorBase* sensor : sensors) {
+    sensor->cubeMap_ = cubeMap;
+  }
+}
+
+void CubeMapSensorBase::drawSharedObservations(
+    const std::vector<CubeMapSensorBase*>& sensors,
+    sim::Simulator& sim) {
+  ESP_CHECK(!sensors.empty(),
+            "CubeMapSensorBase::drawSharedObservations(): the sensor group "
+            "is empty");
+  CubeMapSensorBase& primary = *sensors.front();
+  const Mn::Matrix4 pose = primary.node().absoluteTransformationMatrix();
+
+  int size = 0;
+  gfx::CubeMap::Faces faces{Mn::Math::ZeroInit};
+  bool hasColor = false, hasDepth = false;
+  CubeMapSensorBase* semanticSensor = nullptr;
+  for (CubeMapSensorBase* sensor : sensors) {
+    const CubeMapSensorBaseSpec& spec = *sensor->cubeMapSensorBaseSpec_;
+    ESP_CHECK(sensor->hasRenderTarget(),
+              "CubeMapSensorBase::drawSharedObservations(): sensor"
+                  << spec.uuid << "has no rendering target");
+    ESP_CHECK(sensor->cubeMap_ == primary.cubeMap_,
+              "CubeMapSensorBase::drawSharedObservations(): sensor"
+                  << spec.uuid
+                  << "is not bound to the shared cubemap of the group");
+    ESP_CHECK(sensor->node().absoluteTransformationMatrix() == pose,
+              "CubeMapSensorBase::drawSharedObservations(): sensor"
+                  << spec.uuid << "doesn't share the pose of sensor"
+                  << primary.cubeMapSensorBaseSpec_->uuid);
+    size = std::max(size, sensor->getCubemapSize());
+    faces |= sensor->getVisibleFaces();
+    hasColor |= spec.sensorType == SensorType::Color;
+    hasDepth |= spec.sensorType == SensorType::Depth;
+    if (spec.sensorType == SensorType::Semantic) {
+      semanticSensor = sensor;
+    }
+  }
+  if (semanticSensor) {
+    ESP_CHECK(sim.semanticSceneGraphExists(),
+              "CubeMapSensorBase::drawSharedObservations(): SemanticSensor "
+              "observation requested but no SemanticSceneGraph is loaded");
+    // object ids are only written by the drawables of the main scene graph
+    ESP_CHECK(&sim.getActiveSemanticSceneGraph() == &sim.getActiveSceneGraph(),
+              "CubeMapSensorBase::drawSharedObservations(): a semantic "
+              "sensor can only share a cubemap when the semantic scene is "
+              "part of the main scene graph");
+    semanticSensor->checkCompactSemanticIds(sim);
+  }
+
+  primary.cubeMap_->reset(size);
+  primary.cubeMapCamera_->setProjectionMatrix(
+      size, primary.cubeMapSensorBaseSpec_->near,
+      primary.cubeMapSensorBaseSpec_->far);
+
+  gfx::RenderCamera::Flags flags = cubeMapRenderFlags(sim);
+  if (!hasColor && !semanticSensor) {
+    flags |= gfx::RenderCamera::Flag::DepthOnly;
+  } else if (!hasColor && !hasDepth) {
+    flags |= gfx::RenderCamera::Flag::ObjectIdOnly;
+  }
+  primary.cubeMap_->renderToTexture(*primary.cubeMapCamera_,
+                                    sim.getActiveSceneGraph(), "", flags,
+                                    faces);
+
+  for (CubeMapSensorBase* sensor : sensors) {
+    sensor->drawProjection();
+  }
+}
+
 void CubeMapSensorBase::drawWith(gfx::CubeMapShaderBase& shader) {
   if (cubeMapSensorBaseSpec_->sensorType == SensorType::Color) {
     shader.bindColorTexture(
@@ -7,6 +7,8 @@
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Magnum.h>
+#include <memory>
+#include <vector>
 #include "VisualSensor.h"
 #include "esp/core/Esp.h"
 #include "esp/gfx/CubeMap.h"
@@ -61,6 +63,34 @@ class CubeMapSensorBase : public VisualSensor {
     return cubeMapCamera_->projectionMatrix();
   }
 
+  /**
+   * @brief Let a group of sensors render into one shared cubemap
+   * @param[in] sensors cubemap sensors sharing near and far planes
+   *
+   * The cubemap has the color, depth and object id textures the types of
+   * the sensors need, and is as large as the largest cubemap of them.
+   * @ref drawSharedObservations() then renders it once for all of them.
+   * Drawing a single sensor of the group as usual stays possible, it
+   * renders the shared cubemap on its own.
+   */
+  static void bindSharedCubeMap(
+      const std::vector<CubeMapSensorBase*>& sensors);
+
+  /**
+   * @brief Render the cubemap shared by a group of sensors once and draw
+   * the observations of all of them from it
+   * @param[in] sensors the group bound with @ref bindSharedCubeMap()
+   * @param[in] sim the simulator instance
+   *
+   * The sensors are expected to share a pose as well, e.g. by being mounted
+   * at the same spot of an agent. Only the faces visible to any of them are
+   * rendered. Semantic sensors can only be part of the group if the
+   * semantic scene is part of the main scene graph.
+   */
+  static void drawSharedObservations(
+      const std::vector<CubeMapSensorBase*>& sensors,
+      sim::Simulator& sim);
+
  protected:
   /**
    * @brief constructor
@@ -75,7 +105,8 @@ class CubeMapSensorBase : public VisualSensor {
   // raw pointer only, we can create it but let magnum to handle the memory
   // recycling when releasing it.
   gfx::CubeMapCamera* cubeMapCamera_;
-  Corrade::Containers::Optional<esp::gfx::CubeMap> cubeMap_;
+  // shared with other sensors at the same pose after bindSharedCubeMap()
+  std::shared_ptr<esp::gfx::CubeMap> cubeMap_;
 
   // a big triangles that covers the whole screen
   Magnum::GL::Mesh mesh_;
@@ -89,6 +120,24 @@ class CubeMapSensorBase : public VisualSensor {
 
   virtual Magnum::ResourceKey getShaderKey() = 0;
 
+  /**
+   * @brief The cubemap faces the projection of this sensor samples from. Only
+   * these are rendered by @ref renderToCubemapTexture().
+   * NOTE: sub-class should override this function if its field of view does
+   * not cover the full sphere
+   */
+  virtual gfx::CubeMap::Faces getVisibleFaces() const {
+    return gfx::CubeMap::allFaces();
+  }
+
+  /**
+   * @brief The size of the cubemap to render into, see
+   * @ref CubeMapSensorBaseSpec::cubemapSize
+   * NOTE: sub-class can override this function to fit the size to its
+   * projection
+   */
+  virtual int getCubemapSize() const;
+
   template <typename T>
   Magnum::Resource<gfx::CubeMapShaderBase, T> getShader();
 
@@ -104,6 +153,13 @@ class CubeMapSensorBase : public VisualSensor {
    */
   void drawWith(gfx::CubeMapShaderBase& shader);
 
+  /**
+   * @brief draw the observation from the cubemap with the projection shader
+   * of this sensor
+   * NOTE: assume the cubemap texture is already generated
+   */
+  virtual void drawProjection() = 0;
+
   ESP_SMART_POINTERS(CubeMapSensorBase)
 };
 
@@ -40,13 +40,17 @@ bool EquirectangularSensor::drawObservation(sim::Simulator& sim) {
     return false;
   }
   renderToCubemapTexture(sim);
+  drawProjection();
+
+  return true;
+}
+
+void EquirectangularSensor::drawProjection() {
   Magnum::Resource<gfx::CubeMapShaderBase, gfx::EquirectangularShader> shader =
       getShader<gfx::EquirectangularShader>();
 
   (*shader).setViewportSize(equirectangularSensorSpec_->resolution);
   drawWith(*shader);
-
-  return true;
 }
 
 Mn::ResourceKey EquirectangularSensor::getShaderKey() {
@@ -76,6 +76,7 @@ class EquirectangularSensor : public CubeMapSensorBase {
   EquirectangularSensorSpec::ptr equirectangularSensorSpec_ =
       std::dynamic_pointer_cast<EquirectangularSensorSpec>(spec_);
   Magnum::ResourceKey getShaderKey() override;
+  void drawProjection() override;
   ESP_SMART_POINTERS(EquirectangularSensor)
 };
 
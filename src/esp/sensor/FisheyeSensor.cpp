@@ -5,8 +5,14 @@
 #include "esp/core/Check.h"
 #include "esp/gfx/DoubleSphereCameraShader.h"
 
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#include <cmath>
 
 namespace Mn = Magnum;
 namespace Cr = Corrade;
@@ -55,6 +61,71 @@ Magnum::Vector2 computePrincipalPointOffset(const FisheyeSensorSpec& spec) {
   return Mn::Vector2{spec.resolution} * 0.5f;
 }
 
+namespace {
+
+// pixels are sampled on a grid with this many cells along each image side
+constexpr int gridSize = 64;
+
+/**
+ * @brief Center of the pixel at grid point (@p x, @p y), with the grid
+ * spanning the whole image including its border
+ */
+Mn::Vector2 gridPixel(const Mn::Vector2i& resolution, int x, int y) {
+  // resolution is (rows, cols) while gl_FragCoord is (x, y), hence the flip
+  const Mn::Vector2 last =
+      Mn::Vector2{resolution.flipped()} - Mn::Vector2{1.0f};
+  return Mn::Vector2{0.5f} +
+         Mn::Vector2{float(x), float(y)} / float(gridSize) * last;
+}
+
+/**
+ * @brief Unproject a pixel to the cubemap lookup direction, the CPU
+ * counterpart of the double sphere camera shader
+ * @return NullOpt if the pixel is outside of the valid projection area
+ */
+Cr::Containers::Optional<Mn::Vector3> unprojectDoubleSphere(
+    const FisheyeSensorDoubleSphereSpec& spec,
+    const Mn::Vector2& principalPointOffset,
+    const Mn::Vector2& pixel) {
+  const Mn::Vector2 mxy = (pixel - principalPointOffset) / spec.focalLength;
+  const float r2 = Mn::Math::dot(mxy, mxy);
+  const float sq1 = 1.0f - (2.0f * spec.alpha - 1.0f) * r2;
+  if (sq1 < 0.0f) {
+    return Cr::Containers::NullOpt;
+  }
+  const float mz = (1.0f - spec.alpha * spec.alpha * r2) /
+                   (spec.alpha * std::sqrt(sq1) + 1.0f - spec.alpha);
+  const float mz2 = mz * mz;
+  const float sq2 = mz2 + (1.0f - spec.xi * spec.xi) * r2;
+  if (sq2 < 0.0f) {
+    return Cr::Containers::NullOpt;
+  }
+  Mn::Vector3 ray = (mz * spec.xi + std::sqrt(sq2)) / (mz2 + r2) *
+                        Mn::Vector3{mxy, mz} -
+                    Mn::Vector3{0.0f, 0.0f, spec.xi};
+  // the shader flips z to the left-handed cubemap space, see there
+  ray.z() = -ray.z();
+  return ray;
+}
+
+/**
+ * @brief Mark the cubemap face @p ray is looked up from. Faces sharing an
+ * edge with it are marked too when @p ray is close to the edge, since the
+ * filtering there may read from them.
+ */
+void markCubeMapFaces(const Mn::Vector3& ray, gfx::CubeMap::Faces& faces) {
+  const Mn::Vector3 absRay = Mn::Math::abs(ray);
+  const float majorAxis = absRay.max();
+  for (unsigned int iAxis = 0; iAxis < 3; ++iAxis) {
+    if (absRay[iAxis] >= 0.9f * majorAxis) {
+      // face order is +X, -X, +Y, -Y, +Z, -Z
+      faces.set(2 * iAxis + (ray[iAxis] < 0.0f ? 1 : 0), true);
+    }
+  }
+}
+
+}  // namespace
+
 FisheyeSensor::FisheyeSensor(scene::SceneNode& cameraNode,
                              const FisheyeSensorSpec::ptr& spec)
     : CubeMapSensorBase(cameraNode, spec) {
@@ -69,7 +140,8 @@ bool FisheyeSensorSpec::operator==(const FisheyeSensorSpec& a) const {
   return CubeMapSensorBaseSpec::operator==(a) &&
          fisheyeModelType == a.fisheyeModelType &&
          focalLength == a.focalLength &&
-         principalPointOffset == a.principalPointOffset;
+         principalPointOffset == a.principalPointOffset &&
+         fitCubemapSizeToProjection == a.fitCubemapSizeToProjection;
 }
 
 Mn::ResourceKey FisheyeSensor::getShaderKey() {
@@ -80,13 +152,88 @@ Mn::ResourceKey FisheyeSensor::getShaderKey() {
           cubeMapShaderBaseFlags_));
 }
 
+gfx::CubeMap::Faces FisheyeSensor::getVisibleFaces() const {
+  // TODO: other FisheyeSensorModelType
+  if (fisheyeSensorSpec_->fisheyeModelType !=
+      FisheyeSensorModelType::DoubleSphere) {
+    return gfx::CubeMap::allFaces();
+  }
+  const auto& actualSpec =
+      static_cast<const FisheyeSensorDoubleSphereSpec&>(*fisheyeSensorSpec_);
+  const Mn::Vector2 principalPointOffset =
+      computePrincipalPointOffset(actualSpec);
+
+  gfx::CubeMap::Faces faces{Mn::Math::ZeroInit};
+  for (int y = 0; y <= gridSize; ++y) {
+    for (int x = 0; x <= gridSize; ++x) {
+      if (Cr::Containers::Optional<Mn::Vector3> ray = unprojectDoubleSphere(
+              actualSpec, principalPointOffset,
+              gridPixel(actualSpec.resolution, x, y))) {
+        markCubeMapFaces(*ray, faces);
+      }
+    }
+  }
+  return faces;
+}
+
+int FisheyeSensor::getCubemapSize() const {
+  // TODO: other FisheyeSensorModelType
+  if (fisheyeSensorSpec_->cubemapSize ||
+      !fisheyeSensorSpec_->fitCubemapSizeToProjection ||
+      fisheyeSensorSpec_->fisheyeModelType !=
+          FisheyeSensorModelType::DoubleSphere) {
+    return CubeMapSensorBase::getCubemapSize();
+  }
+  const auto& actualSpec =
+      static_cast<const FisheyeSensorDoubleSphereSpec&>(*fisheyeSensorSpec_);
+  const Mn::Vector2 principalPointOffset =
+      computePrincipalPointOffset(actualSpec);
+
+  // smallest angle between the rays of neighboring pixels
+  float minPixelAngle = Mn::Constants::inf();
+  for (int y = 0; y <= gridSize; ++y) {
+    for (int x = 0; x <= gridSize; ++x) {
+      const Mn::Vector2 pixel = gridPixel(actualSpec.resolution, x, y);
+      Cr::Containers::Optional<Mn::Vector3> ray =
+          unprojectDoubleSphere(actualSpec, principalPointOffset, pixel);
+      if (!ray) {
+        continue;
+      }
+      for (const Mn::Vector2& neighbor : {pixel + Mn::Vector2::xAxis(),
+                                          pixel + Mn::Vector2::yAxis()}) {
+        if (Cr::Containers::Optional<Mn::Vector3> neighborRay =
+                unprojectDoubleSphere(actualSpec, principalPointOffset,
+                                      neighbor)) {
+          minPixelAngle = Mn::Math::min(
+              minPixelAngle,
+              float(Mn::Math::angle(ray->normalized(),
+                                    neighborRay->normalized())));
+        }
+      }
+    }
+  }
+  if (minPixelAngle == Mn::Constants::inf() || minPixelAngle <= 0.0f) {
+    return CubeMapSensorBase::getCubemapSize();
+  }
+
+  // texels are largest at the face centers, where a face of size n covers
+  // tan(45deg) * 2 = 2 with n texels
+  const int size = int(std::ceil(2.0f / minPixelAngle));
+  return Mn::Math::clamp(size, 1, Mn::GL::CubeMapTexture::maxSize().x());
+}
+
 bool FisheyeSensor::drawObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
   }
 
   renderToCubemapTexture(sim);
+  drawProjection();
 
+  return true;
+}
+
+void FisheyeSensor::drawProjection() {
   switch (fisheyeSensorSpec_->fisheyeModelType) {
     case FisheyeSensorModelType::DoubleSphere: {
       Magnum::Resource<gfx::CubeMapShaderBase, gfx::DoubleSphereCameraShader>
@@ -108,8 +255,6 @@ bool FisheyeSensor::drawObservation(sim::Simulator& sim) {
       CORRADE_INTERNAL_ASSERT_UNREACHABLE();
       break;
   }
-
-  return true;
 }
 
 }  // namespace sensor
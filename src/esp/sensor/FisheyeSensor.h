@@ -51,6 +51,14 @@ struct FisheyeSensorSpec : public CubeMapSensorBaseSpec {
    */
   Corrade::Containers::Optional<Magnum::Vector2> principalPointOffset;
 
+  /**
+   * @brief If @ref cubemapSize is not set, derive it from the resolution and
+   * distortion so a cubemap texel is no larger than the smallest image pixel,
+   * instead of using min(height, width) of the resolution. Wide-angle lenses
+   * then get a smaller cubemap.
+   */
+  bool fitCubemapSizeToProjection = false;
+
   /**
    * @brief Constructor
    */
@@ -128,6 +136,20 @@ class FisheyeSensor : public CubeMapSensorBase {
       std::dynamic_pointer_cast<FisheyeSensorSpec>(spec_);
   Magnum::ResourceKey getShaderKey() override;
 
+  /**
+   * @brief The cubemap faces hit by the rays of the image pixels, found by
+   * unprojecting a grid of pixels with the fisheye model
+   */
+  gfx::CubeMap::Faces getVisibleFaces() const override;
+
+  /**
+   * @brief The cubemap size, fit to the projection if
+   * @ref FisheyeSensorSpec::fitCubemapSizeToProjection is set
+   */
+  int getCubemapSize() const override;
+
+  void drawProjection() override;
+
   ESP_SMART_POINTERS(FisheyeSensor)
 };
 
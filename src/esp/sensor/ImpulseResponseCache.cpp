@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ImpulseResponseCache.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "esp/core/Check.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+namespace {
+
+std::size_t byteSize(const ImpulseResponseCache::ImpulseResponse& ir) {
+  std::size_t size = 0;
+  for (const std::vector<float>& channel : ir) {
+    size += channel.size() * sizeof(float);
+  }
+  return size;
+}
+
+void appendQuantized(std::string& key, float value, float step) {
+  const std::int32_t quantized = std::int32_t(std::lround(value / step));
+  key.append(reinterpret_cast<const char*>(&quantized), sizeof(quantized));
+}
+
+}  // namespace
+
+ImpulseResponseCache::ImpulseResponseCache(const float gridSize,
+                                           const float rotationStep,
+                                           const std::size_t memoryBudget)
+    : gridSize_{gridSize},
+      rotationStep_{rotationStep},
+      memoryBudget_{memoryBudget} {
+  ESP_CHECK(gridSize > 0.0f && rotationStep > 0.0f,
+            "ImpulseResponseCache: expected a positive grid size and rotation "
+            "step, got"
+                << gridSize << "and" << rotationStep);
+}
+
+std::string ImpulseResponseCache::key(
+    const std::string& scene,
+    const Mn::Vector3& source,
+    const Mn::Vector3& listener,
+    const Mn::Quaternion& listenerRot) const {
+  std::string key = scene;
+  key += '\0';
+  for (const Mn::Vector3& position : {source, listener}) {
+    for (std::size_t i = 0; i != 3; ++i) {
+      appendQuantized(key, position[i], gridSize_);
+    }
+  }
+  // q and -q are the same rotation
+  const Mn::Quaternion rotation =
+      listenerRot.scalar() < 0.0f ? -listenerRot : listenerRot;
+  for (std::size_t i = 0; i != 3; ++i) {
+    appendQuantized(key, rotation.vector()[i], rotationStep_);
+  }
+  appendQuantized(key, rotation.scalar(), rotationStep_);
+  return key;
+}
+
+const ImpulseResponseCache::ImpulseResponse* ImpulseResponseCache::find(
+    const std::string& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return &found->second->second;
+}
+
+void ImpulseResponseCache::insert(const std::string& key,
+                                  ImpulseResponse impulseResponse) {
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    memoryUsage_ -= byteSize(found->second->second);
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+
+  memoryUsage_ += byteSize(impulseResponse);
+  entries_.emplace_front(key, std::move(impulseResponse));
+  index_.emplace(key, entries_.begin());
+
+  // the newest entry is kept even if it alone is over budget
+  while (memoryUsage_ > memoryBudget_ && entries_.size() > 1) {
+    memoryUsage_ -= byteSize(entries_.back().second);
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+void ImpulseResponseCache::clear() {
+  entries_.clear();
+  index_.clear();
+  memoryUsage_ = 0;
+}
+
+}  // namespace sensor
+}  // namespace esp
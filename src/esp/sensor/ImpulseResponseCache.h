@@ -0,0 +1,119 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_IMPULSERESPONSECACHE_H_
+#define ESP_SENSOR_IMPULSERESPONSECACHE_H_
+
+/** @file
+ * @brief Class @ref esp::sensor::ImpulseResponseCache
+ */
+
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+@brief Impulse responses of an @ref AudioSensor, keyed by quantized source and
+listener poses
+
+Positions are quantized to a grid of @ref gridSize() and listener rotations,
+per quaternion component, to @ref rotationStep(), so that nearby poses share
+an entry. Once the stored responses take more than @ref memoryBudget() bytes,
+the least recently used ones are evicted.
+*/
+class ImpulseResponseCache {
+ public:
+  /** @brief Impulse response samples, indexed by channel and sample */
+  typedef std::vector<std::vector<float>> ImpulseResponse;
+
+  /**
+   * @brief Constructor
+   * @param gridSize      Size of the position grid cells, in meters
+   * @param rotationStep  Quantization step of the listener rotation
+   *    quaternion components
+   * @param memoryBudget  Bytes of samples to keep at most
+   */
+  explicit ImpulseResponseCache(float gridSize,
+                                float rotationStep,
+                                std::size_t memoryBudget);
+
+  /** @brief Size of the position grid cells */
+  float gridSize() const { return gridSize_; }
+
+  /** @brief Quantization step of the listener rotation */
+  float rotationStep() const { return rotationStep_; }
+
+  /** @brief Bytes of samples to keep at most */
+  std::size_t memoryBudget() const { return memoryBudget_; }
+
+  /**
+   * @brief Key of an impulse response
+   * @param scene         Identifies the scene geometry and materials
+   * @param source        Source position
+   * @param listener      Listener position
+   * @param listenerRot   Listener rotation
+   */
+  std::string key(const std::string& scene,
+                  const Magnum::Vector3& source,
+                  const Magnum::Vector3& listener,
+                  const Magnum::Quaternion& listenerRot) const;
+
+  /**
+   * @brief The impulse response stored for @p key, marking it as most
+   * recently used, or @cpp nullptr @ce
+   *
+   * The pointer stays valid until the next @ref insert() or @ref clear().
+   */
+  const ImpulseResponse* find(const std::string& key);
+
+  /** @brief Whether an impulse response is stored for @p key */
+  bool contains(const std::string& key) const {
+    return index_.count(key) != 0;
+  }
+
+  /**
+   * @brief Store @p impulseResponse for @p key, evicting the least recently
+   * used ones if over budget
+   */
+  void insert(const std::string& key, ImpulseResponse impulseResponse);
+
+  /** @brief Number of stored impulse responses */
+  std::size_t size() const { return entries_.size(); }
+
+  /** @brief Bytes of samples stored */
+  std::size_t memoryUsage() const { return memoryUsage_; }
+
+  /** @brief Drop all stored impulse responses */
+  void clear();
+
+ private:
+  typedef std::list<std::pair<std::string, ImpulseResponse>> Entries;
+
+  float gridSize_;
+  float rotationStep_;
+  std::size_t memoryBudget_;
+  std::size_t memoryUsage_ = 0;
+  // most recently used first
+  Entries entries_;
+  std::unordered_map<std::string, Entries::iterator> index_;
+
+ public:
+  ESP_SMART_POINTERS(ImpulseResponseCache)
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_IMPULSERESPONSECACHE_H_
@@ -0,0 +1,138 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LidarSensor.h"
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/sim/Simulator.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+LidarSensorSpec::LidarSensorSpec() : SensorSpec() {
+  uuid = "lidar";
+  sensorType = SensorType::Lidar;
+  sensorSubType = SensorSubType::Spinning;
+}
+
+void LidarSensorSpec::sanityCheck() const {
+  SensorSpec::sanityCheck();
+  CORRADE_ASSERT(sensorType == SensorType::Lidar,
+                 "LidarSensorSpec::sanityCheck(): sensorType must be Lidar", );
+  CORRADE_ASSERT(
+      sensorSubType == SensorSubType::Spinning,
+      "LidarSensorSpec::sanityCheck(): sensorSubType must be Spinning", );
+  CORRADE_ASSERT(horizontalResolution > 0 && verticalResolution > 0,
+                 "LidarSensorSpec::sanityCheck(): resolution"
+                     << horizontalResolution << "x" << verticalResolution
+                     << "is illegal", );
+  CORRADE_ASSERT(horizontalFov > Mn::Deg{0.0f} &&
+                     horizontalFov <= Mn::Deg{360.0f} &&
+                     verticalFov >= Mn::Deg{0.0f} &&
+                     verticalFov <= Mn::Deg{180.0f},
+                 "LidarSensorSpec::sanityCheck(): field of view is illegal", );
+  CORRADE_ASSERT(minRange >= 0.0f && maxRange > minRange,
+                 "LidarSensorSpec::sanityCheck(): range" << minRange << "to"
+                                                         << maxRange
+                                                         << "is illegal", );
+}
+
+bool LidarSensorSpec::operator==(const LidarSensorSpec& a) const {
+  return SensorSpec::operator==(a) &&
+         horizontalResolution == a.horizontalResolution &&
+         verticalResolution == a.verticalResolution &&
+         horizontalFov == a.horizontalFov && verticalFov == a.verticalFov &&
+         minRange == a.minRange && maxRange == a.maxRange;
+}
+
+LidarSensor::LidarSensor(scene::SceneNode& node, LidarSensorSpec::ptr spec)
+    : Sensor{node, std::move(spec)} {
+  lidarSensorSpec_->sanityCheck();
+
+  const int columns = lidarSensorSpec_->horizontalResolution;
+  const int rows = lidarSensorSpec_->verticalResolution;
+  const Mn::Rad hfov{lidarSensorSpec_->horizontalFov};
+  const Mn::Rad vfov{lidarSensorSpec_->verticalFov};
+  // rays are centered in their horizontal sector so a full revolution
+  // doesn't cast the first and last ray twice, while the scan lines include
+  // both ends of the vertical field of view
+  const Mn::Rad hStep = hfov / Mn::Float(columns);
+  const Mn::Rad vStep = rows > 1 ? vfov / Mn::Float(rows - 1) : Mn::Rad{0.0f};
+  const Mn::Rad top = rows > 1 ? vfov * 0.5f : Mn::Rad{0.0f};
+
+  localDirections_.reserve(std::size_t(columns) * rows);
+  for (int row = 0; row != rows; ++row) {
+    const Mn::Rad elevation = top - vStep * Mn::Float(row);
+    const Mn::Float cosElevation = Mn::Math::cos(elevation);
+    for (int column = 0; column != columns; ++column) {
+      // positive azimuth turns from -Z towards -X, i.e. to the left
+      const Mn::Rad azimuth = hfov * 0.5f - hStep * (column + 0.5f);
+      localDirections_.emplace_back(
+          -Mn::Math::sin(azimuth) * cosElevation, Mn::Math::sin(elevation),
+          -Mn::Math::cos(azimuth) * cosElevation);
+    }
+  }
+
+  origins_.resize(localDirections_.size());
+  directions_.resize(localDirections_.size());
+  distances_.resize(localDirections_.size());
+  objectIds_.resize(localDirections_.size(), ID_UNDEFINED);
+}
+
+bool LidarSensor::getObservation(sim::Simulator& sim, Observation& obs) {
+  if (!sim.sceneHasPhysics()) {
+    ESP_ERROR() << "Lidar sensor" << lidarSensorSpec_->uuid
+                << "needs physics to be enabled to cast rays";
+    return false;
+  }
+
+  const Mn::Matrix4 transformation = node().absoluteTransformationMatrix();
+  const Mn::Vector3 origin = transformation.translation();
+  const Mn::Matrix3x3 rotation = transformation.rotation();
+  for (std::size_t i = 0; i != localDirections_.size(); ++i) {
+    origins_[i] = origin;
+    directions_[i] = rotation * localDirections_[i];
+  }
+  sim.castRays(origins_, directions_, lidarSensorSpec_->maxRange, distances_,
+               objectIds_);
+
+  if (buffer_ == nullptr) {
+    ObservationSpace space;
+    getObservationSpace(space);
+    buffer_ = core::Buffer::create(space.shape, space.dataType);
+  }
+  auto* ranges = reinterpret_cast<float*>(buffer_->data.data());
+  for (std::size_t i = 0; i != distances_.size(); ++i) {
+    if (objectIds_[i] == ID_UNDEFINED ||
+        distances_[i] < lidarSensorSpec_->minRange) {
+      objectIds_[i] = ID_UNDEFINED;
+      ranges[i] = 0.0f;
+    } else {
+      ranges[i] = distances_[i];
+    }
+  }
+  obs.buffer = buffer_;
+  return true;
+}
+
+bool LidarSensor::getObservationSpace(ObservationSpace& space) {
+  space.spaceType = ObservationSpaceType::Tensor;
+  space.dataType = core::DataType::DT_FLOAT;
+  space.shape = {std::size_t(lidarSensorSpec_->verticalResolution),
+                 std::size_t(lidarSensorSpec_->horizontalResolution)};
+  return true;
+}
+
+bool LidarSensor::displayObservation(sim::Simulator&) {
+  ESP_ERROR() << "Display observation for lidar sensor is not supported";
+  return false;
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,113 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_LIDARSENSOR_H_
+#define ESP_SENSOR_LIDARSENSOR_H_
+
+#include <Magnum/Math/Angle.h>
+
+#include <vector>
+
+#include "esp/core/Esp.h"
+#include "esp/sensor/Sensor.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief Specification of a @ref LidarSensor
+ *
+ * The scan lines are evenly spread over @ref verticalFov and the rays of each
+ * line over @ref horizontalFov, both centered on the sensor's forward (-Z)
+ * axis.
+ */
+struct LidarSensorSpec : public SensorSpec {
+  /**
+   * @brief Number of rays per scan line.
+   */
+  int horizontalResolution = 360;
+  /**
+   * @brief Number of scan lines, 1 for a planar lidar.
+   */
+  int verticalResolution = 16;
+  /**
+   * @brief Horizontal field of view, 360 degrees for a full revolution.
+   */
+  Magnum::Deg horizontalFov{360.0f};
+  /**
+   * @brief Vertical field of view, ignored with a single scan line.
+   */
+  Magnum::Deg verticalFov{30.0f};
+  /**
+   * @brief Hits closer than this are reported as missing returns.
+   */
+  float minRange = 0.0f;
+  /**
+   * @brief Farthest distance a ray is cast to.
+   */
+  float maxRange = 100.0f;
+
+  LidarSensorSpec();
+  void sanityCheck() const override;
+  bool operator==(const LidarSensorSpec& a) const;
+  ESP_SMART_POINTERS(LidarSensorSpec)
+};
+
+/**
+ * @brief Range sensor casting rays into the physics collision world
+ *
+ * Observations are a float tensor of shape
+ * [@ref LidarSensorSpec::verticalResolution,
+ * @ref LidarSensorSpec::horizontalResolution] holding the distance of the
+ * closest hit of each ray in meters, the top scan line and the leftmost ray
+ * first, and 0 for rays that hit nothing within range. All rays of a scan
+ * are cast as one batch with @ref sim::Simulator::castRays, so physics has to
+ * be enabled.
+ */
+class LidarSensor : public Sensor {
+ public:
+  explicit LidarSensor(scene::SceneNode& node, LidarSensorSpec::ptr spec);
+
+  /**
+   * @brief Return that this is not a visual sensor
+   */
+  bool isVisualSensor() const override { return false; }
+
+  bool getObservation(sim::Simulator& sim, Observation& obs) override;
+  bool getObservationSpace(ObservationSpace& space) override;
+
+  /**
+   * @brief Ray directions in the sensor's local frame, in observation order
+   */
+  const std::vector<Magnum::Vector3>& rayDirections() const {
+    return localDirections_;
+  }
+
+  /**
+   * @brief Ids of the objects hit by the last observation, in observation
+   * order, @ref ID_UNDEFINED for rays that hit nothing within range
+   */
+  const std::vector<int>& hitObjectIds() const { return objectIds_; }
+
+ private:
+  bool displayObservation(sim::Simulator&) override;
+
+  LidarSensorSpec::ptr lidarSensorSpec_ =
+      std::dynamic_pointer_cast<LidarSensorSpec>(spec_);
+
+  std::vector<Magnum::Vector3> localDirections_;
+  // per-scan scratch buffers, kept to avoid reallocating every observation
+  std::vector<Magnum::Vector3> origins_;
+  std::vector<Magnum::Vector3> directions_;
+  std::vector<float> distances_;
+  std::vector<int> objectIds_;
+
+ public:
+  ESP_SMART_POINTERS(LidarSensor)
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_LIDARSENSOR_H_
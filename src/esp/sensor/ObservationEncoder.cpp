@@ -0,0 +1,311 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ObservationEncoder.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Image.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include <chrono>
+
+#include "esp/core/Check.h"
+#include "esp/core/ThreadAffinity.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace sensor {
+
+namespace {
+
+// neither managers nor converters are thread-safe, so every thread that
+// encodes observations keeps its own
+struct ThreadPlugins {
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter>
+      converterManager;
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> jpegConverter;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> pngConverter;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer;
+};
+
+ThreadPlugins& threadPlugins() {
+  thread_local ThreadPlugins plugins;
+  return plugins;
+}
+
+// replaces each pixel by its difference to the previous one in the row, which
+// is small for smooth depth and mostly zero for semantic IDs
+template <class T>
+void deltaEncodeRows(const Cr::Containers::StridedArrayView2D<T>& pixels) {
+  for (std::size_t y = 0; y != pixels.size()[0]; ++y) {
+    for (std::size_t x = pixels.size()[1]; x > 1; --x) {
+      pixels[y][x - 1] -= pixels[y][x - 2];
+    }
+  }
+}
+
+template <class T>
+void deltaDecodeRows(const Cr::Containers::StridedArrayView2D<T>& pixels) {
+  for (std::size_t y = 0; y != pixels.size()[0]; ++y) {
+    for (std::size_t x = 1; x < pixels.size()[1]; ++x) {
+      pixels[y][x] += pixels[y][x - 1];
+    }
+  }
+}
+
+// format the 8-bit channels of a delta-encoded 16- or 32-bit image are
+// stored as
+Cr::Containers::Optional<Mn::PixelFormat> losslessStorageFormat(
+    Mn::PixelFormat format) {
+  switch (format) {
+    case Mn::PixelFormat::R8Unorm:
+    case Mn::PixelFormat::RGB8Unorm:
+    case Mn::PixelFormat::RGBA8Unorm:
+      return format;
+    case Mn::PixelFormat::R16UI:
+      return Mn::PixelFormat::RG8Unorm;
+    case Mn::PixelFormat::R32UI:
+    case Mn::PixelFormat::R32I:
+    case Mn::PixelFormat::R32F:
+      return Mn::PixelFormat::RGBA8Unorm;
+    default:
+      return Cr::Containers::NullOpt;
+  }
+}
+
+}  // namespace
+
+std::string encodeObservation(const Mn::ImageView2D& image,
+                              ObservationEncoding encoding,
+                              int jpegQuality) {
+  CORRADE_ASSERT(encoding != ObservationEncoding::None,
+                 "encodeObservation(): no encoding specified", {});
+  ThreadPlugins& plugins = threadPlugins();
+  Cr::Containers::Optional<Cr::Containers::Array<char>> encoded;
+
+  if (encoding == ObservationEncoding::Jpeg) {
+    if (image.format() != Mn::PixelFormat::RGBA8Unorm &&
+        image.format() != Mn::PixelFormat::RGB8Unorm) {
+      return {};
+    }
+    if (!plugins.jpegConverter) {
+      plugins.jpegConverter = plugins.converterManager.loadAndInstantiate(
+          "StbJpegImageConverter");
+      if (!plugins.jpegConverter) {
+        return {};
+      }
+    }
+    plugins.jpegConverter->configuration().setValue(
+        "jpegQuality", Mn::Math::clamp(jpegQuality, 1, 100) / 100.0f);
+
+    // JPEG has no alpha, dropping it here avoids a warning for every image
+    Mn::Image2D rgb{Mn::PixelStorage{}.setAlignment(1),
+                    Mn::PixelFormat::RGB8Unorm, image.size(),
+                    Cr::Containers::Array<char>{
+                        Cr::NoInit, std::size_t(image.size().product()) * 3}};
+    if (image.format() == Mn::PixelFormat::RGBA8Unorm) {
+      const auto src = image.pixels<Mn::Color4ub>();
+      const auto dst = rgb.pixels<Mn::Color3ub>();
+      for (std::size_t y = 0; y != src.size()[0]; ++y) {
+        for (std::size_t x = 0; x != src.size()[1]; ++x) {
+          dst[y][x] = src[y][x].rgb();
+        }
+      }
+    } else {
+      Cr::Utility::copy(image.pixels<Mn::Color3ub>(),
+                        rgb.pixels<Mn::Color3ub>());
+    }
+    encoded = plugins.jpegConverter->convertToData(rgb);
+  } else {
+    const Cr::Containers::Optional<Mn::PixelFormat> storageFormat =
+        losslessStorageFormat(image.format());
+    if (!storageFormat) {
+      return {};
+    }
+    if (!plugins.pngConverter) {
+      plugins.pngConverter = plugins.converterManager.loadAndInstantiate(
+          "StbPngImageConverter");
+      if (!plugins.pngConverter) {
+        return {};
+      }
+    }
+
+    if (*storageFormat == image.format()) {
+      // PNG filters already predict 8-bit channels from their neighbors
+      encoded = plugins.pngConverter->convertToData(image);
+    } else {
+      Mn::Image2D delta{Mn::PixelStorage{}.setAlignment(1), image.format(),
+                        image.size(),
+                        Cr::Containers::Array<char>{
+                            Cr::NoInit, std::size_t(image.size().product()) *
+                                            image.pixelSize()}};
+      Cr::Utility::copy(image.pixels(), delta.pixels());
+      if (image.pixelSize() == 2) {
+        deltaEncodeRows(delta.pixels<Mn::UnsignedShort>());
+      } else {
+        deltaEncodeRows(delta.pixels<Mn::UnsignedInt>());
+      }
+      encoded = plugins.pngConverter->convertToData(
+          Mn::ImageView2D{delta.storage(), *storageFormat, delta.size(),
+                          delta.data()});
+    }
+  }
+
+  if (!encoded) {
+    return {};
+  }
+  return std::string{encoded->data(), encoded->size()};
+}  // encodeObservation
+
+bool decodeObservation(Cr::Containers::ArrayView<const char> data,
+                       ObservationEncoding encoding,
+                       const Mn::MutableImageView2D& image) {
+  CORRADE_ASSERT(encoding != ObservationEncoding::None,
+                 "decodeObservation(): no encoding specified", false);
+  ThreadPlugins& plugins = threadPlugins();
+  if (!plugins.importer) {
+    plugins.importer =
+        plugins.importerManager.loadAndInstantiate("StbImageImporter");
+    if (!plugins.importer) {
+      return false;
+    }
+  }
+  if (!plugins.importer->openData(data)) {
+    return false;
+  }
+  Cr::Containers::Optional<Mn::Trade::ImageData2D> decodedData =
+      plugins.importer->image2D(0);
+  plugins.importer->close();
+  if (!decodedData || decodedData->size() != image.size()) {
+    return false;
+  }
+  const Mn::Trade::ImageData2D& decoded = *decodedData;
+
+  if (encoding == ObservationEncoding::Jpeg) {
+    if (decoded.format() != Mn::PixelFormat::RGB8Unorm) {
+      return false;
+    }
+    if (image.format() == Mn::PixelFormat::RGB8Unorm) {
+      Cr::Utility::copy(decoded.pixels<Mn::Color3ub>(),
+                        image.pixels<Mn::Color3ub>());
+      return true;
+    }
+    if (image.format() != Mn::PixelFormat::RGBA8Unorm) {
+      return false;
+    }
+    const auto src = decoded.pixels<Mn::Color3ub>();
+    const auto dst = image.pixels<Mn::Color4ub>();
+    for (std::size_t y = 0; y != src.size()[0]; ++y) {
+      for (std::size_t x = 0; x != src.size()[1]; ++x) {
+        dst[y][x] = Mn::Color4ub{src[y][x], 255};
+      }
+    }
+    return true;
+  }
+
+  const Cr::Containers::Optional<Mn::PixelFormat> storageFormat =
+      losslessStorageFormat(image.format());
+  if (!storageFormat || decoded.format() != *storageFormat) {
+    return false;
+  }
+  Cr::Utility::copy(decoded.pixels(), image.pixels());
+  if (*storageFormat != image.format()) {
+    if (image.pixelSize() == 2) {
+      deltaDecodeRows(image.pixels<Mn::UnsignedShort>());
+    } else {
+      deltaDecodeRows(image.pixels<Mn::UnsignedInt>());
+    }
+  }
+  return true;
+}  // decodeObservation
+
+bool EncodedObservation::ready() const {
+  return data_.valid() && data_.wait_for(std::chrono::seconds{0}) ==
+                              std::future_status::ready;
+}
+
+void EncodedObservation::wait() const {
+  ESP_CHECK(data_.valid(), "EncodedObservation::wait(): no observation");
+  data_.wait();
+}
+
+const std::string& EncodedObservation::data() const {
+  ESP_CHECK(data_.valid(), "EncodedObservation::data(): no observation");
+  return data_.get();
+}
+
+ObservationEncoder::ObservationEncoder(std::size_t threadCount) {
+  CORRADE_ASSERT(threadCount,
+                 "ObservationEncoder::ObservationEncoder(): expected at least "
+                 "one thread", );
+  workers_.reserve(threadCount);
+  for (std::size_t i = 0; i != threadCount; ++i) {
+    workers_.emplace_back(&ObservationEncoder::run, this);
+  }
+}
+
+ObservationEncoder::~ObservationEncoder() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+EncodedObservation ObservationEncoder::encode(
+    const Mn::ImageView2D& image,
+    std::shared_ptr<const void> owner,
+    ObservationEncoding encoding,
+    int jpegQuality) {
+  std::packaged_task<std::string()> task{
+      [image, owner = std::move(owner), encoding, jpegQuality]() {
+        return encodeObservation(image, encoding, jpegQuality);
+      }};
+  EncodedObservation encoded;
+  encoded.data_ = task.get_future().share();
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+  return encoded;
+}
+
+void ObservationEncoder::run() {
+  core::pinCurrentThread(core::ThreadRole::Worker);
+  for (;;) {
+    std::packaged_task<std::string()> task;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      // everything submitted gets encoded before stopping
+      cv_.wait(lock, [&]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace sensor
+}  // namespace esp
@@ -0,0 +1,147 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_OBSERVATIONENCODER_H_
+#define ESP_SENSOR_OBSERVATIONENCODER_H_
+
+/** @file
+ * @brief Class @ref esp::sensor::ObservationEncoder,
+ * @ref esp::sensor::EncodedObservation, enum
+ * @ref esp::sensor::ObservationEncoding
+ */
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/ImageView.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace sensor {
+
+/**
+ * @brief How visual sensor observations are compressed, see
+ * @ref encodeObservation()
+ */
+enum class ObservationEncoding : int {
+  /** Not compressed */
+  None,
+
+  /** Lossy JPEG, only for color observations. Alpha is dropped. */
+  Jpeg,
+
+  /**
+   * Lossless PNG. 16- and 32-bit pixels, such as semantic IDs and depth, are
+   * first replaced by their difference to the previous pixel in the same row,
+   * wrapping around, and then stored as two or four 8-bit channels.
+   */
+  Lossless,
+};
+
+/**
+ * @brief Compress @p image
+ * @param image         Observation, in one of the formats visual sensors read
+ * @param encoding      Encoding, not @ref ObservationEncoding::None
+ * @param jpegQuality   Quality of @ref ObservationEncoding::Jpeg, in
+ *    [1, 100]
+ *
+ * Returns an empty string if the image can't be compressed this way.
+ */
+std::string encodeObservation(const Magnum::ImageView2D& image,
+                              ObservationEncoding encoding,
+                              int jpegQuality = 90);
+
+/**
+ * @brief Decompress @p data produced by @ref encodeObservation() into @p image
+ *
+ * @p image has to have the size and format of the original image. Returns
+ * @cpp false @ce if @p data can't be decoded into it.
+ */
+bool decodeObservation(Corrade::Containers::ArrayView<const char> data,
+                       ObservationEncoding encoding,
+                       const Magnum::MutableImageView2D& image);
+
+/**
+ * @brief Observation being compressed by an @ref ObservationEncoder
+ */
+class EncodedObservation {
+ public:
+  /** @brief Whether the compression finished */
+  bool ready() const;
+
+  /** @brief Wait for the compression to finish */
+  void wait() const;
+
+  /**
+   * @brief The compressed observation, waiting for it if it isn't
+   * @ref ready() yet
+   */
+  const std::string& data() const;
+
+ private:
+  friend class ObservationEncoder;
+
+  std::shared_future<std::string> data_;
+};
+
+/**
+@brief Compresses observations on background threads
+
+Lets observations be compressed while the next ones get rendered, e.g. before
+sending them over the network, see @ref VisualSensor::encodeObservation().
+Observations are compressed in the order they were submitted.
+*/
+class ObservationEncoder {
+ public:
+  /** @brief Constructor */
+  explicit ObservationEncoder(std::size_t threadCount = 1);
+
+  /** @brief Finishes all submitted observations before returning */
+  ~ObservationEncoder();
+
+  ObservationEncoder(const ObservationEncoder&) = delete;
+  ObservationEncoder& operator=(const ObservationEncoder&) = delete;
+
+  /** @brief Number of threads compressing observations */
+  std::size_t threadCount() const { return workers_.size(); }
+
+  /**
+   * @brief Compress @p image on a background thread
+   * @param image         Observation, see @ref encodeObservation()
+   * @param owner         Keeps the memory of @p image alive until it's
+   *    compressed
+   * @param encoding      Encoding
+   * @param jpegQuality   Quality of @ref ObservationEncoding::Jpeg
+   */
+  EncodedObservation encode(const Magnum::ImageView2D& image,
+                            std::shared_ptr<const void> owner,
+                            ObservationEncoding encoding,
+                            int jpegQuality = 90);
+
+ private:
+  void run();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<std::string()>> tasks_;
+  bool stop_ = false;
+
+ public:
+  ESP_SMART_POINTERS(ObservationEncoder)
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_OBSERVATIONENCODER_H_
@@ -92,5 +92,16 @@ void RedwoodNoiseModelGPUImpl::simulateFromGPU(const float* devDepth,
                         devNoisyDepth);
 }
 
+void RedwoodNoiseModelGPUImpl::simulateBatchFromGPU(const float* devDepth,
+                                                    const int batchSize,
+                                                    const int rows,
+                                                    const int cols,
+                                                    float* devNoisyDepth) {
+  CudaDeviceContext ctx{gpuDeviceId_};
+  impl::simulateBatchFromGPU(maxThreadsPerBlock_, warpSize_, devDepth,
+                             batchSize, rows, cols, devModel_, curandStates_,
+                             noiseMultiplier_, devNoisyDepth);
+}
+
 }  // namespace sensor
 }  // namespace esp
@@ -41,6 +41,9 @@ __device__ float undistort(const int _x,
     return z / f;
 }
 
+// Images of a batch are stacked along blockIdx.y and each has its own slice
+// of gridDim.x * blockDim.x random states, so the noise of one environment
+// doesn't depend on how many others are in the batch
 __global__ void redwoodNoiseModelKernel(const float* __restrict__ depth,
                                         const int H,
                                         const int W,
@@ -50,6 +53,10 @@ __global__ void redwoodNoiseModelKernel(const float* __restrict__ depth,
                                         float* __restrict__ noisyDepth) {
   const int ID = blockIdx.x * blockDim.x + threadIdx.x;
   const int STRIDE = gridDim.x * blockDim.x;
+  const int imageOffset = blockIdx.y * H * W;
+  depth += imageOffset;
+  noisyDepth += imageOffset;
+  states += blockIdx.y * STRIDE;
 
   curandState_t curandState = states[ID];
 
@@ -158,6 +165,20 @@ void simulateFromGPU(const int maxThreadsPerBlock,
                      CurandStates* curandStates,
                      const float noiseMultiplier,
                      float* __restrict__ devNoisyDepth) {
+  simulateBatchFromGPU(maxThreadsPerBlock, warpSize, devDepth, 1, H, W,
+                       devModel, curandStates, noiseMultiplier, devNoisyDepth);
+}
+
+void simulateBatchFromGPU(const int maxThreadsPerBlock,
+                          const int warpSize,
+                          const float* __restrict__ devDepth,
+                          const int batchSize,
+                          const int H,
+                          const int W,
+                          const float* __restrict__ devModel,
+                          CurandStates* curandStates,
+                          const float noiseMultiplier,
+                          float* __restrict__ devNoisyDepth) {
   const int totalConcurrency = std::ceil(static_cast<float>(H * W) / 4.0f);
   const int nThreads =
       std::min(std::max(roundToNearestMultiple(totalConcurrency, warpSize), 1),
@@ -165,8 +186,8 @@ void simulateFromGPU(const int maxThreadsPerBlock,
   const int nBlocks =
       std::ceil(static_cast<float>(totalConcurrency) / nThreads);
 
-  curandStates->alloc(nBlocks * nThreads, maxThreadsPerBlock);
-  redwoodNoiseModelKernel<<<nBlocks, nThreads>>>(
+  curandStates->alloc(batchSize * nBlocks * nThreads, maxThreadsPerBlock);
+  redwoodNoiseModelKernel<<<dim3(nBlocks, batchSize), nThreads>>>(
       devDepth, H, W, curandStates->devStates, devModel, noiseMultiplier,
       devNoisyDepth);
 }
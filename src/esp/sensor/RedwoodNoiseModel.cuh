@@ -34,6 +34,17 @@ void simulateFromGPU(const int maxThreadsPerBlock,
                      CurandStates* curandStates,
                      const float noiseMultiplier,
                      float* __restrict__ devNoisyDepth);
+
+void simulateBatchFromGPU(const int maxThreadsPerBlock,
+                          const int warpSize,
+                          const float* __restrict__ devDepth,
+                          const int batchSize,
+                          const int H,
+                          const int W,
+                          const float* __restrict__ devModel,
+                          CurandStates* curandStates,
+                          const float noiseMultiplier,
+                          float* __restrict__ devNoisyDepth);
 }  // namespace impl
 }  // namespace sensor
 }  // namespace esp
@@ -75,6 +75,27 @@ struct RedwoodNoiseModelGPUImpl {
                        const int cols,
                        float* devNoisyDepth);
 
+  /**
+   * @brief Similar to @ref simulateFromGPU() but for a batch of depth images
+   * stacked one after another, e.g. the observations of many environments,
+   * all noised with a single kernel launch. Every image of the batch draws
+   * from its own random states.
+   *
+   * @param[in] devDepth        Device pointer to the clean depth, a
+   *                            contiguous array of @p batchSize images in
+   *                            row-major order
+   * @param[in] batchSize       The number of depth images
+   * @param[in] rows            The number of rows of each image
+   * @param[in] cols            The number of columns of each image
+   * @param[out] devNoisyDepth  Device pointer to the memory to write the noisy
+   *                            depth, laid out the same as @p devDepth
+   */
+  void simulateBatchFromGPU(const float* devDepth,
+                            const int batchSize,
+                            const int rows,
+                            const int cols,
+                            float* devNoisyDepth);
+
   ~RedwoodNoiseModelGPUImpl();
 
  private:
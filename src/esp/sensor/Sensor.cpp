@@ -81,6 +81,14 @@ void Sensor::setTransformationFromSpec() {
   node().rotateZ(Magnum::Rad(spec_->orientation[2]));
 }
 
+core::MemoryUsage Sensor::getMemoryUsage() const {
+  core::MemoryUsage usage;
+  if (buffer_) {
+    usage.cpuBytes = buffer_->data.size();
+  }
+  return usage;
+}
+
 SensorSuite::SensorSuite(scene::SceneNode& node)
     : Magnum::SceneGraph::AbstractFeature3D{node} {}
 
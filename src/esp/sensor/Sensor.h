@@ -9,6 +9,7 @@
 
 #include "esp/core/Buffer.h"
 #include "esp/core/Esp.h"
+#include "esp/core/MemoryUsage.h"
 
 #include "esp/sensor/configure.h"
 
@@ -32,6 +33,7 @@ enum class SensorType : int32_t {
   Tensor,
   Text,
   Audio,
+  Lidar,
   SensorTypeCount,  // add new type above this term!!
 };
 
@@ -48,6 +50,7 @@ enum class SensorSubType : int32_t {
   Fisheye,
   Equirectangular,
   ImpulseResponse,
+  Spinning,
   SensorSubTypeCount,  // add new type above this term!!
 };
 
@@ -113,6 +116,19 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual bool isVisualSensor() const { return false; }
 
+  /**
+   * @brief Return whether the sensor is enabled. Disabled sensors aren't
+   * drawn or read by @ref sim::Simulator::getAgentsObservations() unless
+   * requested there by name, so their frames aren't rendered at all when
+   * nobody reads them.
+   */
+  bool isEnabled() const { return enabled_; }
+
+  /**
+   * @brief Enable or disable the sensor, see @ref isEnabled()
+   */
+  void setEnabled(bool enabled) { enabled_ = enabled; }
+
   /**
    * @brief Return whether or not this Sensor can use the HBAO effect
    */
@@ -153,9 +169,17 @@ class Sensor : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual bool displayObservation(sim::Simulator& sim) = 0;
 
+  /**
+   * @brief Estimated memory held by this Sensor for its observations: the
+   * observation buffer, and for visual sensors the render target and pixel
+   * buffers.
+   */
+  virtual core::MemoryUsage getMemoryUsage() const;
+
  protected:
   SensorSpec::ptr spec_ = nullptr;
   core::Buffer::ptr buffer_ = nullptr;
+  bool enabled_ = true;
 
   ESP_SMART_POINTERS(Sensor)
 };
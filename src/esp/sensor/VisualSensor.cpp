@@ -4,17 +4,36 @@
 
 #include "VisualSensor.h"
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 
 #include <utility>
 
+#ifdef ESP_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include "esp/core/Profiler.h"
 #include "esp/core/Utility.h"
 #include "esp/gfx/RenderTarget.h"
+#include "esp/scene/SemanticScene.h"
 #include "esp/sim/Simulator.h"
 
 namespace esp {
 namespace sensor {
 
+Mn::PixelFormat observationPixelFormat(const VisualSensorSpec& spec) {
+  const SensorType type = spec.sensorType;
+  if (type == SensorType::Semantic) {
+    return spec.compactSemanticIds ? Mn::PixelFormat::R16UI
+                                   : Mn::PixelFormat::R32UI;
+  }
+  if (type == SensorType::Depth) {
+    return Mn::PixelFormat::R32F;
+  }
+  return Mn::PixelFormat::RGBA8Unorm;
+}
+
 VisualSensorSpec::VisualSensorSpec() : SensorSpec() {
   sensorType = SensorType::Color;
 }
@@ -51,12 +70,32 @@ void VisualSensorSpec::sanityCheck() const {
   CORRADE_ASSERT(
       near > 0.0 && far > near,
       "VisualSensorSpec::sanityCheck(): the near or far plane is illegal.", );
+  CORRADE_ASSERT(renderScale > 0.0f && renderScale <= 1.0f,
+                 "VisualSensorSpec::sanityCheck(): the render scale"
+                     << renderScale << "is not in (0, 1]", );
+  CORRADE_ASSERT(renderScale == 1.0f || !gpu2gpuTransfer,
+                 "VisualSensorSpec::sanityCheck(): a render scale isn't "
+                 "supported with GPU to GPU transfer", );
+  CORRADE_ASSERT(!compactSemanticIds || !gpu2gpuTransfer,
+                 "VisualSensorSpec::sanityCheck(): compact semantic IDs "
+                 "aren't supported with GPU to GPU transfer", );
+  CORRADE_ASSERT(
+      encoding != ObservationEncoding::Jpeg || sensorType == SensorType::Color,
+      "VisualSensorSpec::sanityCheck(): sensorType must be Color if encoding "
+      "is Jpeg", );
+  CORRADE_ASSERT(jpegQuality >= 1 && jpegQuality <= 100,
+                 "VisualSensorSpec::sanityCheck(): the JPEG quality"
+                     << jpegQuality << "is not in [1, 100]", );
 }
 
 bool VisualSensorSpec::operator==(const VisualSensorSpec& a) const {
   return SensorSpec::operator==(a) && resolution == a.resolution &&
          channels == a.channels && gpu2gpuTransfer == a.gpu2gpuTransfer &&
-         far == a.far && near == a.near && a.clearColor == clearColor;
+         pinnedHostMemory == a.pinnedHostMemory && far == a.far &&
+         near == a.near && a.clearColor == clearColor &&
+         renderScale == a.renderScale &&
+         compactSemanticIds == a.compactSemanticIds &&
+         encoding == a.encoding && jpegQuality == a.jpegQuality;
 }
 
 VisualSensor::VisualSensor(scene::SceneNode& node, VisualSensorSpec::ptr spec)
@@ -68,12 +107,64 @@ VisualSensor::VisualSensor(scene::SceneNode& node, VisualSensorSpec::ptr spec)
 }
 
 void VisualSensor::bindRenderTarget(gfx::RenderTarget::uptr&& tgt) {
-  if (tgt->framebufferSize() != framebufferSize())
+  bindRenderTarget(std::shared_ptr<gfx::RenderTarget>{std::move(tgt)});
+}
+
+void VisualSensor::bindRenderTarget(std::shared_ptr<gfx::RenderTarget> tgt) {
+  if (tgt->outputSize() != framebufferSize())
     throw std::runtime_error("RenderTarget is not the correct size");
 
   tgt_ = std::move(tgt);
 }
 
+core::MemoryUsage VisualSensor::getMemoryUsage() const {
+  core::MemoryUsage usage = Sensor::getMemoryUsage();
+  if (tgt_) {
+    usage.gpuBytes += tgt_->gpuMemoryUsage() / tgt_.use_count();
+  }
+#ifndef MAGNUM_TARGET_WEBGL
+  if (readback_) {
+    usage.gpuBytes += readback_->gpuMemoryUsage();
+  }
+#endif
+#ifdef ESP_BUILD_WITH_CUDA
+  if (gpuObservation_) {
+    usage.gpuBytes += gpuObservationSize_;
+  }
+#endif
+  return usage;
+}
+
+Mn::Vector2i VisualSensor::renderTargetSize() const {
+  const Mn::Vector2i size = framebufferSize();
+  const float scale = visualSensorSpec_->renderScale;
+  // the cubemap sensors resample from the framebuffer size themselves
+  if (scale == 1.0f ||
+      (visualSensorSpec_->sensorSubType != SensorSubType::Pinhole &&
+       visualSensorSpec_->sensorSubType != SensorSubType::Orthographic)) {
+    return size;
+  }
+  return Mn::Math::max(Mn::Vector2i{Mn::Math::round(Mn::Vector2{size} * scale)},
+                       Mn::Vector2i{1});
+}
+
+gfx::RenderTarget& VisualSensor::renderTarget() {
+  ESP_CHECK(hasRenderTarget(),
+            "VisualSensor::renderTarget(): Sensor has no rendering target");
+  // the resolution or render scale may have changed since binding, resize
+  // lazily
+  if (tgt_->outputSize() != framebufferSize() ||
+      tgt_->framebufferSize() != renderTargetSize()) {
+    ESP_CHECK(tgt_.use_count() == 1,
+              "VisualSensor::renderTarget(): the render target of sensor"
+                  << visualSensorSpec_->uuid
+                  << "is shared with other sensors, bind the group again "
+                     "after changing its resolution");
+    tgt_->resize(renderTargetSize(), framebufferSize());
+  }
+  return *tgt_;
+}
+
 bool VisualSensor::displayObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
@@ -90,40 +181,153 @@ bool VisualSensor::getObservationSpace(ObservationSpace& space) {
                  static_cast<size_t>(visualSensorSpec_->channels)};
   space.dataType = core::DataType::DT_UINT8;
   if (visualSensorSpec_->sensorType == SensorType::Semantic) {
-    space.dataType = core::DataType::DT_UINT32;
+    space.dataType = visualSensorSpec_->compactSemanticIds
+                         ? core::DataType::DT_UINT16
+                         : core::DataType::DT_UINT32;
   } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
     space.dataType = core::DataType::DT_FLOAT;
   }
   return true;
 }
 
-void VisualSensor::readObservation(Observation& obs) {
-  // Make sure we have memory
-  if (buffer_ == nullptr) {
-    // TODO: check if our sensor was resized and resize our buffer if needed
-    ObservationSpace space;
-    getObservationSpace(space);
-    buffer_ = core::Buffer::create(space.shape, space.dataType);
+void VisualSensor::prepareObservationBuffer(Observation& obs) {
+  // Make sure we have memory, of the current resolution
+  ObservationSpace space;
+  getObservationSpace(space);
+  if (buffer_ == nullptr || buffer_->shape != space.shape) {
+    buffer_ = core::Buffer::create(space.shape, space.dataType,
+                                   visualSensorSpec_->pinnedHostMemory);
   }
   obs.buffer = buffer_;
+}
+
+void VisualSensor::checkCompactSemanticIds(sim::Simulator& sim) const {
+  if (!visualSensorSpec_->compactSemanticIds) {
+    return;
+  }
+  const auto semanticScene = sim.getSemanticScene();
+  ESP_CHECK(!semanticScene || semanticScene->objects().size() <= 0xffff,
+            "VisualSensor::drawObservation(): the semantic scene has"
+                << semanticScene->objects().size()
+                << "objects, too many for compact semantic IDs");
+}
+
+void VisualSensor::readObservation(Observation& obs) {
+  ESP_PROFILE_SCOPE("VisualSensor::readObservation");
+  prepareObservationBuffer(obs);
 
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
+  const Magnum::MutableImageView2D view{
+      observationPixelFormat(*visualSensorSpec_), framebufferSize(),
+      obs.buffer->data};
   if (visualSensorSpec_->sensorType == SensorType::Semantic) {
-    renderTarget().readFrameObjectId(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32UI, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameObjectId(view);
   } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
-    renderTarget().readFrameDepth(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::R32F, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameDepth(view);
   } else {
-    renderTarget().readFrameRgba(Magnum::MutableImageView2D{
-        Magnum::PixelFormat::RGBA8Unorm, renderTarget().framebufferSize(),
-        obs.buffer->data});
+    renderTarget().readFrameRgba(view);
+  }
+}
+
+EncodedObservation VisualSensor::encodeObservation(
+    Observation& obs,
+    ObservationEncoder& encoder) {
+  ESP_CHECK(visualSensorSpec_->encoding != ObservationEncoding::None,
+            "VisualSensor::encodeObservation(): sensor"
+                << visualSensorSpec_->uuid << "has no encoding set");
+  ESP_CHECK(obs.buffer && obs.buffer == buffer_,
+            "VisualSensor::encodeObservation(): the observation wasn't read "
+            "by this sensor");
+  const Mn::ImageView2D view{observationPixelFormat(*visualSensorSpec_),
+                             framebufferSize(), obs.buffer->data};
+  buffer_ = nullptr;
+  return encoder.encode(view, std::move(obs.buffer),
+                        visualSensorSpec_->encoding,
+                        visualSensorSpec_->jpegQuality);
+}
+
+#ifndef MAGNUM_TARGET_WEBGL
+void VisualSensor::startReadObservation() {
+  ESP_PROFILE_SCOPE("VisualSensor::startReadObservation");
+  const SensorType type = visualSensorSpec_->sensorType;
+  if (!readback_) {
+    readback_ = std::make_unique<gfx::AsyncReadback>(
+        observationPixelFormat(*visualSensorSpec_), readbackSlotCount_);
+  }
+
+  gfx::RenderTarget& tgt = renderTarget();
+  readback_->start([&tgt, type](Mn::GL::BufferImage2D& image) {
+    if (type == SensorType::Semantic) {
+      tgt.readFrameObjectId(image);
+    } else if (type == SensorType::Depth) {
+      tgt.readFrameDepth(image);
+    } else {
+      tgt.readFrameRgba(image);
+    }
+  });
+}
+
+bool VisualSensor::finishReadObservation(Observation& obs) {
+  if (!pendingReadObservationCount()) {
+    return false;
   }
+  prepareObservationBuffer(obs);
+  return finishReadObservation(Magnum::MutableImageView2D{
+      observationPixelFormat(*visualSensorSpec_),
+      framebufferSize(), obs.buffer->data});
 }
 
+bool VisualSensor::finishReadObservation(
+    const Magnum::MutableImageView2D& view) {
+  ESP_PROFILE_SCOPE("VisualSensor::finishReadObservation");
+  return readback_ && readback_->finish(view);
+}
+
+void VisualSensor::setReadbackSlotCount(std::size_t count) {
+  ESP_CHECK(!pendingReadObservationCount(),
+            "VisualSensor::setReadbackSlotCount(): can't resize the readback "
+            "ring while readbacks are pending");
+  readbackSlotCount_ = count;
+  readback_ = nullptr;
+}
+#endif
+
+#ifdef ESP_BUILD_WITH_CUDA
+std::shared_ptr<void> VisualSensor::readObservationGPU() {
+  ESP_PROFILE_SCOPE("VisualSensor::readObservationGPU");
+  // RGBA8, R32F and R32I pixels are all four bytes
+  const Mn::Vector2i size = framebufferSize();
+  const std::size_t byteSize = std::size_t(size.product()) * 4;
+
+  // the CUDA-GL interop resources are registered once per render target, so
+  // only the device memory has to persist across reads
+  if (!gpuObservation_ || gpuObservationSize_ != byteSize) {
+    gpuObservation_ = nullptr;
+    void* devPtr = nullptr;
+    ESP_CHECK(cudaGetDevice(&gpuObservationDevice_) == cudaSuccess &&
+                  cudaMalloc(&devPtr, byteSize) == cudaSuccess,
+              "VisualSensor::readObservationGPU(): can't allocate"
+                  << byteSize << "bytes of device memory");
+    gpuObservation_ =
+        std::shared_ptr<void>{devPtr, [](void* ptr) { cudaFree(ptr); }};
+    gpuObservationSize_ = byteSize;
+  }
+
+  if (visualSensorSpec_->sensorType == SensorType::Semantic) {
+    renderTarget().readFrameObjectIdGPU(
+        static_cast<int32_t*>(gpuObservation_.get()));
+  } else if (visualSensorSpec_->sensorType == SensorType::Depth) {
+    renderTarget().readFrameDepthGPU(
+        static_cast<float*>(gpuObservation_.get()));
+  } else {
+    renderTarget().readFrameRgbaGPU(
+        static_cast<uint8_t*>(gpuObservation_.get()));
+  }
+  return gpuObservation_;
+}  // VisualSensor::readObservationGPU
+#endif
+
 bool VisualSensor::getObservation(sim::Simulator& sim, Observation& obs) {
   // TODO: check if sensor is valid?
   // TODO: have different classes for the different types of sensors
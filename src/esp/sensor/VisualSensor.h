@@ -6,13 +6,16 @@
 #define ESP_SENSOR_VISUALSENSOR_H_
 
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
 #include <Magnum/Math/Angle.h>
 #include <Magnum/Math/ConfigurationValue.h>
 
 #include "esp/core/Check.h"
 #include "esp/core/Esp.h"
 
+#include "esp/gfx/AsyncReadback.h"
 #include "esp/gfx/RenderCamera.h"
+#include "esp/sensor/ObservationEncoder.h"
 #include "esp/sensor/Sensor.h"
 
 namespace Mn = Magnum;
@@ -46,6 +49,11 @@ struct VisualSensorSpec : public SensorSpec {
    * @brief True for pytorch tensor support
    */
   bool gpu2gpuTransfer = false;
+  /**
+   * @brief Keep observations in page-locked host memory, so they can be
+   * copied to a GPU asynchronously. Only has an effect in CUDA builds.
+   */
+  bool pinnedHostMemory = false;
   /**
    * @brief near clipping plane
    */
@@ -58,6 +66,30 @@ struct VisualSensorSpec : public SensorSpec {
    * @brief color used to clear the framebuffer
    */
   Mn::Color4 clearColor = {0, 0, 0, 1};
+  /**
+   * @brief Render at this fraction of @ref resolution and upsample to it when
+   * reading observations, trading quality for throughput. In (0, 1], only
+   * used by pinhole and orthographic camera sensors, not with
+   * @ref gpu2gpuTransfer.
+   */
+  float renderScale = 1.0f;
+  /**
+   * @brief Read semantic observations as 16-bit instead of 32-bit IDs,
+   * halving the readback. IDs above 65535 get clamped to it, so drawing
+   * fails if the active semantic scene has more objects than that. Ignored
+   * by non-semantic sensors, not supported with @ref gpu2gpuTransfer.
+   */
+  bool compactSemanticIds = false;
+  /**
+   * @brief How @ref sim::Simulator::getAgentsEncodedObservations()
+   * compresses observations of this sensor. @ref ObservationEncoding::Jpeg
+   * is only supported by color sensors.
+   */
+  ObservationEncoding encoding = ObservationEncoding::None;
+  /**
+   * @brief Quality of @ref ObservationEncoding::Jpeg, in [1, 100]
+   */
+  int jpegQuality = 90;
 
   /**
    * @brief the type of semantic information being rendered by the semantic
@@ -72,6 +104,11 @@ struct VisualSensorSpec : public SensorSpec {
   ESP_SMART_POINTERS(VisualSensorSpec)
 };
 
+/**
+ * @brief Pixel format of the observations of a sensor with spec @p spec
+ */
+Magnum::PixelFormat observationPixelFormat(const VisualSensorSpec& spec);
+
 // Represents a sensor that provides visual data from the environment to an
 // agent
 class VisualSensor : public Sensor {
@@ -101,6 +138,12 @@ class VisualSensor : public Sensor {
    */
   bool isVisualSensor() const override { return true; }
 
+  /**
+   * @brief Estimated memory held by this Sensor for its observations. A
+   * render target shared by several sensors is split evenly between them.
+   */
+  core::MemoryUsage getMemoryUsage() const override;
+
   /**
    * @brief Returns the parameters needed to unproject depth for the sensor.
    */
@@ -118,14 +161,26 @@ class VisualSensor : public Sensor {
    */
   void bindRenderTarget(std::unique_ptr<gfx::RenderTarget>&& tgt);
 
+  /**
+   * @brief Binds a RenderTarget the sensor shares with other sensors, e.g.
+   * the target of a fused sensor group. See
+   * @ref gfx::Renderer::bindFusedRenderTarget()
+   */
+  void bindRenderTarget(std::shared_ptr<gfx::RenderTarget> tgt);
+
   /**
    * @brief Returns a reference to the sensors render target
+   *
+   * If the resolution or render scale changed since it was bound, it's
+   * resized first, which expects it to not be shared with other sensors.
    */
-  gfx::RenderTarget& renderTarget() {
-    ESP_CHECK(hasRenderTarget(),
-              "VisualSensor::renderTarget(): Sensor has no rendering target");
-    return *tgt_;
-  }
+  gfx::RenderTarget& renderTarget();
+
+  /**
+   * @brief Size the sensor renders at in WxH, @ref framebufferSize() scaled
+   * by @ref VisualSensorSpec::renderScale for sensors that support it
+   */
+  Magnum::Vector2i renderTargetSize() const;
 
   /**
    * @brief Draw an observation to the frame buffer using simulator's renderer
@@ -142,6 +197,101 @@ class VisualSensor : public Sensor {
    */
   virtual void readObservation(Observation& obs);
 
+  /**
+   * @brief Compress the observation in @p obs on @p encoder's threads
+   *
+   * Takes the buffer of @p obs over, which has to be this sensor's own
+   * buffer, e.g. from @ref readObservation(). The next read allocates a new
+   * one, so the sensor can draw and read the next observation while this one
+   * is compressed. Expects that @ref VisualSensorSpec::encoding is set.
+   */
+  EncodedObservation encodeObservation(Observation& obs,
+                                       ObservationEncoder& encoder);
+
+#ifndef MAGNUM_TARGET_WEBGL
+  /**
+   * @brief Start reading back the observation that was last drawn, without
+   * waiting for the GPU.
+   *
+   * Up to @ref readbackSlotCount() readbacks can be pending. They are
+   * completed in order by @ref finishReadObservation(), which lets the
+   * observation of one frame be retrieved while the next one renders.
+   */
+  void startReadObservation();
+
+  /**
+   * @brief Wait for the oldest readback started by @ref startReadObservation()
+   * and store its result
+   * @param[in,out] obs Instance of Observation class in which the observation
+   * will be stored
+   * @return false if no readback is pending
+   */
+  bool finishReadObservation(Observation& obs);
+
+  /**
+   * @brief Wait for the oldest readback started by @ref startReadObservation()
+   * and copy its result to @p view
+   * @return false if no readback is pending
+   */
+  bool finishReadObservation(const Magnum::MutableImageView2D& view);
+
+  /**
+   * @brief Number of readbacks started and not finished yet
+   */
+  std::size_t pendingReadObservationCount() const {
+    return readback_ ? readback_->pendingCount() : 0;
+  }
+
+  /**
+   * @brief Whether the oldest pending readback completed, so
+   * @ref finishReadObservation() won't wait
+   */
+  bool isReadObservationReady() const {
+    return readback_ && readback_->isReady();
+  }
+
+  /**
+   * @brief How many readbacks can be pending at once. Defaults to 2, i.e.
+   * double-buffered.
+   */
+  std::size_t readbackSlotCount() const { return readbackSlotCount_; }
+
+  /**
+   * @brief Set how many readbacks can be pending at once. Expects that no
+   * readback is pending.
+   */
+  void setReadbackSlotCount(std::size_t count);
+#endif
+
+#ifdef ESP_BUILD_WITH_CUDA
+  /**
+   * @brief Copy the observation that was last drawn to the sensor's CUDA
+   * buffer, without going through host memory
+   *
+   * The buffer is allocated on the current CUDA device on first use and
+   * reused by all subsequent reads. It holds @ref framebufferSize() pixels of
+   * four-byte RGBA, float depth or 32-bit object ID values, with rows stored
+   * bottom to top. The device has to be the one the OpenGL context renders
+   * on.
+   * @return The buffer, see @ref observationGPUBuffer()
+   */
+  std::shared_ptr<void> readObservationGPU();
+
+  /**
+   * @brief The CUDA buffer filled by @ref readObservationGPU(), or
+   * @cpp nullptr @ce if it wasn't called yet
+   *
+   * Shares ownership of the device memory, which thus stays valid even after
+   * the sensor is destroyed.
+   */
+  std::shared_ptr<void> observationGPUBuffer() const {
+    return gpuObservation_;
+  }
+
+  /** @brief CUDA device of @ref observationGPUBuffer() */
+  int observationGPUDevice() const { return gpuObservationDevice_; }
+#endif
+
   /*
    * @brief Display next observation from Simulator on default frame buffer
    * @brief Draws an observation to the frame buffer using simulator's renderer,
@@ -166,6 +316,8 @@ class VisualSensor : public Sensor {
 
   /**
    * @brief Sets resolution of Sensor's sensorSpec
+   *
+   * The render target and observation buffers are resized on next use.
    */
   void setResolution(int height, int width) {
     CORRADE_ASSERT(height > 0 && width > 0,
@@ -221,11 +373,35 @@ class VisualSensor : public Sensor {
   }
 
  protected:
+  /**
+   * @brief Point @p obs at the sensor's observation buffer, allocating it on
+   * first use
+   */
+  void prepareObservationBuffer(Observation& obs);
+
+  /**
+   * @brief Check that the semantic IDs of @p sim fit into 16 bits if
+   * @ref VisualSensorSpec::compactSemanticIds is enabled
+   */
+  void checkCompactSemanticIds(sim::Simulator& sim) const;
+
   /** @brief field of view
    */
   Mn::Deg hfov_ = 90.0_degf;
 
-  std::unique_ptr<gfx::RenderTarget> tgt_;
+  std::shared_ptr<gfx::RenderTarget> tgt_;
+
+#ifndef MAGNUM_TARGET_WEBGL
+  //! Pixel buffers of @ref startReadObservation(), created on first use
+  std::unique_ptr<gfx::AsyncReadback> readback_;
+  std::size_t readbackSlotCount_ = 2;
+#endif
+#ifdef ESP_BUILD_WITH_CUDA
+  //! Device memory of @ref readObservationGPU(), created on first use
+  std::shared_ptr<void> gpuObservation_;
+  std::size_t gpuObservationSize_ = 0;
+  int gpuObservationDevice_ = 0;
+#endif
   VisualSensorSpec::ptr visualSensorSpec_ =
       std::dynamic_pointer_cast<VisualSensorSpec>(spec_);
 
@@ -4,8 +4,17 @@
 
 #include "AbstractReplayRenderer.h"
 
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 namespace esp {
 namespace sim {
 
@@ -73,6 +82,91 @@ void AbstractReplayRenderer::setEnvironmentKeyframeUnwrapped(
       esp::gfx::replay::Player::keyframeFromStringUnwrapped(serKeyframe));
 }
 
+std::size_t AbstractReplayRenderer::consumeEnvironmentKeyframes(
+    unsigned envIndex,
+    esp::gfx::replay::KeyframeRingBuffer& buffer) {
+  CORRADE_INTERNAL_ASSERT(envIndex < doEnvironmentCount());
+  std::size_t count = 0;
+  while (const Cr::Containers::Optional<Cr::Containers::StringView> message =
+             buffer.peek()) {
+    doPlayerFor(envIndex).setSingleKeyframe(
+        esp::gfx::replay::Player::keyframeFromStringUnwrapped(*message));
+    buffer.pop();
+    ++count;
+  }
+  return count;
+}
+
+void AbstractReplayRenderer::setEnvironmentKeyframes(
+    const Cr::Containers::ArrayView<const std::string> serKeyframes) {
+  ESP_CHECK(serKeyframes.size() == doEnvironmentCount(),
+            "setEnvironmentKeyframes: expected" << doEnvironmentCount()
+                                                << "keyframes but got"
+                                                << serKeyframes.size());
+  Cr::Containers::Array<esp::gfx::replay::Keyframe> keyframes{
+      Cr::ValueInit, serKeyframes.size()};
+  parallelForEnvironments(
+      serKeyframes.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i != end; ++i) {
+          keyframes[i] =
+              esp::gfx::replay::Player::keyframeFromString(serKeyframes[i]);
+        }
+      });
+  doSetEnvironmentKeyframes(keyframes);
+}
+
+void AbstractReplayRenderer::setEnvironmentKeyframesUnwrapped(
+    const Cr::Containers::ArrayView<const Cr::Containers::StringView>
+        serKeyframes) {
+  ESP_CHECK(serKeyframes.size() == doEnvironmentCount(),
+            "setEnvironmentKeyframesUnwrapped: expected"
+                << doEnvironmentCount() << "keyframes but got"
+                << serKeyframes.size());
+  Cr::Containers::Array<esp::gfx::replay::Keyframe> keyframes{
+      Cr::ValueInit, serKeyframes.size()};
+  parallelForEnvironments(
+      serKeyframes.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i != end; ++i) {
+          keyframes[i] = esp::gfx::replay::Player::keyframeFromStringUnwrapped(
+              serKeyframes[i]);
+        }
+      });
+  doSetEnvironmentKeyframes(keyframes);
+}
+
+void AbstractReplayRenderer::doSetEnvironmentKeyframes(
+    const Cr::Containers::ArrayView<esp::gfx::replay::Keyframe> keyframes) {
+  for (std::size_t i = 0; i != keyframes.size(); ++i) {
+    doPlayerFor(i).setSingleKeyframe(std::move(keyframes[i]));
+  }
+}
+
+void AbstractReplayRenderer::parallelForEnvironments(
+    const std::size_t count,
+    const std::function<void(std::size_t, std::size_t)>& function) {
+  // not worth a thread for less than a few dozen environments
+  const std::size_t numThreads = std::max<std::size_t>(
+      1, std::min<std::size_t>(std::thread::hardware_concurrency(),
+                               count / 32));
+  if (numThreads == 1) {
+    function(0, count);
+    return;
+  }
+
+  const std::size_t countPerThread = (count + numThreads - 1) / numThreads;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    const std::size_t begin = std::min(count, i * countPerThread);
+    const std::size_t end = std::min(count, begin + countPerThread);
+    workers.emplace_back([&function, begin, end]() { function(begin, end); });
+  }
+  function(0, std::min(count, countPerThread));
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
 void AbstractReplayRenderer::setSensorTransform(unsigned envIndex,
                                                 const std::string& sensorName,
                                                 const Mn::Matrix4& transform) {
@@ -91,21 +185,32 @@ void AbstractReplayRenderer::setSensorTransformsFromKeyframe(
   return doSetSensorTransformsFromKeyframe(envIndex, prefix);
 }
 
-void AbstractReplayRenderer::render(
+void AbstractReplayRenderer::checkImageViews(
+    const char* const messagePrefix,
     Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
     Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
   if (colorImageViews.size() > 0) {
     ESP_CHECK(colorImageViews.size() == doEnvironmentCount(),
-              "ReplayRenderer::render(): expected"
-                  << doEnvironmentCount() << "color image views but got"
-                  << colorImageViews.size());
+              messagePrefix << "expected" << doEnvironmentCount()
+                            << "color image views but got"
+                            << colorImageViews.size());
   }
   if (depthImageViews.size() > 0) {
     ESP_CHECK(depthImageViews.size() == doEnvironmentCount(),
-              "ReplayRenderer::render(): expected"
-                  << doEnvironmentCount() << "depth image views but got"
-                  << depthImageViews.size());
+              messagePrefix << "expected" << doEnvironmentCount()
+                            << "depth image views but got"
+                            << depthImageViews.size());
   }
+}
+
+void AbstractReplayRenderer::render(
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
+  checkImageViews("ReplayRenderer::render():", colorImageViews,
+                  depthImageViews);
+  ESP_CHECK(!framesInFlight_, "ReplayRenderer::render(): retrieve the"
+                                  << framesInFlight_
+                                  << "frames in flight with waitFrame() first");
   return doRender(colorImageViews, depthImageViews);
 }
 
@@ -114,6 +219,43 @@ void AbstractReplayRenderer::render(
   return doRender(framebuffer);
 }
 
+void AbstractReplayRenderer::renderAsync() {
+  ESP_CHECK(framesInFlight_ < 2,
+            "ReplayRenderer::renderAsync(): two frames are already in flight, "
+            "retrieve one with waitFrame() first");
+  doRenderAsync();
+  ++framesInFlight_;
+}
+
+void AbstractReplayRenderer::waitFrame(
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
+  checkImageViews("ReplayRenderer::waitFrame():", colorImageViews,
+                  depthImageViews);
+  ESP_CHECK(framesInFlight_,
+            "ReplayRenderer::waitFrame(): no frame in flight, call "
+            "renderAsync() first");
+  doWaitFrame(colorImageViews, depthImageViews);
+  --framesInFlight_;
+}
+
+unsigned AbstractReplayRenderer::framesInFlight() const {
+  return framesInFlight_;
+}
+
+void AbstractReplayRenderer::doRenderAsync() {
+  ESP_CHECK(false,
+            "ReplayRenderer::renderAsync(): only supported by the batch "
+            "renderer");
+}
+
+void AbstractReplayRenderer::doWaitFrame(
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D>,
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D>) {
+  /* Can't get here as doRenderAsync() fails */
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
 const void* AbstractReplayRenderer::getCudaColorBufferDevicePointer() {
   ESP_ERROR() << "CUDA device pointer only available with the batch renderer.";
   return nullptr;
@@ -124,6 +266,30 @@ const void* AbstractReplayRenderer::getCudaDepthBufferDevicePointer() {
   return nullptr;
 }
 
+const void* AbstractReplayRenderer::getCudaObjectIdBufferDevicePointer() {
+  ESP_ERROR() << "CUDA device pointer only available with the batch renderer.";
+  return nullptr;
+}
+
+CudaImageView AbstractReplayRenderer::getCudaColorImageView(unsigned) {
+  ESP_ERROR() << "CUDA image views only available with the batch renderer.";
+  return {};
+}
+
+CudaImageView AbstractReplayRenderer::getCudaDepthImageView(unsigned) {
+  ESP_ERROR() << "CUDA image views only available with the batch renderer.";
+  return {};
+}
+
+CudaImageView AbstractReplayRenderer::getCudaObjectIdImageView(unsigned) {
+  ESP_ERROR() << "CUDA image views only available with the batch renderer.";
+  return {};
+}
+
+void AbstractReplayRenderer::waitForCudaImages(unsigned, void*) {
+  ESP_ERROR() << "CUDA image views only available with the batch renderer.";
+}
+
 std::shared_ptr<esp::gfx::DebugLineRender>
 AbstractReplayRenderer::getDebugLineRender(unsigned envIndex) {
   ESP_CHECK(envIndex == 0, "getDebugLineRender is only available for env 0");
@@ -5,15 +5,21 @@
 #ifndef ESP_SIM_ABSTRACTREPLAYRENDERER_H_
 #define ESP_SIM_ABSTRACTREPLAYRENDERER_H_
 
+#include <Magnum/Math/Vector2.h>
+
 #include "esp/geo/Geo.h"
 #include "esp/gfx/DebugLineRender.h"
 
+#include <functional>
+
 namespace esp {
 
 namespace gfx {
 namespace replay {
+class KeyframeRingBuffer;
 class Player;
-}
+struct Keyframe;
+}  // namespace replay
 }  // namespace gfx
 
 namespace sensor {
@@ -37,6 +43,15 @@ class ReplayRendererConfiguration {
   int numEnvironments = 1;
   //! The system GPU device to use for rendering.
   int gpuDeviceId = 0;
+  /**
+   * @brief CUDA devices to spread the environments across
+   *
+   * Only used by the batch renderer. If not empty, @ref gpuDeviceId is
+   * ignored and each device gets its own standalone renderer and GL context
+   * rendering an even, contiguous share of the @ref numEnvironments
+   * environments. Requires @ref standalone.
+   */
+  std::vector<int> gpuDeviceIds;
   /**
    * @brief Have the renderer create its own GPU context
    *
@@ -59,11 +74,65 @@ class ReplayRendererConfiguration {
 
   bool enableHBAO = false;
 
+  /**
+   * @brief GPU texture memory budget in bytes
+   *
+   * Only used by the batch renderer, for each GPU device. If non-zero,
+   * textures with a pre-made mip chain are streamed in only for environments
+   * that reference them, and evicted when over the budget. See
+   * @ref gfx_batch::RendererConfiguration::setTextureMemoryBudget() for
+   * details. Default is @cpp 0 @ce, meaning unlimited.
+   */
+  std::size_t textureMemoryBudget = 0;
+
+  /**
+   * @brief Count of threads preparing environments for drawing
+   *
+   * Only used by the batch renderer, see
+   * @ref gfx_batch::RendererConfiguration::setDrawThreadCount(). Default is
+   * @cpp 1 @ce, zero means one per hardware core.
+   */
+  unsigned drawThreadCount = 1;
+
+  /**
+   * @brief Render just depth
+   *
+   * Only used by the batch renderer, see
+   * @ref gfx_batch::RendererFlag::DepthOnly. There's no color output then,
+   * so no color images can be retrieved.
+   */
+  bool depthOnly = false;
+
+  /**
+   * @brief Output semantic IDs of all instances
+   *
+   * Only used by the batch renderer, see
+   * @ref gfx_batch::RendererFlag::ObjectId. The IDs come from the semantic
+   * IDs in keyframe state updates and are retrievable through
+   * @ref AbstractReplayRenderer::getCudaObjectIdImageView().
+   */
+  bool objectIds = false;
+
   std::vector<std::shared_ptr<sensor::SensorSpec>> sensorSpecifications;
 
   ESP_SMART_POINTERS(ReplayRendererConfiguration)
 };
 
+/**
+ * @brief View on an environment image in a CUDA device buffer
+ *
+ * Rows are @ref rowStride bytes apart and ordered bottom-up, as in the GL
+ * framebuffer, pixels in a row are tightly packed. Valid until the next
+ * render.
+ */
+struct CudaImageView {
+  //! Device pointer to the first pixel, null if not available
+  const void* data = nullptr;
+  Magnum::PixelFormat format{};
+  Magnum::Vector2i size;
+  std::size_t rowStride = 0;
+};
+
 class AbstractReplayRenderer {
  public:
   static Magnum::Vector2i environmentGridSize(int environmentCount);
@@ -88,6 +157,27 @@ class AbstractReplayRenderer {
       unsigned envIndex,
       Corrade::Containers::StringView serKeyframe);
 
+  // Sets keyframes of all environments at once, one wrapped keyframe per
+  // environment, same as calling setEnvironmentKeyframe() for each. The
+  // keyframes are decoded in parallel and backends that support it apply
+  // keyframes that only update instance states in parallel as well.
+  void setEnvironmentKeyframes(
+      Corrade::Containers::ArrayView<const std::string> serKeyframes);
+
+  // Same as setEnvironmentKeyframes() but with each keyframe consumed
+  // directly as in setEnvironmentKeyframeUnwrapped().
+  void setEnvironmentKeyframesUnwrapped(
+      Corrade::Containers::ArrayView<const Corrade::Containers::StringView>
+          serKeyframes);
+
+  // Applies all keyframes pending in a ring buffer filled by
+  // Recorder::writeIncrementalSavedKeyframesToRingBuffer() to given
+  // environment, in order. The keyframes are decoded directly from the
+  // shared memory. Returns the number of keyframes applied.
+  std::size_t consumeEnvironmentKeyframes(
+      unsigned envIndex,
+      esp::gfx::replay::KeyframeRingBuffer& buffer);
+
   void setSensorTransform(unsigned envIndex,
                           const std::string& sensorName,
                           const Magnum::Matrix4& transform);
@@ -109,12 +199,47 @@ class AbstractReplayRenderer {
   // Assumes the framebuffer color & depth is cleared
   void render(Magnum::GL::AbstractFramebuffer& framebuffer);
 
+  // Submits rendering of all environments and returns without waiting for
+  // the GPU. Keyframes and sensor transforms set afterwards affect only the
+  // next frame, so they can be prepared while this one renders. Up to two
+  // frames can be in flight, retrieve them in order with waitFrame(). Only
+  // supported by the batch renderer.
+  void renderAsync();
+
+  // Waits for the oldest frame submitted with renderAsync() and copies it
+  // into the specified CPU-resident image view arrays, same as render().
+  void waitFrame(
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          colorImageViews,
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          depthImageViews);
+
+  // Count of frames submitted with renderAsync() and not yet retrieved with
+  // waitFrame().
+  unsigned framesInFlight() const;
+
   // Retrieve the color buffer as a CUDA device pointer. */
   virtual const void* getCudaColorBufferDevicePointer();
 
   // Retrieve the depth buffer as a CUDA device pointer. */
   virtual const void* getCudaDepthBufferDevicePointer();
 
+  // Retrieve the object ID buffer as a CUDA device pointer.
+  virtual const void* getCudaObjectIdBufferDevicePointer();
+
+  // Retrieve the color image of given environment in a CUDA buffer.
+  virtual CudaImageView getCudaColorImageView(unsigned envIndex);
+
+  // Retrieve the raw depth image of given environment in a CUDA buffer.
+  virtual CudaImageView getCudaDepthImageView(unsigned envIndex);
+
+  // Retrieve the object ID image of given environment in a CUDA buffer.
+  virtual CudaImageView getCudaObjectIdImageView(unsigned envIndex);
+
+  // Make a cudaStream_t wait until the CUDA images of given environment
+  // retrieved since the last render are ready, without a device-wide sync.
+  virtual void waitForCudaImages(unsigned envIndex, void* stream);
+
   std::shared_ptr<esp::gfx::DebugLineRender> getDebugLineRender(
       unsigned envIndex);
 
@@ -132,6 +257,20 @@ class AbstractReplayRenderer {
  protected:
   void checkEnvIndex(unsigned envIndex);
 
+  void checkImageViews(
+      const char* messagePrefix,
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          colorImageViews,
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          depthImageViews);
+
+  // Calls function with contiguous [begin, end) ranges covering count
+  // environments, spread across threads if count is large enough to make it
+  // worth it. Returns once all ranges are processed.
+  static void parallelForEnvironments(
+      std::size_t count,
+      const std::function<void(std::size_t, std::size_t)>& function);
+
   std::shared_ptr<esp::gfx::DebugLineRender> debugLineRender_;
 
  private:
@@ -156,6 +295,13 @@ class AbstractReplayRenderer {
   /* envIndex is guaranteed to be in bounds */
   virtual Magnum::Vector2i doSensorSize(unsigned envIndex) = 0;
 
+  /* keyframes.size() is guaranteed to be same as doEnvironmentCount(), the
+     keyframes can be moved from. Default implementation calls
+     Player::setSingleKeyframe() on doPlayerFor() of each environment in
+     order. */
+  virtual void doSetEnvironmentKeyframes(
+      Corrade::Containers::ArrayView<esp::gfx::replay::Keyframe> keyframes);
+
   /* envIndex is guaranteed to be in bounds */
   virtual void doSetSensorTransform(unsigned envIndex,
                                     const std::string& sensorName,
@@ -174,9 +320,22 @@ class AbstractReplayRenderer {
 
   virtual void doRender(Magnum::GL::AbstractFramebuffer& framebuffer) = 0;
 
+  /* Default implementations fail with an error, as asynchronous rendering
+     needs backend support. doRenderAsync() is called with at most one frame
+     in flight, doWaitFrame() with at least one, imageViews.size() same as in
+     doRender(). */
+  virtual void doRenderAsync();
+  virtual void doWaitFrame(
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          colorImageViews,
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          depthImageViews);
+
   virtual esp::geo::Ray doUnproject(unsigned envIndex,
                                     const Mn::Vector2i& viewportPosition) = 0;
 
+  unsigned framesInFlight_ = 0;
+
   ESP_SMART_POINTERS(AbstractReplayRenderer)
 };
 
@@ -89,9 +89,8 @@ BatchPlayerImplementation::loadAndCreateRenderAssetInstance(
 
 void BatchPlayerImplementation::deleteAssetInstance(
     const gfx::replay::NodeHandle node) {
-  // TODO actually remove from the scene instead of setting a zero scale
-  renderer_.transformations(sceneId_)[reinterpret_cast<std::size_t>(node) - 1] =
-      Mn::Matrix4{Mn::Math::ZeroInit};
+  renderer_.removeNodeHierarchy(sceneId_,
+                                reinterpret_cast<std::size_t>(node) - 1);
 }
 
 void BatchPlayerImplementation::deleteAssetInstances(
@@ -121,6 +120,16 @@ Mn::Matrix4 BatchPlayerImplementation::hackGetNodeTransform(
       sceneId_)[reinterpret_cast<std::size_t>(node) - 1];
 }
 
+void BatchPlayerImplementation::setNodeSemanticId(
+    const gfx::replay::NodeHandle node,
+    const unsigned id) {
+  // semantic IDs are output only if the renderer has an object ID output
+  if (!(renderer_.flags() & gfx_batch::RendererFlag::ObjectId)) {
+    return;
+  }
+  renderer_.setObjectId(sceneId_, reinterpret_cast<std::size_t>(node) - 1, id);
+}
+
 void BatchPlayerImplementation::changeLightSetup(
     const esp::gfx::LightSetup& lights) {
   if (!renderer_.maxLightCount()) {
@@ -176,9 +185,7 @@ void BatchPlayerImplementation::deleteRigInstance(int) {
   // Not implemented.
 }
 
-void BatchPlayerImplementation::setRigPose(
-    int,
-    const std::vector<gfx::replay::Transform>&) {
+void BatchPlayerImplementation::setRigPose(int, const gfx::replay::RigPose&) {
   // Not implemented.
 }
 }  // namespace sim
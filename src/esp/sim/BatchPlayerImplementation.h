@@ -39,13 +39,15 @@ class BatchPlayerImplementation
 
   Mn::Matrix4 hackGetNodeTransform(gfx::replay::NodeHandle node) const override;
 
+  void setNodeSemanticId(gfx::replay::NodeHandle node, unsigned id) override;
+
   void changeLightSetup(const esp::gfx::LightSetup& lights) override;
 
   void createRigInstance(int, const std::vector<std::string>&) override;
 
   void deleteRigInstance(int) override;
 
-  void setRigPose(int, const std::vector<gfx::replay::Transform>&) override;
+  void setRigPose(int, const gfx::replay::RigPose&) override;
 
   gfx_batch::Renderer& renderer_;
   Mn::UnsignedInt sceneId_;
@@ -12,6 +12,7 @@
 #include <Magnum/GL/AbstractFramebuffer.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 
 namespace esp {
 namespace sim {
@@ -30,28 +31,69 @@ BatchReplayRenderer::BatchReplayRenderer(
   const auto& sensor = static_cast<esp::sensor::CameraSensorSpec&>(
       *cfg.sensorSpecifications.front());
 
-  batchRendererConfiguration.setTileSizeCount(
-      Mn::Vector2i{sensor.resolution}.flipped(),
-      environmentGridSize(cfg.numEnvironments));
-  if ((standalone_ = cfg.standalone))
-    renderer_.emplace<gfx_batch::RendererStandalone>(
-        batchRendererConfiguration,
-        gfx_batch::RendererStandaloneConfiguration{});
-  else {
-    CORRADE_ASSERT(Mn::GL::Context::hasCurrent(),
-                   "BatchReplayRenderer: expecting a current GL context if a "
-                   "standalone renderer is disabled", );
-    renderer_.emplace<gfx_batch::Renderer>(batchRendererConfiguration);
+  ESP_CHECK(cfg.gpuDeviceIds.empty() || cfg.standalone,
+            "BatchReplayRenderer: spreading environments across GPU devices "
+            "requires a standalone renderer");
+  ESP_CHECK(cfg.gpuDeviceIds.size() <= std::size_t(cfg.numEnvironments),
+            "BatchReplayRenderer: got" << cfg.gpuDeviceIds.size()
+                                       << "GPU devices for only"
+                                       << cfg.numEnvironments
+                                       << "environments");
+
+  // the environments are all alike, so an even split balances the load.
+  // Every device gets its own context and a copy of the GPU data.
+  const std::size_t deviceCount =
+      cfg.gpuDeviceIds.empty() ? 1 : cfg.gpuDeviceIds.size();
+  standalone_ = cfg.standalone;
+  if (cfg.textureMemoryBudget)
+    batchRendererConfiguration.setTextureMemoryBudget(cfg.textureMemoryBudget);
+  batchRendererConfiguration.setDrawThreadCount(cfg.drawThreadCount);
+  if (cfg.depthOnly)
+    batchRendererConfiguration.addFlags(gfx_batch::RendererFlag::DepthOnly);
+  if (cfg.objectIds)
+    batchRendererConfiguration.addFlags(gfx_batch::RendererFlag::ObjectId);
+  for (std::size_t device = 0; device != deviceCount; ++device) {
+    const unsigned environmentOffset =
+        device * cfg.numEnvironments / deviceCount;
+    const unsigned environmentCount =
+        (device + 1) * cfg.numEnvironments / deviceCount - environmentOffset;
+    batchRendererConfiguration.setTileSizeCount(
+        Mn::Vector2i{sensor.resolution}.flipped(),
+        environmentGridSize(environmentCount));
+
+    gfx::WindowlessContextPool::Borrowed context;
+    Cr::Containers::Pointer<gfx_batch::Renderer> renderer;
+    if (standalone_) {
+      // contexts are reused across renderers closed and created again
+      context = gfx::WindowlessContextPool::instance().acquire(
+          cfg.gpuDeviceIds.empty() ? cfg.gpuDeviceId
+                                   : cfg.gpuDeviceIds[device]);
+      gfx::WindowlessContext* const contextPointer = context.get();
+      gfx_batch::RendererStandaloneConfiguration standaloneConfiguration;
+      standaloneConfiguration.setExternalContext(
+          [contextPointer]() { contextPointer->makeCurrent(); });
+      renderer.emplace<gfx_batch::RendererStandalone>(
+          batchRendererConfiguration, standaloneConfiguration);
+    } else {
+      CORRADE_ASSERT(Mn::GL::Context::hasCurrent(),
+                     "BatchReplayRenderer: expecting a current GL context if "
+                     "a standalone renderer is disabled", );
+      renderer.emplace<gfx_batch::Renderer>(batchRendererConfiguration);
+    }
+
+    for (unsigned i = 0; i != environmentCount; ++i) {
+      arrayAppend(envs_, EnvironmentRecord{
+                             std::make_shared<BatchPlayerImplementation>(
+                                 *renderer, i)});
+    }
+    arrayAppend(devices_, DeviceRecord{std::move(context), std::move(renderer),
+                                       environmentOffset});
   }
+  // the last created context is the current one
+  currentDevice_ = devices_.size() - 1;
 
   theOnlySensorName_ = sensor.uuid;
   theOnlySensorProjection_ = sensor.projectionMatrix();
-
-  for (Mn::UnsignedInt i = 0; i != cfg.numEnvironments; ++i) {
-    arrayAppend(
-        envs_, EnvironmentRecord{
-                   std::make_shared<BatchPlayerImplementation>(*renderer_, i)});
-  }
 }
 
 BatchReplayRenderer::~BatchReplayRenderer() {
@@ -64,14 +106,41 @@ void BatchReplayRenderer::doClose() {
 
 void BatchReplayRenderer::doCloseImpl() {
   for (int i = 0; i < envs_.size(); ++i) {
+    deviceFor(i);
     envs_[i].player_.close();
   }
   envs_ = {};
-  renderer_.reset();
+  // GL resources have to be destroyed with their own context current
+  for (std::size_t device = 0; device != devices_.size(); ++device) {
+    makeDeviceCurrent(device);
+    devices_[device].renderer_.reset();
+    devices_[device].gpuTimer_ = gfx::GpuTimer{};
+  }
+  devices_ = {};
+}
+
+void BatchReplayRenderer::makeDeviceCurrent(std::size_t device) {
+  if (device == currentDevice_)
+    return;
+  CORRADE_INTERNAL_ASSERT(standalone_);
+  static_cast<gfx_batch::RendererStandalone&>(*devices_[device].renderer_)
+      .makeCurrent();
+  currentDevice_ = device;
+}
+
+std::size_t BatchReplayRenderer::deviceFor(unsigned envIndex) {
+  std::size_t device = devices_.size() - 1;
+  while (devices_[device].environmentOffset_ > envIndex)
+    --device;
+  makeDeviceCurrent(device);
+  return device;
 }
 
 void BatchReplayRenderer::doPreloadFile(Cr::Containers::StringView filename) {
-  CORRADE_INTERNAL_ASSERT(renderer_->addFile(filename));
+  for (std::size_t device = 0; device != devices_.size(); ++device) {
+    makeDeviceCurrent(device);
+    CORRADE_INTERNAL_ASSERT(devices_[device].renderer_->addFile(filename));
+  }
 }
 
 unsigned BatchReplayRenderer::doEnvironmentCount() const {
@@ -81,20 +150,52 @@ unsigned BatchReplayRenderer::doEnvironmentCount() const {
 Mn::Vector2i BatchReplayRenderer::doSensorSize(
     unsigned /* all environments have the same size */
 ) {
-  return renderer_->tileSize();
+  return devices_[0].renderer_->sceneRectangle(0).size();
 }
 
 gfx::replay::Player& BatchReplayRenderer::doPlayerFor(unsigned envIndex) {
+  // the player uploads newly loaded files to the current context
+  deviceFor(envIndex);
   return envs_[envIndex].player_;
 }
 
+void BatchReplayRenderer::doSetEnvironmentKeyframes(
+    const Cr::Containers::ArrayView<gfx::replay::Keyframe> keyframes) {
+  // Keyframes that load, create or delete anything or change lights modify
+  // GPU resources and state shared by the whole renderer, apply those
+  // serially with the right device current. The rest only write
+  // transformations of their own scene, which is safe to do concurrently.
+  Cr::Containers::Array<bool> applied{Cr::ValueInit, keyframes.size()};
+  for (std::size_t i = 0; i != keyframes.size(); ++i) {
+    const gfx::replay::Keyframe& keyframe = keyframes[i];
+    if (keyframe.loads.empty() && keyframe.rigCreations.empty() &&
+        keyframe.creations.empty() && keyframe.deletions.empty() &&
+        !keyframe.lightsChanged) {
+      continue;
+    }
+    doPlayerFor(i).setSingleKeyframe(std::move(keyframes[i]));
+    applied[i] = true;
+  }
+
+  parallelForEnvironments(
+      keyframes.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i != end; ++i) {
+          if (!applied[i]) {
+            envs_[i].player_.setSingleKeyframe(std::move(keyframes[i]));
+          }
+        }
+      });
+}
+
 void BatchReplayRenderer::doSetSensorTransform(
     unsigned envIndex,
     // TODO assumes there's just one sensor per env
     const std::string&,
     const Mn::Matrix4& transform) {
-  renderer_->updateCamera(envIndex, theOnlySensorProjection_,
-                          transform.inverted());
+  const DeviceRecord& device = devices_[deviceFor(envIndex)];
+  device.renderer_->updateCamera(envIndex - device.environmentOffset_,
+                                 theOnlySensorProjection_,
+                                 transform.inverted());
 }
 
 void BatchReplayRenderer::doSetSensorTransformsFromKeyframe(
@@ -108,8 +209,9 @@ void BatchReplayRenderer::doSetSensorTransformsFromKeyframe(
   ESP_CHECK(found,
             "setSensorTransformsFromKeyframe: couldn't find user transform \""
                 << userName << "\" for environment " << envIndex << ".");
-  renderer_->updateCamera(
-      envIndex, theOnlySensorProjection_,
+  const DeviceRecord& device = devices_[deviceFor(envIndex)];
+  device.renderer_->updateCamera(
+      envIndex - device.environmentOffset_, theOnlySensorProjection_,
       Mn::Matrix4::from(rotation.toMatrix(), translation).inverted());
 }
 
@@ -119,18 +221,30 @@ void BatchReplayRenderer::doRender(
   CORRADE_ASSERT(standalone_,
                  "BatchReplayRenderer::render(): can use this function only "
                  "with a standalone renderer", );
-  auto& standalone = static_cast<gfx_batch::RendererStandalone&>(*renderer_);
-  standalone.draw();
+  ESP_CHECK(colorImageViews.isEmpty() ||
+                !(devices_[0].renderer_->flags() &
+                  gfx_batch::RendererFlag::DepthOnly),
+            "BatchReplayRenderer::render(): no color output with a "
+            "depth-only renderer");
+  // submit to all devices before reading back any, so they render in
+  // parallel
+  for (std::size_t device = 0; device != devices_.size(); ++device) {
+    makeDeviceCurrent(device);
+    ESP_PROFILE_GPU_SCOPE(devices_[device].gpuTimer_,
+                          "gfx_batch::Renderer::draw");
+    static_cast<gfx_batch::RendererStandalone&>(*devices_[device].renderer_)
+        .draw();
+  }
 
   // todo: integrate debugLineRender_->flushLines
   CORRADE_INTERNAL_ASSERT(!debugLineRender_);
 
   for (int envIndex = 0; envIndex != envs_.size(); ++envIndex) {
-    const auto rectangle = Mn::Range2Di::fromSize(
-        renderer_->tileSize() *
-            Mn::Vector2i{envIndex % renderer_->tileCount().x(),
-                         envIndex / renderer_->tileCount().x()},
-        renderer_->tileSize());
+    const DeviceRecord& device = devices_[deviceFor(envIndex)];
+    auto& standalone =
+        static_cast<gfx_batch::RendererStandalone&>(*device.renderer_);
+    const unsigned tileIndex = envIndex - device.environmentOffset_;
+    const Mn::Range2Di rectangle = standalone.sceneRectangle(tileIndex);
 
     if (colorImageViews.size() > 0) {
       standalone.colorImageInto(rectangle, colorImageViews[envIndex]);
@@ -142,37 +256,97 @@ void BatchReplayRenderer::doRender(
       standalone.depthImageInto(rectangle, depthBufferView);
 
       // TODO: Add GPU depth unprojection support.
-      gfx_batch::unprojectDepth(renderer_->cameraDepthUnprojection(envIndex),
+      gfx_batch::unprojectDepth(standalone.cameraDepthUnprojection(tileIndex),
                                 depthBufferView.pixels<Mn::Float>());
     }
   }
 }
 
+void BatchReplayRenderer::doRenderAsync() {
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::renderAsync(): can use this function "
+                 "only with a standalone renderer", );
+  // the frame gets copied on the GPU side, not touching CPU memory until
+  // doWaitFrame(), so the players are free to update the scenes meanwhile
+  for (std::size_t device = 0; device != devices_.size(); ++device) {
+    makeDeviceCurrent(device);
+    auto& standalone = static_cast<gfx_batch::RendererStandalone&>(
+        *devices_[device].renderer_);
+    {
+      ESP_PROFILE_GPU_SCOPE(devices_[device].gpuTimer_,
+                            "gfx_batch::Renderer::draw");
+      standalone.draw();
+    }
+    standalone.readFrameAsync(nextFrameSlot_);
+  }
+  nextFrameSlot_ =
+      (nextFrameSlot_ + 1) % gfx_batch::RendererStandalone::FrameSlotCount;
+}
+
+void BatchReplayRenderer::doWaitFrame(
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> colorImageViews,
+    Cr::Containers::ArrayView<const Mn::MutableImageView2D> depthImageViews) {
+  ESP_CHECK(colorImageViews.isEmpty() ||
+                !(devices_[0].renderer_->flags() &
+                  gfx_batch::RendererFlag::DepthOnly),
+            "BatchReplayRenderer::waitFrame(): no color output with a "
+            "depth-only renderer");
+  for (int envIndex = 0; envIndex != envs_.size(); ++envIndex) {
+    const DeviceRecord& device = devices_[deviceFor(envIndex)];
+    auto& standalone =
+        static_cast<gfx_batch::RendererStandalone&>(*device.renderer_);
+    const unsigned tileIndex = envIndex - device.environmentOffset_;
+    const Mn::Range2Di rectangle = standalone.sceneRectangle(tileIndex);
+
+    if (colorImageViews.size() > 0) {
+      standalone.colorFrameInto(oldestFrameSlot_, rectangle,
+                                colorImageViews[envIndex]);
+    }
+    if (depthImageViews.size() > 0) {
+      Mn::MutableImageView2D depthBufferView{
+          standalone.depthFramebufferFormat(), depthImageViews[envIndex].size(),
+          depthImageViews[envIndex].data()};
+      standalone.depthFrameInto(oldestFrameSlot_, rectangle, depthBufferView);
+
+      // the camera may have moved since renderAsync(), but the projection
+      // is the same for all frames
+      gfx_batch::unprojectDepth(standalone.cameraDepthUnprojection(tileIndex),
+                                depthBufferView.pixels<Mn::Float>());
+    }
+  }
+  oldestFrameSlot_ =
+      (oldestFrameSlot_ + 1) % gfx_batch::RendererStandalone::FrameSlotCount;
+}
+
 void BatchReplayRenderer::doRender(
     Magnum::GL::AbstractFramebuffer& framebuffer) {
   CORRADE_ASSERT(!standalone_,
                  "BatchReplayRenderer::render(): can't use this function with "
                  "a standalone renderer", );
 
-  renderer_->draw(framebuffer);
+  // non-standalone renderers always have exactly one device
+  gfx_batch::Renderer& renderer = *devices_[0].renderer_;
+  ESP_PROFILE_GPU_SCOPE(devices_[0].gpuTimer_, "gfx_batch::Renderer::draw");
+  renderer.draw(framebuffer);
 
   if (debugLineRender_) {
     framebuffer.bind();
     constexpr unsigned envIndex = 0;
-    auto projCamMatrix = renderer_->camera(envIndex);
-    debugLineRender_->flushLines(projCamMatrix, renderer_->tileSize());
+    auto projCamMatrix = renderer.camera(envIndex);
+    debugLineRender_->flushLines(projCamMatrix,
+                                 renderer.sceneRectangle(envIndex).size());
   }
 }
 
 esp::geo::Ray BatchReplayRenderer::doUnproject(
-    CORRADE_UNUSED unsigned envIndex,
+    unsigned envIndex,
     const Mn::Vector2i& viewportPosition) {
   // temp stub implementation: produce a placeholder ray that varies with
   // viewportPosition
   return esp::geo::Ray(
-      {static_cast<float>(viewportPosition.x()) / renderer_->tileSize().x(),
+      {static_cast<float>(viewportPosition.x()) / doSensorSize(envIndex).x(),
        0.5f,
-       static_cast<float>(viewportPosition.y()) / renderer_->tileSize().y()},
+       static_cast<float>(viewportPosition.y()) / doSensorSize(envIndex).y()},
       {0.f, -1.f, 0.f});
 }
 
@@ -183,7 +357,15 @@ const void* BatchReplayRenderer::getCudaColorBufferDevicePointer() {
                  "this function only "
                  "with a standalone renderer",
                  nullptr);
-  return static_cast<gfx_batch::RendererStandalone&>(*renderer_)
+  CORRADE_ASSERT(devices_.size() == 1,
+                 "ReplayBatchRenderer::getColorCudaBufferDevicePointer(): can "
+                 "use this function only with a single GPU device",
+                 nullptr);
+  ESP_CHECK(
+      !(devices_[0].renderer_->flags() & gfx_batch::RendererFlag::DepthOnly),
+      "ReplayBatchRenderer::getColorCudaBufferDevicePointer(): no color "
+      "output with a depth-only renderer");
+  return static_cast<gfx_batch::RendererStandalone&>(*devices_[0].renderer_)
       .colorCudaBufferDevicePointer();
 #else
   ESP_ERROR() << "Failed to retrieve device pointer because CUDA is not "
@@ -199,7 +381,11 @@ const void* BatchReplayRenderer::getCudaDepthBufferDevicePointer() {
                  "use this function only "
                  "with a standalone renderer",
                  nullptr);
-  return static_cast<gfx_batch::RendererStandalone&>(*renderer_)
+  CORRADE_ASSERT(devices_.size() == 1,
+                 "ReplayBatchRenderer::getDepthCudaBufferDevicePointer(): can "
+                 "use this function only with a single GPU device",
+                 nullptr);
+  return static_cast<gfx_batch::RendererStandalone&>(*devices_[0].renderer_)
       .depthCudaBufferDevicePointer();
 #else
   ESP_ERROR() << "Failed to retrieve device pointer because CUDA is not "
@@ -207,5 +393,128 @@ const void* BatchReplayRenderer::getCudaDepthBufferDevicePointer() {
   return nullptr;
 #endif
 }
+
+CudaImageView BatchReplayRenderer::getCudaColorImageView(unsigned envIndex) {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::getCudaColorImageView(): can use this "
+                 "function only with a standalone renderer",
+                 {});
+  // unlike the whole-buffer pointers, this works with any device count, as
+  // each environment is fully contained in its device's framebuffer
+  const DeviceRecord& device = devices_[deviceFor(envIndex)];
+  ESP_CHECK(
+      !(device.renderer_->flags() & gfx_batch::RendererFlag::DepthOnly),
+      "BatchReplayRenderer::getCudaColorImageView(): no color output with a "
+      "depth-only renderer");
+  auto& standalone =
+      static_cast<gfx_batch::RendererStandalone&>(*device.renderer_);
+  const unsigned tileIndex = envIndex - device.environmentOffset_;
+  CudaImageView out;
+  out.data = standalone.colorCudaBufferDevicePointer(tileIndex);
+  out.format = standalone.colorFramebufferFormat();
+  out.size = standalone.sceneRectangle(tileIndex).size();
+  out.rowStride = standalone.framebufferSize().x() *
+                  Mn::pixelFormatSize(standalone.colorFramebufferFormat());
+  return out;
+#else
+  static_cast<void>(envIndex);
+  ESP_ERROR() << "Failed to retrieve CUDA image view because CUDA is not "
+                 "available in this build.";
+  return {};
+#endif
+}
+
+CudaImageView BatchReplayRenderer::getCudaDepthImageView(unsigned envIndex) {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::getCudaDepthImageView(): can use this "
+                 "function only with a standalone renderer",
+                 {});
+  const DeviceRecord& device = devices_[deviceFor(envIndex)];
+  auto& standalone =
+      static_cast<gfx_batch::RendererStandalone&>(*device.renderer_);
+  const unsigned tileIndex = envIndex - device.environmentOffset_;
+  CudaImageView out;
+  out.data = standalone.depthCudaBufferDevicePointer(tileIndex);
+  out.format = standalone.depthFramebufferFormat();
+  out.size = standalone.sceneRectangle(tileIndex).size();
+  out.rowStride = standalone.framebufferSize().x() *
+                  Mn::pixelFormatSize(standalone.depthFramebufferFormat());
+  return out;
+#else
+  static_cast<void>(envIndex);
+  ESP_ERROR() << "Failed to retrieve CUDA image view because CUDA is not "
+                 "available in this build.";
+  return {};
+#endif
+}
+
+const void* BatchReplayRenderer::getCudaObjectIdBufferDevicePointer() {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::getCudaObjectIdBufferDevicePointer(): "
+                 "can use this function only with a standalone renderer",
+                 nullptr);
+  CORRADE_ASSERT(devices_.size() == 1,
+                 "BatchReplayRenderer::getCudaObjectIdBufferDevicePointer(): "
+                 "can use this function only with a single GPU device",
+                 nullptr);
+  ESP_CHECK(devices_[0].renderer_->flags() & gfx_batch::RendererFlag::ObjectId,
+            "BatchReplayRenderer::getCudaObjectIdBufferDevicePointer(): "
+            "object IDs not enabled in the configuration");
+  return static_cast<gfx_batch::RendererStandalone&>(*devices_[0].renderer_)
+      .objectIdCudaBufferDevicePointer();
+#else
+  ESP_ERROR() << "Failed to retrieve device pointer because CUDA is not "
+                 "available in this build.";
+  return nullptr;
+#endif
+}
+
+CudaImageView BatchReplayRenderer::getCudaObjectIdImageView(
+    unsigned envIndex) {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::getCudaObjectIdImageView(): can use "
+                 "this function only with a standalone renderer",
+                 {});
+  const DeviceRecord& device = devices_[deviceFor(envIndex)];
+  ESP_CHECK(device.renderer_->flags() & gfx_batch::RendererFlag::ObjectId,
+            "BatchReplayRenderer::getCudaObjectIdImageView(): object IDs not "
+            "enabled in the configuration");
+  auto& standalone =
+      static_cast<gfx_batch::RendererStandalone&>(*device.renderer_);
+  const unsigned tileIndex = envIndex - device.environmentOffset_;
+  CudaImageView out;
+  out.data = standalone.objectIdCudaBufferDevicePointer(tileIndex);
+  out.format = standalone.objectIdFramebufferFormat();
+  out.size = standalone.sceneRectangle(tileIndex).size();
+  out.rowStride = standalone.framebufferSize().x() *
+                  Mn::pixelFormatSize(standalone.objectIdFramebufferFormat());
+  return out;
+#else
+  static_cast<void>(envIndex);
+  ESP_ERROR() << "Failed to retrieve CUDA image view because CUDA is not "
+                 "available in this build.";
+  return {};
+#endif
+}
+
+void BatchReplayRenderer::waitForCudaImages(unsigned envIndex, void* stream) {
+#ifdef ESP_BUILD_WITH_CUDA
+  CORRADE_ASSERT(standalone_,
+                 "BatchReplayRenderer::waitForCudaImages(): can use this "
+                 "function only with a standalone renderer", );
+  static_cast<gfx_batch::RendererStandalone&>(
+      *devices_[deviceFor(envIndex)].renderer_)
+      .waitForCudaBuffers(stream);
+#else
+  static_cast<void>(envIndex);
+  static_cast<void>(stream);
+  ESP_ERROR() << "Failed to wait for CUDA images because CUDA is not "
+                 "available in this build.";
+#endif
+}
 }  // namespace sim
 }  // namespace esp
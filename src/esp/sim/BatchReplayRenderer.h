@@ -5,6 +5,8 @@
 #ifndef ESP_SIM_BATCHREPLAYRENDERER_H_
 #define ESP_SIM_BATCHREPLAYRENDERER_H_
 
+#include "esp/gfx/GpuTimer.h"
+#include "esp/gfx/WindowlessContext.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx_batch/RendererStandalone.h"
 #include "esp/sim/AbstractReplayRenderer.h"
@@ -28,6 +30,16 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
 
   const void* getCudaDepthBufferDevicePointer() override;
 
+  CudaImageView getCudaColorImageView(unsigned envIndex) override;
+
+  CudaImageView getCudaDepthImageView(unsigned envIndex) override;
+
+  const void* getCudaObjectIdBufferDevicePointer() override;
+
+  CudaImageView getCudaObjectIdImageView(unsigned envIndex) override;
+
+  void waitForCudaImages(unsigned envIndex, void* stream) override;
+
  private:
   void doClose() override;
 
@@ -41,6 +53,10 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
 
   esp::gfx::replay::Player& doPlayerFor(unsigned envIndex) override;
 
+  void doSetEnvironmentKeyframes(
+      Corrade::Containers::ArrayView<esp::gfx::replay::Keyframe> keyframes)
+      override;
+
   void doSetSensorTransform(unsigned envIndex,
                             const std::string& sensorName,
                             const Mn::Matrix4& transform) override;
@@ -55,14 +71,40 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
 
   void doRender(Magnum::GL::AbstractFramebuffer& framebuffer) override;
 
+  void doRenderAsync() override;
+
+  void doWaitFrame(
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          colorImageViews,
+      Corrade::Containers::ArrayView<const Magnum::MutableImageView2D>
+          depthImageViews) override;
+
   esp::geo::Ray doUnproject(unsigned envIndex,
                             const Mn::Vector2i& viewportPosition) override;
 
-  /* If standalone_ is true, renderer_ contains a RendererStandalone. Has to be
-     before the EnvironmentRecord array because Player calls
+  // Makes the GL context of given device current, if there's more than one
+  void makeDeviceCurrent(std::size_t device);
+
+  // Index of the device rendering given environment, made current
+  std::size_t deviceFor(unsigned envIndex);
+
+  /* If standalone_ is true, the device renderers are RendererStandalone.
+     There's more than one device only if
+     ReplayRendererConfiguration::gpuDeviceIds lists several, each rendering a
+     contiguous range of environments starting at environmentOffset_. Has to
+     be before the EnvironmentRecord array because Player calls
      gfx_batch::Renderer::clear() on destruction. */
   bool standalone_;
-  Corrade::Containers::Pointer<esp::gfx_batch::Renderer> renderer_;
+  struct DeviceRecord {
+    // borrowed from the pool if standalone, outlives the renderer
+    gfx::WindowlessContextPool::Borrowed context_;
+    Corrade::Containers::Pointer<esp::gfx_batch::Renderer> renderer_;
+    unsigned environmentOffset_;
+    // queries are per context, so each device times its draws separately
+    gfx::GpuTimer gpuTimer_;
+  };
+  Corrade::Containers::Array<DeviceRecord> devices_;
+  std::size_t currentDevice_ = 0;
 
   // TODO pimpl all this?
   struct EnvironmentRecord {
@@ -72,6 +114,11 @@ class BatchReplayRenderer : public AbstractReplayRenderer {
   };
   Corrade::Containers::Array<EnvironmentRecord> envs_;
 
+  // RendererStandalone frame slots the next renderAsync() reads into and
+  // the next waitFrame() retrieves from
+  unsigned nextFrameSlot_ = 0;
+  unsigned oldestFrameSlot_ = 0;
+
   Corrade::Containers::String theOnlySensorName_;
   Mn::Matrix4 theOnlySensorProjection_;
 
@@ -0,0 +1,189 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BatchedSimulator.h"
+
+#include <Corrade/Utility/FormatStl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "esp/metadata/MetadataMediator.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sim {
+
+BatchedSimulator::BatchedSimulator(
+    const BatchedSimulatorConfiguration& cfg,
+    metadata::MetadataMediator::ptr _metadataMediator)
+    : config_(cfg), metadataMediator_{std::move(_metadataMediator)} {
+  ESP_CHECK(config_.numEnvironments > 0,
+            "BatchedSimulator::BatchedSimulator() : numEnvironments must be "
+            "greater than 0, got"
+                << config_.numEnvironments);
+  if (!metadataMediator_) {
+    metadataMediator_ = metadata::MetadataMediator::create(config_.simConfig);
+  }
+
+  envs_.reserve(config_.numEnvironments);
+  agents_.reserve(config_.numEnvironments);
+  for (int envIndex = 0; envIndex < config_.numEnvironments; ++envIndex) {
+    SimulatorConfiguration envConfig = config_.simConfig;
+    envConfig.randomSeed = config_.simConfig.randomSeed + envIndex;
+    // Environments other than the first render through the context created
+    // by environment 0; a background thread would steal that context from
+    // them.
+    if (envIndex > 0) {
+      envConfig.leaveContextWithBackgroundRenderer = false;
+    }
+    envs_.emplace_back(
+        Simulator::create_unique(envConfig, metadataMediator_));
+    agents_.emplace_back(envs_.back()->addAgent(config_.agentConfig));
+  }
+  observations_.resize(envs_.size());
+  ESP_DEBUG() << "Created" << envs_.size() << "batched environments.";
+}
+
+BatchedSimulator::~BatchedSimulator() {
+  ESP_DEBUG() << "Deconstructing BatchedSimulator";
+  observations_.clear();
+  agents_.clear();
+  // environment 0 owns the GL context the others render through, so tear the
+  // batch down back to front.
+  while (!envs_.empty()) {
+    envs_.pop_back();
+  }
+}
+
+void BatchedSimulator::checkEnvIndex(int envIndex) const {
+  ESP_CHECK(envIndex >= 0 && std::size_t(envIndex) < envs_.size(),
+            Cr::Utility::formatString(
+                "BatchedSimulator : environment index {} out of range [0, {})",
+                envIndex, envs_.size()));
+}
+
+Simulator& BatchedSimulator::getEnvironment(int envIndex) {
+  checkEnvIndex(envIndex);
+  return *envs_[envIndex];
+}
+
+agent::Agent::ptr BatchedSimulator::getAgent(int envIndex) {
+  checkEnvIndex(envIndex);
+  return agents_[envIndex];
+}
+
+void BatchedSimulator::reset() {
+  for (auto& env : envs_) {
+    env->reset();
+  }
+}
+
+void BatchedSimulator::resetEnvironment(int envIndex) {
+  checkEnvIndex(envIndex);
+  envs_[envIndex]->reset();
+}
+
+void BatchedSimulator::seed(uint32_t newSeed) {
+  for (size_t envIndex = 0; envIndex < envs_.size(); ++envIndex) {
+    envs_[envIndex]->seed(newSeed + envIndex);
+  }
+}
+
+const std::vector<BatchedSimulator::EnvironmentObservations>&
+BatchedSimulator::stepAll(const std::vector<std::string>& actions) {
+  ESP_CHECK(actions.size() == envs_.size(),
+            Cr::Utility::formatString(
+                "BatchedSimulator::stepAll() : expected {} actions, one per "
+                "environment, but got {}",
+                envs_.size(), actions.size()));
+
+  for (size_t envIndex = 0; envIndex < envs_.size(); ++envIndex) {
+    const std::string& action = actions[envIndex];
+    if (!action.empty() && !agents_[envIndex]->act(action)) {
+      ESP_WARNING() << "Environment" << envIndex
+                    << "agent has no action named" << action
+                    << "so no action was taken.";
+    }
+  }
+  stepWorlds(config_.stepDt);
+  return getAllObservations();
+}
+
+const std::vector<BatchedSimulator::EnvironmentObservations>&
+BatchedSimulator::stepAll(const std::vector<int>& actionIds) {
+  ESP_CHECK(actionIds.size() == envs_.size(),
+            Cr::Utility::formatString(
+                "BatchedSimulator::stepAll() : expected {} actions, one per "
+                "environment, but got {}",
+                envs_.size(), actionIds.size()));
+
+  agent::act(agents_, actionIds);
+  stepWorlds(config_.stepDt);
+  return getAllObservations();
+}
+
+int BatchedSimulator::getActionId(const std::string& actionName) {
+  // all agents are created from the same configuration
+  return agents_.front()->getActionId(actionName);
+}
+
+void BatchedSimulator::stepWorlds(const double dt) {
+  int numThreads = config_.numPhysicsThreads;
+  if (numThreads <= 0) {
+    numThreads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+  numThreads =
+      std::max<int>(1, std::min<std::size_t>(numThreads, envs_.size()));
+
+  // environments are handed out one at a time since their cost varies a lot
+  std::atomic<std::size_t> nextEnv{0};
+  auto work = [&]() {
+    for (std::size_t i = nextEnv++; i < envs_.size(); i = nextEnv++) {
+      envs_[i]->stepWorldPhysics(dt);
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int i = 0; i < numThreads - 1; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  // scene graph updates may race with rendering, keep them on this thread
+  for (auto& env : envs_) {
+    env->finishStepWorld();
+  }
+}
+
+const std::vector<BatchedSimulator::EnvironmentObservations>&
+BatchedSimulator::getAllObservations() {
+  for (size_t envIndex = 0; envIndex < envs_.size(); ++envIndex) {
+    Simulator& env = *envs_[envIndex];
+    EnvironmentObservations& envObservations = observations_[envIndex];
+    // sensor buffers are owned and reused by the sensors themselves, so
+    // updating the existing map entries in place does not allocate.
+    for (auto& entry : agents_[envIndex]->getSubtreeSensors()) {
+      sensor::Observation& obs = envObservations[entry.first];
+      if (!entry.second.get().getObservation(env, obs)) {
+        envObservations.erase(entry.first);
+      }
+    }
+  }
+  return observations_;
+}
+
+const BatchedSimulator::EnvironmentObservations&
+BatchedSimulator::getEnvironmentObservations(int envIndex) const {
+  checkEnvIndex(envIndex);
+  return observations_[envIndex];
+}
+
+}  // namespace sim
+}  // namespace esp
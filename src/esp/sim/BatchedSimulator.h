@@ -0,0 +1,199 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_BATCHEDSIMULATOR_H_
+#define ESP_SIM_BATCHEDSIMULATOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "esp/agent/Agent.h"
+#include "esp/core/Esp.h"
+#include "esp/sensor/Sensor.h"
+
+#include "Simulator.h"
+#include "SimulatorConfiguration.h"
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief Class to hold configuration for a @ref BatchedSimulator.
+ */
+struct BatchedSimulatorConfiguration {
+  /**
+   * @brief Configuration used to build every environment. Each environment
+   * gets a copy with @ref SimulatorConfiguration::randomSeed offset by the
+   * environment index so that episodes differ across the batch.
+   */
+  SimulatorConfiguration simConfig;
+
+  //! Number of concurrent environments to own.
+  int numEnvironments = 1;
+
+  /**
+   * @brief Configuration of the single agent created in each environment.
+   * All environments share the same sensor specifications so that
+   * observations can be stacked.
+   */
+  agent::AgentConfiguration agentConfig;
+
+  //! Timestep used to advance each environment's world in @ref
+  //! BatchedSimulator::stepAll.
+  double stepDt = 1.0 / 60.0;
+
+  //! Number of threads stepping the environments' worlds in @ref
+  //! BatchedSimulator::stepWorlds, 0 for one per hardware thread.
+  int numPhysicsThreads = 0;
+
+  ESP_SMART_POINTERS(BatchedSimulatorConfiguration)
+};
+
+/**
+ * @brief Facade owning N @ref Simulator environments that are driven in
+ * lockstep through a single call.
+ *
+ * All environments share the same @ref metadata::MetadataMediator, so dataset
+ * and attributes configs are parsed exactly once. The first environment creates
+ * the OpenGL context; the remaining environments are constructed while that
+ * context is current and render through it instead of creating their own.
+ */
+class BatchedSimulator {
+ public:
+  /**
+   * @brief Observations of a single environment, keyed by sensor uuid.
+   */
+  typedef std::map<std::string, sensor::Observation> EnvironmentObservations;
+
+  explicit BatchedSimulator(
+      const BatchedSimulatorConfiguration& cfg,
+      std::shared_ptr<metadata::MetadataMediator> _metadataMediator = nullptr);
+
+  ~BatchedSimulator();
+
+  BatchedSimulator(const BatchedSimulator&) = delete;
+  BatchedSimulator(BatchedSimulator&&) = delete;
+  BatchedSimulator& operator=(const BatchedSimulator&) = delete;
+  BatchedSimulator& operator=(BatchedSimulator&&) = delete;
+
+  /**
+   * @brief Number of environments owned by this batch.
+   */
+  int getNumEnvironments() const { return static_cast<int>(envs_.size()); }
+
+  /**
+   * @brief Access a single environment, e.g. to add objects or query its
+   * pathfinder.
+   */
+  Simulator& getEnvironment(int envIndex);
+
+  /**
+   * @brief Access the agent of a single environment.
+   */
+  agent::Agent::ptr getAgent(int envIndex);
+
+  /**
+   * @brief Get this batch's shared @ref metadata::MetadataMediator.
+   */
+  std::shared_ptr<metadata::MetadataMediator> getMetadataMediator() const {
+    return metadataMediator_;
+  }
+
+  /**
+   * @brief Reset all environments. See @ref Simulator::reset.
+   */
+  void reset();
+
+  /**
+   * @brief Reset a single environment. See @ref Simulator::reset.
+   */
+  void resetEnvironment(int envIndex);
+
+  /**
+   * @brief Seed every environment, offsetting @p newSeed by the environment
+   * index.
+   */
+  void seed(uint32_t newSeed);
+
+  /**
+   * @brief Apply one action per environment, step each world by @ref
+   * BatchedSimulatorConfiguration::stepDt and collect the resulting
+   * observations.
+   *
+   * @param actions One action name per environment. An empty name skips the
+   * action for that environment but still steps its world.
+   * @return One @ref EnvironmentObservations per environment, in environment
+   * order.
+   */
+  const std::vector<EnvironmentObservations>& stepAll(
+      const std::vector<std::string>& actions);
+
+  /**
+   * @brief Like @ref stepAll(const std::vector<std::string>&), but with
+   * actions given by their ID, see @ref getActionId()
+   *
+   * A negative ID skips the action for that environment.
+   */
+  const std::vector<EnvironmentObservations>& stepAll(
+      const std::vector<int>& actionIds);
+
+  /**
+   * @brief ID of an action for @ref stepAll(const std::vector<int>&), shared
+   * by the agents of all environments
+   *
+   * Returns @ref ID_UNDEFINED if the agents have no such action.
+   */
+  int getActionId(const std::string& actionName);
+
+  /**
+   * @brief Step the worlds of all environments by @p dt.
+   *
+   * The physics of different environments is stepped in parallel on
+   * @ref BatchedSimulatorConfiguration::numPhysicsThreads threads, each
+   * taking the next unstepped environment when done with one, so a few slow
+   * environments don't hold up the rest. The scene graphs are then updated
+   * on the calling thread. Equivalent to calling @ref Simulator::stepWorld on
+   * each environment.
+   */
+  void stepWorlds(double dt);
+
+  /**
+   * @brief Collect the current observations of all environments without
+   * acting or stepping.
+   */
+  const std::vector<EnvironmentObservations>& getAllObservations();
+
+  /**
+   * @brief Observations of one environment last collected by @ref stepAll()
+   * or @ref getAllObservations()
+   *
+   * The buffers are owned by the sensors and overwritten when observations
+   * are collected again.
+   */
+  const EnvironmentObservations& getEnvironmentObservations(
+      int envIndex) const;
+
+ protected:
+  void checkEnvIndex(int envIndex) const;
+
+  BatchedSimulatorConfiguration config_;
+
+  std::shared_ptr<metadata::MetadataMediator> metadataMediator_ = nullptr;
+
+  //! Environment 0 owns the GL context, so it must be destroyed last.
+  std::vector<Simulator::uptr> envs_;
+
+  std::vector<agent::Agent::ptr> agents_;
+
+  //! Reused across calls so observation maps are not reallocated every step.
+  std::vector<EnvironmentObservations> observations_;
+
+  ESP_SMART_POINTERS(BatchedSimulator)
+};
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_BATCHEDSIMULATOR_H_
@@ -12,6 +12,8 @@
 #include <Magnum/GL/Context.h>
 #include <Magnum/ImageView.h>
 
+#include <algorithm>
+
 namespace esp {
 namespace sim {
 
@@ -78,15 +80,13 @@ ClassicReplayRenderer::ClassicReplayRenderer(
       self_.resourceManager_->getRigManager().deleteRigInstance(rigId);
     }
 
-    void setRigPose(int rigId,
-                    const std::vector<gfx::replay::Transform>& pose) override {
+    void setRigPose(int rigId, const gfx::replay::RigPose& pose) override {
       auto& rig = self_.resourceManager_->getRigManager().getRigInstance(rigId);
-      const size_t boneCount = rig.bones.size();
-      for (int i = 0; i < boneCount; ++i) {
-        const auto& transform = pose[i];
+      const size_t boneCount = std::min(rig.bones.size(), pose.boneCount());
+      for (size_t i = 0; i < boneCount; ++i) {
         rig.bones[i]
-            ->setTranslation(transform.translation)
-            .setRotation(transform.rotation);
+            ->setTranslation(pose.translations[i])
+            .setRotation(pose.rotations[i]);
       }
     }
 
@@ -127,7 +127,8 @@ ClassicReplayRenderer::ClassicReplayRenderer(
           "standalone renderer because a context already exists. If the "
           "application is intended to run within another window, make sure "
           "that the standalone config flag is disabled.");
-      context_ = gfx::WindowlessContext::create_unique(config_.gpuDeviceId);
+      context_ =
+          gfx::WindowlessContextPool::instance().acquire(config_.gpuDeviceId);
     } else {
       ESP_CHECK(
           Magnum::GL::Context::hasCurrent(),
@@ -95,7 +95,7 @@ class ClassicReplayRenderer : public AbstractReplayRenderer {
 
   scene::SceneManager::uptr sceneManager_ = nullptr;
 
-  gfx::WindowlessContext::uptr context_ = nullptr;
+  gfx::WindowlessContextPool::Borrowed context_ = nullptr;
   std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
 
   ReplayRendererConfiguration config_;
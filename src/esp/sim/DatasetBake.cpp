@@ -0,0 +1,232 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DatasetBake.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
+#include <Corrade/Utility/Path.h>
+
+#include "esp/core/Esp.h"
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/nav/PathFinder.h"
+#include "esp/sim/Simulator.h"
+#include "esp/sim/SimulatorConfiguration.h"
+
+#ifdef ESP_BUILD_WITH_BULLET
+#include "esp/physics/bullet/BulletStageBvhCache.h"
+#endif
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sim {
+
+namespace {
+
+// bump when the baked artifacts change, so all scenes are baked again
+constexpr int sceneBakeVersion = 1;
+
+/**
+ * @brief What baking a scene instance of a dataset reads and writes
+ */
+struct SceneBake {
+  std::string sceneName;
+  //! Asset files whose content decides whether the bake is up to date
+  std::vector<std::string> inputFilenames;
+  std::string navmeshFilename;
+  //! Stage collision asset the collision BVH cache is saved alongside
+  std::string collisionAssetFilename;
+};
+
+SceneBake makeSceneBake(metadata::MetadataMediator& metadataMediator,
+                        const std::string& sceneName) {
+  SceneBake bake;
+  bake.sceneName = sceneName;
+  const auto sceneAttributes =
+      metadataMediator.getSceneInstanceAttributesByName(sceneName);
+  bake.inputFilenames =
+      getSceneInstanceAssetFilenames(metadataMediator, *sceneAttributes);
+  bake.navmeshFilename = metadataMediator.getNavmeshPathByHandle(
+      sceneAttributes->getNavmeshHandle());
+
+  const auto stageInstance = sceneAttributes->getStageInstance();
+  if (!stageInstance) {
+    return bake;
+  }
+  const auto& stageManager = metadataMediator.getStageAttributesManager();
+  const std::string stageHandle =
+      metadataMediator.getStageAttrFullHandle(stageInstance->getHandle());
+  if (!stageManager->getObjectLibHasHandle(stageHandle)) {
+    return bake;
+  }
+  const auto stageAttributes = stageManager->getObjectByHandle(stageHandle);
+  bake.collisionAssetFilename = stageAttributes->getCollisionAssetHandle();
+  // scenes without a navmesh get one alongside the stage render asset, as
+  // the scene datasets name them
+  if (bake.navmeshFilename.empty()) {
+    bake.navmeshFilename = stageAttributes->getNavmeshAssetHandle();
+  }
+  if (bake.navmeshFilename.empty() &&
+      !stageAttributes->getRenderAssetHandle().empty()) {
+    bake.navmeshFilename =
+        Cr::Utility::Path::splitExtension(
+            stageAttributes->getRenderAssetHandle())
+            .first() +
+        ".navmesh";
+  }
+  return bake;
+}
+
+/**
+ * @brief Hash of the content of the inputs of @p bake, empty if one can't be
+ * read
+ */
+std::string hashSceneBakeInputs(const SceneBake& bake) {
+  std::string key = Cr::Utility::formatString(
+      "version={}-scene={}", sceneBakeVersion, bake.sceneName);
+  for (const std::string& filename : bake.inputFilenames) {
+    const Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+        Cr::Utility::Path::read(filename);
+    if (!data) {
+      return {};
+    }
+    key += Cr::Utility::formatString(
+        "-{}={}", filename,
+        Cr::Utility::MurmurHash2{}(data->data(), data->size()).hexString());
+  }
+  return Cr::Utility::MurmurHash2{}(key).hexString();
+}
+
+std::string getSceneBakeStampFilename(const SceneBake& bake) {
+  return bake.navmeshFilename + ".stamp";
+}
+
+/**
+ * @brief Whether the artifacts of @p bake exist and were baked from inputs
+ * of @p hash
+ */
+bool isSceneBakeUpToDate(const SceneBake& bake, const std::string& hash) {
+  if (!Cr::Utility::Path::exists(bake.navmeshFilename)) {
+    return false;
+  }
+#ifdef ESP_BUILD_WITH_BULLET
+  // only file assets get a cache
+  if (Cr::Utility::Path::exists(bake.collisionAssetFilename) &&
+      !Cr::Utility::Path::exists(physics::getStageBvhCacheFilename(
+          bake.collisionAssetFilename))) {
+    return false;
+  }
+#endif
+  const Cr::Containers::Optional<Cr::Containers::String> stamp =
+      Cr::Utility::Path::readString(getSceneBakeStampFilename(bake));
+  return stamp && std::string{*stamp} == hash;
+}
+
+}  // namespace
+
+bool bakeSceneInstance(const std::string& datasetFile,
+                       const std::string& sceneName) {
+  SimulatorConfiguration cfg;
+  cfg.sceneDatasetConfigFile = datasetFile;
+  cfg.activeSceneName = sceneName;
+  cfg.useDatasetConfigSnapshot = true;
+  cfg.createRenderer = false;
+  cfg.requiresTextures = false;
+  cfg.loadSemanticMesh = false;
+#ifdef ESP_BUILD_WITH_BULLET
+  // loading the stage with physics saves its collision BVH cache
+  cfg.enablePhysics = true;
+#endif
+  Simulator sim{cfg};
+
+  const SceneBake bake = makeSceneBake(*sim.getMetadataMediator(), sceneName);
+  if (bake.navmeshFilename.empty()) {
+    ESP_ERROR() << "No navmesh filename for scene" << sceneName;
+    return false;
+  }
+  nav::NavMeshSettings settings;
+  settings.setDefaults();
+  nav::PathFinder pf;
+  if (!sim.recomputeNavMesh(pf, settings)) {
+    ESP_ERROR() << "Failed to build navmesh for scene" << sceneName;
+    return false;
+  }
+  if (!pf.saveNavMesh(bake.navmeshFilename)) {
+    ESP_ERROR() << "Failed to save navmesh" << bake.navmeshFilename;
+    return false;
+  }
+  return true;
+}
+
+DatasetBakeStats bakeDataset(const std::string& datasetFile,
+                             unsigned numWorkers,
+                             const SceneBakeFunction& bakeScene) {
+  SimulatorConfiguration cfg;
+  cfg.sceneDatasetConfigFile = datasetFile;
+  cfg.useDatasetConfigSnapshot = true;
+  cfg.createRenderer = false;
+  auto metadataMediator = metadata::MetadataMediator::create(cfg);
+
+  std::vector<SceneBake> bakes;
+  for (const std::string& sceneName :
+       metadataMediator->getAllSceneInstanceHandles()) {
+    bakes.push_back(makeSceneBake(*metadataMediator, sceneName));
+  }
+  DatasetBakeStats stats;
+  if (bakes.empty()) {
+    ESP_ERROR() << "No scene instances in" << datasetFile;
+    return stats;
+  }
+
+  std::atomic<std::size_t> nextBake{0};
+  std::atomic<std::size_t> bakedCount{0};
+  std::atomic<std::size_t> upToDateCount{0};
+  std::mutex failedMutex;
+  const auto bakeScenes = [&]() {
+    for (std::size_t i; (i = nextBake++) < bakes.size();) {
+      const SceneBake& bake = bakes[i];
+      const std::string hash = hashSceneBakeInputs(bake);
+      if (!hash.empty() && isSceneBakeUpToDate(bake, hash)) {
+        ++upToDateCount;
+        continue;
+      }
+      if (!bakeScene(bake.sceneName)) {
+        std::lock_guard<std::mutex> lock{failedMutex};
+        stats.failedScenes.push_back(bake.sceneName);
+        continue;
+      }
+      ++bakedCount;
+      if (!hash.empty()) {
+        Cr::Utility::Path::write(
+            getSceneBakeStampFilename(bake),
+            Cr::Containers::ArrayView<const char>{hash.data(), hash.size()});
+      }
+    }
+  };
+  numWorkers =
+      unsigned(std::min<std::size_t>(std::max(numWorkers, 1u), bakes.size()));
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < numWorkers; ++i) {
+    workers.emplace_back(bakeScenes);
+  }
+  bakeScenes();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  stats.bakedCount = bakedCount;
+  stats.upToDateCount = upToDateCount;
+  return stats;
+}
+
+}  // namespace sim
+}  // namespace esp
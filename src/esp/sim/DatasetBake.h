@@ -0,0 +1,61 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SIM_DATASETBAKE_H_
+#define ESP_SIM_DATASETBAKE_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace esp {
+namespace sim {
+
+/**
+ * @brief What a run of @ref bakeDataset() did
+ */
+struct DatasetBakeStats {
+  //! Scenes baked by the run
+  std::size_t bakedCount = 0;
+  //! Scenes skipped because they were baked from the same inputs
+  std::size_t upToDateCount = 0;
+  //! Scenes whose bake failed
+  std::vector<std::string> failedScenes;
+};
+
+/**
+ * @brief Bakes one scene instance, given its name. Returns whether it
+ * succeeded.
+ */
+typedef std::function<bool(const std::string& sceneName)> SceneBakeFunction;
+
+/**
+ * @brief Bake the navmesh and the stage collision BVH cache of one scene
+ * instance of @p datasetFile
+ *
+ * The navmesh is recomputed rather than loaded, since the one on disk may be
+ * of the previous inputs. Its islands are baked with it, as
+ * @ref nav::PathFinder::saveNavMesh() saves them alongside the tiles.
+ */
+bool bakeSceneInstance(const std::string& datasetFile,
+                       const std::string& sceneName);
+
+/**
+ * @brief Bake all scene instances of @p datasetFile on @p numWorkers threads
+ *
+ * Compiles the dataset metadata into its snapshot, then calls @p bakeScene
+ * for each scene whose inputs changed since the last bake. Up-to-date scenes
+ * are told apart by a hash of their input asset content, saved alongside
+ * their navmesh once @p bakeScene succeeds, so baking an unchanged dataset
+ * again is a no-op.
+ */
+DatasetBakeStats bakeDataset(const std::string& datasetFile,
+                             unsigned numWorkers,
+                             const SceneBakeFunction& bakeScene);
+
+}  // namespace sim
+}  // namespace esp
+
+#endif  // ESP_SIM_DATASETBAKE_H_
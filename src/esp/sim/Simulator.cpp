@@ -4,18 +4,39 @@
 
 #include "Simulator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
+#include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/GL/Context.h>
+#include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 
+#include "esp/core/Blob.h"
 #include "esp/core/Esp.h"
+#include "esp/core/LatencyTracker.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/ScratchArena.h"
+#include "esp/core/ThreadAffinity.h"
 #include "esp/gfx/CubeMapCamera.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/PbrDrawable.h"
@@ -23,6 +44,8 @@
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
+#include "esp/gfx_batch/CompositeConverter.h"
+#include "esp/gfx_batch/ShaderCache.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/metadata/attributes/AttributesBase.h"
 #include "esp/nav/PathFinder.h"
@@ -40,12 +63,162 @@ namespace Cr = Corrade;
 namespace esp {
 namespace sim {
 
+using metadata::attributes::ArticulatedObjectAttributes;
+using metadata::attributes::ObjectAttributes;
 using metadata::attributes::PhysicsManagerAttributes;
 using metadata::attributes::SceneAOInstanceAttributes;
 using metadata::attributes::SceneObjectInstanceAttributes;
 using metadata::attributes::SemanticAttributes;
 using metadata::attributes::StageAttributes;
 
+struct Simulator::ScenePrefetch {
+  ~ScenePrefetch() {
+    cancelled = true;
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  std::string sceneName;
+  std::string navmeshFilename;
+  std::vector<std::string> filenames;
+
+  // written by the thread, only read once it's joined
+  nav::PathFinder::ptr pathfinder;
+  std::unordered_map<std::string, Cr::Containers::Array<char>> files;
+
+  std::atomic<bool> done{false};
+  std::atomic<bool> cancelled{false};
+  std::thread thread;
+};
+
+std::vector<std::string> getSceneInstanceAssetFilenames(
+    metadata::MetadataMediator& metadataMediator,
+    const metadata::attributes::SceneInstanceAttributes& sceneAttributes) {
+  std::vector<std::string> filenames;
+  auto addFilename = [&](const std::string& filename) {
+    if (!filename.empty() &&
+        std::find(filenames.begin(), filenames.end(), filename) ==
+            filenames.end() &&
+        Cr::Utility::Path::exists(filename)) {
+      filenames.push_back(filename);
+    }
+  };
+
+  if (const SceneObjectInstanceAttributes::cptr stageInstance =
+          sceneAttributes.getStageInstance()) {
+    const auto& stageManager = metadataMediator.getStageAttributesManager();
+    const std::string stageHandle =
+        metadataMediator.getStageAttrFullHandle(stageInstance->getHandle());
+    if (stageManager->getObjectLibHasHandle(stageHandle)) {
+      const StageAttributes::ptr stageAttributes =
+          stageManager->getObjectByHandle(stageHandle);
+      addFilename(stageAttributes->getRenderAssetHandle());
+      addFilename(stageAttributes->getCollisionAssetHandle());
+      addFilename(stageAttributes->getSemanticAssetHandle());
+      addFilename(stageAttributes->getSemanticDescriptorFilename());
+    }
+  }
+
+  // the semantic attributes override the stage's semantic assets
+  const std::string semanticHandle = sceneAttributes.getSemanticSceneHandle();
+  const SemanticAttributes::ptr semanticAttributes =
+      semanticHandle.empty()
+          ? nullptr
+          : metadataMediator.getSemanticAttributesManager()
+                ->getFirstMatchingObjectCopyByHandle(semanticHandle);
+  if (semanticAttributes) {
+    addFilename(semanticAttributes->getSemanticAssetHandle());
+    addFilename(semanticAttributes->getSemanticDescriptorFilename());
+  }
+
+  const auto& objectManager = metadataMediator.getObjectAttributesManager();
+  for (const auto& objectInstance : sceneAttributes.getObjectInstances()) {
+    const std::string objectHandle =
+        metadataMediator.getObjAttrFullHandle(objectInstance->getHandle());
+    if (objectHandle.empty() ||
+        !objectManager->getObjectLibHasHandle(objectHandle)) {
+      continue;
+    }
+    const auto objectAttributes =
+        objectManager->getObjectByHandle(objectHandle);
+    addFilename(objectAttributes->getRenderAssetHandle());
+    addFilename(objectAttributes->getCollisionAssetHandle());
+  }
+  return filenames;
+}  // getSceneInstanceAssetFilenames
+
+namespace {
+
+/**
+ * @brief Call @p fn with every index below @p count, spread over as many
+ * threads as there are cores, the calling thread included
+ */
+template <class Fn>
+void forEachIndexInParallel(std::size_t count, const Fn& fn) {
+  std::atomic<std::size_t> nextIndex{0};
+  const auto work = [&]() {
+    for (std::size_t i; (i = nextIndex++) < count;) {
+      fn(i);
+    }
+  };
+  const std::size_t numThreads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), count);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Read the render and collision asset files of @p objectAttributes
+ * that @p resourceManager hasn't loaded yet, in parallel
+ */
+std::unordered_map<std::string, Cr::Containers::Array<char>>
+readObjectAssetFiles(
+    const assets::ResourceManager& resourceManager,
+    const std::vector<ObjectAttributes::ptr>& objectAttributes) {
+  std::vector<std::string> filenames;
+  std::unordered_set<std::string> seen;
+  for (const ObjectAttributes::ptr& attributes : objectAttributes) {
+    if (!attributes) {
+      continue;
+    }
+    for (const std::string& filename :
+         {attributes->getRenderAssetHandle(),
+          attributes->getCollisionAssetHandle()}) {
+      if (!filename.empty() && !resourceManager.isAssetLoaded(filename) &&
+          seen.insert(filename).second) {
+        filenames.push_back(filename);
+      }
+    }
+  }
+
+  std::vector<Cr::Containers::Optional<Cr::Containers::Array<char>>> contents(
+      filenames.size());
+  forEachIndexInParallel(filenames.size(), [&](std::size_t i) {
+    // primitive handles aren't files, and missing files are left for the
+    // importer to report
+    if (Cr::Utility::Path::exists(filenames[i])) {
+      contents[i] = Cr::Utility::Path::read(filenames[i]);
+    }
+  });
+
+  std::unordered_map<std::string, Cr::Containers::Array<char>> files;
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    if (contents[i]) {
+      files.emplace(filenames[i], *std::move(contents[i]));
+    }
+  }
+  return files;
+}  // readObjectAssetFiles
+
+}  // namespace
+
 Simulator::Simulator(const SimulatorConfiguration& cfg,
                      metadata::MetadataMediator::ptr _metadataMediator)
     : metadataMediator_{std::move(_metadataMediator)},
@@ -65,10 +238,14 @@ Simulator::~Simulator() {
 void Simulator::close(const bool destroy) {
   getRenderGLContext();
 
+  scenePrefetch_ = nullptr;
   pathfinder_ = nullptr;
-  navMeshVisPrimID_ = esp::ID_UNDEFINED;
+  occupancyGrid_ = nullptr;
+  occupancyGridSourceStates_.clear();
+  navMeshVisTiles_.clear();
   navMeshVisNode_ = nullptr;
   agents_.clear();
+  agentNavPolygons_.clear();
 
   physicsManager_ = nullptr;
   curSceneInstanceAttributes_ = nullptr;
@@ -85,9 +262,14 @@ void Simulator::close(const bool destroy) {
     debugLineRender_->releaseGLResources();
     debugLineRender_ = nullptr;
   }
+  if (trajectoryRender_) {
+    trajectoryRender_->releaseGLResources();
+    trajectoryRender_ = nullptr;
+  }
 
   // Keeping the renderer and the context only matters when the
-  // background renderer was initialized.
+  // background renderer was initialized. Otherwise the context goes back to
+  // the pool for the next simulator to reuse.
   if (destroy || !renderer_->wasBackgroundRendererInitialized()) {
     renderer_ = nullptr;
     context_ = nullptr;
@@ -99,10 +281,13 @@ void Simulator::close(const bool destroy) {
   config_ = SimulatorConfiguration{};
 
   frustumCulling_ = true;
+  instancedRendering_ = false;
+  meshLod_ = false;
   requiresTextures_ = Cr::Containers::NullOpt;
 }
 
 void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
+  ESP_TRACK_LATENCY("Simulator::reconfigure");
 // Fail early if physics is enabled in config but no bullet support is
 // installed.
 #ifndef ESP_BUILD_WITH_BULLET
@@ -113,6 +298,18 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
             "(e.g recompile Habitat-Sim using the '--bullet' flag or choose a "
             "'withbullet' conda build.)");
 #endif
+  ESP_CHECK(cfg.hbaoResolutionDivisor == 1 || cfg.hbaoResolutionDivisor == 2 ||
+                cfg.hbaoResolutionDivisor == 4,
+            "Simulator::reconfigure(): expected hbaoResolutionDivisor to be 1, "
+            "2 or 4 but got"
+                << cfg.hbaoResolutionDivisor);
+
+  // pin before anything is loaded, so assets are allocated on the NUMA node
+  // of the main thread and the threads it starts inherit its CPUs
+  core::setThreadRoleCpus(core::ThreadRole::Main, cfg.mainThreadCpus);
+  core::setThreadRoleCpus(core::ThreadRole::Render, cfg.renderThreadCpus);
+  core::setThreadRoleCpus(core::ThreadRole::Worker, cfg.workerThreadCpus);
+  core::pinCurrentThread(core::ThreadRole::Main);
 
   // set metadata mediator's cfg  upon creation or reconfigure
   if (!metadataMediator_) {
@@ -173,10 +370,14 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   }
 
   if (config_.createRenderer) {
+    // before anything creates shaders, the renderer included
+    gfx_batch::setShaderCacheDirectory(config_.shaderCacheDir);
+
     /* When creating a viewer based app, there is no need to create a
     WindowlessContext since a (windowed) context already exists. */
     if (!context_ && !Magnum::GL::Context::hasCurrent()) {
-      context_ = gfx::WindowlessContext::create_unique(config_.gpuDeviceId);
+      context_ =
+          gfx::WindowlessContextPool::instance().acquire(config_.gpuDeviceId);
     }
 
     // reinitialize members
@@ -197,6 +398,11 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 
       if (config_.enableHBAO) {
         flags |= gfx::Renderer::Flag::HorizonBasedAmbientOcclusion;
+        if (config_.hbaoResolutionDivisor == 2) {
+          flags |= gfx::Renderer::Flag::HbaoHalfResolution;
+        } else if (config_.hbaoResolutionDivisor == 4) {
+          flags |= gfx::Renderer::Flag::HbaoQuarterResolution;
+        }
       }
 
       renderer_ = gfx::Renderer::create(context_.get(), flags);
@@ -209,6 +415,9 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 
   // (re) create scene instance
   bool success = createSceneInstance(config_.activeSceneName);
+  if (success && config_.precompileShaders) {
+    precompileShaders();
+  }
 
   ESP_DEBUG() << "CreateSceneInstance success =="
               << (success ? "true" : "false")
@@ -229,6 +438,99 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
 
 }  // Simulator::reconfigure
 
+void Simulator::prefetchScene(const std::string& activeSceneName,
+                              std::function<void(bool)> callback) {
+  // only the last requested scene is kept
+  scenePrefetch_ = nullptr;
+
+  const metadata::attributes::SceneInstanceAttributes::cptr sceneAttributes =
+      metadataMediator_->getSceneInstanceAttributesByName(activeSceneName);
+  ESP_CHECK(sceneAttributes,
+            Cr::Utility::formatString(
+                "Simulator::prefetchScene() : Scene instance :{} not found.",
+                activeSceneName));
+
+  // the metadata isn't thread-safe, so everything that needs it is resolved
+  // here and the thread only reads files
+  auto prefetch = std::make_unique<ScenePrefetch>();
+  prefetch->sceneName = activeSceneName;
+  const std::string& navmeshHandle = sceneAttributes->getNavmeshHandle();
+  if (!navmeshHandle.empty()) {
+    prefetch->navmeshFilename =
+        metadataMediator_->getNavmeshPathByHandle(navmeshHandle);
+  }
+  prefetch->filenames =
+      getSceneInstanceAssetFilenames(*metadataMediator_, *sceneAttributes);
+
+  prefetch->thread = std::thread([prefetch = prefetch.get(),
+                                  callback = std::move(callback)]() {
+    core::pinCurrentThread(core::ThreadRole::Worker);
+    bool success = true;
+    if (!prefetch->navmeshFilename.empty() &&
+        Cr::Utility::Path::exists(prefetch->navmeshFilename)) {
+      prefetch->pathfinder = nav::PathFinder::create();
+      success = prefetch->pathfinder->loadNavMesh(prefetch->navmeshFilename);
+    }
+    for (const std::string& filename : prefetch->filenames) {
+      if (prefetch->cancelled) {
+        success = false;
+        break;
+      }
+      Cr::Containers::Optional<Cr::Containers::Array<char>> data =
+          Cr::Utility::Path::read(filename);
+      if (!data) {
+        success = false;
+        continue;
+      }
+      prefetch->files.emplace(filename, *std::move(data));
+    }
+    prefetch->done = true;
+    if (callback) {
+      callback(success);
+    }
+  });
+  scenePrefetch_ = std::move(prefetch);
+}  // Simulator::prefetchScene
+
+bool Simulator::isScenePrefetched(const std::string& activeSceneName) const {
+  return scenePrefetch_ && scenePrefetch_->sceneName == activeSceneName &&
+         scenePrefetch_->done;
+}
+
+void Simulator::precompileShaders() {
+  if (!renderer_ || std::size_t(activeSceneID_) >= sceneID_.size()) {
+    return;
+  }
+  renderer_->acquireGlContext();
+  std::vector<scene::SceneGraph*> sceneGraphs{&getActiveSceneGraph()};
+  if (semanticSceneGraphExists() &&
+      &getActiveSemanticSceneGraph() != sceneGraphs.front()) {
+    sceneGraphs.push_back(&getActiveSemanticSceneGraph());
+  }
+  for (scene::SceneGraph* sceneGraph : sceneGraphs) {
+    for (auto& entry : sceneGraph->getDrawableGroups()) {
+      gfx::DrawableGroup& group = entry.second;
+      for (std::size_t i = 0; i != group.size(); ++i) {
+        // getting the draw state creates the shader variant the drawable
+        // needs for its current flags and light setup
+        if (auto* drawable = dynamic_cast<gfx::Drawable*>(&group[i])) {
+          drawable->getDrawState();
+        }
+      }
+    }
+  }
+}  // Simulator::precompileShaders
+
+std::unique_ptr<Simulator::ScenePrefetch> Simulator::takeScenePrefetch(
+    const std::string& activeSceneName) {
+  if (!scenePrefetch_ || scenePrefetch_->sceneName != activeSceneName) {
+    return nullptr;
+  }
+  std::unique_ptr<ScenePrefetch> prefetch = std::move(scenePrefetch_);
+  prefetch->thread.join();
+  return prefetch;
+}  // Simulator::takeScenePrefetch
+
 bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   getRenderGLContext();
 
@@ -254,6 +556,16 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
 
   const std::string& navmeshFileHandle =
       curSceneInstanceAttributes_->getNavmeshHandle();
+  // use whatever prefetchScene() read for this scene
+  std::unique_ptr<ScenePrefetch> prefetch = takeScenePrefetch(activeSceneName);
+  if (prefetch) {
+    resourceManager_->setPrefetchedFiles(std::move(prefetch->files));
+  }
+
+  // the occupancy grid is of the previous scene
+  occupancyGrid_ = nullptr;
+  occupancyGridSourceStates_.clear();
+
   // create pathfinder and load navmesh if available
   pathfinder_ = nav::PathFinder::create();
   if (navmeshFileHandle.empty()) {
@@ -267,6 +579,11 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
       ESP_DEBUG() << "No navmesh file location provided in scene dataset that "
                      "maps to handle :"
                   << navmeshFileHandle;
+    } else if (prefetch && prefetch->pathfinder &&
+               prefetch->pathfinder->isLoaded() &&
+               prefetch->navmeshFilename == navmeshFileLoc) {
+      ESP_DEBUG() << "Using navmesh prefetched from" << navmeshFileLoc;
+      pathfinder_ = std::move(prefetch->pathfinder);
     } else if (Cr::Utility::Path::exists(navmeshFileLoc)) {
       ESP_DEBUG() << "Loading navmesh from" << navmeshFileLoc;
       bool pfSuccess = pathfinder_->loadNavMesh(navmeshFileLoc);
@@ -341,8 +658,11 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   // - Load semantic scene
   resourceManager_->loadSemanticScene(semanticAttr, activeSceneName);
 
-  // 4. Specify frustumCulling based on value from config
+  // 4. Specify frustumCulling, instancing and level of detail based on value
+  // from config
   frustumCulling_ = config_.frustumCulling;
+  instancedRendering_ = config_.instancedRendering;
+  meshLod_ = config_.meshLodLevels > 0;
 
   // 5. (re)seat & (re)init physics manager using the physics manager
   // attributes specified in current simulator configuration held in
@@ -414,6 +734,10 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   // state of metadataMediator_'s currently active scene dataset.
   resourceManager_->loadAllIBLAssets();
 
+  // assets instanced from here on belong to this scene and are kept when
+  // evicting below
+  resourceManager_->beginSceneAssetUse();
+
   // 8. Load stage specified by Scene Instance Attributes
   bool success = instanceStageForSceneAttributes(curSceneInstanceAttributes_,
                                                  semanticAttr);
@@ -433,6 +757,14 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
     }
   }
 
+  // release what earlier scenes loaded and this one doesn't need, if over
+  // the configured memory budget
+  resourceManager_->evictCachedAssetsOverBudget();
+
+  if (prefetch) {
+    resourceManager_->clearPrefetchedFiles();
+  }
+
   return success;
 }  // Simulator::createSceneInstance
 
@@ -617,9 +949,48 @@ bool Simulator::instanceObjectsForSceneAttributes(
       (curSceneInstanceAttributes_->getTranslationOrigin() ==
        metadata::attributes::SceneInstanceTranslationOrigin::AssetLocal);
 
+  // Resolve the attributes of all instances in parallel first. Finding the
+  // template by substring and copying it doesn't touch the scene graph, GL or
+  // Bullet, so only adding the objects below has to be serial.
+  std::vector<std::string> objAttrFullHandles(objectInstances.size());
+  std::vector<ObjectAttributes::ptr> objAttributes(objectInstances.size());
+  forEachIndexInParallel(objectInstances.size(), [&](std::size_t i) {
+    const auto& objInst = objectInstances[i];
+    if (!objInst) {
+      return;
+    }
+    objAttrFullHandles[i] =
+        metadataMediator_->getObjAttrFullHandle(objInst->getHandle());
+    if (!objAttrFullHandles[i].empty()) {
+      objAttributes[i] = physicsManager_->createObjectInstanceAttributes(
+          objInst, objAttrFullHandles[i]);
+    }
+  });
+
+  // Read the asset files the objects need in parallel as well, unless the
+  // whole scene was prefetched, and serve them to the importer while adding
+  bool servesReadFiles = false;
+  if (!resourceManager_->hasPrefetchedFiles()) {
+    auto files = readObjectAssetFiles(*resourceManager_, objAttributes);
+    servesReadFiles = !files.empty();
+    if (servesReadFiles) {
+      resourceManager_->addPrefetchedFiles(std::move(files));
+    }
+  }
+  // stop serving them on the way out, also when a check below throws, so
+  // they don't stay around for later loads
+  Cr::Containers::ScopeGuard clearReadFiles{
+      resourceManager_.get(), [](assets::ResourceManager* resourceManager) {
+        resourceManager->clearPrefetchedFiles();
+      }};
+  if (!servesReadFiles) {
+    clearReadFiles.release();
+  }
+
   // Iterate through instances, create object and implement initial
   // transformation.
-  for (const auto& objInst : objectInstances) {
+  for (std::size_t i = 0; i < objectInstances.size(); ++i) {
+    const auto& objInst = objectInstances[i];
     // check if attributes is null - should not happen
     ESP_CHECK(
         objInst,
@@ -629,10 +1000,8 @@ bool Simulator::instanceObjectsForSceneAttributes(
             "due to object instance configuration not being found. Aborting",
             config_.activeSceneName));
 
-    const std::string objAttrFullHandle =
-        metadataMediator_->getObjAttrFullHandle(objInst->getHandle());
     // make sure full handle is not empty
-    ESP_CHECK(!objAttrFullHandle.empty(),
+    ESP_CHECK(!objAttrFullHandles[i].empty(),
               Cr::Utility::formatString(
                   "Simulator::instanceObjectsForSceneAttributes() : Attempt to "
                   "load object instance specified in current scene instance "
@@ -641,7 +1010,7 @@ bool Simulator::instanceObjectsForSceneAttributes(
                   config_.activeSceneName, objInst->getHandle()));
     // objID =
     physicsManager_->addObjectInstance(
-        objInst, objAttrFullHandle, defaultCOMCorrection, &getDrawableGroup(),
+        objInst, objAttributes[i], defaultCOMCorrection, &getDrawableGroup(),
         attachmentNode, config_.sceneLightSetupKey);
   }  // for each object attributes
   return true;
@@ -655,9 +1024,30 @@ bool Simulator::instanceArticulatedObjectsForSceneAttributes(
   const std::vector<SceneAOInstanceAttributes::cptr> artObjInstances =
       curSceneInstanceAttributes_->getArticulatedObjectInstances();
 
+  // Resolve the attributes of all instances in parallel first, as for rigid
+  // objects. The URDF files are parsed and their meshes read in parallel by
+  // the URDF importer while adding.
+  std::vector<std::string> artObjAttrHandles(artObjInstances.size());
+  std::vector<ArticulatedObjectAttributes::ptr> artObjAttributes(
+      artObjInstances.size());
+  forEachIndexInParallel(artObjInstances.size(), [&](std::size_t i) {
+    const auto& artObjInst = artObjInstances[i];
+    if (!artObjInst) {
+      return;
+    }
+    artObjAttrHandles[i] = metadataMediator_->getArticulatedObjModelFullHandle(
+        artObjInst->getHandle());
+    if (!artObjAttrHandles[i].empty()) {
+      artObjAttributes[i] =
+          physicsManager_->createArticulatedObjectInstanceAttributes(
+              artObjInst, artObjAttrHandles[i]);
+    }
+  });
+
   // Iterate through instances, create object and implement initial
   // transformation.
-  for (const auto& artObjInst : artObjInstances) {
+  for (std::size_t i = 0; i < artObjInstances.size(); ++i) {
+    const auto& artObjInst = artObjInstances[i];
     // check if instance attributes is null - should not happen
     ESP_CHECK(artObjInst,
               Cr::Utility::formatString(
@@ -667,14 +1057,9 @@ bool Simulator::instanceArticulatedObjectsForSceneAttributes(
                   "AO instance configuration not being found. Aborting",
                   config_.activeSceneName));
 
-    // get model file name
-    const std::string artObjAttrHandle =
-        metadataMediator_->getArticulatedObjModelFullHandle(
-            artObjInst->getHandle());
-
     // make sure full handle is not empty
     ESP_CHECK(
-        !artObjAttrHandle.empty(),
+        !artObjAttrHandles[i].empty(),
         Cr::Utility::formatString(
             "Simulator::instanceArticulatedObjectsForSceneAttributes() : "
             "Attempt to load articulated object instance specified in "
@@ -684,9 +1069,9 @@ bool Simulator::instanceArticulatedObjectsForSceneAttributes(
 
     // create articulated object
     // aoID =
-    physicsManager_->addArticulatedObjectInstance(artObjInst, artObjAttrHandle,
-                                                  &getDrawableGroup(),
-                                                  config_.sceneLightSetupKey);
+    physicsManager_->addArticulatedObjectInstance(
+        artObjInst, artObjAttributes[i], &getDrawableGroup(),
+        config_.sceneLightSetupKey);
   }  // for each articulated object instance
   return true;
 }  // Simulator::instanceArticulatedObjectsForSceneAttributes
@@ -777,9 +1162,12 @@ bool Simulator::saveCurrentSceneInstance(
     ESP_DEBUG() << "Attempting to save current scene layout as "
                    "SceneInstanceAttributes with filename :"
                 << saveFilename;
-    return metadataMediator_->getSceneInstanceAttributesManager()
-        ->saveManagedObjectToFile(buildCurrentStateSceneAttributes(),
-                                  saveFilename, false);
+    const auto& sceneInstanceManager =
+        metadataMediator_->getSceneInstanceAttributesManager();
+    sceneInstanceManager->setSaveFilesInBackground(
+        config_.saveSceneInstancesInBackground);
+    return sceneInstanceManager->saveManagedObjectToFile(
+        buildCurrentStateSceneAttributes(), saveFilename, false);
   }
   return false;
 }  // saveCurrentSceneInstance
@@ -788,13 +1176,21 @@ bool Simulator::saveCurrentSceneInstance(bool overwrite) const {
   if (sceneHasPhysics()) {
     ESP_DEBUG() << "Attempting to save current scene layout as "
                    "SceneInstanceAttributes.";
-    return metadataMediator_->getSceneInstanceAttributesManager()
-        ->saveManagedObjectToFile(buildCurrentStateSceneAttributes(),
-                                  overwrite);
+    const auto& sceneInstanceManager =
+        metadataMediator_->getSceneInstanceAttributesManager();
+    sceneInstanceManager->setSaveFilesInBackground(
+        config_.saveSceneInstancesInBackground);
+    return sceneInstanceManager->saveManagedObjectToFile(
+        buildCurrentStateSceneAttributes(), overwrite);
   }
   return false;
 }  // saveCurrentSceneInstance
 
+bool Simulator::waitForSceneInstanceSaves() const {
+  return metadataMediator_->getSceneInstanceAttributesManager()
+      ->waitForBackgroundSaves();
+}
+
 void Simulator::reconfigureReplayManager(bool enableGfxReplaySave) {
   gfxReplayMgr_ = std::make_shared<gfx::replay::ReplayManager>();
 
@@ -833,14 +1229,30 @@ void Simulator::reconfigureReplayManager(bool enableGfxReplaySave) {
 // === Physics Simulator Functions ===
 
 double Simulator::stepWorld(const double dt) {
+  ESP_TRACK_LATENCY("Simulator::stepWorld");
+  stepWorldPhysics(dt);
+  return finishStepWorld();
+}
+
+void Simulator::stepWorldPhysics(const double dt) {
+  // a new frame starts, on whichever thread the physics is stepped
+  core::ScratchArena::current().reset();
   if (physicsManager_ != nullptr) {
     physicsManager_->deferNodesUpdate();
     physicsManager_->stepPhysics(dt);
+  }
+}
+
+double Simulator::finishStepWorld() {
+  core::ScratchArena::current().reset();
+  if (physicsManager_ != nullptr) {
     if (renderer_) {
       renderer_->waitSceneGraph();
     }
 
     physicsManager_->updateNodes();
+    // everything read this frame uses the cleaned transformations
+    getActiveSceneGraph().updateTransformations();
   }
   return getWorldTime();
 }
@@ -853,6 +1265,59 @@ double Simulator::getWorldTime() {
   return NO_TIME;
 }
 
+namespace {
+
+//! Tags blobs written by Simulator::captureState ("HSST").
+constexpr uint32_t SimulatorStateMagic = 0x54535348;
+
+}  // namespace
+
+std::vector<char> Simulator::captureState() {
+  ESP_CHECK(physicsManager_ != nullptr,
+            "Simulator::captureState() : no scene is loaded.");
+  std::vector<char> state;
+  core::BlobWriter writer{state};
+  writer.write<uint32_t>(SimulatorStateMagic);
+  physicsManager_->captureState(writer);
+
+  writer.write<uint32_t>(agents_.size());
+  auto agentState = agent::AgentState::create();
+  for (const auto& agent : agents_) {
+    agent->getState(agentState);
+    writer.write(Mn::Vector3{agentState->position});
+    writer.write(Mn::Vector4{agentState->rotation});
+  }
+  return state;
+}  // Simulator::captureState
+
+void Simulator::restoreState(const std::vector<char>& state) {
+  ESP_CHECK(physicsManager_ != nullptr,
+            "Simulator::restoreState() : no scene is loaded.");
+  core::BlobReader reader{state};
+  ESP_CHECK(reader.read<uint32_t>() == SimulatorStateMagic,
+            "Simulator::restoreState() : blob was not written by "
+            "Simulator::captureState().");
+  // acquire context if available, since objects may be removed
+  getRenderGLContext();
+  physicsManager_->restoreState(reader);
+
+  const uint32_t numAgents = reader.read<uint32_t>();
+  ESP_CHECK(numAgents == agents_.size(),
+            "Simulator::restoreState() : state holds"
+                << numAgents << "agents but the simulator has"
+                << agents_.size());
+  agent::AgentState agentState;
+  for (const auto& agent : agents_) {
+    agentState.position =
+        Mn::EigenIntegration::cast<vec3f>(reader.read<Mn::Vector3>());
+    agentState.rotation =
+        Mn::EigenIntegration::cast<vec4f>(reader.read<Mn::Vector4>());
+    agent->setState(agentState);
+  }
+  ESP_CHECK(reader.atEnd(),
+            "Simulator::restoreState() : unexpected trailing data in state.");
+}  // Simulator::restoreState
+
 double Simulator::getPhysicsTimeStep() {
   if (physicsManager_ != nullptr) {
     return physicsManager_->getTimestep();
@@ -862,10 +1327,24 @@ double Simulator::getPhysicsTimeStep() {
 
 bool Simulator::recomputeNavMesh(nav::PathFinder& pathfinder,
                                  const nav::NavMeshSettings& navMeshSettings) {
-  assets::MeshData::ptr joinedMesh =
-      getJoinedMesh(navMeshSettings.includeStaticObjects);
+  // without static objects, build directly from the stage mesh cached by the
+  // ResourceManager instead of a copy of it
+  assets::MeshData::ptr joinedMesh;
+  const assets::MeshData* mesh = nullptr;
+  auto stageInitAttrs = physicsManager_->getStageInitAttributes();
+  if (!navMeshSettings.includeStaticObjects && stageInitAttrs != nullptr) {
+    mesh = &resourceManager_->getJoinedCollisionMesh(
+        stageInitAttrs->getRenderAssetHandle());
+    ESP_CHECK(!mesh->vbo.empty(),
+              "::recomputeNavMesh: "
+              "Unable to compute a navmesh upon a non-existent mesh - "
+              "the underlying joined collision mesh has no vertices. Aborting");
+  } else {
+    joinedMesh = getJoinedMesh(navMeshSettings.includeStaticObjects);
+    mesh = joinedMesh.get();
+  }
 
-  if (!pathfinder.build(navMeshSettings, *joinedMesh)) {
+  if (!pathfinder.build(navMeshSettings, *mesh)) {
     ESP_ERROR() << "Failed to build navmesh";
     return false;
   }
@@ -883,6 +1362,7 @@ assets::MeshData::ptr Simulator::getJoinedMesh(
   assets::MeshData::ptr joinedMesh = assets::MeshData::create();
   auto stageInitAttrs = physicsManager_->getStageInitAttributes();
   if (stageInitAttrs != nullptr) {
+    // the stage is joined once and cached, only copied from here on
     joinedMesh = resourceManager_->createJoinedCollisionMesh(
         stageInitAttrs->getRenderAssetHandle());
   }
@@ -948,20 +1428,28 @@ assets::MeshData::ptr Simulator::getJoinedMesh(
       }
     }
 
-    // merge mesh components into the final mesh
+    // merge mesh components into the final mesh. The per-asset joined
+    // meshes are cached by the ResourceManager, so only the transformed
+    // copies are made here.
+    std::size_t numVerts = joinedMesh->vbo.size();
+    std::size_t numIndices = joinedMesh->ibo.size();
+    for (auto& meshComponent : meshComponentStates) {
+      const assets::MeshData& objectMesh =
+          resourceManager_->getJoinedCollisionMesh(meshComponent.first);
+      numVerts += objectMesh.vbo.size() * meshComponent.second.size();
+      numIndices += objectMesh.ibo.size() * meshComponent.second.size();
+    }
+    joinedMesh->vbo.reserve(numVerts);
+    joinedMesh->ibo.reserve(numIndices);
     for (auto& meshComponent : meshComponentStates) {
-      assets::MeshData::uptr joinedObjectMesh =
-          resourceManager_->createJoinedCollisionMesh(meshComponent.first);
+      const assets::MeshData& objectMesh =
+          resourceManager_->getJoinedCollisionMesh(meshComponent.first);
       for (auto& meshTransform : meshComponent.second) {
-        int prevNumIndices = joinedMesh->ibo.size();
-        int prevNumVerts = joinedMesh->vbo.size();
-        joinedMesh->ibo.resize(prevNumIndices + joinedObjectMesh->ibo.size());
-        for (size_t ix = 0; ix < joinedObjectMesh->ibo.size(); ++ix) {
-          joinedMesh->ibo[ix + prevNumIndices] =
-              joinedObjectMesh->ibo[ix] + prevNumVerts;
+        const uint32_t prevNumVerts = joinedMesh->vbo.size();
+        for (const uint32_t index : objectMesh.ibo) {
+          joinedMesh->ibo.push_back(index + prevNumVerts);
         }
-        joinedMesh->vbo.reserve(joinedObjectMesh->vbo.size() + prevNumVerts);
-        for (auto& vert : joinedObjectMesh->vbo) {
+        for (const auto& vert : objectMesh.vbo) {
           joinedMesh->vbo.push_back(meshTransform * vert);
         }
       }
@@ -988,37 +1476,207 @@ assets::MeshData::ptr Simulator::getJoinedSemanticMesh(
   return joinedSemanticMesh;
 }
 
+bool Simulator::exportBatchRendererComposite(
+    const std::string& filename,
+    const bool quantizeVertexAttributes) {
+  ESP_CHECK(physicsManager_,
+            "Simulator::exportBatchRendererComposite(): no scene loaded");
+
+  // the handles are what gfx replay creation entries reference
+  std::vector<std::string> handles;
+  if (auto stageInitAttrs = physicsManager_->getStageInitAttributes()) {
+    handles.push_back(stageInitAttrs->getRenderAssetHandle());
+  }
+  auto rigidObjMgr = getRigidObjectManager();
+  for (auto objectID : physicsManager_->getExistingObjectIDs()) {
+    handles.push_back(rigidObjMgr->getObjectCopyByID(objectID)
+                          ->getInitializationAttributes()
+                          ->getRenderAssetHandle());
+  }
+  for (auto objectID : physicsManager_->getExistingArticulatedObjectIds()) {
+    auto& articulatedObject = physicsManager_->getArticulatedObject(objectID);
+    for (int linkIx = -1; linkIx < articulatedObject.getNumLinks(); ++linkIx) {
+      for (const auto& visualAttachment :
+           articulatedObject.getLink(linkIx).visualAttachments_) {
+        handles.push_back(visualAttachment.second);
+      }
+    }
+  }
+
+  gfx_batch::CompositeConverter converter;
+  converter.setQuantizeVertexAttributes(quantizeVertexAttributes);
+  for (const std::string& handle : handles) {
+    if (converter.hasNodeHierarchy(handle)) {
+      continue;
+    }
+    if (!Cr::Utility::Path::exists(handle)) {
+      ESP_DEBUG() << "Skipping" << handle << "which isn't a file";
+      continue;
+    }
+    if (!converter.addFile(handle)) {
+      ESP_ERROR() << "Can't add" << handle << "to the composite";
+      return false;
+    }
+  }
+  return converter.convertToFile(filename);
+}
+
+namespace {
+
+Cr::Containers::ArrayView<const Mn::Vector3> meshPositions(
+    const assets::MeshData& mesh) {
+  static_assert(sizeof(vec3f) == sizeof(Mn::Vector3),
+                "can't view Eigen vectors as Magnum vectors");
+  return {reinterpret_cast<const Mn::Vector3*>(mesh.vbo.data()),
+          mesh.vbo.size()};
+}
+
+}  // namespace
+
+std::shared_ptr<geo::OccupancyGrid> Simulator::buildOccupancyGrid(
+    const float voxelSize,
+    const std::string& stageCacheFilename) {
+  ESP_CHECK(physicsManager_,
+            "Simulator::buildOccupancyGrid(): no scene loaded");
+  occupancyGrid_ = std::make_shared<geo::OccupancyGrid>(voxelSize);
+  occupancyGridSourceStates_.clear();
+
+  auto stageInitAttrs = physicsManager_->getStageInitAttributes();
+  if (stageInitAttrs != nullptr &&
+      (stageCacheFilename.empty() ||
+       !occupancyGrid_->loadSource(RIGID_STAGE_ID, stageCacheFilename))) {
+    const assets::MeshData& stageMesh =
+        resourceManager_->getJoinedCollisionMesh(
+            stageInitAttrs->getRenderAssetHandle());
+    occupancyGrid_->setSource(RIGID_STAGE_ID, meshPositions(stageMesh),
+                              stageMesh.ibo);
+    if (!stageCacheFilename.empty() &&
+        !occupancyGrid_->saveSource(RIGID_STAGE_ID, stageCacheFilename)) {
+      ESP_WARNING() << "Can't write occupancy grid cache"
+                    << stageCacheFilename;
+    }
+  }
+
+  updateOccupancyGrid();
+  return occupancyGrid_;
+}
+
+void Simulator::updateOccupancyGrid() {
+  ESP_CHECK(occupancyGrid_, "Simulator::updateOccupancyGrid(): call "
+                            "buildOccupancyGrid() first");
+
+  // update nodes so SceneNode transforms are up-to-date
+  if (renderer_) {
+    renderer_->waitSceneGraph();
+  }
+  physicsManager_->updateNodes();
+
+  // current asset handles and transformations of each object and link
+  std::unordered_map<int, std::vector<std::pair<std::string, Mn::Matrix4>>>
+      sourceStates;
+  auto rigidObjMgr = getRigidObjectManager();
+  for (auto objectID : physicsManager_->getExistingObjectIDs()) {
+    const metadata::attributes::ObjectAttributes::cptr initializationTemplate =
+        rigidObjMgr->getObjectCopyByID(objectID)->getInitializationAttributes();
+    std::string meshHandle = initializationTemplate->getCollisionAssetHandle();
+    if (meshHandle.empty()) {
+      meshHandle = initializationTemplate->getRenderAssetHandle();
+    }
+    const Mn::Matrix4 transformation =
+        physicsManager_->getObjectVisualSceneNode(objectID)
+            .absoluteTransformationMatrix() *
+        Mn::Matrix4::scaling(initializationTemplate->getScale());
+    sourceStates[objectID].emplace_back(meshHandle, transformation);
+  }
+  for (auto objectID : physicsManager_->getExistingArticulatedObjectIds()) {
+    auto& articulatedObject = physicsManager_->getArticulatedObject(objectID);
+    // the base is -1 here but a link object ID in the grid
+    std::unordered_map<int, int> linkObjectIds;
+    for (const auto& linkObjectId : articulatedObject.getLinkObjectIds()) {
+      linkObjectIds[linkObjectId.second] = linkObjectId.first;
+    }
+    for (int linkIx = -1; linkIx < articulatedObject.getNumLinks(); ++linkIx) {
+      int sourceId = objectID;
+      if (linkIx != -1) {
+        auto found = linkObjectIds.find(linkIx);
+        if (found == linkObjectIds.end()) {
+          continue;
+        }
+        sourceId = found->second;
+      }
+      for (const auto& visualAttachment :
+           articulatedObject.getLink(linkIx).visualAttachments_) {
+        sourceStates[sourceId].emplace_back(
+            visualAttachment.second,
+            visualAttachment.first->absoluteTransformationMatrix());
+      }
+    }
+  }
+
+  for (const int sourceId : occupancyGrid_->sourceIds()) {
+    if (sourceId != RIGID_STAGE_ID && !sourceStates.count(sourceId)) {
+      occupancyGrid_->removeSource(sourceId);
+      occupancyGridSourceStates_.erase(sourceId);
+    }
+  }
+
+  std::vector<Mn::Vector3> positions;
+  std::vector<uint32_t> indices;
+  for (auto& sourceState : sourceStates) {
+    auto previous = occupancyGridSourceStates_.find(sourceState.first);
+    if (previous != occupancyGridSourceStates_.end() &&
+        previous->second == sourceState.second) {
+      continue;
+    }
+    // parts of a source are joined in world space
+    positions.clear();
+    indices.clear();
+    for (const auto& part : sourceState.second) {
+      const assets::MeshData& mesh =
+          resourceManager_->getJoinedCollisionMesh(part.first);
+      const uint32_t firstVertex = positions.size();
+      for (const Mn::Vector3& position : meshPositions(mesh)) {
+        positions.push_back(part.second.transformPoint(position));
+      }
+      for (const uint32_t index : mesh.ibo) {
+        indices.push_back(firstVertex + index);
+      }
+    }
+    occupancyGrid_->setSource(sourceState.first, positions, indices);
+    occupancyGridSourceStates_[sourceState.first] =
+        std::move(sourceState.second);
+  }
+}
+
 bool Simulator::setNavMeshVisualization(bool visualize) {
   getRenderGLContext();
 
-  // clean-up the NavMesh visualization if necessary
+  // clean-up the NavMesh visualization if necessary. The tile meshes stay
+  // cached, so turning it on again only regenerates tiles that changed.
   if (!visualize && navMeshVisNode_ != nullptr) {
     delete navMeshVisNode_;
     navMeshVisNode_ = nullptr;
-    if (navMeshVisPrimID_ != ID_UNDEFINED)
-      resourceManager_->removePrimitiveMesh(navMeshVisPrimID_);
-    navMeshVisPrimID_ = ID_UNDEFINED;
   }
 
-  // Create new visualization asset and SceneNode
+  // Update the visualization assets and create a new SceneNode
   if (visualize && pathfinder_ != nullptr && navMeshVisNode_ == nullptr &&
       pathfinder_->isLoaded()) {
     auto& sceneGraph = sceneManager_->getSceneGraph(activeSceneID_);
     auto& rootNode = sceneGraph.getRootNode();
     auto& drawables = sceneGraph.getDrawables();
     navMeshVisNode_ = &rootNode.createChild();
-    navMeshVisPrimID_ = resourceManager_->loadNavMeshVisualization(
-        *pathfinder_, navMeshVisNode_, &drawables);
-    if (navMeshVisPrimID_ == ID_UNDEFINED) {
+    if (!resourceManager_->updateNavMeshVisualization(
+            *pathfinder_, navMeshVisTiles_, navMeshVisNode_, &drawables)) {
       ESP_ERROR() << "Failed to load navmesh visualization.";
       delete navMeshVisNode_;
+      navMeshVisNode_ = nullptr;
     }
   }
   return isNavMeshVisualizationActive();
 }
 
 bool Simulator::isNavMeshVisualizationActive() {
-  return (navMeshVisNode_ != nullptr && navMeshVisPrimID_ != ID_UNDEFINED);
+  return navMeshVisNode_ != nullptr;
 }
 
 // Agents
@@ -1086,19 +1744,19 @@ agent::Agent::ptr Simulator::addAgent(
     }
   }
 
+  const std::size_t agentId = agents_.size();
   agents_.push_back(ag);
+  agentNavPolygons_.push_back(0);
   // TODO: just do this once
   if (pathfinder_->isLoaded()) {
-    scene::ObjectControls::MoveFilterFunc moveFilterFunction;
-    if (config_.allowSliding) {
-      moveFilterFunction = [&](const vec3f& start, const vec3f& end) {
-        return pathfinder_->tryStep(start, end);
-      };
-    } else {
-      moveFilterFunction = [&](const vec3f& start, const vec3f& end) {
-        return pathfinder_->tryStepNoSliding(start, end);
-      };
-    }
+    // steps start from the polygon the previous one ended on, shared with
+    // actAgents()
+    scene::ObjectControls::MoveFilterFunc moveFilterFunction =
+        [this, agentId](const vec3f& start, const vec3f& end) {
+          return Mn::EigenIntegration::cast<vec3f>(pathfinder_->tryStep(
+              Mn::Vector3{start}, Mn::Vector3{end}, agentNavPolygons_[agentId],
+              config_.allowSliding));
+        };
     ag->getControls()->setMoveFilterFunction(std::move(moveFilterFunction));
   }
 
@@ -1110,6 +1768,28 @@ agent::Agent::ptr Simulator::addAgent(
   return addAgent(agentConfig, getActiveSceneGraph().getRootNode());
 }
 
+std::vector<bool> Simulator::actAgents(const std::vector<int>& actionIds) {
+  agent::AgentsMoveFilterFunc filterFunc;
+  if (pathfinder_->isLoaded()) {
+    filterFunc = [this](const std::vector<std::size_t>& agentIds,
+                        const std::vector<Mn::Vector3>& starts,
+                        const std::vector<Mn::Vector3>& ends) {
+      std::vector<std::uint64_t> polygons;
+      polygons.reserve(agentIds.size());
+      for (const std::size_t agentId : agentIds) {
+        polygons.push_back(agentNavPolygons_[agentId]);
+      }
+      std::vector<Mn::Vector3> filteredEnds = pathfinder_->trySteps(
+          starts, ends, polygons, config_.allowSliding);
+      for (std::size_t i = 0; i != agentIds.size(); ++i) {
+        agentNavPolygons_[agentIds[i]] = polygons[i];
+      }
+      return filteredEnds;
+    };
+  }
+  return agent::act(agents_, actionIds, filterFunc);
+}
+
 agent::Agent::ptr Simulator::getAgent(const int agentId) {
   CORRADE_INTERNAL_ASSERT(0 <= agentId && agentId < agents_.size());
   return agents_[agentId];
@@ -1211,17 +1891,225 @@ bool Simulator::getAgentObservation(const int agentId,
 int Simulator::getAgentObservations(
     const int agentId,
     std::map<std::string, sensor::Observation>& observations) {
+  std::map<int, std::map<std::string, sensor::Observation>> agentObservations;
+  getAgentsObservations({agentId}, agentObservations);
+  observations = std::move(agentObservations[agentId]);
+  return observations.size();
+}
+
+int Simulator::getAgentObservations(
+    const int agentId,
+    const std::vector<std::string>& sensorIds,
+    std::map<std::string, sensor::Observation>& observations) {
+  std::map<int, std::map<std::string, sensor::Observation>> agentObservations;
+  getAgentsObservations({agentId}, agentObservations, sensorIds);
+  observations = std::move(agentObservations[agentId]);
+  return observations.size();
+}
+
+int Simulator::getAgentsObservations(
+    const std::vector<int>& agentIds,
+    std::map<int, std::map<std::string, sensor::Observation>>& observations,
+    const std::vector<std::string>& sensorIds) {
+  ESP_PROFILE_SCOPE("Simulator::getAgentsObservations");
+  ESP_TRACK_LATENCY("Simulator::getAgentsObservations");
   observations.clear();
-  agent::Agent::ptr ag = getAgent(agentId);
-  if (ag != nullptr) {
+
+  struct PendingRead {
+    sensor::VisualSensor* sensor;
+    sensor::Observation* observation;
+    bool async;
+  };
+  std::vector<PendingRead> reads;
+  int count = 0;
+  for (const int agentId : agentIds) {
+    agent::Agent::ptr ag = getAgent(agentId);
+    if (ag == nullptr) {
+      continue;
+    }
+    std::map<std::string, sensor::Observation>& agentObservations =
+        observations[agentId];
     for (auto& s : ag->getSubtreeSensors()) {
-      sensor::Observation obs;
-      if (s.second.get().getObservation(*this, obs)) {
-        observations[s.first] = obs;
+      sensor::Sensor& sensor = s.second.get();
+      // sensors nobody asked for are neither drawn nor read
+      if (sensorIds.empty()
+              ? !sensor.isEnabled()
+              : std::find(sensorIds.begin(), sensorIds.end(), s.first) ==
+                    sensorIds.end()) {
+        continue;
+      }
+      if (!sensor.isVisualSensor()) {
+        sensor::Observation obs;
+        if (sensor.getObservation(*this, obs)) {
+          agentObservations[s.first] = std::move(obs);
+          ++count;
+        }
+        continue;
       }
+      auto& visualSensor = static_cast<sensor::VisualSensor&>(sensor);
+      if (!visualSensor.hasRenderTarget()) {
+        continue;
+      }
+      visualSensor.drawObservation(*this);
+      reads.push_back({&visualSensor, &agentObservations[s.first], false});
+      ++count;
     }
   }
-  return observations.size();
+
+  // all draws are submitted before anything waits for the GPU
+#ifndef MAGNUM_TARGET_WEBGL
+  for (PendingRead& read : reads) {
+    if (read.sensor->readbackSlotCount() &&
+        !read.sensor->pendingReadObservationCount()) {
+      read.sensor->startReadObservation();
+      read.async = true;
+    }
+  }
+#endif
+  for (PendingRead& read : reads) {
+#ifndef MAGNUM_TARGET_WEBGL
+    if (read.async) {
+      read.sensor->finishReadObservation(*read.observation);
+      continue;
+    }
+#endif
+    read.sensor->readObservation(*read.observation);
+  }
+  return count;
+}  // Simulator::getAgentsObservations
+
+int Simulator::getAgentsEncodedObservations(
+    const std::vector<int>& agentIds,
+    std::map<int, std::map<std::string, sensor::Observation>>& observations,
+    std::map<int, std::map<std::string, sensor::EncodedObservation>>&
+        encoded,
+    const std::vector<std::string>& sensorIds) {
+  encoded.clear();
+  const int count = getAgentsObservations(agentIds, observations, sensorIds);
+  for (auto& agentObservations : observations) {
+    agent::Agent::ptr ag = getAgent(agentObservations.first);
+    for (auto it = agentObservations.second.begin();
+         it != agentObservations.second.end();) {
+      sensor::Sensor& sensor = ag->getSubtreeSensorSuite().get(it->first);
+      auto* visualSensor = sensor.isVisualSensor()
+                               ? static_cast<sensor::VisualSensor*>(&sensor)
+                               : nullptr;
+      if (!visualSensor || visualSensor->specification()->encoding ==
+                               sensor::ObservationEncoding::None) {
+        ++it;
+        continue;
+      }
+      encoded[agentObservations.first][it->first] =
+          visualSensor->encodeObservation(it->second, getObservationEncoder());
+      it = agentObservations.second.erase(it);
+    }
+  }
+  return count;
+}  // Simulator::getAgentsEncodedObservations
+
+namespace {
+
+// Largest side of the render target views of renderViewpoints() are drawn
+// into, keeping the attachments of a batch at a few hundred megabytes
+constexpr Mn::Int MaxViewpointTargetSize = 4096;
+
+}  // namespace
+
+void Simulator::renderViewpoints(
+    const std::vector<Mn::Matrix4>& cameraTransformations,
+    const sensor::CameraSensorSpec& spec,
+    Cr::Containers::ArrayView<char> output) {
+  ESP_PROFILE_SCOPE("Simulator::renderViewpoints");
+  ESP_CHECK(renderer_ && std::size_t(activeSceneID_) < sceneID_.size(),
+            "Simulator::renderViewpoints(): no scene is loaded");
+  ESP_CHECK(spec.sensorSubType == sensor::SensorSubType::Pinhole ||
+                spec.sensorSubType == sensor::SensorSubType::Orthographic,
+            "Simulator::renderViewpoints(): expected a pinhole or "
+            "orthographic camera");
+  const Mn::PixelFormat format = sensor::observationPixelFormat(spec);
+  const std::size_t pixelSize = Mn::pixelFormatSize(format);
+  const Mn::Vector2i imageSize{spec.resolution[1], spec.resolution[0]};
+  const std::size_t imageByteSize =
+      std::size_t(imageSize.product()) * pixelSize;
+  ESP_CHECK(output.size() == cameraTransformations.size() * imageByteSize,
+            "Simulator::renderViewpoints(): expected an output of"
+                << cameraTransformations.size() * imageByteSize
+                << "bytes, got" << output.size());
+  if (cameraTransformations.empty()) {
+    return;
+  }
+  renderer_->acquireGlContext();
+
+  // sensor suites are keyed by the uuid, which mustn't clash with sensors of
+  // agents
+  auto cameraSpec = std::make_shared<sensor::CameraSensorSpec>(spec);
+  cameraSpec->uuid = "Simulator::renderViewpoints";
+  std::unique_ptr<scene::SceneNode> cameraNode{
+      &getActiveSceneGraph().getRootNode().createChild(
+          {scene::SceneNodeTag::Leaf})};
+  auto& camera = cameraNode->addFeature<sensor::CameraSensor>(cameraSpec);
+
+  const Mn::Int maxTargetSize = Mn::Math::min(
+      {MaxViewpointTargetSize, Mn::GL::Renderbuffer::maxSize(),
+       Mn::GL::Texture2D::maxSize().min()});
+  // the tiles are laid out in a grid as square as possible, so a square
+  // number of them fits along both sides
+  const std::size_t gridSide = std::size_t(Mn::Math::max(
+      1, (maxTargetSize / imageSize).min()));
+  const std::size_t batchSize =
+      std::min(cameraTransformations.size(), gridSide * gridSide);
+  std::vector<std::shared_ptr<gfx::RenderTarget>> tiles;
+  const std::shared_ptr<gfx::RenderTarget> target =
+      renderer_->createTiledRenderTarget(camera, int(batchSize), tiles);
+  Cr::Containers::Array<char> targetData{
+      Cr::NoInit, std::size_t(target->framebufferSize().product()) * pixelSize};
+  const Mn::MutableImageView2D targetImage{Mn::PixelStorage{}.setAlignment(1),
+                                           format, target->framebufferSize(),
+                                           targetData};
+  const Cr::Containers::StridedArrayView3D<const char> targetPixels =
+      targetImage.pixels();
+
+  for (std::size_t begin = 0; begin < cameraTransformations.size();
+       begin += batchSize) {
+    const std::size_t count =
+        std::min(batchSize, cameraTransformations.size() - begin);
+    for (std::size_t i = 0; i != count; ++i) {
+      cameraNode->setTransformation(cameraTransformations[begin + i]);
+      camera.bindRenderTarget(tiles[i]);
+      camera.drawObservation(*this);
+    }
+
+    if (spec.sensorType == sensor::SensorType::Semantic) {
+      target->readFrameObjectId(targetImage);
+    } else if (spec.sensorType == sensor::SensorType::Depth) {
+      target->readFrameDepth(targetImage);
+    } else {
+      target->readFrameRgba(targetImage);
+    }
+
+    for (std::size_t i = 0; i != count; ++i) {
+      const Mn::Vector2i offset = tiles[i]->viewport().min();
+      // the framebuffer rows go bottom up
+      Cr::Utility::copy(
+          targetPixels
+              .sliceSize({std::size_t(offset.y()), std::size_t(offset.x()), 0},
+                         {std::size_t(imageSize.y()),
+                          std::size_t(imageSize.x()), pixelSize})
+              .flipped<0>(),
+          Cr::Containers::StridedArrayView3D<char>{
+              output.sliceSize((begin + i) * imageByteSize, imageByteSize),
+              {std::size_t(imageSize.y()), std::size_t(imageSize.x()),
+               pixelSize}});
+    }
+  }
+}  // Simulator::renderViewpoints
+
+sensor::ObservationEncoder& Simulator::getObservationEncoder() {
+  if (!observationEncoder_) {
+    observationEncoder_ = std::make_unique<sensor::ObservationEncoder>(
+        std::min(4u, std::max(1u, std::thread::hardware_concurrency())));
+  }
+  return *observationEncoder_;
 }
 
 bool Simulator::getAgentObservationSpace(const int agentId,
@@ -1257,7 +2145,10 @@ std::vector<std::string> Simulator::getRuntimePerfStatNames() {
           "num active overlaps",
           "num active contacts",
           "num drawables",
-          "num faces"};
+          "num faces",
+          "asset cache hits",
+          "asset cache misses",
+          "asset cache evictions"};
 }
 
 std::vector<float> Simulator::getRuntimePerfStatValues() {
@@ -1277,8 +2168,30 @@ std::vector<float> Simulator::getRuntimePerfStatValues() {
   runtimePerfStatValues_.push_back(drawableCount);
   runtimePerfStatValues_.push_back(drawableNumFaces);
 
+  const auto& assetCacheStats = resourceManager_->getAssetCacheStats();
+  runtimePerfStatValues_.push_back(assetCacheStats.hits);
+  runtimePerfStatValues_.push_back(assetCacheStats.misses);
+  runtimePerfStatValues_.push_back(assetCacheStats.evictions);
+
   return runtimePerfStatValues_;
 }
 
+std::map<std::string, core::MemoryUsage> Simulator::getMemoryUsage() {
+  std::map<std::string, core::MemoryUsage> usage;
+  usage["resources"] = resourceManager_->getMemoryUsage();
+  usage["physics"].cpuBytes =
+      physicsManager_ ? physicsManager_->getMemoryUsage() : 0;
+  usage["navmesh"].cpuBytes = pathfinder_ ? pathfinder_->getMemoryUsage() : 0;
+  core::MemoryUsage& replay = usage["replay"];
+  if (gfxReplayMgr_ && gfxReplayMgr_->getRecorder()) {
+    replay.cpuBytes = gfxReplayMgr_->getRecorder()->getMemoryUsage();
+  }
+  core::MemoryUsage& observations = usage["observations"];
+  for (auto& it : getActiveSceneGraph().getRootNode().getSubtreeSensors()) {
+    observations += it.second.get().getMemoryUsage();
+  }
+  return usage;
+}  // Simulator::getMemoryUsage
+
 }  // namespace sim
 }  // namespace esp
@@ -7,12 +7,21 @@
 
 #include <Corrade/Utility/Assert.h>
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include "esp/agent/Agent.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
 #include "esp/core/Esp.h"
+#include "esp/core/MemoryUsage.h"
 #include "esp/core/Random.h"
+#include "esp/geo/OccupancyGrid.h"
 #include "esp/gfx/DebugLineRender.h"
+#include "esp/gfx/TrajectoryRender.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/gfx/replay/Player.h"
@@ -20,6 +29,7 @@
 #include "esp/physics/PhysicsManager.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
+#include "esp/sensor/ObservationEncoder.h"
 #include "esp/sensor/Sensor.h"
 
 #include "SimulatorConfiguration.h"
@@ -33,6 +43,9 @@ class ActionSpacePathFinder;
 namespace scene {
 class SemanticScene;
 }  // namespace scene
+namespace sensor {
+struct CameraSensorSpec;
+}  // namespace sensor
 namespace gfx {
 class Renderer;
 namespace replay {
@@ -43,6 +56,19 @@ class ReplayManager;
 
 namespace esp {
 namespace sim {
+/**
+ * @brief Ties together the scene, agents, physics, navigation and rendering
+ *
+ * The Python bindings release the GIL during long-running calls such as
+ * @ref reconfigure(), @ref stepWorld(), @ref recomputeNavMesh(), ray casts,
+ * object loading and drawing and reading back observations, so simulators
+ * driven from different Python threads run in parallel. A simulator, and
+ * everything it owns, is not thread-safe itself: each has to be used by one
+ * thread at a time, and simulators rendering on the same GL context must not
+ * draw concurrently. A @ref nav::PathFinder can be queried from several
+ * threads at once as long as it isn't modified, see
+ * @ref nav::PathFinder::createQueryContext().
+ */
 class Simulator {
  public:
   explicit Simulator(
@@ -68,6 +94,46 @@ class Simulator {
 
   void reconfigure(const SimulatorConfiguration& cfg);
 
+  /**
+   * @brief Start reading the files of the scene instance @p activeSceneName
+   * on a background thread, so a later @ref reconfigure to that scene doesn't
+   * wait on the disk.
+   *
+   * The navmesh is loaded into its own @ref nav::PathFinder, and the stage
+   * render, collision and semantic assets, the semantic scene descriptor and
+   * the render and collision assets of the rigid objects are read into
+   * memory. When @ref reconfigure then loads that scene, the navmesh is
+   * swapped in and the assets are imported from memory, after waiting for the
+   * prefetch to finish if it hasn't yet. Importing and the GPU upload still
+   * happen in @ref reconfigure, as they need the GL context. Only the last
+   * prefetched scene is kept; it's kept across reconfigures to other scenes.
+   *
+   * @param activeSceneName The name of the SceneInstanceAttributes to
+   * prefetch, as it would be passed in
+   * @ref SimulatorConfiguration::activeSceneName.
+   * @param callback Called from the background thread once done, with whether
+   * every file was read. Must not wait on this simulator.
+   */
+  void prefetchScene(const std::string& activeSceneName,
+                     std::function<void(bool)> callback = {});
+
+  /**
+   * @brief Whether the files of @p activeSceneName were prefetched with
+   * @ref prefetchScene and reading them has finished.
+   */
+  bool isScenePrefetched(const std::string& activeSceneName) const;
+
+  /**
+   * @brief Create the shaders of all drawables of the active scene and its
+   * semantic scene now instead of on first draw.
+   *
+   * Done after loading a scene if
+   * @ref SimulatorConfiguration::precompileShaders is set. With
+   * @ref SimulatorConfiguration::shaderCacheDir set, shaders already linked
+   * by an earlier run are loaded from the cache instead of compiled.
+   */
+  void precompileShaders();
+
   void reset();
 
   void seed(uint32_t newSeed);
@@ -255,6 +321,16 @@ class Simulator {
   ///////////////////////////
   // End Semantic Scene and Data
 
+  /**
+   * @brief Swap the full-detail @p replacementFilepath into the loaded render
+   * asset @p filepath, such as a stage first loaded from a low-detail
+   * variant. See @ref assets::ResourceManager::replaceRenderAsset.
+   */
+  bool replaceRenderAsset(const std::string& filepath,
+                          const std::string& replacementFilepath) {
+    return resourceManager_->replaceRenderAsset(filepath, replacementFilepath);
+  }
+
   /**
    * @brief Builds a @ref esp::metadata::attributes::SceneInstanceAttributes describing the
    * current scene configuration, and saves it to a JSON file, using @p
@@ -275,6 +351,14 @@ class Simulator {
    */
   bool saveCurrentSceneInstance(bool overwrite = false) const;
 
+  /**
+   * @brief Wait until the files of @ref saveCurrentSceneInstance being written
+   * in the background are complete. See @ref
+   * SimulatorConfiguration::saveSceneInstancesInBackground.
+   * @return whether all of them were written successfully.
+   */
+  bool waitForSceneInstanceSaves() const;
+
   /**
    * @brief Get the IDs of the physics objects instanced in a physical scene.
    * See @ref esp::physics::PhysicsManager::getExistingObjectIDs.
@@ -288,6 +372,27 @@ class Simulator {
     return std::vector<int>();  // empty if no simulator exists
   }
 
+  /**
+   * @brief Keep removed objects for reuse by objects later added from the
+   * same template. See @ref
+   * esp::physics::PhysicsManager::setObjectPoolingEnabled.
+   */
+  void setObjectPoolingEnabled(bool enabled) {
+    if (sceneHasPhysics()) {
+      physicsManager_->setObjectPoolingEnabled(enabled);
+    }
+  }
+
+  /**
+   * @brief Number of removed objects kept for reuse.
+   */
+  int getNumPooledObjects() const {
+    if (sceneHasPhysics()) {
+      return physicsManager_->getNumPooledObjects();
+    }
+    return 0;
+  }
+
   /**
    * @brief Turn on/off rendering for the bounding box of the object's visual
    * component.
@@ -340,6 +445,43 @@ class Simulator {
     return physicsManager_->getContactPoints();
   }
 
+  /**
+   * @brief Query contact point data from the most recent collision detection
+   * cache, keeping only the contacts selected by @p filter.
+   *
+   * Overwrites @p contactPoints, pass the same vector every step to avoid
+   * reallocating it. See @ref physics::PhysicsManager::getContactPoints.
+   */
+  void getPhysicsContactPoints(
+      const esp::physics::ContactPointFilter& filter,
+      std::vector<esp::physics::ContactPointData>& contactPoints) {
+    physicsManager_->getContactPoints(filter, contactPoints);
+  }
+
+  /**
+   * @brief Report contact events of an object during physics steps. See
+   * @ref physics::PhysicsManager::subscribeContactEvents.
+   */
+  void subscribePhysicsContactEvents(int objectId) {
+    physicsManager_->subscribeContactEvents(objectId);
+  }
+
+  /**
+   * @brief Stop reporting contact events of an object.
+   */
+  void unsubscribePhysicsContactEvents(int objectId) {
+    physicsManager_->unsubscribeContactEvents(objectId);
+  }
+
+  /**
+   * @brief Contact events of subscribed objects during the most recent
+   * physics step.
+   */
+  const std::vector<esp::physics::ContactEvent>& getPhysicsContactEvents()
+      const {
+    return physicsManager_->getContactEvents();
+  }
+
   /**
    * @brief Query the number of contact points that were active during the
    * collision detection check.
@@ -428,6 +570,126 @@ class Simulator {
     return esp::physics::RaycastResults();
   }
 
+  /**
+   * @brief Raycast a batch of rays into the collision world of a scene and
+   * write the closest hit of each into preallocated buffers.
+   *
+   * See @ref physics::PhysicsManager::castRays for details. Physics must be
+   * enabled.
+   */
+  void castRays(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      double maxDistance,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals = nullptr) {
+    ESP_CHECK(sceneHasPhysics(),
+              "Simulator::castRays(): physics needs to be enabled");
+    physicsManager_->castRays(origins, directions, maxDistance, distances,
+                              objectIds, normals);
+  }
+
+  /**
+   * @brief Raycast a batch of rays into the collision world of a scene and
+   * write all hits of each into preallocated buffers.
+   *
+   * See @ref physics::PhysicsManager::castRaysAllHits for details. Physics
+   * must be enabled.
+   */
+  void castRaysAllHits(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      double maxDistance,
+      std::size_t maxHitsPerRay,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals,
+      Corrade::Containers::ArrayView<int> hitCounts) {
+    ESP_CHECK(sceneHasPhysics(),
+              "Simulator::castRaysAllHits(): physics needs to be enabled");
+    physicsManager_->castRaysAllHits(origins, directions, maxDistance,
+                                     maxHitsPerRay, distances, objectIds,
+                                     normals, hitCounts);
+  }
+
+  /**
+   * @brief Sweep an upright capsule through the collision world of a scene.
+   *
+   * See @ref physics::PhysicsManager::castCapsule for details. Physics must
+   * be enabled.
+   */
+  esp::physics::RaycastResults castCapsule(const esp::geo::Ray& ray,
+                                           float radius,
+                                           float height,
+                                           double maxDistance = 100.0) {
+    if (sceneHasPhysics()) {
+      return physicsManager_->castCapsule(ray, radius, height, maxDistance);
+    }
+    return esp::physics::RaycastResults();
+  }
+
+  /**
+   * @brief Sweep an upright capsule along a batch of rays and write the
+   * first hit of each into preallocated buffers.
+   *
+   * See @ref physics::PhysicsManager::castCapsules for details. Physics must
+   * be enabled.
+   */
+  void castCapsules(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> origins,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> directions,
+      float radius,
+      float height,
+      double maxDistance,
+      Corrade::Containers::ArrayView<float> distances,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<Magnum::Vector3> normals = nullptr) {
+    ESP_CHECK(sceneHasPhysics(),
+              "Simulator::castCapsules(): physics needs to be enabled");
+    physicsManager_->castCapsules(origins, directions, radius, height,
+                                  maxDistance, distances, objectIds, normals);
+  }
+
+  /**
+   * @brief Find the objects overlapping a batch of axis-aligned boxes and
+   * write them into preallocated buffers.
+   *
+   * See @ref physics::PhysicsManager::queryBoxOverlaps for details. Physics
+   * must be enabled.
+   */
+  void queryBoxOverlaps(
+      Corrade::Containers::ArrayView<const Magnum::Range3D> boxes,
+      std::size_t maxOverlapsPerQuery,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<int> linkIds,
+      Corrade::Containers::ArrayView<int> overlapCounts) {
+    ESP_CHECK(sceneHasPhysics(),
+              "Simulator::queryBoxOverlaps(): physics needs to be enabled");
+    physicsManager_->queryBoxOverlaps(boxes, maxOverlapsPerQuery, objectIds,
+                                      linkIds, overlapCounts);
+  }
+
+  /**
+   * @brief Find the objects overlapping a batch of spheres and write them
+   * into preallocated buffers.
+   *
+   * See @ref physics::PhysicsManager::querySphereOverlaps for details.
+   * Physics must be enabled.
+   */
+  void querySphereOverlaps(
+      Corrade::Containers::ArrayView<const Magnum::Vector3> centers,
+      Corrade::Containers::ArrayView<const float> radii,
+      std::size_t maxOverlapsPerQuery,
+      Corrade::Containers::ArrayView<int> objectIds,
+      Corrade::Containers::ArrayView<int> linkIds,
+      Corrade::Containers::ArrayView<int> overlapCounts) {
+    ESP_CHECK(sceneHasPhysics(),
+              "Simulator::querySphereOverlaps(): physics needs to be enabled");
+    physicsManager_->querySphereOverlaps(centers, radii, maxOverlapsPerQuery,
+                                         objectIds, linkIds, overlapCounts);
+  }
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -441,6 +703,24 @@ class Simulator {
    */
   double stepWorld(double dt = 1.0 / 60.0);
 
+  /**
+   * @brief First half of @ref stepWorld: advance the physical world by @p dt
+   * but defer updating the scene graph nodes of simulated objects.
+   *
+   * Touches only this simulator's own state, so several simulators can be
+   * stepped concurrently on different threads. Has to be followed by
+   * @ref finishStepWorld on the thread that owns the scene graph. Used by
+   * @ref BatchedSimulator::stepWorlds.
+   */
+  void stepWorldPhysics(double dt = 1.0 / 60.0);
+
+  /**
+   * @brief Second half of @ref stepWorld: write the object transformations
+   * computed by @ref stepWorldPhysics to the scene graph.
+   * @return The new world time after stepping.
+   */
+  double finishStepWorld();
+
   /**
    * @brief Get the current time in the simulated world. This is always 0 if no
    * @ref esp::physics::PhysicsManager is initialized. See @ref stepWorld. See
@@ -450,6 +730,26 @@ class Simulator {
    */
   double getWorldTime();
 
+  /**
+   * @brief Capture the dynamic state of the simulation into a compact
+   * in-memory binary blob: world time, rigid and articulated object states and
+   * velocities, articulated joint positions and velocities, rigid constraints
+   * and agent states. See @ref esp::physics::PhysicsManager::captureState.
+   *
+   * The blob is only meant to be restored with @ref restoreState by the same
+   * build, typically to reset an episode without rebuilding the scene.
+   */
+  std::vector<char> captureState();
+
+  /**
+   * @brief Restore a blob captured with @ref captureState, reusing the
+   * existing objects instead of removing and re-adding them. Objects and
+   * constraints added since the capture are removed. The scene and the set of
+   * agents must not have changed. See @ref
+   * esp::physics::PhysicsManager::restoreState.
+   */
+  void restoreState(const std::vector<char>& state);
+
   /**
    * @brief Get the last physics timestep in seconds
    *
@@ -496,9 +796,34 @@ class Simulator {
     return debugLineRender_;
   }
 
+  /**
+   * @brief Get the renderer drawing trajectories into color sensors without
+   * creating an object and render asset for each, unlike
+   * @ref addTrajectoryObject()
+   */
+  std::shared_ptr<esp::gfx::TrajectoryRender> getTrajectoryRender() {
+    // We only create this if/when used (lazy creation)
+    if (!trajectoryRender_) {
+      trajectoryRender_ = std::make_shared<esp::gfx::TrajectoryRender>();
+    }
+    return trajectoryRender_;
+  }
+
+  /**
+   * @brief The trajectory renderer, if @ref getTrajectoryRender() created it
+   * already
+   */
+  esp::gfx::TrajectoryRender* trajectoryRenderIfCreated() const {
+    return trajectoryRender_.get();
+  }
+
   /**
    * @brief Compute the navmesh for the simulator's current active scene and
    * assign it to the referenced @ref nav::PathFinder.
+   *
+   * With @ref nav::NavMeshSettings::tileSize set, the navmesh is built in
+   * parallel tiles and recomputing it into the same pathfinder, e.g. after
+   * moving STATIC objects, only rebuilds the tiles whose geometry changed.
    * @param pathfinder The pathfinder object to which the recomputed navmesh
    * will be assigned.
    * @param navMeshSettings The @ref nav::NavMeshSettings instance to
@@ -525,6 +850,60 @@ class Simulator {
   assets::MeshData::ptr getJoinedSemanticMesh(
       std::vector<std::uint16_t>& objectIds);
 
+  /**
+   * @brief Export render assets of the scene into a batch renderer composite
+   * file
+   * @param filename Output file, ending with `.gltf` or `.glb`
+   * @param quantizeVertexAttributes Store normals, texture coordinates and
+   *    vertex colors in smaller formats, see
+   *    @ref gfx_batch::CompositeConverter::setQuantizeVertexAttributes()
+   * @return Whether the file was written
+   *
+   * Render assets of the stage, all rigid objects and all articulated object
+   * links go through @ref gfx_batch::CompositeConverter, each under its
+   * asset handle. The file can be then given to
+   * @ref AbstractReplayRenderer::preloadFile() of a batch replay renderer,
+   * which then draws the scene with deduplicated meshes and packed textures.
+   * Assets that aren't files, such as primitives, are skipped.
+   */
+  bool exportBatchRendererComposite(const std::string& filename,
+                                    bool quantizeVertexAttributes = false);
+
+  /**
+   * @brief Voxelize the collision geometry of the scene into an occupancy
+   * grid
+   * @param voxelSize           Edge length of a voxel
+   * @param stageCacheFilename  If not empty, the stage voxels are loaded
+   *    from this file if it was written with the same voxel size, and
+   *    voxelized and saved to it otherwise
+   * @return The grid, also available through @ref getOccupancyGrid()
+   *
+   * The stage and every rigid object and articulated object link is a
+   * source of the grid, identified by its object ID, with the stage being
+   * @ref RIGID_STAGE_ID. Rigid objects use their collision asset, articulated
+   * object links their render assets like @ref getJoinedMesh(). Call
+   * @ref updateOccupancyGrid() after objects moved or were added or removed.
+   */
+  std::shared_ptr<geo::OccupancyGrid> buildOccupancyGrid(
+      float voxelSize,
+      const std::string& stageCacheFilename = "");
+
+  /**
+   * @brief Bring the occupancy grid up to date with the objects of the scene
+   *
+   * Only objects and links that were added or moved since the previous
+   * update are voxelized again, removed ones are removed from the grid. Must
+   * be called after @ref buildOccupancyGrid().
+   */
+  void updateOccupancyGrid();
+
+  /**
+   * @brief The occupancy grid built by @ref buildOccupancyGrid(), or null
+   */
+  std::shared_ptr<geo::OccupancyGrid> getOccupancyGrid() const {
+    return occupancyGrid_;
+  }
+
   /**
    * @brief Set visualization of the current NavMesh @ref pathfinder_ on or off.
    *
@@ -601,6 +980,21 @@ class Simulator {
 
   agent::Agent::ptr getAgent(int agentId);
 
+  /**
+   * @brief Perform one action per agent, with the body moves of all agents
+   * constrained to the navmesh in a single batch
+   *
+   * Like calling @ref agent::Agent::act(int) on each agent, but the navmesh
+   * steps of all agents go through one @ref nav::PathFinder::trySteps() call.
+   * Each agent's step starts from the navmesh polygon its previous step
+   * ended on.
+   *
+   * @param actionIds One action per agent, see
+   *    @ref agent::Agent::getActionId(). Agents with a negative ID don't act.
+   * @return Whether the body move of each agent was cut short by the navmesh
+   */
+  std::vector<bool> actAgents(const std::vector<int>& actionIds);
+
   agent::Agent::ptr addAgent(const agent::AgentConfiguration& agentConfig,
                              scene::SceneNode& agentParentNode);
   agent::Agent::ptr addAgent(const agent::AgentConfiguration& agentConfig);
@@ -685,6 +1079,86 @@ class Simulator {
       int agentId,
       std::map<std::string, sensor::Observation>& observations);
 
+  /**
+   * @brief Get the observations of only the sensors @p sensorIds of agent
+   * @p agentId, see @ref getAgentsObservations()
+   */
+  int getAgentObservations(
+      int agentId,
+      const std::vector<std::string>& sensorIds,
+      std::map<std::string, sensor::Observation>& observations);
+
+  /**
+   * @brief Get the observations of the sensors of the agents @p agentIds
+   *
+   * Draws of all visual sensors are submitted first and their readbacks are
+   * started without waiting for the GPU, so the pipeline is drained once
+   * for all sensors rather than once per sensor. Sensors that already have
+   * readbacks pending from @ref sensor::VisualSensor::startReadObservation()
+   * are read synchronously instead, leaving those pending. Observations
+   * point to buffers owned by the sensors, which are reused on subsequent
+   * calls.
+   *
+   * If @p sensorIds is empty, all sensors that are
+   * @ref sensor::Sensor::isEnabled() are drawn and read. Otherwise only the
+   * listed sensors are, including disabled ones, and names an agent doesn't
+   * have a sensor for are skipped. Sensors not requested aren't rendered at
+   * all.
+   * @return Total number of observations retrieved
+   */
+  int getAgentsObservations(
+      const std::vector<int>& agentIds,
+      std::map<int, std::map<std::string, sensor::Observation>>& observations,
+      const std::vector<std::string>& sensorIds = {});
+
+  /**
+   * @brief Like @ref getAgentsObservations(), but compresses observations of
+   * visual sensors with a @ref sensor::VisualSensorSpec::encoding
+   *
+   * Those are put into @p encoded instead of @p observations. They get
+   * compressed on the threads of @ref getObservationEncoder() after this
+   * returns, overlapping with whatever is rendered next.
+   * @return Total number of observations retrieved
+   */
+  int getAgentsEncodedObservations(
+      const std::vector<int>& agentIds,
+      std::map<int, std::map<std::string, sensor::Observation>>& observations,
+      std::map<int, std::map<std::string, sensor::EncodedObservation>>&
+          encoded,
+      const std::vector<std::string>& sensorIds = {});
+
+  /**
+   * @brief Render the active scene from many camera poses at once
+   * @param cameraTransformations  World transformations of the camera, one
+   *    per view. The camera looks along -Z, like sensor nodes do.
+   * @param spec    Color, depth or semantic pinhole or orthographic camera.
+   *    Its position, orientation and uuid are ignored.
+   * @param[out] output  Images of all views one after another, each with the
+   *    top row first and pixels in @ref sensor::observationPixelFormat().
+   *    Expected to have exactly the size of all of them.
+   *
+   * Meant for sampling many viewpoints of one scene, which would otherwise
+   * need an agent state to be set and an observation to be drawn and read
+   * back for each. Here all views are drawn through a single temporary
+   * camera into tiles of one large render target, like with
+   * @ref gfx::Renderer::bindTiledRenderTarget(), which is then read back with
+   * a single transfer. Views that don't fit into the size limits of the
+   * target are rendered in several such batches. Unlike observations of
+   * agent sensors, no HBAO is applied.
+   */
+  void renderViewpoints(
+      const std::vector<Magnum::Matrix4>& cameraTransformations,
+      const sensor::CameraSensorSpec& spec,
+      Corrade::Containers::ArrayView<char> output);
+
+  /**
+   * @brief Encoder compressing the observations of
+   * @ref getAgentsEncodedObservations()
+   *
+   * Created on first use, with up to four threads.
+   */
+  sensor::ObservationEncoder& getObservationEncoder();
+
   bool getAgentObservationSpace(int agentId,
                                 const std::string& sensorId,
                                 sensor::ObservationSpace& space);
@@ -707,6 +1181,33 @@ class Simulator {
    */
   bool isFrustumCullingEnabled() const { return frustumCulling_; }
 
+  /**
+   * @brief Enable or disable instanced rendering of repeated assets
+   * (disabled by default), see @ref gfx::RenderCamera::Flag::Instancing
+   * @param val true = enable, false = disable
+   */
+  void setInstancedRenderingEnabled(bool val) { instancedRendering_ = val; }
+
+  /**
+   * @brief Get status, whether instanced rendering is enabled or not
+   * @return true if enabled, otherwise false
+   */
+  bool isInstancedRenderingEnabled() const { return instancedRendering_; }
+
+  /**
+   * @brief Enable or disable drawing simplified levels of detail of distant
+   * meshes, see @ref gfx::RenderCamera::Flag::LevelOfDetail. Enabled by
+   * default if @ref SimulatorConfiguration::meshLodLevels is nonzero.
+   * @param val true = enable, false = disable
+   */
+  void setMeshLodEnabled(bool val) { meshLod_ = val; }
+
+  /**
+   * @brief Get status, whether level of detail selection is enabled or not
+   * @return true if enabled, otherwise false
+   */
+  bool isMeshLodEnabled() const { return meshLod_; }
+
   /**
    * @brief Get a copy of an existing @ref gfx::LightSetup by its key.
    *
@@ -793,6 +1294,37 @@ class Simulator {
     return physicsManager_->getRigidConstraintSettings(constraintId);
   }
 
+  /**
+   * @brief Update the pivots, frames and maximum impulses of many rigid
+   * constraints in one call. See
+   * @ref physics::PhysicsManager::updateRigidConstraints().
+   *
+   * Note: requires Bullet physics to be enabled.
+   */
+  void updateRigidConstraints(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsA,
+      Corrade::Containers::ArrayView<const Magnum::Vector3> pivotsB,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesA,
+      Corrade::Containers::ArrayView<const Magnum::Matrix3x3> framesB,
+      Corrade::Containers::ArrayView<const float> maxImpulses) {
+    physicsManager_->updateRigidConstraints(constraintIds, pivotsA, pivotsB,
+                                            framesA, framesB, maxImpulses);
+  }
+
+  /**
+   * @brief Get the magnitude of the linear force each of the rigid
+   * constraints applied during the last simulation substep. See
+   * @ref physics::PhysicsManager::getRigidConstraintForces().
+   *
+   * Note: requires Bullet physics to be enabled.
+   */
+  void getRigidConstraintForces(
+      Corrade::Containers::ArrayView<const int> constraintIds,
+      Corrade::Containers::ArrayView<float> forces) {
+    physicsManager_->getRigidConstraintForces(constraintIds, forces);
+  }
+
   //============= END - Object Rigid Constraint API =============
 
   /**
@@ -843,11 +1375,25 @@ class Simulator {
    */
   std::vector<float> getRuntimePerfStatValues();
 
+  /**
+   * @brief Estimated CPU and GPU memory held by each subsystem.
+   *
+   * @return Usage keyed by @cpp "resources" @ce (meshes and textures),
+   * @cpp "physics" @ce, @cpp "navmesh" @ce, @cpp "replay" @ce (recorded
+   * keyframes) and @cpp "observations" @ce (buffers and render targets of the
+   * sensors in the active scene). See @ref core::MemoryUsage for what the
+   * estimates include.
+   */
+  std::map<std::string, core::MemoryUsage> getMemoryUsage();
+
  protected:
   Simulator() = default;
 
   /**
    * @brief if Navmesh visualization is active, reset the visualization.
+   *
+   * Only the meshes of NavMesh tiles that changed since the last update are
+   * regenerated.
    */
   void resetNavMeshVisIfActive() {
     if (isNavMeshVisualizationActive()) {
@@ -868,6 +1414,20 @@ class Simulator {
    */
   bool createSceneInstance(const std::string& activeSceneName);
 
+  /**
+   * @brief Files and navmesh read ahead of time by @ref prefetchScene, defined
+   * in the source file.
+   */
+  struct ScenePrefetch;
+
+  /**
+   * @brief Take the prefetch of @p activeSceneName, waiting for it to finish
+   * if necessary. Returns nullptr if @ref prefetchScene wasn't called for
+   * this scene.
+   */
+  std::unique_ptr<ScenePrefetch> takeScenePrefetch(
+      const std::string& activeSceneName);
+
   /**
    * @brief Instance the stage for the current scene based on
    * curSceneInstanceAttributes_, the currently active scene's @ref
@@ -938,7 +1498,8 @@ class Simulator {
 
   void reconfigureReplayManager(bool enableGfxReplaySave);
 
-  gfx::WindowlessContext::uptr context_ = nullptr;
+  // borrowed from the pool, so closing and recreating the simulator reuses it
+  gfx::WindowlessContextPool::Borrowed context_ = nullptr;
   std::shared_ptr<gfx::Renderer> renderer_ = nullptr;
   // CANNOT make the specification of resourceManager_ above the context_!
   // Because when deconstructing the resourceManager_, it needs
@@ -979,8 +1540,17 @@ class Simulator {
   SimulatorConfiguration config_;
 
   std::vector<agent::Agent::ptr> agents_;
+  //! Navmesh polygon each agent's last step ended on, or 0 if unknown. See
+  //! @ref nav::PathFinder::tryStep().
+  std::vector<std::uint64_t> agentNavPolygons_;
 
   nav::PathFinder::ptr pathfinder_;
+
+  /**
+   * @brief The scene being prefetched by @ref prefetchScene, if any
+   */
+  std::unique_ptr<ScenePrefetch> scenePrefetch_;
+
   // state indicating frustum culling is enabled or not
   //
   // TODO:
@@ -992,8 +1562,17 @@ class Simulator {
   // PinholeCamera requires it when drawing the observation
   bool frustumCulling_ = true;
 
-  //! NavMesh visualization variables
-  int navMeshVisPrimID_ = esp::ID_UNDEFINED;
+  // state indicating instanced rendering is enabled or not, same as
+  // frustumCulling_
+  bool instancedRendering_ = false;
+
+  // state indicating level of detail selection is enabled or not, same as
+  // frustumCulling_
+  bool meshLod_ = false;
+
+  //! NavMesh visualization variables. The tile meshes are kept while the
+  //! visualization is off and updated per tile when it's turned on again.
+  assets::ResourceManager::NavMeshVisualizationTiles navMeshVisTiles_;
   esp::scene::SceneNode* navMeshVisNode_ = nullptr;
 
   /**
@@ -1004,12 +1583,35 @@ class Simulator {
   Corrade::Containers::Optional<bool> requiresTextures_;
 
   std::shared_ptr<esp::gfx::DebugLineRender> debugLineRender_;
+  std::shared_ptr<esp::gfx::TrajectoryRender> trajectoryRender_;
+
+  //! Encoder of @ref getAgentsEncodedObservations(), created on first use
+  std::unique_ptr<sensor::ObservationEncoder> observationEncoder_;
 
   std::vector<float> runtimePerfStatValues_;
 
+  //! Grid of @ref buildOccupancyGrid(), reset on scene change
+  std::shared_ptr<geo::OccupancyGrid> occupancyGrid_;
+  //! Asset handles and transformations each object and link source of
+  //! @ref occupancyGrid_ was last voxelized with
+  std::unordered_map<int,
+                     std::vector<std::pair<std::string, Magnum::Matrix4>>>
+      occupancyGridSourceStates_;
+
   ESP_SMART_POINTERS(Simulator)
 };
 
+/**
+ * @brief Files of the stage and rigid objects of @p sceneAttributes, as far as
+ * they exist on disk
+ *
+ * These are the files @ref Simulator::prefetchScene() reads, and the inputs
+ * whose content decides whether artifacts baked for a scene are up to date.
+ */
+std::vector<std::string> getSceneInstanceAssetFilenames(
+    metadata::MetadataMediator& metadataMediator,
+    const metadata::attributes::SceneInstanceAttributes& sceneAttributes);
+
 }  // namespace sim
 }  // namespace esp
 
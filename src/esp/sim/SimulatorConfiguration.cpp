@@ -14,6 +14,8 @@ bool operator==(const SimulatorConfiguration& a,
          a.createRenderer == b.createRenderer &&
          a.allowSliding == b.allowSliding &&
          a.frustumCulling == b.frustumCulling &&
+         a.instancedRendering == b.instancedRendering &&
+         a.meshLodLevels == b.meshLodLevels &&
          a.enablePhysics == b.enablePhysics &&
          a.enableGfxReplaySave == b.enableGfxReplaySave &&
          a.loadSemanticMesh == b.loadSemanticMesh &&
@@ -27,7 +29,26 @@ bool operator==(const SimulatorConfiguration& a,
          a.physicsConfigFile == b.physicsConfigFile &&
          a.overrideSceneLightDefaults == b.overrideSceneLightDefaults &&
          a.sceneLightSetupKey == b.sceneLightSetupKey &&
-         a.enableHBAO == b.enableHBAO && a.navMeshSettings == b.navMeshSettings;
+         a.enableHBAO == b.enableHBAO &&
+         a.hbaoResolutionDivisor == b.hbaoResolutionDivisor &&
+         a.iblCacheDir == b.iblCacheDir &&
+         a.optimizeMeshes == b.optimizeMeshes &&
+         a.meshCacheDir == b.meshCacheDir &&
+         a.shaderCacheDir == b.shaderCacheDir &&
+         a.precompileShaders == b.precompileShaders &&
+         a.compressTextures == b.compressTextures &&
+         a.assetCacheCpuBudget == b.assetCacheCpuBudget &&
+         a.assetCacheGpuBudget == b.assetCacheGpuBudget &&
+         a.useMinVolumeSemanticOBBs == b.useMinVolumeSemanticOBBs &&
+         a.useDatasetConfigSnapshot == b.useDatasetConfigSnapshot &&
+         a.cacheDirectoryListings == b.cacheDirectoryListings &&
+         a.lazySceneInstanceLoading == b.lazySceneInstanceLoading &&
+         a.saveSceneInstancesInBackground ==
+             b.saveSceneInstancesInBackground &&
+         a.mainThreadCpus == b.mainThreadCpus &&
+         a.renderThreadCpus == b.renderThreadCpus &&
+         a.workerThreadCpus == b.workerThreadCpus &&
+         a.navMeshSettings == b.navMeshSettings;
 }
 
 bool operator!=(const SimulatorConfiguration& a,
@@ -5,7 +5,9 @@
 #ifndef ESP_SIM_SIMULATORCONFIGURATION_H_
 #define ESP_SIM_SIMULATORCONFIGURATION_H_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "esp/core/Esp.h"
 #include "esp/gfx/configure.h"
@@ -37,6 +39,12 @@ struct SimulatorConfiguration {
   bool allowSliding = true;
   //! Enable or disable the frustum culling optimisation
   bool frustumCulling = true;
+  //! Draw copies of the same asset in single instanced draw calls, see
+  //! @ref gfx::RenderCamera::Flag::Instancing
+  bool instancedRendering = false;
+  //! Number of simplified levels of detail to generate for each loaded mesh,
+  //! drawn for distant objects, see @ref gfx::RenderCamera::Flag::LevelOfDetail
+  int meshLodLevels = 0;
   /**
    * @brief This flags specifies whether or not dynamics is supported by the
    * simulation, if a suitable library (i.e. Bullet) has been installed.
@@ -109,6 +117,133 @@ struct SimulatorConfiguration {
    */
   bool enableHBAO = false;
 
+  /**
+   * @brief Resolution divisor HBAO is calculated at, either 1, 2 or 4. The
+   * reduced-resolution result is bilaterally upsampled, trading some detail
+   * for a significantly cheaper effect.
+   */
+  int hbaoResolutionDivisor = 1;
+
+  /**
+   * @brief Directory to cache the IBL maps precomputed from PBR environment
+   * maps in, so later runs can load them instead of recomputing. Empty
+   * disables the cache.
+   */
+  std::string iblCacheDir;
+
+  /**
+   * @brief Optimize loaded meshes for rendering, reordering their indices for
+   * vertex cache locality and packing their normals, tangents and texture
+   * coordinates into smaller vertex formats.
+   */
+  bool optimizeMeshes = false;
+
+  /**
+   * @brief Directory to cache the meshes optimized with @ref optimizeMeshes
+   * in, so later runs can load them instead of importing and optimizing
+   * again. Empty disables the cache.
+   */
+  std::string meshCacheDir;
+
+  /**
+   * @brief Directory to cache the binaries of linked shader programs in, so
+   * later runs, and other processes on the same driver, load them instead of
+   * compiling GLSL again. Empty disables the cache.
+   */
+  std::string shaderCacheDir;
+
+  /**
+   * @brief Create the shaders of all drawables of a scene right after it's
+   * loaded instead of on first draw, moving the compilation latency out of
+   * the first frame, see @ref Simulator::precompileShaders()
+   */
+  bool precompileShaders = false;
+
+  /**
+   * @brief Compress uncompressed 8-bit RGB and RGBA textures to BC1 and BC3
+   * on load, if the GPU supports them, cutting their memory use four to six
+   * times. The compressed textures are cached next to the asset, so later
+   * runs load them instead of compressing again.
+   */
+  bool compressTextures = false;
+
+  /**
+   * @brief Estimated CPU memory, in bytes, that render assets loaded for
+   * earlier scenes may keep taking when the scene is changed. Least recently
+   * used assets the new scene doesn't need are released until the total fits.
+   * Zero keeps everything loaded.
+   */
+  std::size_t assetCacheCpuBudget = 0;
+
+  /**
+   * @brief Estimated GPU memory, in bytes, that render assets loaded for
+   * earlier scenes may keep taking when the scene is changed, see
+   * @ref assetCacheCpuBudget. Zero keeps everything loaded.
+   */
+  std::size_t assetCacheGpuBudget = 0;
+
+  /**
+   * @brief Build tight, approximately minimum volume OBBs instead of AABBs for
+   * semantic objects whose bounding boxes are derived from vertex annotations
+   * on load, e.g. for HM3D. Noticeably slower to load.
+   */
+  bool useMinVolumeSemanticOBBs = false;
+
+  /**
+   * @brief Keep a snapshot of all config files of the scene dataset next to
+   * its `.scene_dataset_config.json`, so later runs read them with a single
+   * read instead of opening each. Files changed since are read from disk
+   * again and the snapshot is updated.
+   */
+  bool useDatasetConfigSnapshot = false;
+
+  /**
+   * @brief Check the existence of dataset config and asset files against
+   * directory listings read once per directory instead of querying the
+   * filesystem for each file, see @ref esp::io::setPathCacheEnabled().
+   * Speeds up loading datasets on network filesystems. Listings are read
+   * again when a scene dataset is loaded, files added to a dataset in between
+   * aren't found. The setting is process-wide.
+   */
+  bool cacheDirectoryListings = false;
+
+  /**
+   * @brief Only index the scene instance configs of the scene dataset when
+   * loading it, and parse each one the first time it's requested. Speeds up
+   * loading datasets with many scene instances of which only a few are used.
+   */
+  bool lazySceneInstanceLoading = false;
+
+  /**
+   * @brief Write the files of @ref Simulator::saveCurrentSceneInstance from a
+   * background thread, so that checkpointing a scene only stalls the
+   * simulation for building its description. Use
+   * @ref Simulator::waitForSceneInstanceSaves to find out whether the writes
+   * succeeded.
+   */
+  bool saveSceneInstancesInBackground = false;
+
+  /**
+   * @brief CPUs to pin the thread creating the simulator to, see
+   * @ref core::ThreadRole::Main. Threads it starts for a single call inherit
+   * them, and buffers it allocates and fills, such as loaded assets, end up on
+   * their NUMA node. Empty leaves the thread where it is.
+   */
+  std::vector<int> mainThreadCpus;
+
+  /**
+   * @brief CPUs to pin the background render thread to. Empty leaves it on
+   * the CPUs it inherited.
+   */
+  std::vector<int> renderThreadCpus;
+
+  /**
+   * @brief CPUs to pin long-lived worker threads to, see
+   * @ref core::ThreadRole::Worker. Empty leaves them on the CPUs they
+   * inherited.
+   */
+  std::vector<int> workerThreadCpus;
+
   ESP_SMART_POINTERS(SimulatorConfiguration)
 };
 
@@ -0,0 +1,15 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+
+// ------------ input -----------------------
+in lowp vec4 interpolatedColor;
+
+//------------- output ----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_COLOR) out lowp vec4 fragmentColor;
+
+//------------- shader ----------------------
+void main() {
+  fragmentColor = interpolatedColor;
+}
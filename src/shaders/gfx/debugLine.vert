@@ -0,0 +1,68 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Expands each line segment, drawn as one instance, to a screen-space quad of
+// constant pixel width. See https://mattdesl.svbtle.com/drawing-lines-is-hard
+
+// ------------ input -----------------------
+// x: 0 at the segment start, 1 at its end; y: -1 or 1 for the two sides
+layout(location = ATTRIBUTE_LOCATION_CORNER) in highp vec2 corner;
+layout(location = ATTRIBUTE_LOCATION_FROM) in highp vec3 from;
+layout(location = ATTRIBUTE_LOCATION_TO) in highp vec3 to;
+layout(location = ATTRIBUTE_LOCATION_FROM_COLOR) in lowp vec4 fromColor;
+layout(location = ATTRIBUTE_LOCATION_TO_COLOR) in lowp vec4 toColor;
+
+// ------------ uniforms --------------------
+uniform highp mat4 TransformationProjectionMatrix;
+uniform highp vec2 ViewportSize;
+uniform highp float LineWidth;
+uniform lowp float Opacity;
+
+// ------------ output ----------------------
+out lowp vec4 interpolatedColor;
+
+// endpoints behind the camera are moved along the segment to just in front of
+// it, otherwise their projection flips to the other side of the screen
+const highp float MinClipW = 1.0e-4;
+
+highp vec4 clipToNear(highp vec4 point, highp vec4 other) {
+  if (point.w >= MinClipW) {
+    return point;
+  }
+  return mix(point, other, (MinClipW - point.w) / (other.w - point.w));
+}
+
+//------------- shader ----------------------
+void main() {
+  highp vec4 clipFrom = TransformationProjectionMatrix * vec4(from, 1.0);
+  highp vec4 clipTo = TransformationProjectionMatrix * vec4(to, 1.0);
+  if (clipFrom.w < MinClipW && clipTo.w < MinClipW) {
+    // entirely behind the camera, put all corners outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    interpolatedColor = vec4(0.0);
+    return;
+  }
+  clipFrom = clipToNear(clipFrom, clipTo);
+  clipTo = clipToNear(clipTo, clipFrom);
+
+  // direction of the segment in pixels
+  highp vec2 direction = (clipTo.xy / clipTo.w - clipFrom.xy / clipFrom.w) *
+                         ViewportSize * 0.5;
+  highp float pixelLength = length(direction);
+  direction =
+      pixelLength > 1.0e-6 ? direction / pixelLength : vec2(1.0, 0.0);
+
+  // offset the corner sideways by half the width, and past the endpoint by
+  // half the width as well, so consecutive segments of a path join up
+  highp vec2 offset = (vec2(-direction.y, direction.x) * corner.y +
+                       direction * (2.0 * corner.x - 1.0)) *
+                      LineWidth * 0.5;
+
+  highp vec4 position = mix(clipFrom, clipTo, corner.x);
+  position.xy += offset * 2.0 / ViewportSize * position.w;
+  gl_Position = position;
+
+  interpolatedColor = mix(fromColor, toColor, corner.x);
+  interpolatedColor.a *= Opacity;
+}
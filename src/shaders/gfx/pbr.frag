@@ -33,7 +33,14 @@ void main() {
   // compute contribution of each light using the microfacet model
   // the following part of the code is inspired by the Phong.frag in Magnum
   // library (https://magnum.graphics/)
+#if defined(CLUSTERED_LIGHTING)
+  // only the lights reaching the cluster this fragment is in
+  highp uvec2 cluster = lightClusterOfFragment();
+  for (highp uint i = 0u; i < cluster.y; ++i) {
+    int iLight = lightIndexFromCluster(cluster.x + i);
+#else
   for (int iLight = 0; iLight < LIGHT_COUNT; ++iLight) {
+#endif  // CLUSTERED_LIGHTING
     // Build a light info for this light
     LightInfo l;
     if (!buildLightInfoFromLightIdx(iLight, pbrInfo, l)) {
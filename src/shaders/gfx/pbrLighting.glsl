@@ -99,6 +99,32 @@ bool buildLightInfoFromLightIdx(int iLight, PBRData pbrInfo, out LightInfo l) {
   return true;
 }  // buildLightInfoFromLightIdx
 
+#if defined(CLUSTERED_LIGHTING)
+// The cluster the current fragment is in. .x is the offset of its lights in
+// uLightIndices, .y their count
+highp uvec2 lightClusterOfFragment() {
+  ivec2 tile = clamp(ivec2(floor(gl_FragCoord.xy / uLightClusterTileSize)),
+                     ivec2(0), uLightClusterCount.xy - 1);
+  float depth = max(dot(uLightClusterDepthRow, vec4(position, 1.0)), EPSILON);
+  int slice =
+      clamp(int(floor(log(depth) * uLightClusterSliceScaleBias.x +
+                      uLightClusterSliceScaleBias.y)),
+            0, uLightClusterCount.z - 1);
+  return texelFetch(uLightClusters,
+                    ivec2(tile.y * uLightClusterCount.x + tile.x, slice), 0)
+      .xy;
+}
+
+// i : the index into uLightIndices
+int lightIndexFromCluster(highp uint i) {
+  return int(texelFetch(uLightIndices,
+                        ivec2(int(i % LIGHT_INDEX_TEXTURE_WIDTH),
+                              int(i / LIGHT_INDEX_TEXTURE_WIDTH)),
+                        0)
+                 .r);
+}
+#endif  // CLUSTERED_LIGHTING
+
 #if defined(ANISOTROPY_LAYER)
 
 // Configure a light-dependent AnisotropyDirectLight object
@@ -147,6 +147,21 @@ uniform vec4 uLightDirections[LIGHT_COUNT];
 // Config driven overall direct lighting intensity
 uniform float uDirectLightIntensity;
 
+#if defined(CLUSTERED_LIGHTING)
+// offset into uLightIndices and count of the lights reaching each cluster,
+// one row of clusters per depth slice. See esp::gfx::LightClusters.
+uniform highp usampler2D uLightClusters;
+uniform highp usampler2D uLightIndices;
+// size of a cluster in pixels
+uniform vec2 uLightClusterTileSize;
+// number of clusters along the width, height and depth of the view
+uniform ivec3 uLightClusterCount;
+// dot product with a world position gives its depth along the view direction
+uniform vec4 uLightClusterDepthRow;
+// log(depth) * .x + .y is the depth slice
+uniform vec2 uLightClusterSliceScaleBias;
+#endif  // CLUSTERED_LIGHTING
+
 #endif  // DIRECT_LIGHTING
 
 #if defined(IMAGE_BASED_LIGHTING)
@@ -0,0 +1,112 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// GLSL port of the Redwood depth noise model in
+// esp/sensor/RedwoodNoiseModel.cu, applied while unprojecting the depth
+// buffer. Read about the noise model here:
+// http://www.alexteichman.com/octo/clams/
+// Original source code: http://redwood-data.org/indoor/data/simdepth.py
+
+precision highp float;
+precision highp int;
+
+// ------------ uniforms --------------------
+// the depth attachment, not unprojected yet
+uniform highp sampler2D DepthTexture;
+// 80 rows of 80 x 5 distortion coefficients
+uniform highp sampler2D DistortionModel;
+uniform highp vec2 DepthUnprojection;
+uniform highp float NoiseMultiplier;
+uniform highp uint Seed;
+
+//------------- output ----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_DEPTH) out highp float noisyDepth;
+
+//------------- shader ----------------------
+
+// https://www.reedbeta.com/blog/hash-functions-for-gpu-rendering/
+uint pcgHash(uint value) {
+  uint state = value * 747796405u + 2891336453u;
+  uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+// uniformly distributed in (0, 1)
+float uniformRandom(inout uint state) {
+  state = pcgHash(state);
+  return (float(state >> 8u) + 0.5) / 16777216.0;
+}
+
+// two standard normally distributed numbers, via the Box-Muller transform
+vec2 normalRandom(inout uint state) {
+  float radius = sqrt(-2.0 * log(uniformRandom(state)));
+  float angle = 6.28318530718 * uniformRandom(state);
+  return radius * vec2(cos(angle), sin(angle));
+}
+
+float unprojectDepth(float depth) {
+  // far plane patched to 0 the same way as in depth.frag
+  return depth == 1.0 ? 0.0
+                      : DepthUnprojection[1] / (depth + DepthUnprojection[0]);
+}
+
+float undistort(int x, int y, float z) {
+  int i2 = int((z + 1.0) / 2.0);
+  int i1 = i2 - 1;
+  float a = (z - (float(i1) * 2.0 + 1.0)) / 2.0;
+  int cell = (x / 8) * 5;
+  int row = y / 6;
+
+  float f = (1.0 - a) * texelFetch(DistortionModel,
+                                   ivec2(cell + clamp(i1, 0, 4), row), 0).r +
+            a * texelFetch(DistortionModel, ivec2(cell + min(i2, 4), row), 0).r;
+
+  return f < 1e-5 ? 0.0 : z / f;
+}
+
+void main(void) {
+  ivec2 size = textureSize(DepthTexture, 0);
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  // the model works on observations, whose rows go from the top while the
+  // framebuffer's go from the bottom
+  int row = size.y - 1 - pixel.y;
+
+  uint state = pcgHash(uint(row * size.x + pixel.x) ^ pcgHash(Seed));
+  vec2 shuffle = normalRandom(state);
+  float highFrequency = normalRandom(state).x;
+
+  float ymax = float(size.y - 1);
+  float xmax = float(size.x - 1);
+  // Shuffle pixels
+  int y = int(clamp(float(row) + shuffle.x * 0.25 * NoiseMultiplier, 0.0,
+                    ymax) + 0.5);
+  int x = int(clamp(float(pixel.x) + shuffle.y * 0.25 * NoiseMultiplier, 0.0,
+                    xmax) + 0.5);
+
+  // downsample
+  float d = unprojectDepth(
+      texelFetch(DepthTexture, ivec2(x - x % 2, size.y - 1 - (y - y % 2)), 0)
+          .r);
+  // If depth is greater than 10m, the sensor will just return a zero
+  if (d >= 10.0) {
+    noisyDepth = 0.0;
+    return;
+  }
+
+  // Distortion
+  // The noise model was originally made for a 640x480 sensor, so re-map our
+  // arbitrarily sized sensor to that size!
+  float undistortedDepth = undistort(int(float(x) / xmax * 639.0 + 0.5),
+                                     int(float(y) / ymax * 479.0 + 0.5), d);
+
+  // quantization and high freq noise
+  if (undistortedDepth == 0.0) {
+    noisyDepth = 0.0;
+    return;
+  }
+  float denom = round((35.130 / undistortedDepth +
+                       highFrequency * 0.027778 * NoiseMultiplier) *
+                      8.0);
+  noisyDepth = denom > 1e-5 ? 35.130 * 8.0 / denom : 0.0;
+}
@@ -0,0 +1,20 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+precision highp float;
+
+// ------------ input -----------------------
+in lowp vec4 interpolatedColor;
+in highp vec3 viewNormal;
+
+//------------- output ----------------------
+layout(location = OUTPUT_ATTRIBUTE_LOCATION_COLOR) out lowp vec4 fragmentColor;
+
+//------------- shader ----------------------
+void main() {
+  // lit by a headlight, so tubes look round from any direction without
+  // depending on the scene lights
+  lowp float diffuse = abs(normalize(viewNormal).z);
+  fragmentColor = vec4(interpolatedColor.rgb * (0.35 + 0.65 * diffuse),
+                       interpolatedColor.a);
+}
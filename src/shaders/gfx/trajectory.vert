@@ -0,0 +1,41 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Places a capsule of the segment radius around each trajectory segment,
+// drawn as one instance of a shared unit capsule mesh.
+
+// ------------ input -----------------------
+// xyz: offset from the segment axis in units of the radius, with z along the
+// segment; w: 0 at the segment start, 1 at its end
+layout(location = ATTRIBUTE_LOCATION_CORNER) in highp vec4 corner;
+layout(location = ATTRIBUTE_LOCATION_FROM) in highp vec3 from;
+layout(location = ATTRIBUTE_LOCATION_TO) in highp vec3 to;
+layout(location = ATTRIBUTE_LOCATION_COLOR) in lowp vec4 color;
+layout(location = ATTRIBUTE_LOCATION_RADIUS) in highp float radius;
+
+// ------------ uniforms --------------------
+uniform highp mat4 ViewMatrix;
+uniform highp mat4 ProjectionMatrix;
+
+// ------------ output ----------------------
+out lowp vec4 interpolatedColor;
+out highp vec3 viewNormal;
+
+//------------- shader ----------------------
+void main() {
+  highp vec3 along = to - from;
+  highp float segmentLength = length(along);
+  along = segmentLength > 1.0e-6 ? along / segmentLength : vec3(0.0, 1.0, 0.0);
+  highp vec3 helper =
+      abs(along.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+  highp vec3 side = normalize(cross(along, helper));
+  highp vec3 up = cross(side, along);
+
+  highp vec3 normal = corner.x * side + corner.y * up + corner.z * along;
+  highp vec3 position = mix(from, to, corner.w) + radius * normal;
+
+  viewNormal = mat3(ViewMatrix) * normal;
+  gl_Position = ProjectionMatrix * ViewMatrix * vec4(position, 1.0);
+  interpolatedColor = color;
+}
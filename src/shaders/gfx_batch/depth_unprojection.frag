@@ -0,0 +1,41 @@
+/* Has to match DepthUnprojectionTileUniform in DepthUnprojection.h */
+struct TileData {
+  highp vec4 rectangle;
+  highp vec4 depthUnprojection;
+  highp mat4 pointUnprojection;
+};
+
+layout(std140) uniform Tiles {
+  TileData tiles[TILE_COUNT];
+};
+
+uniform highp sampler2D depthTexture;
+
+flat in highp int tileId;
+in highp vec2 tileCoordinates;
+
+layout(location = 0) out highp float unprojectedDepth;
+#ifdef POINT_CLOUD
+layout(location = 1) out highp vec4 point;
+#endif
+
+void main() {
+  highp float depth = texelFetch(depthTexture, ivec2(gl_FragCoord.xy), 0).r;
+  highp vec2 depthUnprojection = tiles[tileId].depthUnprojection.xy;
+
+  /* Same as in depth.frag and unprojectDepth(). We can afford using == for
+     comparison as 1.0f has an exact representation and the depth is cleared
+     to exactly this value. */
+  unprojectedDepth = depth == 1.0 ? 0.0 :
+    depthUnprojection[1]/(depth + depthUnprojection[0]);
+
+  #ifdef POINT_CLOUD
+  if(depth == 1.0) {
+    point = vec4(0.0);
+  } else {
+    highp vec4 unprojected = tiles[tileId].pointUnprojection*
+      vec4(tileCoordinates, depth*2.0 - 1.0, 1.0);
+    point = vec4(unprojected.xyz/unprojected.w, 1.0);
+  }
+  #endif
+}
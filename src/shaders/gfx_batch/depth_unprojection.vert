@@ -0,0 +1,28 @@
+/* Has to match DepthUnprojectionTileUniform in DepthUnprojection.h */
+struct TileData {
+  /* Tile rectangle in normalized device coordinates, min in xy, max in zw */
+  highp vec4 rectangle;
+  /* Depth unprojection in xy, zw unused */
+  highp vec4 depthUnprojection;
+  /* Inverse of the projection, or of the combined projection and view for
+     points in world space */
+  highp mat4 pointUnprojection;
+};
+
+layout(std140) uniform Tiles {
+  TileData tiles[TILE_COUNT];
+};
+
+flat out highp int tileId;
+/* Normalized device coordinates relative to the tile */
+out highp vec2 tileCoordinates;
+
+void main() {
+  /* A quad drawn as a triangle strip, one for each instance */
+  highp vec2 corner = vec2(float(gl_VertexID & 1),
+                           float((gl_VertexID >> 1) & 1));
+  highp vec4 rectangle = tiles[gl_InstanceID].rectangle;
+  gl_Position = vec4(mix(rectangle.xy, rectangle.zw, corner), 0.0, 1.0);
+  tileCoordinates = corner*2.0 - vec2(1.0);
+  tileId = gl_InstanceID;
+}
@@ -23,6 +23,9 @@ vec4 BlurFunction(vec2 uv,
                   vec4 center_c,
                   float center_d,
                   inout float w_total) {
+#ifdef AO_TILED
+  uv = clampToTile(uv, 1.0 / vec2(textureSize(uTexSource, 0)));
+#endif
   vec4 c = texture(uTexSource, uv);
   float d = texture(uTexLinearDepth, uv).x;
 
@@ -0,0 +1,57 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+precision highp float;
+
+// Same as in depthlinearize.frag
+uniform vec4 uClipInfo;
+uniform float uSharpness;
+
+// Full-resolution scene depth
+uniform sampler2D uInputTexture;
+// AO and linear depth at 1/UPSAMPLE_FACTOR of the resolution
+uniform sampler2D uTexSource;
+uniform sampler2D uTexLinearDepth;
+
+out vec4 out_Color;
+
+float reconstructCSZ(float depth, vec4 clipInfo) {
+  if (clipInfo[3] == 1.0f) {
+    // perspective projection
+    return (clipInfo[0] / (clipInfo[1] * depth + clipInfo[2]));
+  }
+  // orthographic projection
+  return (clipInfo[1] + clipInfo[2] - depth * clipInfo[1]);
+}
+
+void main() {
+  float centerDepth = reconstructCSZ(
+      texelFetch(uInputTexture, ivec2(gl_FragCoord.xy), 0).x, uClipInfo);
+
+  // Bilinear footprint of the four nearest low-resolution texels, with each
+  // weight further attenuated by how much the texel depth differs. Keeps AO
+  // from bleeding over depth discontinuities when magnified.
+  ivec2 lowSize = textureSize(uTexSource, 0);
+  vec2 lowPosition = gl_FragCoord.xy / float(UPSAMPLE_FACTOR) - 0.5;
+  ivec2 base = ivec2(floor(lowPosition));
+  vec2 f = lowPosition - floor(lowPosition);
+
+  float aoTotal = 0.0;
+  float wTotal = 0.0;
+  for (int y = 0; y != 2; ++y) {
+    for (int x = 0; x != 2; ++x) {
+      ivec2 coord = clamp(base + ivec2(x, y), ivec2(0), lowSize - 1);
+      float bilinear = (x == 1 ? f.x : 1.0 - f.x) * (y == 1 ? f.y : 1.0 - f.y);
+      float ddiff =
+          (texelFetch(uTexLinearDepth, coord, 0).x - centerDepth) * uSharpness;
+      // epsilon so a pixel differing from all its neighbors still gets the
+      // plain bilinear result instead of a division by zero
+      float w = bilinear * exp2(-ddiff * ddiff) + 1.0e-5;
+      aoTotal += texelFetch(uTexSource, coord, 0).x * w;
+      wTotal += w;
+    }
+  }
+
+  out_Color = vec4(aoTotal / wTotal);
+}
@@ -9,6 +9,7 @@ precision highp float;
 // idx 1 : zNear - zFar
 // idx 2 : zFar
 // idx 3 : 1 == perspective, 0 == orthographic
+// With AO_TILED taken from the tile data instead.
 uniform vec4 uClipInfo;
 
 #ifdef DEPTHLINEARIZE_MSAA
@@ -38,9 +39,20 @@ void main() {
 #ifdef DEPTHLINEARIZE_MSAA
   float depth =
       texelFetch(uInputTexture, ivec2(gl_FragCoord.xy), uSampleIndex).x;
+#elif defined(DOWNSAMPLE_FACTOR)
+  // point-sample the center of the block this pixel covers, averaging depths
+  // across edges would create geometry that isn't there
+  ivec2 coord = min(ivec2(gl_FragCoord.xy) * DOWNSAMPLE_FACTOR +
+                        DOWNSAMPLE_FACTOR / 2,
+                    textureSize(uInputTexture, 0) - 1);
+  float depth = texelFetch(uInputTexture, coord, 0).x;
 #else
   float depth = texelFetch(uInputTexture, ivec2(gl_FragCoord.xy), 0).x;
 #endif
 
+#ifdef AO_TILED
+  out_Color = reconstructCSZ(depth, tiles[tileId()].clipInfo);
+#else
   out_Color = reconstructCSZ(depth, uClipInfo);
+#endif
 }
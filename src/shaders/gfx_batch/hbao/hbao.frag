@@ -72,6 +72,15 @@ const float NUM_STEPS = 4.0f;
 // texRandom/uJitter initialization depends on this
 const float NUM_DIRECTIONS = 8.0f;
 
+#ifdef AO_TEMPORAL
+// The directions are spread over AO_TEMPORAL frames, each frame computing
+// the ones starting at uDirectionOffset
+const float NUM_FRAME_DIRECTIONS = NUM_DIRECTIONS / float(AO_TEMPORAL);
+uniform float uDirectionOffset;
+#else
+const float NUM_FRAME_DIRECTIONS = NUM_DIRECTIONS;
+#endif
+
 layout(std140) uniform uControlBuffer {
   HBAOData control;
 };
@@ -154,10 +163,25 @@ in vec2 texCoord;
 
 //----------------------------------------------------------------------------------
 
+#ifdef AO_TILED
+// Data of the tile the fragment is in, filled at the start of main()
+vec4 tileUv;
+vec4 tileProjInfo;
+int tileProjOrtho;
+#endif
+
 vec3 UVToView(vec2 uv, float eye_z) {
+#ifdef AO_TILED
+  // projection info is relative to the tile
+  uv = (uv - tileUv.xy) / tileUv.zw;
+  return vec3((uv * tileProjInfo.xy + tileProjInfo.zw) *
+                  (tileProjOrtho != 0 ? 1. : eye_z),
+              eye_z);
+#else
   return vec3((uv * control.projInfo.xy + control.projInfo.zw) *
                   (control.projOrtho != 0 ? 1. : eye_z),
               eye_z);
+#endif
 }
 
 #ifdef AO_DEINTERLEAVED
@@ -178,7 +202,15 @@ vec3 FetchQuarterResViewPos(vec2 UV) {
 #else  // not AO_DEINTERLEAVED
 
 vec3 FetchViewPos(vec2 UV) {
+#ifdef AO_TILED
+  // don't sample depth of neighboring tiles
+  float ViewDepth =
+      textureLod(texLinearDepth, clampToTile(UV, control.InvFullResolution),
+                 0.0f)
+          .x;
+#else
   float ViewDepth = textureLod(texLinearDepth, UV, 0.0f).x;
+#endif
   return UVToView(UV, ViewDepth);
 }
 
@@ -254,9 +286,13 @@ float ComputeCoarseAO(vec2 FullResUV,
   const float Alpha = 2.0 * M_PI / NUM_DIRECTIONS;
   float AO = 0.0f;
 
-  for (float DirectionIndex = 0.0f; DirectionIndex < NUM_DIRECTIONS;
+  for (float DirectionIndex = 0.0f; DirectionIndex < NUM_FRAME_DIRECTIONS;
        ++DirectionIndex) {
+#ifdef AO_TEMPORAL
+    float Angle = Alpha * (DirectionIndex + uDirectionOffset);
+#else
     float Angle = Alpha * DirectionIndex;
+#endif
 
     // Compute normalized 2D direction
     vec2 Direction = RotateDirection(vec2(cos(Angle), sin(Angle)), Rand.xy);
@@ -282,7 +318,7 @@ float ComputeCoarseAO(vec2 FullResUV,
     }
   }
 
-  AO *= control.AOMultiplier / (NUM_DIRECTIONS * NUM_STEPS);
+  AO *= control.AOMultiplier / (NUM_FRAME_DIRECTIONS * NUM_STEPS);
   return clamp(1.0 - AO * 2.0, 0.0f, 1.0f);
 }
 
@@ -305,6 +341,12 @@ void main() {
 #endif
 #else
       texCoord;
+#endif
+#ifdef AO_TILED
+  HBAOTileData tile = tiles[tileId()];
+  tileUv = tileUvRectangle(control.InvFullResolution);
+  tileProjInfo = tile.projInfo;
+  tileProjOrtho = tile.projOrtho;
 #endif
   vec3 ViewPosition = FetchViewPos(uv);
 
@@ -313,8 +355,13 @@ void main() {
 #endif
 
   // Compute projection of disk of radius control.R into screen space
+#ifdef AO_TILED
+  float RadiusPixels =
+      tile.radiusToScreen / (tile.projOrtho != 0 ? 1.0 : ViewPosition.z);
+#else
   float RadiusPixels =
       control.RadiusToScreen / (control.projOrtho != 0 ? 1.0 : ViewPosition.z);
+#endif
 
   // Get jitter vector for the current full-res pixel
   vec4 Rand = GetJitter();
@@ -22,6 +22,9 @@ float BlurFunction(vec2 uv,
                    float center_c,
                    float center_d,
                    inout float w_total) {
+#ifdef AO_TILED
+  uv = clampToTile(uv, 1.0 / vec2(textureSize(uTexSource, 0)));
+#endif
   vec2 aoz = texture(uTexSource, uv).xy;
   float c = aoz.x;
   float d = aoz.y;
@@ -0,0 +1,63 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+precision highp float;
+
+// Relative difference between the reprojected depth and the depth stored in
+// the previous frame above which the previous AO is rejected as disoccluded
+const float DEPTH_THRESHOLD = 0.05f;
+
+in vec2 texCoord;
+
+// Same as uProjInfo in viewnormal.frag
+uniform vec4 uProjInfo;
+uniform int uProjOrtho;
+
+// View space of the current frame to view space of the previous frame
+uniform mat4 uCurrentToPrevious;
+uniform mat4 uPreviousProjection;
+// Weight of the current frame, 1 if there's no previous frame to use
+uniform float uCurrentWeight;
+
+uniform sampler2D uTexCurrent;
+uniform sampler2D uTexLinearDepth;
+uniform sampler2D uTexHistory;
+uniform sampler2D uTexHistoryLinearDepth;
+
+out vec4 out_Color;
+
+vec3 UVToView(vec2 uv, float eye_z) {
+  return vec3(
+      (uv * uProjInfo.xy + uProjInfo.zw) * (uProjOrtho != 0 ? 1. : eye_z),
+      eye_z);
+}
+
+void main() {
+  vec4 current = texture(uTexCurrent, texCoord);
+  float ao = current.x;
+
+  if (uCurrentWeight < 1.0) {
+    // Linear depth is positive in front of the camera, view space Z negative
+    vec3 viewPosition =
+        UVToView(texCoord, textureLod(uTexLinearDepth, texCoord, 0.0f).x);
+    vec4 previousPosition =
+        uCurrentToPrevious * vec4(viewPosition.xy, -viewPosition.z, 1.0);
+    vec4 previousClip = uPreviousProjection * previousPosition;
+    vec2 previousUv = previousClip.xy / previousClip.w * 0.5 + 0.5;
+
+    if (all(greaterThanEqual(previousUv, vec2(0.0))) &&
+        all(lessThanEqual(previousUv, vec2(1.0)))) {
+      float previousDepth =
+          textureLod(uTexHistoryLinearDepth, previousUv, 0.0f).x;
+      if (abs(previousDepth + previousPosition.z) <=
+          DEPTH_THRESHOLD * previousDepth) {
+        ao = mix(textureLod(uTexHistory, previousUv, 0.0f).x, ao,
+                 uCurrentWeight);
+      }
+    }
+  }
+
+  // The second channel is the depth used by the special blur, if enabled
+  out_Color = vec4(ao, current.y, 0.0, 0.0);
+}
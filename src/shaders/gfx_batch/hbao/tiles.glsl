@@ -0,0 +1,50 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+// Prepended to the HBAO shaders when the effect is calculated for a grid of
+// AO_TILE_COUNT tiles, AO_TILE_COUNT_X in a row, each AO_TILE_SIZE pixels
+// large and with its own projection.
+
+precision highp float;
+
+#ifdef AO_TILE_DATA
+struct HBAOTileData {
+  // Same as uClipInfo in depthlinearize.frag
+  vec4 clipInfo;
+  // Same as projInfo in hbao.frag
+  vec4 projInfo;
+  float radiusToScreen;
+  int projOrtho;
+  int _pad0;
+  int _pad1;
+};
+
+layout(std140) uniform uTileBuffer {
+  HBAOTileData tiles[AO_TILE_COUNT];
+};
+#endif
+
+ivec2 tileCoordinates() {
+  return ivec2(gl_FragCoord.xy / AO_TILE_SIZE);
+}
+
+int tileId() {
+  ivec2 coordinates = tileCoordinates();
+  return coordinates.y * AO_TILE_COUNT_X + coordinates.x;
+}
+
+// Texture coordinates of the current tile origin in xy and the tile size in
+// zw
+vec4 tileUvRectangle(vec2 invResolution) {
+  return vec4(vec2(tileCoordinates()) * AO_TILE_SIZE * invResolution,
+              AO_TILE_SIZE * invResolution);
+}
+
+// Clamps texture coordinates to centers of the edge pixels of the current
+// tile, giving the same result as ClampToEdge would for a standalone tile
+vec2 clampToTile(vec2 uv, vec2 invResolution) {
+  vec2 tileMin = vec2(tileCoordinates()) * AO_TILE_SIZE;
+  return clamp(uv, (tileMin + 0.5) * invResolution,
+               (tileMin + AO_TILE_SIZE - 0.5) * invResolution);
+}
@@ -367,6 +367,20 @@ void AttributesConfigsTest::testPhysicsAttrVals(
   CORRADE_COMPARE(physMgrAttr->getSimulator(), "bullet_test");
   CORRADE_COMPARE(physMgrAttr->getFrictionCoefficient(), 1.4);
   CORRADE_COMPARE(physMgrAttr->getRestitutionCoefficient(), 1.1);
+  CORRADE_COMPARE(physMgrAttr->getNumThreads(), 4);
+  CORRADE_VERIFY(physMgrAttr->getDeterministic());
+  CORRADE_COMPARE(physMgrAttr->getMaxSubsteps(), 20);
+  CORRADE_VERIFY(physMgrAttr->getAdaptiveTimestep());
+  CORRADE_COMPARE(physMgrAttr->getAdaptiveMaxTimestep(), 0.05);
+  CORRADE_COMPARE(physMgrAttr->getAdaptiveMaxContacts(), 8);
+  CORRADE_COMPARE(physMgrAttr->getAdaptiveMaxTravel(), 0.02);
+  CORRADE_COMPARE(physMgrAttr->getBroadphase(), "sap");
+  CORRADE_COMPARE(physMgrAttr->getBroadphaseWorldMin(),
+                  Mn::Vector3(-10, -5, -20));
+  CORRADE_COMPARE(physMgrAttr->getBroadphaseWorldMax(),
+                  Mn::Vector3(10, 5, 20));
+  CORRADE_COMPARE(physMgrAttr->getCollisionMargin(), 0.02);
+  CORRADE_COMPARE(physMgrAttr->getSolverIterations(), 25);
   // test physics manager attributes-level user config vals
   testUserDefinedConfigVals(
       physMgrAttr->getUserConfiguration(), 4, "pm defined string", true, 15,
@@ -389,6 +403,18 @@ void AttributesConfigsTest::testPhysicsJSONLoad() {
   "gravity": [1,2,3],
   "friction_coefficient": 1.4,
   "restitution_coefficient": 1.1,
+  "num_threads": 4,
+  "deterministic": true,
+  "max_substeps": 20,
+  "adaptive_timestep": true,
+  "adaptive_max_timestep": 0.05,
+  "adaptive_max_contacts": 8,
+  "adaptive_max_travel": 0.02,
+  "broadphase": "sap",
+  "broadphase_world_min": [-10,-5,-20],
+  "broadphase_world_max": [10,5,20],
+  "collision_margin": 0.02,
+  "solver_iterations": 25,
   "user_defined" : {
       "user_str_array" : ["test_00", "test_01", "test_02", "test_03"],
       "user_string" : "pm defined string",
@@ -455,6 +481,7 @@ void AttributesConfigsTest::testPbrShaderAttrVals(
                   "brdflut_test_only_image.png_envmap_test_only_image.hdr");
 
   CORRADE_COMPARE(pbrShaderAttr->getDirectLightIntensity(), 1.23f);
+  CORRADE_COMPARE(pbrShaderAttr->getClusteredLightingMinLightCount(), 32);
 
   CORRADE_VERIFY(pbrShaderAttr->getSkipCalcMissingTBN());
   CORRADE_VERIFY(pbrShaderAttr->getUseMikkelsenTBN());
@@ -519,6 +546,7 @@ void AttributesConfigsTest::testPbrShaderAttrJSONLoad() {
   "ibl_diffuse_scale": 3.5,
   "ibl_specular_scale": 4.5,
   "tonemap_exposure": 6.7,
+  "clustered_lighting_min_lights": 32,
   "gamma": 8.9,
   "user_defined" : {
       "user_str_array" : ["test_00", "test_01", "test_02", "test_03", "test_04"],
@@ -1114,6 +1142,19 @@ void AttributesConfigsTest::testSceneInstanceJSONLoad() {
   bool success = sceneInstanceAttributesManager_->saveManagedObjectToFile(
       sceneAttr->getHandle(), newAttrName);
 
+  // saving in the background writes the same file
+  std::string bgAttrName = Cr::Utility::formatString(
+      "{}/testSceneAttrConfig_saved_bg_JSON.{}", TEST_ASSETS,
+      sceneInstanceAttributesManager_->getJSONTypeExt());
+  sceneInstanceAttributesManager_->setSaveFilesInBackground(true);
+  CORRADE_VERIFY(sceneInstanceAttributesManager_->saveManagedObjectToFile(
+      sceneAttr->getHandle(), bgAttrName));
+  CORRADE_VERIFY(sceneInstanceAttributesManager_->waitForBackgroundSaves());
+  sceneInstanceAttributesManager_->setSaveFilesInBackground(false);
+  CORRADE_COMPARE(*Cr::Utility::Path::readString(bgAttrName),
+                  *Cr::Utility::Path::readString(newAttrName));
+  Cr::Utility::Path::remove(bgAttrName);
+
   // test json string to verify format - this also deletes sceneAttr from
   // manager
   ESP_DEBUG() << "About to test string-based sceneAttr :";
@@ -230,6 +230,12 @@ struct AttributesManagersTest : Cr::TestSuite::Tester {
    */
   void testPrimitiveBasedObjectAttributes();
 
+  /**
+   * @brief Test that substring, prefix and suffix handle queries stay
+   * consistent as templates are registered and removed.
+   */
+  void testHandleQueries();
+
   // test member vars
 
   esp::logging::LoggingContext loggingContext_;
@@ -275,6 +281,7 @@ AttributesManagersTest::AttributesManagersTest() {
       &AttributesManagersTest::testLightLayoutAttributesManager,
       &AttributesManagersTest::testPrimitiveAssetAttributes,
       &AttributesManagersTest::testPrimitiveBasedObjectAttributes,
+      &AttributesManagersTest::testHandleQueries,
   });
 }
 
@@ -1045,6 +1052,44 @@ void AttributesManagersTest::testPrimitiveBasedObjectAttributes() {
 
 }  // AttributesManagersTest::testPrimitiveBasedObjectAttributes test
 
+
+void AttributesManagersTest::testHandleQueries() {
+  const auto& mgr = physicsAttributesManager_;
+  const int origNumTemplates = mgr->getNumObjects();
+  const std::vector<std::string> handles{
+      "IndexTest/Alpha.json", "indexTest/beta.json", "other/alphaIndex.json"};
+  for (const std::string& handle : handles) {
+    CORRADE_VERIFY(mgr->createDefaultObject(handle, true));
+  }
+
+  // queries ignore case and return sorted handles
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("ALPHA"),
+                  (std::vector<std::string>{"IndexTest/Alpha.json",
+                                            "other/alphaIndex.json"}));
+  CORRADE_COMPARE(mgr->getObjectHandlesByPrefix("indextest/"),
+                  (std::vector<std::string>{"IndexTest/Alpha.json",
+                                            "indexTest/beta.json"}));
+  CORRADE_COMPARE(mgr->getObjectHandlesBySuffix("ALPHA.json"),
+                  (std::vector<std::string>{"IndexTest/Alpha.json"}));
+  CORRADE_VERIFY(mgr->getObjectHandlesByPrefix("alpha").empty());
+  // every handle either contains the substring or doesn't
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("index", true).size() +
+                      mgr->getObjectHandlesBySubstring("index", false).size(),
+                  std::size_t(mgr->getNumObjects()));
+
+  // removed handles aren't found anymore
+  mgr->removeObjectByHandle(handles[0]);
+  CORRADE_COMPARE(mgr->getObjectHandlesByPrefix("indextest/"),
+                  (std::vector<std::string>{"indexTest/beta.json"}));
+  CORRADE_VERIFY(mgr->getObjectHandlesBySuffix("alpha.json").empty());
+  CORRADE_COMPARE(mgr->getObjectHandlesBySubstring("alpha"),
+                  (std::vector<std::string>{"other/alphaIndex.json"}));
+
+  mgr->removeObjectByHandle(handles[1]);
+  mgr->removeObjectByHandle(handles[2]);
+  CORRADE_COMPARE(mgr->getNumObjects(), origNumTemplates);
+}  // AttributesManagersTest::testHandleQueries
+
 }  // namespace
 
 CORRADE_TEST_MAIN(AttributesManagersTest)
@@ -26,6 +26,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -136,6 +137,8 @@ const struct {
   TestFlags testFlags;
   Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> (*create)(
       const ReplayRendererConfiguration& configuration);
+  // if non-zero, environments are spread across this many contexts on GPU 0
+  std::size_t gpuDeviceCount;
 } TestIntegrationData[]{
     {"rgb - classic", TestFlag::Color,
      [](const ReplayRendererConfiguration& configuration) {
@@ -147,6 +150,12 @@ const struct {
        return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
            new esp::sim::BatchReplayRenderer{configuration}};
      }},
+    {"rgb - batch, two devices", TestFlag::Color,
+     [](const ReplayRendererConfiguration& configuration) {
+       return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
+           new esp::sim::BatchReplayRenderer{configuration}};
+     },
+     2},
     {"depth - classic", TestFlag::Depth,
      [](const ReplayRendererConfiguration& configuration) {
        return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
@@ -157,6 +166,12 @@ const struct {
        return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
            new esp::sim::BatchReplayRenderer{configuration}};
      }},
+    {"depth - batch, two devices", TestFlag::Depth,
+     [](const ReplayRendererConfiguration& configuration) {
+       return Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer>{
+           new esp::sim::BatchReplayRenderer{configuration}};
+     },
+     2},
 };
 
 const struct {
@@ -321,6 +336,7 @@ void BatchReplayRendererTest::testIntegration() {
   ReplayRendererConfiguration batchRendererConfig;
   batchRendererConfig.sensorSpecifications = sensorSpecs;
   batchRendererConfig.numEnvironments = numEnvs;
+  batchRendererConfig.gpuDeviceIds.assign(data.gpuDeviceCount, 0);
   {
     Cr::Containers::Pointer<esp::sim::AbstractReplayRenderer> renderer =
         data.create(batchRendererConfig);
@@ -346,8 +362,10 @@ void BatchReplayRendererTest::testIntegration() {
       }
     }
 
+    // set all environments at once, which decodes the keyframes in parallel
+    renderer->setEnvironmentKeyframes(
+        {serKeyframes.data(), serKeyframes.size()});
     for (int envIndex = 0; envIndex < numEnvs; envIndex++) {
-      renderer->setEnvironmentKeyframe(envIndex, serKeyframes[envIndex]);
       renderer->setSensorTransformsFromKeyframe(envIndex, userPrefix);
     }
 
@@ -376,22 +394,78 @@ void BatchReplayRendererTest::testIntegration() {
       }
     }
 
-    const auto colorPtr = renderer->getCudaColorBufferDevicePointer();
-    const auto depthPtr = renderer->getCudaDepthBufferDevicePointer();
-    bool isBatchRenderer =
-        dynamic_cast<esp::sim::BatchReplayRenderer*>(renderer.get());
+    // two frames in flight give the same output as the synchronous render
+    if (dynamic_cast<esp::sim::BatchReplayRenderer*>(renderer.get())) {
+      renderer->renderAsync();
+      renderer->renderAsync();
+      CORRADE_COMPARE(renderer->framesInFlight(), 2);
+      for (int frame = 0; frame != 2; ++frame) {
+        CORRADE_ITERATION(frame);
+        std::vector<std::vector<char>> asyncColorBuffers(numEnvs);
+        std::vector<std::vector<char>> asyncDepthBuffers(numEnvs);
+        std::vector<Mn::MutableImageView2D> asyncColorImageViews;
+        std::vector<Mn::MutableImageView2D> asyncDepthImageViews;
+        for (int envIndex = 0; envIndex < numEnvs; envIndex++) {
+          if (data.testFlags & TestFlag::Color) {
+            asyncColorImageViews.emplace_back(
+                getRGBView(renderer->sensorSize(envIndex).x(),
+                           renderer->sensorSize(envIndex).y(),
+                           asyncColorBuffers[envIndex]));
+          }
+          if (data.testFlags & TestFlag::Depth) {
+            asyncDepthImageViews.emplace_back(
+                getDepthView(renderer->sensorSize(envIndex).x(),
+                             renderer->sensorSize(envIndex).y(),
+                             asyncDepthBuffers[envIndex]));
+          }
+        }
+        renderer->waitFrame(asyncColorImageViews, asyncDepthImageViews);
+        CORRADE_VERIFY(asyncColorBuffers == colorBuffers);
+        CORRADE_VERIFY(asyncDepthBuffers == depthBuffers);
+      }
+      CORRADE_COMPARE(renderer->framesInFlight(), 0);
+    }
+
+    // the CUDA buffers are a single device's framebuffer
+    if (data.gpuDeviceCount <= 1) {
+      const auto colorPtr = renderer->getCudaColorBufferDevicePointer();
+      const auto depthPtr = renderer->getCudaDepthBufferDevicePointer();
+      bool isBatchRenderer =
+          dynamic_cast<esp::sim::BatchReplayRenderer*>(renderer.get());
 #ifdef ESP_BUILD_WITH_CUDA
-    if (isBatchRenderer) {
-      CORRADE_VERIFY(colorPtr);
-      CORRADE_VERIFY(depthPtr);
-    } else {
-      // Not implemented in ClassicReplayRenderer
+      if (isBatchRenderer) {
+        CORRADE_VERIFY(colorPtr);
+        CORRADE_VERIFY(depthPtr);
+      } else {
+        // Not implemented in ClassicReplayRenderer
+        CORRADE_VERIFY(!colorPtr);
+        CORRADE_VERIFY(!depthPtr);
+      }
+#else
       CORRADE_VERIFY(!colorPtr);
       CORRADE_VERIFY(!depthPtr);
+#endif
+    }
+
+#ifdef ESP_BUILD_WITH_CUDA
+    // per-environment views work with any device count
+    if (dynamic_cast<esp::sim::BatchReplayRenderer*>(renderer.get())) {
+      for (int envIndex = 0; envIndex < numEnvs; envIndex++) {
+        const esp::sim::CudaImageView color =
+            renderer->getCudaColorImageView(envIndex);
+        const esp::sim::CudaImageView depth =
+            renderer->getCudaDepthImageView(envIndex);
+        CORRADE_VERIFY(color.data);
+        CORRADE_VERIFY(depth.data);
+        CORRADE_COMPARE(color.size, renderer->sensorSize(envIndex));
+        CORRADE_COMPARE(depth.size, renderer->sensorSize(envIndex));
+        CORRADE_COMPARE(color.format, Mn::PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE(depth.format, Mn::PixelFormat::Depth32F);
+        CORRADE_COMPARE_AS(color.rowStride, std::size_t(4 * color.size.x()),
+                           Cr::TestSuite::Compare::GreaterOrEqual);
+        renderer->waitForCudaImages(envIndex, nullptr);
+      }
     }
-#else
-    CORRADE_VERIFY(!colorPtr);
-    CORRADE_VERIFY(!depthPtr);
 #endif
   }
   // Check that the context is properly deleted
@@ -4,8 +4,20 @@
 
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <cstdint>
+#include <map>
+#include <thread>
+#include "esp/core/Buffer.h"
 #include "esp/core/Configuration.h"
 #include "esp/core/Esp.h"
+#include "esp/core/LatencyTracker.h"
+#include "esp/core/Profiler.h"
+#include "esp/core/ScratchArena.h"
+#include "esp/core/ThreadAffinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 using namespace esp::core::config;
 namespace Cr = Corrade;
@@ -35,6 +47,65 @@ struct CoreTest : Cr::TestSuite::Tester {
    */
   void TestConfigurationSubconfigFind();
 
+  /**
+   * @brief Test that copies of a Configuration share its subconfigs until
+   * either of them edits one.
+   */
+  void TestConfigurationCopyOnWrite();
+
+  /**
+   * @brief Test that values stay retrievable by key as they are added and
+   * removed, and that literal keys hash the same as runtime strings.
+   */
+  void TestConfigurationValueStorage();
+
+  /**
+   * @brief Test that nested profiler scopes are recorded and aggregated per
+   * frame only while the profiler is enabled.
+   */
+  void TestProfilerScopes();
+
+  /**
+   * @brief Test that profiler counters are summed per frame.
+   */
+  void TestProfilerCounters();
+
+  /**
+   * @brief Test that GPU events are aggregated with the CPU ones but kept on
+   * a track of their own.
+   */
+  void TestProfilerGpuEvents();
+
+  /**
+   * @brief Test that latency histogram percentiles stay within the bucket
+   * precision of the exact ones.
+   */
+  void TestLatencyHistogram();
+
+  /**
+   * @brief Test that the latency tracker records calls per name only while
+   * enabled.
+   */
+  void TestLatencyTracker();
+
+  /**
+   * @brief Test that buffers requesting pinned memory are allocated the same
+   * as pageable ones, and are only pinned in CUDA builds.
+   */
+  void TestBufferPinned();
+
+  /**
+   * @brief Test that the scratch arena is reset only without live
+   * allocations and ends up with a single chunk fitting a whole frame.
+   */
+  void TestScratchArena();
+
+  /**
+   * @brief Test that thread roles keep their CPUs and that threads are pinned
+   * only to CPUs that exist.
+   */
+  void TestThreadAffinity();
+
   esp::logging::LoggingContext loggingContext_;
 };  // struct CoreTest
 
@@ -42,6 +113,16 @@ CoreTest::CoreTest() {
   addTests({
       &CoreTest::TestConfiguration,
       &CoreTest::TestConfigurationSubconfigFind,
+      &CoreTest::TestConfigurationCopyOnWrite,
+      &CoreTest::TestConfigurationValueStorage,
+      &CoreTest::TestProfilerScopes,
+      &CoreTest::TestProfilerCounters,
+      &CoreTest::TestProfilerGpuEvents,
+      &CoreTest::TestLatencyHistogram,
+      &CoreTest::TestLatencyTracker,
+      &CoreTest::TestBufferPinned,
+      &CoreTest::TestScratchArena,
+      &CoreTest::TestThreadAffinity,
   });
 }
 
@@ -329,6 +410,346 @@ void CoreTest::TestConfigurationSubconfigFind() {
 
 }  // CoreTest::TestConfigurationSubconfigFind test
 
+void CoreTest::TestConfigurationCopyOnWrite() {
+  Configuration::ptr cfg = Configuration::create();
+  Configuration::ptr subconfig = Configuration::create();
+  subconfig->set("value", 1);
+  cfg->setSubconfigPtr<Configuration>("subconfig", subconfig);
+
+  // the copy shares the subconfig until it edits it
+  Configuration copy{*cfg};
+  CORRADE_COMPARE(copy.getSubconfigView("subconfig").get(),
+                  cfg->getSubconfigView("subconfig").get());
+  copy.editSubconfig<Configuration>("subconfig")->set("value", 2);
+  CORRADE_VERIFY(copy.getSubconfigView("subconfig").get() !=
+                 cfg->getSubconfigView("subconfig").get());
+  CORRADE_COMPARE(cfg->getSubconfigView("subconfig")->get<int>("value"), 1);
+  CORRADE_COMPARE(copy.getSubconfigView("subconfig")->get<int>("value"), 2);
+
+  // a subconfig handed out for editing may change at any time, so it's
+  // copied right away
+  Configuration::ptr edited = cfg->editSubconfig<Configuration>("subconfig");
+  Configuration otherCopy{*cfg};
+  edited->set("value", 3);
+  CORRADE_COMPARE(cfg->getSubconfigView("subconfig")->get<int>("value"), 3);
+  CORRADE_COMPARE(otherCopy.getSubconfigView("subconfig")->get<int>("value"),
+                  1);
+}  // CoreTest::TestConfigurationCopyOnWrite test
+
+void CoreTest::TestConfigurationValueStorage() {
+  constexpr ConfigKey massKey{"mass"};
+  static_assert(massKey.size() == 4, "key length not computed at compile time");
+  const std::string massStr = "mass";
+  CORRADE_COMPARE(ConfigKey{massStr}.hash(), massKey.hash());
+  CORRADE_VERIFY(massKey.hash() != ConfigKey{"scale"}.hash());
+
+  Configuration cfg;
+  constexpr int numValues = 100;
+  for (int i = 0; i < numValues; ++i) {
+    cfg.set(Cr::Utility::formatString("key_{}", i), i);
+  }
+  cfg.set("mass", 2.5);
+  CORRADE_COMPARE(cfg.getNumValues(), numValues + 1);
+  CORRADE_COMPARE(cfg.get<double>(massKey), 2.5);
+  // overwriting doesn't add another entry
+  cfg.set(massStr, 3.0);
+  CORRADE_COMPARE(cfg.getNumValues(), numValues + 1);
+  CORRADE_COMPARE(cfg.get<double>("mass"), 3.0);
+
+  // remove every other value, the rest stays retrievable
+  for (int i = 0; i < numValues; i += 2) {
+    CORRADE_COMPARE(
+        cfg.remove<int>(Cr::Utility::formatString("key_{}", i)), i);
+  }
+  CORRADE_COMPARE(cfg.getNumValues(), numValues / 2 + 1);
+  for (int i = 0; i < numValues; ++i) {
+    const std::string key = Cr::Utility::formatString("key_{}", i);
+    CORRADE_COMPARE(cfg.hasValue(key), i % 2 == 1);
+    if (i % 2 == 1) {
+      CORRADE_COMPARE(cfg.get<int>(key), i);
+    }
+  }
+}  // CoreTest::TestConfigurationValueStorage test
+
+void CoreTest::TestProfilerScopes() {
+  esp::core::Profiler& profiler = esp::core::Profiler::instance();
+  profiler.clear();
+
+  // disabled by default, so nothing is recorded
+  { ESP_PROFILE_SCOPE("CoreTest::disabled"); }
+  CORRADE_VERIFY(profiler.getEvents().empty());
+
+  profiler.setEnabled(true);
+  profiler.markFrame();
+  for (int i = 0; i < 3; ++i) {
+    ESP_PROFILE_SCOPE("CoreTest::outer");
+    { ESP_PROFILE_SCOPE("CoreTest::inner"); }
+  }
+  profiler.markFrame();
+  profiler.setEnabled(false);
+
+  const std::vector<esp::core::ProfileStat> stats = profiler.getFrameStats();
+  CORRADE_COMPARE(stats.size(), 2);
+  std::map<std::string, esp::core::ProfileStat> statsByName;
+  for (const auto& stat : stats) {
+    statsByName[stat.name] = stat;
+  }
+  CORRADE_COMPARE(statsByName["CoreTest::outer"].callCount, 3);
+  CORRADE_COMPARE(statsByName["CoreTest::outer"].depth, 0);
+  CORRADE_COMPARE(statsByName["CoreTest::inner"].callCount, 3);
+  CORRADE_COMPARE(statsByName["CoreTest::inner"].depth, 1);
+  // the enclosing scope includes the time of the nested one
+  CORRADE_VERIFY(statsByName["CoreTest::outer"].totalMs >=
+                 statsByName["CoreTest::inner"].totalMs);
+
+  const std::string trace = profiler.getChromeTrace();
+  CORRADE_VERIFY(trace.find("\"traceEvents\"") != std::string::npos);
+  CORRADE_VERIFY(trace.find("\"name\":\"CoreTest::inner\"") !=
+                 std::string::npos);
+  profiler.clear();
+}  // CoreTest::TestProfilerScopes
+
+void CoreTest::TestProfilerCounters() {
+  esp::core::Profiler& profiler = esp::core::Profiler::instance();
+  profiler.clear();
+
+  // disabled by default, so nothing is counted
+  ESP_PROFILE_COUNT("CoreTest::disabled", 1);
+
+  profiler.setEnabled(true);
+  profiler.markFrame();
+  for (int i = 0; i < 3; ++i) {
+    ESP_PROFILE_COUNT("CoreTest::b", 2);
+  }
+  ESP_PROFILE_COUNT("CoreTest::a", 1);
+  profiler.markFrame();
+  ESP_PROFILE_COUNT("CoreTest::a", 5);
+
+  const std::vector<esp::core::ProfileCounter> counters =
+      profiler.getFrameCounters();
+  CORRADE_COMPARE(counters.size(), 2);
+  CORRADE_COMPARE(counters[0].name, "CoreTest::a");
+  CORRADE_COMPARE(counters[0].value, 1);
+  CORRADE_COMPARE(counters[1].name, "CoreTest::b");
+  CORRADE_COMPARE(counters[1].value, 6);
+
+  // counts of the frame in progress show up after the next mark only
+  profiler.markFrame();
+  profiler.setEnabled(false);
+  CORRADE_COMPARE(profiler.getFrameCounters().size(), 1);
+  CORRADE_COMPARE(profiler.getFrameCounters()[0].value, 5);
+  profiler.clear();
+}  // CoreTest::TestProfilerCounters
+
+void CoreTest::TestProfilerGpuEvents() {
+  esp::core::Profiler& profiler = esp::core::Profiler::instance();
+  profiler.clear();
+
+  profiler.setEnabled(true);
+  profiler.markFrame();
+  {
+    ESP_PROFILE_SCOPE("CoreTest::cpu");
+    // GPU results arrive with times already converted to the profiler epoch
+    const uint64_t start = esp::core::Profiler::now();
+    profiler.recordGpu("GPU CoreTest::pass", start, start + 2000000, 0);
+    profiler.recordGpu("GPU CoreTest::nested", start + 500000,
+                       start + 1000000, 1);
+  }
+  profiler.markFrame();
+  profiler.setEnabled(false);
+
+  std::map<std::string, esp::core::ProfileStat> statsByName;
+  for (const auto& stat : profiler.getStats()) {
+    statsByName[stat.name] = stat;
+  }
+  CORRADE_COMPARE(statsByName.size(), 3);
+  CORRADE_COMPARE(statsByName["GPU CoreTest::pass"].callCount, 1);
+  CORRADE_COMPARE(statsByName["GPU CoreTest::pass"].totalMs, 2.0);
+  CORRADE_COMPARE(statsByName["GPU CoreTest::nested"].depth, 1);
+
+  const std::vector<esp::core::ProfileEvent> events = profiler.getEvents();
+  CORRADE_COMPARE(events.size(), 3);
+  uint32_t cpuThread = 0;
+  uint32_t gpuThread = 0;
+  for (const esp::core::ProfileEvent& event : events) {
+    (event.gpu ? gpuThread : cpuThread) = event.threadIndex;
+    CORRADE_COMPARE(event.gpu, event.name[0] == 'G');
+  }
+  CORRADE_VERIFY(cpuThread != gpuThread);
+
+  const std::string trace = profiler.getChromeTrace();
+  CORRADE_VERIFY(trace.find("\"cat\":\"gpu\"") != std::string::npos);
+  CORRADE_VERIFY(trace.find("\"args\":{\"name\":\"GPU\"}") !=
+                 std::string::npos);
+  profiler.clear();
+}  // CoreTest::TestProfilerGpuEvents
+
+void CoreTest::TestLatencyHistogram() {
+  esp::core::LatencyHistogram histogram;
+  CORRADE_COMPARE(histogram.valueAtPercentile(99.0), 0);
+
+  // small values are exact
+  for (uint64_t ns = 1; ns <= 100; ++ns) {
+    histogram.record(ns);
+  }
+  CORRADE_COMPARE(histogram.count(), 100);
+  CORRADE_COMPARE(histogram.min(), 1);
+  CORRADE_COMPARE(histogram.max(), 100);
+  CORRADE_COMPARE(histogram.mean(), 50.5);
+  CORRADE_COMPARE(histogram.valueAtPercentile(50.0), 50);
+  CORRADE_COMPARE(histogram.valueAtPercentile(99.0), 99);
+  CORRADE_COMPARE(histogram.valueAtPercentile(100.0), 100);
+
+  // a spike of 1000 calls at 1 s on top of 99000 at 1 ms shows up only in
+  // the tail, reported at most one bucket width above the exact value
+  histogram.clear();
+  esp::core::LatencyHistogram spikes;
+  for (int i = 0; i != 99000; ++i) {
+    histogram.record(1000000);
+  }
+  for (int i = 0; i != 1000; ++i) {
+    spikes.record(1000000000);
+  }
+  histogram.merge(spikes);
+  CORRADE_COMPARE(histogram.count(), 100000);
+  const uint64_t p50 = histogram.valueAtPercentile(50.0);
+  const uint64_t p999 = histogram.valueAtPercentile(99.9);
+  CORRADE_VERIFY(p50 >= 1000000 && p50 < 1000000 + 1000000 / 64);
+  CORRADE_COMPARE(histogram.valueAtPercentile(99.0), p50);
+  CORRADE_COMPARE(p999, 1000000000);
+  CORRADE_COMPARE(histogram.max(), 1000000000);
+}  // CoreTest::TestLatencyHistogram
+
+void CoreTest::TestLatencyTracker() {
+  esp::core::LatencyTracker& tracker = esp::core::LatencyTracker::instance();
+  tracker.clear();
+
+  // disabled by default, so nothing is recorded
+  { ESP_TRACK_LATENCY("CoreTest::disabled"); }
+  CORRADE_VERIFY(tracker.getStats().empty());
+
+  tracker.setEnabled(true);
+  for (int i = 0; i != 10; ++i) {
+    ESP_TRACK_LATENCY("CoreTest::b");
+  }
+  { ESP_TRACK_LATENCY("CoreTest::a"); }
+  tracker.record("CoreTest::a", 4000000);
+  tracker.setEnabled(false);
+
+  const std::vector<esp::core::LatencyStats> stats = tracker.getStats();
+  CORRADE_COMPARE(stats.size(), 2);
+  CORRADE_COMPARE(stats[0].name, "CoreTest::a");
+  CORRADE_COMPARE(stats[0].count, 2);
+  CORRADE_COMPARE(stats[0].maxMs, 4.0);
+  CORRADE_COMPARE(stats[1].name, "CoreTest::b");
+  CORRADE_COMPARE(stats[1].count, 10);
+  CORRADE_VERIFY(stats[1].p50Ms <= stats[1].p99Ms);
+  CORRADE_VERIFY(stats[1].p99Ms <= stats[1].maxMs);
+  CORRADE_COMPARE(tracker.getPercentileMs("CoreTest::a", 100.0), 4.0);
+  CORRADE_COMPARE(tracker.getPercentileMs("CoreTest::none", 50.0), 0.0);
+  tracker.clear();
+}  // CoreTest::TestLatencyTracker
+
+void CoreTest::TestBufferPinned() {
+  using esp::core::Buffer;
+  using esp::core::DataType;
+  Buffer::ptr pageable =
+      Buffer::create(std::vector<size_t>{4, 3}, DataType::DT_FLOAT);
+  CORRADE_VERIFY(!pageable->pinned);
+
+  Buffer::ptr pinned =
+      Buffer::create(std::vector<size_t>{4, 3}, DataType::DT_FLOAT, true);
+#ifndef ESP_BUILD_WITH_CUDA
+  CORRADE_VERIFY(!pinned->pinned);
+#endif
+  CORRADE_COMPARE(pinned->totalSize, 12);
+  CORRADE_COMPARE(pinned->data.size(), pageable->data.size());
+  for (uint8_t byte : pinned->data) {
+    CORRADE_COMPARE(byte, 0);
+  }
+}  // CoreTest::TestBufferPinned
+
+void CoreTest::TestScratchArena() {
+  esp::core::ScratchArena arena;
+  CORRADE_COMPARE(arena.capacity(), 0);
+
+  void* a = arena.allocate(3, 1);
+  void* b = arena.allocate(8, 8);
+  CORRADE_VERIFY(a);
+  CORRADE_COMPARE(reinterpret_cast<std::uintptr_t>(b) % 8, 0);
+  CORRADE_COMPARE(arena.liveAllocationCount(), 2);
+
+  // live allocations keep the arena from being reset
+  CORRADE_VERIFY(!arena.reset());
+  arena.deallocate();
+  arena.deallocate();
+  CORRADE_VERIFY(arena.reset());
+  CORRADE_COMPARE(arena.usedSize(), 0);
+
+  // a frame overflowing the first chunk gets a single large enough one
+  const std::size_t firstCapacity = arena.capacity();
+  arena.allocate(firstCapacity, 16);
+  arena.allocate(firstCapacity, 16);
+  const std::size_t grownCapacity = arena.capacity();
+  CORRADE_VERIFY(grownCapacity >= 2 * firstCapacity);
+  arena.deallocate();
+  arena.deallocate();
+  CORRADE_VERIFY(arena.reset());
+  CORRADE_COMPARE(arena.capacity(), grownCapacity);
+  arena.allocate(firstCapacity, 16);
+  arena.allocate(firstCapacity, 16);
+  CORRADE_COMPARE(arena.capacity(), grownCapacity);
+  arena.deallocate();
+  arena.deallocate();
+
+  // vectors use the arena of the calling thread and give it back
+  esp::core::ScratchArena& current = esp::core::ScratchArena::current();
+  CORRADE_VERIFY(current.reset());
+  {
+    esp::core::ScratchVector<int> values;
+    for (int i = 0; i != 1000; ++i) {
+      values.push_back(i);
+    }
+    CORRADE_COMPARE(values[999], 999);
+    CORRADE_COMPARE(current.liveAllocationCount(), 1);
+  }
+  CORRADE_COMPARE(current.liveAllocationCount(), 0);
+  CORRADE_VERIFY(current.reset());
+}  // CoreTest::TestScratchArena
+
+void CoreTest::TestThreadAffinity() {
+  using esp::core::ThreadRole;
+  esp::core::setThreadRoleCpus(ThreadRole::Worker, {2, 3});
+  CORRADE_COMPARE(esp::core::threadRoleCpus(ThreadRole::Worker),
+                  (std::vector<int>{2, 3}));
+  CORRADE_VERIFY(esp::core::threadRoleCpus(ThreadRole::Render).empty());
+  esp::core::setThreadRoleCpus(ThreadRole::Worker, {});
+  CORRADE_VERIFY(esp::core::threadRoleCpus(ThreadRole::Worker).empty());
+
+  // pinned on a separate thread to leave the test thread alone
+  bool pinnedToNothing = true;
+  bool pinnedToInvalid = true;
+  std::thread{[&]() {
+    pinnedToNothing = esp::core::setCurrentThreadCpus({});
+    pinnedToInvalid = esp::core::setCurrentThreadCpus({-1});
+  }}.join();
+  CORRADE_VERIFY(!pinnedToNothing);
+  CORRADE_VERIFY(!pinnedToInvalid);
+
+#ifdef __linux__
+  // the CPU a thread runs on is one it's allowed to be pinned to
+  bool pinned = false;
+  int cpu = -1;
+  std::thread{[&]() {
+    const int current = sched_getcpu();
+    pinned = esp::core::setCurrentThreadCpus({current});
+    cpu = sched_getcpu() == current ? current : -1;
+  }}.join();
+  CORRADE_VERIFY(pinned);
+  CORRADE_VERIFY(cpu >= 0);
+#endif
+}  // CoreTest::TestThreadAffinity
+
 }  // namespace
 
 CORRADE_TEST_MAIN(CoreTest)
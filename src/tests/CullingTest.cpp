@@ -11,9 +11,11 @@
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/SceneGraph/Drawable.h>
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/LightClusters.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
@@ -34,6 +36,12 @@ using Magnum::Math::Literals::operator""_degf;
 // on GCC and Clang, the following namespace causes useful warnings to be
 // printed when you have accidentally unused variables or functions in the test
 namespace {
+// drawable on a dynamic node, culled but never actually drawn
+struct DummyDrawable : Mn::SceneGraph::Drawable3D {
+  using Mn::SceneGraph::Drawable3D::Drawable3D;
+  void draw(const Mn::Matrix4&, Mn::SceneGraph::Camera3D&) override {}
+};
+
 struct CullingTest : Cr::TestSuite::Tester {
   explicit CullingTest();
 
@@ -43,6 +51,10 @@ struct CullingTest : Cr::TestSuite::Tester {
   // tests
   void computeAbsoluteAABB();
   void frustumCulling();
+  void frustumCullingBvh();
+  void frustumCullingSharedResult();
+  void frustumCullingMovedDrawable();
+  void lightClusters();
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -54,7 +66,11 @@ struct CullingTest : Cr::TestSuite::Tester {
 CullingTest::CullingTest() {
   // clang-format off
   addTests({&CullingTest::computeAbsoluteAABB,
-            &CullingTest::frustumCulling});
+            &CullingTest::frustumCulling,
+            &CullingTest::frustumCullingBvh,
+            &CullingTest::frustumCullingSharedResult,
+            &CullingTest::frustumCullingMovedDrawable,
+            &CullingTest::lightClusters});
   // clang-format on
 }
 
@@ -275,6 +291,198 @@ void CullingTest::frustumCulling() {
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
 }
+
+void CullingTest::frustumCullingBvh() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+
+  esp::scene::SceneNode& cameraNode = sceneGraph.getRootNode().createChild();
+  esp::gfx::RenderCamera& renderCamera = *(new esp::gfx::RenderCamera(
+      cameraNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID));
+  renderCamera.setProjectionMatrix(800, 600, 0.01f, 100.0f, 39.6_degf);
+  cameraNode.translate({0.0f, -2.0f, 12.0f});
+
+  // turn the camera around, so each of the boxes gets culled and accepted
+  // at some point, and compare against testing each drawable linearly
+  for (int angle = 0; angle < 360; angle += 15) {
+    CORRADE_ITERATION(angle);
+    cameraNode.rotateY(Mn::Deg(15.0f));
+
+    auto expected = renderCamera.drawableTransformations(drawables);
+    expected.erase(expected.begin() + renderCamera.cull(expected),
+                   expected.end());
+    const auto actual = renderCamera.visibleDrawableTransformations(drawables);
+
+    // both keep the order of the group
+    CORRADE_COMPARE(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_VERIFY(std::addressof(actual[i].first.get()) ==
+                     std::addressof(expected[i].first.get()));
+      CORRADE_COMPARE(actual[i].second, expected[i].second);
+    }
+  }
+}
+
+void CullingTest::frustumCullingSharedResult() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+
+  // two co-located sensors, like the color and depth sensor of an agent
+  esp::scene::SceneNode& agentNode = sceneGraph.getRootNode().createChild();
+  agentNode.translate({0.0f, -2.0f, 12.0f});
+  esp::scene::SceneNode& colorNode = agentNode.createChild();
+  esp::scene::SceneNode& depthNode = agentNode.createChild();
+  esp::gfx::RenderCamera& colorCamera = *(new esp::gfx::RenderCamera(
+      colorNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID));
+  esp::gfx::RenderCamera& depthCamera = *(new esp::gfx::RenderCamera(
+      depthNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID));
+  colorCamera.setProjectionMatrix(800, 600, 0.01f, 100.0f, 39.6_degf);
+  depthCamera.setProjectionMatrix(800, 600, 0.01f, 100.0f, 39.6_degf);
+
+  CORRADE_VERIFY(!drawables.cachedCullResult(colorCamera.projectionMatrix(),
+                                             colorCamera.cameraMatrix()));
+  const auto colorVisible =
+      colorCamera.visibleDrawableTransformations(drawables);
+  CORRADE_VERIFY(drawables.cachedCullResult(colorCamera.projectionMatrix(),
+                                            colorCamera.cameraMatrix()));
+  CORRADE_VERIFY(!colorVisible.empty());
+
+  // the depth camera reuses the result
+  const auto depthVisible =
+      depthCamera.visibleDrawableTransformations(drawables);
+  CORRADE_COMPARE(depthVisible.size(), colorVisible.size());
+  for (std::size_t i = 0; i < depthVisible.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(std::addressof(depthVisible[i].first.get()) ==
+                   std::addressof(colorVisible[i].first.get()));
+    CORRADE_COMPARE(depthVisible[i].second, colorVisible[i].second);
+  }
+
+  // a different pose is culled on its own
+  depthNode.rotateY(Mn::Deg(180.0f));
+  CORRADE_VERIFY(!drawables.cachedCullResult(depthCamera.projectionMatrix(),
+                                             depthCamera.cameraMatrix()));
+  auto expected = depthCamera.drawableTransformations(drawables);
+  expected.erase(expected.begin() + depthCamera.cull(expected),
+                 expected.end());
+  CORRADE_COMPARE(depthCamera.visibleDrawableTransformations(drawables).size(),
+                  expected.size());
+}
+
+void CullingTest::frustumCullingMovedDrawable() {
+  int sceneID = setupTests();
+  auto& sceneGraph = sceneManager_->getSceneGraph(sceneID);
+  auto& drawables = sceneGraph.getDrawables();
+
+  esp::scene::SceneNode& cameraNode = sceneGraph.getRootNode().createChild();
+  esp::gfx::RenderCamera& renderCamera = *(new esp::gfx::RenderCamera(
+      cameraNode, esp::sensor::SemanticSensorTarget::SEMANTIC_ID));
+  renderCamera.setProjectionMatrix(800, 600, 0.01f, 100.0f, 39.6_degf);
+  cameraNode.translate({0.0f, -2.0f, 12.0f});
+
+  // a dynamic drawable in front of the camera
+  esp::scene::SceneNode& objectNode = sceneGraph.getRootNode().createChild();
+  objectNode.setMeshBB({Mn::Vector3{-0.5f}, Mn::Vector3{0.5f}});
+  objectNode.computeCumulativeBB();
+  objectNode.translate({0.0f, -2.0f, 6.0f});
+  auto* drawable = new DummyDrawable{objectNode, &drawables};
+  CORRADE_VERIFY(!objectNode.hasStaticAbsoluteAABB());
+
+  const auto findDrawable =
+      [&](const esp::gfx::RenderCamera::DrawableTransforms& transforms) {
+        for (const auto& transform : transforms) {
+          if (std::addressof(transform.first.get()) == drawable) {
+            return Cr::Containers::optional(transform.second);
+          }
+        }
+        return Cr::Containers::Optional<Mn::Matrix4>{};
+      };
+
+  const auto before = renderCamera.visibleDrawableTransformations(drawables);
+  CORRADE_VERIFY(findDrawable(before));
+
+  // move it within the view, with the node cleaned by someone else before
+  // the next cull, e.g. SceneGraph::updateTransformations(). The camera and
+  // projection stay the same, so only the movement can invalidate the cache.
+  objectNode.translate({0.25f, 0.0f, 0.0f});
+  objectNode.setClean();
+  const auto moved = renderCamera.visibleDrawableTransformations(drawables);
+  const Cr::Containers::Optional<Mn::Matrix4> movedTransform =
+      findDrawable(moved);
+  CORRADE_VERIFY(movedTransform);
+  CORRADE_COMPARE(*movedTransform,
+                  renderCamera.cameraMatrix() *
+                      objectNode.absoluteTransformationMatrix());
+
+  // move it behind the camera
+  objectNode.translate({0.0f, 0.0f, 12.0f});
+  objectNode.setClean();
+  const auto behind = renderCamera.visibleDrawableTransformations(drawables);
+  CORRADE_VERIFY(!findDrawable(behind));
+  auto expected = renderCamera.drawableTransformations(drawables);
+  expected.erase(expected.begin() + renderCamera.cull(expected),
+                 expected.end());
+  CORRADE_COMPARE(behind.size(), expected.size());
+}
+
+void CullingTest::lightClusters() {
+  // camera at the origin looking down -Z
+  const Mn::Matrix4 cameraMatrix;
+  const Mn::Matrix4 projectionMatrix =
+      Mn::Matrix4::perspectiveProjection(90.0_degf, 16.0f / 9.0f, 0.1f, 100.0f);
+  const Mn::Vector2i viewportSize{1600, 900};
+  const esp::gfx::LightSetup lightSetup{
+      // in front of the camera, with a range of 4
+      {{0.0f, 0.0f, -10.0f, 1.0f}, Mn::Color3{1.0f / 16.0f}},
+      {{0.0f, -1.0f, 0.0f, 0.0f}, Mn::Color3{1.0f}},
+      // behind the camera, out of range of everything visible
+      {{0.0f, 0.0f, 50.0f, 1.0f}, Mn::Color3{1.0f / 16.0f}}};
+
+  esp::gfx::LightClusters clusters;
+  CORRADE_VERIFY(clusters.update(lightSetup, cameraMatrix, projectionMatrix,
+                                 viewportSize));
+  CORRADE_VERIFY(!clusters.update(lightSetup, cameraMatrix, projectionMatrix,
+                                  viewportSize));
+  CORRADE_COMPARE(clusters.clusters().size(), std::size_t{16 * 9 * 24});
+  CORRADE_COMPARE(clusters.ranges()[0], 4.0f);
+  CORRADE_COMPARE(clusters.ranges()[1], Mn::Constants::inf());
+
+  const auto lightsAt = [&](const Mn::Vector2& fragmentCoordinates,
+                            const Mn::Vector3& position) {
+    const Mn::Vector2ui cluster = clusters.clusters()[clusters.clusterIndex(
+        clusters.clusterAt(fragmentCoordinates, position))];
+    return std::vector<Mn::UnsignedInt>(
+        clusters.lightIndices().begin() + cluster.x(),
+        clusters.lightIndices().begin() + cluster.x() + cluster.y());
+  };
+
+  // the directional light reaches every cluster, the light behind the camera
+  // none
+  for (const Mn::Vector2ui cluster : clusters.clusters()) {
+    CORRADE_VERIFY(cluster.y() >= 1);
+    CORRADE_COMPARE(clusters.lightIndices()[cluster.x()], 1);
+    for (Mn::UnsignedInt i = 0; i != cluster.y(); ++i) {
+      CORRADE_VERIFY(clusters.lightIndices()[cluster.x() + i] != 2);
+    }
+  }
+
+  // next to the point light, and far behind it
+  CORRADE_COMPARE(lightsAt({800.0f, 450.0f}, {0.0f, 0.0f, -10.0f}),
+                  (std::vector<Mn::UnsignedInt>{1, 0}));
+  CORRADE_COMPARE(lightsAt({800.0f, 450.0f}, {0.0f, 0.0f, -90.0f}),
+                  (std::vector<Mn::UnsignedInt>{1}));
+  // in a corner tile at the depth of the light, more than 4 units from it
+  CORRADE_COMPARE(lightsAt({10.0f, 10.0f}, {-9.9f, -5.5f, -10.0f}),
+                  (std::vector<Mn::UnsignedInt>{1}));
+
+  // moving the camera onto the light invalidates the clusters
+  CORRADE_VERIFY(clusters.update(lightSetup,
+                                 Mn::Matrix4::translation({0.0f, 0.0f, 10.0f}),
+                                 projectionMatrix, viewportSize));
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(CullingTest)
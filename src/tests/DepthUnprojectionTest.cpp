@@ -4,7 +4,10 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/OpenGLTester.h>
@@ -20,6 +23,7 @@
 #include <Magnum/Trade/MeshData.h>
 
 #include "esp/gfx_batch/DepthUnprojection.h"
+#include "esp/gfx_batch/ShaderCache.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -36,6 +40,7 @@ struct DepthUnprojectionTest : Mn::GL::OpenGLTester {
   void testCpu();
   void testGpuDirect();
   void testGpuUnprojectExisting();
+  void testShaderCache();
 
   void benchmarkBaseline();
   void benchmarkCpu();
@@ -149,6 +154,8 @@ DepthUnprojectionTest::DepthUnprojectionTest() {
        &DepthUnprojectionTest::testGpuUnprojectExisting},
       Cr::Containers::arraySize(TestData));
 
+  addTests({&DepthUnprojectionTest::testShaderCache});
+
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkBaseline}, 10,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
@@ -265,6 +272,82 @@ void DepthUnprojectionTest::testGpuUnprojectExisting() {
                        Cr::TestSuite::Compare::around(data.depth * 0.0002f));
 }
 
+void DepthUnprojectionTest::testShaderCache() {
+  if (!isShaderCacheSupported()) {
+    CORRADE_SKIP("The driver can't retrieve program binaries.");
+  }
+
+  const std::string directory = "DepthUnprojectionTestShaderCache";
+  const auto clearDirectory = [&]() {
+    Cr::Containers::Optional<Cr::Containers::Array<Cr::Containers::String>>
+        files = Cr::Utility::Path::list(
+            directory, Cr::Utility::Path::ListFlag::SkipDotAndDotDot);
+    if (files) {
+      for (const Cr::Containers::String& file : *files) {
+        Cr::Utility::Path::remove(Cr::Utility::Path::join(directory, file));
+      }
+    }
+  };
+  clearDirectory();
+  setShaderCacheDirectory(directory);
+
+  const ShaderCacheStatistics before = shaderCacheStatistics();
+  { DepthShader shader{DepthShader::Flag::UnprojectExistingDepth}; }
+  CORRADE_COMPARE(shaderCacheStatistics().hits, before.hits);
+  CORRADE_COMPARE(shaderCacheStatistics().misses, before.misses + 1);
+
+  // the same variant is loaded, a different one is compiled
+  DepthShader shader{DepthShader::Flag::UnprojectExistingDepth};
+  CORRADE_COMPARE(shaderCacheStatistics().hits, before.hits + 1);
+  CORRADE_COMPARE(shaderCacheStatistics().misses, before.misses + 1);
+  { DepthShader other; }
+  CORRADE_COMPARE(shaderCacheStatistics().hits, before.hits + 1);
+  CORRADE_COMPARE(shaderCacheStatistics().misses, before.misses + 2);
+
+  // the loaded program works the same as a compiled one
+  const Mn::Matrix4 projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.01f, 100.0f);
+  Mn::Vector3 projected = projection.transformPoint({0.95f, -0.34f, -4.0f});
+  Mn::GL::Renderer::setClearDepth(
+      Mn::Math::lerpInverted(-1.0f, 1.0f, projected.z()));
+
+  Mn::GL::Texture2D depth;
+  depth.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+      .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+      .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+      .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, Mn::Vector2i{4});
+  Mn::GL::Framebuffer framebuffer{{{}, Mn::Vector2i{4}}};
+  framebuffer
+      .attachTexture(Mn::GL::Framebuffer::BufferAttachment::Depth, depth, 0)
+      .mapForDraw(Mn::GL::Framebuffer::DrawAttachment::None)
+      .clear(Mn::GL::FramebufferClear::Depth)
+      .bind();
+
+  Mn::GL::Texture2D output;
+  output.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
+      .setMagnificationFilter(Mn::GL::SamplerFilter::Nearest)
+      .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+      .setStorage(1, Mn::GL::TextureFormat::R32F, Mn::Vector2i{4});
+  framebuffer.detach(Mn::GL::Framebuffer::BufferAttachment::Depth)
+      .attachTexture(Mn::GL::Framebuffer::ColorAttachment{0}, output, 0)
+      .mapForDraw(Mn::GL::Framebuffer::ColorAttachment{0})
+      .clear(Mn::GL::FramebufferClear::Color);
+
+  shader.setProjectionMatrix(projection)
+      .bindDepthTexture(depth)
+      .draw(Mn::GL::Mesh{}.setCount(3));
+
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  Mn::Image2D image =
+      framebuffer.read(framebuffer.viewport(), {Mn::PixelFormat::R32F});
+  CORRADE_COMPARE_WITH(image.pixels<Mn::Float>()[2][2], 4.0f,
+                       Cr::TestSuite::Compare::around(4.0f * 0.0002f));
+
+  setShaderCacheDirectory({});
+  clearDirectory();
+}
+
 constexpr Mn::Vector2i BenchmarkSize{1536};
 
 void DepthUnprojectionTest::benchmarkBaseline() {
@@ -2,16 +2,29 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
+#include <Magnum/GL/CubeMapTexture.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/Primitives/Cube.h>
 #include <Magnum/Shaders/FlatGL.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/MeshData.h>
+#include <cstdlib>
+#include <vector>
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/BonePalette.h"
+#include "esp/gfx/CubeMap.h"
 #include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
+#include "esp/gfx/Renderer.h"
+#include "esp/gfx/TrajectoryRender.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/scene/SceneManager.h"
@@ -33,6 +46,10 @@ struct DrawableTest : Cr::TestSuite::Tester {
   explicit DrawableTest();
   // tests
   void addRemoveDrawables();
+  void drawOrder();
+  void bonePaletteRanges();
+  void trajectoryRender();
+  void gaussianFilterImplementations();
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -54,7 +71,9 @@ DrawableTest::DrawableTest() {
   auto MM = MetadataMediator::create(cfg);
   resourceManager_ = std::make_unique<ResourceManager>(MM);
   //clang-format off
-  addTests({&DrawableTest::addRemoveDrawables});
+  addTests({&DrawableTest::addRemoveDrawables, &DrawableTest::drawOrder,
+            &DrawableTest::bonePaletteRanges, &DrawableTest::trajectoryRender,
+            &DrawableTest::gaussianFilterImplementations});
   //clang-format on
   auto stageAttributesMgr = MM->getStageAttributesManager();
   std::string stageFile =
@@ -147,6 +166,258 @@ void DrawableTest::addRemoveDrawables() {
   CORRADE_VERIFY(!drawableGroup_->hasDrawable(dr->getDrawableId()));
 }
 
+void DrawableTest::drawOrder() {
+  Mn::Trade::MeshData cube = Mn::Primitives::cubeSolidStrip();
+  Mn::GL::Mesh boxes[]{Mn::MeshTools::compile(cube),
+                       Mn::MeshTools::compile(cube)};
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID_);
+  // everything created here is deleted with the parent at the end
+  esp::scene::SceneNode& parent = sceneGraph.getRootNode().createChild();
+  auto& camera = parent.createChild().addFeature<esp::gfx::RenderCamera>(
+      esp::scene::SceneNodeSemanticDataIDX::SEMANTIC_ID);
+
+  esp::gfx::DrawableGroup group;
+  esp::gfx::Drawable::Flags meshAttributeFlags{};
+  esp::gfx::DrawableConfiguration cfg{
+      esp::NO_LIGHT_KEY,
+      esp::PER_VERTEX_OBJECT_ID_MATERIAL_KEY,
+      esp::metadata::attributes::ObjectInstanceShaderType::Phong,
+      &group,    // DrawableGroup
+      nullptr,   // Skin
+      nullptr,   // PbrIBLHelper
+      nullptr};  // PbrShaderAttributes
+
+  // alternate the two meshes, same shader and material otherwise
+  std::vector<esp::gfx::GenericDrawable*> drawables;
+  for (int i = 0; i < 4; ++i) {
+    drawables.push_back(
+        &parent.createChild().addFeature<esp::gfx::GenericDrawable>(
+            &boxes[i % 2], meshAttributeFlags,
+            resourceManager_->getShaderManager(), cfg));
+  }
+  CORRADE_COMPARE(drawables[0]->getMaterialId(),
+                  drawables[1]->getMaterialId());
+  CORRADE_VERIFY(!group.hasDrawOrder());
+
+  group.prepareForDraw(camera);
+  CORRADE_VERIFY(group.hasDrawOrder());
+  // drawables with the same mesh are next to each other, keeping their
+  // relative order
+  const std::size_t first = group.drawOrderIndex(*drawables[0]);
+  const std::size_t second = group.drawOrderIndex(*drawables[1]);
+  CORRADE_COMPARE(group.drawOrderIndex(*drawables[2]), first + 1);
+  CORRADE_COMPARE(group.drawOrderIndex(*drawables[3]), second + 1);
+
+  // drawables in a frame follow the draw order
+  auto drawableTransforms = camera.filteredDrawableTransformations(group);
+  CORRADE_COMPARE(drawableTransforms.size(), 4);
+  for (std::size_t i = 1; i != drawableTransforms.size(); ++i) {
+    CORRADE_VERIFY(group.drawOrderIndex(drawableTransforms[i - 1].first) <
+                   group.drawOrderIndex(drawableTransforms[i].first));
+  }
+
+  // changing the material gives the drawable a material id of its own
+  drawables[1]->setMaterialValues(
+      resourceManager_->getShaderManager().get<Mn::Trade::MaterialData>(
+          esp::PER_VERTEX_OBJECT_ID_MATERIAL_KEY));
+  CORRADE_VERIFY(drawables[0]->getMaterialId() !=
+                 drawables[1]->getMaterialId());
+
+  // adding or removing drawables invalidates the order
+  delete drawables[3];
+  CORRADE_VERIFY(!group.hasDrawOrder());
+  group.prepareForDraw(camera);
+  CORRADE_VERIFY(group.hasDrawOrder());
+
+  delete &parent;
+}
+
+void DrawableTest::bonePaletteRanges() {
+  esp::gfx::BonePalette palette;
+  const int a = palette.addRange(3);
+  const int b = palette.addRange(5);
+  CORRADE_COMPARE(palette.rangeCount(), 2);
+  CORRADE_COMPARE(palette.matrices().size(), 8);
+  CORRADE_COMPARE(palette.rangeOffset(a), 0);
+  CORRADE_COMPARE(palette.rangeOffset(b), 3);
+  CORRADE_COMPARE(palette.range(b).size(), 5);
+  CORRADE_COMPARE(palette.range(b)[4], Mn::Matrix4{});
+
+  // ranges are views into the packed palette
+  palette.range(b)[0] = Mn::Matrix4::translation({1.0f, 2.0f, 3.0f});
+  CORRADE_COMPARE(palette.matrices()[3],
+                  Mn::Matrix4::translation({1.0f, 2.0f, 3.0f}));
+
+  // a removed range is reused by a later one that fits, reset to identity
+  palette.removeRange(b);
+  CORRADE_COMPARE(palette.rangeCount(), 1);
+  const int c = palette.addRange(4);
+  CORRADE_COMPARE(c, b);
+  CORRADE_COMPARE(palette.rangeOffset(c), 3);
+  CORRADE_COMPARE(palette.range(c).size(), 4);
+  CORRADE_COMPARE(palette.range(c)[0], Mn::Matrix4{});
+  CORRADE_COMPARE(palette.matrices().size(), 8);
+
+  // one that doesn't fit goes to the end
+  const int d = palette.addRange(6);
+  CORRADE_COMPARE(palette.rangeOffset(d), 8);
+  CORRADE_COMPARE(palette.matrices().size(), 14);
+  CORRADE_COMPARE(palette.rangeCount(), 3);
+}
+
+void DrawableTest::trajectoryRender() {
+  esp::gfx::TrajectoryRender render;
+  const int a = render.addTrajectory(
+      {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+      Mn::Color4{1.0f}, 0.05f);
+  const int b = render.addTrajectory({{0.0f, 0.0f, 0.0f}}, Mn::Color4{1.0f},
+                                     0.05f);
+  CORRADE_COMPARE(render.trajectoryCount(), 2);
+  CORRADE_COMPARE(render.segmentCount(), 2);
+
+  // a single point makes no segment yet, every further one adds one, also
+  // past the initially reserved capacity
+  std::vector<Mn::Vector3> points;
+  for (int i = 0; i != 40; ++i) {
+    points.emplace_back(float(i), 2.0f, 0.0f);
+  }
+  const std::uint64_t revision = render.revision();
+  render.appendPoints(b, points);
+  CORRADE_COMPARE(render.segmentCount(), 42);
+  CORRADE_VERIFY(render.revision() != revision);
+
+  render.removeTrajectory(a);
+  CORRADE_VERIFY(!render.hasTrajectory(a));
+  CORRADE_VERIFY(render.hasTrajectory(b));
+  CORRADE_COMPARE(render.segmentCount(), 40);
+
+  // IDs aren't reused
+  const int c = render.addTrajectory({}, Mn::Color4{1.0f}, 0.05f);
+  CORRADE_VERIFY(c != a && c != b);
+
+  render.clear();
+  CORRADE_COMPARE(render.trajectoryCount(), 0);
+  CORRADE_COMPARE(render.segmentCount(), 0);
+}
+
+void DrawableTest::gaussianFilterImplementations() {
+#ifdef MAGNUM_TARGET_GLES
+  CORRADE_SKIP("Compute shaders aren't supported on OpenGL ES.");
+#else
+  if (!esp::gfx::Renderer::isGaussianFilterComputeSupported()) {
+    CORRADE_SKIP("Compute shaders aren't supported, nothing to compare.");
+  }
+  using esp::gfx::CubeMap;
+
+  // sharp edges everywhere, including along the face borders, where the
+  // compute shader clamps the texel index and the fragment shader samples
+  // with ClampToEdge. Blue stays zero, as the fragment implementation filters
+  // every face through a two-channel texture.
+  constexpr int size = 32;
+  std::vector<Mn::Color4ub> source(6 * size * size);
+  for (int face = 0; face != 6; ++face) {
+    for (int y = 0; y != size; ++y) {
+      for (int x = 0; x != size; ++x) {
+        source[(face * size + y) * size + x] = {
+            Mn::UnsignedByte((x / 3 + y / 5 + face) % 2 * 255),
+            Mn::UnsignedByte(x * 8 + face * 13), 0, 255};
+      }
+    }
+  }
+
+  // the same separable kernel on the CPU, rounded to 8 bits after each pass
+  // like the helper cubemap does
+  const float weights[]{0.2270270270f, 0.3162162162f, 0.0702702703f};
+  const auto filter = [&](const std::vector<Mn::Color4ub>& input,
+                          Mn::Vector2i direction) {
+    std::vector<Mn::Color4ub> output(input.size());
+    for (int face = 0; face != 6; ++face) {
+      for (int y = 0; y != size; ++y) {
+        for (int x = 0; x != size; ++x) {
+          Mn::Vector3 result;
+          for (int i = -2; i <= 2; ++i) {
+            const Mn::Vector2i texel = Mn::Math::clamp(
+                Mn::Vector2i{x, y} + direction * i, Mn::Vector2i{0},
+                Mn::Vector2i{size - 1});
+            result +=
+                Mn::Math::unpack<Mn::Vector3>(
+                    input[(face * size + texel.y()) * size + texel.x()].rgb()) *
+                weights[std::abs(i)];
+          }
+          output[(face * size + y) * size + x] = {
+              Mn::Math::pack<Mn::Vector3ub>(result), 255};
+        }
+      }
+    }
+    return output;
+  };
+  const std::vector<Mn::Color4ub> expected =
+      filter(filter(source, Mn::Vector2i::xAxis(1)), Mn::Vector2i::yAxis(1));
+
+  std::shared_ptr<esp::gfx::Renderer> renderer = esp::gfx::Renderer::create();
+  const auto filterOnGpu =
+      [&](esp::gfx::Renderer::GaussianFilterImplementation implementation) {
+        CubeMap target{size};
+        CubeMap helper{size};
+        Mn::GL::CubeMapTexture& texture =
+            target.getTexture(CubeMap::TextureType::Color);
+        for (int face = 0; face != 6; ++face) {
+          texture.setSubImage(
+              Mn::GL::CubeMapCoordinate(
+                  int(Mn::GL::CubeMapCoordinate::PositiveX) + face),
+              0, {},
+              Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                              {size, size},
+                              Cr::Containers::arrayView(
+                                  source.data() + face * size * size,
+                                  size * size)});
+        }
+        renderer->setGaussianFilterImplementation(implementation);
+        renderer->applyGaussianFiltering(target, helper,
+                                         CubeMap::TextureType::Color);
+
+        std::vector<Mn::Color4ub> output;
+        output.reserve(source.size());
+        for (int face = 0; face != 6; ++face) {
+          Mn::Image2D image = texture.image(
+              Mn::GL::CubeMapCoordinate(
+                  int(Mn::GL::CubeMapCoordinate::PositiveX) + face),
+              0, {Mn::PixelFormat::RGBA8Unorm});
+          for (const auto row : image.pixels<Mn::Color4ub>()) {
+            for (const Mn::Color4ub& pixel : row) {
+              output.push_back(pixel);
+            }
+          }
+        }
+        return output;
+      };
+  const std::vector<Mn::Color4ub> compute =
+      filterOnGpu(esp::gfx::Renderer::GaussianFilterImplementation::Compute);
+  const std::vector<Mn::Color4ub> fragment =
+      filterOnGpu(esp::gfx::Renderer::GaussianFilterImplementation::Fragment);
+  CORRADE_COMPARE(compute.size(), expected.size());
+  CORRADE_COMPARE(fragment.size(), expected.size());
+
+  // both round differently in each of the two passes
+  const auto closeTo = [](const Mn::Color4ub& a, const Mn::Color4ub& b) {
+    return (Mn::Math::abs(Mn::Vector4i{a} - Mn::Vector4i{b}) <=
+            Mn::Vector4i{2})
+        .all();
+  };
+  for (int face = 0; face != 6; ++face) {
+    for (int y = 0; y != size; ++y) {
+      for (int x = 0; x != size; ++x) {
+        CORRADE_ITERATION(face << ":" << x << y);
+        const std::size_t i = (face * size + y) * size + x;
+        CORRADE_VERIFY(closeTo(compute[i], expected[i]));
+        CORRADE_VERIFY(closeTo(fragment[i], expected[i]));
+        CORRADE_VERIFY(closeTo(compute[i], fragment[i]));
+      }
+    }
+  }
+#endif
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(DrawableTest)
@@ -2,16 +2,22 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include "esp/core/Utility.h"
 #include "esp/geo/CoordinateFrame.h"
 #include "esp/geo/Geo.h"
 #include "esp/geo/OBB.h"
+#include "esp/geo/OccupancyGrid.h"
+
+#include "configure.h"
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -28,7 +34,11 @@ struct GeoTest : Cr::TestSuite::Tester {
   void aabb();
   void obbConstruction();
   void obbFunctions();
+  void minVolumeOBB();
   void coordinateFrame();
+  void adjacencyComponents();
+  void batchFunctions();
+  void occupancyGrid();
   // benchmarks
   void getTransformedBB_standard();
   void getTransformedBB();
@@ -52,7 +62,11 @@ GeoTest::GeoTest() {
   addTests({&GeoTest::aabb,
             &GeoTest::obbConstruction,
             &GeoTest::obbFunctions,
-            &GeoTest::coordinateFrame});
+            &GeoTest::minVolumeOBB,
+            &GeoTest::coordinateFrame,
+            &GeoTest::adjacencyComponents,
+            &GeoTest::batchFunctions,
+            &GeoTest::occupancyGrid});
   addBenchmarks({&GeoTest::getTransformedBB_standard,
                  &GeoTest::getTransformedBB}, 10);
   // clang-format on
@@ -122,6 +136,135 @@ void GeoTest::aabb() {
   }
 }
 
+void GeoTest::batchFunctions() {
+  // an odd count so the vectorized loops have a remainder
+  std::vector<Mn::Vector3> points;
+  for (int i = 0; i != 1003; ++i) {
+    points.emplace_back((rand() % 2000) / 100.0f - 10.0f,
+                        (rand() % 2000) / 100.0f - 10.0f,
+                        (rand() % 2000) / 100.0f - 10.0f);
+  }
+  // a point exactly on the box boundary counts as inside
+  points[7] = {5.0f, -5.0f, 0.0f};
+  const Cr::Containers::ArrayView<const Mn::Vector3> view =
+      Cr::Containers::arrayView(points);
+
+  CORRADE_COMPARE(esp::geo::computeAABB(view),
+                  Mn::Range3D{Mn::Math::minmax(points)});
+  // every other point, which is not contiguous
+  const Cr::Containers::StridedArrayView1D<const Mn::Vector3> strided =
+      Cr::Containers::StridedArrayView1D<const Mn::Vector3>{view}.every(2);
+  CORRADE_COMPARE(esp::geo::computeAABB(strided),
+                  Mn::Range3D{Mn::Math::minmax(strided)});
+  CORRADE_COMPARE(esp::geo::computeAABB(
+                      Cr::Containers::StridedArrayView1D<const Mn::Vector3>{}),
+                  Mn::Range3D{});
+
+  const std::vector<uint32_t> indices{3, 900, 17, 3};
+  CORRADE_COMPARE(
+      esp::geo::computeAABB(view, indices),
+      (Mn::Range3D{Mn::Math::min(points[3], Mn::Math::min(points[900],
+                                                          points[17])),
+                   Mn::Math::max(points[3], Mn::Math::max(points[900],
+                                                          points[17]))}));
+
+  const Mn::Matrix4& xform = xforms_[0];
+  std::vector<Mn::Vector3> transformed = points;
+  esp::geo::transformPoints(xform, view,
+                            Cr::Containers::arrayView(transformed));
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(transformed[i], xform.transformPoint(points[i]));
+  }
+  const Mn::Range3D transformedAABB =
+      esp::geo::computeTransformedAABB(xform, view);
+  CORRADE_COMPARE(transformedAABB, Mn::Range3D{Mn::Math::minmax(transformed)});
+
+  const Mn::Range3D box{{-5.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f}};
+  Cr::Containers::Array<bool> inside{Cr::Containers::NoInit, points.size()};
+  std::size_t expectedCount = 0;
+  const std::size_t count = esp::geo::pointsInAABB(box, view, inside);
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const bool expected = (points[i] >= box.min()).all() &&
+                          (points[i] <= box.max()).all();
+    expectedCount += expected;
+    CORRADE_COMPARE(inside[i], expected);
+  }
+  CORRADE_COMPARE(count, expectedCount);
+  CORRADE_VERIFY(inside[7]);
+}
+
+void GeoTest::occupancyGrid() {
+  // a horizontal square not touching the voxel boundaries in X and Z, in the
+  // middle of the y=0 voxel layer
+  const Mn::Vector3 positions[]{{0.01f, 0.05f, 0.01f},
+                                {0.99f, 0.05f, 0.01f},
+                                {0.99f, 0.05f, 0.99f},
+                                {0.01f, 0.05f, 0.99f}};
+  const std::uint32_t indices[]{0, 1, 2, 0, 2, 3};
+
+  OccupancyGrid grid{0.1f};
+  grid.setSource(1, positions, indices);
+  CORRADE_COMPARE(grid.sourceCount(), 1);
+  CORRADE_COMPARE(grid.occupiedVoxelCount(), 100);
+  CORRADE_COMPARE(grid.sourceVoxels(1).front(), (Mn::Vector3i{0, 0, 0}));
+  CORRADE_COMPARE(grid.sourceVoxels(1).back(), (Mn::Vector3i{9, 0, 9}));
+  CORRADE_VERIFY(grid.isOccupied({0.5f, 0.05f, 0.5f}));
+  CORRADE_VERIFY(!grid.isOccupied({0.5f, 0.15f, 0.5f}));
+  CORRADE_VERIFY(!grid.isOccupied({1.05f, 0.05f, 0.5f}));
+
+  // the same square moved below zero, with more threads than tasks
+  grid.setSource(2, positions, indices,
+                 Mn::Matrix4::translation({0.0f, -0.1f, 0.0f}), 4);
+  CORRADE_COMPARE(grid.occupiedVoxelCount(), 200);
+  CORRADE_VERIFY(grid.isOccupied({0.5f, -0.05f, 0.5f}));
+
+  // replacing a source with geometry overlapping another keeps the shared
+  // voxels occupied once
+  grid.setSource(2, positions, indices);
+  CORRADE_COMPARE(grid.sourceCount(), 2);
+  CORRADE_COMPARE(grid.occupiedVoxelCount(), 100);
+  CORRADE_VERIFY(grid.removeSource(1));
+  CORRADE_VERIFY(!grid.removeSource(1));
+  CORRADE_COMPARE(grid.occupiedVoxelCount(), 100);
+  CORRADE_VERIFY(grid.isOccupied({0.5f, 0.05f, 0.5f}));
+
+  const Mn::Vector3 points[]{{0.5f, 0.05f, 0.5f}, {0.5f, -0.05f, 0.5f}};
+  bool occupied[2];
+  grid.isOccupied(points, occupied);
+  CORRADE_VERIFY(occupied[0]);
+  CORRADE_VERIFY(!occupied[1]);
+
+  const Mn::Range3D boxes[]{{{0.4f, 0.2f, 0.4f}, {0.6f, 0.4f, 0.6f}},
+                            {{-5.0f, -5.0f, -5.0f}, {5.0f, 0.05f, 5.0f}},
+                            {{-5.0f, -5.0f, -5.0f}, {5.0f, -0.15f, 5.0f}}};
+  bool boxOccupied[3];
+  grid.isBoxOccupied(boxes, boxOccupied);
+  CORRADE_VERIFY(!boxOccupied[0]);
+  CORRADE_VERIFY(boxOccupied[1]);
+  CORRADE_VERIFY(!boxOccupied[2]);
+
+  // a saved source loads back only into a grid of the same voxel size
+  const std::string filename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "GeoTestOccupancyGrid.bin");
+  CORRADE_VERIFY(grid.saveSource(2, filename));
+  OccupancyGrid loaded{0.1f};
+  CORRADE_VERIFY(loaded.loadSource(7, filename));
+  CORRADE_COMPARE_AS(loaded.sourceVoxels(7), grid.sourceVoxels(2),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(loaded.occupiedVoxelCount(), 100);
+  OccupancyGrid coarser{0.2f};
+  CORRADE_VERIFY(!coarser.loadSource(7, filename));
+  CORRADE_COMPARE(coarser.sourceCount(), 0);
+  CORRADE_VERIFY(Cr::Utility::Path::remove(filename));
+
+  grid.clear();
+  CORRADE_COMPARE(grid.occupiedVoxelCount(), 0);
+  CORRADE_COMPARE(grid.blockCount(), 0);
+  CORRADE_VERIFY(!grid.isOccupied({0.5f, 0.05f, 0.5f}));
+}
+
 void GeoTest::obbConstruction() {
   OBB obb1;
   const vec3f center(0, 0, 0);
@@ -166,6 +309,41 @@ void GeoTest::obbFunctions() {
   CORRADE_COMPARE_AS(obb2.distance(vec3f(-10, -5, 2)), 1, float);
 }
 
+void GeoTest::minVolumeOBB() {
+  // corners and face centers of a 4x2x1 box, rotated off all world axes
+  const quatf rot = quatf(Eigen::AngleAxisf(0.6f, vec3f::UnitX())) *
+                    quatf(Eigen::AngleAxisf(-0.4f, vec3f::UnitY())) *
+                    quatf(Eigen::AngleAxisf(1.1f, vec3f::UnitZ()));
+  const vec3f center(3, -1, 2);
+  const vec3f halfExtents(2, 1, 0.5);
+  std::vector<vec3f> points;
+  for (int x = -1; x <= 1; ++x) {
+    for (int y = -1; y <= 1; ++y) {
+      for (int z = -1; z <= 1; ++z) {
+        points.emplace_back(center +
+                            rot * vec3f(x, y, z).cwiseProduct(halfExtents));
+      }
+    }
+  }
+
+  const OBB obb = computeMinVolumeOBB(points);
+  CORRADE_COMPARE_WITH(obb.volume(), 8.0f,
+                       Cr::TestSuite::Compare::around(0.01f));
+  CORRADE_VERIFY(obb.center().isApprox(center, 1e-4f));
+  box3f aabb;
+  for (const vec3f& point : points) {
+    CORRADE_VERIFY(obb.distance(point) < 1e-4f);
+    aabb.extend(point);
+  }
+  CORRADE_VERIFY(obb.volume() < OBB(aabb).volume());
+
+  // degenerate inputs fall back to an empty box or the AABB
+  CORRADE_COMPARE(computeMinVolumeOBB({}).volume(), 0.0f);
+  const std::vector<vec3f> segment{vec3f(0, 0, 0), vec3f(1, 1, 1)};
+  CORRADE_VERIFY(computeMinVolumeOBB(segment).center().isApprox(
+      vec3f(0.5, 0.5, 0.5)));
+}
+
 void GeoTest::coordinateFrame() {
   const vec3f origin(1, -2, 3);
   const vec3f up(0, 0, 1);
@@ -201,6 +379,68 @@ void GeoTest::coordinateFrame() {
   CORRADE_COMPARE(c1.toString(), j);
 }
 
+void GeoTest::adjacencyComponents() {
+  // two quads sharing no verts, plus an isolated vert 8. The first quad has
+  // one vert of a different color, splitting it.
+  const std::vector<uint32_t> indices{0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+  const AdjacencyList adjList = buildAdjList(9, indices);
+  CORRADE_COMPARE(adjList.size(), 9);
+  // rows are sorted and the shared diagonal edge isn't duplicated
+  CORRADE_COMPARE_AS(
+      Cr::Containers::arrayView(adjList.neighbors)
+          .slice(adjList.offsets[0], adjList.offsets[1]),
+      Cr::Containers::arrayView<uint32_t>({1, 2, 3}),
+      Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(
+      Cr::Containers::arrayView(adjList.neighbors)
+          .slice(adjList.offsets[1], adjList.offsets[2]),
+      Cr::Containers::arrayView<uint32_t>({0, 2}),
+      Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(adjList.offsets[8], adjList.offsets[9]);
+  CORRADE_COMPARE(adjList.neighbors.size(), 20);
+
+  const std::vector<int> colors{1, 1, 2, 1, 1, 1, 1, 1, 3};
+  const auto clrsToComponents = findCCsByGivenColor(adjList, colors);
+  CORRADE_COMPARE(clrsToComponents.size(), 3);
+  // {0, 1, 3} and {4, 5, 6, 7} share a color but aren't connected
+  CORRADE_COMPARE(clrsToComponents.at(1).size(), 2);
+  CORRADE_VERIFY(clrsToComponents.at(1)[0] == (std::set<uint32_t>{0, 1, 3}));
+  CORRADE_VERIFY(clrsToComponents.at(1)[1] ==
+                 (std::set<uint32_t>{4, 5, 6, 7}));
+  CORRADE_VERIFY(clrsToComponents.at(2)[0] == (std::set<uint32_t>{2}));
+  CORRADE_VERIFY(clrsToComponents.at(3)[0] == (std::set<uint32_t>{8}));
+
+  // large enough to be split across threads: a strip of quads, colored in
+  // bands of two quads, so every band is its own CC
+  const uint32_t numQuads = 100000;
+  std::vector<uint32_t> stripIndices;
+  std::vector<int> stripColors;
+  for (uint32_t i = 0; i != numQuads; ++i) {
+    const uint32_t v = i * 4;
+    stripIndices.insert(stripIndices.end(),
+                        {v, v + 1, v + 2, v, v + 2, v + 3});
+    stripColors.insert(stripColors.end(), 4, i / 2 % 5);
+  }
+  // connect each quad to the next one
+  for (uint32_t i = 0; i + 1 != numQuads; ++i) {
+    const uint32_t v = i * 4;
+    stripIndices.insert(stripIndices.end(), {v + 2, v + 4, v + 3});
+  }
+  const auto stripCCs = findCCsByGivenColor(
+      buildAdjList(numQuads * 4, stripIndices), stripColors);
+  CORRADE_COMPARE(stripCCs.size(), 5);
+  std::size_t numCCs = 0;
+  for (const auto& elem : stripCCs) {
+    numCCs += elem.second.size();
+    for (const std::set<uint32_t>& cc : elem.second) {
+      CORRADE_COMPARE(cc.size(), 8);
+    }
+  }
+  CORRADE_COMPARE(numCCs, numQuads / 2);
+  CORRADE_VERIFY(stripCCs.at(0)[0] ==
+                 (std::set<uint32_t>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(GeoTest)
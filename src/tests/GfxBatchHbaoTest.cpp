@@ -103,6 +103,14 @@ struct GfxBatchHbaoTest : Mn::GL::OpenGLTester {
    */
   void testOrthographic();
 
+  /**
+   * @brief Test a perspective and an orthographic projection side by side in
+   * a single tiled framebuffer
+   */
+  void testTiled();
+
+  void testTemporal();
+
   /// @brief Benchmarks ///
   /**
    * @brief Benchmark synthesizing HBAO effect
@@ -251,6 +259,48 @@ TestDataType BenchData[]{
          .setUseLayeredGeometryShader(true)
          .setUseSpecialBlur(true),
      1.0f, 0.1f},
+    {"cache-aware, layered with geometry shader, AO special blur, half "
+     "resolution",
+     "hbao-cache-geom-sblur", esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}
+         .setUseLayeredGeometryShader(true)
+         .setUseSpecialBlur(true)
+         .setResolution(esp::gfx_batch::HbaoResolution::Half),
+     1.0f, 0.1f},
+    {"cache-aware, layered with geometry shader, AO special blur, quarter "
+     "resolution",
+     "hbao-cache-geom-sblur", esp::gfx_batch::HbaoType::CacheAware,
+     esp::gfx_batch::HbaoConfiguration{}
+         .setUseLayeredGeometryShader(true)
+         .setUseSpecialBlur(true)
+         .setResolution(esp::gfx_batch::HbaoResolution::Quarter),
+     1.0f, 0.1f},
+};
+
+const TestDataType TiledData[]{
+    {"classic, defaults", "hbao-classic", esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}, 1.0f, 0.1f},
+    {"classic, AO special blur", "hbao-classic-sblur",
+     esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}.setUseSpecialBlur(true), 1.0f, 0.1f},
+};
+
+// The accumulated result is an average of the partial results, which differs
+// from computing all directions at once by the intensity exponent applied to
+// each part and by the rounding of the history
+const TestDataType TemporalData[]{
+    {"classic, two frames", "hbao-classic", esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}.setTemporalFrameCount(2), 24.0f,
+     0.75f},
+    {"classic, four frames", "hbao-classic", esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}.setTemporalFrameCount(4), 24.0f,
+     0.75f},
+    {"classic, four frames, AO special blur", "hbao-classic-sblur",
+     esp::gfx_batch::HbaoType::Classic,
+     esp::gfx_batch::HbaoConfiguration{}
+         .setUseSpecialBlur(true)
+         .setTemporalFrameCount(4),
+     24.0f, 0.75f},
 };
 
 const struct {
@@ -274,6 +324,12 @@ GfxBatchHbaoTest::GfxBatchHbaoTest() {
                      &GfxBatchHbaoTest::testOrthographic},
                     Cr::Containers::arraySize(TestData));
 
+  addInstancedTests({&GfxBatchHbaoTest::testTiled},
+                    Cr::Containers::arraySize(TiledData));
+
+  addInstancedTests({&GfxBatchHbaoTest::testTemporal},
+                    Cr::Containers::arraySize(TemporalData));
+
   addInstancedBenchmarks({&GfxBatchHbaoTest::benchmarkPerspective,
                           &GfxBatchHbaoTest::benchmarkOrthographic},
                          5, Cr::Containers::arraySize(BenchData),
@@ -533,6 +589,147 @@ void GfxBatchHbaoTest::testOrthographic() {
 
 }  // GfxBatchHbaoTest::testOrthographic()
 
+void GfxBatchHbaoTest::testTiled() {
+  auto&& data = TiledData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      importerManager.loadAndInstantiate("AnyImageImporter");
+  CORRADE_VERIFY(importer);
+
+  const Mn::Vector2i tiledSize = Size * Mn::Vector2i{2, 1};
+  Mn::GL::Texture2D inputDepthTexture;
+  Mn::GL::Texture2D outputColorTexture;
+  inputDepthTexture.setStorage(1, Mn::GL::TextureFormat::DepthComponent32F,
+                               tiledSize);
+  outputColorTexture.setStorage(1, Mn::GL::TextureFormat::RGBA8, tiledSize);
+
+  /* Perspective on the left, orthographic on the right */
+  const Projection* const projData[]{&perspectiveData, &orthographicData};
+  for (std::size_t i = 0; i != 2; ++i) {
+    CORRADE_ITERATION(i);
+    const Mn::Vector2i offset{Mn::Int(i) * Size.x(), 0};
+
+    if (!importer->openFile(Cr::Utility::Path::join(
+            testHBAOImageDir, projData[i]->sourceColorFilename))) {
+      CORRADE_FAIL("Cannot load the color image");
+    }
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> color =
+        importer->image2D(0);
+    CORRADE_VERIFY(color);
+    CORRADE_COMPARE(color->size(), Size);
+    outputColorTexture.setSubImage(0, offset, *color);
+
+    if (!importer->openFile(Cr::Utility::Path::join(
+            testHBAOImageDir, projData[i]->sourceDepthFilename))) {
+      CORRADE_FAIL("Cannot load the depth image");
+    }
+    Cr::Containers::Optional<Mn::Trade::ImageData2D> depth =
+        importer->image2D(0);
+    CORRADE_VERIFY(depth);
+    CORRADE_COMPARE(depth->size(), Size);
+    inputDepthTexture.setSubImage(0, offset, *depth);
+  }
+
+  Mn::GL::Framebuffer output{{{}, tiledSize}};
+  output.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
+                       outputColorTexture, 0);
+
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  esp::gfx_batch::Hbao hbao{esp::gfx_batch::HbaoConfiguration{data.config}
+                                .setSize(tiledSize)
+                                .setTileCount({2, 1})};
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  const Mn::Matrix4 projections[]{perspectiveData.projection,
+                                  orthographicData.projection};
+  hbao.drawEffect(projections, inputDepthTexture, output);
+
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  /* Each tile should be the same as if rendered alone */
+  CORRADE_COMPARE_WITH(
+      output.read({{}, Size}, {Mn::PixelFormat::RGBA8Unorm}),
+      Cr::Utility::Path::join(
+          testHBAOImageDir,
+          Cr::Utility::format("{}.{}.png", baseTestFilename, data.filename)),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+  CORRADE_COMPARE_WITH(
+      output.read({{Size.x(), 0}, tiledSize}, {Mn::PixelFormat::RGBA8Unorm}),
+      Cr::Utility::Path::join(testHBAOImageDir,
+                              Cr::Utility::format("{}.{}-ortho.png",
+                                                  baseTestFilename,
+                                                  data.filename)),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+}  // GfxBatchHbaoTest::testTiled()
+
+void GfxBatchHbaoTest::testTemporal() {
+  auto&& data = TemporalData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager;
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      importerManager.loadAndInstantiate("AnyImageImporter");
+  CORRADE_VERIFY(importer);
+
+  if (!importer->openFile(Cr::Utility::Path::join(
+          testHBAOImageDir, perspectiveData.sourceColorFilename))) {
+    CORRADE_FAIL("Cannot load the color image");
+  }
+  Cr::Containers::Optional<Mn::Trade::ImageData2D> color = importer->image2D(0);
+  CORRADE_VERIFY(color);
+  CORRADE_COMPARE(color->size(), Size);
+
+  if (!importer->openFile(Cr::Utility::Path::join(
+          testHBAOImageDir, perspectiveData.sourceDepthFilename))) {
+    CORRADE_FAIL("Cannot load the depth image");
+  }
+  Cr::Containers::Optional<Mn::Trade::ImageData2D> depth = importer->image2D(0);
+  CORRADE_VERIFY(depth);
+  CORRADE_COMPARE(depth->size(), Size);
+
+  Mn::GL::Texture2D inputDepthTexture;
+  Mn::GL::Texture2D outputColorTexture;
+  inputDepthTexture
+      .setStorage(1, Mn::GL::TextureFormat::DepthComponent32F, Size)
+      .setSubImage(0, {}, *depth);
+  outputColorTexture.setStorage(1, Mn::GL::TextureFormat::RGBA8, Size);
+
+  Mn::GL::Framebuffer output{{{}, Size}};
+  output.attachTexture(Mn::GL::Framebuffer::ColorAttachment{0},
+                       outputColorTexture, 0);
+
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  esp::gfx_batch::Hbao hbao{
+      esp::gfx_batch::HbaoConfiguration{data.config}.setSize(Size)};
+  MAGNUM_VERIFY_NO_GL_ERROR();
+
+  /* With a static camera, all directions are computed after the configured
+     count of frames. The effect is blended onto the color, so reupload it
+     before each frame. */
+  const Mn::Matrix4 cameraMatrix = Mn::Matrix4::translation({0.5f, 0.0f, 0.0f});
+  for (Mn::Int i = 0; i != data.config.temporalFrameCount(); ++i) {
+    CORRADE_ITERATION(i);
+    outputColorTexture.setSubImage(0, {}, *color);
+    hbao.drawEffect(perspectiveData.projection, cameraMatrix,
+                    inputDepthTexture, output);
+    MAGNUM_VERIFY_NO_GL_ERROR();
+  }
+
+  CORRADE_COMPARE_WITH(
+      output.read({{}, Size}, {Mn::PixelFormat::RGBA8Unorm}),
+      Cr::Utility::Path::join(
+          testHBAOImageDir,
+          Cr::Utility::format("{}.{}.png", baseTestFilename, data.filename)),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+}  // GfxBatchHbaoTest::testTemporal()
+
 void GfxBatchHbaoTest::testPerspectiveFlipped() {
   auto&& data = TestData[testCaseInstanceId()];
   setTestCaseDescription(
@@ -28,9 +28,11 @@
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/SceneData.h>
 #include <Magnum/Trade/TextureData.h>
+#include <sstream>
 
 #include <esp/gfx_batch/DepthUnprojection.h>
 #include "Corrade/TestSuite/Compare/Numeric.h"
+#include "esp/gfx_batch/CompositeConverter.h"
 #include "esp/gfx_batch/RendererStandalone.h"
 
 #ifdef ESP_BUILD_WITH_CUDA
@@ -59,17 +61,24 @@ struct GfxBatchRendererTest : Cr::TestSuite::Tester {
 
   void singleMesh();
   void meshHierarchy();
+  void compositeConverter();
   void multipleMeshes();
 
   void renderNoFileAdded();
   void multipleScenes();
   void clearScene();
+  void removeNodeHierarchy();
+  void frustumCulling();
+  void tileSizes();
 
   void lights();
   void clearLights();
 
   void imageInto();
+  void textureMemoryBudget();
   void depthUnprojection();
+  void depthUnprojectionGpu();
+  void depthOnlyObjectId();
   void cudaInterop();
 };
 
@@ -206,6 +215,15 @@ const struct {
     {"batch.gltf", {}, nullptr}}},
     esp::gfx_batch::RendererFlag::NoTextures, 5, 4, 1, 1.0f,
     "GfxBatchRendererTestMeshHierarchyNoTextures.png"},
+  {"memory-mapped", {Cr::InPlaceInit, {
+    {"batch.gltf", {}, nullptr}}},
+    esp::gfx_batch::RendererFlag::MemoryMapFiles, 5, 4, 1, 0xcc/255.0f,
+    "GfxBatchRendererTestMeshHierarchy.png"},
+  {"multiple files, memory-mapped", {Cr::InPlaceInit, {
+    {"batch-square-circle-triangle.gltf", {}, nullptr},
+    {"batch-four-squares.gltf", {}, nullptr}}},
+    esp::gfx_batch::RendererFlag::MemoryMapFiles, 5, 4, 4, 0xcc/255.0f,
+    "GfxBatchRendererTestMeshHierarchy.png"},
   {"multiple meshes, no textures", {Cr::InPlaceInit, {
     {"batch-multiple-meshes.gltf", {}, nullptr}}},
     esp::gfx_batch::RendererFlag::NoTextures, 5, 4, 4, 1.0f,
@@ -219,6 +237,15 @@ const struct {
     "GfxBatchRendererTestMeshHierarchyNoTextures.png"},
 };
 
+const struct {
+  const char* name;
+  bool quantize;
+  const char* filename;
+} CompositeConverterData[]{
+  {"", false, "batch-composite.gltf"},
+  {"quantized vertex attributes", true, "batch-composite-quantized.gltf"},
+};
+
 const struct {
   const char* name;
   Mn::UnsignedInt maxLightCount;
@@ -265,6 +292,14 @@ const struct {
     "flat checkerboard sphere",
     "GfxBatchRendererTestLightsDisabled.png"},
 };
+
+const struct {
+  const char* name;
+  esp::gfx_batch::RendererStandaloneFlags flags;
+} DepthUnprojectionGpuData[]{
+  {"camera frame", {}},
+  {"world frame", esp::gfx_batch::RendererStandaloneFlag::PointCloudWorldFrame},
+};
 // clang-format on
 
 GfxBatchRendererTest::GfxBatchRendererTest() {
@@ -284,11 +319,17 @@ GfxBatchRendererTest::GfxBatchRendererTest() {
   addInstancedTests({&GfxBatchRendererTest::meshHierarchy},
       Cr::Containers::arraySize(MeshHierarchyData));
 
+  addInstancedTests({&GfxBatchRendererTest::compositeConverter},
+      Cr::Containers::arraySize(CompositeConverterData));
+
   addTests({&GfxBatchRendererTest::renderNoFileAdded});
 
   addInstancedTests({&GfxBatchRendererTest::multipleMeshes,
                      &GfxBatchRendererTest::multipleScenes,
-                     &GfxBatchRendererTest::clearScene},
+                     &GfxBatchRendererTest::clearScene,
+                     &GfxBatchRendererTest::removeNodeHierarchy,
+                     &GfxBatchRendererTest::frustumCulling,
+                     &GfxBatchRendererTest::tileSizes},
       Cr::Containers::arraySize(FileData));
 
   addInstancedTests({&GfxBatchRendererTest::lights},
@@ -296,8 +337,15 @@ GfxBatchRendererTest::GfxBatchRendererTest() {
 
   addTests({&GfxBatchRendererTest::clearLights,
             &GfxBatchRendererTest::imageInto,
-            &GfxBatchRendererTest::depthUnprojection,
-            &GfxBatchRendererTest::cudaInterop});
+            &GfxBatchRendererTest::textureMemoryBudget,
+            &GfxBatchRendererTest::depthUnprojection});
+
+  addInstancedTests({&GfxBatchRendererTest::depthUnprojectionGpu},
+      Cr::Containers::arraySize(DepthUnprojectionGpuData));
+
+  addTests({&GfxBatchRendererTest::depthOnlyObjectId});
+
+  addTests({&GfxBatchRendererTest::cudaInterop});
   // clang-format on
 }
 
@@ -1476,6 +1524,7 @@ void GfxBatchRendererTest::defaults() {
   CORRADE_COMPARE(renderer.tileSize(), (Mn::Vector2i{48, 32}));
   CORRADE_COMPARE(renderer.tileCount(), (Mn::Vector2i{2, 3}));
   CORRADE_COMPARE(renderer.sceneCount(), 6);
+  CORRADE_COMPARE(renderer.drawThreadCount(), 1);
 
   for (std::size_t i = 0; i != renderer.sceneCount(); ++i) {
     CORRADE_ITERATION(i);
@@ -1659,6 +1708,90 @@ void GfxBatchRendererTest::meshHierarchy() {
                   0xffff00_rgb * data.textureMultiplier);
 }
 
+void GfxBatchRendererTest::compositeConverter() {
+  auto&& data = CompositeConverterData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter>
+      imageConverterManager;
+  if (imageConverterManager.loadState("KtxImageConverter") ==
+      Cr::PluginManager::LoadState::NotFound)
+    CORRADE_SKIP("KtxImageConverter plugin not found");
+  Cr::PluginManager::Manager<Mn::Trade::AbstractSceneConverter>
+      converterManager;
+  if (converterManager.loadState("GltfSceneConverter") ==
+      Cr::PluginManager::LoadState::NotFound)
+    CORRADE_SKIP("GltfSceneConverter plugin not found");
+
+  const Cr::Containers::String fourSquares =
+      Cr::Utility::Path::join({TEST_ASSETS, "scenes",
+                               "batch-four-squares-deep-hierarchy-whole-file.gltf"});
+
+  esp::gfx_batch::CompositeConverter converter;
+  CORRADE_VERIFY(!converter.quantizeVertexAttributes());
+  converter.setQuantizeVertexAttributes(data.quantize);
+  CORRADE_VERIFY(converter.addFile(fourSquares, "four squares"));
+  CORRADE_VERIFY(converter.hasNodeHierarchy("four squares"));
+  /* One mesh, two texture layers and four materials */
+  CORRADE_COMPARE(converter.meshCount(), 1);
+  CORRADE_COMPARE(converter.imageCount(), 2);
+  CORRADE_COMPARE(converter.materialCount(), 4);
+
+  /* The same file again under a different name adds no new data */
+  CORRADE_VERIFY(converter.addFile(fourSquares, "four squares again"));
+  CORRADE_COMPARE(converter.nodeHierarchyCount(), 2);
+  CORRADE_COMPARE(converter.meshCount(), 1);
+  CORRADE_COMPARE(converter.imageCount(), 2);
+  CORRADE_COMPARE(converter.materialCount(), 4);
+
+  /* A name that's taken fails */
+  {
+    std::ostringstream out;
+    Cr::Utility::Error redirectError{&out};
+    CORRADE_VERIFY(!converter.addFile(fourSquares, "four squares"));
+  }
+  CORRADE_COMPARE(converter.nodeHierarchyCount(), 2);
+
+  const Cr::Containers::String filename =
+      Cr::Utility::Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, data.filename);
+  CORRADE_VERIFY(converter.convertToFile(filename));
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1}),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_VERIFY(renderer.addFile(filename));
+  CORRADE_VERIFY(renderer.hasNodeHierarchy("four squares"));
+  CORRADE_VERIFY(renderer.hasNodeHierarchy("four squares again"));
+
+  /* Same setup as in meshHierarchy(), the output should be the same as well,
+     just with everything in a single draw batch */
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "four squares"), 0);
+  renderer.transformations(0)[0] = Mn::Matrix4::scaling(Mn::Vector3{0.8f});
+
+  esp::gfx_batch::SceneStats stats = renderer.sceneStats(0);
+  CORRADE_COMPARE(stats.nodeCount, 5);
+  CORRADE_COMPARE(stats.drawCount, 4);
+  CORRADE_COMPARE(stats.drawBatchCount, 1);
+
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_AS(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          {TEST_ASSETS, "screenshots", "GfxBatchRendererTestMeshHierarchy.png"}),
+      Mn::DebugTools::CompareImageToFile);
+}
+
 void GfxBatchRendererTest::multipleMeshes() {
   auto&& data = FileData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -1739,14 +1872,17 @@ void GfxBatchRendererTest::multipleScenes() {
   auto&& data = FileData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
 
+  /* Scenes prepared on multiple threads should render the same */
   // clang-format off
   esp::gfx_batch::RendererStandalone renderer{
       esp::gfx_batch::RendererConfiguration{}
-          .setTileSizeCount({64, 48}, {2, 2}),
+          .setTileSizeCount({64, 48}, {2, 2})
+          .setDrawThreadCount(3),
       esp::gfx_batch::RendererStandaloneConfiguration{}
           .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
   };
   // clang-format on
+  CORRADE_COMPARE(renderer.drawThreadCount(), 3);
 
   for (const auto& file : data.gltfFilenames)
     CORRADE_VERIFY(renderer.addFile(
@@ -1905,6 +2041,230 @@ void GfxBatchRendererTest::clearScene() {
                                           data.meanThreshold}));
 }
 
+void GfxBatchRendererTest::removeNodeHierarchy() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1}),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+
+  /* Like in multipleMeshes(), except that there's a triangle covering the
+     square that gets removed again */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "triangle"), 2);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "circle"), 4);
+  CORRADE_COMPARE(renderer.addEmptyNode(0), 6);
+  renderer.transformations(0)[2] =
+      Mn::Matrix4::translation({0.0f, 0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+
+  /* Render once so the removal has to update an already processed scene */
+  renderer.draw();
+
+  renderer.removeNodeHierarchy(0, 2);
+  renderer.removeNodeHierarchy(0, 6);
+  esp::gfx_batch::SceneStats stats = renderer.sceneStats(0);
+  CORRADE_COMPARE(stats.nodeCount, 7);
+  CORRADE_COMPARE(stats.drawCount, 2);
+
+  /* Adding the same count of nodes again reuses the removed IDs */
+  CORRADE_COMPARE(renderer.addEmptyNode(0), 6);
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "triangle"), 2);
+  stats = renderer.sceneStats(0);
+  CORRADE_COMPARE(stats.nodeCount, 7);
+  CORRADE_COMPARE(stats.drawCount, 3);
+
+  renderer.transformations(0)[0] =
+      Mn::Matrix4::translation({0.0f, 0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  renderer.transformations(0)[2] =
+      Mn::Matrix4::translation({0.5f, -0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  renderer.transformations(0)[4] =
+      Mn::Matrix4::translation({-0.5f, -0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+
+  /* Now it should match the output in multipleMeshes() */
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_WITH(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleMeshes.png"),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+}
+
+void GfxBatchRendererTest::frustumCulling() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1})
+          .setFlags(esp::gfx_batch::RendererFlag::FrustumCulling),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+
+  /* Like in multipleMeshes(), plus two more objects outside of the view */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  renderer.transformations(0)[0] =
+      Mn::Matrix4::translation({0.0f, 0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "circle"), 2);
+  renderer.transformations(0)[2] =
+      Mn::Matrix4::translation({-0.5f, -0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "triangle"), 4);
+  renderer.transformations(0)[4] =
+      Mn::Matrix4::translation({0.5f, -0.5f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "circle"), 6);
+  renderer.transformations(0)[6] =
+      Mn::Matrix4::translation({3.0f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 8);
+  renderer.transformations(0)[8] =
+      Mn::Matrix4::translation({0.0f, 0.0f, -20.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+
+  renderer.draw();
+  esp::gfx_batch::SceneStats stats = renderer.sceneStats(0);
+  CORRADE_COMPARE(stats.drawCount, 5);
+  CORRADE_COMPARE(stats.culledDrawCount, 2);
+
+  /* The culled objects shouldn't affect the output */
+  Mn::Image2D color = renderer.colorImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_WITH(
+      color,
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleMeshes.png"),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+
+  /* Moving an object into the view makes it not culled anymore */
+  renderer.transformations(0)[6] =
+      Mn::Matrix4::translation({3.0f, 0.0f, 0.0f}).inverted() *
+      renderer.transformations(0)[6];
+  renderer.draw();
+  CORRADE_COMPARE(renderer.sceneStats(0).culledDrawCount, 1);
+}
+
+void GfxBatchRendererTest::tileSizes() {
+  auto&& data = FileData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  /* The third tile doesn't fit next to the first two and goes to a new row */
+  const Mn::Vector2i sizes[]{{128, 96}, {64, 48}, {64, 48}};
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizes(sizes, 192),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+
+  CORRADE_COMPARE(renderer.sceneCount(), 3);
+  CORRADE_COMPARE(renderer.tileSize(), Mn::Vector2i{});
+  CORRADE_COMPARE(renderer.tileCount(), Mn::Vector2i{});
+  CORRADE_COMPARE(renderer.framebufferSize(), (Mn::Vector2i{192, 144}));
+  CORRADE_COMPARE(renderer.sceneRectangle(0),
+                  Mn::Range2Di::fromSize({}, {128, 96}));
+  CORRADE_COMPARE(renderer.sceneRectangle(1),
+                  Mn::Range2Di::fromSize({128, 0}, {64, 48}));
+  CORRADE_COMPARE(renderer.sceneRectangle(2),
+                  Mn::Range2Di::fromSize({0, 96}, {64, 48}));
+
+  for (const auto& file : data.gltfFilenames)
+    CORRADE_VERIFY(renderer.addFile(
+        Cr::Utility::Path::join({TEST_ASSETS, "scenes", file.first()}),
+        file.second(), file.third()));
+
+  /* Same contents as in multipleMeshes() in the first two scenes, the last
+     one stays empty */
+  for (Mn::UnsignedInt sceneId : {0, 1}) {
+    renderer.updateCamera(sceneId,
+                          Mn::Matrix4::orthographicProjection(
+                              2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f}, 0.1f,
+                              10.0f),
+                          Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f))
+                              .inverted());
+    CORRADE_COMPARE(renderer.addNodeHierarchy(sceneId, "square"), 0);
+    renderer.transformations(sceneId)[0] =
+        Mn::Matrix4::translation({0.0f, 0.5f, 0.0f}) *
+        Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+    CORRADE_COMPARE(renderer.addNodeHierarchy(sceneId, "circle"), 2);
+    renderer.transformations(sceneId)[2] =
+        Mn::Matrix4::translation({-0.5f, -0.5f, 0.0f}) *
+        Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+    CORRADE_COMPARE(renderer.addNodeHierarchy(sceneId, "triangle"), 4);
+    renderer.transformations(sceneId)[4] =
+        Mn::Matrix4::translation({0.5f, -0.5f, 0.0f}) *
+        Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  }
+
+  renderer.draw();
+  CORRADE_COMPARE(renderer.sceneStats(1).rectangle,
+                  renderer.sceneRectangle(1));
+
+  Mn::Image2D color = renderer.colorImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(color.size(), (Mn::Vector2i{192, 144}));
+
+  /* The full-size scene is the same as in multipleMeshes() */
+  Mn::Image2D first{
+      Mn::PixelFormat::RGBA8Unorm, renderer.sceneRectangle(0).size(),
+      Cr::Containers::Array<char>{
+          Cr::NoInit,
+          std::size_t((renderer.sceneRectangle(0).size() * 4).product())}};
+  renderer.colorImageInto(renderer.sceneRectangle(0), first);
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_WITH(
+      first,
+      Cr::Utility::Path::join(
+          TEST_ASSETS, "screenshots/GfxBatchRendererTestMultipleMeshes.png"),
+      (Mn::DebugTools::CompareImageToFile{data.maxThreshold,
+                                          data.meanThreshold}));
+
+  /* The half-size one has the circle and triangle at half the coordinates */
+  CORRADE_COMPARE(color.pixels<Mn::Color4ub>()[9][128 + 22], 0x00cccc_rgb);
+  CORRADE_COMPARE(color.pixels<Mn::Color4ub>()[12][128 + 44], 0xcc00cc_rgb);
+}
+
 void GfxBatchRendererTest::lights() {
   auto&& data = LightData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -2172,6 +2532,49 @@ void GfxBatchRendererTest::imageInto() {
   CORRADE_COMPARE(depth.pixels<Mn::Float>()[64][48], 0.0909091f);
 }
 
+void GfxBatchRendererTest::textureMemoryBudget() {
+  /* Same as singleMesh(), just with a texture memory budget set. The test
+     file has no pre-made mip chain, so the texture is resident in full and the
+     output is the same. */
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1})
+          .setTextureMemoryBudget(1024),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.textureMemoryBudget(), 1024);
+
+  /* Just the reserved white pixel at first */
+  CORRADE_COMPARE(renderer.textureMemoryUsage(), 4);
+
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+  const std::size_t usage = renderer.textureMemoryUsage();
+  CORRADE_COMPARE_AS(usage, 4, Cr::TestSuite::Compare::Greater);
+
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+  renderer.addNodeHierarchy(0, "square",
+                            Mn::Matrix4::scaling(Mn::Vector3{0.8f}));
+  renderer.draw();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE_AS(
+      renderer.colorImage(),
+      Cr::Utility::Path::join(TEST_ASSETS,
+                              "screenshots/GfxBatchRendererTestSingleMesh.png"),
+      Mn::DebugTools::CompareImageToFile);
+
+  /* Nothing to stream, so the usage stays the same */
+  CORRADE_COMPARE(renderer.textureMemoryUsage(), usage);
+}
+
 void GfxBatchRendererTest::depthUnprojection() {
   constexpr Mn::Vector2i tileCount{2, 2};
   constexpr float near = 0.001f;
@@ -2245,6 +2648,134 @@ void GfxBatchRendererTest::depthUnprojection() {
   CORRADE_COMPARE(depth.pixels<Mn::Float>()[96][96], 0.0f);
 }
 
+void GfxBatchRendererTest::depthUnprojectionGpu() {
+  auto&& data = DepthUnprojectionGpuData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  constexpr Mn::Vector2i tileCount{2, 2};
+  constexpr Mn::Vector2i tileSize(64, 64);
+
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount(tileSize, tileCount),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog|
+                    esp::gfx_batch::RendererStandaloneFlag::UnprojectDepth|
+                    esp::gfx_batch::RendererStandaloneFlag::PointCloud|
+                    data.flags)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.depthFramebufferFormat(), Mn::PixelFormat::R32F);
+
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+
+  // Same setup as in depthUnprojection(), except that the unprojection is
+  // done by the renderer itself.
+  const auto& projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.001f, 10.0f);
+  const float distances[]{2.5f, 5.0f, 7.5f, 20.0f};
+  CORRADE_VERIFY(renderer.hasNodeHierarchy("square"));
+  for (int i = 0; i < tileCount.product(); ++i) {
+    renderer.updateCamera(
+        i, projection,
+        Mn::Matrix4::translation(Mn::Vector3::zAxis(distances[i])).inverted());
+    CORRADE_COMPARE(renderer.addNodeHierarchy(i, "square"), 0);
+  }
+
+  renderer.draw();
+  Mn::Image2D depth = renderer.depthImage();
+  Mn::Image2D points = renderer.pointCloudImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(depth.format(), Mn::PixelFormat::R32F);
+  CORRADE_COMPARE(points.format(), Mn::PixelFormat::RGBA32F);
+
+  const Mn::Vector2i centers[]{{32, 32}, {96, 32}, {32, 96}, {96, 96}};
+  for (int i = 0; i != 3; ++i) {
+    CORRADE_ITERATION(i);
+    const Mn::Vector2i center = centers[i];
+    CORRADE_COMPARE_WITH(depth.pixels<Mn::Float>()[center.y()][center.x()],
+                         distances[i],
+                         Corrade::TestSuite::Compare::around(0.01f));
+    // The square is at origin, facing the camera
+    const Mn::Vector4 point =
+        points.pixels<Mn::Vector4>()[center.y()][center.x()];
+    CORRADE_COMPARE_WITH(point.x(), 0.0f,
+                         Corrade::TestSuite::Compare::around(0.05f));
+    CORRADE_COMPARE_WITH(point.y(), 0.0f,
+                         Corrade::TestSuite::Compare::around(0.05f));
+    CORRADE_COMPARE_WITH(point.z(), data.flags ? 0.0f : -distances[i],
+                         Corrade::TestSuite::Compare::around(0.05f));
+    CORRADE_COMPARE(point.w(), 1.0f);
+  }
+
+  // Target 3 is beyond the far plane, both outputs are zero.
+  CORRADE_COMPARE(depth.pixels<Mn::Float>()[96][96], 0.0f);
+  CORRADE_COMPARE(points.pixels<Mn::Vector4>()[96][96], Mn::Vector4{});
+}
+
+void GfxBatchRendererTest::depthOnlyObjectId() {
+  // clang-format off
+  esp::gfx_batch::RendererStandalone renderer{
+      esp::gfx_batch::RendererConfiguration{}
+          .setTileSizeCount({128, 96}, {1, 1})
+          .setFlags(esp::gfx_batch::RendererFlag::DepthOnly|
+                    esp::gfx_batch::RendererFlag::ObjectId),
+      esp::gfx_batch::RendererStandaloneConfiguration{}
+          .setFlags(esp::gfx_batch::RendererStandaloneFlag::QuietLog)
+  };
+  // clang-format on
+  CORRADE_COMPARE(renderer.objectIdFramebufferFormat(),
+                  Mn::PixelFormat::R32UI);
+
+  CORRADE_VERIFY(renderer.addFile(
+      Cr::Utility::Path::join(TEST_ASSETS, "scenes/batch.gltf")));
+  renderer.updateCamera(
+      0,
+      Mn::Matrix4::orthographicProjection(2.0f * Mn::Vector2{4.0f / 3.0f, 1.0f},
+                                          0.1f, 10.0f),
+      Mn::Matrix4::translation(Mn::Vector3::zAxis(1.0f)).inverted());
+
+  /* Two squares next to each other, with different object IDs */
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 0);
+  renderer.transformations(0)[0] =
+      Mn::Matrix4::translation({-0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  CORRADE_COMPARE(renderer.addNodeHierarchy(0, "square"), 2);
+  renderer.transformations(0)[2] =
+      Mn::Matrix4::translation({0.5f, 0.0f, 0.0f}) *
+      Mn::Matrix4::scaling(Mn::Vector3{0.4f});
+  renderer.setObjectId(0, 0, 3);
+  renderer.setObjectId(0, 2, 7);
+
+  renderer.draw();
+  Mn::Image2D depth = renderer.depthImage();
+  Mn::Image2D objectIds = renderer.objectIdImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(objectIds.format(), Mn::PixelFormat::R32UI);
+  CORRADE_COMPARE(objectIds.size(), (Mn::Vector2i{128, 96}));
+
+  /* Depth is the same as with color output, pixels not covered by anything
+     have a zero ID */
+  CORRADE_COMPARE(depth.pixels<Mn::Float>()[0][0], 1.0f);
+  CORRADE_COMPARE(depth.pixels<Mn::Float>()[48][40], 0.0909091f);
+  CORRADE_COMPARE(depth.pixels<Mn::Float>()[48][88], 0.0909091f);
+  CORRADE_COMPARE(objectIds.pixels<Mn::UnsignedInt>()[0][0], 0);
+  CORRADE_COMPARE(objectIds.pixels<Mn::UnsignedInt>()[48][40], 3);
+  CORRADE_COMPARE(objectIds.pixels<Mn::UnsignedInt>()[48][88], 7);
+
+  /* Changing an ID is reflected in the next draw, removing a hierarchy
+     doesn't mix up the IDs of the remaining draws */
+  renderer.setObjectId(0, 2, 11);
+  renderer.removeNodeHierarchy(0, 0);
+  renderer.draw();
+  objectIds = renderer.objectIdImage();
+  MAGNUM_VERIFY_NO_GL_ERROR();
+  CORRADE_COMPARE(objectIds.pixels<Mn::UnsignedInt>()[48][40], 0);
+  CORRADE_COMPARE(objectIds.pixels<Mn::UnsignedInt>()[48][88], 11);
+}
+
 void GfxBatchRendererTest::cudaInterop() {
 #ifndef ESP_BUILD_WITH_CUDA
   CORRADE_SKIP("ESP_BUILD_WITH_CUDA is not enabled");
@@ -5,6 +5,7 @@
 #include "configure.h"
 
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Tester.h>
@@ -16,6 +17,8 @@
 #include "esp/gfx/LightSetup.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/BinaryKeyframes.h"
+#include "esp/gfx/replay/KeyframeRingBuffer.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
@@ -28,6 +31,10 @@
 #include <fstream>
 #include <string>
 
+#ifdef CORRADE_TARGET_UNIX
+#include <unistd.h>
+#endif
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -47,6 +54,8 @@ struct GfxReplayTest : Cr::TestSuite::Tester {
 
   void testRecorder();
 
+  void testRecorderStateUpdateFilter();
+
   void testPlayer();
 
   void testPlayerReadMissingFile();
@@ -56,6 +65,11 @@ struct GfxReplayTest : Cr::TestSuite::Tester {
   void testLightIntegration();
   void testSkinningIntegration();
   void testDecimalPlaces();
+  void testBinaryKeyframes();
+  void testStreamingKeyframes();
+  void testKeyframeRingBuffer();
+  void testPlayerPartialRigPose();
+  void testPlayerSeek();
 
   esp::logging::LoggingContext loggingContext;
 
@@ -73,6 +87,7 @@ int getNumberOfChildrenOfRoot(esp::scene::SceneNode& rootNode) {
 GfxReplayTest::GfxReplayTest() {
   addTests({
       &GfxReplayTest::testRecorder,
+      &GfxReplayTest::testRecorderStateUpdateFilter,
       &GfxReplayTest::testPlayer,
       &GfxReplayTest::testPlayerReadMissingFile,
       &GfxReplayTest::testPlayerReadInvalidFile,
@@ -80,6 +95,11 @@ GfxReplayTest::GfxReplayTest() {
       &GfxReplayTest::testLightIntegration,
       &GfxReplayTest::testSkinningIntegration,
       &GfxReplayTest::testDecimalPlaces,
+      &GfxReplayTest::testBinaryKeyframes,
+      &GfxReplayTest::testStreamingKeyframes,
+      &GfxReplayTest::testKeyframeRingBuffer,
+      &GfxReplayTest::testPlayerPartialRigPose,
+      &GfxReplayTest::testPlayerSeek,
   });
 }  // ctor
 
@@ -189,6 +209,83 @@ void GfxReplayTest::testRecorder() {
   CORRADE_COMPARE(
       keyframes[2].userTransforms.at("my_user_transform").translation,
       Mn::Vector3(4.f, 5.f, 6.f));
+  // node2 didn't move since frame #1
+  CORRADE_VERIFY(keyframes[2].stateUpdates.empty());
+
+  // moving node2 after the deletion is still picked up
+  node2->setTranslation(Mn::Vector3(-1.f, 0.f, 0.f));
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes.size(), 4);
+  CORRADE_COMPARE(keyframes[3].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[3].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(-1.f, 0.f, 0.f));
+
+  // a node that was already cleaned, e.g. by the renderer, is picked up too,
+  // using the cached absolute transformation
+  node2->setTranslation(Mn::Vector3(0.f, 2.f, 0.f));
+  node2->setClean();
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes.size(), 5);
+  CORRADE_COMPARE(keyframes[4].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[4].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(0.f, 2.f, 0.f));
+}
+
+void GfxReplayTest::testRecorderStateUpdateFilter() {
+  esp::scene::SceneGraph sceneGraph;
+  esp::scene::SceneNode& node = sceneGraph.getRootNode().createChild();
+  esp::scene::SceneNode& node2 = sceneGraph.getRootNode().createChild();
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+
+  esp::gfx::replay::Recorder recorder;
+  recorder.onCreateRenderAssetInstance(&node, creation);
+  recorder.onCreateRenderAssetInstance(&node2, creation);
+  esp::gfx::replay::StateUpdateFilter filter;
+  filter.minTranslation = 0.1f;
+  filter.minRotation = 0.1f;
+  recorder.setStateUpdateFilter(filter);
+  esp::gfx::replay::StateUpdateFilter filter2;
+  filter2.minKeyframeInterval = 3;
+  recorder.setInstanceStateUpdateFilter(&node2, filter2);
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+
+  // first states are always recorded
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[0].stateUpdates.size(), 2);
+
+  // small changes are dropped, but accumulate; node2 has to wait
+  node.translate({0.06f, 0.0f, 0.0f});
+  node2.translate({1.0f, 0.0f, 0.0f});
+  recorder.saveKeyframe();
+  CORRADE_VERIFY(keyframes[1].stateUpdates.empty());
+  node.translate({0.06f, 0.0f, 0.0f});
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[2].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[2].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(0.12f, 0.0f, 0.0f));
+
+  // node2 didn't move since, but its postponed update is recorded
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[3].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[3].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(1.0f, 0.0f, 0.0f));
+
+  // a rotation above the threshold is recorded even without translation
+  node.rotateY(Mn::Deg(10.0f));
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[4].stateUpdates.size(), 1);
+
+  // instances outside of the region of interest wait until it gets closer
+  recorder.setRegionOfInterest({10.0f, 0.0f, 0.0f}, 5.0f);
+  node.translate({1.0f, 0.0f, 0.0f});
+  recorder.saveKeyframe();
+  CORRADE_VERIFY(keyframes[5].stateUpdates.empty());
+  recorder.setRegionOfInterest({5.0f, 0.0f, 0.0f}, 5.0f);
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(keyframes[6].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[6].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(1.12f, 0.0f, 0.0f));
 }
 
 // construct some render keyframes and play them using replay::Player
@@ -698,7 +795,8 @@ void GfxReplayTest::testSkinningIntegration() {
   CORRADE_VERIFY(getBoneIdFromName(0, keyframes[0], "D") != esp::ID_UNDEFINED);
   CORRADE_VERIFY(getBoneIdFromName(0, keyframes[0], "E") != esp::ID_UNDEFINED);
   CORRADE_COMPARE(keyframes[0].rigUpdates.size(), 1);
-  CORRADE_COMPARE(keyframes[0].rigUpdates[0].pose.size(), 5);
+  CORRADE_COMPARE(keyframes[0].rigUpdates[0].pose.boneCount(), 5);
+  CORRADE_VERIFY(!keyframes[0].rigUpdates[0].isPartial());
 
   // Frame 1
   CORRADE_COMPARE(keyframes[1].rigCreations.size(), 0);
@@ -707,7 +805,9 @@ void GfxReplayTest::testSkinningIntegration() {
   // Frame 2
   CORRADE_COMPARE(keyframes[2].rigCreations.size(), 0);
   CORRADE_COMPARE(keyframes[2].rigUpdates.size(), 1);
-  CORRADE_COMPARE(keyframes[2].rigUpdates[0].pose.size(), 5);
+  // moving the base moves all bones
+  CORRADE_COMPARE(keyframes[2].rigUpdates[0].pose.boneCount(), 5);
+  CORRADE_VERIFY(!keyframes[2].rigUpdates[0].isPartial());
 
   // Frame 3
   CORRADE_COMPARE(keyframes[3].rigCreations.size(), 1);
@@ -718,8 +818,19 @@ void GfxReplayTest::testSkinningIntegration() {
   CORRADE_VERIFY(getBoneIdFromName(1, keyframes[3], "D") != esp::ID_UNDEFINED);
   CORRADE_VERIFY(getBoneIdFromName(1, keyframes[3], "E") != esp::ID_UNDEFINED);
   CORRADE_COMPARE(keyframes[3].rigUpdates.size(), 2);
-  CORRADE_COMPARE(keyframes[3].rigUpdates[0].pose.size(), 5);
-  CORRADE_COMPARE(keyframes[3].rigUpdates[1].pose.size(), 5);
+  for (const auto& rigUpdate : keyframes[3].rigUpdates) {
+    CORRADE_ITERATION(rigUpdate.id);
+    if (rigUpdate.id == 0) {
+      // only the moved link and its descendants are recorded
+      CORRADE_VERIFY(rigUpdate.isPartial());
+      CORRADE_COMPARE_AS(rigUpdate.pose.boneCount(), std::size_t{5},
+                         Cr::TestSuite::Compare::Less);
+    } else {
+      // the new rig gets a full pose
+      CORRADE_COMPARE(rigUpdate.pose.boneCount(), 5);
+      CORRADE_VERIFY(!rigUpdate.isPartial());
+    }
+  }
 
   // Frame 4
   CORRADE_COMPARE(keyframes[4].deletions.size(), 2);
@@ -787,6 +898,453 @@ void GfxReplayTest::testDecimalPlaces() {
   }
 }
 
+void GfxReplayTest::testBinaryKeyframes() {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::RenderAssetInstanceState;
+  using esp::gfx::replay::Transform;
+
+  const Transform staticTransform{
+      {1.0f, 2.0f, 3.0f},
+      Mn::Quaternion::rotation(Mn::Deg(30.0f), Mn::Vector3::yAxis())};
+
+  std::vector<Keyframe> keyframes(2);
+  {
+    Keyframe& keyframe = keyframes[0];
+    keyframe.loads.emplace_back(esp::assets::AssetInfo::fromPath(
+        Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb")));
+    keyframe.rigCreations.push_back({7, {"root", "arm"}});
+    esp::assets::RenderAssetInstanceCreationInfo creation{
+        "sphere.glb", Mn::Vector3{2.0f},
+        esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD, "lights",
+        7};
+    keyframe.creations.emplace_back(3, creation);
+    keyframe.creations.emplace_back(5, creation);
+    keyframe.stateUpdates.emplace_back(
+        3, RenderAssetInstanceState{staticTransform, 11});
+    keyframe.stateUpdates.emplace_back(
+        5, RenderAssetInstanceState{{{-0.5f, 0.25f, 8.0f}, {}}, -1});
+    keyframe.rigUpdates.push_back(
+        {7,
+         {{staticTransform.translation, {}}, {staticTransform.rotation, {}}},
+         {}});
+    keyframe.userTransforms["camera"] = staticTransform;
+    keyframe.lightsChanged = true;
+    keyframe.lights.push_back({{0.0f, 1.0f, 0.0f, 0.0f},
+                               {0.5f, 0.5f, 1.0f},
+                               LightPositionModel::Camera});
+  }
+  {
+    Keyframe& keyframe = keyframes[1];
+    keyframe.deletions.push_back(5);
+    // unchanged state and a moved bone, delta-coded against the first frame
+    keyframe.stateUpdates.emplace_back(
+        3, RenderAssetInstanceState{staticTransform, 11});
+    keyframe.rigUpdates.push_back(
+        {7, {{{0.0f, 0.125f, 0.0f}}, {Mn::Quaternion{}}}, {1u << 1}});
+  }
+
+  const std::string data = esp::gfx::replay::keyframesToBinary(keyframes);
+  CORRADE_VERIFY(esp::gfx::replay::isBinaryKeyframeData(data));
+  CORRADE_VERIFY(!esp::gfx::replay::isBinaryKeyframeData("{\"keyframes\""));
+
+  std::vector<Keyframe> decoded;
+  CORRADE_VERIFY(esp::gfx::replay::keyframesFromBinary(data, decoded));
+  CORRADE_COMPARE(decoded.size(), 2);
+
+  const Keyframe& first = decoded[0];
+  CORRADE_COMPARE(first.loads.size(), 1);
+  CORRADE_VERIFY(first.loads[0] == keyframes[0].loads[0]);
+  CORRADE_COMPARE(first.rigCreations.size(), 1);
+  CORRADE_COMPARE(first.rigCreations[0].id, 7);
+  CORRADE_COMPARE(first.rigCreations[0].boneNames[1], "arm");
+  CORRADE_COMPARE(first.creations.size(), 2);
+  CORRADE_COMPARE(first.creations[1].first, 5);
+  CORRADE_COMPARE(first.creations[1].second.filepath, "sphere.glb");
+  CORRADE_COMPARE(*first.creations[1].second.scale, Mn::Vector3{2.0f});
+  CORRADE_VERIFY(first.creations[1].second.isRGBD());
+  CORRADE_VERIFY(!first.creations[1].second.isSemantic());
+  CORRADE_COMPARE(first.creations[1].second.lightSetupKey, "lights");
+  CORRADE_COMPARE(first.creations[1].second.rigId, 7);
+  CORRADE_COMPARE(first.stateUpdates.size(), 2);
+  CORRADE_COMPARE(first.stateUpdates[0].first, 3);
+  CORRADE_COMPARE(first.stateUpdates[0].second.semanticId, 11);
+  CORRADE_COMPARE(first.stateUpdates[1].second.semanticId, -1);
+  CORRADE_COMPARE_AS((first.stateUpdates[1].second.absTransform.translation -
+                      Mn::Vector3{-0.5f, 0.25f, 8.0f})
+                         .length(),
+                     1.0e-4f, Cr::TestSuite::Compare::LessOrEqual);
+  // user transforms and lights are stored at full precision
+  CORRADE_VERIFY(first.userTransforms.at("camera") == staticTransform);
+  CORRADE_VERIFY(first.lightsChanged);
+  CORRADE_COMPARE(first.lights.size(), 1);
+  CORRADE_VERIFY(first.lights[0] == keyframes[0].lights[0]);
+
+  const Keyframe& second = decoded[1];
+  CORRADE_COMPARE(second.deletions.size(), 1);
+  CORRADE_COMPARE(second.deletions[0], 5);
+  CORRADE_COMPARE(second.stateUpdates.size(), 1);
+  CORRADE_COMPARE(second.stateUpdates[0].second.semanticId, 11);
+  CORRADE_VERIFY(!second.lightsChanged);
+  const Transform& state = second.stateUpdates[0].second.absTransform;
+  CORRADE_COMPARE_AS((state.translation - staticTransform.translation).length(),
+                     1.0e-4f, Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_COMPARE_AS(
+      (state.rotation.vector() - staticTransform.rotation.vector()).length(),
+      1.0e-4f, Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_COMPARE(second.rigUpdates[0].pose.boneCount(), 1);
+  CORRADE_VERIFY(second.rigUpdates[0].isPartial());
+  CORRADE_VERIFY(!second.rigUpdates[0].isBoneChanged(0));
+  CORRADE_VERIFY(second.rigUpdates[0].isBoneChanged(1));
+  CORRADE_COMPARE_AS((second.rigUpdates[0].pose.translations[0] -
+                      Mn::Vector3{0.0f, 0.125f, 0.0f})
+                         .length(),
+                     1.0e-4f, Cr::TestSuite::Compare::LessOrEqual);
+
+  // truncated data is rejected and leaves the output untouched
+  std::vector<Keyframe> truncated;
+  CORRADE_VERIFY(!esp::gfx::replay::keyframesFromBinary(
+      Cr::Containers::StringView{data}.exceptSuffix(3), truncated));
+  CORRADE_VERIFY(truncated.empty());
+
+  // single keyframes go through the same path as JSON ones for the batch
+  // replay renderer
+  const Keyframe single =
+      esp::gfx::replay::Player::keyframeFromStringUnwrapped(
+          esp::gfx::replay::keyframesToBinary({keyframes[0]}));
+  CORRADE_COMPARE(single.creations.size(), 2);
+  CORRADE_COMPARE(single.stateUpdates[0].second.semanticId, 11);
+}
+
+void GfxReplayTest::testStreamingKeyframes() {
+  const std::string testFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb");
+  const auto testFilepath =
+      Corrade::Utility::Path::join(DATA_DIR, "./gfx_replay_stream_test.json");
+  const auto checkpointFilepath =
+      Corrade::Utility::Path::join(DATA_DIR, "./gfx_replay_stream_test_1.json");
+
+  {
+    SimulatorConfiguration simConfig{};
+    simConfig.enableGfxReplaySave = true;
+    simConfig.createRenderer = false;
+    simConfig.activeSceneName = testFile;
+    auto sim = Simulator::create_unique(simConfig);
+    CORRADE_VERIFY(sim);
+    const auto recorder = sim->getGfxReplayManager()->getRecorder();
+    CORRADE_VERIFY(recorder);
+
+    esp::assets::RenderAssetInstanceCreationInfo creation(
+        testFile, Corrade::Containers::NullOpt,
+        esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD, "");
+    auto* node = sim->loadAndCreateRenderAssetInstance(
+        esp::assets::AssetInfo::fromPath(testFile), creation);
+    CORRADE_VERIFY(node);
+
+    recorder->startStreamingKeyframesToFile(testFilepath, 2);
+    CORRADE_VERIFY(recorder->isStreamingKeyframes());
+    for (int i = 0; i < 3; ++i) {
+      node->setTranslation(Mn::Vector3{float(i), 0.0f, 0.0f});
+      recorder->saveKeyframe();
+      // only the latest keyframe is kept in memory
+      CORRADE_COMPARE(recorder->debugGetSavedKeyframes().size(), 1);
+    }
+    recorder->stopStreamingKeyframes();
+    CORRADE_VERIFY(!recorder->isStreamingKeyframes());
+    CORRADE_VERIFY(recorder->debugGetSavedKeyframes().empty());
+  }
+
+  esp::gfx::replay::Player player{
+      std::make_shared<DummySceneGraphPlayerImplementation>()};
+  player.readKeyframesFromFile(testFilepath);
+  CORRADE_COMPARE(player.getNumKeyframes(), 2);
+  CORRADE_VERIFY(!player.debugGetKeyframes()[0].creations.empty());
+  CORRADE_VERIFY(player.debugGetKeyframes()[1].creations.empty());
+
+  // the continuation file starts with a checkpoint and plays on its own
+  player.readKeyframesFromFile(checkpointFilepath);
+  CORRADE_COMPARE(player.getNumKeyframes(), 1);
+  const auto& checkpoint = player.debugGetKeyframes()[0];
+  CORRADE_VERIFY(!checkpoint.loads.empty());
+  CORRADE_VERIFY(!checkpoint.creations.empty());
+  CORRADE_VERIFY(!checkpoint.stateUpdates.empty());
+  const auto& lastState = checkpoint.stateUpdates.back().second;
+  CORRADE_COMPARE(lastState.absTransform.translation,
+                  (Mn::Vector3{2.0f, 0.0f, 0.0f}));
+
+  for (const std::string& filepath : {testFilepath, checkpointFilepath}) {
+    if (!Corrade::Utility::Path::remove(filepath)) {
+      ESP_WARNING() << "Unable to remove temporary test JSON file" << filepath;
+    }
+  }
+}
+
+void GfxReplayTest::testKeyframeRingBuffer() {
+#ifndef CORRADE_TARGET_UNIX
+  CORRADE_SKIP("Shared-memory ring buffers are only available on Unix.");
+#else
+  using esp::gfx::replay::KeyframeRingBuffer;
+  const std::string name =
+      "habitat_GfxReplayTest_" + std::to_string(getpid());
+
+  std::unique_ptr<KeyframeRingBuffer> producer =
+      KeyframeRingBuffer::create(name, 100);
+  CORRADE_VERIFY(producer);
+  CORRADE_COMPARE(producer->capacity(), 104);
+  CORRADE_COMPARE(producer->maxMessageSize(), 40);
+  // a second buffer of the same name can't be created
+  CORRADE_VERIFY(!KeyframeRingBuffer::create(name, 100));
+  CORRADE_VERIFY(!KeyframeRingBuffer::open(name + "_nonexistent"));
+
+  std::unique_ptr<KeyframeRingBuffer> consumer = KeyframeRingBuffer::open(name);
+  CORRADE_VERIFY(consumer);
+  CORRADE_COMPARE(consumer->capacity(), 104);
+  CORRADE_VERIFY(consumer->isEmpty());
+  CORRADE_VERIFY(!consumer->peek());
+
+  // messages of varying sizes wrap around the end of the area many times
+  for (int i = 0; i != 20; ++i) {
+    CORRADE_ITERATION(i);
+    const std::string first(1 + i % 29, char('a' + i % 26));
+    const std::string second(40 - i % 13, char('A' + i % 26));
+    CORRADE_VERIFY(producer->tryPush(first));
+    CORRADE_VERIFY(producer->tryPush(second));
+    CORRADE_COMPARE(*consumer->peek(), first);
+    consumer->pop();
+    CORRADE_COMPARE(*consumer->peek(), second);
+    consumer->pop();
+    CORRADE_VERIFY(consumer->isEmpty());
+  }
+
+  // a full buffer rejects messages until the consumer catches up
+  CORRADE_VERIFY(producer->tryPush(std::string(40, 'x')));
+  CORRADE_VERIFY(producer->tryPush(std::string(40, 'y')));
+  CORRADE_VERIFY(!producer->tryPush(std::string(40, 'z')));
+  consumer->pop();
+  CORRADE_VERIFY(producer->tryPush(std::string(40, 'z')));
+  CORRADE_COMPARE(*consumer->peek(), std::string(40, 'y'));
+  consumer->pop();
+  CORRADE_COMPARE(*consumer->peek(), std::string(40, 'z'));
+  consumer->pop();
+  CORRADE_VERIFY(consumer->isEmpty());
+
+  // keyframes published by the recorder decode in place on the other side
+  const std::string testFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/sphere.glb");
+  std::unique_ptr<KeyframeRingBuffer> keyframeBuffer =
+      KeyframeRingBuffer::create(name + "_keyframes", 1 << 16);
+  CORRADE_VERIFY(keyframeBuffer);
+  {
+    SimulatorConfiguration simConfig{};
+    simConfig.enableGfxReplaySave = true;
+    simConfig.createRenderer = false;
+    simConfig.activeSceneName = testFile;
+    auto sim = Simulator::create_unique(simConfig);
+    CORRADE_VERIFY(sim);
+    const auto recorder = sim->getGfxReplayManager()->getRecorder();
+    CORRADE_VERIFY(recorder);
+
+    esp::assets::RenderAssetInstanceCreationInfo creation(
+        testFile, Corrade::Containers::NullOpt,
+        esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD, "");
+    auto* node = sim->loadAndCreateRenderAssetInstance(
+        esp::assets::AssetInfo::fromPath(testFile), creation);
+    CORRADE_VERIFY(node);
+
+    for (int i = 0; i < 3; ++i) {
+      node->setTranslation(Mn::Vector3{float(i), 0.0f, 0.0f});
+      recorder->saveKeyframe();
+    }
+    CORRADE_COMPARE(
+        recorder->writeIncrementalSavedKeyframesToRingBuffer(*keyframeBuffer),
+        3);
+    CORRADE_VERIFY(recorder->debugGetSavedKeyframes().empty());
+  }
+
+  std::vector<esp::gfx::replay::Keyframe> keyframes;
+  while (const auto message = keyframeBuffer->peek()) {
+    keyframes.push_back(
+        esp::gfx::replay::Player::keyframeFromStringUnwrapped(*message));
+    keyframeBuffer->pop();
+  }
+  CORRADE_COMPARE(keyframes.size(), 3);
+  CORRADE_VERIFY(!keyframes[0].creations.empty());
+  CORRADE_VERIFY(keyframes[2].creations.empty());
+  CORRADE_VERIFY(!keyframes[2].stateUpdates.empty());
+  const auto& lastState = keyframes[2].stateUpdates.back().second;
+  CORRADE_COMPARE(lastState.absTransform.translation,
+                  (Mn::Vector3{2.0f, 0.0f, 0.0f}));
+#endif
+}
+
+void GfxReplayTest::testPlayerPartialRigPose() {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::RigPose;
+
+  // Records the poses it receives
+  class RigPosePlayerImplementation
+      : public esp::gfx::replay::AbstractSceneGraphPlayerImplementation {
+   public:
+    std::vector<RigPose> poses;
+
+   private:
+    esp::gfx::replay::NodeHandle loadAndCreateRenderAssetInstance(
+        const esp::assets::AssetInfo&,
+        const esp::assets::RenderAssetInstanceCreationInfo&) override {
+      return {};
+    }
+    void setRigPose(int, const RigPose& pose) override {
+      poses.push_back(pose);
+    }
+  };
+
+  auto implementation = std::make_shared<RigPosePlayerImplementation>();
+  esp::gfx::replay::Player player{implementation};
+
+  Keyframe first;
+  first.rigCreations.push_back({3, {"a", "b", "c"}});
+  first.rigUpdates.push_back(
+      {3,
+       {{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}},
+        {Mn::Quaternion{}, Mn::Quaternion{}, Mn::Quaternion{}}},
+       {}});
+  Keyframe second;
+  // only the last bone moved
+  second.rigUpdates.push_back(
+      {3, {{{5.0f, 0.0f, 0.0f}}, {Mn::Quaternion{}}}, {1u << 2}});
+  player.appendKeyframe(std::move(first));
+  player.appendKeyframe(std::move(second));
+
+  player.setKeyframeIndex(1);
+  CORRADE_COMPARE(implementation->poses.size(), 2);
+  // the implementation gets the partial update merged into the full pose
+  const RigPose& pose = implementation->poses.back();
+  CORRADE_COMPARE(pose.boneCount(), 3);
+  CORRADE_COMPARE(pose.translations[0], (Mn::Vector3{0.0f, 0.0f, 0.0f}));
+  CORRADE_COMPARE(pose.translations[1], (Mn::Vector3{1.0f, 0.0f, 0.0f}));
+  CORRADE_COMPARE(pose.translations[2], (Mn::Vector3{5.0f, 0.0f, 0.0f}));
+}
+
+void GfxReplayTest::testPlayerSeek() {
+  using esp::gfx::replay::Keyframe;
+  using esp::gfx::replay::NodeHandle;
+
+  // Keeps track of created instances without a scene graph
+  class NodeListPlayerImplementation
+      : public esp::gfx::replay::AbstractPlayerImplementation {
+   public:
+    struct Node {
+      std::string filepath;
+      Mn::Vector3 translation;
+      bool alive = true;
+    };
+
+    int creationCount = 0;
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    const Node* aliveNode(const std::string& filepath) const {
+      for (const auto& node : nodes) {
+        if (node->alive && node->filepath == filepath) {
+          return node.get();
+        }
+      }
+      return nullptr;
+    }
+
+   private:
+    NodeHandle loadAndCreateRenderAssetInstance(
+        const esp::assets::AssetInfo&,
+        const esp::assets::RenderAssetInstanceCreationInfo& creation) override {
+      ++creationCount;
+      nodes.emplace_back(new Node{creation.filepath, {}});
+      return reinterpret_cast<NodeHandle>(nodes.back().get());
+    }
+    void deleteAssetInstance(NodeHandle node) override {
+      reinterpret_cast<Node*>(node)->alive = false;
+    }
+    void deleteAssetInstances(
+        const std::unordered_map<esp::gfx::replay::RenderAssetInstanceKey,
+                                 NodeHandle>& instances) override {
+      for (const auto& pair : instances) {
+        deleteAssetInstance(pair.second);
+      }
+    }
+    void setNodeTransform(NodeHandle node,
+                          const Mn::Vector3& translation,
+                          const Mn::Quaternion&) override {
+      reinterpret_cast<Node*>(node)->translation = translation;
+    }
+    void setNodeTransform(NodeHandle node,
+                          const Mn::Matrix4& transform) override {
+      reinterpret_cast<Node*>(node)->translation = transform.translation();
+    }
+    Mn::Matrix4 hackGetNodeTransform(NodeHandle node) const override {
+      return Mn::Matrix4::translation(
+          reinterpret_cast<Node*>(node)->translation);
+    }
+  };
+
+  // instance 1 exists in frames 0-149 and moves along X, instance 2 exists
+  // from frame 100 on and moves along Y
+  esp::assets::AssetInfo info1, info2;
+  info1.filepath = "first.glb";
+  info2.filepath = "second.glb";
+  esp::assets::RenderAssetInstanceCreationInfo creation1, creation2;
+  creation1.filepath = info1.filepath;
+  creation2.filepath = info2.filepath;
+  std::vector<Keyframe> keyframes(200);
+  keyframes[0].loads = {info1, info2};
+  keyframes[0].creations.emplace_back(1, creation1);
+  keyframes[100].creations.emplace_back(2, creation2);
+  keyframes[150].deletions.push_back(1);
+  for (int i = 0; i != 200; ++i) {
+    if (i < 150) {
+      keyframes[i].stateUpdates.emplace_back(
+          1, esp::gfx::replay::RenderAssetInstanceState{
+                 {Mn::Vector3::xAxis(float(i)), {}}, 0});
+    }
+    if (i >= 100) {
+      keyframes[i].stateUpdates.emplace_back(
+          2, esp::gfx::replay::RenderAssetInstanceState{
+                 {Mn::Vector3::yAxis(float(i)), {}}, 0});
+    }
+  }
+
+  auto implementation = std::make_shared<NodeListPlayerImplementation>();
+  esp::gfx::replay::Player player{implementation};
+  player.debugSetKeyframes(std::move(keyframes));
+
+  // jumps to the snapshot at frame 191, which doesn't contain instance 1
+  // anymore, so it's never created
+  player.setKeyframeIndex(199);
+  CORRADE_COMPARE(implementation->creationCount, 1);
+  CORRADE_VERIFY(!implementation->aliveNode("first.glb"));
+  CORRADE_VERIFY(implementation->aliveNode("second.glb"));
+  CORRADE_COMPARE(implementation->aliveNode("second.glb")->translation,
+                  Mn::Vector3::yAxis(199.0f));
+
+  // no snapshot before frame 63, replays from the start
+  player.setKeyframeIndex(10);
+  CORRADE_VERIFY(!implementation->aliveNode("second.glb"));
+  CORRADE_COMPARE(implementation->aliveNode("first.glb")->translation,
+                  Mn::Vector3::xAxis(10.0f));
+
+  // far ahead, jumps to the snapshot at frame 127
+  implementation->creationCount = 0;
+  player.setKeyframeIndex(130);
+  CORRADE_COMPARE(implementation->creationCount, 2);
+  CORRADE_COMPARE(player.getKeyframeIndex(), 130);
+  CORRADE_COMPARE(implementation->aliveNode("first.glb")->translation,
+                  Mn::Vector3::xAxis(130.0f));
+  CORRADE_COMPARE(implementation->aliveNode("second.glb")->translation,
+                  Mn::Vector3::yAxis(130.0f));
+
+  // close enough to just apply the keyframes in between
+  player.setKeyframeIndex(131);
+  CORRADE_COMPARE(implementation->creationCount, 2);
+  CORRADE_COMPARE(implementation->aliveNode("first.glb")->translation,
+                  Mn::Vector3::xAxis(131.0f));
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(GfxReplayTest)
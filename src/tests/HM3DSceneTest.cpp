@@ -50,6 +50,8 @@ struct HM3DSceneTest : Cr::TestSuite::Tester {
 
   void testHM3DSemanticScene();
 
+  void testHM3DHouseParsing();
+
   esp::logging::LoggingContext loggingContext;
 
   // The MetadataMediator can exist independently of simulator
@@ -77,6 +79,7 @@ HM3DSceneTest::HM3DSceneTest() {
   addInstancedTests(
       {&HM3DSceneTest::testHM3DScene, &HM3DSceneTest::testHM3DSemanticScene},
       Cr::Containers::arraySize(TestHM3DScenes));
+  addTests({&HM3DSceneTest::testHM3DHouseParsing});
 }
 
 void HM3DSceneTest::testHM3DScene() {
@@ -121,6 +124,40 @@ void HM3DSceneTest::testHM3DSemanticScene() {
   }
 }
 
+void HM3DSceneTest::testHM3DHouseParsing() {
+  // doesn't need the dataset, the file is parsed in place from memory
+  const std::string filename = "HM3DSceneTestHouse.txt";
+  CORRADE_VERIFY(Cr::Utility::Path::write(
+      filename, Cr::Containers::StringView{
+                    "HM3D Semantic Annotations\r\n"
+                    "1,FF0000,\"chair\",2\r\n"
+                    "\n"
+                    "2,00ff00,\"table, dining\",2\n"
+                    "3,0000FF,\"chair\",5"}));
+  esp::scene::SemanticScene scene;
+  CORRADE_VERIFY(esp::scene::SemanticScene::loadHM3DHouse(filename, scene));
+
+  // the unknown object, and three annotated ones in two regions
+  CORRADE_COMPARE(scene.objects().size(), 4);
+  CORRADE_COMPARE(scene.regions().size(), 3);
+  CORRADE_COMPARE(scene.categories().size(), 3);
+  const auto& table = scene.objects()[2];
+  CORRADE_COMPARE(table->semanticID(), 2);
+  CORRADE_COMPARE(table->getColorAsInt(), 0x00ff00);
+  CORRADE_COMPARE(table->category()->name(""), "table, dining");
+  CORRADE_COMPARE(table->region()->getIndex(), 2);
+  CORRADE_COMPARE(scene.objects()[3]->region()->getIndex(), 5);
+
+  // a malformed line fails the load instead of throwing
+  CORRADE_VERIFY(Cr::Utility::Path::write(
+      filename, Cr::Containers::StringView{"HM3D Semantic Annotations\n"
+                                           "1,FF0000,\"chair\",two\n"}));
+  esp::scene::SemanticScene malformed;
+  CORRADE_VERIFY(
+      !esp::scene::SemanticScene::loadHM3DHouse(filename, malformed));
+  Cr::Utility::Path::remove(filename);
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(HM3DSceneTest)
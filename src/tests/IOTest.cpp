@@ -11,6 +11,7 @@
 #include "esp/io/Io.h"
 #include "esp/io/Json.h"
 #include "esp/io/JsonAllTypes.h"
+#include "esp/io/JsonFileSnapshot.h"
 #include "esp/metadata/URDFParser.h"
 #include "esp/metadata/attributes/ArticulatedObjectAttributes.h"
 #include "esp/metadata/attributes/ObjectAttributes.h"
@@ -28,8 +29,10 @@ struct IOTest : Cr::TestSuite::Tester {
   explicit IOTest();
   void fileReplaceExtTest();
   void testEllipsisFilter();
+  void testPathCache();
   void parseURDF();
   void testJson();
+  void testJsonFileSnapshot();
   void testJsonBuiltinTypes();
   void testJsonStlTypes();
   void testJsonMagnumTypes();
@@ -52,7 +55,8 @@ struct IOTest : Cr::TestSuite::Tester {
 
 IOTest::IOTest() {
   addTests({&IOTest::fileReplaceExtTest, &IOTest::testEllipsisFilter,
-            &IOTest::parseURDF, &IOTest::testJson,
+            &IOTest::testPathCache, &IOTest::parseURDF, &IOTest::testJson,
+            &IOTest::testJsonFileSnapshot,
             &IOTest::testJsonBuiltinTypes, &IOTest::testJsonStlTypes,
             &IOTest::testJsonMagnumTypes, &IOTest::testJsonEspTypes,
             &IOTest::testJsonUserType});
@@ -136,6 +140,64 @@ void IOTest::testEllipsisFilter() {
 
 }  // IOTest::testEllipsisFilter
 
+void IOTest::testPathCache() {
+  namespace Path = Corrade::Utility::Path;
+  const std::string dir = Path::join(dataDir, "../io_test_path_cache");
+  const std::string subdir = Path::join(dir, "sub");
+  const std::string file = Path::join(dir, "a.json");
+  const auto writeFile = [](const std::string& filename) {
+    return Path::write(filename,
+                       Corrade::Containers::ArrayView<const char>{"{}", 2});
+  };
+  CORRADE_VERIFY(Path::make(subdir));
+  CORRADE_VERIFY(writeFile(file));
+  CORRADE_VERIFY(writeFile(Path::join(subdir, "b.json")));
+
+  for (const bool enabled : {false, true}) {
+    CORRADE_ITERATION(enabled);
+    esp::io::setPathCacheEnabled(enabled);
+    CORRADE_COMPARE(esp::io::isPathCacheEnabled(), enabled);
+
+    CORRADE_VERIFY(esp::io::pathExists(file));
+    CORRADE_VERIFY(!esp::io::isDirectory(file));
+    CORRADE_VERIFY(esp::io::isDirectory(subdir));
+    CORRADE_VERIFY(esp::io::isDirectory(subdir + "/"));
+    CORRADE_VERIFY(!esp::io::pathExists(Path::join(dir, "missing.json")));
+    CORRADE_VERIFY(!esp::io::pathExists(Path::join(dir, "missing/a.json")));
+    CORRADE_COMPARE(esp::io::listDirectory(dir),
+                    (std::vector<std::string>{"a.json", "sub"}));
+    CORRADE_COMPARE(esp::io::listDirectory(file), std::vector<std::string>{});
+    CORRADE_COMPARE(esp::io::globDirs(Path::join(dir, "*")),
+                    (std::vector<std::string>{file, subdir + "/"}));
+    CORRADE_COMPARE(esp::io::globDirs(Path::join(dir, "*/*.json")),
+                    std::vector<std::string>{Path::join(subdir, "b.json")});
+    CORRADE_COMPARE(esp::io::globDirs(Path::join(dir, "s?b")),
+                    std::vector<std::string>{subdir + "/"});
+    CORRADE_COMPARE(esp::io::globDirs(Path::join(dir, "*.txt")),
+                    std::vector<std::string>{});
+  }
+
+  // files created after the listing aren't seen until it's invalidated,
+  // except for JSON files written through the io library
+  const std::string added = Path::join(dir, "added.json");
+  CORRADE_VERIFY(writeFile(added));
+  CORRADE_VERIFY(!esp::io::pathExists(added));
+  esp::io::invalidatePathCache(added);
+  CORRADE_VERIFY(esp::io::pathExists(added));
+  const std::string written = Path::join(dir, "written.json");
+  CORRADE_VERIFY(
+      esp::io::writeJsonToFile(esp::io::parseJsonString("{}"), written));
+  CORRADE_VERIFY(esp::io::pathExists(written));
+
+  esp::io::setPathCacheEnabled(false);
+  Path::remove(written);
+  Path::remove(added);
+  Path::remove(Path::join(subdir, "b.json"));
+  Path::remove(subdir);
+  Path::remove(file);
+  Path::remove(dir);
+}
+
 void IOTest::parseURDF() {
   const std::string iiwaURDF = Cr::Utility::Path::join(
       TEST_ASSETS, "urdf/kuka_iiwa/model_free_base.urdf");
@@ -191,6 +253,71 @@ void IOTest::parseURDF() {
       urdfModel->getLink(1)->m_collisionArray.back().m_geometry.m_meshScale,
       Mn::Vector3{1.0});
   CORRADE_COMPARE(urdfModel->getLink(1)->m_inertia.m_mass, 4.0);
+
+  // clones are scaled independently and keep their own link hierarchy
+  std::shared_ptr<esp::metadata::URDF::Model> clonedModel =
+      urdfModel->clone();
+  clonedModel->setGlobalScaling(2.0);
+  CORRADE_COMPARE(
+      urdfModel->getLink(1)->m_collisionArray.back().m_geometry.m_meshScale,
+      Mn::Vector3{1.0});
+  CORRADE_COMPARE(
+      clonedModel->getLink(1)->m_collisionArray.back().m_geometry.m_meshScale,
+      Mn::Vector3{2.0});
+  CORRADE_COMPARE(clonedModel->m_rootLinks.size(), 1);
+  CORRADE_VERIFY(clonedModel->m_rootLinks[0] != urdfModel->m_rootLinks[0]);
+  CORRADE_VERIFY(clonedModel->getLink(1)->m_parentLink.lock() ==
+                 clonedModel->getLink(0));
+  CORRADE_VERIFY(clonedModel->getJoint(1) ==
+                 clonedModel->m_joints.at(urdfModel->getJoint(1)->m_name));
+}
+
+/**
+ * @brief Test reading JSON files through a snapshot
+ */
+void IOTest::testJsonFileSnapshot() {
+  const std::string s = "{\"test\":[1,2,3,4]}";
+  const auto testFilepath =
+      Corrade::Utility::Path::join(dataDir, "../io_test_snapshot.json");
+  const auto snapshotFilepath =
+      esp::io::JsonFileSnapshot::getSnapshotFilename(testFilepath);
+  CORRADE_VERIFY(
+      esp::io::writeJsonToFile(esp::io::parseJsonString(s), testFilepath));
+
+  // files read from disk get stored in the snapshot and saved
+  {
+    esp::io::JsonFileSnapshot snapshot{snapshotFilepath};
+    const auto docs = esp::io::parseJsonFiles({testFilepath}, &snapshot);
+    CORRADE_VERIFY(docs[0]);
+    CORRADE_COMPARE(esp::io::jsonToString(*docs[0]), s);
+    CORRADE_VERIFY(snapshot.save());
+  }
+
+  // and are used from there while unchanged
+  {
+    esp::io::JsonFileSnapshot snapshot{snapshotFilepath};
+    const std::string* contents = snapshot.find(
+        testFilepath, esp::io::JsonFileSnapshot::stamp(testFilepath));
+    CORRADE_VERIFY(contents);
+    CORRADE_COMPARE(esp::io::jsonToString(esp::io::parseJsonString(*contents)),
+                    s);
+  }
+
+  // a changed file is read from disk again
+  const std::string changed = "{\"test\":[5,6]}";
+  CORRADE_VERIFY(esp::io::writeJsonToFile(esp::io::parseJsonString(changed),
+                                          testFilepath));
+  {
+    esp::io::JsonFileSnapshot snapshot{snapshotFilepath};
+    CORRADE_VERIFY(!snapshot.find(
+        testFilepath, esp::io::JsonFileSnapshot::stamp(testFilepath)));
+    const auto docs = esp::io::parseJsonFiles({testFilepath}, &snapshot);
+    CORRADE_VERIFY(docs[0]);
+    CORRADE_COMPARE(esp::io::jsonToString(*docs[0]), changed);
+  }
+
+  Corrade::Utility::Path::remove(snapshotFilepath);
+  Corrade::Utility::Path::remove(testFilepath);
 }
 
 /**
@@ -210,6 +337,32 @@ void IOTest::testJson() {
   CORRADE_VERIFY(esp::io::writeJsonToFile(json, testFilepath));
   const auto& loadedJson = esp::io::parseJsonFile(testFilepath);
   CORRADE_COMPARE(esp::io::jsonToString(loadedJson), s);
+
+  // parsing in place leaves the strings in the buffer
+  std::string insitu = "{\"name\":\"banana\",\"test\":[1,2,3,4]}";
+  const auto insituJson = esp::io::parseJsonInsitu(&insitu[0]);
+  const char* name = insituJson["name"].GetString();
+  CORRADE_COMPARE(std::string{name}, "banana");
+  CORRADE_VERIFY(name >= insitu.data() && name < insitu.data() + insitu.size());
+  CORRADE_COMPARE(insituJson["test"][3].GetInt(), 4);
+
+  // parallel parsing keeps the order and leaves failed files empty
+  auto badFilepath =
+      Corrade::Utility::Path::join(dataDir, "../io_test_bad_json.json");
+  const std::string badJson = "{\"test\":[";
+  CORRADE_VERIFY(Corrade::Utility::Path::write(
+      badFilepath, Corrade::Containers::ArrayView<const char>{
+                       badJson.data(), badJson.size()}));
+  const auto loadedJsons = esp::io::parseJsonFiles(
+      {testFilepath, badFilepath, testFilepath + ".missing", testFilepath});
+  CORRADE_COMPARE(loadedJsons.size(), std::size_t{4});
+  CORRADE_VERIFY(loadedJsons[0]);
+  CORRADE_COMPARE(esp::io::jsonToString(*loadedJsons[0]), s);
+  CORRADE_VERIFY(!loadedJsons[1]);
+  CORRADE_VERIFY(!loadedJsons[2]);
+  CORRADE_VERIFY(loadedJsons[3]);
+  CORRADE_COMPARE(esp::io::jsonToString(*loadedJsons[3]), s);
+  Corrade::Utility::Path::remove(badFilepath);
   Corrade::Utility::Path::remove(testFilepath);
 
   // test basic attributes populating
@@ -55,6 +55,8 @@ struct LoggingTest : Cr::TestSuite::Tester {
   explicit LoggingTest();
 
   void envVarTest();
+  void nestedContextTest();
+  void asyncTest();
 };
 
 constexpr const struct {
@@ -95,6 +97,7 @@ constexpr const struct {
 LoggingTest::LoggingTest() {
   addInstancedTests({&LoggingTest::envVarTest},
                     Cr::Containers::arraySize(EnvVarTestData));
+  addTests({&LoggingTest::nestedContextTest, &LoggingTest::asyncTest});
 }
 
 void LoggingTest::envVarTest() {
@@ -134,5 +137,59 @@ void LoggingTest::envVarTest() {
   out.str("");
 }
 
+void LoggingTest::nestedContextTest() {
+  using esp::logging::LoggingLevel;
+  using esp::logging::Subsystem;
+
+  esp::logging::LoggingContext outer{"quiet"};
+  CORRADE_VERIFY(
+      !esp::logging::isLevelEnabled(Subsystem::sim, LoggingLevel::Warning));
+  {
+    esp::logging::LoggingContext inner{"quiet:Sim=debug"};
+    CORRADE_VERIFY(
+        esp::logging::isLevelEnabled(Subsystem::sim, LoggingLevel::Debug));
+    CORRADE_VERIFY(
+        !esp::logging::isLevelEnabled(Subsystem::gfx, LoggingLevel::Debug));
+  }
+  // the levels of the outer context are in effect again
+  CORRADE_VERIFY(
+      !esp::logging::isLevelEnabled(Subsystem::sim, LoggingLevel::Debug));
+  CORRADE_VERIFY(
+      esp::logging::isLevelEnabled(Subsystem::sim, LoggingLevel::Error));
+}
+
+void LoggingTest::asyncTest() {
+  esp::logging::LoggingContext ctx{"debug"};
+
+  std::ostringstream out;
+  Cr::Utility::Debug debugCapture{&out};
+  Cr::Utility::Warning warnCapture{&out};
+  Cr::Utility::Error errorCapture{&out};
+
+  esp::logging::setAsyncLogging(true);
+  CORRADE_VERIFY(esp::logging::isAsyncLogging());
+  debug("AsyncDebug");
+  warning("AsyncWarning");
+  esp::logging::flushAsyncLogging();
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "::debug : AsyncDebug\n"));
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains(
+      "::warning : AsyncWarning\n"));
+
+  // errors are written right away, after everything queued before them
+  out.str("");
+  debug("AsyncDebug");
+  ESP_ERROR() << "AsyncError";
+  const std::string written = out.str();
+  CORRADE_VERIFY(written.find("AsyncDebug") != std::string::npos);
+  CORRADE_VERIFY(written.find("AsyncDebug") < written.find("AsyncError"));
+
+  esp::logging::setAsyncLogging(false);
+  CORRADE_VERIFY(!esp::logging::isAsyncLogging());
+  out.str("");
+  debug("SyncDebug");
+  CORRADE_VERIFY(Cr::Containers::StringView{out.str()}.contains("SyncDebug"));
+}
+
 }  // namespace
 CORRADE_TEST_MAIN(LoggingTest)
@@ -80,6 +80,8 @@ struct MetadataMediatorTest : Cr::TestSuite::Tester {
 
   void testDatasetDelete();
 
+  void testLazySceneInstanceLoading();
+
   esp::logging::LoggingContext loggingContext;
   MetadataMediator::ptr MM_ = nullptr;
 
@@ -89,7 +91,8 @@ MetadataMediatorTest::MetadataMediatorTest() {
   MM_ = MetadataMediator::create();
   addTests({&MetadataMediatorTest::testDataset0,
             &MetadataMediatorTest::testDataset1,
-            &MetadataMediatorTest::testDatasetDelete});
+            &MetadataMediatorTest::testDatasetDelete,
+            &MetadataMediatorTest::testLazySceneInstanceLoading});
 
 }  // ctor
 
@@ -600,6 +603,40 @@ void MetadataMediatorTest::testDatasetDelete() {
 
 }  // testDatasetDelete
 
+void MetadataMediatorTest::testLazySceneInstanceLoading() {
+  reset();
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  cfg.sceneDatasetConfigFile = sceneDatasetConfigFile_1;
+  cfg.physicsConfigFile = physicsConfigFile;
+  cfg.lazySceneInstanceLoading = true;
+  MM_->setSimulatorConfiguration(cfg);
+
+  const auto& sceneInstanceAttributesMgr =
+      MM_->getSceneInstanceAttributesManager();
+  // nothing is loaded yet, but both file based scene instances are known
+  CORRADE_COMPARE(sceneInstanceAttributesMgr->getNumObjects(), 0);
+  const std::vector<std::string> sceneHandles =
+      MM_->getAllSceneInstanceHandles();
+  CORRADE_COMPARE(sceneHandles.size(), 2);
+
+  // requesting a scene instance loads only that one
+  auto sceneAttrs = MM_->getSceneInstanceAttributesByName(sceneHandles[0]);
+  CORRADE_VERIFY(sceneAttrs);
+  CORRADE_COMPARE(sceneAttrs->getHandle(), sceneHandles[0]);
+  CORRADE_COMPARE(sceneInstanceAttributesMgr->getNumObjects(), 1);
+  CORRADE_VERIFY(
+      sceneInstanceAttributesMgr->getObjectLibHasHandle(sceneHandles[0]));
+  CORRADE_COMPARE(MM_->getAllSceneInstanceHandles(), sceneHandles);
+
+  // requesting it again doesn't load it a second time
+  MM_->getSceneInstanceAttributesByName(sceneHandles[0]);
+  CORRADE_COMPARE(sceneInstanceAttributesMgr->getNumObjects(), 1);
+
+  MM_->getSceneInstanceAttributesByName(sceneHandles[1]);
+  CORRADE_COMPARE(sceneInstanceAttributesMgr->getNumObjects(), 2);
+  CORRADE_COMPARE(MM_->getAllSceneInstanceHandles(), sceneHandles);
+}  // testLazySceneInstanceLoading
+
 }  // namespace
 
 CORRADE_TEST_MAIN(MetadataMediatorTest)
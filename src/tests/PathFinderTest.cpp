@@ -6,6 +6,8 @@
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 
+#include <esp/assets/MeshData.h>
+#include <esp/nav/GreedyFollower.h>
 #include <esp/nav/PathFinder.h>
 
 #include <Corrade/Utility/Path.h>
@@ -14,6 +16,10 @@
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector3.h>
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 #include "configure.h"
 
 namespace Cr = Corrade;
@@ -37,11 +43,24 @@ struct PathFinderTest : Cr::TestSuite::Tester {
   void bounds();
   void tryStepNoSliding();
   void multiGoalPath();
+  void multiGoalDistanceField();
+  void findPathsBatched();
+  void geodesicDistanceMatrix();
+  void tryStepsBatched();
+  void tryStepsPolygonHints();
+  void randomNavigablePointsBatched();
+  void greedyFollowerBatch();
+  void queryContextThreads();
+  void topDownViewRasterized();
 
   void benchmarkSingleGoal();
   void benchmarkMultiGoal();
 
   void testCaching();
+  void buildTiled();
+  void saveLoadIslands();
+  void obstacleDistanceField();
+  void pathHierarchy();
 
   void navMeshSettingsTestJSON();
 
@@ -50,7 +69,20 @@ struct PathFinderTest : Cr::TestSuite::Tester {
 
 PathFinderTest::PathFinderTest() {
   addTests({&PathFinderTest::bounds, &PathFinderTest::tryStepNoSliding,
-            &PathFinderTest::multiGoalPath, &PathFinderTest::testCaching,
+            &PathFinderTest::multiGoalPath,
+            &PathFinderTest::multiGoalDistanceField,
+            &PathFinderTest::findPathsBatched,
+            &PathFinderTest::geodesicDistanceMatrix,
+            &PathFinderTest::tryStepsBatched,
+            &PathFinderTest::tryStepsPolygonHints,
+            &PathFinderTest::randomNavigablePointsBatched,
+            &PathFinderTest::greedyFollowerBatch,
+            &PathFinderTest::queryContextThreads,
+            &PathFinderTest::topDownViewRasterized,
+            &PathFinderTest::testCaching, &PathFinderTest::buildTiled,
+            &PathFinderTest::saveLoadIslands,
+            &PathFinderTest::obstacleDistanceField,
+            &PathFinderTest::pathHierarchy,
             &PathFinderTest::navMeshSettingsTestJSON});
 
   addBenchmarks({&PathFinderTest::benchmarkSingleGoal}, 1000);
@@ -135,6 +167,418 @@ void PathFinderTest::multiGoalPath() {
   }
 }
 
+void PathFinderTest::multiGoalDistanceField() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> ends;
+  ends.reserve(20);
+  for (int i = 0; i < 20; ++i) {
+    ends.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  esp::nav::MultiGoalShortestPath exactPath;
+  exactPath.setRequestedEnds(ends);
+  esp::nav::MultiGoalShortestPath fieldPath;
+  fieldPath.useDistanceField = true;
+  fieldPath.setRequestedEnds(ends);
+
+  // the same ends are queried from many starts, reusing one field
+  for (int i = 0; i < 200; ++i) {
+    CORRADE_ITERATION(i);
+    exactPath.requestedStart = pathFinder.getRandomNavigablePoint();
+    fieldPath.requestedStart = exactPath.requestedStart;
+
+    const bool exactFound = pathFinder.findPath(exactPath);
+    CORRADE_COMPARE(pathFinder.findPath(fieldPath), exactFound);
+    CORRADE_VERIFY(fieldPath.points.empty());
+    if (!exactFound) {
+      CORRADE_VERIFY(std::isinf(fieldPath.geodesicDistance));
+      CORRADE_COMPARE(fieldPath.closestEndPointIndex, -1);
+      continue;
+    }
+
+    CORRADE_VERIFY(fieldPath.closestEndPointIndex >= 0);
+    CORRADE_VERIFY(fieldPath.closestEndPointIndex < int(ends.size()));
+    // routing through polygon centers never beats the true shortest path and
+    // stays within a reasonable factor of it
+    CORRADE_COMPARE_AS(fieldPath.geodesicDistance,
+                       exactPath.geodesicDistance - 1e-3f,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(fieldPath.geodesicDistance,
+                       2.0f * exactPath.geodesicDistance + 0.5f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+
+  // new ends invalidate the field
+  fieldPath.setRequestedEnds({ends[0]});
+  fieldPath.requestedStart = ends[0];
+  CORRADE_VERIFY(pathFinder.findPath(fieldPath));
+  CORRADE_COMPARE(fieldPath.closestEndPointIndex, 0);
+  CORRADE_COMPARE(fieldPath.geodesicDistance, 0.0f);
+}
+
+void PathFinderTest::findPathsBatched() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::nav::ShortestPath> paths(500);
+  for (esp::nav::ShortestPath& path : paths) {
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+  }
+  // a start far off the navmesh can't be projected and must fail
+  paths[0].requestedStart = esp::vec3f{1000.0f, 1000.0f, 1000.0f};
+
+  std::vector<esp::nav::ShortestPath> serialPaths = paths;
+  int numSerialFound = 0;
+  for (esp::nav::ShortestPath& path : serialPaths) {
+    numSerialFound += pathFinder.findPath(path);
+  }
+  CORRADE_VERIFY(numSerialFound > 0);
+
+  for (int numThreads : {1, 4}) {
+    CORRADE_ITERATION(numThreads);
+    std::vector<esp::nav::ShortestPath> batchPaths = paths;
+    CORRADE_COMPARE(pathFinder.findPaths(batchPaths, numThreads),
+                    numSerialFound);
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(batchPaths[i].geodesicDistance,
+                      serialPaths[i].geodesicDistance);
+      CORRADE_COMPARE(batchPaths[i].points.size(),
+                      serialPaths[i].points.size());
+    }
+  }
+  CORRADE_VERIFY(std::isinf(serialPaths[0].geodesicDistance));
+}
+
+void PathFinderTest::geodesicDistanceMatrix() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  std::vector<Mn::Vector3> points = pathFinder.getRandomNavigablePoints(40, 7);
+  // a point far off the navmesh is infinitely far from everything
+  points.push_back({1000.0f, 1000.0f, 1000.0f});
+  const std::size_t numPoints = points.size();
+
+  const Eigen::MatrixXf distances =
+      pathFinder.geodesicDistanceMatrix(points, 1);
+  CORRADE_COMPARE(distances.rows(), numPoints);
+  CORRADE_COMPARE(distances.cols(), numPoints);
+  CORRADE_VERIFY(pathFinder.geodesicDistanceMatrix(points, 4) == distances);
+
+  for (std::size_t i = 0; i < numPoints - 1; ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(distances(i, i), 0.0f);
+    CORRADE_VERIFY(std::isinf(distances(i, numPoints - 1)));
+    CORRADE_VERIFY(std::isinf(distances(numPoints - 1, i)));
+    for (std::size_t j = i + 1; j < numPoints - 1; ++j) {
+      CORRADE_ITERATION(j);
+      CORRADE_COMPARE_WITH(distances(i, j), distances(j, i),
+                           Cr::TestSuite::Compare::around(1e-3f));
+
+      // not much longer than the path Detour finds
+      esp::nav::ShortestPath path;
+      path.requestedStart = Mn::EigenIntegration::cast<esp::vec3f>(points[i]);
+      path.requestedEnd = Mn::EigenIntegration::cast<esp::vec3f>(points[j]);
+      if (!pathFinder.findPath(path)) {
+        CORRADE_VERIFY(std::isinf(distances(i, j)));
+        continue;
+      }
+      CORRADE_COMPARE_AS(distances(i, j),
+                         1.5f * path.geodesicDistance + 0.5f,
+                         Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+}
+
+void PathFinderTest::tryStepsBatched() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<Mn::Vector3> starts, ends;
+  for (int i = 0; i < 500; ++i) {
+    starts.emplace_back(pathFinder.getRandomNavigablePoint());
+    ends.push_back(starts.back() + Mn::Vector3{0.0f, 0.0f, -1.0f});
+  }
+
+  for (bool allowSliding : {true, false}) {
+    for (int numThreads : {1, 4}) {
+      CORRADE_ITERATION(allowSliding << numThreads);
+      const std::vector<Mn::Vector3> results =
+          pathFinder.trySteps(starts, ends, allowSliding, numThreads);
+      CORRADE_COMPARE(results.size(), starts.size());
+      for (std::size_t i = 0; i < starts.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(results[i],
+                        allowSliding
+                            ? pathFinder.tryStep(starts[i], ends[i])
+                            : pathFinder.tryStepNoSliding(starts[i], ends[i]));
+      }
+    }
+  }
+}
+
+void PathFinderTest::tryStepsPolygonHints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<Mn::Vector3> positions;
+  for (int i = 0; i < 100; ++i) {
+    positions.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  // walking with the polygons of the previous steps ends up in the same
+  // places as searching for the start polygon every time
+  std::vector<std::uint64_t> polygonHints;
+  for (int step = 0; step < 10; ++step) {
+    CORRADE_ITERATION(step);
+    std::vector<Mn::Vector3> ends;
+    for (const Mn::Vector3& position : positions) {
+      ends.push_back(position + Mn::Vector3{0.25f, 0.0f, -0.25f});
+    }
+    const std::vector<Mn::Vector3> results =
+        pathFinder.trySteps(positions, ends, polygonHints);
+    CORRADE_COMPARE(polygonHints.size(), positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE(results[i], pathFinder.tryStep(positions[i], ends[i]));
+      CORRADE_VERIFY(polygonHints[i] != 0);
+    }
+    positions = results;
+  }
+
+  // a stale hint is ignored
+  std::uint64_t hint = polygonHints[0];
+  const Mn::Vector3 start = pathFinder.getRandomNavigablePoint();
+  const Mn::Vector3 end = start + Mn::Vector3{0.0f, 0.0f, -0.25f};
+  CORRADE_COMPARE(pathFinder.tryStep(start, end, hint),
+                  pathFinder.tryStep(start, end));
+}
+
+void PathFinderTest::randomNavigablePointsBatched() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  const std::vector<Mn::Vector3> points =
+      pathFinder.getRandomNavigablePoints(10000, 42, esp::ID_UNDEFINED, 1);
+  CORRADE_COMPARE(points.size(), 10000);
+  for (std::size_t i = 0; i < points.size(); i += 97) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(pathFinder.isNavigable(
+        Mn::EigenIntegration::cast<esp::vec3f>(points[i])));
+  }
+
+  // the same seed gives the same points regardless of the thread count
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(
+                     10000, 42, esp::ID_UNDEFINED, 4) == points);
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(
+                     10000, 43, esp::ID_UNDEFINED, 4) != points);
+
+  // island-specific points stay on the island
+  const int islandIndex = pathFinder.getIsland(points[0]);
+  const std::vector<Mn::Vector3> islandPoints =
+      pathFinder.getRandomNavigablePoints(500, 7, islandIndex);
+  CORRADE_COMPARE(islandPoints.size(), 500);
+  for (std::size_t i = 0; i < islandPoints.size(); i += 23) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(pathFinder.getIsland(islandPoints[i]), islandIndex);
+  }
+
+  CORRADE_VERIFY(
+      pathFinder.getRandomNavigablePoints(0, 42, esp::ID_UNDEFINED).empty());
+}
+
+void PathFinderTest::greedyFollowerBatch() {
+  auto pathFinder = esp::nav::PathFinder::create();
+  pathFinder->loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder->isLoaded());
+  pathFinder->seed(0);
+
+  constexpr int numAgents = 32;
+  constexpr float goalRadius = 0.2f;
+  const double turnAmount = float(Mn::Rad{Mn::Deg{10.0f}});
+  std::vector<esp::core::RigidState> states;
+  std::vector<Mn::Vector3> goals;
+  while (states.size() < numAgents) {
+    esp::nav::ShortestPath path;
+    path.requestedStart = pathFinder->getRandomNavigablePoint();
+    path.requestedEnd = pathFinder->getRandomNavigablePoint();
+    if (!pathFinder->findPath(path) || path.geodesicDistance > 10.0f) {
+      continue;
+    }
+    states.emplace_back(Mn::Quaternion{}, Mn::Vector3{path.requestedStart});
+    goals.emplace_back(path.requestedEnd);
+  }
+
+  // agents always map to the same query context, so the result doesn't
+  // depend on the thread count
+  typedef esp::nav::GreedyGeodesicFollowerImpl::CODES CODES;
+  std::vector<std::vector<CODES>> expectedPaths;
+  for (int numThreads : {1, 4}) {
+    CORRADE_ITERATION(numThreads);
+    esp::nav::GreedyGeodesicFollowerBatch batch{pathFinder, numAgents,
+                                                goalRadius, 0.25, turnAmount,
+                                                /*allowSliding=*/true,
+                                                /*fixThrashing=*/true, 16,
+                                                numThreads};
+    CORRADE_COMPARE(batch.numAgents(), numAgents);
+
+    const auto paths = batch.findPaths(states, goals);
+    if (expectedPaths.empty()) {
+      expectedPaths = paths;
+    } else {
+      CORRADE_VERIFY(paths == expectedPaths);
+    }
+
+    // stepping through the actions one at a time ends at the goals
+    std::vector<esp::core::RigidState> rollout = states;
+    std::vector<CODES> actions;
+    for (int step = 0; step < 1000; ++step) {
+      actions = batch.step(rollout, goals);
+      if (std::all_of(actions.begin(), actions.end(), [](CODES action) {
+            return action == CODES::STOP || action == CODES::ERROR;
+          })) {
+        break;
+      }
+    }
+    for (int i = 0; i < numAgents; ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_VERIFY(actions[i] == CODES::STOP);
+      esp::nav::ShortestPath path;
+      path.requestedStart =
+          Mn::EigenIntegration::cast<esp::vec3f>(rollout[i].translation);
+      path.requestedEnd = Mn::EigenIntegration::cast<esp::vec3f>(goals[i]);
+      CORRADE_VERIFY(pathFinder->findPath(path));
+      CORRADE_COMPARE_AS(path.geodesicDistance, goalRadius,
+                         Cr::TestSuite::Compare::Less);
+    }
+  }
+}
+
+void PathFinderTest::queryContextThreads() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  constexpr int numThreads = 4;
+  constexpr int numQueries = 200;
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < numQueries + 1; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  struct Result {
+    bool navigable = false;
+    esp::vec3f snapped;
+    esp::vec3f stepped;
+    float obstacleDist = 0.0f;
+    float geodesicDistance = 0.0f;
+  };
+  auto runQueries = [&](auto& queries) {
+    std::vector<Result> results(numQueries);
+    for (int i = 0; i < numQueries; ++i) {
+      const esp::vec3f offset = points[i] + esp::vec3f{0.1f, 0.2f, 0.1f};
+      results[i].navigable = queries.isNavigable(points[i]);
+      results[i].snapped = queries.snapPoint(offset);
+      results[i].stepped = queries.tryStep(points[i], points[i + 1]);
+      results[i].obstacleDist = queries.distanceToClosestObstacle(points[i]);
+      esp::nav::ShortestPath path;
+      path.requestedStart = points[i];
+      path.requestedEnd = points[i + 1];
+      queries.findPath(path);
+      results[i].geodesicDistance = path.geodesicDistance;
+    }
+    return results;
+  };
+
+  const std::vector<Result> expected = runQueries(pathFinder);
+
+  std::vector<std::vector<Result>> threadResults(numThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      esp::nav::PathFinderQueryContext::ptr context =
+          pathFinder.createQueryContext();
+      threadResults[t] = runQueries(*context);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < numThreads; ++t) {
+    CORRADE_ITERATION(t);
+    for (int i = 0; i < numQueries; ++i) {
+      CORRADE_ITERATION(i);
+      const Result& actual = threadResults[t][i];
+      CORRADE_COMPARE(actual.navigable, expected[i].navigable);
+      CORRADE_VERIFY(actual.snapped.isApprox(expected[i].snapped));
+      CORRADE_VERIFY(actual.stepped.isApprox(expected[i].stepped));
+      CORRADE_COMPARE(actual.obstacleDist, expected[i].obstacleDist);
+      CORRADE_COMPARE(actual.geodesicDistance, expected[i].geodesicDistance);
+    }
+  }
+
+  // island-restricted snapping lands on the requested island
+  esp::nav::PathFinderQueryContext context{pathFinder};
+  for (int i = 0; i < numQueries; ++i) {
+    CORRADE_ITERATION(i);
+    const int island = pathFinder.getIsland(points[i]);
+    const esp::vec3f snapped = context.snapPoint(points[i], island);
+    CORRADE_VERIFY(snapped.isApprox(pathFinder.snapPoint(points[i], island)));
+    CORRADE_COMPARE(pathFinder.getIsland(snapped), island);
+  }
+
+  // contexts keep their navmesh alive when the PathFinder is reloaded
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_COMPARE(context.isNavigable(points[0]), expected[0].navigable);
+}
+
+void PathFinderTest::topDownViewRasterized() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  const float height = pathFinder.bounds().first[1];
+  const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> sampled =
+      pathFinder.getTopDownView(0.1f, height);
+  const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> rasterized =
+      pathFinder.getTopDownView(0.1f, height, 0.5f, true);
+  CORRADE_COMPARE(rasterized.rows(), sampled.rows());
+  CORRADE_COMPARE(rasterized.cols(), sampled.cols());
+  CORRADE_VERIFY(sampled.count() > 0);
+
+  // only cells right at polygon borders may disagree
+  const Eigen::Index numDifferent = (rasterized.array() != sampled.array())
+                                        .cast<Eigen::Index>()
+                                        .sum();
+  CORRADE_COMPARE_AS(numDifferent, sampled.count() / 50,
+                     Cr::TestSuite::Compare::LessOrEqual);
+
+  const Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic> islands =
+      pathFinder.getTopDownIslandView(0.1f, height, 0.5f, true);
+  CORRADE_COMPARE(islands.rows(), rasterized.rows());
+  CORRADE_COMPARE(islands.cols(), rasterized.cols());
+  CORRADE_VERIFY(((islands.array() >= 0) == rasterized.array()).all());
+
+  // repeated queries are answered from the cache
+  CORRADE_VERIFY(pathFinder.getTopDownView(0.1f, height, 0.5f, true) ==
+                 rasterized);
+}
+
 void PathFinderTest::testCaching() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
@@ -211,6 +655,244 @@ void PathFinderTest::benchmarkMultiGoal() {
   CORRADE_VERIFY(status);
 }
 
+void PathFinderTest::buildTiled() {
+  // the triangulated navmesh is a convenient walkable input to build from
+  esp::nav::PathFinder source;
+  source.loadNavMesh(skokloster);
+  CORRADE_VERIFY(source.isLoaded());
+  esp::assets::MeshData mesh = *source.getNavMeshData();
+
+  esp::nav::NavMeshSettings settings;
+  esp::nav::PathFinder single;
+  CORRADE_VERIFY(single.build(settings, mesh));
+
+  settings.tileSize = 2.0f;
+  esp::nav::PathFinder tiled;
+  CORRADE_VERIFY(tiled.build(settings, mesh));
+  CORRADE_COMPARE(tiled.getNavMeshSettings()->tileSize, 2.0f);
+  // tile borders split polygons, but the walkable surface stays the same
+  CORRADE_COMPARE_WITH(
+      tiled.getNavigableArea(), single.getNavigableArea(),
+      Cr::TestSuite::Compare::around(0.02f * single.getNavigableArea()));
+
+  // cut a hole around a point in the open
+  tiled.seed(0);
+  esp::vec3f hole;
+  do {
+    hole = tiled.getRandomNavigablePoint();
+  } while (tiled.distanceToClosestObstacle(hole) < 1.0f);
+  std::vector<uint32_t> ibo;
+  for (std::size_t i = 0; i < mesh.ibo.size(); i += 3) {
+    const esp::vec3f centroid =
+        (mesh.vbo[mesh.ibo[i]] + mesh.vbo[mesh.ibo[i + 1]] +
+         mesh.vbo[mesh.ibo[i + 2]]) /
+        3.0f;
+    if (Eigen::Vector2f(centroid[0] - hole[0], centroid[2] - hole[2]).norm() >
+        0.75f) {
+      ibo.insert(ibo.end(), &mesh.ibo[i], &mesh.ibo[i] + 3);
+    }
+  }
+  CORRADE_VERIFY(ibo.size() < mesh.ibo.size());
+  mesh.ibo = std::move(ibo);
+  const std::map<std::pair<int, int>, uint64_t> revisions =
+      tiled.getNavMeshTileRevisions();
+  CORRADE_COMPARE_AS(revisions.size(), std::size_t{1},
+                     Cr::TestSuite::Compare::Greater);
+
+  // the incremental rebuild only redoes the tiles around the hole, and has
+  // to agree with a full build of the changed input
+  CORRADE_VERIFY(tiled.build(settings, mesh));
+  CORRADE_VERIFY(!tiled.isNavigable(hole, 0.1f));
+
+  // only the rebuilt tiles get new revisions
+  std::size_t numChanged = 0;
+  for (const auto& revision : tiled.getNavMeshTileRevisions()) {
+    const auto found = revisions.find(revision.first);
+    numChanged += found == revisions.end() || found->second != revision.second;
+  }
+  CORRADE_COMPARE_AS(numChanged, std::size_t{0},
+                     Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE_AS(numChanged, revisions.size() / 2,
+                     Cr::TestSuite::Compare::Less);
+  const std::pair<int, int> tile =
+      tiled.getNavMeshTileRevisions().begin()->first;
+  CORRADE_VERIFY(
+      !tiled.getNavMeshTileData(tile.first, tile.second)->ibo.empty());
+  CORRADE_VERIFY(tiled.getNavMeshTileData(-1, -1)->ibo.empty());
+  esp::nav::PathFinder full;
+  CORRADE_VERIFY(full.build(settings, mesh));
+  CORRADE_COMPARE(tiled.getNavigableArea(), full.getNavigableArea());
+  CORRADE_COMPARE(tiled.numIslands(), full.numIslands());
+  full.seed(0);
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    const esp::vec3f point = full.getRandomNavigablePoint();
+    CORRADE_VERIFY(tiled.isNavigable(point));
+  }
+}
+
+void PathFinderTest::saveLoadIslands() {
+  esp::nav::PathFinder original;
+  original.loadNavMesh(skokloster);
+  CORRADE_VERIFY(original.isLoaded());
+
+  const auto testFilepath =
+      Cr::Utility::Path::join(TEST_ASSETS, "test_save_load_islands.navmesh");
+  CORRADE_VERIFY(original.saveNavMesh(testFilepath));
+
+  // the islands are read back from the file instead of being recomputed
+  esp::nav::PathFinder reloaded;
+  CORRADE_VERIFY(reloaded.loadNavMesh(testFilepath));
+  CORRADE_COMPARE(reloaded.numIslands(), original.numIslands());
+  CORRADE_COMPARE(reloaded.getNavigableArea(), original.getNavigableArea());
+  for (int i = 0; i < original.numIslands(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(reloaded.islandRadius(i), original.islandRadius(i));
+    CORRADE_COMPARE(reloaded.getNavigableArea(i),
+                    original.getNavigableArea(i));
+  }
+
+  original.seed(0);
+  for (int i = 0; i < 100; ++i) {
+    CORRADE_ITERATION(i);
+    const esp::vec3f point = original.getRandomNavigablePoint();
+    CORRADE_VERIFY(reloaded.isNavigable(point));
+    CORRADE_COMPARE(reloaded.getIsland(point), original.getIsland(point));
+  }
+
+  // the navmesh stays valid after the file it was mapped from is gone
+  CORRADE_VERIFY(Cr::Utility::Path::remove(testFilepath));
+  esp::nav::ShortestPath path;
+  path.requestedStart = original.getRandomNavigablePoint();
+  path.requestedEnd = original.getRandomNavigablePoint();
+  CORRADE_COMPARE(reloaded.findPath(path), original.findPath(path));
+}
+
+void PathFinderTest::obstacleDistanceField() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  CORRADE_VERIFY(!pathFinder.hasObstacleDistanceField());
+
+  const std::vector<Mn::Vector3> points =
+      pathFinder.getRandomNavigablePoints(500, 3);
+  const std::vector<float> exact =
+      pathFinder.distancesToClosestObstacle(points, 2.0f, 4);
+  CORRADE_COMPARE(exact.size(), points.size());
+  for (std::size_t i = 0; i < points.size(); i += 50) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(exact[i], pathFinder.distanceToClosestObstacle(
+                                  Mn::EigenIntegration::cast<esp::vec3f>(
+                                      points[i])));
+  }
+
+  // interpolated distances are off by at most about the sample spacing
+  pathFinder.buildObstacleDistanceField(0.05f, 2.0f);
+  CORRADE_VERIFY(pathFinder.hasObstacleDistanceField());
+  const std::vector<float> interpolated =
+      pathFinder.distancesToClosestObstacle(points, 2.0f, 4);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE_WITH(interpolated[i], exact[i],
+                         Cr::TestSuite::Compare::around(0.1f));
+    CORRADE_COMPARE(interpolated[i],
+                    pathFinder.distanceToClosestObstacle(
+                        Mn::EigenIntegration::cast<esp::vec3f>(points[i])));
+  }
+
+  // the field is saved with the navmesh and discarded when it changes
+  const auto testFilepath = Cr::Utility::Path::join(
+      TEST_ASSETS, "test_obstacle_distance_field.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(testFilepath));
+  esp::nav::PathFinder reloaded;
+  CORRADE_VERIFY(reloaded.loadNavMesh(testFilepath));
+  CORRADE_VERIFY(reloaded.hasObstacleDistanceField());
+  CORRADE_VERIFY(reloaded.distancesToClosestObstacle(points) == interpolated);
+  CORRADE_VERIFY(Cr::Utility::Path::remove(testFilepath));
+
+  CORRADE_VERIFY(reloaded.loadNavMesh(skokloster));
+  CORRADE_VERIFY(!reloaded.hasObstacleDistanceField());
+  pathFinder.clearObstacleDistanceField();
+  CORRADE_VERIFY(!pathFinder.hasObstacleDistanceField());
+  CORRADE_VERIFY(pathFinder.distancesToClosestObstacle(points) == exact);
+}
+
+void PathFinderTest::pathHierarchy() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  CORRADE_VERIFY(!pathFinder.hasPathHierarchy());
+  pathFinder.seed(0);
+
+  std::vector<esp::nav::ShortestPath> paths(200);
+  for (esp::nav::ShortestPath& path : paths) {
+    path.requestedStart = pathFinder.getRandomNavigablePoint();
+    path.requestedEnd = pathFinder.getRandomNavigablePoint();
+  }
+  std::vector<esp::nav::ShortestPath> direct = paths;
+  const int numFound = pathFinder.findPaths(direct);
+  CORRADE_VERIFY(numFound > 0);
+
+  // small regions so most of the paths go through the portals
+  pathFinder.buildPathHierarchy(8, 4);
+  CORRADE_VERIFY(pathFinder.hasPathHierarchy());
+  std::vector<esp::nav::ShortestPath> hierarchical = paths;
+  CORRADE_COMPARE(pathFinder.findPaths(hierarchical), numFound);
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    CORRADE_ITERATION(i);
+    if (std::isinf(direct[i].geodesicDistance)) {
+      CORRADE_VERIFY(std::isinf(hierarchical[i].geodesicDistance));
+      continue;
+    }
+    // the refined path isn't much longer than the direct one, and ends at
+    // the same points
+    CORRADE_COMPARE_AS(hierarchical[i].geodesicDistance,
+                       1.5f * direct[i].geodesicDistance + 0.5f,
+                       Cr::TestSuite::Compare::LessOrEqual);
+    CORRADE_VERIFY(hierarchical[i].points.front().isApprox(
+        direct[i].points.front(), 1e-4f));
+    CORRADE_VERIFY(
+        hierarchical[i].points.back().isApprox(direct[i].points.back(), 1e-4f));
+  }
+
+  // query contexts use the hierarchy as well
+  esp::nav::PathFinderQueryContext::ptr context =
+      pathFinder.createQueryContext();
+  for (std::size_t i = 0; i < paths.size(); i += 20) {
+    CORRADE_ITERATION(i);
+    esp::nav::ShortestPath path = paths[i];
+    context->findPath(path);
+    CORRADE_COMPARE(path.geodesicDistance, hierarchical[i].geodesicDistance);
+  }
+
+  // the hierarchy is saved with the navmesh and discarded when it changes
+  const auto testFilepath =
+      Cr::Utility::Path::join(TEST_ASSETS, "test_path_hierarchy.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(testFilepath));
+  esp::nav::PathFinder reloaded;
+  CORRADE_VERIFY(reloaded.loadNavMesh(testFilepath));
+  CORRADE_VERIFY(reloaded.hasPathHierarchy());
+  std::vector<esp::nav::ShortestPath> reloadedPaths = paths;
+  CORRADE_COMPARE(reloaded.findPaths(reloadedPaths), numFound);
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(reloadedPaths[i].geodesicDistance,
+                    hierarchical[i].geodesicDistance);
+  }
+  CORRADE_VERIFY(Cr::Utility::Path::remove(testFilepath));
+
+  CORRADE_VERIFY(reloaded.loadNavMesh(skokloster));
+  CORRADE_VERIFY(!reloaded.hasPathHierarchy());
+  pathFinder.clearPathHierarchy();
+  CORRADE_VERIFY(!pathFinder.hasPathHierarchy());
+  std::vector<esp::nav::ShortestPath> cleared = paths;
+  pathFinder.findPaths(cleared);
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(cleared[i].geodesicDistance, direct[i].geodesicDistance);
+  }
+}
+
 void PathFinderTest::navMeshSettingsTestJSON() {
   esp::nav::NavMeshSettings navmeshSettings;
 
@@ -5,6 +5,7 @@
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
+#include <cmath>
 #include <string>
 
 #include "esp/sim/Simulator.h"
@@ -13,9 +14,14 @@
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/scene/SceneManager.h"
 
+#include "esp/physics/BatchedPhysicsBackend.h"
 #include "esp/physics/PhysicsManager.h"
+#include "esp/physics/URDFModelBundle.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #ifdef ESP_BUILD_WITH_BULLET
+#include "esp/physics/bullet/BulletConvexDecomposition.h"
+#include "esp/physics/bullet/BulletStageBvhCache.h"
+#include "esp/physics/bullet/BulletURDFImporter.h"
 #include "esp/physics/bullet/BulletPhysicsManager.h"
 #include "esp/physics/bullet/objectWrappers/ManagedBulletRigidObject.h"
 #endif
@@ -74,13 +80,17 @@ struct PhysicsTest : Cr::TestSuite::Tester {
     sceneID_ = sceneManager_->initSceneGraph();
   }
 
-  void initStage(const std::string& stageFile) {
+  void initStage(const std::string& stageFile,
+                 esp::metadata::attributes::PhysicsManagerAttributes::ptr
+                     physicsManagerAttributes = nullptr) {
     auto& sceneGraph = sceneManager_->getSceneGraph(sceneID_);
     auto& rootNode = sceneGraph.getRootNode();
 
     // construct appropriate physics attributes based on config file
-    auto physicsManagerAttributes =
-        physicsAttributesManager_->createObject(physicsConfigFile, true);
+    if (!physicsManagerAttributes) {
+      physicsManagerAttributes =
+          physicsAttributesManager_->createObject(physicsConfigFile, true);
+    }
     auto stageAttributesMgr = metadataMediator_->getStageAttributesManager();
     if (physicsManagerAttributes != nullptr) {
       stageAttributesMgr->setCurrPhysicsManagerAttributesHandle(
@@ -147,9 +157,21 @@ struct PhysicsTest : Cr::TestSuite::Tester {
   void testConfigurableScaling();
   void testVelocityControl();
   void testSceneNodeAttachment();
+  void testObjectPooling();
+  void testWrapperSharingAndBulkAccess();
+  void testBatchedBackend();
   void testMotionTypes();
   void testNumActiveContactPoints();
   void testRemoveSleepingSupport();
+  void testDeferredNodeUpdates();
+  void testContactEvents();
+  void testConvexDecomposition();
+  void testStageBvhCache();
+  void testURDFModelBundle();
+  void testDeterministicThreading();
+  void testSubstepBudget();
+  void testWorldClone();
+  void testRigidConstraintBatch();
   /////
 
   esp::logging::LoggingContext loggingContext_;
@@ -183,10 +205,22 @@ PhysicsTest::PhysicsTest() {
           &PhysicsTest::testMotionTypes,
           &PhysicsTest::testRemoveSleepingSupport,
           &PhysicsTest::testNumActiveContactPoints,
+          &PhysicsTest::testDeferredNodeUpdates,
+          &PhysicsTest::testContactEvents,
+          &PhysicsTest::testConvexDecomposition,
+          &PhysicsTest::testStageBvhCache,
+          &PhysicsTest::testURDFModelBundle,
+          &PhysicsTest::testDeterministicThreading,
+          &PhysicsTest::testSubstepBudget,
+          &PhysicsTest::testWorldClone,
+          &PhysicsTest::testRigidConstraintBatch,
 #endif
           &PhysicsTest::testConfigurableScaling,
           &PhysicsTest::testVelocityControl,
-          &PhysicsTest::testSceneNodeAttachment},
+          &PhysicsTest::testSceneNodeAttachment,
+          &PhysicsTest::testObjectPooling,
+          &PhysicsTest::testWrapperSharingAndBulkAccess,
+          &PhysicsTest::testBatchedBackend},
       Cr::Containers::arraySize(RendererEnabledData));
 }
 
@@ -750,18 +784,530 @@ void PhysicsTest::testNumActiveContactPoints() {
     CORRADE_COMPARE_AS(totalNormalForce - 9.8, 3.0e-4,
                        Cr::TestSuite::Compare::LessOrEqual);
 
+    // filtered queries overwrite the caller's buffer
+    const int cubeId = esp::RIGID_STAGE_ID + 1;
+    std::vector<esp::physics::ContactPointData> filteredContactPoints(7);
+    esp::physics::ContactPointFilter filter;
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 4);
+    // pairs match in either order and ID_UNDEFINED matches anything
+    filter.objectPairs = {{esp::RIGID_STAGE_ID, cubeId}};
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 4);
+    filter.objectPairs = {{cubeId, esp::ID_UNDEFINED}};
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 4);
+    filter.objectPairs = {{cubeId, cubeId + 1}};
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 0);
+    filter.objectPairs.clear();
+    filter.links = {{cubeId, -1}};
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 4);
+    CORRADE_COMPARE(filteredContactPoints[0].objectIdA, cubeId);
+    filter.links = {{cubeId, 0}};
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 0);
+    filter.links.clear();
+
     // continue simulation until the cube is stable and sleeping
     while (physicsManager_->getWorldTime() < 4.0) {
       physicsManager_->stepPhysics(0.1);
     }
     // 4 inactive contact points at end
     CORRADE_COMPARE(physicsManager_->getContactPoints().size(), 4);
+    filter.activeOnly = true;
+    physicsManager_->getContactPoints(filter, filteredContactPoints);
+    CORRADE_COMPARE(filteredContactPoints.size(), 0);
     // no active contact points at end
     CORRADE_COMPARE(physicsManager_->getNumActiveContactPoints(), 0);
     CORRADE_COMPARE(physicsManager_->getNumActiveOverlappingPairs(), 0);
   }
 }  // PhysicsTest::testNumActiveContactPoints
 
+void PhysicsTest::testDeferredNodeUpdates() {
+  // test that deferred node updates reach awake objects and leave sleeping
+  // ones alone
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  initStage("NONE");
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+
+  std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+
+  // a cube resting on a static one falls asleep
+  auto support = makeObjectGetWrapper(cubeHandle, &drawables);
+  support->setMotionType(esp::physics::MotionType::STATIC);
+  auto sleeping = makeObjectGetWrapper(cubeHandle, &drawables);
+  sleeping->setTranslation({0, 0.2, 0});
+  while (physicsManager_->getWorldTime() < 4.0) {
+    physicsManager_->stepPhysics(0.1);
+  }
+  CORRADE_VERIFY(!sleeping->isActive());
+
+  auto falling = makeObjectGetWrapper(cubeHandle, &drawables);
+  falling->setTranslation({2.0, 2.0, 0});
+  const Mn::Vector3 sleepingTranslation = sleeping->getTranslation();
+
+  physicsManager_->deferNodesUpdate();
+  physicsManager_->stepPhysics(0.1);
+  // nodes don't move until the deferred updates are applied
+  CORRADE_COMPARE(falling->getSceneNode()->translation(),
+                  Mn::Vector3(2.0, 2.0, 0));
+
+  physicsManager_->updateNodes();
+  CORRADE_COMPARE_AS(falling->getSceneNode()->translation().y(), 2.0f,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE(sleeping->getTranslation(), sleepingTranslation);
+
+  // updates are applied directly again afterwards
+  const float fallenY = falling->getSceneNode()->translation().y();
+  physicsManager_->stepPhysics(0.1);
+  CORRADE_COMPARE_AS(falling->getSceneNode()->translation().y(), fallenY,
+                     Cr::TestSuite::Compare::Less);
+}  // PhysicsTest::testDeferredNodeUpdates
+
+void PhysicsTest::testContactEvents() {
+  // test contact events of a cube dropped onto another one
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  initStage("NONE");
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+
+  std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+  auto support = makeObjectGetWrapper(cubeHandle, &drawables);
+  support->setMotionType(esp::physics::MotionType::STATIC);
+  auto falling = makeObjectGetWrapper(cubeHandle, &drawables);
+  falling->setTranslation({0, 0.5, 0});
+  physicsManager_->subscribeContactEvents(falling->getID());
+
+  std::size_t callbackEventCount = 0;
+  physicsManager_->setContactEventCallback(
+      [&](const std::vector<esp::physics::ContactEvent>& events) {
+        callbackEventCount += events.size();
+      });
+
+  // the cube only touches the support once it landed
+  bool landed = false;
+  std::size_t eventCount = 0;
+  while (!landed && physicsManager_->getWorldTime() < 2.0) {
+    physicsManager_->stepPhysics(0.1);
+    for (const auto& event : physicsManager_->getContactEvents()) {
+      ++eventCount;
+      if (event.type == esp::physics::ContactEventType::Begin) {
+        landed = true;
+        CORRADE_COMPARE(event.objectIdA, support->getID());
+        CORRADE_COMPARE(event.objectIdB, falling->getID());
+        CORRADE_COMPARE(event.linkIndexA, -1);
+        CORRADE_COMPARE_AS(event.numContactPoints, 0,
+                           Cr::TestSuite::Compare::Greater);
+      }
+    }
+  }
+  CORRADE_VERIFY(landed);
+  CORRADE_COMPARE(callbackEventCount, eventCount);
+
+  // a resting contact persists through each step
+  while (physicsManager_->getWorldTime() < 4.0) {
+    physicsManager_->stepPhysics(0.1);
+  }
+  CORRADE_COMPARE(physicsManager_->getContactEvents().size(), 1);
+  CORRADE_COMPARE(physicsManager_->getContactEvents()[0].type,
+                  esp::physics::ContactEventType::Persist);
+
+  // moving the cube away ends the contact
+  falling->setTranslation({0, 5.0, 0});
+  physicsManager_->stepPhysics(0.1);
+  CORRADE_COMPARE(physicsManager_->getContactEvents().size(), 1);
+  CORRADE_COMPARE(physicsManager_->getContactEvents()[0].type,
+                  esp::physics::ContactEventType::End);
+  CORRADE_COMPARE(physicsManager_->getContactEvents()[0].numContactPoints, 0);
+
+  // no events once unsubscribed
+  physicsManager_->unsubscribeContactEvents(falling->getID());
+  falling->setTranslation({0, 0.2, 0});
+  physicsManager_->stepPhysics(0.1);
+  CORRADE_VERIFY(physicsManager_->getContactEvents().empty());
+}  // PhysicsTest::testContactEvents
+
+void PhysicsTest::testConvexDecomposition() {
+  // test that a concave object is decomposed into several hulls, which are
+  // cached for later instances
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  initStage("NONE");
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+
+  const int maxHulls = 8;
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/donut.glb");
+  auto objectAttributesManager =
+      metadataMediator_->getObjectAttributesManager();
+  ObjectAttributes::ptr objectTemplate = ObjectAttributes::create();
+  objectTemplate->setRenderAssetHandle(objectFile);
+  objectTemplate->setConvexDecompositionMaxHulls(maxHulls);
+  objectAttributesManager->registerObject(objectTemplate, objectFile);
+  const std::string collisionAssetHandle =
+      objectAttributesManager->getObjectCopyByHandle(objectFile)
+          ->getCollisionAssetHandle();
+
+  const std::string cacheFilename =
+      esp::physics::getConvexDecompositionCacheFilename(collisionAssetHandle,
+                                                        maxHulls);
+  if (Cr::Utility::Path::exists(cacheFilename)) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+  }
+
+  // the first instance decomposes the asset and caches the hulls
+  auto first = rigidObjectManager_->addObjectByHandle(objectFile);
+  CORRADE_VERIFY(first);
+  CORRADE_VERIFY(Cr::Utility::Path::exists(cacheFilename));
+
+  esp::physics::ConvexDecomposition cached;
+  CORRADE_VERIFY(esp::physics::loadConvexDecompositionFromCache(
+      cacheFilename, collisionAssetHandle, cached));
+  // the hole makes the donut concave
+  CORRADE_COMPARE_AS(int(cached.size()), 1, Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE_AS(int(cached.size()), maxHulls,
+                     Cr::TestSuite::Compare::LessOrEqual);
+
+  esp::physics::ConvexDecomposition computed =
+      esp::physics::computeConvexDecomposition(
+          resourceManager_->getCollisionMesh(collisionAssetHandle),
+          resourceManager_->getMeshMetaData(collisionAssetHandle).root,
+          maxHulls);
+  CORRADE_COMPARE(computed.size(), cached.size());
+  for (std::size_t i = 0; i != computed.size(); ++i) {
+    CORRADE_COMPARE(computed[i].size(), cached[i].size());
+  }
+
+  // a convex object stays a single hull
+  std::string sphereFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/sphere.glb");
+  ObjectAttributes::ptr sphereTemplate = ObjectAttributes::create();
+  sphereTemplate->setRenderAssetHandle(sphereFile);
+  objectAttributesManager->registerObject(sphereTemplate, sphereFile);
+  const std::string sphereAssetHandle =
+      objectAttributesManager->getObjectCopyByHandle(sphereFile)
+          ->getCollisionAssetHandle();
+  CORRADE_VERIFY(rigidObjectManager_->addObjectByHandle(sphereFile));
+  CORRADE_COMPARE(esp::physics::computeConvexDecomposition(
+                      resourceManager_->getCollisionMesh(sphereAssetHandle),
+                      resourceManager_->getMeshMetaData(sphereAssetHandle).root,
+                      maxHulls)
+                      .size(),
+                  1);
+
+  // later instances load the cached hulls
+  auto second = rigidObjectManager_->addObjectByHandle(objectFile);
+  CORRADE_VERIFY(second);
+
+  rigidObjectManager_->removeAllObjects();
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+}  // PhysicsTest::testConvexDecomposition
+
+void PhysicsTest::testStageBvhCache() {
+  // test that stage collision bvhs are cached on first load and that a stage
+  // using the cached bvhs collides the same as a freshly built one
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/simple_room.glb");
+  const std::string cacheFilename =
+      esp::physics::getStageBvhCacheFilename(stageFile);
+  if (Cr::Utility::Path::exists(cacheFilename)) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+  }
+
+  initStage(stageFile);
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+  CORRADE_VERIFY(Cr::Utility::Path::exists(cacheFilename));
+
+  // rays through the origin from outside the stage along all axes
+  std::vector<esp::geo::Ray> rays;
+  for (const Mn::Vector3& axis : {Mn::Vector3::xAxis(), Mn::Vector3::yAxis(),
+                                  Mn::Vector3::zAxis()}) {
+    rays.emplace_back(axis * 50.0f, -axis);
+    rays.emplace_back(-axis * 50.0f, axis);
+  }
+  std::vector<esp::physics::RaycastResults> builtResults;
+  bool anyHits = false;
+  for (const auto& ray : rays) {
+    builtResults.push_back(physicsManager_->castRay(ray));
+    anyHits = anyHits || builtResults.back().hasHits();
+  }
+  CORRADE_VERIFY(anyHits);
+
+  // reloading the stage uses the cached bvhs
+  initStage(stageFile);
+  for (std::size_t i = 0; i != rays.size(); ++i) {
+    esp::physics::RaycastResults cachedResults =
+        physicsManager_->castRay(rays[i]);
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(cachedResults.hits.size(), builtResults[i].hits.size());
+    for (std::size_t j = 0; j != cachedResults.hits.size(); ++j) {
+      CORRADE_COMPARE(cachedResults.hits[j].rayDistance,
+                      builtResults[i].hits[j].rayDistance);
+      CORRADE_COMPARE(cachedResults.hits[j].normal,
+                      builtResults[i].hits[j].normal);
+    }
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+}  // PhysicsTest::testStageBvhCache
+
+void PhysicsTest::testURDFModelBundle() {
+  // test that a bundle baked from a URDF loads back into the same model, with
+  // convex hulls for all mesh collision shapes
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  const std::string urdfFile = Cr::Utility::Path::join(
+      dataDir, "test_assets/urdf/kuka_iiwa/model_free_base.urdf");
+  const std::string bundleFile =
+      esp::physics::getURDFModelBundleFilename(urdfFile);
+  if (Cr::Utility::Path::exists(bundleFile)) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(bundleFile));
+  }
+  CORRADE_VERIFY(!esp::physics::loadURDFModelBundle(bundleFile, urdfFile));
+
+  esp::physics::BulletURDFImporter importer{*resourceManager_};
+  CORRADE_VERIFY(importer.bakeURDFModelBundle(urdfFile));
+  std::shared_ptr<esp::metadata::URDF::Model> bundled =
+      esp::physics::loadURDFModelBundle(bundleFile, urdfFile);
+  CORRADE_VERIFY(bundled);
+
+  esp::metadata::URDF::Parser parser;
+  std::shared_ptr<esp::metadata::URDF::Model> parsed;
+  CORRADE_VERIFY(parser.parseURDF(urdfFile, parsed));
+  CORRADE_COMPARE(bundled->m_name, parsed->m_name);
+  CORRADE_COMPARE(bundled->m_links.size(), parsed->m_links.size());
+  CORRADE_COMPARE(bundled->m_joints.size(), parsed->m_joints.size());
+  CORRADE_COMPARE(bundled->m_rootLinks.size(), 1);
+  CORRADE_COMPARE(bundled->m_rootLinks[0]->m_name,
+                  parsed->m_rootLinks[0]->m_name);
+  for (const auto& link : parsed->m_links) {
+    CORRADE_ITERATION(link.first);
+    auto bundledLink = bundled->getLink(link.first);
+    CORRADE_VERIFY(bundledLink);
+    CORRADE_COMPARE(bundledLink->m_linkIndex, link.second->m_linkIndex);
+    CORRADE_COMPARE(bundledLink->m_inertia.m_mass,
+                    link.second->m_inertia.m_mass);
+    CORRADE_COMPARE(bundledLink->m_childLinks.size(),
+                    link.second->m_childLinks.size());
+    CORRADE_COMPARE(bundledLink->m_collisionArray.size(),
+                    link.second->m_collisionArray.size());
+    for (std::size_t i = 0; i != bundledLink->m_collisionArray.size(); ++i) {
+      const auto& collision = bundledLink->m_collisionArray[i];
+      const auto& parsedCollision = link.second->m_collisionArray[i];
+      CORRADE_COMPARE(collision.m_geometry.m_meshFileName,
+                      parsedCollision.m_geometry.m_meshFileName);
+      if (collision.m_geometry.m_type == esp::metadata::URDF::GEOM_MESH) {
+        CORRADE_VERIFY(!collision.m_convexHulls.empty());
+      }
+    }
+  }
+  for (const auto& joint : parsed->m_joints) {
+    CORRADE_ITERATION(joint.first);
+    auto bundledJointIter = bundled->m_joints.find(joint.first);
+    CORRADE_VERIFY(bundledJointIter != bundled->m_joints.end());
+    const auto& bundledJoint = bundledJointIter->second;
+    CORRADE_COMPARE(bundledJoint->m_lowerLimit, joint.second->m_lowerLimit);
+    CORRADE_COMPARE(bundledJoint->m_upperLimit, joint.second->m_upperLimit);
+    CORRADE_COMPARE(bundledJoint->m_parentLinkName,
+                    joint.second->m_parentLinkName);
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(bundleFile));
+}  // PhysicsTest::testURDFModelBundle
+
+void PhysicsTest::testDeterministicThreading() {
+  // test that a deterministic simulation produces bit-identical trajectories
+  // for any number of collision detection threads
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+
+  auto simulateTrajectory = [&](int numThreads) {
+    auto physicsManagerAttributes =
+        physicsAttributesManager_->createObject(physicsConfigFile, true);
+    physicsManagerAttributes->setNumThreads(numThreads);
+    physicsManagerAttributes->setDeterministic(true);
+    initStage(stageFile, physicsManagerAttributes);
+
+    std::vector<Mn::Float> trajectory;
+    if (physicsManager_->getPhysicsSimulationLibrary() !=
+        PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+      return trajectory;
+    }
+
+    // a loose pile of cubes, so contacts begin and end throughout
+    std::string cubeHandle =
+        metadataMediator_->getObjectAttributesManager()
+            ->getObjectHandlesBySubstring("cubeSolid")[0];
+    auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+    std::vector<esp::physics::ManagedRigidObject::ptr> cubes;
+    for (int layer = 0; layer < 4; ++layer) {
+      for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+          cubes.push_back(makeObjectGetWrapper(cubeHandle, &drawables));
+          cubes.back()->setTranslation(
+              {i * 1.05f + layer * 0.3f, 1.0f + layer * 1.1f,
+               j * 1.05f - layer * 0.2f});
+          cubes.back()->setRotation(Mn::Quaternion::rotation(
+              Mn::Deg(15.0f * (i + j + layer)), Mn::Vector3::yAxis()));
+        }
+      }
+    }
+
+    while (physicsManager_->getWorldTime() < 2.0) {
+      physicsManager_->stepPhysics(0.1);
+      for (const auto& cube : cubes) {
+        const Mn::Vector3 translation = cube->getTranslation();
+        const Mn::Quaternion rotation = cube->getRotation();
+        trajectory.insert(trajectory.end(), translation.data(),
+                          translation.data() + 3);
+        trajectory.insert(trajectory.end(), rotation.data(),
+                          rotation.data() + 4);
+      }
+    }
+    rigidObjectManager_->removeAllObjects();
+    return trajectory;
+  };
+
+  const std::vector<Mn::Float> reference = simulateTrajectory(1);
+  for (int numThreads : {1, 2, 4, 4}) {
+    CORRADE_ITERATION(numThreads);
+    // exact comparison, Magnum's vector comparisons are fuzzy
+    CORRADE_VERIFY(simulateTrajectory(numThreads) == reference);
+  }
+}  // PhysicsTest::testDeterministicThreading
+
+void PhysicsTest::testSubstepBudget() {
+  // test that steps are bounded by the substep budget and that the adaptive
+  // timestep takes longer substeps only in calm scenes
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  auto physicsManagerAttributes =
+      physicsAttributesManager_->createObject(physicsConfigFile, true);
+  physicsManagerAttributes->setTimestep(0.008);
+  physicsManagerAttributes->setMaxSubsteps(5);
+  initStage("NONE", physicsManagerAttributes);
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+  auto* bPhysManager =
+      static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+
+  // a long step is cut at the budget, the rest of the time is dropped
+  physicsManager_->stepPhysics(1.0);
+  CORRADE_COMPARE(bPhysManager->getRecentNumSubStepsTaken(), 5);
+  CORRADE_COMPARE(physicsManager_->getWorldTime(), 5 * 0.008);
+
+  physicsManagerAttributes->setMaxSubsteps(0);
+  physicsManagerAttributes->setAdaptiveTimestep(true);
+  physicsManagerAttributes->setAdaptiveMaxTimestep(0.032);
+  physicsManagerAttributes->setAdaptiveMaxTravel(0.01);
+  initStage("NONE", physicsManagerAttributes);
+  bPhysManager =
+      static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+
+  // nothing moves, so the longest substeps are taken
+  physicsManager_->stepPhysics(0.32);
+  CORRADE_COMPARE(bPhysManager->getRecentTimeStep(), 0.032);
+  CORRADE_COMPARE_AS(bPhysManager->getRecentNumSubStepsTaken(), 8,
+                     Cr::TestSuite::Compare::Greater);
+  CORRADE_COMPARE(physicsManager_->getWorldTime(),
+                  bPhysManager->getRecentNumSubStepsTaken() * 0.032);
+
+  // a fast object shortens the substeps to multiples of the timestep
+  std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  auto cube = makeObjectGetWrapper(cubeHandle, &drawables);
+  cube->setLinearVelocity({0, 0, 1.0});
+  physicsManager_->stepPhysics(0.32);
+  CORRADE_COMPARE_AS(bPhysManager->getRecentTimeStep(), 0.032,
+                     Cr::TestSuite::Compare::Less);
+  const double substeps = bPhysManager->getRecentTimeStep() / 0.008;
+  CORRADE_COMPARE(substeps, std::round(substeps));
+
+  cube->setLinearVelocity({0, 0, 10.0});
+  physicsManager_->stepPhysics(0.32);
+  CORRADE_COMPARE(bPhysManager->getRecentTimeStep(), 0.008);
+}  // PhysicsTest::testSubstepBudget
+
+void PhysicsTest::testWorldClone() {
+  // test that clones roll forward like the source world, independently of it
+  // and of each other
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/plane.glb");
+  initStage(stageFile);
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+  auto* bPhysManager =
+      static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+
+  std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  auto cube = makeObjectGetWrapper(cubeHandle, &drawables);
+  const Mn::Vector3 start{0.0f, 2.0f, 0.0f};
+  cube->setTranslation(start);
+
+  auto clone = bPhysManager->cloneWorld();
+  auto pushedClone = bPhysManager->cloneWorld();
+  CORRADE_COMPARE(clone->getWorldTime(), physicsManager_->getWorldTime());
+  CORRADE_COMPARE(clone->getRigidObjectTransformation(cube->getID()),
+                  cube->getTransformation());
+  pushedClone->setRigidObjectLinearVelocity(cube->getID(), {2.0f, 0, 0});
+
+  // the clones fall and come to rest on the stage, the source doesn't move
+  clone->stepPhysics(1.0);
+  pushedClone->stepPhysics(1.0);
+  CORRADE_COMPARE(cube->getTranslation(), start);
+  CORRADE_COMPARE(physicsManager_->getWorldTime(), 0.0);
+  CORRADE_COMPARE_WITH(clone->getWorldTime(), 1.0,
+                       Cr::TestSuite::Compare::around(1.0e-6));
+  const Mn::Vector3 cloneTranslation =
+      clone->getRigidObjectTransformation(cube->getID()).translation();
+  CORRADE_COMPARE_AS(cloneTranslation.y(), 0.5f,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE_AS(
+      pushedClone->getRigidObjectTransformation(cube->getID()).translation().x(),
+      0.5f, Cr::TestSuite::Compare::Greater);
+
+  // the source gets to the same state as the unpushed clone
+  physicsManager_->stepPhysics(1.0);
+  CORRADE_COMPARE_AS((cube->getTranslation() - cloneTranslation).length(),
+                     0.01f, Cr::TestSuite::Compare::Less);
+}  // PhysicsTest::testWorldClone
+
 #endif
 
 void PhysicsTest::testConfigurableScaling() {
@@ -831,6 +1377,30 @@ void PhysicsTest::testConfigurableScaling() {
         rigidObjectManager_->getObjectCopyByID(objectIDs[ix])->getScale(),
         testScales[ix]);
   }
+
+#ifdef ESP_BUILD_WITH_BULLET
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    // instances with the same scale share their hulls, adding and modifying
+    // one doesn't change the collision shape of the others
+    objectTemplate->setScale(testScales[1]);
+    objectAttributesManager->registerObject(objectTemplate);
+    auto objectWrapper = makeObjectGetWrapper(objectFile, &drawables);
+    objectWrapper->setMargin(0.1);
+    objectWrapper->setMargin(0.0);
+    for (size_t ix = 0; ix < objectIDs.size(); ++ix) {
+      CORRADE_COMPARE(
+          rigidObjectManager_
+              ->getObjectCopyByID<esp::physics::ManagedBulletRigidObject>(
+                  objectIDs[ix])
+              ->getCollisionShapeAabb(),
+          Magnum::Range3D(-abs(testScales[ix]), abs(testScales[ix])));
+    }
+    CORRADE_COMPARE(
+        objectWrapper->getCollisionShapeAabb(),
+        Magnum::Range3D(-abs(testScales[1]), abs(testScales[1])));
+  }
+#endif
 }  // PhysicsTest::testConfigurableScaling
 
 void PhysicsTest::testVelocityControl() {
@@ -982,6 +1552,22 @@ void PhysicsTest::testVelocityControl() {
 
   CORRADE_COMPARE_AS(float(angleErrorLocal), errorEps,
                      Cr::TestSuite::Compare::LessOrEqual);
+
+  // the batched integration used by stepPhysics() matches integrateTransform()
+  velControl->linVel = Magnum::Vector3{0.5, 0.0, -1.0};
+  velControl->angVel = Magnum::Vector3{0.0, 2.0, 1.0};
+  esp::core::RigidState state(Magnum::Quaternion::rotation(
+                                  Magnum::Deg(30.0f), Magnum::Vector3::yAxis()),
+                              Magnum::Vector3{1.0, 2.0, 3.0});
+  esp::physics::VelocityControlBatch batch;
+  CORRADE_VERIFY(esp::physics::VelocityControlBatch::isBatchable(*velControl));
+  batch.add(*velControl, state);
+  for (int i = 0; i < 3; ++i) {
+    state = velControl->integrateTransform(0.1, state);
+    batch.integrate(0.1);
+  }
+  CORRADE_COMPARE(batch.state(0).translation, state.translation);
+  CORRADE_COMPARE(batch.state(0).rotation, state.rotation);
 }  // PhysicsTest::testVelocityControl
 
 void PhysicsTest::testSceneNodeAttachment() {
@@ -1042,6 +1628,235 @@ void PhysicsTest::testSceneNodeAttachment() {
                      Cr::TestSuite::Compare::NotEqual);
 }  // PhysicsTest::testSceneNodeAttachment
 
+void PhysicsTest::testObjectPooling() {
+  // test that removed objects are reused by objects added from the same
+  // template
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+
+  initStage("NONE");
+
+  ObjectAttributes::ptr objectTemplate = ObjectAttributes::create();
+  objectTemplate->setRenderAssetHandle(objectFile);
+  auto objectAttributesManager =
+      metadataMediator_->getObjectAttributesManager();
+  objectAttributesManager->registerObject(objectTemplate, objectFile);
+
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+  const std::size_t numDrawables = drawables.size();
+
+  physicsManager_->setObjectPoolingEnabled(true);
+  auto objectWrapper = makeObjectGetWrapper(objectFile, &drawables);
+  CORRADE_VERIFY(objectWrapper);
+  const int objectId = objectWrapper->getID();
+  esp::scene::SceneNode* objectNode = objectWrapper->getSceneNode();
+  const std::size_t numObjectDrawables = drawables.size();
+  objectWrapper->setTranslation({1.0, 2.0, 3.0});
+  objectWrapper->setMotionType(esp::physics::MotionType::KINEMATIC);
+
+  // removing hides the object and keeps it
+  physicsManager_->removeObject(objectId);
+  CORRADE_COMPARE(physicsManager_->getNumRigidObjects(), 0);
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 1);
+  CORRADE_COMPARE(drawables.size(), numDrawables);
+  CORRADE_VERIFY(!rigidObjectManager_->getObjectLibHasID(objectId));
+
+  // adding from the same template reuses it in its initial state
+  objectWrapper = makeObjectGetWrapper(objectFile, &drawables);
+  CORRADE_VERIFY(objectWrapper);
+  CORRADE_COMPARE(objectWrapper->getID(), objectId);
+  CORRADE_COMPARE(objectWrapper->getSceneNode(), objectNode);
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 0);
+  CORRADE_COMPARE(drawables.size(), numObjectDrawables);
+  CORRADE_COMPARE(objectWrapper->getTranslation(), Mn::Vector3{});
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::NoPhysics) {
+    CORRADE_COMPARE(objectWrapper->getMotionType(),
+                    esp::physics::MotionType::DYNAMIC);
+  }
+
+  // objects attached to an existing node are not pooled
+  esp::scene::SceneNode* newNode =
+      &sceneManager_->getSceneGraph(sceneID_).getRootNode().createChild();
+  auto attachedWrapper = makeObjectGetWrapper(objectFile, &drawables, newNode);
+  CORRADE_VERIFY(attachedWrapper);
+  physicsManager_->removeObject(attachedWrapper->getID());
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 0);
+
+  // disabling pooling destroys the pooled objects and releases their IDs
+  physicsManager_->removeObject(objectId);
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 1);
+  physicsManager_->setObjectPoolingEnabled(false);
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 0);
+  CORRADE_COMPARE(drawables.size(), numDrawables);
+  objectWrapper = makeObjectGetWrapper(objectFile, &drawables);
+  CORRADE_VERIFY(objectWrapper);
+  physicsManager_->removeObject(objectWrapper->getID());
+  CORRADE_COMPARE(physicsManager_->getNumPooledObjects(), 0);
+}  // PhysicsTest::testObjectPooling
+
+void PhysicsTest::testWrapperSharingAndBulkAccess() {
+  // test that looking up an object returns its one wrapper and that bulk
+  // access matches the per-object accessors
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+
+  initStage("NONE");
+
+  ObjectAttributes::ptr objectTemplate = ObjectAttributes::create();
+  objectTemplate->setRenderAssetHandle(objectFile);
+  metadataMediator_->getObjectAttributesManager()->registerObject(
+      objectTemplate, objectFile);
+
+  auto firstWrapper = makeObjectGetWrapper(objectFile);
+  auto secondWrapper = makeObjectGetWrapper(objectFile);
+  CORRADE_VERIFY(firstWrapper);
+  CORRADE_VERIFY(secondWrapper);
+  CORRADE_COMPARE(rigidObjectManager_->getObjectCopyByID(firstWrapper->getID())
+                      .get(),
+                  firstWrapper.get());
+  CORRADE_COMPARE(
+      rigidObjectManager_->getObjectOrCopyByHandle(secondWrapper->getHandle())
+          .get(),
+      secondWrapper.get());
+
+  firstWrapper->setTranslation({1.0f, 2.0f, 3.0f});
+  secondWrapper->setRotation(
+      Mn::Quaternion::rotation(Mn::Deg(90.0f), Mn::Vector3::yAxis()));
+  secondWrapper->setMotionType(esp::physics::MotionType::KINEMATIC);
+
+  const int objectIds[]{secondWrapper->getID(), firstWrapper->getID()};
+  Mn::Matrix4 transformations[2];
+  esp::physics::MotionType motionTypes[2];
+  rigidObjectManager_->getTransformations(objectIds, transformations);
+  rigidObjectManager_->getMotionTypes(objectIds, motionTypes);
+  CORRADE_COMPARE(transformations[0], secondWrapper->getTransformation());
+  CORRADE_COMPARE(transformations[1], firstWrapper->getTransformation());
+  CORRADE_COMPARE(motionTypes[0], secondWrapper->getMotionType());
+  CORRADE_COMPARE(motionTypes[1], firstWrapper->getMotionType());
+
+  // a removed object's wrapper is no longer handed out
+  const int firstId = firstWrapper->getID();
+  physicsManager_->removeObject(firstId);
+  CORRADE_VERIFY(!firstWrapper->isAlive());
+  CORRADE_VERIFY(!rigidObjectManager_->getObjectLibHasID(firstId));
+}  // PhysicsTest::testWrapperSharingAndBulkAccess
+
+void PhysicsTest::testBatchedBackend() {
+  // test that an attached world is stepped by the backend and that the bulk
+  // accessors of its manager go through the backend
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+
+  std::string objectFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/objects/transform_box.glb");
+
+  initStage("NONE");
+
+  ObjectAttributes::ptr objectTemplate = ObjectAttributes::create();
+  objectTemplate->setRenderAssetHandle(objectFile);
+  metadataMediator_->getObjectAttributesManager()->registerObject(
+      objectTemplate, objectFile);
+  auto objectWrapper = makeObjectGetWrapper(objectFile);
+  objectWrapper->setMotionType(esp::physics::MotionType::KINEMATIC);
+  objectWrapper->setTranslation({1.0f, 2.0f, 3.0f});
+
+  auto backend = std::make_shared<esp::physics::CpuBatchedPhysicsBackend>(2);
+  physicsManager_->setBatchedBackend(backend);
+  CORRADE_COMPARE(physicsManager_->getBatchedBackend(), backend.get());
+  CORRADE_COMPARE(physicsManager_->getBatchedWorldId(), 0);
+  CORRADE_COMPARE(backend->getNumWorlds(), 1);
+
+  const int worldIds[]{physicsManager_->getBatchedWorldId()};
+  backend->stepWorlds(worldIds, 0.5);
+  CORRADE_COMPARE_WITH(physicsManager_->getWorldTime(), 0.5,
+                       Cr::TestSuite::Compare::around(1.0e-6));
+
+  const int objectIds[]{objectWrapper->getID()};
+  Mn::Matrix4 transformations[1];
+  rigidObjectManager_->getTransformations(objectIds, transformations);
+  CORRADE_COMPARE(transformations[0], objectWrapper->getTransformation());
+
+  // a backend of its own serves the bulk accessors
+  struct OffsetBackend : esp::physics::CpuBatchedPhysicsBackend {
+    void getRigidTransformations(
+        int worldId,
+        Cr::Containers::ArrayView<const int> objectIds,
+        Cr::Containers::ArrayView<Mn::Matrix4> transformations) override {
+      CpuBatchedPhysicsBackend::getRigidTransformations(worldId, objectIds,
+                                                        transformations);
+      for (Mn::Matrix4& transformation : transformations) {
+        transformation =
+            Mn::Matrix4::translation(Mn::Vector3::xAxis()) * transformation;
+      }
+    }
+  };
+  auto offsetBackend = std::make_shared<OffsetBackend>();
+  physicsManager_->setBatchedBackend(offsetBackend);
+  CORRADE_COMPARE(backend->getNumWorlds(), 0);
+  CORRADE_COMPARE(offsetBackend->getNumWorlds(), 1);
+  rigidObjectManager_->getTransformations(objectIds, transformations);
+  CORRADE_COMPARE(transformations[0].translation(),
+                  (Mn::Vector3{2.0f, 2.0f, 3.0f}));
+
+  // detached, the objects are read directly again
+  physicsManager_->setBatchedBackend(nullptr);
+  CORRADE_COMPARE(offsetBackend->getNumWorlds(), 0);
+  CORRADE_COMPARE(physicsManager_->getBatchedWorldId(), esp::ID_UNDEFINED);
+  rigidObjectManager_->getTransformations(objectIds, transformations);
+  CORRADE_COMPARE(transformations[0], objectWrapper->getTransformation());
+}  // PhysicsTest::testBatchedBackend
+
+void PhysicsTest::testRigidConstraintBatch() {
+  // test that batched constraint updates match the per-constraint settings
+  // and that constraints holding objects up report their force
+  resetCreateRendererFlag(RendererEnabledData[testCaseInstanceId()].enabled);
+  initStage("NONE");
+  if (physicsManager_->getPhysicsSimulationLibrary() !=
+      PhysicsManager::PhysicsSimulationLibrary::Bullet) {
+    return;
+  }
+
+  std::string cubeHandle =
+      metadataMediator_->getObjectAttributesManager()
+          ->getObjectHandlesBySubstring("cubeSolid")[0];
+  auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+
+  int constraintIds[2];
+  for (int i = 0; i != 2; ++i) {
+    auto cube = makeObjectGetWrapper(cubeHandle, &drawables);
+    cube->setTranslation({float(i), 1.0f, 0.0f});
+    esp::physics::RigidConstraintSettings settings;
+    settings.objectIdA = cube->getID();
+    settings.pivotB = {float(i), 1.0f, 0.0f};
+    constraintIds[i] = physicsManager_->createRigidConstraint(settings);
+  }
+
+  // only the given parameters change
+  const Mn::Vector3 pivotsB[]{{0.0f, 2.0f, 0.0f}, {1.0f, 2.0f, 0.0f}};
+  const float maxImpulses[]{5.0f, 7.0f};
+  physicsManager_->updateRigidConstraints(constraintIds, {}, pivotsB, {}, {},
+                                          maxImpulses);
+  for (int i = 0; i != 2; ++i) {
+    auto settings =
+        physicsManager_->getRigidConstraintSettings(constraintIds[i]);
+    CORRADE_COMPARE(settings.pivotA, Mn::Vector3{});
+    CORRADE_COMPARE(settings.pivotB, pivotsB[i]);
+    CORRADE_COMPARE(settings.maxImpulse, double(maxImpulses[i]));
+  }
+
+  // the constraints carry the weight of the cubes
+  physicsManager_->stepPhysics(1.0);
+  float forces[2];
+  physicsManager_->getRigidConstraintForces(constraintIds, forces);
+  for (int i = 0; i != 2; ++i) {
+    CORRADE_COMPARE_AS(forces[i], 0.0f, Cr::TestSuite::Compare::Greater);
+  }
+}  // PhysicsTest::testRigidConstraintBatch
+
 }  // namespace
 
 CORRADE_TEST_MAIN(PhysicsTest)
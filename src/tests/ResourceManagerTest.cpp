@@ -6,16 +6,33 @@
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/CubeMapTexture.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Primitives/UVSphere.h>
 #include <Magnum/Trade/MaterialData.h>
 #include <string>
 
+#include "esp/assets/AssetCache.h"
+#include "esp/assets/GenericMeshData.h"
 #include "esp/assets/MeshData.h"
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/assets/SemanticColorLookup.h"
+#include "esp/assets/StageBundle.h"
+#include "esp/assets/TextureCompression.h"
+#include "esp/gfx/PbrIBLHelper.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/metadata/MetadataMediator.h"
@@ -42,6 +59,24 @@ struct ResourceManagerTest : Cr::TestSuite::Tester {
 
   void testShaderTypeSpecification();
 
+  void shareRenderAssetAcrossResourceManagers();
+
+  void generateMeshLodLevels();
+
+  void optimizeMeshAndCache();
+
+  void compressTextureAndCache();
+
+  void loadTexturesInParallel();
+
+  void iblMapsCache();
+
+  void convertSemanticTexture();
+
+  void bakeStageBundle();
+
+  void replaceRenderAsset();
+
   esp::logging::LoggingContext loggingContext;
 };  // struct ResourceManagerTest
 ResourceManagerTest::ResourceManagerTest() {
@@ -49,6 +84,15 @@ ResourceManagerTest::ResourceManagerTest() {
       &ResourceManagerTest::createJoinedCollisionMesh,
       &ResourceManagerTest::loadAndCreateRenderAssetInstance,
       &ResourceManagerTest::testShaderTypeSpecification,
+      &ResourceManagerTest::shareRenderAssetAcrossResourceManagers,
+      &ResourceManagerTest::generateMeshLodLevels,
+      &ResourceManagerTest::optimizeMeshAndCache,
+      &ResourceManagerTest::compressTextureAndCache,
+      &ResourceManagerTest::loadTexturesInParallel,
+      &ResourceManagerTest::iblMapsCache,
+      &ResourceManagerTest::convertSemanticTexture,
+      &ResourceManagerTest::bakeStageBundle,
+      &ResourceManagerTest::replaceRenderAsset,
   });
 }
 
@@ -112,6 +156,17 @@ void ResourceManagerTest::createJoinedCollisionMesh() {
                           16, 17, 18, 16, 18, 19, 20, 21, 22, 20, 22, 23}),
                      Cr::TestSuite::Compare::Container);
 
+  // the joined mesh is cached, later requests don't join again
+  const esp::assets::MeshData& cachedBox =
+      resourceManager.getJoinedCollisionMesh(boxFile);
+  CORRADE_COMPARE(&resourceManager.getJoinedCollisionMesh(boxFile),
+                  &cachedBox);
+  CORRADE_COMPARE_AS(Cr::Containers::arrayView(cachedBox.ibo),
+                     Cr::Containers::arrayView(joinedBox->ibo),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_VERIFY(resourceManager.createJoinedCollisionMesh(boxFile)->vbo ==
+                 joinedBox->vbo);
+
 }  // namespace Test
 
 // Load and create a render asset instance and assert success
@@ -143,6 +198,16 @@ void ResourceManagerTest::loadAndCreateRenderAssetInstance() {
   auto* node = resourceManager.loadAndCreateRenderAssetInstance(
       info, creation, &sceneManager_, tempIDs);
   CORRADE_VERIFY(node);
+
+  // the collision mesh group is built on request and cached
+  const esp::assets::MeshMetaData& meshMetaData =
+      resourceManager.getMeshMetaData(boxFile);
+  const std::vector<esp::assets::CollisionMeshData>& meshGroup =
+      resourceManager.getCollisionMesh(boxFile);
+  CORRADE_COMPARE(meshGroup.size(),
+                  std::size_t(meshMetaData.meshIndex.second -
+                              meshMetaData.meshIndex.first + 1));
+  CORRADE_COMPARE(&resourceManager.getCollisionMesh(boxFile), &meshGroup);
 }
 
 /**
@@ -252,6 +317,469 @@ void ResourceManagerTest::testShaderTypeSpecification() {
 
 }  // ResourceManagerTest::testFlatShaderTypeSpecification
 
+void ResourceManagerTest::shareRenderAssetAcrossResourceManagers() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  auto MM = MetadataMediator::create();
+  std::string boxFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/transform_box.glb");
+  esp::assets::AssetInfo info = esp::assets::AssetInfo::fromPath(boxFile);
+  esp::assets::AssetCache& assetCache = esp::assets::AssetCache::instance();
+  const int numLiveAssets = assetCache.getNumLiveAssets();
+  {
+    // first ResourceManager imports the asset and publishes it
+    ResourceManager firstResourceManager(MM);
+    CORRADE_VERIFY(firstResourceManager.loadRenderAsset(info));
+    CORRADE_COMPARE(assetCache.getNumLiveAssets(), numLiveAssets + 1);
+
+    // second ResourceManager adopts it instead of importing it again
+    ResourceManager secondResourceManager(MM);
+    CORRADE_VERIFY(secondResourceManager.loadRenderAsset(info));
+    CORRADE_COMPARE(assetCache.getNumLiveAssets(), numLiveAssets + 1);
+
+    // collision data is shared, not copied
+    const auto& firstCollisionMesh =
+        firstResourceManager.getCollisionMesh(boxFile);
+    const auto& secondCollisionMesh =
+        secondResourceManager.getCollisionMesh(boxFile);
+    CORRADE_COMPARE(secondCollisionMesh.size(), firstCollisionMesh.size());
+    CORRADE_COMPARE(secondCollisionMesh[0].positions.data(),
+                    firstCollisionMesh[0].positions.data());
+
+    // every material referenced by the adopted hierarchy is registered with
+    // the adopting ResourceManager
+    std::set<std::string> matIDs;
+    buildMaterialIDs(secondResourceManager.getMeshMetaData(boxFile).root,
+                     matIDs);
+    CORRADE_COMPARE(matIDs.size(), 3);
+    auto& shaderManager = secondResourceManager.getShaderManager();
+    for (const std::string& id : matIDs) {
+      CORRADE_COMPARE(shaderManager.get<Mn::Trade::MaterialData>(id).state(),
+                      Mn::ResourceState::Final);
+    }
+  }
+  // the asset is released together with the last ResourceManager using it
+  CORRADE_COMPARE(assetCache.getNumLiveAssets(), numLiveAssets);
+}  // ResourceManagerTest::shareRenderAssetAcrossResourceManagers
+
+void ResourceManagerTest::generateMeshLodLevels() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  esp::assets::GenericMeshData meshData;
+  meshData.setMeshData(Mn::Primitives::uvSphereSolid(64, 128));
+  meshData.generateLodLevels(4);
+  meshData.uploadBuffersToGPU();
+
+  // every level is coarser and meant for smaller sizes on screen than the
+  // previous one
+  CORRADE_VERIFY(meshData.getLodLevelCount() > 0);
+  CORRADE_VERIFY(meshData.getLodLevelCount() <= 4);
+  Mn::Int previousCount = meshData.getMagnumGLMesh()->count();
+  float previousMaxPixelSize = Mn::Constants::inf();
+  for (std::size_t i = 0; i != meshData.getLodLevelCount(); ++i) {
+    CORRADE_ITERATION(i);
+    Mn::GL::Mesh* lodMesh = meshData.getLodMagnumGLMesh(i);
+    CORRADE_VERIFY(lodMesh);
+    CORRADE_VERIFY(lodMesh->count() > 0);
+    CORRADE_COMPARE_AS(lodMesh->count(), previousCount,
+                       Cr::TestSuite::Compare::Less);
+    CORRADE_COMPARE_AS(meshData.getLodMaxPixelSize(i), previousMaxPixelSize,
+                       Cr::TestSuite::Compare::Less);
+    previousCount = lodMesh->count();
+    previousMaxPixelSize = meshData.getLodMaxPixelSize(i);
+  }
+  CORRADE_VERIFY(!meshData.getLodMagnumGLMesh(meshData.getLodLevelCount()));
+}
+
+void ResourceManagerTest::optimizeMeshAndCache() {
+  esp::assets::GenericMeshData meshData;
+  meshData.setMeshData(Mn::Primitives::uvSphereSolid(
+      16, 32, Mn::Primitives::UVSphereFlag::TextureCoordinates));
+  const Mn::UnsignedInt vertexCount = meshData.getMeshData()->vertexCount();
+  const Mn::UnsignedInt indexCount = meshData.getMeshData()->indexCount();
+  const std::size_t vertexDataSize =
+      meshData.getMeshData()->vertexData().size();
+
+  meshData.optimizeForRendering();
+  const Mn::Trade::MeshData& optimized = *meshData.getMeshData();
+  CORRADE_COMPARE(optimized.vertexCount(), vertexCount);
+  CORRADE_COMPARE(optimized.indexCount(), indexCount);
+  CORRADE_COMPARE(optimized.attributeFormat(Mn::Trade::MeshAttribute::Position),
+                  Mn::VertexFormat::Vector3);
+  CORRADE_COMPARE(optimized.attributeFormat(Mn::Trade::MeshAttribute::Normal),
+                  Mn::VertexFormat::Vector3sNormalized);
+  CORRADE_COMPARE(
+      optimized.attributeFormat(Mn::Trade::MeshAttribute::TextureCoordinates),
+      Mn::VertexFormat::Vector2h);
+  CORRADE_COMPARE_AS(optimized.vertexData().size(), vertexDataSize,
+                     Cr::TestSuite::Compare::Less);
+
+  // a cached mesh loads back the same
+  const std::string cacheFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "optimizeMeshAndCache.bin");
+  CORRADE_VERIFY(meshData.saveMeshDataToCache(cacheFilename));
+  esp::assets::GenericMeshData cachedMeshData;
+  CORRADE_VERIFY(cachedMeshData.loadMeshDataFromCache(cacheFilename));
+  const Mn::Trade::MeshData& cached = *cachedMeshData.getMeshData();
+  CORRADE_COMPARE(cached.attributeCount(), optimized.attributeCount());
+  CORRADE_COMPARE_AS(cached.indicesAsArray(), optimized.indicesAsArray(),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(cached.vertexData(), optimized.vertexData(),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE_AS(cachedMeshData.getCollisionMeshData().positions,
+                     meshData.getCollisionMeshData().positions,
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+
+  // a missing file fails to load
+  CORRADE_VERIFY(!cachedMeshData.loadMeshDataFromCache(cacheFilename));
+}
+
+void ResourceManagerTest::compressTextureAndCache() {
+  Mn::Color4ub pixels[64 * 64];
+  for (int y = 0; y != 64; ++y) {
+    for (int x = 0; x != 64; ++x) {
+      pixels[y * 64 + x] = Mn::Color4ub(x * 4, y * 4, 128, 255);
+    }
+  }
+  const Mn::ImageView2D image{Mn::PixelFormat::RGBA8Unorm, {64, 64}, pixels};
+  CORRADE_VERIFY(esp::assets::isCompressibleTextureImage(image));
+  // not a multiple of the block size
+  CORRADE_VERIFY(!esp::assets::isCompressibleTextureImage(
+      Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm, {30, 30}, pixels}));
+
+  const std::vector<Mn::Trade::ImageData2D> levels =
+      esp::assets::compressTextureImage(image);
+  if (levels.empty()) {
+    CORRADE_SKIP("StbDxtImageConverter is not available.");
+  }
+  // mips down to the 4x4 block size
+  CORRADE_COMPARE(levels.size(), 5);
+  for (std::size_t i = 0; i != levels.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(levels[i].isCompressed());
+    CORRADE_COMPARE(levels[i].compressedFormat(),
+                    Mn::CompressedPixelFormat::Bc3RGBAUnorm);
+    CORRADE_COMPARE(levels[i].size(), Mn::Vector2i{64 >> i});
+  }
+
+  // a cached texture loads back the same
+  const std::string cacheFilename = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "compressTextureAndCache.ktx2");
+  if (!esp::assets::saveCompressedTextureToCache(levels, cacheFilename)) {
+    CORRADE_SKIP("KtxImageConverter is not available.");
+  }
+  const std::vector<Mn::Trade::ImageData2D> cached =
+      esp::assets::loadCompressedTextureFromCache(cacheFilename);
+  CORRADE_COMPARE(cached.size(), levels.size());
+  for (std::size_t i = 0; i != cached.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(cached[i].compressedFormat(),
+                    levels[i].compressedFormat());
+    CORRADE_COMPARE(cached[i].size(), levels[i].size());
+    CORRADE_COMPARE_AS(cached[i].data(), levels[i].data(),
+                       Cr::TestSuite::Compare::Container);
+  }
+  CORRADE_VERIFY(Cr::Utility::Path::remove(cacheFilename));
+
+  // a missing file fails to load
+  CORRADE_VERIFY(
+      esp::assets::loadCompressedTextureFromCache(cacheFilename).empty());
+}
+
+void ResourceManagerTest::loadTexturesInParallel() {
+#ifdef MAGNUM_TARGET_GLES
+  CORRADE_SKIP("Texture image queries are not available on OpenGL ES.");
+#else
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  auto MM = MetadataMediator::create();
+  // four images embedded in an external buffer file
+  const std::string assetFile = Cr::Utility::Path::join(
+      TEST_ASSETS, "scenes/batch-multiple-textures.gltf");
+  const esp::assets::AssetInfo info =
+      esp::assets::AssetInfo::fromPath(assetFile);
+
+  // pixels of every texture of the asset, empty for textures that failed to
+  // load, no textures at all if the asset failed to load
+  const auto loadTexturePixels = [&](int maxImageDecodeThreads,
+                                     bool prefetch) {
+    std::vector<std::vector<char>> pixels;
+    ResourceManager resourceManager(MM);
+    resourceManager.setMaxImageDecodeThreads(maxImageDecodeThreads);
+    if (prefetch) {
+      // the workers get served the files the importer reads
+      resourceManager.setPrefetchedFiles({});
+    }
+    const bool loaded = resourceManager.loadRenderAsset(info);
+    resourceManager.clearPrefetchedFiles();
+    if (!loaded) {
+      return pixels;
+    }
+
+    const auto& textureIndex =
+        resourceManager.getMeshMetaData(assetFile).textureIndex;
+    for (int id = textureIndex.first; id <= textureIndex.second; ++id) {
+      std::shared_ptr<Mn::GL::Texture2D> texture =
+          resourceManager.getTexture(id);
+      pixels.emplace_back();
+      if (texture) {
+        Mn::Image2D image =
+            texture->image(0, Mn::Image2D{Mn::PixelFormat::RGBA8Unorm});
+        pixels.back().assign(image.data().begin(), image.data().end());
+      }
+    }
+    return pixels;
+  };
+
+  // each ResourceManager goes away before the next one loads, so the asset
+  // isn't adopted from the asset cache
+  const std::vector<std::vector<char>> serial = loadTexturePixels(1, false);
+  CORRADE_COMPARE(serial.size(), 4);
+  for (std::size_t i = 0; i != serial.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(!serial[i].empty());
+  }
+
+  for (const bool prefetch : {false, true}) {
+    CORRADE_ITERATION(prefetch);
+    const std::vector<std::vector<char>> parallel =
+        loadTexturePixels(4, prefetch);
+    CORRADE_COMPARE(parallel.size(), serial.size());
+    for (std::size_t i = 0; i != parallel.size(); ++i) {
+      CORRADE_ITERATION(i);
+      CORRADE_COMPARE_AS(parallel[i], serial[i],
+                         Cr::TestSuite::Compare::Container);
+    }
+  }
+#endif
+}
+
+void ResourceManagerTest::iblMapsCache() {
+#ifdef MAGNUM_TARGET_GLES
+  CORRADE_SKIP("Cube map image queries are not available on OpenGL ES.");
+#else
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+  auto MM = MetadataMediator::create();
+  ResourceManager resourceManager(MM);
+
+  // two environment maps of the same size, a gradient and a flat color
+  Mn::Color4ub gradient[32 * 16];
+  Mn::Color4ub flat[32 * 16];
+  for (int y = 0; y != 16; ++y) {
+    for (int x = 0; x != 32; ++x) {
+      gradient[y * 32 + x] = Mn::Color4ub(x * 8, y * 16, 64, 255);
+      flat[y * 32 + x] = Mn::Color4ub(32, 32, 32, 255);
+    }
+  }
+  const auto makeTexture = [](const Mn::Color4ub* pixels) {
+    auto texture = std::make_shared<Mn::GL::Texture2D>();
+    texture->setMinificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setMagnificationFilter(Mn::GL::SamplerFilter::Linear)
+        .setWrapping(Mn::GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, Mn::GL::TextureFormat::RGBA8, {32, 16})
+        .setSubImage(
+            0, {},
+            Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm, {32, 16},
+                            Cr::Containers::arrayView(pixels, 32 * 16)});
+    return texture;
+  };
+  const std::shared_ptr<Mn::GL::Texture2D> gradientTexture =
+      makeTexture(gradient);
+  const std::shared_ptr<Mn::GL::Texture2D> flatTexture = makeTexture(flat);
+  // contents don't matter, it's only passed through
+  const std::shared_ptr<Mn::GL::Texture2D> brdfLUT = makeTexture(flat);
+
+  // the key depends on the contents, not just their size
+  const std::string cacheDir = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "iblMapsCache");
+  const std::string prefix = esp::gfx::PbrIBLHelper::getCacheFilePrefix(
+      cacheDir, Cr::Containers::arrayCast<const char>(
+                    Cr::Containers::arrayView(gradient)));
+  const std::string flatPrefix = esp::gfx::PbrIBLHelper::getCacheFilePrefix(
+      cacheDir,
+      Cr::Containers::arrayCast<const char>(Cr::Containers::arrayView(flat)));
+  CORRADE_COMPARE(esp::gfx::PbrIBLHelper::getCacheFilePrefix(
+                      cacheDir, Cr::Containers::arrayCast<const char>(
+                                    Cr::Containers::arrayView(gradient))),
+                  prefix);
+  CORRADE_VERIFY(flatPrefix != prefix);
+  for (const std::string& file :
+       {prefix + ".irradiance.ktx2", prefix + ".prefiltered.ktx2",
+        flatPrefix + ".irradiance.ktx2", flatPrefix + ".prefiltered.ktx2"}) {
+    if (Cr::Utility::Path::exists(file)) {
+      CORRADE_VERIFY(Cr::Utility::Path::remove(file));
+    }
+  }
+
+  const auto irradianceFace = [](esp::gfx::PbrIBLHelper& helper) {
+    Mn::Image2D image =
+        helper.getIrradianceMap()
+            .getTexture(esp::gfx::CubeMap::TextureType::Color)
+            .image(Mn::GL::CubeMapCoordinate::PositiveX, 0,
+                   Mn::Image2D{Mn::PixelFormat::RGBA8Unorm});
+    return std::vector<char>(image.data().begin(), image.data().end());
+  };
+
+  // a miss computes the maps and saves them
+  esp::gfx::PbrIBLHelper computed{resourceManager.getShaderManager(), brdfLUT,
+                                  gradientTexture, prefix};
+  if (!Cr::Utility::Path::exists(prefix + ".irradiance.ktx2")) {
+    CORRADE_SKIP("KtxImageConverter is not available.");
+  }
+  CORRADE_VERIFY(Cr::Utility::Path::exists(prefix + ".prefiltered.ktx2"));
+  const std::vector<char> expected = irradianceFace(computed);
+
+  // a hit loads them back, regardless of the texture passed in
+  esp::gfx::PbrIBLHelper cached{resourceManager.getShaderManager(), brdfLUT,
+                                flatTexture, prefix};
+  CORRADE_COMPARE_AS(irradianceFace(cached), expected,
+                     Cr::TestSuite::Compare::Container);
+
+  // a different key computes its own
+  esp::gfx::PbrIBLHelper other{resourceManager.getShaderManager(), brdfLUT,
+                               flatTexture, flatPrefix};
+  CORRADE_VERIFY(irradianceFace(other) != expected);
+  CORRADE_VERIFY(Cr::Utility::Path::exists(flatPrefix + ".irradiance.ktx2"));
+
+  for (const std::string& file :
+       {prefix + ".irradiance.ktx2", prefix + ".prefiltered.ktx2",
+        flatPrefix + ".irradiance.ktx2", flatPrefix + ".prefiltered.ktx2"}) {
+    CORRADE_VERIFY(Cr::Utility::Path::remove(file));
+  }
+#endif
+}
+
+void ResourceManagerTest::convertSemanticTexture() {
+  // black is always the unknown object, a repeated color maps to its last ID
+  const esp::assets::SemanticColorLookup lookup{
+      {0x000000, 0xff0000, 0x00ff00, 0x0000ff, 0x102030, 0x00ff00}};
+  CORRADE_COMPARE(lookup.size(), 4);
+  CORRADE_COMPARE(lookup(0x000000), 0);
+  CORRADE_COMPARE(lookup(0xff0000), 1);
+  CORRADE_COMPARE(lookup(0x00ff00), 5);
+  CORRADE_COMPARE(lookup(0x0000ff), 3);
+  CORRADE_COMPARE(lookup(0x102030), 4);
+  CORRADE_COMPARE(lookup(0x123456), 0);
+  CORRADE_COMPARE(esp::assets::SemanticColorLookup{}(0xff0000), 0);
+
+  // enough rows to be split across threads, with runs of the same color and
+  // colors not in the lookup
+  const Mn::Color3ub colors[]{{0xff, 0x00, 0x00}, {0x00, 0xff, 0x00},
+                              {0x10, 0x20, 0x30}, {0x12, 0x34, 0x56}};
+  const Mn::UnsignedShort ids[]{1, 5, 4, 0};
+  std::vector<Mn::Color3ub> pixels(37 * 70);
+  for (std::size_t i = 0; i != pixels.size(); ++i) {
+    pixels[i] = colors[(i / 3) % 4];
+  }
+  const Mn::ImageView2D image{Mn::PixelStorage{}.setAlignment(1),
+                              Mn::PixelFormat::RGB8Unorm, {37, 70}, pixels};
+  for (const std::size_t threadCount : {1, 4}) {
+    CORRADE_ITERATION(threadCount);
+    const Mn::Image2D converted = lookup.convert(image, threadCount);
+    CORRADE_COMPARE(converted.format(), Mn::PixelFormat::R16UI);
+    CORRADE_COMPARE(converted.size(), (Mn::Vector2i{37, 70}));
+    const auto convertedPixels = converted.pixels<Mn::UnsignedShort>();
+    for (std::size_t y = 0; y != 70; ++y) {
+      CORRADE_ITERATION(y);
+      for (std::size_t x = 0; x != 37; ++x) {
+        CORRADE_ITERATION(x);
+        CORRADE_COMPARE(convertedPixels[y][x], ids[((y * 37 + x) / 3) % 4]);
+      }
+    }
+  }
+}
+
+void ResourceManagerTest::bakeStageBundle() {
+  auto cfg = esp::sim::SimulatorConfiguration{};
+  cfg.createRenderer = false;
+  auto MM = MetadataMediator::create(cfg);
+  const std::string boxFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/nested_box.glb");
+  const std::string bundleFile = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "bakeStageBundle.bundle");
+
+  ResourceManager resourceManager(MM);
+  resourceManager.setRequiresTextures(false);
+  CORRADE_VERIFY(resourceManager.bakeStageBundle(boxFile, bundleFile));
+  // can't bake what's already loaded
+  CORRADE_VERIFY(!resourceManager.bakeStageBundle(boxFile, bundleFile));
+  const esp::assets::MeshMetaData& meshMetaData =
+      resourceManager.getMeshMetaData(boxFile);
+
+  Cr::Containers::Optional<esp::assets::StageBundle> bundle =
+      esp::assets::loadStageBundle(bundleFile, boxFile);
+  CORRADE_VERIFY(bundle);
+  CORRADE_COMPARE(bundle->meshes.size(), meshMetaData.meshIndex.second -
+                                             meshMetaData.meshIndex.first + 1);
+  CORRADE_COMPARE(bundle->meshBBs.size(), bundle->meshes.size());
+  CORRADE_VERIFY(!bundle->absoluteAABBs.empty());
+  CORRADE_COMPARE(bundle->root.children.size(),
+                  meshMetaData.root.children.size());
+
+  // the meshes load back and match their baked bounding boxes
+  for (std::size_t i = 0; i != bundle->meshes.size(); ++i) {
+    CORRADE_ITERATION(i);
+    esp::assets::GenericMeshData meshData;
+    CORRADE_VERIFY(meshData.deserializeMeshData(bundle->meshes[i]));
+    CORRADE_COMPARE(Mn::Range3D{Mn::Math::minmax(
+                        meshData.getCollisionMeshData().positions)},
+                    bundle->meshBBs[i]);
+  }
+
+  // a bundle baked from a different asset is rejected
+  CORRADE_VERIFY(!esp::assets::loadStageBundle(
+      bundleFile,
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/transform_box.glb")));
+
+  bundle = Cr::Containers::NullOpt;
+  CORRADE_VERIFY(Cr::Utility::Path::remove(bundleFile));
+}
+
+void ResourceManagerTest::replaceRenderAsset() {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  auto MM = MetadataMediator::create();
+  ResourceManager resourceManager(MM);
+  const std::string boxFile =
+      Cr::Utility::Path::join(TEST_ASSETS, "objects/transform_box.glb");
+  // a file with the same meshes and textures, as a full-detail variant would
+  const std::string replacementFile = Cr::Utility::Path::join(
+      MAGNUMRENDERERTEST_OUTPUT_DIR, "replaceRenderAsset.glb");
+  CORRADE_VERIFY(Cr::Utility::Path::copy(boxFile, replacementFile));
+
+  // nothing to replace yet
+  CORRADE_VERIFY(!resourceManager.replaceRenderAsset(boxFile, replacementFile));
+
+  CORRADE_VERIFY(resourceManager.loadRenderAsset(
+      esp::assets::AssetInfo::fromPath(boxFile)));
+  const esp::core::MemoryUsage usage = resourceManager.getMemoryUsage();
+  CORRADE_VERIFY(resourceManager.replaceRenderAsset(boxFile, replacementFile));
+  // the replacement is swapped in under the original name, without anything
+  // left behind
+  CORRADE_VERIFY(resourceManager.getMeshMetaData(boxFile).meshIndex.first !=
+                 esp::ID_UNDEFINED);
+  CORRADE_COMPARE(resourceManager.getMemoryUsage().cpuBytes, usage.cpuBytes);
+  CORRADE_COMPARE(resourceManager.getMemoryUsage().gpuBytes, usage.gpuBytes);
+
+  // a missing replacement keeps the original
+  CORRADE_VERIFY(Cr::Utility::Path::remove(replacementFile));
+  CORRADE_VERIFY(!resourceManager.replaceRenderAsset(boxFile, replacementFile));
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(ResourceManagerTest)
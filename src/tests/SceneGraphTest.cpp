@@ -3,17 +3,27 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <Corrade/TestSuite/Tester.h>
+#include <Magnum/SceneGraph/Drawable.h>
 
 #include "esp/scene/SceneGraph.h"
 
 using esp::gfx::DrawableGroup;
 using esp::scene::SceneGraph;
+using esp::scene::SceneNode;
 
 namespace {
+struct TestDrawable : Mn::SceneGraph::Drawable3D {
+  explicit TestDrawable(SceneNode& node)
+      : Mn::SceneGraph::Drawable3D{node, nullptr} {}
+  void draw(const Mn::Matrix4&, Mn::SceneGraph::Camera3D&) override {}
+};
+
 struct SceneGraphTest : Cr::TestSuite::Tester {
   explicit SceneGraphTest();
   void testGetDrawableGroup();
   void testDeleteDrawableGroup();
+  void testSubtreeAABB();
+  void testUpdateTransformations();
   esp::logging::LoggingContext loggingContext_;
   size_t numInitialGroups;
   SceneGraph g;
@@ -22,7 +32,9 @@ struct SceneGraphTest : Cr::TestSuite::Tester {
 SceneGraphTest::SceneGraphTest() {
   numInitialGroups = g.getDrawableGroups().size();
   addTests({&SceneGraphTest::testGetDrawableGroup,
-            &SceneGraphTest::testDeleteDrawableGroup});
+            &SceneGraphTest::testDeleteDrawableGroup,
+            &SceneGraphTest::testSubtreeAABB,
+            &SceneGraphTest::testUpdateTransformations});
 }
 
 void SceneGraphTest::testGetDrawableGroup() {
@@ -41,6 +53,73 @@ void SceneGraphTest::testDeleteDrawableGroup() {
   CORRADE_COMPARE(g.getDrawableGroups().size(), numInitialGroups);
   CORRADE_VERIFY(g.getDrawableGroup(groupName) == nullptr);
 }
+
+void SceneGraphTest::testSubtreeAABB() {
+  SceneNode& object = g.getRootNode().createChild();
+  SceneNode& first = object.createChild();
+  SceneNode& second = object.createChild();
+  const Mn::Range3D unitBox{Mn::Vector3{-0.5f}, Mn::Vector3{0.5f}};
+  first.setMeshBB(unitBox);
+  first.computeCumulativeBB();
+  second.setMeshBB(unitBox);
+  second.computeCumulativeBB();
+
+  // nothing to draw yet
+  CORRADE_VERIFY(!object.getSubtreeAABB());
+
+  TestDrawable firstDrawable{first};
+  TestDrawable secondDrawable{second};
+  // done by esp::gfx::Drawable, which needs a GL context
+  first.invalidateSubtreeAABB();
+  second.invalidateSubtreeAABB();
+  first.translate({2.0f, 0.0f, 0.0f});
+  CORRADE_VERIFY(object.getSubtreeAABB());
+  CORRADE_COMPARE(*object.getSubtreeAABB(),
+                  (Mn::Range3D{{-0.5f, -0.5f, -0.5f}, {2.5f, 0.5f, 0.5f}}));
+
+  // moving a descendant updates the cached box of the object
+  second.translate({0.0f, -3.0f, 0.0f});
+  CORRADE_COMPARE(*object.getSubtreeAABB(),
+                  (Mn::Range3D{{-0.5f, -3.5f, -0.5f}, {2.5f, 0.5f, 0.5f}}));
+
+  // and so does moving the object itself
+  object.translate({0.0f, 0.0f, 10.0f});
+  CORRADE_COMPARE(*object.getSubtreeAABB(),
+                  (Mn::Range3D{{-0.5f, -3.5f, 9.5f}, {2.5f, 0.5f, 10.5f}}));
+
+  // reparenting removes the subtree from the old parent's box
+  second.setParent(&g.getRootNode());
+  CORRADE_COMPARE(*object.getSubtreeAABB(),
+                  (Mn::Range3D{{1.5f, -0.5f, 9.5f}, {2.5f, 0.5f, 10.5f}}));
+}
+
+void SceneGraphTest::testUpdateTransformations() {
+  SceneNode& parent = g.getRootNode().createChild();
+  SceneNode& child = parent.createChild();
+  parent.translate({1.0f, 0.0f, 0.0f});
+  child.translate({0.0f, 2.0f, 0.0f});
+  CORRADE_VERIFY(g.updateTransformations() >= 2);
+  CORRADE_VERIFY(!parent.isDirty());
+  CORRADE_VERIFY(!child.isDirty());
+  CORRADE_COMPARE(child.cleanAbsoluteTransformation().translation(),
+                  (Mn::Vector3{1.0f, 2.0f, 0.0f}));
+
+  // nothing moved
+  CORRADE_COMPARE(g.updateTransformations(), std::size_t{0});
+
+  // moving the parent dirties both
+  parent.translate({0.0f, 0.0f, 3.0f});
+  CORRADE_COMPARE(g.updateTransformations(), std::size_t{2});
+  CORRADE_COMPARE(child.cleanAbsoluteTransformation().translation(),
+                  (Mn::Vector3{1.0f, 2.0f, 3.0f}));
+
+  // nodes added after the last update are picked up
+  SceneNode& grandchild = child.createChild();
+  grandchild.translate({0.0f, 0.0f, -3.0f});
+  CORRADE_COMPARE(g.updateTransformations(), std::size_t{1});
+  CORRADE_COMPARE(grandchild.cleanAbsoluteTransformation().translation(),
+                  (Mn::Vector3{1.0f, 2.0f, 0.0f}));
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(SceneGraphTest)
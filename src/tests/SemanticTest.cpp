@@ -2,7 +2,9 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <vector>
 
 #include "esp/core/Esp.h"
@@ -28,6 +30,12 @@ struct SemanticTest : Cr::TestSuite::Tester {
    */
   void TestRegionCreation();
 
+  /**
+   * @brief This test will validate the indexed region queries against
+   * testing every region.
+   */
+  void TestRegionQueries();
+
   esp::logging::LoggingContext loggingContext_;
 
   //
@@ -48,7 +56,8 @@ SemanticTest::SemanticTest() {
   semanticAttr_ = MM->getSemanticAttributesManager()->createObject(
       semanticConfigFile, true);
 
-  addTests({&SemanticTest::TestRegionCreation});
+  addTests({&SemanticTest::TestRegionCreation,
+            &SemanticTest::TestRegionQueries});
 }
 
 void SemanticTest::TestRegionCreation() {
@@ -127,6 +136,51 @@ void SemanticTest::TestRegionCreation() {
 
 }  // namespace
 
+void SemanticTest::TestRegionQueries() {
+  std::shared_ptr<esp::scene::SemanticScene> semanticScene =
+      esp::scene::SemanticScene::create();
+
+  esp::scene::SemanticScene::loadSemanticSceneDescriptor(semanticAttr_,
+                                                         *semanticScene);
+  const auto& regions = semanticScene->regions();
+  CORRADE_COMPARE(regions.size(), 2);
+
+  // sweep a grid over both regions and a margin around them
+  std::vector<Mn::Vector3> points;
+  for (float x = -30.0f; x <= 30.0f; x += 0.5f) {
+    for (float y = -3.0f; y <= 3.0f; y += 1.5f) {
+      for (float z = -12.0f; z <= 12.0f; z += 0.5f) {
+        points.emplace_back(x, y, z);
+      }
+    }
+  }
+
+  std::vector<int> numPointsInRegion(regions.size(), 0);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(points[i]);
+    std::vector<int> expected;
+    for (int rix = 0; rix < regions.size(); ++rix) {
+      if (regions[rix]->contains(points[i])) {
+        expected.push_back(rix);
+        ++numPointsInRegion[rix];
+      }
+    }
+    CORRADE_COMPARE_AS(semanticScene->getRegionsForPoint(points[i]), expected,
+                       Cr::TestSuite::Compare::Container);
+  }
+  CORRADE_VERIFY(numPointsInRegion[0] > 0);
+  CORRADE_VERIFY(numPointsInRegion[1] > 0);
+
+  const auto regionWeights = semanticScene->getRegionsForPoints(points);
+  CORRADE_COMPARE(regionWeights.size(), 2);
+  for (const auto& regionWeight : regionWeights) {
+    CORRADE_ITERATION(regionWeight.first);
+    CORRADE_COMPARE(regionWeight.second,
+                    double(numPointsInRegion[regionWeight.first]) /
+                        points.size());
+  }
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SemanticTest)
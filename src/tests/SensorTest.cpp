@@ -1,16 +1,25 @@
 // Copyright (c) Meta Platforms, Inc. and its affiliates.
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Image.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
 
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/ImpulseResponseCache.h"
+#include "esp/sensor/ObservationEncoder.h"
 #include "esp/sensor/Sensor.h"
 #include "esp/sensor/SensorFactory.h"
 
 namespace Cr = Corrade;
+namespace Mn = Magnum;
 using namespace esp::sensor;
 using namespace esp::scene;
 
@@ -22,6 +31,8 @@ struct SensorTest : Cr::TestSuite::Tester {
   void testSensorFactory();
   void testSensorDestructors();
   void testSetParent();
+  void testImpulseResponseCache();
+  void testObservationEncoder();
 
  private:
   esp::logging::LoggingContext loggingContext_;
@@ -32,6 +43,8 @@ SensorTest::SensorTest() {
   addTests({&SensorTest::testSensorFactory});
   addTests({&SensorTest::testSensorDestructors});
   addTests({&SensorTest::testSetParent});
+  addTests({&SensorTest::testImpulseResponseCache});
+  addTests({&SensorTest::testObservationEncoder});
   // clang-format on
 }
 
@@ -376,6 +389,136 @@ void SensorTest::testSetParent() {
   CORRADE_COMPARE(child2Node.getNodeSensors().size(), 1);
   CORRADE_COMPARE(child2Node.getSubtreeSensors().size(), 1);
 }
+
+void SensorTest::testImpulseResponseCache() {
+  // two channels of 4 samples take 32 bytes, so two responses fit
+  ImpulseResponseCache cache{0.5f, 0.1f, 64};
+  const ImpulseResponseCache::ImpulseResponse ir(2, std::vector<float>(4));
+
+  // poses within the same grid cell and rotation step share a key, q and -q
+  // are the same rotation
+  const Mn::Quaternion rotation =
+      Mn::Quaternion::rotation(Mn::Deg(90.0f), Mn::Vector3::yAxis());
+  const std::string key =
+      cache.key("scene", {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 1.0f}, rotation);
+  CORRADE_COMPARE(cache.key("scene", {0.1f, 0.0f, -0.1f}, {1.1f, 0.0f, 0.9f},
+                            -rotation),
+                  key);
+  CORRADE_VERIFY(cache.key("scene", {0.0f, 0.0f, 0.0f}, {1.5f, 0.0f, 1.0f},
+                           rotation) != key);
+  CORRADE_VERIFY(cache.key("other", {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 1.0f},
+                           rotation) != key);
+  CORRADE_VERIFY(cache.key("scene", {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 1.0f},
+                           Mn::Quaternion{}) != key);
+
+  CORRADE_VERIFY(!cache.find(key));
+  cache.insert(key, ir);
+  CORRADE_COMPARE(cache.size(), 1);
+  CORRADE_COMPARE(cache.memoryUsage(), 32);
+  CORRADE_VERIFY(cache.find(key));
+  CORRADE_COMPARE(cache.find(key)->size(), 2);
+
+  // the least recently used response is evicted once over budget
+  cache.insert("b", ir);
+  CORRADE_VERIFY(cache.find(key));
+  cache.insert("c", ir);
+  CORRADE_COMPARE(cache.size(), 2);
+  CORRADE_COMPARE(cache.memoryUsage(), 64);
+  CORRADE_VERIFY(cache.contains(key));
+  CORRADE_VERIFY(!cache.contains("b"));
+  CORRADE_VERIFY(cache.contains("c"));
+
+  cache.clear();
+  CORRADE_COMPARE(cache.size(), 0);
+  CORRADE_COMPARE(cache.memoryUsage(), 0);
+}
+
+void SensorTest::testObservationEncoder() {
+  const Mn::Vector2i size{16, 8};
+
+  // depth round-trips exactly, including values smaller than their left
+  // neighbor
+  Mn::Image2D depth{Mn::PixelFormat::R32F, size,
+                    Cr::Containers::Array<char>{
+                        Cr::ValueInit, std::size_t(size.product()) * 4}};
+  const auto depthPixels = depth.pixels<Mn::Float>();
+  for (std::size_t y = 0; y != depthPixels.size()[0]; ++y) {
+    for (std::size_t x = 0; x != depthPixels.size()[1]; ++x) {
+      depthPixels[y][x] = 1.0f + 0.25f * y + (x % 5 ? 0.01f * x : 3.0f);
+    }
+  }
+  const std::string encodedDepth =
+      encodeObservation(depth, ObservationEncoding::Lossless);
+  CORRADE_VERIFY(!encodedDepth.empty());
+  CORRADE_COMPARE_AS(encodedDepth.size(), depth.data().size(),
+                     Cr::TestSuite::Compare::Less);
+  Mn::Image2D decodedDepth{Mn::PixelFormat::R32F, size,
+                           Cr::Containers::Array<char>{
+                               Cr::ValueInit, depth.data().size()}};
+  CORRADE_VERIFY(decodeObservation({encodedDepth.data(), encodedDepth.size()},
+                                   ObservationEncoding::Lossless,
+                                   decodedDepth));
+  CORRADE_COMPARE_AS(decodedDepth.data(), depth.data(),
+                     Cr::TestSuite::Compare::Container);
+
+  // 16-bit semantic IDs as well, decoding into the wrong format fails
+  Mn::Image2D ids{Mn::PixelFormat::R16UI, size,
+                  Cr::Containers::Array<char>{
+                      Cr::ValueInit, std::size_t(size.product()) * 2}};
+  const auto idPixels = ids.pixels<Mn::UnsignedShort>();
+  for (std::size_t y = 0; y != idPixels.size()[0]; ++y) {
+    for (std::size_t x = 0; x != idPixels.size()[1]; ++x) {
+      idPixels[y][x] = x < 8 ? 40000 : 3;
+    }
+  }
+  const std::string encodedIds =
+      encodeObservation(ids, ObservationEncoding::Lossless);
+  Mn::Image2D decodedIds{Mn::PixelFormat::R16UI, size,
+                         Cr::Containers::Array<char>{Cr::ValueInit,
+                                                     ids.data().size()}};
+  CORRADE_VERIFY(decodeObservation({encodedIds.data(), encodedIds.size()},
+                                   ObservationEncoding::Lossless, decodedIds));
+  CORRADE_COMPARE_AS(decodedIds.data(), ids.data(),
+                     Cr::TestSuite::Compare::Container);
+  CORRADE_VERIFY(!decodeObservation({encodedIds.data(), encodedIds.size()},
+                                    ObservationEncoding::Lossless,
+                                    decodedDepth));
+
+  // color through JPEG on a background thread only comes back approximately,
+  // and JPEG can't hold depth
+  Mn::Image2D color{Mn::PixelFormat::RGBA8Unorm, size,
+                    Cr::Containers::Array<char>{
+                        Cr::ValueInit, std::size_t(size.product()) * 4}};
+  for (auto row : color.pixels<Mn::Color4ub>()) {
+    for (Mn::Color4ub& pixel : row) {
+      pixel = {200, 100, 50, 255};
+    }
+  }
+  ObservationEncoder encoder{2};
+  CORRADE_COMPARE(encoder.threadCount(), 2);
+  EncodedObservation encodedColor =
+      encoder.encode(color, nullptr, ObservationEncoding::Jpeg, 95);
+  EncodedObservation encodedJpegDepth =
+      encoder.encode(depth, nullptr, ObservationEncoding::Jpeg);
+  encodedColor.wait();
+  CORRADE_VERIFY(encodedColor.ready());
+  CORRADE_VERIFY(encodedJpegDepth.data().empty());
+
+  Mn::Image2D decodedColor{Mn::PixelFormat::RGBA8Unorm, size,
+                           Cr::Containers::Array<char>{
+                               Cr::ValueInit, color.data().size()}};
+  CORRADE_VERIFY(decodeObservation(
+      {encodedColor.data().data(), encodedColor.data().size()},
+      ObservationEncoding::Jpeg, decodedColor));
+  for (auto row : decodedColor.pixels<Mn::Color4ub>()) {
+    for (const Mn::Color4ub& pixel : row) {
+      CORRADE_COMPARE_AS(
+          Mn::Math::abs(Mn::Vector4i{pixel} - Mn::Vector4i{200, 100, 50, 255})
+              .max(),
+          4, Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(SensorTest)
@@ -2,7 +2,10 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -12,16 +15,23 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/PixelFormat.h>
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "esp/assets/Asset.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/RenderTarget.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/physics/RigidObject.h"
 #include "esp/physics/objectManagers/ArticulatedObjectManager.h"
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/EquirectangularSensor.h"
+#include "esp/sensor/LidarSensor.h"
+#include "esp/sim/BatchedSimulator.h"
+#include "esp/sim/DatasetBake.h"
 #include "esp/sim/Simulator.h"
 
 #include "configure.h"
@@ -46,6 +56,8 @@ using esp::sensor::Observation;
 using esp::sensor::ObservationSpace;
 using esp::sensor::ObservationSpaceType;
 using esp::sensor::SensorType;
+using esp::sim::BatchedSimulator;
+using esp::sim::BatchedSimulatorConfiguration;
 using esp::sim::Simulator;
 using esp::sim::SimulatorConfiguration;
 
@@ -139,6 +151,8 @@ struct SimTest : Cr::TestSuite::Tester {
 
   void basic();
   void reconfigure();
+  void prefetchScene();
+  void sceneAssetCache();
   void reset();
   void getSceneRGBAObservation();
   void getSceneWithLightingRGBAObservation();
@@ -151,11 +165,26 @@ struct SimTest : Cr::TestSuite::Tester {
   void loadingObjectTemplates();
   void buildingPrimAssetObjectTemplates();
   void addObjectByHandle();
+  void captureAndRestoreState();
   void addObjectInvertedScale();
   void addSensorToObject();
+  void fusedSensorRendering();
+  void sharedCubeMapRendering();
+  void tiledSensorRendering();
+  void renderViewpoints();
+  void asyncObservationReadback();
+  void resizeSensor();
+  void multiAgentObservations();
+  void instancedRendering();
+  void depthOnlyRendering();
   void createMagnumRenderingOff();
+  void stepPhysicsObservation();
   void getRuntimePerfStats();
+  void getMemoryUsage();
   void testArticulatedObjectSkinned();
+  void batchedSimulatorStepAll();
+  void reuseContextFromPool();
+  void bakeDatasetTwice();
 
   esp::logging::LoggingContext loggingContext_;
   // TODO: remove outlier pixels from image and lower maxThreshold
@@ -186,6 +215,8 @@ SimTest::SimTest() {
   addInstancedTests({
             &SimTest::basic,
             &SimTest::reconfigure,
+            &SimTest::prefetchScene,
+            &SimTest::sceneAssetCache,
             &SimTest::reset,
             &SimTest::getSceneRGBAObservation,
             &SimTest::getSceneWithLightingRGBAObservation,
@@ -198,14 +229,29 @@ SimTest::SimTest() {
             &SimTest::loadingObjectTemplates,
             &SimTest::buildingPrimAssetObjectTemplates,
             &SimTest::addObjectByHandle,
+            &SimTest::captureAndRestoreState,
             &SimTest::addObjectInvertedScale,
             &SimTest::addSensorToObject,
+            &SimTest::fusedSensorRendering,
+            &SimTest::sharedCubeMapRendering,
+            &SimTest::tiledSensorRendering,
+            &SimTest::renderViewpoints,
+            &SimTest::asyncObservationReadback,
+            &SimTest::resizeSensor,
+            &SimTest::multiAgentObservations,
+            &SimTest::instancedRendering,
+            &SimTest::depthOnlyRendering,
             &SimTest::getRuntimePerfStats,
+            &SimTest::getMemoryUsage,
 #ifdef ESP_BUILD_WITH_BULLET
             &SimTest::createMagnumRenderingOff,
+            &SimTest::stepPhysicsObservation,
             &SimTest::testArticulatedObjectSkinned
 #endif
             }, Cr::Containers::arraySize(SimulatorBuilder) );
+  addTests({&SimTest::batchedSimulatorStepAll,
+            &SimTest::reuseContextFromPool,
+            &SimTest::bakeDatasetTwice});
   // clang-format on
 }
 void SimTest::basic() {
@@ -231,6 +277,73 @@ void SimTest::reconfigure() {
   CORRADE_VERIFY(pathfinder != simulator->getPathFinder());
 }
 
+void SimTest::prefetchScene() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+  std::atomic<int> callbackCount{0};
+  std::atomic<bool> prefetchSuccess{false};
+  simulator->prefetchScene(skokloster, [&](bool success) {
+    prefetchSuccess = success;
+    ++callbackCount;
+  });
+  CORRADE_VERIFY(!simulator->isScenePrefetched(vangogh));
+
+  // the reconfigure waits for the prefetch and consumes it
+  SimulatorConfiguration cfg =
+      simulator->getMetadataMediator()->getSimulatorConfiguration();
+  cfg.activeSceneName = skokloster;
+  simulator->reconfigure(cfg);
+  CORRADE_COMPARE(callbackCount, 1);
+  CORRADE_VERIFY(prefetchSuccess);
+  CORRADE_VERIFY(!simulator->isScenePrefetched(skokloster));
+  CORRADE_VERIFY(simulator->getPathFinder()->isLoaded());
+}
+
+void SimTest::sceneAssetCache() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  constexpr auto hitsIdx = 7;
+  constexpr auto missesIdx = 8;
+  constexpr auto evictionsIdx = 9;
+  auto statNames = simulator->getRuntimePerfStatNames();
+  CORRADE_COMPARE(statNames[hitsIdx], "asset cache hits");
+  CORRADE_COMPARE(statNames[missesIdx], "asset cache misses");
+  CORRADE_COMPARE(statNames[evictionsIdx], "asset cache evictions");
+
+  auto statValues = simulator->getRuntimePerfStatValues();
+  CORRADE_COMPARE(statValues[hitsIdx], 0);
+  CORRADE_VERIFY(statValues[missesIdx] > 0);
+
+  // without a budget, going back to a scene reuses its loaded stage
+  SimulatorConfiguration cfg =
+      simulator->getMetadataMediator()->getSimulatorConfiguration();
+  cfg.activeSceneName = skokloster;
+  simulator->reconfigure(cfg);
+  cfg.activeSceneName = vangogh;
+  simulator->reconfigure(cfg);
+  statValues = simulator->getRuntimePerfStatValues();
+  CORRADE_VERIFY(statValues[hitsIdx] > 0);
+  CORRADE_COMPARE(statValues[evictionsIdx], 0);
+  const float misses = statValues[missesIdx];
+
+  // with a budget nothing fits in, everything the new scene doesn't use is
+  // released and has to be loaded again
+  cfg.activeSceneName = skokloster;
+  cfg.assetCacheCpuBudget = 1;
+  cfg.assetCacheGpuBudget = 1;
+  simulator->reconfigure(cfg);
+  statValues = simulator->getRuntimePerfStatValues();
+  CORRADE_VERIFY(statValues[evictionsIdx] > 0);
+
+  cfg.activeSceneName = vangogh;
+  simulator->reconfigure(cfg);
+  statValues = simulator->getRuntimePerfStatValues();
+  CORRADE_VERIFY(statValues[missesIdx] > misses);
+}
+
 void SimTest::reset() {
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -662,6 +775,35 @@ void SimTest::addObjectByHandle() {
   CORRADE_VERIFY(obj->getID() != esp::ID_UNDEFINED);
 }
 
+void SimTest::captureAndRestoreState() {
+  ESP_DEBUG() << "Starting Test : captureAndRestoreState";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, planeStage, true, esp::NO_LIGHT_KEY);
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  const auto objHandle = Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json");
+
+  auto obj = rigidObjMgr->addObjectByHandle(objHandle);
+  CORRADE_VERIFY(obj->isAlive());
+  const Mn::Vector3 capturedTranslation{1.0f, 0.5f, -2.5f};
+  obj->setTranslation(capturedTranslation);
+  const std::vector<char> state = simulator->captureState();
+
+  // diverge from the captured state
+  obj->setTranslation({-1.0f, 2.0f, 3.0f});
+  auto otherObj = rigidObjMgr->addObjectByHandle(objHandle);
+  CORRADE_VERIFY(otherObj->isAlive());
+  CORRADE_COMPARE(simulator->getExistingObjectIDs().size(), 2);
+
+  simulator->restoreState(state);
+  // the original object is reused in place, the newer one is removed
+  CORRADE_VERIFY(obj->isAlive());
+  CORRADE_COMPARE(obj->getTranslation(), capturedTranslation);
+  CORRADE_COMPARE(simulator->getExistingObjectIDs().size(), 1);
+  CORRADE_VERIFY(!otherObj->isAlive());
+}
+
 void SimTest::addObjectsAndMakeObservation(
     Simulator& sim,
     esp::sensor::CameraSensorSpec& cameraSpec,
@@ -836,6 +978,576 @@ void SimTest::addSensorToObject() {
       (Mn::DebugTools::CompareImageToFile{maxThreshold, 0.75f}));
 }
 
+void SimTest::fusedSensorRendering() {
+  ESP_DEBUG() << "Starting Test : fusedSensorRendering";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  // a color and a depth sensor mounted at the same spot
+  auto colorSpec = CameraSensorSpec::create();
+  colorSpec->uuid = "color";
+  colorSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  colorSpec->sensorType = SensorType::Color;
+  colorSpec->position = {1.0f, 1.5f, 1.0f};
+  colorSpec->resolution = {128, 128};
+  auto depthSpec = CameraSensorSpec::create(*colorSpec);
+  depthSpec->uuid = "depth";
+  depthSpec->sensorType = SensorType::Depth;
+
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {colorSpec, depthSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // reference observations with each sensor drawing into its own target.
+  // Copied out as the sensors reuse their observation buffers.
+  Observation observation;
+  CORRADE_VERIFY(simulator->getAgentObservation(0, "color", observation));
+  const std::vector<uint8_t> expectedColor(observation.buffer->data.begin(),
+                                           observation.buffer->data.end());
+  CORRADE_VERIFY(simulator->getAgentObservation(0, "depth", observation));
+  const std::vector<uint8_t> expectedDepth(observation.buffer->data.begin(),
+                                           observation.buffer->data.end());
+
+  auto& colorSensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("color"));
+  auto& depthSensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("depth"));
+  const std::vector<esp::sensor::VisualSensor*> group{&colorSensor,
+                                                      &depthSensor};
+  simulator->getRenderer()->bindFusedRenderTarget(group);
+  CORRADE_VERIFY(&colorSensor.renderTarget() == &depthSensor.renderTarget());
+
+  // a single pass serves both observations, matching the separate draws.
+  // The color sensor's own target has a lower precision depth buffer, so
+  // color may differ in a few pixels. The depth sensor's own draw is
+  // depth-only, with a different shader, so depth may differ by rounding.
+  simulator->getRenderer()->drawFused(group, *simulator);
+  colorSensor.readObservation(observation);
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {colorSpec->resolution[0], colorSpec->resolution[1]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {colorSpec->resolution[0], colorSpec->resolution[1]},
+                       Cr::Containers::arrayView(expectedColor)}),
+      (Mn::DebugTools::CompareImage{maxThreshold, 0.75f}));
+  depthSensor.readObservation(observation);
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[0], depthSpec->resolution[1]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[0], depthSpec->resolution[1]},
+                       Cr::Containers::arrayView(expectedDepth)}),
+      (Mn::DebugTools::CompareImage{1.0e-3f, 1.0e-5f}));
+}
+
+void SimTest::sharedCubeMapRendering() {
+  ESP_DEBUG() << "Starting Test : sharedCubeMapRendering";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  // a color and a depth equirectangular sensor mounted at the same spot
+  auto colorSpec = esp::sensor::EquirectangularSensorSpec::create();
+  colorSpec->uuid = "color";
+  colorSpec->sensorType = SensorType::Color;
+  colorSpec->position = {1.0f, 1.5f, 1.0f};
+  colorSpec->resolution = {64, 128};
+  auto depthSpec = esp::sensor::EquirectangularSensorSpec::create(*colorSpec);
+  depthSpec->uuid = "depth";
+  depthSpec->sensorType = SensorType::Depth;
+
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {colorSpec, depthSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // reference observations with each sensor rendering its own cubemap
+  Observation observation;
+  CORRADE_VERIFY(simulator->getAgentObservation(0, "color", observation));
+  const std::vector<uint8_t> expectedColor(observation.buffer->data.begin(),
+                                           observation.buffer->data.end());
+  CORRADE_VERIFY(simulator->getAgentObservation(0, "depth", observation));
+  const std::vector<uint8_t> expectedDepth(observation.buffer->data.begin(),
+                                           observation.buffer->data.end());
+
+  auto& colorSensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("color"));
+  auto& depthSensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("depth"));
+  const std::vector<esp::sensor::VisualSensor*> group{&colorSensor,
+                                                      &depthSensor};
+  simulator->getRenderer()->bindFusedRenderTarget(group);
+  // the projections still go to separate targets, only the cubemap is shared
+  CORRADE_VERIFY(&colorSensor.renderTarget() != &depthSensor.renderTarget());
+
+  // a single cubemap pass serves both projections. Same tolerances as in
+  // fusedSensorRendering(), as the cubemap depth is a different pass too.
+  simulator->getRenderer()->drawFused(group, *simulator);
+  colorSensor.readObservation(observation);
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {colorSpec->resolution[1], colorSpec->resolution[0]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {colorSpec->resolution[1], colorSpec->resolution[0]},
+                       Cr::Containers::arrayView(expectedColor)}),
+      (Mn::DebugTools::CompareImage{maxThreshold, 0.75f}));
+  depthSensor.readObservation(observation);
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[1], depthSpec->resolution[0]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[1], depthSpec->resolution[0]},
+                       Cr::Containers::arrayView(expectedDepth)}),
+      (Mn::DebugTools::CompareImage{1.0e-3f, 1.0e-5f}));
+}
+
+void SimTest::tiledSensorRendering() {
+  ESP_DEBUG() << "Starting Test : tiledSensorRendering";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  // three color sensors looking from different spots, tiled in a 2x2 grid
+  std::vector<CameraSensorSpec::ptr> specs;
+  AgentConfiguration agentConfig{};
+  for (int i = 0; i != 3; ++i) {
+    auto spec = CameraSensorSpec::create();
+    spec->uuid = "color" + std::to_string(i);
+    spec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+    spec->sensorType = SensorType::Color;
+    spec->position = {1.0f, 1.5f, 1.0f - float(i)};
+    spec->resolution = {64, 64};
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // reference observations with each sensor drawing into its own target
+  std::vector<esp::sensor::VisualSensor*> group;
+  std::vector<std::vector<uint8_t>> expected;
+  Observation observation;
+  for (int i = 0; i != 3; ++i) {
+    const std::string uuid = "color" + std::to_string(i);
+    CORRADE_VERIFY(simulator->getAgentObservation(0, uuid, observation));
+    expected.emplace_back(observation.buffer->data.begin(),
+                          observation.buffer->data.end());
+    group.push_back(&static_cast<esp::sensor::VisualSensor&>(
+        agent->getSubtreeSensorSuite().get(uuid)));
+  }
+
+  std::shared_ptr<esp::gfx::RenderTarget> atlas =
+      simulator->getRenderer()->bindTiledRenderTarget(group);
+  CORRADE_COMPARE(atlas->framebufferSize(), (Mn::Vector2i{128, 128}));
+  CORRADE_COMPARE(group[1]->renderTarget().viewport(),
+                  Mn::Range2Di::fromSize({64, 0}, {64, 64}));
+  CORRADE_COMPARE(group[2]->renderTarget().viewport(),
+                  Mn::Range2Di::fromSize({0, 64}, {64, 64}));
+
+  // each sensor renders and reads its own tile like before
+  for (int i = 0; i != 3; ++i) {
+    CORRADE_VERIFY(simulator->getAgentObservation(
+        0, "color" + std::to_string(i), observation));
+    CORRADE_COMPARE_AS(
+        Cr::Containers::ArrayView<const uint8_t>{observation.buffer->data},
+        Cr::Containers::ArrayView<const uint8_t>{expected[i]},
+        Cr::TestSuite::Compare::Container);
+  }
+
+  // and a single read of the atlas returns all of them
+  std::vector<uint8_t> atlasPixels(128 * 128 * 4);
+  atlas->readFrameRgba(Mn::MutableImageView2D{
+      Mn::PixelFormat::RGBA8Unorm, {128, 128}, atlasPixels});
+  for (int i = 0; i != 3; ++i) {
+    const Mn::Range2Di tile = group[i]->renderTarget().viewport();
+    std::vector<uint8_t> tilePixels;
+    for (int y = tile.bottom(); y != tile.top(); ++y) {
+      const auto rowBegin = atlasPixels.begin() + (y * 128 + tile.left()) * 4;
+      tilePixels.insert(tilePixels.end(), rowBegin,
+                        rowBegin + tile.sizeX() * 4);
+    }
+    CORRADE_COMPARE_AS(Cr::Containers::ArrayView<const uint8_t>{tilePixels},
+                       Cr::Containers::ArrayView<const uint8_t>{expected[i]},
+                       Cr::TestSuite::Compare::Container);
+  }
+}
+
+void SimTest::renderViewpoints() {
+  ESP_DEBUG() << "Starting Test : renderViewpoints";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  auto spec = CameraSensorSpec::create();
+  spec->uuid = "color";
+  spec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  spec->sensorType = SensorType::Color;
+  spec->position = {1.0f, 1.5f, 1.0f};
+  spec->resolution = {48, 64};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {spec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("color"));
+
+  // reference observations of the agent sensor from a few spots
+  std::vector<Mn::Matrix4> transformations;
+  std::vector<std::vector<uint8_t>> expected;
+  Observation observation;
+  for (int i = 0; i != 3; ++i) {
+    AgentState state;
+    state.position = {0.0f, 0.0f, -float(i)};
+    agent->setState(state);
+    transformations.push_back(sensor.node().absoluteTransformationMatrix());
+    CORRADE_VERIFY(simulator->getAgentObservation(0, "color", observation));
+    expected.emplace_back(observation.buffer->data.begin(),
+                          observation.buffer->data.end());
+  }
+
+  // the views come out one after another, with the rows flipped compared to
+  // the observations
+  const std::size_t rowSize = 64 * 4;
+  std::vector<char> images(3 * 48 * rowSize);
+  simulator->renderViewpoints(transformations, *spec, images);
+  for (int i = 0; i != 3; ++i) {
+    std::vector<uint8_t> image;
+    for (int y = 47; y >= 0; --y) {
+      const auto rowBegin = images.begin() + (i * 48 + y) * rowSize;
+      image.insert(image.end(), rowBegin, rowBegin + rowSize);
+    }
+    CORRADE_COMPARE_AS(Cr::Containers::ArrayView<const uint8_t>{image},
+                       Cr::Containers::ArrayView<const uint8_t>{expected[i]},
+                       Cr::TestSuite::Compare::Container);
+  }
+
+  // the temporary camera doesn't stay around
+  CORRADE_COMPARE(agent->getSubtreeSensors().size(), 1);
+  CORRADE_VERIFY(!simulator->getActiveSceneGraph()
+                      .getRootNode()
+                      .getSubtreeSensorSuite()
+                      .getSensors()
+                      .count("Simulator::renderViewpoints"));
+}
+
+void SimTest::asyncObservationReadback() {
+  ESP_DEBUG() << "Starting Test : asyncObservationReadback";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  auto colorSpec = CameraSensorSpec::create();
+  colorSpec->uuid = "color";
+  colorSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  colorSpec->sensorType = SensorType::Color;
+  colorSpec->position = {1.0f, 1.5f, 1.0f};
+  colorSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {colorSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+  auto& sensor = static_cast<esp::sensor::VisualSensor&>(
+      agent->getSubtreeSensorSuite().get("color"));
+
+  // frame N, read back synchronously for reference and then asynchronously
+  Observation observation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  const std::vector<uint8_t> expectedFirst(observation.buffer->data.begin(),
+                                           observation.buffer->data.end());
+  sensor.startReadObservation();
+  CORRADE_COMPARE(sensor.pendingReadObservationCount(), 1);
+
+  // frame N + 1 renders from a different spot while N is still pending
+  agent->node().rotateY(90.0_degf);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  const std::vector<uint8_t> expectedSecond(observation.buffer->data.begin(),
+                                            observation.buffer->data.end());
+  CORRADE_VERIFY(expectedFirst != expectedSecond);
+  sensor.startReadObservation();
+  CORRADE_COMPARE(sensor.pendingReadObservationCount(), 2);
+
+  // readbacks complete in order
+  CORRADE_VERIFY(sensor.finishReadObservation(observation));
+  CORRADE_COMPARE_AS(
+      Cr::Containers::ArrayView<const uint8_t>{observation.buffer->data},
+      Cr::Containers::ArrayView<const uint8_t>{expectedFirst},
+      Cr::TestSuite::Compare::Container);
+  CORRADE_VERIFY(sensor.finishReadObservation(observation));
+  CORRADE_COMPARE_AS(
+      Cr::Containers::ArrayView<const uint8_t>{observation.buffer->data},
+      Cr::Containers::ArrayView<const uint8_t>{expectedSecond},
+      Cr::TestSuite::Compare::Container);
+  CORRADE_COMPARE(sensor.pendingReadObservationCount(), 0);
+  CORRADE_VERIFY(!sensor.finishReadObservation(observation));
+}
+
+void SimTest::resizeSensor() {
+  ESP_DEBUG() << "Starting Test : resizeSensor";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  auto colorSpec = CameraSensorSpec::create();
+  colorSpec->uuid = "color";
+  colorSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  colorSpec->sensorType = SensorType::Color;
+  colorSpec->position = {1.0f, 1.5f, 1.0f};
+  colorSpec->resolution = {128, 128};
+  auto scaledSpec = CameraSensorSpec::create();
+  *scaledSpec = *colorSpec;
+  scaledSpec->uuid = "scaled";
+  scaledSpec->renderScale = 0.5f;
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {colorSpec, scaledSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+  auto& sensor = static_cast<esp::sensor::CameraSensor&>(
+      agent->getSubtreeSensorSuite().get("color"));
+  auto& scaled = static_cast<esp::sensor::CameraSensor&>(
+      agent->getSubtreeSensorSuite().get("scaled"));
+
+  Observation observation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE(observation.buffer->shape,
+                  (std::vector<size_t>{128, 128, 4}));
+
+  // the render target and the observation get reallocated on next use
+  sensor.setWidth(96);
+  sensor.setHeight(64);
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_COMPARE(observation.buffer->shape,
+                  (std::vector<size_t>{64, 96, 4}));
+  CORRADE_COMPARE(sensor.renderTarget().framebufferSize(),
+                  Mn::Vector2i(96, 64));
+
+  // a scaled sensor renders at half the size but reads the full resolution
+  CORRADE_COMPARE(scaled.renderTargetSize(), Mn::Vector2i(64, 64));
+  CORRADE_VERIFY(scaled.getObservation(*simulator, observation));
+  CORRADE_COMPARE(observation.buffer->shape,
+                  (std::vector<size_t>{128, 128, 4}));
+  CORRADE_COMPARE(scaled.renderTarget().framebufferSize(),
+                  Mn::Vector2i(64, 64));
+  CORRADE_COMPARE(scaled.renderTarget().outputSize(), Mn::Vector2i(128, 128));
+}
+
+void SimTest::multiAgentObservations() {
+  ESP_DEBUG() << "Starting Test : multiAgentObservations";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  std::vector<int> agentIds;
+  for (float angle : {0.0f, 90.0f}) {
+    auto colorSpec = CameraSensorSpec::create();
+    colorSpec->uuid = "color";
+    colorSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+    colorSpec->sensorType = SensorType::Color;
+    colorSpec->position = {1.0f, 1.5f, 1.0f};
+    colorSpec->resolution = {64, 64};
+    auto depthSpec = CameraSensorSpec::create();
+    *depthSpec = *colorSpec;
+    depthSpec->uuid = "depth";
+    depthSpec->sensorType = SensorType::Depth;
+    depthSpec->channels = 1;
+    AgentConfiguration agentConfig{};
+    agentConfig.sensorSpecifications = {colorSpec, depthSpec};
+    Agent::ptr agent = simulator->addAgent(agentConfig);
+    agent->setInitialState(AgentState{});
+    agent->node().rotateY(Mn::Deg(angle));
+    // agents are numbered in the order they're added
+    agentIds.push_back(agentIds.size());
+  }
+
+  // the batched path matches observing each sensor on its own
+  std::map<int, std::map<std::string, Observation>> observations;
+  CORRADE_COMPARE(simulator->getAgentsObservations(agentIds, observations), 4);
+  CORRADE_COMPARE(observations.size(), 2);
+  for (const int agentId : agentIds) {
+    for (const char* uuid : {"color", "depth"}) {
+      CORRADE_ITERATION(agentId << uuid);
+      const auto found = observations[agentId].find(uuid);
+      CORRADE_VERIFY(found != observations[agentId].end());
+      const std::vector<uint8_t> batched(found->second.buffer->data.begin(),
+                                         found->second.buffer->data.end());
+      Observation single;
+      CORRADE_VERIFY(simulator->getAgentObservation(agentId, uuid, single));
+      CORRADE_COMPARE_AS(
+          Cr::Containers::ArrayView<const uint8_t>{single.buffer->data},
+          Cr::Containers::ArrayView<const uint8_t>{batched},
+          Cr::TestSuite::Compare::Container);
+    }
+  }
+
+  // disabled sensors are skipped unless requested by name
+  for (const int agentId : agentIds) {
+    simulator->getAgent(agentId)
+        ->getSubtreeSensorSuite()
+        .get("depth")
+        .setEnabled(false);
+  }
+  CORRADE_COMPARE(simulator->getAgentsObservations(agentIds, observations), 2);
+  for (const int agentId : agentIds) {
+    CORRADE_ITERATION(agentId);
+    CORRADE_COMPARE(observations[agentId].size(), 1);
+    CORRADE_COMPARE(observations[agentId].count("color"), 1);
+  }
+  std::map<std::string, Observation> subset;
+  CORRADE_COMPARE(
+      simulator->getAgentObservations(0, {"depth", "nonexistent"}, subset), 1);
+  CORRADE_COMPARE(subset.count("depth"), 1);
+}
+
+void SimTest::instancedRendering() {
+  ESP_DEBUG() << "Starting Test : instancedRendering";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, planeStage, true, esp::NO_LIGHT_KEY);
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  auto objAttrMgr = simulator->getObjectAttributesManager();
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {0.0f, 1.5f, 0.0f};
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // Phong-shaded copies of a box share mesh, material and lights, so they
+  // get batched into instanced draws
+  ObjectAttributes::ptr boxAttr = objAttrMgr->getObjectCopyByHandle(
+      Cr::Utility::Path::join(TEST_ASSETS,
+                              "objects/nested_box.object_config.json"));
+  boxAttr->setShaderType("phong");
+  objAttrMgr->registerObject(boxAttr, "phong_box");
+  // PBR copies, added in between, get drawn sorted by shader and material
+  ObjectAttributes::ptr pbrBoxAttr = objAttrMgr->getObjectCopyByHandle(
+      Cr::Utility::Path::join(TEST_ASSETS,
+                              "objects/nested_box.object_config.json"));
+  pbrBoxAttr->setShaderType("pbr");
+  objAttrMgr->registerObject(pbrBoxAttr, "pbr_box");
+  for (int i = 0; i < 3; ++i) {
+    auto obj = rigidObjMgr->addObjectByHandle("phong_box");
+    CORRADE_VERIFY(obj);
+    obj->setTranslation({-1.5f + 1.5f * i, 0.5f, -2.5f});
+    auto pbrObj = rigidObjMgr->addObjectByHandle("pbr_box");
+    CORRADE_VERIFY(pbrObj);
+    pbrObj->setTranslation({-1.5f + 1.5f * i, 2.0f, -2.5f});
+  }
+
+  Observation observation;
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  Cr::Containers::Array<uint8_t> expected{Cr::NoInit,
+                                          observation.buffer->data.size()};
+  Cr::Utility::copy(observation.buffer->data, expected);
+
+  // only the draw order changes
+  simulator->setInstancedRenderingEnabled(true);
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[0], pinholeCameraSpec->resolution[1]},
+          observation.buffer->data}),
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[0], pinholeCameraSpec->resolution[1]},
+          expected}),
+      (Mn::DebugTools::CompareImage{maxThreshold, 0.01f}));
+}
+
+void SimTest::stepPhysicsObservation() {
+  ESP_DEBUG() << "Starting Test : stepPhysicsObservation";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, planeStage, true, esp::NO_LIGHT_KEY);
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {0.0f, 1.5f, 0.0f};
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // a box in front of the camera, falling once the world is stepped
+  auto obj = rigidObjMgr->addObjectByHandle(Cr::Utility::Path::join(
+      TEST_ASSETS, "objects/nested_box.object_config.json"));
+  CORRADE_VERIFY(obj);
+  obj->setMotionType(esp::physics::MotionType::DYNAMIC);
+  obj->setTranslation({0.0f, 2.0f, -2.5f});
+
+  Observation observation;
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  const std::vector<uint8_t> before(observation.buffer->data.begin(),
+                                    observation.buffer->data.end());
+
+  // the step cleans all transformations before anything is drawn, the
+  // camera stays put, so only the moved box can make the image differ
+  simulator->stepWorld(0.5);
+  CORRADE_COMPARE_AS(obj->getTranslation().y(), 1.5f,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  CORRADE_COMPARE(observation.buffer->data.size(), before.size());
+  CORRADE_VERIFY(!std::equal(before.begin(), before.end(),
+                             observation.buffer->data.begin()));
+}
+
+void SimTest::depthOnlyRendering() {
+  ESP_DEBUG() << "Starting Test : depthOnlyRendering";
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  auto depthSpec = CameraSensorSpec::create();
+  depthSpec->uuid = "depth";
+  depthSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  depthSpec->sensorType = SensorType::Depth;
+  depthSpec->position = {1.0f, 1.5f, 1.0f};
+  depthSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {depthSpec};
+  Agent::ptr agent = simulator->addAgent(agentConfig);
+  agent->setInitialState(AgentState{});
+
+  // depth sensors draw depth only
+  Observation observation;
+  CORRADE_VERIFY(simulator->getAgentObservation(0, "depth", observation));
+  const std::vector<uint8_t> depthOnly(observation.buffer->data.begin(),
+                                       observation.buffer->data.end());
+
+  // fully shaded draw of the same view
+  auto& depthSensor = static_cast<esp::sensor::CameraSensor&>(
+      agent->getSubtreeSensorSuite().get("depth"));
+  depthSensor.renderTarget().renderEnter();
+  depthSensor.draw(simulator->getActiveSceneGraph(),
+                   esp::gfx::RenderCamera::Flag::FrustumCulling);
+  depthSensor.renderTarget().renderExit();
+  depthSensor.readObservation(observation);
+
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[0], depthSpec->resolution[1]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::R32F,
+                       {depthSpec->resolution[0], depthSpec->resolution[1]},
+                       Cr::Containers::arrayView(depthOnly)}),
+      (Mn::DebugTools::CompareImage{1.0e-3f, 1.0e-5f}));
+}
+
 void SimTest::createMagnumRenderingOff() {
   ESP_DEBUG() << "Starting Test : createMagnumRenderingOff";
 
@@ -879,6 +1591,94 @@ void SimTest::createMagnumRenderingOff() {
     point = raycastresults.hits[0].point;
     CORRADE_COMPARE_AS(distanceBetween(point, {10.0, 10.1, 10.0}), 0.001,
                        Cr::TestSuite::Compare::Less);
+
+    // the batched variants report the same closest hits, a zero-length ray
+    // is a miss
+    const Mn::Vector3 origins[]{
+        {10.0, 9.0, 10.0}, {10.0, 11.0, 10.0}, {10.0, 9.0, 10.0}};
+    const Mn::Vector3 directions[]{
+        {0.0, 1.0, 0.0}, {0.0, -1.0, 0.0}, {0.0, 0.0, 0.0}};
+    float distances[3];
+    int objectIds[3];
+    Mn::Vector3 normals[3];
+    simulator->castRays(origins, directions, 100.0, distances, objectIds,
+                        normals);
+    CORRADE_COMPARE(objectIds[0], obj->getID());
+    CORRADE_COMPARE(objectIds[1], obj->getID());
+    CORRADE_COMPARE(objectIds[2], esp::ID_UNDEFINED);
+    CORRADE_COMPARE_WITH(distances[0], 0.9f,
+                         Cr::TestSuite::Compare::around(0.001f));
+    CORRADE_COMPARE_WITH(distances[1], 0.9f,
+                         Cr::TestSuite::Compare::around(0.001f));
+    CORRADE_COMPARE(distances[2], 100.0f);
+    CORRADE_COMPARE_AS(distanceBetween(normals[0], {0.0, -1.0, 0.0}), 0.001,
+                       Cr::TestSuite::Compare::Less);
+    CORRADE_COMPARE(normals[2], Mn::Vector3{});
+
+    constexpr std::size_t maxHits = 4;
+    float allDistances[3 * maxHits];
+    int allObjectIds[3 * maxHits];
+    int hitCounts[3];
+    simulator->castRaysAllHits(origins, directions, 100.0, maxHits,
+                               allDistances, allObjectIds, nullptr,
+                               hitCounts);
+    CORRADE_COMPARE_AS(hitCounts[0], 1, Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(allObjectIds[0], obj->getID());
+    CORRADE_COMPARE(allDistances[0], distances[0]);
+    for (int hit = 1; hit < hitCounts[0]; ++hit) {
+      CORRADE_COMPARE_AS(allDistances[hit - 1], allDistances[hit],
+                         Cr::TestSuite::Compare::LessOrEqual);
+    }
+    CORRADE_COMPARE(hitCounts[2], 0);
+    CORRADE_COMPARE(allObjectIds[2 * maxHits], esp::ID_UNDEFINED);
+
+    // a capsule reaching 0.1 above its center hits 0.1 earlier than a ray
+    auto sweepresults = simulator->castCapsule(
+        esp::geo::Ray({10.0, 9.0, 10.0}, {0.0, 1.0, 0.0}), 0.05, 0.1, 100.0);
+    CORRADE_VERIFY(sweepresults.hasHits());
+    CORRADE_COMPARE(sweepresults.hits[0].objectId, obj->getID());
+    CORRADE_COMPARE_WITH(sweepresults.hits[0].rayDistance, 0.8,
+                         Cr::TestSuite::Compare::around(0.01));
+    simulator->castCapsules(origins, directions, 0.05, 0.1, 100.0, distances,
+                            objectIds, normals);
+    CORRADE_COMPARE(objectIds[0], obj->getID());
+    CORRADE_COMPARE(objectIds[1], obj->getID());
+    CORRADE_COMPARE(objectIds[2], esp::ID_UNDEFINED);
+    CORRADE_COMPARE_WITH(distances[0], 0.8f,
+                         Cr::TestSuite::Compare::around(0.01f));
+    CORRADE_COMPARE_WITH(distances[1], 0.8f,
+                         Cr::TestSuite::Compare::around(0.01f));
+    CORRADE_COMPARE(distances[2], 100.0f);
+    CORRADE_COMPARE_WITH(Mn::Math::abs(normals[0].y()), 1.0f,
+                         Cr::TestSuite::Compare::around(0.01f));
+    CORRADE_COMPARE(normals[2], Mn::Vector3{});
+
+    // a box around the object finds just it, one far away nothing
+    constexpr std::size_t maxOverlaps = 2;
+    const Mn::Range3D boxes[]{
+        Mn::Range3D::fromCenter({10.0, 10.0, 10.0}, Mn::Vector3{0.5}),
+        Mn::Range3D::fromCenter({10.0, 50.0, 10.0}, Mn::Vector3{0.5})};
+    int overlapObjectIds[2 * maxOverlaps];
+    int overlapLinkIds[2 * maxOverlaps];
+    int overlapCounts[2];
+    simulator->queryBoxOverlaps(boxes, maxOverlaps, overlapObjectIds,
+                                overlapLinkIds, overlapCounts);
+    CORRADE_COMPARE(overlapCounts[0], 1);
+    CORRADE_COMPARE(overlapObjectIds[0], obj->getID());
+    CORRADE_COMPARE(overlapLinkIds[0], -1);
+    CORRADE_COMPARE(overlapObjectIds[1], esp::ID_UNDEFINED);
+    CORRADE_COMPARE(overlapCounts[1], 0);
+    CORRADE_COMPARE(overlapObjectIds[maxOverlaps], esp::ID_UNDEFINED);
+
+    // a sphere above the object reaches it only with the larger radius
+    const Mn::Vector3 centers[]{{10.0, 10.5, 10.0}, {10.0, 10.5, 10.0}};
+    const float radii[]{0.2f, 0.6f};
+    simulator->querySphereOverlaps(centers, radii, maxOverlaps,
+                                   overlapObjectIds, overlapLinkIds,
+                                   overlapCounts);
+    CORRADE_COMPARE(overlapCounts[0], 0);
+    CORRADE_COMPARE(overlapCounts[1], 1);
+    CORRADE_COMPARE(overlapObjectIds[maxOverlaps], obj->getID());
   };
 
   auto testBoundingBox = [&]() {
@@ -928,6 +1728,31 @@ void SimTest::createMagnumRenderingOff() {
   // check that there is no renderer
   CORRADE_VERIFY(!simulator->getRenderer());
   CORRADE_VERIFY(!cameraSensor.getObservation(*simulator, observation));
+
+  // a lidar doesn't need a renderer, point a narrow one down at the object
+  auto lidarSpec = esp::sensor::LidarSensorSpec::create();
+  lidarSpec->horizontalResolution = 3;
+  lidarSpec->verticalResolution = 1;
+  lidarSpec->horizontalFov = Mn::Deg{3.0f};
+  lidarSpec->maxRange = 10.0f;
+  lidarSpec->position = {0.0f, 0.0f, 0.0f};
+  esp::scene::SceneNode& lidarNode =
+      simulator->getActiveSceneGraph().getRootNode().createChild(
+          {esp::scene::SceneNodeTag::Leaf});
+  auto& lidar = lidarNode.addFeature<esp::sensor::LidarSensor>(lidarSpec);
+  lidarNode.rotateX(-90.0_degf);
+  lidarNode.translate({10.0f, 12.0f, 10.0f});
+  ObservationSpace lidarSpace;
+  CORRADE_VERIFY(lidar.getObservationSpace(lidarSpace));
+  CORRADE_COMPARE(lidarSpace.shape, (std::vector<size_t>{1, 3}));
+  CORRADE_VERIFY(lidar.getObservation(*simulator, observation));
+  const auto* ranges =
+      reinterpret_cast<const float*>(observation.buffer->data.data());
+  for (std::size_t i = 0; i != 3; ++i) {
+    CORRADE_COMPARE(lidar.hitObjectIds()[i], obj->getID());
+    CORRADE_COMPARE_WITH(ranges[i], 1.9f,
+                         Cr::TestSuite::Compare::around(0.01f));
+  }
 }
 
 void SimTest::getRuntimePerfStats() {
@@ -979,6 +1804,36 @@ void SimTest::getRuntimePerfStats() {
   CORRADE_COMPARE(statValues[drawFacesIdx], 0);
 }
 
+void SimTest::getMemoryUsage() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, true, esp::NO_LIGHT_KEY);
+
+  auto usage = simulator->getMemoryUsage();
+  CORRADE_COMPARE(usage.size(), 5);
+  CORRADE_VERIFY(usage["resources"].cpuBytes > 0);
+  CORRADE_VERIFY(usage["resources"].gpuBytes > 0);
+  CORRADE_COMPARE(usage["navmesh"].cpuBytes > 0,
+                  simulator->getPathFinder()->isLoaded());
+  CORRADE_COMPARE(usage["observations"].cpuBytes, 0);
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  simulator->addAgent(agentConfig);
+  Observation observation;
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+
+  // the observation buffer and at least the RGBA attachment
+  usage = simulator->getMemoryUsage();
+  CORRADE_VERIFY(usage["observations"].cpuBytes >= 128 * 128 * 4);
+  CORRADE_VERIFY(usage["observations"].gpuBytes >= 128 * 128 * 4);
+}
+
 void SimTest::testArticulatedObjectSkinned() {
   ESP_DEBUG() << "Starting Test : testArticulatedObjectSkinned";
 
@@ -1038,6 +1893,157 @@ void SimTest::testArticulatedObjectSkinned() {
 
 }  // SimTest::testArticulatedObjectSkinned
 
+void SimTest::batchedSimulatorStepAll() {
+  BatchedSimulatorConfiguration batchConfig{};
+  batchConfig.simConfig.activeSceneName = vangogh;
+  batchConfig.simConfig.overrideSceneLightDefaults = true;
+  batchConfig.simConfig.sceneLightSetupKey = esp::NO_LIGHT_KEY;
+  batchConfig.numEnvironments = 3;
+  batchConfig.numPhysicsThreads = 2;
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {0.0f, 1.5f, 0.0f};
+  pinholeCameraSpec->resolution = {64, 96};
+  batchConfig.agentConfig.sensorSpecifications = {pinholeCameraSpec};
+
+  BatchedSimulator batch{batchConfig};
+  CORRADE_COMPARE(batch.getNumEnvironments(), 3);
+  // all environments share the same parsed dataset
+  CORRADE_COMPARE(batch.getEnvironment(1).getMetadataMediator(),
+                  batch.getMetadataMediator());
+
+  for (int i = 0; i < batch.getNumEnvironments(); ++i) {
+    batch.getAgent(i)->setInitialState(AgentState{});
+  }
+
+  const auto& observations = batch.stepAll({"moveForward", "turnLeft", ""});
+  CORRADE_COMPARE(observations.size(), 3);
+  const std::vector<size_t> expectedShape{64, 96, 4};
+  for (const auto& envObservations : observations) {
+    CORRADE_COMPARE(envObservations.size(), 1);
+    CORRADE_COMPARE(envObservations.at(pinholeCameraSpec->uuid).buffer->shape,
+                    expectedShape);
+  }
+
+  // each environment moved independently
+  auto movedState = AgentState::create();
+  auto turnedState = AgentState::create();
+  auto idleState = AgentState::create();
+  batch.getAgent(0)->getState(movedState);
+  batch.getAgent(1)->getState(turnedState);
+  batch.getAgent(2)->getState(idleState);
+  CORRADE_VERIFY(movedState->position != idleState->position);
+  CORRADE_COMPARE(turnedState->position, idleState->position);
+  CORRADE_VERIFY(turnedState->rotation != idleState->rotation);
+
+  // actions by ID do the same as by name, negative IDs skip
+  CORRADE_COMPARE(batch.getActionId("notAnAction"), esp::ID_UNDEFINED);
+  const int turnLeft = batch.getActionId("turnLeft");
+  CORRADE_COMPARE(turnLeft, batch.getAgent(2)->getActionId("turnLeft"));
+  batch.stepAll(std::vector<int>{-1, -1, turnLeft});
+  auto idleTurnedState = AgentState::create();
+  batch.getAgent(2)->getState(idleTurnedState);
+  CORRADE_COMPARE(idleTurnedState->position, idleState->position);
+  CORRADE_COMPARE(idleTurnedState->rotation, turnedState->rotation);
+  auto stillTurnedState = AgentState::create();
+  batch.getAgent(1)->getState(stillTurnedState);
+  CORRADE_COMPARE(stillTurnedState->rotation, turnedState->rotation);
+
+  // worlds are stepped on different threads, but all by the same amount
+  const double worldTime = batch.getEnvironment(0).getWorldTime();
+  batch.stepWorlds(0.5);
+  for (int i = 0; i < batch.getNumEnvironments(); ++i) {
+    CORRADE_COMPARE_AS(batch.getEnvironment(i).getWorldTime(),
+                       worldTime + 0.5, Cr::TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(batch.getEnvironment(i).getWorldTime(),
+                    batch.getEnvironment(0).getWorldTime());
+  }
+}  // SimTest::batchedSimulatorStepAll
+
+void SimTest::reuseContextFromPool() {
+  auto& pool = esp::gfx::WindowlessContextPool::instance();
+  auto simulator = getSimulator(*this, vangogh, true);
+  const int gpuDevice = simulator->gpuDevice();
+  const std::size_t idleCount = pool.idleContextCount(gpuDevice);
+
+  // the context goes back to the pool instead of being destroyed
+  simulator = nullptr;
+  CORRADE_COMPARE(pool.idleContextCount(gpuDevice), idleCount + 1);
+
+  // and the next simulator borrows it again
+  simulator = getSimulator(*this, vangogh, true);
+  CORRADE_COMPARE(pool.idleContextCount(gpuDevice), idleCount);
+  CORRADE_COMPARE(simulator->gpuDevice(), gpuDevice);
+  simulator->close(true);
+  CORRADE_COMPARE(pool.idleContextCount(gpuDevice), idleCount + 1);
+}  // SimTest::reuseContextFromPool
+
+void SimTest::bakeDatasetTwice() {
+  namespace Path = Cr::Utility::Path;
+  // the bake writes alongside the stage asset, so it bakes a copy of one
+  const std::string datasetDir =
+      Path::join(MAGNUMRENDERERTEST_OUTPUT_DIR, "SimTestBakeDataset");
+  const std::string stageDir = Path::join(datasetDir, "stages");
+  const std::string sceneDir = Path::join(datasetDir, "scenes");
+  CORRADE_VERIFY(Path::make(stageDir));
+  CORRADE_VERIFY(Path::make(sceneDir));
+  CORRADE_VERIFY(Path::copy(planeStage, Path::join(stageDir, "plane.glb")));
+  const std::string navmeshFile = Path::join(stageDir, "plane.navmesh");
+  for (const std::string& file : {navmeshFile, navmeshFile + ".stamp"}) {
+    if (Path::exists(file)) {
+      CORRADE_VERIFY(Path::remove(file));
+    }
+  }
+  CORRADE_VERIFY(Path::write(
+      Path::join(stageDir, "bake_stage.stage_config.json"),
+      Cr::Containers::StringView{"{\"render_asset\": \"plane.glb\"}"}));
+  CORRADE_VERIFY(Path::write(
+      Path::join(sceneDir, "bake_scene.scene_instance.json"),
+      Cr::Containers::StringView{
+          "{\"stage_instance\": {\"template_name\": \"bake_stage\"}}"}));
+  const std::string datasetFile =
+      Path::join(datasetDir, "bake.scene_dataset_config.json");
+  CORRADE_VERIFY(Path::write(
+      datasetFile,
+      Cr::Containers::StringView{
+          "{\"stages\": {\"paths\": {\".json\": [\"stages\"]}},\n"
+          " \"scene_instances\": {\"paths\": {\".json\": [\"scenes\"]}}}"}));
+
+  int bakeCount = 0;
+  const auto bakeScene = [&](const std::string& sceneName) {
+    ++bakeCount;
+    return esp::sim::bakeSceneInstance(datasetFile, sceneName);
+  };
+  esp::sim::DatasetBakeStats stats =
+      esp::sim::bakeDataset(datasetFile, 1, bakeScene);
+  CORRADE_COMPARE(stats.bakedCount, 1);
+  CORRADE_COMPARE(stats.upToDateCount, 0);
+  CORRADE_VERIFY(stats.failedScenes.empty());
+  CORRADE_COMPARE(bakeCount, 1);
+  CORRADE_VERIFY(Path::exists(navmeshFile + ".stamp"));
+
+  // the baked navmesh loads with its islands
+  PathFinder pathfinder;
+  CORRADE_VERIFY(pathfinder.loadNavMesh(navmeshFile));
+  CORRADE_VERIFY(pathfinder.numIslands() > 0);
+
+  // nothing changed, so a second run bakes nothing
+  stats = esp::sim::bakeDataset(datasetFile, 1, bakeScene);
+  CORRADE_COMPARE(stats.bakedCount, 0);
+  CORRADE_COMPARE(stats.upToDateCount, 1);
+  CORRADE_VERIFY(stats.failedScenes.empty());
+  CORRADE_COMPARE(bakeCount, 1);
+
+  // a missing artifact bakes the scene again
+  CORRADE_VERIFY(Path::remove(navmeshFile));
+  stats = esp::sim::bakeDataset(datasetFile, 1, bakeScene);
+  CORRADE_COMPARE(stats.bakedCount, 1);
+  CORRADE_COMPARE(stats.upToDateCount, 0);
+  CORRADE_COMPARE(bakeCount, 2);
+}  // SimTest::bakeDatasetTwice
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SimTest)
@@ -0,0 +1,452 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Json.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+
+#ifndef CORRADE_TARGET_WINDOWS
+#include <sys/resource.h>
+#endif
+
+#include "esp/agent/Agent.h"
+#include "esp/core/LatencyTracker.h"
+#include "esp/core/Logging.h"
+#include "esp/core/MemoryUsage.h"
+#include "esp/physics/objectManagers/ArticulatedObjectManager.h"
+#include "esp/sensor/CameraSensor.h"
+#include "esp/sim/BatchReplayRenderer.h"
+#include "esp/sim/Simulator.h"
+
+namespace {
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+using namespace Cr::Containers::Literals;
+using Clock = std::chrono::steady_clock;
+
+/* Everything measured for one configuration */
+struct Result {
+  std::string name;
+  /* Why the configuration didn't run, empty if it did */
+  std::string skipped;
+  std::size_t steps = 0;
+  /* Sensor images rendered, over all sensors and environments */
+  std::size_t frames = 0;
+  double seconds = 0.0;
+  std::map<std::string, esp::core::LatencyHistogram> stages;
+  std::map<std::string, esp::core::MemoryUsage> memory;
+  std::size_t peakRssBytes = 0;
+};
+
+/* Times f() into the histogram of given stage */
+template <class F>
+void timeStage(Result& result, const char* stage, F&& f) {
+  const Clock::time_point start = Clock::now();
+  f();
+  result.stages[stage].record(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                           start)
+          .count());
+}
+
+/* Largest resident set size of the process so far, 0 if unknown */
+std::size_t peakRssBytes() {
+#ifndef CORRADE_TARGET_WINDOWS
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef CORRADE_TARGET_APPLE
+  return std::size_t(usage.ru_maxrss);
+#else
+  return std::size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+std::shared_ptr<esp::sensor::CameraSensorSpec> cameraSpec(
+    const std::string& uuid,
+    esp::sensor::SensorType type,
+    const Mn::Vector2i& size) {
+  auto spec = esp::sensor::CameraSensorSpec::create();
+  spec->uuid = uuid;
+  spec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  spec->sensorType = type;
+  spec->position = {0.0f, 1.5f, 0.0f};
+  spec->resolution = {size.y(), size.x()};
+  if (type != esp::sensor::SensorType::Color)
+    spec->channels = 1;
+  return spec;
+}
+
+struct Options {
+  std::string scene;
+  std::string dataset;
+  std::string urdf;
+  std::string replay;
+  Mn::Vector2i size;
+  std::size_t steps;
+  std::size_t warmup;
+  int gpu;
+};
+
+/* Agent with the given sensors taking random navigation actions, optionally
+   with physics stepped and an articulated robot driven with random joint
+   velocities every step */
+Result runSimulator(const std::string& name,
+                    const Options& options,
+                    const std::vector<esp::sensor::SensorType>& sensorTypes,
+                    bool physics) {
+  Result result;
+  result.name = name;
+  if (options.scene.empty()) {
+    result.skipped = "no --scene given";
+    return result;
+  }
+  if (physics) {
+#ifndef ESP_BUILD_WITH_BULLET
+    result.skipped = "built without Bullet";
+    return result;
+#endif
+    if (options.urdf.empty()) {
+      result.skipped = "no --urdf given";
+      return result;
+    }
+  }
+
+  esp::sim::SimulatorConfiguration simConfig;
+  simConfig.activeSceneName = options.scene;
+  if (!options.dataset.empty())
+    simConfig.sceneDatasetConfigFile = options.dataset;
+  simConfig.enablePhysics = physics;
+  simConfig.gpuDeviceId = options.gpu;
+  simConfig.loadSemanticMesh =
+      std::find(sensorTypes.begin(), sensorTypes.end(),
+                esp::sensor::SensorType::Semantic) != sensorTypes.end();
+  auto simulator = esp::sim::Simulator::create_unique(simConfig);
+
+  esp::agent::AgentConfiguration agentConfig;
+  for (const esp::sensor::SensorType type : sensorTypes) {
+    std::ostringstream uuid;
+    uuid << "sensor" << agentConfig.sensorSpecifications.size();
+    agentConfig.sensorSpecifications.push_back(
+        cameraSpec(uuid.str(), type, options.size));
+  }
+  esp::agent::Agent::ptr agent = simulator->addAgent(agentConfig);
+
+  std::shared_ptr<esp::physics::ManagedArticulatedObject> robot;
+  if (physics) {
+    robot = simulator->getArticulatedObjectManager()
+                ->addArticulatedObjectFromURDF(options.urdf);
+    if (!robot) {
+      result.skipped = "can't load " + options.urdf;
+      return result;
+    }
+  }
+
+  // fixed seed, so builds being compared do the exact same work
+  std::mt19937 random{0};
+  const char* const actions[]{"moveForward", "turnLeft", "turnRight"};
+  std::uniform_int_distribution<int> actionDistribution{0, 2};
+  std::uniform_real_distribution<float> velocityDistribution{-1.0f, 1.0f};
+  const std::vector<int> agentIds{0};
+  std::map<int, std::map<std::string, esp::sensor::Observation>>
+      observations;
+  std::vector<float> velocities;
+
+  Clock::time_point start;
+  for (std::size_t step = 0; step != options.warmup + options.steps; ++step) {
+    if (step == options.warmup) {
+      result.stages.clear();
+      result.frames = 0;
+      start = Clock::now();
+    }
+    timeStage(result, "act",
+              [&] { agent->act(actions[actionDistribution(random)]); });
+    if (physics) {
+      timeStage(result, "physics", [&] {
+        velocities.resize(robot->getJointVelocities().size());
+        for (float& velocity : velocities)
+          velocity = velocityDistribution(random);
+        robot->setJointVelocities(velocities);
+        simulator->stepWorld();
+      });
+    }
+    timeStage(result, "observe", [&] {
+      result.frames += simulator->getAgentsObservations(agentIds, observations);
+    });
+  }
+  result.seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  result.steps = options.steps;
+  result.memory = simulator->getMemoryUsage();
+  result.peakRssBytes = peakRssBytes();
+  return result;
+}
+
+/* Keyframes of a gfx-replay file, pointing into json */
+Cr::Containers::Array<Cr::Containers::StringView> loadKeyframes(
+    const std::string& filename,
+    Cr::Containers::Optional<Cr::Utility::Json>& json) {
+  Cr::Containers::Optional<Cr::Utility::JsonObjectView> root;
+  const Cr::Utility::JsonToken* jsonKeyframes;
+  if (!(json = Cr::Utility::Json::fromFile(filename)) ||
+      !(root = json->parseObject(json->root())) ||
+      !(jsonKeyframes = (*root).find("keyframes")) ||
+      !json->parseArray(*jsonKeyframes))
+    return {};
+
+  Cr::Containers::Array<Cr::Containers::StringView> keyframes;
+  for (const Cr::Utility::JsonToken& keyframe : jsonKeyframes->asArray())
+    arrayAppend(keyframes, keyframe.data());
+  return keyframes;
+}
+
+/* The same replay in each of tileCount batch renderer environments, with
+   the next frame submitted before the previous one is read back, same as
+   the headless replayer does */
+Result runBatchReplay(const Options& options, std::size_t tileCount) {
+  Result result;
+  result.name = Cr::Utility::formatString("batch_replay_{}", tileCount);
+  if (options.replay.empty()) {
+    result.skipped = "no --replay given";
+    return result;
+  }
+  Cr::Containers::Optional<Cr::Utility::Json> json;
+  const Cr::Containers::Array<Cr::Containers::StringView> keyframes =
+      loadKeyframes(options.replay, json);
+  if (keyframes.isEmpty()) {
+    result.skipped = "no keyframes in " + options.replay;
+    return result;
+  }
+
+  esp::sim::ReplayRendererConfiguration rendererConfig;
+  rendererConfig.sensorSpecifications = {
+      cameraSpec("rgb", esp::sensor::SensorType::Color, options.size)};
+  rendererConfig.numEnvironments = int(tileCount);
+  rendererConfig.gpuDeviceId = options.gpu;
+  esp::sim::BatchReplayRenderer renderer{rendererConfig};
+  const Mn::Vector3 eye{-1.5f, 1.75f, -0.5f};
+  for (std::size_t i = 0; i != tileCount; ++i)
+    renderer.setSensorTransform(
+        i, "rgb",
+        Mn::Matrix4::lookAt(eye, eye + Mn::Vector3{2.0f, -0.5f, 1.0f},
+                            Mn::Vector3::yAxis()));
+
+  Cr::Containers::Array<char> pixels{
+      Cr::NoInit, tileCount * std::size_t(options.size.product()) * 4};
+  Cr::Containers::Array<Mn::MutableImageView2D> views;
+  for (std::size_t i = 0; i != tileCount; ++i)
+    arrayAppend(views, Cr::InPlaceInit, Mn::PixelFormat::RGBA8Unorm,
+                options.size,
+                pixels.sliceSize(i * std::size_t(options.size.product()) * 4,
+                                 std::size_t(options.size.product()) * 4));
+
+  Clock::time_point start;
+  const std::size_t stepCount = options.warmup + options.steps;
+  for (std::size_t step = 0; step != stepCount + 1; ++step) {
+    if (step == options.warmup) {
+      result.stages.clear();
+      start = Clock::now();
+    }
+    if (step < stepCount) {
+      timeStage(result, "set_keyframes", [&] {
+        for (std::size_t i = 0; i != tileCount; ++i)
+          renderer.setEnvironmentKeyframeUnwrapped(
+              i, keyframes[step % keyframes.size()]);
+      });
+      timeStage(result, "submit", [&] { renderer.renderAsync(); });
+    }
+    if (renderer.framesInFlight() == 2 ||
+        (step == stepCount && renderer.framesInFlight()))
+      timeStage(result, "readback", [&] { renderer.waitFrame(views, {}); });
+  }
+  result.seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  result.steps = options.steps;
+  result.frames = options.steps * tileCount;
+  result.peakRssBytes = peakRssBytes();
+  return result;
+}
+
+std::string toJson(const std::vector<Result>& results) {
+  std::string out = "{\"results\":[";
+  for (std::size_t i = 0; i != results.size(); ++i) {
+    const Result& result = results[i];
+    out += Cr::Utility::formatString("{}\n{{\"name\":\"{}\"", i ? "," : "",
+                                     result.name);
+    if (!result.skipped.empty()) {
+      out += Cr::Utility::formatString(",\"skipped\":\"{}\"}}",
+                                       result.skipped);
+      continue;
+    }
+    const double seconds = Mn::Math::max(result.seconds, 1.0e-9);
+    out += Cr::Utility::formatString(
+        ",\"steps\":{},\"seconds\":{:.4f},\"steps_per_sec\":{:.2f},"
+        "\"frames_per_sec\":{:.2f},\"peak_rss_bytes\":{},\"stages\":{{",
+        result.steps, result.seconds, result.steps / seconds,
+        result.frames / seconds, result.peakRssBytes);
+    bool first = true;
+    for (const auto& stage : result.stages) {
+      const esp::core::LatencyHistogram& histogram = stage.second;
+      out += Cr::Utility::formatString(
+          "{}\"{}\":{{\"total_ms\":{:.3f},\"mean_ms\":{:.4f},"
+          "\"p50_ms\":{:.4f},\"p99_ms\":{:.4f},\"max_ms\":{:.4f}}}",
+          first ? "" : ",", stage.first,
+          histogram.mean() * histogram.count() * 1.0e-6,
+          histogram.mean() * 1.0e-6,
+          histogram.valueAtPercentile(50.0) * 1.0e-6,
+          histogram.valueAtPercentile(99.0) * 1.0e-6, histogram.max() * 1.0e-6);
+      first = false;
+    }
+    out += "},\"memory\":{";
+    first = true;
+    for (const auto& memory : result.memory) {
+      out += Cr::Utility::formatString(
+          "{}\"{}\":{{\"cpu_bytes\":{},\"gpu_bytes\":{}}}", first ? "" : ",",
+          memory.first, memory.second.cpuBytes, memory.second.gpuBytes);
+      first = false;
+    }
+    out += "}}";
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  esp::logging::LoggingContext loggingContext;
+
+  Cr::Utility::Arguments args;
+  args.addOption("scene")
+      .setHelp("scene", "scene to navigate in the simulator configurations")
+      .addOption("dataset")
+      .setHelp("dataset", "scene dataset config the scene is part of")
+      .addOption("urdf")
+      .setHelp("urdf", "robot for the rearrangement configuration, such as "
+                       "Fetch or Spot")
+      .addOption("replay")
+      .setHelp("replay", "gfx-replay JSON file for the batch configurations")
+      .addOption("tile-counts", "1 4 16 64")
+      .setHelp("tile-counts", "batch renderer environment counts to run")
+      .addOption("configs")
+      .setHelp("configs",
+               "comma-separated configurations to run, all if empty")
+      .addOption("size", "256 256")
+      .setHelp("size", "sensor resolution", "\"X Y\"")
+      .addOption("steps", "1000")
+      .setHelp("steps", "measured steps per configuration")
+      .addOption("warmup", "50")
+      .setHelp("warmup", "steps run before measuring")
+      .addOption("gpu", "0")
+      .setHelp("gpu", "GPU device to render on")
+      .addOption('o', "output")
+      .setHelp("output", "file to write the JSON results to instead of "
+                         "the standard output")
+      .setGlobalHelp(R"(
+Measures end-to-end throughput of a fixed set of configurations, to compare
+builds, GPUs and drivers:
+
+-   pointnav_rgbd: an agent with RGB and depth sensors taking random
+    navigation actions in --scene
+-   objectnav_semantic: same, with a semantic sensor in addition
+-   rearrange_physics: same as pointnav_rgbd, with physics stepped every step
+    and the --urdf robot driven with random joint velocities
+-   batch_replay_<N>: the --replay file rendered in N batch renderer
+    environments at once, for each of --tile-counts
+
+Configurations whose assets weren't passed are reported as skipped. Random
+actions use a fixed seed, so every run does the same work. The results are
+written as JSON with steps and sensor frames per second, the time spent in
+each stage of a step, the memory reported by the simulator subsystems and the
+peak resident set size of the process so far.
+)"_s.trimmed())
+      .parse(argc, argv);
+
+  Options options;
+  options.scene = args.value("scene");
+  options.dataset = args.value("dataset");
+  options.urdf = args.value("urdf");
+  options.replay = args.value("replay");
+  options.size = args.value<Mn::Vector2i>("size");
+  options.steps = args.value<std::size_t>("steps");
+  options.warmup = args.value<std::size_t>("warmup");
+  options.gpu = args.value<int>("gpu");
+
+  // keep the standard output clean for the results
+  const std::string output = args.value("output");
+  Cr::Containers::Optional<Mn::Debug> redirectDebug;
+  if (output.empty())
+    redirectDebug.emplace(&std::cerr);
+
+  const std::vector<std::string> selected =
+      Cr::Utility::String::splitWithoutEmptyParts(args.value("configs"), ',');
+  const auto isSelected = [&](const std::string& name) {
+    return selected.empty() ||
+           std::find(selected.begin(), selected.end(), name) != selected.end();
+  };
+
+  using esp::sensor::SensorType;
+  std::vector<Result> results;
+  const auto run = [&](const std::string& name, const auto& runner) {
+    if (!isSelected(name))
+      return;
+    Mn::Debug{} << "Running" << name;
+    results.push_back(runner());
+    if (!results.back().skipped.empty())
+      Mn::Warning{} << "Skipping" << name << Mn::Debug::nospace << ":"
+                    << results.back().skipped;
+  };
+  run("pointnav_rgbd", [&] {
+    return runSimulator("pointnav_rgbd", options,
+                        {SensorType::Color, SensorType::Depth}, false);
+  });
+  run("objectnav_semantic", [&] {
+    return runSimulator(
+        "objectnav_semantic", options,
+        {SensorType::Color, SensorType::Depth, SensorType::Semantic}, false);
+  });
+  run("rearrange_physics", [&] {
+    return runSimulator("rearrange_physics", options,
+                        {SensorType::Color, SensorType::Depth}, true);
+  });
+  for (const std::string& tileCount :
+       Cr::Utility::String::splitWithoutEmptyParts(args.value("tile-counts"))) {
+    const std::size_t count =
+        Mn::Math::max(std::size_t(std::stoul(tileCount)), std::size_t{1});
+    run(Cr::Utility::formatString("batch_replay_{}", count),
+        [&] { return runBatchReplay(options, count); });
+  }
+
+  const std::string json = toJson(results);
+  if (output.empty()) {
+    std::fputs(json.data(), stdout);
+  } else if (!Cr::Utility::Path::write(
+                 output, Cr::Containers::arrayView(json.data(), json.size()))) {
+    Mn::Error{} << "Can't write" << output;
+    return 1;
+  }
+  return 0;
+}
@@ -2,19 +2,29 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
+#include <Corrade/Utility/FormatStl.h>
+
 #include "SceneLoader.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
 #include "Mp3dInstanceMeshData.h"
+#include "esp/assets/ResourceManager.h"
 #include "esp/core/Esp.h"
+#include "esp/metadata/MetadataMediator.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/scene/SemanticScene.h"
+#include "esp/sim/DatasetBake.h"
+#include "esp/sim/SimulatorConfiguration.h"
+
+namespace Cr = Corrade;
 
 using esp::assets::AssetInfo;
 using esp::assets::MeshData;
@@ -23,6 +33,7 @@ using esp::assets::SceneLoader;
 using esp::nav::NavMeshSettings;
 using esp::nav::PathFinder;
 using esp::scene::SemanticScene;
+using esp::sim::SimulatorConfiguration;
 
 int createNavMesh(const std::string& meshFile, const std::string& navmeshFile) {
   SceneLoader loader;
@@ -154,13 +165,90 @@ int createMp3dSemanticMesh(const std::string& plyFile,
   return 0;
 }
 
+int bakeStageBundle(const std::string& assetFile,
+                    const std::string& bundleFile) {
+  // only the geometry is baked, so neither a GPU nor textures are needed
+  SimulatorConfiguration cfg;
+  cfg.createRenderer = false;
+  cfg.requiresTextures = false;
+  cfg.optimizeMeshes = true;
+  esp::assets::ResourceManager resourceManager{
+      esp::metadata::MetadataMediator::create(cfg)};
+  resourceManager.setRequiresTextures(false);
+  if (!resourceManager.bakeStageBundle(assetFile, bundleFile)) {
+    ESP_ERROR() << "Failed baking stage bundle for" << assetFile;
+    return 1;
+  }
+  return 0;
+}
+
+namespace {
+
+std::string shellQuote(const std::string& arg) {
+  std::string quoted = "'";
+  for (const char c : arg) {
+    quoted += c == '\'' ? std::string{"'\\''"} : std::string(1, c);
+  }
+  return quoted + "'";
+}
+
+}  // namespace
+
+/**
+ * @brief Bake all scene instances of @p datasetFile on @p numWorkers
+ * processes
+ *
+ * Each scene whose inputs changed since the last bake is baked by
+ * @ref esp::sim::bakeSceneInstance() in a child process of @p datatool, so a
+ * crash in one scene doesn't end the whole bake.
+ */
+int bakeDataset(const std::string& datatool,
+                const std::string& datasetFile,
+                unsigned numWorkers) {
+  const auto bakeScene = [&](const std::string& sceneName) {
+    const std::string command = Cr::Utility::formatString(
+        "{} bake_scene {} {}", shellQuote(datatool), shellQuote(datasetFile),
+        shellQuote(sceneName));
+    return std::system(command.c_str()) == 0;
+  };
+  const esp::sim::DatasetBakeStats stats =
+      esp::sim::bakeDataset(datasetFile, numWorkers, bakeScene);
+
+  ESP_DEBUG() << "Baked" << stats.bakedCount << "scenes,"
+              << stats.upToDateCount << "were up to date.";
+  for (const std::string& sceneName : stats.failedScenes) {
+    ESP_ERROR() << "Failed baking scene" << sceneName;
+  }
+  // a dataset without scene instances fails too
+  if (!stats.failedScenes.empty() ||
+      stats.bakedCount + stats.upToDateCount == 0) {
+    return 1;
+  }
+  return 0;
+}
+
 int main(int argc, char** argv) {
-  if (argc < 4) {
+  if (argc < 3) {
     std::cout << "Usage: Datatool task input_file output_file" << std::endl;
     return 64;
   }
   const std::string task = argv[1];
-  if (task == "create_navmesh") {
+  if (task == "bake_dataset") {
+    // the workers default to one per core
+    const unsigned numWorkers =
+        argc < 4 ? std::thread::hardware_concurrency()
+                 : unsigned(std::strtoul(argv[3], nullptr, 10));
+    if (bakeDataset(argv[0], argv[2], numWorkers) != 0) {
+      return 1;
+    }
+  } else if (argc < 4) {
+    std::cout << "Usage: Datatool task input_file output_file" << std::endl;
+    return 64;
+  } else if (task == "bake_scene") {
+    if (!esp::sim::bakeSceneInstance(argv[2], argv[3])) {
+      return 1;
+    }
+  } else if (task == "create_navmesh") {
     createNavMesh(argv[2], argv[3]);
   } else if (task == "create_mp3d_semantic_mesh") {
     if (argc < 5) {
@@ -178,6 +266,13 @@ int main(int argc, char** argv) {
       return 64;
     }
     createGibsonSemanticMesh(argv[2], argv[3], argv[4]);
+  } else if (task == "bake_stage_bundle") {
+    // "-" saves the bundle alongside the asset, where stage loads find it
+    const std::string bundleFile =
+        std::string{argv[3]} == "-" ? std::string{} : argv[3];
+    if (bakeStageBundle(argv[2], bundleFile) != 0) {
+      return 1;
+    }
   } else {
     ESP_ERROR() << "Unrecognized task" << task;
     return 1;
@@ -0,0 +1,435 @@
+// Copyright (c) Meta Platforms, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Json.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "esp/core/Logging.h"
+#include "esp/sensor/CameraSensor.h"
+#include "esp/sim/BatchReplayRenderer.h"
+
+namespace {
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+using namespace Cr::Containers::Literals;
+
+/* Where frames of one replay file end up. Either a numbered image sequence
+   written through AnyImageConverter or raw RGBA frames piped to an ffmpeg
+   process. Only ever used from a single encoder thread. */
+class Sink {
+ public:
+  explicit Sink(std::string path, bool video, Mn::Vector2i size, int fps)
+      : path_{std::move(path)}, video_{video}, size_{size}, fps_{fps} {}
+
+  ~Sink() { finish(); }
+
+  bool write(Mn::Trade::AbstractImageConverter& converter,
+             const std::size_t frame,
+             const Mn::ImageView2D& image) {
+    if (failed_)
+      return false;
+
+    if (video_) {
+      if (!pipe_ && !openPipe())
+        return fail();
+      if (std::fwrite(image.data().data(), image.data().size(), 1, pipe_) != 1)
+        return fail();
+      return true;
+    }
+
+    if (frame == 0 && !Cr::Utility::Path::make(path_))
+      return fail();
+    const std::string filename = Cr::Utility::Path::join(
+        path_, Cr::Utility::format("{:.5}.{}", frame, extension_));
+    if (!converter.convertToFile(image, filename))
+      return fail();
+    return true;
+  }
+
+  void finish() {
+    if (pipe_) {
+      if (pclose(pipe_) != 0)
+        fail();
+      pipe_ = nullptr;
+    }
+  }
+
+  void setExtension(std::string extension) {
+    extension_ = std::move(extension);
+  }
+
+  bool failed() const { return failed_; }
+
+  const std::string& path() const { return path_; }
+
+ private:
+  bool openPipe() {
+    /* Magnum images are bottom-up, flip them back. The path is quoted for
+       the shell, with single quotes inside escaped. */
+    std::string quotedPath = "'";
+    for (const char c : path_) {
+      if (c == '\'')
+        quotedPath += "'\\''";
+      else
+        quotedPath += c;
+    }
+    quotedPath += "'";
+    const std::string command = Cr::Utility::format(
+        "ffmpeg -y -loglevel error -f rawvideo -pix_fmt rgba -s {}x{} -r {} "
+        "-i - -vf vflip -pix_fmt yuv420p {}",
+        size_.x(), size_.y(), fps_, quotedPath);
+    pipe_ = popen(command.data(), "w");
+    return pipe_;
+  }
+
+  bool fail() {
+    if (!failed_)
+      Mn::Error{} << "Writing" << path_ << "failed";
+    failed_ = true;
+    return false;
+  }
+
+  std::string path_;
+  std::string extension_ = "png";
+  bool video_;
+  Mn::Vector2i size_;
+  int fps_;
+  std::FILE* pipe_ = nullptr;
+  bool failed_ = false;
+};
+
+/* One encoder thread with a bounded queue, so rendering blocks instead of
+   piling up frames if encoding can't keep up. A sink is always assigned to
+   the same encoder, which keeps its frames in order. */
+class Encoder {
+ public:
+  explicit Encoder(
+      Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter,
+      std::size_t maxQueueSize)
+      : converter_{std::move(converter)},
+        maxQueueSize_{maxQueueSize},
+        thread_{[this]() { run(); }} {}
+
+  ~Encoder() {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      done_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+  }
+
+  // An empty pixel array means the sink should be finished
+  void push(Sink& sink,
+            std::size_t frame,
+            Mn::Vector2i size,
+            Cr::Containers::Array<char>&& pixels) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    condition_.wait(lock, [&]() { return queue_.size() < maxQueueSize_; });
+    queue_.push_back(Task{&sink, frame, size, std::move(pixels)});
+    condition_.notify_all();
+  }
+
+  // Waits until everything pushed so far is processed
+  void wait() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    condition_.wait(lock, [&]() { return queue_.empty() && !busy_; });
+  }
+
+ private:
+  struct Task {
+    Sink* sink;
+    std::size_t frame;
+    Mn::Vector2i size;
+    Cr::Containers::Array<char> pixels;
+  };
+
+  void run() {
+    for (;;) {
+      Task task;
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        condition_.wait(lock, [&]() { return done_ || !queue_.empty(); });
+        if (queue_.empty())
+          return;
+        task = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+      }
+      condition_.notify_all();
+
+      if (task.pixels.isEmpty())
+        task.sink->finish();
+      else
+        task.sink->write(*converter_, task.frame,
+                         Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                                         task.size, task.pixels});
+
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        busy_ = false;
+      }
+      condition_.notify_all();
+    }
+  }
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter_;
+  std::size_t maxQueueSize_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Task> queue_;
+  bool busy_ = false;
+  bool done_ = false;
+  std::thread thread_;
+};
+
+/* Tokenizes a gfx-replay JSON file and returns views on the individual
+   keyframes, same as the interactive replayer does */
+Cr::Containers::Array<Cr::Containers::StringView> loadKeyframes(
+    const Cr::Containers::StringView filename,
+    Cr::Containers::Optional<Cr::Utility::Json>& json) {
+  Cr::Containers::Optional<Cr::Utility::JsonObjectView> root;
+  if (!(json = Cr::Utility::Json::fromFile(filename)) ||
+      !(root = json->parseObject(json->root()))) {
+    Mn::Error{} << "Can't parse" << filename;
+    return {};
+  }
+  const Cr::Utility::JsonToken* jsonKeyframes;
+  if (!(jsonKeyframes = (*root).find("keyframes")) ||
+      !json->parseArray(*jsonKeyframes)) {
+    Mn::Error{} << "No keyframes array in" << filename;
+    return {};
+  }
+
+  Cr::Containers::Array<Cr::Containers::StringView> keyframes;
+  for (const Cr::Utility::JsonToken& keyframe : jsonKeyframes->asArray())
+    arrayAppend(keyframes, keyframe.data());
+  return keyframes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  esp::logging::LoggingContext loggingContext;
+
+  Cr::Utility::Arguments args;
+  args.addArrayArgument("json")
+      .setHelp("json", "gfx-replay JSON file(s) to render")
+      .addOption('o', "output", ".")
+      .setHelp("output", "output directory")
+      .addArrayOption('P', "preload")
+      .setHelp("preload", "composite file(s) to preload", "file.glb")
+      .addOption("size", "512 384")
+      .setHelp("size", "output image size", "\"X Y\"")
+      .addOption("environments", "16")
+      .setHelp("environments", "how many files to render at once")
+      .addOption("max-light-count", "0")
+      .setHelp("max-light-count", "max light count used per scene")
+      .addOption("gpu", "0")
+      .setHelp("gpu", "GPU device to render on")
+      .addOption("sensor-prefix")
+      .setHelp("sensor-prefix",
+               "take the camera from user transform <prefix>rgb in each "
+               "keyframe instead of using a fixed camera",
+               "prefix")
+      .addBooleanOption("video")
+      .setHelp("video", "encode an MP4 video per file with ffmpeg")
+      .addOption("fps", "30")
+      .setHelp("fps", "video frame rate")
+      .addOption("format", "png")
+      .setHelp("format", "image file extension, if not encoding a video")
+      .addOption('j', "jobs", "0")
+      .setHelp("jobs", "encoder thread count, 0 for one per CPU core")
+      .setGlobalHelp(R"(
+Renders one or more gfx-replay JSON files without a window using the batch
+renderer, writing each to an image sequence or a video.
+
+Files are rendered --environments at a time, each in its own environment of
+the batch renderer. Every frame is read back while the next one renders, and
+handed over to encoder threads, so encoding of all files overlaps with
+rendering. With --video, frames are piped to an `ffmpeg` executable that has
+to be in PATH and each file produces <output>/<name>.mp4. Otherwise each file
+produces an <output>/<name>/ directory with one image per keyframe, in a
+format given by --format.
+
+Composite files passed via -P / --preload are used instead of loading
+individual meshes where possible, same as in the interactive replayer.
+)"_s.trimmed())
+      .parse(argc, argv);
+
+  const std::size_t fileCount = args.arrayValueCount("json");
+  const std::size_t environmentCount = Mn::Math::min(
+      fileCount,
+      std::size_t(Mn::Math::max(args.value<Mn::UnsignedInt>("environments"),
+                                1u)));
+  const Mn::Vector2i size = args.value<Mn::Vector2i>("size");
+  const std::string output = args.value("output");
+  const bool video = args.isSet("video");
+  const std::string sensorPrefix = args.value("sensor-prefix");
+  if (!fileCount)
+    Mn::Fatal{} << "No files to render";
+  if (!Cr::Utility::Path::make(output))
+    Mn::Fatal{} << "Can't create output directory" << output;
+
+  const std::string sensorName = "rgb";
+  esp::sim::ReplayRendererConfiguration rendererConfig;
+  {
+    auto pinholeCameraSpec = esp::sensor::CameraSensorSpec::create();
+    pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+    pinholeCameraSpec->sensorType = esp::sensor::SensorType::Color;
+    pinholeCameraSpec->position = {0.0f, 0.f, 0.0f};
+    pinholeCameraSpec->resolution = {size.flipped()};
+    pinholeCameraSpec->uuid = sensorName;
+    rendererConfig.sensorSpecifications = {pinholeCameraSpec};
+  }
+  rendererConfig.numEnvironments = environmentCount;
+  rendererConfig.gpuDeviceId = args.value<int>("gpu");
+  esp::gfx_batch::RendererConfiguration batchRendererConfig;
+  batchRendererConfig.setMaxLightCount(
+      args.value<Mn::UnsignedInt>("max-light-count"));
+  esp::sim::BatchReplayRenderer replayRenderer{rendererConfig,
+                                               std::move(batchRendererConfig)};
+  for (std::size_t i = 0, iMax = args.arrayValueCount("preload"); i != iMax;
+       ++i)
+    replayRenderer.preloadFile(args.arrayValue("preload", i));
+
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  std::size_t jobCount = args.value<Mn::UnsignedInt>("jobs");
+  if (!jobCount)
+    jobCount = Mn::Math::max(std::thread::hardware_concurrency(), 1u);
+  jobCount = Mn::Math::min(jobCount, environmentCount);
+  Cr::Containers::Array<Cr::Containers::Pointer<Encoder>> encoders;
+  for (std::size_t i = 0; i != jobCount; ++i) {
+    Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter> converter =
+        manager.loadAndInstantiate("AnyImageConverter");
+    if (!converter)
+      Mn::Fatal{} << "Can't load an image converter";
+    // two frames of each environment it encodes, the rest waits in the GPU
+    arrayAppend(encoders, Cr::InPlaceInit,
+                new Encoder{std::move(converter),
+                            2 * (environmentCount / jobCount + 1)});
+  }
+
+  const std::size_t pixelCount = std::size_t(size.product()) * 4;
+  bool failed = false;
+  for (std::size_t batch = 0; batch < fileCount; batch += environmentCount) {
+    const std::size_t batchSize =
+        Mn::Math::min(environmentCount, fileCount - batch);
+
+    /* Keep the Json instances around, the keyframe views point into them */
+    Cr::Containers::Array<Cr::Containers::Optional<Cr::Utility::Json>> jsons{
+        Cr::ValueInit, batchSize};
+    Cr::Containers::Array<Cr::Containers::Array<Cr::Containers::StringView>>
+        keyframes{Cr::ValueInit, batchSize};
+    Cr::Containers::Array<Cr::Containers::Pointer<Sink>> sinks{Cr::ValueInit,
+                                                              batchSize};
+    std::size_t frameCount = 0;
+    for (std::size_t i = 0; i != batchSize; ++i) {
+      const std::string filename = args.arrayValue("json", batch + i);
+      keyframes[i] = loadKeyframes(filename, jsons[i]);
+      if (keyframes[i].isEmpty()) {
+        failed = true;
+        continue;
+      }
+      const std::string name =
+          Cr::Utility::Path::splitExtension(
+              Cr::Utility::Path::split(filename).second())
+              .first();
+      sinks[i].emplace(
+          Cr::Utility::Path::join(output, video ? name + ".mp4" : name), video,
+          size, args.value<int>("fps"));
+      sinks[i]->setExtension(args.value("format"));
+      frameCount = Mn::Math::max(frameCount, keyframes[i].size());
+    }
+    Mn::Debug{} << "Rendering" << frameCount << "frames from files"
+                << batch + 1 << "to" << batch + batchSize << "of"
+                << fileCount;
+
+    for (std::size_t i = 0; i != environmentCount; ++i)
+      replayRenderer.clearEnvironment(i);
+
+    /* Submit frame N + 1 before reading back frame N, so the CPU readback,
+       the keyframe parsing of the next frame and the encoding all overlap
+       with the GPU */
+    std::size_t readFrame = 0;
+    for (std::size_t frame = 0; frame != frameCount + 1; ++frame) {
+      if (frame < frameCount) {
+        for (std::size_t i = 0; i != batchSize; ++i) {
+          if (frame >= keyframes[i].size())
+            continue;
+          replayRenderer.setEnvironmentKeyframeUnwrapped(i,
+                                                         keyframes[i][frame]);
+          if (!sensorPrefix.empty()) {
+            replayRenderer.setSensorTransformsFromKeyframe(i, sensorPrefix);
+          } else if (frame == 0) {
+            const auto eyePos = Mn::Vector3(-1.5f, 1.75f, -0.5f);
+            replayRenderer.setSensorTransform(
+                i, sensorName,
+                Mn::Matrix4::lookAt(eyePos,
+                                    eyePos + Mn::Vector3(2.f, -0.5f, 1.f),
+                                    {0.f, 1.f, 0.f}));
+          }
+        }
+        replayRenderer.renderAsync();
+      }
+
+      if (replayRenderer.framesInFlight() == 2 ||
+          (frame == frameCount && replayRenderer.framesInFlight())) {
+        Cr::Containers::Array<Cr::Containers::Array<char>> pixels{
+            Cr::ValueInit, environmentCount};
+        Cr::Containers::Array<Mn::MutableImageView2D> views;
+        for (std::size_t i = 0; i != environmentCount; ++i) {
+          pixels[i] = Cr::Containers::Array<char>{Cr::NoInit, pixelCount};
+          arrayAppend(views, Cr::InPlaceInit, Mn::PixelFormat::RGBA8Unorm,
+                      size, pixels[i]);
+        }
+        replayRenderer.waitFrame(views, {});
+        for (std::size_t i = 0; i != batchSize; ++i) {
+          if (sinks[i] && readFrame < keyframes[i].size())
+            encoders[i % jobCount]->push(*sinks[i], readFrame, size,
+                                         std::move(pixels[i]));
+        }
+        ++readFrame;
+      }
+    }
+    CORRADE_INTERNAL_ASSERT(!replayRenderer.framesInFlight());
+
+    for (std::size_t i = 0; i != batchSize; ++i) {
+      if (sinks[i])
+        encoders[i % jobCount]->push(*sinks[i], 0, size, {});
+    }
+    for (Cr::Containers::Pointer<Encoder>& encoder : encoders)
+      encoder->wait();
+    for (std::size_t i = 0; i != batchSize; ++i) {
+      if (!sinks[i])
+        continue;
+      if (sinks[i]->failed())
+        failed = true;
+      else
+        Mn::Debug{} << "Wrote" << sinks[i]->path();
+    }
+  }
+
+  return failed ? 1 : 0;
+}
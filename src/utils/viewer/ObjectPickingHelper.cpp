@@ -3,8 +3,10 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "ObjectPickingHelper.h"
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
@@ -55,12 +57,6 @@ ObjectPickingHelper& ObjectPickingHelper::prepareToDraw() {
       selectionFramebuffer_.checkStatus(Mn::GL::FramebufferTarget::Draw) ==
       Mn::GL::Framebuffer::Status::Complete);
 
-  // remove any visualized object that is picked before
-  if (meshVisualizerDrawable_) {
-    delete meshVisualizerDrawable_;
-    meshVisualizerDrawable_ = nullptr;
-  }
-
   return *this;
 }
 
@@ -81,7 +77,7 @@ ObjectPickingHelper& ObjectPickingHelper::handleViewportChange(
   return *this;
 }
 
-unsigned int ObjectPickingHelper::getObjectId(
+Mn::Range2Di ObjectPickingHelper::objectIdArea(
     const Mn::Vector2i& mouseEventPosition,
     const Mn::Vector2i& windowSize) {
   selectionFramebuffer_.mapForRead(Mn::GL::Framebuffer::ColorAttachment{1});
@@ -100,7 +96,13 @@ unsigned int ObjectPickingHelper::getObjectId(
   const Mn::Vector2i fbPosition{
       position.x(),
       selectionFramebuffer_.viewport().sizeY() - position.y() - 1};
-  const Mn::Range2Di area = Mn::Range2Di::fromSize(fbPosition, Mn::Vector2i{1});
+  return Mn::Range2Di::fromSize(fbPosition, Mn::Vector2i{1});
+}
+
+unsigned int ObjectPickingHelper::getObjectId(
+    const Mn::Vector2i& mouseEventPosition,
+    const Mn::Vector2i& windowSize) {
+  const Mn::Range2Di area = objectIdArea(mouseEventPosition, windowSize);
 
   const Mn::UnsignedInt pickedObject =
       selectionFramebuffer_.read(area, {Mn::PixelFormat::R32UI})
@@ -109,6 +111,33 @@ unsigned int ObjectPickingHelper::getObjectId(
   return pickedObject;
 }
 
+void ObjectPickingHelper::requestObjectId(
+    const Mn::Vector2i& mouseEventPosition,
+    const Mn::Vector2i& windowSize) {
+#ifndef MAGNUM_TARGET_GLES
+  // the copy is queued after the drawing, so this doesn't wait on the GPU
+  selectionFramebuffer_.read(objectIdArea(mouseEventPosition, windowSize),
+                             objectIdPixel_, Mn::GL::BufferUsage::StreamRead);
+#else
+  requestedObjectId_ = getObjectId(mouseEventPosition, windowSize);
+#endif
+  objectIdRequested_ = true;
+}
+
+Cr::Containers::Optional<unsigned int> ObjectPickingHelper::resolveObjectId() {
+  if (!objectIdRequested_) {
+    return Cr::Containers::NullOpt;
+  }
+  objectIdRequested_ = false;
+#ifndef MAGNUM_TARGET_GLES
+  const Cr::Containers::Array<char> data = objectIdPixel_.buffer().data();
+  CORRADE_INTERNAL_ASSERT(data.size() >= sizeof(Mn::UnsignedInt));
+  return *reinterpret_cast<const Mn::UnsignedInt*>(data.data());
+#else
+  return requestedObjectId_;
+#endif
+}
+
 void ObjectPickingHelper::createPickedObjectVisualizer(
     esp::gfx::Drawable* pickedObject) {
   if (meshVisualizerDrawable_) {
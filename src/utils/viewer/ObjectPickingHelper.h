@@ -5,9 +5,12 @@
 #ifndef ESP_UTILS_VIEWER_OBJECTPICKINGHELPER_H_
 #define ESP_UTILS_VIEWER_OBJECTPICKINGHELPER_H_
 
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/PixelFormat.h>
 #include <memory>
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/MeshVisualizerDrawable.h"
@@ -30,7 +33,8 @@ class ObjectPickingHelper {
 
   /**
    *@brief Prepare to draw: it will bind the framebuffer, map color attachement,
-   *clear depth, background color
+   *clear depth, background color. The visualizer of a previously picked object
+   *is kept until @ref createPickedObjectVisualizer() replaces it.
    */
   ObjectPickingHelper& prepareToDraw();
 
@@ -46,6 +50,32 @@ class ObjectPickingHelper {
   unsigned int getObjectId(const Magnum::Vector2i& mouseEventPosition,
                            const Magnum::Vector2i& windowSize);
 
+  /**
+   * @brief Start reading the object id at the mouse event position without
+   * waiting for the GPU to finish drawing
+   * @param eventPosition, mouse event position
+   * @param windowSize, the size of the GUI window
+   *
+   * Only the queried pixel is copied, into a pixel buffer. Call
+   * @ref resolveObjectId() a frame later to get the id, by when the copy is
+   * usually done. A request that wasn't resolved yet is replaced. On WebGL,
+   * where pixel buffers can't be read back, the pixel is read immediately.
+   */
+  void requestObjectId(const Magnum::Vector2i& mouseEventPosition,
+                       const Magnum::Vector2i& windowSize);
+
+  /**
+   * @brief return true if an object id was requested with
+   * @ref requestObjectId() and not resolved yet
+   */
+  bool isObjectIdRequested() const { return objectIdRequested_; }
+
+  /**
+   * @brief get the object id read by the last @ref requestObjectId(), or
+   * @ref Corrade::Containers::NullOpt if there's no request to resolve
+   */
+  Corrade::Containers::Optional<unsigned int> resolveObjectId();
+
   /**
    * @brief create a mesh visualizer (a drawable) for the picked object (a
    * drawable), if there is any
@@ -67,12 +97,21 @@ class ObjectPickingHelper {
   Magnum::GL::Renderbuffer selectionDepth_;
   Magnum::GL::Renderbuffer selectionDrawableId_;
 
+  // pixel buffer the requested object id is copied to
+  Magnum::GL::BufferImage2D objectIdPixel_{Magnum::PixelFormat::R32UI};
+  bool objectIdRequested_ = false;
+#ifdef MAGNUM_TARGET_GLES
+  unsigned int requestedObjectId_ = 0;
+#endif
+
   Magnum::Shaders::MeshVisualizerGL3D shader_{
       Magnum::Shaders::MeshVisualizerGL3D::Configuration{}.setFlags(
           Magnum::Shaders::MeshVisualizerGL3D::Flag::Wireframe)};
   esp::gfx::MeshVisualizerDrawable* meshVisualizerDrawable_ = nullptr;
   esp::gfx::DrawableGroup pickedObjectDrawbles_;
   ObjectPickingHelper& mapForDraw();
+  Magnum::Range2Di objectIdArea(const Magnum::Vector2i& mouseEventPosition,
+                                const Magnum::Vector2i& windowSize);
 };
 
 #endif  // ESP_UTILS_VIEWER_OBJECTPICKINGHELPER_H_
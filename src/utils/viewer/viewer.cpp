@@ -340,7 +340,7 @@ In LOOK mode (default):
   SHIFT-LEFT:
     Read Semantic ID and tag of clicked object (Currently only HM3D);
   SHIFT-RIGHT:
-    Click a mesh to highlight it.
+    Click a mesh to highlight it. The mesh is highlighted one frame later.
   WHEEL:
     Modify orthographic camera zoom/perspective camera FOV (+SHIFT for fine grained control)
 In GRAB mode (with 'enable-physics'):
@@ -382,6 +382,7 @@ Key Commands:
   'e': Enable/disable frustum culling.
   'c': Show/hide UI overlay.
   'n': Show/hide NavMesh wireframe.
+  'k': Toggle highlighting the mesh under the mouse cursor.
   'i': Save a screenshot to "./screenshots/year_month_day_hour-minute-second/#.png".
   ',': Render a Bullet collision shape debug wireframe overlay (white=active, green=sleeping, blue=wants sleeping, red=can't sleep)
 
@@ -621,7 +622,22 @@ Key Commands:
 
   // NOTE: Mouse + shift is to select object on the screen!!
   void createPickedObjectVisualizer(unsigned int objectId);
+  /**
+   * @brief Render the object ids for picking and request the id at
+   * @ref pickPosition_, if there's a pick to do. The id is resolved at the
+   * start of the next frame, so the frame doesn't wait on the readback.
+   */
+  void requestObjectPick();
   std::unique_ptr<ObjectPickingHelper> objectPickingHelper_;
+  // unscaled mouse position of a requested pick
+  Cr::Containers::Optional<Mn::Vector2i> pickPosition_;
+  // whether the object under the mouse is highlighted without clicking
+  bool hoverPicking_ = false;
+  // unscaled mouse position of the last mouse move
+  Mn::Vector2i hoverMousePosition_;
+  // camera of the last hover pick, to pick again once the camera moved
+  Mn::Matrix4 hoverPickCameraMatrix_;
+  unsigned int pickedObjectId_ = ~0u;
 
   enum class VisualizeMode : uint8_t {
     RGBA = 0,
@@ -1583,6 +1599,20 @@ void Viewer::drawEvent() {
     timeSinceLastSimulation_ = fmod(timeSinceLastSimulation_, 1.0 / 60.0);
   }
 
+  // highlight the object picked in the previous frame, then pick again
+  if (Cr::Containers::Optional<unsigned int> pickedObject =
+          objectPickingHelper_->resolveObjectId()) {
+    // while hovering, keep the visualizer of an object still under the mouse
+    if (!hoverPicking_ || *pickedObject != pickedObjectId_) {
+      createPickedObjectVisualizer(*pickedObject);
+    }
+  }
+  if (hoverPicking_ && !pickPosition_ &&
+      hoverPickCameraMatrix_ != renderCamera_->cameraMatrix()) {
+    pickPosition_ = hoverMousePosition_;
+  }
+  requestObjectPick();
+
   uint32_t visibles = renderCamera_->getPreviousNumVisibleDrawables();
 
   if ((visualizeMode_ == VisualizeMode::RGBA) &&
@@ -1860,13 +1890,40 @@ void Viewer::viewportEvent(ViewportEvent& event) {
 }
 
 void Viewer::createPickedObjectVisualizer(unsigned int objectId) {
+  esp::gfx::Drawable* pickedDrawable = nullptr;
   for (auto& it : activeSceneGraph_->getDrawableGroups()) {
     if (it.second.hasDrawable(objectId)) {
-      auto* pickedDrawable = it.second.getDrawable(objectId);
-      objectPickingHelper_->createPickedObjectVisualizer(pickedDrawable);
+      pickedDrawable = it.second.getDrawable(objectId);
       break;
     }
   }
+  // also removes the visualizer of the previously picked object
+  objectPickingHelper_->createPickedObjectVisualizer(pickedDrawable);
+  pickedObjectId_ = objectId;
+}
+
+void Viewer::requestObjectPick() {
+  if (!pickPosition_) {
+    return;
+  }
+  // cannot use the default framebuffer, so setup another framebuffer, also,
+  // setup the color attachment for rendering
+  objectPickingHelper_->prepareToDraw();
+
+  // redraw the scene on the object picking framebuffer
+  esp::gfx::RenderCamera::Flags flags =
+      esp::gfx::RenderCamera::Flag::UseDrawableIdAsObjectId;
+  if (simulator_->isFrustumCullingEnabled())
+    flags |= esp::gfx::RenderCamera::Flag::FrustumCulling;
+  for (auto& it : activeSceneGraph_->getDrawableGroups()) {
+    renderCamera_->draw(it.second, flags);
+  }
+
+  // Request the object Id - takes unscaled mouse position, and scales it in
+  // objectPicker
+  objectPickingHelper_->requestObjectId(*pickPosition_, windowSize());
+  hoverPickCameraMatrix_ = renderCamera_->cameraMatrix();
+  pickPosition_ = Cr::Containers::NullOpt;
 }
 
 void Viewer::buildSemanticPrims(int semanticID,
@@ -1917,27 +1974,9 @@ void Viewer::mousePressEvent(MouseEvent& event) {
       // if shift pressed w/right click in look mode, get object ID and
       // create visualization
       if (event.modifiers() & MouseEvent::Modifier::Shift) {
-        // cannot use the default framebuffer, so setup another framebuffer,
-        // also, setup the color attachment for rendering, and remove the
-        // visualizer for the previously picked object
-        objectPickingHelper_->prepareToDraw();
-
-        // redraw the scene on the object picking framebuffer
-        esp::gfx::RenderCamera::Flags flags =
-            esp::gfx::RenderCamera::Flag::UseDrawableIdAsObjectId;
-        if (simulator_->isFrustumCullingEnabled())
-          flags |= esp::gfx::RenderCamera::Flag::FrustumCulling;
-        for (auto& it : activeSceneGraph_->getDrawableGroups()) {
-          renderCamera_->draw(it.second, flags);
-        }
-
-        // Read the object Id - takes unscaled mouse position, and scales it in
-        // objectPicker
-        unsigned int pickedObject =
-            objectPickingHelper_->getObjectId(event.position(), windowSize());
-
-        // if an object is selected, create a visualizer
-        createPickedObjectVisualizer(pickedObject);
+        // picked in the next frame and highlighted in the one after, so the
+        // click doesn't wait for the GPU to read the object id back
+        pickPosition_ = event.position();
         return;
       }  // drawable selection
       // add primitive w/ right click if a collision object is hit by a raycast
@@ -2154,6 +2193,10 @@ void Viewer::mouseScrollEvent(MouseScrollEvent& event) {
 }  // Viewer::mouseScrollEvent
 
 void Viewer::mouseMoveEvent(MouseMoveEvent& event) {
+  hoverMousePosition_ = event.position();
+  if (hoverPicking_) {
+    pickPosition_ = hoverMousePosition_;
+  }
   if ((mouseInteractionMode == MouseInteractionMode::LOOK) &&
       (!(event.buttons() & MouseMoveEvent::Button::Left))) {
     return;
@@ -2317,6 +2360,15 @@ void Viewer::keyPressEvent(KeyEvent& event) {
     case KeyEvent::Key::I:
       screenshot();
       break;
+    case KeyEvent::Key::K:
+      // toggle highlighting the object under the mouse
+      hoverPicking_ = !hoverPicking_;
+      if (hoverPicking_) {
+        pickPosition_ = hoverMousePosition_;
+      } else {
+        createPickedObjectVisualizer(~0u);
+      }
+      break;
     case KeyEvent::Key::M: {
       // toggle the mouse interaction mode
       mouseInteractionMode = MouseInteractionMode(
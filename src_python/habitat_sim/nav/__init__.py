@@ -4,6 +4,7 @@
 
 from habitat_sim._ext.habitat_sim_bindings import (
     GreedyFollowerCodes,
+    GreedyGeodesicFollowerBatch,
     GreedyGeodesicFollowerImpl,
     HitRecord,
     MultiGoalShortestPath,
@@ -17,6 +18,7 @@ from .greedy_geodesic_follower import GreedyGeodesicFollower
 
 __all__ = [
     "GreedyGeodesicFollower",
+    "GreedyGeodesicFollowerBatch",
     "GreedyGeodesicFollowerImpl",
     "GreedyFollowerCodes",
     "MultiGoalShortestPath",
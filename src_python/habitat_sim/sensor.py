@@ -9,6 +9,7 @@ from habitat_sim._ext.habitat_sim_bindings import (
     CameraSensorSpec,
     CubeMapSensorBase,
     CubeMapSensorBaseSpec,
+    EncodedObservation,
     EquirectangularSensor,
     EquirectangularSensorSpec,
     FisheyeSensor,
@@ -16,6 +17,8 @@ from habitat_sim._ext.habitat_sim_bindings import (
     FisheyeSensorModelType,
     FisheyeSensorSpec,
     Observation,
+    ObservationEncoder,
+    ObservationEncoding,
     RLRAudioPropagationChannelLayout,
     RLRAudioPropagationChannelLayoutType,
     RLRAudioPropagationConfiguration,
@@ -26,6 +29,7 @@ from habitat_sim._ext.habitat_sim_bindings import (
     SensorType,
     VisualSensor,
     VisualSensorSpec,
+    decode_observation,
 )
 
 __all__ = [
@@ -33,6 +37,7 @@ __all__ = [
     "CameraSensorSpec",
     "CubeMapSensorBase",
     "CubeMapSensorBaseSpec",
+    "EncodedObservation",
     "EquirectangularSensor",
     "EquirectangularSensorSpec",
     "FisheyeSensor",
@@ -40,6 +45,8 @@ __all__ = [
     "FisheyeSensorModelType",
     "FisheyeSensorSpec",
     "Observation",
+    "ObservationEncoder",
+    "ObservationEncoding",
     "Sensor",
     "SensorFactory",
     "SensorSpec",
@@ -47,6 +54,7 @@ __all__ = [
     "SensorType",
     "VisualSensor",
     "VisualSensorSpec",
+    "decode_observation",
     "AudioSensorSpec",
     "AudioSensor",
     "RLRAudioPropagationChannelLayout",
@@ -113,11 +113,17 @@ class RedwoodNoiseModelCPUImpl:
 @attr.s(auto_attribs=True, kw_only=True)
 class RedwoodDepthNoiseModel(SensorNoiseModel):
     noise_multiplier: float = 1.0
+    # Apply the noise on the GPU while the depth is read from the render
+    # target instead, see attach_to_render_target(). Needs no CUDA.
+    apply_in_render_target: bool = False
+    seed: int = 0
 
     def __attrs_post_init__(self) -> None:
         dist = np.load(
             osp.join(osp.dirname(__file__), "data", "redwood-depth-dist-model.npy")
         )
+        self._dist = dist
+        self._applied_in_render_target = False
 
         if cuda_enabled:
             self._impl = RedwoodNoiseModelGPUImpl(
@@ -130,7 +136,22 @@ class RedwoodDepthNoiseModel(SensorNoiseModel):
     def is_valid_sensor_type(sensor_type: SensorType) -> bool:
         return sensor_type == SensorType.DEPTH
 
+    def attach_to_render_target(self, renderer, sensor_object) -> None:
+        r"""Apply the noise to the depth read from the render target of
+        ``sensor_object``, after which `simulate()` passes the depth through.
+        The noise has the same distribution, but isn't bit-exact with the
+        CPU and CUDA implementations."""
+        renderer.set_redwood_depth_noise(
+            sensor_object,
+            self._dist.reshape(80, -1).astype(np.float32),
+            self.noise_multiplier,
+            self.seed,
+        )
+        self._applied_in_render_target = True
+
     def simulate(self, gt_depth: Union[ndarray, "Tensor"]) -> Union[ndarray, "Tensor"]:
+        if self._applied_in_render_target:
+            return gt_depth
         if cuda_enabled:
             if isinstance(gt_depth, np.ndarray):
                 return self._impl.simulate_from_cpu(gt_depth)
@@ -143,6 +164,29 @@ class RedwoodDepthNoiseModel(SensorNoiseModel):
         else:
             return self._impl.simulate(gt_depth)
 
+    def simulate_batch(
+        self, gt_depths: Union[ndarray, "Tensor"]
+    ) -> Union[ndarray, "Tensor"]:
+        r"""Simulates noisy depth for a batch of clean depth images stacked
+        along the first dimension, e.g. the observations of many environments.
+        A CUDA tensor is noised with a single kernel launch, every image
+        drawing from its own random states."""
+        if self._applied_in_render_target:
+            return gt_depths
+        if cuda_enabled and not isinstance(gt_depths, np.ndarray):
+            gt_depths = gt_depths.contiguous()
+            noisy_depths = torch.empty_like(gt_depths)
+            batch_size, rows, cols = gt_depths.size()
+            self._impl.simulate_batch_from_gpu(
+                gt_depths.data_ptr(),  # type: ignore[attr-defined]
+                batch_size,
+                rows,
+                cols,
+                noisy_depths.data_ptr(),  # type: ignore[attr-defined]
+            )
+            return noisy_depths
+        return np.stack([self.simulate(gt_depth) for gt_depth in gt_depths])
+
     def apply(self, gt_depth: Union[ndarray, "Tensor"]) -> Union[ndarray, "Tensor"]:
         r"""Alias of `simulate()` to conform to base-class and expected API"""
         return self.simulate(gt_depth)
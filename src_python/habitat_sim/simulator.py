@@ -31,7 +31,14 @@ from habitat_sim.bindings import cuda_enabled
 from habitat_sim.logging import LoggingContext, logger
 from habitat_sim.metadata import MetadataMediator
 from habitat_sim.nav import GreedyGeodesicFollower
-from habitat_sim.sensor import SensorSpec, SensorType
+from habitat_sim.sensor import (
+    EncodedObservation,
+    ObservationEncoding,
+    SensorSpec,
+    SensorSubType,
+    SensorType,
+    VisualSensorSpec,
+)
 from habitat_sim.sensors.noise_models import make_sensor_noise_model
 from habitat_sim.sim import SimulatorBackend, SimulatorConfiguration
 from habitat_sim.utils.common import quat_from_angle_axis
@@ -47,6 +54,11 @@ class Configuration:
     :property sim_cfg: The configuration of the backend of the simulator
     :property agents: A list of agent configurations
     :property metadata_mediator: (optional) The metadata mediator to build the simulator from.
+    :property enable_fused_sensor_rendering: Render the color, depth and
+        semantic sensors of an agent that share a mount point, resolution and
+        projection in a single pass. Fisheye and equirectangular sensors that
+        share a mount point and near and far planes render one shared cubemap
+        instead. See `Renderer.bind_fused_render_target`
 
     Ties together a backend config, `sim_cfg` and a list of agent
     configurations `agents`.
@@ -57,6 +69,7 @@ class Configuration:
     # An existing Metadata Mediator can also be used to construct a SimulatorBackend
     metadata_mediator: Optional[MetadataMediator] = None
     enable_batch_renderer: bool = False
+    enable_fused_sensor_rendering: bool = False
 
 
 @attr.s(auto_attribs=True)
@@ -68,6 +81,11 @@ class Simulator(SimulatorBackend):
     The simulator ties together the backend, the agent, controls functions,
     NavMesh collision checking/pathfinding, attribute template management,
     object manipulation, and physics simulation.
+
+    Loading scenes, stepping physics, recomputing the NavMesh, path finding and
+    drawing and reading observations release the GIL, so simulators stepped
+    from different Python threads run in parallel. Each simulator must only be
+    used by one thread at a time.
     """
 
     config: Configuration
@@ -75,11 +93,16 @@ class Simulator(SimulatorBackend):
     _num_total_frames: int = attr.ib(default=0, init=False)
     _default_agent_id: int = attr.ib(default=0, init=False)
     __sensors: List[Dict[str, "Sensor"]] = attr.ib(factory=list, init=False)
+    __fused_sensor_groups: List[List[List["Sensor"]]] = attr.ib(
+        factory=list, init=False
+    )
     _initialized: bool = attr.ib(default=False, init=False)
     _previous_step_time: float = attr.ib(
         default=0.0, init=False
     )  # track the compute time of each step
     _async_draw_agent_ids: Optional[Union[int, List[int]]] = None
+    # collided flags of the actions whose results step_pipelined() returns next
+    _pipelined_collided: Dict[int, bool] = attr.ib(factory=dict, init=False)
     __last_state: Dict[int, AgentState] = attr.ib(factory=dict, init=False)
 
     @staticmethod
@@ -140,6 +163,7 @@ class Simulator(SimulatorBackend):
                 del sensor
 
         self.__sensors = []
+        self.__fused_sensor_groups = []
 
         for agent in self.agents:
             agent.close()
@@ -175,6 +199,7 @@ class Simulator(SimulatorBackend):
         super().reset()
         for i in range(len(self.agents)):
             self.reset_agent(i)
+        self._pipelined_collided.clear()
 
         if agent_ids is None:
             agent_ids = [self._default_agent_id]
@@ -237,10 +262,12 @@ class Simulator(SimulatorBackend):
         self.__sensors: List[Dict[str, Sensor]] = [
             dict() for i in range(len(config.agents))
         ]
+        self.__fused_sensor_groups = [[] for i in range(len(config.agents))]
         self.__last_state = dict()
         for agent_id, agent_cfg in enumerate(config.agents):
             for spec in agent_cfg.sensor_specifications:
                 self._update_simulator_sensors(spec.uuid, agent_id=agent_id)
+            self._fuse_agent_sensors(agent_id)
             self.initialize_agent(agent_id)
 
     def _update_simulator_sensors(self, uuid: str, agent_id: int) -> None:
@@ -248,6 +275,27 @@ class Simulator(SimulatorBackend):
             sim=self, agent=self.get_agent(agent_id), sensor_id=uuid
         )
 
+    def _fuse_agent_sensors(self, agent_id: int) -> None:
+        r"""Group the sensors of an agent that can be drawn in one pass and
+        bind a shared render target to each group with more than one sensor.
+        """
+        if not self.config.enable_fused_sensor_rendering or self.renderer is None:
+            return
+
+        groups: Dict[Any, List[Sensor]] = OrderedDict()
+        for sensor in self.__sensors[agent_id].values():
+            key = sensor._fusion_key()
+            if key is not None:
+                groups.setdefault(key, []).append(sensor)
+
+        self.__fused_sensor_groups[agent_id] = [
+            group for group in groups.values() if len(group) > 1
+        ]
+        for group in self.__fused_sensor_groups[agent_id]:
+            self.renderer.bind_fused_render_target(
+                [sensor._sensor_object for sensor in group]
+            )
+
     def add_sensor(
         self, sensor_spec: SensorSpec, agent_id: Optional[int] = None
     ) -> None:
@@ -276,6 +324,22 @@ class Simulator(SimulatorBackend):
         agent = self.get_agent(agent_id=agent_id)
         agent._add_sensor(sensor_spec)
         self._update_simulator_sensors(sensor_spec.uuid, agent_id=agent_id)
+        self._fuse_agent_sensors(agent_id)
+
+    def bind_sensor_observation_buffer(
+        self,
+        uuid: str,
+        buffer: Union[ndarray, "Tensor"],
+        agent_id: Optional[int] = None,
+    ) -> None:
+        r"""Read the observations of sensor :p:`uuid` straight into
+        :p:`buffer` instead of the sensor's own buffer, see
+        :ref:`Sensor.bind_observation_buffer`. The binding is dropped when the
+        sensors are recreated, e.g. by :ref:`reconfigure`, or resized.
+        """
+        if agent_id is None:
+            agent_id = self._default_agent_id
+        self.__sensors[agent_id][uuid].bind_observation_buffer(buffer)
 
     def get_agent(self, agent_id: int) -> Agent:
         return self.agents[agent_id]
@@ -376,18 +440,30 @@ class Simulator(SimulatorBackend):
         return observations
 
     @overload
-    def get_sensor_observations(self, agent_ids: int = 0) -> ObservationDict:
+    def get_sensor_observations(
+        self, agent_ids: int = 0, sensor_uuids: Optional[List[str]] = None
+    ) -> ObservationDict:
         ...
 
     @overload
     def get_sensor_observations(
-        self, agent_ids: List[int]
+        self, agent_ids: List[int], sensor_uuids: Optional[List[str]] = None
     ) -> Dict[int, ObservationDict]:
         ...
 
     def get_sensor_observations(
-        self, agent_ids: Union[int, List[int]] = 0
+        self,
+        agent_ids: Union[int, List[int]] = 0,
+        sensor_uuids: Optional[List[str]] = None,
     ) -> Union[ObservationDict, Dict[int, ObservationDict],]:
+        r"""Draw and read the observations of the sensors of given agents.
+
+        If :p:`sensor_uuids` is :py:`None`, all sensors that are
+        :ref:`habitat_sim.sensor.Sensor.enabled` are drawn. Otherwise only the
+        listed sensors are, including disabled ones, and uuids an agent doesn't
+        have a sensor for are skipped. Sensors not requested aren't rendered
+        and are missing in the result.
+        """
         if isinstance(agent_ids, int):
             agent_ids = [agent_ids]
             return_single = True
@@ -397,12 +473,14 @@ class Simulator(SimulatorBackend):
         # As backport. All Dicts are ordered in Python >= 3.7.
         observations: Dict[int, ObservationDict] = OrderedDict()
 
+        sensors = {
+            agent_id: self._requested_sensors(agent_id, sensor_uuids)
+            for agent_id in agent_ids
+        }
+
         # Draw observations (for classic non-batched renderer).
         if not self.config.enable_batch_renderer:
-            for agent_id in agent_ids:
-                agent_sensorsuite = self.__sensors[agent_id]
-                for _sensor_uuid, sensor in agent_sensorsuite.items():
-                    sensor.draw_observation()
+            self._draw_sensor_observations(agent_ids, sensors)
         else:
             # The batch renderer draws observations from external code.
             # Sensors are only used as data containers.
@@ -411,7 +489,7 @@ class Simulator(SimulatorBackend):
         # Get observations.
         for agent_id in agent_ids:
             agent_observations: ObservationDict = {}
-            for sensor_uuid, sensor in self.__sensors[agent_id].items():
+            for sensor_uuid, sensor in sensors[agent_id].items():
                 agent_observations[sensor_uuid] = sensor.get_observation()
             observations[agent_id] = agent_observations
 
@@ -419,6 +497,140 @@ class Simulator(SimulatorBackend):
             return next(iter(observations.values()))
         return observations
 
+    def get_encoded_sensor_observations(
+        self,
+        agent_ids: Union[int, List[int]] = 0,
+        sensor_uuids: Optional[List[str]] = None,
+    ) -> Union[Dict[str, Any], Dict[int, Dict[str, Any]]]:
+        r"""Like :ref:`get_sensor_observations`, but observations of visual
+        sensors with an :ref:`habitat_sim.sensor.VisualSensorSpec.encoding`
+        are returned as :ref:`habitat_sim.sensor.EncodedObservation`. Those get
+        compressed on the threads of :ref:`observation_encoder` while the next
+        frames render, their bytes can be decompressed with
+        :ref:`habitat_sim.sensor.decode_observation`. Noise models aren't
+        applied to them.
+        """
+        assert not self.config.enable_batch_renderer
+        if isinstance(agent_ids, int):
+            agent_ids = [agent_ids]
+            return_single = True
+        else:
+            return_single = False
+
+        sensors = {
+            agent_id: self._requested_sensors(agent_id, sensor_uuids)
+            for agent_id in agent_ids
+        }
+        self._draw_sensor_observations(agent_ids, sensors)
+        observations: Dict[int, Dict[str, Any]] = OrderedDict()
+        for agent_id in agent_ids:
+            agent_observations: Dict[str, Any] = {}
+            for sensor_uuid, sensor in sensors[agent_id].items():
+                if sensor.encoding != ObservationEncoding.NONE:
+                    agent_observations[sensor_uuid] = sensor.get_encoded_observation()
+                else:
+                    agent_observations[sensor_uuid] = sensor.get_observation()
+            observations[agent_id] = agent_observations
+
+        if return_single:
+            return next(iter(observations.values()))
+        return observations
+
+    def _requested_sensors(
+        self, agent_id: int, sensor_uuids: Optional[List[str]]
+    ) -> Dict[str, "Sensor"]:
+        agent_sensorsuite = self.__sensors[agent_id]
+        if sensor_uuids is None:
+            return {
+                sensor_uuid: sensor
+                for sensor_uuid, sensor in agent_sensorsuite.items()
+                if sensor._sensor_object.enabled
+            }
+        return {
+            sensor_uuid: agent_sensorsuite[sensor_uuid]
+            for sensor_uuid in sensor_uuids
+            if sensor_uuid in agent_sensorsuite
+        }
+
+    def _draw_sensor_observations(
+        self,
+        agent_ids: List[int],
+        sensors: Optional[Dict[int, Dict[str, "Sensor"]]] = None,
+    ) -> None:
+        for agent_id in agent_ids:
+            agent_sensors = (
+                self.__sensors[agent_id] if sensors is None else sensors[agent_id]
+            )
+            requested = {id(sensor) for sensor in agent_sensors.values()}
+            # a fused group is drawn only if all its sensors are requested,
+            # otherwise its requested sensors are drawn one by one
+            fused_sensors = set()
+            for group in self.__fused_sensor_groups[agent_id]:
+                if all(id(sensor) in requested for sensor in group):
+                    group[0].draw_observation_fused(group)
+                    fused_sensors.update(id(sensor) for sensor in group)
+
+            for _sensor_uuid, sensor in agent_sensors.items():
+                if id(sensor) not in fused_sensors:
+                    sensor.draw_observation()
+
+    def start_sensor_observations_readback(
+        self, agent_ids: Union[int, List[int]] = 0
+    ) -> None:
+        r"""Draw the sensor observations of the current frame and start
+        reading them back without waiting for the GPU.
+
+        Retrieve them with `get_sensor_observations_readback_finish`, which
+        can be called after the next frame was started, so that rendering of
+        one step overlaps with physics and the readback of the previous one.
+        Each sensor can have up to its `readback_slot_count` readbacks
+        pending.
+        """
+        assert not self.config.enable_batch_renderer
+        if isinstance(agent_ids, int):
+            agent_ids = [agent_ids]
+
+        self._draw_sensor_observations(agent_ids)
+        for agent_id in agent_ids:
+            for sensor in self.__sensors[agent_id].values():
+                sensor._start_readback()
+
+    @overload
+    def get_sensor_observations_readback_finish(
+        self, agent_ids: int = 0
+    ) -> ObservationDict:
+        ...
+
+    @overload
+    def get_sensor_observations_readback_finish(
+        self, agent_ids: List[int]
+    ) -> Dict[int, ObservationDict]:
+        ...
+
+    def get_sensor_observations_readback_finish(
+        self, agent_ids: Union[int, List[int]] = 0
+    ) -> Union[ObservationDict, Dict[int, ObservationDict],]:
+        r"""Wait for the oldest readback started by
+        `start_sensor_observations_readback` and return its observations.
+        """
+        assert not self.config.enable_batch_renderer
+        if isinstance(agent_ids, int):
+            agent_ids = [agent_ids]
+            return_single = True
+        else:
+            return_single = False
+
+        observations: Dict[int, ObservationDict] = OrderedDict()
+        for agent_id in agent_ids:
+            agent_observations: ObservationDict = {}
+            for sensor_uuid, sensor in self.__sensors[agent_id].items():
+                agent_observations[sensor_uuid] = sensor._get_observation_readback()
+            observations[agent_id] = agent_observations
+
+        if return_single:
+            return next(iter(observations.values()))
+        return observations
+
     @property
     def _default_agent(self) -> Agent:
         # TODO Deprecate and remove
@@ -483,6 +695,92 @@ class Simulator(SimulatorBackend):
             return multi_observations[self._default_agent_id]
         return multi_observations
 
+    @overload
+    def step_pipelined(
+        self, action: Union[str, int], dt: float = 1.0 / 60.0
+    ) -> ObservationDict:
+        ...
+
+    @overload
+    def step_pipelined(
+        self, action: MutableMapping_T[int, Union[str, int]], dt: float = 1.0 / 60.0
+    ) -> Dict[int, ObservationDict]:
+        ...
+
+    def step_pipelined(
+        self,
+        action: Union[str, int, MutableMapping_T[int, Union[str, int]]],
+        dt: float = 1.0 / 60.0,
+    ) -> Union[ObservationDict, Dict[int, ObservationDict],]:
+        r"""Like :ref:`step`, but render the observations of the previous step
+        while this one is simulated.
+
+        The observations returned by a call are of the state *before* its
+        action is applied, that is the state :ref:`step` would have returned
+        observations of in the previous call, and their ``"collided"`` entry
+        is of the action that led to that state. The first call after
+        construction or :ref:`reset` returns observations of the initial
+        state with ``"collided"`` being :py:`False`. Observations of the
+        state after the last call are retrieved with
+        :ref:`get_sensor_observations`.
+
+        Sensor poses and object transformations are captured before the
+        agents act, then the agents act and physics steps while the
+        background renderer draws, and the call returns once both are done.
+        Objects can't be added or removed during that, but can be between
+        calls. Without a background renderer the observations are rendered
+        first and the latency is the same.
+        """
+        if self._async_draw_agent_ids is not None:
+            raise RuntimeError(
+                "start_async_render_and_step_physics was already called.  "
+                "Call get_sensor_observations_async_finish before calling step_pipelined."
+            )
+
+        self._num_total_frames += 1
+        if isinstance(action, MutableMapping):
+            return_single = False
+        else:
+            action = cast(Dict[int, Union[str, int]], {self._default_agent_id: action})
+            return_single = True
+        agent_ids = list(action.keys())
+
+        pipelined = (
+            not self.config.enable_batch_renderer
+            and self.renderer is not None
+            and hasattr(self.renderer, "start_draw_jobs")
+        )
+        if pipelined:
+            self.start_async_render(agent_ids)
+        else:
+            multi_observations = self.get_sensor_observations(agent_ids=agent_ids)
+
+        try:
+            if pipelined:
+                # skinned drawables read the scene graph while being drawn
+                self.renderer.wait_scene_graph()
+            collided_dict: Dict[int, bool] = {}
+            for agent_id, agent_act in action.items():
+                agent = self.get_agent(agent_id)
+                collided_dict[agent_id] = agent.act(agent_act)
+                self.__last_state[agent_id] = agent.get_state()
+
+            step_start_Time = time.time()
+            super().step_world(dt)
+            self._previous_step_time = time.time() - step_start_Time
+        finally:
+            if pipelined:
+                multi_observations = self.get_sensor_observations_async_finish()
+
+        for agent_id, agent_observation in multi_observations.items():
+            agent_observation["collided"] = self._pipelined_collided.get(
+                agent_id, False
+            )
+        self._pipelined_collided.update(collided_dict)
+        if return_single:
+            return multi_observations[self._default_agent_id]
+        return multi_observations
+
     def make_greedy_follower(
         self,
         agent_id: Optional[int] = None,
@@ -562,6 +860,31 @@ class Sensor:
         if self._sim.renderer is not None:
             self._sim.renderer.bind_render_target(self._sensor_object)
 
+        self._allocate_buffers()
+
+        noise_model_kwargs = self._spec.noise_model_kwargs
+        self._noise_model = make_sensor_noise_model(
+            self._spec.noise_model,
+            {"gpu_device_id": self._sim.gpu_device, **noise_model_kwargs},
+        )
+        assert self._noise_model.is_valid_sensor_type(
+            self._spec.sensor_type
+        ), "Noise model '{}' is not valid for sensor '{}'".format(
+            self._spec.noise_model, self._spec.uuid
+        )
+        if (
+            getattr(self._noise_model, "apply_in_render_target", False)
+            and self._sim.renderer is not None
+        ):
+            self._noise_model.attach_to_render_target(
+                self._sim.renderer, self._sensor_object
+            )
+
+    def _allocate_buffers(self) -> None:
+        r"""Allocate the observation buffer for the current resolution of the
+        sensor. Any buffer bound with :ref:`bind_observation_buffer` is
+        dropped.
+        """
         if self._spec.gpu2gpu_transfer:
             assert cuda_enabled, "Must build habitat sim with cuda for gpu2gpu-transfer"
             assert _HAS_TORCH
@@ -584,29 +907,32 @@ class Sensor:
         else:
             size = self._sensor_object.framebuffer_size
             if self._spec.sensor_type == SensorType.SEMANTIC:
-                self._buffer = np.empty(
+                compact = self._spec.compact_semantic_ids
+                self._buffer = self._empty_host_buffer(
                     (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.uint32,
+                    np.uint16 if compact else np.uint32,
                 )
                 self.view = mn.MutableImageView2D(
-                    mn.PixelFormat.R32UI, size, self._buffer
+                    mn.PixelFormat.R16UI if compact else mn.PixelFormat.R32UI,
+                    size,
+                    self._buffer,
                 )
             elif self._spec.sensor_type == SensorType.DEPTH:
-                self._buffer = np.empty(
+                self._buffer = self._empty_host_buffer(
                     (self._spec.resolution[0], self._spec.resolution[1]),
-                    dtype=np.float32,
+                    np.float32,
                 )
                 self.view = mn.MutableImageView2D(
                     mn.PixelFormat.R32F, size, self._buffer
                 )
             else:
-                self._buffer = np.empty(
+                self._buffer = self._empty_host_buffer(
                     (
                         self._spec.resolution[0],
                         self._spec.resolution[1],
                         self._spec.channels,
                     ),
-                    dtype=np.uint8,
+                    np.uint8,
                 )
                 self.view = mn.MutableImageView2D(
                     mn.PixelFormat.RGBA8_UNORM,
@@ -614,16 +940,87 @@ class Sensor:
                     self._buffer.reshape(self._spec.resolution[0], -1),
                 )
 
-        noise_model_kwargs = self._spec.noise_model_kwargs
-        self._noise_model = make_sensor_noise_model(
-            self._spec.noise_model,
-            {"gpu_device_id": self._sim.gpu_device, **noise_model_kwargs},
-        )
-        assert self._noise_model.is_valid_sensor_type(
-            self._spec.sensor_type
-        ), "Noise model '{}' is not valid for sensor '{}'".format(
-            self._spec.noise_model, self._spec.uuid
+    def _update_buffers(self) -> None:
+        r"""Reallocate the observation buffer if the sensor was resized since
+        it was allocated. The render target is resized by the sensor itself.
+        """
+        if tuple(self._buffer.shape[:2]) != tuple(self._spec.resolution):
+            self._allocate_buffers()
+
+    def _empty_host_buffer(self, shape, dtype) -> ndarray:
+        r"""Observation buffer for CPU sensors, page-locked if
+        :ref:`VisualSensorSpec.pinned_host_memory` is set and CUDA is
+        available through torch, so it can be copied to a GPU asynchronously.
+        """
+        if (
+            getattr(self._spec, "pinned_host_memory", False)
+            and _HAS_TORCH
+            and torch.cuda.is_available()  # type: ignore[attr-defined]
+        ):
+            # the array keeps the tensor and thus the pinned memory alive
+            nbytes = int(np.prod(shape)) * np.dtype(dtype).itemsize
+            pinned = torch.empty(nbytes, dtype=torch.uint8, pin_memory=True)  # type: ignore[attr-defined]
+            return pinned.numpy().view(dtype).reshape(shape)
+        buffer = np.empty(shape, dtype=dtype)
+        if self._sim.config.sim_cfg.main_thread_cpus:
+            # pages land on the NUMA node of the thread first writing them,
+            # so touch them here on the pinned main thread rather than leaving
+            # it to the render thread
+            buffer.fill(0)
+        return buffer
+
+    def bind_observation_buffer(self, buffer: Union[ndarray, "Tensor"]) -> None:
+        r"""Read observations straight into :p:`buffer` from now on, e.g. a
+        slice of preallocated rollout storage, instead of copying them there
+        from the sensor's own buffer.
+
+        :p:`buffer` has to have the shape and type of the observations and be
+        contiguous, such as one element of a batch. For CPU sensors it's a
+        NumPy array, for :ref:`SensorSpec.gpu2gpu_transfer` sensors a torch
+        tensor on the simulator's GPU. For asynchronous copies to a GPU, a
+        CPU buffer can be page-locked, e.g. a view of a tensor created with
+        ``pin_memory=True``. As with the sensor's own buffer, rows are stored
+        bottom to top as rendered and the returned observations are
+        vertically flipped views of it.
+        """
+        assert not self._sim.config.enable_batch_renderer
+        if self._spec.sensor_type == SensorType.AUDIO:
+            raise ValueError("Audio sensors have no observation buffer")
+        if tuple(buffer.shape) != tuple(self._buffer.shape):
+            raise ValueError(
+                f"Expected a buffer of shape {tuple(self._buffer.shape)}, "
+                f"got {tuple(buffer.shape)}"
+            )
+        if buffer.dtype != self._buffer.dtype:
+            raise ValueError(
+                f"Expected a buffer of type {self._buffer.dtype}, got {buffer.dtype}"
+            )
+
+        if self._spec.gpu2gpu_transfer:
+            # the device to device copies write the whole image at once
+            if (
+                not torch.is_tensor(buffer)
+                or buffer.device != self._buffer.device
+                or not buffer.is_contiguous()
+            ):
+                raise ValueError(
+                    f"Expected a contiguous tensor on {self._buffer.device}"
+                )
+            self._buffer = buffer
+            return
+
+        if (
+            not isinstance(buffer, np.ndarray)
+            or not buffer.flags.writeable
+            or not buffer.flags.c_contiguous
+        ):
+            raise ValueError("Expected a writeable contiguous NumPy array")
+        self.view = mn.MutableImageView2D(
+            self.view.format,
+            self._sensor_object.framebuffer_size,
+            buffer.reshape(buffer.shape[0], -1),
         )
+        self._buffer = buffer
 
     def draw_observation(self) -> None:
         # Batch rendering happens elsewhere.
@@ -644,6 +1041,65 @@ class Sensor:
             )
         self._sim.renderer.draw(self._sensor_object, self._sim)
 
+    def _fusion_key(self) -> Optional[Any]:
+        r"""Key identifying the sensors that can share a fused render pass
+        with this one, or None if it has to be drawn on its own.
+        """
+        if self._sim.config.enable_batch_renderer or self._spec.sensor_type not in (
+            SensorType.COLOR,
+            SensorType.DEPTH,
+            SensorType.SEMANTIC,
+        ):
+            return None
+        if (
+            self._spec.sensor_type == SensorType.SEMANTIC
+            and self._sim.get_active_scene_graph()
+            is not self._sim.get_active_semantic_scene_graph()
+        ):
+            return None
+        # cubemap sensors share just the cubemap, their resolution and
+        # projection can differ
+        if self._spec.sensor_subtype in (
+            SensorSubType.FISHEYE,
+            SensorSubType.EQUIRECTANGULAR,
+        ):
+            return (
+                "cubemap",
+                self._sensor_object.near,
+                self._sensor_object.far,
+                tuple(self._spec.position),
+                tuple(self._spec.orientation),
+            )
+        if self._sensor_object.render_camera is None:
+            return None
+
+        return (
+            tuple(self._spec.resolution),
+            self._spec.sensor_subtype,
+            float(self._sensor_object.hfov),
+            self._sensor_object.near,
+            self._sensor_object.far,
+            getattr(self._spec, "ortho_scale", None),
+            tuple(self._spec.position),
+            tuple(self._spec.orientation),
+        )
+
+    def draw_observation_fused(self, group: List["Sensor"]) -> None:
+        r"""Draw the observations of a fused sensor group, which this sensor
+        is part of, in a single pass.
+        """
+        assert not self._sim.config.enable_batch_renderer
+        assert self._sim.renderer is not None
+        for sensor in group:
+            if not sensor._sensor_object.object:
+                raise habitat_sim.errors.InvalidAttachedObject(
+                    "Sensor observation requested but sensor is invalid.\
+                        (has it been detached from a scene node?)"
+                )
+        self._sim.renderer.draw_fused(
+            [sensor._sensor_object for sensor in group], self._sim
+        )
+
     def _draw_observation_async(self) -> None:
         # Batch rendering happens elsewhere.
         assert not self._sim.config.enable_batch_renderer
@@ -678,6 +1134,13 @@ class Sensor:
                 raise RuntimeError(
                     "SemanticSensor observation requested but no SemanticScene is loaded"
                 )
+            if (
+                self._spec.compact_semantic_ids
+                and len(self._sim.semantic_scene.objects) > 0xFFFF
+            ):
+                raise RuntimeError(
+                    "The SemanticScene has too many objects for compact semantic IDs"
+                )
             scene = self._sim.get_active_semantic_scene_graph()
         else:  # SensorType is DEPTH or any other type
             scene = self._sim.get_active_scene_graph()
@@ -702,11 +1165,31 @@ class Sensor:
 
         if self._sim.frustum_culling:
             render_flags |= habitat_sim.gfx.Camera.Flags.FRUSTUM_CULLING
-
+        if self._sim.instanced_rendering:
+            render_flags |= habitat_sim.gfx.Camera.Flags.INSTANCING
+        if self._spec.sensor_type == SensorType.DEPTH:
+            render_flags |= habitat_sim.gfx.Camera.Flags.DEPTH_ONLY
+        elif self._spec.sensor_type == SensorType.SEMANTIC:
+            render_flags |= habitat_sim.gfx.Camera.Flags.OBJECT_ID_ONLY
+
+        self._update_buffers()
         self._sim.renderer.enqueue_async_draw_job(
             self._sensor_object, scene, self.view, render_flags
         )
 
+    @property
+    def encoding(self) -> ObservationEncoding:
+        if not isinstance(self._spec, VisualSensorSpec):
+            return ObservationEncoding.NONE
+        return self._spec.encoding
+
+    def get_encoded_observation(self) -> EncodedObservation:
+        r"""Read the observation that was last drawn and compress it in the
+        background, according to the encoding of the sensor specification
+        """
+        assert self._sim.renderer is not None
+        return self._sensor_object.encode_observation(self._sim.observation_encoder)
+
     def get_observation(self) -> Union[ndarray, "Tensor"]:
         if self._spec.sensor_type == SensorType.AUDIO:
             return self._get_audio_observation()
@@ -716,18 +1199,12 @@ class Sensor:
             return None
 
         assert self._sim.renderer is not None
+        self._update_buffers()
         tgt = self._sensor_object.render_target
 
         if self._spec.gpu2gpu_transfer:
-            with torch.cuda.device(self._buffer.device):  # type: ignore[attr-defined, union-attr]
-                if self._spec.sensor_type == SensorType.SEMANTIC:
-                    tgt.read_frame_object_id_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
-                elif self._spec.sensor_type == SensorType.DEPTH:
-                    tgt.read_frame_depth_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
-                else:
-                    tgt.read_frame_rgba_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
-
-                obs = self._buffer.flip(0)  # type: ignore[union-attr]
+            self._read_frame_gpu()
+            obs = self._buffer.flip(0)  # type: ignore[union-attr]
         else:
             if self._spec.sensor_type == SensorType.SEMANTIC:
                 tgt.read_frame_object_id(self.view)
@@ -740,6 +1217,45 @@ class Sensor:
 
         return self._noise_model(obs)
 
+    def _read_frame_gpu(self) -> None:
+        tgt = self._sensor_object.render_target
+        with torch.cuda.device(self._buffer.device):  # type: ignore[attr-defined, union-attr]
+            if self._spec.sensor_type == SensorType.SEMANTIC:
+                tgt.read_frame_object_id_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
+            elif self._spec.sensor_type == SensorType.DEPTH:
+                tgt.read_frame_depth_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
+            else:
+                tgt.read_frame_rgba_gpu(self._buffer.data_ptr())  # type: ignore[attr-defined, union-attr]
+
+    def _start_readback(self) -> None:
+        if self._spec.sensor_type == SensorType.AUDIO:
+            return
+
+        self._update_buffers()
+        if self._spec.gpu2gpu_transfer:
+            # device to device copies don't stall the CPU on the readback,
+            # so they are done right away. Such sensors always return the
+            # observation of the last started readback.
+            self._read_frame_gpu()
+        else:
+            self._sensor_object.start_read_observation()
+
+    def _get_observation_readback(self) -> Union[ndarray, "Tensor"]:
+        if self._spec.sensor_type == SensorType.AUDIO:
+            return self._get_audio_observation()
+
+        if self._spec.gpu2gpu_transfer:
+            obs = self._buffer.flip(0)  # type: ignore[union-attr]
+        else:
+            if not self._sensor_object.finish_read_observation(self.view):
+                raise RuntimeError(
+                    "get_sensor_observations_readback_finish was called without a "
+                    "pending start_sensor_observations_readback"
+                )
+            obs = np.flip(self._buffer, axis=0)
+
+        return self._noise_model(obs)
+
     def _get_observation_async(self) -> Union[ndarray, "Tensor"]:
         if self._spec.sensor_type == SensorType.AUDIO:
             return self._get_audio_observation()
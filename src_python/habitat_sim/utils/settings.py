@@ -59,6 +59,8 @@ default_sim_settings: Dict[str, Any] = {
     "navmesh_include_static_objects": False,
     # Enable horizon-based ambient occlusion, which provides soft shadows in corners and crevices.
     "enable_hbao": False,
+    # Resolution divisor HBAO is calculated at, 1, 2 or 4.
+    "hbao_resolution_divisor": 1,
 }
 # [/default_sim_settings]
 
@@ -86,6 +88,7 @@ def make_cfg(settings: Dict[str, Any]):
     if "scene_light_setup" in settings:
         sim_cfg.scene_light_setup = settings["scene_light_setup"]
     sim_cfg.enable_hbao = settings.get("enable_hbao", False)
+    sim_cfg.hbao_resolution_divisor = settings.get("hbao_resolution_divisor", 1)
     sim_cfg.gpu_device_id = 0
 
     if not hasattr(sim_cfg, "scene_id"):
@@ -642,9 +642,19 @@ def test_collision_groups():
                 "my_custom_group_1"
             )
 
+            # the precomputed pair table follows the two-way mask check
+            assert cgh.groups_interact(cg.Dynamic, cg.Static)
+            assert not cgh.groups_interact(cg.Static, cg.Kinematic)
+            assert not cgh.groups_interact(cg.Noncollidable, cg.Dynamic)
+            assert int(cgh.get_interacting_groups(cg.Noncollidable)) == 0
+
             # create a custom group behavior (STATIC and KINEMATIC only)
             new_user_group_1_mask = cg.Static | cg.Kinematic
             cgh.set_mask_for_group(cg.UserGroup1, new_user_group_1_mask)
+            assert cgh.groups_interact(cg.UserGroup1, cg.Static)
+            assert cgh.groups_interact(cg.Static, cg.UserGroup1)
+            assert not cgh.groups_interact(cg.UserGroup1, cg.Dynamic)
+            assert not cgh.groups_interact(cg.Dynamic, cg.UserGroup1)
 
             cube_prim_handle = obj_template_mgr.get_template_handles("cube")[0]
             cube_obj1 = rigid_obj_mgr.add_object_by_template_handle(cube_prim_handle)
@@ -732,6 +742,19 @@ def test_collision_groups():
             assert ao.contact_test()
             assert cube_obj2.contact_test()
 
+            # batched queries agree with contact_test and leave the state as is
+            ao_positions = ao.joint_positions
+            assert ao.contact_test_joint_positions(ao_positions * 3) == [True] * 3
+            assert ao.joint_positions == ao_positions
+            assert ao.contact_test_joint_positions(ao_positions[:-1]) == []
+            cube_transform = cube_obj2.transformation
+            far_transform = mn.Matrix4.translation(mn.Vector3(-100.0, 0.0, 0.0))
+            assert cube_obj2.contact_test_transforms(
+                [cube_transform, far_transform]
+            ) == [True, False]
+            assert cube_obj2.transformation == cube_transform
+            assert cube_obj2.contact_test()
+
             # we can re-sleep after moving, but states have been updated correctly for contact check
             ao.awake = False
             cube_obj2.awake = False
@@ -938,6 +961,180 @@ def test_articulated_object_add_remove():
         assert art_obj_mgr.get_num_objects() == 0
 
 
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_articulated_object_batched_joint_state():
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        art_obj_mgr = sim.get_articulated_object_manager()
+        robot_file = "data/test_assets/urdf/kuka_iiwa/model_free_base.urdf"
+        robots = [
+            art_obj_mgr.add_articulated_object_from_urdf(filepath=robot_file)
+            for _i in range(3)
+        ]
+        ids = np.array([robot.object_id for robot in robots], dtype=np.int32)
+        num_dofs = len(robots[0].joint_velocities)
+        num_positions = len(robots[0].joint_positions)
+        assert art_obj_mgr.get_num_dofs(ids) == 3 * num_dofs
+        assert art_obj_mgr.get_num_joint_positions(ids) == 3 * num_positions
+
+        # scatter distinct positions, then gather them back
+        positions = np.random.uniform(
+            -0.5, 0.5, size=(3, num_positions)
+        ).astype(np.float32)
+        art_obj_mgr.set_joint_positions(ids, positions)
+        for i, robot in enumerate(robots):
+            assert np.allclose(robot.joint_positions, positions[i], atol=1.0e-5)
+        assert np.allclose(
+            art_obj_mgr.get_joint_positions(ids), positions.ravel(), atol=1.0e-5
+        )
+
+        # gathering into a buffer writes it in place
+        out = np.zeros((3, num_positions), dtype=np.float32)
+        assert art_obj_mgr.get_joint_positions(ids, out=out) is out
+        assert np.allclose(out, positions, atol=1.0e-5)
+        # the order of the ids is the order of the output
+        reversed_out = art_obj_mgr.get_joint_positions(ids[::-1].copy())
+        assert np.allclose(reversed_out[:num_positions], positions[2], atol=1.0e-5)
+
+        velocities = np.full(3 * num_dofs, 0.25, dtype=np.float32)
+        art_obj_mgr.set_joint_velocities(ids, velocities)
+        assert np.allclose(robots[1].joint_velocities, 0.25)
+        assert np.allclose(art_obj_mgr.get_joint_velocities(ids), velocities)
+
+        forces = np.ones(3 * num_dofs, dtype=np.float32)
+        art_obj_mgr.set_joint_forces(ids, forces)
+        art_obj_mgr.add_joint_forces(ids, forces)
+        assert np.allclose(art_obj_mgr.get_joint_forces(ids), 2.0)
+
+        # sizes must match and buffers must not need a conversion
+        with pytest.raises(RuntimeError):
+            art_obj_mgr.set_joint_positions(ids, positions[:2])
+        with pytest.raises(RuntimeError):
+            art_obj_mgr.get_joint_positions(ids, out=out.astype(np.float64))
+
+
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_articulated_object_batched_kinematics():
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        art_obj_mgr = sim.get_articulated_object_manager()
+        robot_file = "data/test_assets/urdf/kuka_iiwa/model_free_base.urdf"
+        robot = art_obj_mgr.add_articulated_object_from_urdf(filepath=robot_file)
+        robot.translation = mn.Vector3(0.5, 1.0, -0.25)
+        initial_positions = robot.joint_positions
+        num_positions = len(initial_positions)
+        num_dofs = len(robot.joint_velocities)
+        link_ids = robot.get_link_ids()
+
+        rng = np.random.default_rng(0)
+        positions = rng.uniform(-1.0, 1.0, size=(8, num_positions)).astype(
+            np.float32
+        )
+        transformations = robot.compute_link_transformations(positions)
+        assert transformations.shape == (8, robot.num_links + 1, 4, 4)
+        # the object is left as it was and threading doesn't change anything
+        assert np.allclose(robot.joint_positions, initial_positions)
+        assert np.allclose(
+            robot.compute_link_transformations(positions, num_threads=1),
+            transformations,
+        )
+
+        # same poses as setting the joint positions
+        for config, expected in zip(positions, transformations):
+            robot.joint_positions = config
+            for i, link_id in enumerate([-1] + link_ids):
+                node = robot.get_link_scene_node(link_id)
+                assert np.allclose(
+                    node.absolute_transformation(), expected[i], atol=1.0e-4
+                )
+
+        # the linear part of the jacobian matches finite differences of the
+        # link origin, the angular part is unit joint axes for revolute joints
+        link_id = link_ids[-1]
+        jacobians = robot.compute_link_jacobians(link_id, positions)
+        assert jacobians.shape == (8, 6, num_dofs)
+        assert np.allclose(
+            np.linalg.norm(jacobians[:, 3:], axis=1), 1.0, atol=1.0e-4
+        )
+        eps = 1.0e-2
+        for dof in range(num_dofs):
+            offset = np.zeros(num_positions, dtype=np.float32)
+            offset[dof] = eps
+            plus = robot.compute_link_transformations(positions + offset)
+            minus = robot.compute_link_transformations(positions - offset)
+            finite_difference = (
+                plus[:, link_id + 1, :3, 3] - minus[:, link_id + 1, :3, 3]
+            ) / (2.0 * eps)
+            assert np.allclose(jacobians[:, :3, dof], finite_difference, atol=1.0e-2)
+
+        with pytest.raises(RuntimeError):
+            robot.compute_link_transformations(positions[:, :-1])
+
+
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_articulated_object_kinematic_update():
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        art_obj_mgr = sim.get_articulated_object_manager()
+        robot_file = "data/test_assets/urdf/kuka_iiwa/model_free_base.urdf"
+        robot = art_obj_mgr.add_articulated_object_from_urdf(filepath=robot_file)
+        pose = [0.1 * (i + 1) for i in range(len(robot.joint_positions))]
+        root_translation = mn.Vector3(0.5, 1.0, -0.25)
+
+        def link_transforms():
+            return [
+                robot.get_link_scene_node(link_id).absolute_transformation()
+                for link_id in robot.get_link_ids()
+            ]
+
+        # forward kinematics of the multibody
+        robot.translation = root_translation
+        robot.joint_positions = pose
+        expected = link_transforms()
+
+        # the direct update of non-simulated objects gives the same transforms
+        robot.motion_type = habitat_sim.physics.MotionType.KINEMATIC
+        robot.translation = mn.Vector3()
+        robot.joint_positions = [0.0] * len(pose)
+        robot.translation = root_translation
+        robot.joint_positions = pose
+        for transform, expected_transform in zip(link_transforms(), expected):
+            assert np.allclose(transform, expected_transform, atol=1.0e-5)
+
+        # stepping doesn't move the kinematic robot and motors don't act on it
+        robot.create_all_motors(habitat_sim.physics.JointMotorSettings())
+        sim.step_physics(0.1)
+        assert np.allclose(robot.joint_positions, pose, atol=1.0e-5)
+        for transform, expected_transform in zip(link_transforms(), expected):
+            assert np.allclose(transform, expected_transform, atol=1.0e-5)
+
+        # and it is simulated again once dynamic
+        robot.motion_type = habitat_sim.physics.MotionType.DYNAMIC
+        sim.step_physics(0.1)
+        assert not np.allclose(robot.translation, root_translation)
+
+
 @pytest.mark.skipif(
     not habitat_sim.bindings.built_with_bullet,
     reason="ArticulatedObject API requires Bullet physics.",
@@ -4,6 +4,9 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import json
+
+import magnum as mn
 import pytest
 
 import habitat_sim
@@ -39,3 +42,56 @@ def test_benchmark_urdf_add_remove(benchmark, iterations, force_reload):
                 art_obj_mgr.remove_object_by_id(robot.object_id)
 
     benchmark(instance_remove_urdf, iterations)
+
+
+# benchmark stepping a cluttered scene with different broadphase and solver
+# configurations from the physics config
+@pytest.mark.sim_benchmarks
+@pytest.mark.skipif(
+    not habitat_sim.bindings.built_with_bullet,
+    reason="Broadphase configuration requires Bullet physics.",
+)
+@pytest.mark.benchmark(group="Clutter step broadphase|solver_iterations")
+@pytest.mark.parametrize("broadphase", ["dbvt", "sap"])
+@pytest.mark.parametrize("solver_iterations", [10, 50])
+def test_benchmark_clutter_broadphase(
+    benchmark, tmp_path, broadphase, solver_iterations
+):
+    physics_config = {
+        "physics_simulator": "bullet",
+        "timestep": 0.008,
+        "gravity": [0, -9.8, 0],
+        "broadphase": broadphase,
+        "broadphase_world_min": [-50, -50, -50],
+        "broadphase_world_max": [50, 50, 50],
+        "solver_iterations": solver_iterations,
+    }
+    physics_config_file = tmp_path / "benchmark.physics_config.json"
+    physics_config_file.write_text(json.dumps(physics_config))
+
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    cfg_settings["physics_config_file"] = str(physics_config_file)
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        obj_template_mgr = sim.get_object_template_manager()
+        rigid_obj_mgr = sim.get_rigid_object_manager()
+        cube_handle = obj_template_mgr.get_template_handles("cubeSolid")[0]
+
+        # a kinematic floor of cubes with dynamic clutter layered above it
+        grid_size = 10
+        for layer in range(4):
+            for x in range(grid_size):
+                for z in range(grid_size):
+                    cube = rigid_obj_mgr.add_object_by_template_handle(cube_handle)
+                    cube.translation = mn.Vector3(
+                        x * 1.1 - grid_size / 2,
+                        layer * 1.5,
+                        z * 1.1 - grid_size / 2,
+                    )
+                    if layer == 0:
+                        cube.motion_type = habitat_sim.physics.MotionType.KINEMATIC
+
+        benchmark(sim.step_physics, 1.0)
@@ -363,3 +363,126 @@ def test_rgba_noise(scene_and_dataset, model_name, make_cfg_settings):
         assert np.linalg.norm(
             obs["color_sensor"].astype(float) - gt.astype(float)
         ) > 1.5e-2 * np.linalg.norm(gt.astype(float)), "Incorrect color_sensor output"
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("scene_and_dataset", _non_semantic_scenes)
+@pytest.mark.parametrize("sensor_type", all_base_sensor_types[:2])
+def test_bound_observation_buffer(scene_and_dataset, sensor_type, make_cfg_settings):
+    scene = scene_and_dataset[0]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["scene_dataset_config_file"] = scene_and_dataset[1]
+    with habitat_sim.Simulator(make_cfg(make_cfg_settings)) as sim:
+        expected = sim.get_sensor_observations()[sensor_type].copy()
+
+        # one element of batched rollout storage
+        own = sim._sensors[sensor_type]._buffer
+        batch = np.zeros((3,) + own.shape, dtype=own.dtype)
+        sim.bind_sensor_observation_buffer(sensor_type, batch[1])
+        obs = sim.get_sensor_observations()[sensor_type]
+        assert np.shares_memory(obs, batch)
+        assert np.array_equal(obs, expected)
+        assert np.array_equal(np.flip(batch[1], axis=0), expected)
+        assert not batch[0].any() and not batch[2].any()
+
+        with pytest.raises(ValueError):
+            sim.bind_sensor_observation_buffer(sensor_type, batch[:, 0])
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("scene_and_dataset", _semantic_scenes)
+def test_compact_semantic_ids(scene_and_dataset, make_cfg_settings):
+    scene = scene_and_dataset[0]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+    make_cfg_settings["semantic_sensor"] = True
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["scene_dataset_config_file"] = scene_and_dataset[1]
+    hsim_cfg = make_cfg(make_cfg_settings)
+    with habitat_sim.Simulator(hsim_cfg) as sim:
+        expected = _render_scene(sim, scene, "semantic_sensor", False)[
+            "semantic_sensor"
+        ].copy()
+
+    for spec in hsim_cfg.agents[0].sensor_specifications:
+        if spec.uuid == "semantic_sensor":
+            spec.compact_semantic_ids = True
+    with habitat_sim.Simulator(hsim_cfg) as sim:
+        obs = _render_scene(sim, scene, "semantic_sensor", False)["semantic_sensor"]
+        assert obs.dtype == np.uint16
+        assert np.array_equal(obs.astype(np.uint32), expected)
+
+
+def test_observation_buffer_view(make_cfg_settings):
+    scene = make_cfg_settings["scene"]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+    with habitat_sim.Simulator(make_cfg(make_cfg_settings)) as sim:
+        sensor = sim._sensors["depth_sensor"]._sensor_object
+        obs = habitat_sim.sensor.Observation()
+        assert sensor.get_observation(sim, obs)
+
+        view = np.asarray(obs.buffer)
+        assert view.dtype == np.float32
+        assert list(view.shape) == obs.buffer.shape
+        # both views alias the sensor's memory, and outlive the observation
+        assert np.shares_memory(view, np.asarray(obs.buffer))
+        del obs
+        assert np.isfinite(view).all()
+
+
+@pytest.mark.gfxtest
+@pytest.mark.parametrize("scene_and_dataset", _non_semantic_scenes)
+def test_skip_unchanged_draws(scene_and_dataset, make_cfg_settings):
+    scene = scene_and_dataset[0]
+    if not osp.exists(scene):
+        pytest.skip("Skipping {}".format(scene))
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["scene"] = scene
+    make_cfg_settings["scene_dataset_config_file"] = scene_and_dataset[1]
+    with habitat_sim.Simulator(make_cfg(make_cfg_settings)) as sim:
+        sensor = sim._sensors["color_sensor"]._sensor_object
+        assert not sensor.skip_unchanged_draws
+        sensor.skip_unchanged_draws = True
+
+        # a small sphere right in front of the sensor
+        obj_template_mgr = sim.get_object_template_manager()
+        rigid_obj_mgr = sim.get_rigid_object_manager()
+        sphere_handle = obj_template_mgr.get_template_handles("uvSphereSolid")[0]
+        sphere_template = obj_template_mgr.get_template_by_handle(sphere_handle)
+        sphere_template.scale = [0.1, 0.1, 0.1]
+        obj_template_mgr.register_template(sphere_template, "skip_draws_sphere")
+        sphere = rigid_obj_mgr.add_object_by_template_handle("skip_draws_sphere")
+        sphere.motion_type = habitat_sim.physics.MotionType.KINEMATIC
+        sensor_transform = sensor.node.absolute_transformation()
+        sphere.translation = sensor_transform.transform_point(mn.Vector3(0, 0, -1))
+        expected = sim.get_sensor_observations()["color_sensor"].copy()
+
+        # nothing moved, the previous image is reused
+        drawn = sensor.draw_count
+        skipped = sensor.skipped_draw_count
+        obs = sim.get_sensor_observations()["color_sensor"]
+        assert sensor.draw_count == drawn
+        assert sensor.skipped_draw_count == skipped + 1
+        assert np.array_equal(obs, expected)
+
+        # moving an object while the agent stays still changes the view
+        sphere.translation += sensor_transform.transform_vector(
+            mn.Vector3(0.2, 0, 0)
+        )
+        obs = sim.get_sensor_observations()["color_sensor"]
+        assert sensor.draw_count == drawn + 1
+        assert sensor.skipped_draw_count == skipped + 1
+        assert not np.array_equal(obs, expected)
+
+        # turning the agent changes the view
+        sim.step("turn_left")
+        assert sensor.draw_count == drawn + 2
+
+        sensor.skip_unchanged_draws = False
+        sim.get_sensor_observations()
+        assert sensor.draw_count == drawn + 3
+        assert sensor.skipped_draw_count == skipped + 1
@@ -2,6 +2,7 @@
 # This source code is licensed under the MIT license found in the
 # LICENSE file in the root directory of this source tree.
 
+import json
 import random
 from copy import copy
 from os import path as osp
@@ -142,6 +143,40 @@ def test_sim_multiagent_move_and_reset(make_cfg_settings, num_agents=10):
             )
 
 
+def test_step_pipelined(make_cfg_settings):
+    cfg_settings = make_cfg_settings.copy()
+    cfg_settings["semantic_sensor"] = False
+    cfg_settings["depth_sensor"] = False
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+    actions = ["move_forward", "turn_left", "move_forward", "turn_right"]
+
+    # observations are views of the sensor buffers, so keep copies
+    def color_and_collided(obs):
+        return obs["color_sensor"].copy(), obs["collided"]
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        sim.initialize_agent(0)
+        initial = sim.get_sensor_observations()["color_sensor"].copy()
+        stepped = [color_and_collided(sim.step(action)) for action in actions]
+
+        # each call returns what step() returned one call earlier, starting
+        # with the initial state
+        sim.reset()
+        pipelined = [
+            color_and_collided(sim.step_pipelined(action)) for action in actions
+        ]
+        assert np.array_equal(pipelined[0][0], initial)
+        assert not pipelined[0][1]
+        for expected, obs in zip(stepped[:-1], pipelined[1:]):
+            assert np.array_equal(obs[0], expected[0])
+            assert obs[1] == expected[1]
+
+        # the state after the last call is rendered as usual
+        assert np.array_equal(
+            sim.get_sensor_observations()["color_sensor"], stepped[-1][0]
+        )
+
+
 # Make sure you can keep a reference to an agent alive without crashing
 def test_keep_agent():
     sim_cfg = habitat_sim.SimulatorConfiguration()
@@ -257,6 +292,81 @@ def test_object_template_editing():
             assert obj_init_template.render_asset_handle.endswith("sphere.glb")
 
 
+def test_scene_instance_objects_match_serial(tmp_path):
+    # scene instance objects are resolved and read in parallel, then added in
+    # order, so they should come out as if added one by one
+    template_names = [
+        "dataset_test_object1",
+        "dataset_test_object2",
+        "dataset_test_object1",
+        "dataset_test_object1",
+        "dataset_test_object2",
+    ]
+    translations = [
+        [0.1, 0.2, 0.3],
+        [0.3, 0.4, 0.5],
+        [1.1, 0.2, 0.3],
+        [2.1, 0.2, 0.3],
+        [0.5, 0.6, 0.7],
+    ]
+
+    def write_scene(name, object_template_names):
+        scene = {
+            "translation_origin": "com",
+            "stage_instance": {"template_name": "modified_test_stage"},
+            "object_instances": [
+                {"template_name": template_name, "translation": translation}
+                for template_name, translation in zip(
+                    object_template_names, translations
+                )
+            ],
+        }
+        scene_file = tmp_path / (name + ".scene_instance.json")
+        scene_file.write_text(json.dumps(scene))
+        return str(scene_file)
+
+    def object_states(sim):
+        objects = sim.get_rigid_object_manager().get_objects_by_handle_substring()
+        return sorted(
+            (
+                obj.object_id,
+                handle,
+                obj.creation_attributes.render_asset_handle,
+                obj.creation_attributes.scale,
+                obj.translation,
+            )
+            for handle, obj in objects.items()
+        )
+
+    cfg_settings = habitat_sim.utils.settings.default_sim_settings.copy()
+    cfg_settings["scene_dataset_config_file"] = osp.abspath(
+        "data/test_assets/dataset_tests/dataset_0/test_dataset_0.scene_dataset_config.json"
+    )
+    cfg_settings["scene"] = write_scene("stage_only", [])
+    hab_cfg = habitat_sim.utils.settings.make_cfg(cfg_settings)
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        obj_template_mgr = sim.get_object_template_manager()
+        rigid_obj_mgr = sim.get_rigid_object_manager()
+        for template_name, translation in zip(template_names, translations):
+            handle = obj_template_mgr.get_template_handles(template_name)[0]
+            obj = rigid_obj_mgr.add_object_by_template_handle(handle)
+            obj.translation = mn.Vector3(translation)
+        serial_states = object_states(sim)
+        assert len(serial_states) == len(template_names)
+
+        # a missing template fails the load without affecting the next one
+        hab_cfg.sim_cfg.scene_id = write_scene(
+            "missing_objects",
+            template_names[:2] + ["missing_test_object"] + template_names[3:],
+        )
+        with pytest.raises(RuntimeError):
+            sim.reconfigure(hab_cfg)
+
+        hab_cfg.sim_cfg.scene_id = write_scene("repeated_objects", template_names)
+        sim.reconfigure(hab_cfg)
+        assert object_states(sim) == serial_states
+
+
 @pytest.mark.filterwarnings("ignore::pytest.PytestUnraisableExceptionWarning")
 def test_no_config():
     with pytest.raises(TypeError):